@@ -20,10 +20,31 @@
 #include "cxx.h"
 #include "ffrt.h"
 
+#include <memory>
+#include <vector>
+
 struct ClosureWrapper;
+enum class FfrtQos : uint8_t;
+
+struct FfrtTask {
+    ffrt::task_handle handle;
+};
+
+struct FfrtDeps {
+    void Add(const FfrtTask &task);
+    std::vector<ffrt::dependence> deps;
+};
 
 void FfrtSpawn(rust::Box<ClosureWrapper> closure);
 
+void FfrtSpawnQos(rust::Box<ClosureWrapper> closure, FfrtQos qos);
+
+std::unique_ptr<FfrtDeps> NewFfrtDeps();
+
+std::unique_ptr<FfrtTask> FfrtSubmit(rust::Box<ClosureWrapper> closure, FfrtQos qos, const FfrtDeps &deps);
+
+void FfrtWait(const FfrtTask &task);
+
 void FfrtSleep(uint64_t ms);
 
 #endif
\ No newline at end of file
@@ -15,16 +15,65 @@
 
 #include "wrapper.h"
 
+#include <functional>
+#include <utility>
+
 #include "cpp/task.h"
 #include "cxx.h"
 #include "wrapper.rs.h"
 
-void FfrtSpawn(rust::Box<ClosureWrapper> closure)
+static std::function<void()> TaskOf(rust::Box<ClosureWrapper> closure)
 {
-    ffrt::submit([closure = closure.into_raw()]() mutable {
+    return [closure = closure.into_raw()]() mutable {
         closure->run();
         rust::Box<ClosureWrapper>::from_raw(closure);
-    });
+    };
+}
+
+static ffrt::qos ToFfrtQos(FfrtQos qos)
+{
+    switch (qos) {
+        case FfrtQos::Background:
+            return ffrt::qos_background;
+        case FfrtQos::Utility:
+            return ffrt::qos_utility;
+        case FfrtQos::UserInitiated:
+            return ffrt::qos_user_initiated;
+        default:
+            return ffrt::qos_default;
+    }
+}
+
+void FfrtSpawn(rust::Box<ClosureWrapper> closure)
+{
+    ffrt::submit(TaskOf(std::move(closure)));
+}
+
+void FfrtSpawnQos(rust::Box<ClosureWrapper> closure, FfrtQos qos)
+{
+    ffrt::submit(TaskOf(std::move(closure)), {}, {}, ffrt::task_attr().qos(ToFfrtQos(qos)));
+}
+
+void FfrtDeps::Add(const FfrtTask &task)
+{
+    deps.emplace_back(task.handle);
+}
+
+std::unique_ptr<FfrtDeps> NewFfrtDeps()
+{
+    return std::make_unique<FfrtDeps>();
+}
+
+std::unique_ptr<FfrtTask> FfrtSubmit(rust::Box<ClosureWrapper> closure, FfrtQos qos, const FfrtDeps &deps)
+{
+    auto task = std::make_unique<FfrtTask>();
+    task->handle = ffrt::submit_h(TaskOf(std::move(closure)), deps.deps, {}, ffrt::task_attr().qos(ToFfrtQos(qos)));
+    return task;
+}
+
+void FfrtWait(const FfrtTask &task)
+{
+    ffrt::wait({ task.handle });
 }
 
 void FfrtSleep(uint64_t ms)
@@ -14,8 +14,54 @@
 #![allow(missing_docs)]
 mod wrapper;
 
+use cxx::UniquePtr;
 // Import necessary items from the wrapper module
-use wrapper::{ClosureWrapper, FfrtSleep, FfrtSpawn};
+use wrapper::{
+    ClosureWrapper, FfrtQos, FfrtSleep, FfrtSpawn, FfrtSpawnQos, FfrtSubmit, FfrtTask, FfrtWait,
+    NewFfrtDeps,
+};
+
+/// QoS level of a task, deciding which tasks FFRT runs first.
+///
+/// Work no caller waits for, such as writing caches, should run below the
+/// work users see the result of, such as the callbacks of a fetch.
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub enum Qos {
+    /// Work nobody waits for, such as cache writes and cleanups
+    Background,
+    /// Work whose result is needed later, such as prefetches
+    Utility,
+    /// The level of tasks spawned by `ffrt_spawn`
+    Default,
+    /// Work a user waits for, such as the callbacks of a fetch
+    UserInitiated,
+}
+
+impl From<Qos> for FfrtQos {
+    fn from(qos: Qos) -> Self {
+        match qos {
+            Qos::Background => FfrtQos::Background,
+            Qos::Utility => FfrtQos::Utility,
+            Qos::Default => FfrtQos::Default,
+            Qos::UserInitiated => FfrtQos::UserInitiated,
+        }
+    }
+}
+
+/// Handle of a task spawned by `ffrt_spawn_after`, used to make other tasks
+/// wait for it.
+pub struct TaskHandle {
+    inner: UniquePtr<FfrtTask>,
+}
+
+impl TaskHandle {
+    /// Blocks until the task has run.
+    pub fn wait(&self) {
+        if let Some(task) = self.inner.as_ref() {
+            FfrtWait(task);
+        }
+    }
+}
 
 /// Spawns a task using the FastFlow Runtime.
 /// 
@@ -47,6 +93,99 @@ where
     FfrtSpawn(ClosureWrapper::new(f));
 }
 
+/// Spawns a task running at the given QoS level.
+///
+/// # Arguments
+///
+/// * `qos` - The QoS level of the task
+/// * `f` - The closure to execute
+///
+/// # Examples
+///
+/// ```
+/// use ffrt_rs::{ffrt_spawn_qos, Qos};
+///
+/// // Write a cache without delaying user visible tasks
+/// ffrt_spawn_qos(Qos::Background, || {
+///     println!("Cache written");
+/// });
+/// ```
+pub fn ffrt_spawn_qos<F>(qos: Qos, f: F)
+where
+    F: FnOnce() + 'static,
+{
+    FfrtSpawnQos(ClosureWrapper::new(f), qos.into());
+}
+
+/// Spawns a task that runs once all the tasks of `deps` have run.
+///
+/// # Arguments
+///
+/// * `qos` - The QoS level of the task
+/// * `deps` - The tasks to wait for, none to run the task right away
+/// * `f` - The closure to execute
+///
+/// # Returns
+///
+/// The handle of the task, for later tasks to wait for it
+///
+/// # Examples
+///
+/// ```
+/// use ffrt_rs::{ffrt_spawn_after, Qos};
+///
+/// let write = ffrt_spawn_after(Qos::Background, &[], || println!("written"));
+/// let notify = ffrt_spawn_after(Qos::UserInitiated, &[&write], || println!("notified"));
+/// notify.wait();
+/// ```
+pub fn ffrt_spawn_after<F>(qos: Qos, deps: &[&TaskHandle], f: F) -> TaskHandle
+where
+    F: FnOnce() + 'static,
+{
+    let mut ffrt_deps = NewFfrtDeps();
+    for dep in deps {
+        if let Some(task) = dep.inner.as_ref() {
+            ffrt_deps.pin_mut().Add(task);
+        }
+    }
+    TaskHandle {
+        inner: FfrtSubmit(ClosureWrapper::new(f), qos.into(), &ffrt_deps),
+    }
+}
+
+/// Spawns one task running all the closures in order.
+///
+/// Submitting a task costs more than running a small closure, so closures too
+/// small to be worth a task each are better run together. A closure that blocks
+/// delays the ones after it.
+///
+/// # Arguments
+///
+/// * `qos` - The QoS level of the task
+/// * `closures` - The closures to execute, in order
+///
+/// # Examples
+///
+/// ```
+/// use ffrt_rs::{ffrt_spawn_batch, Qos};
+///
+/// let closures: Vec<Box<dyn FnOnce()>> = vec![
+///     Box::new(|| println!("first")),
+///     Box::new(|| println!("second")),
+/// ];
+/// ffrt_spawn_batch(Qos::Default, closures);
+/// ```
+pub fn ffrt_spawn_batch(qos: Qos, closures: Vec<Box<dyn FnOnce()>>) {
+    if closures.is_empty() {
+        return;
+    }
+    ffrt_spawn_qos(qos, move || {
+        for f in closures {
+            f();
+        }
+    });
+}
+
 /// Suspends the current thread execution for the specified duration using FFRT.
 /// 
 /// # Arguments
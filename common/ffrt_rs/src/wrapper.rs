@@ -16,8 +16,84 @@
 //! This module provides the low-level bindings and wrapper types needed to interface
 //! with the C++ FastFlow Runtime library.
 
+use std::mem::{self, ManuallyDrop, MaybeUninit};
+use std::ptr;
+
 // Import FFI functions from the C++ interface
-pub(crate) use ffi::{FfrtSleep, FfrtSpawn};
+pub(crate) use ffi::{
+    FfrtQos, FfrtSleep, FfrtSpawn, FfrtSpawnQos, FfrtSubmit, FfrtTask, FfrtWait, NewFfrtDeps,
+};
+
+/// Words of inline storage in a `ClosureWrapper`.
+///
+/// Closures capturing no more than this are moved into the wrapper itself
+/// instead of a second allocation.
+const INLINE_WORDS: usize = 4;
+
+/// A closure owned by a `ClosureWrapper`.
+enum Closure {
+    /// Small closure stored in the wrapper allocation
+    Inline(InlineClosure),
+    /// Closure too large or too aligned to be stored inline
+    Boxed(Box<dyn FnOnce()>),
+}
+
+/// Closure of an erased type, stored in place.
+struct InlineClosure {
+    /// Storage holding the closure
+    data: [MaybeUninit<usize>; INLINE_WORDS],
+    /// Moves the closure out of `data` and calls it
+    call: unsafe fn(*mut u8),
+    /// Drops the closure in `data` without calling it
+    drop: unsafe fn(*mut u8),
+}
+
+impl InlineClosure {
+    /// Stores `f` in place, or gives it back if it does not fit.
+    fn new<F>(f: F) -> Result<Self, F>
+    where
+        F: FnOnce() + 'static,
+    {
+        if mem::size_of::<F>() > mem::size_of::<[usize; INLINE_WORDS]>()
+            || mem::align_of::<F>() > mem::align_of::<usize>()
+        {
+            return Err(f);
+        }
+        let mut data = [MaybeUninit::uninit(); INLINE_WORDS];
+        // SAFETY: `data` was checked to be large and aligned enough for `F`, which
+        // is owned by the storage from now on.
+        unsafe { ptr::write(data.as_mut_ptr() as *mut F, f) };
+        Ok(Self {
+            data,
+            call: call_inline::<F>,
+            drop: drop_inline::<F>,
+        })
+    }
+
+    /// Calls the closure, consuming it.
+    fn run(self) {
+        let mut this = ManuallyDrop::new(self);
+        // SAFETY: `this` is never dropped, so the closure is moved out only once.
+        unsafe { (this.call)(this.data.as_mut_ptr() as *mut u8) }
+    }
+}
+
+impl Drop for InlineClosure {
+    fn drop(&mut self) {
+        // SAFETY: the closure is still in place, `run` does not drop `self`.
+        unsafe { (self.drop)(self.data.as_mut_ptr() as *mut u8) }
+    }
+}
+
+/// Moves the `F` stored at `data` out and calls it.
+unsafe fn call_inline<F: FnOnce()>(data: *mut u8) {
+    ptr::read(data as *mut F)()
+}
+
+/// Drops the `F` stored at `data`.
+unsafe fn drop_inline<F>(data: *mut u8) {
+    ptr::drop_in_place(data as *mut F)
+}
 
 /// Wrapper for closures to be passed across the FFI boundary.
 /// 
@@ -25,7 +101,7 @@ pub(crate) use ffi::{FfrtSleep, FfrtSpawn};
 /// executed by the C++ FFRT library.
 pub struct ClosureWrapper {
     /// The wrapped closure, stored as an Option to allow take() during execution
-    inner: Option<Box<dyn FnOnce()>>,
+    inner: Option<Closure>,
 }
 
 impl ClosureWrapper {
@@ -42,8 +118,12 @@ impl ClosureWrapper {
     where
         F: FnOnce() + 'static,
     {
+        let closure = match InlineClosure::new(f) {
+            Ok(inline) => Closure::Inline(inline),
+            Err(f) => Closure::Boxed(Box::new(f)),
+        };
         Box::new(Self {
-            inner: Some(Box::new(f)),
+            inner: Some(closure),
         })
     }
 
@@ -53,15 +133,29 @@ impl ClosureWrapper {
     /// After execution, the closure is removed from the wrapper to ensure it's
     /// only called once.
     pub fn run(&mut self) {
-        if let Some(f) = self.inner.take() {
-            f();
+        match self.inner.take() {
+            Some(Closure::Inline(inline)) => inline.run(),
+            Some(Closure::Boxed(f)) => f(),
+            None => {}
         }
     }
 }
 
 // CXX bridge for FFI between Rust and C++ FFRT components
+// SAFETY: a task handle only refers to the task, which FFRT shares between
+// threads itself.
+unsafe impl Send for FfrtTask {}
+
 #[cxx::bridge]
 mod ffi {
+    /// QoS levels of FFRT tasks, from the lowest.
+    enum FfrtQos {
+        Background,
+        Utility,
+        Default,
+        UserInitiated,
+    }
+
     // Rust interface exposed to C++
     extern "Rust" {
         type ClosureWrapper;
@@ -73,8 +167,22 @@ mod ffi {
         // Include the C++ header defining the FFRT interface
         include!("wrapper.h");
         
+        /// Handle of a submitted task.
+        type FfrtTask;
+        /// Tasks a task waits for.
+        type FfrtDeps;
+
         // FFRT API functions
         fn FfrtSpawn(closure: Box<ClosureWrapper>);
+        fn FfrtSpawnQos(closure: Box<ClosureWrapper>, qos: FfrtQos);
+        fn NewFfrtDeps() -> UniquePtr<FfrtDeps>;
+        fn Add(self: Pin<&mut FfrtDeps>, task: &FfrtTask);
+        fn FfrtSubmit(
+            closure: Box<ClosureWrapper>,
+            qos: FfrtQos,
+            deps: &FfrtDeps,
+        ) -> UniquePtr<FfrtTask>;
+        fn FfrtWait(task: &FfrtTask);
         fn FfrtSleep(ms: u64);
     }
 }
@@ -61,4 +61,113 @@ fn ut_ffrt_sleep() {
     }
     std::thread::sleep(time::Duration::from_millis(500));
     assert_eq!(flag.load(Ordering::SeqCst), 1);
-}
\ No newline at end of file
+}
+// @tc.name: ut_ffrt_spawn_qos
+// @tc.desc: Test ffrt_spawn_qos running tasks at every QoS level
+// @tc.precon: NA
+// @tc.step: 1. Spawn a task incrementing a counter at each QoS level
+//           2. Wait for the tasks
+// @tc.expect: Every task runs once
+// @tc.type: FUNC
+// @tc.require: issues#ICN31I
+// @tc.level: Level 1
+#[test]
+fn ut_ffrt_spawn_qos() {
+    let flag = Arc::new(AtomicUsize::new(0));
+    for qos in [Qos::Background, Qos::Utility, Qos::Default, Qos::UserInitiated] {
+        let flag_clone = flag.clone();
+        ffrt_spawn_qos(qos, move || {
+            flag_clone.fetch_add(1, Ordering::SeqCst);
+        });
+    }
+    std::thread::sleep(time::Duration::from_millis(100));
+    assert_eq!(flag.load(Ordering::SeqCst), 4);
+}
+
+// @tc.name: ut_ffrt_spawn_after
+// @tc.desc: Test ffrt_spawn_after running a task after its dependencies
+// @tc.precon: NA
+// @tc.step: 1. Spawn two background tasks recording their order, one sleeping
+//           2. Spawn a user initiated task depending on both
+//           3. Wait for the last task
+// @tc.expect: The last task runs after both dependencies
+// @tc.type: FUNC
+// @tc.require: issues#ICN31I
+// @tc.level: Level 1
+#[test]
+fn ut_ffrt_spawn_after() {
+    let order = Arc::new(std::sync::Mutex::new(Vec::new()));
+    let first_order = order.clone();
+    let first = ffrt_spawn_after(Qos::Background, &[], move || {
+        ffrt_sleep(50);
+        first_order.lock().unwrap().push(1);
+    });
+    let second_order = order.clone();
+    let second = ffrt_spawn_after(Qos::Background, &[], move || {
+        second_order.lock().unwrap().push(2);
+    });
+    let last_order = order.clone();
+    let last = ffrt_spawn_after(Qos::UserInitiated, &[&first, &second], move || {
+        last_order.lock().unwrap().push(3);
+    });
+    last.wait();
+    let order = order.lock().unwrap();
+    assert_eq!(order.len(), 3);
+    assert_eq!(order[2], 3);
+}
+
+// @tc.name: ut_ffrt_spawn_batch
+// @tc.desc: Test ffrt_spawn_batch running closures in order in one task
+// @tc.precon: NA
+// @tc.step: 1. Spawn a batch of closures recording their index
+//           2. Spawn an empty batch
+//           3. Wait for the batch
+// @tc.expect: The closures run once each, in order
+// @tc.type: FUNC
+// @tc.require: issues#ICN31I
+// @tc.level: Level 1
+#[test]
+fn ut_ffrt_spawn_batch() {
+    let order = Arc::new(std::sync::Mutex::new(Vec::new()));
+    let mut closures: Vec<Box<dyn FnOnce()>> = Vec::new();
+    for i in 0..5 {
+        let order = order.clone();
+        closures.push(Box::new(move || order.lock().unwrap().push(i)));
+    }
+    ffrt_spawn_batch(Qos::Default, closures);
+    ffrt_spawn_batch(Qos::Default, Vec::new());
+    std::thread::sleep(time::Duration::from_millis(100));
+    assert_eq!(*order.lock().unwrap(), vec![0, 1, 2, 3, 4]);
+}
+
+// @tc.name: ut_closure_wrapper_drop
+// @tc.desc: Test dropping wrapped closures that never ran
+// @tc.precon: NA
+// @tc.step: 1. Wrap a small closure, stored inline, and a large one, boxed
+//           2. Run one of each and drop the others unrun
+// @tc.expect: Every captured value is dropped exactly once
+// @tc.type: FUNC
+// @tc.require: issues#ICN31I
+// @tc.level: Level 1
+#[test]
+fn ut_closure_wrapper_drop() {
+    let captured = Arc::new(());
+    let small = captured.clone();
+    let mut inline_run = ClosureWrapper::new(move || drop(small));
+    let small = captured.clone();
+    let inline_unrun = ClosureWrapper::new(move || drop(small));
+    let large = (captured.clone(), [0u64; 8]);
+    let mut boxed_run = ClosureWrapper::new(move || drop(large));
+    let large = (captured.clone(), [0u64; 8]);
+    let boxed_unrun = ClosureWrapper::new(move || drop(large));
+    assert_eq!(Arc::strong_count(&captured), 5);
+
+    inline_run.run();
+    boxed_run.run();
+    assert_eq!(Arc::strong_count(&captured), 3);
+    drop(inline_unrun);
+    drop(boxed_unrun);
+    drop(inline_run);
+    drop(boxed_run);
+    assert_eq!(Arc::strong_count(&captured), 1);
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef REQUEST_URL_VIEW_H
+#define REQUEST_URL_VIEW_H
+
+#include <cstddef>
+#include <string_view>
+
+namespace OHOS::Request {
+// Parts of a url, viewing the url they were parsed from. The url is not
+// validated, parts it does not have are empty.
+struct UrlView {
+    std::string_view scheme;
+    // With the brackets of an IPv6 address.
+    std::string_view host;
+    std::string_view port;
+};
+
+// Splits a url into its parts without allocating, in line with `UrlView::parse`
+// of `request_utils::url` used by the service. `\` separates the parts like `/`,
+// and user information before `@` is not part of the host.
+inline UrlView ParseUrlView(std::string_view url)
+{
+    auto isSlash = [](char c) { return c == '/' || c == '\\'; };
+    UrlView view;
+    size_t start = 0;
+    for (size_t i = 0; i + 2 < url.size(); i++) {
+        if (url[i] == ':' && isSlash(url[i + 1]) && isSlash(url[i + 2])) {
+            view.scheme = url.substr(0, i);
+            // 3 is the length of "://".
+            start = i + 3;
+            break;
+        }
+    }
+    while (start < url.size() && isSlash(url[start])) {
+        start++;
+    }
+
+    size_t end = url.find_first_of("/\\?#", start);
+    std::string_view authority = url.substr(start, end == std::string_view::npos ? end : end - start);
+    size_t at = authority.rfind('@');
+    if (at != std::string_view::npos) {
+        authority.remove_prefix(at + 1);
+    }
+
+    size_t hostEnd = std::string_view::npos;
+    if (!authority.empty() && authority.front() == '[') {
+        hostEnd = authority.find(']');
+        if (hostEnd != std::string_view::npos) {
+            hostEnd++;
+        }
+    } else {
+        hostEnd = authority.find(':');
+    }
+    if (hostEnd == std::string_view::npos) {
+        hostEnd = authority.size();
+    }
+    view.host = authority.substr(0, hostEnd);
+    if (hostEnd < authority.size() && authority[hostEnd] == ':') {
+        view.port = authority.substr(hostEnd + 1);
+    }
+    return view;
+}
+} // namespace OHOS::Request
+
+#endif // REQUEST_URL_VIEW_H
@@ -28,6 +28,12 @@ using namespace OHOS::NetStack::HttpClient;
 
 void SetRequestSslType(HttpClientRequest &request, const std::string &sslType);
 
+void SetRequestHttp3(HttpClientRequest &request, bool enabled);
+
+bool IsRequestHttp3(const HttpClientRequest &request);
+
+std::shared_ptr<HttpClientTask> NewFallbackTask(const HttpClientRequest &request);
+
 rust::vec<rust::string> GetHeaders(HttpClientResponse &response);
 
 rust::vec<rust::string> GetResolvConf();
@@ -0,0 +1,168 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Origins that advertised HTTP/3 in an `Alt-Svc` header (RFC 7838).
+//!
+//! A request asking for HTTP/3 only uses it once its origin advertised
+//! `h3` on its own host and port, until the advertisement expires. An origin
+//! whose HTTP/3 request failed is not tried over HTTP/3 again for a while,
+//! the request falling back to HTTP/1.1 or HTTP/2.
+
+use std::collections::HashMap;
+use std::sync::{Mutex, OnceLock};
+use std::time::{Duration, Instant};
+
+/// Lifetime of an advertisement without a `ma` parameter.
+const DEFAULT_MAX_AGE: Duration = Duration::from_secs(24 * 60 * 60);
+
+/// How long HTTP/3 is not tried again on an origin after it failed.
+const BROKEN_FOR: Duration = Duration::from_secs(5 * 60);
+
+/// Number of origins kept, expired ones are dropped first.
+const MAX_ORIGINS: usize = 256;
+
+/// State of an origin.
+#[derive(Clone, Copy)]
+enum Entry {
+    /// HTTP/3 advertised until the instant.
+    Advertised(Instant),
+    /// HTTP/3 failed, not tried again until the instant.
+    Broken(Instant),
+}
+
+impl Entry {
+    fn expiry(&self) -> Instant {
+        match self {
+            Entry::Advertised(at) | Entry::Broken(at) => *at,
+        }
+    }
+}
+
+/// Cache of the HTTP/3 advertisements of origins.
+pub struct AltSvcCache {
+    entries: Mutex<HashMap<String, Entry>>,
+}
+
+impl AltSvcCache {
+    /// Creates an empty cache.
+    pub fn new() -> Self {
+        Self {
+            entries: Mutex::new(HashMap::new()),
+        }
+    }
+
+    /// Returns the cache shared by the requests of the process.
+    pub fn global() -> &'static AltSvcCache {
+        static CACHE: OnceLock<AltSvcCache> = OnceLock::new();
+        CACHE.get_or_init(AltSvcCache::new)
+    }
+
+    /// Records the `Alt-Svc` header an origin answered with.
+    ///
+    /// # Arguments
+    ///
+    /// * `origin` - The origin of the request, see `stats::origin`.
+    /// * `value` - The value of the header.
+    pub fn record(&self, origin: &str, value: &str) {
+        let now = Instant::now();
+        let mut entries = self.entries.lock().unwrap();
+        if matches!(entries.get(origin), Some(Entry::Broken(at)) if *at > now) {
+            return;
+        }
+        match parse_h3(origin, value) {
+            Some(Advert::Clear) => {
+                entries.remove(origin);
+            }
+            Some(Advert::H3(max_age)) => {
+                if !entries.contains_key(origin) && entries.len() >= MAX_ORIGINS {
+                    entries.retain(|_, entry| entry.expiry() > now);
+                    if entries.len() >= MAX_ORIGINS {
+                        return;
+                    }
+                }
+                entries.insert(origin.to_string(), Entry::Advertised(now + max_age));
+            }
+            None => {}
+        }
+    }
+
+    /// Returns `true` if HTTP/3 is to be tried on the origin.
+    pub fn advertised(&self, origin: &str) -> bool {
+        let entries = self.entries.lock().unwrap();
+        matches!(entries.get(origin), Some(Entry::Advertised(at)) if *at > Instant::now())
+    }
+
+    /// Records that an HTTP/3 request to the origin failed.
+    pub fn mark_broken(&self, origin: &str) {
+        let mut entries = self.entries.lock().unwrap();
+        if let Some(entry) = entries.get_mut(origin) {
+            *entry = Entry::Broken(Instant::now() + BROKEN_FOR);
+        }
+    }
+}
+
+/// What an `Alt-Svc` header tells about HTTP/3 on the origin.
+#[derive(Debug, PartialEq, Eq)]
+enum Advert {
+    /// The origin withdrew its alternatives.
+    Clear,
+    /// HTTP/3 is served on the host and port of the origin for the duration.
+    H3(Duration),
+}
+
+/// Parses an `Alt-Svc` header for HTTP/3 on the host and port of `origin`.
+///
+/// Alternatives on another host or port are ignored, requests only switch
+/// protocol and not endpoint.
+fn parse_h3(origin: &str, value: &str) -> Option<Advert> {
+    if value.trim() == "clear" {
+        return Some(Advert::Clear);
+    }
+    let (scheme, authority) = origin.split_once("://")?;
+    if scheme != "https" {
+        return None;
+    }
+    // The last colon of a bracketed IPv6 address without port is inside it
+    let (host, port) = match authority.rfind(':') {
+        Some(i) if !authority[i..].contains(']') => (&authority[..i], &authority[i + 1..]),
+        _ => (authority, "443"),
+    };
+    for alternative in value.split(',') {
+        let mut params = alternative.split(';').map(str::trim);
+        let Some((protocol, alt_authority)) = params.next().and_then(|p| p.split_once('=')) else {
+            continue;
+        };
+        if protocol.trim() != "h3" {
+            continue;
+        }
+        let alt_authority = alt_authority.trim().trim_matches('"');
+        let Some((alt_host, alt_port)) = alt_authority.rsplit_once(':') else {
+            continue;
+        };
+        if (!alt_host.is_empty() && !alt_host.eq_ignore_ascii_case(host)) || alt_port != port {
+            continue;
+        }
+        let max_age = params
+            .filter_map(|param| param.split_once('='))
+            .find(|(key, _)| key.trim() == "ma")
+            .and_then(|(_, secs)| secs.trim().trim_matches('"').parse::<u64>().ok())
+            .map_or(DEFAULT_MAX_AGE, Duration::from_secs);
+        return Some(Advert::H3(max_age));
+    }
+    None
+}
+
+#[cfg(test)]
+mod ut_alt_svc {
+    include!("../tests/ut/ut_alt_svc.rs");
+}
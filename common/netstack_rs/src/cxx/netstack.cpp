@@ -48,6 +48,24 @@ void SetRequestSslType(HttpClientRequest &request, const std::string &sslType)
     return;
 }
 
+void SetRequestHttp3(HttpClientRequest &request, bool enabled)
+{
+    request.SetHttpProtocol(enabled ? HttpProtocol::HTTP3 : HttpProtocol::HTTP_NONE);
+}
+
+bool IsRequestHttp3(const HttpClientRequest &request)
+{
+    return request.GetHttpProtocol() == HttpProtocol::HTTP3;
+}
+
+std::shared_ptr<HttpClientTask> NewFallbackTask(const HttpClientRequest &request)
+{
+    // Same request over whatever protocol the client negotiates on TCP
+    HttpClientRequest fallback = request;
+    fallback.SetHttpProtocol(HttpProtocol::HTTP_NONE);
+    return NewHttpClientTask(fallback);
+}
+
 rust::vec<rust::string> GetHeaders(HttpClientResponse &response)
 {
     rust::vec<rust::string> ret;
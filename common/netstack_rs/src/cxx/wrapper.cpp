@@ -41,6 +41,9 @@ void OnCallback(const std::shared_ptr<HttpClientTask> &task, rust::Box<CallbackW
     });
     auto weak = task->weak_from_this();
     task->OnDataReceive([shared, weak](const HttpClientRequest &, const uint8_t *data, size_t size) {
+        if (shared->on_data_receive_direct(data, size)) {
+            return;
+        }
         auto httpTask = weak.lock();
         if (httpTask != nullptr) {
             shared->on_data_receive(httpTask, data, size);
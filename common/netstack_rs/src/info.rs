@@ -17,12 +17,17 @@
 //! various metrics and information related to network downloads, including
 //! performance timings, resource details, and network configuration.
 
+use std::borrow::Cow;
+use std::sync::atomic::{AtomicU64, Ordering};
 use std::sync::Mutex;
+use std::time::{Duration, SystemTime, UNIX_EPOCH};
 
 use request_utils::lru::LRUCache;
 use request_utils::task_id::TaskId;
 use request_utils::{debug, info};
 
+use crate::stats::{OriginStats, TimingRing};
+
 /// Represents performance metrics for network operations.
 ///
 /// This struct tracks various timing metrics during network operations,
@@ -192,6 +197,10 @@ struct NetworkInfo {
     addr: String,
     /// DNS servers used for resolution.
     dns: Vec<String>,
+    /// Scheme, host and port of the requested URL.
+    origin: String,
+    /// Whether the request asked for HTTP/3.
+    http3: bool,
 }
 
 impl NetworkInfo {
@@ -202,6 +211,8 @@ impl NetworkInfo {
         NetworkInfo {
             addr: String::new(),
             dns: Vec::new(),
+            origin: String::new(),
+            http3: false,
         }
     }
 
@@ -242,6 +253,15 @@ impl NetworkInfo {
     }
 }
 
+/// Connection pool usage of the HTTP client as seen by a download.
+#[derive(Clone, Copy, Default)]
+struct PoolInfo {
+    /// Downloads recorded so far that reused a pooled connection.
+    hits: u64,
+    /// Downloads recorded so far that opened a new connection.
+    misses: u64,
+}
+
 /// Combines resource, network, and performance information for a download operation.
 ///
 /// Provides a unified view of all relevant information about a download, including
@@ -254,17 +274,20 @@ pub struct DownloadInfo {
     network: NetworkInfo,
     /// Performance metrics tracking operation timings.
     performance: RustPerformanceInfo,
+    /// Connection pool counters when this download was recorded.
+    pool: PoolInfo,
 }
 
 impl DownloadInfo {
     /// Creates a new `DownloadInfo` instance with default values.
     ///
     /// Initializes all nested structures with their default values.
-    pub(crate) fn new() -> Self {
+    pub fn new() -> Self {
         Self {
             resource: ResourceInfo::new(),
             network: NetworkInfo::new(),
             performance: RustPerformanceInfo::default(),
+            pool: PoolInfo::default(),
         }
     }
 
@@ -299,6 +322,16 @@ impl DownloadInfo {
         self.network.set_ip_address(addr);
     }
 
+    /// Sets the origin of the requested URL.
+    pub(crate) fn set_origin(&mut self, origin: String) {
+        self.network.origin = origin;
+    }
+
+    /// Sets whether the request asked for HTTP/3.
+    pub(crate) fn set_http3(&mut self, http3: bool) {
+        self.network.http3 = http3;
+    }
+
     /// Returns the DNS resolution time in milliseconds.
     ///
     /// # Returns
@@ -388,6 +421,48 @@ impl DownloadInfo {
     pub fn dns_servers(&self) -> Vec<String> {
         self.network.dns()
     }
+
+    /// Returns the scheme, host and port of the requested URL.
+    pub fn origin(&self) -> &str {
+        &self.network.origin
+    }
+
+    /// Returns `true` if the download was made over HTTP/3.
+    ///
+    /// A failed HTTP/3 attempt is recorded as such before the download falls
+    /// back to HTTP/1.1 or HTTP/2, its timings are those of the attempt.
+    pub fn http3(&self) -> bool {
+        self.network.http3
+    }
+
+    /// Returns the key the timings of the download are grouped by: the
+    /// origin, followed by ` h3` for HTTP/3.
+    fn timing_key(&self) -> Cow<'_, str> {
+        match self.http3() {
+            true => Cow::Owned(format!("{} h3", self.origin())),
+            false => Cow::Borrowed(self.origin()),
+        }
+    }
+
+    /// Returns `true` if the download reused a pooled connection.
+    ///
+    /// The client reports a connect time of zero for a reused connection, a
+    /// download without timings did not reach the network.
+    pub fn connection_reused(&self) -> bool {
+        self.total_time() > 0.0 && self.connect_time() == 0.0
+    }
+
+    /// Returns how many recorded downloads reused a pooled connection, up to
+    /// and including this one.
+    pub fn pool_hits(&self) -> u64 {
+        self.pool.hits
+    }
+
+    /// Returns how many recorded downloads opened a new connection, up to and
+    /// including this one.
+    pub fn pool_misses(&self) -> u64 {
+        self.pool.misses
+    }
 }
 
 /// Tracks the capacity and usage statistics of an information collection.
@@ -558,6 +633,12 @@ impl InfoCollection {
 pub struct DownloadInfoMgr {
     /// Thread-safe wrapper around the information collection.
     info: Mutex<InfoCollection>,
+    /// Recorded downloads that reused a pooled connection.
+    pool_hits: AtomicU64,
+    /// Recorded downloads that opened a new connection.
+    pool_misses: AtomicU64,
+    /// Timings of the latest downloads, kept whatever the list size.
+    timings: TimingRing,
 }
 
 impl DownloadInfoMgr {
@@ -574,6 +655,9 @@ impl DownloadInfoMgr {
     pub fn new() -> Self {
         DownloadInfoMgr {
             info: Mutex::new(InfoCollection::new()),
+            pool_hits: AtomicU64::new(0),
+            pool_misses: AtomicU64::new(0),
+            timings: TimingRing::new(),
         }
     }
 
@@ -590,7 +674,29 @@ impl DownloadInfoMgr {
     /// # Safety
     ///
     /// This function will panic if the underlying mutex is poisoned.
-    pub fn insert_download_info(&self, task_id: TaskId, info: DownloadInfo) {
+    pub fn insert_download_info(&self, task_id: TaskId, mut info: DownloadInfo) {
+        if info.total_time() > 0.0 {
+            self.timings.push(
+                &info.timing_key(),
+                millis_since_epoch(),
+                [
+                    info.dns_time(),
+                    info.connect_time(),
+                    info.tls_time(),
+                    info.first_recv_time(),
+                    info.total_time(),
+                ],
+            );
+            let counter = match info.connection_reused() {
+                true => &self.pool_hits,
+                false => &self.pool_misses,
+            };
+            counter.fetch_add(1, Ordering::Relaxed);
+        }
+        info.pool = PoolInfo {
+            hits: self.pool_hits.load(Ordering::Relaxed),
+            misses: self.pool_misses.load(Ordering::Relaxed),
+        };
         let mut info_guard = self.info.lock().unwrap();
         info_guard.insert_info(task_id, info);
     }
@@ -634,6 +740,29 @@ impl DownloadInfoMgr {
         let mut info_guard = self.info.lock().unwrap();
         info_guard.info_list.get(&task_id).cloned()
     }
+
+    /// Returns timing percentiles of the downloads finished within a window,
+    /// grouped by origin, those over HTTP/3 apart under the origin followed
+    /// by ` h3`.
+    ///
+    /// Only the latest `RING_SIZE` downloads are kept, older ones are not
+    /// counted even if they are inside the window.
+    ///
+    /// # Arguments
+    ///
+    /// * `window` - How far back to look from now.
+    pub fn timing_stats(&self, window: Duration) -> Vec<OriginStats> {
+        let since = millis_since_epoch().saturating_sub(window.as_millis() as u64);
+        self.timings.stats(since)
+    }
+}
+
+/// Returns the current time in milliseconds since the Unix epoch.
+fn millis_since_epoch() -> u64 {
+    SystemTime::now()
+        .duration_since(UNIX_EPOCH)
+        .map(|d| d.as_millis() as u64)
+        .unwrap_or(0)
 }
 
 #[cfg(test)]
@@ -23,6 +23,7 @@
 //! * [`response`] - Types and functionality for handling HTTP responses
 //! * [`error`] - Error types and handling
 //! * [`info`] - Types for download and performance information
+//! * [`alt_svc`] - Origins that advertised HTTP/3
 
 #![warn(
     missing_docs,
@@ -68,6 +69,18 @@ mod wrapper;
 /// performance metrics during HTTP operations.
 pub mod info;
 
+/// Aggregated timing statistics of downloads.
+///
+/// This module keeps the timings of recent downloads in a lock-free ring and
+/// computes their percentiles by origin.
+pub mod stats;
+
+/// Origins that advertised HTTP/3.
+///
+/// This module caches the `Alt-Svc` advertisements of origins, telling
+/// which requests may use HTTP/3.
+pub mod alt_svc;
+
 use hilog_rust::{HiLogLabel, LogType};
 
 /// Log label used for logging within the netstack_rs crate.
@@ -25,7 +25,11 @@ use crate::error::HttpClientError;
 use crate::info::{DownloadInfo, DownloadInfoMgr};
 use crate::response::Response;
 use crate::task::RequestTask;
-use crate::wrapper::ffi::{HttpClientRequest, NewHttpClientRequest, SetBody, SetRequestSslType};
+use crate::alt_svc::AltSvcCache;
+use crate::stats::origin;
+use crate::wrapper::ffi::{
+    HttpClientRequest, NewHttpClientRequest, SetBody, SetRequestHttp3, SetRequestSslType,
+};
 /// Builder for creating HTTP requests with configurable options.
 ///
 /// Provides a fluent interface for configuring and building HTTP requests
@@ -55,6 +59,8 @@ pub struct Request<C: RequestCallback + 'static> {
     info_mgr: Option<Arc<DownloadInfoMgr>>,
     /// Optional task identifier for request tracking
     task_id: Option<TaskId>,
+    /// Whether HTTP/3 is used once the origin advertised it
+    http3: bool,
 }
 
 impl<C: RequestCallback> Request<C> {
@@ -68,6 +74,7 @@ impl<C: RequestCallback> Request<C> {
             callback: None,
             info_mgr: None,
             task_id: None,
+            http3: false,
         }
     }
 
@@ -151,6 +158,24 @@ impl<C: RequestCallback> Request<C> {
         self
     }
 
+    /// Lets the request use HTTP/3 if its origin advertised it in an
+    /// `Alt-Svc` header of a previous response.
+    ///
+    /// The request falls back to HTTP/1.1 or HTTP/2 at once if HTTP/3 fails,
+    /// and the origin is then not tried over HTTP/3 for a while.
+    ///
+    /// # Arguments
+    ///
+    /// * `enabled` - Whether HTTP/3 may be used
+    ///
+    /// # Returns
+    ///
+    /// A mutable reference to `self` for method chaining
+    pub fn http3(&mut self, enabled: bool) -> &mut Self {
+        self.http3 = enabled;
+        self
+    }
+
     /// Sets the request body as raw bytes.
     ///
     /// # Arguments
@@ -253,6 +278,12 @@ impl<C: RequestCallback> Request<C> {
     /// Transfers all configured callbacks and trackers to the new task. If a callback,
     /// info manager, and task ID are all provided, they are set together on the task.
     pub fn build(mut self) -> Option<RequestTask> {
+        if self.http3 {
+            let origin = origin(&self.inner.GetURL().to_string_lossy());
+            if AltSvcCache::global().advertised(&origin) {
+                SetRequestHttp3(self.inner.pin_mut(), true);
+            }
+        }
         RequestTask::from_http_request(&self.inner).map(|mut task| {
             // Transfer ownership of callback, info_mgr, and task_id to the task if all are present
             if let (Some(callback), Some(mgr), Some(task_id)) = (
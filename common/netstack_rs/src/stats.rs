@@ -0,0 +1,250 @@
+// Copyright (C) 2024 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Lock-free ring of download timings with aggregated statistics.
+//!
+//! Every finished download writes one record into a fixed-size ring without
+//! taking a lock. Each slot is guarded by a sequence number that is odd while
+//! the slot is written, so readers skip slots that change under them. Origins
+//! are interned once into a fixed table, a record only stores their index.
+
+use std::collections::hash_map::DefaultHasher;
+use std::collections::HashMap;
+use std::hash::{Hash, Hasher};
+use std::sync::atomic::{fence, AtomicU64, Ordering};
+use std::sync::OnceLock;
+
+/// Number of records kept, older records are overwritten.
+pub const RING_SIZE: usize = 1024;
+
+/// Number of distinct origins kept, records of further origins are dropped.
+const MAX_ORIGINS: usize = 256;
+
+/// Timings of a download in milliseconds: dns, connect, tls, first byte
+/// received and total.
+pub type Timings = [f64; 5];
+
+/// A slot of the ring.
+struct Slot {
+    /// Twice the record index plus one while written, plus two once written
+    seq: AtomicU64,
+    /// Index of the origin in the origin table
+    origin: AtomicU64,
+    /// Finish time in milliseconds since the Unix epoch
+    at: AtomicU64,
+    /// Bits of the timings
+    timings: [AtomicU64; 5],
+}
+
+impl Slot {
+    fn new() -> Self {
+        Self {
+            seq: AtomicU64::new(0),
+            origin: AtomicU64::new(0),
+            at: AtomicU64::new(0),
+            timings: Default::default(),
+        }
+    }
+}
+
+/// The 50th, 95th and 99th percentiles of a timing, in milliseconds.
+#[derive(Clone, Copy, Default, Debug, PartialEq)]
+pub struct Percentiles {
+    pub p50: f64,
+    pub p95: f64,
+    pub p99: f64,
+}
+
+impl Percentiles {
+    /// Computes the nearest-rank percentiles of unsorted values.
+    fn of(mut values: Vec<f64>) -> Self {
+        if values.is_empty() {
+            return Self::default();
+        }
+        values.sort_by(f64::total_cmp);
+        let rank = |p: usize| {
+            let n = values.len();
+            values[((n * p + 99) / 100).clamp(1, n) - 1]
+        };
+        Self {
+            p50: rank(50),
+            p95: rank(95),
+            p99: rank(99),
+        }
+    }
+}
+
+/// Timing percentiles of the downloads from an origin.
+#[derive(Clone, Debug, PartialEq)]
+pub struct OriginStats {
+    /// Scheme, host and port the downloads were made to
+    pub origin: String,
+    /// Number of downloads aggregated
+    pub count: usize,
+    pub dns: Percentiles,
+    pub connect: Percentiles,
+    pub tls: Percentiles,
+    /// Time to the first byte received
+    pub ttfb: Percentiles,
+    pub total: Percentiles,
+}
+
+/// Fixed-size ring of download timings.
+pub struct TimingRing {
+    /// Index of the next record
+    head: AtomicU64,
+    slots: Box<[Slot]>,
+    origins: Box<[OnceLock<Box<str>>]>,
+}
+
+impl TimingRing {
+    /// Creates an empty ring.
+    pub fn new() -> Self {
+        Self {
+            head: AtomicU64::new(0),
+            slots: (0..RING_SIZE).map(|_| Slot::new()).collect(),
+            origins: (0..MAX_ORIGINS).map(|_| OnceLock::new()).collect(),
+        }
+    }
+
+    /// Records the timings of a download.
+    ///
+    /// # Arguments
+    ///
+    /// * `origin` - Origin the download was made to
+    /// * `at` - Finish time in milliseconds since the Unix epoch
+    /// * `timings` - Timings of the download
+    pub fn push(&self, origin: &str, at: u64, timings: Timings) {
+        let Some(origin) = self.intern(origin) else {
+            return;
+        };
+        let index = self.head.fetch_add(1, Ordering::Relaxed);
+        let slot = &self.slots[(index % RING_SIZE as u64) as usize];
+        // A slot being written or already claimed by a later record is kept,
+        // this record is dropped
+        let seq = slot.seq.load(Ordering::Relaxed);
+        if seq % 2 == 1
+            || seq > 2 * index
+            || slot
+                .seq
+                .compare_exchange(seq, 2 * index + 1, Ordering::Acquire, Ordering::Relaxed)
+                .is_err()
+        {
+            return;
+        }
+        fence(Ordering::Release);
+        slot.origin.store(origin, Ordering::Relaxed);
+        slot.at.store(at, Ordering::Relaxed);
+        for (cell, timing) in slot.timings.iter().zip(timings) {
+            cell.store(timing.to_bits(), Ordering::Relaxed);
+        }
+        slot.seq.store(2 * index + 2, Ordering::Release);
+    }
+
+    /// Aggregates the records finished at or after `since`, by origin.
+    ///
+    /// # Arguments
+    ///
+    /// * `since` - Start of the window in milliseconds since the Unix epoch
+    ///
+    /// # Returns
+    ///
+    /// The statistics of every origin with records in the window, ordered by
+    /// origin
+    pub fn stats(&self, since: u64) -> Vec<OriginStats> {
+        let mut groups: HashMap<u64, Vec<Timings>> = HashMap::new();
+        for slot in self.slots.iter() {
+            if let Some((origin, timings)) = Self::read(slot, since) {
+                groups.entry(origin).or_default().push(timings);
+            }
+        }
+        let mut stats = groups
+            .into_iter()
+            .filter_map(|(origin, records)| {
+                let name = self.origins.get(origin as usize)?.get()?;
+                let column = |i: usize| Percentiles::of(records.iter().map(|t| t[i]).collect());
+                Some(OriginStats {
+                    origin: name.to_string(),
+                    count: records.len(),
+                    dns: column(0),
+                    connect: column(1),
+                    tls: column(2),
+                    ttfb: column(3),
+                    total: column(4),
+                })
+            })
+            .collect::<Vec<_>>();
+        stats.sort_by(|a, b| a.origin.cmp(&b.origin));
+        stats
+    }
+
+    /// Reads a slot, `None` if it is empty, being written or too old.
+    fn read(slot: &Slot, since: u64) -> Option<(u64, [f64; 5])> {
+        let seq = slot.seq.load(Ordering::Acquire);
+        if seq == 0 || seq % 2 == 1 {
+            return None;
+        }
+        let origin = slot.origin.load(Ordering::Relaxed);
+        let at = slot.at.load(Ordering::Relaxed);
+        let mut timings = [0f64; 5];
+        for (timing, cell) in timings.iter_mut().zip(slot.timings.iter()) {
+            *timing = f64::from_bits(cell.load(Ordering::Relaxed));
+        }
+        fence(Ordering::Acquire);
+        if slot.seq.load(Ordering::Relaxed) != seq || at < since {
+            return None;
+        }
+        Some((origin, timings))
+    }
+
+    /// Returns the index of an origin in the origin table, adding it if new.
+    fn intern(&self, origin: &str) -> Option<u64> {
+        let mut hasher = DefaultHasher::new();
+        origin.hash(&mut hasher);
+        let start = hasher.finish() as usize;
+        for probe in 0..MAX_ORIGINS {
+            let i = (start + probe) % MAX_ORIGINS;
+            if self.origins[i].get_or_init(|| origin.into()).as_ref() == origin {
+                return Some(i as u64);
+            }
+        }
+        None
+    }
+}
+
+/// Returns the origin of a URL: its lowercase scheme, host and port.
+///
+/// # Examples
+///
+/// ```
+/// use netstack_rs::stats::origin;
+///
+/// assert_eq!(origin("HTTPS://Example.com:8443/a?b"), "https://example.com:8443");
+/// assert_eq!(origin("https://user@example.com#top"), "https://example.com");
+/// ```
+pub fn origin(url: &str) -> String {
+    let (scheme, rest) = url.split_once("://").unwrap_or(("", url));
+    let end = rest.find(['/', '?', '#']).unwrap_or(rest.len());
+    let authority = &rest[..end];
+    let authority = authority.rsplit_once('@').map_or(authority, |(_, a)| a);
+    if scheme.is_empty() {
+        authority.to_ascii_lowercase()
+    } else {
+        format!("{}://{}", scheme, authority).to_ascii_lowercase()
+    }
+}
+
+#[cfg(test)]
+mod ut_stats {
+    include!("../tests/ut/ut_stats.rs");
+}
@@ -128,6 +128,19 @@ impl RequestTask {
         })
     }
 
+    /// Creates a RequestTask sharing the state of an existing one.
+    ///
+    /// # Arguments
+    ///
+    /// * `inner` - The task slot of the existing RequestTask
+    /// * `reset` - The reset flag of the existing RequestTask
+    pub(crate) fn from_shared(
+        inner: Arc<Mutex<SharedPtr<HttpClientTask>>>,
+        reset: Arc<AtomicBool>,
+    ) -> Self {
+        Self { inner, reset }
+    }
+
     /// Creates a RequestTask from a raw FFI task pointer.
     ///
     /// # Arguments
@@ -217,6 +230,16 @@ impl RequestTask {
         self.response().headers()
     }
 
+    /// Gets the URL the task requests.
+    pub(crate) fn url(&mut self) -> String {
+        let task = self.inner.lock().unwrap().clone();
+        Self::pin_mut(&task)
+            .GetRequest()
+            .GetURL()
+            .to_string_lossy()
+            .into_owned()
+    }
+
     /// Sets the callback handler for this task.
     ///
     /// # Arguments
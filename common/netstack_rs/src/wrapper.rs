@@ -23,16 +23,18 @@ use std::sync::{Arc, Mutex, Weak};
 use cxx::SharedPtr;
 use ffi::{
     GetHttpAddress, GetPerformanceInfo, GetResolvConf, HttpClientRequest, HttpClientTask,
-    NewHttpClientTask, OnCallback,
+    IsRequestHttp3, NewFallbackTask, NewHttpClientTask, OnCallback,
 };
 use ffrt_rs::{ffrt_sleep, ffrt_spawn};
 use request_utils::error;
 use request_utils::task_id::TaskId;
 
+use crate::alt_svc::AltSvcCache;
 use crate::error::{HttpClientError, HttpErrorCode};
 use crate::info::{DownloadInfo, DownloadInfoMgr, RustPerformanceInfo};
 use crate::request::RequestCallback;
 use crate::response::{Response, ResponseCode};
+use crate::stats::origin;
 use crate::task::{RequestTask, TaskStatus};
 
 /// Result type for task creation operations.
@@ -119,11 +121,13 @@ impl CallbackWrapper {
     ///
     /// * `_request` - The HTTP request that completed
     /// * `response` - The HTTP response received
-    fn on_success(&mut self, _request: &HttpClientRequest, response: &ffi::HttpClientResponse) {
+    fn on_success(&mut self, request: &HttpClientRequest, response: &ffi::HttpClientResponse) {
         // Collect performance metrics from the response
         let mut performance = RustPerformanceInfo::default();
         GetPerformanceInfo(response, Pin::new(&mut performance));
         let addr = GetHttpAddress(response);
+        self.info.set_origin(origin(&request.GetURL().to_string_lossy()));
+        self.info.set_http3(IsRequestHttp3(request));
         self.info.set_performance(performance);
         self.info.set_ip_address(addr);
         self.info.set_size(self.current as i64);
@@ -170,6 +174,9 @@ impl CallbackWrapper {
         let mut performance = RustPerformanceInfo::default();
         GetPerformanceInfo(response, Pin::new(&mut performance));
         let addr = GetHttpAddress(response);
+        let http3 = IsRequestHttp3(request);
+        self.info.set_origin(origin(&request.GetURL().to_string_lossy()));
+        self.info.set_http3(http3);
         self.info.set_performance(performance);
         self.info.set_ip_address(addr);
         self.info.set_size(self.current as i64);
@@ -192,8 +199,22 @@ impl CallbackWrapper {
         };
 
         let info = self.info.clone();
+        // A failed HTTP/3 request falls back to TCP at once, without counting
+        // as a retry
+        if http3 {
+            AltSvcCache::global().mark_broken(self.info.origin());
+            match self.create_new_task(callback, request, true) {
+                NewTaskResult::Success(new_task, mut new_callback) => {
+                    new_callback.tries = self.tries;
+                    Self::start_new_task(new_task, new_callback);
+                }
+                NewTaskResult::Failed(mut callback) => callback.on_fail(error, info),
+            }
+            return;
+        }
+
         // Attempt to create a new task for retrying
-        let (new_task, mut new_callback) = match self.create_new_task(callback, request) {
+        let (new_task, mut new_callback) = match self.create_new_task(callback, request, false) {
             NewTaskResult::Success(new_task, new_callback) => (new_task, new_callback),
             NewTaskResult::Failed(mut callback) => {
                 // If task creation failed, call the fail callback
@@ -247,7 +268,7 @@ impl CallbackWrapper {
         // Check if a reset is requested
         if self.reset.load(Ordering::SeqCst) {
             // Attempt to create a new task for restarting
-            let (new_task, new_callback) = match self.create_new_task(callback, request) {
+            let (new_task, new_callback) = match self.create_new_task(callback, request, false) {
                 NewTaskResult::Success(new_task, new_callback) => (new_task, new_callback),
                 NewTaskResult::Failed(mut callback) => {
                     // If task creation failed, call the cancel callback
@@ -264,21 +285,48 @@ impl CallbackWrapper {
         }
     }
 
+    /// Handles received data with the task passed by the C++ side.
     fn on_data_receive(
         &mut self,
         task: SharedPtr<ffi::HttpClientTask>,
         data: *const u8,
         size: usize,
     ) {
+        self.deliver(RequestTask::from_ffi(task), data, size);
+    }
+
+    /// Handles received data with the task the callback was registered for.
+    ///
+    /// Reusing the registered task spares the C++ side locking its weak task
+    /// pointer and a new task wrapper for every chunk.
+    ///
+    /// # Returns
+    ///
+    /// `false` if every handle of the registered task is dropped, the chunk
+    /// must then be passed to `on_data_receive`
+    fn on_data_receive_direct(&mut self, data: *const u8, size: usize) -> bool {
+        let Some(inner) = self.task.upgrade() else {
+            return false;
+        };
+        self.deliver(RequestTask::from_shared(inner, self.reset.clone()), data, size);
+        true
+    }
+
+    /// Forwards a chunk of received data to the user callback.
+    fn deliver(&mut self, mut task: RequestTask, data: *const u8, size: usize) {
         // Check if user callback is available
         let Some(callback) = self.inner.as_mut() else {
             return;
         };
+        // Record the HTTP/3 advertisement of the origin once the body starts
+        if self.current == 0 {
+            record_alt_svc(&mut task);
+        }
         // Update progress counter
         self.current += size as u64;
+        // SAFETY: netstack keeps the chunk alive for the duration of the call
         let data = unsafe { std::slice::from_raw_parts(data, size) };
-        let task = RequestTask::from_ffi(task);
-        // Forward data to user callback
+        // Forward data to user callback, which copies what it keeps
         callback.on_data_receive(data, task);
     }
 
@@ -307,6 +355,7 @@ impl CallbackWrapper {
     ///
     /// * `callback` - The user callback to use with the new task
     /// * `request` - The HTTP request to create a new task for
+    /// * `fallback` - Whether the new task drops HTTP/3 for TCP
     ///
     /// # Returns
     ///
@@ -315,6 +364,7 @@ impl CallbackWrapper {
         &mut self,
         mut callback: Box<dyn RequestCallback>,
         request: &HttpClientRequest,
+        fallback: bool,
     ) -> NewTaskResult {
         // Notify the callback if we're restarting a partially completed request
         if self.current > 0 {
@@ -322,7 +372,10 @@ impl CallbackWrapper {
         }
 
         // Create a new HTTP task from the request
-        let new_task = NewHttpClientTask(request);
+        let new_task = match fallback {
+            true => NewFallbackTask(request),
+            false => NewHttpClientTask(request),
+        };
         // Check if task creation failed
         if new_task.is_null() {
             error!("create_new_task NewHttpClientTask return null.");
@@ -361,6 +414,13 @@ impl CallbackWrapper {
     }
 }
 
+/// Records the `Alt-Svc` header the origin of a task answered with.
+fn record_alt_svc(task: &mut RequestTask) {
+    if let Some(value) = task.headers().get("alt-svc") {
+        AltSvcCache::global().record(&origin(&task.url()), value);
+    }
+}
+
 // SAFETY: HttpClientTask is thread-safe through its shared pointer implementation
 unsafe impl Send for HttpClientTask {}
 unsafe impl Sync for HttpClientTask {}
@@ -393,6 +453,11 @@ pub(crate) mod ffi {
             data: *const u8,
             size: usize,
         );
+        unsafe fn on_data_receive_direct(
+            self: &mut CallbackWrapper,
+            data: *const u8,
+            size: usize,
+        ) -> bool;
         fn on_progress(
             self: &mut CallbackWrapper,
             dl_total: u64,
@@ -427,6 +492,8 @@ pub(crate) mod ffi {
         type HttpClientRequest;
 
         fn SetRequestSslType(request: Pin<&mut HttpClientRequest>, ssl_type: &CxxString);
+        fn SetRequestHttp3(request: Pin<&mut HttpClientRequest>, enabled: bool);
+        fn IsRequestHttp3(request: &HttpClientRequest) -> bool;
         fn SetCaPath(self: Pin<&mut HttpClientRequest>, path: &CxxString);
 
         #[namespace = "OHOS::NetStack::HttpClient"]
@@ -438,13 +505,16 @@ pub(crate) mod ffi {
         fn SetHeader(self: Pin<&mut HttpClientRequest>, key: &CxxString, val: &CxxString);
         fn SetTimeout(self: Pin<&mut HttpClientRequest>, timeout: u32);
         fn SetConnectTimeout(self: Pin<&mut HttpClientRequest>, timeout: u32);
+        fn GetURL(self: &HttpClientRequest) -> &CxxString;
         unsafe fn SetBody(request: Pin<&mut HttpClientRequest>, data: *const u8, length: usize);
 
         #[namespace = "OHOS::NetStack::HttpClient"]
         type HttpClientTask;
 
         fn NewHttpClientTask(request: &HttpClientRequest) -> SharedPtr<HttpClientTask>;
+        fn NewFallbackTask(request: &HttpClientRequest) -> SharedPtr<HttpClientTask>;
         fn GetResponse(self: Pin<&mut HttpClientTask>) -> Pin<&mut HttpClientResponse>;
+        fn GetRequest(self: Pin<&mut HttpClientTask>) -> Pin<&mut HttpClientRequest>;
         fn Start(self: Pin<&mut HttpClientTask>) -> bool;
         fn Cancel(self: Pin<&mut HttpClientTask>);
         fn GetStatus(self: Pin<&mut HttpClientTask>) -> TaskStatus;
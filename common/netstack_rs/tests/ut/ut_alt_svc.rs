@@ -0,0 +1,81 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use super::*;
+
+// @tc.name: ut_alt_svc_parse
+// @tc.desc: Test parsing Alt-Svc headers for HTTP/3
+// @tc.precon: NA
+// @tc.step: 1. Parse headers advertising HTTP/3 on the origin, on another
+//              endpoint, other protocols and clearing the alternatives
+// @tc.expect: Only HTTP/3 on the host and port of the origin is taken, with
+//             its max age or the default one
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_alt_svc_parse() {
+    let origin = "https://example.com";
+    assert_eq!(
+        parse_h3(origin, "h3=\":443\"; ma=3600, h3-29=\":443\""),
+        Some(Advert::H3(Duration::from_secs(3600)))
+    );
+    assert_eq!(
+        parse_h3(origin, "h2=\":443\", h3=\"example.com:443\""),
+        Some(Advert::H3(DEFAULT_MAX_AGE))
+    );
+    assert_eq!(parse_h3(origin, "h3=\":8443\"; ma=60"), None);
+    assert_eq!(parse_h3(origin, "h3=\"alt.example.com:443\""), None);
+    assert_eq!(parse_h3(origin, "h3-29=\":443\""), None);
+    assert_eq!(parse_h3("http://example.com", "h3=\":443\""), None);
+    assert_eq!(
+        parse_h3("https://example.com:8443", "h3=\":8443\""),
+        Some(Advert::H3(DEFAULT_MAX_AGE))
+    );
+    assert_eq!(
+        parse_h3("https://[::1]", "h3=\":443\"; ma=5"),
+        Some(Advert::H3(Duration::from_secs(5)))
+    );
+    assert_eq!(parse_h3(origin, "clear"), Some(Advert::Clear));
+}
+
+// @tc.name: ut_alt_svc_cache
+// @tc.desc: Test the HTTP/3 state of origins in the cache
+// @tc.precon: NA
+// @tc.step: 1. Record advertisements, expired ones and clearing ones
+//           2. Mark an origin broken and record it again
+// @tc.expect: Only origins with a live advertisement use HTTP/3, a broken
+//             origin does not until its ban expires
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_alt_svc_cache() {
+    let cache = AltSvcCache::new();
+    let a = "https://a.example.com";
+    let b = "https://b.example.com";
+    assert!(!cache.advertised(a));
+    cache.record(a, "h3=\":443\"");
+    cache.record(b, "h3=\":443\"; ma=0");
+    assert!(cache.advertised(a));
+    assert!(!cache.advertised(b));
+
+    cache.record(b, "h3=\":443\"");
+    cache.record(b, "clear");
+    assert!(!cache.advertised(b));
+
+    cache.mark_broken(a);
+    assert!(!cache.advertised(a));
+    cache.record(a, "h3=\":443\"");
+    assert!(!cache.advertised(a));
+}
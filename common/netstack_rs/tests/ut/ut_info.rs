@@ -182,3 +182,44 @@ fn info_collection_update() {
     assert!(info_mgr.get_download_info(task_id).is_none());
     assert!(info_mgr.get_download_info(task_id_2).is_some());
 }
+
+// @tc.name: info_pool_counters
+// @tc.desc: Test counting downloads that reused a pooled connection
+// @tc.precon: NA
+// @tc.step: 1. Insert a download info with a connect time
+//           2. Insert a download info without a connect time
+//           3. Insert a download info without timings
+// @tc.expect: The first is a miss, the second a hit, the third is not counted
+// and every info carries the counters at its insertion
+// @tc.type: FUNC
+// @tc.require: issue#ICN31I
+// @tc.level: level1
+#[test]
+fn info_pool_counters() {
+    let info_mgr = DownloadInfoMgr::new();
+    info_mgr.update_info_list_size(3);
+    let info = |connect: f64, total: f64| {
+        let mut performance = RustPerformanceInfo::default();
+        performance.set_connect_timing(connect);
+        performance.set_total_timing(total);
+        let mut info = DownloadInfo::new();
+        info.set_performance(performance);
+        info
+    };
+    let first = TaskId::from_url("https://www.example.com/pool/1");
+    let second = TaskId::from_url("https://www.example.com/pool/2");
+    let third = TaskId::from_url("https://www.example.com/pool/3");
+    info_mgr.insert_download_info(first.clone(), info(2.0, 6.0));
+    info_mgr.insert_download_info(second.clone(), info(0.0, 3.0));
+    info_mgr.insert_download_info(third.clone(), DownloadInfo::new());
+
+    let first = info_mgr.get_download_info(first).unwrap();
+    assert!(!first.connection_reused());
+    assert_eq!((first.pool_hits(), first.pool_misses()), (0, 1));
+    let second = info_mgr.get_download_info(second).unwrap();
+    assert!(second.connection_reused());
+    assert_eq!((second.pool_hits(), second.pool_misses()), (1, 1));
+    let third = info_mgr.get_download_info(third).unwrap();
+    assert!(!third.connection_reused());
+    assert_eq!((third.pool_hits(), third.pool_misses()), (1, 1));
+}
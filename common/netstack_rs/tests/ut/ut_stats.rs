@@ -0,0 +1,124 @@
+// Copyright (C) 2024 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use std::sync::Arc;
+use std::thread;
+
+use super::*;
+
+// @tc.name: ut_stats_origin
+// @tc.desc: Test extracting the origin of a URL
+// @tc.precon: NA
+// @tc.step: 1. Call origin with URLs carrying ports, user info, paths and queries
+// @tc.expect: The lowercase scheme, host and port are returned
+// @tc.type: FUNC
+// @tc.require: issue#ICN31I
+// @tc.level: level1
+#[test]
+fn ut_stats_origin() {
+    assert_eq!(origin("https://Example.com/a/b.png"), "https://example.com");
+    assert_eq!(origin("http://u:p@example.com:8080?x=1"), "http://example.com:8080");
+    assert_eq!(origin("example.com/path"), "example.com");
+}
+
+// @tc.name: ut_stats_percentiles
+// @tc.desc: Test the percentiles of timings grouped by origin
+// @tc.precon: NA
+// @tc.step: 1. Push 100 records of one origin and one of another
+//           2. Aggregate them over a window covering both
+// @tc.expect: Each origin has its count and nearest-rank percentiles
+// @tc.type: FUNC
+// @tc.require: issue#ICN31I
+// @tc.level: level1
+#[test]
+fn ut_stats_percentiles() {
+    let ring = TimingRing::new();
+    for i in 1..=100 {
+        let t = i as f64;
+        ring.push("https://a.com", 1000, [t, t, t, t, t * 2.0]);
+    }
+    ring.push("https://b.com", 1000, [1.0, 2.0, 3.0, 4.0, 5.0]);
+
+    let stats = ring.stats(0);
+    assert_eq!(stats.len(), 2);
+    assert_eq!(stats[0].origin, "https://a.com");
+    assert_eq!(stats[0].count, 100);
+    let expected = Percentiles { p50: 50.0, p95: 95.0, p99: 99.0 };
+    assert_eq!(stats[0].dns, expected);
+    assert_eq!(stats[0].ttfb, expected);
+    assert_eq!(stats[0].total.p99, 198.0);
+    assert_eq!(stats[1].origin, "https://b.com");
+    assert_eq!(stats[1].count, 1);
+    assert_eq!(stats[1].tls, Percentiles { p50: 3.0, p95: 3.0, p99: 3.0 });
+}
+
+// @tc.name: ut_stats_window
+// @tc.desc: Test that records before the window and overwritten records are
+// not aggregated
+// @tc.precon: NA
+// @tc.step: 1. Push an old record, then RING_SIZE recent records
+//           2. Aggregate over windows starting before and after the old record
+// @tc.expect: The old record is overwritten, the window excludes older records
+// @tc.type: FUNC
+// @tc.require: issue#ICN31I
+// @tc.level: level1
+#[test]
+fn ut_stats_window() {
+    let ring = TimingRing::new();
+    ring.push("https://old.com", 10, [1.0; 5]);
+    assert_eq!(ring.stats(0).len(), 1);
+    assert!(ring.stats(11).is_empty());
+    for i in 0..RING_SIZE {
+        ring.push("https://a.com", 100 + i as u64, [1.0; 5]);
+    }
+    let stats = ring.stats(0);
+    assert_eq!(stats.len(), 1);
+    assert_eq!(stats[0].count, RING_SIZE);
+    assert_eq!(ring.stats(100 + RING_SIZE as u64 - 10)[0].count, 10);
+}
+
+// @tc.name: ut_stats_concurrent
+// @tc.desc: Test pushing records from several threads at once
+// @tc.precon: NA
+// @tc.step: 1. Push records from four threads while another thread aggregates
+// @tc.expect: Every aggregated record is complete and no more than pushed
+// @tc.type: FUNC
+// @tc.require: issue#ICN31I
+// @tc.level: level1
+#[test]
+fn ut_stats_concurrent() {
+    let ring = Arc::new(TimingRing::new());
+    let writers = (0..4)
+        .map(|n| {
+            let ring = ring.clone();
+            thread::spawn(move || {
+                for _ in 0..200 {
+                    let t = n as f64;
+                    ring.push(&format!("https://{}.com", n), 1, [t; 5]);
+                }
+            })
+        })
+        .collect::<Vec<_>>();
+    for _ in 0..50 {
+        for stat in ring.stats(0) {
+            let t = stat.origin[8..9].parse::<f64>().unwrap();
+            assert_eq!(stat.total, Percentiles { p50: t, p95: t, p99: t });
+            assert!(stat.count <= 200);
+        }
+    }
+    for writer in writers {
+        writer.join().unwrap();
+    }
+    let stats = ring.stats(0);
+    assert_eq!(stats.iter().map(|s| s.count).sum::<usize>(), 800);
+}
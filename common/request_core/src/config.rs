@@ -53,6 +53,9 @@ pub struct TaskConfig {
     pub proxy: String,
     /// Certificate pinning configuration.
     pub certificate_pins: String,
+    /// Expected digest of the downloaded file as `<algorithm>:<hex>`, empty if
+    /// the file is not verified.
+    pub checksum: String,
     /// Additional configuration parameters.
     pub extras: HashMap<String, String>,
     /// API version to use for compatibility.
@@ -106,6 +109,7 @@ pub struct TaskConfigBuilder {
 
     // file
     file_path: Option<String>,
+    checksum: Option<String>,
 
     method: Option<String>,
     index: Option<i32>,
@@ -131,6 +135,7 @@ impl TaskConfigBuilder {
             title: None,
             background: None,
             file_path: None,
+            checksum: None,
             method: None,
             index: None,
             begins: None,
@@ -196,6 +201,13 @@ impl TaskConfigBuilder {
         self
     }
 
+    /// Sets the expected digest of the downloaded file, as `sha256:<hex>` or
+    /// `md5:<hex>`.
+    pub fn checksum(&mut self, checksum: String) -> &mut Self {
+        self.checksum = Some(checksum);
+        self
+    }
+
     pub fn method(&mut self, method: String) -> &mut Self {
         self.method = Some(method);
         self
@@ -255,6 +267,7 @@ impl TaskConfigBuilder {
             token: "".to_string(),
             proxy: "".to_string(),
             certificate_pins: "".to_string(),
+            checksum: self.checksum.unwrap_or_default(),
             extras: HashMap::new(),
             version: self.version,
             form_items: self.data.unwrap_or(vec![]),
@@ -289,6 +302,16 @@ impl TaskConfigBuilder {
                     connection_timeout: 0,
                     total_timeout: 0,
                 },
+                stall_detection: StallDetection::default(),
+                concurrency: 0,
+                chunk_size: 0,
+                deadline: 0,
+                coalesce: false,
+                compression: false,
+                memory_limit: 0,
+                prefetch: false,
+                bypass_cache: false,
+                trace_id: 0,
             },
             saveas: self.file_path.unwrap_or_default(),
             overwrite: false,
@@ -340,6 +363,17 @@ impl ipc::parcel::Serialize for TaskConfig {
         parcel.write(&self.common_data.min_speed.duration)?;
         parcel.write(&self.common_data.timeout.connection_timeout)?;
         parcel.write(&self.common_data.timeout.total_timeout)?;
+        parcel.write(&self.common_data.stall_detection.window)?;
+        parcel.write(&self.common_data.stall_detection.ratio)?;
+        parcel.write(&self.common_data.concurrency)?;
+        parcel.write(&self.common_data.chunk_size)?;
+        parcel.write(&self.common_data.deadline)?;
+        parcel.write(&self.common_data.coalesce)?;
+        parcel.write(&self.common_data.compression)?;
+        parcel.write(&self.common_data.memory_limit)?;
+        parcel.write(&self.common_data.prefetch)?;
+        parcel.write(&self.common_data.bypass_cache)?;
+        parcel.write(&self.common_data.trace_id)?;
 
         // Serialize basic string fields
         parcel.write(&self.url)?;
@@ -350,6 +384,7 @@ impl ipc::parcel::Serialize for TaskConfig {
         parcel.write(&self.data)?;
         parcel.write(&self.proxy)?;
         parcel.write(&self.certificate_pins)?;
+        parcel.write(&self.checksum)?;
 
         // Serialize vector of certificate paths
         parcel.write(&(self.certs_path.len() as u32))?;
@@ -424,6 +459,9 @@ impl ipc::parcel::Serialize for TaskConfig {
         } else {
             parcel.write(&1u32).unwrap();
         }
+
+        // No preloaded body is handed over
+        parcel.write(&false)?;
         Ok(())
     }
 }
@@ -549,6 +587,14 @@ pub struct Timeout {
     pub total_timeout: u64,
 }
 
+/// task stall detection, a window in milliseconds and a percent of the
+/// average throughput, 0 for the defaults of the service
+#[derive(Copy, Clone, Debug, Default)]
+pub struct StallDetection {
+    pub window: i64,
+    pub ratio: i64,
+}
+
 /// Common configuration parameters for network tasks.
 ///
 /// Contains general task settings that apply to both download and upload operations.
@@ -596,6 +642,26 @@ pub struct CommonTaskConfig {
     pub min_speed: MinSpeed,
     /// the timeout of task
     pub timeout: Timeout,
+    /// the stall detection of a download
+    pub stall_detection: StallDetection,
+    /// the number of files of an upload sent at the same time
+    pub concurrency: u32,
+    /// the size of the chunks of a resumable upload
+    pub chunk_size: u64,
+    /// the time in milliseconds since the epoch the task should be done by
+    pub deadline: u64,
+    /// whether a download may share its transfer with identical ones
+    pub coalesce: bool,
+    /// whether a download asks for a compressed body and stores it decoded
+    pub compression: bool,
+    /// cap in bytes of a body kept in memory instead of a file, 0 for a file
+    pub memory_limit: u32,
+    /// whether a background task waits for the prefetch window of the device
+    pub prefetch: bool,
+    /// whether a download keeps its written data out of the page cache
+    pub bypass_cache: bool,
+    /// the trace of the request in the service, 0 if untraced
+    pub trace_id: u64,
 }
 
 //deserialize by service file stub.rs function serialize_task_config
@@ -680,6 +746,34 @@ impl ipc::parcel::Deserialize for TaskConfig {
         let min_speed_speed = parcel.read::<i64>()?;
         let min_speed_duration = parcel.read::<i64>()?;
 
+        // deserialize stall_detection
+        let stall_window = parcel.read::<i64>()?;
+        let stall_ratio = parcel.read::<i64>()?;
+
+        // deserialize concurrency
+        let concurrency = parcel.read::<u32>()?;
+
+        // deserialize chunk size
+        let chunk_size = parcel.read::<u64>()?;
+
+        // deserialize deadline
+        let deadline = parcel.read::<u64>()?;
+
+        // deserialize transfer coalescing
+        let coalesce = parcel.read::<bool>()?;
+
+        // deserialize content decoding
+        let compression = parcel.read::<bool>()?;
+
+        // deserialize in-memory body cap
+        let memory_limit = parcel.read::<u32>()?;
+
+        // deserialize prefetch scheduling
+        let prefetch = parcel.read::<bool>()?;
+
+        // deserialize page cache bypass
+        let bypass_cache = parcel.read::<bool>()?;
+
         Ok(TaskConfig {
             bundle,
             bundle_type,
@@ -693,6 +787,7 @@ impl ipc::parcel::Deserialize for TaskConfig {
             token,
             proxy: "".to_string(),
             certificate_pins: "".to_string(),
+            checksum: "".to_string(),
             extras,
             version: version.into(),
             form_items,
@@ -704,7 +799,17 @@ impl ipc::parcel::Deserialize for TaskConfig {
                 metered, roaming, retry, redirect, index, begins: begins as u64, ends,
                 gauge, precise, priority, background, multipart,
                 min_speed: MinSpeed{ speed: min_speed_speed, duration: min_speed_duration },
-                timeout: Timeout{connection_timeout: 0, total_timeout: 0}
+                timeout: Timeout{connection_timeout: 0, total_timeout: 0},
+                stall_detection: StallDetection { window: stall_window, ratio: stall_ratio },
+                concurrency,
+                chunk_size,
+                deadline,
+                coalesce,
+                compression,
+                memory_limit,
+                prefetch,
+                bypass_cache,
+                trace_id: 0,
             },
             saveas: "".to_string(),
             overwrite: cover,
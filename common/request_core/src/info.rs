@@ -212,6 +212,9 @@ pub enum Reason {
     AppAccount,
     NetworkAppAccount,
     LowSpeed,
+    ChecksumMismatch,
+    BodyTooLarge,
+    OriginUnavailable,
 }
 
 impl From<u32> for Reason {
@@ -249,6 +252,9 @@ impl From<u32> for Reason {
             29 => Reason::AppAccount,
             30 => Reason::NetworkAppAccount,
             31 => Reason::LowSpeed,
+            32 => Reason::ChecksumMismatch,
+            33 => Reason::BodyTooLarge,
+            34 => Reason::OriginUnavailable,
             _ => unimplemented!(),
         }
     }
@@ -304,6 +310,10 @@ pub struct Progress {
     /// Additional progress-related metadata.
     pub extras: HashMap<String, String>,
     pub body_bytes: Vec<u8>,
+    /// Average speed of the running task in bytes per second, 0 otherwise.
+    pub speed: u64,
+    /// Estimated seconds left of the running task, -1 if unknown.
+    pub eta: i64,
 }
 
 /// Data structure for task notifications.
@@ -337,6 +347,10 @@ pub struct InfoProgress {
     pub processed: Vec<usize>,
     /// Additional progress-related metadata.
     pub extras: HashMap<String, String>,
+    /// Average speed of the running task in bytes per second, 0 otherwise.
+    pub speed: u64,
+    /// Estimated seconds left of the running task, -1 if unknown.
+    pub eta: i64,
 }
 
 /// Common progress data shared across different progress representations.
@@ -381,6 +395,27 @@ pub struct CommonTaskInfo {
     pub priority: u32,
 }
 
+/// Transport timings of the latest attempt of a task.
+///
+/// Durations are in milliseconds, -1 if unknown.
+#[derive(Clone, Debug, Default)]
+pub struct Performance {
+    /// Number of the attempt, 0 before the first request was sent.
+    pub attempt: u32,
+    /// Time spent resolving the host.
+    pub dns: i64,
+    /// Time spent establishing the TCP connection.
+    pub connect: i64,
+    /// Time spent in the TLS handshake.
+    pub tls: i64,
+    /// Time from sending the request to receiving the response headers.
+    pub ttfb: i64,
+    /// Time from the response headers to the end of the transfer.
+    pub transfer: i64,
+    /// Host and port of the server.
+    pub server: String,
+}
+
 /// Comprehensive information about a network task.
 ///
 /// Contains all details needed to represent and manage a network task,
@@ -428,6 +463,8 @@ pub struct TaskInfo {
     pub common_data: CommonTaskInfo,
     /// Maximum allowed transfer speed (bytes per second).
     pub max_speed: i64,
+    /// Transport timings of the latest attempt.
+    pub performance: Performance,
 }
 
 impl Deserialize for TaskInfo {
@@ -494,6 +531,8 @@ impl Deserialize for TaskInfo {
         let processed = parcel.read::<u64>().unwrap() as usize;
         let total_processed = parcel.read::<u64>().unwrap() as usize;
         let sizes = parcel.read::<Vec<i64>>().unwrap();
+        let speed = parcel.read::<u64>().unwrap();
+        let eta = parcel.read::<i64>().unwrap();
 
         // Read progress extras
         let extras_len = parcel.read::<u32>().unwrap() as usize;
@@ -530,6 +569,17 @@ impl Deserialize for TaskInfo {
             });
         }
 
+        // Read transport timings of the latest attempt
+        let performance = Performance {
+            attempt: parcel.read::<u32>().unwrap(),
+            dns: parcel.read::<i64>().unwrap(),
+            connect: parcel.read::<i64>().unwrap(),
+            tls: parcel.read::<i64>().unwrap(),
+            ttfb: parcel.read::<i64>().unwrap(),
+            transfer: parcel.read::<i64>().unwrap(),
+            server: parcel.read::<String>().unwrap(),
+        };
+
         // Construct common task information
         let common_data = CommonTaskInfo {
             task_id,
@@ -556,6 +606,8 @@ impl Deserialize for TaskInfo {
             sizes,
             processed: vec![processed; file_specs.len()],
             extras: progress_extras,
+            speed,
+            eta,
         };
 
         // Return constructed TaskInfo
@@ -573,6 +625,7 @@ impl Deserialize for TaskInfo {
             extras, // Extras are not serialized in this context
             common_data,
             max_speed: 0, // Max speed is not serialized in this context
+            performance,
         })
     }
 }
@@ -200,20 +200,33 @@ struct SysEventInfo {
     std::string extraInfo;
 };
 
+// Index of the writer of an event in SysEventLog.
+enum SysEventType : uint8_t {
+    SYS_EVENT_STATISTIC = 0,
+    SYS_EVENT_FAULT,
+    SYS_EVENT_TYPE_COUNT,
+};
+
+// Events are queued without a lock and written by a background thread, so that the caller, often on the
+// UDS receive path or the DB path, does not wait for hisysevent. An event repeating with the same code and
+// bundle is written once per window, the repeats being counted and written when the window ends.
 class SysEventLog {
 public:
-    static void SendSysEventLog(const std::string &eventName, const uint32_t dCode, const std::string bundleName,
-        const std::string moduleName, const std::string extraInfo);
-    static void SendSysEventLog(const std::string &eventName, const uint32_t dCode, const std::string extraInfo);
+    static void SendSysEventLog(const std::string &eventName, const uint32_t dCode, const std::string &bundleName,
+        const std::string &moduleName, const std::string &extraInfo);
+    static void SendSysEventLog(const std::string &eventName, const uint32_t dCode, const std::string &extraInfo);
     static void SendSysEventLog(
         const std::string &eventName, const uint32_t dCode, const int32_t one, const int32_t two);
 
 private:
-    static std::unordered_map<std::string, void (*)(const SysEventInfo &info)> sysEventMap_;
+    friend class SysEventWriter;
 
+    static bool GetType(const std::string &eventName, SysEventType &type);
     static void SendStatisticEvent(const SysEventInfo &info);
     static void SendFaultEvent(const SysEventInfo &info);
 
+    static void (*const writers_[SYS_EVENT_TYPE_COUNT])(const SysEventInfo &info);
+
     template<typename... Types>
     static int32_t HisysWrite(const std::string &eventName, HiviewDFX::HiSysEvent::EventType type, Types... keyValues);
 };
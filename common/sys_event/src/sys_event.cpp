@@ -15,9 +15,20 @@
 
 #include "sys_event.h"
 
+#include <pthread.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdint>
+#include <map>
+#include <mutex>
 #include <string>
-#include <unordered_map>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 #include "hisysevent.h"
 #include "log.h"
@@ -32,51 +43,210 @@ const std::string PARAM_BUNDLE_NAME = "BUNDLE_NAME";
 const std::string PARAM_MODULE_NAME = "MODULE_NAME";
 const std::string PARAM_EXTRA_INFO = "EXTRA_INFO";
 
+// Events waiting for the writer beyond which new ones are dropped.
+constexpr uint32_t MAX_PENDING_EVENTS = 1024;
+constexpr std::chrono::seconds AGGREGATE_WINDOW(10);
+
+struct SysEventRecord {
+    SysEventRecord *next = nullptr;
+    SysEventType type;
+    SysEventInfo info;
+    // Set for the events of the (one, two) overload, whose extra info is formatted by the writer.
+    bool expect = false;
+    int32_t one = 0;
+    int32_t two = 0;
+};
+
 } // namespace
 
-void SysEventLog::SendSysEventLog(const std::string &eventName, const uint32_t dCode, const std::string bundleName,
-    const std::string moduleName, const std::string extraInfo)
-{
-    auto iter = sysEventMap_.find(eventName);
-    if (iter == sysEventMap_.end()) {
-        return;
+// Queue of the events, a lock-free stack the writer thread takes whole, and the windows of the events written
+// lately. The thread is started by the first event.
+class SysEventWriter {
+public:
+    static SysEventWriter &GetInstance()
+    {
+        // Never destroyed, its thread may still wait on it at exit.
+        static SysEventWriter *writer = new SysEventWriter();
+        return *writer;
+    }
+
+    void Push(SysEventRecord *record)
+    {
+        if (pending_.fetch_add(1, std::memory_order_relaxed) >= MAX_PENDING_EVENTS) {
+            pending_.fetch_sub(1, std::memory_order_relaxed);
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            delete record;
+            return;
+        }
+        std::call_once(startFlag_, [this]() { std::thread(&SysEventWriter::Run, this).detach(); });
+        SysEventRecord *head = head_.load(std::memory_order_relaxed);
+        do {
+            record->next = head;
+        } while (!head_.compare_exchange_weak(head, record, std::memory_order_release, std::memory_order_relaxed));
+        // Only the push onto an empty queue may find the writer waiting.
+        if (head == nullptr) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            cond_.notify_one();
+        }
+    }
+
+private:
+    using Key = std::tuple<SysEventType, uint32_t, std::string>;
+    struct Window {
+        std::chrono::steady_clock::time_point end;
+        // Last repeat of the event in the window, written with the count when the window ends.
+        SysEventInfo last;
+        uint32_t repeats = 0;
+    };
+
+    void Run()
+    {
+        pthread_setname_np(pthread_self(), "req_sysevent");
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                auto ready = [this]() { return head_.load(std::memory_order_relaxed) != nullptr; };
+                if (windows_.empty()) {
+                    cond_.wait(lock, ready);
+                } else {
+                    cond_.wait_until(lock, NextWindowEnd(), ready);
+                }
+            }
+            for (SysEventRecord *record : Take()) {
+                Write(*record);
+                delete record;
+            }
+            CloseWindows();
+        }
+    }
+
+    // Takes the queued events, oldest first.
+    std::vector<SysEventRecord *> Take()
+    {
+        std::vector<SysEventRecord *> records;
+        SysEventRecord *record = head_.exchange(nullptr, std::memory_order_acquire);
+        for (; record != nullptr; record = record->next) {
+            records.push_back(record);
+        }
+        pending_.fetch_sub(records.size(), std::memory_order_relaxed);
+        uint32_t dropped = dropped_.exchange(0, std::memory_order_relaxed);
+        if (dropped != 0) {
+            REQUEST_HILOGW("sys event queue full, %{public}u events dropped", dropped);
+        }
+        return std::vector<SysEventRecord *>(records.rbegin(), records.rend());
+    }
+
+    void Write(SysEventRecord &record)
+    {
+        if (record.expect) {
+            record.info.extraInfo = "expect" + std::to_string(record.one) + "=" + std::to_string(record.two);
+        }
+        Key key(record.type, record.info.dCode, record.info.bundleName);
+        auto it = windows_.find(key);
+        if (it != windows_.end()) {
+            it->second.last = std::move(record.info);
+            it->second.repeats++;
+            return;
+        }
+        SysEventLog::writers_[record.type](record.info);
+        windows_.emplace(std::move(key), Window{ std::chrono::steady_clock::now() + AGGREGATE_WINDOW, {}, 0 });
+    }
+
+    void CloseWindows()
+    {
+        auto now = std::chrono::steady_clock::now();
+        for (auto it = windows_.begin(); it != windows_.end();) {
+            if (it->second.end > now) {
+                ++it;
+                continue;
+            }
+            Window &window = it->second;
+            if (window.repeats != 0) {
+                window.last.extraInfo += " repeats:" + std::to_string(window.repeats);
+                SysEventLog::writers_[std::get<0>(it->first)](window.last);
+            }
+            it = windows_.erase(it);
+        }
     }
 
-    SysEventInfo info = { .dCode = dCode, .bundleName = bundleName, .moduleName = moduleName, .extraInfo = extraInfo };
-    iter->second(info);
+    std::chrono::steady_clock::time_point NextWindowEnd() const
+    {
+        auto end = std::chrono::steady_clock::time_point::max();
+        for (const auto &[key, window] : windows_) {
+            end = std::min(end, window.end);
+        }
+        return end;
+    }
+
+    std::atomic<SysEventRecord *> head_{ nullptr };
+    std::atomic<uint32_t> pending_{ 0 };
+    std::atomic<uint32_t> dropped_{ 0 };
+    std::once_flag startFlag_;
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    // Only used by the writer thread.
+    std::map<Key, Window> windows_;
+};
+
+void (*const SysEventLog::writers_[SYS_EVENT_TYPE_COUNT])(const SysEventInfo &info) = {
+    SendStatisticEvent,
+    SendFaultEvent,
+};
+
+bool SysEventLog::GetType(const std::string &eventName, SysEventType &type)
+{
+    if (eventName == FAULT_EVENT) {
+        type = SYS_EVENT_FAULT;
+        return true;
+    }
+    if (eventName == STATISTIC_EVENT) {
+        type = SYS_EVENT_STATISTIC;
+        return true;
+    }
+    return false;
 }
 
-void SysEventLog::SendSysEventLog(const std::string &eventName, const uint32_t dCode, const std::string extraInfo)
+void SysEventLog::SendSysEventLog(const std::string &eventName, const uint32_t dCode, const std::string &bundleName,
+    const std::string &moduleName, const std::string &extraInfo)
 {
-    auto iter = sysEventMap_.find(eventName);
-    if (iter == sysEventMap_.end()) {
+    SysEventType type;
+    if (!GetType(eventName, type)) {
         return;
     }
+    SysEventRecord *record = new SysEventRecord();
+    record->type = type;
+    record->info = { .dCode = dCode, .bundleName = bundleName, .moduleName = moduleName, .extraInfo = extraInfo };
+    SysEventWriter::GetInstance().Push(record);
+}
 
-    SysEventInfo info = { .dCode = dCode, .bundleName = "", .moduleName = "", .extraInfo = extraInfo };
-    iter->second(info);
+void SysEventLog::SendSysEventLog(const std::string &eventName, const uint32_t dCode, const std::string &extraInfo)
+{
+    SysEventType type;
+    if (!GetType(eventName, type)) {
+        return;
+    }
+    SysEventRecord *record = new SysEventRecord();
+    record->type = type;
+    record->info = { .dCode = dCode, .bundleName = "", .moduleName = "", .extraInfo = extraInfo };
+    SysEventWriter::GetInstance().Push(record);
 }
 
 void SysEventLog::SendSysEventLog(
     const std::string &eventName, const uint32_t dCode, const int32_t one, const int32_t two)
 {
-    auto iter = sysEventMap_.find(eventName);
-    if (iter == sysEventMap_.end()) {
+    SysEventType type;
+    if (!GetType(eventName, type)) {
         return;
     }
-
-    SysEventInfo info = { .dCode = dCode,
-        .bundleName = "",
-        .moduleName = "",
-        .extraInfo = "expect" + std::to_string(one) + "=" + std::to_string(two) };
-    iter->second(info);
+    SysEventRecord *record = new SysEventRecord();
+    record->type = type;
+    record->info.dCode = dCode;
+    record->expect = true;
+    record->one = one;
+    record->two = two;
+    SysEventWriter::GetInstance().Push(record);
 }
 
-std::unordered_map<std::string, void (*)(const SysEventInfo &info)> SysEventLog::sysEventMap_ = {
-    { STATISTIC_EVENT, [](const SysEventInfo &info) { SendStatisticEvent(info); } },
-    { FAULT_EVENT, [](const SysEventInfo &info) { SendFaultEvent(info); } },
-};
-
 template<typename... Types>
 int32_t SysEventLog::HisysWrite(const std::string &eventName, HiviewDFX::HiSysEvent::EventType type, Types... keyValues)
 {
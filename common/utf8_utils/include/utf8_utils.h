@@ -16,10 +16,15 @@
 #ifndef REQUEST_UTF8_UTILS_H
 #define REQUEST_UTF8_UTILS_H
 
+#include <cstddef>
 #include <cstdint>
+#include <string_view>
 #include <vector>
 
 namespace OHOS::Request::Utf8Utils {
+// Returns whether the bytes are valid UTF-8, ASCII runs are checked 16 bytes at a time.
+bool RunUtf8Validation(const uint8_t *data, size_t len);
+bool RunUtf8Validation(std::string_view s);
 bool RunUtf8Validation(const std::vector<uint8_t> &v);
 } // namespace OHOS::Request::Utf8Utils
 #endif // UTF8_UTILS_H
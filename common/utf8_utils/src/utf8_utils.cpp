@@ -15,19 +15,63 @@
 
 #include "utf8_utils.h"
 
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 namespace OHOS::Request::Utf8Utils {
 namespace {
 static constexpr size_t TWO_OCTET = 2;
 static constexpr size_t THREE_OCTET = 3;
 static constexpr size_t FOUR_OCTET = 4;
+static constexpr size_t BLOCK_SIZE = 16;
+static constexpr size_t WORD_SIZE = 8;
+static constexpr uint64_t HIGH_BITS = 0x8080808080808080ULL;
+
+// Returns whether a block of 16 bytes is all ASCII.
+bool IsAsciiBlock(const uint8_t *p)
+{
+#if defined(__SSE2__)
+    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+    return _mm_movemask_epi8(block) == 0;
+#elif defined(__aarch64__)
+    return vmaxvq_u8(vld1q_u8(p)) <= 0x7F;
+#else
+    uint64_t lo = 0;
+    uint64_t hi = 0;
+    memcpy(&lo, p, WORD_SIZE);
+    memcpy(&hi, p + WORD_SIZE, WORD_SIZE);
+    return ((lo | hi) & HIGH_BITS) == 0;
+#endif
+}
+
+// Skips the ASCII bytes starting at index, 16 and then 8 bytes at a time.
+size_t SkipAscii(const uint8_t *data, size_t len, size_t index)
+{
+    while (len - index >= BLOCK_SIZE && IsAsciiBlock(data + index)) {
+        index += BLOCK_SIZE;
+    }
+    if (len - index >= WORD_SIZE) {
+        uint64_t word = 0;
+        memcpy(&word, data + index, WORD_SIZE);
+        if ((word & HIGH_BITS) == 0) {
+            index += WORD_SIZE;
+        }
+    }
+    return index;
+}
 
-bool GetNextByte(const std::vector<uint8_t> &v, size_t &index, uint8_t &next)
+bool GetNextByte(const uint8_t *data, size_t len, size_t &index, uint8_t &next)
 {
     index += 1;
-    if (index >= v.size()) {
+    if (index >= len) {
         return false;
     }
-    next = v[index];
+    next = data[index];
     return true;
 }
 
@@ -60,19 +104,19 @@ size_t Utf8CharWidth(uint8_t b)
 // https://tools.ietf.org/html/rfc3629
 // UTF8-1      = %x00-7F
 // UTF8-2      = %xC2-DF UTF8-tail
-bool Check2Bytes(const std::vector<uint8_t> &v, size_t &index)
+bool Check2Bytes(const uint8_t *data, size_t len, size_t &index)
 {
     uint8_t next = 0;
-    return GetNextByte(v, index, next) && (next >= 0x80 && next <= 0xBF);
+    return GetNextByte(data, len, index, next) && (next >= 0x80 && next <= 0xBF);
 }
 
 // https://tools.ietf.org/html/rfc3629
 // UTF8-3      = %xE0 %xA0-BF UTF8-tail / %xE1-EC 2( UTF8-tail ) /
 //               %xED %x80-9F UTF8-tail / %xEE-EF 2( UTF8-tail )
-bool Check3Bytes(const std::vector<uint8_t> &v, const size_t &first, size_t &index)
+bool Check3Bytes(const uint8_t *data, size_t len, const size_t &first, size_t &index)
 {
     uint8_t next = 0;
-    if (!GetNextByte(v, index, next)) {
+    if (!GetNextByte(data, len, index, next)) {
         return false;
     };
 
@@ -84,16 +128,16 @@ bool Check3Bytes(const std::vector<uint8_t> &v, const size_t &first, size_t &ind
         return false;
     };
 
-    return Check2Bytes(v, index);
+    return Check2Bytes(data, len, index);
 }
 
 // https://tools.ietf.org/html/rfc3629
 // UTF8-4      = %xF0 %x90-BF 2( UTF8-tail ) / %xF1-F3 3( UTF8-tail ) /
 //               %xF4 %x80-8F 2( UTF8-tail )
-bool Check4Bytes(const std::vector<uint8_t> &v, const size_t &first, size_t &index)
+bool Check4Bytes(const uint8_t *data, size_t len, const size_t &first, size_t &index)
 {
     uint8_t next = 0;
-    if (!GetNextByte(v, index, next)) {
+    if (!GetNextByte(data, len, index, next)) {
         return false;
     };
 
@@ -104,35 +148,37 @@ bool Check4Bytes(const std::vector<uint8_t> &v, const size_t &first, size_t &ind
         return false;
     }
 
-    return Check2Bytes(v, index) && Check2Bytes(v, index);
+    return Check2Bytes(data, len, index) && Check2Bytes(data, len, index);
 }
 } // namespace
 
-bool RunUtf8Validation(const std::vector<uint8_t> &v)
+bool RunUtf8Validation(const uint8_t *data, size_t len)
 {
+    if (data == nullptr) {
+        return len == 0;
+    }
     size_t index = 0;
-    size_t len = v.size();
 
     while (index < len) {
-        uint8_t first = v[index];
+        uint8_t first = data[index];
 
         // <= 0x7F means single byte.
         if (first <= 0x7F) {
-            index += 1;
+            index = SkipAscii(data, len, index + 1);
             continue;
         }
 
         size_t w = Utf8CharWidth(first);
         if (w == TWO_OCTET) {
-            if (!Check2Bytes(v, index)) {
+            if (!Check2Bytes(data, len, index)) {
                 return false;
             }
         } else if (w == THREE_OCTET) {
-            if (!Check3Bytes(v, first, index)) {
+            if (!Check3Bytes(data, len, first, index)) {
                 return false;
             }
         } else if (w == FOUR_OCTET) {
-            if (!Check4Bytes(v, first, index)) {
+            if (!Check4Bytes(data, len, first, index)) {
                 return false;
             }
         } else {
@@ -142,4 +188,14 @@ bool RunUtf8Validation(const std::vector<uint8_t> &v)
     }
     return true;
 }
-} // namespace OHOS::Request::Utf8Utils
\ No newline at end of file
+
+bool RunUtf8Validation(std::string_view s)
+{
+    return RunUtf8Validation(reinterpret_cast<const uint8_t *>(s.data()), s.size());
+}
+
+bool RunUtf8Validation(const std::vector<uint8_t> &v)
+{
+    return RunUtf8Validation(v.data(), v.size());
+}
+} // namespace OHOS::Request::Utf8Utils
@@ -0,0 +1,234 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Benchmarks of the slab LRU against the boxed linked list it replaced.
+//!
+//! Every workload runs the same pseudo-random operations on a cache bounded
+//! like the caches of `CacheManager`: inserting past the capacity evicts the
+//! least recently used entry.
+
+use std::collections::HashMap;
+use std::hash::Hash;
+use std::ptr;
+
+use criterion::{black_box, criterion_group, criterion_main, BenchmarkId, Criterion};
+use request_utils::lru::LRUCache;
+
+/// Entries kept by the caches.
+const CAPACITIES: [usize; 2] = [1_024, 65_536];
+
+/// Operations run per iteration.
+const OPS: usize = 10_000;
+
+/// Operations a workload is made of.
+trait Lru {
+    fn get(&mut self, key: u64) -> Option<&u64>;
+    fn insert(&mut self, key: u64, value: u64);
+    fn pop(&mut self) -> Option<u64>;
+    fn len(&self) -> usize;
+}
+
+impl Lru for LRUCache<u64, u64> {
+    fn get(&mut self, key: u64) -> Option<&u64> {
+        LRUCache::get(self, &key)
+    }
+
+    fn insert(&mut self, key: u64, value: u64) {
+        LRUCache::insert(self, key, value);
+    }
+
+    fn pop(&mut self) -> Option<u64> {
+        LRUCache::pop(self)
+    }
+
+    fn len(&self) -> usize {
+        LRUCache::len(self)
+    }
+}
+
+/// The previous implementation: a `HashMap` of separately boxed nodes linked
+/// by raw pointers.
+struct BoxedLru<K, V> {
+    map: HashMap<K, *mut Node<K, V>>,
+    head: *mut Node<K, V>,
+    tail: *mut Node<K, V>,
+}
+
+struct Node<K, V> {
+    key: K,
+    value: V,
+    prev: *mut Node<K, V>,
+    next: *mut Node<K, V>,
+}
+
+impl<K: Hash + Eq + Clone, V> BoxedLru<K, V> {
+    fn new() -> Self {
+        Self {
+            map: HashMap::new(),
+            head: ptr::null_mut(),
+            tail: ptr::null_mut(),
+        }
+    }
+
+    fn push_front(&mut self, node: *mut Node<K, V>) {
+        // SAFETY: `node` and the nodes of the list are owned by the list.
+        unsafe {
+            (*node).prev = ptr::null_mut();
+            (*node).next = self.head;
+            if !self.head.is_null() {
+                (*self.head).prev = node;
+            }
+            self.head = node;
+            if self.tail.is_null() {
+                self.tail = node;
+            }
+        }
+    }
+
+    fn unlink(&mut self, node: *mut Node<K, V>) {
+        // SAFETY: `node` is in the list.
+        unsafe {
+            if !(*node).prev.is_null() {
+                (*(*node).prev).next = (*node).next;
+            } else {
+                self.head = (*node).next;
+            }
+            if !(*node).next.is_null() {
+                (*(*node).next).prev = (*node).prev;
+            } else {
+                self.tail = (*node).prev;
+            }
+        }
+    }
+}
+
+impl<K, V> Drop for BoxedLru<K, V> {
+    fn drop(&mut self) {
+        for &node in self.map.values() {
+            // SAFETY: Every node was boxed once and is freed once.
+            drop(unsafe { Box::from_raw(node) });
+        }
+    }
+}
+
+impl Lru for BoxedLru<u64, u64> {
+    fn get(&mut self, key: u64) -> Option<&u64> {
+        let node = *self.map.get(&key)?;
+        self.unlink(node);
+        self.push_front(node);
+        // SAFETY: `node` is in the list.
+        Some(unsafe { &(*node).value })
+    }
+
+    fn insert(&mut self, key: u64, value: u64) {
+        if let Some(&node) = self.map.get(&key) {
+            self.unlink(node);
+            self.push_front(node);
+            // SAFETY: `node` is in the list.
+            unsafe { (*node).value = value };
+            return;
+        }
+        let node = Box::into_raw(Box::new(Node {
+            key,
+            value,
+            prev: ptr::null_mut(),
+            next: ptr::null_mut(),
+        }));
+        self.push_front(node);
+        self.map.insert(key, node);
+    }
+
+    fn pop(&mut self) -> Option<u64> {
+        if self.tail.is_null() {
+            return None;
+        }
+        let node = self.tail;
+        self.unlink(node);
+        // SAFETY: `node` was just taken out of the list.
+        let node = unsafe { Box::from_raw(node) };
+        self.map.remove(&node.key);
+        Some(node.value)
+    }
+
+    fn len(&self) -> usize {
+        self.map.len()
+    }
+}
+
+/// Keys of a workload, drawn from twice the capacity so about half of the
+/// lookups miss.
+fn keys(capacity: usize) -> Vec<u64> {
+    let mut seed = 0x9e37_79b9_7f4a_7c15_u64;
+    (0..OPS)
+        .map(|_| {
+            seed ^= seed << 13;
+            seed ^= seed >> 7;
+            seed ^= seed << 17;
+            seed % (capacity as u64 * 2)
+        })
+        .collect()
+}
+
+/// Fills a cache to its capacity.
+fn filled<C: Lru>(mut cache: C, capacity: usize) -> C {
+    for key in 0..capacity as u64 {
+        cache.insert(key * 2, key);
+    }
+    cache
+}
+
+/// Runs `percent_get` percent of lookups, the rest inserts evicting the least
+/// recently used entry once the capacity is reached.
+fn run<C: Lru>(cache: &mut C, keys: &[u64], capacity: usize, percent_get: u64) {
+    for &key in keys {
+        if key % 100 < percent_get {
+            black_box(cache.get(key));
+        } else {
+            cache.insert(key, key);
+            if cache.len() > capacity {
+                black_box(cache.pop());
+            }
+        }
+    }
+}
+
+fn bench_mix(c: &mut Criterion, name: &str, percent_get: u64) {
+    let mut group = c.benchmark_group(name);
+    for capacity in CAPACITIES {
+        let keys = keys(capacity);
+        let mut slab = filled(LRUCache::new(), capacity);
+        group.bench_with_input(BenchmarkId::new("slab", capacity), &keys, |b, keys| {
+            b.iter(|| run(&mut slab, keys, capacity, percent_get))
+        });
+        let mut boxed = filled(BoxedLru::new(), capacity);
+        group.bench_with_input(BenchmarkId::new("boxed", capacity), &keys, |b, keys| {
+            b.iter(|| run(&mut boxed, keys, capacity, percent_get))
+        });
+    }
+    group.finish();
+}
+
+fn lru_get_heavy(c: &mut Criterion) {
+    bench_mix(c, "lru_get_heavy", 90);
+}
+
+fn lru_balanced(c: &mut Criterion) {
+    bench_mix(c, "lru_balanced", 50);
+}
+
+fn lru_insert_evict(c: &mut Criterion) {
+    bench_mix(c, "lru_insert_evict", 0);
+}
+
+criterion_group!(lru, lru_get_heavy, lru_balanced, lru_insert_evict);
+criterion_main!(lru);
@@ -21,7 +21,8 @@
 namespace OHOS::Request {
 using namespace OHOS::AbilityRuntime;
 
-int32_t DataAbilityOpenFile(std::shared_ptr<Context> const &context, const std::string &path);
+// Opens a file of a data ability, `mode` as "r", "rw" or "rwt" to truncate it.
+int32_t DataAbilityOpenFile(std::shared_ptr<Context> const &context, const std::string &path, const std::string &mode);
 
 } // namespace OHOS::Request
 #endif
\ No newline at end of file
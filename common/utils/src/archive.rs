@@ -0,0 +1,699 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Streaming extraction of archives.
+//!
+//! An [`Extractor`] takes an archive in pieces of any size, as it is
+//! downloaded, and hands its entries to a [`Sink`] without the archive being
+//! read again. The format is detected from the first bytes:
+//!
+//! - tar, ustar and GNU, with long names and pax paths, gzip compressed or
+//!   not;
+//! - zip, read from its local headers in order, the central directory at the
+//!   end is not needed. Entries are stored or deflated, the sizes of a
+//!   deflated entry may follow its data.
+//!
+//! Only files and directories are extracted, links and devices are skipped.
+//! Entry paths are relative to the directory extracted to, a path leaving it
+//! fails the extraction.
+
+use std::fmt;
+use std::io;
+
+use crate::compress::inflate::{crc32, Format, Inflater};
+use crate::compress::{ContentDecoder, ContentEncoding, DecodeError};
+
+/// Size of the blocks of a tar archive.
+const TAR_BLOCK: usize = 512;
+
+/// Largest long name or pax header of a tar archive read.
+const MAX_HEADER_DATA: u64 = 64 * 1024;
+
+const ZIP_LOCAL_HEADER: u32 = 0x0403_4b50;
+const ZIP_CENTRAL_HEADER: u32 = 0x0201_4b50;
+const ZIP_END_OF_CENTRAL: u32 = 0x0605_4b50;
+const ZIP_DESCRIPTOR: u32 = 0x0807_4b50;
+const ZIP_LOCAL_HEADER_SIZE: usize = 30;
+/// Flag of a zip entry whose sizes and CRC follow its data.
+const ZIP_FLAG_DESCRIPTOR: u16 = 0x08;
+const ZIP_FLAG_ENCRYPTED: u16 = 0x01;
+const ZIP_STORED: u16 = 0;
+const ZIP_DEFLATED: u16 = 8;
+
+/// Kind of an entry of an archive.
+#[derive(Clone, Copy, PartialEq, Eq, Debug)]
+pub enum EntryKind {
+    File,
+    Dir,
+}
+
+/// Entry of an archive.
+#[derive(Clone, PartialEq, Eq, Debug)]
+pub struct Entry {
+    /// Path relative to the directory extracted to, `/` separated
+    pub path: String,
+    pub kind: EntryKind,
+    /// Size of the data of the entry, if the archive tells it upfront
+    pub size: Option<u64>,
+}
+
+/// Receiver of the entries of an archive, in order.
+pub trait Sink {
+    /// Starts an entry, the data of a file follows.
+    fn begin(&mut self, entry: &Entry) -> io::Result<()>;
+
+    /// Takes the next piece of the data of the entry started.
+    fn data(&mut self, data: &[u8]) -> io::Result<()>;
+
+    /// Ends the entry started, its data is complete.
+    fn end(&mut self) -> io::Result<()>;
+}
+
+/// Error extracting an archive.
+#[derive(Debug)]
+pub enum ArchiveError {
+    /// The data is not an archive of a supported format.
+    Unsupported,
+    /// The archive is malformed.
+    Invalid(&'static str),
+    /// An entry path leaves the directory extracted to.
+    Path(String),
+    /// The data of an entry does not match its CRC.
+    Checksum,
+    /// The archive ended before its last entry.
+    Truncated,
+    /// The compressed data is invalid.
+    Decode(DecodeError),
+    /// The sink failed.
+    Io(io::Error),
+}
+
+impl fmt::Display for ArchiveError {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        match self {
+            Self::Unsupported => f.write_str("unsupported archive"),
+            Self::Invalid(msg) => write!(f, "invalid archive, {}", msg),
+            Self::Path(path) => write!(f, "entry path {} leaves the directory", path),
+            Self::Checksum => f.write_str("entry checksum mismatch"),
+            Self::Truncated => f.write_str("truncated archive"),
+            Self::Decode(e) => write!(f, "{}", e),
+            Self::Io(e) => write!(f, "{}", e),
+        }
+    }
+}
+
+impl std::error::Error for ArchiveError {}
+
+impl From<io::Error> for ArchiveError {
+    fn from(value: io::Error) -> Self {
+        Self::Io(value)
+    }
+}
+
+impl From<DecodeError> for ArchiveError {
+    fn from(value: DecodeError) -> Self {
+        Self::Decode(value)
+    }
+}
+
+/// Data of a tar entry and what it is for.
+enum TarData {
+    /// Data of the file started
+    File,
+    /// Long name of the next entry
+    LongName(Vec<u8>),
+    /// Pax header of the next entry
+    Pax(Vec<u8>),
+    Skip,
+}
+
+enum State {
+    /// Format not detected yet
+    Detect,
+    TarHeader,
+    TarData {
+        left: u64,
+        padding: usize,
+        data: TarData,
+    },
+    ZipHeader,
+    /// Data of a zip entry, inflated if `inflater` is set, `left` is `None`
+    /// if its size follows it
+    ZipData {
+        inflater: Option<Box<Inflater>>,
+        left: Option<u64>,
+        crc: u32,
+        expected: Option<u32>,
+    },
+    ZipDescriptor {
+        crc: u32,
+    },
+    End,
+}
+
+/// Streaming extractor of an archive.
+///
+/// # Examples
+///
+/// ```rust
+/// use std::io;
+///
+/// use request_utils::archive::{Entry, Extractor, Sink};
+///
+/// struct Names(Vec<String>);
+///
+/// impl Sink for Names {
+///     fn begin(&mut self, entry: &Entry) -> io::Result<()> {
+///         self.0.push(entry.path.clone());
+///         Ok(())
+///     }
+///
+///     fn data(&mut self, _data: &[u8]) -> io::Result<()> {
+///         Ok(())
+///     }
+///
+///     fn end(&mut self) -> io::Result<()> {
+///         Ok(())
+///     }
+/// }
+///
+/// let mut extractor = Extractor::new();
+/// let mut names = Names(Vec::new());
+/// assert!(extractor.feed(b"not an archive", &mut names).is_ok());
+/// assert!(extractor.finish().is_err());
+/// ```
+pub struct Extractor {
+    /// Decoder of a gzip compressed tar archive
+    gzip: Option<ContentDecoder>,
+    /// Whether the gzip magic was looked for
+    sniffed: bool,
+    /// Archive bytes not consumed yet
+    input: Vec<u8>,
+    state: State,
+    /// Path of the next tar entry, from a long name or a pax header
+    next_path: Option<String>,
+    /// Entries extracted
+    entries: u64,
+}
+
+impl Default for Extractor {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+impl Extractor {
+    /// Creates an extractor of an archive of any supported format.
+    pub fn new() -> Self {
+        Self {
+            gzip: None,
+            sniffed: false,
+            input: Vec::new(),
+            state: State::Detect,
+            next_path: None,
+            entries: 0,
+        }
+    }
+
+    /// Returns the number of entries extracted so far.
+    pub fn entries(&self) -> u64 {
+        self.entries
+    }
+
+    /// Extracts the entries the next piece of the archive completes or
+    /// continues.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if the archive is not supported or malformed, or if
+    /// the sink fails. The extraction cannot go on afterwards.
+    pub fn feed(&mut self, data: &[u8], sink: &mut dyn Sink) -> Result<(), ArchiveError> {
+        if !self.sniffed {
+            self.input.extend_from_slice(data);
+            if self.input.len() < 2 {
+                return Ok(());
+            }
+            self.sniffed = true;
+            if self.input[..2] == [0x1f, 0x8b] {
+                let mut gzip = ContentDecoder::new(ContentEncoding::Gzip);
+                let raw = std::mem::take(&mut self.input);
+                gzip.decode(&raw, &mut self.input)?;
+                self.gzip = Some(gzip);
+            }
+        } else if let Some(gzip) = self.gzip.as_mut() {
+            gzip.decode(data, &mut self.input)?;
+        } else {
+            self.input.extend_from_slice(data);
+        }
+        let mut pos = 0;
+        let res = self.run(&mut pos, sink);
+        self.input.drain(..pos);
+        res
+    }
+
+    /// Checks that the archive received is complete.
+    pub fn finish(&self) -> Result<(), ArchiveError> {
+        if let Some(gzip) = self.gzip.as_ref() {
+            gzip.finish()?;
+        }
+        match self.state {
+            State::End => Ok(()),
+            // Some writers leave out the end blocks of tar archives
+            State::TarHeader if self.input.is_empty() && self.entries > 0 => Ok(()),
+            State::Detect if self.input.is_empty() => Err(ArchiveError::Truncated),
+            State::Detect => Err(ArchiveError::Unsupported),
+            _ => Err(ArchiveError::Truncated),
+        }
+    }
+
+    /// Runs the steps the input allows from `pos`, which is left after the
+    /// bytes consumed.
+    fn run(&mut self, pos: &mut usize, sink: &mut dyn Sink) -> Result<(), ArchiveError> {
+        loop {
+            let progressed = match std::mem::replace(&mut self.state, State::End) {
+                State::Detect => self.detect(*pos)?,
+                State::TarHeader => self.tar_header(pos, sink)?,
+                State::TarData {
+                    left,
+                    padding,
+                    data,
+                } => self.tar_data(pos, sink, left, padding, data)?,
+                State::ZipHeader => self.zip_header(pos, sink)?,
+                State::ZipData {
+                    inflater,
+                    left,
+                    crc,
+                    expected,
+                } => self.zip_data(pos, sink, inflater, left, crc, expected)?,
+                State::ZipDescriptor { crc } => self.zip_descriptor(pos, sink, crc)?,
+                State::End => {
+                    // Data after the archive is ignored
+                    *pos = self.input.len();
+                    false
+                }
+            };
+            if !progressed {
+                return Ok(());
+            }
+        }
+    }
+
+    fn detect(&mut self, pos: usize) -> Result<bool, ArchiveError> {
+        let input = &self.input[pos..];
+        if input.len() >= 4 && le32(input) == ZIP_LOCAL_HEADER {
+            self.state = State::ZipHeader;
+            return Ok(true);
+        }
+        if input.len() < 262 {
+            self.state = State::Detect;
+            return Ok(false);
+        }
+        if &input[257..262] != b"ustar" {
+            return Err(ArchiveError::Unsupported);
+        }
+        self.state = State::TarHeader;
+        Ok(true)
+    }
+
+    fn tar_header(&mut self, pos: &mut usize, sink: &mut dyn Sink) -> Result<bool, ArchiveError> {
+        if self.input.len() - *pos < TAR_BLOCK {
+            self.state = State::TarHeader;
+            return Ok(false);
+        }
+        let header = &self.input[*pos..*pos + TAR_BLOCK];
+        *pos += TAR_BLOCK;
+        if header.iter().all(|&b| b == 0) {
+            self.state = State::End;
+            return Ok(true);
+        }
+        let expected = octal(&header[148..156]).ok_or(ArchiveError::Invalid("tar checksum"))?;
+        let sum = header
+            .iter()
+            .enumerate()
+            .map(|(i, &b)| if (148..156).contains(&i) { b' ' } else { b } as u64)
+            .sum::<u64>();
+        if sum != expected {
+            return Err(ArchiveError::Invalid("tar checksum"));
+        }
+        let size = octal(&header[124..136]).ok_or(ArchiveError::Invalid("tar size"))?;
+        let kind = header[156];
+        let data = match kind {
+            b'0' | b'\0' | b'7' | b'5' => {
+                let path = match self.next_path.take() {
+                    Some(path) => path,
+                    None => {
+                        let name = cstr(&header[..100]);
+                        let prefix = cstr(&header[345..500]);
+                        if &header[257..262] == b"ustar" && !prefix.is_empty() {
+                            format!("{}/{}", prefix, name)
+                        } else {
+                            name
+                        }
+                    }
+                };
+                let entry_kind = if kind == b'5' || path.ends_with('/') {
+                    EntryKind::Dir
+                } else {
+                    EntryKind::File
+                };
+                match self.begin(sink, &path, entry_kind, Some(size))? {
+                    true if entry_kind == EntryKind::File => TarData::File,
+                    true => {
+                        self.end(sink)?;
+                        TarData::Skip
+                    }
+                    false => TarData::Skip,
+                }
+            }
+            b'L' | b'x' if size > MAX_HEADER_DATA => {
+                return Err(ArchiveError::Invalid("tar header too large"));
+            }
+            b'L' => TarData::LongName(Vec::new()),
+            b'x' => TarData::Pax(Vec::new()),
+            _ => TarData::Skip,
+        };
+        let padding = (TAR_BLOCK - (size % TAR_BLOCK as u64) as usize) % TAR_BLOCK;
+        self.state = State::TarData {
+            left: size,
+            padding,
+            data,
+        };
+        Ok(true)
+    }
+
+    fn tar_data(
+        &mut self,
+        pos: &mut usize,
+        sink: &mut dyn Sink,
+        mut left: u64,
+        mut padding: usize,
+        mut data: TarData,
+    ) -> Result<bool, ArchiveError> {
+        let available = self.input.len() - *pos;
+        let n = left.min(available as u64) as usize;
+        let piece = &self.input[*pos..*pos + n];
+        match &mut data {
+            TarData::File => sink.data(piece)?,
+            TarData::LongName(buf) | TarData::Pax(buf) => buf.extend_from_slice(piece),
+            TarData::Skip => {}
+        }
+        *pos += n;
+        left -= n as u64;
+        if left == 0 {
+            let skipped = padding.min(self.input.len() - *pos);
+            *pos += skipped;
+            padding -= skipped;
+        }
+        if left > 0 || padding > 0 {
+            self.state = State::TarData {
+                left,
+                padding,
+                data,
+            };
+            return Ok(false);
+        }
+        match data {
+            TarData::File => self.end(sink)?,
+            TarData::LongName(buf) => self.next_path = Some(cstr(&buf)),
+            TarData::Pax(buf) => {
+                if let Some(path) = pax_path(&buf) {
+                    self.next_path = Some(path);
+                }
+            }
+            TarData::Skip => {}
+        }
+        self.state = State::TarHeader;
+        Ok(true)
+    }
+
+    fn zip_header(&mut self, pos: &mut usize, sink: &mut dyn Sink) -> Result<bool, ArchiveError> {
+        let input = &self.input[*pos..];
+        if input.len() < 4 {
+            self.state = State::ZipHeader;
+            return Ok(false);
+        }
+        match le32(input) {
+            ZIP_LOCAL_HEADER => {}
+            ZIP_CENTRAL_HEADER | ZIP_END_OF_CENTRAL => {
+                self.state = State::End;
+                return Ok(true);
+            }
+            _ => return Err(ArchiveError::Invalid("zip header")),
+        }
+        if input.len() < ZIP_LOCAL_HEADER_SIZE {
+            self.state = State::ZipHeader;
+            return Ok(false);
+        }
+        let flags = le16(&input[6..]);
+        let method = le16(&input[8..]);
+        let crc = le32(&input[14..]);
+        let compressed = le32(&input[18..]);
+        let size = le32(&input[22..]);
+        let name_len = le16(&input[26..]) as usize;
+        let extra_len = le16(&input[28..]) as usize;
+        let header_len = ZIP_LOCAL_HEADER_SIZE + name_len + extra_len;
+        if input.len() < header_len {
+            self.state = State::ZipHeader;
+            return Ok(false);
+        }
+        let descriptor = flags & ZIP_FLAG_DESCRIPTOR != 0;
+        if flags & ZIP_FLAG_ENCRYPTED != 0
+            || (method != ZIP_STORED && method != ZIP_DEFLATED)
+            || (method == ZIP_STORED && descriptor)
+            || (!descriptor && (compressed == u32::MAX || size == u32::MAX))
+        {
+            return Err(ArchiveError::Unsupported);
+        }
+        let path =
+            String::from_utf8_lossy(&input[ZIP_LOCAL_HEADER_SIZE..][..name_len]).replace('\\', "/");
+        *pos += header_len;
+        let kind = if path.ends_with('/') {
+            EntryKind::Dir
+        } else {
+            EntryKind::File
+        };
+        let size = (!descriptor).then_some(size as u64);
+        if !self.begin(sink, &path, kind, size)? {
+            return Err(ArchiveError::Invalid("zip entry path"));
+        }
+        let inflater = (method == ZIP_DEFLATED).then(|| Box::new(Inflater::new(Format::Raw)));
+        self.state = State::ZipData {
+            inflater,
+            left: (!descriptor).then_some(compressed as u64),
+            crc: 0,
+            expected: (!descriptor).then_some(crc),
+        };
+        Ok(true)
+    }
+
+    fn zip_data(
+        &mut self,
+        pos: &mut usize,
+        sink: &mut dyn Sink,
+        mut inflater: Option<Box<Inflater>>,
+        mut left: Option<u64>,
+        mut crc: u32,
+        expected: Option<u32>,
+    ) -> Result<bool, ArchiveError> {
+        let available = self.input.len() - *pos;
+        let n = left.map_or(available, |left| left.min(available as u64) as usize);
+        let piece = &self.input[*pos..*pos + n];
+        *pos += n;
+        if let Some(left) = left.as_mut() {
+            *left -= n as u64;
+        }
+        let complete = match inflater.as_mut() {
+            Some(inflater) => {
+                let mut out = Vec::new();
+                inflater.inflate(piece, &mut out)?;
+                crc = crc32(crc, &out);
+                sink.data(&out)?;
+                inflater.is_complete()
+            }
+            None => {
+                crc = crc32(crc, piece);
+                sink.data(piece)?;
+                left == Some(0)
+            }
+        };
+        if !complete {
+            if left == Some(0) {
+                return Err(ArchiveError::Invalid("zip entry data"));
+            }
+            self.state = State::ZipData {
+                inflater,
+                left,
+                crc,
+                expected,
+            };
+            return Ok(false);
+        }
+        match expected {
+            Some(expected) => {
+                if left != Some(0) {
+                    return Err(ArchiveError::Invalid("zip entry data"));
+                }
+                if crc != expected {
+                    return Err(ArchiveError::Checksum);
+                }
+                self.end(sink)?;
+                self.state = State::ZipHeader;
+            }
+            None => {
+                // The input read past the end of the data is the descriptor
+                if let Some(mut inflater) = inflater {
+                    let mut rest = inflater.take_rest();
+                    rest.extend_from_slice(&self.input[*pos..]);
+                    self.input = rest;
+                    *pos = 0;
+                }
+                self.state = State::ZipDescriptor { crc };
+            }
+        }
+        Ok(true)
+    }
+
+    fn zip_descriptor(
+        &mut self,
+        pos: &mut usize,
+        sink: &mut dyn Sink,
+        crc: u32,
+    ) -> Result<bool, ArchiveError> {
+        let input = &self.input[*pos..];
+        let len = if input.len() >= 4 && le32(input) == ZIP_DESCRIPTOR {
+            16
+        } else {
+            12
+        };
+        if input.len() < len {
+            self.state = State::ZipDescriptor { crc };
+            return Ok(false);
+        }
+        if le32(&input[len - 12..]) != crc {
+            return Err(ArchiveError::Checksum);
+        }
+        *pos += len;
+        self.end(sink)?;
+        self.state = State::ZipHeader;
+        Ok(true)
+    }
+
+    /// Starts an entry in the sink if its path is inside the directory.
+    ///
+    /// # Returns
+    ///
+    /// `false` if the path is empty, as `./`, and the entry is skipped.
+    fn begin(
+        &mut self,
+        sink: &mut dyn Sink,
+        path: &str,
+        kind: EntryKind,
+        size: Option<u64>,
+    ) -> Result<bool, ArchiveError> {
+        let Some(relative) = sanitize(path)? else {
+            return Ok(false);
+        };
+        sink.begin(&Entry {
+            path: relative,
+            kind,
+            size,
+        })?;
+        Ok(true)
+    }
+
+    fn end(&mut self, sink: &mut dyn Sink) -> Result<(), ArchiveError> {
+        sink.end()?;
+        self.entries += 1;
+        Ok(())
+    }
+}
+
+/// Returns the path of an entry relative to the directory extracted to,
+/// `None` if it names the directory itself.
+///
+/// # Errors
+///
+/// Returns `ArchiveError::Path` if the path leaves the directory.
+pub fn sanitize(path: &str) -> Result<Option<String>, ArchiveError> {
+    let mut parts = Vec::new();
+    for part in path.split('/') {
+        match part {
+            "" | "." => {}
+            ".." => return Err(ArchiveError::Path(path.to_string())),
+            part if part.contains('\0') => return Err(ArchiveError::Path(path.to_string())),
+            part => parts.push(part),
+        }
+    }
+    if parts.is_empty() {
+        return Ok(None);
+    }
+    Ok(Some(parts.join("/")))
+}
+
+fn le16(b: &[u8]) -> u16 {
+    u16::from_le_bytes([b[0], b[1]])
+}
+
+fn le32(b: &[u8]) -> u32 {
+    u32::from_le_bytes([b[0], b[1], b[2], b[3]])
+}
+
+/// Parses a numeric field of a tar header, octal or GNU base-256.
+fn octal(field: &[u8]) -> Option<u64> {
+    if field[0] & 0x80 != 0 {
+        return field[1..]
+            .iter()
+            .try_fold((field[0] & 0x7f) as u64, |n, &b| {
+                n.checked_mul(256)?.checked_add(b as u64)
+            });
+    }
+    let text = std::str::from_utf8(field).ok()?;
+    let text = text.trim_matches(|c| c == ' ' || c == '\0');
+    if text.is_empty() {
+        return Some(0);
+    }
+    u64::from_str_radix(text, 8).ok()
+}
+
+/// Returns the text of a NUL terminated field.
+fn cstr(field: &[u8]) -> String {
+    let end = field.iter().position(|&b| b == 0).unwrap_or(field.len());
+    String::from_utf8_lossy(&field[..end]).into_owned()
+}
+
+/// Returns the `path` record of a pax header, records being written as
+/// `<length> <key>=<value>\n`.
+fn pax_path(mut records: &[u8]) -> Option<String> {
+    let mut path = None;
+    while !records.is_empty() {
+        let space = records.iter().position(|&b| b == b' ')?;
+        let len = std::str::from_utf8(&records[..space])
+            .ok()?
+            .parse::<usize>()
+            .ok()?;
+        if len <= space + 1 || len > records.len() {
+            return None;
+        }
+        let record = &records[space + 1..len - 1];
+        if let Some(value) = record.strip_prefix(b"path=") {
+            path = Some(String::from_utf8_lossy(value).into_owned());
+        }
+        records = &records[len..];
+    }
+    path
+}
+
+#[cfg(test)]
+mod ut_archive {
+    include!("../tests/ut/ut_archive.rs");
+}
@@ -0,0 +1,280 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Streaming DEFLATE encoder (RFC 1951) with gzip (RFC 1952) and zlib
+//! (RFC 1950) framing.
+//!
+//! Input is accepted in pieces of any size and encoded in blocks of
+//! `BLOCK_SIZE` bytes with the fixed Huffman codes, matches being searched
+//! by hash chains over the last `WINDOW_SIZE` bytes. Whole bytes of output
+//! are given out as soon as a block is encoded, the bits of a partial byte
+//! are kept for the next block.
+
+use super::inflate::{adler32, crc32, DIST_BASE, DIST_EXTRA, LENGTH_BASE, LENGTH_EXTRA};
+
+const WINDOW_SIZE: usize = 1 << 15;
+const WINDOW_MASK: usize = WINDOW_SIZE - 1;
+/// Input encoded at once as a block.
+const BLOCK_SIZE: usize = 1 << 16;
+const HASH_BITS: usize = 15;
+const MIN_MATCH: usize = 3;
+const MAX_MATCH: usize = 258;
+/// Candidates of a hash chain compared before the longest match is taken.
+const MAX_CHAIN: usize = 64;
+/// No position in a hash chain.
+const NIL: usize = usize::MAX;
+const END_OF_BLOCK: u16 = 256;
+
+const GZIP_HEADER: [u8; 10] = [0x1f, 0x8b, 0x08, 0, 0, 0, 0, 0, 0, 0xff];
+/// Deflate with a 32K window at the default level, checked by `FLG`.
+const ZLIB_HEADER: [u8; 2] = [0x78, 0x9c];
+
+/// Framing of the DEFLATE data.
+#[derive(Clone, Copy, PartialEq, Eq)]
+pub(crate) enum Frame {
+    /// A gzip member.
+    Gzip,
+    /// A zlib stream.
+    Zlib,
+}
+
+/// Output bits not making a whole byte yet.
+struct BitWriter {
+    bits: u64,
+    count: usize,
+}
+
+impl BitWriter {
+    /// Appends the `n` low bits of `value`, least significant first.
+    fn put(&mut self, value: u32, n: usize, out: &mut Vec<u8>) {
+        self.bits |= (value as u64) << self.count;
+        self.count += n;
+        while self.count >= 8 {
+            out.push(self.bits as u8);
+            self.bits >>= 8;
+            self.count -= 8;
+        }
+    }
+
+    /// Appends a Huffman code of `n` bits, most significant first.
+    fn put_code(&mut self, code: u32, n: usize, out: &mut Vec<u8>) {
+        self.put(code.reverse_bits() >> (32 - n), n, out);
+    }
+
+    /// Pads the output to a whole byte.
+    fn flush(&mut self, out: &mut Vec<u8>) {
+        if self.count > 0 {
+            out.push(self.bits as u8);
+        }
+        self.bits = 0;
+        self.count = 0;
+    }
+}
+
+/// Streaming DEFLATE encoder.
+pub(crate) struct Deflater {
+    frame: Frame,
+    started: bool,
+    /// History of up to `WINDOW_SIZE` bytes followed by the input not
+    /// encoded yet.
+    window: Vec<u8>,
+    /// Index in `window` of the first byte not encoded yet.
+    pending: usize,
+    /// Position in the whole input of the first byte of `window`.
+    base: usize,
+    /// Latest position of each hash.
+    head: Vec<usize>,
+    /// Previous position of the same hash, by position modulo the window.
+    prev: Vec<usize>,
+    out: BitWriter,
+    crc: u32,
+    adler: u32,
+    size: u32,
+}
+
+impl Deflater {
+    pub(crate) fn new(frame: Frame) -> Self {
+        Self {
+            frame,
+            started: false,
+            window: Vec::new(),
+            pending: 0,
+            base: 0,
+            head: vec![NIL; 1 << HASH_BITS],
+            prev: vec![NIL; WINDOW_SIZE],
+            out: BitWriter { bits: 0, count: 0 },
+            crc: 0,
+            adler: 1,
+            size: 0,
+        }
+    }
+
+    /// Encodes `data` to `out`, keeping the input short of a block for the
+    /// next call.
+    pub(crate) fn deflate(&mut self, data: &[u8], out: &mut Vec<u8>) {
+        self.start(out);
+        self.crc = crc32(self.crc, data);
+        self.adler = adler32(self.adler, data);
+        self.size = self.size.wrapping_add(data.len() as u32);
+        self.window.extend_from_slice(data);
+        while self.window.len() - self.pending >= BLOCK_SIZE {
+            self.block(self.pending + BLOCK_SIZE, false, out);
+        }
+    }
+
+    /// Encodes the input kept and ends the stream with its trailer.
+    pub(crate) fn finish(&mut self, out: &mut Vec<u8>) {
+        self.start(out);
+        self.block(self.window.len(), true, out);
+        self.out.flush(out);
+        match self.frame {
+            Frame::Gzip => {
+                out.extend_from_slice(&self.crc.to_le_bytes());
+                out.extend_from_slice(&self.size.to_le_bytes());
+            }
+            Frame::Zlib => out.extend_from_slice(&self.adler.to_be_bytes()),
+        }
+    }
+
+    fn start(&mut self, out: &mut Vec<u8>) {
+        if !self.started {
+            self.started = true;
+            match self.frame {
+                Frame::Gzip => out.extend_from_slice(&GZIP_HEADER),
+                Frame::Zlib => out.extend_from_slice(&ZLIB_HEADER),
+            }
+        }
+    }
+
+    /// Encodes the input up to index `end` of the window as a block with the
+    /// fixed codes, matches not reaching past `end`.
+    fn block(&mut self, end: usize, last: bool, out: &mut Vec<u8>) {
+        self.out.put(last as u32, 1, out);
+        self.out.put(1, 2, out);
+        let mut pos = self.pending;
+        while pos < end {
+            let (len, dist) = self.longest_match(pos, end);
+            if len >= MIN_MATCH {
+                self.length(len, out);
+                self.distance(dist, out);
+                for at in pos..pos + len {
+                    self.insert(at, end);
+                }
+                pos += len;
+            } else {
+                self.literal(self.window[pos] as u16, out);
+                self.insert(pos, end);
+                pos += 1;
+            }
+        }
+        self.literal(END_OF_BLOCK, out);
+        self.pending = end;
+
+        // Keep only the history distances can reach
+        if self.window.len() > 2 * WINDOW_SIZE && self.pending > WINDOW_SIZE {
+            let drop = self.pending - WINDOW_SIZE;
+            self.window.drain(..drop);
+            self.pending -= drop;
+            self.base += drop;
+        }
+    }
+
+    fn hash(&self, pos: usize) -> usize {
+        let b = &self.window[pos..pos + MIN_MATCH];
+        let h = ((b[0] as u32) << 16 | (b[1] as u32) << 8 | b[2] as u32).wrapping_mul(0x9e37_79b1);
+        (h >> (32 - HASH_BITS)) as usize
+    }
+
+    /// Adds the position at index `pos` of the window to its hash chain.
+    fn insert(&mut self, pos: usize, end: usize) {
+        if pos + MIN_MATCH > end {
+            return;
+        }
+        let hash = self.hash(pos);
+        let abs = self.base + pos;
+        self.prev[abs & WINDOW_MASK] = self.head[hash];
+        self.head[hash] = abs;
+    }
+
+    /// Returns the length and distance of the longest match of the input at
+    /// index `pos` of the window.
+    fn longest_match(&self, pos: usize, end: usize) -> (usize, usize) {
+        if pos + MIN_MATCH > end {
+            return (0, 0);
+        }
+        let abs = self.base + pos;
+        let max = MAX_MATCH.min(end - pos);
+        let (mut best, mut dist) = (0, 0);
+        let mut candidate = self.head[self.hash(pos)];
+        for _ in 0..MAX_CHAIN {
+            if candidate == NIL
+                || candidate < self.base
+                || candidate >= abs
+                || abs - candidate > WINDOW_SIZE
+            {
+                break;
+            }
+            let from = candidate - self.base;
+            let len = self.window[from..from + max]
+                .iter()
+                .zip(&self.window[pos..pos + max])
+                .take_while(|(a, b)| a == b)
+                .count();
+            if len > best {
+                best = len;
+                dist = abs - candidate;
+                if len == max {
+                    break;
+                }
+            }
+            candidate = self.prev[candidate & WINDOW_MASK];
+        }
+        (best, dist)
+    }
+
+    fn literal(&mut self, symbol: u16, out: &mut Vec<u8>) {
+        let symbol = symbol as u32;
+        match symbol {
+            0..=143 => self.out.put_code(0x30 + symbol, 8, out),
+            144..=255 => self.out.put_code(0x190 + symbol - 144, 9, out),
+            256..=279 => self.out.put_code(symbol - 256, 7, out),
+            _ => self.out.put_code(0xc0 + symbol - 280, 8, out),
+        }
+    }
+
+    fn length(&mut self, len: usize, out: &mut Vec<u8>) {
+        let code = LENGTH_BASE
+            .iter()
+            .rposition(|&base| base as usize <= len)
+            .unwrap_or(0);
+        self.literal(257 + code as u16, out);
+        let extra = LENGTH_EXTRA[code] as usize;
+        if extra > 0 {
+            self.out
+                .put((len - LENGTH_BASE[code] as usize) as u32, extra, out);
+        }
+    }
+
+    fn distance(&mut self, dist: usize, out: &mut Vec<u8>) {
+        let code = DIST_BASE
+            .iter()
+            .rposition(|&base| base as usize <= dist)
+            .unwrap_or(0);
+        self.out.put_code(code as u32, 5, out);
+        let extra = DIST_EXTRA[code] as usize;
+        if extra > 0 {
+            self.out
+                .put((dist - DIST_BASE[code] as usize) as u32, extra, out);
+        }
+    }
+}
@@ -0,0 +1,696 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Streaming DEFLATE decoder (RFC 1951) with gzip (RFC 1952) and zlib
+//! (RFC 1950) framing.
+//!
+//! Input is accepted in pieces of any size. Every step of the decoder, a
+//! header or a symbol, only takes effect once all of its bits are available:
+//! otherwise the bits read are given back and the step is retried when more
+//! input arrives, so the unconsumed tail of a piece is kept until then.
+//! Raw DEFLATE data followed by other data, as in zip archives, gives the
+//! input left after its end back with `take_rest`.
+
+use super::DecodeError;
+
+const WINDOW_SIZE: usize = 1 << 15;
+const WINDOW_MASK: usize = WINDOW_SIZE - 1;
+const MAX_BITS: usize = 15;
+/// Code lengths resolved by a single table lookup.
+const FAST_BITS: usize = 9;
+const FAST_MASK: u64 = (1 << FAST_BITS) - 1;
+
+pub(super) const LENGTH_BASE: [u16; 29] = [
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131,
+    163, 195, 227, 258,
+];
+pub(super) const LENGTH_EXTRA: [u8; 29] = [
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0,
+];
+pub(super) const DIST_BASE: [u16; 30] = [
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537,
+    2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577,
+];
+pub(super) const DIST_EXTRA: [u8; 30] = [
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13,
+    13,
+];
+const CODE_LENGTH_ORDER: [usize; 19] = [
+    16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15,
+];
+
+const GZIP_FTEXT_MASK: u8 = 0xe0;
+const GZIP_FHCRC: u8 = 0x02;
+const GZIP_FEXTRA: u8 = 0x04;
+const GZIP_FNAME: u8 = 0x08;
+const GZIP_FCOMMENT: u8 = 0x10;
+
+const CRC32_TABLE: [u32; 256] = {
+    let mut table = [0u32; 256];
+    let mut i = 0;
+    while i < 256 {
+        let mut crc = i as u32;
+        let mut k = 0;
+        while k < 8 {
+            crc = if crc & 1 != 0 {
+                0xedb8_8320 ^ (crc >> 1)
+            } else {
+                crc >> 1
+            };
+            k += 1;
+        }
+        table[i] = crc;
+        i += 1;
+    }
+    table
+};
+
+pub(crate) fn crc32(crc: u32, data: &[u8]) -> u32 {
+    let mut crc = !crc;
+    for &b in data {
+        crc = CRC32_TABLE[((crc ^ b as u32) & 0xff) as usize] ^ (crc >> 8);
+    }
+    !crc
+}
+
+pub(crate) fn adler32(adler: u32, data: &[u8]) -> u32 {
+    // Largest number of bytes summed before the sums can overflow.
+    const NMAX: usize = 5552;
+    const BASE: u32 = 65521;
+    let (mut a, mut b) = (adler & 0xffff, adler >> 16);
+    for chunk in data.chunks(NMAX) {
+        for &byte in chunk {
+            a += byte as u32;
+            b += a;
+        }
+        a %= BASE;
+        b %= BASE;
+    }
+    (b << 16) | a
+}
+
+/// Returns `Ok(None)` from the enclosing step if the input runs out.
+macro_rules! need {
+    ($e:expr) => {
+        match $e {
+            Some(v) => v,
+            None => return Ok(None),
+        }
+    };
+}
+
+/// Framing of the DEFLATE data.
+#[derive(Clone, Copy, PartialEq, Eq)]
+pub(crate) enum Format {
+    /// gzip members, possibly several.
+    Gzip,
+    /// zlib stream, or raw DEFLATE data if it has no zlib header.
+    Deflate,
+    /// Raw DEFLATE data only.
+    Raw,
+}
+
+/// Checksum of the decoded data of a member.
+enum Check {
+    Crc32 { crc: u32, size: u32 },
+    Adler32(u32),
+    None,
+}
+
+/// Canonical Huffman code.
+struct Huffman {
+    /// Number of codes of each length
+    counts: [u16; MAX_BITS + 1],
+    /// Symbols ordered by code
+    symbols: Vec<u16>,
+    /// Symbol and length of the codes of at most `FAST_BITS` bits, indexed by
+    /// their bit-reversed code, 0 for longer codes.
+    fast: Vec<u16>,
+}
+
+impl Huffman {
+    fn new(lengths: &[u8]) -> Result<Self, DecodeError> {
+        let mut counts = [0u16; MAX_BITS + 1];
+        for &len in lengths {
+            counts[len as usize] += 1;
+        }
+        counts[0] = 0;
+        let mut left = 1i32;
+        for count in &counts[1..] {
+            left = (left << 1) - *count as i32;
+            if left < 0 {
+                return Err(DecodeError::InvalidData);
+            }
+        }
+        let mut offsets = [0u16; MAX_BITS + 1];
+        for len in 1..MAX_BITS {
+            offsets[len + 1] = offsets[len] + counts[len];
+        }
+        let mut symbols = vec![0u16; lengths.len()];
+        for (symbol, &len) in lengths.iter().enumerate() {
+            if len != 0 {
+                symbols[offsets[len as usize] as usize] = symbol as u16;
+                offsets[len as usize] += 1;
+            }
+        }
+
+        let mut fast = vec![0u16; 1 << FAST_BITS];
+        let (mut code, mut index) = (0u32, 0usize);
+        for (len, &count) in counts.iter().enumerate().take(FAST_BITS + 1).skip(1) {
+            for _ in 0..count {
+                let entry = (symbols[index] << 4) | len as u16;
+                let mut i = (code.reverse_bits() >> (32 - len)) as usize;
+                while i < fast.len() {
+                    fast[i] = entry;
+                    i += 1 << len;
+                }
+                code += 1;
+                index += 1;
+            }
+            code <<= 1;
+        }
+        Ok(Self {
+            counts,
+            symbols,
+            fast,
+        })
+    }
+
+    fn fixed() -> (Self, Self) {
+        let mut lengths = [0u8; 288];
+        lengths[..144].fill(8);
+        lengths[144..256].fill(9);
+        lengths[256..280].fill(7);
+        lengths[280..].fill(8);
+        // Both tables are valid, they cannot fail.
+        (Self::new(&lengths).unwrap(), Self::new(&[5; 30]).unwrap())
+    }
+}
+
+/// Input not consumed yet and the bits read ahead of it.
+struct Bits {
+    buf: Vec<u8>,
+    pos: usize,
+    bits: u64,
+    count: usize,
+}
+
+impl Bits {
+    fn save(&self) -> (usize, u64, usize) {
+        (self.pos, self.bits, self.count)
+    }
+
+    fn restore(&mut self, (pos, bits, count): (usize, u64, usize)) {
+        self.pos = pos;
+        self.bits = bits;
+        self.count = count;
+    }
+
+    /// Reads ahead until at least `n` bits are available, `false` if the
+    /// input runs out first.
+    fn fill(&mut self, n: usize) -> bool {
+        while self.count < n {
+            let Some(&byte) = self.buf.get(self.pos) else {
+                return false;
+            };
+            self.bits |= (byte as u64) << self.count;
+            self.pos += 1;
+            self.count += 8;
+        }
+        true
+    }
+
+    fn consume(&mut self, n: usize) {
+        self.bits >>= n;
+        self.count -= n;
+    }
+
+    fn take(&mut self, n: usize) -> Option<u32> {
+        if !self.fill(n) {
+            return None;
+        }
+        let value = (self.bits & ((1 << n) - 1)) as u32;
+        self.consume(n);
+        Some(value)
+    }
+
+    /// Drops the bits left in the current byte.
+    fn align(&mut self) {
+        self.consume(self.count % 8);
+    }
+
+    /// Takes a whole byte, the bits must be aligned.
+    fn byte(&mut self) -> Option<u8> {
+        self.take(8).map(|b| b as u8)
+    }
+
+    fn u16_le(&mut self) -> Option<u16> {
+        Some(self.byte()? as u16 | (self.byte()? as u16) << 8)
+    }
+
+    fn u32_le(&mut self) -> Option<u32> {
+        Some(self.u16_le()? as u32 | (self.u16_le()? as u32) << 16)
+    }
+
+    fn is_empty(&self) -> bool {
+        self.count == 0 && self.pos == self.buf.len()
+    }
+
+    fn decode(&mut self, code: &Huffman) -> Result<Option<u16>, DecodeError> {
+        self.fill(MAX_BITS);
+        let entry = code.fast[(self.bits & FAST_MASK) as usize];
+        let len = (entry & 0xf) as usize;
+        if entry != 0 && len <= self.count {
+            self.consume(len);
+            return Ok(Some(entry >> 4));
+        }
+        // Codes longer than the table, one bit at a time.
+        let (mut value, mut first, mut index) = (0i32, 0i32, 0i32);
+        for len in 1..=MAX_BITS {
+            if len > self.count {
+                return Ok(None);
+            }
+            value |= ((self.bits >> (len - 1)) & 1) as i32;
+            let count = code.counts[len] as i32;
+            if value - first < count {
+                self.consume(len);
+                return Ok(Some(code.symbols[(index + value - first) as usize]));
+            }
+            index += count;
+            first = (first + count) << 1;
+            value <<= 1;
+        }
+        Err(DecodeError::InvalidData)
+    }
+}
+
+enum Stage {
+    /// Start of a zlib or raw DEFLATE stream.
+    Detect,
+    /// Header of a gzip member, `true` for the first one.
+    GzipHeader(bool),
+    BlockHeader,
+    /// Bytes left in a stored block.
+    Stored(usize),
+    /// Compressed block with its literal/length and distance codes.
+    Codes(Box<(Huffman, Huffman)>),
+    Trailer,
+    /// End of a gzip member, another one may follow.
+    MemberEnd,
+    Done,
+}
+
+/// Streaming DEFLATE decoder.
+pub(crate) struct Inflater {
+    format: Format,
+    stage: Stage,
+    input: Bits,
+    window: Box<[u8; WINDOW_SIZE]>,
+    window_pos: usize,
+    /// Bytes decoded in the current member, distances cannot reach further
+    history: usize,
+    last_block: bool,
+    check: Check,
+}
+
+impl Inflater {
+    pub(crate) fn new(format: Format) -> Self {
+        let stage = match format {
+            Format::Gzip => Stage::GzipHeader(true),
+            Format::Deflate => Stage::Detect,
+            Format::Raw => Stage::BlockHeader,
+        };
+        Self {
+            format,
+            stage,
+            input: Bits {
+                buf: Vec::new(),
+                pos: 0,
+                bits: 0,
+                count: 0,
+            },
+            window: Box::new([0; WINDOW_SIZE]),
+            window_pos: 0,
+            history: 0,
+            last_block: false,
+            check: Check::None,
+        }
+    }
+
+    /// Whether the data decoded so far is a complete stream.
+    pub(crate) fn is_complete(&self) -> bool {
+        matches!(self.stage, Stage::MemberEnd | Stage::Done)
+    }
+
+    /// Takes the input left after the end of the stream, the bytes read
+    /// ahead included.
+    pub(crate) fn take_rest(&mut self) -> Vec<u8> {
+        self.input.align();
+        let mut rest = Vec::with_capacity(self.input.buf.len() - self.input.pos + 8);
+        while self.input.count >= 8 {
+            rest.push(self.input.bits as u8);
+            self.input.consume(8);
+        }
+        rest.extend_from_slice(&self.input.buf[self.input.pos..]);
+        self.input.buf.clear();
+        self.input.pos = 0;
+        rest
+    }
+
+    /// Decodes `data` to `out`, keeping the bytes that do not complete a step
+    /// for the next call.
+    pub(crate) fn inflate(&mut self, data: &[u8], out: &mut Vec<u8>) -> Result<(), DecodeError> {
+        self.input.buf.drain(..self.input.pos);
+        self.input.pos = 0;
+        self.input.buf.extend_from_slice(data);
+        let mut checked = out.len();
+        let result = self.run(out, &mut checked);
+        self.update_check(&out[checked..]);
+        result
+    }
+
+    /// Runs the steps the input allows, `checked` is where the output not
+    /// added to the checksum yet starts.
+    fn run(&mut self, out: &mut Vec<u8>, checked: &mut usize) -> Result<(), DecodeError> {
+        loop {
+            let saved = self.input.save();
+            let next = match &mut self.stage {
+                Stage::Detect => self.detect()?,
+                Stage::GzipHeader(first) => {
+                    let first = *first;
+                    self.gzip_header(first)?
+                }
+                Stage::BlockHeader => self.block_header()?,
+                Stage::Stored(left) => {
+                    let left = *left;
+                    self.stored(left, out)
+                }
+                Stage::Codes(_) => match self.codes(out)? {
+                    Some(stage) => Some(stage),
+                    // The symbols decoded are kept, only the last one is retried.
+                    None => return Ok(()),
+                },
+                Stage::Trailer => {
+                    // The checksum covers the member up to here.
+                    self.update_check(&out[*checked..]);
+                    *checked = out.len();
+                    self.trailer()?
+                }
+                Stage::MemberEnd => {
+                    if self.input.is_empty() {
+                        None
+                    } else {
+                        Some(Stage::GzipHeader(false))
+                    }
+                }
+                Stage::Done => {
+                    // Data after the stream is ignored.
+                    self.input.pos = self.input.buf.len();
+                    self.input.count = 0;
+                    None
+                }
+            };
+            match next {
+                Some(stage) => self.stage = stage,
+                None => {
+                    self.input.restore(saved);
+                    return Ok(());
+                }
+            }
+        }
+    }
+
+    fn update_check(&mut self, data: &[u8]) {
+        match &mut self.check {
+            Check::Crc32 { crc, size } => {
+                *crc = crc32(*crc, data);
+                *size = size.wrapping_add(data.len() as u32);
+            }
+            Check::Adler32(adler) => *adler = adler32(*adler, data),
+            Check::None => {}
+        }
+    }
+
+    fn detect(&mut self) -> Result<Option<Stage>, DecodeError> {
+        if !self.input.fill(16) {
+            return Ok(None);
+        }
+        let (cmf, flg) = (self.input.bits as u8, (self.input.bits >> 8) as u8);
+        let zlib = cmf & 0x0f == 8 && cmf >> 4 <= 7 && (((cmf as u16) << 8) | flg as u16) % 31 == 0;
+        if zlib {
+            if flg & 0x20 != 0 {
+                // A preset dictionary is never used by HTTP content.
+                return Err(DecodeError::InvalidHeader);
+            }
+            self.input.consume(16);
+            self.check = Check::Adler32(1);
+        }
+        Ok(Some(Stage::BlockHeader))
+    }
+
+    fn gzip_header(&mut self, first: bool) -> Result<Option<Stage>, DecodeError> {
+        let id1 = need!(self.input.byte());
+        if id1 != 0x1f && !first {
+            // Not another member but padding after the last one.
+            return Ok(Some(Stage::Done));
+        }
+        let id2 = need!(self.input.byte());
+        let method = need!(self.input.byte());
+        let flags = need!(self.input.byte());
+        if id1 != 0x1f || id2 != 0x8b || method != 8 || flags & GZIP_FTEXT_MASK != 0 {
+            return Err(DecodeError::InvalidHeader);
+        }
+        // MTIME, XFL and OS
+        for _ in 0..6 {
+            need!(self.input.byte());
+        }
+        if flags & GZIP_FEXTRA != 0 {
+            let len = need!(self.input.u16_le());
+            for _ in 0..len {
+                need!(self.input.byte());
+            }
+        }
+        for flag in [GZIP_FNAME, GZIP_FCOMMENT] {
+            if flags & flag != 0 {
+                while need!(self.input.byte()) != 0 {}
+            }
+        }
+        if flags & GZIP_FHCRC != 0 {
+            need!(self.input.u16_le());
+        }
+        self.check = Check::Crc32 { crc: 0, size: 0 };
+        self.history = 0;
+        Ok(Some(Stage::BlockHeader))
+    }
+
+    fn block_header(&mut self) -> Result<Option<Stage>, DecodeError> {
+        let header = need!(self.input.take(3));
+        let last = header & 1 != 0;
+        let stage = match header >> 1 {
+            0 => {
+                self.input.align();
+                let len = need!(self.input.u16_le());
+                let nlen = need!(self.input.u16_le());
+                if len != !nlen {
+                    return Err(DecodeError::InvalidData);
+                }
+                Stage::Stored(len as usize)
+            }
+            1 => Stage::Codes(Box::new(Huffman::fixed())),
+            2 => Stage::Codes(Box::new(need!(self.dynamic_codes()?))),
+            _ => return Err(DecodeError::InvalidData),
+        };
+        self.last_block = last;
+        Ok(Some(stage))
+    }
+
+    fn dynamic_codes(&mut self) -> Result<Option<(Huffman, Huffman)>, DecodeError> {
+        let nlen = need!(self.input.take(5)) as usize + 257;
+        let ndist = need!(self.input.take(5)) as usize + 1;
+        let ncode = need!(self.input.take(4)) as usize + 4;
+        if nlen > 286 || ndist > 30 {
+            return Err(DecodeError::InvalidData);
+        }
+        let mut lengths = [0u8; 19];
+        for &index in &CODE_LENGTH_ORDER[..ncode] {
+            lengths[index] = need!(self.input.take(3)) as u8;
+        }
+        let code = Huffman::new(&lengths)?;
+
+        let mut lengths = [0u8; 286 + 30];
+        let mut index = 0;
+        while index < nlen + ndist {
+            let symbol = need!(self.input.decode(&code)?);
+            let (len, repeat) = match symbol {
+                0..=15 => (symbol as u8, 1),
+                16 => {
+                    if index == 0 {
+                        return Err(DecodeError::InvalidData);
+                    }
+                    (lengths[index - 1], 3 + need!(self.input.take(2)))
+                }
+                17 => (0, 3 + need!(self.input.take(3))),
+                _ => (0, 11 + need!(self.input.take(7))),
+            };
+            let end = index + repeat as usize;
+            if end > nlen + ndist {
+                return Err(DecodeError::InvalidData);
+            }
+            lengths[index..end].fill(len);
+            index = end;
+        }
+        if lengths[256] == 0 {
+            return Err(DecodeError::InvalidData);
+        }
+        Ok(Some((
+            Huffman::new(&lengths[..nlen])?,
+            Huffman::new(&lengths[nlen..nlen + ndist])?,
+        )))
+    }
+
+    fn after_block(&self) -> Stage {
+        match (self.last_block, self.format, &self.check) {
+            (false, _, _) => Stage::BlockHeader,
+            (true, Format::Deflate | Format::Raw, Check::None) => Stage::Done,
+            (true, _, _) => Stage::Trailer,
+        }
+    }
+
+    /// Copies the bytes of a stored block available, `None` if there are none.
+    fn stored(&mut self, mut left: usize, out: &mut Vec<u8>) -> Option<Stage> {
+        let before = left;
+        // Bytes already read ahead come first.
+        while left > 0 && self.input.count >= 8 {
+            let byte = self.input.bits as u8;
+            self.input.consume(8);
+            self.emit(byte, out);
+            left -= 1;
+        }
+        let n = left.min(self.input.buf.len() - self.input.pos);
+        let start = self.input.pos;
+        self.input.pos += n;
+        for i in start..start + n {
+            let byte = self.input.buf[i];
+            self.window[self.window_pos] = byte;
+            self.window_pos = (self.window_pos + 1) & WINDOW_MASK;
+        }
+        out.extend_from_slice(&self.input.buf[start..start + n]);
+        self.history += n;
+        left -= n;
+        if left == 0 {
+            Some(self.after_block())
+        } else if left == before {
+            None
+        } else {
+            Some(Stage::Stored(left))
+        }
+    }
+
+    fn emit(&mut self, byte: u8, out: &mut Vec<u8>) {
+        self.window[self.window_pos] = byte;
+        self.window_pos = (self.window_pos + 1) & WINDOW_MASK;
+        self.history += 1;
+        out.push(byte);
+    }
+
+    fn codes(&mut self, out: &mut Vec<u8>) -> Result<Option<Stage>, DecodeError> {
+        let Stage::Codes(codes) = std::mem::replace(&mut self.stage, Stage::Done) else {
+            unreachable!()
+        };
+        let result = self.symbols(&codes, out);
+        self.stage = Stage::Codes(codes);
+        result
+    }
+
+    /// Decodes symbols until the end of the block or of the input.
+    fn symbols(
+        &mut self,
+        (lit, dist): &(Huffman, Huffman),
+        out: &mut Vec<u8>,
+    ) -> Result<Option<Stage>, DecodeError> {
+        loop {
+            let saved = self.input.save();
+            match self.symbol(lit, dist, out)? {
+                Some(true) => {}
+                Some(false) => return Ok(Some(self.after_block())),
+                None => {
+                    self.input.restore(saved);
+                    return Ok(None);
+                }
+            }
+        }
+    }
+
+    /// Decodes one literal or match, `Some(false)` at the end of the block.
+    fn symbol(
+        &mut self,
+        lit: &Huffman,
+        dist: &Huffman,
+        out: &mut Vec<u8>,
+    ) -> Result<Option<bool>, DecodeError> {
+        let symbol = need!(self.input.decode(lit)?) as usize;
+        if symbol < 256 {
+            self.emit(symbol as u8, out);
+            return Ok(Some(true));
+        }
+        if symbol == 256 {
+            return Ok(Some(false));
+        }
+        let index = symbol - 257;
+        if index >= LENGTH_BASE.len() {
+            return Err(DecodeError::InvalidData);
+        }
+        let len = LENGTH_BASE[index] as usize
+            + need!(self.input.take(LENGTH_EXTRA[index] as usize)) as usize;
+        let index = need!(self.input.decode(dist)?) as usize;
+        if index >= DIST_BASE.len() {
+            return Err(DecodeError::InvalidData);
+        }
+        let distance =
+            DIST_BASE[index] as usize + need!(self.input.take(DIST_EXTRA[index] as usize)) as usize;
+        if distance > self.history.min(WINDOW_SIZE) {
+            return Err(DecodeError::InvalidData);
+        }
+        out.reserve(len);
+        for _ in 0..len {
+            let byte = self.window[(self.window_pos.wrapping_sub(distance)) & WINDOW_MASK];
+            self.emit(byte, out);
+        }
+        Ok(Some(true))
+    }
+
+    fn trailer(&mut self) -> Result<Option<Stage>, DecodeError> {
+        self.input.align();
+        match self.check {
+            Check::Crc32 { crc, size } => {
+                let expected_crc = need!(self.input.u32_le());
+                let expected_size = need!(self.input.u32_le());
+                if crc != expected_crc || size != expected_size {
+                    return Err(DecodeError::Checksum);
+                }
+                Ok(Some(Stage::MemberEnd))
+            }
+            Check::Adler32(adler) => {
+                let mut expected = 0u32;
+                for _ in 0..4 {
+                    expected = (expected << 8) | need!(self.input.byte()) as u32;
+                }
+                if adler != expected {
+                    return Err(DecodeError::Checksum);
+                }
+                Ok(Some(Stage::Done))
+            }
+            Check::None => Ok(Some(Stage::Done)),
+        }
+    }
+}
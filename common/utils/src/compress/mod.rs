@@ -0,0 +1,247 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Content coding of HTTP bodies.
+//!
+//! A body sent with a `Content-Encoding` of `gzip` or `deflate` is decoded
+//! while it is received, in pieces of any size, so it is stored decoded
+//! without being read again. Only these encodings are advertised, they are
+//! the ones a decoder is available for. Request bodies are encoded the same
+//! way while they are sent.
+
+mod deflate;
+pub(crate) mod inflate;
+
+use std::fmt;
+
+use deflate::{Deflater, Frame};
+use inflate::{Format, Inflater};
+
+/// `Accept-Encoding` value advertising the encodings that can be decoded.
+pub const ACCEPT_ENCODING: &str = "gzip, deflate";
+
+/// Content encoding of a response body.
+#[derive(Clone, Copy, PartialEq, Eq, Debug)]
+pub enum ContentEncoding {
+    /// gzip file format.
+    Gzip,
+    /// zlib format, or raw DEFLATE data as sent by some servers.
+    Deflate,
+}
+
+impl ContentEncoding {
+    /// Parses a `Content-Encoding` header value.
+    ///
+    /// Returns `None` for the identity encoding and for encodings that cannot
+    /// be decoded, whose bodies are kept as they are.
+    ///
+    /// # Examples
+    ///
+    /// ```rust
+    /// use request_utils::compress::ContentEncoding;
+    ///
+    /// assert_eq!(ContentEncoding::parse("GZip"), Some(ContentEncoding::Gzip));
+    /// assert_eq!(ContentEncoding::parse("identity"), None);
+    /// ```
+    pub fn parse(value: &str) -> Option<Self> {
+        let value = value.trim();
+        if value.eq_ignore_ascii_case("gzip") || value.eq_ignore_ascii_case("x-gzip") {
+            Some(Self::Gzip)
+        } else if value.eq_ignore_ascii_case("deflate") {
+            Some(Self::Deflate)
+        } else {
+            None
+        }
+    }
+
+    /// Returns the `Content-Encoding` header value of the encoding.
+    pub fn as_str(&self) -> &'static str {
+        match self {
+            Self::Gzip => "gzip",
+            Self::Deflate => "deflate",
+        }
+    }
+}
+
+/// Error decoding a body.
+#[derive(Clone, Copy, PartialEq, Eq, Debug)]
+pub enum DecodeError {
+    /// The gzip or zlib header is invalid.
+    InvalidHeader,
+    /// The compressed data is invalid.
+    InvalidData,
+    /// The decoded data does not match its checksum or length.
+    Checksum,
+    /// The body ended before the end of the compressed data.
+    Truncated,
+}
+
+impl fmt::Display for DecodeError {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        let msg = match self {
+            Self::InvalidHeader => "invalid header",
+            Self::InvalidData => "invalid compressed data",
+            Self::Checksum => "checksum mismatch",
+            Self::Truncated => "truncated compressed data",
+        };
+        f.write_str(msg)
+    }
+}
+
+impl std::error::Error for DecodeError {}
+
+/// Streaming decoder of an encoded body.
+///
+/// # Examples
+///
+/// ```rust
+/// use request_utils::compress::{ContentDecoder, ContentEncoding};
+///
+/// // "hello" compressed with gzip
+/// let body = [
+///     0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0xcb, 0x48, 0xcd, 0xc9,
+///     0xc9, 0x07, 0x00, 0x86, 0xa6, 0x10, 0x36, 0x05, 0x00, 0x00, 0x00,
+/// ];
+/// let mut decoder = ContentDecoder::new(ContentEncoding::Gzip);
+/// let mut out = Vec::new();
+/// for piece in body.chunks(4) {
+///     decoder.decode(piece, &mut out).unwrap();
+/// }
+/// decoder.finish().unwrap();
+/// assert_eq!(out, b"hello");
+/// assert_eq!(decoder.wire_bytes(), body.len() as u64);
+/// ```
+pub struct ContentDecoder {
+    inflater: Inflater,
+    wire: u64,
+    decoded: u64,
+}
+
+impl ContentDecoder {
+    /// Creates a decoder of a body with the given encoding.
+    pub fn new(encoding: ContentEncoding) -> Self {
+        let format = match encoding {
+            ContentEncoding::Gzip => Format::Gzip,
+            ContentEncoding::Deflate => Format::Deflate,
+        };
+        Self {
+            inflater: Inflater::new(format),
+            wire: 0,
+            decoded: 0,
+        }
+    }
+
+    /// Decodes the next piece of the body, appending the decoded bytes to
+    /// `out`. Bytes completing no decoding step are kept for the next piece.
+    pub fn decode(&mut self, data: &[u8], out: &mut Vec<u8>) -> Result<(), DecodeError> {
+        let len = out.len();
+        self.wire += data.len() as u64;
+        let result = self.inflater.inflate(data, out);
+        self.decoded += (out.len() - len) as u64;
+        result
+    }
+
+    /// Checks that the body received is complete.
+    pub fn finish(&self) -> Result<(), DecodeError> {
+        if self.inflater.is_complete() {
+            Ok(())
+        } else {
+            Err(DecodeError::Truncated)
+        }
+    }
+
+    /// Returns the number of encoded bytes received.
+    pub fn wire_bytes(&self) -> u64 {
+        self.wire
+    }
+
+    /// Returns the number of bytes decoded.
+    pub fn decoded_bytes(&self) -> u64 {
+        self.decoded
+    }
+}
+
+/// Streaming encoder of a body.
+///
+/// # Examples
+///
+/// ```rust
+/// use request_utils::compress::{ContentDecoder, ContentEncoder, ContentEncoding};
+///
+/// let body = b"hello hello hello hello".repeat(100);
+/// let mut encoder = ContentEncoder::new(ContentEncoding::Gzip);
+/// let mut encoded = Vec::new();
+/// for piece in body.chunks(7) {
+///     encoder.encode(piece, &mut encoded);
+/// }
+/// encoder.finish(&mut encoded);
+/// assert!(encoded.len() < body.len() / 10);
+///
+/// let mut decoder = ContentDecoder::new(ContentEncoding::Gzip);
+/// let mut out = Vec::new();
+/// decoder.decode(&encoded, &mut out).unwrap();
+/// decoder.finish().unwrap();
+/// assert_eq!(out, body);
+/// ```
+pub struct ContentEncoder {
+    deflater: Deflater,
+    source: u64,
+    wire: u64,
+}
+
+impl ContentEncoder {
+    /// Creates an encoder of a body with the given encoding, `deflate`
+    /// being sent as a zlib stream.
+    pub fn new(encoding: ContentEncoding) -> Self {
+        let frame = match encoding {
+            ContentEncoding::Gzip => Frame::Gzip,
+            ContentEncoding::Deflate => Frame::Zlib,
+        };
+        Self {
+            deflater: Deflater::new(frame),
+            source: 0,
+            wire: 0,
+        }
+    }
+
+    /// Encodes the next piece of the body, appending the encoded bytes to
+    /// `out`. Bytes completing no block are kept for the next piece.
+    pub fn encode(&mut self, data: &[u8], out: &mut Vec<u8>) {
+        let len = out.len();
+        self.source += data.len() as u64;
+        self.deflater.deflate(data, out);
+        self.wire += (out.len() - len) as u64;
+    }
+
+    /// Encodes the bytes kept and ends the body, appending them to `out`.
+    pub fn finish(&mut self, out: &mut Vec<u8>) {
+        let len = out.len();
+        self.deflater.finish(out);
+        self.wire += (out.len() - len) as u64;
+    }
+
+    /// Returns the number of bytes of the body encoded.
+    pub fn source_bytes(&self) -> u64 {
+        self.source
+    }
+
+    /// Returns the number of encoded bytes given out.
+    pub fn wire_bytes(&self) -> u64 {
+        self.wire
+    }
+}
+
+#[cfg(test)]
+mod ut_compress {
+    include!("../../tests/ut/compress/ut_compress.rs");
+}
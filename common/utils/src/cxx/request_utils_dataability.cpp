@@ -18,7 +18,7 @@
 
 namespace OHOS::Request {
 
-int32_t DataAbilityOpenFile(std::shared_ptr<Context> const &context, const std::string &path)
+int32_t DataAbilityOpenFile(std::shared_ptr<Context> const &context, const std::string &path, const std::string &mode)
 {
     std::shared_ptr<Uri> uri = std::make_shared<Uri>(path);
     std::shared_ptr<AppExecFwk::DataAbilityHelper> dataAbilityHelper =
@@ -26,7 +26,7 @@ int32_t DataAbilityOpenFile(std::shared_ptr<Context> const &context, const std::
     if (dataAbilityHelper == nullptr) {
         return -1;
     }
-    return dataAbilityHelper->OpenFile(*uri, "r");
+    return dataAbilityHelper->OpenFile(*uri, mode);
 }
 
 } // namespace OHOS::Request
\ No newline at end of file
@@ -16,7 +16,11 @@
 #include "request_utils_wrapper.h"
 
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <sstream>
+#include <unordered_map>
+#include <vector>
 
 #include "ani.h"
 #include "ani_base_context.h"
@@ -25,6 +29,51 @@
 #include "network_security_config.h"
 
 namespace OHOS::Request {
+namespace {
+// Hostnames whose network security config is kept, the cache is emptied when full.
+constexpr size_t MAX_CACHED_HOSTS = 64;
+
+// Network security config of one hostname, each part is resolved on first use.
+struct HostSecurity {
+    std::optional<bool> cleartextPermitted;
+    std::optional<std::vector<std::string>> trustAnchors;
+    std::optional<std::string> certificatePins;
+};
+
+// The network security config of the application is fixed for the life of the
+// process, so it is resolved once per hostname instead of for every request.
+struct HostSecurityCache {
+    std::mutex mutex;
+    std::unordered_map<std::string, HostSecurity> hosts;
+};
+
+HostSecurityCache &GetHostSecurityCache()
+{
+    // Never destroyed, so it can be used while the process exits.
+    static HostSecurityCache *cache = new HostSecurityCache();
+    return *cache;
+}
+
+template<typename T, typename F>
+T CachedHostSecurity(std::string const &hostname, std::optional<T> HostSecurity::*part, F resolve)
+{
+    auto &cache = GetHostSecurityCache();
+    {
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        auto it = cache.hosts.find(hostname);
+        if (it != cache.hosts.end() && (it->second.*part).has_value()) {
+            return *(it->second.*part);
+        }
+    }
+    T value = resolve();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    if (cache.hosts.size() >= MAX_CACHED_HOSTS && cache.hosts.find(hostname) == cache.hosts.end()) {
+        cache.hosts.clear();
+    }
+    cache.hosts[hostname].*part = value;
+    return value;
+}
+} // namespace
 
 rust::string GetCacheDir()
 {
@@ -75,15 +124,23 @@ std::shared_ptr<AbilityRuntime::Context> GetStageModeContext(AniEnv **env, AniOb
 
 bool IsCleartextPermitted(std::string const &hostname)
 {
-    bool cleartextPermitted = true;
-    OHOS::NetManagerStandard::NetworkSecurityConfig::GetInstance().IsCleartextPermitted(hostname, cleartextPermitted);
-    return cleartextPermitted;
+    return CachedHostSecurity(hostname, &HostSecurity::cleartextPermitted, [&hostname]() {
+        bool cleartextPermitted = true;
+        OHOS::NetManagerStandard::NetworkSecurityConfig::GetInstance().IsCleartextPermitted(
+            hostname, cleartextPermitted);
+        return cleartextPermitted;
+    });
 }
 
 rust::vec<rust::string> GetTrustAnchorsForHostName(std::string const &hostname)
 {
-    std::vector<std::string> trustAnchors;
-    OHOS::NetManagerStandard::NetworkSecurityConfig::GetInstance().GetTrustAnchorsForHostName(hostname, trustAnchors);
+    std::vector<std::string> trustAnchors =
+        CachedHostSecurity(hostname, &HostSecurity::trustAnchors, [&hostname]() {
+            std::vector<std::string> trustAnchors;
+            OHOS::NetManagerStandard::NetworkSecurityConfig::GetInstance().GetTrustAnchorsForHostName(
+                hostname, trustAnchors);
+            return trustAnchors;
+        });
     rust::vec<rust::string> ret;
     for (auto &anchor : trustAnchors) {
         ret.push_back(anchor);
@@ -93,11 +150,14 @@ rust::vec<rust::string> GetTrustAnchorsForHostName(std::string const &hostname)
 
 rust::string GetCertificatePinsForHostName(std::string const &hostname)
 {
-    if (OHOS::NetManagerStandard::NetworkSecurityConfig::GetInstance().IsPinOpenMode(hostname)) {
-        return "";
-    }
-    std::string certificatePins;
-    OHOS::NetManagerStandard::NetworkSecurityConfig::GetInstance().GetPinSetForHostName(hostname, certificatePins);
-    return certificatePins;
+    return CachedHostSecurity(hostname, &HostSecurity::certificatePins, [&hostname]() {
+        std::string certificatePins;
+        if (OHOS::NetManagerStandard::NetworkSecurityConfig::GetInstance().IsPinOpenMode(hostname)) {
+            return certificatePins;
+        }
+        OHOS::NetManagerStandard::NetworkSecurityConfig::GetInstance().GetPinSetForHostName(
+            hostname, certificatePins);
+        return certificatePins;
+    });
 }
 } // namespace OHOS::Request
\ No newline at end of file
@@ -33,6 +33,10 @@ mod ffi {
         #[namespace = "OHOS::AbilityRuntime"]
         type Context = request_utils::wrapper::Context;
 
-        fn DataAbilityOpenFile(context: &SharedPtr<Context>, path: &CxxString) -> i32;
+        fn DataAbilityOpenFile(
+            context: &SharedPtr<Context>,
+            path: &CxxString,
+            mode: &CxxString,
+        ) -> i32;
     }
 }
\ No newline at end of file
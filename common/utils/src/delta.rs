@@ -0,0 +1,291 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Blocks of a new version of a file found in an old one, after zsync.
+//!
+//! The server publishes a [`Manifest`] of the new version: the size of its
+//! blocks, its length, and a weak rolling checksum and an MD5 digest of every
+//! full block. The old version, the base, is scanned with a window of one
+//! block rolled a byte at a time, and a window whose weak checksum and digest
+//! match a block is a copy of it. The [`Assembly`] of the new version copies
+//! the blocks found from the base and fetches the others, the last partial
+//! block always being fetched.
+//!
+//! The manifest is text, headers then one line per block:
+//!
+//! ```text
+//! Blocksize: 4096
+//! Length: 10000
+//! SHA-256: <hex digest of the file, optional>
+//!
+//! <weak checksum, 8 hex digits> <MD5 digest, 32 hex digits>
+//! ```
+//!
+//! The weak checksum of bytes `x[0..n]` is `b << 16 | a`, with `a` the sum of
+//! `x[i]` and `b` the sum of `(n - i) * x[i]`, both modulo 2^16.
+
+use std::collections::HashMap;
+use std::io::{self, Read};
+
+use crate::hash::Md5;
+
+/// Smallest block size accepted.
+const MIN_BLOCK_SIZE: usize = 512;
+
+/// Largest block size accepted.
+const MAX_BLOCK_SIZE: usize = 4 * 1024 * 1024;
+
+/// Bytes of the base read at once.
+const READ_SIZE: usize = 256 * 1024;
+
+/// Checksums of a full block of the new version.
+struct Block {
+    weak: u32,
+    strong: [u8; 16],
+}
+
+/// Block checksums of the new version of a file.
+pub struct Manifest {
+    /// Size of the blocks in bytes
+    pub block_size: usize,
+    /// Length of the new version in bytes
+    pub length: u64,
+    /// SHA-256 digest of the new version, if the manifest has one
+    pub sha256: Option<Vec<u8>>,
+    blocks: Vec<Block>,
+}
+
+impl Manifest {
+    /// Parses a manifest.
+    ///
+    /// # Returns
+    ///
+    /// `None` if a header is missing or malformed, the block size is out of
+    /// bounds, or the number of blocks does not match the length.
+    ///
+    /// # Examples
+    ///
+    /// ```rust
+    /// use request_utils::delta::Manifest;
+    ///
+    /// let manifest = Manifest::parse("Blocksize: 4096\nLength: 100\n\n").unwrap();
+    /// assert_eq!(manifest.length, 100);
+    /// ```
+    pub fn parse(text: &str) -> Option<Self> {
+        let mut lines = text.lines();
+        let (mut block_size, mut length, mut sha256) = (None, None, None);
+        for line in lines.by_ref() {
+            let line = line.trim();
+            if line.is_empty() {
+                break;
+            }
+            let (name, value) = line.split_once(':')?;
+            let value = value.trim();
+            match name.trim().to_ascii_lowercase().as_str() {
+                "blocksize" => block_size = Some(value.parse::<usize>().ok()?),
+                "length" => length = Some(value.parse::<u64>().ok()?),
+                "sha-256" => sha256 = Some(from_hex(value).filter(|digest| digest.len() == 32)?),
+                _ => {}
+            }
+        }
+        let (block_size, length) = (block_size?, length?);
+        if !(MIN_BLOCK_SIZE..=MAX_BLOCK_SIZE).contains(&block_size) {
+            return None;
+        }
+        let mut blocks = Vec::new();
+        for line in lines.map(str::trim).filter(|line| !line.is_empty()) {
+            let (weak, strong) = line.split_once(' ')?;
+            let weak = u32::from_str_radix(weak, 16).ok()?;
+            let strong = from_hex(strong.trim())?.try_into().ok()?;
+            blocks.push(Block { weak, strong });
+        }
+        if blocks.len() as u64 != length / block_size as u64 {
+            return None;
+        }
+        Some(Self {
+            block_size,
+            length,
+            sha256,
+            blocks,
+        })
+    }
+
+    /// Scans the base for the full blocks of the new version.
+    ///
+    /// # Returns
+    ///
+    /// For every full block, the offset of a copy of it in the base, if one
+    /// was found.
+    pub fn scan<R: Read>(&self, mut base: R) -> io::Result<Vec<Option<u64>>> {
+        let n = self.block_size;
+        let mut found = vec![None; self.blocks.len()];
+        let mut index: HashMap<u32, Vec<usize>> = HashMap::new();
+        for (i, block) in self.blocks.iter().enumerate() {
+            index.entry(block.weak).or_default().push(i);
+        }
+        let mut missing = found.len();
+        // Bytes of the base from `offset`, the window starts at `start`
+        let mut buf = Vec::new();
+        let (mut offset, mut start) = (0u64, 0usize);
+        let mut eof = false;
+        let mut rolling: Option<Rolling> = None;
+        while missing > 0 {
+            // The window and the byte rolled into it next are kept
+            while !eof && buf.len() - start <= n {
+                if start >= READ_SIZE {
+                    buf.drain(..start);
+                    offset += start as u64;
+                    start = 0;
+                }
+                let len = buf.len();
+                buf.resize(len + READ_SIZE, 0);
+                let read = base.read(&mut buf[len..])?;
+                buf.truncate(len + read);
+                eof = read == 0;
+            }
+            if buf.len() - start < n {
+                break;
+            }
+            let window = &buf[start..start + n];
+            let sum = rolling.unwrap_or_else(|| Rolling::new(window));
+            let mut matched = false;
+            if let Some(candidates) = index.get(&sum.digest()) {
+                if candidates.iter().any(|&i| found[i].is_none()) {
+                    let mut md5 = Md5::new();
+                    md5.update(window);
+                    let strong = md5.finish();
+                    for &i in candidates {
+                        if found[i].is_none() && self.blocks[i].strong == strong {
+                            found[i] = Some(offset + start as u64);
+                            missing -= 1;
+                            matched = true;
+                        }
+                    }
+                }
+            }
+            if matched {
+                start += n;
+                rolling = None;
+            } else if start + n < buf.len() {
+                let mut sum = sum;
+                sum.roll(buf[start], buf[start + n], n);
+                start += 1;
+                rolling = Some(sum);
+            } else {
+                break;
+            }
+        }
+        Ok(found)
+    }
+
+    /// Returns how the new version is assembled from the blocks `found` in
+    /// the base by `scan`.
+    pub fn assemble(&self, found: &[Option<u64>]) -> Assembly {
+        let n = self.block_size as u64;
+        let mut assembly = Assembly {
+            copies: Vec::new(),
+            missing: Vec::new(),
+        };
+        for (i, base) in found.iter().enumerate() {
+            let at = i as u64 * n;
+            match base {
+                Some(base) => match assembly.copies.last_mut() {
+                    Some(copy) if copy.0 + copy.2 == *base && copy.1 + copy.2 == at => copy.2 += n,
+                    _ => assembly.copies.push((*base, at, n)),
+                },
+                None => assembly.add_missing(at, at + n - 1),
+            }
+        }
+        let tail = found.len() as u64 * n;
+        if tail < self.length {
+            assembly.add_missing(tail, self.length - 1);
+        }
+        assembly
+    }
+}
+
+/// Copies and fetches that make the new version of a file.
+pub struct Assembly {
+    /// Runs copied from the base, as offset in the base, offset in the new
+    /// version and length
+    pub copies: Vec<(u64, u64, u64)>,
+    /// Byte ranges fetched, as offsets of their first and last byte
+    pub missing: Vec<(u64, u64)>,
+}
+
+impl Assembly {
+    /// Returns the bytes copied from the base.
+    pub fn matched(&self) -> u64 {
+        self.copies.iter().map(|copy| copy.2).sum()
+    }
+
+    fn add_missing(&mut self, start: u64, end: u64) {
+        match self.missing.last_mut() {
+            Some(range) if range.1 + 1 == start => range.1 = end,
+            _ => self.missing.push((start, end)),
+        }
+    }
+}
+
+/// Weak checksum of a window, rolled a byte at a time.
+#[derive(Clone, Copy)]
+struct Rolling {
+    a: u32,
+    b: u32,
+}
+
+impl Rolling {
+    fn new(window: &[u8]) -> Self {
+        let n = window.len() as u32;
+        let (mut a, mut b) = (0u32, 0u32);
+        for (i, &x) in window.iter().enumerate() {
+            a = a.wrapping_add(x as u32);
+            b = b.wrapping_add((n - i as u32).wrapping_mul(x as u32));
+        }
+        Self { a, b }
+    }
+
+    /// Moves a window of `n` bytes one byte forward, `out` leaving it and
+    /// `new` entering it.
+    fn roll(&mut self, out: u8, new: u8, n: usize) {
+        self.a = self.a.wrapping_sub(out as u32).wrapping_add(new as u32);
+        self.b = self
+            .b
+            .wrapping_sub((n as u32).wrapping_mul(out as u32))
+            .wrapping_add(self.a);
+    }
+
+    fn digest(&self) -> u32 {
+        (self.b & 0xffff) << 16 | (self.a & 0xffff)
+    }
+}
+
+/// Returns the weak checksum of a block, as the manifest holds it.
+pub fn weak_checksum(block: &[u8]) -> u32 {
+    Rolling::new(block).digest()
+}
+
+fn from_hex(hex: &str) -> Option<Vec<u8>> {
+    if hex.len() % 2 != 0 || !hex.is_ascii() {
+        return None;
+    }
+    (0..hex.len())
+        .step_by(2)
+        .map(|i| u8::from_str_radix(&hex[i..i + 2], 16).ok())
+        .collect()
+}
+
+#[cfg(test)]
+mod ut_delta {
+    include!("../tests/ut/ut_delta.rs");
+}
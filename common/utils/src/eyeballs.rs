@@ -0,0 +1,183 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Address families the hosts are reached over, after RFC 8305.
+//!
+//! The HTTP clients try the addresses of a host one after another, each up
+//! to the connect timeout. On a network with broken IPv6 the connections of
+//! a dual-stack host waited seconds for the IPv6 attempts to fail.
+//! [`Families`] orders the addresses of a host for these attempts: the
+//! family that answered first the last time leads, and the families
+//! alternate after it. For a host without a known family the first
+//! addresses of both families are raced, the next attempt starting
+//! `CONNECTION_ATTEMPT_DELAY` after the previous one or as soon as it fails,
+//! and the family of the first connection is kept for `FAMILY_TTL`. The
+//! connections of the race are closed, the clients open their own.
+
+use std::collections::HashMap;
+use std::net::{SocketAddr, TcpStream};
+use std::sync::{mpsc, Mutex};
+use std::thread;
+use std::time::{Duration, Instant};
+
+/// Delay before the next attempt of a race starts, the one of RFC 8305.
+const CONNECTION_ATTEMPT_DELAY: Duration = Duration::from_millis(250);
+
+/// Time a race waits for a connection in total.
+const RACE_TIMEOUT: Duration = Duration::from_secs(2);
+
+/// Most addresses raced.
+const RACE_ATTEMPTS: usize = 4;
+
+/// Time in milliseconds the family of a host is kept for.
+const FAMILY_TTL: u64 = 10 * 60 * 1000;
+
+/// Family of a host and the time it expires at in milliseconds.
+struct Family {
+    ipv6: bool,
+    expires: u64,
+}
+
+/// Families the hosts answered over first, keyed by authority.
+pub struct Families {
+    families: Mutex<HashMap<String, Family>>,
+}
+
+impl Families {
+    /// Creates an empty set of families.
+    pub fn new() -> Self {
+        Self {
+            families: Mutex::new(HashMap::new()),
+        }
+    }
+
+    /// Returns the family `authority` answered over, if known at `now` in
+    /// milliseconds.
+    fn get(&self, authority: &str, now: u64) -> Option<bool> {
+        let mut families = self.families.lock().unwrap();
+        match families.get(authority) {
+            Some(family) if family.expires > now => Some(family.ipv6),
+            Some(_) => {
+                families.remove(authority);
+                None
+            }
+            None => None,
+        }
+    }
+
+    /// Orders the resolved `addrs` of `authority` for connection attempts
+    /// at `now`, in milliseconds, racing them if the family of the host is
+    /// not known.
+    ///
+    /// # Examples
+    ///
+    /// ```rust
+    /// use std::net::SocketAddr;
+    ///
+    /// use request_utils::eyeballs::Families;
+    ///
+    /// let families = Families::new();
+    /// let addr: SocketAddr = "127.0.0.1:80".parse().unwrap();
+    /// assert_eq!(families.order("a.com:80", vec![addr], 0), vec![addr]);
+    /// ```
+    pub fn order(&self, authority: &str, addrs: Vec<SocketAddr>, now: u64) -> Vec<SocketAddr> {
+        let dual_stack =
+            addrs.iter().any(SocketAddr::is_ipv6) && addrs.iter().any(SocketAddr::is_ipv4);
+        if !dual_stack {
+            return addrs;
+        }
+        if let Some(ipv6) = self.get(authority, now) {
+            return interleave(addrs, ipv6);
+        }
+        let addrs = interleave(addrs, true);
+        let attempts = &addrs[..addrs.len().min(RACE_ATTEMPTS)];
+        let Some(winner) = race(attempts, CONNECTION_ATTEMPT_DELAY, RACE_TIMEOUT) else {
+            return addrs;
+        };
+        let family = Family {
+            ipv6: winner.is_ipv6(),
+            expires: now.saturating_add(FAMILY_TTL),
+        };
+        self.families
+            .lock()
+            .unwrap()
+            .insert(authority.to_string(), family);
+        let mut addrs = addrs;
+        addrs.retain(|addr| *addr != winner);
+        addrs.insert(0, winner);
+        interleave(addrs, winner.is_ipv6())
+    }
+
+    /// Forgets the families, called when the network changes.
+    pub fn clear(&self) {
+        self.families.lock().unwrap().clear();
+    }
+}
+
+/// Alternates the families of `addrs`, keeping the order within each, the
+/// first address being of IPv6 if `ipv6_first` is set.
+pub fn interleave(addrs: Vec<SocketAddr>, ipv6_first: bool) -> Vec<SocketAddr> {
+    let (first, second): (Vec<_>, Vec<_>) = addrs
+        .into_iter()
+        .partition(|addr| addr.is_ipv6() == ipv6_first);
+    let mut first = first.into_iter();
+    let mut second = second.into_iter();
+    let mut interleaved = Vec::with_capacity(first.len() + second.len());
+    loop {
+        match (first.next(), second.next()) {
+            (None, None) => return interleaved,
+            (a, b) => interleaved.extend(a.into_iter().chain(b)),
+        }
+    }
+}
+
+/// Connects to `addrs` in turn, starting each attempt `stagger` after the
+/// previous one or as soon as it failed, and returns the first address that
+/// answered within `timeout`.
+pub fn race(addrs: &[SocketAddr], stagger: Duration, timeout: Duration) -> Option<SocketAddr> {
+    let deadline = Instant::now() + timeout;
+    let (tx, rx) = mpsc::channel();
+    let mut pending = 0;
+    for addr in addrs.iter().copied() {
+        let tx = tx.clone();
+        thread::spawn(move || {
+            let connected = TcpStream::connect_timeout(&addr, timeout).is_ok();
+            let _ = tx.send((addr, connected));
+        });
+        pending += 1;
+        let next = Instant::now() + stagger;
+        while pending > 0 {
+            match rx.recv_timeout(next.saturating_duration_since(Instant::now())) {
+                Ok((addr, true)) => return Some(addr),
+                Ok((_, false)) => {
+                    pending -= 1;
+                    break;
+                }
+                Err(_) => break,
+            }
+        }
+    }
+    while pending > 0 {
+        match rx.recv_timeout(deadline.saturating_duration_since(Instant::now())) {
+            Ok((addr, true)) => return Some(addr),
+            Ok((_, false)) => pending -= 1,
+            Err(_) => return None,
+        }
+    }
+    None
+}
+
+#[cfg(test)]
+mod ut_eyeballs {
+    include!("../tests/ut/ut_eyeballs.rs");
+}
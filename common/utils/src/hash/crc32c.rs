@@ -0,0 +1,156 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! CRC-32C (Castagnoli) checksums of stored data.
+//!
+//! The CRC instructions of ARMv8 and SSE4.2 compute 8 bytes per instruction,
+//! several gigabytes per second, so checksumming a file costs little next to
+//! reading it. The instructions are detected once at runtime, without them a
+//! table computes a byte at a time.
+
+use std::sync::OnceLock;
+
+/// Reversed Castagnoli polynomial.
+const POLY: u32 = 0x82f6_3b78;
+
+/// CRC of every byte, for the computation without the instructions.
+const TABLE: [u32; 256] = table();
+
+const fn table() -> [u32; 256] {
+    let mut table = [0u32; 256];
+    let mut i = 0;
+    while i < 256 {
+        let mut crc = i as u32;
+        let mut bit = 0;
+        while bit < 8 {
+            crc = if crc & 1 == 1 {
+                (crc >> 1) ^ POLY
+            } else {
+                crc >> 1
+            };
+            bit += 1;
+        }
+        table[i] = crc;
+        i += 1;
+    }
+    table
+}
+
+/// Updates the inverted `crc` with `bytes`, a byte at a time.
+fn update_table(crc: u32, bytes: &[u8]) -> u32 {
+    bytes.iter().fold(crc, |crc, b| {
+        TABLE[((crc ^ *b as u32) & 0xff) as usize] ^ (crc >> 8)
+    })
+}
+
+#[cfg(target_arch = "aarch64")]
+#[target_feature(enable = "crc")]
+unsafe fn update_hw(mut crc: u32, bytes: &[u8]) -> u32 {
+    use std::arch::aarch64::{__crc32cb, __crc32cd};
+
+    let mut words = bytes.chunks_exact(8);
+    for word in &mut words {
+        crc = __crc32cd(crc, u64::from_le_bytes(word.try_into().unwrap_or_default()));
+    }
+    for b in words.remainder() {
+        crc = __crc32cb(crc, *b);
+    }
+    crc
+}
+
+#[cfg(target_arch = "x86_64")]
+#[target_feature(enable = "sse4.2")]
+unsafe fn update_hw(crc: u32, bytes: &[u8]) -> u32 {
+    use std::arch::x86_64::{_mm_crc32_u64, _mm_crc32_u8};
+
+    let mut crc = crc as u64;
+    let mut words = bytes.chunks_exact(8);
+    for word in &mut words {
+        crc = _mm_crc32_u64(crc, u64::from_le_bytes(word.try_into().unwrap_or_default()));
+    }
+    let mut crc = crc as u32;
+    for b in words.remainder() {
+        crc = _mm_crc32_u8(crc, *b);
+    }
+    crc
+}
+
+/// Returns whether the CPU has the CRC-32C instructions, detected once.
+fn has_hw() -> bool {
+    static HW: OnceLock<bool> = OnceLock::new();
+    *HW.get_or_init(|| {
+        #[cfg(target_arch = "aarch64")]
+        return std::arch::is_aarch64_feature_detected!("crc");
+        #[cfg(target_arch = "x86_64")]
+        return std::arch::is_x86_feature_detected!("sse4.2");
+        #[allow(unreachable_code)]
+        false
+    })
+}
+
+/// Updates the inverted `crc` with `bytes`.
+fn update(crc: u32, bytes: &[u8]) -> u32 {
+    #[cfg(any(target_arch = "aarch64", target_arch = "x86_64"))]
+    if has_hw() {
+        // SAFETY: The instructions of `update_hw` were detected.
+        return unsafe { update_hw(crc, bytes) };
+    }
+    update_table(crc, bytes)
+}
+
+/// CRC-32C of data given in parts.
+///
+/// # Examples
+///
+/// ```rust
+/// use request_utils::hash::{crc32c, Crc32c};
+///
+/// let mut crc = Crc32c::new();
+/// crc.update(b"1234");
+/// crc.update(b"56789");
+/// assert_eq!(crc.finish(), crc32c(b"123456789"));
+/// ```
+#[derive(Clone, Copy)]
+pub struct Crc32c {
+    /// Inverted CRC of the parts so far
+    state: u32,
+}
+
+impl Crc32c {
+    /// Creates the CRC of no data.
+    pub fn new() -> Self {
+        Self { state: !0 }
+    }
+
+    /// Adds `bytes` to the data.
+    pub fn update(&mut self, bytes: &[u8]) {
+        self.state = update(self.state, bytes);
+    }
+
+    /// Returns the CRC of the data so far.
+    pub fn finish(&self) -> u32 {
+        !self.state
+    }
+}
+
+/// Returns the CRC-32C of `bytes`.
+pub fn crc32c(bytes: &[u8]) -> u32 {
+    let mut crc = Crc32c::new();
+    crc.update(bytes);
+    crc.finish()
+}
+
+#[cfg(test)]
+mod ut_crc32c {
+    include!("../../tests/ut/hash/ut_crc32c.rs");
+}
@@ -0,0 +1,265 @@
+// Copyright (C) 2024 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Incremental SHA-256 and MD5 digests.
+//!
+//! Both digests take their input in pieces of any size, so a body can be
+//! hashed while it is received instead of being read again afterwards. Bytes
+//! are buffered until a whole 64-byte block is available.
+
+const BLOCK_SIZE: usize = 64;
+
+/// Block buffer and length shared by both digests.
+struct Blocks {
+    buf: [u8; BLOCK_SIZE],
+    filled: usize,
+    /// Total number of bytes hashed
+    len: u64,
+}
+
+impl Blocks {
+    fn new() -> Self {
+        Self {
+            buf: [0; BLOCK_SIZE],
+            filled: 0,
+            len: 0,
+        }
+    }
+
+    /// Passes every complete block of `buf` followed by `data` to `compress`.
+    fn update(&mut self, mut data: &[u8], mut compress: impl FnMut(&[u8; BLOCK_SIZE])) {
+        self.len = self.len.wrapping_add(data.len() as u64);
+        if self.filled > 0 {
+            let n = (BLOCK_SIZE - self.filled).min(data.len());
+            self.buf[self.filled..self.filled + n].copy_from_slice(&data[..n]);
+            self.filled += n;
+            data = &data[n..];
+            if self.filled < BLOCK_SIZE {
+                return;
+            }
+            compress(&self.buf);
+            self.filled = 0;
+        }
+        let mut blocks = data.chunks_exact(BLOCK_SIZE);
+        for block in &mut blocks {
+            compress(block.try_into().unwrap());
+        }
+        let rest = blocks.remainder();
+        self.buf[..rest.len()].copy_from_slice(rest);
+        self.filled = rest.len();
+    }
+
+    /// Pads the input with a one bit, zeros and the bit length.
+    fn finish(&mut self, len: [u8; 8], mut compress: impl FnMut(&[u8; BLOCK_SIZE])) {
+        self.buf[self.filled] = 0x80;
+        self.buf[self.filled + 1..].fill(0);
+        if self.filled + 1 > BLOCK_SIZE - 8 {
+            compress(&self.buf);
+            self.buf.fill(0);
+        }
+        self.buf[BLOCK_SIZE - 8..].copy_from_slice(&len);
+        compress(&self.buf);
+    }
+}
+
+const SHA256_K: [u32; 64] = [
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+];
+
+const SHA256_INIT: [u32; 8] = [
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+];
+
+/// Incremental SHA-256 digest.
+///
+/// # Examples
+///
+/// ```rust
+/// use request_utils::hash::Sha256;
+///
+/// let mut digest = Sha256::new();
+/// digest.update(b"a");
+/// digest.update(b"bc");
+/// let mut whole = Sha256::new();
+/// whole.update(b"abc");
+/// assert_eq!(digest.finish(), whole.finish());
+/// ```
+pub struct Sha256 {
+    state: [u32; 8],
+    blocks: Blocks,
+}
+
+impl Sha256 {
+    /// Creates a digest of no input.
+    pub fn new() -> Self {
+        Self {
+            state: SHA256_INIT,
+            blocks: Blocks::new(),
+        }
+    }
+
+    /// Adds `data` to the hashed input.
+    pub fn update(&mut self, data: &[u8]) {
+        let state = &mut self.state;
+        self.blocks.update(data, |block| sha256_compress(state, block));
+    }
+
+    /// Returns the digest of the input.
+    pub fn finish(mut self) -> [u8; 32] {
+        let len = self.blocks.len.wrapping_mul(8).to_be_bytes();
+        let state = &mut self.state;
+        self.blocks.finish(len, |block| sha256_compress(state, block));
+        let mut out = [0u8; 32];
+        for (chunk, word) in out.chunks_exact_mut(4).zip(self.state) {
+            chunk.copy_from_slice(&word.to_be_bytes());
+        }
+        out
+    }
+}
+
+impl Default for Sha256 {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+fn sha256_compress(state: &mut [u32; 8], block: &[u8; BLOCK_SIZE]) {
+    let mut w = [0u32; 64];
+    for (word, chunk) in w.iter_mut().zip(block.chunks_exact(4)) {
+        *word = u32::from_be_bytes(chunk.try_into().unwrap());
+    }
+    for i in 16..64 {
+        let s0 = w[i - 15].rotate_right(7) ^ w[i - 15].rotate_right(18) ^ (w[i - 15] >> 3);
+        let s1 = w[i - 2].rotate_right(17) ^ w[i - 2].rotate_right(19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16]
+            .wrapping_add(s0)
+            .wrapping_add(w[i - 7])
+            .wrapping_add(s1);
+    }
+    let [mut a, mut b, mut c, mut d, mut e, mut f, mut g, mut h] = *state;
+    for (k, w) in SHA256_K.iter().zip(w) {
+        let s1 = e.rotate_right(6) ^ e.rotate_right(11) ^ e.rotate_right(25);
+        let ch = (e & f) ^ (!e & g);
+        let t1 = h
+            .wrapping_add(s1)
+            .wrapping_add(ch)
+            .wrapping_add(*k)
+            .wrapping_add(w);
+        let s0 = a.rotate_right(2) ^ a.rotate_right(13) ^ a.rotate_right(22);
+        let maj = (a & b) ^ (a & c) ^ (b & c);
+        let t2 = s0.wrapping_add(maj);
+        h = g;
+        g = f;
+        f = e;
+        e = d.wrapping_add(t1);
+        d = c;
+        c = b;
+        b = a;
+        a = t1.wrapping_add(t2);
+    }
+    for (word, value) in state.iter_mut().zip([a, b, c, d, e, f, g, h]) {
+        *word = word.wrapping_add(value);
+    }
+}
+
+const MD5_SHIFTS: [u32; 16] = [7, 12, 17, 22, 5, 9, 14, 20, 4, 11, 16, 23, 6, 10, 15, 21];
+
+const MD5_K: [u32; 64] = [
+    0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+    0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+    0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+    0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+    0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+    0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+    0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+    0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391,
+];
+
+const MD5_INIT: [u32; 4] = [0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476];
+
+/// Incremental MD5 digest, only meant to match checksums published by servers.
+pub struct Md5 {
+    state: [u32; 4],
+    blocks: Blocks,
+}
+
+impl Md5 {
+    /// Creates a digest of no input.
+    pub fn new() -> Self {
+        Self {
+            state: MD5_INIT,
+            blocks: Blocks::new(),
+        }
+    }
+
+    /// Adds `data` to the hashed input.
+    pub fn update(&mut self, data: &[u8]) {
+        let state = &mut self.state;
+        self.blocks.update(data, |block| md5_compress(state, block));
+    }
+
+    /// Returns the digest of the input.
+    pub fn finish(mut self) -> [u8; 16] {
+        let len = self.blocks.len.wrapping_mul(8).to_le_bytes();
+        let state = &mut self.state;
+        self.blocks.finish(len, |block| md5_compress(state, block));
+        let mut out = [0u8; 16];
+        for (chunk, word) in out.chunks_exact_mut(4).zip(self.state) {
+            chunk.copy_from_slice(&word.to_le_bytes());
+        }
+        out
+    }
+}
+
+impl Default for Md5 {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+fn md5_compress(state: &mut [u32; 4], block: &[u8; BLOCK_SIZE]) {
+    let mut m = [0u32; 16];
+    for (word, chunk) in m.iter_mut().zip(block.chunks_exact(4)) {
+        *word = u32::from_le_bytes(chunk.try_into().unwrap());
+    }
+    let [mut a, mut b, mut c, mut d] = *state;
+    for i in 0..64 {
+        let (f, g) = match i / 16 {
+            0 => ((b & c) | (!b & d), i),
+            1 => ((d & b) | (!d & c), (5 * i + 1) % 16),
+            2 => (b ^ c ^ d, (3 * i + 5) % 16),
+            _ => (c ^ (b | !d), (7 * i) % 16),
+        };
+        let shift = MD5_SHIFTS[(i / 16) * 4 + i % 4];
+        let f = f.wrapping_add(a).wrapping_add(MD5_K[i]).wrapping_add(m[g]);
+        a = d;
+        d = c;
+        c = b;
+        b = b.wrapping_add(f.rotate_left(shift));
+    }
+    for (word, value) in state.iter_mut().zip([a, b, c, d]) {
+        *word = word.wrapping_add(value);
+    }
+}
+
+#[cfg(test)]
+mod ut_digest {
+    include!("../../tests/ut/hash/ut_digest.rs");
+}
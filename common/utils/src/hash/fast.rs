@@ -0,0 +1,72 @@
+// Copyright (C) 2024 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Fast 128-bit non-cryptographic hash for in-memory keys.
+//!
+//! The input is consumed 16 bytes at a time, each block is mixed with a
+//! 64x64->128 bit multiplication into two lanes. It is not collision resistant
+//! against crafted inputs, so callers that must not confuse two inputs compare
+//! the inputs as well.
+
+const P0: u64 = 0xa076_1d64_78bd_642f;
+const P1: u64 = 0xe703_7ed1_a0b4_28db;
+const P2: u64 = 0x8ebc_6af0_9c88_c6e3;
+const P3: u64 = 0x5899_65cc_7537_4cc3;
+
+/// Multiplies two words and folds the 128-bit product into 64 bits.
+#[inline]
+fn mix(a: u64, b: u64) -> u64 {
+    let product = (a as u128).wrapping_mul(b as u128);
+    (product as u64) ^ ((product >> 64) as u64)
+}
+
+/// Returns a 128-bit hash of `bytes`.
+///
+/// # Examples
+///
+/// ```rust
+/// use request_utils::hash::hash128;
+///
+/// assert_eq!(hash128(b"https://example.com"), hash128(b"https://example.com"));
+/// assert_ne!(hash128(b"https://example.com"), hash128(b"https://example.org"));
+/// ```
+pub fn hash128(bytes: &[u8]) -> [u8; 16] {
+    let len = bytes.len() as u64;
+    let mut lo = P0 ^ len;
+    let mut hi = P1.wrapping_add(len);
+
+    let mut blocks = bytes.chunks_exact(16);
+    let mut round = |block: &[u8]| {
+        let a = u64::from_le_bytes(block[..8].try_into().unwrap_or_default());
+        let b = u64::from_le_bytes(block[8..16].try_into().unwrap_or_default());
+        lo = lo.rotate_left(29).wrapping_add(mix(a ^ P2, b ^ P3));
+        hi = hi.rotate_left(37) ^ mix(b ^ P0, a ^ P1);
+    };
+    for block in &mut blocks {
+        round(block);
+    }
+    let rest = blocks.remainder();
+    if !rest.is_empty() {
+        // The length is already mixed in, zero padding is unambiguous
+        let mut block = [0u8; 16];
+        block[..rest.len()].copy_from_slice(rest);
+        round(&block);
+    }
+
+    let lo = mix(lo ^ P0, hi ^ P3);
+    let hi = mix(hi ^ P2, lo ^ P1);
+    let mut key = [0u8; 16];
+    key[..8].copy_from_slice(&lo.to_le_bytes());
+    key[8..].copy_from_slice(&hi.to_le_bytes());
+    key
+}
@@ -15,5 +15,11 @@ cfg_ohos! {
     mod sha256;
 }
 
+mod crc32c;
+mod digest;
+mod fast;
 mod url;
+pub use crc32c::{crc32c, Crc32c};
+pub use digest::{Md5, Sha256};
+pub use fast::hash128;
 pub use url::url_hash;
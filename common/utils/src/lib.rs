@@ -25,6 +25,18 @@
 #[macro_use]
 mod macros;
 
+/// Streaming extraction of tar and zip archives.
+pub mod archive;
+
+/// Content decoding of response bodies.
+pub mod compress;
+
+/// Blocks of a new version of a file found in an old one.
+pub mod delta;
+
+/// Address families the hosts are reached over.
+pub mod eyeballs;
+
 /// Fast pseudorandom number generation utilities.
 pub mod fastrand;
 
@@ -40,9 +52,15 @@ mod hilog;
 /// Least Recently Used (LRU) cache implementation.
 pub mod lru;
 
+/// Cache of the targets of redirects.
+pub mod redirect;
+
 /// Task ID generation and management utilities.
 pub mod task_id;
 
+/// URL parsing utilities.
+pub mod url;
+
 // Conditional compilation for non-OHOS platforms
 // Provides standard logging macros from the log crate
 cfg_not_ohos! {
@@ -13,118 +13,46 @@
 
 //! Least Recently Used (LRU) cache implementation.
 //!
-//! This module provides an efficient LRU cache implementation using a combination
-//! of a hash map for O(1) lookups and a doubly linked list for O(1) insertions and
-//! deletions from both ends.
-
-use std::collections::hash_map::Entry;
-use std::collections::HashMap;
-use std::hash::Hash;
-use std::ptr;
-
-/// A node in the doubly linked list used to track access order.
-struct Node<K, V> {
-    /// The key associated with this node.
-    key: K,
-    /// The value stored in this node.
-    value: V,
-    /// Pointer to the previous node in the list.
-    prev: *mut Node<K, V>,
-    /// Pointer to the next node in the list.
-    next: *mut Node<K, V>,
-}
-
-/// A doubly linked list used to maintain the access order of cache entries.
-struct LinkedList<K, V> {
-    /// Pointer to the head of the list (most recently used).
-    head: *mut Node<K, V>,
-    /// Pointer to the tail of the list (least recently used).
-    tail: *mut Node<K, V>,
-}
+//! Entries live in one contiguous slab and are linked in access order by
+//! `u32` indices, so an insertion allocates nothing once the slab has grown
+//! and walking the order stays within one allocation. Keys are found through
+//! an open-addressing table with linear probing, whose slots hold the slab
+//! index and the hash of their entry so probes rarely touch the slab.
 
-impl<K, V> LinkedList<K, V> {
-    /// Creates a new empty linked list.
-    fn new() -> Self {
-        LinkedList {
-            head: ptr::null_mut(),
-            tail: ptr::null_mut(),
-        }
-    }
+use std::collections::hash_map::RandomState;
+use std::hash::{BuildHasher, Hash};
+use std::mem;
 
-    /// Adds a node to the front of the list (most recently used position).
-    ///
-    /// # Safety
-    ///
-    /// Assumes the provided node pointer is valid and not null.
-    fn push_front(&mut self, node: *mut Node<K, V>) {
-        unsafe {
-            // Initialize node's pointers
-            (*node).prev = ptr::null_mut();
-            (*node).next = self.head;
+/// Index standing for no entry.
+const NIL: u32 = u32::MAX;
 
-            // Update head's previous pointer if head exists
-            if !self.head.is_null() {
-                (*self.head).prev = node;
-            }
-            // Update head to new node
-            self.head = node;
-
-            // If list was empty, set tail to new node
-            if self.tail.is_null() {
-                self.tail = node;
-            }
-        }
-    }
-
-    /// Removes a node from the list.
-    ///
-    /// # Safety
-    ///
-    /// Assumes the provided node pointer is valid, not null, and is part of this list.
-    fn remove(&mut self, node: *mut Node<K, V>) {
-        unsafe {
-            // Update previous node's next pointer or head
-            if !(*node).prev.is_null() {
-                (*(*node).prev).next = (*node).next;
-            } else {
-                self.head = (*node).next;
-            }
+/// Smallest number of slots of the table.
+const MIN_TABLE: usize = 8;
 
-            // Update next node's previous pointer or tail
-            if !(*node).next.is_null() {
-                (*(*node).next).prev = (*node).prev;
-            } else {
-                self.tail = (*node).prev;
-            }
-        }
-    }
+/// An entry of the slab, linked to its neighbours in access order.
+struct Slot<K, V> {
+    /// Key and value, `None` while the slot is free.
+    entry: Option<(K, V)>,
+    /// Hash of the key.
+    hash: u32,
+    /// Index of the more recently used entry.
+    prev: u32,
+    /// Index of the less recently used entry, or of the next free slot.
+    next: u32,
+}
 
-    /// Removes and returns the node at the back of the list (least recently used).
-    fn pop_back(&mut self) -> *mut Node<K, V> {
-        if self.tail.is_null() {
-            return ptr::null_mut();
-        }
-        let node = self.tail;
-        self.remove(node);
-        node
-    }
+/// A slot of the table: index of an entry in the slab and hash of its key.
+#[derive(Clone, Copy)]
+struct Bucket {
+    index: u32,
+    hash: u32,
 }
 
-impl<K, V> Drop for LinkedList<K, V> {
-    /// Drops the linked list and all its nodes.
-    ///
-    /// Properly deallocates all nodes in the list to prevent memory leaks.
-    fn drop(&mut self) {
-        let mut current = self.head;
-        while !current.is_null() {
-            unsafe {
-                let next = (*current).next;
-                // Convert raw pointer back to Box and drop it
-                let _ = Box::from_raw(current);
-                current = next;
-            }
-        }
-    }
+impl Bucket {
+    const EMPTY: Bucket = Bucket {
+        index: NIL,
+        hash: 0,
+    };
 }
 
 /// A Least Recently Used (LRU) cache.
@@ -159,23 +87,34 @@ impl<K, V> Drop for LinkedList<K, V> {
 /// assert!(cache.is_empty());
 /// ```
 ///
-/// # Safety
-///
-/// This implementation uses unsafe pointer operations to manage the linked list.
-/// The pointers are carefully managed to avoid dangling pointers or memory leaks.
 pub struct LRUCache<K, V> {
-    /// Map from keys to nodes for O(1) lookups.
-    map: HashMap<K, *mut Node<K, V>>,
-    /// Linked list to track access order.
-    list: LinkedList<K, V>,
+    /// Entries, used and free.
+    slots: Vec<Slot<K, V>>,
+    /// Open-addressing table of the entries, its length is a power of two.
+    table: Vec<Bucket>,
+    /// Hasher of the keys.
+    hasher: RandomState,
+    /// Most recently used entry.
+    head: u32,
+    /// Least recently used entry.
+    tail: u32,
+    /// First free slot, the others are linked through `next`.
+    free: u32,
+    /// Number of entries.
+    len: usize,
 }
 
-impl<K: Hash + Eq + Clone, V> LRUCache<K, V> {
+impl<K: Hash + Eq, V> LRUCache<K, V> {
     /// Creates a new empty LRU cache.
     pub fn new() -> Self {
         LRUCache {
-            map: HashMap::new(),
-            list: LinkedList::new(),
+            slots: Vec::new(),
+            table: Vec::new(),
+            hasher: RandomState::new(),
+            head: NIL,
+            tail: NIL,
+            free: NIL,
+            len: 0,
         }
     }
 
@@ -195,15 +134,7 @@ impl<K: Hash + Eq + Clone, V> LRUCache<K, V> {
     /// assert_eq!(cache.get(&2), None);
     /// ```
     pub fn get(&mut self, key: &K) -> Option<&V> {
-        if let Some(&node) = self.map.get(key) {
-            // Move to front (most recently used)
-            self.list.remove(node);
-            self.list.push_front(node);
-            unsafe {
-                return Some(&(*node).value);
-            }
-        }
-        None
+        self.get_mut(key).map(|value| &*value)
     }
 
     /// Returns a mutable reference to the value corresponding to the key if it exists.
@@ -225,15 +156,14 @@ impl<K: Hash + Eq + Clone, V> LRUCache<K, V> {
     /// assert_eq!(cache.get(&1), Some(&15));
     /// ```
     pub fn get_mut(&mut self, key: &K) -> Option<&mut V> {
-        if let Some(&mut node) = self.map.get_mut(key) {
-            // Move to front (most recently used)
-            self.list.remove(node);
-            self.list.push_front(node);
-            unsafe {
-                return Some(&mut (*node).value);
-            }
-        }
-        None
+        let (_, index) = self.find(self.hash(key), key)?;
+        // Move to front (most recently used)
+        self.unlink(index);
+        self.push_front(index);
+        self.slots[index as usize]
+            .entry
+            .as_mut()
+            .map(|(_, value)| value)
     }
 
     /// Inserts a key-value pair into the cache.
@@ -252,29 +182,27 @@ impl<K: Hash + Eq + Clone, V> LRUCache<K, V> {
     /// assert_eq!(cache.get(&1), Some(&"ONE"));
     /// ```
     pub fn insert(&mut self, key: K, value: V) -> Option<V> {
-        match self.map.entry(key) {
-            Entry::Occupied(addr) => {
-                // Key exists, update value and move to front
-                self.list.remove(*addr.get());
-                self.list.push_front(*addr.get());
-                unsafe {
-                    let old = std::mem::replace(&mut (*(*addr.get())).value, value);
-                    Some(old)
-                }
-            }
-            Entry::Vacant(addr) => {
-                // Key doesn't exist, create new node
-                let new_node = Box::into_raw(Box::new(Node {
-                    key: addr.key().clone(),
-                    value,
-                    prev: ptr::null_mut(),
-                    next: ptr::null_mut(),
-                }));
-                self.list.push_front(new_node);
-                addr.insert(new_node);
-                None
-            }
+        let hash = self.hash(&key);
+        if let Some((_, index)) = self.find(hash, &key) {
+            // Key exists, update value and move to front
+            self.unlink(index);
+            self.push_front(index);
+            let (_, old) = self.slots[index as usize].entry.as_mut()?;
+            return Some(mem::replace(old, value));
+        }
+        // Key doesn't exist, take a free slot and index it
+        if (self.len + 1) * 2 > self.table.len() {
+            self.grow();
         }
+        let index = self.alloc(hash, key, value);
+        let mut pos = hash as usize & (self.table.len() - 1);
+        while self.table[pos].index != NIL {
+            pos = (pos + 1) & (self.table.len() - 1);
+        }
+        self.table[pos] = Bucket { index, hash };
+        self.push_front(index);
+        self.len += 1;
+        None
     }
 
     /// Removes and returns the least recently used item.
@@ -294,18 +222,52 @@ impl<K: Hash + Eq + Clone, V> LRUCache<K, V> {
     /// assert_eq!(cache.pop(), None);
     /// ```
     pub fn pop(&mut self) -> Option<V> {
-        let old_node = self.list.pop_back();
-        if !old_node.is_null() {
-            unsafe {
-                // Remove from map and deallocate node
-                let old_key = (*old_node).key.clone();
-                self.map.remove(&old_key);
-                let node = Box::from_raw(old_node);
-                Some(node.value)
-            }
-        } else {
-            None
+        self.pop_entry().map(|(_, value)| value)
+    }
+
+    /// Removes and returns the least recently used key and its value.
+    ///
+    /// # Examples
+    ///
+    /// ```rust
+    /// use request_utils::lru::LRUCache;
+    ///
+    /// let mut cache = LRUCache::new();
+    /// cache.insert(1, "one");
+    ///
+    /// assert_eq!(cache.pop_entry(), Some((1, "one")));
+    /// assert_eq!(cache.pop_entry(), None);
+    /// ```
+    pub fn pop_entry(&mut self) -> Option<(K, V)> {
+        if self.tail == NIL {
+            return None;
         }
+        let index = self.tail;
+        let hash = self.slots[index as usize].hash;
+        let mut pos = hash as usize & (self.table.len() - 1);
+        while self.table[pos].index != index {
+            pos = (pos + 1) & (self.table.len() - 1);
+        }
+        Some(self.remove_at(pos, index))
+    }
+
+    /// Returns the least recently used key without changing the order.
+    ///
+    /// # Examples
+    ///
+    /// ```rust
+    /// use request_utils::lru::LRUCache;
+    ///
+    /// let mut cache = LRUCache::new();
+    /// cache.insert(1, "one");
+    /// cache.insert(2, "two");
+    ///
+    /// assert_eq!(cache.peek_lru(), Some(&1));
+    /// assert_eq!(cache.len(), 2);
+    /// ```
+    pub fn peek_lru(&self) -> Option<&K> {
+        let slot = self.slots.get(self.tail as usize)?;
+        slot.entry.as_ref().map(|(key, _)| key)
     }
 
     /// Removes and returns the value associated with the key if it exists.
@@ -322,15 +284,8 @@ impl<K: Hash + Eq + Clone, V> LRUCache<K, V> {
     /// assert_eq!(cache.remove(&2), None);
     /// ```
     pub fn remove(&mut self, key: &K) -> Option<V> {
-        if let Some(node) = self.map.remove(key) {
-            self.list.remove(node);
-            unsafe {
-                // Deallocate node
-                let node = Box::from_raw(node);
-                return Some(node.value);
-            }
-        }
-        None
+        let (pos, index) = self.find(self.hash(key), key)?;
+        Some(self.remove_at(pos, index).1)
     }
 
     /// Returns `true` if the cache contains the specified key.
@@ -347,7 +302,7 @@ impl<K: Hash + Eq + Clone, V> LRUCache<K, V> {
     /// assert!(!cache.contains_key(&2));
     /// ```
     pub fn contains_key(&self, k: &K) -> bool {
-        self.map.contains_key(k)
+        self.find(self.hash(k), k).is_some()
     }
 
     /// Returns `true` if the cache contains no elements.
@@ -364,7 +319,7 @@ impl<K: Hash + Eq + Clone, V> LRUCache<K, V> {
     /// assert!(!cache.is_empty());
     /// ```
     pub fn is_empty(&self) -> bool {
-        self.map.is_empty()
+        self.len == 0
     }
 
     /// Returns the number of elements in the cache.
@@ -382,10 +337,11 @@ impl<K: Hash + Eq + Clone, V> LRUCache<K, V> {
     /// assert_eq!(cache.len(), 2);
     /// ```
     pub fn len(&self) -> usize {
-        self.map.len()
+        self.len
     }
 
-    /// Returns an iterator over the keys of the cache.
+    /// Returns an iterator over the keys of the cache, from the least to the
+    /// most recently used.
     ///
     /// # Examples
     ///
@@ -400,25 +356,163 @@ impl<K: Hash + Eq + Clone, V> LRUCache<K, V> {
     /// assert_eq!(keys, vec![&1, &2]);
     /// ```
     pub fn keys(&self) -> impl Iterator<Item = &K> {
-        self.map.keys()
+        self.entries().map(|(key, _)| key)
+    }
+
+    /// Returns an iterator over the values of the cache, from the least to
+    /// the most recently used.
+    ///
+    /// The access order is not changed.
+    ///
+    /// # Examples
+    ///
+    /// ```rust
+    /// use request_utils::lru::LRUCache;
+    ///
+    /// let mut cache = LRUCache::new();
+    /// cache.insert(1, "one");
+    ///
+    /// let values: Vec<_> = cache.values().collect();
+    /// assert_eq!(values, vec![&"one"]);
+    /// ```
+    pub fn values(&self) -> impl Iterator<Item = &V> {
+        self.entries().map(|(_, value)| value)
+    }
+
+    /// Returns an iterator over the entries from the least to the most
+    /// recently used.
+    fn entries(&self) -> impl Iterator<Item = &(K, V)> {
+        let mut index = self.tail;
+        std::iter::from_fn(move || {
+            let slot = self.slots.get(index as usize)?;
+            index = slot.prev;
+            slot.entry.as_ref()
+        })
+    }
+
+    /// Hashes a key, only the low bits are kept and used by the table.
+    fn hash(&self, key: &K) -> u32 {
+        self.hasher.hash_one(key) as u32
+    }
+
+    /// Returns the table position and slab index of the entry of a key.
+    fn find(&self, hash: u32, key: &K) -> Option<(usize, u32)> {
+        if self.table.is_empty() {
+            return None;
+        }
+        let mask = self.table.len() - 1;
+        let mut pos = hash as usize & mask;
+        loop {
+            let bucket = self.table[pos];
+            if bucket.index == NIL {
+                return None;
+            }
+            if bucket.hash == hash {
+                if let Some((k, _)) = &self.slots[bucket.index as usize].entry {
+                    if k == key {
+                        return Some((pos, bucket.index));
+                    }
+                }
+            }
+            pos = (pos + 1) & mask;
+        }
+    }
+
+    /// Stores an entry in a free slot, returning its index.
+    fn alloc(&mut self, hash: u32, key: K, value: V) -> u32 {
+        let slot = Slot {
+            entry: Some((key, value)),
+            hash,
+            prev: NIL,
+            next: NIL,
+        };
+        if self.free == NIL {
+            self.slots.push(slot);
+            return (self.slots.len() - 1) as u32;
+        }
+        let index = self.free;
+        self.free = self.slots[index as usize].next;
+        self.slots[index as usize] = slot;
+        index
+    }
+
+    /// Doubles the table and indexes the entries again.
+    fn grow(&mut self) {
+        let size = (self.table.len() * 2).max(MIN_TABLE);
+        let old = mem::replace(&mut self.table, vec![Bucket::EMPTY; size]);
+        let mask = size - 1;
+        for bucket in old.into_iter().filter(|bucket| bucket.index != NIL) {
+            let mut pos = bucket.hash as usize & mask;
+            while self.table[pos].index != NIL {
+                pos = (pos + 1) & mask;
+            }
+            self.table[pos] = bucket;
+        }
+    }
+
+    /// Removes the entry at a table position and frees its slot.
+    fn remove_at(&mut self, pos: usize, index: u32) -> (K, V) {
+        // Shift the following entries of the probe sequence back into the
+        // hole, so lookups never need tombstones.
+        let mask = self.table.len() - 1;
+        let mut hole = pos;
+        let mut next = (pos + 1) & mask;
+        while self.table[next].index != NIL {
+            let home = self.table[next].hash as usize & mask;
+            if next.wrapping_sub(home) & mask >= next.wrapping_sub(hole) & mask {
+                self.table[hole] = self.table[next];
+                hole = next;
+            }
+            next = (next + 1) & mask;
+        }
+        self.table[hole] = Bucket::EMPTY;
+
+        self.unlink(index);
+        let slot = &mut self.slots[index as usize];
+        slot.next = self.free;
+        self.free = index;
+        self.len -= 1;
+        // An indexed slot always holds an entry.
+        slot.entry.take().unwrap()
+    }
+
+    /// Makes an entry the most recently used.
+    fn push_front(&mut self, index: u32) {
+        let old = self.head;
+        let slot = &mut self.slots[index as usize];
+        slot.prev = NIL;
+        slot.next = old;
+        if old != NIL {
+            self.slots[old as usize].prev = index;
+        } else {
+            self.tail = index;
+        }
+        self.head = index;
+    }
+
+    /// Takes an entry out of the access order.
+    fn unlink(&mut self, index: u32) {
+        let Slot { prev, next, .. } = self.slots[index as usize];
+        if prev != NIL {
+            self.slots[prev as usize].next = next;
+        } else {
+            self.head = next;
+        }
+        if next != NIL {
+            self.slots[next as usize].prev = prev;
+        } else {
+            self.tail = prev;
+        }
     }
 }
 
-impl<K: Eq + Hash + Clone, V> Default for LRUCache<K, V> {
+impl<K: Hash + Eq, V> Default for LRUCache<K, V> {
     /// Creates a new empty LRU cache.
     fn default() -> Self {
         Self::new()
     }
 }
 
-unsafe impl<K, V> Send for LRUCache<K, V> {
-    // Safety: The cache's internal pointers are not exposed outside the cache
-    // and are managed in a way that ensures thread safety for the Send trait.
-    // The pointers are only accessed within methods that have exclusive mutable
-    // access to the cache, and all modifications to the pointers are properly
-    // synchronized through Rust's ownership system.
-}
-
 #[cfg(test)]
 mod ut_lru {
     include!("../tests/ut/ut_lru.rs");
@@ -0,0 +1,198 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Targets of the redirects of urls.
+//!
+//! A request to a url that redirects pays one more round trip every time it
+//! is sent. [`RedirectCache`] keeps the targets of the redirects that may be
+//! stored, per source url, so that the next request goes to the target
+//! straight away:
+//!
+//! - permanent redirects, `301` and `308`, for their `max-age`, or
+//!   `DEFAULT_PERMANENT_AGE` without one;
+//! - temporary redirects, `302` and `307`, only for their `max-age`.
+//!
+//! `no-store`, `no-cache` and `private` keep a redirect out of the cache. The
+//! cache holds a bounded number of urls, the least recently used is dropped
+//! first.
+
+use std::sync::Mutex;
+
+use crate::lru::LRUCache;
+
+/// Time in milliseconds a permanent redirect without `max-age` is used for.
+const DEFAULT_PERMANENT_AGE: u64 = 24 * 60 * 60 * 1000;
+
+/// Most cached redirects followed for a url, in case they loop.
+const MAX_CHAIN: usize = 8;
+
+/// Target of a redirect and the time it expires at in milliseconds.
+struct Target {
+    url: String,
+    expires: u64,
+}
+
+/// Cached redirects, keyed by the url they redirect.
+pub struct RedirectCache {
+    targets: Mutex<LRUCache<String, Target>>,
+    capacity: usize,
+}
+
+impl RedirectCache {
+    /// Creates an empty cache of at most `capacity` redirects.
+    pub fn new(capacity: usize) -> Self {
+        Self {
+            targets: Mutex::new(LRUCache::new()),
+            capacity,
+        }
+    }
+
+    /// Returns the url a request to `url` ends at `now`, in milliseconds,
+    /// following the cached redirects of the targets too.
+    ///
+    /// # Examples
+    ///
+    /// ```rust
+    /// use request_utils::redirect::RedirectCache;
+    ///
+    /// let cache = RedirectCache::new(16);
+    /// cache.insert("http://a.com/x", 301, "https://a.com/x", None, 0);
+    /// assert_eq!(cache.get("http://a.com/x", 0).as_deref(), Some("https://a.com/x"));
+    /// ```
+    pub fn get(&self, url: &str, now: u64) -> Option<String> {
+        let mut targets = self.targets.lock().unwrap();
+        let mut target: Option<String> = None;
+        for _ in 0..MAX_CHAIN {
+            let source = target.clone().unwrap_or_else(|| url.to_string());
+            match targets.get(&source) {
+                Some(next) if next.expires > now => target = Some(next.url.clone()),
+                Some(_) => {
+                    targets.remove(&source);
+                    break;
+                }
+                None => break,
+            }
+        }
+        target
+    }
+
+    /// Records that `url` redirected at `now`, in milliseconds, with `status`
+    /// and the `Location` and `Cache-Control` headers of the response.
+    ///
+    /// # Returns
+    ///
+    /// The absolute url of the target, cached or not, or `None` if the
+    /// location is empty or `url` is not absolute.
+    pub fn insert(
+        &self,
+        url: &str,
+        status: u16,
+        location: &str,
+        cache_control: Option<&str>,
+        now: u64,
+    ) -> Option<String> {
+        let target = resolve(url, location)?;
+        if let Some(age) = cache_age(status, cache_control.unwrap_or_default()) {
+            if age > 0 && target != url {
+                let entry = Target {
+                    url: target.clone(),
+                    expires: now.saturating_add(age),
+                };
+                let mut targets = self.targets.lock().unwrap();
+                targets.insert(url.to_string(), entry);
+                while targets.len() > self.capacity {
+                    targets.pop();
+                }
+            }
+        }
+        Some(target)
+    }
+
+    /// Forgets the redirect of `url`, whose target failed.
+    pub fn remove(&self, url: &str) {
+        self.targets.lock().unwrap().remove(&url.to_string());
+    }
+}
+
+/// Returns the milliseconds a redirect with `status` and `cache_control` may
+/// be used for, `None` if it may not be cached.
+fn cache_age(status: u16, cache_control: &str) -> Option<u64> {
+    let mut max_age = None;
+    for directive in cache_control.split(',') {
+        let (name, value) = directive.split_once('=').unwrap_or((directive, ""));
+        let name = name.trim();
+        if ["no-store", "no-cache", "private"]
+            .iter()
+            .any(|directive| name.eq_ignore_ascii_case(directive))
+        {
+            return None;
+        }
+        if name.eq_ignore_ascii_case("max-age") {
+            let age = value.trim().trim_matches('"').parse::<u64>().ok()?;
+            max_age = Some(age.saturating_mul(1000));
+        }
+    }
+    match status {
+        301 | 308 => Some(max_age.unwrap_or(DEFAULT_PERMANENT_AGE)),
+        302 | 307 => max_age,
+        _ => None,
+    }
+}
+
+/// Returns the absolute url of `location` relative to `base`.
+///
+/// Dot segments of a relative path are kept as they are, the server resolves
+/// them.
+pub fn resolve(base: &str, location: &str) -> Option<String> {
+    let location = location.trim();
+    if location.is_empty() {
+        return None;
+    }
+    if let Some(colon) = location.find("://") {
+        let scheme = &location[..colon];
+        if !scheme.is_empty()
+            && scheme
+                .chars()
+                .all(|c| c.is_ascii_alphanumeric() || matches!(c, '+' | '-' | '.'))
+        {
+            return Some(location.to_string());
+        }
+    }
+    let (scheme, rest) = base.split_once("://")?;
+    if let Some(location) = location.strip_prefix("//") {
+        return Some(format!("{}://{}", scheme, location));
+    }
+    let authority_end = rest.find(['/', '?', '#']).unwrap_or(rest.len());
+    let origin = &base[..scheme.len() + 3 + authority_end];
+    let rest = &rest[authority_end..];
+    let path = &rest[..rest.find(['?', '#']).unwrap_or(rest.len())];
+    let target = match location.as_bytes()[0] {
+        b'/' => format!("{}{}", origin, location),
+        b'?' => format!("{}{}{}", origin, path, location),
+        b'#' => {
+            let query_end = rest.find('#').unwrap_or(rest.len());
+            format!("{}{}{}", origin, &rest[..query_end], location)
+        }
+        _ => {
+            let dir = &path[..path.rfind('/').map_or(0, |slash| slash + 1)];
+            let dir = if dir.is_empty() { "/" } else { dir };
+            format!("{}{}{}", origin, dir, location)
+        }
+    };
+    Some(target)
+}
+
+#[cfg(test)]
+mod ut_redirect {
+    include!("../tests/ut/ut_redirect.rs");
+}
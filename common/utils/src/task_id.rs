@@ -16,10 +16,24 @@
 //! This module provides types for uniquely identifying tasks within the request system,
 //! with functionality for creating IDs from hash strings or URLs and displaying them
 //! in full or abbreviated form.
+//!
+//! The hash string names the files of a task, so it stays the SHA-256 of the URL.
+//! In-memory maps compare and hash a 128-bit key of it instead, and the hash
+//! string of recently seen URLs is remembered so lookups do not recompute it.
 
 use std::fmt::Display;
+use std::hash::{Hash, Hasher};
+use std::sync::{Arc, LazyLock, Mutex};
 
-use crate::hash::url_hash;
+use crate::hash::{hash128, url_hash};
+use crate::lru::LRUCache;
+
+/// Number of URLs whose task IDs are remembered.
+const URL_CACHE_SIZE: usize = 1024;
+
+/// Task IDs of recently seen URLs, by the 128-bit key of the URL.
+static URL_IDS: LazyLock<Mutex<LRUCache<[u8; 16], (Box<str>, TaskId)>>> =
+    LazyLock::new(|| Mutex::new(LRUCache::new()));
 
 /// A unique identifier for tasks.
 ///
@@ -43,10 +57,12 @@ use crate::hash::url_hash;
 /// // Display full ID
 /// println!("Full ID: {}", task_id);
 /// ```
-#[derive(Hash, PartialEq, Eq, Clone)]
+#[derive(Clone)]
 pub struct TaskId {
+    /// 128-bit key of `hash`, compared and hashed before `hash` itself.
+    key: [u8; 16],
     /// The hash string that uniquely identifies the task.
-    hash: String,
+    hash: Arc<str>,
 }
 
 impl TaskId {
@@ -70,12 +86,16 @@ impl TaskId {
     /// assert_eq!(task_id.to_string(), "deadbeef1234567890abcdef01234567");
     /// ```
     pub fn new(hash: String) -> Self {
-        Self { hash }
+        Self {
+            key: hash128(hash.as_bytes()),
+            hash: hash.into(),
+        }
     }
 
     /// Creates a new task ID by hashing a URL.
     ///
-    /// Uses the `url_hash` function to generate a hash from the provided URL string.
+    /// Uses the `url_hash` function to generate a hash from the provided URL string,
+    /// the hash of a recently seen URL is reused instead of being computed again.
     ///
     /// # Parameters
     ///
@@ -96,9 +116,38 @@ impl TaskId {
     /// assert_eq!(task_id, same_id);
     /// ```
     pub fn from_url(url: &str) -> Self {
-        Self {
-            hash: url_hash(url),
+        let url_key = hash128(url.as_bytes());
+        if let Some((cached, task_id)) = URL_IDS.lock().unwrap().get(&url_key) {
+            // The key is not collision resistant, the URL itself must match
+            if **cached == *url {
+                return task_id.clone();
+            }
+        }
+
+        let task_id = Self::new(url_hash(url));
+        let mut ids = URL_IDS.lock().unwrap();
+        ids.insert(url_key, (url.into(), task_id.clone()));
+        if ids.len() > URL_CACHE_SIZE {
+            ids.pop();
         }
+        task_id
+    }
+
+    /// Returns the 128-bit key of the task ID.
+    ///
+    /// Equal task IDs have equal keys. Distinct task IDs almost always have
+    /// distinct keys, but the key is not collision resistant.
+    ///
+    /// # Examples
+    ///
+    /// ```rust
+    /// use request_utils::task_id::TaskId;
+    ///
+    /// let task_id = TaskId::new("0123456789abcdef".to_string());
+    /// assert_eq!(task_id.key(), TaskId::new("0123456789abcdef".to_string()).key());
+    /// ```
+    pub fn key(&self) -> [u8; 16] {
+        self.key
     }
 
     /// Returns a shortened version of the task ID.
@@ -122,7 +171,22 @@ impl TaskId {
     pub fn brief(&self) -> &str {
         let len = self.hash.len();
         // Return the first quarter of the hash for display purposes
-        &self.hash.as_str()[..len / 4]
+        &self.hash[..len / 4]
+    }
+}
+
+impl PartialEq for TaskId {
+    fn eq(&self, other: &Self) -> bool {
+        self.key == other.key && (Arc::ptr_eq(&self.hash, &other.hash) || self.hash == other.hash)
+    }
+}
+
+impl Eq for TaskId {}
+
+impl Hash for TaskId {
+    /// Hashes the 128-bit key only, equal task IDs have equal keys.
+    fn hash<H: Hasher>(&self, state: &mut H) {
+        self.key.hash(state);
     }
 }
 
@@ -13,3 +13,4 @@
 
 pub mod log;
 pub mod server;
+pub mod shaping;
@@ -0,0 +1,272 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Network conditions of the test servers.
+//!
+//! The test servers answer over the loopback, at memory speed and without
+//! loss, which says nothing of a download on 3G or on a lossy Wi-Fi.
+//! [`Shaped`] wraps the writing half of a connection and sends what is
+//! written as a link of a [`NetProfile`] would. The first byte of each
+//! response waits for the time to first byte of the server and the latency
+//! of the link, with a random jitter. The bytes then leave in segments at
+//! the bandwidth of the link, and a lost segment stalls the connection for a
+//! retransmission timeout, which is how TCP recovers from it. The loopback
+//! never loses packets, so the stall emulates the loss. A profile may also
+//! drop the connection in the middle of each response.
+//!
+//! The benchmarks read their profile from `REQUEST_NET_PROFILE`, e.g.
+//! `REQUEST_NET_PROFILE=3g`, so the same benchmark runs under every profile.
+
+use std::io::{self, Write};
+use std::thread;
+use std::time::{Duration, Instant};
+
+use crate::fastrand::fast_random;
+
+/// Variable the benchmarks read the name of their profile from.
+pub const NET_PROFILE_ENV: &str = "REQUEST_NET_PROFILE";
+
+/// Most bytes sent at once, the payload of a TCP segment on Ethernet.
+const SEGMENT: usize = 1460;
+
+/// Shortest retransmission timeout, the one of Linux.
+const MIN_RTO: Duration = Duration::from_millis(200);
+
+/// Conditions of the link between a test server and its clients.
+#[derive(Clone, Copy, Debug, PartialEq)]
+pub struct NetProfile {
+    /// Name of the profile in `REQUEST_NET_PROFILE` and in the reports
+    pub name: &'static str,
+    /// Bytes per second sent, 0 for no limit
+    pub bandwidth: u64,
+    /// One-way latency, waited for before the first byte of each response
+    pub latency: Duration,
+    /// Most random time added to the latency
+    pub jitter: Duration,
+    /// Probability that a segment is lost and retransmitted
+    pub loss: f64,
+    /// Time the server takes to answer, before the first byte of each
+    /// response
+    pub ttfb: Duration,
+    /// Bytes of each response sent before the connection is dropped, `None`
+    /// to send them all
+    pub disconnect_after: Option<u64>,
+}
+
+impl NetProfile {
+    /// The loopback itself.
+    pub const LOOPBACK: NetProfile = NetProfile {
+        name: "loopback",
+        bandwidth: 0,
+        latency: Duration::ZERO,
+        jitter: Duration::ZERO,
+        loss: 0.0,
+        ttfb: Duration::ZERO,
+        disconnect_after: None,
+    };
+
+    /// A 3G cell, slow with a long and variable latency.
+    pub const CELL_3G: NetProfile = NetProfile {
+        name: "3g",
+        bandwidth: 200 * 1024,
+        latency: Duration::from_millis(150),
+        jitter: Duration::from_millis(50),
+        loss: 0.01,
+        ..Self::LOOPBACK
+    };
+
+    /// A busy Wi-Fi, fast but losing segments.
+    pub const LOSSY_WIFI: NetProfile = NetProfile {
+        name: "lossy_wifi",
+        bandwidth: 2500 * 1024,
+        latency: Duration::from_millis(10),
+        jitter: Duration::from_millis(20),
+        loss: 0.05,
+        ..Self::LOOPBACK
+    };
+
+    /// A remote server, such as one over a satellite link.
+    pub const HIGH_RTT: NetProfile = NetProfile {
+        name: "high_rtt",
+        bandwidth: 1250 * 1024,
+        latency: Duration::from_millis(300),
+        jitter: Duration::from_millis(10),
+        ..Self::LOOPBACK
+    };
+
+    /// A server slow to answer over a good link.
+    pub const SLOW_TTFB: NetProfile = NetProfile {
+        name: "slow_ttfb",
+        bandwidth: 5000 * 1024,
+        latency: Duration::from_millis(20),
+        ttfb: Duration::from_secs(2),
+        ..Self::LOOPBACK
+    };
+
+    /// A link dropping the connections in the middle of the responses.
+    pub const FLAKY: NetProfile = NetProfile {
+        name: "flaky",
+        bandwidth: 600 * 1024,
+        latency: Duration::from_millis(40),
+        jitter: Duration::from_millis(20),
+        loss: 0.01,
+        disconnect_after: Some(256 * 1024),
+        ..Self::LOOPBACK
+    };
+
+    /// Every profile, the loopback first.
+    pub const ALL: [NetProfile; 6] = [
+        Self::LOOPBACK,
+        Self::CELL_3G,
+        Self::LOSSY_WIFI,
+        Self::HIGH_RTT,
+        Self::SLOW_TTFB,
+        Self::FLAKY,
+    ];
+
+    /// Returns the profile named `name`.
+    pub fn by_name(name: &str) -> Option<NetProfile> {
+        Self::ALL.into_iter().find(|profile| profile.name == name)
+    }
+
+    /// Returns the profile named by `REQUEST_NET_PROFILE`, the loopback if
+    /// unset.
+    ///
+    /// # Panics
+    ///
+    /// Panics if no profile has the name, so that a typo does not benchmark
+    /// the loopback.
+    pub fn from_env() -> NetProfile {
+        match std::env::var(NET_PROFILE_ENV) {
+            Ok(name) => Self::by_name(&name)
+                .unwrap_or_else(|| panic!("unknown {} {}", NET_PROFILE_ENV, name)),
+            Err(_) => Self::LOOPBACK,
+        }
+    }
+
+    /// Whether the profile changes nothing of the loopback.
+    fn is_loopback(&self) -> bool {
+        self.bandwidth == 0
+            && self.latency.is_zero()
+            && self.jitter.is_zero()
+            && self.loss == 0.0
+            && self.ttfb.is_zero()
+            && self.disconnect_after.is_none()
+    }
+
+    /// Returns the time `len` bytes take to leave at the bandwidth.
+    fn transmit(&self, len: usize) -> Duration {
+        match self.bandwidth {
+            0 => Duration::ZERO,
+            bandwidth => Duration::from_nanos(len as u64 * 1_000_000_000 / bandwidth),
+        }
+    }
+
+    /// Returns the stall of a lost segment, a round trip but at least
+    /// `MIN_RTO`.
+    fn rto(&self) -> Duration {
+        (self.latency * 2).max(MIN_RTO)
+    }
+}
+
+/// Returns a random number in [0, 1).
+fn random() -> f64 {
+    (fast_random() >> 11) as f64 / (1u64 << 53) as f64
+}
+
+/// Writing half of a connection sending as a link of a profile.
+pub struct Shaped<W> {
+    inner: W,
+    profile: NetProfile,
+    /// Whether the next write is the first of a response
+    first: bool,
+    /// Bytes of the current response written
+    sent: u64,
+    /// Time the link is free to send the next segment
+    free_at: Instant,
+}
+
+impl<W: Write> Shaped<W> {
+    /// Shapes the writes to `inner` with `profile`, the first one starting a
+    /// response.
+    pub fn new(inner: W, profile: NetProfile) -> Self {
+        Self {
+            inner,
+            profile,
+            first: true,
+            sent: 0,
+            free_at: Instant::now(),
+        }
+    }
+
+    /// Starts the next response of a keep-alive connection, its first byte
+    /// waits for the time to first byte and the latency again.
+    pub fn respond(&mut self) {
+        self.first = true;
+        self.sent = 0;
+    }
+
+    /// Returns the writer shaped.
+    pub fn get_mut(&mut self) -> &mut W {
+        &mut self.inner
+    }
+
+    /// Waits until `delay` after the link is free.
+    fn wait(&mut self, delay: Duration) {
+        let now = Instant::now();
+        self.free_at = self.free_at.max(now) + delay;
+        if let Some(wait) = self.free_at.checked_duration_since(now) {
+            thread::sleep(wait);
+        }
+    }
+}
+
+impl<W: Write> Write for Shaped<W> {
+    fn write(&mut self, buf: &[u8]) -> io::Result<usize> {
+        if self.profile.is_loopback() || buf.is_empty() {
+            return self.inner.write(buf);
+        }
+        let mut len = buf.len().min(SEGMENT);
+        if let Some(limit) = self.profile.disconnect_after {
+            if self.sent >= limit {
+                return Err(io::Error::new(
+                    io::ErrorKind::ConnectionAborted,
+                    "dropped by the net profile",
+                ));
+            }
+            len = len.min((limit - self.sent) as usize);
+        }
+        let mut delay = self.profile.transmit(len);
+        if self.first {
+            self.first = false;
+            let jitter = self.profile.jitter.mul_f64(random());
+            delay += self.profile.ttfb + self.profile.latency + jitter;
+        }
+        if random() < self.profile.loss {
+            delay += self.profile.rto();
+        }
+        self.wait(delay);
+        let written = self.inner.write(&buf[..len])?;
+        self.sent += written as u64;
+        Ok(written)
+    }
+
+    fn flush(&mut self) -> io::Result<()> {
+        self.inner.flush()
+    }
+}
+
+#[cfg(test)]
+mod ut_shaping {
+    include!("../../tests/ut/test/ut_shaping.rs");
+}
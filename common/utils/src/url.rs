@@ -0,0 +1,88 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! URL parsing shared by the clients and the service.
+//!
+//! The network security config and the url policy are looked up by the host
+//! of a url, which is found for every created task. [`UrlView`] borrows the
+//! parts from the url instead of copying it. It is kept in line with
+//! `ParseUrlView` of `common/include/url_view.h`, used by the C++ clients.
+
+/// Parts of a url, borrowed from the url they were parsed from.
+///
+/// The url is not validated, parts it does not have are empty.
+#[derive(Clone, Copy, Debug, Default, PartialEq, Eq)]
+pub struct UrlView<'a> {
+    /// Scheme before `://`.
+    pub scheme: &'a str,
+    /// Host, with the brackets of an IPv6 address.
+    pub host: &'a str,
+    /// Port after the host.
+    pub port: &'a str,
+}
+
+impl<'a> UrlView<'a> {
+    /// Splits a url into its parts without allocating.
+    ///
+    /// `\` separates the parts like `/`, and user information before `@` is
+    /// not part of the host.
+    ///
+    /// # Examples
+    ///
+    /// ```rust
+    /// use request_utils::url::UrlView;
+    ///
+    /// let view = UrlView::parse("https://user@example.com:8080/path?query");
+    /// assert_eq!(view.scheme, "https");
+    /// assert_eq!(view.host, "example.com");
+    /// assert_eq!(view.port, "8080");
+    /// ```
+    pub fn parse(url: &'a str) -> Self {
+        let bytes = url.as_bytes();
+        let is_slash = |b: u8| b == b'/' || b == b'\\';
+
+        let mut view = Self::default();
+        let mut start = 0;
+        if let Some(colon) = (0..bytes.len().saturating_sub(2))
+            .find(|&i| bytes[i] == b':' && is_slash(bytes[i + 1]) && is_slash(bytes[i + 2]))
+        {
+            view.scheme = &url[..colon];
+            start = colon + 3;
+        }
+        while start < bytes.len() && is_slash(bytes[start]) {
+            start += 1;
+        }
+
+        let end = bytes[start..]
+            .iter()
+            .position(|&b| matches!(b, b'/' | b'\\' | b'?' | b'#'))
+            .map_or(bytes.len(), |end| start + end);
+        let mut authority = &url[start..end];
+        if let Some(at) = authority.rfind('@') {
+            authority = &authority[at + 1..];
+        }
+
+        let host_end = match authority.strip_prefix('[') {
+            Some(ipv6) => ipv6.find(']').map_or(authority.len(), |end| end + 2),
+            None => authority.find(':').unwrap_or(authority.len()),
+        };
+        view.host = &authority[..host_end];
+        view.port = authority[host_end..].strip_prefix(':').unwrap_or_default();
+        view
+    }
+}
+
+#[cfg(test)]
+mod ut_url {
+    include!("../tests/ut/ut_url.rs");
+}
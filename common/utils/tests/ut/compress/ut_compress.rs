@@ -0,0 +1,212 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use super::*;
+
+/// "hello" compressed with gzip.
+const GZIP_HELLO: [u8; 25] = [
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xcb, 0x48, 0xcd, 0xc9, 0xc9, 0x07,
+    0x00, 0x86, 0xa6, 0x10, 0x36, 0x05, 0x00, 0x00, 0x00,
+];
+
+/// "line 0\n" to "line 63\n" compressed with zlib, a block with dynamic codes.
+const ZLIB_LINES: [u8; 136] = [
+    0x78, 0xda, 0x35, 0xd1, 0xbb, 0x0d, 0x02, 0x30, 0x0c, 0x40, 0xc1, 0x9e, 0x29, 0x18, 0x01, 0xff,
+    0x02, 0x0c, 0x44, 0x81, 0x84, 0xd8, 0xbf, 0x44, 0x28, 0x97, 0xea, 0x55, 0x3e, 0xd9, 0xc9, 0xe7,
+    0xfd, 0x7d, 0x5d, 0x6f, 0x97, 0xcf, 0x3f, 0xb1, 0x93, 0x3b, 0xb5, 0xd3, 0x3b, 0xb3, 0xb3, 0x76,
+    0xee, 0x3b, 0x8f, 0x9d, 0xa7, 0xf1, 0xc3, 0x70, 0x02, 0x14, 0xa4, 0x40, 0x05, 0x2b, 0x60, 0x41,
+    0x0b, 0x5c, 0xf0, 0x92, 0x97, 0x67, 0x2f, 0x5e, 0xf2, 0x92, 0x97, 0xbc, 0xe4, 0x25, 0x2f, 0x79,
+    0xc9, 0x2b, 0x5e, 0xf1, 0xea, 0x1c, 0xca, 0x2b, 0x5e, 0xf1, 0x8a, 0x57, 0xbc, 0xe2, 0x15, 0xaf,
+    0x79, 0xcd, 0x6b, 0x5e, 0x9f, 0x97, 0xe3, 0x35, 0xaf, 0x79, 0xcd, 0x6b, 0x5e, 0xf3, 0x86, 0x37,
+    0xbc, 0xe1, 0x0d, 0x6f, 0xce, 0x57, 0xf0, 0x86, 0x37, 0xbc, 0xe1, 0x0d, 0x6f, 0xf1, 0x16, 0x6f,
+    0xf1, 0x56, 0x5d, 0x7e, 0x00, 0xd3, 0x8c, 0x63,
+];
+
+/// "hello" compressed as raw DEFLATE data.
+const RAW_HELLO: [u8; 7] = [0xcb, 0x48, 0xcd, 0xc9, 0xc9, 0x07, 0x00];
+
+fn decode_in_pieces(encoding: ContentEncoding, body: &[u8], piece: usize) -> Vec<u8> {
+    let mut decoder = ContentDecoder::new(encoding);
+    let mut out = Vec::new();
+    for data in body.chunks(piece) {
+        decoder.decode(data, &mut out).unwrap();
+    }
+    decoder.finish().unwrap();
+    assert_eq!(decoder.wire_bytes(), body.len() as u64);
+    assert_eq!(decoder.decoded_bytes(), out.len() as u64);
+    out
+}
+
+// @tc.name: ut_compress_parse
+// @tc.desc: Test parsing of `Content-Encoding` values
+// @tc.precon: NA
+// @tc.step: 1. Parse supported, identity and unsupported encodings
+// @tc.expect: Only gzip and deflate are recognized, case insensitively
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 0
+#[test]
+fn ut_compress_parse() {
+    assert_eq!(ContentEncoding::parse("gzip"), Some(ContentEncoding::Gzip));
+    assert_eq!(
+        ContentEncoding::parse(" x-gzip "),
+        Some(ContentEncoding::Gzip)
+    );
+    assert_eq!(
+        ContentEncoding::parse("Deflate"),
+        Some(ContentEncoding::Deflate)
+    );
+    assert_eq!(ContentEncoding::parse("identity"), None);
+    assert_eq!(ContentEncoding::parse("br"), None);
+}
+
+// @tc.name: ut_compress_gzip_pieces
+// @tc.desc: Test decoding a gzip body received in pieces of any size
+// @tc.precon: NA
+// @tc.step: 1. Decode the body in pieces of every size up to its length
+// @tc.expect: The decoded body is the same for every piece size
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_compress_gzip_pieces() {
+    for piece in 1..=GZIP_HELLO.len() {
+        assert_eq!(
+            decode_in_pieces(ContentEncoding::Gzip, &GZIP_HELLO, piece),
+            b"hello"
+        );
+    }
+}
+
+// @tc.name: ut_compress_deflate
+// @tc.desc: Test decoding zlib and raw DEFLATE bodies
+// @tc.precon: NA
+// @tc.step: 1. Decode a zlib body with dynamic codes byte by byte
+//           2. Decode raw DEFLATE bodies with fixed codes and a stored block
+// @tc.expect: The original bodies are returned
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_compress_deflate() {
+    let lines = (0..64).map(|i| format!("line {}\n", i)).collect::<String>();
+    for piece in [1, 7, ZLIB_LINES.len()] {
+        assert_eq!(
+            decode_in_pieces(ContentEncoding::Deflate, &ZLIB_LINES, piece),
+            lines.as_bytes()
+        );
+    }
+    assert_eq!(
+        decode_in_pieces(ContentEncoding::Deflate, &RAW_HELLO, 1),
+        b"hello"
+    );
+    let stored = [0x01, 0x05, 0x00, 0xfa, 0xff, b'h', b'e', b'l', b'l', b'o'];
+    assert_eq!(
+        decode_in_pieces(ContentEncoding::Deflate, &stored, 3),
+        b"hello"
+    );
+}
+
+// @tc.name: ut_compress_gzip_members
+// @tc.desc: Test decoding a gzip body made of several members
+// @tc.precon: NA
+// @tc.step: 1. Decode two concatenated members
+// @tc.expect: The bodies of both members are returned
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_compress_gzip_members() {
+    let body = [GZIP_HELLO, GZIP_HELLO].concat();
+    assert_eq!(
+        decode_in_pieces(ContentEncoding::Gzip, &body, 5),
+        b"hellohello"
+    );
+}
+
+// @tc.name: ut_compress_invalid
+// @tc.desc: Test decoding corrupted and truncated bodies
+// @tc.precon: NA
+// @tc.step: 1. Decode a gzip body with a wrong checksum
+//           2. Decode a gzip body with a wrong header
+//           3. Decode a truncated gzip body
+// @tc.expect: The matching errors are returned
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_compress_invalid() {
+    let mut out = Vec::new();
+    let mut body = GZIP_HELLO;
+    body[18] ^= 1;
+    let mut decoder = ContentDecoder::new(ContentEncoding::Gzip);
+    assert_eq!(decoder.decode(&body, &mut out), Err(DecodeError::Checksum));
+
+    let mut body = GZIP_HELLO;
+    body[1] = 0;
+    let mut decoder = ContentDecoder::new(ContentEncoding::Gzip);
+    assert_eq!(
+        decoder.decode(&body, &mut out),
+        Err(DecodeError::InvalidHeader)
+    );
+
+    let mut decoder = ContentDecoder::new(ContentEncoding::Gzip);
+    decoder.decode(&GZIP_HELLO[..20], &mut out).unwrap();
+    assert_eq!(decoder.finish(), Err(DecodeError::Truncated));
+}
+
+// @tc.name: ut_compress_encode
+// @tc.desc: Test encoding a body in pieces
+// @tc.precon: NA
+// @tc.step: 1. Encode empty, repetitive and random bodies with gzip and
+//              deflate, fed in pieces of several sizes
+//           2. Decode the encoded bodies
+// @tc.expect: The decoded bodies equal the originals and the repetitive body
+//             is compressed
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_compress_encode() {
+    let text = (0..20000)
+        .map(|i| format!("{{\"line\": {}, \"level\": \"info\"}}\n", i % 97))
+        .collect::<String>()
+        .into_bytes();
+    let mut x = 7u32;
+    let random = (0..200_000)
+        .map(|_| {
+            x = x.wrapping_mul(1103515245).wrapping_add(12345);
+            (x >> 16) as u8
+        })
+        .collect::<Vec<_>>();
+    for encoding in [ContentEncoding::Gzip, ContentEncoding::Deflate] {
+        for body in [&b""[..], b"a", &text, &random] {
+            for piece in [1000, 70000] {
+                let mut encoder = ContentEncoder::new(encoding);
+                let mut encoded = Vec::new();
+                for data in body.chunks(piece) {
+                    encoder.encode(data, &mut encoded);
+                }
+                encoder.finish(&mut encoded);
+                assert_eq!(encoder.source_bytes(), body.len() as u64);
+                assert_eq!(encoder.wire_bytes(), encoded.len() as u64);
+                assert_eq!(decode_in_pieces(encoding, &encoded, 4096), body);
+            }
+        }
+    }
+    let mut encoder = ContentEncoder::new(ContentEncoding::Gzip);
+    let mut encoded = Vec::new();
+    encoder.encode(&text, &mut encoded);
+    encoder.finish(&mut encoded);
+    assert!(encoded.len() < text.len() / 5);
+}
@@ -0,0 +1,56 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use super::*;
+
+// @tc.name: ut_crc32c_known
+// @tc.desc: Test CRC-32C checksums against known values
+// @tc.precon: NA
+// @tc.step: 1. Checksum the check input and the test patterns of RFC 3720
+// @tc.expect: The published checksums are returned
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 0
+#[test]
+fn ut_crc32c_known() {
+    assert_eq!(crc32c(b""), 0);
+    assert_eq!(crc32c(b"123456789"), 0xe306_9283);
+    assert_eq!(crc32c(&[0; 32]), 0x8a91_36aa);
+    assert_eq!(crc32c(&[0xff; 32]), 0x62a8_ab43);
+    let ascending = (0..32).collect::<Vec<u8>>();
+    assert_eq!(crc32c(&ascending), 0x46dd_794e);
+}
+
+// @tc.name: ut_crc32c_parts
+// @tc.desc: Test that the CRC of data given in parts is the CRC of the whole
+// @tc.precon: NA
+// @tc.step: 1. Checksum data of every length up to 100 bytes whole and split
+//           at every position, unaligned for the 8-byte instructions
+// @tc.expect: The CRCs are the same and match the byte at a time table
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_crc32c_parts() {
+    let data = (0..100u32).map(|i| (i * 31 + 7) as u8).collect::<Vec<_>>();
+    for len in 0..data.len() {
+        let whole = crc32c(&data[..len]);
+        assert_eq!(whole, !update_table(!0, &data[..len]));
+        for split in 0..=len {
+            let mut crc = Crc32c::new();
+            crc.update(&data[..split]);
+            crc.update(&data[split..len]);
+            assert_eq!(crc.finish(), whole);
+        }
+    }
+}
@@ -0,0 +1,98 @@
+// Copyright (C) 2024 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use super::*;
+
+fn hex(bytes: &[u8]) -> String {
+    bytes.iter().map(|b| format!("{:02x}", b)).collect()
+}
+
+// @tc.name: ut_digest_sha256
+// @tc.desc: Test SHA-256 digests against known values
+// @tc.precon: NA
+// @tc.step: 1. Hash the empty input, "abc" and the two block test message
+// @tc.expect: The published digests are returned
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 0
+#[test]
+fn ut_digest_sha256() {
+    let digest = |input: &[u8]| {
+        let mut sha = Sha256::new();
+        sha.update(input);
+        hex(&sha.finish())
+    };
+    assert_eq!(
+        digest(b""),
+        "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"
+    );
+    assert_eq!(
+        digest(b"abc"),
+        "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"
+    );
+    assert_eq!(
+        digest(b"abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq"),
+        "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1"
+    );
+}
+
+// @tc.name: ut_digest_md5
+// @tc.desc: Test MD5 digests against known values
+// @tc.precon: NA
+// @tc.step: 1. Hash the empty input, "abc" and an input longer than a block
+// @tc.expect: The published digests are returned
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 0
+#[test]
+fn ut_digest_md5() {
+    let digest = |input: &[u8]| {
+        let mut md5 = Md5::new();
+        md5.update(input);
+        hex(&md5.finish())
+    };
+    assert_eq!(digest(b""), "d41d8cd98f00b204e9800998ecf8427e");
+    assert_eq!(digest(b"abc"), "900150983cd24fb0d6963f7d28e17f72");
+    assert_eq!(
+        digest(b"12345678901234567890123456789012345678901234567890123456789012345678901234567890"),
+        "57edf4a22be3c955ac49da2e2107b67a"
+    );
+}
+
+// @tc.name: ut_digest_pieces
+// @tc.desc: Test digests of input given in pieces of different sizes
+// @tc.precon: NA
+// @tc.step: 1. Hash 1000 bytes at once and in pieces of 1 to 130 bytes
+// @tc.expect: Both digests give the same result for every piece size
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_digest_pieces() {
+    let input = (0..1000u32).map(|i| (i * 7) as u8).collect::<Vec<_>>();
+    let mut sha = Sha256::new();
+    sha.update(&input);
+    let mut md5 = Md5::new();
+    md5.update(&input);
+    let (sha, md5) = (sha.finish(), md5.finish());
+    for size in 1..130 {
+        let mut sha_pieces = Sha256::new();
+        let mut md5_pieces = Md5::new();
+        for piece in input.chunks(size) {
+            sha_pieces.update(piece);
+            md5_pieces.update(piece);
+        }
+        assert_eq!(sha_pieces.finish(), sha);
+        assert_eq!(md5_pieces.finish(), md5);
+    }
+}
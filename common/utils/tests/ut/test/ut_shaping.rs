@@ -0,0 +1,107 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use super::*;
+
+// @tc.name: ut_shaping_bandwidth
+// @tc.desc: Test that the writes are paced at the bandwidth of the profile
+// @tc.precon: NA
+// @tc.step: 1. Write 100 KiB through a profile of 1 MiB per second
+// @tc.expect: The write takes about 100 ms and every byte is written
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_shaping_bandwidth() {
+    let profile = NetProfile {
+        bandwidth: 1024 * 1024,
+        ..NetProfile::LOOPBACK
+    };
+    let body = vec![0x5a; 100 * 1024];
+    let mut shaped = Shaped::new(Vec::new(), profile);
+    let start = Instant::now();
+    shaped.write_all(&body).unwrap();
+    let elapsed = start.elapsed();
+    assert!(elapsed >= Duration::from_millis(90), "{:?}", elapsed);
+    assert!(elapsed < Duration::from_secs(1), "{:?}", elapsed);
+    assert_eq!(*shaped.get_mut(), body);
+}
+
+// @tc.name: ut_shaping_first_byte
+// @tc.desc: Test that the first byte of each response waits for the time to
+// first byte and the latency
+// @tc.precon: NA
+// @tc.step: 1. Write a response through a profile with a time to first byte
+// 2. Start another response and write it
+// @tc.expect: Both responses wait for the time to first byte and the latency
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_shaping_first_byte() {
+    let profile = NetProfile {
+        ttfb: Duration::from_millis(50),
+        latency: Duration::from_millis(20),
+        ..NetProfile::LOOPBACK
+    };
+    let mut shaped = Shaped::new(Vec::new(), profile);
+    for _ in 0..2 {
+        let start = Instant::now();
+        shaped.write_all(b"response").unwrap();
+        assert!(start.elapsed() >= Duration::from_millis(70));
+        shaped.respond();
+    }
+    assert_eq!(shaped.get_mut().len(), 16);
+}
+
+// @tc.name: ut_shaping_disconnect
+// @tc.desc: Test that a response is dropped after the bytes of the profile
+// @tc.precon: NA
+// @tc.step: 1. Write 100 bytes through a profile dropping after 10
+// 2. Start another response and write 100 bytes again
+// @tc.expect: Each write fails with ConnectionAborted after 10 bytes
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_shaping_disconnect() {
+    let profile = NetProfile {
+        disconnect_after: Some(10),
+        ..NetProfile::LOOPBACK
+    };
+    let mut shaped = Shaped::new(Vec::new(), profile);
+    for written in [10, 20] {
+        let err = shaped.write_all(&[0; 100]).unwrap_err();
+        assert_eq!(err.kind(), io::ErrorKind::ConnectionAborted);
+        assert_eq!(shaped.get_mut().len(), written);
+        shaped.respond();
+    }
+}
+
+// @tc.name: ut_shaping_profiles
+// @tc.desc: Test finding the profiles by name
+// @tc.precon: NA
+// @tc.step: 1. Find every profile by its name, then an unknown one
+// @tc.expect: Every profile is found, the unknown name is not
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_shaping_profiles() {
+    for profile in NetProfile::ALL {
+        assert_eq!(NetProfile::by_name(profile.name), Some(profile));
+    }
+    assert_eq!(NetProfile::by_name("5g"), None);
+    assert!(NetProfile::LOOPBACK.is_loopback());
+    assert!(NetProfile::ALL[1..].iter().all(|p| !p.is_loopback()));
+}
@@ -0,0 +1,280 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use super::*;
+
+/// Raw DEFLATE of `"hello hello hello hello archive\n"` four times.
+const DEFLATED: [u8; 22] = [
+    0xcb, 0x48, 0xcd, 0xc9, 0xc9, 0x57, 0xc8, 0xc0, 0x20, 0x13, 0x8b, 0x92, 0x33, 0x32, 0xcb, 0x52,
+    0xb9, 0x32, 0x68, 0x2c, 0x0f, 0x00,
+];
+
+#[derive(Default)]
+struct Collect {
+    entries: Vec<(Entry, Vec<u8>)>,
+    open: bool,
+}
+
+impl Sink for Collect {
+    fn begin(&mut self, entry: &Entry) -> io::Result<()> {
+        assert!(!self.open);
+        self.open = true;
+        self.entries.push((entry.clone(), Vec::new()));
+        Ok(())
+    }
+
+    fn data(&mut self, data: &[u8]) -> io::Result<()> {
+        assert!(self.open);
+        self.entries.last_mut().unwrap().1.extend_from_slice(data);
+        Ok(())
+    }
+
+    fn end(&mut self) -> io::Result<()> {
+        assert!(self.open);
+        self.open = false;
+        Ok(())
+    }
+}
+
+fn tar_header(name: &str, kind: u8, size: usize) -> Vec<u8> {
+    let mut header = vec![0u8; TAR_BLOCK];
+    header[..name.len()].copy_from_slice(name.as_bytes());
+    header[100..107].copy_from_slice(b"0000644");
+    header[124..135].copy_from_slice(format!("{:011o}", size).as_bytes());
+    header[156] = kind;
+    header[257..263].copy_from_slice(b"ustar\0");
+    header[263..265].copy_from_slice(b"00");
+    header[148..156].copy_from_slice(b"        ");
+    let sum = header.iter().map(|&b| b as u32).sum::<u32>();
+    header[148..155].copy_from_slice(format!("{:06o}\0", sum).as_bytes());
+    header
+}
+
+fn tar_entry(tar: &mut Vec<u8>, name: &str, kind: u8, data: &[u8]) {
+    tar.extend_from_slice(&tar_header(name, kind, data.len()));
+    tar.extend_from_slice(data);
+    tar.resize(tar.len().div_ceil(TAR_BLOCK) * TAR_BLOCK, 0);
+}
+
+fn sample_tar() -> Vec<u8> {
+    let long = format!("{}/file.txt", "d".repeat(120));
+    let mut tar = Vec::new();
+    tar_entry(&mut tar, "dir/", b'5', b"");
+    tar_entry(&mut tar, "./dir/a.txt", b'0', b"alpha");
+    tar_entry(
+        &mut tar,
+        "././@LongLink",
+        b'L',
+        format!("{}\0", long).as_bytes(),
+    );
+    tar_entry(&mut tar, "truncated", b'0', &vec![7u8; 1000]);
+    tar_entry(&mut tar, "link", b'2', b"");
+    tar.extend_from_slice(&[0u8; TAR_BLOCK * 2]);
+    tar
+}
+
+/// Wraps `data` in a gzip member of stored blocks.
+fn gzip(data: &[u8]) -> Vec<u8> {
+    let mut out = vec![0x1f, 0x8b, 8, 0, 0, 0, 0, 0, 0, 0xff];
+    let mut chunks = data.chunks(1000).peekable();
+    while let Some(chunk) = chunks.next() {
+        out.push(chunks.peek().is_none() as u8);
+        let len = chunk.len() as u16;
+        out.extend_from_slice(&len.to_le_bytes());
+        out.extend_from_slice(&(!len).to_le_bytes());
+        out.extend_from_slice(chunk);
+    }
+    out.extend_from_slice(&crc32(0, data).to_le_bytes());
+    out.extend_from_slice(&(data.len() as u32).to_le_bytes());
+    out
+}
+
+/// Appends a zip entry, its sizes after its data if `descriptor` is set.
+fn zip_entry(
+    zip: &mut Vec<u8>,
+    name: &str,
+    method: u16,
+    data: &[u8],
+    plain: &[u8],
+    descriptor: bool,
+) {
+    let crc = crc32(0, plain);
+    let flags = if descriptor { ZIP_FLAG_DESCRIPTOR } else { 0 };
+    let (crc_field, sizes) = if descriptor {
+        (0, (0, 0))
+    } else {
+        (crc, (data.len() as u32, plain.len() as u32))
+    };
+    zip.extend_from_slice(&ZIP_LOCAL_HEADER.to_le_bytes());
+    zip.extend_from_slice(&20u16.to_le_bytes());
+    zip.extend_from_slice(&flags.to_le_bytes());
+    zip.extend_from_slice(&method.to_le_bytes());
+    zip.extend_from_slice(&[0; 4]);
+    zip.extend_from_slice(&crc_field.to_le_bytes());
+    zip.extend_from_slice(&sizes.0.to_le_bytes());
+    zip.extend_from_slice(&sizes.1.to_le_bytes());
+    zip.extend_from_slice(&(name.len() as u16).to_le_bytes());
+    zip.extend_from_slice(&4u16.to_le_bytes());
+    zip.extend_from_slice(name.as_bytes());
+    zip.extend_from_slice(&[0xfe, 0xca, 0, 0]);
+    zip.extend_from_slice(data);
+    if descriptor {
+        zip.extend_from_slice(&ZIP_DESCRIPTOR.to_le_bytes());
+        zip.extend_from_slice(&crc.to_le_bytes());
+        zip.extend_from_slice(&(data.len() as u32).to_le_bytes());
+        zip.extend_from_slice(&(plain.len() as u32).to_le_bytes());
+    }
+}
+
+fn sample_zip() -> (Vec<u8>, Vec<u8>) {
+    let plain = b"hello hello hello hello archive\n".repeat(4);
+    let mut zip = Vec::new();
+    zip_entry(&mut zip, "docs/", ZIP_STORED, b"", b"", false);
+    zip_entry(
+        &mut zip,
+        "docs/readme",
+        ZIP_STORED,
+        b"read me",
+        b"read me",
+        false,
+    );
+    zip_entry(
+        &mut zip,
+        "docs/deflated",
+        ZIP_DEFLATED,
+        &DEFLATED,
+        &plain,
+        false,
+    );
+    zip_entry(&mut zip, "streamed", ZIP_DEFLATED, &DEFLATED, &plain, true);
+    zip.extend_from_slice(&ZIP_CENTRAL_HEADER.to_le_bytes());
+    zip.extend_from_slice(&[0; 42]);
+    (zip, plain)
+}
+
+/// Extracts `archive` fed in pieces of `step` bytes.
+fn extract(archive: &[u8], step: usize) -> Result<Vec<(Entry, Vec<u8>)>, ArchiveError> {
+    let mut extractor = Extractor::new();
+    let mut sink = Collect::default();
+    for piece in archive.chunks(step) {
+        extractor.feed(piece, &mut sink)?;
+    }
+    extractor.finish()?;
+    assert_eq!(extractor.entries(), sink.entries.len() as u64);
+    Ok(sink.entries)
+}
+
+// @tc.name: ut_archive_tar
+// @tc.desc: Test extracting a tar archive fed in pieces
+// @tc.precon: NA
+// @tc.step: 1. Extract a tar archive, plain and gzip compressed, fed in
+//              pieces of several sizes
+// @tc.expect: The directory and the files are extracted with their data, the
+//             long name is applied and the link is skipped
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_archive_tar() {
+    let tar = sample_tar();
+    let long = format!("{}/file.txt", "d".repeat(120));
+    for archive in [tar.clone(), gzip(&tar)] {
+        for step in [1, 100, 512, archive.len()] {
+            let entries = extract(&archive, step).unwrap();
+            assert_eq!(entries.len(), 3);
+            assert_eq!(entries[0].0.path, "dir");
+            assert_eq!(entries[0].0.kind, EntryKind::Dir);
+            assert_eq!(entries[1].0.path, "dir/a.txt");
+            assert_eq!(entries[1].0.size, Some(5));
+            assert_eq!(entries[1].1, b"alpha");
+            assert_eq!(entries[2].0.path, long);
+            assert_eq!(entries[2].1, vec![7u8; 1000]);
+        }
+    }
+    assert!(matches!(
+        extract(&tar[..1500], 64),
+        Err(ArchiveError::Truncated)
+    ));
+    let mut corrupt = tar.clone();
+    corrupt[0] = b'x';
+    assert!(matches!(
+        extract(&corrupt, 512),
+        Err(ArchiveError::Invalid(_))
+    ));
+}
+
+// @tc.name: ut_archive_zip
+// @tc.desc: Test extracting a zip archive fed in pieces
+// @tc.precon: NA
+// @tc.step: 1. Extract a zip archive with stored and deflated entries, one
+//              with its sizes after its data, fed in pieces of several sizes
+//           2. Extract it with the data of an entry corrupted
+// @tc.expect: The entries are extracted with their data up to the central
+//             directory, the corrupted entry fails its checksum
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_archive_zip() {
+    let (zip, plain) = sample_zip();
+    for step in [1, 7, 64, zip.len()] {
+        let entries = extract(&zip, step).unwrap();
+        assert_eq!(entries.len(), 4);
+        assert_eq!(entries[0].0.kind, EntryKind::Dir);
+        assert_eq!(entries[0].0.path, "docs");
+        assert_eq!(entries[1].1, b"read me");
+        assert_eq!(entries[2].0.size, Some(plain.len() as u64));
+        assert_eq!(entries[2].1, plain);
+        assert_eq!(entries[3].0.path, "streamed");
+        assert_eq!(entries[3].0.size, None);
+        assert_eq!(entries[3].1, plain);
+    }
+    let mut corrupt = zip.clone();
+    let at = zip.windows(7).position(|w| w == b"read me").unwrap();
+    corrupt[at] = b'R';
+    assert!(matches!(extract(&corrupt, 64), Err(ArchiveError::Checksum)));
+    assert!(matches!(
+        extract(&zip[..zip.len() - 50], 64),
+        Err(ArchiveError::Truncated)
+    ));
+}
+
+// @tc.name: ut_archive_path
+// @tc.desc: Test the paths of the entries of an archive
+// @tc.precon: NA
+// @tc.step: 1. Sanitize relative, absolute and parent paths
+//           2. Extract a tar archive with an entry leaving the directory
+// @tc.expect: Paths are made relative, a path leaving the directory fails
+//             the extraction
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_archive_path() {
+    assert_eq!(sanitize("a/./b//c").unwrap().as_deref(), Some("a/b/c"));
+    assert_eq!(
+        sanitize("/etc/passwd").unwrap().as_deref(),
+        Some("etc/passwd")
+    );
+    assert_eq!(sanitize("./").unwrap(), None);
+    assert!(matches!(sanitize("a/../../b"), Err(ArchiveError::Path(_))));
+
+    let mut tar = Vec::new();
+    tar_entry(&mut tar, "../escape", b'0', b"x");
+    tar.extend_from_slice(&[0u8; TAR_BLOCK * 2]);
+    assert!(matches!(extract(&tar, 512), Err(ArchiveError::Path(_))));
+    assert!(matches!(
+        extract(b"plain text, no archive", 4),
+        Err(ArchiveError::Unsupported)
+    ));
+}
@@ -0,0 +1,135 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use super::*;
+
+fn data(len: usize, seed: u32) -> Vec<u8> {
+    let mut x = seed;
+    (0..len)
+        .map(|_| {
+            x = x.wrapping_mul(1103515245).wrapping_add(12345);
+            (x >> 16) as u8
+        })
+        .collect()
+}
+
+fn manifest_of(file: &[u8], block_size: usize) -> String {
+    let mut text = format!("Blocksize: {}\nLength: {}\n\n", block_size, file.len());
+    for block in file.chunks_exact(block_size) {
+        let mut md5 = Md5::new();
+        md5.update(block);
+        let strong = md5
+            .finish()
+            .iter()
+            .map(|b| format!("{:02x}", b))
+            .collect::<String>();
+        text.push_str(&format!("{:08x} {}\n", weak_checksum(block), strong));
+    }
+    text
+}
+
+// @tc.name: ut_delta_manifest_parse
+// @tc.desc: Test parsing the manifest of a file
+// @tc.precon: NA
+// @tc.step: 1. Parse a valid manifest and malformed ones
+// @tc.expect: The valid manifest keeps its headers and blocks, the others are
+//             refused
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_delta_manifest_parse() {
+    let file = data(2000, 1);
+    let text = manifest_of(&file, 512);
+    let manifest = Manifest::parse(&text).unwrap();
+    assert_eq!(manifest.block_size, 512);
+    assert_eq!(manifest.length, 2000);
+    assert_eq!(manifest.blocks.len(), 3);
+    assert!(manifest.sha256.is_none());
+
+    let sha = format!("SHA-256: {}\n", "ab".repeat(32));
+    let manifest = Manifest::parse(&text.replacen("\n\n", &format!("\n{}\n", sha), 1)).unwrap();
+    assert_eq!(manifest.sha256, Some(vec![0xab; 32]));
+
+    assert!(Manifest::parse(&text.replace("Blocksize: 512", "Blocksize: 16")).is_none());
+    assert!(Manifest::parse(&text.replace("Length: 2000", "Length: 3000")).is_none());
+    assert!(Manifest::parse("Length: 10\n\n").is_none());
+    assert!(Manifest::parse("Blocksize: 512\nLength: 600\n\nzz 00\n").is_none());
+}
+
+// @tc.name: ut_delta_rolling
+// @tc.desc: Test rolling the weak checksum over a buffer
+// @tc.precon: NA
+// @tc.step: 1. Roll the checksum of a window a byte at a time
+// @tc.expect: Each rolled checksum equals the checksum of the window
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_delta_rolling() {
+    let buf = data(4096, 2);
+    let n = 700;
+    let mut sum = Rolling::new(&buf[..n]);
+    for start in 1..buf.len() - n {
+        sum.roll(buf[start - 1], buf[start + n - 1], n);
+        assert_eq!(sum.digest(), weak_checksum(&buf[start..start + n]));
+    }
+}
+
+// @tc.name: ut_delta_scan_assemble
+// @tc.desc: Test finding the blocks of a new version in an old one
+// @tc.precon: NA
+// @tc.step: 1. Make a new version by inserting bytes into the old one and
+//              changing a block
+//           2. Scan the old version and assemble the new one
+// @tc.expect: The unchanged blocks are copied from their shifted offsets, the
+//             changed ones and the tail are fetched, and the assembly equals
+//             the new version
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_delta_scan_assemble() {
+    let n = 512;
+    let base = data(n * 10, 3);
+    let mut new = base[..n * 2].to_vec();
+    new.extend_from_slice(&data(n, 4));
+    new.extend_from_slice(&base[n * 2..n * 6]);
+    new.extend_from_slice(&data(100, 5));
+    new.extend_from_slice(&base[n * 6 + 7..]);
+
+    let manifest = Manifest::parse(&manifest_of(&new, n)).unwrap();
+    let found = manifest.scan(&base[..]).unwrap();
+    assert_eq!(found[0], Some(0));
+    assert_eq!(found[2], None);
+    assert_eq!(found[3], Some(2 * n as u64));
+
+    let assembly = manifest.assemble(&found);
+    assert_eq!(assembly.copies[0], (0, 0, 2 * n as u64));
+    assert_eq!(assembly.missing[0], (2 * n as u64, 3 * n as u64 - 1));
+    assert_eq!(assembly.missing.last().unwrap().1, new.len() as u64 - 1);
+
+    let mut out = vec![0u8; new.len()];
+    for &(from, to, len) in assembly.copies.iter() {
+        let (from, to, len) = (from as usize, to as usize, len as usize);
+        out[to..to + len].copy_from_slice(&base[from..from + len]);
+    }
+    for &(start, end) in assembly.missing.iter() {
+        let (start, end) = (start as usize, end as usize);
+        out[start..=end].copy_from_slice(&new[start..=end]);
+    }
+    assert_eq!(out, new);
+    assert!(assembly.matched() >= 7 * n as u64);
+    let fetched = assembly.missing.iter().map(|r| r.1 - r.0 + 1).sum::<u64>();
+    assert_eq!(assembly.matched() + fetched, new.len() as u64);
+}
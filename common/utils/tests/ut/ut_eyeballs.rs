@@ -0,0 +1,115 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use std::net::TcpListener;
+
+use super::*;
+
+fn addr(s: &str) -> SocketAddr {
+    s.parse().unwrap()
+}
+
+/// Returns an address of the loopback nothing listens on.
+fn closed_addr() -> SocketAddr {
+    let listener = TcpListener::bind("127.0.0.1:0").unwrap();
+    listener.local_addr().unwrap()
+}
+
+// @tc.name: ut_eyeballs_interleave
+// @tc.desc: Test alternating the families of addresses
+// @tc.precon: NA
+// @tc.step: 1. Interleave addresses of both families with either first
+// @tc.expect: The families alternate from the first one, in their order
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_eyeballs_interleave() {
+    let addrs = vec![
+        addr("[::1]:80"),
+        addr("[::2]:80"),
+        addr("[::3]:80"),
+        addr("1.1.1.1:80"),
+    ];
+    assert_eq!(
+        interleave(addrs.clone(), true),
+        vec![
+            addr("[::1]:80"),
+            addr("1.1.1.1:80"),
+            addr("[::2]:80"),
+            addr("[::3]:80"),
+        ]
+    );
+    assert_eq!(
+        interleave(addrs, false),
+        vec![
+            addr("1.1.1.1:80"),
+            addr("[::1]:80"),
+            addr("[::2]:80"),
+            addr("[::3]:80"),
+        ]
+    );
+}
+
+// @tc.name: ut_eyeballs_race
+// @tc.desc: Test racing connections to addresses
+// @tc.precon: NA
+// @tc.step: 1. Race an address nothing listens on and a listening one
+//           2. Race only addresses nothing listens on
+// @tc.expect: The listening address wins, no address wins without one
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_eyeballs_race() {
+    let listener = TcpListener::bind("127.0.0.1:0").unwrap();
+    let open = listener.local_addr().unwrap();
+    let closed = closed_addr();
+    let stagger = Duration::from_secs(5);
+    let timeout = Duration::from_secs(5);
+    let start = Instant::now();
+    assert_eq!(race(&[closed, open], stagger, timeout), Some(open));
+    // The failed attempt starts the next one without waiting for the stagger
+    assert!(start.elapsed() < stagger);
+    assert_eq!(race(&[closed], stagger, timeout), None);
+}
+
+// @tc.name: ut_eyeballs_order
+// @tc.desc: Test ordering the addresses of a dual-stack host
+// @tc.precon: NA
+// @tc.step: 1. Order the addresses of a host answering over IPv4 only
+//           2. Order them again before and after the family expires
+// @tc.expect: IPv4 leads once it won a race, until the family expires
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_eyeballs_order() {
+    let listener = TcpListener::bind("127.0.0.1:0").unwrap();
+    let open = listener.local_addr().unwrap();
+    let v6 = SocketAddr::new("::1".parse().unwrap(), closed_addr().port());
+    let families = Families::new();
+    assert_eq!(
+        families.order("a.com:80", vec![v6, open], 0),
+        vec![open, v6]
+    );
+    drop(listener);
+    assert_eq!(families.get("a.com:80", FAMILY_TTL - 1), Some(false));
+    assert_eq!(
+        families.order("a.com:80", vec![v6, open], 1),
+        vec![open, v6]
+    );
+    assert_eq!(families.get("a.com:80", FAMILY_TTL), None);
+    families.clear();
+    assert_eq!(families.get("a.com:80", 0), None);
+}
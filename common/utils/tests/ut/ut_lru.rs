@@ -253,3 +253,81 @@ fn ut_test_insert_after_pop() {
     assert!(!cache.is_empty());
     assert_eq!(Some(Cache::from_u(1)), cache.pop());
 }
+
+// @tc.name: ut_lru_cache_peek_pop_entry
+// @tc.desc: Test peeking and popping the least recently used entry
+// @tc.precon: NA
+// @tc.step: 1. Create a new LRUCache instance
+//           2. Insert entries and access the oldest one
+//           3. Peek and pop the least recently used entry
+// @tc.expect: peek_lru returns the least recently used key without removing
+// it, pop_entry removes it together with its value
+// @tc.type: FUNC
+// @tc.require: issue#ICN31I
+// @tc.level: level3
+#[test]
+fn ut_lru_cache_peek_pop_entry() {
+    let mut cache = LRUCache::new();
+    assert_eq!(None, cache.peek_lru());
+    cache.insert("key0", Cache::from_u(0));
+    cache.insert("key1", Cache::from_u(1));
+    cache.get(&"key0");
+    assert_eq!(Some(&"key1"), cache.peek_lru());
+    assert_eq!(2, cache.len());
+    assert_eq!(Some(("key1", Cache::from_u(1))), cache.pop_entry());
+    assert_eq!(Some(&"key0"), cache.peek_lru());
+    assert_eq!(Some(("key0", Cache::from_u(0))), cache.pop_entry());
+    assert_eq!(None, cache.pop_entry());
+}
+
+// @tc.name: ut_lru_cache_model
+// @tc.desc: Test LRUCache against a simple model under mixed operations
+// @tc.precon: NA
+// @tc.step: 1. Run a long pseudo-random mix of insert, get, remove and pop on
+//              a small key space, growing and emptying the cache repeatedly
+//           2. Apply the same operations to a vector kept in access order
+// @tc.expect: Every result, the length and the order of keys match the model
+// @tc.type: FUNC
+// @tc.require: issue#ICN31I
+// @tc.level: level2
+#[test]
+fn ut_lru_cache_model() {
+    let mut cache = LRUCache::new();
+    let mut model: Vec<(u32, u32)> = Vec::new();
+    let mut seed = 0x2545_f491_u64;
+    for i in 0..20_000u32 {
+        seed = seed
+            .wrapping_mul(6364136223846793005)
+            .wrapping_add(1442695040888963407);
+        let key = ((seed >> 33) % 300) as u32;
+        let found = model.iter().position(|&(k, _)| k == key);
+        match (seed >> 20) % 8 {
+            0..=2 => {
+                let old = found.map(|pos| model.remove(pos).1);
+                model.push((key, i));
+                assert_eq!(old, cache.insert(key, i));
+            }
+            3 | 4 => {
+                let value = found.map(|pos| {
+                    let entry = model.remove(pos);
+                    model.push(entry);
+                    entry.1
+                });
+                assert_eq!(value.as_ref(), cache.get(&key));
+            }
+            5 => {
+                let value = found.map(|pos| model.remove(pos).1);
+                assert_eq!(value, cache.remove(&key));
+            }
+            6 => {
+                let entry = (!model.is_empty()).then(|| model.remove(0));
+                assert_eq!(entry, cache.pop_entry());
+            }
+            _ => assert_eq!(found.is_some(), cache.contains_key(&key)),
+        }
+        assert_eq!(model.len(), cache.len());
+        assert_eq!(model.first().map(|(k, _)| k), cache.peek_lru());
+    }
+    let keys = cache.keys().copied().collect::<Vec<_>>();
+    assert_eq!(model.iter().map(|&(k, _)| k).collect::<Vec<_>>(), keys);
+}
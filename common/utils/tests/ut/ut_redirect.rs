@@ -0,0 +1,129 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use super::*;
+
+// @tc.name: ut_redirect_resolve
+// @tc.desc: Test resolving the location of a redirect
+// @tc.precon: NA
+// @tc.step: 1. Resolve absolute, scheme relative, absolute path, relative
+//              path and query locations
+// @tc.expect: Each location resolves to the absolute url of its target
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_redirect_resolve() {
+    let base = "https://a.com/x/y?q=1#f";
+    assert_eq!(
+        resolve(base, "http://b.com/z").as_deref(),
+        Some("http://b.com/z")
+    );
+    assert_eq!(
+        resolve(base, "//b.com/z").as_deref(),
+        Some("https://b.com/z")
+    );
+    assert_eq!(resolve(base, "/z").as_deref(), Some("https://a.com/z"));
+    assert_eq!(resolve(base, "z").as_deref(), Some("https://a.com/x/z"));
+    assert_eq!(
+        resolve(base, "?r=2").as_deref(),
+        Some("https://a.com/x/y?r=2")
+    );
+    assert_eq!(
+        resolve("https://a.com", "z").as_deref(),
+        Some("https://a.com/z")
+    );
+    assert_eq!(resolve(base, " "), None);
+    assert_eq!(resolve("a.com/x", "z"), None);
+}
+
+// @tc.name: ut_redirect_cache_policy
+// @tc.desc: Test which redirects are cached and for how long
+// @tc.precon: NA
+// @tc.step: 1. Insert permanent and temporary redirects with and without
+//              Cache-Control
+//           2. Look them up before and after they expire
+// @tc.expect: Permanent redirects and temporary ones with max-age are cached
+//             until they expire, the others are not
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_redirect_cache_policy() {
+    let cache = RedirectCache::new(16);
+    cache.insert("http://a.com/1", 301, "/one", None, 0);
+    assert_eq!(
+        cache
+            .get("http://a.com/1", DEFAULT_PERMANENT_AGE - 1)
+            .as_deref(),
+        Some("http://a.com/one")
+    );
+    assert_eq!(cache.get("http://a.com/1", DEFAULT_PERMANENT_AGE), None);
+
+    cache.insert("http://a.com/2", 308, "/two", Some("max-age=10"), 0);
+    assert!(cache.get("http://a.com/2", 9999).is_some());
+    assert!(cache.get("http://a.com/2", 10000).is_none());
+
+    cache.insert("http://a.com/3", 302, "/three", None, 0);
+    assert!(cache.get("http://a.com/3", 0).is_none());
+    cache.insert(
+        "http://a.com/3",
+        307,
+        "/three",
+        Some("public, max-age=5"),
+        0,
+    );
+    assert!(cache.get("http://a.com/3", 0).is_some());
+
+    cache.insert("http://a.com/4", 301, "/four", Some("no-store"), 0);
+    cache.insert("http://a.com/5", 303, "/five", Some("max-age=5"), 0);
+    cache.insert("http://a.com/6", 307, "/six", Some("private, max-age=5"), 0);
+    assert!(cache.get("http://a.com/4", 0).is_none());
+    assert!(cache.get("http://a.com/5", 0).is_none());
+    assert!(cache.get("http://a.com/6", 0).is_none());
+}
+
+// @tc.name: ut_redirect_cache_chain
+// @tc.desc: Test the chains, the loops and the bound of the cache
+// @tc.precon: NA
+// @tc.step: 1. Cache a chain of redirects and a loop
+//           2. Insert more redirects than the capacity and remove one
+// @tc.expect: Chains end at their last target, loops end, the least
+//             recently used redirect is dropped
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_redirect_cache_chain() {
+    let cache = RedirectCache::new(2);
+    cache.insert("http://a.com/1", 301, "http://a.com/2", None, 0);
+    cache.insert("http://a.com/2", 301, "http://a.com/1", None, 0);
+    assert!(cache.get("http://a.com/1", 0).is_some());
+
+    cache.insert("http://a.com/3", 301, "http://a.com/4", None, 0);
+    assert!(cache.get("http://a.com/1", 0).is_none());
+    assert_eq!(
+        cache.get("http://a.com/2", 0).as_deref(),
+        Some("http://a.com/1")
+    );
+    cache.remove("http://a.com/3");
+    assert!(cache.get("http://a.com/3", 0).is_none());
+
+    let cache = RedirectCache::new(16);
+    cache.insert("http://a.com/1", 301, "http://a.com/2", None, 0);
+    cache.insert("http://a.com/2", 308, "https://a.com/2", None, 0);
+    assert_eq!(
+        cache.get("http://a.com/1", 0).as_deref(),
+        Some("https://a.com/2")
+    );
+}
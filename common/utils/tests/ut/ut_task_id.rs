@@ -260,4 +260,42 @@ mod ut_task_id {
         let task2 = TaskId::from_url("https://example.org");
         assert_ne!(task1, task2);
     }
-}
\ No newline at end of file
+
+    // @tc.name: ut_task_id_key
+    // @tc.desc: Verify the 128-bit key of TaskId
+    // @tc.precon: NA
+    // @tc.step: 1. Create TaskIds from the same and from different hashes
+    // 2. Compare their keys
+    // @tc.expect: Equal TaskIds have equal keys, different ones different keys
+    // @tc.type: FUNC
+    // @tc.require: issueNumber
+    // @tc.level: Level 1
+    #[test]
+    fn ut_task_id_key() {
+        let task1 = TaskId::new("key_test".to_string());
+        let task2 = TaskId::new("key_test".to_string());
+        let task3 = TaskId::new("key_test_other".to_string());
+        assert_eq!(task1.key(), task2.key());
+        assert_ne!(task1.key(), task3.key());
+    }
+
+    // @tc.name: ut_task_id_from_url_repeated
+    // @tc.desc: Verify from_url of a remembered URL
+    // @tc.precon: NA
+    // @tc.step: 1. Call from_url twice with the same URL
+    // 2. Call from_url with another URL
+    // @tc.expect: The repeated URL gives an equal TaskId with the same hash
+    // string, the other URL a different one
+    // @tc.type: FUNC
+    // @tc.require: issueNumber
+    // @tc.level: Level 1
+    #[test]
+    fn ut_task_id_from_url_repeated() {
+        let task1 = TaskId::from_url("https://example.com/repeated");
+        let task2 = TaskId::from_url("https://example.com/repeated");
+        let task3 = TaskId::from_url("https://example.com/other");
+        assert!(task1 == task2);
+        assert_eq!(task1.to_string(), url_hash("https://example.com/repeated"));
+        assert!(task1 != task3);
+    }
+}
@@ -21,7 +21,9 @@
 #include <mutex>
 #include <string>
 
+#include "cj_payload_arena.h"
 #include "cj_request_ffi.h"
+#include "notify_delivery.h"
 #include "request_common.h"
 
 namespace OHOS::CJSystemapi::Request {
@@ -41,18 +43,26 @@ public:
         std::function<void(CProgress)> progressCB_;
         std::function<void(CResponse)> responseCB_;
         CFunc cbId_ = nullptr;
+        // The callback only borrows its payload, which is freed once it returns.
+        bool borrowed_ = false;
 
-        CallBackInfo(std::function<void(CProgress)> cb, CFunc cbId) : progressCB_(cb), cbId_(cbId) {}
+        CallBackInfo(std::function<void(CProgress)> cb, CFunc cbId, bool borrowed)
+            : progressCB_(cb), cbId_(cbId), borrowed_(borrowed)
+        {
+        }
 
-        CallBackInfo(std::function<void(CResponse)> cb, CFunc cbId) : responseCB_(cb), cbId_(cbId) {}
+        CallBackInfo(std::function<void(CResponse)> cb, CFunc cbId, bool borrowed)
+            : responseCB_(cb), cbId_(cbId), borrowed_(borrowed)
+        {
+        }
     };
 
 protected:
     bool IsListenerAdded(void *cb);
     void OnMessageReceive(const std::shared_ptr<NotifyData> &notifyData);
     void OnMessageReceive(const std::shared_ptr<Response> &response);
-    void AddListenerInner(std::function<void(CProgress)> &cb, CFunc cbId);
-    void AddListenerInner(std::function<void(CResponse)> &cb, CFunc cbId);
+    void AddListenerInner(std::function<void(CProgress)> &cb, CFunc cbId, bool borrowed);
+    void AddListenerInner(std::function<void(CResponse)> &cb, CFunc cbId, bool borrowed);
     void RemoveListenerInner(CFunc cb);
 
 protected:
@@ -62,6 +72,10 @@ protected:
     std::recursive_mutex allCbMutex_;
     std::list<std::pair<bool, std::shared_ptr<CallBackInfo>>> allCb_;
     std::atomic<uint32_t> validCbNum{0};
+    // Payloads of the borrowing callbacks, built once per message. Guarded by `allCbMutex_`.
+    CJPayloadArena arena_;
+    // Calls the callbacks off the receiving thread.
+    std::shared_ptr<OHOS::Request::NotifyDelivery> delivery_ = std::make_shared<OHOS::Request::NotifyDelivery>();
 };
 } // namespace OHOS::CJSystemapi::Request
 #endif // OHOS_REQUEST_CJ_LISTENER_LIST_H
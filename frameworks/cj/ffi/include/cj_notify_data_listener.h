@@ -33,7 +33,7 @@ public:
     CJNotifyDataListener(const std::string &taskId, const SubscribeType &type) : ListenerList(taskId, type)
     {
     }
-    void AddListener(std::function<void(CProgress)> cb, CFunc cbId);
+    void AddListener(std::function<void(CProgress)> cb, CFunc cbId, bool borrowed = false);
     void RemoveListener(CFunc cbId = nullptr);
     void OnNotifyDataReceive(const std::shared_ptr<NotifyData> &notifyData) override;
     void OnFaultsReceive(const std::shared_ptr<int32_t> &tid, const std::shared_ptr<SubscribeType> &type,
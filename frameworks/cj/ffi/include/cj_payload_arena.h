@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_REQUEST_CJ_PAYLOAD_ARENA_H
+#define OHOS_REQUEST_CJ_PAYLOAD_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace OHOS::CJSystemapi::Request {
+
+// Memory of the C payloads passed to borrowing callbacks. Everything allocated is released at once by
+// `Reset` once the callbacks have returned, and the blocks are kept for the next message of the listener.
+class CJPayloadArena {
+public:
+    CJPayloadArena() = default;
+    CJPayloadArena(const CJPayloadArena &) = delete;
+    CJPayloadArena &operator=(const CJPayloadArena &) = delete;
+
+    // Returns uninitialized memory aligned for any type, nullptr if `size` is 0 or out of memory.
+    void *Alloc(size_t size);
+    template<typename T> T *AllocArray(size_t count)
+    {
+        if (count > SIZE_MAX / sizeof(T)) {
+            return nullptr;
+        }
+        return static_cast<T *>(Alloc(sizeof(T) * count));
+    }
+    // Same as `MallocCString`: nullptr for an empty string.
+    char *CopyString(const std::string &str);
+    void Reset();
+
+private:
+    bool NextBlock();
+
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    // Allocations larger than a block, freed by `Reset`.
+    std::vector<std::unique_ptr<char[]>> large_;
+    size_t nextBlock_ = 0;
+    char *cursor_ = nullptr;
+    char *end_ = nullptr;
+};
+
+} // namespace OHOS::CJSystemapi::Request
+#endif // OHOS_REQUEST_CJ_PAYLOAD_ARENA_H
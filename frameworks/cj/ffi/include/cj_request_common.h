@@ -19,6 +19,7 @@
 #include <string>
 #include <vector>
 
+#include "cj_payload_arena.h"
 #include "cj_request_ffi.h"
 #include "constant.h"
 #include "request_common.h"
@@ -41,6 +42,9 @@ void RemoveFile(const std::string &filePath);
 
 CProgress Convert2CProgress(const Progress &in);
 CResponse Convert2CResponse(const std::shared_ptr<Response> &in);
+// Same as above with the payload allocated from `arena`, valid until it is reset.
+CProgress Convert2CProgress(const Progress &in, CJPayloadArena &arena);
+CResponse Convert2CResponse(const std::shared_ptr<Response> &in, CJPayloadArena &arena);
 std::string GetSaveas(const std::vector<FileSpec> &files, Action action);
 uint32_t Convert2Broken(Reason code);
 std::string Convert2ReasonMsg(Reason code);
@@ -195,6 +195,21 @@ typedef struct {
     RetError err;
 } RetReqData;
 
+typedef struct {
+    CConfig *head;
+    int64_t size;
+} CConfigArr;
+
+typedef struct {
+    RetReqData *head;
+    int64_t size;
+} RetReqDataArr;
+
+typedef struct {
+    RetError err;
+    RetReqDataArr tasks;
+} RetReqDataBatch;
+
 typedef struct {
     RetError err;
     CTaskInfo task;
@@ -217,12 +232,15 @@ typedef struct {
 
 FFI_EXPORT void FfiOHOSRequestFreeTask(const char *taskId);
 FFI_EXPORT RetError FfiOHOSRequestTaskProgressOn(char *event, const char *taskId, void *callback);
+// The payload passed to `callback` is only valid until it returns.
+FFI_EXPORT RetError FfiOHOSRequestTaskProgressOnBorrowed(char *event, const char *taskId, void *callback);
 FFI_EXPORT RetError FfiOHOSRequestTaskProgressOff(char *event, const char *taskId, void *callback);
 FFI_EXPORT RetError FfiOHOSRequestTaskStart(const char *taskId);
 FFI_EXPORT RetError FfiOHOSRequestTaskPause(const char *taskId);
 FFI_EXPORT RetError FfiOHOSRequestTaskResume(const char *taskId);
 FFI_EXPORT RetError FfiOHOSRequestTaskStop(const char *taskId);
 FFI_EXPORT RetReqData FfiOHOSRequestCreateTask(void *context, CConfig config);
+FFI_EXPORT RetReqDataBatch FfiOHOSRequestCreateTasks(void *context, CConfigArr configs);
 FFI_EXPORT RetTask FfiOHOSRequestGetTask(void *context, const char *taskId, RequestNativeOptionCString token);
 FFI_EXPORT RetError FfiOHOSRequestRemoveTask(const char *taskId);
 FFI_EXPORT RetTaskInfo FfiOHOSRequestShowTask(const char *taskId);
@@ -43,6 +43,7 @@ public:
     ~CJRequestImpl() = default;
 
     static RetReqData CreateTask(OHOS::AbilityRuntime::Context *context, CConfig *ffiConfig);
+    static RetReqDataBatch CreateTasks(OHOS::AbilityRuntime::Context *context, CConfigArr &ffiConfigs);
     static RetTask GetTask(OHOS::AbilityRuntime::Context *context, std::string taskId,
                            RequestNativeOptionCString &cToken);
     static void FreeTask(std::string taskId);
@@ -51,7 +52,7 @@ public:
     static RetTaskInfo TouchTask(std::string taskId, const char *token);
     static RetTaskArr SearchTask(CFilter &filter);
     static ExceptionError Convert2Filter(CFilter &filter, Filter &out);
-    static RetError ProgressOn(char *event, std::string taskId, void *callback);
+    static RetError ProgressOn(char *event, std::string taskId, void *callback, bool borrowed = false);
     static RetError ProgressOff(char *event, std::string taskId, void *callback);
     static RetError TaskStart(std::string taskId);
     static RetError TaskPause(std::string taskId);
@@ -60,11 +60,8 @@ public:
     static CJRequestTask *ClearTaskMap(const std::string &key);
     static void ClearTaskTemp(const std::string &tid, bool isRmFiles, bool isRmAcls, bool isRmCertsAcls);
 
-    static std::mutex pathMutex_;
-    static std::map<std::string, int32_t> pathMap_;
-    static void AddPathMap(const std::string &filepath, const std::string &baseDir);
+    static std::vector<std::string> ParentDirs(const std::string &filepath, const std::string &baseDir);
     static void RemovePathMap(const std::string &filepath);
-    static void ResetDirAccess(const std::string &filepath);
     static void RemoveDirsPermission(const std::vector<std::string> &dirs);
 
     static bool register_;
@@ -77,7 +74,10 @@ public:
     void SetTid();
 
     ExceptionError Create(OHOS::AbilityRuntime::Context *context, Config &config);
-    ExceptionError On(std::string type, std::string &taskId, void *callback);
+    // Registers a task the service created with `taskId_`.
+    void FinishCreate();
+    // `borrowed` callbacks get payloads valid only until they return, freed by the listener.
+    ExceptionError On(std::string type, std::string &taskId, void *callback, bool borrowed = false);
     ExceptionError Off(std::string event, CFunc callback);
 
     static void ReloadListener();
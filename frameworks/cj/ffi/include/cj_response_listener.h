@@ -33,7 +33,7 @@ class CJResponseListener : public OHOS::Request::IResponseListener,
 public:
     explicit CJResponseListener(const std::string &taskId) : ListenerList(taskId, SubscribeType::RESPONSE) {}
 
-    void AddListener(std::function<void(CResponse)> cb, CFunc cbId);
+    void AddListener(std::function<void(CResponse)> cb, CFunc cbId, bool borrowed = false);
     void RemoveListener(CFunc cbId = nullptr);
     void OnResponseReceive(const std::shared_ptr<Response> &response) override;
 
@@ -30,6 +30,7 @@
 #include "request_common.h"
 #include "request_manager.h"
 #include "sys_event.h"
+#include "url_view.h"
 #include "securec.h"
 #include "file_uri.h"
 
@@ -62,28 +63,7 @@ static const std::string AREA5 = "/data/storage/el5/base";
 
 std::string GetHostnameFromURL(const std::string &url)
 {
-    if (url.empty()) {
-        return "";
-    }
-    std::string delimiter = "://";
-    std::string tempUrl = url;
-    std::replace(tempUrl.begin(), tempUrl.end(), '\\', '/');
-    size_t posStart = tempUrl.find(delimiter);
-    if (posStart != std::string::npos) {
-        posStart += delimiter.length();
-    } else {
-        posStart = 0;
-    }
-    size_t notSlash = tempUrl.find_first_not_of('/', posStart);
-    if (notSlash != std::string::npos) {
-        posStart = notSlash;
-    }
-    size_t posEnd =
-        std::min({ tempUrl.find(':', posStart), tempUrl.find('/', posStart), tempUrl.find('?', posStart) });
-    if (posEnd != std::string::npos) {
-        return tempUrl.substr(posStart, posEnd - posStart);
-    }
-    return tempUrl.substr(posStart);
+    return std::string(ParseUrlView(url).host);
 }
 
 ExceptionError CJInitialize::ParseBundleName(const std::shared_ptr<OHOS::AbilityRuntime::Context> &context,
@@ -148,32 +128,12 @@ bool CJInitialize::ParseCertsPath(std::string &url, std::vector<std::string> &ce
         return false;
     }
 
-    typedef std::string::const_iterator iter_t;
-    iter_t urlEnd = url.end();
-    iter_t protocolStart = url.cbegin();
-    iter_t protocolEnd = std::find(protocolStart, urlEnd, ':');
-    std::string protocol = std::string(protocolStart, protocolEnd);
-    if (protocol != "https") {
+    UrlView view = ParseUrlView(url);
+    if (view.scheme != "https") {
         REQUEST_HILOGD("Using Http");
         return true;
     }
-    if (protocolEnd != urlEnd) {
-        std::string afterProtocol = &*(protocolEnd);
-        // 3 is the num of ://
-        if ((afterProtocol.length() > 3) && (afterProtocol.substr(0, 3) == "://")) {
-            // 3 means go beyound :// in protocolEnd
-            protocolEnd += 3;
-        } else {
-            protocolEnd = url.cbegin();
-        }
-    } else {
-        protocolEnd = url.cbegin();
-    }
-    iter_t hostStart = protocolEnd;
-    iter_t pathStart = std::find(hostStart, urlEnd, '/');
-    iter_t queryStart = std::find(url.cbegin(), urlEnd, '?');
-    iter_t hostEnd = std::find(protocolEnd, (pathStart != urlEnd) ? pathStart : queryStart, ':');
-    std::string hostname = std::string(hostStart, hostEnd);
+    std::string hostname(view.host);
     REQUEST_HILOGD("Hostname is %{public}s", hostname.c_str());
     NetManagerStandard::NetworkSecurityConfig::GetInstance().GetTrustAnchorsForHostName(hostname, certsPath);
 
@@ -18,25 +18,25 @@
 
 namespace OHOS::CJSystemapi::Request {
 
-void ListenerList::AddListenerInner(std::function<void(CProgress)> &cb, CFunc cbId)
+void ListenerList::AddListenerInner(std::function<void(CProgress)> &cb, CFunc cbId, bool borrowed)
 {
     std::lock_guard<std::recursive_mutex> lock(allCbMutex_);
     if (this->IsListenerAdded(cbId)) {
         return;
     }
 
-    this->allCb_.push_back(std::make_pair(true, std::make_shared<CallBackInfo>(cb, cbId)));
+    this->allCb_.push_back(std::make_pair(true, std::make_shared<CallBackInfo>(cb, cbId, borrowed)));
     ++this->validCbNum;
 }
 
-void ListenerList::AddListenerInner(std::function<void(CResponse)> &cb, CFunc cbId)
+void ListenerList::AddListenerInner(std::function<void(CResponse)> &cb, CFunc cbId, bool borrowed)
 {
     std::lock_guard<std::recursive_mutex> lock(allCbMutex_);
     if (this->IsListenerAdded(cbId)) {
         return;
     }
 
-    this->allCb_.push_back(std::make_pair(true, std::make_shared<CallBackInfo>(cb, cbId)));
+    this->allCb_.push_back(std::make_pair(true, std::make_shared<CallBackInfo>(cb, cbId, borrowed)));
     ++this->validCbNum;
 }
 
@@ -69,27 +69,49 @@ void ListenerList::RemoveListenerInner(CFunc cb)
 void ListenerList::OnMessageReceive(const std::shared_ptr<NotifyData> &notifyData)
 {
     std::lock_guard<std::recursive_mutex> lock(allCbMutex_);
+    bool built = false;
+    CProgress borrowed = {0};
     for (auto it = this->allCb_.begin(); it != this->allCb_.end();) {
         if (it->first == false) {
             it = this->allCb_.erase(it);
             continue;
         }
-        it->second->progressCB_(Convert2CProgress(notifyData->progress));
+        if (!it->second->borrowed_) {
+            it->second->progressCB_(Convert2CProgress(notifyData->progress));
+        } else {
+            if (!built) {
+                borrowed = Convert2CProgress(notifyData->progress, arena_);
+                built = true;
+            }
+            it->second->progressCB_(borrowed);
+        }
         it++;
     }
+    arena_.Reset();
 }
 
 void ListenerList::OnMessageReceive(const std::shared_ptr<Response> &response)
 {
     std::lock_guard<std::recursive_mutex> lock(allCbMutex_);
+    bool built = false;
+    CResponse borrowed = {0};
     for (auto it = this->allCb_.begin(); it != this->allCb_.end();) {
         if (it->first == false) {
             it = this->allCb_.erase(it);
             continue;
         }
-        it->second->responseCB_(Convert2CResponse(response));
+        if (!it->second->borrowed_) {
+            it->second->responseCB_(Convert2CResponse(response));
+        } else {
+            if (!built) {
+                borrowed = Convert2CResponse(response, arena_);
+                built = true;
+            }
+            it->second->responseCB_(borrowed);
+        }
         it++;
     }
+    arena_.Reset();
 }
 
 bool ListenerList::IsListenerAdded(void *cb)
@@ -27,9 +27,9 @@ using OHOS::Request::RequestManager;
 using OHOS::Request::State;
 using OHOS::Request::Version;
 
-void CJNotifyDataListener::AddListener(std::function<void(CProgress)> cb, CFunc cbId)
+void CJNotifyDataListener::AddListener(std::function<void(CProgress)> cb, CFunc cbId, bool borrowed)
 {
-    this->AddListenerInner(cb, cbId);
+    this->AddListenerInner(cb, cbId, borrowed);
     /* remove listener must be subscribed to free task */
     if (this->validCbNum == 1 && this->type_ != SubscribeType::REMOVE) {
         RequestManager::GetInstance()->AddListener(this->taskId_, this->type_, shared_from_this());
@@ -41,6 +41,7 @@ void CJNotifyDataListener::RemoveListener(CFunc cbId)
     this->RemoveListenerInner(cbId);
     if (this->validCbNum == 0 && this->type_ != SubscribeType::REMOVE) {
         RequestManager::GetInstance()->RemoveListener(this->taskId_, this->type_, shared_from_this());
+        this->delivery_->Cancel();
     }
 }
 
@@ -103,9 +104,14 @@ static void RemoveJSTask(const std::shared_ptr<NotifyData> &notifyData)
 
 void CJNotifyDataListener::OnNotifyDataReceive(const std::shared_ptr<NotifyData> &notifyData)
 {
-    this->NotifyDataProcess(notifyData);
-    this->OnMessageReceive(notifyData);
-    RemoveJSTask(notifyData);
+    std::shared_ptr<CJNotifyDataListener> self = shared_from_this();
+    this->delivery_->Push(
+        [self, notifyData]() {
+            self->NotifyDataProcess(notifyData);
+            self->OnMessageReceive(notifyData);
+            RemoveJSTask(notifyData);
+        },
+        OHOS::Request::IsIntermediateProgress(notifyData));
 }
 
 void CJNotifyDataListener::OnFaultsReceive(const std::shared_ptr<int32_t> &tid,
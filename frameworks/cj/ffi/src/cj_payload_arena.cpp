@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cj_payload_arena.h"
+
+#include <cstring>
+#include <new>
+#include <utility>
+
+namespace OHOS::CJSystemapi::Request {
+
+static constexpr size_t BLOCK_SIZE = 4096;
+// Blocks kept by `Reset`, a message needing more gives the rest back.
+static constexpr size_t KEPT_BLOCKS = 4;
+static constexpr size_t ALIGN = alignof(std::max_align_t);
+
+void *CJPayloadArena::Alloc(size_t size)
+{
+    if (size == 0 || size > SIZE_MAX - ALIGN) {
+        return nullptr;
+    }
+    size = (size + ALIGN - 1) / ALIGN * ALIGN;
+    if (size > BLOCK_SIZE) {
+        std::unique_ptr<char[]> large(new (std::nothrow) char[size]);
+        if (large == nullptr) {
+            return nullptr;
+        }
+        large_.push_back(std::move(large));
+        return large_.back().get();
+    }
+    if (static_cast<size_t>(end_ - cursor_) < size && !NextBlock()) {
+        return nullptr;
+    }
+    void *ret = cursor_;
+    cursor_ += size;
+    return ret;
+}
+
+char *CJPayloadArena::CopyString(const std::string &str)
+{
+    if (str.empty()) {
+        return nullptr;
+    }
+    char *ret = static_cast<char *>(Alloc(str.size() + 1));
+    if (ret == nullptr) {
+        return nullptr;
+    }
+    memcpy(ret, str.c_str(), str.size() + 1);
+    return ret;
+}
+
+void CJPayloadArena::Reset()
+{
+    large_.clear();
+    if (blocks_.size() > KEPT_BLOCKS) {
+        blocks_.resize(KEPT_BLOCKS);
+    }
+    nextBlock_ = 0;
+    cursor_ = nullptr;
+    end_ = nullptr;
+}
+
+bool CJPayloadArena::NextBlock()
+{
+    if (nextBlock_ == blocks_.size()) {
+        std::unique_ptr<char[]> block(new (std::nothrow) char[BLOCK_SIZE]);
+        if (block == nullptr) {
+            return false;
+        }
+        blocks_.push_back(std::move(block));
+    }
+    cursor_ = blocks_[nextBlock_++].get();
+    end_ = cursor_ + BLOCK_SIZE;
+    return true;
+}
+
+} // namespace OHOS::CJSystemapi::Request
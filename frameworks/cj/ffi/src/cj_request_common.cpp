@@ -15,6 +15,7 @@
 
 #include "cj_request_common.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <fstream>
 #include <sstream>
@@ -217,17 +218,18 @@ CResponse Convert2CResponse(const std::shared_ptr<Response> &in)
     out.statusCode = in->statusCode;
     out.reason = MallocCString(in->reason);
 
-    if (in->headers.size() <= 0) {
+    const auto &headers = in->GetHeaders();
+    if (headers.size() <= 0) {
         return out;
     }
     CHttpHeaderHashPair *hashHead =
-        static_cast<CHttpHeaderHashPair *>(malloc(sizeof(CHttpHeaderHashPair) * in->headers.size()));
+        static_cast<CHttpHeaderHashPair *>(malloc(sizeof(CHttpHeaderHashPair) * headers.size()));
     if (hashHead == nullptr) {
         return out;
     }
 
     int64_t index = 0;
-    for (auto iter : in->headers) {
+    for (const auto &iter : headers) {
         hashHead[index].key = MallocCString(iter.first);
         hashHead[index].value = Convert2CArrString(iter.second);
         index++;
@@ -237,6 +239,63 @@ CResponse Convert2CResponse(const std::shared_ptr<Response> &in)
     return out;
 }
 
+CProgress Convert2CProgress(const Progress &in, CJPayloadArena &arena)
+{
+    CProgress out = {0};
+    out.state = static_cast<uint32_t>(in.state);
+    out.index = in.index;
+    out.processed = in.processed;
+
+    out.sizeArr = arena.AllocArray<int64_t>(in.sizes.size());
+    if (out.sizeArr != nullptr) {
+        std::copy(in.sizes.begin(), in.sizes.end(), out.sizeArr);
+        out.sizeArrLen = static_cast<int64_t>(in.sizes.size());
+    }
+
+    out.extras.headers = arena.AllocArray<CHashStrPair>(in.extras.size());
+    if (out.extras.headers == nullptr) {
+        return out;
+    }
+    int64_t index = 0;
+    for (const auto &iter : in.extras) {
+        CHashStrPair *elem = &out.extras.headers[index++];
+        elem->key = arena.CopyString(iter.first);
+        elem->value = arena.CopyString(iter.second);
+    }
+    out.extras.size = index;
+    return out;
+}
+
+CResponse Convert2CResponse(const std::shared_ptr<Response> &in, CJPayloadArena &arena)
+{
+    CResponse out = {0};
+    out.version = arena.CopyString(in->version);
+    out.statusCode = in->statusCode;
+    out.reason = arena.CopyString(in->reason);
+
+    const auto &headers = in->GetHeaders();
+    CHttpHeaderHashPair *hashHead = arena.AllocArray<CHttpHeaderHashPair>(headers.size());
+    if (hashHead == nullptr) {
+        return out;
+    }
+    int64_t index = 0;
+    for (const auto &iter : headers) {
+        hashHead[index].key = arena.CopyString(iter.first);
+        CArrString &value = hashHead[index].value;
+        value = {};
+        value.head = arena.AllocArray<char *>(iter.second.size());
+        if (value.head != nullptr) {
+            for (const auto &str : iter.second) {
+                value.head[value.size++] = arena.CopyString(str);
+            }
+        }
+        index++;
+    }
+    out.headers.hashHead = hashHead;
+    out.headers.size = index;
+    return out;
+}
+
 void RemoveFile(const std::string &filePath)
 {
     auto removeFile = [filePath]() -> void {
@@ -291,6 +350,8 @@ uint32_t Convert2Broken(Reason code)
         {Reason::NETWORK_ACCOUNT, Faults::DISCONNECTED},
         {Reason::APP_ACCOUNT, Faults::OTHERS},
         {Reason::NETWORK_APP_ACCOUNT, Faults::DISCONNECTED},
+        {Reason::CHECKSUM_MISMATCH, Faults::FSIO},
+        {Reason::BODY_TOO_LARGE, Faults::OTHERS},
     };
     constexpr const int32_t detailVersion = 12;
     auto iter = InnerCodeToBroken.find(code);
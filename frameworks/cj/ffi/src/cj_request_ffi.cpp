@@ -33,6 +33,11 @@ RetError FfiOHOSRequestTaskProgressOn(char *event, const char *taskId, void *cal
     return CJRequestImpl::ProgressOn(event, taskId, callback);
 }
 
+RetError FfiOHOSRequestTaskProgressOnBorrowed(char *event, const char *taskId, void *callback)
+{
+    return CJRequestImpl::ProgressOn(event, taskId, callback, true);
+}
+
 RetError FfiOHOSRequestTaskProgressOff(char *event, const char *taskId, void *callback)
 {
     return CJRequestImpl::ProgressOff(event, taskId, callback);
@@ -63,6 +68,11 @@ RetReqData FfiOHOSRequestCreateTask(void *context, CConfig config)
     return CJRequestImpl::CreateTask((OHOS::AbilityRuntime::Context *)context, &config);
 }
 
+RetReqDataBatch FfiOHOSRequestCreateTasks(void *context, CConfigArr configs)
+{
+    return CJRequestImpl::CreateTasks((OHOS::AbilityRuntime::Context *)context, configs);
+}
+
 RetTask FfiOHOSRequestGetTask(void *context, const char *taskId, RequestNativeOptionCString token)
 {
     return CJRequestImpl::GetTask((OHOS::AbilityRuntime::Context *)context, taskId, token);
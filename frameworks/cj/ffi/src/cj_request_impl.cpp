@@ -16,7 +16,9 @@
 #include "cj_request_impl.h"
 
 #include <cstdint>
+#include <cstdlib>
 #include <string>
+#include <vector>
 #include "cj_initialize.h"
 #include "cj_request_common.h"
 #include "cj_request_event.h"
@@ -24,6 +26,7 @@
 #include "cj_request_task.h"
 #include "constant.h"
 #include "log.h"
+#include "request_manager.h"
 
 namespace OHOS::CJSystemapi::Request {
 using OHOS::Request::E_FILE_IO_INFO;
@@ -45,9 +48,12 @@ using OHOS::Request::FUNCTION_RESUME;
 using OHOS::Request::FUNCTION_START;
 using OHOS::Request::FUNCTION_STOP;
 using OHOS::Request::Reason;
+using OHOS::Request::RequestManager;
 using OHOS::Request::TaskInfo;
+using OHOS::Request::TaskRet;
 using OHOS::Request::Version;
 
+static constexpr int64_t CREATE_BATCH_MAX = 100;
 static constexpr const char *NOT_SYSTEM_APP = "permission verification failed, application which is not a system "
                                               "application uses system API";
 static const std::map<ExceptionErrorCode, std::string> ErrorCodeToMsg{
@@ -221,6 +227,79 @@ RetReqData CJRequestImpl::CreateTask(OHOS::AbilityRuntime::Context *context, CCo
     return ret;
 }
 
+RetReqDataBatch CJRequestImpl::CreateTasks(OHOS::AbilityRuntime::Context *context, CConfigArr &ffiConfigs)
+{
+    REQUEST_HILOGD("[CJRequestImpl] CreateTasks start");
+    RetReqDataBatch ret{};
+    if (ffiConfigs.size <= 0 || ffiConfigs.size > CREATE_BATCH_MAX || ffiConfigs.head == nullptr) {
+        ret.err = Convert2RetErr(ExceptionErrorCode::E_PARAMETER_CHECK);
+        return ret;
+    }
+    size_t size = static_cast<size_t>(ffiConfigs.size);
+    ret.tasks.head = static_cast<RetReqData *>(calloc(size, sizeof(RetReqData)));
+    if (ret.tasks.head == nullptr) {
+        ret.err = Convert2RetErr(ExceptionErrorCode::E_OTHER);
+        return ret;
+    }
+    ret.tasks.size = ffiConfigs.size;
+
+    // Configs are still parsed one by one, the service creates the valid ones in a single call.
+    std::vector<Config> configs;
+    std::vector<CJRequestTask *> tasks;
+    std::vector<size_t> indexes;
+    configs.reserve(size);
+    tasks.reserve(size);
+    indexes.reserve(size);
+    for (size_t i = 0; i < size; i++) {
+        Config config{};
+        Convert2Config(&ffiConfigs.head[i], config);
+        ExceptionError result = CJInitialize::ParseConfig(context, &ffiConfigs.head[i], config);
+        if (result.code != 0) {
+            ret.tasks.head[i].err = Convert2RetErr(result);
+            continue;
+        }
+        CJRequestTask *task = new (std::nothrow) CJRequestTask();
+        if (task == nullptr) {
+            REQUEST_HILOGE("[CJRequestImpl] Fail to create task.");
+            ret.tasks.head[i].err.errCode = ExceptionErrorCode::E_OTHER;
+            continue;
+        }
+        if (config.mode == Mode::FOREGROUND) {
+            CJRequestTask::RegisterForegroundResume();
+        }
+        task->config_ = config;
+        configs.push_back(std::move(config));
+        tasks.push_back(task);
+        indexes.push_back(i);
+    }
+    if (configs.empty()) {
+        return ret;
+    }
+
+    RequestManager::GetInstance()->RestoreListener(CJRequestTask::ReloadListener);
+    std::vector<TaskRet> rets;
+    ExceptionErrorCode code = RequestManager::GetInstance()->CreateTasks(configs, rets);
+    for (size_t j = 0; j < tasks.size(); j++) {
+        RetReqData &out = ret.tasks.head[indexes[j]];
+        ExceptionErrorCode taskCode = code;
+        if (taskCode == ExceptionErrorCode::E_OK) {
+            taskCode = j < rets.size() ? rets[j].code : ExceptionErrorCode::E_SERVICE_ERROR;
+        }
+        if (taskCode != ExceptionErrorCode::E_OK) {
+            REQUEST_HILOGE("[CJRequestImpl] task create failed, ret:%{public}d.", taskCode);
+            delete tasks[j];
+            out.err = Convert2RetErr(taskCode);
+            continue;
+        }
+        tasks[j]->taskId_ = rets[j].tid;
+        tasks[j]->FinishCreate();
+        out.taskId = MallocCString(tasks[j]->taskId_);
+    }
+
+    REQUEST_HILOGD("[CJRequestImpl] CreateTasks end");
+    return ret;
+}
+
 ExceptionError CJRequestImpl::ParseToken(RequestNativeOptionCString &cToken, std::string &out)
 {
     ExceptionError err = {.code = ExceptionErrorCode::E_OK};
@@ -444,7 +523,7 @@ void CJRequestImpl::FreeTask(std::string taskId)
     delete CJRequestTask::ClearTaskMap(taskId);
 }
 
-RetError CJRequestImpl::ProgressOn(char *event, std::string taskId, void *callback)
+RetError CJRequestImpl::ProgressOn(char *event, std::string taskId, void *callback, bool borrowed)
 {
     REQUEST_HILOGD("[CJRequestImpl] ProgressOn start");
     RetError ret{};
@@ -454,7 +533,7 @@ RetError CJRequestImpl::ProgressOn(char *event, std::string taskId, void *callba
         return Convert2RetErr(ExceptionErrorCode::E_TASK_NOT_FOUND);
     }
 
-    ExceptionError result = task->On(event, taskId, callback);
+    ExceptionError result = task->On(event, taskId, callback, borrowed);
     if (result.code != 0) {
         REQUEST_HILOGE("[CJRequestImpl] task on failed, ret:%{public}d.", result.code);
         return Convert2RetErr(result);
@@ -21,6 +21,7 @@
 #include <regex>
 #include <string>
 #include <sys/stat.h>
+#include "acl_grant_table.h"
 #include "application_context.h"
 #include "cj_app_state_callback.h"
 #include "cj_application_context.h"
@@ -34,27 +35,22 @@
 #include "log.h"
 #include "request_manager.h"
 #include "securec.h"
-#include "storage_acl.h"
 
 namespace OHOS::CJSystemapi::Request {
 namespace fs = std::filesystem;
 using OHOS::AbilityRuntime::Context;
+using OHOS::Request::AclGrantTable;
 using OHOS::Request::Action;
 using OHOS::Request::ExceptionErrorCode;
 using OHOS::Request::RequestManager;
 using OHOS::Request::TaskInfo;
 using OHOS::Request::Version;
-using OHOS::StorageDaemon::AclSetAccess;
 
 std::mutex CJRequestTask::taskMutex_;
 std::map<std::string, CJRequestTask *> CJRequestTask::taskMap_;
 
-std::mutex CJRequestTask::pathMutex_;
-std::map<std::string, int32_t> CJRequestTask::pathMap_;
-
 bool CJRequestTask::register_ = false;
 
-static constexpr int ACL_SUCC = 0;
 static const std::string SA_PERMISSION_RWX = "g:3815:rwx";
 static const std::string SA_PERMISSION_X = "g:3815:x";
 static const std::string SA_PERMISSION_CLEAN = "g:3815:---";
@@ -127,20 +123,14 @@ bool CJRequestTask::SetPathPermission(const std::string &filepath)
         }
     }
 
-    AddPathMap(filepath, baseDir);
-    {
-        std::lock_guard<std::mutex> lockGuard(pathMutex_);
-        for (auto it : pathMap_) {
-            if (it.second <= 0) {
-                continue;
-            }
-            if (AclSetAccess(it.first, SA_PERMISSION_X) != ACL_SUCC) {
-                REQUEST_HILOGE("AclSetAccess Parent Dir Failed.");
-            }
+    for (const auto &dir : ParentDirs(filepath, baseDir)) {
+        if (!AclGrantTable::Acquire(dir, SA_PERMISSION_X)) {
+            REQUEST_HILOGE("AclSetAccess Parent Dir Failed.");
         }
     }
 
-    if (AclSetAccess(filepath, SA_PERMISSION_RWX) != ACL_SUCC) {
+    // The file may have been created again since its last grant.
+    if (!AclGrantTable::Acquire(filepath, SA_PERMISSION_RWX, true)) {
         REQUEST_HILOGE("AclSetAccess Child Dir Failed.");
         return false;
     }
@@ -190,29 +180,15 @@ bool CJRequestTask::SetDirsPermission(std::vector<std::string> &dirs)
     return true;
 }
 
-void CJRequestTask::AddPathMap(const std::string &filepath, const std::string &baseDir)
+std::vector<std::string> CJRequestTask::ParentDirs(const std::string &filepath, const std::string &baseDir)
 {
+    std::vector<std::string> dirs;
     std::string childDir(filepath);
-    std::string parentDir;
     while (childDir.length() > baseDir.length()) {
-        parentDir = childDir.substr(0, childDir.rfind("/"));
-        std::lock_guard<std::mutex> lockGuard(CJRequestTask::pathMutex_);
-        auto it = pathMap_.find(parentDir);
-        if (it == pathMap_.end()) {
-            pathMap_[parentDir] = 1;
-        } else {
-            pathMap_[parentDir] += 1;
-        }
-        childDir = parentDir;
-    }
-}
-
-void CJRequestTask::ResetDirAccess(const std::string &filepath)
-{
-    int ret = AclSetAccess(filepath, SA_PERMISSION_CLEAN);
-    if (ret != ACL_SUCC) {
-        REQUEST_HILOGE("AclSetAccess Reset Dir Failed: %{public}s", filepath.c_str());
+        childDir = childDir.substr(0, childDir.rfind("/"));
+        dirs.push_back(childDir);
     }
+    return dirs;
 }
 
 void CJRequestTask::RemovePathMap(const std::string &filepath)
@@ -227,21 +203,13 @@ void CJRequestTask::RemovePathMap(const std::string &filepath)
         REQUEST_HILOGE("File remove WOTH access Failed.");
     }
 
-    std::string childDir(filepath);
-    std::string parentDir;
-    while (childDir.length() > baseDir.length()) {
-        parentDir = childDir.substr(0, childDir.rfind("/"));
-        std::lock_guard<std::mutex> lockGuard(CJRequestTask::pathMutex_);
-        auto it = pathMap_.find(parentDir);
-        if (it != pathMap_.end()) {
-            if (pathMap_[parentDir] <= 1) {
-                pathMap_.erase(parentDir);
-                ResetDirAccess(parentDir);
-            } else {
-                pathMap_[parentDir] -= 1;
-            }
+    if (!AclGrantTable::Release(filepath, SA_PERMISSION_CLEAN)) {
+        REQUEST_HILOGE("AclSetAccess Reset File Failed: %{public}s", filepath.c_str());
+    }
+    for (const auto &dir : ParentDirs(filepath, baseDir)) {
+        if (!AclGrantTable::Release(dir, SA_PERMISSION_CLEAN)) {
+            REQUEST_HILOGE("AclSetAccess Reset Dir Failed: %{public}s", dir.c_str());
         }
-        childDir = parentDir;
     }
 }
 
@@ -291,6 +259,12 @@ ExceptionError CJRequestTask::Create(Context *context, Config &config)
         return err;
     }
 
+    FinishCreate();
+    return err;
+}
+
+void CJRequestTask::FinishCreate()
+{
     SetTid();
     {
         std::unique_lock<std::recursive_mutex> lock(listenerMutex_);
@@ -300,8 +274,6 @@ ExceptionError CJRequestTask::Create(Context *context, Config &config)
             notifyDataListenerMap_[SubscribeType::REMOVE]);
     }
     AddTaskMap(GetTidStr(), this);
-
-    return err;
 }
 
 ExceptionError CJRequestTask::GetTask(OHOS::AbilityRuntime::Context *context, std::string &taskId, std::string &token,
@@ -370,7 +342,7 @@ void CJRequestTask::ReloadListener()
     }
 }
 
-ExceptionError CJRequestTask::On(std::string type, std::string &taskId, void *callback)
+ExceptionError CJRequestTask::On(std::string type, std::string &taskId, void *callback, bool borrowed)
 {
     int32_t seq = RequestManager::GetInstance()->GetNextSeq();
     REQUEST_HILOGI("Begin task on, seq: %{public}d", seq);
@@ -390,7 +362,7 @@ ExceptionError CJRequestTask::On(std::string type, std::string &taskId, void *ca
                 responseListener_ = std::make_shared<CJResponseListener>(GetTidStr());
             }
         }
-        responseListener_->AddListener(CJLambda::Create((void (*)(CResponse progress))callback), callback);
+        responseListener_->AddListener(CJLambda::Create((void (*)(CResponse progress))callback), callback, borrowed);
     } else {
         std::unique_lock<std::recursive_mutex> lock(listenerMutex_);
         auto listener = notifyDataListenerMap_.find(subscribeType);
@@ -398,7 +370,7 @@ ExceptionError CJRequestTask::On(std::string type, std::string &taskId, void *ca
             notifyDataListenerMap_[subscribeType] = std::make_shared<CJNotifyDataListener>(GetTidStr(), subscribeType);
         }
         notifyDataListenerMap_[subscribeType]->AddListener(CJLambda::Create((void (*)(CProgress progress))callback),
-            (CFunc)callback);
+            (CFunc)callback, borrowed);
     }
 
     REQUEST_HILOGI("End task on event %{public}s successfully, seq: %{public}d, tid: %{public}s", type.c_str(), seq,
@@ -21,9 +21,9 @@ namespace OHOS::CJSystemapi::Request {
 
 using OHOS::Request::RequestManager;
 
-void CJResponseListener::AddListener(std::function<void(CResponse)> cb, CFunc cbId)
+void CJResponseListener::AddListener(std::function<void(CResponse)> cb, CFunc cbId, bool borrowed)
 {
-    this->AddListenerInner(cb, cbId);
+    this->AddListenerInner(cb, cbId, borrowed);
     if (this->validCbNum == 1 && this->type_ != SubscribeType::REMOVE) {
         RequestManager::GetInstance()->AddListener(this->taskId_, this->type_, shared_from_this());
     }
@@ -34,13 +34,15 @@ void CJResponseListener::RemoveListener(CFunc cbId)
     this->RemoveListenerInner(cbId);
     if (this->validCbNum == 0 && this->type_ != SubscribeType::REMOVE) {
         RequestManager::GetInstance()->RemoveListener(this->taskId_, this->type_, shared_from_this());
+        this->delivery_->Cancel();
     }
 }
 
 void CJResponseListener::OnResponseReceive(const std::shared_ptr<Response> &response)
 {
     REQUEST_HILOGI("CJOnRespRecv tid %{public}s", response->taskId.c_str());
-    this->OnMessageReceive(response);
+    std::shared_ptr<CJResponseListener> self = shared_from_this();
+    this->delivery_->Push([self, response]() { self->OnMessageReceive(response); }, false);
 }
 
 } // namespace OHOS::CJSystemapi::Request
\ No newline at end of file
@@ -23,6 +23,7 @@ pub enum SslType {
 pub enum CacheStrategy {
     FORCE,
     LAZY,
+    STALE_WHILE_REVALIDATE,
 }
 
 #[ani_rs::ani(path = "L@ohos/request/cacheDownload/cacheDownload/CacheDownloadOptions")]
@@ -31,4 +32,6 @@ pub struct CacheDownloadOptions {
     pub ssl_type: Option<SslType>,
     pub cache_strategy: Option<CacheStrategy>,
     pub caPath: Option<String>,
+    pub priority: Option<i32>,
+    pub compression: Option<bool>,
 }
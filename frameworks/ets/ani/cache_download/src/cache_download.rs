@@ -19,7 +19,7 @@
 
 use ani_rs::business_error::BusinessError;
 use preload_native_rlib::{CacheDownloadService, DownloadRequest, PreloadCallback, Downloader};
-use crate::bridge::CacheDownloadOptions;
+use crate::bridge::{CacheDownloadOptions, CacheStrategy};
 
 /// Empty callback implementation for preload operations.
 ///
@@ -84,13 +84,26 @@ pub fn download(url: String, options: CacheDownloadOptions) -> Result<(), Busine
     if !borrowed.is_empty() {
         request.headers(borrowed);
     }
-    // Initiate preloading with Netstack downloader and auto-refresh enabled
-    CacheDownloadService::get_instance().preload(
-        request,
-        callback,
-        true,  // Enable auto-refresh of cached resources
-        Downloader::Netstack,
-    );
+    if let Some(priority) = options.priority {
+        request.priority(priority);
+    }
+    if let Some(compression) = options.compression {
+        request.compression(compression);
+    }
+    // Initiate preloading with Netstack downloader, refreshing cached resources
+    // unless the caller asks otherwise
+    let service = CacheDownloadService::get_instance();
+    match options.cache_strategy {
+        Some(CacheStrategy::LAZY) => {
+            service.preload(request, callback, false, Downloader::Netstack);
+        }
+        Some(CacheStrategy::STALE_WHILE_REVALIDATE) => {
+            service.preload_stale(request, callback, Downloader::Netstack);
+        }
+        _ => {
+            service.preload(request, callback, true, Downloader::Netstack);
+        }
+    }
     Ok(())
 }
 
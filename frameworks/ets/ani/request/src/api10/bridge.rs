@@ -18,7 +18,9 @@
 
 use std::collections::HashMap;
 
-use request_core::config::{self, CommonTaskConfig, NetworkConfig, TaskConfig, Version, MinSpeed, Timeout};
+use request_core::config::{
+    self, CommonTaskConfig, MinSpeed, NetworkConfig, StallDetection, TaskConfig, Timeout, Version,
+};
 use serde::{Deserialize, Serialize};
 
 /// Defines the type of action for a request task.
@@ -386,6 +388,19 @@ impl From<&request_core::info::Progress> for Progress {
     }
 }
 
+/// Converts from a progress borrowed from a notification to API Progress.
+impl From<&request_client::ProgressRef<'_>> for Progress {
+    fn from(value: &request_client::ProgressRef<'_>) -> Self {
+        Progress {
+            state: value.state.clone().into(),
+            index: value.index as i32,
+            processed: value.total_processed as i64,
+            sizes: value.sizes().collect(),
+            extras: None,
+        }
+    }
+}
+
 /// Converts from core InfoProgress to API Progress.
 impl From<&request_core::info::InfoProgress> for Progress {
     fn from(value: &request_core::info::InfoProgress) -> Self {
@@ -693,6 +708,7 @@ impl From<Config> for TaskConfig {
             token: value.token.unwrap_or("".to_string()),
             proxy: value.proxy.unwrap_or("".to_string()),
             certificate_pins: "".to_string(),
+            checksum: "".to_string(),
             extras: value.extras.unwrap_or_default(),
             version: Version::API10,
             form_items,
@@ -729,6 +745,16 @@ impl From<Config> for TaskConfig {
                     connection_timeout: 0,
                     total_timeout: 0,
                 },
+                stall_detection: StallDetection::default(),
+                concurrency: 0,
+                chunk_size: 0,
+                deadline: 0,
+                coalesce: false,
+                compression: false,
+                memory_limit: 0,
+                prefetch: false,
+                bypass_cache: false,
+                trace_id: 0,
             },
             saveas: value.saveas.unwrap_or_default(),
             overwrite: value.overwrite.unwrap_or(false),
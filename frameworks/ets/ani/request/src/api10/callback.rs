@@ -22,7 +22,7 @@ use std::sync::{Arc, Mutex, OnceLock};
 
 use ani_rs::objects::{AniFnObject, GlobalRefCallback};
 use ani_rs::AniEnv;
-use request_client::RequestClient;
+use request_client::{ProgressRef, RequestClient};
 use request_core::info::{Progress, Response, Faults};
 
 use crate::api10::bridge::{self, Task};
@@ -462,7 +462,7 @@ impl request_client::Callback for CallbackColl {
     /// # Parameters
     ///
     /// * `progress` - The current progress information of the task
-    fn on_progress(&self, progress: &Progress) {
+    fn on_progress(&self, progress: &ProgressRef<'_>) {
         // Lock the callbacks vector to prevent concurrent modifications during execution
         let callbacks = self.on_progress.lock().unwrap();
         for callback in callbacks.iter() {
@@ -23,7 +23,7 @@ use std::sync::{Arc, Mutex, OnceLock};
 use ani_rs::business_error::BusinessError;
 use ani_rs::objects::{AniFnObject, GlobalRefCallback};
 use ani_rs::AniEnv;
-use request_client::RequestClient;
+use request_client::{ProgressRef, RequestClient};
 use request_core::info::{Progress, TaskState};
 
 use crate::api10::task;
@@ -660,12 +660,13 @@ impl request_client::Callback for CallbackColl {
     /// # Parameters
     ///
     /// * `progress` - The progress information containing processed bytes and total size
-    fn on_progress(&self, progress: &Progress) {
+    fn on_progress(&self, progress: &ProgressRef<'_>) {
         // Lock the callback vector to prevent concurrent modifications
         let callbacks = self.on_progress.lock().unwrap();
-        // Execute each callback with processed bytes and total size
+        // Execute each callback with processed bytes and total size, -1 when unknown
+        let total = progress.size(0).unwrap_or(-1);
         for callback in callbacks.iter() {
-            callback.execute((progress.processed as i64, progress.sizes[0]));
+            callback.execute((progress.processed as i64, total));
         }
     }
 
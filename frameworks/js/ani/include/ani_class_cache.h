@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANI_CLASS_CACHE_H
+#define ANI_CLASS_CACHE_H
+
+#include <ani.h>
+
+namespace OHOS {
+namespace AniUtil {
+
+// Classes, constructors and fields used by the conversions, resolved once when the module is loaded
+// instead of by name on every call. The classes are global references, valid in every env of the vm,
+// and methods and fields are valid as long as their class.
+struct AniClassCache {
+    ani_class taskImpl = nullptr;
+    ani_method taskImplCtor = nullptr;
+    ani_field taskImplNativePtr = nullptr;
+    ani_class progressImpl = nullptr;
+    ani_method progressImplCtor = nullptr;
+    ani_class httpResponseImpl = nullptr;
+    ani_method httpResponseImplCtor = nullptr;
+    ani_class businessError = nullptr;
+    ani_method businessErrorCtor = nullptr;
+    ani_field businessErrorCode = nullptr;
+    ani_class string = nullptr;
+    ani_class fileSpec = nullptr;
+
+    // Called from `ANI_Constructor`, a cache already initialized is kept.
+    static ani_status Init(ani_env *env);
+    // Returns nullptr until `Init` succeeded, callers then fall back to the lookups by name.
+    static const AniClassCache *Get();
+};
+
+} // namespace AniUtil
+} // namespace OHOS
+
+#endif
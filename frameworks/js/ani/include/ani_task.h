@@ -20,6 +20,7 @@
 #include "i_response_listener.h"
 #include "i_notify_data_listener.h"
 #include "listener_list.h"
+#include "notify_delivery.h"
 
 namespace OHOS::Request {
 
@@ -37,6 +38,9 @@ public:
     void AddListener(ani_ref &callback);
 
 private:
+    void Deliver(const std::shared_ptr<Response> &response);
+
+    std::shared_ptr<NotifyDelivery> delivery_ = std::make_shared<NotifyDelivery>();
     ani_vm *vm_ = nullptr;
     std::string tid_ = "";
     SubscribeType type_ = SubscribeType::FAILED;
@@ -63,6 +67,9 @@ public:
     void AddListener(ani_ref &callback);
 
 private:
+    void Deliver(const std::shared_ptr<NotifyData> &notifyData);
+
+    std::shared_ptr<NotifyDelivery> delivery_ = std::make_shared<NotifyDelivery>();
     ani_vm *vm_ = nullptr;
     std::string tid_ = "";
     SubscribeType type_ = SubscribeType::FAILED;
@@ -95,8 +102,7 @@ public:
     static bool SetDirsPermission(std::vector<std::string> &dirs);
     static bool SetPathPermission(const std::string &filepath);
     static void RemoveDirsPermission(const std::vector<std::string> &dirs);
-    static void AddPathMap(const std::string &filepath, const std::string &baseDir);
-    static void ResetDirAccess(const std::string &filepath);
+    static std::vector<std::string> ParentDirs(const std::string &filepath, const std::string &baseDir);
     static void RemovePathMap(const std::string &filepath);
     static void AddTaskMap(const std::string &key, AniTask *task);
     static void ClearTaskMap(const std::string &key);
@@ -107,7 +113,6 @@ public:
     static std::mutex pathMutex_;
     static std::mutex taskMutex_;
     static std::map<std::string, AniTask *> taskMap_;
-    static std::map<std::string, int32_t> pathMap_;
     static std::map<std::string, int32_t> fileMap_;
 
 private:
@@ -99,6 +99,21 @@ public:
         return obj;
     }
 
+    // Creates an object with a constructor resolved beforehand, see `AniClassCache`.
+    static ani_object New(ani_env *env, ani_class cls, ani_method ctor, ...)
+    {
+        ani_object obj;
+        va_list args;
+        va_start(args, ctor);
+        ani_status status = env->Object_New_V(cls, ctor, &obj, args);
+        va_end(args);
+        if (ANI_OK != status) {
+            REQUEST_HILOGE("[ANI] Failed to Object_New for class.");
+            return nullptr;
+        }
+        return obj;
+    }
+
     static ani_object From(ani_env *env, bool value)
     {
         return Create(env, "std.core.Boolean", static_cast<ani_boolean>(value));
@@ -296,6 +311,7 @@ inline bool UnionAccessor::TryConvert<std::string>(std::string &value)
 }
 
 ani_boolean IsInstanceOf(ani_env *env, const std::string &cls_name, ani_object obj);
+ani_boolean IsInstanceOf(ani_env *env, ani_class cls, ani_object obj);
 
 class OptionalAccessor {
 public:
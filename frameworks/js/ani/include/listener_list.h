@@ -19,6 +19,7 @@
 #include <list>
 #include <mutex>
 #include <string>
+#include <vector>
 #include "request_common.h"
 
 namespace OHOS::Request {
@@ -31,11 +32,15 @@ public:
 protected:
     void OnMessageReceive(ani_env* env, std::vector<ani_ref> &args);
     ani_status AddListenerInner(ani_ref cb);
+    // Returns the env of the calling delivery worker, attached to `vm` once and detached when the thread exits.
+    static ani_env *AttachWorkerEnv(ani_vm *vm);
 
 protected:
     std::list<std::pair<bool, ani_ref>> allCb_;
     std::recursive_mutex allCbMutex_;
     std::atomic<uint32_t> validCbNum{ 0 };
+    // Arguments of the callbacks, reused by every delivery as the listener delivers one message at a time.
+    std::vector<ani_ref> args_;
 };
 
 } // namespace OHOS::Request
@@ -88,9 +88,18 @@ public:
     {
     }
 
+    // Accesses the field through a handle resolved beforehand, the lookup by name is used if it is nullptr.
+    NativePtrWrapper(ani_env *env, ani_object object, ani_field field, const char* propName = "nativePtr")
+        : env_(env), obj_(object), field_(field), propName_(propName)
+    {
+    }
+
     template<typename T>
     ani_status Wrap(T* nativePtr)
     {
+        if (field_ != nullptr) {
+            return env_->Object_SetField_Long(obj_, field_, reinterpret_cast<ani_long>(nativePtr));
+        }
         return env_->Object_SetFieldByName_Long(obj_, propName_.c_str(), reinterpret_cast<ani_long>(nativePtr));
     }
 
@@ -98,7 +107,9 @@ public:
     T* Unwrap()
     {
         ani_long nativePtr;
-        if (ANI_OK != env_->Object_GetFieldByName_Long(obj_, propName_.c_str(), &nativePtr)) {
+        ani_status status = field_ != nullptr ? env_->Object_GetField_Long(obj_, field_, &nativePtr) :
+                                                env_->Object_GetFieldByName_Long(obj_, propName_.c_str(), &nativePtr);
+        if (ANI_OK != status) {
             return nullptr;
         }
         return reinterpret_cast<T*>(nativePtr);
@@ -107,6 +118,7 @@ public:
 private:
     ani_env *env_ = nullptr;
     ani_object obj_ = nullptr;
+    ani_field field_ = nullptr;
     std::string propName_;
 };
 
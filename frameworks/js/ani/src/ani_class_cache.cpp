@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ani_class_cache.h"
+
+#include <atomic>
+#include <mutex>
+
+#include "log.h"
+
+namespace OHOS {
+namespace AniUtil {
+
+static AniClassCache g_cache;
+static std::atomic<bool> g_ready{ false };
+static std::mutex g_initMutex;
+
+static ani_status FindGlobalClass(ani_env *env, const char *clsName, ani_class &out)
+{
+    ani_class cls = nullptr;
+    ani_status status = env->FindClass(clsName, &cls);
+    if (ANI_OK != status) {
+        REQUEST_HILOGE("[ANI] Not found class %{public}s", clsName);
+        return status;
+    }
+    ani_ref ref = nullptr;
+    status = env->GlobalReference_Create(static_cast<ani_ref>(cls), &ref);
+    if (ANI_OK != status) {
+        REQUEST_HILOGE("[ANI] GlobalReference_Create failed for %{public}s", clsName);
+        return status;
+    }
+    out = static_cast<ani_class>(ref);
+    return ANI_OK;
+}
+
+static ani_status FindCtor(ani_env *env, ani_class cls, const char *signature, ani_method &out)
+{
+    ani_status status = env->Class_FindMethod(cls, "<ctor>", signature, &out);
+    if (ANI_OK != status) {
+        REQUEST_HILOGE("[ANI] Not found <ctor> for class");
+    }
+    return status;
+}
+
+static ani_status Resolve(ani_env *env, AniClassCache &cache)
+{
+    ani_status status = ANI_OK;
+    if ((status = FindGlobalClass(env, "@ohos.request.request.agent.TaskImpl", cache.taskImpl)) != ANI_OK ||
+        (status = FindCtor(env, cache.taskImpl, nullptr, cache.taskImplCtor)) != ANI_OK ||
+        (status = env->Class_FindField(cache.taskImpl, "nativePtr", &cache.taskImplNativePtr)) != ANI_OK) {
+        return status;
+    }
+    if ((status = FindGlobalClass(env, "@ohos.request.request.agent.ProgressImpl", cache.progressImpl)) != ANI_OK ||
+        (status = FindCtor(env, cache.progressImpl, nullptr, cache.progressImplCtor)) != ANI_OK) {
+        return status;
+    }
+    if ((status = FindGlobalClass(env, "@ohos.request.request.agent.HttpResponseImpl", cache.httpResponseImpl)) !=
+            ANI_OK ||
+        (status = FindCtor(env, cache.httpResponseImpl, nullptr, cache.httpResponseImplCtor)) != ANI_OK) {
+        return status;
+    }
+    if ((status = FindGlobalClass(env, "L@ohos/base/BusinessError;", cache.businessError)) != ANI_OK ||
+        (status = FindCtor(env, cache.businessError, ":V", cache.businessErrorCtor)) != ANI_OK ||
+        (status = env->Class_FindField(cache.businessError, "code", &cache.businessErrorCode)) != ANI_OK) {
+        return status;
+    }
+    if ((status = FindGlobalClass(env, "Lstd/core/String;", cache.string)) != ANI_OK) {
+        return status;
+    }
+    return FindGlobalClass(env, "L@ohos/request/request/agent/FileSpec;", cache.fileSpec);
+}
+
+static void Release(ani_env *env, AniClassCache &cache)
+{
+    for (ani_class cls : { cache.taskImpl, cache.progressImpl, cache.httpResponseImpl, cache.businessError,
+             cache.string, cache.fileSpec }) {
+        if (cls != nullptr) {
+            env->GlobalReference_Delete(static_cast<ani_ref>(cls));
+        }
+    }
+    cache = AniClassCache();
+}
+
+ani_status AniClassCache::Init(ani_env *env)
+{
+    std::lock_guard<std::mutex> lock(g_initMutex);
+    if (g_ready.load(std::memory_order_relaxed)) {
+        return ANI_OK;
+    }
+    AniClassCache cache;
+    ani_status status = Resolve(env, cache);
+    if (ANI_OK != status) {
+        Release(env, cache);
+        return status;
+    }
+    g_cache = cache;
+    g_ready.store(true, std::memory_order_release);
+    return ANI_OK;
+}
+
+const AniClassCache *AniClassCache::Get()
+{
+    return g_ready.load(std::memory_order_acquire) ? &g_cache : nullptr;
+}
+
+} // namespace AniUtil
+} // namespace OHOS
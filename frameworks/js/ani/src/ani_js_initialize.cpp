@@ -34,6 +34,7 @@
 #include "request_common.h"
 #include "request_manager.h"
 #include "sys_event.h"
+#include "url_view.h"
 
 static const std::string AREA1 = "/data/storage/el1/base";
 static const std::string AREA2 = "/data/storage/el2/base";
@@ -323,27 +324,7 @@ bool JsInitialize::GetInternalPath(const std::shared_ptr<OHOS::AbilityRuntime::C
 
 std::string GetHostnameFromURL(const std::string &url)
 {
-    if (url.empty()) {
-        return "";
-    }
-    std::string delimiter = "://";
-    std::string tempUrl = url;
-    std::replace(tempUrl.begin(), tempUrl.end(), '\\', '/');
-    size_t posStart = tempUrl.find(delimiter);
-    if (posStart != std::string::npos) {
-        posStart += delimiter.length();
-    } else {
-        posStart = 0;
-    }
-    size_t notSlash = tempUrl.find_first_not_of('/', posStart);
-    if (notSlash != std::string::npos) {
-        posStart = notSlash;
-    }
-    size_t posEnd = std::min({ tempUrl.find(':', posStart), tempUrl.find('/', posStart), tempUrl.find('?', posStart) });
-    if (posEnd != std::string::npos) {
-        return tempUrl.substr(posStart, posEnd - posStart);
-    }
-    return tempUrl.substr(posStart);
+    return std::string(ParseUrlView(url).host);
 }
 
 bool JsInitialize::CheckUserFileSpec(const std::shared_ptr<OHOS::AbilityRuntime::Context> &context,
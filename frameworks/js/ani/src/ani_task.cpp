@@ -16,26 +16,25 @@
 #include <ani.h>
 #include <iostream>
 #include <filesystem>
+#include "acl_grant_table.h"
 #include "constant.h"
 #include "log.h"
+#include "ani_class_cache.h"
 #include "ani_js_initialize.h"
 #include "ani_utils.h"
 #include "ani_task.h"
-#include "storage_acl.h"
 #include "request_manager.h"
+#include "request_trace.h"
 
 using namespace OHOS::Request;
 using namespace OHOS::AniUtil;
-using OHOS::StorageDaemon::AclSetAccess;
 
 namespace fs = std::filesystem;
 std::mutex AniTask::pathMutex_;
 std::mutex AniTask::taskMutex_;
 std::map<std::string, AniTask *> AniTask::taskMap_;
-std::map<std::string, int32_t> AniTask::pathMap_;
 std::map<std::string, int32_t> AniTask::fileMap_;
 
-static constexpr int ACL_SUCC = 0;
 static const std::string SA_PERMISSION_RWX = "g:3815:rwx";
 static const std::string SA_PERMISSION_X = "g:3815:x";
 static const std::string SA_PERMISSION_CLEAN = "g:3815:---";
@@ -59,13 +58,16 @@ static void ThrowBusinessError(ani_env *env, int errCode, std::string&& errMsg)
         return;
     }
     static const char *errorClsName = "L@ohos/base/BusinessError;";
+    const AniClassCache *cache = AniClassCache::Get();
     ani_class cls {};
-    if (env->FindClass(errorClsName, &cls) != ANI_OK) {
+    ani_method ctor {};
+    if (cache != nullptr) {
+        cls = cache->businessError;
+        ctor = cache->businessErrorCtor;
+    } else if (env->FindClass(errorClsName, &cls) != ANI_OK) {
         REQUEST_HILOGE("find class BusinessError %{public}s failed", errorClsName);
         return;
-    }
-    ani_method ctor;
-    if (env->Class_FindMethod(cls, "<ctor>", ":V", &ctor) != ANI_OK) {
+    } else if (env->Class_FindMethod(cls, "<ctor>", ":V", &ctor) != ANI_OK) {
         REQUEST_HILOGE("find method BusinessError.constructor failed");
         return;
     }
@@ -80,7 +82,10 @@ static void ThrowBusinessError(ani_env *env, int errCode, std::string&& errMsg)
         REQUEST_HILOGE("convert errMsg to ani_string failed");
         return;
     }
-    if (env->Object_SetFieldByName_Double(errorObject, "code", aniErrCode) != ANI_OK) {
+    ani_status status = cache != nullptr ?
+        env->Object_SetField_Double(errorObject, cache->businessErrorCode, aniErrCode) :
+        env->Object_SetFieldByName_Double(errorObject, "code", aniErrCode);
+    if (status != ANI_OK) {
         REQUEST_HILOGE("set error code failed");
         return;
     }
@@ -116,6 +121,7 @@ AniTask* AniTask::Create([[maybe_unused]] ani_env* env, Config config)
     RequestManager::GetInstance()->LoadRequestServer();
 
     std::string tid = "";
+    config.traceId = RequestTrace::NewId();
     int32_t ret = RequestManager::GetInstance()->Create(config, seq, tid);
     REQUEST_HILOGI("Create return: tid: [%{public}s]", tid.c_str());
     if (ret != E_OK) {
@@ -179,21 +185,22 @@ static RemoveTaskChecker CheckRemoveJSTask(const std::shared_ptr<NotifyData> &no
     return RemoveTaskChecker::DoNothing;
 }
 
+// Called on the receiving thread, the callbacks are called on the delivery worker.
 void NotifyDataListener::OnNotifyDataReceive(const std::shared_ptr<NotifyData> &notifyData)
 {
-    REQUEST_HILOGI("OnNotifyDataReceive enter");
-    ani_env *workerEnv = nullptr;
-    ani_options aniArgs {0, nullptr};
-    auto status = vm_->AttachCurrentThread(&aniArgs, ANI_VERSION_1, &workerEnv);
-    if (status == ANI_ERROR) {
-        status = vm_->GetEnv(ANI_VERSION_1, &workerEnv);
-    }
+    std::shared_ptr<NotifyDataListener> self = shared_from_this();
+    delivery_->Push([self, notifyData]() { self->Deliver(notifyData); }, IsIntermediateProgress(notifyData));
+}
 
-    AniLocalScopeGuard guard(workerEnv, 0X16);
+void NotifyDataListener::Deliver(const std::shared_ptr<NotifyData> &notifyData)
+{
+    REQUEST_HILOGI("OnNotifyDataReceive enter");
+    ani_env *workerEnv = AttachWorkerEnv(vm_);
     if (workerEnv == nullptr) {
         REQUEST_HILOGE("%{public}s: env_ == nullptr.", __func__);
         return;
     }
+    AniLocalScopeGuard guard(workerEnv, 0X16);
 
     std::string tid = std::to_string(notifyData->taskId);
     RemoveTaskChecker checkDo = CheckRemoveJSTask(notifyData, tid);
@@ -201,13 +208,17 @@ void NotifyDataListener::OnNotifyDataReceive(const std::shared_ptr<NotifyData> &
         AniTask::ClearTaskMap(tid);
     }
 
-    ani_object Progress = AniObjectUtils::Create(workerEnv, "@ohos.request.request", "agent", "ProgressImpl",
-        static_cast<ani_double>(notifyData->progress.state), static_cast<ani_double>(notifyData->progress.index),
-        static_cast<ani_double>(notifyData->progress.processed));
-    std::vector<ani_ref> args = {Progress};
-    
-    OnMessageReceive(workerEnv, args);
-    status = vm_->DetachCurrentThread();
+    const Progress &progress = notifyData->progress;
+    const AniClassCache *cache = AniClassCache::Get();
+    ani_object aniProgress = cache != nullptr ?
+        AniObjectUtils::New(workerEnv, cache->progressImpl, cache->progressImplCtor,
+            static_cast<ani_double>(progress.state), static_cast<ani_double>(progress.index),
+            static_cast<ani_double>(progress.processed)) :
+        AniObjectUtils::Create(workerEnv, "@ohos.request.request", "agent", "ProgressImpl",
+            static_cast<ani_double>(progress.state), static_cast<ani_double>(progress.index),
+            static_cast<ani_double>(progress.processed));
+    args_.assign(1, aniProgress);
+    OnMessageReceive(workerEnv, args_);
     REQUEST_HILOGI("OnNotifyDataReceive end");
 }
 
@@ -222,25 +233,29 @@ void NotifyDataListener::AddListener(ani_ref &callback)
 
 void ResponseListener::OnResponseReceive(const std::shared_ptr<Response> &response)
 {
-    REQUEST_HILOGI("OnResponseReceive enter");
-    ani_env *workerEnv = nullptr;
-    ani_options aniArgs {0, nullptr};
-    auto status = vm_->AttachCurrentThread(&aniArgs, ANI_VERSION_1, &workerEnv);
-    if (status == ANI_ERROR) {
-        status = vm_->GetEnv(ANI_VERSION_1, &workerEnv);
-    }
+    std::shared_ptr<ResponseListener> self = shared_from_this();
+    delivery_->Push([self, response]() { self->Deliver(response); }, false);
+}
 
-    AniLocalScopeGuard guard(workerEnv, 0X16);
+void ResponseListener::Deliver(const std::shared_ptr<Response> &response)
+{
+    REQUEST_HILOGI("OnResponseReceive enter");
+    ani_env *workerEnv = AttachWorkerEnv(vm_);
     if (workerEnv == nullptr) {
         REQUEST_HILOGE("%{public}s: env_ == nullptr.", __func__);
         return;
     }
-    ani_object httpResponse = AniObjectUtils::Create(workerEnv, "@ohos.request.request", "agent",
-        "LHttpResponseImpl;", AniStringUtils::ToAni(workerEnv, response->version),
-        static_cast<ani_double>(response->statusCode), AniStringUtils::ToAni(workerEnv, response->reason));
-    std::vector<ani_ref> args = {httpResponse};
-    OnMessageReceive(workerEnv, args);
-    status = vm_->DetachCurrentThread();
+    AniLocalScopeGuard guard(workerEnv, 0X16);
+    const AniClassCache *cache = AniClassCache::Get();
+    ani_object httpResponse = cache != nullptr ?
+        AniObjectUtils::New(workerEnv, cache->httpResponseImpl, cache->httpResponseImplCtor,
+            AniStringUtils::ToAni(workerEnv, response->version), static_cast<ani_double>(response->statusCode),
+            AniStringUtils::ToAni(workerEnv, response->reason)) :
+        AniObjectUtils::Create(workerEnv, "@ohos.request.request", "agent", "LHttpResponseImpl;",
+            AniStringUtils::ToAni(workerEnv, response->version), static_cast<ani_double>(response->statusCode),
+            AniStringUtils::ToAni(workerEnv, response->reason));
+    args_.assign(1, httpResponse);
+    OnMessageReceive(workerEnv, args_);
 }
 
 void ResponseListener::AddListener(ani_ref &callback)
@@ -329,61 +344,34 @@ bool AniTask::SetPathPermission(const std::string &filepath)
     if (!JsInitialize::CheckBelongAppBaseDir(filepath, baseDir)) {
         return false;
     }
-
-    AddPathMap(filepath, baseDir);
     {
         std::lock_guard<std::mutex> lockGuard(AniTask::pathMutex_);
-        for (auto it : pathMap_) {
-            if (it.second <= 0) {
-                continue;
-            }
-            if (AclSetAccess(it.first, SA_PERMISSION_X) != ACL_SUCC) {
-                REQUEST_HILOGD("AclSetAccess Parent Dir Failed: %{public}s", it.first.c_str());
-            }
-        }
+        fileMap_[filepath] += 1;
     }
 
-    std::string childDir = filepath.substr(0, filepath.rfind("/"));
-    if (AclSetAccess(childDir, SA_PERMISSION_RWX) != ACL_SUCC) {
-        REQUEST_HILOGE("AclSetAccess Child Dir Failed: %{public}s", childDir.c_str());
+    // The directory of the file is read and written, the ones above it are only searched.
+    std::vector<std::string> dirs = ParentDirs(filepath, baseDir);
+    for (size_t i = 1; i < dirs.size(); i++) {
+        if (!AclGrantTable::Acquire(dirs[i], SA_PERMISSION_X)) {
+            REQUEST_HILOGD("AclSetAccess Parent Dir Failed: %{public}s", dirs[i].c_str());
+        }
+    }
+    if (!dirs.empty() && !AclGrantTable::Acquire(dirs[0], SA_PERMISSION_RWX)) {
+        REQUEST_HILOGE("AclSetAccess Child Dir Failed: %{public}s", dirs[0].c_str());
         return false;
     }
     return true;
 }
 
-void AniTask::AddPathMap(const std::string &filepath, const std::string &baseDir)
+std::vector<std::string> AniTask::ParentDirs(const std::string &filepath, const std::string &baseDir)
 {
-    {
-        std::lock_guard<std::mutex> lockGuard(AniTask::pathMutex_);
-        auto it = fileMap_.find(filepath);
-        if (it == fileMap_.end()) {
-            fileMap_[filepath] = 1;
-        } else {
-            fileMap_[filepath] += 1;
-        }
-    }
-
+    std::vector<std::string> dirs;
     std::string childDir(filepath);
-    std::string parentDir;
     while (childDir.length() > baseDir.length()) {
-        parentDir = childDir.substr(0, childDir.rfind("/"));
-        std::lock_guard<std::mutex> lockGuard(AniTask::pathMutex_);
-        auto it = pathMap_.find(parentDir);
-        if (it == pathMap_.end()) {
-            pathMap_[parentDir] = 1;
-        } else {
-            pathMap_[parentDir] += 1;
-        }
-        childDir = parentDir;
-    }
-}
-
-void AniTask::ResetDirAccess(const std::string &filepath)
-{
-    int ret = AclSetAccess(filepath, SA_PERMISSION_CLEAN);
-    if (ret != ACL_SUCC) {
-        REQUEST_HILOGD("AclSetAccess Reset Dir Failed: %{public}s", filepath.c_str());
+        childDir = childDir.substr(0, childDir.rfind("/"));
+        dirs.push_back(childDir);
     }
+    return dirs;
 }
 
 void AniTask::RemovePathMap(const std::string &filepath)
@@ -393,38 +381,28 @@ void AniTask::RemovePathMap(const std::string &filepath)
         return;
     }
 
+    bool lastFile = false;
     {
         std::lock_guard<std::mutex> lockGuard(AniTask::pathMutex_);
         auto it = fileMap_.find(filepath);
-        if (it != fileMap_.end()) {
-            if (fileMap_[filepath] <= 1) {
-                fileMap_.erase(filepath);
-                if (chmod(filepath.c_str(), S_IRUSR | S_IWUSR | S_IRGRP) != 0) {
-                    REQUEST_HILOGE("File remove OTH access Failed: %{public}s", filepath.c_str());
-                }
-            } else {
-                fileMap_[filepath] -= 1;
-            }
-        } else {
+        if (it == fileMap_.end()) {
             return;
         }
+        if (it->second <= 1) {
+            fileMap_.erase(it);
+            lastFile = true;
+        } else {
+            it->second -= 1;
+        }
+    }
+    if (lastFile && chmod(filepath.c_str(), S_IRUSR | S_IWUSR | S_IRGRP) != 0) {
+        REQUEST_HILOGE("File remove OTH access Failed: %{public}s", filepath.c_str());
     }
 
-    std::string childDir(filepath);
-    std::string parentDir;
-    while (childDir.length() > baseDir.length()) {
-        parentDir = childDir.substr(0, childDir.rfind("/"));
-        std::lock_guard<std::mutex> lockGuard(AniTask::pathMutex_);
-        auto it = pathMap_.find(parentDir);
-        if (it != pathMap_.end()) {
-            if (pathMap_[parentDir] <= 1) {
-                pathMap_.erase(parentDir);
-                ResetDirAccess(parentDir);
-            } else {
-                pathMap_[parentDir] -= 1;
-            }
+    for (const auto &dir : ParentDirs(filepath, baseDir)) {
+        if (!AclGrantTable::Release(dir, SA_PERMISSION_CLEAN)) {
+            REQUEST_HILOGD("AclSetAccess Reset Dir Failed: %{public}s", dir.c_str());
         }
-        childDir = parentDir;
     }
 }
 
@@ -18,6 +18,42 @@
 #include "log.h"
 using namespace OHOS::AniUtil;
 namespace OHOS::Request {
+namespace {
+struct WorkerAttachment {
+    ani_vm *vm = nullptr;
+    ani_env *env = nullptr;
+
+    ~WorkerAttachment()
+    {
+        if (vm != nullptr) {
+            vm->DetachCurrentThread();
+        }
+    }
+};
+thread_local WorkerAttachment g_workerAttachment;
+} // namespace
+
+ani_env *ListenerList::AttachWorkerEnv(ani_vm *vm)
+{
+    if (vm == nullptr) {
+        return nullptr;
+    }
+    if (g_workerAttachment.vm == vm) {
+        return g_workerAttachment.env;
+    }
+    ani_env *env = nullptr;
+    ani_options aniArgs {0, nullptr};
+    if (vm->AttachCurrentThread(&aniArgs, ANI_VERSION_1, &env) == ANI_OK) {
+        g_workerAttachment.vm = vm;
+        g_workerAttachment.env = env;
+        return env;
+    }
+    // Attached by someone else, who also detaches it.
+    if (vm->GetEnv(ANI_VERSION_1, &env) != ANI_OK) {
+        return nullptr;
+    }
+    return env;
+}
 
 ani_status ListenerList::AddListenerInner(ani_ref cb)
 {
@@ -26,6 +26,7 @@
 #include "class.h"
 #include "log.h"
 #include "memory.h"
+#include "ani_class_cache.h"
 #include "ani_utils.h"
 #include "ani_task.h"
 #include "ani_js_initialize.h"
@@ -57,13 +58,16 @@ static void ThrowBusinessError(ani_env *env, int errCode, std::string&& errMsg)
 {
     REQUEST_HILOGI("into ThrowBusinessError.");
     static const char *errorClsName = "L@ohos/base/BusinessError;";
+    const AniClassCache *cache = AniClassCache::Get();
     ani_class cls {};
-    if (env->FindClass(errorClsName, &cls) != ANI_OK) {
+    ani_method ctor {};
+    if (cache != nullptr) {
+        cls = cache->businessError;
+        ctor = cache->businessErrorCtor;
+    } else if (env->FindClass(errorClsName, &cls) != ANI_OK) {
         REQUEST_HILOGE("find class BusinessError %{public}s failed", errorClsName);
         return;
-    }
-    ani_method ctor;
-    if (env->Class_FindMethod(cls, "<ctor>", ":V", &ctor) != ANI_OK) {
+    } else if (env->Class_FindMethod(cls, "<ctor>", ":V", &ctor) != ANI_OK) {
         REQUEST_HILOGE("find method BusinessError.constructor failed");
         return;
     }
@@ -78,7 +82,10 @@ static void ThrowBusinessError(ani_env *env, int errCode, std::string&& errMsg)
         REQUEST_HILOGE("convert errMsg to ani_string failed");
         return;
     }
-    if (env->Object_SetFieldByName_Double(errorObject, "code", aniErrCode) != ANI_OK) {
+    ani_status status = cache != nullptr ?
+        env->Object_SetField_Double(errorObject, cache->businessErrorCode, aniErrCode) :
+        env->Object_SetFieldByName_Double(errorObject, "code", aniErrCode);
+    if (status != ANI_OK) {
         REQUEST_HILOGE("set error code failed");
         return;
     }
@@ -139,10 +146,43 @@ ani_boolean OHOS::AniUtil::IsInstanceOf(ani_env *env, const std::string &cls_nam
     return ret;
 }
 
+ani_boolean OHOS::AniUtil::IsInstanceOf(ani_env *env, ani_class cls, ani_object obj)
+{
+    ani_boolean ret = ANI_FALSE;
+    if (ANI_OK != env->Object_InstanceOf(obj, cls, &ret)) {
+        return ANI_FALSE;
+    }
+    return ret;
+}
+
+static bool IsString(ani_env *env, ani_object obj)
+{
+    const AniClassCache *cache = AniClassCache::Get();
+    if (cache != nullptr) {
+        return IsInstanceOf(env, cache->string, obj);
+    }
+    return IsInstanceOf(env, "Lstd/core/String;", obj);
+}
+
+static bool IsFileSpec(ani_env *env, ani_object obj)
+{
+    const AniClassCache *cache = AniClassCache::Get();
+    if (cache != nullptr) {
+        return IsInstanceOf(env, cache->fileSpec, obj);
+    }
+    return IsInstanceOf(env, "L@ohos/request/request/agent/FileSpec;", obj);
+}
+
+static AniTask *UnwrapTask(ani_env *env, ani_object object)
+{
+    const AniClassCache *cache = AniClassCache::Get();
+    NativePtrWrapper wrapper(env, object, cache != nullptr ? cache->taskImplNativePtr : nullptr);
+    return wrapper.Unwrap<AniTask>();
+}
+
 static bool GetDownloadData(ani_env *env, Config &aniConfig, ani_object aniData)
 {
-    UnionAccessor unionAccessor(env, aniData);
-    if (unionAccessor.IsInstanceOf("Lstd/core/String;")) {
+    if (IsString(env, aniData)) {
         aniConfig.data = AniStringUtils::ToStd(env, static_cast<ani_string>(aniData));
     }
     return true;
@@ -177,14 +217,14 @@ static bool ProcessDatas(ani_env *env, Config &aniConfig, ani_object aniData)
             REQUEST_HILOGE("Object_GetFieldByName_Ref value from data Faild");
             return false;
         }
-        if (IsInstanceOf(env, "Lstd/core/String;", static_cast<ani_object>(valueRef))) {
+        if (IsString(env, static_cast<ani_object>(valueRef))) {
             FormItem form;
             form.name = name;
             form.value = AniStringUtils::ToStd(env, static_cast<ani_string>(valueRef));
             aniConfig.forms.push_back(form);
             continue;
         }
-        if (IsInstanceOf(env, "L@ohos/request/request/agent/FileSpec;", static_cast<ani_object>(valueRef))) {
+        if (IsFileSpec(env, static_cast<ani_object>(valueRef))) {
             FileSpec file;
             if (!JsInitialize::Convert2FileSpec(env, static_cast<ani_object>(valueRef), name, file)) {
                 REQUEST_HILOGE("Convert2FileSpec failed");
@@ -285,9 +325,15 @@ static ani_object Create([[maybe_unused]] ani_env *env, ani_object object, ani_o
         return nullobj;
     }
 
-    auto taskImpl = AniObjectUtils::Create(env, "@ohos.request.request", "agent", "TaskImpl");
-
-    NativePtrWrapper wrapper(env, taskImpl);
+    const AniClassCache *cache = AniClassCache::Get();
+    if (cache == nullptr) {
+        auto taskImpl = AniObjectUtils::Create(env, "@ohos.request.request", "agent", "TaskImpl");
+        NativePtrWrapper wrapper(env, taskImpl);
+        wrapper.Wrap<AniTask>(task);
+        return taskImpl;
+    }
+    auto taskImpl = AniObjectUtils::New(env, cache->taskImpl, cache->taskImplCtor, static_cast<ani_long>(0));
+    NativePtrWrapper wrapper(env, taskImpl, cache->taskImplNativePtr);
     wrapper.Wrap<AniTask>(task);
     return taskImpl;
 }
@@ -298,8 +344,7 @@ static void StartSync([[maybe_unused]] ani_env *env, ani_object object)
     if (env == nullptr) {
         return;
     }
-    NativePtrWrapper wrapper(env, object);
-    auto task = wrapper.Unwrap<AniTask>();
+    auto task = UnwrapTask(env, object);
     if (task == nullptr) {
         REQUEST_HILOGE("task is nullptr");
         return;
@@ -315,8 +360,7 @@ static void OnSync([[maybe_unused]] ani_env *env, [[maybe_unused]] ani_object ob
     ani_ref callbackRef = nullptr;
     env->GlobalReference_Create(reinterpret_cast<ani_ref>(callback), &callbackRef);
     auto responseEvent = AniStringUtils::ToStd(env, static_cast<ani_string>(response));
-    NativePtrWrapper wrapper(env, object);
-    auto task = wrapper.Unwrap<AniTask>();
+    auto task = UnwrapTask(env, object);
     if (task == nullptr) {
         REQUEST_HILOGE("task is nullptr");
         return;
@@ -365,6 +409,10 @@ ANI_EXPORT ani_status ANI_Constructor(ani_vm *vm, uint32_t *result)
         return ANI_ERROR;
     }
 
+    if (ANI_OK != AniClassCache::Init(env)) {
+        REQUEST_HILOGE("AniClassCache init failed, classes are looked up by name");
+    }
+
     auto cleanerCls = TypeFinder(env).FindClass("ohos.request.request.agent.Cleaner");
     NativePtrCleaner(env).Bind(cleanerCls.value());
 
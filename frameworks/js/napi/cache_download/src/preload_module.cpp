@@ -18,10 +18,14 @@
 #include <dlfcn.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <cstring>
 #include <memory>
 #include <optional>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "access_token.h"
 #include "accesstoken_kit.h"
@@ -41,6 +45,7 @@ namespace OHOS::Request {
 using namespace Security::AccessToken;
 
 constexpr const size_t MAX_UTL_LENGTH = 8192;
+constexpr const size_t MAX_TAG_LENGTH = 128;
 
 constexpr int64_t MAX_MEM_SIZE = 1073741824;
 constexpr int64_t MAX_FILE_SIZE = 4294967296;
@@ -254,6 +259,41 @@ napi_status CallbackManager::RemoveCallback(const std::string &url, CallbackType
     return info->RemoveCallback(cb);
 }
 
+// Wraps the cached bytes in an ArrayBuffer without copying them. The buffer keeps the data alive until JS
+// finalizes it, and it shares memory with the cache, so it must be treated as read-only.
+static napi_value CreateDataBuffer(napi_env env, const std::shared_ptr<Data> &data)
+{
+    napi_value buffer = nullptr;
+    if (data == nullptr) {
+        return buffer;
+    }
+    Slice<const uint8_t> bytes = data->bytes();
+    if (bytes.empty()) {
+        void *ptr = nullptr;
+        napi_create_arraybuffer(env, 0, &ptr, &buffer);
+        return buffer;
+    }
+    auto *hint = new std::shared_ptr<Data>(data);
+    napi_status status = napi_create_external_arraybuffer(
+        env, const_cast<uint8_t *>(bytes.data()), bytes.size(),
+        [](napi_env env, void *ptr, void *hint) { delete static_cast<std::shared_ptr<Data> *>(hint); }, hint,
+        &buffer);
+    if (status == napi_ok) {
+        return buffer;
+    }
+    // Runtimes without external buffers get a copy
+    delete hint;
+    REQUEST_HILOGD("external arraybuffer unavailable, copy data, reason: %{public}d", status);
+    void *ptr = nullptr;
+    status = napi_create_arraybuffer(env, bytes.size(), &ptr, &buffer);
+    if (status != napi_ok || ptr == nullptr) {
+        REQUEST_HILOGE("create arraybuffer failed, reason: %{public}d", status);
+        return nullptr;
+    }
+    memcpy(ptr, bytes.data(), bytes.size());
+    return buffer;
+}
+
 void CallbackManager::InvokeSuccessCallbacks(const std::string &url, std::shared_ptr<Data> data, napi_env env,
                                              const std::string &taskId)
 {
@@ -269,8 +309,9 @@ void CallbackManager::InvokeSuccessCallbacks(const std::string &url, std::shared
 
     int32_t ret = napi_send_event(
         info->env_,
-        [url, info]() {
+        [url, info, data]() {
             napi_value values[2] = {nullptr};
+            values[0] = CreateDataBuffer(info->env_, data);
             info->InvokeSuccessCallbacks(values);
         },
         napi_eprio_high,
@@ -385,6 +426,22 @@ PreloadCallback CreatePreloadCallback(napi_env env, const std::string url)
     };
 }
 
+static void GetDownloadOptions(
+    napi_env env, napi_value arg, std::unique_ptr<PreloadOptions> &options, CacheStrategy &strategy)
+{
+    SetOptionsHeaders(env, arg, options);
+    SetOptionsSslType(env, arg, options);
+    napi_value napiCaPath = GetNamedProperty(env, arg, "caPath");
+    if (napiCaPath != nullptr) {
+        std::string caPath = GetStringValueWithDefault(env, napiCaPath);
+        options->caPath = caPath;
+    }
+    SetOptionsPriority(env, arg, options);
+    SetOptionsCompression(env, arg, options);
+    SetOptionsTag(env, arg, options);
+    GetCacheStrategy(env, arg, strategy);
+}
+
 napi_value download(napi_env env, napi_callback_info info)
 {
     if (!CheckInternetPermission()) {
@@ -406,17 +463,81 @@ napi_value download(napi_env env, napi_callback_info info)
     }
     std::string url = GetValueString(env, args[0], urlLength);
     std::unique_ptr<PreloadOptions> options = std::make_unique<PreloadOptions>();
-    SetOptionsHeaders(env, args[1], options);
-    SetOptionsSslType(env, args[1], options);
-    napi_value napiCaPath = GetNamedProperty(env, args[1], "caPath");
-    if (napiCaPath != nullptr) {
-        std::string caPath = GetStringValueWithDefault(env, napiCaPath);
-        options->caPath = caPath;
-    }
-    bool isUpdate = true;
-    GetCacheStrategy(env, args[1], isUpdate);
+    CacheStrategy strategy = CacheStrategy::FORCE;
+    GetDownloadOptions(env, args[1], options, strategy);
     auto jsCallback = CreatePreloadCallback(env, url);
-    Preload::GetInstance()->load(url, std::make_unique<PreloadCallback>(jsCallback), std::move(options), isUpdate);
+    Preload::GetInstance()->load(url, std::make_unique<PreloadCallback>(jsCallback), std::move(options), strategy);
+    return nullptr;
+}
+
+napi_value downloadBatch(napi_env env, napi_callback_info info)
+{
+    if (!CheckInternetPermission()) {
+        ThrowError(env, E_PERMISSION, "internet permission denied");
+        REQUEST_HILOGI("internet permission denied");
+        return nullptr;
+    }
+    size_t argc = 2;
+    napi_value args[2] = { nullptr };
+    NAPI_CALL(env, napi_get_cb_info(env, info, &argc, args, nullptr, nullptr));
+    bool isArray = false;
+    napi_is_array(env, args[0], &isArray);
+    if (!isArray || GetValueType(env, args[1]) != napi_object) {
+        ThrowError(env, E_PARAMETER_CHECK, "parameter error");
+        return nullptr;
+    }
+    uint32_t length = 0;
+    NAPI_CALL(env, napi_get_array_length(env, args[0], &length));
+    std::vector<std::string> urls;
+    urls.reserve(length);
+    std::vector<std::unique_ptr<PreloadCallback>> callbacks;
+    callbacks.reserve(length);
+    for (uint32_t i = 0; i < length; i++) {
+        napi_value napiUrl = nullptr;
+        if (napi_get_element(env, args[0], i, &napiUrl) != napi_ok || GetValueType(env, napiUrl) != napi_string) {
+            ThrowError(env, E_PARAMETER_CHECK, "parameter error");
+            return nullptr;
+        }
+        size_t urlLength = GetStringLength(env, napiUrl);
+        if (urlLength > MAX_UTL_LENGTH) {
+            ThrowError(env, E_PARAMETER_CHECK, "url exceeds the maximum length");
+            return nullptr;
+        }
+        urls.push_back(GetValueString(env, napiUrl, urlLength));
+    }
+    for (const std::string &url : urls) {
+        callbacks.push_back(std::make_unique<PreloadCallback>(CreatePreloadCallback(env, url)));
+    }
+    std::unique_ptr<PreloadOptions> options = std::make_unique<PreloadOptions>();
+    CacheStrategy strategy = CacheStrategy::FORCE;
+    GetDownloadOptions(env, args[1], options, strategy);
+    Preload::GetInstance()->loadBatch(urls, std::move(callbacks), std::move(options), strategy);
+    return nullptr;
+}
+
+napi_value prewarm(napi_env env, napi_callback_info info)
+{
+    if (!CheckInternetPermission()) {
+        ThrowError(env, E_PERMISSION, "internet permission denied");
+        REQUEST_HILOGI("internet permission denied");
+        return nullptr;
+    }
+    size_t argc = 1;
+    napi_value args[1] = { nullptr };
+    NAPI_CALL(env, napi_get_cb_info(env, info, &argc, args, nullptr, nullptr));
+    if (GetValueType(env, args[0]) != napi_string) {
+        ThrowError(env, E_PARAMETER_CHECK, "parameter error");
+        return nullptr;
+    }
+    size_t originLength = GetStringLength(env, args[0]);
+    if (originLength > MAX_UTL_LENGTH) {
+        ThrowError(env, E_PARAMETER_CHECK, "origin exceeds the maximum length");
+        return nullptr;
+    }
+    std::string origin = GetValueString(env, args[0], originLength);
+    if (!Preload::GetInstance()->Prewarm(origin)) {
+        ThrowError(env, E_PARAMETER_CHECK, "origin is not a valid http or https origin");
+    }
     return nullptr;
 }
 
@@ -439,6 +560,180 @@ napi_value cancel(napi_env env, napi_callback_info info)
     return nullptr;
 }
 
+static bool GetTag(napi_env env, napi_value arg, std::string &tag)
+{
+    if (GetValueType(env, arg) != napi_string) {
+        ThrowError(env, E_PARAMETER_CHECK, "parameter error");
+        return false;
+    }
+    size_t tagLength = GetStringLength(env, arg);
+    if (tagLength > MAX_TAG_LENGTH) {
+        ThrowError(env, E_PARAMETER_CHECK, "tag exceeds the maximum length");
+        return false;
+    }
+    tag = GetValueString(env, arg, tagLength);
+    return true;
+}
+
+napi_value cancelTag(napi_env env, napi_callback_info info)
+{
+    size_t argc = 1;
+    napi_value args[1] = { nullptr };
+    NAPI_CALL(env, napi_get_cb_info(env, info, &argc, args, nullptr, nullptr));
+    std::string tag;
+    if (!GetTag(env, args[0], tag)) {
+        return nullptr;
+    }
+    Preload::GetInstance()->CancelTag(tag);
+    return nullptr;
+}
+
+napi_value setTagPriority(napi_env env, napi_callback_info info)
+{
+    size_t argc = 2;
+    napi_value args[2] = { nullptr };
+    NAPI_CALL(env, napi_get_cb_info(env, info, &argc, args, nullptr, nullptr));
+    std::string tag;
+    if (!GetTag(env, args[0], tag)) {
+        return nullptr;
+    }
+    if (GetValueType(env, args[1]) != napi_number) {
+        ThrowError(env, E_PARAMETER_CHECK, "parameter error");
+        return nullptr;
+    }
+    int64_t priority = std::clamp<int64_t>(GetValueNum(env, args[1]), INT32_MIN, INT32_MAX);
+    Preload::GetInstance()->SetTagPriority(tag, static_cast<int32_t>(priority));
+    return nullptr;
+}
+
+napi_value removeTag(napi_env env, napi_callback_info info)
+{
+    size_t argc = 1;
+    napi_value args[1] = { nullptr };
+    NAPI_CALL(env, napi_get_cb_info(env, info, &argc, args, nullptr, nullptr));
+    std::string tag;
+    if (!GetTag(env, args[0], tag)) {
+        return nullptr;
+    }
+    Preload::GetInstance()->RemoveTag(tag);
+    return nullptr;
+}
+
+// Returns the cached bytes of a URL right away, undefined if it is not cached. A RAM hit and a large file, which
+// is mapped, are not copied. A small file is read on the calling thread, fetchAsync reads it in the background.
+napi_value fetch(napi_env env, napi_callback_info info)
+{
+    size_t argc = 1;
+    napi_value args[1] = { nullptr };
+    NAPI_CALL(env, napi_get_cb_info(env, info, &argc, args, nullptr, nullptr));
+    if (GetValueType(env, args[0]) != napi_string) {
+        ThrowError(env, E_PARAMETER_CHECK, "parameter error");
+        return nullptr;
+    }
+    size_t urlLength = GetStringLength(env, args[0]);
+    if (urlLength > MAX_UTL_LENGTH) {
+        ThrowError(env, E_PARAMETER_CHECK, "url exceeds the maximum length");
+        return nullptr;
+    }
+    std::string url = GetValueString(env, args[0], urlLength);
+    std::optional<Data> data = Preload::GetInstance()->fetch(url);
+    if (!data.has_value()) {
+        return nullptr;
+    }
+    return CreateDataBuffer(env, std::make_shared<Data>(std::move(*data)));
+}
+
+struct FetchContext {
+    napi_async_work work = nullptr;
+    napi_deferred deferred = nullptr;
+    std::string url;
+    std::optional<Data> data;
+};
+
+static void ExecuteFetch(napi_env env, void *data)
+{
+    auto *context = static_cast<FetchContext *>(data);
+    context->data = Preload::GetInstance()->fetch(context->url);
+}
+
+static void CompleteFetch(napi_env env, napi_status status, void *data)
+{
+    auto *context = static_cast<FetchContext *>(data);
+    napi_value result = nullptr;
+    if (status == napi_ok && context->data.has_value()) {
+        result = CreateDataBuffer(env, std::make_shared<Data>(std::move(*context->data)));
+    }
+    if (result == nullptr) {
+        napi_get_undefined(env, &result);
+    }
+    napi_resolve_deferred(env, context->deferred, result);
+    napi_delete_async_work(env, context->work);
+    delete context;
+}
+
+// Like fetch, but looks the URL up off the JS thread and resolves the returned promise with the bytes.
+napi_value fetchAsync(napi_env env, napi_callback_info info)
+{
+    size_t argc = 1;
+    napi_value args[1] = { nullptr };
+    NAPI_CALL(env, napi_get_cb_info(env, info, &argc, args, nullptr, nullptr));
+    if (GetValueType(env, args[0]) != napi_string) {
+        ThrowError(env, E_PARAMETER_CHECK, "parameter error");
+        return nullptr;
+    }
+    size_t urlLength = GetStringLength(env, args[0]);
+    if (urlLength > MAX_UTL_LENGTH) {
+        ThrowError(env, E_PARAMETER_CHECK, "url exceeds the maximum length");
+        return nullptr;
+    }
+    auto context = std::make_unique<FetchContext>();
+    context->url = GetValueString(env, args[0], urlLength);
+    napi_value promise = nullptr;
+    NAPI_CALL(env, napi_create_promise(env, &context->deferred, &promise));
+    napi_value resourceName = nullptr;
+    NAPI_CALL(env, napi_create_string_utf8(env, "fetchAsync", NAPI_AUTO_LENGTH, &resourceName));
+    NAPI_CALL(env, napi_create_async_work(
+        env, nullptr, resourceName, ExecuteFetch, CompleteFetch, context.get(), &context->work));
+    if (napi_queue_async_work(env, context->work) != napi_ok) {
+        napi_delete_async_work(env, context->work);
+        napi_value undefined = nullptr;
+        napi_get_undefined(env, &undefined);
+        napi_resolve_deferred(env, context->deferred, undefined);
+        return promise;
+    }
+    context.release();
+    return promise;
+}
+
+napi_value fetchRange(napi_env env, napi_callback_info info)
+{
+    size_t argc = 3;
+    napi_value args[3] = { nullptr };
+    NAPI_CALL(env, napi_get_cb_info(env, info, &argc, args, nullptr, nullptr));
+    if (GetValueType(env, args[0]) != napi_string || GetValueType(env, args[1]) != napi_number
+        || GetValueType(env, args[2]) != napi_number) {
+        ThrowError(env, E_PARAMETER_CHECK, "parameter error");
+        return nullptr;
+    }
+    size_t urlLength = GetStringLength(env, args[0]);
+    if (urlLength > MAX_UTL_LENGTH) {
+        ThrowError(env, E_PARAMETER_CHECK, "url exceeds the maximum length");
+        return nullptr;
+    }
+    int64_t offset = GetValueNum(env, args[1]);
+    int64_t length = GetValueNum(env, args[2]);
+    if (offset < 0 || length < 0) {
+        ThrowError(env, E_PARAMETER_CHECK, "offset and length must not be negative");
+        return nullptr;
+    }
+    std::string url = GetValueString(env, args[0], urlLength);
+    std::optional<Data> data = Preload::GetInstance()->fetch(url, offset, length);
+    if (!data.has_value()) {
+        return nullptr;
+    }
+    return CreateDataBuffer(env, std::make_shared<Data>(std::move(*data)));
+}
+
 napi_value setMemoryCacheSize(napi_env env, napi_callback_info info)
 {
     size_t argc = 1;
@@ -529,6 +824,72 @@ napi_value getDownloadInfo(napi_env env, napi_callback_info info)
     return BuildDownloadInfo(env, result.value());
 }
 
+static napi_value BuildTimingPercentiles(napi_env env, const TimingPercentiles &percentiles)
+{
+    napi_value value = nullptr;
+    napi_create_object(env, &value);
+    std::pair<const char *, double> fields[] = {
+        { "p50", percentiles.p50 },
+        { "p95", percentiles.p95 },
+        { "p99", percentiles.p99 },
+    };
+    for (const auto &[name, number] : fields) {
+        napi_value field = nullptr;
+        napi_create_double(env, number, &field);
+        napi_set_named_property(env, value, name, field);
+    }
+    return value;
+}
+
+static napi_value BuildOriginTimingStats(napi_env env, const OriginTimingStats &stats)
+{
+    napi_value value = nullptr;
+    napi_create_object(env, &value);
+    napi_set_named_property(env, value, "origin", Convert2JSValue(env, stats.origin));
+    napi_value count = nullptr;
+    napi_create_int64(env, static_cast<int64_t>(stats.count), &count);
+    napi_set_named_property(env, value, "count", count);
+    std::pair<const char *, const TimingPercentiles *> timings[] = {
+        { "dns", &stats.dns },
+        { "connect", &stats.connect },
+        { "tls", &stats.tls },
+        { "ttfb", &stats.ttfb },
+        { "total", &stats.total },
+    };
+    for (const auto &[name, percentiles] : timings) {
+        napi_set_named_property(env, value, name, BuildTimingPercentiles(env, *percentiles));
+    }
+    return value;
+}
+
+napi_value getTimingStats(napi_env env, napi_callback_info info)
+{
+    if (!CheckNetworkInfoPermission()) {
+        ThrowError(env, E_PERMISSION, "GET_NETWORK_INFO permission denied");
+        REQUEST_HILOGI("GET_NETWORK_INFO permission denied");
+        return nullptr;
+    }
+    size_t argc = 1;
+    napi_value args[1] = { nullptr };
+    NAPI_CALL(env, napi_get_cb_info(env, info, &argc, args, nullptr, nullptr));
+    if (GetValueType(env, args[0]) != napi_number) {
+        ThrowError(env, E_PARAMETER_CHECK, "parameter error");
+        return nullptr;
+    }
+    int64_t windowSecs = GetValueNum(env, args[0]);
+    if (windowSecs <= 0) {
+        ThrowError(env, E_PARAMETER_CHECK, "window must be positive");
+        return nullptr;
+    }
+    std::vector<OriginTimingStats> stats = Preload::GetInstance()->GetTimingStats(static_cast<uint64_t>(windowSecs));
+    napi_value result = nullptr;
+    NAPI_CALL(env, napi_create_array_with_length(env, stats.size(), &result));
+    for (size_t i = 0; i < stats.size(); i++) {
+        napi_set_element(env, result, i, BuildOriginTimingStats(env, stats[i]));
+    }
+    return result;
+}
+
 napi_value clearMemoryCache(napi_env env, napi_callback_info info)
 {
     Preload::GetInstance()->ClearMemoryCache();
@@ -711,6 +1072,8 @@ static void NapiCreateEnumCacheStrategy(napi_env env, napi_value &cacheStrategy)
     napi_create_object(env, &cacheStrategy);
     SetUint32Property(env, cacheStrategy, "FORCE", static_cast<uint32_t>(CacheStrategy::FORCE));
     SetUint32Property(env, cacheStrategy, "LAZY", static_cast<uint32_t>(CacheStrategy::LAZY));
+    SetUint32Property(env, cacheStrategy, "STALE_WHILE_REVALIDATE",
+        static_cast<uint32_t>(CacheStrategy::STALE_WHILE_REVALIDATE));
 }
 
 static void NapiCreateEnumErrorCode(napi_env env, napi_value &errorCode)
@@ -736,11 +1099,20 @@ static napi_value registerFunc(napi_env env, napi_value exports)
         DECLARE_NAPI_PROPERTY("CacheStrategy", cacheStrategy),
         DECLARE_NAPI_PROPERTY("ErrorCode", errorCode),
         DECLARE_NAPI_FUNCTION("download", download),
+        DECLARE_NAPI_FUNCTION("downloadBatch", downloadBatch),
         DECLARE_NAPI_FUNCTION("cancel", cancel),
+        DECLARE_NAPI_FUNCTION("cancelTag", cancelTag),
+        DECLARE_NAPI_FUNCTION("setTagPriority", setTagPriority),
+        DECLARE_NAPI_FUNCTION("removeTag", removeTag),
+        DECLARE_NAPI_FUNCTION("prewarm", prewarm),
+        DECLARE_NAPI_FUNCTION("fetch", fetch),
+        DECLARE_NAPI_FUNCTION("fetchAsync", fetchAsync),
+        DECLARE_NAPI_FUNCTION("fetchRange", fetchRange),
         DECLARE_NAPI_FUNCTION("setMemoryCacheSize", setMemoryCacheSize),
         DECLARE_NAPI_FUNCTION("setFileCacheSize", setFileCacheSize),
         DECLARE_NAPI_FUNCTION("setDownloadInfoListSize", setDownloadInfoListSize),
         DECLARE_NAPI_FUNCTION("getDownloadInfo", getDownloadInfo),
+        DECLARE_NAPI_FUNCTION("getTimingStats", getTimingStats),
         DECLARE_NAPI_FUNCTION("clearMemoryCache", clearMemoryCache),
         DECLARE_NAPI_FUNCTION("clearFileCache", clearFileCache),
         DECLARE_NAPI_FUNCTION("onDownloadSuccess", onDownloadSuccess),
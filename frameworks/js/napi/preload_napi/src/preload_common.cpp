@@ -13,9 +13,11 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <cstdint>
 #include <mutex>
 #include <string>
+#include <utility>
 
 #include "base/request/request/common/include/constant.h"
 #include "js_native_api.h"
@@ -25,6 +27,7 @@
 
 static const std::string SSL_TYPE_TLS = "TLS";
 static const std::string SSL_TYPE_TLCP = "TLCP";
+static constexpr size_t MAX_TAG_LENGTH = 128;
 
 namespace OHOS::Request {
 
@@ -69,22 +72,54 @@ void SetOptionsSslType(napi_env env, napi_value arg, std::unique_ptr<PreloadOpti
     }
 }
 
-void GetCacheStrategy(napi_env env, napi_value arg, bool &isUpdate)
+void SetOptionsPriority(napi_env env, napi_value arg, std::unique_ptr<PreloadOptions> &options)
 {
+    napi_value napiPriority = GetNamedProperty(env, arg, "priority");
+    if (napiPriority == nullptr || GetValueType(env, napiPriority) != napi_number) {
+        return;
+    }
+    int64_t priority = GetValueNum(env, napiPriority);
+    priority = std::clamp<int64_t>(priority, INT32_MIN, INT32_MAX);
+    options->priority = static_cast<int32_t>(priority);
+}
+
+void SetOptionsCompression(napi_env env, napi_value arg, std::unique_ptr<PreloadOptions> &options)
+{
+    napi_value napiCompression = GetNamedProperty(env, arg, "compression");
+    if (napiCompression == nullptr || GetValueType(env, napiCompression) != napi_boolean) {
+        return;
+    }
+    bool compression = false;
+    if (napi_get_value_bool(env, napiCompression, &compression) == napi_ok) {
+        options->compression = compression;
+    }
+}
+
+void SetOptionsTag(napi_env env, napi_value arg, std::unique_ptr<PreloadOptions> &options)
+{
+    napi_value napiTag = GetNamedProperty(env, arg, "tag");
+    if (napiTag == nullptr || GetValueType(env, napiTag) != napi_string) {
+        return;
+    }
+    size_t tagLength = GetStringLength(env, napiTag);
+    if (tagLength > MAX_TAG_LENGTH) {
+        return;
+    }
+    options->tag = GetValueString(env, napiTag, tagLength);
+}
+
+void GetCacheStrategy(napi_env env, napi_value arg, CacheStrategy &strategy)
+{
+    strategy = CacheStrategy::FORCE;
     napi_value napiCacheStrategy = GetNamedProperty(env, arg, "cacheStrategy");
-    if (napiCacheStrategy != nullptr) {
-        if (GetValueType(env, napiCacheStrategy) != napi_number) {
-            isUpdate = true;
-            return;
-        }
-        int64_t numCacheStrategy = GetValueNum(env, napiCacheStrategy);
-        if (numCacheStrategy == static_cast<int64_t>(CacheStrategy::LAZY)) {
-            isUpdate = false;
-        } else {
-            isUpdate = true;
-        }
-    } else {
-        isUpdate = true;
+    if (napiCacheStrategy == nullptr || GetValueType(env, napiCacheStrategy) != napi_number) {
+        return;
+    }
+    int64_t numCacheStrategy = GetValueNum(env, napiCacheStrategy);
+    if (numCacheStrategy == static_cast<int64_t>(CacheStrategy::LAZY)) {
+        strategy = CacheStrategy::LAZY;
+    } else if (numCacheStrategy == static_cast<int64_t>(CacheStrategy::STALE_WHILE_REVALIDATE)) {
+        strategy = CacheStrategy::STALE_WHILE_REVALIDATE;
     }
 }
 
@@ -158,6 +193,30 @@ bool BuildInfoNetwork(napi_env env, const CppDownloadInfo &result, napi_value &j
     if (status != napi_ok) {
         return false;
     }
+    napi_value reused;
+    status = napi_get_boolean(env, result.connection_reused(), &reused);
+    if (status != napi_ok) {
+        return false;
+    }
+    status = napi_set_named_property(env, network, "connectionReused", reused);
+    if (status != napi_ok) {
+        return false;
+    }
+    std::pair<const char *, uint64_t> poolCounters[] = {
+        { "poolHits", result.pool_hits() },
+        { "poolMisses", result.pool_misses() },
+    };
+    for (const auto &[name, count] : poolCounters) {
+        napi_value value;
+        status = napi_create_int64(env, static_cast<int64_t>(count), &value);
+        if (status != napi_ok) {
+            return false;
+        }
+        status = napi_set_named_property(env, network, name, value);
+        if (status != napi_ok) {
+            return false;
+        }
+    }
     status = napi_set_named_property(env, jsInfo, "network", network);
     if (status != napi_ok) {
         return false;
@@ -20,6 +20,7 @@
 #include <new>
 #include <string>
 
+#include "async_worker.h"
 #include "constant.h"
 #include "log.h"
 #include "napi/native_node_api.h"
@@ -38,7 +39,7 @@ public:
         virtual ~Context()
         {
             ContextNapiHolder *holder = new (std::nothrow)
-                ContextNapiHolder{ .env = env_, .callbackRef = callbackRef_, .self = self_, .work = work_ };
+                ContextNapiHolder{ .env = env_, .callbackRef = callbackRef_, .self = self_ };
             if (holder == nullptr) {
                 REQUEST_HILOGE("new ContextNapiHolder null");
                 return;
@@ -50,13 +51,14 @@ public:
                 if (status != napi_ok || scope == nullptr) {
                     delete holder;
                     return;
-                } else if (holder->env == nullptr || holder->work == nullptr || holder->self == nullptr) {
+                } else if (holder->env == nullptr) {
                     napi_close_handle_scope(holder->env, scope);
                     delete holder;
                     return;
                 }
-                napi_delete_async_work(holder->env, holder->work);
-                napi_delete_reference(holder->env, holder->self);
+                if (holder->self != nullptr) {
+                    napi_delete_reference(holder->env, holder->self);
+                }
                 if (holder->callbackRef != nullptr) {
                     napi_delete_reference(holder->env, holder->callbackRef);
                 }
@@ -89,6 +91,9 @@ public:
         {
             ExceptionError error;
             NapiUtils::ConvertError(innerCode_, error);
+            if (error.errInfo.empty()) {
+                error.errInfo = errInfo_;
+            }
             return NapiUtils::CreateBusinessError(env_, error.code, error.errInfo, withErrCode_);
         }
 
@@ -100,9 +105,9 @@ public:
         napi_ref callbackRef_ = nullptr;
         napi_ref self_ = nullptr;
         napi_deferred defer_ = nullptr;
-        napi_async_work work_ = nullptr;
 
         int32_t innerCode_;
+        std::string errInfo_;
         bool withErrCode_;
         Version version_;
     };
@@ -111,31 +116,26 @@ public:
     ~AsyncCall();
     napi_value Call(const std::shared_ptr<Context> &context, const std::string &resourceName = "AsyncCall");
 
-    inline void SetQosLevel(napi_qos_t napiQosLevel)
-    {
-        napiQosLevel_ = napiQosLevel;
-    }
-
 private:
     enum { ARG_ERROR, ARG_DATA, ARG_BUTT };
 
-    struct WorkData {
-        std::shared_ptr<Context> ctx = nullptr;
-        ~WorkData()
+    class Work : public AsyncWork {
+    public:
+        explicit Work(const std::shared_ptr<Context> &ctx) : AsyncWork(ctx->env_), ctx_(ctx)
         {
-            ctx = nullptr;
         }
+        void Execute() override;
+        void Complete(napi_env env) override;
+
+    private:
+        std::shared_ptr<Context> ctx_;
     };
 
     struct ContextNapiHolder {
         napi_env env;
         napi_ref callbackRef;
         napi_ref self;
-        napi_async_work work;
     };
-    static void OnExecute(napi_env env, void *data);
-    static void OnComplete(napi_env env, napi_status status, void *data);
-    napi_qos_t napiQosLevel_ = napi_qos_default;
 };
 } // namespace OHOS::Request
 #endif // ASYNC_CALL_H
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_REQUEST_ASYNC_WORKER_H
+#define OHOS_REQUEST_ASYNC_WORKER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+#include "napi/native_api.h"
+
+namespace OHOS::Request {
+
+// Work of a JS call, executed off the JS thread then completed on it.
+class AsyncWork {
+public:
+    explicit AsyncWork(napi_env env) : env_(env)
+    {
+    }
+    virtual ~AsyncWork() = default;
+    // Runs on the worker thread, may block on the service.
+    virtual void Execute() = 0;
+    // Runs on the JS thread of the env, in a handle scope.
+    virtual void Complete(napi_env env) = 0;
+
+private:
+    friend class AsyncWorker;
+    napi_env env_;
+    AsyncWork *next_ = nullptr;
+};
+
+// Thread of the request module executing the work of its JS calls, instead of the libuv pool every module of
+// the application shares. Submitting pushes on a lock-free stack, the thread takes the whole stack at once and
+// completes the work it executed with one event per env.
+class AsyncWorker {
+public:
+    static AsyncWorker &GetInstance();
+    // Queues the work, which is deleted once completed.
+    void Submit(AsyncWork *work);
+    // Completes work with nothing to execute, on the next turn of the JS thread.
+    static void Complete(AsyncWork *work);
+
+private:
+    AsyncWorker() = default;
+    void Run();
+    // Takes the queued work, oldest first, waiting for some if there is none.
+    AsyncWork *Take();
+    // Completes a list of work of one env with a single event.
+    static void Post(napi_env env, AsyncWork *list);
+
+    std::atomic<AsyncWork *> head_ = nullptr;
+    std::once_flag started_;
+    // Only used to park the thread while there is no work.
+    std::mutex mutex_;
+    std::condition_variable cond_;
+};
+
+} // namespace OHOS::Request
+
+#endif // OHOS_REQUEST_ASYNC_WORKER_H
@@ -45,6 +45,7 @@ public:
     static void StringTrim(std::string &str);
     static bool CreateDirs(const std::vector<std::string> &pathDirs);
     static bool FindDir(const std::string &pathDir);
+    static ExceptionError CheckFiles(JsTask *task);
 
 private:
     static ExceptionError InitParam(
@@ -59,9 +60,14 @@ private:
     static bool ParseUrl(napi_env env, napi_value jsConfig, std::string &url, std::string &errInfo);
     static bool ParseNotification(napi_env env, napi_value jsConfig, Config &config, std::string &errInfo);
     static bool ParseMinSpeed(napi_env env, napi_value jsConfig, Config &config, std::string &errInfo);
+    static bool ParseStallDetection(napi_env env, napi_value jsConfig, Config &config, std::string &errInfo);
+    static bool ParseConcurrency(napi_env env, napi_value jsConfig, Config &config, std::string &errInfo);
+    static bool ParseChunkSize(napi_env env, napi_value jsConfig, Config &config, std::string &errInfo);
+    static bool ParseDeadline(napi_env env, napi_value jsConfig, Config &config, std::string &errInfo);
+    static bool ParseMaxCallbackFrequency(napi_env env, napi_value jsConfig, Config &config, std::string &errInfo);
     static bool ParseProxy(napi_env env, napi_value jsConfig, std::string &proxy, std::string &errInfo);
-    static bool ParseCertsPath(
-        napi_env env, napi_value jsConfig, std::vector<std::string> &certsPath, std::string &errInfo);
+    static bool ParseChecksum(napi_env env, napi_value jsConfig, Config &config, std::string &errInfo);
+    static void GetCertsPath(const std::string &url, std::vector<std::string> &certsPath);
     static bool ParseData(napi_env env, napi_value jsConfig, Config &config, std::string &errInfo);
     static bool ParseIndex(napi_env env, napi_value jsConfig, Config &config, std::string &errInfo);
     static bool ParseName(napi_env env, napi_value jsVal, std::string &name);
@@ -90,14 +96,15 @@ private:
     static bool Convert2FileSpecs(
         napi_env env, napi_value jsValue, const std::string &name, std::vector<FileSpec> &files);
     static bool Convert2FileSpec(napi_env env, napi_value jsValue, const std::string &name, FileSpec &file);
+    static bool Convert2MemoryFile(napi_env env, napi_value jsData, FileSpec &file);
     static bool GetInternalPath(const std::shared_ptr<OHOS::AbilityRuntime::Context> &context, const Config &config,
         std::string &path, std::string &errInfo);
 
     static bool CheckUploadBodyFiles(const std::string &filePath, Config &config, ExceptionError &error);
     static bool CheckPathIsFile(const std::string &path, ExceptionError &error);
     static bool CheckPathOverWrite(const std::string &path, const Config &config, ExceptionError &error);
-    static bool GetFdUpload(const std::string &path, const Config &config, ExceptionError &error);
-    static bool GetFdDownload(const std::string &path, const Config &config, ExceptionError &error);
+    static bool GetFdUpload(const std::string &path, const Config &config, int32_t &fd, ExceptionError &error);
+    static bool GetFdDownload(const std::string &path, const Config &config, int32_t &fd, ExceptionError &error);
     static void StandardizePathApi9(std::string &path);
     static bool InterceptData(const std::string &str, const std::string &in, std::string &out);
     static bool IsStageMode(napi_env env, napi_value value);
@@ -16,8 +16,14 @@
 #ifndef REQUEST_JS_NOTIFY_DATA_LISTENER_H
 #define REQUEST_JS_NOTIFY_DATA_LISTENER_H
 
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <vector>
+
 #include "i_notify_data_listener.h"
 #include "listener_list.h"
+#include "notify_delivery.h"
 #include "request_common.h"
 
 namespace OHOS::Request {
@@ -37,12 +43,20 @@ public:
     void OnFaultsReceive(const std::shared_ptr<int32_t> &tid, const std::shared_ptr<SubscribeType> &type,
         const std::shared_ptr<Reason> &reason) override;
     void OnWaitReceive(std::int32_t taskId, WaitingReason reason) override;
+    // Progress notifications closer than `interval` ms to the last delivered one are dropped, 0 delivers all.
+    void SetMinInterval(uint64_t interval);
 
 private:
+    friend class JSNotifyQueue;
+    static bool IsIntermediateProgress(const std::shared_ptr<NotifyData> &notifyData);
+    bool Throttled(const std::shared_ptr<NotifyData> &notifyData);
     bool IsHeaderReceive(const std::shared_ptr<NotifyData> &notifyData);
     void ProcessHeaderReceive(const std::shared_ptr<NotifyData> &notifyData);
     void NotifyDataProcess(const std::shared_ptr<NotifyData> &notifyData, napi_value *value, uint32_t &paramNumber);
     void DoJSTask(const std::shared_ptr<NotifyData> &notifyData);
+
+    std::atomic<uint64_t> minInterval_{ 0 };
+    std::atomic<uint64_t> lastProgress_{ 0 };
 };
 
 struct NotifyDataPtr {
@@ -50,6 +64,32 @@ struct NotifyDataPtr {
     std::shared_ptr<JSNotifyDataListener> listener = nullptr;
 };
 
+// Notifications waiting for the JS thread of an env. They are all delivered by one posted task in one handle
+// scope, and a pending intermediate progress is replaced by a newer one of the same listener. At most CAPACITY
+// wait, past it the oldest intermediate progress is dropped, as in NotifyDelivery.
+class JSNotifyQueue : public std::enable_shared_from_this<JSNotifyQueue> {
+public:
+    explicit JSNotifyQueue(napi_env env) : env_(env)
+    {
+    }
+    static std::shared_ptr<JSNotifyQueue> GetInstance(napi_env env);
+    void Push(const std::shared_ptr<JSNotifyDataListener> &listener, const std::shared_ptr<NotifyData> &notifyData);
+
+private:
+    static constexpr size_t CAPACITY = 512;
+
+    static void RemoveInstance(void *env);
+    void Drain();
+
+    static std::mutex instancesMutex_;
+    static std::map<napi_env, std::shared_ptr<JSNotifyQueue>> instances_;
+
+    const napi_env env_;
+    std::mutex mutex_;
+    std::vector<NotifyDataPtr> pending_;
+    bool posted_ = false;
+};
+
 struct ReasonDataPtr {
     std::shared_ptr<JSNotifyDataListener> listener = nullptr;
     std::shared_ptr<Reason> reason = nullptr;
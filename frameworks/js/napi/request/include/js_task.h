@@ -21,6 +21,10 @@
 #include "js_response_listener.h"
 #include "request_common.h"
 
+namespace OHOS::AbilityRuntime {
+class Context;
+} // namespace OHOS::AbilityRuntime
+
 namespace OHOS::Request {
 class JsTask {
 public:
@@ -45,7 +49,12 @@ public:
     static napi_value Show(napi_env env, napi_callback_info info);
     static napi_value Touch(napi_env env, napi_callback_info info);
     static napi_value Search(napi_env env, napi_callback_info info);
+    static napi_value SearchPage(napi_env env, napi_callback_info info);
     static napi_value Query(napi_env env, napi_callback_info info);
+    static napi_value CreateBatch(napi_env env, napi_callback_info info);
+    static napi_value StartBatch(napi_env env, napi_callback_info info);
+    static napi_value QueryBatch(napi_env env, napi_callback_info info);
+    static napi_value GetProgressSnapshot(napi_env env, napi_callback_info info);
 
     std::string GetTid();
     void SetTid(std::string &tid);
@@ -60,6 +69,8 @@ public:
 
     Config config_;
     bool isGetPermission;
+    // Context of a new task until its files are checked by the create work.
+    std::shared_ptr<OHOS::AbilityRuntime::Context> context_;
     static bool register_;
     static std::mutex taskMutex_;
     static std::map<std::string, std::shared_ptr<ContextInfo>> taskContextMap_;
@@ -102,6 +113,10 @@ private:
     static ExceptionError ParseGetTask(
         napi_env env, size_t argc, napi_value *argv, std::shared_ptr<ContextInfo> context);
     static ExceptionError ParseTid(napi_env env, size_t argc, napi_value *argv, std::string &tid);
+    static ExceptionError ParseBatch(napi_env env, napi_value value, const std::string &name, uint32_t max,
+        std::vector<napi_value> &elements);
+    static napi_value BatchResult(napi_env env, const std::vector<int32_t> &codes,
+        const std::function<napi_value(size_t)> &element);
     static napi_value TouchInner(napi_env env, napi_callback_info info, AsyncCall::Context::InputAction action,
         std::shared_ptr<TouchContext> context, int32_t req);
     static ExceptionError ParseSearch(napi_env env, size_t argc, napi_value *argv, Filter &filter);
@@ -109,6 +124,8 @@ private:
     static State ParseState(napi_env env, napi_value value);
     static Action ParseAction(napi_env env, napi_value value);
     static Mode ParseMode(napi_env env, napi_value value);
+    static std::string ParseKeyword(napi_env env, napi_value value);
+    static ExceptionError ParsePage(napi_env env, size_t argc, napi_value *argv, Filter &filter);
     static ExceptionError ParseTouch(
         napi_env env, size_t argc, napi_value *argv, std::shared_ptr<TouchContext> context);
     static int64_t ParseBefore(napi_env env, napi_value value);
@@ -120,6 +137,7 @@ private:
     static bool ParseTouchCheck(const napi_env env, const size_t argc, const napi_value *argv,
         const std::shared_ptr<TouchContext> context, ExceptionError &err);
     static int32_t AuthorizePath(const Config &config);
+    static int32_t OpenCachedBody(const Config &config);
     bool Equals(napi_env env, napi_value value, napi_ref copy);
 
     static std::mutex createMutex_;
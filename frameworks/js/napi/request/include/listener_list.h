@@ -16,9 +16,11 @@
 #ifndef REQUEST_LISTENER_LIST_H
 #define REQUEST_LISTENER_LIST_H
 
-#include <list>
+#include <atomic>
+#include <cstdint>
 #include <mutex>
 #include <string>
+#include <vector>
 
 #include "napi/native_api.h"
 #include "napi_utils.h"
@@ -33,7 +35,25 @@ public:
     bool HasListener();
     void DeleteAllListenerRef();
 
+    // Dispatches made while a `DispatchBatch` is alive share one handle scope, so each of them looks up the
+    // callbacks of a list only once.
+    class DispatchBatch {
+    public:
+        DispatchBatch();
+        ~DispatchBatch();
+        DispatchBatch(const DispatchBatch &) = delete;
+        DispatchBatch &operator=(const DispatchBatch &) = delete;
+    };
+
 protected:
+    struct Listener {
+        napi_ref ref = nullptr;
+        bool valid = true;
+        // The callback looked up in the dispatch batch `batch`.
+        napi_value callback = nullptr;
+        uint64_t batch = 0;
+    };
+
     bool IsListenerAdded(napi_value cb);
     void OnMessageReceive(napi_value *value, uint32_t paramNumber);
     napi_status AddListenerInner(napi_value cb);
@@ -43,9 +63,17 @@ protected:
     const napi_env env_;
     const std::string taskId_;
     const SubscribeType type_;
-    std::list<std::pair<bool, napi_ref>> allCb_;
-    std::recursive_mutex allCbMutex_;
+    // Only changed on the JS thread, removed listeners are erased by the next dispatch.
+    std::vector<Listener> allCb_;
+    std::mutex allCbMutex_;
     std::atomic<uint32_t> validCbNum{ 0 };
+
+private:
+    napi_value GetCallback(Listener &listener);
+    void EraseRemoved();
+
+    uint32_t removedCbNum_ = 0;
+    uint32_t dispatchDepth_ = 0;
 };
 
 } // namespace OHOS::Request
@@ -30,6 +30,7 @@ class PathUtils {
 public:
     static bool AddPathsToMap(const std::string &path, const Action action);
     static bool SubPathsToMap(const std::string &path);
+    static bool AddDirToMap(const std::string &dir);
     static bool CheckBelongAppBaseDir(const std::string &filepath);
     static std::string ShieldPath(const std::string &path);
 };
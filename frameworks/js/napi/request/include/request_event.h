@@ -47,6 +47,8 @@ public:
     static napi_value Start(napi_env env, napi_callback_info info);
     static napi_value Stop(napi_env env, napi_callback_info info);
     static napi_value SetMaxSpeed(napi_env env, napi_callback_info info);
+    static napi_value GetPerformance(napi_env env, napi_callback_info info);
+    static int32_t CheckStart(JsTask *task);
     static std::map<Reason, DownloadErrorCode> failMap_;
 
 private:
@@ -57,12 +59,13 @@ private:
         napi_value self;
         JsTask *task;
     };
-    enum { BOOL_RES, STR_RES, INFO_RES };
+    enum { BOOL_RES, STR_RES, INFO_RES, PERFORMANCE_RES };
     struct ExecContext : public AsyncCall::Context {
         JsTask *task = nullptr;
         bool boolRes = false;
         std::string strRes;
         DownloadInfo infoRes;
+        TaskPerformance performanceRes;
         int64_t maxSpeed;
     };
 
@@ -82,6 +85,7 @@ private:
     static int32_t RemoveExec(const std::shared_ptr<ExecContext> &context);
     static int32_t ResumeExec(const std::shared_ptr<ExecContext> &context);
     static int32_t SetMaxSpeedExec(const std::shared_ptr<ExecContext> &context);
+    static int32_t GetPerformanceExec(const std::shared_ptr<ExecContext> &context);
 
     static napi_status ParseInputParameters(
         napi_env env, size_t argc, napi_value self, const std::shared_ptr<ExecContext> &context);
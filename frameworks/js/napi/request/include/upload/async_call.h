@@ -18,6 +18,7 @@
 #include <functional>
 #include <memory>
 
+#include "async_worker.h"
 #include "napi/native_api.h"
 #include "napi/native_common.h"
 #include "napi/native_node_api.h"
@@ -90,13 +91,19 @@ private:
     enum { ARG_ERROR, ARG_DATA, ARG_BUTT };
     static void OnExecute(napi_env env, void *data);
     static void OnComplete(napi_env env, napi_status status, void *data);
-    struct AsyncContext {
+    struct AsyncContext : public AsyncWork {
+        explicit AsyncContext(napi_env env) : AsyncWork(env)
+        {
+        }
+        void Execute() override;
+        void Complete(napi_env env) override;
+
         std::shared_ptr<Context> ctx = nullptr;
         napi_ref callback = nullptr;
         napi_ref self = nullptr;
         napi_deferred defer = nullptr;
-        napi_async_work work = nullptr;
     };
+    static void DeleteReferences(napi_env env, AsyncContext *context);
     static void DeleteContext(napi_env env, AsyncContext *context);
 
     AsyncContext *context_ = nullptr;
@@ -16,22 +16,26 @@
 #ifndef CURLADP_H
 #define CURLADP_H
 
+#include <functional>
 #include <mutex>
 #include <vector>
 
 #include "curl/curl.h"
 #include "curl/easy.h"
 #include "i_upload_task.h"
-#include "timer.h"
 #include "upload/upload_common.h"
 #include "upload_config.h"
 
 namespace OHOS::Request::Upload {
 class CUrlAdp : public std::enable_shared_from_this<CUrlAdp> {
 public:
+    using UploadDone = std::function<void(uint32_t result)>;
+
     CUrlAdp(std::vector<FileData> &fileArray, std::shared_ptr<UploadConfig> &config);
     virtual ~CUrlAdp();
-    uint32_t DoUpload(std::shared_ptr<IUploadTask> task);
+    // Uploads the files one after the other on the `UploadEngine`, then calls
+    // `done`, usually on the engine thread.
+    void DoUpload(std::shared_ptr<IUploadTask> task, UploadDone done);
     bool Remove();
     bool IsReadAbort()
     {
@@ -49,9 +53,10 @@ protected:
     static bool CheckCUrlAdp(FileData *fData);
 
 private:
-    int CheckUploadStatus(CURLM *curlMulti);
-    bool MultiAddHandle(CURLM *curlMulti, std::vector<CURL *> &curlArray);
-    int32_t UploadOneFile();
+    int CheckUploadStatus(CURL *curl, CURLcode code);
+    void UploadNext();
+    bool UploadOneFile();
+    void OnFileDone(CURL *curl, CURLcode code);
     bool IsSuccess(const uint32_t count, const uint32_t size);
     void SetCurlOpt(CURL *curl);
     void SetHeadData(CURL *curl);
@@ -62,14 +67,9 @@ private:
     void SetNetworkOpt(CURL *curl);
     void SetCallbackOpt(CURL *curl);
     void SetBehaviorOpt(CURL *curl);
-    std::string ReadCertification();
-    void CurlGlobalInit();
-    void CurlGlobalCleanup();
-    void StartTimer();
-    void StopTimer();
+    static std::string ReadCertification();
 
 private:
-    uint32_t timerId_;
     std::shared_ptr<IUploadTask> uploadTask_;
     std::vector<FileData> &fileDatas_;
     FileData mfileData_;
@@ -77,17 +77,15 @@ private:
     static constexpr int32_t HTTP_SUCCESS = 200;
     std::mutex mutex_;
     std::mutex curlMutex_;
-    std::mutex globalMutex_;
-    bool isCurlGlobalInit_;
-    CURLM *curlMulti_;
-    std::vector<CURL *> curlArray_;
+    CURL *curl_;
+    curl_mime *mime_;
+    size_t fileIndex_;
+    uint32_t successCount_;
+    UploadDone done_;
     bool isReadAbort_;
-    Utils::Timer timer_;
 
-    static constexpr int TRANS_TIMEOUT_MS = 300 * 1000;
     static constexpr int READFILE_TIMEOUT_MS = 30 * 1000;
     static constexpr int TIMEOUTTYPE = 1;
-    static constexpr int FILE_UPLOAD_INTERVAL = 1000;
     static constexpr int COLLECT_DO_FLAG = 1;
     static constexpr int COLLECT_END_FLAG = 2;
 };
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UPLOAD_ENGINE_H
+#define UPLOAD_ENGINE_H
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "curl/curl.h"
+
+namespace OHOS::Request::Upload {
+// Transfers of all the legacy uploads, driven by one thread.
+//
+// The engine owns a curl multi handle in socket mode: curl tells it which
+// sockets to watch and when its next timeout is due, and the engine thread
+// waits for both with epoll, so an idle upload costs no thread and no polling.
+// The engine thread is the only one touching the multi handle, other threads
+// hand it new transfers through a queue and wake it with an eventfd.
+//
+// Connections, DNS results and TLS sessions are kept in the multi handle and
+// in a share handle, so that files and tasks going to the same host reuse
+// them.
+class UploadEngine {
+public:
+    // Called on the engine thread once a transfer is over and its handle is
+    // out of the multi handle.
+    using Done = std::function<void(CURL *curl, CURLcode code)>;
+
+    static UploadEngine &GetInstance();
+
+    // Makes an easy handle use the DNS and TLS session caches of the engine.
+    void Share(CURL *curl);
+
+    // Starts the transfer of an easy handle, `done` being called when it ends.
+    // Returns false if the engine cannot run, `done` is not called then.
+    bool Add(CURL *curl, Done done);
+
+private:
+    UploadEngine() = default;
+    ~UploadEngine() = default;
+    bool Start();
+    void Run();
+    void AddPending();
+    void CheckDone();
+    void Wake();
+    void OnEvent(int fd, uint32_t events);
+    static int SocketCallback(CURL *curl, curl_socket_t fd, int what, void *userp, void *socketp);
+    static int TimerCallback(CURLM *multi, long timeoutMs, void *userp);
+    static void LockShare(CURL *curl, curl_lock_data data, curl_lock_access access, void *userp);
+    static void UnlockShare(CURL *curl, curl_lock_data data, void *userp);
+
+    std::mutex mutex_;
+    bool started_ = false;
+    std::vector<std::pair<CURL *, Done>> pending_;
+
+    std::once_flag shareFlag_;
+    CURLSH *share_ = nullptr;
+    std::mutex shareMutex_[CURL_LOCK_DATA_LAST];
+
+    // Only used by the engine thread.
+    CURLM *multi_ = nullptr;
+    int epollFd_ = -1;
+    int eventFd_ = -1;
+    bool hasDeadline_ = false;
+    std::chrono::steady_clock::time_point deadline_;
+    std::map<CURL *, Done> running_;
+
+    static constexpr int MAX_EVENTS = 16;
+};
+} // namespace OHOS::Request::Upload
+#endif
@@ -16,10 +16,7 @@
 #ifndef UPLOAD_TASK_
 #define UPLOAD_TASK_
 
-#include <pthread.h>
-
 #include <cstdio>
-#include <thread>
 #include <vector>
 
 #include "ability_context.h"
@@ -52,6 +49,7 @@ public:
     UPLOAD_API void ExecuteTask();
     static void Run(std::shared_ptr<Upload::UploadTask> task);
     void OnRun();
+    void OnDone(uint32_t ret);
 
     UPLOAD_API void SetCallback(Type type, void *callback);
     UPLOAD_API void SetContext(std::shared_ptr<OHOS::AbilityRuntime::Context> context);
@@ -68,7 +66,6 @@ private:
     uint32_t StartUploadFile();
 
     std::shared_ptr<UploadConfig> uploadConfig_;
-    std::unique_ptr<std::thread> thread_;
     std::shared_ptr<CUrlAdp> curlAdp_;
     std::shared_ptr<UploadTaskNapiV5> uploadProxy_;
     std::shared_ptr<OHOS::AbilityRuntime::Context> context_;
@@ -81,7 +78,6 @@ private:
     std::mutex mutex_;
     bool isRemoved_{ false };
     std::mutex removeMutex_;
-    std::thread::native_handle_type thread_handle_;
     static constexpr int USLEEP_INTERVAL_BEFORE_RUN = 50 * 1000;
 };
 } // namespace OHOS::Request::Upload
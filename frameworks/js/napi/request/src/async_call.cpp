@@ -78,49 +78,34 @@ napi_value AsyncCall::Call(const std::shared_ptr<Context> &context, const std::s
     } else {
         napi_get_undefined(context->env_, &ret);
     }
-    napi_value resource = nullptr;
-    std::string name = "REQUEST_" + resourceName;
-    napi_create_string_utf8(context->env_, name.c_str(), NAPI_AUTO_LENGTH, &resource);
-    WorkData *workData = new (std::nothrow) WorkData{ .ctx = context };
-    if (workData == nullptr) {
+    Work *work = new (std::nothrow) Work(context);
+    if (work == nullptr) {
         return ret;
     }
-    workData->ctx = context;
-    napi_status status = napi_create_async_work(
-        context->env_, nullptr, resource, AsyncCall::OnExecute, AsyncCall::OnComplete, workData, &context->work_);
-    if (status != napi_ok) {
-        REQUEST_HILOGE("async call napi_create failed");
-        delete workData;
-        return nullptr;
-    }
-    status = napi_queue_async_work_with_qos(context->env_, context->work_, napiQosLevel_);
-    if (status != napi_ok) {
-        REQUEST_HILOGE("async call napi_create failed");
-        napi_delete_async_work(context->env_, context->work_);
-        delete workData;
-        return nullptr;
+    if (context->exec_ == nullptr) {
+        // Nothing to execute, the call completes without passing through the worker.
+        AsyncWorker::Complete(work);
+    } else {
+        AsyncWorker::GetInstance().Submit(work);
     }
-    REQUEST_HILOGD("async call exec");
+    REQUEST_HILOGD("async call %{public}s exec", resourceName.c_str());
     return ret;
 }
 
-void AsyncCall::OnExecute(napi_env env, void *data)
+void AsyncCall::Work::Execute()
 {
-    WorkData *workData = reinterpret_cast<WorkData *>(data);
-    if (workData->ctx != nullptr && workData->ctx->exec_ != nullptr) {
-        workData->ctx->exec_();
-        workData->ctx->exec_ = nullptr;
+    if (ctx_->exec_ != nullptr) {
+        ctx_->exec_();
+        ctx_->exec_ = nullptr;
     }
 }
 
-void AsyncCall::OnComplete(napi_env env, napi_status status, void *data)
+void AsyncCall::Work::Complete(napi_env env)
 {
     REQUEST_HILOGD("AsyncCall OnComplete in");
-    WorkData *workData = reinterpret_cast<WorkData *>(data);
-    auto context = workData->ctx;
-    if (context == nullptr || context->output_ == nullptr) {
+    auto context = ctx_;
+    if (context->output_ == nullptr) {
         REQUEST_HILOGD("missing output handler");
-        delete workData;
         return;
     }
     napi_value result[ARG_BUTT] = { nullptr };
@@ -130,14 +115,14 @@ void AsyncCall::OnComplete(napi_env env, napi_status status, void *data)
         napi_get_undefined(env, &result[ARG_ERROR]);
     }
     napi_get_undefined(env, &result[ARG_DATA]);
-    napi_status outputStatus = workData->ctx->output_(&result[ARG_DATA]);
+    napi_status outputStatus = context->output_(&result[ARG_DATA]);
     context->output_ = nullptr;
-    if (status != napi_ok || outputStatus != napi_ok) {
+    if (outputStatus != napi_ok) {
         result[ARG_ERROR] = context->CreateErr();
     }
     if (context->defer_ != nullptr) {
         // promise
-        if (status == napi_ok && outputStatus == napi_ok) {
+        if (outputStatus == napi_ok) {
             napi_resolve_deferred(env, context->defer_, result[ARG_DATA]);
         } else {
             napi_reject_deferred(env, context->defer_, result[ARG_ERROR]);
@@ -151,6 +136,5 @@ void AsyncCall::OnComplete(napi_env env, napi_status status, void *data)
         napi_delete_reference(env, context->callbackRef_);
         context->callbackRef_ = nullptr;
     }
-    delete workData;
 }
 } // namespace OHOS::Request
\ No newline at end of file
@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "async_worker.h"
+
+#include <pthread.h>
+
+#include <thread>
+
+#include "log.h"
+
+namespace OHOS::Request {
+
+AsyncWorker &AsyncWorker::GetInstance()
+{
+    // Never destroyed, its thread may still wait on it at exit.
+    static AsyncWorker *worker = new AsyncWorker();
+    return *worker;
+}
+
+void AsyncWorker::Submit(AsyncWork *work)
+{
+    // The worker lives as long as the process, so does its thread.
+    std::call_once(started_, [this]() { std::thread(&AsyncWorker::Run, this).detach(); });
+    AsyncWork *head = head_.load(std::memory_order_relaxed);
+    do {
+        work->next_ = head;
+    } while (!head_.compare_exchange_weak(head, work, std::memory_order_release, std::memory_order_relaxed));
+    // The thread only parks once the stack is empty, so only the first work pushed on it wakes it up.
+    if (head == nullptr) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cond_.notify_one();
+    }
+}
+
+void AsyncWorker::Complete(AsyncWork *work)
+{
+    work->next_ = nullptr;
+    Post(work->env_, work);
+}
+
+void AsyncWorker::Run()
+{
+    pthread_setname_np(pthread_self(), "req_async");
+    while (true) {
+        AsyncWork *work = Take();
+        // Executed work not completed yet, all of the same env.
+        AsyncWork *batch = nullptr;
+        AsyncWork *tail = nullptr;
+        while (work != nullptr) {
+            AsyncWork *next = work->next_;
+            work->Execute();
+            if (batch != nullptr && batch->env_ != work->env_) {
+                Post(batch->env_, batch);
+                batch = nullptr;
+            }
+            work->next_ = nullptr;
+            if (batch == nullptr) {
+                batch = work;
+            } else {
+                tail->next_ = work;
+            }
+            tail = work;
+            work = next;
+        }
+        if (batch != nullptr) {
+            Post(batch->env_, batch);
+        }
+    }
+}
+
+AsyncWork *AsyncWorker::Take()
+{
+    AsyncWork *stack = head_.exchange(nullptr, std::memory_order_acquire);
+    if (stack == nullptr) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cond_.wait(lock, [this]() { return head_.load(std::memory_order_relaxed) != nullptr; });
+        stack = head_.exchange(nullptr, std::memory_order_acquire);
+    }
+    // The stack holds the newest work first.
+    AsyncWork *list = nullptr;
+    while (stack != nullptr) {
+        AsyncWork *next = stack->next_;
+        stack->next_ = list;
+        list = stack;
+        stack = next;
+    }
+    return list;
+}
+
+void AsyncWorker::Post(napi_env env, AsyncWork *list)
+{
+    auto complete = [env, list]() {
+        AsyncWork *work = list;
+        while (work != nullptr) {
+            AsyncWork *next = work->next_;
+            napi_handle_scope scope = nullptr;
+            napi_status status = napi_open_handle_scope(env, &scope);
+            if (status == napi_ok && scope != nullptr) {
+                work->Complete(env);
+                napi_close_handle_scope(env, scope);
+            } else {
+                REQUEST_HILOGE("async work napi_scope failed");
+            }
+            delete work;
+            work = next;
+        }
+    };
+    int32_t ret = napi_send_event(env, complete, napi_eprio_high, "request:async_call");
+    if (ret != napi_ok) {
+        REQUEST_HILOGE("napi_send_event failed: %{public}d", ret);
+        while (list != nullptr) {
+            AsyncWork *next = list->next_;
+            delete list;
+            list = next;
+        }
+    }
+}
+
+} // namespace OHOS::Request
@@ -17,7 +17,9 @@
 
 #include <fcntl.h>
 #include <securec.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <unistd.h>
 
 #include <algorithm>
 #include <cstdio>
@@ -38,6 +40,7 @@
 #include "request_common.h"
 #include "request_manager.h"
 #include "sys_event.h"
+#include "url_view.h"
 
 #include "want_agent_helper.h"
 #include "want_agent.h"
@@ -52,6 +55,10 @@ static constexpr uint32_t DESCRIPTION_MAXIMUM = 1024;
 static constexpr uint32_t URL_MAXIMUM = 8192;
 static constexpr uint32_t NOTIFICATION_TITLE_MAXIMUM = 1024;
 static constexpr uint32_t NOTIFICATION_TEXT_MAXIMUM = 3072;
+static constexpr int64_t MAX_STALL_RATIO = 100;
+static constexpr uint32_t MAX_UPLOAD_CONCURRENCY = 8;
+static constexpr int64_t MIN_CHUNK_SIZE = 64 * 1024;
+static constexpr int64_t MAX_CALLBACK_FREQUENCY = 1000;
 static constexpr uint32_t PROXY_MAXIMUM = 512;
 static constexpr uint32_t MAX_UPLOAD_ON15_FILES = 100;
 static constexpr uint32_t MIN_TIMEOUT = 1;
@@ -94,6 +101,9 @@ napi_value JsInitialize::Initialize(napi_env env, napi_callback_info info, Versi
     }
     task->config_ = config;
     task->isGetPermission = true;
+    if (firstInit) {
+        task->context_ = context;
+    }
     RequestManager::GetInstance()->RestoreListener(JsTask::ReloadListener);
     // `finalize` executes on the JS thread
     auto finalize = [](napi_env env, void *data, void *hint) {
@@ -138,7 +148,21 @@ ExceptionError JsInitialize::InitParam(
     }
     config.bundleName = context->GetBundleName();
     REQUEST_HILOGD("config.bundleName is %{public}s", config.bundleName.c_str());
-    CheckFilePath(context, config, err);
+    // The files of a new task are checked by its create work, off the JS thread.
+    if (!config.firstInit) {
+        CheckFilePath(context, config, err);
+    }
+    return err;
+}
+
+ExceptionError JsInitialize::CheckFiles(JsTask *task)
+{
+    ExceptionError err = { .code = E_OK };
+    if (task->context_ == nullptr) {
+        return err;
+    }
+    CheckFilePath(task->context_, task->config_, err);
+    task->context_ = nullptr;
     return err;
 }
 
@@ -184,6 +208,9 @@ bool JsInitialize::GetAppBaseDir(std::string &baseDir)
 bool JsInitialize::CheckFilePath(
     const std::shared_ptr<OHOS::AbilityRuntime::Context> &context, Config &config, ExceptionError &error)
 {
+    if (config.version == Version::API10) {
+        GetCertsPath(config.url, config.certsPath);
+    }
     if (config.action == Action::DOWNLOAD) {
         if (!CheckDownloadFile(context, config, error)) {
             SysEventLog::SendSysEventLog(STATISTIC_EVENT, APP_ERROR_00, config.bundleName, "", error.errInfo);
@@ -268,7 +295,7 @@ bool JsInitialize::CheckPathIsFile(const std::string &path, ExceptionError &erro
     return true;
 }
 
-bool JsInitialize::GetFdDownload(const std::string &path, const Config &config, ExceptionError &error)
+bool JsInitialize::GetFdDownload(const std::string &path, const Config &config, int32_t &fd, ExceptionError &error)
 {
     // File is exist.
     if (JsInitialize::FindDir(path)) {
@@ -280,47 +307,39 @@ bool JsInitialize::GetFdDownload(const std::string &path, const Config &config,
         }
     }
 
-    FILE *file = NULL;
-    if (config.firstInit) {
-        file = fopen(path.c_str(), "w+");
-    } else {
-        file = fopen(path.c_str(), "a+");
+    // The service writes to this descriptor, it appends as it does to the files it opens itself.
+    int32_t flags = O_RDWR | O_CREAT | O_APPEND;
+    // A delta download keeps the old content, the service fetches only the blocks that changed.
+    if (config.firstInit && config.extras.find("delta") == config.extras.end()) {
+        flags |= O_TRUNC;
     }
-
-    if (file == NULL) {
+    fd = open(path.c_str(), flags, S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH);
+    if (fd < 0) {
         error.code = E_FILE_IO;
         error.errInfo = "GetFd failed to open file errno " + std::to_string(errno);
         SysEventLog::SendSysEventLog(FAULT_EVENT, STANDARD_FAULT_00, config.bundleName, "", error.errInfo);
         return false;
     }
-    int32_t retClose = fclose(file);
-    if (retClose != 0) {
-        REQUEST_HILOGE("download fclose fail: %{public}d", retClose);
-        SysEventLog::SendSysEventLog(FAULT_EVENT, STANDARD_FAULT_02, config.bundleName, "", std::to_string(retClose));
-    }
+    fdsan_exchange_owner_tag(fd, 0, REQUEST_FDSAN_TAG);
     return true;
 }
 
-bool JsInitialize::GetFdUpload(const std::string &path, const Config &config, ExceptionError &error)
+bool JsInitialize::GetFdUpload(const std::string &path, const Config &config, int32_t &fd, ExceptionError &error)
 {
     if (!JsInitialize::CheckPathIsFile(path, error)) {
         error.code = config.version == Version::API10 ? E_FILE_IO : E_FILE_PATH;
         SysEventLog::SendSysEventLog(FAULT_EVENT, STANDARD_FAULT_03, config.bundleName, "", error.errInfo);
         return false;
     }
-    FILE *file = fopen(path.c_str(), "r");
-    if (file == NULL) {
+    fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
         error.code = config.version == Version::API10 ? E_FILE_IO : E_FILE_PATH;
         error.errInfo = "GetFd failed to open file errno " + std::to_string(errno);
         SysEventLog::SendSysEventLog(FAULT_EVENT, STANDARD_FAULT_00, config.bundleName, "", error.errInfo);
         return false;
     }
-    REQUEST_HILOGD("upload file fopen ok");
-    int32_t retClose = fclose(file);
-    if (retClose != 0) {
-        REQUEST_HILOGE("upload fclose fail: %{public}d", retClose);
-        SysEventLog::SendSysEventLog(FAULT_EVENT, STANDARD_FAULT_02, config.bundleName, "", std::to_string(retClose));
-    }
+    fdsan_exchange_owner_tag(fd, 0, REQUEST_FDSAN_TAG);
+    REQUEST_HILOGD("upload file open ok");
     return true;
 }
 
@@ -367,6 +386,11 @@ void JsInitialize::SetParseConfig(napi_env env, napi_value jsConfig, Config &con
     config.headers = ParseMap(env, jsConfig, "headers");
     config.extras = ParseMap(env, jsConfig, "extras");
     config.multipart = NapiUtils::Convert2Boolean(env, jsConfig, "multipart");
+    config.coalesce = NapiUtils::Convert2Boolean(env, jsConfig, "coalesce");
+    config.compression = NapiUtils::Convert2Boolean(env, jsConfig, "compression");
+    config.memoryLimit = NapiUtils::Convert2Uint32(env, jsConfig, "memoryLimit");
+    config.prefetch = NapiUtils::Convert2Boolean(env, jsConfig, "prefetch");
+    config.bypassCache = NapiUtils::Convert2Boolean(env, jsConfig, "bypassCache");
     if (config.mode == Mode::BACKGROUND) {
         config.background = true;
     }
@@ -421,9 +445,6 @@ bool JsInitialize::ParseConfig(napi_env env, napi_value jsConfig, Config &config
     if (!ParseUrl(env, jsConfig, config.url, errInfo)) {
         return false;
     }
-    if (!ParseCertsPath(env, jsConfig, config.certsPath, errInfo)) {
-        return false;
-    }
     if (!ParseData(env, jsConfig, config, errInfo)) {
         return false;
     }
@@ -433,6 +454,9 @@ bool JsInitialize::ParseConfig(napi_env env, napi_value jsConfig, Config &config
     if (!ParseProxy(env, jsConfig, config.proxy, errInfo)) {
         return false;
     }
+    if (!ParseChecksum(env, jsConfig, config, errInfo)) {
+        return false;
+    }
     if (!ParseTitle(env, jsConfig, config, errInfo) || !ParseToken(env, jsConfig, config, errInfo)
         || !ParseDescription(env, jsConfig, config.description, errInfo)) {
         return false;
@@ -449,6 +473,21 @@ bool JsInitialize::ParseConfig(napi_env env, napi_value jsConfig, Config &config
     if (!ParseTimeout(env, jsConfig, config, errInfo)) {
         return false;
     }
+    if (!ParseStallDetection(env, jsConfig, config, errInfo)) {
+        return false;
+    }
+    if (!ParseConcurrency(env, jsConfig, config, errInfo)) {
+        return false;
+    }
+    if (!ParseChunkSize(env, jsConfig, config, errInfo)) {
+        return false;
+    }
+    if (!ParseDeadline(env, jsConfig, config, errInfo)) {
+        return false;
+    }
+    if (!ParseMaxCallbackFrequency(env, jsConfig, config, errInfo)) {
+        return false;
+    }
     ParseConfigInner(env, jsConfig, config);
     return true;
 }
@@ -548,6 +587,128 @@ bool JsInitialize::ParseMinSpeed(napi_env env, napi_value jsConfig, Config &conf
     return true;
 }
 
+bool JsInitialize::ParseStallDetection(napi_env env, napi_value jsConfig, Config &config, std::string &errInfo)
+{
+    napi_value stallDetection = NapiUtils::GetNamedProperty(env, jsConfig, "stallDetection");
+    if (NapiUtils::GetValueType(env, stallDetection) == napi_undefined) {
+        return true;
+    }
+    napi_value value = NapiUtils::GetNamedProperty(env, stallDetection, "window");
+    auto ty = NapiUtils::GetValueType(env, value);
+    if (ty != napi_undefined) {
+        if (ty != napi_number) {
+            REQUEST_HILOGE("GetNamedProperty err");
+            errInfo = "Incorrect parameter type, stallDetection.window type is not of napi_number type";
+            return false;
+        }
+        config.stallDetection.window = NapiUtils::Convert2Int64(env, value);
+        if (config.stallDetection.window < 0) {
+            errInfo = "Parameter verification failed, stallDetection.window must be greater than or equal to 0";
+            return false;
+        }
+    }
+    value = NapiUtils::GetNamedProperty(env, stallDetection, "ratio");
+    ty = NapiUtils::GetValueType(env, value);
+    if (ty != napi_undefined) {
+        if (ty != napi_number) {
+            REQUEST_HILOGE("GetNamedProperty err");
+            errInfo = "Incorrect parameter type, stallDetection.ratio type is not of napi_number type";
+            return false;
+        }
+        // A negative ratio disables the detection
+        config.stallDetection.ratio = NapiUtils::Convert2Int64(env, value);
+        if (config.stallDetection.ratio > MAX_STALL_RATIO) {
+            errInfo = "Parameter verification failed, stallDetection.ratio must be less than or equal to 100";
+            return false;
+        }
+    }
+    return true;
+}
+
+bool JsInitialize::ParseConcurrency(napi_env env, napi_value jsConfig, Config &config, std::string &errInfo)
+{
+    napi_value value = NapiUtils::GetNamedProperty(env, jsConfig, "concurrency");
+    auto ty = NapiUtils::GetValueType(env, value);
+    if (ty == napi_undefined) {
+        return true;
+    }
+    if (ty != napi_number) {
+        REQUEST_HILOGE("GetNamedProperty err");
+        errInfo = "Incorrect parameter type, concurrency type is not of napi_number type";
+        return false;
+    }
+    int64_t concurrency = NapiUtils::Convert2Int64(env, value);
+    if (concurrency < 1 || concurrency > MAX_UPLOAD_CONCURRENCY) {
+        errInfo = "Parameter verification failed, concurrency must be between 1 and 8";
+        return false;
+    }
+    config.concurrency = static_cast<uint32_t>(concurrency);
+    return true;
+}
+
+bool JsInitialize::ParseChunkSize(napi_env env, napi_value jsConfig, Config &config, std::string &errInfo)
+{
+    napi_value value = NapiUtils::GetNamedProperty(env, jsConfig, "chunkSize");
+    auto ty = NapiUtils::GetValueType(env, value);
+    if (ty == napi_undefined) {
+        return true;
+    }
+    if (ty != napi_number) {
+        REQUEST_HILOGE("GetNamedProperty err");
+        errInfo = "Incorrect parameter type, chunkSize type is not of napi_number type";
+        return false;
+    }
+    int64_t chunkSize = NapiUtils::Convert2Int64(env, value);
+    if (chunkSize < MIN_CHUNK_SIZE) {
+        errInfo = "Parameter verification failed, chunkSize must be at least 65536";
+        return false;
+    }
+    config.chunkSize = static_cast<uint64_t>(chunkSize);
+    return true;
+}
+
+bool JsInitialize::ParseDeadline(napi_env env, napi_value jsConfig, Config &config, std::string &errInfo)
+{
+    napi_value value = NapiUtils::GetNamedProperty(env, jsConfig, "deadline");
+    auto ty = NapiUtils::GetValueType(env, value);
+    if (ty == napi_undefined) {
+        return true;
+    }
+    if (ty != napi_number) {
+        REQUEST_HILOGE("GetNamedProperty err");
+        errInfo = "Incorrect parameter type, deadline type is not of napi_number type";
+        return false;
+    }
+    int64_t deadline = NapiUtils::Convert2Int64(env, value);
+    if (deadline <= 0) {
+        errInfo = "Parameter verification failed, deadline must be a positive timestamp in milliseconds";
+        return false;
+    }
+    config.deadline = static_cast<uint64_t>(deadline);
+    return true;
+}
+
+bool JsInitialize::ParseMaxCallbackFrequency(napi_env env, napi_value jsConfig, Config &config, std::string &errInfo)
+{
+    napi_value value = NapiUtils::GetNamedProperty(env, jsConfig, "maxCallbackFrequency");
+    auto ty = NapiUtils::GetValueType(env, value);
+    if (ty == napi_undefined) {
+        return true;
+    }
+    if (ty != napi_number) {
+        REQUEST_HILOGE("GetNamedProperty err");
+        errInfo = "Incorrect parameter type, maxCallbackFrequency type is not of napi_number type";
+        return false;
+    }
+    int64_t frequency = NapiUtils::Convert2Int64(env, value);
+    if (frequency < 1 || frequency > MAX_CALLBACK_FREQUENCY) {
+        errInfo = "Parameter verification failed, maxCallbackFrequency must be between 1 and 1000";
+        return false;
+    }
+    config.maxCallbackFrequency = static_cast<uint32_t>(frequency);
+    return true;
+}
+
 bool JsInitialize::ParseTimeout(napi_env env, napi_value jsConfig, Config &config, std::string &errInfo)
 {
     napi_value timeout = NapiUtils::GetNamedProperty(env, jsConfig, "timeout");
@@ -744,14 +905,17 @@ bool JsInitialize::ParseUrl(napi_env env, napi_value jsConfig, std::string &url,
     auto hostname = GetHostnameFromURL(url);
     bool cleartextPermitted = true;
     OHOS::NetManagerStandard::NetworkSecurityConfig::GetInstance().IsCleartextPermitted(hostname, cleartextPermitted);
+    // Compiled once, as each of them is matched by every created task.
+    static const std::regex httpsUrl("^https:\\/\\/.+");
+    static const std::regex httpUrl("^http(s)?:\\/\\/.+");
     if (!cleartextPermitted) {
-        if (!regex_match(url, std::regex("^https:\\/\\/.+"))) {
+        if (!regex_match(url, httpsUrl)) {
             REQUEST_HILOGE("ParseUrl error");
             errInfo = "Parameter verification failed, clear text transmission to this url is not permitted";
             return false;
         }
     } else {
-        if (!regex_match(url, std::regex("^http(s)?:\\/\\/.+"))) {
+        if (!regex_match(url, httpUrl)) {
             REQUEST_HILOGE("ParseUrl error");
             errInfo = "Parameter verification failed, the url should start with http(s)://";
             return false;
@@ -761,51 +925,17 @@ bool JsInitialize::ParseUrl(napi_env env, napi_value jsConfig, std::string &url,
     return true;
 }
 
-bool JsInitialize::ParseCertsPath(
-    napi_env env, napi_value jsConfig, std::vector<std::string> &certsPath, std::string &errInfo)
+// The url has been checked by `ParseUrl`.
+void JsInitialize::GetCertsPath(const std::string &url, std::vector<std::string> &certsPath)
 {
-    std::string url = NapiUtils::Convert2String(env, jsConfig, "url");
-    if (url.size() > URL_MAXIMUM) {
-        REQUEST_HILOGE("The URL exceeds the maximum length of 8192");
-        errInfo = "Parameter verification failed, the length of url exceeds 8192";
-        return false;
-    }
-    if (!regex_match(url, std::regex("^http(s)?:\\/\\/.+"))) {
-        REQUEST_HILOGE("ParseUrl error");
-        errInfo = "Parameter verification failed, the url should start with http(s)://";
-        return false;
-    }
-
-    typedef std::string::const_iterator iter_t;
-
-    iter_t urlEnd = url.end();
-    iter_t protocolStart = url.cbegin();
-    iter_t protocolEnd = std::find(protocolStart, urlEnd, ':');
-    std::string protocol = std::string(protocolStart, protocolEnd);
-    if (protocol != "https") {
+    UrlView view = ParseUrlView(url);
+    if (view.scheme != "https") {
         REQUEST_HILOGD("Using Http");
-        return true;
-    }
-    if (protocolEnd != urlEnd) {
-        std::string afterProtocol = &*(protocolEnd);
-        // 3 is the num of ://
-        if ((afterProtocol.length() > 3) && (afterProtocol.substr(0, 3) == "://")) {
-            // 3 means go beyound :// in protocolEnd
-            protocolEnd += 3;
-        } else {
-            protocolEnd = url.cbegin();
-        }
-    } else {
-        protocolEnd = url.cbegin();
+        return;
     }
-    iter_t hostStart = protocolEnd;
-    iter_t pathStart = std::find(hostStart, urlEnd, '/');
-    iter_t queryStart = std::find(url.cbegin(), urlEnd, '?');
-    iter_t hostEnd = std::find(protocolEnd, (pathStart != urlEnd) ? pathStart : queryStart, ':');
-    std::string hostname = std::string(hostStart, hostEnd);
+    std::string hostname(view.host);
     REQUEST_HILOGD("Hostname is %{public}s", hostname.c_str());
     NetManagerStandard::NetworkSecurityConfig::GetInstance().GetTrustAnchorsForHostName(hostname, certsPath);
-    return true;
 }
 
 bool JsInitialize::ParseTitle(napi_env env, napi_value jsConfig, Config &config, std::string &errInfo)
@@ -834,7 +964,8 @@ bool JsInitialize::ParseProxy(napi_env env, napi_value jsConfig, std::string &pr
         return false;
     }
 
-    if (!regex_match(proxy, std::regex("^http:\\/\\/.+:\\d{1,5}$"))) {
+    static const std::regex proxyFormat("^http:\\/\\/.+:\\d{1,5}$");
+    if (!regex_match(proxy, proxyFormat)) {
         REQUEST_HILOGE("ParseProxy error");
         errInfo = "Parameter verification failed, the format of proxy is http(s)://<address or domain>:port";
         return false;
@@ -842,30 +973,30 @@ bool JsInitialize::ParseProxy(napi_env env, napi_value jsConfig, std::string &pr
     return true;
 }
 
-std::string GetHostnameFromURL(const std::string &url)
+// The checksum is `<algorithm>:<hex digest>`, the service checks the digest length.
+bool JsInitialize::ParseChecksum(napi_env env, napi_value jsConfig, Config &config, std::string &errInfo)
 {
-    if (url.empty()) {
-        return "";
-    }
-    std::string delimiter = "://";
-    std::string tempUrl = url;
-    std::replace(tempUrl.begin(), tempUrl.end(), '\\', '/');
-    size_t posStart = tempUrl.find(delimiter);
-    if (posStart != std::string::npos) {
-        posStart += delimiter.length();
-    } else {
-        posStart = 0;
+    config.checksum = NapiUtils::Convert2String(env, jsConfig, "checksum");
+    if (config.checksum.empty()) {
+        return true;
     }
-    size_t notSlash = tempUrl.find_first_not_of('/', posStart);
-    if (notSlash != std::string::npos) {
-        posStart = notSlash;
+    if (config.action != Action::DOWNLOAD) {
+        REQUEST_HILOGE("ParseChecksum error, checksum of upload task");
+        errInfo = "Parameter verification failed, config.checksum is only supported by download tasks";
+        return false;
     }
-    size_t posEnd =
-        std::min({ tempUrl.find(':', posStart), tempUrl.find('/', posStart), tempUrl.find('?', posStart) });
-    if (posEnd != std::string::npos) {
-        return tempUrl.substr(posStart, posEnd - posStart);
+    static const std::regex checksumFormat("^(sha256|md5):([0-9a-f]{2})+$", std::regex::icase);
+    if (!regex_match(config.checksum, checksumFormat)) {
+        REQUEST_HILOGE("ParseChecksum error");
+        errInfo = "Parameter verification failed, the format of checksum is sha256:<hex> or md5:<hex>";
+        return false;
     }
-    return tempUrl.substr(posStart);
+    return true;
+}
+
+std::string GetHostnameFromURL(const std::string &url)
+{
+    return std::string(ParseUrlView(url).host);
 }
 
 void JsInitialize::ParseCertificatePins(napi_env env, std::string &url, std::string &certificatePins)
@@ -1058,16 +1189,65 @@ bool JsInitialize::Convert2FileSpec(napi_env env, napi_value jsValue, const std:
 {
     REQUEST_HILOGD("Convert2FileSpec in");
     file.name = name;
+    file.filename = NapiUtils::Convert2String(env, jsValue, "filename");
+    file.hasContentType = NapiUtils::HasNamedProperty(env, jsValue, "contentType");
+    if (file.hasContentType) {
+        file.type = NapiUtils::Convert2String(env, jsValue, "contentType");
+    }
+    if (!NapiUtils::HasNamedProperty(env, jsValue, "path") && NapiUtils::HasNamedProperty(env, jsValue, "data")) {
+        return Convert2MemoryFile(env, NapiUtils::GetNamedProperty(env, jsValue, "data"), file);
+    }
     file.uri = NapiUtils::Convert2String(env, jsValue, "path");
     StringTrim(file.uri);
     if (file.uri.empty()) {
         return false;
     }
-    file.filename = NapiUtils::Convert2String(env, jsValue, "filename");
-    file.hasContentType = NapiUtils::HasNamedProperty(env, jsValue, "contentType");
-    if (file.hasContentType) {
-        file.type = NapiUtils::Convert2String(env, jsValue, "contentType");
+    return true;
+}
+
+// A part given as an ArrayBuffer is copied once into an anonymous memory file, sent to the service like the fd of
+// a user file, so it is uploaded without a temporary file of the app.
+bool JsInitialize::Convert2MemoryFile(napi_env env, napi_value jsData, FileSpec &file)
+{
+    bool isArrayBuffer = false;
+    napi_is_arraybuffer(env, jsData, &isArrayBuffer);
+    if (!isArrayBuffer) {
+        REQUEST_HILOGE("Upload data is not an ArrayBuffer");
+        return false;
+    }
+    void *data = nullptr;
+    size_t length = 0;
+    if (napi_get_arraybuffer_info(env, jsData, &data, &length) != napi_ok) {
+        REQUEST_HILOGE("Get upload data failed");
+        return false;
+    }
+    int32_t fd = memfd_create("request-upload", MFD_CLOEXEC);
+    if (fd < 0) {
+        REQUEST_HILOGE("Create memory file failed, errno: %{public}d", errno);
+        return false;
+    }
+    const char *buf = static_cast<const char *>(data);
+    size_t written = 0;
+    while (written < length) {
+        ssize_t ret = write(fd, buf + written, length - written);
+        if (ret < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ret <= 0) {
+            REQUEST_HILOGE("Write memory file failed, errno: %{public}d", errno);
+            close(fd);
+            return false;
+        }
+        written += static_cast<size_t>(ret);
+    }
+    if (lseek(fd, 0, SEEK_SET) < 0) {
+        REQUEST_HILOGE("Seek memory file failed, errno: %{public}d", errno);
+        close(fd);
+        return false;
     }
+    fdsan_exchange_owner_tag(fd, 0, REQUEST_FDSAN_TAG);
+    file.fd = fd;
+    file.isUserFile = true;
     return true;
 }
 
@@ -1206,6 +1386,19 @@ bool JsInitialize::CheckUserFileSpec(const std::shared_ptr<OHOS::AbilityRuntime:
             return false;
         }
         file.fd = dataAbilityHelper->OpenFile(*uri, "r");
+    } else if (file.uri.find("file://media/") == 0) {
+        // The service writes the body to the fd of the media library, the file is never staged.
+        std::shared_ptr<Uri> uri = std::make_shared<Uri>(file.uri);
+        std::shared_ptr<AppExecFwk::DataAbilityHelper> dataAbilityHelper =
+            AppExecFwk::DataAbilityHelper::Creator(context, uri);
+        if (dataAbilityHelper == nullptr) {
+            REQUEST_HILOGE("dataAbilityHelper null");
+            error.code = E_PARAMETER_CHECK;
+            error.errInfo = "Parameter verification failed, dataAbilityHelper null";
+            SysEventLog::SendSysEventLog(FAULT_EVENT, ABMS_FAULT_07, config.bundleName, "", error.errInfo);
+            return false;
+        }
+        file.fd = dataAbilityHelper->OpenFile(*uri, config.firstInit ? "rwt" : "rw");
     } else {
         std::shared_ptr<AppFileService::ModuleFileUri::FileUri> fileUri =
             std::make_shared<AppFileService::ModuleFileUri::FileUri>(file.uri);
@@ -1241,6 +1434,10 @@ bool JsInitialize::CheckUploadFiles(
     }
     // need reconstruction.
     for (auto &file : config.files) {
+        if (file.isUserFile && file.fd >= 0) {
+            // Parts given in memory already carry their file.
+            continue;
+        }
         if (IsUserFile(file.uri)) {
             file.isUserFile = true;
             if (config.version == Version::API9) {
@@ -1282,7 +1479,7 @@ bool JsInitialize::CheckUploadFileSpec(const std::shared_ptr<OHOS::AbilityRuntim
     }
     REQUEST_HILOGD("CheckUploadFileSpec path");
     file.uri = path;
-    if (!GetFdUpload(path, config, error)) {
+    if (!GetFdUpload(path, config, file.fd, error)) {
         return false;
     }
     StandardizeFileSpec(file);
@@ -1300,6 +1497,12 @@ void JsInitialize::StandardizePathApi9(std::string &path)
 bool JsInitialize::CheckDownloadFile(
     const std::shared_ptr<OHOS::AbilityRuntime::Context> &context, Config &config, ExceptionError &error)
 {
+    if (config.version == Version::API10 && config.memoryLimit > 0) {
+        // No file, the body comes with the completed progress.
+        FileSpec file = { .uri = "", .isUserFile = false };
+        config.files.push_back(file);
+        return true;
+    }
     if (IsUserFile(config.saveas)) {
         if (config.version == Version::API9) {
             error.code = E_PARAMETER_CHECK;
@@ -1335,10 +1538,10 @@ bool JsInitialize::CheckDownloadFile(
     }
     FileSpec file = { .uri = config.saveas, .isUserFile = false };
     StandardizeFileSpec(file);
-    config.files.push_back(file);
-    if (!GetFdDownload(file.uri, config, error)) {
+    if (!GetFdDownload(file.uri, config, file.fd, error)) {
         return false;
     }
+    config.files.push_back(file);
     return true;
 }
 
@@ -15,6 +15,7 @@
 
 #include "js_notify_data_listener.h"
 
+#include <chrono>
 #include <numeric>
 
 #include "js_task.h"
@@ -211,42 +212,133 @@ void JSNotifyDataListener::DoJSTask(const std::shared_ptr<NotifyData> &notifyDat
     }
 }
 
+void JSNotifyDataListener::SetMinInterval(uint64_t interval)
+{
+    this->minInterval_.store(interval);
+}
+
+bool JSNotifyDataListener::IsIntermediateProgress(const std::shared_ptr<NotifyData> &notifyData)
+{
+    return OHOS::Request::IsIntermediateProgress(notifyData);
+}
+
+bool JSNotifyDataListener::Throttled(const std::shared_ptr<NotifyData> &notifyData)
+{
+    uint64_t interval = this->minInterval_.load();
+    if (interval == 0 || !IsIntermediateProgress(notifyData)) {
+        return false;
+    }
+    uint64_t now = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+    uint64_t last = this->lastProgress_.load();
+    if (last != 0 && now - last < interval) {
+        return true;
+    }
+    this->lastProgress_.store(now);
+    return false;
+}
+
 void JSNotifyDataListener::OnNotifyDataReceive(const std::shared_ptr<NotifyData> &notifyData)
 {
-    NotifyDataPtr *ptr = new (std::nothrow) NotifyDataPtr;
-    if (ptr == nullptr) {
-        REQUEST_HILOGE("NotifyDataPtr new failed");
+    if (notifyData->type == SubscribeType::PROGRESS) {
+        REQUEST_HILOGD("cb progress %{public}d", notifyData->taskId);
+    } else {
+        REQUEST_HILOGI(
+            "cb %{public}s %{public}d", SubscribeTypeToString(notifyData->type).c_str(), notifyData->taskId);
+    }
+    if (this->Throttled(notifyData)) {
         return;
     }
-    ptr->listener = shared_from_this();
-    ptr->notifyData = notifyData;
-    REQUEST_HILOGI(
-        "cb %{public}s %{public}d", SubscribeTypeToString(notifyData->type).c_str(), notifyData->taskId);
-    int32_t ret = napi_send_event(
-        this->env_,
-        [ptr]() {
-            uint32_t paramNumber = NapiUtils::ONE_ARG;
-            napi_handle_scope scope = nullptr;
-            napi_status status = napi_open_handle_scope(ptr->listener->env_, &scope);
-            if (status != napi_ok || scope == nullptr) {
-                REQUEST_HILOGE("OnNotifyDataReceive napi_scope failed");
-                delete ptr;
+    std::shared_ptr<JSNotifyQueue> queue = JSNotifyQueue::GetInstance(this->env_);
+    if (queue == nullptr) {
+        return;
+    }
+    queue->Push(shared_from_this(), notifyData);
+}
+
+std::mutex JSNotifyQueue::instancesMutex_;
+std::map<napi_env, std::shared_ptr<JSNotifyQueue>> JSNotifyQueue::instances_;
+
+std::shared_ptr<JSNotifyQueue> JSNotifyQueue::GetInstance(napi_env env)
+{
+    std::lock_guard<std::mutex> lockGuard(instancesMutex_);
+    auto it = instances_.find(env);
+    if (it != instances_.end()) {
+        return it->second;
+    }
+    std::shared_ptr<JSNotifyQueue> queue = std::make_shared<JSNotifyQueue>(env);
+    napi_status status = napi_add_env_cleanup_hook(env, RemoveInstance, env);
+    if (status != napi_ok) {
+        REQUEST_HILOGE("JSNotifyQueue add cleanup hook failed: %{public}d", status);
+        return nullptr;
+    }
+    instances_[env] = queue;
+    return queue;
+}
+
+void JSNotifyQueue::RemoveInstance(void *env)
+{
+    std::lock_guard<std::mutex> lockGuard(instancesMutex_);
+    instances_.erase(static_cast<napi_env>(env));
+}
+
+void JSNotifyQueue::Push(
+    const std::shared_ptr<JSNotifyDataListener> &listener, const std::shared_ptr<NotifyData> &notifyData)
+{
+    std::lock_guard<std::mutex> lockGuard(this->mutex_);
+    if (JSNotifyDataListener::IsIntermediateProgress(notifyData)) {
+        for (NotifyDataPtr &pending : this->pending_) {
+            if (pending.listener == listener && JSNotifyDataListener::IsIntermediateProgress(pending.notifyData)) {
+                pending.notifyData = notifyData;
                 return;
             }
-            if (ptr->notifyData->type == SubscribeType::COMPLETED || ptr->notifyData->type == SubscribeType::FAILED) {
-                REQUEST_HILOGD("DoJSTask: %{public}s tid %{public}d",
-                    SubscribeTypeToString(ptr->notifyData->type).c_str(), ptr->notifyData->taskId);
-            }
-            ptr->listener->DoJSTask(ptr->notifyData);
-            napi_close_handle_scope(ptr->listener->env_, scope);
-            delete ptr;
-        },
-        napi_eprio_high,
+        }
+    }
+    bool hasRoom = MakeRoom(this->pending_, CAPACITY,
+        [](const NotifyDataPtr &pending) { return JSNotifyDataListener::IsIntermediateProgress(pending.notifyData); });
+    if (!hasRoom) {
+        REQUEST_HILOGW("js notify queue full, %{public}zu notifications waiting", this->pending_.size());
+    }
+    this->pending_.push_back(NotifyDataPtr{ notifyData, listener });
+    if (this->posted_) {
+        return;
+    }
+    int32_t ret = napi_send_event(
+        this->env_, [queue = shared_from_this()]() { queue->Drain(); }, napi_eprio_high,
         "request:download|downloadfile|upload|uploadfile|agent.create");
     if (ret != napi_ok) {
         REQUEST_HILOGE("napi_send_event failed: %{public}d", ret);
-        delete ptr;
+        this->pending_.clear();
+        return;
+    }
+    this->posted_ = true;
+}
+
+void JSNotifyQueue::Drain()
+{
+    std::vector<NotifyDataPtr> pending;
+    {
+        std::lock_guard<std::mutex> lockGuard(this->mutex_);
+        pending.swap(this->pending_);
+        this->posted_ = false;
+    }
+    napi_handle_scope scope = nullptr;
+    napi_status status = napi_open_handle_scope(this->env_, &scope);
+    if (status != napi_ok || scope == nullptr) {
+        REQUEST_HILOGE("OnNotifyDataReceive napi_scope failed");
+        return;
+    }
+    {
+        ListenerList::DispatchBatch batch;
+        for (const NotifyDataPtr &ptr : pending) {
+            if (ptr.notifyData->type == SubscribeType::COMPLETED || ptr.notifyData->type == SubscribeType::FAILED) {
+                REQUEST_HILOGD("DoJSTask: %{public}s tid %{public}d",
+                    SubscribeTypeToString(ptr.notifyData->type).c_str(), ptr.notifyData->taskId);
+            }
+            ptr.listener->DoJSTask(ptr.notifyData);
+        }
     }
+    napi_close_handle_scope(this->env_, scope);
 }
 
 void JSNotifyDataListener::OnFaultsReceive(const std::shared_ptr<int32_t> &tid,
@@ -16,7 +16,9 @@
 #include "js_task.h"
 
 #include <securec.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <unistd.h>
 
 #include <chrono>
 #include <cstring>
@@ -37,6 +39,8 @@
 #include "request_common.h"
 #include "request_event.h"
 #include "request_manager.h"
+#include "request_preload.h"
+#include "request_trace.h"
 #include "storage_acl.h"
 #include "sys_event.h"
 #include "upload/upload_task_napiV5.h"
@@ -45,6 +49,14 @@ using namespace OHOS::StorageDaemon;
 namespace fs = std::filesystem;
 namespace OHOS::Request {
 constexpr int64_t MILLISECONDS_IN_ONE_DAY = 24 * 60 * 60 * 1000;
+// The batch limits of the service, checked here so that a batch is never sent only to be rejected.
+constexpr uint32_t CREATE_BATCH_MAX = 100;
+constexpr uint32_t START_BATCH_MAX = 500;
+constexpr uint32_t QUERY_BATCH_MAX = 200;
+// No longer than the longest description, a longer keyword would never match.
+constexpr size_t SEARCH_KEYWORD_MAX = 1024;
+// Config extra naming the directory the archive of a download is extracted to.
+static const std::string EXTRACT_EXTRA = "extract";
 std::mutex JsTask::createMutex_;
 thread_local napi_ref JsTask::createCtor = nullptr;
 std::mutex JsTask::requestMutex_;
@@ -65,6 +77,7 @@ napi_property_descriptor clzDes[] = {
     DECLARE_NAPI_FUNCTION(FUNCTION_RESUME, RequestEvent::Resume),
     DECLARE_NAPI_FUNCTION(FUNCTION_STOP, RequestEvent::Stop),
     DECLARE_NAPI_FUNCTION(FUNCTION_SET_MAX_SPEED, RequestEvent::SetMaxSpeed),
+    DECLARE_NAPI_FUNCTION(FUNCTION_GET_PERFORMANCE, RequestEvent::GetPerformance),
 };
 
 napi_property_descriptor clzDesV9[] = {
@@ -185,7 +198,6 @@ napi_value JsTask::JsMain(napi_env env, napi_callback_info info, Version version
     };
     context->SetInput(input).SetOutput(output).SetExec(exec);
     AsyncCall asyncCall(env, info, context);
-    asyncCall.SetQosLevel(napi_qos_utility);
     return asyncCall.Call(context, "create");
 }
 
@@ -208,6 +220,13 @@ int32_t JsTask::CreateExec(const std::shared_ptr<ContextInfo> &context, int32_t
     REQUEST_HILOGD("JsTask CreateExec: Action %{public}d, Mode %{public}d, seq: %{public}d",
         context->task->config_.action, context->task->config_.mode, seq);
 
+    ExceptionError error = JsInitialize::CheckFiles(context->task);
+    if (error.code != E_OK) {
+        REQUEST_HILOGE("End create task in JsTask CreateExec, seq: %{public}d, failed: %{public}s", seq,
+            error.errInfo.c_str());
+        context->errInfo_ = error.errInfo;
+        return error.code;
+    }
     if (context->task->config_.mode == Mode::FOREGROUND) {
         RegisterForegroundResume();
     }
@@ -217,7 +236,13 @@ int32_t JsTask::CreateExec(const std::shared_ptr<ContextInfo> &context, int32_t
         return err;
     }
 
+    // Traced from here to the notifications of the task.
+    context->task->config_.traceId = RequestTrace::NewId();
+    TraceSpan span(context->task->config_.traceId, "js create");
+    // Closed by the request manager once the task is created.
+    context->task->config_.cachedBodyFd = JsTask::OpenCachedBody(context->task->config_);
     int32_t ret = RequestManager::GetInstance()->Create(context->task->config_, seq, context->tid);
+    context->task->config_.cachedBodyFd = -1;
     if (ret != E_OK) {
         REQUEST_HILOGE("End create task in JsTask CreateExec, seq: %{public}d, failed: %{public}d", seq, ret);
         return ret;
@@ -226,17 +251,82 @@ int32_t JsTask::CreateExec(const std::shared_ptr<ContextInfo> &context, int32_t
     return ret;
 }
 
+// The body the application preloaded for the URL of a download is copied into an anonymous memory file, the
+// service writes the file of the task from it instead of downloading the body again. Only plain GET downloads
+// of the whole body to a file are sent the same request as the preload.
+int32_t JsTask::OpenCachedBody(const Config &config)
+{
+    if (config.version != Version::API10 || config.action != Action::DOWNLOAD || config.method != "GET"
+        || !config.headers.empty() || config.memoryLimit > 0 || config.begins > 0 || config.ends >= 0) {
+        return -1;
+    }
+    std::optional<Data> data = Preload::GetInstance()->fetch(config.url);
+    if (!data.has_value()) {
+        return -1;
+    }
+    Slice<const uint8_t> bytes = data->bytes();
+    int32_t fd = memfd_create("request-cached-body", MFD_CLOEXEC);
+    if (fd < 0) {
+        REQUEST_HILOGE("Create cached body file failed, errno: %{public}d", errno);
+        return -1;
+    }
+    const uint8_t *buf = bytes.data();
+    size_t length = bytes.size();
+    size_t written = 0;
+    while (written < length) {
+        ssize_t ret = write(fd, buf + written, length - written);
+        if (ret < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ret <= 0) {
+            REQUEST_HILOGE("Write cached body file failed, errno: %{public}d", errno);
+            close(fd);
+            return -1;
+        }
+        written += static_cast<size_t>(ret);
+    }
+    fdsan_exchange_owner_tag(fd, 0, REQUEST_FDSAN_TAG);
+    REQUEST_HILOGI("Hand over a cached body of %{public}zu bytes", length);
+    return fd;
+}
+
+// The service extracts the archive of a download into this directory of the application.
+static int32_t AuthorizeExtractDir(const Config &config)
+{
+    auto it = config.extras.find(EXTRACT_EXTRA);
+    if (it == config.extras.end() || it->second.empty()) {
+        return E_OK;
+    }
+    const std::string &dir = it->second;
+    if (!PathUtils::CheckBelongAppBaseDir(dir) || dir.find("..") != std::string::npos) {
+        REQUEST_HILOGE("Extract dir not in the app base dir");
+        return E_PARAMETER_CHECK;
+    }
+    std::error_code err;
+    fs::create_directories(dir, err);
+    if (err) {
+        REQUEST_HILOGE("Create extract dir failed, %{public}d", err.value());
+        return E_FILE_IO;
+    }
+    if (!PathUtils::AddDirToMap(dir)) {
+        REQUEST_HILOGE("Add Dir acl failed, %{public}s", PathUtils::ShieldPath(dir).c_str());
+        return E_FILE_IO;
+    }
+    return E_OK;
+}
+
 int32_t JsTask::AuthorizePath(const Config &config)
 {
     if (config.action == Action::DOWNLOAD) {
         FileSpec fileSpec = config.files[0];
-        if (fileSpec.isUserFile) {
+        if (fileSpec.isUserFile || config.memoryLimit > 0) {
             return E_OK;
         }
         if (!PathUtils::AddPathsToMap(fileSpec.uri, config.action)) {
             REQUEST_HILOGE("Add Path acl failed, %{public}s", PathUtils::ShieldPath(fileSpec.uri).c_str());
             return E_FILE_IO;
         }
+        return AuthorizeExtractDir(config);
     } else {
         for (auto &fileSpec : config.files) {
             if (fileSpec.isUserFile) {
@@ -818,6 +908,13 @@ ExceptionError JsTask::ParseSearch(napi_env env, size_t argc, napi_value *argv,
     filter.state = ParseState(env, argv[0]);
     filter.action = ParseAction(env, argv[0]);
     filter.mode = ParseMode(env, argv[0]);
+    filter.keyword = ParseKeyword(env, argv[0]);
+    if (filter.keyword.size() > SEARCH_KEYWORD_MAX) {
+        REQUEST_HILOGE("keyword is too long");
+        err.code = E_PARAMETER_CHECK;
+        err.errInfo = "Parameter verification failed, the length of filter keyword exceeds 1024";
+        return err;
+    }
     return err;
 }
 
@@ -857,6 +954,18 @@ Action JsTask::ParseAction(napi_env env, napi_value value)
     return static_cast<Action>(NapiUtils::Convert2Uint32(env, value1));
 }
 
+std::string JsTask::ParseKeyword(napi_env env, napi_value value)
+{
+    if (!NapiUtils::HasNamedProperty(env, value, "keyword")) {
+        return "";
+    }
+    napi_value value1 = NapiUtils::GetNamedProperty(env, value, "keyword");
+    if (NapiUtils::GetValueType(env, value1) != napi_string) {
+        return "";
+    }
+    return NapiUtils::Convert2String(env, value1);
+}
+
 Mode JsTask::ParseMode(napi_env env, napi_value value)
 {
     if (!NapiUtils::HasNamedProperty(env, value, "mode")) {
@@ -869,6 +978,36 @@ Mode JsTask::ParseMode(napi_env env, napi_value value)
     return static_cast<Mode>(NapiUtils::Convert2Uint32(env, value1));
 }
 
+ExceptionError JsTask::ParsePage(napi_env env, size_t argc, napi_value *argv, Filter &filter)
+{
+    ExceptionError err = { .code = E_OK };
+    if (argc < 1 || NapiUtils::GetValueType(env, argv[0]) != napi_object) {
+        err.code = E_PARAMETER_CHECK;
+        err.errInfo = "Missing mandatory parameters, missing limit";
+        return err;
+    }
+    napi_value limit = NapiUtils::GetNamedProperty(env, argv[0], "limit");
+    if (NapiUtils::GetValueType(env, limit) != napi_number) {
+        err.code = E_PARAMETER_CHECK;
+        err.errInfo = "Incorrect parameter type, limit is not of number type";
+        return err;
+    }
+    filter.limit = NapiUtils::Convert2Uint32(env, limit);
+    if (filter.limit == 0) {
+        err.code = E_PARAMETER_CHECK;
+        err.errInfo = "Parameter verification failed, limit must be greater than 0";
+        return err;
+    }
+    if (!NapiUtils::HasNamedProperty(env, argv[0], "cursor")) {
+        return err;
+    }
+    napi_value cursor = NapiUtils::GetNamedProperty(env, argv[0], "cursor");
+    if (NapiUtils::GetValueType(env, cursor) == napi_string) {
+        filter.cursor = NapiUtils::Convert2String(env, cursor);
+    }
+    return err;
+}
+
 int64_t JsTask::ParseBefore(napi_env env, napi_value value)
 {
     using namespace std::chrono;
@@ -939,6 +1078,53 @@ napi_value JsTask::Search(napi_env env, napi_callback_info info)
     return asyncCall.Call(context, "search");
 }
 
+napi_value JsTask::SearchPage(napi_env env, napi_callback_info info)
+{
+    int32_t seq = RequestManager::GetInstance()->GetNextSeq();
+    REQUEST_HILOGI("Begin search page seq %{public}d", seq);
+    struct SearchPageContext : public AsyncCall::Context {
+        Filter filter;
+        std::vector<std::string> tids;
+        std::string next;
+    };
+
+    auto context = std::make_shared<SearchPageContext>();
+    context->withErrCode_ = true;
+    context->version_ = Version::API10;
+    auto input = [context, seq](size_t argc, napi_value *argv, napi_value self) -> napi_status {
+        ExceptionError err = ParseSearch(context->env_, argc, argv, context->filter);
+        if (err.code == E_OK) {
+            err = ParsePage(context->env_, argc, argv, context->filter);
+        }
+        if (err.code != E_OK) {
+            REQUEST_HILOGE("End task search page in AsyncCall input, seq: %{public}d, failed: arg invalid", seq);
+            NapiUtils::ThrowError(context->env_, err.code, err.errInfo, true);
+            return napi_invalid_arg;
+        }
+        return napi_ok;
+    };
+    auto output = [context, seq](napi_value *result) -> napi_status {
+        if (context->innerCode_ != E_OK) {
+            REQUEST_HILOGE("End task search page in AsyncCall output, seq: %{public}d, failed: %{public}d", seq,
+                context->innerCode_);
+            return napi_generic_failure;
+        }
+        napi_create_object(context->env_, result);
+        napi_set_named_property(
+            context->env_, *result, "ids", NapiUtils::Convert2JSValue(context->env_, context->tids));
+        napi_set_named_property(
+            context->env_, *result, "cursor", NapiUtils::Convert2JSValue(context->env_, context->next));
+        REQUEST_HILOGI("End search page seq %{public}d, num %{public}zu", seq, context->tids.size());
+        return napi_ok;
+    };
+    auto exec = [context]() {
+        context->innerCode_ = RequestManager::GetInstance()->SearchPage(context->filter, context->tids, context->next);
+    };
+    context->SetInput(std::move(input)).SetOutput(std::move(output)).SetExec(std::move(exec));
+    AsyncCall asyncCall(env, info, context);
+    return asyncCall.Call(context, "searchPage");
+}
+
 napi_value JsTask::Query(napi_env env, napi_callback_info info)
 {
     int32_t seq = RequestManager::GetInstance()->GetNextSeq();
@@ -979,6 +1165,333 @@ napi_value JsTask::Query(napi_env env, napi_callback_info info)
     return asyncCall.Call(context, "query");
 }
 
+napi_value JsTask::CreateBatch(napi_env env, napi_callback_info info)
+{
+    int32_t seq = RequestManager::GetInstance()->GetNextSeq();
+    REQUEST_HILOGI("Begin create batch seq %{public}d", seq);
+    struct CreateBatchContext : public AsyncCall::Context {
+        std::vector<std::shared_ptr<ContextInfo>> tasks;
+        std::vector<int32_t> codes;
+    };
+
+    auto context = std::make_shared<CreateBatchContext>();
+    context->withErrCode_ = true;
+    context->version_ = Version::API10;
+    auto release = [context]() {
+        for (auto &task : context->tasks) {
+            if (task->taskRef != nullptr) {
+                napi_delete_reference(context->env_, task->taskRef);
+                task->taskRef = nullptr;
+            }
+        }
+    };
+    auto input = [context, seq, release](size_t argc, napi_value *argv, napi_value self) -> napi_status {
+        std::vector<napi_value> configs;
+        ExceptionError err = { .code = E_PARAMETER_CHECK, .errInfo = "Missing mandatory parameters, missing configs" };
+        if (argc >= NapiUtils::TWO_ARG) {
+            err = ParseBatch(context->env_, argv[NapiUtils::SECOND_ARGV], "configs", CREATE_BATCH_MAX, configs);
+        }
+        if (err.code != E_OK) {
+            REQUEST_HILOGE("End task create batch in AsyncCall input, seq: %{public}d, failed: arg invalid", seq);
+            NapiUtils::ThrowError(context->env_, err.code, err.errInfo, true);
+            return napi_invalid_arg;
+        }
+        for (napi_value config : configs) {
+            auto task = std::make_shared<ContextInfo>();
+            task->env_ = context->env_;
+            task->withErrCode_ = true;
+            task->version_ = Version::API10;
+            context->tasks.push_back(task);
+            napi_value args[NapiUtils::TWO_ARG] = { argv[NapiUtils::FIRST_ARGV], config };
+            napi_status status = CreateInput(task, seq, NapiUtils::TWO_ARG, args);
+            if (status != napi_ok) {
+                release();
+                return status;
+            }
+        }
+        context->codes.resize(context->tasks.size(), E_OK);
+        return napi_ok;
+    };
+    auto exec = [context]() {
+        std::vector<Config> configs;
+        std::vector<size_t> indexes;
+        for (size_t i = 0; i < context->tasks.size(); i++) {
+            const Config &config = context->tasks[i]->task->config_;
+            context->codes[i] = JsInitialize::CheckFiles(context->tasks[i]->task).code;
+            if (context->codes[i] != E_OK) {
+                continue;
+            }
+            if (config.mode == Mode::FOREGROUND) {
+                RegisterForegroundResume();
+            }
+            context->codes[i] = JsTask::AuthorizePath(config);
+            if (context->codes[i] == E_OK) {
+                configs.push_back(config);
+                indexes.push_back(i);
+            }
+        }
+        std::vector<TaskRet> rets;
+        context->innerCode_ = RequestManager::GetInstance()->CreateTasks(configs, rets);
+        if (context->innerCode_ != E_OK) {
+            return;
+        }
+        for (size_t j = 0; j < indexes.size(); j++) {
+            auto &task = context->tasks[indexes[j]];
+            if (j >= rets.size()) {
+                context->codes[indexes[j]] = E_SERVICE_ERROR;
+                continue;
+            }
+            context->codes[indexes[j]] = rets[j].code;
+            if (rets[j].code == E_OK) {
+                task->tid = rets[j].tid;
+                JsTask::AddRemoveListener(task);
+            }
+        }
+    };
+    auto output = [context, seq, release](napi_value *result) -> napi_status {
+        if (context->innerCode_ != E_OK) {
+            release();
+            REQUEST_HILOGE("End task create batch in AsyncCall output, seq: %{public}d, failed: %{public}d", seq,
+                context->innerCode_);
+            return napi_generic_failure;
+        }
+        *result = BatchResult(context->env_, context->codes, [context](size_t i) -> napi_value {
+            auto &task = context->tasks[i];
+            napi_value jsTask = nullptr;
+            napi_get_reference_value(context->env_, task->taskRef, &jsTask);
+            task->task->SetTid(task->tid);
+            JsTask::AddTaskWhenCreate(task);
+            NapiUtils::SetStringPropertyUtf8(context->env_, jsTask, "tid", task->tid);
+            return jsTask;
+        });
+        for (size_t i = 0; i < context->tasks.size(); i++) {
+            if (context->codes[i] != E_OK && context->tasks[i]->taskRef != nullptr) {
+                napi_delete_reference(context->env_, context->tasks[i]->taskRef);
+                context->tasks[i]->taskRef = nullptr;
+            }
+        }
+        REQUEST_HILOGI("End create batch seq %{public}d, num %{public}zu", seq, context->tasks.size());
+        return napi_ok;
+    };
+    context->SetInput(std::move(input)).SetOutput(std::move(output)).SetExec(std::move(exec));
+    AsyncCall asyncCall(env, info, context);
+    return asyncCall.Call(context, "createBatch");
+}
+
+napi_value JsTask::StartBatch(napi_env env, napi_callback_info info)
+{
+    int32_t seq = RequestManager::GetInstance()->GetNextSeq();
+    REQUEST_HILOGI("Begin start batch seq %{public}d", seq);
+    struct StartBatchContext : public AsyncCall::Context {
+        std::vector<JsTask *> tasks;
+        std::vector<int32_t> codes;
+    };
+
+    auto context = std::make_shared<StartBatchContext>();
+    context->withErrCode_ = true;
+    context->version_ = Version::API10;
+    auto input = [context, seq](size_t argc, napi_value *argv, napi_value self) -> napi_status {
+        std::vector<napi_value> tasks;
+        ExceptionError err = { .code = E_PARAMETER_CHECK, .errInfo = "Missing mandatory parameters, missing tasks" };
+        if (argc >= NapiUtils::ONE_ARG) {
+            err = ParseBatch(context->env_, argv[NapiUtils::FIRST_ARGV], "tasks", START_BATCH_MAX, tasks);
+        }
+        for (size_t i = 0; err.code == E_OK && i < tasks.size(); i++) {
+            JsTask *task = nullptr;
+            napi_status status = napi_unwrap(context->env_, tasks[i], reinterpret_cast<void **>(&task));
+            if (status != napi_ok || task == nullptr) {
+                err.code = E_PARAMETER_CHECK;
+                err.errInfo = "Incorrect parameter type, tasks contains a value that is not a task";
+                break;
+            }
+            context->tasks.push_back(task);
+        }
+        if (err.code != E_OK) {
+            REQUEST_HILOGE("End task start batch in AsyncCall input, seq: %{public}d, failed: arg invalid", seq);
+            NapiUtils::ThrowError(context->env_, err.code, err.errInfo, true);
+            return napi_invalid_arg;
+        }
+        context->codes.resize(context->tasks.size(), E_OK);
+        return napi_ok;
+    };
+    auto exec = [context]() {
+        std::vector<std::string> tids;
+        std::vector<size_t> indexes;
+        for (size_t i = 0; i < context->tasks.size(); i++) {
+            context->codes[i] = RequestEvent::CheckStart(context->tasks[i]);
+            if (context->codes[i] == E_OK) {
+                tids.push_back(context->tasks[i]->GetTid());
+                indexes.push_back(i);
+            }
+        }
+        if (tids.empty()) {
+            return;
+        }
+        std::vector<ExceptionErrorCode> rets;
+        context->innerCode_ = RequestManager::GetInstance()->StartTasks(tids, rets);
+        for (size_t j = 0; context->innerCode_ == E_OK && j < indexes.size(); j++) {
+            context->codes[indexes[j]] = j < rets.size() ? rets[j] : E_SERVICE_ERROR;
+        }
+    };
+    auto output = [context, seq](napi_value *result) -> napi_status {
+        if (context->innerCode_ != E_OK) {
+            REQUEST_HILOGE("End task start batch in AsyncCall output, seq: %{public}d, failed: %{public}d", seq,
+                context->innerCode_);
+            return napi_generic_failure;
+        }
+        *result = BatchResult(context->env_, context->codes, [context](size_t i) -> napi_value {
+            napi_value value = nullptr;
+            napi_get_null(context->env_, &value);
+            return value;
+        });
+        REQUEST_HILOGI("End start batch seq %{public}d, num %{public}zu", seq, context->tasks.size());
+        return napi_ok;
+    };
+    context->SetInput(std::move(input)).SetOutput(std::move(output)).SetExec(std::move(exec));
+    AsyncCall asyncCall(env, info, context);
+    return asyncCall.Call(context, "startBatch");
+}
+
+napi_value JsTask::QueryBatch(napi_env env, napi_callback_info info)
+{
+    int32_t seq = RequestManager::GetInstance()->GetNextSeq();
+    REQUEST_HILOGI("Begin query batch seq %{public}d", seq);
+    struct QueryBatchContext : public AsyncCall::Context {
+        std::vector<std::string> tids;
+        uint32_t fields = TASK_INFO_ALL;
+        std::vector<int32_t> codes;
+        std::vector<TaskInfoRet> rets;
+    };
+
+    auto context = std::make_shared<QueryBatchContext>();
+    context->withErrCode_ = true;
+    context->version_ = Version::API10;
+    auto input = [context, seq](size_t argc, napi_value *argv, napi_value self) -> napi_status {
+        std::vector<napi_value> ids;
+        ExceptionError err = { .code = E_PARAMETER_CHECK, .errInfo = "Missing mandatory parameters, missing ids" };
+        if (argc >= NapiUtils::ONE_ARG) {
+            err = ParseBatch(context->env_, argv[NapiUtils::FIRST_ARGV], "ids", QUERY_BATCH_MAX, ids);
+        }
+        for (size_t i = 0; err.code == E_OK && i < ids.size(); i++) {
+            std::string tid;
+            err = ParseTid(context->env_, NapiUtils::ONE_ARG, &ids[i], tid);
+            context->tids.push_back(tid);
+        }
+        if (err.code == E_OK && argc >= NapiUtils::TWO_ARG
+            && NapiUtils::GetValueType(context->env_, argv[NapiUtils::SECOND_ARGV]) == napi_number) {
+            context->fields = NapiUtils::Convert2Uint32(context->env_, argv[NapiUtils::SECOND_ARGV]);
+        }
+        if (err.code != E_OK) {
+            REQUEST_HILOGE("End task query batch in AsyncCall input, seq: %{public}d, failed: arg invalid", seq);
+            NapiUtils::ThrowError(context->env_, err.code, err.errInfo, true);
+            return napi_invalid_arg;
+        }
+        return napi_ok;
+    };
+    auto exec = [context]() {
+        context->innerCode_ = RequestManager::GetInstance()->QueryTasks(context->tids, context->rets, context->fields);
+        context->codes.resize(context->tids.size(), E_SERVICE_ERROR);
+        for (size_t i = 0; i < context->rets.size() && i < context->codes.size(); i++) {
+            context->codes[i] = context->rets[i].code;
+        }
+    };
+    auto output = [context, seq](napi_value *result) -> napi_status {
+        if (context->innerCode_ != E_OK) {
+            REQUEST_HILOGE("End task query batch in AsyncCall output, seq: %{public}d, failed: %{public}d", seq,
+                context->innerCode_);
+            return napi_generic_failure;
+        }
+        *result = BatchResult(context->env_, context->codes, [context](size_t i) -> napi_value {
+            context->rets[i].info.withSystem = true;
+            return NapiUtils::Convert2JSValue(context->env_, context->rets[i].info);
+        });
+        REQUEST_HILOGI("End query batch seq %{public}d, num %{public}zu", seq, context->tids.size());
+        return napi_ok;
+    };
+    context->SetInput(std::move(input)).SetOutput(std::move(output)).SetExec(std::move(exec));
+    AsyncCall asyncCall(env, info, context);
+    return asyncCall.Call(context, "queryBatch");
+}
+
+ExceptionError JsTask::ParseBatch(
+    napi_env env, napi_value value, const std::string &name, uint32_t max, std::vector<napi_value> &elements)
+{
+    ExceptionError err = { .code = E_OK };
+    bool isArray = false;
+    napi_is_array(env, value, &isArray);
+    if (!isArray) {
+        err.code = E_PARAMETER_CHECK;
+        err.errInfo = "Incorrect parameter type, " + name + " is not of array type";
+        return err;
+    }
+    uint32_t length = 0;
+    napi_get_array_length(env, value, &length);
+    if (length == 0 || length > max) {
+        err.code = E_PARAMETER_CHECK;
+        err.errInfo = "Parameter verification failed, the length of " + name + " exceeds 1 to " + std::to_string(max);
+        return err;
+    }
+    for (uint32_t i = 0; i < length; i++) {
+        napi_value element = nullptr;
+        napi_get_element(env, value, i, &element);
+        elements.push_back(element);
+    }
+    return err;
+}
+
+// Reads the latest progress of a task from the shared progress table, without any IPC once the table is mapped.
+// Returns undefined if the table holds no progress of the task.
+napi_value JsTask::GetProgressSnapshot(napi_env env, napi_callback_info info)
+{
+    size_t argc = NapiUtils::MAX_ARGC;
+    napi_value argv[NapiUtils::MAX_ARGC] = { nullptr };
+    NAPI_CALL(env, napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr));
+    std::string tid;
+    ExceptionError err = ParseTid(env, argc, argv, tid);
+    if (err.code != E_OK) {
+        NapiUtils::ThrowError(env, err.code, err.errInfo, true);
+        return nullptr;
+    }
+    ProgressSnapshot snapshot;
+    int32_t ret = RequestManager::GetInstance()->ReadProgressSnapshot(tid, snapshot);
+    if (ret == E_TASK_NOT_FOUND) {
+        return NapiUtils::GetUndefined(env);
+    }
+    if (ret != E_OK) {
+        NapiUtils::ConvertError(ret, err);
+        NapiUtils::ThrowError(env, err.code, err.errInfo, true);
+        return nullptr;
+    }
+    napi_value result = nullptr;
+    napi_create_object(env, &result);
+    napi_set_named_property(
+        env, result, "state", NapiUtils::Convert2JSValue(env, static_cast<uint32_t>(snapshot.state)));
+    napi_set_named_property(env, result, "processed", NapiUtils::Convert2JSValue(env, snapshot.processed));
+    napi_set_named_property(env, result, "total", NapiUtils::Convert2JSValue(env, snapshot.total));
+    napi_set_named_property(env, result, "mtime", NapiUtils::Convert2JSValue(env, snapshot.mtime));
+    return result;
+}
+
+// Builds the result array of a batch, whose entries are either the result of a task or its BusinessError.
+napi_value JsTask::BatchResult(
+    napi_env env, const std::vector<int32_t> &codes, const std::function<napi_value(size_t)> &element)
+{
+    napi_value result = nullptr;
+    napi_create_array_with_length(env, codes.size(), &result);
+    for (size_t i = 0; i < codes.size(); i++) {
+        napi_value value = nullptr;
+        if (codes[i] == E_OK) {
+            value = element(i);
+        } else {
+            ExceptionError err;
+            NapiUtils::ConvertError(codes[i], err);
+            value = NapiUtils::CreateBusinessError(env, err.code, err.errInfo, true);
+        }
+        napi_set_element(env, result, i, value);
+    }
+    return result;
+}
+
 std::string JsTask::GetTid()
 {
     return tid_;
@@ -1016,10 +1529,10 @@ void JsTask::ReloadListener()
             tids.push_back(it.first);
         }
     }
-    for (const auto &it : tids) {
-        REQUEST_HILOGD("ReloadListener tid: %{public}s", it.c_str());
-        RequestManager::GetInstance()->Subscribe(it);
-    }
+    // The channel is reopened by the same calls, instead of one call per task flooding a restarted service.
+    std::vector<ExceptionErrorCode> rets;
+    ExceptionErrorCode ret = RequestManager::GetInstance()->SubscribeTasks(tids, rets);
+    REQUEST_HILOGI("ReloadListener %{public}zu tasks, ret: %{public}d", tids.size(), ret);
 }
 
 bool JsTask::SetDirsPermission(std::vector<std::string> &dirs)
@@ -1100,6 +1613,10 @@ void JsTask::ClearTaskTemp(const std::string &tid, bool isRmFiles, bool isRmAcls
         for (auto &file : context->task->config_.files) {
             PathUtils::SubPathsToMap(file.uri);
         }
+        auto extract = context->task->config_.extras.find(EXTRACT_EXTRA);
+        if (extract != context->task->config_.extras.end() && !extract->second.empty()) {
+            PathUtils::SubPathsToMap(extract->second);
+        }
         context->task->isGetPermission = false;
     }
     if (isRmCertsAcls) {
@@ -16,10 +16,23 @@
 #include "listener_list.h"
 
 namespace OHOS::Request {
+// The dispatch batch alive on the JS thread, 0 if there is none.
+static thread_local uint64_t currentBatch = 0;
+static thread_local uint64_t lastBatch = 0;
+
+ListenerList::DispatchBatch::DispatchBatch()
+{
+    currentBatch = ++lastBatch;
+}
+
+ListenerList::DispatchBatch::~DispatchBatch()
+{
+    currentBatch = 0;
+}
 
 napi_status ListenerList::AddListenerInner(napi_value cb)
 {
-    std::lock_guard<std::recursive_mutex> lock(allCbMutex_);
+    std::lock_guard<std::mutex> lock(allCbMutex_);
     if (this->IsListenerAdded(cb)) {
         return napi_ok;
     }
@@ -30,7 +43,7 @@ napi_status ListenerList::AddListenerInner(napi_value cb)
         return status;
     }
 
-    this->allCb_.push_back(std::make_pair(true, ref));
+    this->allCb_.push_back(Listener{ .ref = ref });
     ++this->validCbNum;
 
     return napi_ok;
@@ -38,28 +51,32 @@ napi_status ListenerList::AddListenerInner(napi_value cb)
 
 napi_status ListenerList::RemoveListenerInner(napi_value cb)
 {
-    std::lock_guard<std::recursive_mutex> lock(allCbMutex_);
+    std::lock_guard<std::mutex> lock(allCbMutex_);
     if (this->validCbNum == 0) {
         return napi_ok;
     }
 
     if (cb == nullptr) {
-        for (auto it = this->allCb_.begin(); it != this->allCb_.end(); it++) {
-            it->first = false;
+        for (auto &listener : this->allCb_) {
+            if (listener.valid) {
+                listener.valid = false;
+                ++this->removedCbNum_;
+            }
         }
         this->validCbNum = 0;
         return napi_ok;
     }
 
-    for (auto it = this->allCb_.begin(); it != this->allCb_.end(); it++) {
+    for (auto &listener : this->allCb_) {
         napi_value copyValue = nullptr;
-        napi_get_reference_value(this->env_, it->second, &copyValue);
+        napi_get_reference_value(this->env_, listener.ref, &copyValue);
 
         bool isEquals = false;
         napi_strict_equals(this->env_, cb, copyValue, &isEquals);
         if (isEquals) {
-            if (it->first == true) {
-                it->first = false;
+            if (listener.valid) {
+                listener.valid = false;
+                ++this->removedCbNum_;
                 --this->validCbNum;
             }
             break;
@@ -69,21 +86,53 @@ napi_status ListenerList::RemoveListenerInner(napi_value cb)
 }
 
 // In JS main thread.
+// The callbacks may add or remove listeners, so the listeners are visited by index, a listener removed by an
+// earlier callback is skipped and one added is only called from the next message on.
 void ListenerList::OnMessageReceive(napi_value *value, uint32_t paramNumber)
 {
-    std::lock_guard<std::recursive_mutex> lock(allCbMutex_);
-    for (auto it = this->allCb_.begin(); it != this->allCb_.end();) {
-        if (it->first == false) {
-            napi_delete_reference(this->env_, it->second);
-            it = this->allCb_.erase(it);
+    if (this->dispatchDepth_ == 0) {
+        this->EraseRemoved();
+    }
+    ++this->dispatchDepth_;
+    size_t size = this->allCb_.size();
+    for (size_t i = 0; i < size && i < this->allCb_.size(); i++) {
+        if (!this->allCb_[i].valid) {
             continue;
         }
-        napi_value callbackFunc = nullptr;
-        napi_get_reference_value(this->env_, it->second, &callbackFunc);
+        napi_value callbackFunc = this->GetCallback(this->allCb_[i]);
         napi_value callbackResult = nullptr;
         napi_call_function(this->env_, nullptr, callbackFunc, paramNumber, value, &callbackResult);
-        it++;
     }
+    --this->dispatchDepth_;
+}
+
+napi_value ListenerList::GetCallback(Listener &listener)
+{
+    if (currentBatch != 0 && listener.batch == currentBatch) {
+        return listener.callback;
+    }
+    napi_value callback = nullptr;
+    napi_get_reference_value(this->env_, listener.ref, &callback);
+    listener.callback = callback;
+    listener.batch = currentBatch;
+    return callback;
+}
+
+void ListenerList::EraseRemoved()
+{
+    if (this->removedCbNum_ == 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(allCbMutex_);
+    for (auto it = this->allCb_.begin(); it != this->allCb_.end();) {
+        if (it->valid) {
+            it++;
+            continue;
+        }
+        napi_delete_reference(this->env_, it->ref);
+        it = this->allCb_.erase(it);
+    }
+    this->removedCbNum_ = 0;
 }
 
 // Check whether `cb` has been stored, in JS main thread.
@@ -92,14 +141,14 @@ bool ListenerList::IsListenerAdded(napi_value cb)
     if (cb == nullptr) {
         return true;
     }
-    for (auto it = this->allCb_.begin(); it != this->allCb_.end(); it++) {
+    for (auto &listener : this->allCb_) {
         napi_value copyValue = nullptr;
-        napi_get_reference_value(this->env_, it->second, &copyValue);
+        napi_get_reference_value(this->env_, listener.ref, &copyValue);
 
         bool isEquals = false;
         napi_strict_equals(this->env_, cb, copyValue, &isEquals);
         if (isEquals) {
-            return it->first;
+            return listener.valid;
         }
     }
     return false;
@@ -112,14 +161,14 @@ bool ListenerList::HasListener()
 
 void ListenerList::DeleteAllListenerRef()
 {
-    std::lock_guard<std::recursive_mutex> lock(allCbMutex_);
-    for (auto it = this->allCb_.begin(); it != this->allCb_.end();) {
-        it->first = false;
-        napi_delete_reference(this->env_, it->second);
-        it = this->allCb_.erase(it);
+    std::lock_guard<std::mutex> lock(allCbMutex_);
+    for (auto &listener : this->allCb_) {
+        napi_delete_reference(this->env_, listener.ref);
     }
+    this->allCb_.clear();
+    this->removedCbNum_ = 0;
     this->validCbNum = 0;
     return;
 }
 
-} // namespace OHOS::Request
\ No newline at end of file
+} // namespace OHOS::Request
@@ -22,6 +22,7 @@
 #include <fstream>
 #include <initializer_list>
 #include <memory>
+#include <mutex>
 #include <regex>
 
 #include "constant.h"
@@ -43,6 +44,128 @@ static const std::map<ExceptionErrorCode, std::string> ErrorCodeToMsg{ { E_OK, E
     { E_TASK_NOT_FOUND, E_TASK_NOT_FOUND_INFO }, { E_TASK_STATE, E_TASK_STATE_INFO }, { E_OTHER, E_OTHER_INFO },
     { E_NOT_SYSTEM_APP, NOT_SYSTEM_APP }, { E_GROUP_NOT_FOUND, E_GROUP_NOT_FOUND_INFO } };
 
+// Names of the properties of the objects built on every progress callback and task query.
+enum PropertyName : size_t {
+    PROP_STATE = 0,
+    PROP_INDEX,
+    PROP_PROCESSED,
+    PROP_SIZES,
+    PROP_EXTRAS,
+    PROP_SPEED,
+    PROP_ETA,
+    PROP_UID,
+    PROP_BUNDLE,
+    PROP_URL,
+    PROP_SAVEAS,
+    PROP_DATA,
+    PROP_TID,
+    PROP_TITLE,
+    PROP_DESCRIPTION,
+    PROP_ACTION,
+    PROP_MODE,
+    PROP_MIME_TYPE,
+    PROP_PROGRESS,
+    PROP_GAUGE,
+    PROP_PRIORITY,
+    PROP_CTIME,
+    PROP_MTIME,
+    PROP_RETRY,
+    PROP_TRIES,
+    PROP_FAULTS,
+    PROP_REASON,
+    PROP_COUNT,
+};
+
+static constexpr const char *PROPERTY_NAMES[PROP_COUNT] = { "state", "index", "processed", "sizes", "extras", "speed",
+    "eta", "uid", "bundle", "url", "saveas", "data", "tid", "title", "description", "action", "mode", "mimeType",
+    "progress", "gauge", "priority", "ctime", "mtime", "retry", "tries", "faults", "reason" };
+
+static constexpr napi_property_attributes DATA_PROPERTY =
+    static_cast<napi_property_attributes>(napi_writable | napi_enumerable | napi_configurable);
+
+// Property name strings of each env, created once and kept alive by references until the env is cleaned up.
+static std::mutex propertyNamesMutex;
+static std::map<napi_env, std::vector<napi_ref>> propertyNames;
+
+static void DeletePropertyNames(void *arg)
+{
+    napi_env env = static_cast<napi_env>(arg);
+    std::lock_guard<std::mutex> lockGuard(propertyNamesMutex);
+    auto it = propertyNames.find(env);
+    if (it == propertyNames.end()) {
+        return;
+    }
+    for (napi_ref ref : it->second) {
+        napi_delete_reference(env, ref);
+    }
+    propertyNames.erase(it);
+}
+
+static napi_value GetPropertyName(napi_env env, PropertyName name)
+{
+    std::lock_guard<std::mutex> lockGuard(propertyNamesMutex);
+    auto it = propertyNames.find(env);
+    if (it == propertyNames.end()) {
+        std::vector<napi_ref> refs(PROP_COUNT, nullptr);
+        for (size_t i = 0; i < PROP_COUNT; i++) {
+            napi_value str = nullptr;
+            if (napi_create_string_utf8(env, PROPERTY_NAMES[i], NAPI_AUTO_LENGTH, &str) != napi_ok
+                || napi_create_reference(env, str, ONE_REF, &refs[i]) != napi_ok) {
+                REQUEST_HILOGE("Create property name %{public}s failed", PROPERTY_NAMES[i]);
+                for (size_t j = 0; j < i; j++) {
+                    napi_delete_reference(env, refs[j]);
+                }
+                return nullptr;
+            }
+        }
+        if (napi_add_env_cleanup_hook(env, DeletePropertyNames, env) != napi_ok) {
+            REQUEST_HILOGE("Add property names cleanup hook failed");
+        }
+        it = propertyNames.emplace(env, std::move(refs)).first;
+    }
+    napi_value str = nullptr;
+    napi_get_reference_value(env, it->second[name], &str);
+    return str;
+}
+
+// Collects the properties of an object to create it with one `napi_define_properties` call.
+class ObjectBuilder {
+public:
+    explicit ObjectBuilder(napi_env env) : env_(env)
+    {
+    }
+
+    ObjectBuilder &Add(PropertyName name, napi_value value)
+    {
+        napi_value key = GetPropertyName(env_, name);
+        if (key == nullptr) {
+            return Add(PROPERTY_NAMES[name], value);
+        }
+        desc_.push_back({ nullptr, key, nullptr, nullptr, nullptr, value, DATA_PROPERTY, nullptr });
+        return *this;
+    }
+
+    ObjectBuilder &Add(const char *name, napi_value value)
+    {
+        desc_.push_back({ name, nullptr, nullptr, nullptr, nullptr, value, DATA_PROPERTY, nullptr });
+        return *this;
+    }
+
+    napi_value Build()
+    {
+        napi_value object = nullptr;
+        napi_create_object(env_, &object);
+        if (!desc_.empty()) {
+            napi_define_properties(env_, object, desc_.size(), desc_.data());
+        }
+        return object;
+    }
+
+private:
+    napi_env env_;
+    std::vector<napi_property_descriptor> desc_;
+};
+
 napi_status Convert2JSValue(napi_env env, const DownloadInfo &in, napi_value &out)
 {
     napi_create_object(env, &out);
@@ -187,12 +310,11 @@ napi_value Convert2JSHeadersAndBody(napi_env env, const std::map<std::string, st
 
 napi_value Convert2JSValue(napi_env env, const std::map<std::string, std::string> &code)
 {
-    napi_value object = nullptr;
-    napi_create_object(env, &object);
+    ObjectBuilder builder(env);
     for (const auto &cInt : code) {
-        napi_set_named_property(env, object, cInt.first.c_str(), Convert2JSValue(env, cInt.second));
+        builder.Add(cInt.first.c_str(), Convert2JSValue(env, cInt.second));
     }
-    return object;
+    return builder.Build();
 }
 
 napi_value Convert2JSValue(napi_env env, const std::string &str)
@@ -222,15 +344,15 @@ napi_value Convert2JSValue(napi_env env, const std::vector<TaskState> &taskState
 
 napi_value Convert2JSValue(napi_env env, const Progress &progress)
 {
-    napi_value value = nullptr;
-    napi_create_object(env, &value);
-    napi_set_named_property(env, value, "state", Convert2JSValue(env, static_cast<uint32_t>(progress.state)));
-    napi_set_named_property(env, value, "index", Convert2JSValue(env, progress.index));
-    napi_set_named_property(env, value, "processed", Convert2JSValue(env, progress.processed));
-    napi_set_named_property(env, value, "sizes", Convert2JSValue(env, progress.sizes));
-    napi_set_named_property(
-        env, value, "extras", Convert2JSHeadersAndBody(env, progress.extras, progress.bodyBytes, false));
-    return value;
+    return ObjectBuilder(env)
+        .Add(PROP_STATE, Convert2JSValue(env, static_cast<uint32_t>(progress.state)))
+        .Add(PROP_INDEX, Convert2JSValue(env, progress.index))
+        .Add(PROP_PROCESSED, Convert2JSValue(env, progress.processed))
+        .Add(PROP_SIZES, Convert2JSValue(env, progress.sizes))
+        .Add(PROP_EXTRAS, Convert2JSHeadersAndBody(env, progress.extras, progress.bodyBytes, false))
+        .Add(PROP_SPEED, Convert2JSValue(env, progress.speed))
+        .Add(PROP_ETA, Convert2JSValue(env, progress.eta))
+        .Build();
 }
 
 napi_value Convert2JSValue(napi_env env, const std::vector<FileSpec> &files, const std::vector<FormItem> &forms)
@@ -272,13 +394,35 @@ napi_value Convert2JSValue(napi_env env, const MinSpeed &minSpeed)
     return value;
 }
 
-napi_value Convert2JSValue(napi_env env, TaskInfo &taskInfo)
+napi_value Convert2JSValue(napi_env env, const StallDetection &stallDetection)
 {
     napi_value value = nullptr;
     napi_create_object(env, &value);
+    napi_set_named_property(env, value, "window", Convert2JSValue(env, stallDetection.window));
+    napi_set_named_property(env, value, "ratio", Convert2JSValue(env, stallDetection.ratio));
+    return value;
+}
+
+napi_value Convert2JSValue(napi_env env, const TaskPerformance &performance)
+{
+    napi_value value = nullptr;
+    napi_create_object(env, &value);
+    napi_set_named_property(env, value, "attempt", Convert2JSValue(env, performance.attempt));
+    napi_set_named_property(env, value, "dns", Convert2JSValue(env, performance.dns));
+    napi_set_named_property(env, value, "connect", Convert2JSValue(env, performance.connect));
+    napi_set_named_property(env, value, "tls", Convert2JSValue(env, performance.tls));
+    napi_set_named_property(env, value, "ttfb", Convert2JSValue(env, performance.ttfb));
+    napi_set_named_property(env, value, "transfer", Convert2JSValue(env, performance.transfer));
+    napi_set_named_property(env, value, "server", Convert2JSValue(env, performance.server));
+    return value;
+}
+
+napi_value Convert2JSValue(napi_env env, TaskInfo &taskInfo)
+{
+    ObjectBuilder builder(env);
     if (taskInfo.withSystem) {
-        napi_set_named_property(env, value, "uid", Convert2JSValue(env, taskInfo.uid));
-        napi_set_named_property(env, value, "bundle", Convert2JSValue(env, taskInfo.bundle));
+        builder.Add(PROP_UID, Convert2JSValue(env, taskInfo.uid));
+        builder.Add(PROP_BUNDLE, Convert2JSValue(env, taskInfo.bundle));
         taskInfo.url = "";
         taskInfo.data = "";
         if (taskInfo.action == Action::UPLOAD) {
@@ -286,37 +430,38 @@ napi_value Convert2JSValue(napi_env env, TaskInfo &taskInfo)
             taskInfo.forms.clear();
         }
     }
-    napi_set_named_property(env, value, "url", Convert2JSValue(env, taskInfo.url));
-    napi_set_named_property(env, value, "saveas", Convert2JSValue(env, GetSaveas(taskInfo.files, taskInfo.action)));
+    builder.Add(PROP_URL, Convert2JSValue(env, taskInfo.url));
+    builder.Add(PROP_SAVEAS, Convert2JSValue(env, GetSaveas(taskInfo.files, taskInfo.action)));
     if (taskInfo.action == Action::DOWNLOAD) {
-        napi_set_named_property(env, value, "data", Convert2JSValue(env, taskInfo.data));
+        builder.Add(PROP_DATA, Convert2JSValue(env, taskInfo.data));
     } else {
-        napi_set_named_property(env, value, "data", Convert2JSValue(env, taskInfo.files, taskInfo.forms));
-    }
-    napi_set_named_property(env, value, "tid", Convert2JSValue(env, taskInfo.tid));
-    napi_set_named_property(env, value, "title", Convert2JSValue(env, taskInfo.title));
-    napi_set_named_property(env, value, "description", Convert2JSValue(env, taskInfo.description));
-    napi_set_named_property(env, value, "action", Convert2JSValue(env, static_cast<uint32_t>(taskInfo.action)));
-    napi_set_named_property(env, value, "mode", Convert2JSValue(env, static_cast<uint32_t>(taskInfo.mode)));
-    napi_set_named_property(env, value, "mimeType", Convert2JSValue(env, taskInfo.mimeType));
-    napi_set_named_property(env, value, "progress", Convert2JSValue(env, taskInfo.progress));
-    napi_set_named_property(env, value, "gauge", Convert2JSValue(env, taskInfo.gauge));
-    napi_set_named_property(env, value, "priority", Convert2JSValue(env, taskInfo.priority));
-    napi_set_named_property(env, value, "ctime", Convert2JSValue(env, taskInfo.ctime));
-    napi_set_named_property(env, value, "mtime", Convert2JSValue(env, taskInfo.mtime));
-    napi_set_named_property(env, value, "retry", Convert2JSValue(env, taskInfo.retry));
-    napi_set_named_property(env, value, "tries", Convert2JSValue(env, taskInfo.tries));
+        builder.Add(PROP_DATA, Convert2JSValue(env, taskInfo.files, taskInfo.forms));
+    }
+    builder.Add(PROP_TID, Convert2JSValue(env, taskInfo.tid))
+        .Add(PROP_TITLE, Convert2JSValue(env, taskInfo.title))
+        .Add(PROP_DESCRIPTION, Convert2JSValue(env, taskInfo.description))
+        .Add(PROP_ACTION, Convert2JSValue(env, static_cast<uint32_t>(taskInfo.action)))
+        .Add(PROP_MODE, Convert2JSValue(env, static_cast<uint32_t>(taskInfo.mode)))
+        .Add(PROP_MIME_TYPE, Convert2JSValue(env, taskInfo.mimeType))
+        .Add(PROP_PROGRESS, Convert2JSValue(env, taskInfo.progress))
+        .Add(PROP_GAUGE, Convert2JSValue(env, taskInfo.gauge))
+        .Add(PROP_PRIORITY, Convert2JSValue(env, taskInfo.priority))
+        .Add(PROP_CTIME, Convert2JSValue(env, taskInfo.ctime))
+        .Add(PROP_MTIME, Convert2JSValue(env, taskInfo.mtime))
+        .Add(PROP_RETRY, Convert2JSValue(env, taskInfo.retry))
+        .Add(PROP_TRIES, Convert2JSValue(env, taskInfo.tries));
     if (taskInfo.code == Reason::REASON_OK) {
         napi_value value1 = nullptr;
         napi_get_null(env, &value1);
-        napi_set_named_property(env, value, "faults", value1);
+        builder.Add(PROP_FAULTS, value1);
     } else {
         Faults fault = CommonUtils::GetFaultByReason(taskInfo.code);
-        napi_set_named_property(env, value, "faults", Convert2JSValue(env, static_cast<uint32_t>(fault)));
+        builder.Add(PROP_FAULTS, Convert2JSValue(env, static_cast<uint32_t>(fault)));
     }
-    napi_set_named_property(env, value, "reason", Convert2JSValue(env, CommonUtils::GetMsgByReason(taskInfo.code)));
-    napi_set_named_property(env, value, "extras", Convert2JSValue(env, taskInfo.extras));
-    return value;
+    builder.Add(PROP_REASON, Convert2JSValue(env, CommonUtils::GetMsgByReason(taskInfo.code)));
+    builder.Add(PROP_EXTRAS, Convert2JSValue(env, taskInfo.extras));
+    builder.Add("performance", Convert2JSValue(env, taskInfo.performance));
+    return builder.Build();
 }
 
 napi_value Convert2JSValueConfig(napi_env env, Config &config)
@@ -354,6 +499,15 @@ napi_value Convert2JSValueConfig(napi_env env, Config &config)
     napi_set_named_property(env, value, "extras", Convert2JSValue(env, config.extras));
     napi_set_named_property(env, value, "multipart", Convert2JSValue(env, config.multipart));
     napi_set_named_property(env, value, "minSpeed", Convert2JSValue(env, config.minSpeed));
+    napi_set_named_property(env, value, "stallDetection", Convert2JSValue(env, config.stallDetection));
+    napi_set_named_property(env, value, "concurrency", Convert2JSValue(env, config.concurrency));
+    napi_set_named_property(env, value, "chunkSize", Convert2JSValue(env, config.chunkSize));
+    napi_set_named_property(env, value, "deadline", Convert2JSValue(env, config.deadline));
+    napi_set_named_property(env, value, "coalesce", Convert2JSValue(env, config.coalesce));
+    napi_set_named_property(env, value, "compression", Convert2JSValue(env, config.compression));
+    napi_set_named_property(env, value, "memoryLimit", Convert2JSValue(env, config.memoryLimit));
+    napi_set_named_property(env, value, "prefetch", Convert2JSValue(env, config.prefetch));
+    napi_set_named_property(env, value, "bypassCache", Convert2JSValue(env, config.bypassCache));
     return value;
 }
 
@@ -364,7 +518,7 @@ napi_value Convert2JSValue(napi_env env, const std::shared_ptr<Response> &respon
     napi_set_named_property(env, value, "version", Convert2JSValue(env, response->version));
     napi_set_named_property(env, value, "statusCode", Convert2JSValue(env, response->statusCode));
     napi_set_named_property(env, value, "reason", Convert2JSValue(env, response->reason));
-    napi_set_named_property(env, value, "headers", Convert2JSHeaders(env, response->headers));
+    napi_set_named_property(env, value, "headers", Convert2JSHeaders(env, response->GetHeaders()));
     return value;
 }
 
@@ -17,29 +17,24 @@
 
 #include <sstream>
 #include <string>
-#include <tuple>
 #include <utility>
 
+#include "acl_grant_table.h"
 #include "log.h"
-#include "storage_acl.h"
 
 namespace OHOS::Request {
 
-static constexpr int ACL_SUCC = 0;
-
 // SA side reading and writing are aware of the `Other` permission of `UGO`;
 // otherwise, it will cause concurrency with the Set ACL and generate `Permission denied`.
 static const std::string SA_PERMISSION_U_RW = "u:3815:rw";
 static const std::string SA_PERMISSION_U_R = "u:3815:r";
 static const std::string SA_PERMISSION_U_X = "u:3815:x";
+static const std::string SA_PERMISSION_U_RWX = "u:3815:rwx";
 static const std::string SA_PERMISSION_U_CLEAN = "u:3815:---";
 static const std::string AREA1 = "/data/storage/el1/base";
 static const std::string AREA2 = "/data/storage/el2/base";
 static const std::string AREA5 = "/data/storage/el5/base";
 
-static std::mutex pathMutex_;
-static std::map<std::string, std::tuple<bool, uint32_t>> pathMap_;
-
 bool PathUtils::CheckBelongAppBaseDir(const std::string &filepath)
 {
     return (filepath.find(AREA1) == 0) || filepath.find(AREA2) == 0 || filepath.find(AREA5) == 0;
@@ -62,7 +57,8 @@ std::vector<std::string> SplitPath(const std::string &path)
             nextPos = path.size();
         }
         if (nextPos > pos) {
-            currentPath += ("/" + path.substr(pos, nextPos - pos));
+            currentPath.push_back('/');
+            currentPath.append(path, pos, nextPos - pos);
             result.emplace_back(currentPath);
         }
         pos = nextPos + 1;
@@ -90,93 +86,25 @@ std::vector<std::pair<std::string, bool>> SelectPath(const std::vector<std::stri
     return result;
 }
 
-bool AddAcl(const std::string &path, const bool isFile, const Action action)
-{
-    std::string entry;
-    if (isFile) {
-        if (action == Action::UPLOAD) {
-            entry = SA_PERMISSION_U_R;
-        } else {
-            entry = SA_PERMISSION_U_RW;
-        }
-    } else {
-        entry = SA_PERMISSION_U_X;
-    }
-    if (StorageDaemon::AclSetAccess(path, entry) != ACL_SUCC) {
-        REQUEST_HILOGE("Add Acl Failed, %{public}s", PathUtils::ShieldPath(path).c_str());
-        return false;
-    };
-    return true;
-}
-
-bool SubAcl(const std::string &path)
-{
-    std::string entry = SA_PERMISSION_U_CLEAN;
-    if (StorageDaemon::AclSetAccess(path, entry) != ACL_SUCC) {
-        REQUEST_HILOGE("Sub Acl Failed, %{public}s", PathUtils::ShieldPath(path).c_str());
-        return false;
-    };
-    return true;
-}
-
-bool AddOnePathToMap(const std::string &path, const bool isFile, const Action action)
-{
-    std::lock_guard<std::mutex> lockGuard(pathMutex_);
-    auto it = pathMap_.find(path);
-    if (it == pathMap_.end()) {
-        if (!AddAcl(path, isFile, action)) {
-            return false;
-        }
-        pathMap_.emplace(path, std::tuple(isFile, 1));
-    } else {
-        // It is necessary to ensure that the permissions are set.
-        if (!AddAcl(path, isFile, action)) {
-            return false;
-        }
-        auto &[iFile, count] = it->second;
-        iFile = isFile;
-        count++;
-    }
-    return true;
-}
-
-bool SubOnePathToMap(const std::string &path, const bool isFile)
+static std::string AclEntry(const Action action)
 {
-    std::lock_guard<std::mutex> lockGuard(pathMutex_);
-    auto it = pathMap_.find(path);
-    if (it == pathMap_.end()) {
-        REQUEST_HILOGE("SubOnePathToMap no path, %{public}s", PathUtils::ShieldPath(path).c_str());
-        return false;
-    }
-    auto &[iFile, count] = it->second;
-    if (iFile != isFile) {
-        REQUEST_HILOGE("SubOnePathToMap path changed, %{public}s", PathUtils::ShieldPath(path).c_str());
-    }
-    if (count <= 0) {
-        REQUEST_HILOGE("SubOnePathToMap count 0, %{public}s", PathUtils::ShieldPath(path).c_str());
-        pathMap_.erase(it);
-        return false;
-    }
-    count--;
-    if (count == 0) {
-        const bool ret = SubAcl(path);
-        pathMap_.erase(it);
-        return ret;
-    }
-    return true;
+    return action == Action::UPLOAD ? SA_PERMISSION_U_R : SA_PERMISSION_U_RW;
 }
 
 bool SubPathsVec(const std::vector<std::pair<std::string, bool>> &paths)
 {
+    bool ret = true;
     for (auto &elem : paths) {
-        if (!SubOnePathToMap(elem.first, elem.second)) {
-            return false;
+        if (!AclGrantTable::Release(elem.first, SA_PERMISSION_U_CLEAN)) {
+            REQUEST_HILOGE("Sub Acl Failed, %{public}s", PathUtils::ShieldPath(elem.first).c_str());
+            ret = false;
         }
     }
-    return true;
+    return ret;
 }
 
-bool PathUtils::AddPathsToMap(const std::string &path, const Action action)
+// Grants the ancestors of `path` and `path` itself with `entry`.
+static bool AcquirePaths(const std::string &path, const std::string &entry)
 {
     std::vector<std::pair<std::string, bool>> paths = SelectPath(SplitPath(path));
     if (paths.empty()) {
@@ -185,15 +113,28 @@ bool PathUtils::AddPathsToMap(const std::string &path, const Action action)
     std::vector<std::pair<std::string, bool>> completePaths;
     completePaths.reserve(paths.size());
     for (auto &elem : paths) {
-        if (!AddOnePathToMap(elem.first, elem.second, action)) {
+        // The reference is taken even if the grant fails, it is released with the others.
+        completePaths.emplace_back(elem);
+        if (!AclGrantTable::Acquire(elem.first, elem.second ? entry : SA_PERMISSION_U_X, elem.second)) {
+            REQUEST_HILOGE("Add Acl Failed, %{public}s", PathUtils::ShieldPath(elem.first).c_str());
             SubPathsVec(completePaths);
             return false;
         }
-        completePaths.emplace_back(elem);
     }
     return true;
 }
 
+bool PathUtils::AddPathsToMap(const std::string &path, const Action action)
+{
+    return AcquirePaths(path, AclEntry(action));
+}
+
+// The directory an archive is extracted to, the service creates its entries.
+bool PathUtils::AddDirToMap(const std::string &dir)
+{
+    return AcquirePaths(dir, SA_PERMISSION_U_RWX);
+}
+
 bool PathUtils::SubPathsToMap(const std::string &path)
 {
     std::vector<std::pair<std::string, bool>> paths = SelectPath(SplitPath(path));
@@ -24,6 +24,7 @@
 namespace OHOS::Request {
 constexpr const std::int32_t DECIMALISM = 10;
 constexpr const int64_t MIN_SPEED_LIMIT = 16 * 1024;
+constexpr const uint32_t MS_PER_SECOND = 1000;
 static constexpr const char *EVENT_COMPLETED = "completed";
 static constexpr const char *EVENT_FAILED = "failed";
 static constexpr const char *EVENT_PAUSE = "pause";
@@ -67,6 +68,7 @@ std::map<std::string, RequestEvent::Event> RequestEvent::requestEvent_ = {
     { FUNCTION_START, RequestEvent::StartExec },
     { FUNCTION_STOP, RequestEvent::StopExec },
     { FUNCTION_SET_MAX_SPEED, RequestEvent::SetMaxSpeedExec },
+    { FUNCTION_GET_PERFORMANCE, RequestEvent::GetPerformanceExec },
 };
 
 std::map<std::string, uint32_t> RequestEvent::resMap_ = {
@@ -78,6 +80,7 @@ std::map<std::string, uint32_t> RequestEvent::resMap_ = {
     { FUNCTION_START, BOOL_RES },
     { FUNCTION_STOP, BOOL_RES },
     { FUNCTION_SET_MAX_SPEED, BOOL_RES },
+    { FUNCTION_GET_PERFORMANCE, PERFORMANCE_RES },
 };
 
 std::map<State, DownloadStatus> RequestEvent::stateMap_ = {
@@ -137,6 +140,11 @@ napi_value RequestEvent::Stop(napi_env env, napi_callback_info info)
     return Exec(env, info, FUNCTION_STOP);
 }
 
+napi_value RequestEvent::GetPerformance(napi_env env, napi_callback_info info)
+{
+    return Exec(env, info, FUNCTION_GET_PERFORMANCE);
+}
+
 napi_value RequestEvent::SetMaxSpeed(napi_env env, napi_callback_info info)
 {
     int32_t seq = RequestManager::GetInstance()->GetNextSeq();
@@ -218,6 +226,10 @@ napi_value RequestEvent::On(napi_env env, napi_callback_info info)
             jsParam.task->notifyDataListenerMap_[jsParam.subscribeType] =
                 std::make_shared<JSNotifyDataListener>(env, jsParam.task->GetTid(), jsParam.subscribeType);
         }
+        uint32_t frequency = jsParam.task->config_.maxCallbackFrequency;
+        if (jsParam.subscribeType == SubscribeType::PROGRESS && frequency > 0) {
+            jsParam.task->notifyDataListenerMap_[jsParam.subscribeType]->SetMinInterval(MS_PER_SECOND / frequency);
+        }
         jsParam.task->listenerMutex_.unlock();
         napi_status ret = jsParam.task->notifyDataListenerMap_[jsParam.subscribeType]->AddListener(jsParam.callback);
         if (ret != napi_ok) {
@@ -454,13 +466,30 @@ napi_status RequestEvent::GetResult(
     if (res->second == INFO_RES) {
         return NapiUtils::Convert2JSValue(env, context->infoRes, result);
     }
+    if (res->second == PERFORMANCE_RES) {
+        result = NapiUtils::Convert2JSValue(env, context->performanceRes);
+        return result == nullptr ? napi_generic_failure : napi_ok;
+    }
     return napi_generic_failure;
 }
 
 int32_t RequestEvent::StartExec(const std::shared_ptr<ExecContext> &context)
 {
     REQUEST_HILOGD("RequestEvent::StartExec in");
-    JsTask *task = context->task;
+    int32_t ret = CheckStart(context->task);
+    if (ret != E_OK) {
+        return ret;
+    }
+    ret = RequestManager::GetInstance()->Start(context->task->GetTid());
+    if (ret == E_OK) {
+        context->boolRes = true;
+    }
+    return ret;
+}
+
+// Rechecks the task before it is started, also for the tasks started by startBatch.
+int32_t RequestEvent::CheckStart(JsTask *task)
+{
     Config config = task->config_;
 
     // Rechecks file path.
@@ -475,22 +504,15 @@ int32_t RequestEvent::StartExec(const std::shared_ptr<ExecContext> &context)
             return E_FILE_IO;
         }
     }
-    std::string tid = context->task->GetTid();
-    {
-        std::lock_guard<std::mutex> lockGuard(JsTask::taskMutex_);
-        auto it = JsTask::taskContextMap_.find(tid);
-        if (it == JsTask::taskContextMap_.end() || it->second->task == nullptr) {
-            REQUEST_HILOGE("Start taskContextMap_ not find %{public}s.", tid.c_str());
-            // In JS d.ts, only can throw 201/13400003/21900007（E_TASK_STATE）
-            return E_TASK_STATE;
-        }
+    std::string tid = task->GetTid();
+    std::lock_guard<std::mutex> lockGuard(JsTask::taskMutex_);
+    auto it = JsTask::taskContextMap_.find(tid);
+    if (it == JsTask::taskContextMap_.end() || it->second->task == nullptr) {
+        REQUEST_HILOGE("Start taskContextMap_ not find %{public}s.", tid.c_str());
+        // In JS d.ts, only can throw 201/13400003/21900007（E_TASK_STATE）
+        return E_TASK_STATE;
     }
-
-    int32_t ret = RequestManager::GetInstance()->Start(tid);
-    if (ret == E_OK) {
-        context->boolRes = true;
-    }
-    return ret;
+    return E_OK;
 }
 
 int32_t RequestEvent::StopExec(const std::shared_ptr<ExecContext> &context)
@@ -535,6 +557,16 @@ int32_t RequestEvent::QueryExec(const std::shared_ptr<ExecContext> &context)
     return ret;
 }
 
+int32_t RequestEvent::GetPerformanceExec(const std::shared_ptr<ExecContext> &context)
+{
+    TaskInfo infoRes;
+    int32_t ret = RequestManager::GetInstance()->Show(context->task->GetTid(), infoRes);
+    if (ret == E_OK) {
+        context->performanceRes = std::move(infoRes.performance);
+    }
+    return ret;
+}
+
 int32_t RequestEvent::QueryMimeTypeExec(const std::shared_ptr<ExecContext> &context)
 {
     int32_t ret = E_OK;
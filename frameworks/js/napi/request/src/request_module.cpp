@@ -46,6 +46,16 @@ static void NapiCreateMode(napi_env env, napi_value &mode)
     NapiUtils::SetUint32Property(env, mode, "FOREGROUND", static_cast<uint32_t>(Mode::FOREGROUND));
 }
 
+static void NapiCreateTaskInfoField(napi_env env, napi_value &taskInfoField)
+{
+    napi_create_object(env, &taskInfoField);
+    NapiUtils::SetUint32Property(env, taskInfoField, "FORM_ITEMS", TASK_INFO_FORM_ITEMS);
+    NapiUtils::SetUint32Property(env, taskInfoField, "FILE_SPECS", TASK_INFO_FILE_SPECS);
+    NapiUtils::SetUint32Property(env, taskInfoField, "EXTRAS", TASK_INFO_EXTRAS);
+    NapiUtils::SetUint32Property(env, taskInfoField, "EACH_FILE_STATUS", TASK_INFO_EACH_FILE_STATUS);
+    NapiUtils::SetUint32Property(env, taskInfoField, "ALL", TASK_INFO_ALL);
+}
+
 static void NapiCreateNetwork(napi_env env, napi_value &network)
 {
     napi_create_object(env, &network);
@@ -95,6 +105,8 @@ static void NapiCreateWaitingReason(napi_env env, napi_value &waitingReason)
         env, waitingReason, "APP_BACKGROUND", static_cast<uint32_t>(WaitingReason::AppBackground));
     NapiUtils::SetUint32Property(
         env, waitingReason, "USER_INACTIVATED", static_cast<uint32_t>(WaitingReason::UserInactivated));
+    NapiUtils::SetUint32Property(
+        env, waitingReason, "ORIGIN_UNAVAILABLE", static_cast<uint32_t>(WaitingReason::OriginUnavailable));
 }
 
 static void NapiCreateBroadcastEvent(napi_env env, napi_value &broadcastEvent)
@@ -124,6 +136,8 @@ static napi_value InitAgent(napi_env env, napi_value exports)
     NapiCreateBroadcastEvent(env, broadcastEvent);
     napi_value waitingReason = nullptr;
     NapiCreateWaitingReason(env, waitingReason);
+    napi_value taskInfoField = nullptr;
+    NapiCreateTaskInfoField(env, taskInfoField);
 
     napi_property_descriptor desc[] = {
         DECLARE_NAPI_PROPERTY("Action", action),
@@ -133,6 +147,7 @@ static napi_value InitAgent(napi_env env, napi_value exports)
         DECLARE_NAPI_PROPERTY("Faults", faults),
         DECLARE_NAPI_PROPERTY("BroadcastEvent", broadcastEvent),
         DECLARE_NAPI_PROPERTY("WaitingReason", waitingReason),
+        DECLARE_NAPI_PROPERTY("TaskInfoField", taskInfoField),
         DECLARE_NAPI_STATIC_PROPERTY("VISIBILITY_COMPLETION", visibility_completion),
         DECLARE_NAPI_STATIC_PROPERTY("VISIBILITY_PROGRESS", visibility_progress),
 
@@ -142,7 +157,12 @@ static napi_value InitAgent(napi_env env, napi_value exports)
         DECLARE_NAPI_METHOD("show", JsTask::Show),
         DECLARE_NAPI_METHOD("touch", JsTask::Touch),
         DECLARE_NAPI_METHOD("search", JsTask::Search),
+        DECLARE_NAPI_METHOD("searchPage", JsTask::SearchPage),
         DECLARE_NAPI_METHOD("query", JsTask::Query),
+        DECLARE_NAPI_METHOD("createBatch", JsTask::CreateBatch),
+        DECLARE_NAPI_METHOD("startBatch", JsTask::StartBatch),
+        DECLARE_NAPI_METHOD("queryBatch", JsTask::QueryBatch),
+        DECLARE_NAPI_METHOD("getProgressSnapshot", JsTask::GetProgressSnapshot),
         DECLARE_NAPI_METHOD("createGroup", createGroup),
         DECLARE_NAPI_METHOD("attachGroup", attachGroup),
         DECLARE_NAPI_METHOD("deleteGroup", deleteGroup),
@@ -21,7 +21,7 @@ using namespace OHOS::Request::Upload;
 namespace OHOS::Request::UploadNapi {
 AsyncCall::AsyncCall(napi_env env, napi_callback_info info, std::shared_ptr<Context> context) : env_(env)
 {
-    context_ = new (std::nothrow) AsyncContext();
+    context_ = new (std::nothrow) AsyncContext(env);
     if (context_ == nullptr) {
         return;
     }
@@ -67,13 +67,8 @@ napi_value AsyncCall::Call(napi_env env, Context::ExecAction exec)
     } else {
         napi_get_undefined(env, &promise);
     }
-    napi_async_work work = context_->work;
-    napi_value resource = nullptr;
-    napi_create_string_utf8(env, "AsyncCall", NAPI_AUTO_LENGTH, &resource);
-    napi_create_async_work(env, nullptr, resource, AsyncCall::OnExecute, AsyncCall::OnComplete, context_, &work);
-    context_->work = work;
+    AsyncWorker::GetInstance().Submit(context_);
     context_ = nullptr;
-    napi_queue_async_work(env, work);
     UPLOAD_HILOGD(UPLOAD_MODULE_JS_NAPI, "async call exec");
     return promise;
 }
@@ -93,6 +88,7 @@ napi_value AsyncCall::SyncCall(napi_env env, AsyncCall::Context::ExecAction exec
     }
     AsyncCall::OnExecute(env, context_);
     AsyncCall::OnComplete(env, napi_ok, context_);
+    DeleteContext(env, context_);
     context_ = nullptr;
     return promise;
 }
@@ -136,15 +132,31 @@ void AsyncCall::OnComplete(napi_env env, napi_status status, void *data)
         napi_value returnValue;
         napi_call_function(env, nullptr, callback, ARG_BUTT, result, &returnValue);
     }
-    DeleteContext(env, context);
 }
-void AsyncCall::DeleteContext(napi_env env, AsyncContext *context)
+
+void AsyncCall::AsyncContext::Execute()
+{
+    AsyncCall::OnExecute(nullptr, this);
+}
+
+void AsyncCall::AsyncContext::Complete(napi_env env)
+{
+    AsyncCall::OnComplete(env, napi_ok, this);
+    // The worker deletes the context itself.
+    DeleteReferences(env, this);
+}
+
+void AsyncCall::DeleteReferences(napi_env env, AsyncContext *context)
 {
     if (env != nullptr) {
         napi_delete_reference(env, context->callback);
         napi_delete_reference(env, context->self);
-        napi_delete_async_work(env, context->work);
     }
+}
+
+void AsyncCall::DeleteContext(napi_env env, AsyncContext *context)
+{
+    DeleteReferences(env, context);
     delete context;
 }
 } // namespace OHOS::Request::UploadNapi
\ No newline at end of file
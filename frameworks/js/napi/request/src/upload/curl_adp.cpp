@@ -18,6 +18,7 @@
 #include <fcntl.h>
 #include <unistd.h>
 
+#include <chrono>
 #include <cinttypes>
 #include <climits>
 #include <cstdio>
@@ -26,16 +27,16 @@
 #include <string>
 #include <vector>
 
-#include "common_timer_errors.h"
 #include "constant.h"
+#include "upload/upload_engine.h"
 #include "upload/upload_hilog_wrapper.h"
 #include "upload/upload_task.h"
 
 namespace OHOS::Request::Upload {
 static constexpr const char *HTTP_DEFAULT_CA_PATH = "/etc/ssl/certs/cacert.pem";
 CUrlAdp::CUrlAdp(std::vector<FileData> &fileDatas, std::shared_ptr<UploadConfig> &config)
-    : timerId_(0), fileDatas_(fileDatas), config_(config), isCurlGlobalInit_(false), curlMulti_(nullptr),
-      isReadAbort_(false), timer_("uploadTimer")
+    : fileDatas_(fileDatas), config_(config), curl_(nullptr), mime_(nullptr), fileIndex_(0), successCount_(0),
+      isReadAbort_(false)
 {
 }
 
@@ -44,15 +45,22 @@ CUrlAdp::~CUrlAdp()
     UPLOAD_HILOGI(UPLOAD_MODULE_FRAMEWORK, "~CUrlAdp()");
 }
 
-uint32_t CUrlAdp::DoUpload(std::shared_ptr<IUploadTask> task)
+void CUrlAdp::DoUpload(std::shared_ptr<IUploadTask> task, UploadDone done)
 {
     UPLOAD_HILOGD(UPLOAD_MODULE_FRAMEWORK, "upload start");
     if (task != nullptr) {
         uploadTask_ = task;
     }
+    done_ = std::move(done);
+    fileIndex_ = 0;
+    successCount_ = 0;
+    UploadNext();
+}
 
-    uint32_t successCount = 0;
-    for (auto &vmem : fileDatas_) {
+void CUrlAdp::UploadNext()
+{
+    for (; fileIndex_ < fileDatas_.size(); fileIndex_++) {
+        FileData &vmem = fileDatas_[fileIndex_];
         UPLOAD_HILOGD(UPLOAD_MODULE_FRAMEWORK, "read abort stat: %{public}d file index: %{public}u", IsReadAbort(),
             vmem.fileIndex);
         if (IsReadAbort()) {
@@ -62,40 +70,63 @@ uint32_t CUrlAdp::DoUpload(std::shared_ptr<IUploadTask> task)
 
         mfileData_ = vmem;
         mfileData_.adp = shared_from_this();
-        vmem.result = static_cast<uint32_t>(UploadOneFile());
-        if (vmem.result == UPLOAD_OK) {
-            successCount++;
-        }
-        mfileData_.responseHead.clear();
-        if (mfileData_.list) {
-            curl_slist_free_all(mfileData_.list);
-            mfileData_.list = nullptr;
+        if (UploadOneFile()) {
+            // Goes on in OnFileDone once the engine is done with the file.
+            return;
         }
+        vmem.result = UPLOAD_ERRORCODE_UPLOAD_LIB_ERROR;
         ClearCurlResource();
-        usleep(FILE_UPLOAD_INTERVAL);
+    }
+    uint32_t result = (IsSuccess(successCount_, fileDatas_.size())) ? UPLOAD_OK : UPLOAD_ERRORCODE_UPLOAD_FAIL;
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        if (curl_ != nullptr) {
+            curl_easy_cleanup(curl_);
+            curl_ = nullptr;
+        }
     }
     mfileData_.adp = nullptr;
     uploadTask_ = nullptr;
-    return (IsSuccess(successCount, fileDatas_.size())) ? UPLOAD_OK : UPLOAD_ERRORCODE_UPLOAD_FAIL;
+    UploadDone done = std::move(done_);
+    done_ = nullptr;
+    if (done != nullptr) {
+        done(result);
+    }
 }
 
-bool CUrlAdp::IsSuccess(const uint32_t count, const uint32_t size)
+bool CUrlAdp::UploadOneFile()
 {
-    return (count == size);
+    std::lock_guard<std::mutex> guard(mutex_);
+    // The handle is kept across the files, with its live connection.
+    if (curl_ == nullptr) {
+        curl_ = curl_easy_init();
+    }
+    if (curl_ == nullptr) {
+        return false;
+    }
+    UploadEngine::GetInstance().Share(curl_);
+    SetCurlOpt(curl_);
+    std::shared_ptr<CUrlAdp> adp = shared_from_this();
+    return UploadEngine::GetInstance().Add(curl_, [adp](CURL *curl, CURLcode code) { adp->OnFileDone(curl, code); });
 }
 
-bool CUrlAdp::MultiAddHandle(CURLM *curlMulti, std::vector<CURL *> &curlArray)
+void CUrlAdp::OnFileDone(CURL *curl, CURLcode code)
 {
-    CURL *curl = curl_easy_init();
-    if (curl == nullptr) {
-        return false;
+    int result = CheckUploadStatus(curl, code);
+    if (fileIndex_ < fileDatas_.size()) {
+        fileDatas_[fileIndex_].result = static_cast<uint32_t>(result);
+    }
+    if (result == UPLOAD_OK) {
+        successCount_++;
     }
+    ClearCurlResource();
+    fileIndex_++;
+    UploadNext();
+}
 
-    SetCurlOpt(curl);
-    std::lock_guard<std::mutex> guard(mutex_);
-    curlArray.push_back(curl);
-    curl_multi_add_handle(curlMulti, curl);
-    return true;
+bool CUrlAdp::IsSuccess(const uint32_t count, const uint32_t size)
+{
+    return (count == size);
 }
 
 void CUrlAdp::SetHeadData(CURL *curl)
@@ -174,6 +205,13 @@ void CUrlAdp::SetSslOpt(CURL *curl)
 
 std::string CUrlAdp::ReadCertification()
 {
+    // Read once for all the files and tasks, until it is read successfully.
+    static std::mutex certMutex;
+    static std::string certInfo;
+    std::lock_guard<std::mutex> guard(certMutex);
+    if (!certInfo.empty()) {
+        return certInfo;
+    }
     std::ifstream inFile(HTTP_DEFAULT_CA_PATH, std::ios::in | std::ios::binary);
     if (!inFile.is_open()) {
         UPLOAD_HILOGE(UPLOAD_MODULE_FRAMEWORK, "open cacert.pem failed, errno:%{public}d", errno);
@@ -181,7 +219,8 @@ std::string CUrlAdp::ReadCertification()
     }
     std::stringstream buf;
     buf << inFile.rdbuf();
-    return std::string(buf.str());
+    certInfo = buf.str();
+    return certInfo;
 }
 
 void CUrlAdp::SetCurlOpt(CURL *curl)
@@ -216,6 +255,7 @@ void CUrlAdp::SetMimePost(CURL *curl)
     curl_mime_filename(part, mfileData_.filename.c_str());
     curl_mime_data_cb(part, mfileData_.totalsize, ReadCallback, NULL, NULL, &mfileData_);
     curl_easy_setopt(curl, CURLOPT_MIMEPOST, mime);
+    mime_ = mime;
 }
 
 void CUrlAdp::SetHttpPut(CURL *curl)
@@ -226,87 +266,29 @@ void CUrlAdp::SetHttpPut(CURL *curl)
     curl_easy_setopt(curl, CURLOPT_INFILESIZE, mfileData_.totalsize);
 }
 
-int32_t CUrlAdp::UploadOneFile()
+int CUrlAdp::CheckUploadStatus(CURL *curl, CURLcode code)
 {
-    CurlGlobalInit();
-    curlMulti_ = curl_multi_init();
-    if (curlMulti_ == nullptr) {
-        CurlGlobalCleanup();
-        return UPLOAD_ERRORCODE_UPLOAD_LIB_ERROR;
-    }
-
-    bool ret = MultiAddHandle(curlMulti_, curlArray_);
-    if (ret == false) {
-        return UPLOAD_ERRORCODE_UPLOAD_LIB_ERROR;
-    }
-
-    int isRunning = 0;
-    curl_multi_perform(curlMulti_, &isRunning);
-    UPLOAD_HILOGD(UPLOAD_MODULE_FRAMEWORK, "isRunning = %{public}d", isRunning);
-    do {
-        int numfds = 0;
-        int res = curl_multi_wait(curlMulti_, NULL, 0, TRANS_TIMEOUT_MS, &numfds);
-        if (res != CURLM_OK) {
-            return res;
-        }
-        curl_multi_perform(curlMulti_, &isRunning);
-    } while (isRunning);
-
-    return CheckUploadStatus(curlMulti_);
-}
-
-void CUrlAdp::CurlGlobalInit()
-{
-    std::lock_guard<std::mutex> guard(globalMutex_);
-    if (!isCurlGlobalInit_) {
-        isCurlGlobalInit_ = true;
-    }
-}
-
-void CUrlAdp::CurlGlobalCleanup()
-{
-    std::lock_guard<std::mutex> guard(globalMutex_);
-    if (isCurlGlobalInit_) {
-        isCurlGlobalInit_ = false;
-    }
-}
-
-int CUrlAdp::CheckUploadStatus(CURLM *curlMulti)
-{
-    int msgsLeft = 0;
-    int returnCode = UPLOAD_ERRORCODE_UPLOAD_FAIL;
-    CURLMsg *msg = NULL;
     if (IsReadAbort()) {
         UPLOAD_HILOGE(UPLOAD_MODULE_FRAMEWORK, "CheckUploadStatus  IsReadAbort is %{public}d", IsReadAbort());
-        return returnCode;
+        return UPLOAD_ERRORCODE_UPLOAD_FAIL;
+    }
+    if (code == CURLE_SSL_CONNECT_ERROR) {
+        UPLOAD_HILOGE(UPLOAD_MODULE_FRAMEWORK, "upload fail curl error %{public}d", code);
+        return UPLOAD_CURLE_SSL_CONNECT_ERROR;
+    }
+    if (code != CURLE_OK) {
+        UPLOAD_HILOGE(UPLOAD_MODULE_FRAMEWORK, "upload fail curl error %{public}d", code);
+        return UPLOAD_ERRORCODE_UPLOAD_LIB_ERROR;
     }
-    while ((msg = curl_multi_info_read(curlMulti, &msgsLeft))) {
-        if (msg->msg != CURLMSG_DONE) {
-            continue;
-        }
-        CURL *eh = NULL;
-        eh = msg->easy_handle;
-        returnCode = msg->data.result;
-        if (returnCode == CURLE_SSL_CONNECT_ERROR) {
-            UPLOAD_HILOGE(UPLOAD_MODULE_FRAMEWORK, "upload fail curl error %{public}d", returnCode);
-            return UPLOAD_CURLE_SSL_CONNECT_ERROR;
-        }
-        if (returnCode != CURLE_OK) {
-            UPLOAD_HILOGE(UPLOAD_MODULE_FRAMEWORK, "upload fail curl error %{public}d", returnCode);
-            return UPLOAD_ERRORCODE_UPLOAD_LIB_ERROR;
-        }
 
-        long respCode = 0;
-        curl_easy_getinfo(eh, CURLINFO_RESPONSE_CODE, &respCode);
-        UPLOAD_HILOGD(UPLOAD_MODULE_FRAMEWORK, "upload http code %{public}ld", respCode);
-        if (respCode != HTTP_SUCCESS) {
-            returnCode = respCode;
-            UPLOAD_HILOGE(UPLOAD_MODULE_FRAMEWORK, "upload fail http error %{public}d", returnCode);
-            return UPLOAD_ERRORCODE_UPLOAD_FAIL;
-        }
-        returnCode = UPLOAD_OK;
+    long respCode = 0;
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &respCode);
+    UPLOAD_HILOGD(UPLOAD_MODULE_FRAMEWORK, "upload http code %{public}ld", respCode);
+    if (respCode != HTTP_SUCCESS) {
+        UPLOAD_HILOGE(UPLOAD_MODULE_FRAMEWORK, "upload fail http error %{public}ld", respCode);
+        return UPLOAD_ERRORCODE_UPLOAD_FAIL;
     }
-    return returnCode;
+    return UPLOAD_OK;
 }
 
 bool CUrlAdp::Remove()
@@ -320,16 +302,20 @@ bool CUrlAdp::Remove()
 bool CUrlAdp::ClearCurlResource()
 {
     std::lock_guard<std::mutex> guard(mutex_);
-    for (auto url : curlArray_) {
-        curl_multi_remove_handle(curlMulti_, url);
-        curl_easy_cleanup(url);
+    mfileData_.responseHead.clear();
+    if (mfileData_.list) {
+        curl_slist_free_all(mfileData_.list);
+        mfileData_.list = nullptr;
+    }
+    // Reset rather than cleaned up, the handle keeps its connection and caches
+    // for the next file.
+    if (curl_ != nullptr) {
+        curl_easy_reset(curl_);
     }
-    curlArray_.clear();
-    if (curlMulti_) {
-        curl_multi_cleanup(curlMulti_);
-        curlMulti_ = nullptr;
+    if (mime_ != nullptr) {
+        curl_mime_free(mime_);
+        mime_ = nullptr;
     }
-    CurlGlobalCleanup();
     return true;
 }
 
@@ -447,30 +433,15 @@ size_t CUrlAdp::ReadCallback(char *buffer, size_t size, size_t nitems, void *arg
 
     std::shared_ptr<CUrlAdp> url = fData->adp;
     std::lock_guard<std::mutex> lock(url->curlMutex_);
-    url->StartTimer();
+    auto start = std::chrono::steady_clock::now();
     size_t readSize = fread(buffer, size, nitems, fData->fp);
-    url->StopTimer();
+    // A read this slow stalls every upload of the engine, give up on the task.
+    if (std::chrono::steady_clock::now() - start > std::chrono::milliseconds(READFILE_TIMEOUT_MS)) {
+        UPLOAD_HILOGE(UPLOAD_MODULE_FRAMEWORK, "read file timeout");
+        url->isReadAbort_ = true;
+    }
 
     return readSize;
 }
 
-void CUrlAdp::StartTimer()
-{
-    uint32_t ret = timer_.Setup();
-    if (ret != Utils::TIMER_ERR_OK) {
-        UPLOAD_HILOGI(UPLOAD_MODULE_FRAMEWORK, "Create Timer error");
-        return;
-    }
-    auto TimeOutCallback = [this]() {
-        UPLOAD_HILOGD(UPLOAD_MODULE_FRAMEWORK, "OutTime error");
-        this->isReadAbort_ = true;
-    };
-    timerId_ = timer_.Register(TimeOutCallback, READFILE_TIMEOUT_MS, true);
-}
-
-void CUrlAdp::StopTimer()
-{
-    timer_.Unregister(timerId_);
-    timer_.Shutdown();
-}
 } // namespace OHOS::Request::Upload
\ No newline at end of file
@@ -0,0 +1,246 @@
+/*
+ * Copyright (c) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "upload/upload_engine.h"
+
+#include <pthread.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <thread>
+
+#include "upload/upload_hilog_wrapper.h"
+
+namespace OHOS::Request::Upload {
+UploadEngine &UploadEngine::GetInstance()
+{
+    // Never destroyed, its thread may still run at exit.
+    static UploadEngine *engine = new UploadEngine();
+    return *engine;
+}
+
+void UploadEngine::Share(CURL *curl)
+{
+    std::call_once(shareFlag_, [this]() {
+        share_ = curl_share_init();
+        if (share_ == nullptr) {
+            UPLOAD_HILOGE(UPLOAD_MODULE_FRAMEWORK, "upload engine share init failed");
+            return;
+        }
+        curl_share_setopt(share_, CURLSHOPT_LOCKFUNC, LockShare);
+        curl_share_setopt(share_, CURLSHOPT_UNLOCKFUNC, UnlockShare);
+        curl_share_setopt(share_, CURLSHOPT_USERDATA, this);
+        curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+        curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+    });
+    if (share_ != nullptr) {
+        curl_easy_setopt(curl, CURLOPT_SHARE, share_);
+    }
+}
+
+bool UploadEngine::Add(CURL *curl, Done done)
+{
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        if (!started_ && !Start()) {
+            return false;
+        }
+        pending_.emplace_back(curl, std::move(done));
+    }
+    Wake();
+    return true;
+}
+
+bool UploadEngine::Start()
+{
+    epollFd_ = epoll_create1(EPOLL_CLOEXEC);
+    eventFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    multi_ = curl_multi_init();
+    if (epollFd_ < 0 || eventFd_ < 0 || multi_ == nullptr) {
+        UPLOAD_HILOGE(UPLOAD_MODULE_FRAMEWORK, "upload engine init failed, errno: %{public}d", errno);
+        if (epollFd_ >= 0) {
+            close(epollFd_);
+            epollFd_ = -1;
+        }
+        if (eventFd_ >= 0) {
+            close(eventFd_);
+            eventFd_ = -1;
+        }
+        if (multi_ != nullptr) {
+            curl_multi_cleanup(multi_);
+            multi_ = nullptr;
+        }
+        return false;
+    }
+    curl_multi_setopt(multi_, CURLMOPT_SOCKETFUNCTION, SocketCallback);
+    curl_multi_setopt(multi_, CURLMOPT_SOCKETDATA, this);
+    curl_multi_setopt(multi_, CURLMOPT_TIMERFUNCTION, TimerCallback);
+    curl_multi_setopt(multi_, CURLMOPT_TIMERDATA, this);
+    struct epoll_event event {};
+    event.events = EPOLLIN;
+    event.data.fd = eventFd_;
+    epoll_ctl(epollFd_, EPOLL_CTL_ADD, eventFd_, &event);
+    // The engine lives as long as the process, so does its thread.
+    std::thread(&UploadEngine::Run, this).detach();
+    started_ = true;
+    return true;
+}
+
+void UploadEngine::Wake()
+{
+    uint64_t one = 1;
+    if (write(eventFd_, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+        UPLOAD_HILOGE(UPLOAD_MODULE_FRAMEWORK, "upload engine wake failed, errno: %{public}d", errno);
+    }
+}
+
+void UploadEngine::Run()
+{
+    pthread_setname_np(pthread_self(), "upload_engine");
+    struct epoll_event events[MAX_EVENTS];
+    while (true) {
+        int waitMs = -1;
+        if (hasDeadline_) {
+            auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline_ - std::chrono::steady_clock::now());
+            waitMs = left.count() > 0 ? static_cast<int>(left.count()) : 0;
+        }
+        int num = epoll_wait(epollFd_, events, MAX_EVENTS, waitMs);
+        if (num < 0 && errno != EINTR) {
+            UPLOAD_HILOGE(UPLOAD_MODULE_FRAMEWORK, "upload engine epoll_wait failed, errno: %{public}d", errno);
+        }
+        for (int i = 0; i < num; i++) {
+            if (events[i].data.fd == eventFd_) {
+                uint64_t count = 0;
+                (void)read(eventFd_, &count, sizeof(count));
+                AddPending();
+            } else {
+                OnEvent(events[i].data.fd, events[i].events);
+            }
+        }
+        if (hasDeadline_ && std::chrono::steady_clock::now() >= deadline_) {
+            hasDeadline_ = false;
+            int running = 0;
+            curl_multi_socket_action(multi_, CURL_SOCKET_TIMEOUT, 0, &running);
+        }
+        CheckDone();
+    }
+}
+
+void UploadEngine::AddPending()
+{
+    std::vector<std::pair<CURL *, Done>> pending;
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        pending.swap(pending_);
+    }
+    for (auto &[curl, done] : pending) {
+        CURLMcode code = curl_multi_add_handle(multi_, curl);
+        if (code != CURLM_OK) {
+            UPLOAD_HILOGE(UPLOAD_MODULE_FRAMEWORK, "upload engine add handle failed: %{public}d", code);
+            done(curl, CURLE_FAILED_INIT);
+            continue;
+        }
+        running_.emplace(curl, std::move(done));
+    }
+}
+
+void UploadEngine::OnEvent(int fd, uint32_t events)
+{
+    int action = 0;
+    if (events & EPOLLIN) {
+        action |= CURL_CSELECT_IN;
+    }
+    if (events & EPOLLOUT) {
+        action |= CURL_CSELECT_OUT;
+    }
+    if (events & (EPOLLERR | EPOLLHUP)) {
+        action |= CURL_CSELECT_ERR;
+    }
+    int running = 0;
+    curl_multi_socket_action(multi_, fd, action, &running);
+}
+
+void UploadEngine::CheckDone()
+{
+    int msgsLeft = 0;
+    CURLMsg *msg = nullptr;
+    while ((msg = curl_multi_info_read(multi_, &msgsLeft)) != nullptr) {
+        if (msg->msg != CURLMSG_DONE) {
+            continue;
+        }
+        CURL *curl = msg->easy_handle;
+        CURLcode result = msg->data.result;
+        curl_multi_remove_handle(multi_, curl);
+        auto it = running_.find(curl);
+        if (it == running_.end()) {
+            continue;
+        }
+        Done done = std::move(it->second);
+        running_.erase(it);
+        done(curl, result);
+    }
+}
+
+int UploadEngine::SocketCallback(CURL *curl, curl_socket_t fd, int what, void *userp, void *socketp)
+{
+    UploadEngine *engine = static_cast<UploadEngine *>(userp);
+    if (what == CURL_POLL_REMOVE) {
+        epoll_ctl(engine->epollFd_, EPOLL_CTL_DEL, fd, nullptr);
+        return 0;
+    }
+    struct epoll_event event {};
+    if (what == CURL_POLL_IN || what == CURL_POLL_INOUT) {
+        event.events |= EPOLLIN;
+    }
+    if (what == CURL_POLL_OUT || what == CURL_POLL_INOUT) {
+        event.events |= EPOLLOUT;
+    }
+    event.data.fd = fd;
+    // A socket curl already asked about carries a non-null pointer.
+    if (socketp != nullptr) {
+        epoll_ctl(engine->epollFd_, EPOLL_CTL_MOD, fd, &event);
+    } else {
+        epoll_ctl(engine->epollFd_, EPOLL_CTL_ADD, fd, &event);
+        curl_multi_assign(engine->multi_, fd, engine);
+    }
+    return 0;
+}
+
+void UploadEngine::LockShare(CURL *curl, curl_lock_data data, curl_lock_access access, void *userp)
+{
+    static_cast<UploadEngine *>(userp)->shareMutex_[data].lock();
+}
+
+void UploadEngine::UnlockShare(CURL *curl, curl_lock_data data, void *userp)
+{
+    static_cast<UploadEngine *>(userp)->shareMutex_[data].unlock();
+}
+
+int UploadEngine::TimerCallback(CURLM *multi, long timeoutMs, void *userp)
+{
+    UploadEngine *engine = static_cast<UploadEngine *>(userp);
+    if (timeoutMs < 0) {
+        engine->hasDeadline_ = false;
+        return 0;
+    }
+    engine->deadline_ = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    engine->hasDeadline_ = true;
+    return 0;
+}
+} // namespace OHOS::Request::Upload
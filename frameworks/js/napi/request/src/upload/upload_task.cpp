@@ -15,12 +15,9 @@
 
 #include "upload/upload_task.h"
 
-#include <pthread.h>
-
-#include <thread>
-
 #include "curl/curl.h"
 #include "curl/easy.h"
+#include "ffrt.h"
 
 namespace OHOS::Request::Upload {
 UploadTask::UploadTask(std::shared_ptr<UploadConfig> &uploadConfig)
@@ -70,25 +67,11 @@ void UploadTask::SetUploadProxy(std::shared_ptr<UploadTaskNapiV5> proxy)
 void UploadTask::Run(std::shared_ptr<Upload::UploadTask> task)
 {
     UPLOAD_HILOGD(UPLOAD_MODULE_FRAMEWORK, "Run. In.");
-    pthread_setname_np(pthread_self(), "upload_task");
-    usleep(USLEEP_INTERVAL_BEFORE_RUN);
     if (task == nullptr) {
         UPLOAD_HILOGE(UPLOAD_MODULE_FRAMEWORK, "task == nullptr");
         return;
     }
     task->OnRun();
-    std::lock_guard<std::mutex> guard(task->removeMutex_);
-    if (task->isRemoved_) {
-        task->SetUploadProxy(nullptr);
-        return;
-    }
-    if (task->uploadConfig_->protocolVersion == API3) {
-        if (task->uploadConfig_->fcomplete) {
-            task->uploadConfig_->fcomplete();
-            UPLOAD_HILOGD(UPLOAD_MODULE_FRAMEWORK, "Complete.");
-        }
-    }
-    task->SetUploadProxy(nullptr);
 }
 
 uint32_t UploadTask::InitFileArray()
@@ -147,7 +130,9 @@ uint32_t UploadTask::StartUploadFile()
         return ret;
     }
     curlAdp_ = std::make_shared<CUrlAdp>(fileDatas_, uploadConfig_);
-    return curlAdp_->DoUpload(shared_from_this());
+    std::shared_ptr<UploadTask> task = shared_from_this();
+    curlAdp_->DoUpload(task, [task](uint32_t ret) { task->OnDone(ret); });
+    return UPLOAD_OK;
 }
 
 void UploadTask::OnRun()
@@ -155,25 +140,44 @@ void UploadTask::OnRun()
     UPLOAD_HILOGD(UPLOAD_MODULE_FRAMEWORK, "OnRun. In.");
     state_ = STATE_RUNNING;
     uint32_t ret = StartUploadFile();
+    if (ret != UPLOAD_OK) {
+        OnDone(ret);
+    }
+}
+
+void UploadTask::OnDone(uint32_t ret)
+{
+    UPLOAD_HILOGD(UPLOAD_MODULE_FRAMEWORK, "OnDone. In.");
     std::lock_guard<std::mutex> guard(removeMutex_);
-    if (!isRemoved_) {
-        if (ret != UPLOAD_OK) {
-            UPLOAD_HILOGE(UPLOAD_MODULE_FRAMEWORK, "ret != UPLOAD_OK");
-            state_ = STATE_FAILURE;
-        } else {
-            state_ = STATE_SUCCESS;
+    totalSize_ = 0;
+    if (isRemoved_) {
+        SetUploadProxy(nullptr);
+        return;
+    }
+    if (ret != UPLOAD_OK) {
+        UPLOAD_HILOGE(UPLOAD_MODULE_FRAMEWORK, "ret != UPLOAD_OK");
+        state_ = STATE_FAILURE;
+    } else {
+        state_ = STATE_SUCCESS;
+    }
+    ClearFileArray();
+    if (uploadConfig_->protocolVersion == API3) {
+        if (uploadConfig_->fcomplete) {
+            uploadConfig_->fcomplete();
+            UPLOAD_HILOGD(UPLOAD_MODULE_FRAMEWORK, "Complete.");
         }
-        ClearFileArray();
     }
-    totalSize_ = 0;
+    SetUploadProxy(nullptr);
 }
 
 void UploadTask::ExecuteTask()
 {
     UPLOAD_HILOGD(UPLOAD_MODULE_FRAMEWORK, "ExecuteTask. In.");
-    thread_ = std::make_unique<std::thread>(UploadTask::Run, shared_from_this());
-    thread_handle_ = thread_->native_handle();
-    thread_->detach();
+    // Only opening the files runs on a worker, their transfers all share the
+    // thread of the UploadEngine.
+    std::shared_ptr<UploadTask> task = shared_from_this();
+    ffrt::submit([task]() { UploadTask::Run(task); }, {}, {},
+        ffrt::task_attr().name("Os_Request_Upload").qos(ffrt::qos_default).delay(USLEEP_INTERVAL_BEFORE_RUN));
 }
 
 void UploadTask::ClearFileArray()
@@ -16,11 +16,13 @@
 #ifndef REQUEST_INOTIFY_EVENT_LISTENT_H
 #define REQUEST_INOTIFY_EVENT_LISTENT_H
 
-#include <atomic>
+#include <chrono>
 #include <cstdint>
 #include <filesystem>
-#include <functional>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace fs = std::filesystem;
 
@@ -34,34 +36,57 @@ namespace OHOS::Request {
 
 struct DirRebuilder;
 
+/**
+ * @brief Watches directories for deletion on one shared thread
+ *
+ * Every watched directory is a watch descriptor of a single inotify instance.
+ * Events of a directory are coalesced for COALESCE_WINDOW and a directory is
+ * rebuilt at most once per MIN_REBUILD_INTERVAL.
+ */
 class DirectoryMonitor {
 public:
-    DirectoryMonitor(const std::string &directory, rust::Box<DirRebuilder> callback);
-    DirectoryMonitor(DirectoryMonitor &&other) = delete;
-    DirectoryMonitor &operator=(DirectoryMonitor &&other) = delete;
+    static DirectoryMonitor &GetInstance();
 
     DirectoryMonitor(const DirectoryMonitor &) = delete;
     DirectoryMonitor &operator=(const DirectoryMonitor &) = delete;
-    ~DirectoryMonitor();
-    void Start();
-    void Stop();
+    DirectoryMonitor(DirectoryMonitor &&other) = delete;
+    DirectoryMonitor &operator=(DirectoryMonitor &&other) = delete;
+
+    bool Watch(const std::string &directory, rust::Box<DirRebuilder> callback);
 
 private:
-    int Run();
+    using Clock = std::chrono::steady_clock;
+
+    struct WatchEntry {
+        fs::path directory;
+        DirRebuilder *callback = nullptr;
+        bool pending = false;
+        Clock::time_point due;
+    };
+
+    DirectoryMonitor() = default;
+    ~DirectoryMonitor() = default;
+
+    bool EnsureStarted();
     int SetupInotify();
     int SetupEpoll();
-    int AddToEpoll(int fd, uint32_t events);
-    void HandleInotify();
+    void Run();
+    bool HandleInotify();
+    void Schedule(int wd, Clock::time_point now);
+    int NextTimeout(Clock::time_point now);
+    void RebuildDue(Clock::time_point now);
+    void Shutdown();
     void Cleanup();
 
-    fs::path directory_;
-    DirRebuilder *callback_;
+    std::mutex mutex_;
+    std::unordered_map<int, WatchEntry> watches_;
+    // Last rebuild of every directory, kept across watches of the same path
+    std::unordered_map<std::string, Clock::time_point> lastRebuild_;
 
     int inotify_fd_ = -1;
     int epoll_fd_ = -1;
-    int watch_descriptor_ = -1;
-    std::atomic<bool> running_{ false };
+    bool started_ = false;
 };
 } // namespace OHOS::Request
 
-#endif
\ No newline at end of file
+#endif
@@ -20,8 +20,7 @@
 #include "inotify_event_listener.h"
 
 namespace OHOS::Request {
-std::unique_ptr<DirectoryMonitor> NewDirectoryMonitor(const std::string &target, rust::Box<DirRebuilder> callback);
-void StartObserve(DirectoryMonitor &monitor);
+bool ObserveDirectory(const std::string &target, rust::Box<DirRebuilder> callback);
 } // namespace OHOS::Request
 
 #endif
\ No newline at end of file
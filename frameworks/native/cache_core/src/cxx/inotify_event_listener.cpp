@@ -20,76 +20,85 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <cerrno>
 #include <climits>
-#include <csignal>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <filesystem>
+#include <thread>
 
 #include "cxx.h"
-#include "ffrt.h"
 #include "log.h"
 #include "wrapper.rs.h"
 
 namespace OHOS::Request {
+namespace {
+// Events of a directory arriving within this window cause one rebuild
+constexpr std::chrono::milliseconds COALESCE_WINDOW(200);
+// A directory deleted again right after its rebuild waits this long
+constexpr std::chrono::milliseconds MIN_REBUILD_INTERVAL(1000);
+constexpr uint32_t WATCH_MASK = IN_DELETE_SELF | IN_MOVE_SELF;
+} // namespace
+
 /**
- * @class DirectoryMonitor
- * @brief Monitors a directory for changes using inotify and epoll
+ * @brief Returns the monitor shared by all watched directories
+ *
+ * The monitor is never destroyed, so its thread can outlive static destruction.
  */
-DirectoryMonitor::DirectoryMonitor(const std::string &directory, rust::Box<DirRebuilder> callback)
-{
-    // Convert the directory string to filesystem path
-    directory_ = fs::path(directory);
-    // Take ownership of the Rust callback by converting it to a raw pointer
-    callback_ = callback.into_raw();
-}
-
-DirectoryMonitor::~DirectoryMonitor()
+DirectoryMonitor &DirectoryMonitor::GetInstance()
 {
-    // Ensure monitoring is stopped
-    Stop();
-    // Clean up system resources
-    Cleanup();
-    // Reconstruct the Rust Box to properly deallocate the callback
-    rust::Box<DirRebuilder>::from_raw(callback_);
+    static DirectoryMonitor *instance = new DirectoryMonitor();
+    return *instance;
 }
 
 /**
- * @brief Starts the directory monitoring
- *
- * Initializes inotify and epoll, then enters the monitoring loop
+ * @brief Watches a directory and rebuilds it once it is deleted or moved
+ * @param directory Directory to watch
+ * @param callback Rebuilder called once for the directory, then dropped
+ * @return bool true if the directory is watched
  */
-void DirectoryMonitor::Start()
+bool DirectoryMonitor::Watch(const std::string &directory, rust::Box<DirRebuilder> callback)
 {
-    if (running_) {
-        return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!EnsureStarted()) {
+        return false;
     }
-    if (SetupInotify() == -1) {
-        Cleanup();
-        return;
+    int wd = inotify_add_watch(inotify_fd_, directory.c_str(), WATCH_MASK);
+    if (wd == -1) {
+        REQUEST_HILOGE("inotify_add_watch fail, err : %{public}s", strerror(errno));
+        return false;
     }
-    if (SetupEpoll() == -1) {
-        Cleanup();
-        return;
+    auto it = watches_.find(wd);
+    if (it != watches_.end()) {
+        // The directory is already watched, its rebuilder is kept
+        return true;
     }
-    running_ = true;
-    Run();
-    Cleanup();
+    WatchEntry entry;
+    entry.directory = fs::path(directory);
+    // Take ownership of the Rust callback by converting it to a raw pointer
+    entry.callback = callback.into_raw();
+    watches_.emplace(wd, std::move(entry));
+    return true;
 }
 
 /**
- * @brief Stops the directory monitoring
- *
- * Signals the monitoring loop to exit
+ * @brief Sets up inotify and epoll and starts the monitor thread on first use
+ * @return bool true if the monitor thread is running
  */
-void DirectoryMonitor::Stop()
+bool DirectoryMonitor::EnsureStarted()
 {
-    if (!running_) {
-        return;
+    if (started_) {
+        return true;
+    }
+    if (SetupInotify() == -1 || SetupEpoll() == -1) {
+        Cleanup();
+        return false;
     }
-    running_ = false;
+    std::thread(&DirectoryMonitor::Run, this).detach();
+    started_ = true;
+    return true;
 }
 
 /**
@@ -98,39 +107,34 @@ void DirectoryMonitor::Stop()
  */
 int DirectoryMonitor::SetupInotify()
 {
-    int ret = -1;
     // Create inotify instance with non-blocking and close-on-exec flags
-    ret = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    int ret = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
     if (ret == -1) {
         REQUEST_HILOGE("inotify_init1 fail, err : %{public}s", strerror(errno));
         return ret;
     }
     inotify_fd_ = ret;
-    // Add watch for directory deletion/move events
-    ret = inotify_add_watch(inotify_fd_, directory_.c_str(), IN_DELETE_SELF | IN_MOVE_SELF);
-    if (ret == -1) {
-        REQUEST_HILOGE("inotify_add_watch fail, err : %{public}s", strerror(errno));
-    }
-    watch_descriptor_ = ret;
     return ret;
 }
 
 /**
  * @brief Sets up epoll for monitoring inotify events
- * @return int File descriptor on success, -1 on failure
+ * @return int 0 on success, -1 on failure
  */
 int DirectoryMonitor::SetupEpoll()
 {
-    int ret = -1;
     // Create epoll instance
-    ret = epoll_create1(0);
+    int ret = epoll_create1(EPOLL_CLOEXEC);
     if (ret == -1) {
         REQUEST_HILOGE("create epoll instance fail, code : %{public}s", strerror(errno));
         return ret;
     }
     epoll_fd_ = ret;
     // Add inotify fd to epoll for read events
-    ret = AddToEpoll(inotify_fd_, EPOLLIN);
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = inotify_fd_;
+    ret = epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, inotify_fd_, &ev);
     if (ret == -1) {
         REQUEST_HILOGE("add inotify fd to epoll fail, code : %{public}s", strerror(errno));
     }
@@ -138,100 +142,172 @@ int DirectoryMonitor::SetupEpoll()
 }
 
 /**
- * @brief Adds a file descriptor to epoll monitoring
- * @param fd File descriptor to monitor
- * @param events Events to monitor for (EPOLLIN, etc.)
- * @return int 0 on success, -1 on failure
- */
-int DirectoryMonitor::AddToEpoll(int fd, uint32_t events)
-{
-    epoll_event ev{};
-    ev.events = events;
-    ev.data.fd = fd;
-    // Register the file descriptor with epoll
-    return epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev);
-}
-
-/**
- * @brief Main monitoring loop
- * @return int 0 on normal exit, -1 on error
+ * @brief Main monitoring loop, waits for events until the next due rebuild
  */
-int DirectoryMonitor::Run()
+void DirectoryMonitor::Run()
 {
     constexpr int MAX_EVENT = 10;
     epoll_event events[MAX_EVENT];
-    while (running_) {
-        // Wait for events with no timeout (blocks until events occur)
-        int num_events = epoll_wait(epoll_fd_, events, MAX_EVENT, -1);
+    while (true) {
+        int timeout = NextTimeout(Clock::now());
+        int num_events = epoll_wait(epoll_fd_, events, MAX_EVENT, timeout);
         if (num_events == -1) {
             // Handle interrupt signal
             if (errno == EINTR) {
                 continue;
             }
             REQUEST_HILOGE("epoll_wait fail, errno : %{public}s", strerror(errno));
-            running_ = false;
-            return -1;
+            Shutdown();
+            return;
         }
         // Process all received events
         for (int i = 0; i < num_events; ++i) {
-            if (events[i].data.fd == inotify_fd_) {
-                HandleInotify();
+            if (events[i].data.fd == inotify_fd_ && !HandleInotify()) {
+                Shutdown();
+                return;
             }
         }
+        RebuildDue(Clock::now());
     }
-    return 0;
 }
 
 /**
- * @brief Handles inotify events
+ * @brief Reads all pending inotify events and schedules the rebuilds
+ * @return bool false if the inotify instance failed
  */
-void DirectoryMonitor::HandleInotify()
+bool DirectoryMonitor::HandleInotify()
 {
     constexpr size_t EVENT_SIZE = sizeof(inotify_event);
-    constexpr size_t BUF_LEN = 1024 * (EVENT_SIZE + NAME_MAX + 1);
-
-    // Read events from inotify
-    char buffer[BUF_LEN];
-    ssize_t len = read(inotify_fd_, buffer, BUF_LEN);
-    if (len == -1) {
-        // Handle non-blocking mode errors
-        if (errno == EAGAIN || errno == EWOULDBLOCK) {
-            return;
+    constexpr size_t BUF_LEN = 16 * (EVENT_SIZE + NAME_MAX + 1);
+
+    alignas(inotify_event) char buffer[BUF_LEN];
+    while (true) {
+        ssize_t len = read(inotify_fd_, buffer, BUF_LEN);
+        if (len == -1) {
+            // Handle non-blocking mode errors
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return true;
+            }
+            if (errno == EINTR) {
+                continue;
+            }
+            REQUEST_HILOGE("read inotify_fd_ fail, err : %{public}s", strerror(errno));
+            return false;
         }
-        REQUEST_HILOGE("read inotify_fd_ fail, err : %{public}s", strerror(errno));
-        running_ = false;
+        auto now = Clock::now();
+        // Process each event in the buffer
+        for (char *ptr = buffer; ptr < buffer + len;) {
+            auto *event = reinterpret_cast<inotify_event *>(ptr);
+            ptr += EVENT_SIZE + event->len;
+            // A removed watch can no longer report the deletion, rebuild too
+            if (event->mask & (WATCH_MASK | IN_IGNORED)) {
+                Schedule(event->wd, now);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Schedules the rebuild of a watched directory
+ *
+ * Events of a directory already scheduled are coalesced into its rebuild.
+ */
+void DirectoryMonitor::Schedule(int wd, Clock::time_point now)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = watches_.find(wd);
+    if (it == watches_.end() || it->second.pending) {
         return;
     }
+    WatchEntry &entry = it->second;
+    entry.pending = true;
+    entry.due = now + COALESCE_WINDOW;
+    auto last = lastRebuild_.find(entry.directory.string());
+    if (last != lastRebuild_.end()) {
+        entry.due = std::max(entry.due, last->second + MIN_REBUILD_INTERVAL);
+    }
+}
 
-    // Process each event in the buffer
-    for (char *ptr = buffer; ptr < buffer + len;) {
-        auto *event = reinterpret_cast<inotify_event *>(ptr);
-        ptr += EVENT_SIZE + event->len;
+/**
+ * @brief Returns the epoll timeout until the next scheduled rebuild
+ * @return int Timeout in milliseconds, -1 if no rebuild is scheduled
+ */
+int DirectoryMonitor::NextTimeout(Clock::time_point now)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    int timeout = -1;
+    for (const auto &[wd, entry] : watches_) {
+        if (!entry.pending) {
+            continue;
+        }
+        auto wait = std::chrono::ceil<std::chrono::milliseconds>(entry.due - now).count();
+        int ms = static_cast<int>(std::max<decltype(wait)>(wait, 0));
+        timeout = timeout == -1 ? ms : std::min(timeout, ms);
+    }
+    return timeout;
+}
 
-        // Check for directory deletion/move events
-        if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF)) {
-            if (callback_ == nullptr) {
-                running_ = false;
-                return;
+/**
+ * @brief Rebuilds every directory whose rebuild is due
+ *
+ * The rebuilders are called and dropped outside of the lock, dropping one lets
+ * the Rust side watch the recreated directory again.
+ */
+void DirectoryMonitor::RebuildDue(Clock::time_point now)
+{
+    std::vector<DirRebuilder *> due;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto it = watches_.begin(); it != watches_.end();) {
+            if (!it->second.pending || it->second.due > now) {
+                ++it;
+                continue;
             }
-            // Notify Rust callback about directory removal
-            callback_->remove_store_dir();
-            running_ = false;
+            // Removing a watch the kernel already dropped fails harmlessly
+            inotify_rm_watch(inotify_fd_, it->first);
+            lastRebuild_[it->second.directory.string()] = now;
+            due.push_back(it->second.callback);
+            it = watches_.erase(it);
+        }
+    }
+    for (DirRebuilder *callback : due) {
+        // Notify Rust callback about directory removal
+        callback->remove_store_dir();
+        // Reconstruct the Rust Box to properly deallocate the callback
+        rust::Box<DirRebuilder>::from_raw(callback);
+    }
+}
+
+/**
+ * @brief Stops watching after the monitor thread failed
+ *
+ * The rebuilders are dropped without a rebuild, so their directories can be
+ * watched again by a new monitor thread.
+ */
+void DirectoryMonitor::Shutdown()
+{
+    std::vector<DirRebuilder *> dropped;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto &[wd, entry] : watches_) {
+            dropped.push_back(entry.callback);
         }
+        watches_.clear();
+        Cleanup();
+        started_ = false;
+    }
+    for (DirRebuilder *callback : dropped) {
+        rust::Box<DirRebuilder>::from_raw(callback);
     }
 }
 
 /**
  * @brief Cleans up system resources
  *
- * Removes inotify watches and closes file descriptors
+ * Closes the file descriptors, which also removes their inotify watches
  */
 void DirectoryMonitor::Cleanup()
 {
-    // Remove inotify watch if it was created
-    if (watch_descriptor_ != -1) {
-        inotify_rm_watch(inotify_fd_, watch_descriptor_);
-    }
     // Close inotify file descriptor if it was opened
     if (inotify_fd_ != -1) {
         close(inotify_fd_);
@@ -243,7 +319,6 @@ void DirectoryMonitor::Cleanup()
     // Reset all descriptors to invalid state
     inotify_fd_ = -1;
     epoll_fd_ = -1;
-    watch_descriptor_ = -1;
 }
 
-} // namespace OHOS::Request
\ No newline at end of file
+} // namespace OHOS::Request
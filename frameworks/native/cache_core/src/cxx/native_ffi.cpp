@@ -17,13 +17,8 @@
 #include "cxx.h"
 
 namespace OHOS::Request {
-std::unique_ptr<DirectoryMonitor> NewDirectoryMonitor(const std::string &target, rust::Box<DirRebuilder> callback)
+bool ObserveDirectory(const std::string &target, rust::Box<DirRebuilder> callback)
 {
-    return std::make_unique<DirectoryMonitor>(target, std::move(callback));
-}
-
-void StartObserve(DirectoryMonitor &monitor)
-{
-    monitor.Start();
+    return DirectoryMonitor::GetInstance().Watch(target, std::move(callback));
 }
 } // namespace OHOS::Request
\ No newline at end of file
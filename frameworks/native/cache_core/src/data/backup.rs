@@ -0,0 +1,103 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Index of the RAM caches waiting to be written to the file cache.
+//!
+//! The file writer holds the bodies it has not written yet, this index only
+//! refers to them weakly so they can be read until they are on disk without
+//! the index keeping them alive any longer. It is an LRU of at most
+//! `MAX_BACKUPS` entries, a body evicted from the index is still written but
+//! read from RAM only if it is in the RAM cache.
+
+use std::sync::{Arc, Mutex, Weak};
+
+use request_utils::lru::LRUCache;
+use request_utils::task_id::TaskId;
+
+use super::RamCache;
+
+/// Largest number of bodies waiting for their write that can be read.
+pub(crate) const MAX_BACKUPS: usize = 64;
+
+/// Weak index of the bodies queued for the file writer.
+pub(crate) struct BackupRams {
+    entries: Mutex<LRUCache<TaskId, Weak<RamCache>>>,
+}
+
+impl BackupRams {
+    /// Creates an empty index.
+    pub(crate) fn new() -> Self {
+        Self {
+            entries: Mutex::new(LRUCache::new()),
+        }
+    }
+
+    /// Indexes the body of a task queued for the file writer, replacing an
+    /// older body of the task.
+    pub(crate) fn insert(&self, task_id: TaskId, cache: &Arc<RamCache>) {
+        let mut entries = self.entries.lock().unwrap();
+        entries.insert(task_id, Arc::downgrade(cache));
+        while entries.len() > MAX_BACKUPS {
+            entries.pop();
+        }
+    }
+
+    /// Returns the body of a task if it is still waiting for its write.
+    pub(crate) fn get(&self, task_id: &TaskId) -> Option<Arc<RamCache>> {
+        let mut entries = self.entries.lock().unwrap();
+        let cache = entries.get(task_id).and_then(Weak::upgrade);
+        if cache.is_none() {
+            entries.remove(task_id);
+        }
+        cache
+    }
+
+    /// Whether the body of a task is waiting for its write.
+    pub(crate) fn contains_key(&self, task_id: &TaskId) -> bool {
+        self.get(task_id).is_some()
+    }
+
+    /// Removes the body of a task from the index.
+    pub(crate) fn remove(&self, task_id: &TaskId) {
+        self.entries.lock().unwrap().remove(task_id);
+    }
+
+    /// Removes the body of a task from the index if it is `cache`, and not a
+    /// newer body queued since.
+    pub(crate) fn remove_written(&self, task_id: &TaskId, cache: &Arc<RamCache>) {
+        let mut entries = self.entries.lock().unwrap();
+        if entries
+            .get(task_id)
+            .is_some_and(|backup| std::ptr::eq(backup.as_ptr(), Arc::as_ptr(cache)))
+        {
+            entries.remove(task_id);
+        }
+    }
+
+    /// Returns the number and the bytes of the indexed bodies still alive.
+    pub(crate) fn usage(&self) -> (usize, u64) {
+        let entries = self.entries.lock().unwrap();
+        entries
+            .values()
+            .filter_map(Weak::upgrade)
+            .fold((0, 0), |(count, bytes), cache| {
+                (count + 1, bytes + cache.size() as u64)
+            })
+    }
+}
+
+#[cfg(test)]
+mod ut_backup {
+    // Include test module containing unit tests for BackupRams
+    include!("../../tests/ut/data/ut_backup.rs");
+}
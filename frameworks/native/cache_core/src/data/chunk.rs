@@ -0,0 +1,58 @@
+// Copyright (C) 2024 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Pool of fixed-size storage chunks for RAM caches.
+//!
+//! Downloads without a known length are stored as a list of `CHUNK_SIZE`
+//! chunks instead of one growing vector, so they are never reallocated and
+//! copied. Released chunks are kept in a bounded free list and handed out
+//! again to the next download.
+
+use std::sync::Mutex;
+
+/// Size in bytes of a pooled chunk.
+pub(crate) const CHUNK_SIZE: usize = 64 * 1024;
+
+/// Maximum number of free chunks kept for reuse.
+const POOL_CAPACITY: usize = 64;
+
+static POOL: Mutex<Vec<Vec<u8>>> = Mutex::new(Vec::new());
+
+/// Takes an empty chunk with `CHUNK_SIZE` capacity from the pool.
+pub(crate) fn alloc_chunk() -> Vec<u8> {
+    POOL.lock()
+        .unwrap()
+        .pop()
+        .unwrap_or_else(|| Vec::with_capacity(CHUNK_SIZE))
+}
+
+/// Returns a chunk to the pool.
+///
+/// Chunks that were not taken from the pool, or that do not fit in it, are
+/// freed.
+pub(crate) fn free_chunk(mut chunk: Vec<u8>) {
+    if chunk.capacity() != CHUNK_SIZE {
+        return;
+    }
+    let mut pool = POOL.lock().unwrap();
+    if pool.len() < POOL_CAPACITY {
+        chunk.clear();
+        pool.push(chunk);
+    }
+}
+
+#[cfg(test)]
+mod ut_chunk {
+    // Include test module containing unit tests for the chunk pool
+    include!("../../tests/ut/data/ut_chunk.rs");
+}
@@ -25,17 +25,25 @@
 //! mechanisms for persisting data across application restarts.
 
 use std::collections::hash_map::Entry;
+use std::collections::HashMap;
 use std::fs::{self, DirEntry, File, OpenOptions};
-use std::io::{self, Seek, Write};
-use std::os::unix::fs::MetadataExt;
+use std::io::{self, Read, Write};
+use std::os::unix::fs::{FileExt, MetadataExt};
 use std::path::{Path, PathBuf};
 use std::str::FromStr;
+use std::sync::atomic::{AtomicBool, AtomicU64, Ordering};
 use std::sync::{Arc, Mutex, Once, OnceLock, Weak};
-use std::time::SystemTime;
+use std::thread;
+use std::time::{Duration, Instant, SystemTime};
 
+use request_utils::hash::Crc32c;
 use request_utils::task_id::TaskId;
 
+use super::journal::{now_secs, secs, JournalEntry, JOURNAL_NAME};
 use super::ram::RamCache;
+use super::{
+    CacheData, MappedCache, Validators, Weight, MMAP_MIN_SIZE, PARTIAL_SUFFIX, VALIDATOR_SUFFIX,
+};
 use crate::manage::CacheManager;
 use crate::spawn;
 
@@ -46,6 +54,20 @@ use crate::spawn;
 /// invalid.
 const FINISH_SUFFIX: &str = "_F";
 
+/// Files not in the cache index are only removed once they are this old, so
+/// files being written are kept.
+const ORPHAN_MIN_AGE: Duration = Duration::from_secs(10 * 60);
+
+/// Loads of file caches into RAM tracked before the finished ones whose
+/// bodies are dropped are swept.
+pub(crate) const MAX_FILE_LOADS: usize = 64;
+
+/// Minimum time in seconds between two scans for orphaned files.
+pub(crate) const ORPHAN_SCAN_INTERVAL: u64 = 30 * 60;
+
+/// Bytes read at once when checking the file caches in the background.
+const CHECK_BLOCK: usize = 64 * 1024;
+
 /// Global file store directory manager.
 ///
 /// This static variable manages the directories used for storing cache files. It is
@@ -382,10 +404,35 @@ impl HistoryDir {
 pub(crate) struct FileCache {
     /// ID of the task associated with this cache
     task_id: TaskId,
+    /// Size of the cache file applied from the file budget (in bytes)
+    size: u64,
+    /// Last access in seconds since the Unix epoch
+    accessed: AtomicU64,
+    /// Validators of the cached response
+    validators: Validators,
+    /// CRC-32C of the file when it was written, `None` if unknown
+    crc: Option<u32>,
+    /// Set once the file is known to match `crc`, shared with the checks in
+    /// progress
+    verified: Arc<AtomicBool>,
     /// Reference to the cache manager
     handle: &'static CacheManager,
 }
 
+/// Check of a file cache against its CRC-32C, see `FileCache::pending_check`.
+pub(crate) struct PendingCheck {
+    /// CRC-32C the file must match
+    crc: u32,
+    /// Flag of the file cache checked
+    verified: Arc<AtomicBool>,
+}
+
+impl Weight for FileCache {
+    fn weight(&self) -> u64 {
+        self.size
+    }
+}
+
 impl Drop for FileCache {
     /// Cleans up the cache file when the FileCache is dropped.
     ///
@@ -393,20 +440,17 @@ impl Drop for FileCache {
     fn drop(&mut self) {
         // Inner function to handle the actual cleanup with proper error handling
         fn drop_inner(me: &mut FileCache) -> Result<(), io::Error> {
+            // Release the space used by this cache even if its file is gone
+            me.handle.file_handle.release(me.size);
+            me.handle.journal.remove(&me.task_id);
+            Validators::remove(&me.task_id);
             if let Some(path) = FileCache::path(&me.task_id) {
-                let metadata = fs::metadata(&path)?;
                 debug!(
                     "try drop file cache {} for task {}",
-                    metadata.len(),
+                    me.size,
                     me.task_id.brief()
                 );
                 fs::remove_file(path)?;
-                // Release the memory used by this cache
-                me.handle
-                    .file_handle
-                    .lock()
-                    .unwrap()
-                    .release(metadata.len());
             }
             Ok(())
         }
@@ -444,6 +488,7 @@ impl FileCache {
             if !CacheManager::apply_cache(
                 &handle.file_handle,
                 &handle.files,
+                Some(&task_id),
                 metadata.len() as usize,
             ) {
                 info!("apply file cache for task {} failed", task_id.brief());
@@ -452,12 +497,56 @@ impl FileCache {
                 return None;
             }
 
-            Some(Self { task_id, handle })
+            let accessed = metadata.modified().map(secs).unwrap_or_else(|_| now_secs());
+            Some(Self {
+                validators: Validators::load(&task_id).unwrap_or_default(),
+                task_id,
+                size: metadata.len(),
+                accessed: AtomicU64::new(accessed),
+                crc: None,
+                verified: Arc::new(AtomicBool::new(false)),
+                handle,
+            })
         } else {
             None
         }
     }
 
+    /// Restores a file cache recorded in the journal without touching its
+    /// file.
+    ///
+    /// # Parameters
+    /// - `entry`: Journal entry of the file cache
+    /// - `handle`: Reference to the cache manager
+    ///
+    /// # Returns
+    /// `Some(FileCache)` if successful, `None` if the cache can't be applied, in
+    /// which case its file is removed
+    pub(crate) fn from_journal(entry: JournalEntry, handle: &'static CacheManager) -> Option<Self> {
+        if !CacheManager::apply_cache(
+            &handle.file_handle,
+            &handle.files,
+            Some(&entry.task_id),
+            entry.size as usize,
+        ) {
+            info!("apply file cache for task {} failed", entry.task_id.brief());
+            if let Some(path) = Self::path(&entry.task_id) {
+                let _ = fs::remove_file(path);
+            }
+            Validators::remove(&entry.task_id);
+            return None;
+        }
+        Some(Self {
+            task_id: entry.task_id,
+            size: entry.size,
+            accessed: AtomicU64::new(entry.accessed),
+            validators: entry.validators,
+            crc: entry.crc,
+            verified: Arc::new(AtomicBool::new(false)),
+            handle,
+        })
+    }
+
     /// Attempts to create a new file cache from RAM cache data.
     ///
     /// Writes the contents of the RAM cache to a file and creates a new FileCache instance.
@@ -482,19 +571,33 @@ impl FileCache {
         );
 
         // Check if we can allocate memory for this cache
-        if !CacheManager::apply_cache(&handle.file_handle, &handle.files, size) {
+        if !CacheManager::apply_cache(&handle.file_handle, &handle.files, Some(&task_id), size) {
             info!("apply file cache for task {} failed", task_id.brief());
             return None;
         }
 
         // Try to create the file cache
-        if let Err(e) = Self::create_file(&task_id, cache) {
-            error!("create file cache error: {}", e);
-            // Release memory if creation fails
-            handle.file_handle.lock().unwrap().release(size as u64);
-            return None;
-        }
-        Some(Self { task_id, handle })
+        let validators = cache.validators().cloned().unwrap_or_default();
+        let crc = match Self::create_file(&task_id, cache) {
+            Ok(crc) => crc,
+            Err(e) => {
+                error!("create file cache error: {}", e);
+                // Release memory if creation fails
+                handle.file_handle.release(size as u64);
+                handle.file_write_failed(&e);
+                return None;
+            }
+        };
+        Some(Self {
+            task_id,
+            size: size as u64,
+            accessed: AtomicU64::new(now_secs()),
+            validators,
+            crc: Some(crc),
+            // Written from the RAM cache just now
+            verified: Arc::new(AtomicBool::new(true)),
+            handle,
+        })
     }
 
     /// Creates a cache file and writes the contents of the RAM cache to it.
@@ -507,24 +610,33 @@ impl FileCache {
     /// - `cache`: RAM cache to write to disk
     ///
     /// # Returns
-    /// `Ok(())` if successful, `Err(io::Error)` if any file operation fails
-    fn create_file(task_id: &TaskId, cache: Arc<RamCache>) -> Result<(), io::Error> {
-        if let Some(path) = Self::path(task_id) {
+    /// `Ok(u32)` holding the CRC-32C of the file if successful,
+    /// `Err(io::Error)` if any file operation fails
+    fn create_file(task_id: &TaskId, cache: Arc<RamCache>) -> Result<u32, io::Error> {
+        // SAFETY: This is a read-only operation that joins a path
+        if let Some(path) = unsafe { FILE_STORE_DIR.join(task_id.to_string()) } {
             // Create the file and write cache contents
             let mut file = OpenOptions::new()
                 .write(true)
                 .create(true)
                 .truncate(true)
                 .open(path.as_path())?;
-            io::copy(&mut cache.cursor(), &mut file)?;
+            let mut crc = Crc32c::new();
+            for chunk in cache.chunks() {
+                file.write_all(chunk)?;
+                crc.update(chunk);
+            }
             file.flush()?;
-            file.rewind()?;
-            
+
             // Rename to indicate the file is complete
-            let file_name = format!("{}{}", task_id, FINISH_SUFFIX);
-            if let Some(new_path) = unsafe { FILE_STORE_DIR.join(file_name) } {
+            if let Some(new_path) = Self::path(task_id) {
                 fs::rename(path, new_path)?;
-                return Ok(());
+                if let Some(validators) = cache.validators() {
+                    if let Err(e) = validators.save(task_id) {
+                        error!("{} save validators failed {}", task_id.brief(), e);
+                    }
+                }
+                return Ok(crc.finish());
             }
         }
         Err(io::Error::new(
@@ -533,12 +645,53 @@ impl FileCache {
         ))
     }
 
+    /// Maps the cache file if it is large enough to be served without a copy.
+    ///
+    /// # Returns
+    /// `Ok(None)` if the file is smaller than `MMAP_MIN_SIZE`, otherwise the
+    /// mapping or the error that prevented it
+    pub(crate) fn map(&self) -> Result<Option<MappedCache>, io::Error> {
+        if self.size < MMAP_MIN_SIZE {
+            return Ok(None);
+        }
+        let file = self.open()?;
+        MappedCache::map(&file, self.size as usize).map(Some)
+    }
+
+    /// Reads a window of the cache file without reading the rest of it.
+    ///
+    /// Windows of at least `MMAP_MIN_SIZE` bytes are mapped, smaller ones
+    /// are read into a buffer.
+    ///
+    /// # Parameters
+    /// - `offset`: Position of the window in the file
+    /// - `len`: Length of the window, cut at the end of the file
+    ///
+    /// # Returns
+    /// `Ok(CacheData)` holding the window, `Err(io::Error)` if the file can't
+    /// be mapped or read
+    pub(crate) fn read_range(&self, offset: u64, len: u64) -> Result<CacheData, io::Error> {
+        let offset = offset.min(self.size);
+        let len = len.min(self.size - offset);
+        if len == 0 {
+            return Ok(CacheData::Read(Vec::new()));
+        }
+        let file = self.open()?;
+        if len >= MMAP_MIN_SIZE {
+            return MappedCache::map_range(&file, offset, len as usize).map(CacheData::Mapped);
+        }
+        let mut bytes = vec![0; len as usize];
+        file.read_exact_at(&mut bytes, offset)?;
+        Ok(CacheData::Read(bytes))
+    }
+
     /// Opens the cache file for reading.
     ///
     /// # Returns
     /// `Ok(File)` if successful, `Err(io::Error)` if the file can't be opened
     pub(crate) fn open(&self) -> Result<File, io::Error> {
         if let Some(path) = Self::path(&self.task_id) {
+            self.touch();
             OpenOptions::new().read(true).open(path)
         } else {
             Err(io::Error::new(
@@ -548,6 +701,42 @@ impl FileCache {
         }
     }
 
+    /// Returns the validators of the cached response.
+    pub(crate) fn validators(&self) -> &Validators {
+        &self.validators
+    }
+
+    /// Returns the check the file still needs before it is served, `None` if
+    /// it was verified or its CRC-32C is unknown.
+    pub(crate) fn pending_check(&self) -> Option<PendingCheck> {
+        if self.verified.load(Ordering::Acquire) {
+            return None;
+        }
+        self.crc.map(|crc| PendingCheck {
+            crc,
+            verified: self.verified.clone(),
+        })
+    }
+
+    /// Returns the journal entry describing this cache.
+    pub(crate) fn journal_entry(&self) -> JournalEntry {
+        JournalEntry {
+            task_id: self.task_id.clone(),
+            size: self.size,
+            accessed: self.accessed.load(Ordering::Relaxed),
+            validators: self.validators.clone(),
+            crc: self.crc,
+        }
+    }
+
+    /// Records a read of the cache, at most once per second.
+    fn touch(&self) {
+        let now = now_secs();
+        if self.accessed.swap(now, Ordering::Relaxed) != now {
+            self.handle.journal.touch(&self.task_id, now);
+        }
+    }
+
     /// Gets the path to the cache file for the given task ID.
     ///
     /// # Parameters
@@ -601,7 +790,8 @@ pub(crate) fn restore_files_inner(path: &Path) -> impl Iterator<Item = TaskId> {
     let mut v = files
         .into_iter()
         .filter_map(|entry| match filter_map_entry(entry, path) {
-            Ok((path, time)) => Some((path, time)),
+            Ok(Some((path, time))) => Some((path, time)),
+            Ok(None) => None,
             Err(e) => {
                 error!("restore file error {}", e);
                 None
@@ -625,11 +815,13 @@ pub(crate) fn restore_files_inner(path: &Path) -> impl Iterator<Item = TaskId> {
 /// - `path`: Base directory path
 ///
 /// # Returns
-/// `Ok((TaskId, SystemTime))` if the entry is a valid cache file, `Err(io::Error)` otherwise
+/// `Ok(Some((TaskId, SystemTime)))` if the entry is a valid cache file, `Ok(None)` for
+/// partial bodies, validators and the journal kept next to the caches, `Err(io::Error)`
+/// otherwise
 fn filter_map_entry(
     entry: Result<DirEntry, io::Error>,
     path: &Path,
-) -> Result<(TaskId, SystemTime), io::Error> {
+) -> Result<Option<(TaskId, SystemTime)>, io::Error> {
     // Get the file name and validate it
     let file_name = entry?.file_name();
     let file_name = file_name.to_str().ok_or(io::Error::new(
@@ -637,6 +829,15 @@ fn filter_map_entry(
         format!("invalid file name {:?}", file_name),
     ))?;
     
+    // Partial bodies, validators and the journal are not caches but are kept
+    // next to them
+    if file_name.ends_with(PARTIAL_SUFFIX)
+        || file_name.ends_with(VALIDATOR_SUFFIX)
+        || file_name.starts_with(JOURNAL_NAME)
+    {
+        return Ok(None);
+    }
+
     // Check for the finish suffix to ensure the file is complete
     if !file_name.ends_with(FINISH_SUFFIX) {
         // Remove incomplete files
@@ -652,45 +853,243 @@ fn filter_map_entry(
     let path = path.join(file_name);
     // Get the modification time
     let time = fs::metadata(path)?.modified()?;
-    Ok((task_id, time))
+    Ok(Some((task_id, time)))
+}
+
+/// Lists the orphaned files in a cache directory.
+///
+/// A cache body or validators file is orphaned if its task is not live, a file
+/// without a known suffix is left over from an interrupted write. Partial
+/// bodies and the journal are managed elsewhere and never listed.
+///
+/// # Parameters
+/// - `path`: Path to the directory to scan
+/// - `live`: Returns whether a task is in the cache index
+/// - `before`: Only files last modified before this time are listed
+///
+/// # Returns
+/// Paths of the orphaned files
+pub(crate) fn orphan_files(
+    path: &Path,
+    live: impl Fn(&TaskId) -> bool,
+    before: SystemTime,
+) -> Vec<PathBuf> {
+    let files = match fs::read_dir(path) {
+        Ok(files) => files,
+        Err(e) => {
+            error!("read dir error {}", e);
+            return vec![];
+        }
+    };
+    files
+        .filter_map(|entry| {
+            let entry = entry.ok()?;
+            let file_name = entry.file_name();
+            let file_name = file_name.to_str()?;
+            if file_name.ends_with(PARTIAL_SUFFIX) || file_name.starts_with(JOURNAL_NAME) {
+                return None;
+            }
+            let task_id = file_name
+                .strip_suffix(FINISH_SUFFIX)
+                .or_else(|| file_name.strip_suffix(VALIDATOR_SUFFIX));
+            if task_id.is_some_and(|task_id| live(&TaskId::new(task_id.to_string()))) {
+                return None;
+            }
+            let metadata = entry.metadata().ok()?;
+            if !metadata.is_file() || metadata.modified().ok()? >= before {
+                return None;
+            }
+            Some(entry.path())
+        })
+        .collect()
+}
+
+/// Removes the loads of file caches that are finished and whose bodies are
+/// no longer alive, loads still running are kept.
+fn sweep_file_loads(loads: &mut HashMap<TaskId, Arc<OnceLock<io::Result<Weak<RamCache>>>>>) {
+    loads.retain(|_, once| match once.get() {
+        None => true,
+        Some(res) => res.as_ref().is_ok_and(|weak| weak.strong_count() > 0),
+    });
 }
 
 impl CacheManager {
     /// Updates the file cache for a given task with data from RAM.
     ///
-    /// This method creates a new file cache from RAM cache data in a background task,
-    /// ensuring that the operation doesn't block the calling thread.
+    /// The write is queued on the file writer so the calling thread is not
+    /// blocked. Until it is written the data stays readable as a backup RAM
+    /// cache.
     ///
     /// # Parameters
     /// - `task_id`: ID of the task to update
     /// - `cache`: RAM cache containing the data to write to disk
-    pub(super) fn update_file_cache(&'static self, task_id: TaskId, cache: Arc<RamCache>) {
+    pub(crate) fn update_file_cache(&'static self, task_id: TaskId, cache: Arc<RamCache>) {
         // Remove any existing update operation for this task
         self.update_from_file_once.lock().unwrap().remove(&task_id);
-        
-        // Spawn background task to perform the file write
-        spawn(move || {
-            // Store backup of RAM cache
-            self.backup_rams
-                .lock()
-                .unwrap()
-                .insert(task_id.clone(), cache.clone());
-            
+
+        // Index the queued body so it is readable until written
+        self.backup_rams.insert(task_id.clone(), &cache);
+
+        if self.writer.push(task_id, cache) {
+            spawn(move || self.write_file_caches());
+        }
+    }
+
+    /// Writes queued file caches until the writer queue is drained.
+    fn write_file_caches(&'static self) {
+        while let Some((task_id, cache)) = self.writer.next() {
             // Remove any existing file cache
-            self.files.lock().unwrap().remove(&task_id);
-            
+            self.files.remove(&task_id);
+
             // Create new file cache
-            if let Some(file_cache) = FileCache::try_create(task_id.clone(), self, cache) {
+            if let Some(file_cache) = FileCache::try_create(task_id.clone(), self, cache.clone()) {
                 info!("{} file cache updated", task_id.brief());
-                self.files
-                    .lock()
-                    .unwrap()
-                    .insert(task_id.clone(), file_cache);
+                let entry = file_cache.journal_entry();
+                self.files.insert(task_id.clone(), file_cache);
+                // Recorded after the insert so a concurrent rewrite sees the
+                // entry or this record lands in the rewritten journal
+                self.journal.add(&entry);
+                if self.journal.needs_compaction(|| self.files.keys().len()) {
+                    self.compact_journal();
+                }
             };
-            
-            // Clean up backup
-            self.backup_rams.lock().unwrap().remove(&task_id);
+
+            // Clean up backup unless a newer body of the task is queued
+            self.backup_rams.remove_written(&task_id, &cache);
+            self.writer.done();
+        }
+        self.schedule_orphan_scan();
+        self.schedule_quota_check(false);
+    }
+
+    /// Removes orphaned files from the cache directory in the background, at
+    /// most once per `ORPHAN_SCAN_INTERVAL`.
+    ///
+    /// Files end up orphaned when the process dies between writing a file and
+    /// indexing it, or between dropping a cache and removing its file. They are
+    /// not counted against the file cache size, so they are removed here to keep
+    /// the disk use bounded.
+    pub(crate) fn schedule_orphan_scan(&'static self) {
+        let now = now_secs();
+        let last = self.orphan_scanned.load(Ordering::Relaxed);
+        if now.saturating_sub(last) < ORPHAN_SCAN_INTERVAL
+            || self
+                .orphan_scanned
+                .compare_exchange(last, now, Ordering::Relaxed, Ordering::Relaxed)
+                .is_err()
+        {
+            return;
+        }
+        spawn(move || self.remove_orphan_files());
+    }
+
+    /// Removes the files of the cache directory not in the cache index.
+    fn remove_orphan_files(&self) {
+        // SAFETY: This is a read-only operation to get the path
+        let Some(path) = (unsafe { FILE_STORE_DIR.as_path() }) else {
+            return;
+        };
+        let before = SystemTime::now() - ORPHAN_MIN_AGE;
+        let live = |task_id: &TaskId| {
+            self.files.contains_key(task_id) || self.backup_rams.contains_key(task_id)
+        };
+        let mut removed = 0;
+        for orphan in orphan_files(path, live, before) {
+            match fs::remove_file(&orphan) {
+                Ok(()) => removed += 1,
+                Err(e) => error!("remove orphaned cache file error {}", e),
+            }
+        }
+        info!("orphaned cache files removed {}", removed);
+    }
+
+    /// Completes the check of the file cache of a task read as `actual`.
+    ///
+    /// A file matching its CRC-32C is not checked again. A file that does not
+    /// is discarded with its journal record, unless it was rewritten since the
+    /// check started.
+    ///
+    /// # Returns
+    /// `true` if the file matched
+    pub(crate) fn finish_check(&self, task_id: &TaskId, check: PendingCheck, actual: u32) -> bool {
+        if actual == check.crc {
+            check.verified.store(true, Ordering::Release);
+            return true;
+        }
+        error!(
+            "{} file cache corrupted, crc {:08x} expected {:08x}",
+            task_id.brief(),
+            actual,
+            check.crc
+        );
+        let same = self
+            .files
+            .get(task_id, |file| Arc::ptr_eq(&file.verified, &check.verified));
+        if same == Some(true) {
+            self.files.remove(task_id);
+        }
+        false
+    }
+
+    /// Checks the file caches not yet verified against their CRC-32C, reading
+    /// at most `bytes_per_sec` bytes per second, 0 for no limit.
+    ///
+    /// The reads do not count as accesses of the caches, corrupted files are
+    /// discarded.
+    pub(crate) fn check_file_caches(&self, bytes_per_sec: u64) {
+        let pending = self.files.values(|file| {
+            file.pending_check()
+                .map(|check| (file.task_id.clone(), check))
         });
+        let start = Instant::now();
+        let mut read = 0u64;
+        let mut pace = |len: usize| {
+            read += len as u64;
+            if bytes_per_sec == 0 {
+                return;
+            }
+            let due = Duration::from_secs_f64(read as f64 / bytes_per_sec as f64);
+            if let Some(wait) = due.checked_sub(start.elapsed()) {
+                thread::sleep(wait);
+            }
+        };
+        let (mut checked, mut discarded) = (0, 0);
+        for (task_id, check) in pending.into_iter().flatten() {
+            let Some(path) = FileCache::path(&task_id) else {
+                break;
+            };
+            let actual = match file_crc(&path, &mut pace) {
+                Ok(actual) => actual,
+                Err(e) => {
+                    // The cache was removed since the pass started
+                    debug!("{} check file cache error {}", task_id.brief(), e);
+                    continue;
+                }
+            };
+            if self.finish_check(&task_id, check, actual) {
+                checked += 1;
+            } else {
+                discarded += 1;
+            }
+        }
+        info!(
+            "file caches checked {} discarded {}",
+            checked + discarded,
+            discarded
+        );
+    }
+
+    /// Rewrites the journal with only the live file caches.
+    pub(crate) fn compact_journal(&self) {
+        let res = self.journal.rewrite(|| {
+            let mut entries = self.files.values(FileCache::journal_entry);
+            entries.sort_by_key(|entry| entry.accessed);
+            entries
+        });
+        match res {
+            Ok(()) => info!("cache journal compacted"),
+            Err(e) => error!("compact cache journal failed {}", e),
+        }
     }
 
     /// Updates the RAM cache from the file cache for a given task.
@@ -736,17 +1135,16 @@ impl CacheManager {
         *retry = false;
         
         // Get or create a OnceLock for this task
-        let once = match self
-            .update_from_file_once
-            .lock()
-            .unwrap()
-            .entry(task_id.clone())
-        {
+        let mut loads = self.update_from_file_once.lock().unwrap();
+        if loads.len() >= MAX_FILE_LOADS {
+            sweep_file_loads(&mut loads);
+        }
+        let once = match loads.entry(task_id.clone()) {
             Entry::Occupied(entry) => entry.into_mut().clone(),
             Entry::Vacant(entry) => {
                 // Check if the cache is already in RAM
-                let res = self.rams.lock().unwrap().get(task_id).cloned();
-                let res = res.or_else(|| self.backup_rams.lock().unwrap().get(task_id).cloned());
+                let res = self.rams.get(task_id, Arc::clone);
+                let res = res.or_else(|| self.backup_rams.get(task_id));
                 if res.is_some() {
                     return res;
                 } else {
@@ -755,6 +1153,7 @@ impl CacheManager {
                 }
             }
         };
+        drop(loads);
 
         // Storage for the result
         let mut ret = None;
@@ -764,13 +1163,13 @@ impl CacheManager {
             debug!("{} ram updated from file", task_id.brief());
             
             // Open the file
-            let mut file = self
+            let (mut file, validators, check) = self
                 .files
-                .lock()
-                .unwrap()
-                .get(task_id)
+                .get(task_id, |file| -> io::Result<_> {
+                    let opened = file.open()?;
+                    Ok((opened, file.validators().clone(), file.pending_check()))
+                })
                 .ok_or(io::Error::new(io::ErrorKind::NotFound, "not found"))?
-                .open()
                 .map_err(|e| {
                     error!(
                         "task {:?} update ram open file fail {:?}",
@@ -794,8 +1193,24 @@ impl CacheManager {
                 e
             })?;
 
+            // Served bodies are checked once against the CRC-32C of the file
+            if let Some(check) = check {
+                let mut crc = Crc32c::new();
+                cache.chunks().for_each(|chunk| crc.update(chunk));
+                if !self.finish_check(task_id, check, crc.finish()) {
+                    return Err(io::Error::new(
+                        io::ErrorKind::InvalidData,
+                        "file cache corrupted",
+                    ));
+                }
+            }
+
+            if !validators.is_empty() {
+                cache.set_validators(validators);
+            }
+
             // Check if the cache size is valid
-            let is_cache = cache.check_size();
+            let is_cache = cache.admit();
             let cache = Arc::new(cache);
 
             // Update the RAM cache if valid
@@ -813,6 +1228,17 @@ impl CacheManager {
         if ret.is_some() {
             return ret;
         }
+        // A failed load is not kept, the next fetch tries again
+        if res.is_err() {
+            let mut loads = self.update_from_file_once.lock().unwrap();
+            if loads
+                .get(task_id)
+                .is_some_and(|kept| Arc::ptr_eq(kept, &once))
+            {
+                loads.remove(task_id);
+            }
+            return None;
+        }
         
         // Try to upgrade the weak reference
         res.as_ref().ok().and_then(|weak| {
@@ -822,6 +1248,24 @@ impl CacheManager {
     }
 }
 
+/// Returns the CRC-32C of the file at `path`, calling `pace` after each
+/// block read.
+fn file_crc(path: &Path, pace: &mut impl FnMut(usize)) -> Result<u32, io::Error> {
+    let mut file = File::open(path)?;
+    let mut crc = Crc32c::new();
+    let mut block = vec![0; CHECK_BLOCK];
+    loop {
+        let len = match file.read(&mut block) {
+            Ok(0) => break Ok(crc.finish()),
+            Ok(len) => len,
+            Err(e) if e.kind() == io::ErrorKind::Interrupted => continue,
+            Err(e) => break Err(e),
+        };
+        crc.update(&block[..len]);
+        pace(len);
+    }
+}
+
 #[cfg(test)]
 mod ut_file {
     // Include unit tests
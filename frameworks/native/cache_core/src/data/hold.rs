@@ -0,0 +1,163 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Hold times of the cache locks, for contention benchmarks.
+//!
+//! Only built with the `lock_stats` feature. Every shard lock of the caches
+//! and every apply on a byte budget is then timed from acquisition to
+//! release, into a histogram with power-of-two buckets.
+
+use std::ops::{Deref, DerefMut};
+use std::sync::atomic::{AtomicU64, Ordering};
+use std::time::Instant;
+
+/// Buckets of the histogram, the last one counts holds of 2^30 ns and more.
+const BUCKETS: usize = 32;
+
+/// Hold times of one lock, or of all the shard locks of one cache.
+pub(crate) struct LockHolds {
+    /// Holds whose time in nanoseconds has its highest bit at the index
+    buckets: [AtomicU64; BUCKETS],
+    /// Sum of the hold times in nanoseconds
+    total_ns: AtomicU64,
+    /// Longest hold time in nanoseconds
+    max_ns: AtomicU64,
+}
+
+/// Summary of the hold times of a lock since it was last reset.
+#[derive(Clone, Copy, Debug, Default, PartialEq)]
+pub struct LockHoldStats {
+    /// Number of holds
+    pub count: u64,
+    /// Mean hold time in nanoseconds
+    pub mean_ns: f64,
+    /// Upper bound of the bucket holding the median, in nanoseconds
+    pub p50_ns: u64,
+    /// Upper bound of the bucket holding the 99th percentile, in nanoseconds
+    pub p99_ns: u64,
+    /// Longest hold time in nanoseconds
+    pub max_ns: u64,
+}
+
+/// Hold times of the locks of a `CacheManager`.
+#[derive(Clone, Copy, Debug, Default, PartialEq)]
+pub struct CacheLockStats {
+    /// Shard locks of the RAM cache
+    pub rams: LockHoldStats,
+    /// Shard locks of the file cache
+    pub files: LockHoldStats,
+    /// Applies on the RAM cache budget, retries of the update included
+    pub ram_handle: LockHoldStats,
+}
+
+impl LockHolds {
+    pub(crate) fn new() -> Self {
+        Self {
+            buckets: std::array::from_fn(|_| AtomicU64::new(0)),
+            total_ns: AtomicU64::new(0),
+            max_ns: AtomicU64::new(0),
+        }
+    }
+
+    /// Counts a hold of `ns` nanoseconds.
+    pub(crate) fn record(&self, ns: u64) {
+        let bucket = (u64::BITS - ns.leading_zeros()) as usize;
+        self.buckets[bucket.min(BUCKETS - 1)].fetch_add(1, Ordering::Relaxed);
+        self.total_ns.fetch_add(ns, Ordering::Relaxed);
+        self.max_ns.fetch_max(ns, Ordering::Relaxed);
+    }
+
+    /// Forgets the holds counted so far.
+    pub(crate) fn reset(&self) {
+        for bucket in self.buckets.iter() {
+            bucket.store(0, Ordering::Relaxed);
+        }
+        self.total_ns.store(0, Ordering::Relaxed);
+        self.max_ns.store(0, Ordering::Relaxed);
+    }
+
+    pub(crate) fn stats(&self) -> LockHoldStats {
+        let counts = self
+            .buckets
+            .iter()
+            .map(|bucket| bucket.load(Ordering::Relaxed))
+            .collect::<Vec<_>>();
+        let count = counts.iter().sum::<u64>();
+        if count == 0 {
+            return LockHoldStats::default();
+        }
+        let max_ns = self.max_ns.load(Ordering::Relaxed);
+        let percentile = |percent: u64| {
+            let rank = (count * percent).div_ceil(100);
+            let mut seen = 0;
+            for (i, n) in counts.iter().enumerate() {
+                seen += n;
+                if seen >= rank {
+                    return ((1u64 << i) - 1).min(max_ns);
+                }
+            }
+            max_ns
+        };
+        LockHoldStats {
+            count,
+            mean_ns: self.total_ns.load(Ordering::Relaxed) as f64 / count as f64,
+            p50_ns: percentile(50),
+            p99_ns: percentile(99),
+            max_ns,
+        }
+    }
+}
+
+/// Guard of a lock timed into `LockHolds` until it is dropped.
+pub(crate) struct Held<'a, G> {
+    guard: G,
+    holds: &'a LockHolds,
+    since: Instant,
+}
+
+impl<'a, G> Held<'a, G> {
+    /// Times `guard`, which was just acquired.
+    pub(crate) fn new(guard: G, holds: &'a LockHolds) -> Self {
+        Self {
+            guard,
+            holds,
+            since: Instant::now(),
+        }
+    }
+}
+
+impl<G: Deref> Deref for Held<'_, G> {
+    type Target = G::Target;
+
+    fn deref(&self) -> &Self::Target {
+        &self.guard
+    }
+}
+
+impl<G: DerefMut> DerefMut for Held<'_, G> {
+    fn deref_mut(&mut self) -> &mut Self::Target {
+        &mut self.guard
+    }
+}
+
+impl<G> Drop for Held<'_, G> {
+    fn drop(&mut self) {
+        self.holds.record(self.since.elapsed().as_nanos() as u64);
+    }
+}
+
+#[cfg(test)]
+mod ut_hold {
+    // Include test module containing unit tests for LockHolds
+    include!("../../tests/ut/data/ut_hold.rs");
+}
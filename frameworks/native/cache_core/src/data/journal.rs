@@ -0,0 +1,306 @@
+// Copyright (C) 2024 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Index of the file caches kept in an append-only journal.
+//!
+//! Creating, reading and dropping a file cache appends a record to the
+//! journal, so startup restores the file caches with one sequential read
+//! instead of listing the directory and reading the metadata of every file.
+//! The journal is rewritten with only the live entries at startup and when it
+//! grows much larger than the cache.
+//!
+//! Every line holds the checksum of its record and the record, with fields
+//! separated by tabs:
+//! - `A <task id> <size> <last access> <etag> <last modified> <crc>` adds a
+//!   cache, the CRC-32C of its file in hex is empty if unknown and missing
+//!   in older journals
+//! - `T <task id> <last access>` records a read
+//! - `R <task id>` removes a cache
+//!
+//! A missing journal or a line with a wrong checksum makes startup fall back
+//! to scanning the directory.
+
+use std::collections::HashMap;
+use std::fs::{self, OpenOptions};
+use std::io::{self, Write};
+use std::path::PathBuf;
+use std::sync::atomic::{AtomicUsize, Ordering};
+use std::sync::Mutex;
+use std::time::{SystemTime, UNIX_EPOCH};
+
+use request_utils::task_id::TaskId;
+
+use super::file::FILE_STORE_DIR;
+use super::Validators;
+
+/// Name of the journal in the cache directory.
+pub(crate) const JOURNAL_NAME: &str = "cache_index";
+
+/// Suffix of the journal while it is rewritten.
+pub(crate) const JOURNAL_TEMP_SUFFIX: &str = "_T";
+
+/// Appended records tolerated before the journal is compacted.
+const COMPACT_MIN_RECORDS: usize = 1024;
+
+/// The journal is compacted once it holds this many records per live entry.
+const COMPACT_FACTOR: usize = 4;
+
+/// A file cache as recorded in the journal.
+#[derive(Clone, PartialEq, Eq)]
+pub(crate) struct JournalEntry {
+    /// Task the file cache belongs to
+    pub(crate) task_id: TaskId,
+    /// Size of the cache file in bytes
+    pub(crate) size: u64,
+    /// Last access in seconds since the Unix epoch
+    pub(crate) accessed: u64,
+    /// Validators of the cached response
+    pub(crate) validators: Validators,
+    /// CRC-32C of the cache file, if known
+    pub(crate) crc: Option<u32>,
+}
+
+/// Append-only journal of the file caches.
+pub(crate) struct Journal {
+    /// File name in the cache directory
+    name: String,
+    /// Serializes adds, removals and rewrites
+    lock: Mutex<()>,
+    /// Records in the journal file
+    records: AtomicUsize,
+}
+
+impl Journal {
+    /// Creates the journal of the cache directory.
+    pub(crate) fn new() -> Self {
+        Self::with_name(JOURNAL_NAME)
+    }
+
+    fn with_name(name: &str) -> Self {
+        Self {
+            name: name.to_string(),
+            lock: Mutex::new(()),
+            records: AtomicUsize::new(0),
+        }
+    }
+
+    /// Reads the file caches recorded in the journal.
+    ///
+    /// # Returns
+    /// The recorded entries, least recently accessed first, or an error if the
+    /// journal is missing or corrupted
+    pub(crate) fn load(&self) -> io::Result<Vec<JournalEntry>> {
+        let content = {
+            let _guard = self.lock.lock().unwrap();
+            fs::read_to_string(self.path("")?)?
+        };
+        // Entries with the line of their latest add or read
+        let mut entries = HashMap::new();
+        let mut lines = 0;
+        for (n, line) in content.lines().enumerate() {
+            let record = line
+                .split_once('\t')
+                .filter(|(sum, record)| {
+                    u64::from_str_radix(sum, 16).ok() == Some(checksum(record))
+                })
+                .and_then(|(_, record)| parse(record, n, &mut entries));
+            if record.is_none() {
+                return Err(io::Error::new(
+                    io::ErrorKind::InvalidData,
+                    format!("journal line {} corrupted", n + 1),
+                ));
+            }
+            lines += 1;
+        }
+        self.records.store(lines, Ordering::Release);
+
+        let mut entries = entries.into_values().collect::<Vec<_>>();
+        entries.sort_by_key(|(n, _)| *n);
+        Ok(entries.into_iter().map(|(_, entry)| entry).collect())
+    }
+
+    /// Replaces the journal with the given entries, in order.
+    ///
+    /// `f` is called while adds and removals wait, so the entries it returns
+    /// cannot miss one of them.
+    pub(crate) fn rewrite(&self, f: impl FnOnce() -> Vec<JournalEntry>) -> io::Result<()> {
+        let _guard = self.lock.lock().unwrap();
+        let entries = f();
+        let temp = self.path(JOURNAL_TEMP_SUFFIX)?;
+        let mut file = OpenOptions::new()
+            .write(true)
+            .create(true)
+            .truncate(true)
+            .open(temp.as_path())?;
+        let mut content = String::new();
+        for entry in entries.iter() {
+            content.push_str(&line(&add_record(entry)));
+        }
+        file.write_all(content.as_bytes())?;
+        file.flush()?;
+        fs::rename(temp, self.path("")?)?;
+        self.records.store(entries.len(), Ordering::Release);
+        Ok(())
+    }
+
+    /// Records a new file cache.
+    pub(crate) fn add(&self, entry: &JournalEntry) {
+        let _guard = self.lock.lock().unwrap();
+        self.append(&add_record(entry));
+    }
+
+    /// Records a read of a file cache.
+    ///
+    /// Reads happen under the cache shard locks and do not wait for a
+    /// rewrite, a read recorded during one may be lost.
+    pub(crate) fn touch(&self, task_id: &TaskId, accessed: u64) {
+        self.append(&format!("T\t{}\t{}", task_id, accessed));
+    }
+
+    /// Records the removal of a file cache.
+    pub(crate) fn remove(&self, task_id: &TaskId) {
+        let _guard = self.lock.lock().unwrap();
+        self.append(&format!("R\t{}", task_id));
+    }
+
+    /// Returns `true` if the journal should be rewritten.
+    ///
+    /// # Parameters
+    /// - `live`: Returns the number of live file caches
+    pub(crate) fn needs_compaction(&self, live: impl FnOnce() -> usize) -> bool {
+        let records = self.records.load(Ordering::Acquire);
+        records > COMPACT_MIN_RECORDS && records > live().saturating_mul(COMPACT_FACTOR)
+    }
+
+    fn append(&self, record: &str) {
+        let res = self.path("").and_then(|path| {
+            let mut file = OpenOptions::new().append(true).create(true).open(path)?;
+            // A single write keeps concurrent lines apart
+            file.write_all(line(record).as_bytes())
+        });
+        match res {
+            Ok(()) => {
+                self.records.fetch_add(1, Ordering::AcqRel);
+            }
+            Err(e) => error!("append cache journal failed {}", e),
+        }
+    }
+
+    fn path(&self, suffix: &str) -> io::Result<PathBuf> {
+        // SAFETY: This is a read-only operation that joins a path
+        unsafe { FILE_STORE_DIR.join(self.name.clone() + suffix) }.ok_or(io::Error::new(
+            io::ErrorKind::NotFound,
+            "cache store dir not created.",
+        ))
+    }
+}
+
+/// Returns the current time in seconds since the Unix epoch.
+pub(crate) fn now_secs() -> u64 {
+    secs(SystemTime::now())
+}
+
+/// Returns a time in seconds since the Unix epoch, 0 for earlier times.
+pub(crate) fn secs(time: SystemTime) -> u64 {
+    time.duration_since(UNIX_EPOCH)
+        .map(|d| d.as_secs())
+        .unwrap_or(0)
+}
+
+fn add_record(entry: &JournalEntry) -> String {
+    // Tabs and line breaks would split the record, such values are dropped
+    let value = |v: &Option<String>| {
+        v.as_deref()
+            .filter(|v| !v.contains(['\t', '\n', '\r']))
+            .unwrap_or_default()
+            .to_string()
+    };
+    let crc = entry.crc.map(|crc| format!("{:08x}", crc));
+    format!(
+        "A\t{}\t{}\t{}\t{}\t{}\t{}",
+        entry.task_id,
+        entry.size,
+        entry.accessed,
+        value(&entry.validators.etag),
+        value(&entry.validators.last_modified),
+        crc.unwrap_or_default(),
+    )
+}
+
+fn line(record: &str) -> String {
+    format!("{:016x}\t{}\n", checksum(record), record)
+}
+
+/// Applies a record to `entries`.
+///
+/// # Returns
+/// `None` if the record is malformed
+fn parse(
+    record: &str,
+    n: usize,
+    entries: &mut HashMap<TaskId, (usize, JournalEntry)>,
+) -> Option<()> {
+    let mut fields = record.split('\t');
+    let kind = fields.next()?;
+    let task_id = TaskId::new(fields.next()?.to_string());
+    match kind {
+        "A" => {
+            let size = fields.next()?.parse().ok()?;
+            let accessed = fields.next()?.parse().ok()?;
+            let value = |v: &str| (!v.is_empty()).then(|| v.to_string());
+            let validators = Validators {
+                etag: value(fields.next()?),
+                last_modified: value(fields.next()?),
+            };
+            let crc = match fields.next() {
+                None | Some("") => None,
+                Some(crc) => Some(u32::from_str_radix(crc, 16).ok()?),
+            };
+            let entry = JournalEntry {
+                task_id: task_id.clone(),
+                size,
+                accessed,
+                validators,
+                crc,
+            };
+            entries.insert(task_id, (n, entry));
+        }
+        "T" => {
+            let accessed = fields.next()?.parse().ok()?;
+            if let Some((line, entry)) = entries.get_mut(&task_id) {
+                *line = n;
+                entry.accessed = accessed;
+            }
+        }
+        "R" => {
+            entries.remove(&task_id);
+        }
+        _ => return None,
+    }
+    fields.next().is_none().then_some(())
+}
+
+/// 64-bit FNV-1a hash of a record.
+fn checksum(record: &str) -> u64 {
+    const OFFSET: u64 = 0xcbf2_9ce4_8422_2325;
+    const PRIME: u64 = 0x0000_0100_0000_01b3;
+    record
+        .bytes()
+        .fold(OFFSET, |hash, b| (hash ^ b as u64).wrapping_mul(PRIME))
+}
+
+#[cfg(test)]
+mod ut_journal {
+    // Include test module containing unit tests for Journal
+    include!("../../tests/ut/data/ut_journal.rs");
+}
@@ -0,0 +1,190 @@
+// Copyright (C) 2024 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Read-only memory mappings of cache files.
+//!
+//! Large file cache entries are served straight from a private mapping instead
+//! of being copied into a `RamCache`, so they neither allocate heap memory nor
+//! churn the RAM budget. The mapping stays valid after the cache file is
+//! removed, it is only unmapped once the last `MappedCache` handle is dropped.
+
+use std::ffi::{c_int, c_long, c_void};
+use std::fs::File;
+use std::io;
+use std::os::fd::AsRawFd;
+use std::sync::Arc;
+
+use super::{RamCache, RamRange};
+
+/// Cache files smaller than this are still loaded into RAM.
+pub(crate) const MMAP_MIN_SIZE: u64 = 64 * 1024;
+
+const PROT_READ: i32 = 0x1;
+const MAP_PRIVATE: i32 = 0x02;
+const MAP_FAILED: *mut c_void = !0 as *mut c_void;
+const SC_PAGESIZE: c_int = 30;
+
+extern "C" {
+    fn mmap(addr: *mut c_void, len: usize, prot: i32, flags: i32, fd: i32, off: i64)
+        -> *mut c_void;
+    fn munmap(addr: *mut c_void, len: usize) -> i32;
+    fn sysconf(name: c_int) -> c_long;
+}
+
+/// Returns the size of a memory page, mappings start at a multiple of it.
+fn page_size() -> u64 {
+    // SAFETY: `sysconf` only reads a system constant.
+    match unsafe { sysconf(SC_PAGESIZE) } {
+        size if size > 0 => size as u64,
+        _ => 4096,
+    }
+}
+
+/// A read-only private mapping of a cache file, or of a window of it.
+pub struct MappedCache {
+    /// Start of the mapping
+    ptr: *mut c_void,
+    /// Bytes mapped before the data, a window starts inside its first page
+    skip: usize,
+    /// Length of the data in bytes
+    len: usize,
+}
+
+// SAFETY: The mapping is read-only and never remapped, it can be shared and
+// unmapped from any thread.
+unsafe impl Send for MappedCache {}
+unsafe impl Sync for MappedCache {}
+
+impl MappedCache {
+    /// Maps the first `len` bytes of `file`.
+    ///
+    /// # Returns
+    /// The mapping on success, or the error reported by `mmap`
+    pub(crate) fn map(file: &File, len: usize) -> io::Result<Self> {
+        Self::map_range(file, 0, len)
+    }
+
+    /// Maps `len` bytes of `file` from `offset`.
+    ///
+    /// The mapping starts at the page holding `offset`, the bytes before
+    /// `offset` in that page are mapped but not handed out.
+    ///
+    /// # Returns
+    /// The mapping on success, or the error reported by `mmap`
+    pub(crate) fn map_range(file: &File, offset: u64, len: usize) -> io::Result<Self> {
+        let skip = offset % page_size();
+        // SAFETY: A fresh private read-only mapping of an open file at a page
+        // aligned offset, the kernel picks the address.
+        let ptr = unsafe {
+            mmap(
+                std::ptr::null_mut(),
+                skip as usize + len,
+                PROT_READ,
+                MAP_PRIVATE,
+                file.as_raw_fd(),
+                (offset - skip) as i64,
+            )
+        };
+        if ptr == MAP_FAILED {
+            return Err(io::Error::last_os_error());
+        }
+        Ok(Self {
+            ptr,
+            skip: skip as usize,
+            len,
+        })
+    }
+
+    /// Returns the size of the mapped data.
+    pub fn size(&self) -> usize {
+        self.len
+    }
+
+    /// Returns the mapped data.
+    pub fn bytes(&self) -> &[u8] {
+        // SAFETY: `ptr` points to `skip + len` readable bytes until `self`
+        // is dropped.
+        unsafe { std::slice::from_raw_parts((self.ptr as *const u8).add(self.skip), self.len) }
+    }
+}
+
+impl Drop for MappedCache {
+    fn drop(&mut self) {
+        // SAFETY: `ptr` and `skip + len` describe a mapping created by
+        // `map_range`.
+        if unsafe { munmap(self.ptr, self.skip + self.len) } != 0 {
+            error!("munmap cache failed {}", io::Error::last_os_error());
+        }
+    }
+}
+
+/// Cached content handed out by `CacheManager::fetch_data`, or a window of
+/// it handed out by `CacheManager::fetch_range`.
+pub enum CacheData {
+    /// Content held in a RAM cache
+    Ram(Arc<RamCache>),
+    /// Content mapped from a file cache
+    Mapped(MappedCache),
+    /// Window of content held in a RAM cache
+    RamRange(RamRange),
+    /// Window read from a file cache
+    Read(Vec<u8>),
+}
+
+impl CacheData {
+    /// Returns the size of the content.
+    pub fn size(&self) -> usize {
+        match self {
+            CacheData::Ram(cache) => cache.size(),
+            CacheData::Mapped(mapped) => mapped.size(),
+            CacheData::RamRange(range) => range.size(),
+            CacheData::Read(bytes) => bytes.len(),
+        }
+    }
+
+    /// Returns the content bytes, valid as long as `self`.
+    pub fn bytes(&self) -> &[u8] {
+        match self {
+            CacheData::Ram(cache) => cache.bytes(),
+            CacheData::Mapped(mapped) => mapped.bytes(),
+            CacheData::RamRange(range) => range.bytes(),
+            CacheData::Read(bytes) => bytes,
+        }
+    }
+
+    /// Returns the number of non-empty chunks holding the content, a mapping
+    /// or a read window is a single chunk.
+    pub fn chunk_count(&self) -> usize {
+        match self {
+            CacheData::Ram(cache) => cache.chunks().count(),
+            CacheData::RamRange(range) => range.chunks().count(),
+            CacheData::Mapped(_) | CacheData::Read(_) => (self.size() != 0) as usize,
+        }
+    }
+
+    /// Returns the chunk at `index`, or an empty slice if it is out of range.
+    pub fn chunk(&self, index: usize) -> &[u8] {
+        match self {
+            CacheData::Ram(cache) => cache.chunks().nth(index).unwrap_or(&[]),
+            CacheData::RamRange(range) => range.chunks().nth(index).unwrap_or(&[]),
+            CacheData::Mapped(_) | CacheData::Read(_) if index == 0 => self.bytes(),
+            CacheData::Mapped(_) | CacheData::Read(_) => &[],
+        }
+    }
+}
+
+#[cfg(test)]
+mod ut_mmap {
+    // Include test module containing unit tests for MappedCache
+    include!("../../tests/ut/data/ut_mmap.rs");
+}
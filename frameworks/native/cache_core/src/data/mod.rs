@@ -11,18 +11,46 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+mod backup;
+mod chunk;
 mod file;
+#[cfg(feature = "lock_stats")]
+mod hold;
+mod journal;
+mod mmap;
+mod partial;
+mod quota;
 mod ram;
+mod range;
+mod shard;
+mod sketch;
 mod space;
+mod validator;
+mod writer;
 
 pub mod observer;
 
+pub(crate) use backup::BackupRams;
 pub use file::{
     get_curr_store_dir, init_curr_store_dir, init_history_store_dir, is_history_init, FileStoreDir,
     HistoryDir,
 };
 pub(crate) use file::{restore_files, FileCache};
+#[cfg(feature = "lock_stats")]
+pub use hold::{CacheLockStats, LockHoldStats};
+pub(crate) use journal::Journal;
+pub(crate) use mmap::MMAP_MIN_SIZE;
+pub use mmap::{CacheData, MappedCache};
+pub use partial::PartialCache;
+pub(crate) use partial::{PARTIAL_MIN_SIZE, PARTIAL_SUFFIX};
+pub(crate) use quota::FileQuota;
 pub use ram::RamCache;
+pub use range::RamRange;
+pub use shard::{CacheStats, RamCachePolicy};
+pub(crate) use shard::{ShardedLru, Weight, DEFAULT_COST};
 pub(crate) use space::ResourceManager;
+pub use validator::Validators;
+pub(crate) use validator::VALIDATOR_SUFFIX;
+pub(crate) use writer::FileWriter;
 
 pub(crate) const MAX_CACHE_SIZE: u64 = 20971520;
@@ -0,0 +1,219 @@
+// Copyright (C) 2024 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Partial bodies of interrupted downloads.
+//!
+//! When a download fails or is cancelled after receiving part of a body that
+//! carries a validator (`ETag` or `Last-Modified`), the received prefix is
+//! kept next to the file caches. A later download of the same URL only asks
+//! for the missing range and continues from the stored prefix if the server
+//! still serves the same representation.
+//!
+//! A partial file starts with the validator length as a little-endian `u16`,
+//! followed by the validator and the body prefix.
+
+use std::collections::HashSet;
+use std::fs::{self, File, OpenOptions};
+use std::io::{self, Read, Seek, SeekFrom, Write};
+use std::path::PathBuf;
+
+use request_utils::task_id::TaskId;
+
+use super::file::FILE_STORE_DIR;
+use super::RamCache;
+
+/// Suffix of files holding a partial body.
+pub(crate) const PARTIAL_SUFFIX: &str = "_P";
+
+/// Suffix of partial files that are still being written.
+const TEMP_SUFFIX: &str = "_PT";
+
+/// Smaller prefixes are not worth a resume request and are dropped.
+pub(crate) const PARTIAL_MIN_SIZE: usize = 64 * 1024;
+
+/// Longest validator that is stored.
+const MAX_VALIDATOR_LEN: usize = 1024;
+
+/// Body prefix of an interrupted download stored on disk.
+pub struct PartialCache {
+    /// Task the prefix belongs to
+    task_id: TaskId,
+    /// `ETag` or `Last-Modified` value of the response, sent as `If-Range`
+    validator: String,
+    /// Position of the body in the file
+    offset: u64,
+    /// Size of the stored prefix in bytes
+    size: u64,
+}
+
+impl PartialCache {
+    /// Opens the partial body stored for a task.
+    ///
+    /// Unreadable or empty partial files are removed.
+    ///
+    /// # Returns
+    /// The partial body if one is stored, `None` otherwise
+    pub fn open(task_id: &TaskId) -> Option<Self> {
+        let mut file = File::open(Self::path(task_id, PARTIAL_SUFFIX)?).ok()?;
+        match Self::read_header(task_id, &mut file) {
+            Ok(partial) if partial.size != 0 => Some(partial),
+            Ok(_) => {
+                Self::remove(task_id);
+                None
+            }
+            Err(e) => {
+                error!("{} partial file invalid {}", task_id.brief(), e);
+                Self::remove(task_id);
+                None
+            }
+        }
+    }
+
+    /// Returns the size of the stored prefix in bytes.
+    pub fn size(&self) -> u64 {
+        self.size
+    }
+
+    /// Returns the validator of the response the prefix was received from.
+    pub fn validator(&self) -> &str {
+        &self.validator
+    }
+
+    /// Writes the data of `cache` as the partial body of a task, replacing any
+    /// earlier one.
+    ///
+    /// # Parameters
+    /// - `task_id`: Task the data belongs to
+    /// - `cache`: Body prefix received so far
+    /// - `validator`: `ETag` or `Last-Modified` value of the response
+    pub(crate) fn save(task_id: &TaskId, cache: &RamCache, validator: &str) -> io::Result<()> {
+        if validator.len() > MAX_VALIDATOR_LEN {
+            return Err(io::Error::new(
+                io::ErrorKind::InvalidInput,
+                "validator too long",
+            ));
+        }
+        let (Some(temp), Some(path)) = (
+            Self::path(task_id, TEMP_SUFFIX),
+            Self::path(task_id, PARTIAL_SUFFIX),
+        ) else {
+            return Err(io::Error::new(
+                io::ErrorKind::NotFound,
+                "cache store dir not created.",
+            ));
+        };
+
+        let mut file = OpenOptions::new()
+            .write(true)
+            .create(true)
+            .truncate(true)
+            .open(temp.as_path())?;
+        file.write_all(&(validator.len() as u16).to_le_bytes())?;
+        file.write_all(validator.as_bytes())?;
+        for chunk in cache.chunks() {
+            file.write_all(chunk)?;
+        }
+        file.flush()?;
+        fs::rename(temp, path)
+    }
+
+    /// Appends the stored prefix to `cache`.
+    pub(crate) fn load(&self, cache: &mut RamCache) -> io::Result<()> {
+        let path = Self::path(&self.task_id, PARTIAL_SUFFIX).ok_or(io::Error::new(
+            io::ErrorKind::NotFound,
+            "cache store dir not created.",
+        ))?;
+        let mut file = File::open(path)?;
+        file.seek(SeekFrom::Start(self.offset))?;
+        let copied = io::copy(&mut file.take(self.size), cache)?;
+        if copied != self.size {
+            return Err(io::Error::new(
+                io::ErrorKind::UnexpectedEof,
+                format!("partial file truncated {}/{}", copied, self.size),
+            ));
+        }
+        Ok(())
+    }
+
+    /// Removes the partial body stored for a task, if any.
+    pub fn remove(task_id: &TaskId) {
+        let Some(path) = Self::path(task_id, PARTIAL_SUFFIX) else {
+            return;
+        };
+        match fs::remove_file(path) {
+            Ok(()) => info!("{} partial file removed", task_id.brief()),
+            Err(e) if e.kind() == io::ErrorKind::NotFound => {}
+            Err(e) => error!("{} remove partial file failed {}", task_id.brief(), e),
+        }
+    }
+
+    /// Removes the partial bodies of all tasks not in `keep`.
+    pub(crate) fn remove_all(keep: &HashSet<TaskId>) {
+        // SAFETY: This is a read-only operation to get the path
+        let Some(dir) = (unsafe { FILE_STORE_DIR.as_path() }) else {
+            return;
+        };
+        let Ok(entries) = fs::read_dir(dir) else {
+            return;
+        };
+        for entry in entries.flatten() {
+            let file_name = entry.file_name();
+            let Some(task_id) = file_name
+                .to_str()
+                .and_then(|name| name.strip_suffix(PARTIAL_SUFFIX))
+            else {
+                continue;
+            };
+            let task_id = TaskId::new(task_id.to_string());
+            if !keep.contains(&task_id) {
+                Self::remove(&task_id);
+            }
+        }
+    }
+
+    fn read_header(task_id: &TaskId, file: &mut File) -> io::Result<Self> {
+        let mut len = [0u8; 2];
+        file.read_exact(&mut len)?;
+        let len = u16::from_le_bytes(len) as usize;
+        if len == 0 || len > MAX_VALIDATOR_LEN {
+            return Err(io::Error::new(
+                io::ErrorKind::InvalidData,
+                format!("validator length {}", len),
+            ));
+        }
+        let mut validator = vec![0u8; len];
+        file.read_exact(&mut validator)?;
+        let validator = String::from_utf8(validator)
+            .map_err(|e| io::Error::new(io::ErrorKind::InvalidData, e))?;
+
+        let offset = (len + 2) as u64;
+        let size = file.metadata()?.len().saturating_sub(offset);
+        Ok(Self {
+            task_id: task_id.clone(),
+            validator,
+            offset,
+            size,
+        })
+    }
+
+    fn path(task_id: &TaskId, suffix: &str) -> Option<PathBuf> {
+        // SAFETY: This is a read-only operation that joins a path
+        unsafe { FILE_STORE_DIR.join(task_id.to_string() + suffix) }
+    }
+}
+
+#[cfg(test)]
+mod ut_partial {
+    // Include test module containing unit tests for PartialCache
+    include!("../../tests/ut/data/ut_partial.rs");
+}
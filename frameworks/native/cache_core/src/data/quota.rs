@@ -0,0 +1,204 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Sizing of the file cache to the free space of its disk.
+//!
+//! With an adaptive size the file cache may take a share of the space it
+//! could use, the free space of the disk plus the bytes it already holds,
+//! within fixed bounds. The size is evaluated again after file cache writes
+//! at most once per `QUOTA_INTERVAL`, and right away once a write runs out
+//! of space, so the cache shrinks as the disk fills up instead of failing
+//! its writes. Entries over a smaller size are evicted in the background.
+
+use std::ffi::{c_char, c_int, c_ulong, CString};
+use std::io;
+use std::os::unix::ffi::OsStrExt;
+use std::path::Path;
+use std::sync::atomic::{AtomicU64, Ordering};
+use std::sync::Mutex;
+
+use super::file::FILE_STORE_DIR;
+use super::journal::now_secs;
+use crate::manage::CacheManager;
+use crate::spawn;
+
+/// Minimum time in seconds between two evaluations of the adaptive size.
+pub(crate) const QUOTA_INTERVAL: u64 = 5 * 60;
+
+/// `ENOSPC`, reported by writes to a full disk.
+const ENOSPC: i32 = 28;
+
+/// `struct statvfs` of musl and of 64-bit glibc. Only the leading fields
+/// are read, the others are left room for.
+#[allow(dead_code)]
+#[repr(C)]
+struct StatVfs {
+    f_bsize: c_ulong,
+    f_frsize: c_ulong,
+    f_blocks: u64,
+    f_bfree: u64,
+    f_bavail: u64,
+    rest: [u64; 16],
+}
+
+extern "C" {
+    fn statvfs(path: *const c_char, buf: *mut StatVfs) -> c_int;
+}
+
+/// Returns the bytes of the disk holding `path` available to the process.
+pub(crate) fn free_space(path: &Path) -> io::Result<u64> {
+    let path = CString::new(path.as_os_str().as_bytes())
+        .map_err(|e| io::Error::new(io::ErrorKind::InvalidInput, e))?;
+    // SAFETY: `StatVfs` is plain data larger than the struct filled in.
+    let mut stat = unsafe { std::mem::zeroed::<StatVfs>() };
+    // SAFETY: A valid C string and a buffer large enough for the result.
+    if unsafe { statvfs(path.as_ptr(), &mut stat) } != 0 {
+        return Err(io::Error::last_os_error());
+    }
+    Ok(stat.f_bavail.saturating_mul(stat.f_frsize as u64))
+}
+
+/// Bounds of an adaptive file cache size.
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub(crate) struct AdaptiveSize {
+    /// Percent of the usable space taken
+    percent: u64,
+    /// Smallest size in bytes
+    min: u64,
+    /// Largest size in bytes
+    max: u64,
+}
+
+impl AdaptiveSize {
+    /// Creates bounds, a `max` below `min` is raised to it.
+    pub(crate) fn new(percent: u8, min: u64, max: u64) -> Self {
+        Self {
+            percent: u64::from(percent.min(100)),
+            min,
+            max: max.max(min),
+        }
+    }
+
+    /// Returns the size of a file cache holding `used` bytes on a disk with
+    /// `free` bytes available.
+    pub(crate) fn size(&self, free: u64, used: u64) -> u64 {
+        (free.saturating_add(used) / 100 * self.percent).clamp(self.min, self.max)
+    }
+}
+
+/// Adaptive size of the file cache and when it was last evaluated.
+pub(crate) struct FileQuota {
+    /// Bounds of the size, `None` for a fixed size
+    adaptive: Mutex<Option<AdaptiveSize>>,
+    /// Last evaluation in seconds since the Unix epoch
+    evaluated: AtomicU64,
+}
+
+impl FileQuota {
+    /// Creates a quota for a fixed size.
+    pub(crate) fn new() -> Self {
+        Self {
+            adaptive: Mutex::new(None),
+            evaluated: AtomicU64::new(0),
+        }
+    }
+
+    /// Sets the bounds of the size, `None` to keep it fixed.
+    pub(crate) fn set(&self, adaptive: Option<AdaptiveSize>) {
+        *self.adaptive.lock().unwrap() = adaptive;
+        self.evaluated.store(0, Ordering::Relaxed);
+    }
+
+    /// Returns the bounds of the size, `None` if it is fixed.
+    pub(crate) fn adaptive(&self) -> Option<AdaptiveSize> {
+        *self.adaptive.lock().unwrap()
+    }
+}
+
+impl CacheManager {
+    /// Sizes the file cache to a share of the free space of its disk.
+    ///
+    /// The file cache takes `percent` of its free space plus the bytes it
+    /// already holds, at least `min` and at most `max` bytes. The size is
+    /// evaluated now and again as files are cached, entries over it are
+    /// evicted in the background. `set_file_cache_size` sets a fixed size
+    /// again.
+    ///
+    /// # Parameters
+    /// - `percent`: Share of the usable space taken, at most 100
+    /// - `min`: Smallest size in bytes
+    /// - `max`: Largest size in bytes, raised to `min` if below it
+    pub fn set_adaptive_file_cache_size(&'static self, percent: u8, min: u64, max: u64) {
+        let adaptive = AdaptiveSize::new(percent, min, max);
+        info!("set adaptive file cache size {:?}", adaptive);
+        self.file_quota.set(Some(adaptive));
+        self.schedule_quota_check(false);
+    }
+
+    /// Evaluates the adaptive size of the file cache in the background, at
+    /// most once per `QUOTA_INTERVAL` unless `now` is set.
+    ///
+    /// # Parameters
+    /// - `now`: Whether to evaluate even within the interval
+    pub(crate) fn schedule_quota_check(&'static self, now: bool) {
+        let Some(adaptive) = self.file_quota.adaptive() else {
+            return;
+        };
+        let evaluated = &self.file_quota.evaluated;
+        let time = now_secs();
+        let last = evaluated.load(Ordering::Relaxed);
+        if (!now && time.saturating_sub(last) < QUOTA_INTERVAL)
+            || evaluated
+                .compare_exchange(last, time, Ordering::Relaxed, Ordering::Relaxed)
+                .is_err()
+        {
+            return;
+        }
+        spawn(move || self.resize_file_cache(adaptive));
+    }
+
+    /// Evaluates the size of the file cache after a write error, at once if
+    /// the disk is full.
+    pub(crate) fn file_write_failed(&'static self, error: &io::Error) {
+        self.schedule_quota_check(error.raw_os_error() == Some(ENOSPC));
+    }
+
+    /// Sets the file cache size for the free space of its disk and evicts
+    /// the entries over it.
+    fn resize_file_cache(&self, adaptive: AdaptiveSize) {
+        // SAFETY: This is a read-only operation to get the path
+        let Some(path) = (unsafe { FILE_STORE_DIR.as_path() }) else {
+            return;
+        };
+        let free = match free_space(path) {
+            Ok(free) => free,
+            Err(e) => {
+                error!("get free space of file cache error {}", e);
+                return;
+            }
+        };
+        let size = adaptive.size(free, self.file_handle.used_capacity());
+        if size == self.file_handle.total_capacity() {
+            return;
+        }
+        info!("adapt file cache size to {}, {} free", size, free);
+        self.file_handle.change_total_size(size);
+        CacheManager::apply_cache(&self.file_handle, &self.files, None, 0);
+    }
+}
+
+#[cfg(test)]
+mod ut_quota {
+    // Include test module containing unit tests for the file cache quota
+    include!("../../tests/ut/data/ut_quota.rs");
+}
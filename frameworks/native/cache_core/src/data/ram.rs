@@ -20,25 +20,36 @@
 
 use std::cmp::Ordering;
 use std::io::{Cursor, Write};
-use std::sync::Arc;
+use std::sync::{Arc, OnceLock};
 
 use request_utils::task_id::TaskId;
 
-use super::MAX_CACHE_SIZE;
+use super::chunk::{alloc_chunk, free_chunk, CHUNK_SIZE};
+use super::{Validators, Weight, DEFAULT_COST, MAX_CACHE_SIZE};
 use crate::manage::CacheManager;
 
-/// Default capacity for new cache vectors when no size is specified.
-const DEFAULT_TRUNK_CAPACITY: usize = 512;
-
 /// In-memory cache implementation for task data.
 ///
 /// This struct manages RAM-based storage for task data, including memory allocation
 /// tracking and automatic resource cleanup.
+///
+/// Data is stored as a list of chunks. A download of known size gets a single
+/// chunk of exactly that size, otherwise pooled `CHUNK_SIZE` chunks are
+/// appended as data arrives, so the stored bytes are never reallocated. A
+/// contiguous copy is only built if a caller asks for one.
 pub struct RamCache {
     /// Unique identifier for the task associated with this cache
     pub(super) task_id: TaskId,
-    /// Binary data stored in the cache
-    data: Vec<u8>,
+    /// Binary data stored in the cache, in order
+    chunks: Vec<Vec<u8>>,
+    /// Total size of the stored data (in bytes)
+    len: usize,
+    /// Contiguous copy of the chunks, built on demand
+    contiguous: OnceLock<Vec<u8>>,
+    /// Validators of the response the data was received from
+    validators: Option<Validators>,
+    /// Milliseconds it took to download the data, if measured
+    cost: Option<u64>,
     /// Amount of memory allocated for this cache (in bytes)
     applied: u64,
     /// Reference to the cache manager controlling this cache
@@ -53,7 +64,10 @@ impl Drop for RamCache {
     fn drop(&mut self) {
         if self.applied != 0 {
             info!("ram {} released {}", self.task_id.brief(), self.applied);
-            self.handle.ram_handle.lock().unwrap().release(self.applied);
+            self.handle.ram_handle.release(self.applied);
+        }
+        for chunk in self.chunks.drain(..) {
+            free_chunk(chunk);
         }
     }
 }
@@ -73,8 +87,12 @@ impl RamCache {
     /// A new RamCache instance with the specified parameters
     pub(crate) fn new(task_id: TaskId, handle: &'static CacheManager, size: Option<usize>) -> Self {
         let applied = match size {
+            Some(size) if size as u64 > handle.ram_entry_max_size() => {
+                info!("ram {} for {} exceeds entry limit", size, task_id.brief());
+                0
+            }
             Some(size) => {
-                if CacheManager::apply_cache(&handle.ram_handle, &handle.rams, size) {
+                if CacheManager::apply_cache(&handle.ram_handle, &handle.rams, Some(&task_id), size) {
                     info!("apply ram {} for {}", size, task_id.brief());
                     size as u64
                 } else {
@@ -85,9 +103,17 @@ impl RamCache {
             None => 0,
         };
 
+        let chunks = match size {
+            Some(size) if size > 0 => vec![Vec::with_capacity(size)],
+            _ => Vec::new(),
+        };
         Self {
             task_id,
-            data: Vec::with_capacity(size.unwrap_or(DEFAULT_TRUNK_CAPACITY)),
+            chunks,
+            len: 0,
+            contiguous: OnceLock::new(),
+            validators: None,
+            cost: None,
             applied,
             handle,
         }
@@ -101,7 +127,8 @@ impl RamCache {
     /// # Returns
     /// An Arc pointing to the finalized cache
     pub(crate) fn finish_write(mut self) -> Arc<RamCache> {
-        let is_cache = self.check_size();
+        self.compact();
+        let is_cache = self.admit();
         let me = Arc::new(self);
 
         if is_cache {
@@ -121,12 +148,18 @@ impl RamCache {
     /// # Returns
     /// `true` if the cache is still valid for memory storage, `false` if it exceeds size limits
     pub(crate) fn check_size(&mut self) -> bool {
-        match (self.data.len() as u64).cmp(&self.applied) {
+        match (self.len as u64).cmp(&self.applied) {
             Ordering::Equal => true,
             Ordering::Greater => {
-                let diff = self.data.len() - self.applied as usize;
-                if self.data.len() > MAX_CACHE_SIZE as usize
-                    || !CacheManager::apply_cache(&self.handle.ram_handle, &self.handle.rams, diff)
+                let diff = self.len - self.applied as usize;
+                if self.len > MAX_CACHE_SIZE as usize
+                    || self.len as u64 > self.handle.ram_entry_max_size()
+                    || !CacheManager::apply_cache(
+                        &self.handle.ram_handle,
+                        &self.handle.rams,
+                        Some(&self.task_id),
+                        diff,
+                    )
                 {
                     // Exceeds maximum allowed size or failed to allocate additional memory
                     info!(
@@ -134,7 +167,7 @@ impl RamCache {
                         diff,
                         self.task_id.brief()
                     );
-                    self.handle.ram_handle.lock().unwrap().release(self.applied);
+                    self.handle.ram_handle.release(self.applied);
                     self.applied = 0;
                     false
                 } else {
@@ -144,7 +177,7 @@ impl RamCache {
                         diff,
                         self.task_id.brief()
                     );
-                    self.applied = self.data.len() as u64;
+                    self.applied = self.len as u64;
                     true
                 }
             }
@@ -152,15 +185,43 @@ impl RamCache {
                 // Release excess allocated memory
                 self.handle
                     .ram_handle
-                    .lock()
-                    .unwrap()
-                    .release(self.applied - self.data.len() as u64);
-                self.applied = self.data.len() as u64;
+                    .release(self.applied - self.len as u64);
+                self.applied = self.len as u64;
                 true
             }
         }
     }
 
+    /// Checks the size of the cache like `check_size`, a cache that does not
+    /// fit the RAM cache still has its bytes counted against the RAM budget
+    /// for as long as it is alive.
+    ///
+    /// # Returns
+    /// `true` if the cache can be stored in the RAM cache
+    pub(crate) fn admit(&mut self) -> bool {
+        if self.check_size() {
+            return true;
+        }
+        self.handle.ram_handle.charge(self.len as u64);
+        self.applied = self.len as u64;
+        false
+    }
+
+    /// Moves a partially filled single pooled chunk into an exact-size buffer
+    /// and returns the chunk to the pool, so small downloads of unknown size
+    /// do not pin a whole chunk.
+    fn compact(&mut self) {
+        if self.chunks.len() != 1
+            || self.chunks[0].capacity() != CHUNK_SIZE
+            || self.len == CHUNK_SIZE
+        {
+            return;
+        }
+        let chunk = self.chunks.pop().unwrap();
+        self.chunks.push(chunk.as_slice().to_vec());
+        free_chunk(chunk);
+    }
+
     /// Returns a reference to the task ID associated with this cache.
     ///
     /// # Returns
@@ -169,12 +230,50 @@ impl RamCache {
         &self.task_id
     }
 
+    /// Sets the validators of the response the data was received from.
+    pub(crate) fn set_validators(&mut self, validators: Validators) {
+        self.validators = (!validators.is_empty()).then_some(validators);
+    }
+
+    /// Sets how long it took to download the data, used as its re-fetch cost.
+    pub(crate) fn set_cost(&mut self, millis: u64) {
+        self.cost = Some(millis);
+    }
+
+    /// Returns the validators of the response the data was received from.
+    pub fn validators(&self) -> Option<&Validators> {
+        self.validators.as_ref()
+    }
+
     /// Returns the current size of the cached data.
     ///
     /// # Returns
     /// Size of the data in bytes
     pub fn size(&self) -> usize {
-        self.data.len()
+        self.len
+    }
+
+    /// Returns the cached data in storage order without copying it.
+    ///
+    /// # Returns
+    /// One slice per chunk, empty chunks are skipped
+    pub fn chunks(&self) -> impl Iterator<Item = &[u8]> {
+        self.chunks
+            .iter()
+            .map(Vec::as_slice)
+            .filter(|chunk| !chunk.is_empty())
+    }
+
+    /// Returns the cached data as one contiguous slice.
+    ///
+    /// Data stored in more than one chunk is copied into a contiguous buffer
+    /// on the first call, prefer `chunks` where possible.
+    pub fn bytes(&self) -> &[u8] {
+        match self.chunks.len() {
+            0 => &[],
+            1 => &self.chunks[0],
+            _ => self.contiguous.get_or_init(|| self.chunks.concat()),
+        }
     }
 
     /// Creates a cursor for reading the cached data.
@@ -182,14 +281,29 @@ impl RamCache {
     /// # Returns
     /// A new cursor positioned at the start of the cached data
     pub fn cursor(&self) -> Cursor<&[u8]> {
-        Cursor::new(&self.data)
+        Cursor::new(self.bytes())
+    }
+}
+
+impl Weight for Arc<RamCache> {
+    /// Returns the size of the cached data, it no longer changes once the
+    /// cache is registered with the manager.
+    fn weight(&self) -> u64 {
+        self.size() as u64
+    }
+
+    /// Returns the measured download time, or `DEFAULT_COST` for data that
+    /// was not downloaded in this run.
+    fn cost(&self) -> u64 {
+        self.cost.unwrap_or(DEFAULT_COST)
     }
 }
 
 impl Write for RamCache {
     /// Writes data to the cache.
     ///
-    /// Delegates to the underlying Vec<u8> implementation.
+    /// Fills the last chunk up to its capacity and appends pooled chunks for
+    /// the rest, existing data is never moved.
     ///
     /// # Parameters
     /// - `buf`: Buffer containing the data to write
@@ -197,18 +311,33 @@ impl Write for RamCache {
     /// # Returns
     /// Number of bytes written on success, or an error
     fn write(&mut self, buf: &[u8]) -> std::io::Result<usize> {
-        self.data.write(buf)
+        self.contiguous.take();
+        let mut rest = buf;
+        while !rest.is_empty() {
+            let full = match self.chunks.last() {
+                Some(chunk) => chunk.len() == chunk.capacity(),
+                None => true,
+            };
+            if full {
+                self.chunks.push(alloc_chunk());
+            }
+            let chunk = self.chunks.last_mut().unwrap();
+            let n = (chunk.capacity() - chunk.len()).min(rest.len());
+            chunk.extend_from_slice(&rest[..n]);
+            rest = &rest[n..];
+        }
+        self.len += buf.len();
+        Ok(buf.len())
     }
 
     /// Flushes the cache.
     ///
-    /// Delegates to the underlying Vec<u8> implementation.
     /// Since this is an in-memory cache, this operation is a no-op.
     ///
     /// # Returns
     /// Ok(()) indicating success
     fn flush(&mut self) -> std::io::Result<()> {
-        self.data.flush()
+        Ok(())
     }
 }
 
@@ -224,15 +353,9 @@ impl CacheManager {
     pub(crate) fn update_ram_cache(&'static self, cache: Arc<RamCache>) {
         let task_id = cache.task_id().clone();
 
-        if self
-            .rams
-            .lock()
-            .unwrap()
-            .insert(task_id.clone(), cache.clone())
-            .is_some()
-        {
+        if self.rams.insert(task_id.clone(), cache.clone()).is_some() {
             // If there was a previous cache, remove associated file cache
-            self.files.lock().unwrap().remove(&task_id);
+            self.files.remove(&task_id);
             info!("{} old caches delete", task_id.brief());
         }
         // Prevent updating from file again for this task
@@ -0,0 +1,100 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Windows of cached content.
+//!
+//! A player seeking in a cached media file only reads part of it. A window
+//! of content in RAM is served from the chunks holding it, a window of a
+//! cache file is mapped or read over its own pages only, so serving it never
+//! loads the whole body into the RAM cache.
+
+use std::sync::{Arc, OnceLock};
+
+use super::RamCache;
+
+/// Window of the content of a RAM cache.
+pub struct RamRange {
+    /// Cache holding the content
+    cache: Arc<RamCache>,
+    /// Position of the window in the content
+    offset: usize,
+    /// Length of the window in bytes
+    len: usize,
+    /// Contiguous copy of a window spanning chunks, built on demand
+    contiguous: OnceLock<Vec<u8>>,
+}
+
+impl RamRange {
+    /// Creates the window of `len` bytes from `offset`, cut at the end of the
+    /// content.
+    pub(crate) fn new(cache: Arc<RamCache>, offset: u64, len: u64) -> Self {
+        let size = cache.size();
+        let offset = usize::try_from(offset).unwrap_or(usize::MAX).min(size);
+        let len = usize::try_from(len)
+            .unwrap_or(usize::MAX)
+            .min(size - offset);
+        Self {
+            cache,
+            offset,
+            len,
+            contiguous: OnceLock::new(),
+        }
+    }
+
+    /// Returns the size of the window.
+    pub fn size(&self) -> usize {
+        self.len
+    }
+
+    /// Returns the window in storage order without copying it.
+    ///
+    /// # Returns
+    /// The part of each chunk inside the window, empty parts are skipped
+    pub fn chunks(&self) -> impl Iterator<Item = &[u8]> {
+        let (start, end) = (self.offset, self.offset + self.len);
+        self.cache
+            .chunks()
+            .scan(0, move |position, chunk| {
+                if *position >= end {
+                    return None;
+                }
+                let chunk_start = *position;
+                *position += chunk.len();
+                let from = start.clamp(chunk_start, *position);
+                let to = end.min(*position);
+                Some(&chunk[from - chunk_start..to.max(from) - chunk_start])
+            })
+            .filter(|part| !part.is_empty())
+    }
+
+    /// Returns the window as one contiguous slice.
+    ///
+    /// A window spanning more than one chunk is copied into a contiguous
+    /// buffer on the first call, prefer `chunks` where possible.
+    pub fn bytes(&self) -> &[u8] {
+        let mut chunks = self.chunks();
+        match (chunks.next(), chunks.next()) {
+            (None, _) => &[],
+            (Some(chunk), None) => chunk,
+            _ => self
+                .contiguous
+                .get_or_init(|| self.chunks().collect::<Vec<_>>().concat()),
+        }
+    }
+}
+
+#[cfg(test)]
+mod ut_range {
+    // Include test module containing unit tests for RamRange
+    include!("../../tests/ut/data/ut_range.rs");
+}
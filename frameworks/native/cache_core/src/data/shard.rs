@@ -0,0 +1,528 @@
+// Copyright (C) 2024 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Lock-striped LRU cache keyed by task ID.
+//!
+//! Entries are spread over a fixed number of shards by the hash of their task
+//! ID. Every shard is an independent LRU behind its own lock and accounts the
+//! bytes of the entries it holds, so lookups of different tasks do not contend
+//! and eviction can pick the shard that frees the most.
+//!
+//! Under `RamCachePolicy::TinyLfu` every shard is a segmented LRU instead: new
+//! entries start in a probation segment and move to a protected one when they
+//! are hit again. A frequency sketch per shard estimates how often each task
+//! was accessed recently, and a new entry may only evict one that is accessed
+//! less often, so a burst of one-time entries does not flush the hot ones.
+//!
+//! Under `RamCachePolicy::GreedyDualSize` entries are evicted by credit
+//! instead of recency. An entry is credited with its re-fetch cost per byte on
+//! top of the cache's inflation value whenever it is inserted or hit, the
+//! entry with the lowest credit is evicted and its credit becomes the new
+//! inflation value. Large entries that are cheap to fetch again go first, and
+//! a single large entry no longer pushes out many small hot ones.
+
+use std::collections::hash_map::DefaultHasher;
+use std::collections::{BTreeMap, HashMap};
+use std::hash::{Hash, Hasher};
+use std::sync::atomic::{AtomicU64, AtomicU8, Ordering};
+use std::sync::{Mutex, MutexGuard};
+
+use request_utils::lru::LRUCache;
+use request_utils::task_id::TaskId;
+
+#[cfg(feature = "lock_stats")]
+use super::hold::{Held, LockHoldStats, LockHolds};
+use super::sketch::FrequencySketch;
+
+/// Number of shards of a cache, a power of two.
+pub(crate) const CACHE_SHARDS: usize = 16;
+
+/// Counters per row of the frequency sketch of a shard.
+const SKETCH_WIDTH: usize = 256;
+
+/// Percentage of the entries of a shard the protected segment may hold.
+const PROTECTED_PERCENT: usize = 80;
+
+/// Re-fetch cost in milliseconds assumed for entries without a measured one.
+pub(crate) const DEFAULT_COST: u64 = 100;
+
+/// Fixed-point scale of credits, so that credits of large entries do not
+/// round down to zero.
+const CREDIT_SCALE: u64 = 1 << 20;
+
+/// Size in bytes an entry accounts for in its shard.
+pub(crate) trait Weight {
+    /// Returns the bytes held by the entry.
+    fn weight(&self) -> u64;
+
+    /// Returns the cost in milliseconds of fetching the entry again.
+    fn cost(&self) -> u64 {
+        DEFAULT_COST
+    }
+}
+
+/// Returns the credit an entry earns in addition to the inflation value.
+fn credit<V: Weight>(value: &V) -> u64 {
+    value.cost().saturating_mul(CREDIT_SCALE) / value.weight().max(1)
+}
+
+/// Eviction policy of the RAM cache.
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub enum RamCachePolicy {
+    /// Least recently used entries are evicted first
+    Lru = 0,
+    /// Segmented LRU with a TinyLFU admission filter
+    TinyLfu = 1,
+    /// Entries with the lowest re-fetch cost per byte are evicted first
+    GreedyDualSize = 2,
+}
+
+impl RamCachePolicy {
+    fn from_u8(policy: u8) -> Self {
+        match policy {
+            1 => RamCachePolicy::TinyLfu,
+            2 => RamCachePolicy::GreedyDualSize,
+            _ => RamCachePolicy::Lru,
+        }
+    }
+}
+
+/// Lookup counters of a cache.
+#[derive(Clone, Copy, Debug, Default, PartialEq, Eq)]
+pub struct CacheStats {
+    /// Lookups that found the entry
+    pub hits: u64,
+    /// Lookups that did not find the entry
+    pub misses: u64,
+}
+
+impl CacheStats {
+    /// Returns the share of lookups that found the entry, 0 without lookups.
+    pub fn hit_ratio(&self) -> f64 {
+        match self.hits + self.misses {
+            0 => 0.0,
+            total => self.hits as f64 / total as f64,
+        }
+    }
+}
+
+/// Entries of a shard.
+///
+/// Under `RamCachePolicy::Lru` and `RamCachePolicy::GreedyDualSize` all
+/// entries are kept in `probation`.
+struct Segments<V> {
+    /// Entries not hit since they were inserted
+    probation: LRUCache<TaskId, V>,
+    /// Entries hit at least once after insertion
+    protected: LRUCache<TaskId, V>,
+    /// Recent access frequencies of the tasks mapped to this shard
+    sketch: FrequencySketch,
+    /// Entries by credit and then insertion order, only under
+    /// `RamCachePolicy::GreedyDualSize`
+    credits: BTreeMap<(u64, u64), TaskId>,
+    /// Key of every entry in `credits`
+    credit_keys: HashMap<TaskId, (u64, u64)>,
+    /// Insertion counter breaking ties between equal credits
+    credit_seq: u64,
+}
+
+impl<V> Segments<V> {
+    /// Sets the credit of an entry, replacing its previous one.
+    fn set_credit(&mut self, task_id: &TaskId, credit: u64) {
+        self.clear_credit(task_id);
+        self.credit_seq += 1;
+        let key = (credit, self.credit_seq);
+        self.credits.insert(key, task_id.clone());
+        self.credit_keys.insert(task_id.clone(), key);
+    }
+
+    fn clear_credit(&mut self, task_id: &TaskId) {
+        if let Some(key) = self.credit_keys.remove(task_id) {
+            self.credits.remove(&key);
+        }
+    }
+
+    /// Returns the lowest credit of the shard.
+    fn min_credit(&self) -> Option<u64> {
+        self.credits.keys().next().map(|(credit, _)| *credit)
+    }
+
+    /// Evicts the entry with the lowest credit.
+    ///
+    /// # Returns
+    /// The credit and the entry
+    fn pop_lowest(&mut self) -> Option<(u64, V)> {
+        let ((credit, _), task_id) = self.credits.pop_first()?;
+        self.credit_keys.remove(&task_id);
+        self.probation.remove(&task_id).map(|value| (credit, value))
+    }
+
+    /// Returns the entry evicted next, the least recently used one of
+    /// probation or, if it is empty, of protected.
+    fn victim(&self) -> Option<&TaskId> {
+        self.probation.peek_lru().or_else(|| self.protected.peek_lru())
+    }
+
+    fn pop(&mut self) -> Option<V> {
+        self.probation.pop().or_else(|| self.protected.pop())
+    }
+
+    /// Moves the least recently used protected entries to probation until
+    /// protected holds at most `PROTECTED_PERCENT` of the entries, rounded up.
+    fn demote(&mut self) {
+        let total = self.probation.len() + self.protected.len();
+        let limit = (total * PROTECTED_PERCENT).div_ceil(100);
+        while self.protected.len() > limit {
+            let Some((task_id, value)) = self.protected.pop_entry() else {
+                break;
+            };
+            self.probation.insert(task_id, value);
+        }
+    }
+}
+
+/// A single shard and the bytes of its entries.
+struct Shard<V> {
+    segments: Mutex<Segments<V>>,
+    bytes: AtomicU64,
+}
+
+/// LRU cache split into `CACHE_SHARDS` independently locked shards.
+pub(crate) struct ShardedLru<V> {
+    shards: Box<[Shard<V>]>,
+    /// Current `RamCachePolicy`
+    policy: AtomicU8,
+    /// Hits counted by `lookup`
+    hits: AtomicU64,
+    /// Misses counted by `lookup`
+    misses: AtomicU64,
+    /// Credit of the last entry evicted under `RamCachePolicy::GreedyDualSize`
+    inflation: AtomicU64,
+    /// Hold times of the shard locks
+    #[cfg(feature = "lock_stats")]
+    holds: LockHolds,
+}
+
+impl<V: Weight> ShardedLru<V> {
+    /// Creates an empty cache.
+    pub(crate) fn new() -> Self {
+        let shards = (0..CACHE_SHARDS)
+            .map(|_| Shard {
+                segments: Mutex::new(Segments {
+                    probation: LRUCache::new(),
+                    protected: LRUCache::new(),
+                    sketch: FrequencySketch::new(SKETCH_WIDTH),
+                    credits: BTreeMap::new(),
+                    credit_keys: HashMap::new(),
+                    credit_seq: 0,
+                }),
+                bytes: AtomicU64::new(0),
+            })
+            .collect::<Vec<_>>();
+        Self {
+            shards: shards.into_boxed_slice(),
+            policy: AtomicU8::new(RamCachePolicy::Lru as u8),
+            hits: AtomicU64::new(0),
+            misses: AtomicU64::new(0),
+            inflation: AtomicU64::new(0),
+            #[cfg(feature = "lock_stats")]
+            holds: LockHolds::new(),
+        }
+    }
+
+    #[cfg(not(feature = "lock_stats"))]
+    fn lock<'a>(&self, shard: &'a Shard<V>) -> MutexGuard<'a, Segments<V>> {
+        shard.segments.lock().unwrap()
+    }
+
+    #[cfg(feature = "lock_stats")]
+    fn lock<'a>(&'a self, shard: &'a Shard<V>) -> Held<'a, MutexGuard<'a, Segments<V>>> {
+        Held::new(shard.segments.lock().unwrap(), &self.holds)
+    }
+
+    /// Returns the hold times of the shard locks and forgets them if `reset`.
+    #[cfg(feature = "lock_stats")]
+    pub(crate) fn lock_holds(&self, reset: bool) -> LockHoldStats {
+        let stats = self.holds.stats();
+        if reset {
+            self.holds.reset();
+        }
+        stats
+    }
+
+    fn shard(&self, task_id: &TaskId) -> (&Shard<V>, u64) {
+        let mut hasher = DefaultHasher::new();
+        task_id.hash(&mut hasher);
+        let hash = hasher.finish();
+        (&self.shards[hash as usize & (CACHE_SHARDS - 1)], hash)
+    }
+
+    /// Returns the current eviction policy.
+    pub(crate) fn policy(&self) -> RamCachePolicy {
+        RamCachePolicy::from_u8(self.policy.load(Ordering::Acquire))
+    }
+
+    /// Switches the eviction policy and resets the lookup counters.
+    ///
+    /// Entries are kept. Policies other than `RamCachePolicy::TinyLfu` move the
+    /// protected entries to the most recently used end, and
+    /// `RamCachePolicy::GreedyDualSize` credits every entry afresh.
+    pub(crate) fn set_policy(&self, policy: RamCachePolicy) {
+        self.policy.store(policy as u8, Ordering::Release);
+        let inflation = self.inflation.load(Ordering::Acquire);
+        for shard in self.shards.iter() {
+            let mut segments = self.lock(shard);
+            if policy != RamCachePolicy::TinyLfu {
+                while let Some((task_id, value)) = segments.protected.pop_entry() {
+                    segments.probation.insert(task_id, value);
+                }
+            }
+            segments.credits.clear();
+            segments.credit_keys.clear();
+            if policy == RamCachePolicy::GreedyDualSize {
+                let keys = segments.probation.keys().cloned().collect::<Vec<_>>();
+                for task_id in keys {
+                    // `get` only reorders the LRU, which this policy ignores
+                    let Some(credit) = segments.probation.get(&task_id).map(credit) else {
+                        continue;
+                    };
+                    segments.set_credit(&task_id, inflation.saturating_add(credit));
+                }
+            }
+        }
+        self.hits.store(0, Ordering::Release);
+        self.misses.store(0, Ordering::Release);
+    }
+
+    /// Returns the lookup counters since the policy was last set.
+    pub(crate) fn stats(&self) -> CacheStats {
+        CacheStats {
+            hits: self.hits.load(Ordering::Acquire),
+            misses: self.misses.load(Ordering::Acquire),
+        }
+    }
+
+    /// Records an access of a task in the frequency sketch, without looking
+    /// up its entry.
+    pub(crate) fn record(&self, task_id: &TaskId) {
+        if self.policy() == RamCachePolicy::TinyLfu {
+            let (shard, hash) = self.shard(task_id);
+            self.lock(shard).sketch.record(hash);
+        }
+    }
+
+    /// Inserts an entry as the most recently used one of its shard.
+    ///
+    /// A replaced entry keeps its segment, new entries start in probation.
+    /// The access was already recorded when space was applied for the entry.
+    ///
+    /// # Returns
+    /// The entry previously stored for the task, if any
+    pub(crate) fn insert(&self, task_id: TaskId, value: V) -> Option<V> {
+        let (shard, _) = self.shard(&task_id);
+        shard.bytes.fetch_add(value.weight(), Ordering::AcqRel);
+        let mut segments = self.lock(shard);
+        if self.policy() == RamCachePolicy::GreedyDualSize {
+            let credit = self.inflation.load(Ordering::Acquire).saturating_add(credit(&value));
+            segments.set_credit(&task_id, credit);
+        }
+        let old = if segments.protected.contains_key(&task_id) {
+            segments.protected.insert(task_id, value)
+        } else {
+            segments.probation.insert(task_id, value)
+        };
+        drop(segments);
+        if let Some(old) = old.as_ref() {
+            shard.bytes.fetch_sub(old.weight(), Ordering::AcqRel);
+        }
+        old
+    }
+
+    /// Marks the entry of a task as recently used and maps it with `f`.
+    ///
+    /// Under `RamCachePolicy::TinyLfu` the access is recorded and an entry hit
+    /// in probation moves to protected. `f` runs while the shard is locked
+    /// and should be short.
+    pub(crate) fn get<R>(&self, task_id: &TaskId, f: impl FnOnce(&V) -> R) -> Option<R> {
+        let (shard, hash) = self.shard(task_id);
+        let mut segments = self.lock(shard);
+        match self.policy() {
+            RamCachePolicy::Lru => return segments.probation.get(task_id).map(f),
+            RamCachePolicy::GreedyDualSize => {
+                let credit = segments.probation.get(task_id).map(credit)?;
+                let credit = self.inflation.load(Ordering::Acquire).saturating_add(credit);
+                segments.set_credit(task_id, credit);
+                return segments.probation.get(task_id).map(f);
+            }
+            RamCachePolicy::TinyLfu => {}
+        }
+        segments.sketch.record(hash);
+        if let Some(value) = segments.probation.remove(task_id) {
+            segments.protected.insert(task_id.clone(), value);
+            segments.demote();
+        }
+        segments.protected.get(task_id).map(f)
+    }
+
+    /// Like `get`, and counts the lookup as a hit or miss in `stats`.
+    pub(crate) fn lookup<R>(&self, task_id: &TaskId, f: impl FnOnce(&V) -> R) -> Option<R> {
+        let res = self.get(task_id, f);
+        let counter = if res.is_some() { &self.hits } else { &self.misses };
+        counter.fetch_add(1, Ordering::Relaxed);
+        res
+    }
+
+    /// Removes the entry of a task.
+    ///
+    /// The entry is returned so that it is dropped after the shard lock is
+    /// released.
+    pub(crate) fn remove(&self, task_id: &TaskId) -> Option<V> {
+        let (shard, _) = self.shard(task_id);
+        let old = {
+            let mut segments = self.lock(shard);
+            segments.clear_credit(task_id);
+            segments
+                .probation
+                .remove(task_id)
+                .or_else(|| segments.protected.remove(task_id))
+        };
+        if let Some(old) = old.as_ref() {
+            shard.bytes.fetch_sub(old.weight(), Ordering::AcqRel);
+        }
+        old
+    }
+
+    /// Checks whether an entry exists for the task.
+    pub(crate) fn contains_key(&self, task_id: &TaskId) -> bool {
+        let segments = self.lock(self.shard(task_id).0);
+        segments.probation.contains_key(task_id) || segments.protected.contains_key(task_id)
+    }
+
+    /// Returns the task IDs of all entries.
+    pub(crate) fn keys(&self) -> Vec<TaskId> {
+        let mut keys = Vec::new();
+        for shard in self.shards.iter() {
+            let segments = self.lock(shard);
+            keys.extend(segments.probation.keys().cloned());
+            keys.extend(segments.protected.keys().cloned());
+        }
+        keys
+    }
+
+    /// Maps every entry with `f` without changing its recency.
+    pub(crate) fn values<R>(&self, mut f: impl FnMut(&V) -> R) -> Vec<R> {
+        let mut values = Vec::new();
+        for shard in self.shards.iter() {
+            let segments = self.lock(shard);
+            values.extend(segments.probation.values().map(&mut f));
+            values.extend(segments.protected.values().map(&mut f));
+        }
+        values
+    }
+
+    /// Shard indexes ordered by the bytes they hold, most first.
+    fn heaviest(&self) -> Vec<usize> {
+        let mut order = (0..CACHE_SHARDS).collect::<Vec<_>>();
+        order.sort_by_key(|i| std::cmp::Reverse(self.shards[*i].bytes.load(Ordering::Acquire)));
+        order
+    }
+
+    /// Evicts the least recently used entry of the shard holding the most
+    /// bytes, or under `RamCachePolicy::GreedyDualSize` the entry with the
+    /// lowest credit.
+    ///
+    /// # Returns
+    /// The evicted entry, `None` if the cache is empty
+    pub(crate) fn pop(&self) -> Option<V> {
+        if self.policy() == RamCachePolicy::GreedyDualSize {
+            return self.pop_lowest();
+        }
+        for i in self.heaviest() {
+            let shard = &self.shards[i];
+            let popped = self.lock(shard).pop();
+            if let Some(popped) = popped {
+                shard.bytes.fetch_sub(popped.weight(), Ordering::AcqRel);
+                return Some(popped);
+            }
+        }
+        None
+    }
+
+    /// Evicts the entry with the lowest credit of all shards and raises the
+    /// inflation value to its credit.
+    fn pop_lowest(&self) -> Option<V> {
+        loop {
+            let lowest = self
+                .shards
+                .iter()
+                .enumerate()
+                .filter_map(|(i, shard)| Some((self.lock(shard).min_credit()?, i)))
+                .min()?;
+            let shard = &self.shards[lowest.1];
+            // The shard may have changed since it was inspected, its lowest
+            // entry is evicted anyway
+            let popped = self.lock(shard).pop_lowest();
+            let Some((credit, popped)) = popped else {
+                continue;
+            };
+            self.inflation.fetch_max(credit, Ordering::AcqRel);
+            shard.bytes.fetch_sub(popped.weight(), Ordering::AcqRel);
+            return Some(popped);
+        }
+    }
+
+    /// Evicts an entry to make room for the entry of `candidate`.
+    ///
+    /// Under `RamCachePolicy::TinyLfu` the victim is only evicted if the
+    /// candidate was accessed more often recently, otherwise this acts like
+    /// `pop`.
+    ///
+    /// # Returns
+    /// The evicted entry, `None` if the cache is empty or the candidate is
+    /// not admitted
+    pub(crate) fn evict_for(&self, candidate: &TaskId) -> Option<V> {
+        if self.policy() != RamCachePolicy::TinyLfu {
+            return self.pop();
+        }
+        let (candidate_shard, candidate_hash) = self.shard(candidate);
+        let frequency = self.lock(candidate_shard).sketch.frequency(candidate_hash);
+        for i in self.heaviest() {
+            let shard = &self.shards[i];
+            let popped = {
+                let mut segments = self.lock(shard);
+                let Some(victim) = segments.victim().cloned() else {
+                    continue;
+                };
+                if victim != *candidate {
+                    let (_, victim_hash) = self.shard(&victim);
+                    if segments.sketch.frequency(victim_hash) >= frequency {
+                        debug!("{} not admitted", candidate.brief());
+                        return None;
+                    }
+                }
+                segments.pop()
+            };
+            if let Some(popped) = popped {
+                shard.bytes.fetch_sub(popped.weight(), Ordering::AcqRel);
+                return Some(popped);
+            }
+        }
+        None
+    }
+}
+
+#[cfg(test)]
+mod ut_shard {
+    // Include test module containing unit tests for ShardedLru
+    include!("../../tests/ut/data/ut_shard.rs");
+}
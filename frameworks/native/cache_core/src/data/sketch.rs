@@ -0,0 +1,94 @@
+// Copyright (C) 2024 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Approximate access frequencies for cache admission.
+//!
+//! A count-min sketch of small saturating counters estimates how often a key
+//! was accessed recently. Once the number of recorded accesses reaches the
+//! sample size, all counters are halved so old popularity fades out.
+
+/// Number of counter rows, each indexed by a different hash.
+const ROWS: usize = 4;
+
+/// Largest value of a counter.
+const MAX_COUNT: u8 = 15;
+
+/// Recorded accesses per counter of a row before the counters are halved.
+const SAMPLE_FACTOR: usize = 10;
+
+/// Count-min sketch with 4-bit saturating counters and periodic aging.
+pub(crate) struct FrequencySketch {
+    /// `ROWS` rows of `width` counters
+    table: Box<[u8]>,
+    /// Counters per row, a power of two
+    width: usize,
+    /// Accesses recorded since the last aging
+    additions: usize,
+}
+
+impl FrequencySketch {
+    /// Creates a sketch with `width` counters per row, rounded up to a power
+    /// of two.
+    pub(crate) fn new(width: usize) -> Self {
+        let width = width.max(1).next_power_of_two();
+        Self {
+            table: vec![0; ROWS * width].into_boxed_slice(),
+            width,
+            additions: 0,
+        }
+    }
+
+    /// Records an access of the key with the given hash.
+    pub(crate) fn record(&mut self, hash: u64) {
+        for row in 0..ROWS {
+            let index = self.index(hash, row);
+            if self.table[index] < MAX_COUNT {
+                self.table[index] += 1;
+            }
+        }
+        self.additions += 1;
+        if self.additions >= SAMPLE_FACTOR * self.width {
+            self.age();
+        }
+    }
+
+    /// Returns the estimated recent access count of the key with the given
+    /// hash.
+    pub(crate) fn frequency(&self, hash: u64) -> u8 {
+        (0..ROWS)
+            .map(|row| self.table[self.index(hash, row)])
+            .min()
+            .unwrap_or(0)
+    }
+
+    /// Halves all counters.
+    fn age(&mut self) {
+        for count in self.table.iter_mut() {
+            *count >>= 1;
+        }
+        self.additions /= 2;
+    }
+
+    fn index(&self, hash: u64, row: usize) -> usize {
+        // Double hashing, the odd step visits distinct columns per row
+        let h1 = hash as u32 as usize;
+        let h2 = ((hash >> 32) as u32 | 1) as usize;
+        row * self.width + (h1.wrapping_add(row.wrapping_mul(h2)) & (self.width - 1))
+    }
+}
+
+#[cfg(test)]
+mod ut_sketch {
+    // Include test module containing unit tests for FrequencySketch
+    include!("../../tests/ut/data/ut_sketch.rs");
+}
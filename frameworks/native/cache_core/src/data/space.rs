@@ -17,15 +17,27 @@
 //! within the cache system, including applying for additional resources and releasing
 //! unused resources.
 
+use std::sync::atomic::{AtomicU64, Ordering};
+#[cfg(feature = "lock_stats")]
+use std::time::Instant;
+
+#[cfg(feature = "lock_stats")]
+use super::hold::{LockHoldStats, LockHolds};
+
 /// Manages resource capacities for the caching system.
 ///
 /// This struct tracks total available capacity and currently used capacity,
 /// providing methods to apply for additional resources and release unused ones.
+/// Both counters are atomics, so the byte budget is enforced across all cache
+/// shards without a global lock.
 pub(crate) struct ResourceManager {
     /// Total available capacity (in bytes)
-    pub(super) total_capacity: u64,
+    pub(super) total_capacity: AtomicU64,
     /// Currently used capacity (in bytes)
-    pub(super) used_capacity: u64,
+    pub(super) used_capacity: AtomicU64,
+    /// Time spent updating `used_capacity` in `apply_cache_size`
+    #[cfg(feature = "lock_stats")]
+    holds: LockHolds,
 }
 
 impl ResourceManager {
@@ -38,8 +50,10 @@ impl ResourceManager {
     /// A new ResourceManager instance with the specified capacity and zero used capacity
     pub(crate) fn new(capacity: u64) -> Self {
         Self {
-            total_capacity: capacity,
-            used_capacity: 0,
+            total_capacity: AtomicU64::new(capacity),
+            used_capacity: AtomicU64::new(0),
+            #[cfg(feature = "lock_stats")]
+            holds: LockHolds::new(),
         }
     }
 
@@ -53,12 +67,19 @@ impl ResourceManager {
     ///
     /// # Returns
     /// `true` if allocation succeeded, `false` if insufficient capacity
-    pub(crate) fn apply_cache_size(&mut self, apply_size: u64) -> bool {
-        if apply_size + self.used_capacity > self.total_capacity {
-            return false;
-        }
-        self.used_capacity += apply_size;
-        true
+    pub(crate) fn apply_cache_size(&self, apply_size: u64) -> bool {
+        #[cfg(feature = "lock_stats")]
+        let since = Instant::now();
+        let total = self.total_capacity.load(Ordering::Acquire);
+        let applied = self
+            .used_capacity
+            .fetch_update(Ordering::AcqRel, Ordering::Acquire, |used| {
+                used.checked_add(apply_size).filter(|sum| *sum <= total)
+            })
+            .is_ok();
+        #[cfg(feature = "lock_stats")]
+        self.holds.record(since.elapsed().as_nanos() as u64);
+        applied
     }
 
     /// Releases previously allocated resource space.
@@ -67,16 +88,48 @@ impl ResourceManager {
     ///
     /// # Parameters
     /// - `size`: Amount of space to release in bytes
-    pub(super) fn release(&mut self, size: u64) {
-        self.used_capacity -= size;
+    pub(crate) fn release(&self, size: u64) {
+        self.used_capacity.fetch_sub(size, Ordering::AcqRel);
+    }
+
+    /// Counts space in use whether it fits the total capacity or not.
+    ///
+    /// Used for memory already allocated, the space is made up for by the
+    /// next allocations evicting more.
+    ///
+    /// # Parameters
+    /// - `size`: Amount of space to count in bytes
+    pub(crate) fn charge(&self, size: u64) {
+        self.used_capacity.fetch_add(size, Ordering::AcqRel);
     }
 
     /// Updates the total capacity of the resource manager.
     ///
     /// # Parameters
     /// - `size`: New total capacity in bytes
-    pub(crate) fn change_total_size(&mut self, size: u64) {
-        self.total_capacity = size;
+    pub(crate) fn change_total_size(&self, size: u64) {
+        self.total_capacity.store(size, Ordering::Release);
+    }
+
+    /// Returns the total capacity in bytes.
+    pub(crate) fn total_capacity(&self) -> u64 {
+        self.total_capacity.load(Ordering::Acquire)
+    }
+
+    /// Returns the currently used capacity in bytes.
+    pub(crate) fn used_capacity(&self) -> u64 {
+        self.used_capacity.load(Ordering::Acquire)
+    }
+
+    /// Returns the time spent in `apply_cache_size` and forgets it if
+    /// `reset`.
+    #[cfg(feature = "lock_stats")]
+    pub(crate) fn lock_holds(&self, reset: bool) -> LockHoldStats {
+        let stats = self.holds.stats();
+        if reset {
+            self.holds.reset();
+        }
+        stats
     }
 }
 
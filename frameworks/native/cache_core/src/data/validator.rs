@@ -0,0 +1,125 @@
+// Copyright (C) 2024 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Response validators of cached bodies.
+//!
+//! The `ETag` and `Last-Modified` values of a cached response are kept in a
+//! small file next to its file cache, so a refresh can ask the server whether
+//! the cached body is still current instead of downloading it again.
+//!
+//! A validator file holds the `ETag` on the first line and `Last-Modified` on
+//! the second, either line may be empty.
+
+use std::fs::{self, OpenOptions};
+use std::io::{self, Write};
+use std::path::PathBuf;
+
+use request_utils::task_id::TaskId;
+
+use super::file::FILE_STORE_DIR;
+
+/// Suffix of files holding the validators of a file cache.
+pub(crate) const VALIDATOR_SUFFIX: &str = "_V";
+
+/// Longest validator value that is stored.
+const MAX_VALUE_LEN: usize = 1024;
+
+/// Validators of a cached response.
+#[derive(Clone, Debug, Default, PartialEq, Eq)]
+pub struct Validators {
+    /// `ETag` header value
+    pub etag: Option<String>,
+    /// `Last-Modified` header value
+    pub last_modified: Option<String>,
+}
+
+impl Validators {
+    /// Returns `true` if the response carried no usable validator.
+    pub fn is_empty(&self) -> bool {
+        self.etag.is_none() && self.last_modified.is_none()
+    }
+
+    /// Returns the validator to send as `If-Range`.
+    ///
+    /// Weak entity tags must not be used for range requests, `Last-Modified`
+    /// is used instead if there is no strong one.
+    pub fn if_range(&self) -> Option<&str> {
+        match self.etag.as_deref() {
+            Some(etag) if !etag.starts_with("W/") => Some(etag),
+            _ => self.last_modified.as_deref(),
+        }
+    }
+
+    /// Stores the validators of a task, replacing earlier ones.
+    ///
+    /// Empty validators remove the stored ones instead.
+    pub(crate) fn save(&self, task_id: &TaskId) -> io::Result<()> {
+        if self.is_empty() {
+            Self::remove(task_id);
+            return Ok(());
+        }
+        let path = Self::path(task_id).ok_or(io::Error::new(
+            io::ErrorKind::NotFound,
+            "cache store dir not created.",
+        ))?;
+        let mut file = OpenOptions::new()
+            .write(true)
+            .create(true)
+            .truncate(true)
+            .open(path)?;
+        writeln!(file, "{}", self.etag.as_deref().unwrap_or_default())?;
+        writeln!(file, "{}", self.last_modified.as_deref().unwrap_or_default())?;
+        file.flush()
+    }
+
+    /// Loads the validators stored for a task.
+    ///
+    /// # Returns
+    /// The validators if a valid file is stored, `None` otherwise
+    pub(crate) fn load(task_id: &TaskId) -> Option<Self> {
+        let content = fs::read_to_string(Self::path(task_id)?).ok()?;
+        let mut lines = content.lines();
+        let value = |line: Option<&str>| {
+            line.filter(|v| !v.is_empty() && v.len() <= MAX_VALUE_LEN)
+                .map(str::to_string)
+        };
+        let me = Self {
+            etag: value(lines.next()),
+            last_modified: value(lines.next()),
+        };
+        (!me.is_empty()).then_some(me)
+    }
+
+    /// Removes the validators stored for a task, if any.
+    pub(crate) fn remove(task_id: &TaskId) {
+        let Some(path) = Self::path(task_id) else {
+            return;
+        };
+        if let Err(e) = fs::remove_file(path) {
+            if e.kind() != io::ErrorKind::NotFound {
+                error!("{} remove validators failed {}", task_id.brief(), e);
+            }
+        }
+    }
+
+    fn path(task_id: &TaskId) -> Option<PathBuf> {
+        // SAFETY: This is a read-only operation that joins a path
+        unsafe { FILE_STORE_DIR.join(task_id.to_string() + VALIDATOR_SUFFIX) }
+    }
+}
+
+#[cfg(test)]
+mod ut_validator {
+    // Include test module containing unit tests for Validators
+    include!("../../tests/ut/data/ut_validator.rs");
+}
@@ -0,0 +1,128 @@
+// Copyright (C) 2024 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Background queue of file cache writes.
+//!
+//! Finished downloads are queued instead of each spawning its own write. At
+//! most `MAX_WRITERS` workers drain the queue, and a task queued again before
+//! its write started only has its latest body written. `flush` waits until
+//! every queued write is done, so clearing the file cache does not race with
+//! writes already accepted.
+
+use std::collections::{HashMap, VecDeque};
+use std::sync::{Arc, Condvar, Mutex};
+
+use request_utils::task_id::TaskId;
+
+use super::RamCache;
+
+/// Largest number of workers writing file caches at the same time.
+pub(crate) const MAX_WRITERS: usize = 2;
+
+/// Queue of file cache writes shared by the writer workers.
+pub(crate) struct FileWriter {
+    state: Mutex<WriterState>,
+    /// Signalled when the queue is drained and no write is in flight
+    idle: Condvar,
+}
+
+struct WriterState {
+    /// Tasks in the order they were first queued
+    queue: VecDeque<TaskId>,
+    /// Latest body queued for each task in `queue`
+    pending: HashMap<TaskId, Arc<RamCache>>,
+    /// Running workers
+    workers: usize,
+    /// Writes taken from the queue and not finished yet
+    in_flight: usize,
+}
+
+impl FileWriter {
+    /// Creates an empty write queue.
+    pub(crate) fn new() -> Self {
+        Self {
+            state: Mutex::new(WriterState {
+                queue: VecDeque::new(),
+                pending: HashMap::new(),
+                workers: 0,
+                in_flight: 0,
+            }),
+            idle: Condvar::new(),
+        }
+    }
+
+    /// Queues the body of a task to be written.
+    ///
+    /// A body still queued for the same task is replaced and will not be
+    /// written.
+    ///
+    /// # Returns
+    /// `true` if the caller must spawn a worker running `next` and `done`
+    pub(crate) fn push(&self, task_id: TaskId, cache: Arc<RamCache>) -> bool {
+        let mut state = self.state.lock().unwrap();
+        if state.pending.insert(task_id.clone(), cache).is_some() {
+            debug!("{} file write coalesced", task_id.brief());
+            return false;
+        }
+        state.queue.push_back(task_id);
+        if state.workers < MAX_WRITERS {
+            state.workers += 1;
+            true
+        } else {
+            false
+        }
+    }
+
+    /// Takes the next write from the queue.
+    ///
+    /// # Returns
+    /// The task and the body to write, `None` if the queue is drained, in
+    /// which case the calling worker must stop
+    pub(crate) fn next(&self) -> Option<(TaskId, Arc<RamCache>)> {
+        let mut state = self.state.lock().unwrap();
+        while let Some(task_id) = state.queue.pop_front() {
+            if let Some(cache) = state.pending.remove(&task_id) {
+                state.in_flight += 1;
+                return Some((task_id, cache));
+            }
+        }
+        state.workers -= 1;
+        if state.in_flight == 0 {
+            self.idle.notify_all();
+        }
+        None
+    }
+
+    /// Marks a write returned by `next` as finished.
+    pub(crate) fn done(&self) {
+        let mut state = self.state.lock().unwrap();
+        state.in_flight -= 1;
+        if state.in_flight == 0 && state.queue.is_empty() {
+            self.idle.notify_all();
+        }
+    }
+
+    /// Blocks until all queued writes are finished.
+    pub(crate) fn flush(&self) {
+        let mut state = self.state.lock().unwrap();
+        while !state.queue.is_empty() || state.in_flight != 0 {
+            state = self.idle.wait(state).unwrap();
+        }
+    }
+}
+
+#[cfg(test)]
+mod ut_writer {
+    // Include test module containing unit tests for FileWriter
+    include!("../../tests/ut/data/ut_writer.rs");
+}
@@ -39,17 +39,40 @@ pub mod observe;
 /// In-memory cache implementation for task data.
 pub use data::RamCache;
 
+/// Cached content, either in RAM or mapped from a cache file, whole or as a
+/// window.
+pub use data::{CacheData, MappedCache, RamRange};
+
+/// Body prefix of an interrupted download, kept for a later range request.
+pub use data::PartialCache;
+
+/// `ETag` and `Last-Modified` values of a cached response.
+pub use data::Validators;
+
+/// Eviction policy of the RAM cache and its lookup counters.
+pub use data::{CacheStats, RamCachePolicy};
+
+/// Hold times of the locks of the caches, with the `lock_stats` feature.
+#[cfg(feature = "lock_stats")]
+pub use data::{CacheLockStats, LockHoldStats};
+
 /// Central manager for cache operations and resources.
 pub use manage::CacheManager;
 
+/// Memory pressure levels the RAM cache is trimmed for, and the memory held
+/// by the RAM caches.
+pub use manage::{MemoryLevel, MemoryStats};
+
 /// Handles cache updates and synchronization operations.
 pub use update::Updater;
 
 // Conditional compilation for OHOS platform
 cfg_ohos! {
     mod wrapper;
-    // Use ffrt_spawn for thread spawning on OHOS
-    use ffrt_rs::ffrt_spawn as spawn;
+    // Cache writes and cleanups run below the tasks users wait for on OHOS
+    fn spawn<F: FnOnce() + 'static>(f: F) {
+        ffrt_rs::ffrt_spawn_qos(ffrt_rs::Qos::Background, f);
+    }
 }
 
 // Conditional compilation for non-OHOS platforms
@@ -19,13 +19,18 @@
 
 use std::collections::{HashMap, HashSet};
 use std::io;
+use std::sync::atomic::{AtomicBool, AtomicU64, Ordering};
 use std::sync::{Arc, Mutex, OnceLock, Weak};
 
-use request_utils::lru::LRUCache;
+use request_utils::hash::crc32c;
 use request_utils::task_id::TaskId;
 
-use super::data::{self, restore_files, FileCache, RamCache};
+use super::data::{
+    self, restore_files, BackupRams, CacheData, CacheStats, FileCache, FileQuota, FileWriter,
+    Journal, PartialCache, RamCache, RamCachePolicy, RamRange, ShardedLru, Validators, Weight,
+};
 use crate::data::{init_curr_store_dir, MAX_CACHE_SIZE};
+use crate::spawn;
 
 /// Default maximum size for RAM-based cache storage (20MB).
 const DEFAULT_RAM_CACHE_SIZE: u64 = 1024 * 1024 * 20;
@@ -33,11 +38,55 @@ const DEFAULT_RAM_CACHE_SIZE: u64 = 1024 * 1024 * 20;
 /// Default maximum size for file-based cache storage (100MB).
 const DEFAULT_FILE_CACHE_SIZE: u64 = 1024 * 1024 * 100;
 
+/// Memory pressure reported by the system.
+///
+/// The RAM cache is trimmed to a share of its budget at each level, so it
+/// shrinks in steps as the pressure rises instead of being dropped at once.
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub enum MemoryLevel {
+    /// Memory is getting low, 75% of the budget is kept.
+    Moderate,
+    /// Memory is low, 50% of the budget is kept.
+    Low,
+    /// Memory is critically low, 25% of the budget is kept.
+    Critical,
+}
+
+impl MemoryLevel {
+    /// Returns the percent of the RAM cache budget kept at this level.
+    fn kept_percent(self) -> u64 {
+        match self {
+            MemoryLevel::Moderate => 75,
+            MemoryLevel::Low => 50,
+            MemoryLevel::Critical => 25,
+        }
+    }
+}
+
+/// Memory held by the RAM caches of a manager.
+#[derive(Clone, Copy, Debug, Default, PartialEq, Eq)]
+pub struct MemoryStats {
+    /// Bytes counted against the RAM cache budget
+    pub used: u64,
+    /// RAM cache budget in bytes
+    pub total: u64,
+    /// Entries of the RAM cache
+    pub ram_entries: usize,
+    /// Bodies waiting to be written to the file cache
+    pub backup_entries: usize,
+    /// Bytes of the bodies waiting to be written to the file cache
+    pub backup_bytes: u64,
+    /// Loads of file caches into RAM tracked to run once
+    pub file_loads: usize,
+}
+
 /// Central manager for coordinating different cache types and resources.
 ///
 /// This struct manages RAM-based and file-based caches, handles resource allocation,
 /// and provides methods for cache operations across different storage types.
 /// It uses LRU (Least Recently Used) eviction policy for managing cache entries.
+/// Both caches are sharded by task ID so parallel fetches of different tasks
+/// do not serialize, and their byte budgets are atomics shared by all shards.
 ///
 /// # Examples
 ///
@@ -54,23 +103,43 @@ const DEFAULT_FILE_CACHE_SIZE: u64 = 1024 * 1024 * 100;
 /// ```
 pub struct CacheManager {
     /// Primary RAM cache storage using LRU eviction policy
-    pub(crate) rams: Mutex<LRUCache<TaskId, Arc<RamCache>>>,
+    pub(crate) rams: ShardedLru<Arc<RamCache>>,
 
-    /// Backup RAM cache storage not subject to LRU eviction
-    pub(crate) backup_rams: Mutex<HashMap<TaskId, Arc<RamCache>>>,
+    /// Weak index of the RAM caches waiting to be written to files
+    pub(crate) backup_rams: BackupRams,
 
     /// File-based cache storage using LRU eviction policy
-    pub(crate) files: Mutex<LRUCache<TaskId, FileCache>>,
+    pub(crate) files: ShardedLru<FileCache>,
 
-    /// Ensures each file-to-RAM update is performed only once
+    /// Ensures each file-to-RAM update is performed only once, entries of
+    /// loaded bodies only refer to them weakly and are swept once
+    /// `MAX_FILE_LOADS` are kept
     pub(crate) update_from_file_once:
         Mutex<HashMap<TaskId, Arc<OnceLock<io::Result<Weak<RamCache>>>>>>,
 
     /// Manages RAM cache resource allocation and capacity
-    pub(crate) ram_handle: Mutex<data::ResourceManager>,
+    pub(crate) ram_handle: data::ResourceManager,
 
     /// Manages file cache resource allocation and capacity
-    pub(crate) file_handle: Mutex<data::ResourceManager>,
+    pub(crate) file_handle: data::ResourceManager,
+
+    /// Adaptive size of the file cache, if it is not fixed
+    pub(crate) file_quota: FileQuota,
+
+    /// Largest entry in bytes that is admitted to the RAM cache
+    ram_entry_max_size: AtomicU64,
+
+    /// Queue of file cache writes
+    pub(crate) writer: FileWriter,
+
+    /// Index of the file caches read at startup
+    pub(crate) journal: Journal,
+
+    /// Last scan for orphaned cache files in seconds since the Unix epoch
+    pub(crate) orphan_scanned: AtomicU64,
+
+    /// Whether a pass checking the file caches is running
+    checking_files: AtomicBool,
 }
 
 impl CacheManager {
@@ -82,13 +151,19 @@ impl CacheManager {
     /// A new CacheManager instance ready for use
     pub fn new() -> Self {
         Self {
-            rams: Mutex::new(LRUCache::new()),
-            files: Mutex::new(LRUCache::new()),
-            backup_rams: Mutex::new(HashMap::new()),
+            rams: ShardedLru::new(),
+            files: ShardedLru::new(),
+            backup_rams: BackupRams::new(),
             update_from_file_once: Mutex::new(HashMap::new()),
 
-            ram_handle: Mutex::new(data::ResourceManager::new(DEFAULT_RAM_CACHE_SIZE)),
-            file_handle: Mutex::new(data::ResourceManager::new(DEFAULT_FILE_CACHE_SIZE)),
+            ram_handle: data::ResourceManager::new(DEFAULT_RAM_CACHE_SIZE),
+            file_handle: data::ResourceManager::new(DEFAULT_FILE_CACHE_SIZE),
+            file_quota: FileQuota::new(),
+            ram_entry_max_size: AtomicU64::new(MAX_CACHE_SIZE),
+            writer: FileWriter::new(),
+            journal: Journal::new(),
+            orphan_scanned: AtomicU64::new(0),
+            checking_files: AtomicBool::new(false),
         }
     }
 
@@ -100,40 +175,144 @@ impl CacheManager {
     /// # Parameters
     /// - `size`: New maximum RAM cache size in bytes
     pub fn set_ram_cache_size(&self, size: u64) {
-        self.ram_handle.lock().unwrap().change_total_size(size);
-        CacheManager::apply_cache(&self.ram_handle, &self.rams, 0);
+        self.ram_handle.change_total_size(size);
+        CacheManager::apply_cache(&self.ram_handle, &self.rams, None, 0);
+    }
+
+    /// Sets the largest entry admitted to the RAM cache.
+    ///
+    /// Larger downloads are still stored in the file cache, cached entries
+    /// above the new limit stay until they are evicted.
+    ///
+    /// # Parameters
+    /// - `size`: Entry size limit in bytes, at most `MAX_CACHE_SIZE`
+    pub fn set_ram_entry_max_size(&self, size: u64) {
+        self.ram_entry_max_size
+            .store(size.min(MAX_CACHE_SIZE), Ordering::Release);
+    }
+
+    /// Returns the largest entry in bytes admitted to the RAM cache.
+    pub(crate) fn ram_entry_max_size(&self) -> u64 {
+        self.ram_entry_max_size.load(Ordering::Acquire)
+    }
+
+    /// Sets the eviction policy of the RAM cache.
+    ///
+    /// Cached entries are kept and the lookup counters returned by
+    /// `ram_cache_stats` are reset, so policies can be compared.
+    ///
+    /// # Parameters
+    /// - `policy`: New eviction policy
+    pub fn set_ram_cache_policy(&self, policy: RamCachePolicy) {
+        self.rams.set_policy(policy);
+    }
+
+    /// Returns the RAM cache lookup counters of `fetch` and `fetch_data`
+    /// since the policy was last set.
+    pub fn ram_cache_stats(&self) -> CacheStats {
+        self.rams.stats()
+    }
+
+    /// Returns the memory held by the RAM caches.
+    ///
+    /// Bodies waiting to be written to the file cache and bodies loaded from
+    /// it are counted in `used` while they are alive, even those not in the
+    /// RAM cache.
+    pub fn memory_stats(&self) -> MemoryStats {
+        let (backup_entries, backup_bytes) = self.backup_rams.usage();
+        MemoryStats {
+            used: self.ram_handle.used_capacity(),
+            total: self.ram_handle.total_capacity(),
+            ram_entries: self.rams.keys().len(),
+            backup_entries,
+            backup_bytes,
+            file_loads: self.update_from_file_once.lock().unwrap().len(),
+        }
+    }
+
+    /// Returns the hold times of the locks of the caches since the last
+    /// reset, and resets them if `reset`.
+    #[cfg(feature = "lock_stats")]
+    pub fn lock_stats(&self, reset: bool) -> data::CacheLockStats {
+        data::CacheLockStats {
+            rams: self.rams.lock_holds(reset),
+            files: self.files.lock_holds(reset),
+            ram_handle: self.ram_handle.lock_holds(reset),
+        }
     }
 
     /// Sets the maximum size for file-based caching.
     ///
     /// Adjusts the total capacity for file-based caching and triggers cache eviction
-    /// if the new size requires releasing resources.
+    /// if the new size requires releasing resources. An adaptive size set by
+    /// `set_adaptive_file_cache_size` is replaced by this fixed one.
     ///
     /// # Parameters
     /// - `size`: New maximum file cache size in bytes
     pub fn set_file_cache_size(&self, size: u64) {
-        self.file_handle.lock().unwrap().change_total_size(size);
-        CacheManager::apply_cache(&self.file_handle, &self.files, 0);
+        self.file_quota.set(None);
+        self.file_handle.change_total_size(size);
+        CacheManager::apply_cache(&self.file_handle, &self.files, None, 0);
     }
 
     /// Restores cached files from persistent storage.
     ///
     /// Initializes the current storage directory and restores all previously cached files
-    /// into the manager's file cache.
+    /// into the manager's file cache. The files are taken from the cache journal, the
+    /// directory is only scanned if the journal is missing or corrupted. The journal is
+    /// then rewritten with the restored files and files not restored are removed in the
+    /// background.
     ///
     /// # Safety
     /// Must be called with a `'static self` reference as it may spawn background tasks
     /// that need to reference the manager.
     pub fn restore_files(&'static self) {
         init_curr_store_dir();
-        if let Some(task_ids) = restore_files() {
-            for task_id in task_ids {
-                let Some(file_cache) = FileCache::try_restore(task_id.clone(), self) else {
-                    continue;
-                };
-                self.files.lock().unwrap().insert(task_id, file_cache);
+        match self.journal.load() {
+            Ok(entries) => {
+                for entry in entries {
+                    let task_id = entry.task_id.clone();
+                    let Some(file_cache) = FileCache::from_journal(entry, self) else {
+                        continue;
+                    };
+                    self.files.insert(task_id, file_cache);
+                }
+            }
+            Err(e) => {
+                info!("restore file caches by scanning, journal {}", e);
+                if let Some(task_ids) = restore_files() {
+                    for task_id in task_ids {
+                        let Some(file_cache) = FileCache::try_restore(task_id.clone(), self)
+                        else {
+                            continue;
+                        };
+                        self.files.insert(task_id, file_cache);
+                    }
+                }
             }
         }
+        self.compact_journal();
+        self.schedule_orphan_scan();
+        self.schedule_quota_check(false);
+    }
+
+    /// Checks the restored file caches against their CRC-32C in the
+    /// background.
+    ///
+    /// File caches are otherwise checked the first time they are loaded or
+    /// mapped. Corrupted files are discarded, files restored without a
+    /// recorded CRC-32C are not checked. Only one pass runs at a time.
+    ///
+    /// # Parameters
+    /// - `bytes_per_sec`: Most bytes read per second, 0 for no limit
+    pub fn verify_file_caches(&'static self, bytes_per_sec: u64) {
+        if self.checking_files.swap(true, Ordering::AcqRel) {
+            return;
+        }
+        spawn(move || {
+            self.check_file_caches(bytes_per_sec);
+            self.checking_files.store(false, Ordering::Release);
+        });
     }
 
     /// Fetches a cache entry by task ID.
@@ -153,6 +332,94 @@ impl CacheManager {
         self.get_cache(task_id)
     }
 
+    /// Fetches cached content by task ID without copying large cache files.
+    ///
+    /// Content already in RAM is returned as is. Otherwise a file cache of at
+    /// least `MMAP_MIN_SIZE` bytes is mapped read-only and returned without
+    /// being loaded into RAM, smaller ones are loaded like in `fetch`. A file
+    /// not yet checked against its CRC-32C is checked on its first mapping.
+    ///
+    /// # Parameters
+    /// - `task_id`: The task ID to fetch
+    ///
+    /// # Returns
+    /// `Some(CacheData)` if found, `None` otherwise
+    pub fn fetch_data(&'static self, task_id: &TaskId) -> Option<CacheData> {
+        let res = self.rams.lookup(task_id, Arc::clone);
+        if let Some(cache) = res.or_else(|| self.backup_rams.get(task_id)) {
+            return Some(CacheData::Ram(cache));
+        }
+        let res = self
+            .files
+            .get(task_id, |file| (file.map(), file.pending_check()));
+        match res {
+            Some((Ok(Some(mapped)), check)) => {
+                // Checked outside the shard lock
+                if let Some(check) = check {
+                    if !self.finish_check(task_id, check, crc32c(mapped.bytes())) {
+                        return None;
+                    }
+                }
+                return Some(CacheData::Mapped(mapped));
+            }
+            Some((Err(e), _)) => error!("{} map file cache failed {}", task_id.brief(), e),
+            _ => {}
+        }
+        self.update_ram_from_file(task_id).map(CacheData::Ram)
+    }
+
+    /// Fetches a window of cached content by task ID without loading the
+    /// rest of it.
+    ///
+    /// Content in RAM is served from the chunks holding the window. Otherwise
+    /// only the window of the file cache is mapped or read, and nothing is
+    /// loaded into the RAM cache.
+    ///
+    /// # Parameters
+    /// - `task_id`: The task ID to fetch
+    /// - `offset`: Position of the window in the content
+    /// - `len`: Length of the window, cut at the end of the content
+    ///
+    /// # Returns
+    /// `Some(CacheData)` holding the window if found, `None` otherwise
+    pub fn fetch_range(&self, task_id: &TaskId, offset: u64, len: u64) -> Option<CacheData> {
+        let res = self.rams.lookup(task_id, Arc::clone);
+        if let Some(cache) = res.or_else(|| self.backup_rams.get(task_id)) {
+            return Some(CacheData::RamRange(RamRange::new(cache, offset, len)));
+        }
+        let res = self
+            .files
+            .get(task_id, |file| file.read_range(offset, len))?;
+        match res {
+            Ok(data) => Some(data),
+            Err(e) => {
+                error!("{} read file cache range failed {}", task_id.brief(), e);
+                None
+            }
+        }
+    }
+
+    /// Returns the validators of the cached response of a task.
+    ///
+    /// Entries in RAM carry their validators, for entries only on disk the
+    /// validators kept with the file cache are returned without loading the
+    /// body.
+    ///
+    /// # Parameters
+    /// - `task_id`: The task ID to look up
+    ///
+    /// # Returns
+    /// `Some(Validators)` if the task is cached with validators, `None` otherwise
+    pub fn validators(&self, task_id: &TaskId) -> Option<Validators> {
+        let res = self.rams.get(task_id, Arc::clone);
+        if let Some(cache) = res.or_else(|| self.backup_rams.get(task_id)) {
+            return cache.validators().cloned();
+        }
+        self.files
+            .get(task_id, |file| file.validators().clone())
+            .filter(|validators| !validators.is_empty())
+    }
+
     /// Removes a cache entry by task ID.
     ///
     /// Removes the entry from all cache storage types (file, backup RAM, and primary RAM cache),
@@ -161,10 +428,11 @@ impl CacheManager {
     /// # Parameters
     /// - `task_id`: The task ID to remove
     pub fn remove(&self, task_id: TaskId) {
-        self.files.lock().unwrap().remove(&task_id);
-        self.backup_rams.lock().unwrap().remove(&task_id);
-        self.rams.lock().unwrap().remove(&task_id);
+        self.files.remove(&task_id);
+        self.backup_rams.remove(&task_id);
+        self.rams.remove(&task_id);
         self.update_from_file_once.lock().unwrap().remove(&task_id);
+        PartialCache::remove(&task_id);
     }
 
     /// Checks if a cache entry exists for the given task ID.
@@ -177,15 +445,16 @@ impl CacheManager {
     /// # Returns
     /// `true` if the task ID exists in any cache, `false` otherwise
     pub fn contains(&self, task_id: &TaskId) -> bool {
-        self.files.lock().unwrap().contains_key(task_id)
-            || self.backup_rams.lock().unwrap().contains_key(task_id)
-            || self.rams.lock().unwrap().contains_key(task_id)
+        self.files.contains_key(task_id)
+            || self.backup_rams.contains_key(task_id)
+            || self.rams.contains_key(task_id)
     }
 
     /// Internal method to get a cache entry with fallback logic.
     ///
     /// First checks the primary RAM cache, then the backup RAM cache, and finally
-    /// attempts to load from file cache if necessary.
+    /// attempts to load from file cache if necessary. The primary RAM lookup is
+    /// counted in `ram_cache_stats`.
     ///
     /// # Parameters
     /// - `task_id`: The task ID to retrieve
@@ -193,87 +462,109 @@ impl CacheManager {
     /// # Returns
     /// `Some(Arc<RamCache>)` if found through any cache source, `None` otherwise
     pub(crate) fn get_cache(&'static self, task_id: &TaskId) -> Option<Arc<RamCache>> {
-        let res = self.rams.lock().unwrap().get(task_id).cloned();
-        res.or_else(|| self.backup_rams.lock().unwrap().get(task_id).cloned())
+        let res = self.rams.lookup(task_id, Arc::clone);
+        res.or_else(|| self.backup_rams.get(task_id))
             .or_else(|| self.update_ram_from_file(task_id))
     }
 
     /// Clears memory cache entries not associated with running tasks.
     pub fn clear_memory_cache(&self, running_tasks: &HashSet<TaskId>) {
-        let ram_keys = self
-            .rams
-            .lock()
-            .unwrap()
-            .keys()
-            .cloned()
-            .collect::<Vec<_>>();
-        let key_to_remove = ram_keys
-            .into_iter()
-            .filter(|task_id| !running_tasks.contains(task_id))
-            .collect::<Vec<_>>();
-        let mut rams_to_remove = Vec::with_capacity(key_to_remove.len());
-        // Do not delete the data of Arc during the time when the lock is held to reduce the time when the lock is held
-        {
-            let mut rams = self.rams.lock().unwrap();
-            for key in key_to_remove {
-                rams_to_remove.push(rams.remove(&key));
+        // Entries are dropped one by one outside of the shard locks
+        for key in self.rams.keys() {
+            if !running_tasks.contains(&key) {
+                self.rams.remove(&key);
+            }
+        }
+    }
+
+    /// Trims the RAM cache under memory pressure.
+    ///
+    /// Entries are evicted in the order of the RAM cache policy, least
+    /// recently used first by default, until the RAM cache uses at most the
+    /// share of its budget kept at `level`. Evicted entries missing from the
+    /// file cache are written to it, so they are still served from disk
+    /// instead of downloaded again. The budget itself is unchanged and the
+    /// cache fills up again once the pressure is gone.
+    ///
+    /// # Parameters
+    /// - `level`: Memory pressure reported by the system
+    ///
+    /// # Returns
+    /// Bytes of the evicted entries, released once they are not in use
+    pub fn trim_memory_cache(&'static self, level: MemoryLevel) -> u64 {
+        let kept = self.ram_handle.total_capacity() / 100 * level.kept_percent();
+        let excess = self.ram_handle.used_capacity().saturating_sub(kept);
+        let mut evicted = 0;
+        while evicted < excess {
+            let Some(cache) = self.rams.pop() else {
+                break;
+            };
+            evicted += cache.weight();
+            let task_id = cache.task_id().clone();
+            let queued = self.backup_rams.contains_key(&task_id);
+            if !queued && !self.files.contains_key(&task_id) {
+                self.update_file_cache(task_id, cache);
             }
         }
+        info!("trim ram cache for {:?}, {} evicted", level, evicted);
+        evicted
     }
 
     /// Clears file cache entries not associated with running tasks.
+    ///
+    /// Waits for queued file cache writes first, so none of them is written
+    /// after the clear.
     pub fn clear_file_cache(&self, running_tasks: &HashSet<TaskId>) {
-        let file_keys = self
-            .files
-            .lock()
-            .unwrap()
-            .keys()
-            .cloned()
-            .collect::<Vec<_>>();
-        let key_to_remove = file_keys
-            .into_iter()
-            .filter(|task_id| !running_tasks.contains(task_id))
-            .collect::<Vec<_>>();
-        let mut files_to_remove = Vec::with_capacity(key_to_remove.len());
-        // Do not delete the data of FileCache during the time when the lock is held to reduce the time when the lock is held
-        {
-            let mut files = self.files.lock().unwrap();
-            for key in key_to_remove {
-                files_to_remove.push(files.remove(&key));
+        self.writer.flush();
+        // Entries are dropped one by one outside of the shard locks
+        for key in self.files.keys() {
+            if !running_tasks.contains(&key) {
+                self.files.remove(&key);
             }
         }
+        PartialCache::remove_all(running_tasks);
     }
 
     /// Attempts to allocate cache space, evicting entries if necessary.
     ///
     /// Tries to apply for the requested cache size, and if insufficient space is available,
     /// evicts the least recently used entries until enough space is freed or all entries
-    /// have been evicted.
+    /// have been evicted. Under `RamCachePolicy::TinyLfu` an entry is only evicted for a
+    /// candidate accessed more often than it.
     ///
     /// # Type Parameters
     /// - `T`: The cache value type, can be either `RamCache` or `FileCache`
     ///
     /// # Parameters
     /// - `handle`: Resource manager controlling the cache capacity
-    /// - `caches`: LRU cache to potentially evict entries from
+    /// - `caches`: Sharded LRU cache to potentially evict entries from
+    /// - `candidate`: Task the space is for, `None` to evict unconditionally
     /// - `size`: Amount of space to allocate in bytes
     ///
     /// # Returns
     /// `true` if allocation succeeded, `false` if insufficient space even after eviction
-    pub(super) fn apply_cache<T>(
-        handle: &Mutex<data::ResourceManager>,
-        caches: &Mutex<LRUCache<TaskId, T>>,
+    pub(super) fn apply_cache<T: Weight>(
+        handle: &data::ResourceManager,
+        caches: &ShardedLru<T>,
+        candidate: Option<&TaskId>,
         size: usize,
     ) -> bool {
+        if let Some(task_id) = candidate {
+            caches.record(task_id);
+        }
         loop {
             if size > MAX_CACHE_SIZE as usize {
                 return false;
             }
-            if handle.lock().unwrap().apply_cache_size(size as u64) {
+            if handle.apply_cache_size(size as u64) {
                 return true;
             };
-            // No cache in caches - eviction failed
-            if caches.lock().unwrap().pop().is_none() {
+            let evicted = match candidate {
+                Some(task_id) => caches.evict_for(task_id),
+                None => caches.pop(),
+            };
+            // No cache in caches or candidate not admitted - eviction failed
+            if evicted.is_none() {
                 info!("CacheManager release cache failed");
                 return false;
             }
@@ -19,7 +19,7 @@
 
 use crate::data::observer::DirRebuilder;
 use crate::data::{init_history_store_dir, is_history_init, HistoryDir};
-use crate::wrapper::ffi::{NewDirectoryMonitor, StartObserve};
+use crate::wrapper::ffi::ObserveDirectory;
 use cxx::let_cxx_string;
 use std::{path::PathBuf, sync::Arc};
 
@@ -51,29 +51,26 @@ pub fn observe_image_file_delete(path: String) {
 
 /// Starts directory observation for the history directory.
 ///
-/// Spawns a new thread to monitor the history directory for changes using the system's
-/// directory monitoring capabilities. The directory monitor is set up to rebuild the
-/// directory structure when changes are detected.
+/// Registers the history directory with the directory monitor, which watches all
+/// directories on one shared thread. The directory monitor rebuilds the directory
+/// structure when the history directory is deleted.
 ///
 /// # Parameters
 /// - `curr`: Current directory path to monitor
 /// - `history`: History directory manager for handling directory changes
 ///
-/// # Safety
-/// Spawns a background thread that runs indefinitely until the program terminates
-/// or the monitor is stopped externally.
+/// # Notes
+/// The registration is spawned because a rebuilder dropped on failure stops the
+/// observation, which locks the flag the caller holds.
 pub fn start_history_dir_observe(curr: PathBuf, history: Arc<HistoryDir>) {
-    // Use ffrt_spawn for thread creation to ensure proper resource management
     ffrt_rs::ffrt_spawn(move || {
         // Only proceed if a valid image directory path is available
         if let Some(image_dir) = history.dir_path() {
             let_cxx_string!(image_dir = image_dir);
             // Create directory rebuilder to handle directory structure changes
             let rebuilder = Box::new(DirRebuilder::new(curr, history));
-            let mut monitor = NewDirectoryMonitor(&image_dir, rebuilder);
-            // Start observation if the monitor was successfully created
-            if let Some(ptr) = monitor.as_mut() {
-                StartObserve(ptr);
+            if !ObserveDirectory(&image_dir, rebuilder) {
+                error!("observe history dir failed");
             }
         }
     });
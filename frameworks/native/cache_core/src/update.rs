@@ -22,8 +22,9 @@ use std::sync::Arc;
 
 use request_utils::task_id::TaskId;
 
-use crate::data::RamCache;
+use crate::data::{PartialCache, RamCache, Validators, MAX_CACHE_SIZE, PARTIAL_MIN_SIZE};
 use crate::manage::CacheManager;
+use crate::spawn;
 
 // Previous version of Updater struct (commented out)
 // pub(crate) struct Updater {
@@ -65,6 +66,15 @@ pub struct Updater {
     
     /// Reference to the global cache manager
     cache_manager: &'static CacheManager,
+
+    /// Stored prefix of an earlier attempt this download may continue
+    partial: Option<PartialCache>,
+
+    /// Validators of the response being received
+    validators: Option<Validators>,
+
+    /// Cached entry a conditional request asks the server to validate
+    stale: Option<Arc<RamCache>>,
 }
 
 impl Updater {
@@ -84,6 +94,9 @@ impl Updater {
             task_id,
             cache: None,
             cache_manager,
+            partial: None,
+            validators: None,
+            stale: None,
         }
     }
 
@@ -95,8 +108,14 @@ impl Updater {
     /// # Returns
     /// An Arc-wrapped RamCache instance containing the cached data
     pub fn cache_finish(&mut self) -> Arc<RamCache> {
+        self.drop_partial();
         match self.cache.take() {
-            Some(cache) => cache.finish_write(),
+            Some(mut cache) => {
+                if let Some(validators) = self.validators.take() {
+                    cache.set_validators(validators);
+                }
+                cache.finish_write()
+            }
             None => Arc::new(RamCache::new(
                 self.task_id.clone(),
                 self.cache_manager,
@@ -105,6 +124,61 @@ impl Updater {
         }
     }
 
+    /// Sets the cached entry a conditional request of this download asks the
+    /// server to validate, it is kept alive until the download finishes.
+    ///
+    /// # Parameters
+    /// - `cache`: Cached entry the validators were taken from
+    pub fn set_revalidating(&mut self, cache: Arc<RamCache>) {
+        self.stale = Some(cache);
+    }
+
+    /// Finalizes a download the server answered with `304 Not Modified`.
+    ///
+    /// The cached entry is still current, it is fetched again so it becomes
+    /// the most recently used one and nothing is written. An entry evicted in
+    /// the meantime is restored from the one kept by `set_revalidating`.
+    ///
+    /// # Returns
+    /// The cached entry, or an empty cache like `cache_finish` if no entry
+    /// was being revalidated
+    pub fn cache_revalidated(&mut self) -> Arc<RamCache> {
+        let Some(stale) = self.stale.take() else {
+            error!("{} not modified without cache", self.task_id.brief());
+            return self.cache_finish();
+        };
+        self.drop_partial();
+        self.cache.take();
+        info!("{} cache revalidated", self.task_id.brief());
+        match self.cache_manager.fetch(&self.task_id) {
+            Some(cache) => cache,
+            None => {
+                self.cache_manager.update_ram_cache(stale.clone());
+                stale
+            }
+        }
+    }
+
+    /// Sets the validators of the response, stored with the cache once the
+    /// download finishes.
+    ///
+    /// # Parameters
+    /// - `validators`: `ETag` and `Last-Modified` values of the response
+    pub fn set_validators(&mut self, validators: Validators) {
+        self.validators = Some(validators);
+    }
+
+    /// Sets how long the download took, kept with the cache as its re-fetch
+    /// cost for `RamCachePolicy::GreedyDualSize`.
+    ///
+    /// # Parameters
+    /// - `millis`: Download time in milliseconds
+    pub fn set_cost(&mut self, millis: u64) {
+        if let Some(cache) = self.cache.as_mut() {
+            cache.set_cost(millis);
+        }
+    }
+
     /// Receives and caches a chunk of data.
     ///
     /// Initializes the cache if it doesn't exist yet, using the provided content length
@@ -134,11 +208,93 @@ impl Updater {
         };
     }
 
+    /// Returns the data received so far, in order.
+    ///
+    /// # Returns
+    /// The chunks of the RAM cache being written, empty before the first write
+    pub fn received(&self) -> impl Iterator<Item = &[u8]> {
+        self.cache.iter().flat_map(|cache| cache.chunks())
+    }
+
+    /// Sets the stored prefix this download asks the server to continue.
+    ///
+    /// # Parameters
+    /// - `partial`: Prefix stored by an earlier, interrupted download
+    pub fn set_partial(&mut self, partial: PartialCache) {
+        self.partial = Some(partial);
+    }
+
+    /// Returns the size of the stored prefix this download may continue.
+    pub fn partial_size(&self) -> Option<u64> {
+        self.partial.as_ref().map(PartialCache::size)
+    }
+
+    /// Starts the cache with the stored prefix, for a response that continues it.
+    ///
+    /// # Parameters
+    /// - `content_length`: Length of the remaining body, if known
+    ///
+    /// # Returns
+    /// `false` if there is no prefix or it could not be read, the prefix is
+    /// then dropped
+    pub fn cache_resume(&mut self, content_length: Option<usize>) -> bool {
+        let Some(partial) = self.partial.as_ref() else {
+            return false;
+        };
+        let size = content_length.map(|len| len + partial.size() as usize);
+        let mut cache = RamCache::new(self.task_id.clone(), self.cache_manager, size);
+        match partial.load(&mut cache) {
+            Ok(()) => {
+                info!("{} resume from {}", self.task_id.brief(), partial.size());
+                self.cache = Some(cache);
+                true
+            }
+            Err(e) => {
+                error!("{} load partial failed {}", self.task_id.brief(), e);
+                self.drop_partial();
+                false
+            }
+        }
+    }
+
+    /// Removes the stored prefix, if any.
+    ///
+    /// Called once the prefix is no longer useful, e.g. when the server sent
+    /// the whole body again.
+    pub fn drop_partial(&mut self) {
+        if self.partial.take().is_some() {
+            PartialCache::remove(&self.task_id);
+        }
+    }
+
+    /// Stores the data received so far so a later download can continue it.
+    ///
+    /// Prefixes smaller than `PARTIAL_MIN_SIZE` or larger than a cacheable body
+    /// are dropped. The file is written in the background.
+    ///
+    /// # Parameters
+    /// - `validator`: `ETag` or `Last-Modified` value of the response
+    pub fn cache_partial(&mut self, validator: String) {
+        self.partial = None;
+        let Some(cache) = self.cache.take() else {
+            return;
+        };
+        if cache.size() < PARTIAL_MIN_SIZE || cache.size() > MAX_CACHE_SIZE as usize {
+            return;
+        }
+        let task_id = self.task_id.clone();
+        spawn(move || match PartialCache::save(&task_id, &cache, &validator) {
+            Ok(()) => info!("{} partial {} saved", task_id.brief(), cache.size()),
+            Err(e) => error!("{} save partial failed {}", task_id.brief(), e),
+        });
+    }
+
     /// Resets the cache, releasing its resources.
     ///
     /// Takes ownership of the current cache if it contains data, effectively
     /// clearing it and releasing associated resources.
     pub fn reset_cache(&mut self) {
+        self.validators = None;
         let size = self.cache.as_ref().map(|a| a.size()).unwrap_or(0);
         if size != 0 {
             info!("reset {} cache size {}", self.task_id.brief(), size);
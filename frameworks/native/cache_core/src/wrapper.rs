@@ -41,39 +41,17 @@ pub(crate) mod ffi {
         include!("inotify_event_listener.h");
         include!("native_ffi.h");
         
-        /// C++ directory monitor type for observing file system events.
+        /// Watches a directory on the thread shared by all watched directories.
         ///
-        /// Provides native directory monitoring capabilities through C++ implementation.
-        type DirectoryMonitor;
-
-        /// Creates a new directory monitor with the specified target and callback.
-        ///
-        /// # Safety
-        ///
-        /// This function is marked unsafe because it interfaces with C++ code and
-        /// manages raw pointers internally. Proper lifetime management of the callback
-        /// is required.
+        /// The rebuilder is called once the directory is deleted or moved and
+        /// then dropped. Rebuilds of a directory are rate limited.
         ///
         /// # Parameters
         /// - `target`: Path to the directory to monitor
         /// - `callback`: Rebuilder instance to handle directory events
         ///
         /// # Returns
-        /// A unique pointer to the created DirectoryMonitor instance
-        fn NewDirectoryMonitor(
-            target: &CxxString,
-            callback: Box<DirRebuilder>,
-        ) -> UniquePtr<DirectoryMonitor>;
-        
-        /// Starts monitoring the directory for changes.
-        ///
-        /// # Safety
-        ///
-        /// This function is marked unsafe because it calls into C++ code that may
-        /// have side effects or thread safety considerations.
-        ///
-        /// # Parameters
-        /// - `monitor`: Pin reference to the directory monitor instance
-        fn StartObserve(monitor: Pin<&mut DirectoryMonitor>);
+        /// `true` if the directory is watched, otherwise the rebuilder is dropped
+        fn ObserveDirectory(target: &CxxString, callback: Box<DirRebuilder>) -> bool;
     }
 }
@@ -0,0 +1,92 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use std::io::Write;
+use std::sync::LazyLock;
+
+use request_utils::fastrand::fast_random;
+use request_utils::test::log::init;
+
+use super::*;
+use crate::manage::CacheManager;
+
+const TEST_SIZE: usize = 16;
+
+fn body(manager: &'static CacheManager) -> Arc<RamCache> {
+    let task_id = TaskId::new(fast_random().to_string());
+    let mut cache = RamCache::new(task_id, manager, Some(TEST_SIZE));
+    cache.write_all(&[b'a'; TEST_SIZE]).unwrap();
+    Arc::new(cache)
+}
+
+// @tc.name: ut_backup_weak
+// @tc.desc: Test that the index does not keep bodies alive
+// @tc.precon: NA
+// @tc.step: 1. Index a body and read it
+//           2. Drop the body
+// @tc.expect: The body is read while alive, then it is no longer indexed
+//             and its RAM is released
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_backup_weak() {
+    init();
+    static CACHE_MANAGER: LazyLock<CacheManager> = LazyLock::new(CacheManager::new);
+    let backups = BackupRams::new();
+    let cache = body(&CACHE_MANAGER);
+    let task_id = cache.task_id().clone();
+    backups.insert(task_id.clone(), &cache);
+    assert!(Arc::ptr_eq(&backups.get(&task_id).unwrap(), &cache));
+    assert_eq!(backups.usage(), (1, TEST_SIZE as u64));
+
+    drop(cache);
+    assert!(!backups.contains_key(&task_id));
+    assert_eq!(backups.usage(), (0, 0));
+    assert_eq!(CACHE_MANAGER.ram_handle.used_capacity(), 0);
+}
+
+// @tc.name: ut_backup_bounded
+// @tc.desc: Test the bound of the index and the removal of written bodies
+// @tc.precon: NA
+// @tc.step: 1. Index one body more than MAX_BACKUPS
+//           2. Remove a body written after a newer one was indexed
+// @tc.expect: The oldest body is no longer indexed, the newer body of a
+//             task stays indexed
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_backup_bounded() {
+    init();
+    static CACHE_MANAGER: LazyLock<CacheManager> = LazyLock::new(CacheManager::new);
+    CACHE_MANAGER.set_ram_cache_size(((MAX_BACKUPS + 2) * TEST_SIZE) as u64);
+    let backups = BackupRams::new();
+    let caches = (0..=MAX_BACKUPS)
+        .map(|_| body(&CACHE_MANAGER))
+        .collect::<Vec<_>>();
+    for cache in caches.iter() {
+        backups.insert(cache.task_id().clone(), cache);
+    }
+    assert!(!backups.contains_key(caches[0].task_id()));
+    assert!(backups.contains_key(caches[MAX_BACKUPS].task_id()));
+    assert_eq!(backups.usage().0, MAX_BACKUPS);
+
+    let task_id = caches[1].task_id().clone();
+    let newer = body(&CACHE_MANAGER);
+    backups.insert(task_id.clone(), &newer);
+    backups.remove_written(&task_id, &caches[1]);
+    assert!(Arc::ptr_eq(&backups.get(&task_id).unwrap(), &newer));
+    backups.remove_written(&task_id, &newer);
+    assert!(!backups.contains_key(&task_id));
+}
@@ -0,0 +1,114 @@
+// Copyright (C) 2024 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+use std::io::Write;
+use std::sync::{Arc, LazyLock};
+
+use request_utils::fastrand::fast_random;
+use request_utils::task_id::TaskId;
+use request_utils::test::log::init;
+
+use super::*;
+use crate::data::RamCache;
+use crate::CacheManager;
+
+fn test_bytes(size: usize) -> Vec<u8> {
+    (0..size).map(|i| (i % 251) as u8).collect()
+}
+
+// @tc.name: ut_chunk_pool_reuse
+// @tc.desc: Test that freed chunks are handed out again
+// @tc.precon: NA
+// @tc.step: 1. Allocate a chunk, fill and free it
+//           2. Free a buffer of another capacity
+//           3. Allocate a chunk again
+// @tc.expect: Allocated chunks are empty with CHUNK_SIZE capacity and foreign
+// buffers are not pooled
+// @tc.type: FUNC
+// @tc.require: issue#ICN31I
+// @tc.level: level1
+#[test]
+fn ut_chunk_pool_reuse() {
+    let mut chunk = alloc_chunk();
+    assert!(chunk.is_empty());
+    assert_eq!(chunk.capacity(), CHUNK_SIZE);
+    chunk.extend_from_slice(&[1; 16]);
+    free_chunk(chunk);
+    free_chunk(Vec::with_capacity(16));
+
+    let chunk = alloc_chunk();
+    assert!(chunk.is_empty());
+    assert_eq!(chunk.capacity(), CHUNK_SIZE);
+    assert!(POOL
+        .lock()
+        .unwrap()
+        .iter()
+        .all(|chunk| chunk.capacity() == CHUNK_SIZE));
+}
+
+// @tc.name: ut_chunk_ram_cache_unknown_size
+// @tc.desc: Test that a RamCache of unknown size is stored in chunks
+// @tc.precon: NA
+// @tc.step: 1. Write several chunks of data to a RamCache without size hint
+//           2. Read it back by chunks and contiguously
+// @tc.expect: Data is split at CHUNK_SIZE boundaries and both views equal the
+// written bytes
+// @tc.type: FUNC
+// @tc.require: issue#ICN31I
+// @tc.level: level1
+#[test]
+fn ut_chunk_ram_cache_unknown_size() {
+    init();
+    static CACHE_MANAGER: LazyLock<CacheManager> = LazyLock::new(CacheManager::new);
+
+    let bytes = test_bytes(CHUNK_SIZE * 2 + 100);
+    let mut ram_cache = RamCache::new(TaskId::new(fast_random().to_string()), &CACHE_MANAGER, None);
+    for part in bytes.chunks(1000) {
+        ram_cache.write_all(part).unwrap();
+    }
+    assert_eq!(ram_cache.size(), bytes.len());
+
+    let sizes: Vec<usize> = ram_cache.chunks().map(|chunk| chunk.len()).collect();
+    assert_eq!(sizes, vec![CHUNK_SIZE, CHUNK_SIZE, 100]);
+    assert_eq!(ram_cache.chunks().collect::<Vec<_>>().concat(), bytes);
+    assert_eq!(ram_cache.bytes(), bytes.as_slice());
+}
+
+// @tc.name: ut_chunk_ram_cache_known_size
+// @tc.desc: Test that a RamCache of known size uses a single exact chunk
+// @tc.precon: NA
+// @tc.step: 1. Write data to a RamCache created with its exact size
+//           2. Finish the write and read the data back
+// @tc.expect: The data is held in one chunk and no copy is needed to read it
+// @tc.type: FUNC
+// @tc.require: issue#ICN31I
+// @tc.level: level1
+#[test]
+fn ut_chunk_ram_cache_known_size() {
+    init();
+    static CACHE_MANAGER: LazyLock<CacheManager> = LazyLock::new(CacheManager::new);
+
+    let bytes = test_bytes(CHUNK_SIZE * 3);
+    let mut ram_cache = RamCache::new(
+        TaskId::new(fast_random().to_string()),
+        &CACHE_MANAGER,
+        Some(bytes.len()),
+    );
+    ram_cache.write_all(&bytes).unwrap();
+    let ram_cache: Arc<RamCache> = ram_cache.finish_write();
+
+    assert_eq!(ram_cache.chunks().count(), 1);
+    assert_eq!(ram_cache.bytes().as_ptr(), ram_cache.chunks().next().unwrap().as_ptr());
+    assert_eq!(ram_cache.bytes(), bytes.as_slice());
+}
@@ -56,11 +56,7 @@ fn ut_cache_file_create() {
         ram_cache.write_all(TEST_STRING.as_bytes()).unwrap();
         let file_cache =
             FileCache::try_create(task_id.clone(), &CACHE_MANAGER, Arc::new(ram_cache)).unwrap();
-        CACHE_MANAGER
-            .files
-            .lock()
-            .unwrap()
-            .insert(task_id, file_cache);
+        CACHE_MANAGER.files.insert(task_id, file_cache);
     }
 }
 
@@ -124,11 +120,11 @@ fn ut_cache_file_drop() {
     let file_cache =
         FileCache::try_create(task_id.clone(), &CACHE_MANAGER, Arc::new(ram_cache)).unwrap();
     assert_eq!(
-        CACHE_MANAGER.file_handle.lock().unwrap().used_capacity,
+        CACHE_MANAGER.file_handle.used_capacity(),
         TEST_STRING_SIZE as u64
     );
     drop(file_cache);
-    assert_eq!(CACHE_MANAGER.file_handle.lock().unwrap().used_capacity, 0);
+    assert_eq!(CACHE_MANAGER.file_handle.used_capacity(), 0);
 }
 
 // @tc.name: ut_cache_file_content
@@ -223,11 +219,7 @@ fn ut_cache_file_update_ram_from_file() {
     ram_cache.write_all(TEST_STRING.as_bytes()).unwrap();
     let file_cache =
         FileCache::try_create(task_id.clone(), &CACHE_MANAGER, Arc::new(ram_cache)).unwrap();
-    CACHE_MANAGER
-        .files
-        .lock()
-        .unwrap()
-        .insert(task_id.clone(), file_cache);
+    CACHE_MANAGER.files.insert(task_id.clone(), file_cache);
 
     let mut v = vec![];
     for _ in 0..1000 {
@@ -243,3 +235,102 @@ fn ut_cache_file_update_ram_from_file() {
         assert!(j.join().unwrap());
     }
 }
+
+// @tc.name: ut_cache_file_orphan_files
+// @tc.desc: Test listing the files of a cache directory not in the index
+// @tc.precon: NA
+// @tc.step: 1. Create bodies, validators, a partial body, the journal and a
+//              leftover file in a test directory
+//           2. Call orphan_files with one live task and different ages
+// @tc.expect: Only old files of tasks not live and leftovers are listed
+// @tc.type: FUNC
+// @tc.require: issue#ICN31I
+// @tc.level: level1
+#[test]
+fn ut_cache_file_orphan_files() {
+    init();
+    const TEST_DIR: &str = "orphan_test";
+
+    init_curr_store_dir();
+    let path = unsafe { FILE_STORE_DIR.join(String::from(TEST_DIR)).unwrap() };
+    fs::create_dir_all(&path).unwrap();
+    let names = [
+        format!("live{}", FINISH_SUFFIX),
+        format!("live{}", VALIDATOR_SUFFIX),
+        format!("gone{}", FINISH_SUFFIX),
+        format!("gone{}", VALIDATOR_SUFFIX),
+        format!("gone{}", PARTIAL_SUFFIX),
+        JOURNAL_NAME.to_string(),
+        "leftover".to_string(),
+    ];
+    for name in names.iter() {
+        fs::File::create(path.join(name)).unwrap();
+    }
+    let live = |task_id: &TaskId| task_id.to_string() == "live";
+
+    let later = SystemTime::now() + Duration::from_secs(1);
+    let mut orphans = orphan_files(path.as_path(), live, later)
+        .into_iter()
+        .map(|orphan| orphan.file_name().unwrap().to_str().unwrap().to_string())
+        .collect::<Vec<_>>();
+    orphans.sort();
+    let mut expected = vec![names[2].clone(), names[3].clone(), names[6].clone()];
+    expected.sort();
+    assert_eq!(orphans, expected);
+
+    // Files modified after the cutoff may still be written
+    assert!(orphan_files(path.as_path(), live, SystemTime::UNIX_EPOCH).is_empty());
+    fs::remove_dir_all(&path).unwrap();
+}
+
+// @tc.name: ut_cache_file_crc_check
+// @tc.desc: Test that file caches are checked against their CRC-32C
+// @tc.precon: NA
+// @tc.step: 1. Store three file caches and mark them not verified
+//           2. Change a byte of two of the files
+//           3. Load the first changed one into RAM
+//           4. Check the file caches in the background pass
+// @tc.expect: The changed files are discarded, the intact one is verified
+// and still served
+// @tc.type: FUNC
+// @tc.require: issue#ICN31I
+// @tc.level: level1
+#[test]
+fn ut_cache_file_crc_check() {
+    init();
+    static CACHE_MANAGER: LazyLock<CacheManager> = LazyLock::new(CacheManager::new);
+    CACHE_MANAGER.set_file_cache_size(TEST_SIZE);
+
+    init_curr_store_dir();
+    let mut task_ids = vec![];
+    for _ in 0..3 {
+        let task_id = TaskId::new(fast_random().to_string());
+        let mut ram_cache = RamCache::new(task_id.clone(), &CACHE_MANAGER, Some(TEST_STRING_SIZE));
+        ram_cache.write_all(TEST_STRING.as_bytes()).unwrap();
+        let file_cache =
+            FileCache::try_create(task_id.clone(), &CACHE_MANAGER, Arc::new(ram_cache)).unwrap();
+        assert!(file_cache.pending_check().is_none());
+        file_cache.verified.store(false, Ordering::Release);
+        CACHE_MANAGER.files.insert(task_id.clone(), file_cache);
+        task_ids.push(task_id);
+    }
+    for task_id in task_ids[1..].iter() {
+        let path = FileCache::path(task_id).unwrap();
+        let mut content = fs::read(&path).unwrap();
+        content[0] ^= 1;
+        fs::write(&path, content).unwrap();
+    }
+
+    assert!(CACHE_MANAGER.update_ram_from_file(&task_ids[1]).is_none());
+    assert!(!CACHE_MANAGER.files.contains_key(&task_ids[1]));
+    assert!(fs::metadata(FileCache::path(&task_ids[1]).unwrap()).is_err());
+
+    CACHE_MANAGER.check_file_caches(0);
+    assert!(!CACHE_MANAGER.files.contains_key(&task_ids[2]));
+    let check = CACHE_MANAGER
+        .files
+        .get(&task_ids[0], |file| file.pending_check().is_none());
+    assert_eq!(check, Some(true));
+    let cache = CACHE_MANAGER.update_ram_from_file(&task_ids[0]).unwrap();
+    assert_eq!(cache.bytes(), TEST_STRING.as_bytes());
+}
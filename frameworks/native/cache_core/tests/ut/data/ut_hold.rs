@@ -0,0 +1,73 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use super::*;
+
+// @tc.name: ut_lock_holds_stats
+// @tc.desc: Test the summary of the recorded hold times
+// @tc.precon: NA
+// @tc.step: 1. Record 99 holds of 100 ns and one of 10000 ns
+//           2. Read the stats, reset and read them again
+// @tc.expect: The percentiles are the bounds of their buckets capped by the
+// longest hold, and the stats are empty after the reset
+// @tc.type: FUNC
+// @tc.require: issue#ICN31I
+// @tc.level: level1
+#[test]
+fn ut_lock_holds_stats() {
+    let holds = LockHolds::new();
+    assert_eq!(holds.stats(), LockHoldStats::default());
+    for _ in 0..99 {
+        holds.record(100);
+    }
+    holds.record(10000);
+    let stats = holds.stats();
+    assert_eq!(stats.count, 100);
+    assert_eq!(stats.mean_ns, 199.0);
+    assert_eq!(stats.p50_ns, 127);
+    assert_eq!(stats.p99_ns, 127);
+    assert_eq!(stats.max_ns, 10000);
+
+    holds.record(0);
+    assert_eq!(holds.stats().count, 101);
+    holds.reset();
+    assert_eq!(holds.stats(), LockHoldStats::default());
+}
+
+// @tc.name: ut_lock_holds_guard
+// @tc.desc: Test that a held guard is timed until it is dropped
+// @tc.precon: NA
+// @tc.step: 1. Lock a mutex through Held and sleep while holding it
+//           2. Drop the guard
+// @tc.expect: One hold of at least the time slept is recorded
+// @tc.type: FUNC
+// @tc.require: issue#ICN31I
+// @tc.level: level1
+#[test]
+fn ut_lock_holds_guard() {
+    use std::sync::Mutex;
+    use std::time::Duration;
+
+    let holds = LockHolds::new();
+    let mutex = Mutex::new(0);
+    {
+        let mut held = Held::new(mutex.lock().unwrap(), &holds);
+        *held += 1;
+        std::thread::sleep(Duration::from_millis(1));
+        assert_eq!(holds.stats().count, 0);
+    }
+    assert_eq!(*mutex.lock().unwrap(), 1);
+    let stats = holds.stats();
+    assert_eq!(stats.count, 1);
+    assert!(stats.max_ns >= 1_000_000);
+}
@@ -0,0 +1,120 @@
+// Copyright (C) 2024 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use request_utils::fastrand::fast_random;
+use request_utils::test::log::init;
+
+use super::*;
+use crate::data::init_curr_store_dir;
+
+const TEST_LAST_MODIFIED: &str = "Wed, 21 Oct 2015 07:28:00 GMT";
+
+fn test_journal() -> Journal {
+    init();
+    init_curr_store_dir();
+    Journal::with_name(&format!("{}_{}", JOURNAL_NAME, fast_random()))
+}
+
+fn entry(size: u64, accessed: u64) -> JournalEntry {
+    JournalEntry {
+        task_id: TaskId::new(fast_random().to_string()),
+        size,
+        accessed,
+        validators: Validators::default(),
+        crc: None,
+    }
+}
+
+// @tc.name: ut_journal_load
+// @tc.desc: Test restoring entries from the records of a journal
+// @tc.precon: NA
+// @tc.step: 1. Add three entries, read the first one and remove the second
+//           2. Load the journal
+//           3. Rewrite the journal with the loaded entries and load it again
+// @tc.expect: The remaining entries are loaded least recently accessed first
+// with their validators and CRC, and a rewrite keeps them
+// @tc.type: FUNC
+// @tc.require: issue#ICN31I
+// @tc.level: level1
+#[test]
+fn ut_journal_load() {
+    let journal = test_journal();
+    let mut first = entry(10, 100);
+    first.validators.last_modified = Some(TEST_LAST_MODIFIED.to_string());
+    first.crc = Some(0x0a1b_2c3d);
+    let second = entry(20, 101);
+    let third = entry(30, 102);
+    journal.add(&first);
+    journal.add(&second);
+    journal.add(&third);
+    journal.touch(&first.task_id, 103);
+    journal.remove(&second.task_id);
+
+    first.accessed = 103;
+    let expected = vec![third, first];
+    assert!(journal.load().unwrap() == expected);
+    assert!(!journal.needs_compaction(|| expected.len()));
+
+    journal.rewrite(|| expected.clone()).unwrap();
+    assert!(journal.load().unwrap() == expected);
+    fs::remove_file(journal.path("").unwrap()).unwrap();
+}
+
+// @tc.name: ut_journal_corrupted
+// @tc.desc: Test that a damaged or missing journal is rejected
+// @tc.precon: NA
+// @tc.step: 1. Load a journal that does not exist
+//           2. Add an entry and change one byte of its record
+//           3. Load the journal
+// @tc.expect: Both loads fail so the caller scans the directory instead
+// @tc.type: FUNC
+// @tc.require: issue#ICN31I
+// @tc.level: level1
+#[test]
+fn ut_journal_corrupted() {
+    let journal = test_journal();
+    assert_eq!(
+        journal.load().unwrap_err().kind(),
+        io::ErrorKind::NotFound
+    );
+
+    journal.add(&entry(10, 100));
+    let path = journal.path("").unwrap();
+    let content = fs::read_to_string(&path).unwrap().replacen("\t10\t", "\t11\t", 1);
+    fs::write(&path, content).unwrap();
+    assert_eq!(
+        journal.load().unwrap_err().kind(),
+        io::ErrorKind::InvalidData
+    );
+    fs::remove_file(path).unwrap();
+}
+
+// @tc.name: ut_journal_without_crc
+// @tc.desc: Test restoring the records of a journal written without CRC
+// @tc.precon: NA
+// @tc.step: 1. Write an add record in the format without the CRC field
+//           2. Load the journal
+// @tc.expect: The entry is loaded with an unknown CRC
+// @tc.type: FUNC
+// @tc.require: issue#ICN31I
+// @tc.level: level1
+#[test]
+fn ut_journal_without_crc() {
+    let journal = test_journal();
+    let expected = entry(10, 100);
+    let path = journal.path("").unwrap();
+    let record = format!("A\t{}\t10\t100\t\t", expected.task_id);
+    fs::write(&path, line(&record)).unwrap();
+    assert!(journal.load().unwrap() == vec![expected]);
+    fs::remove_file(path).unwrap();
+}
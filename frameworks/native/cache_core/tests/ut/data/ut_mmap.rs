@@ -0,0 +1,92 @@
+// Copyright (C) 2024 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use std::io::Write;
+use std::sync::LazyLock;
+
+use request_utils::fastrand::fast_random;
+use request_utils::task_id::TaskId;
+use request_utils::test::log::init;
+
+use super::*;
+use crate::data::{init_curr_store_dir, FileCache};
+use crate::CacheManager;
+
+const TEST_FILE_SIZE: usize = MMAP_MIN_SIZE as usize * 2;
+
+fn test_bytes(size: usize) -> Vec<u8> {
+    (0..size).map(|i| (i % 251) as u8).collect()
+}
+
+// @tc.name: ut_mmap_fetch_large_file
+// @tc.desc: Test that large file caches are fetched as mappings
+// @tc.precon: NA
+// @tc.step: 1. Create a file cache larger than MMAP_MIN_SIZE
+//           2. Fetch it with fetch_data
+//           3. Remove the cache while the mapping is alive
+// @tc.expect: The mapped bytes equal the written ones, no RAM is applied and
+// the mapping stays readable after the cache file is removed
+// @tc.type: FUNC
+// @tc.require: issue#ICN31I
+// @tc.level: level1
+#[test]
+fn ut_mmap_fetch_large_file() {
+    init();
+    static CACHE_MANAGER: LazyLock<CacheManager> = LazyLock::new(CacheManager::new);
+    init_curr_store_dir();
+
+    let bytes = test_bytes(TEST_FILE_SIZE);
+    let task_id = TaskId::new(fast_random().to_string());
+    let mut ram_cache = RamCache::new(task_id.clone(), &CACHE_MANAGER, Some(bytes.len()));
+    ram_cache.write_all(&bytes).unwrap();
+    let file_cache =
+        FileCache::try_create(task_id.clone(), &CACHE_MANAGER, Arc::new(ram_cache)).unwrap();
+    CACHE_MANAGER.files.insert(task_id.clone(), file_cache);
+
+    let data = CACHE_MANAGER.fetch_data(&task_id).unwrap();
+    assert!(matches!(data, CacheData::Mapped(_)));
+    assert_eq!(data.size(), bytes.len());
+    assert_eq!(CACHE_MANAGER.ram_handle.used_capacity(), 0);
+    assert!(!CACHE_MANAGER.rams.contains_key(&task_id));
+
+    CACHE_MANAGER.remove(task_id);
+    assert_eq!(data.bytes(), bytes.as_slice());
+}
+
+// @tc.name: ut_mmap_fetch_small_file
+// @tc.desc: Test that small file caches are still loaded into RAM
+// @tc.precon: NA
+// @tc.step: 1. Create a file cache smaller than MMAP_MIN_SIZE
+//           2. Fetch it with fetch_data
+// @tc.expect: The content is returned from a RamCache with the written bytes
+// @tc.type: FUNC
+// @tc.require: issue#ICN31I
+// @tc.level: level1
+#[test]
+fn ut_mmap_fetch_small_file() {
+    init();
+    static CACHE_MANAGER: LazyLock<CacheManager> = LazyLock::new(CacheManager::new);
+    init_curr_store_dir();
+
+    let bytes = test_bytes(1024);
+    let task_id = TaskId::new(fast_random().to_string());
+    let mut ram_cache = RamCache::new(task_id.clone(), &CACHE_MANAGER, Some(bytes.len()));
+    ram_cache.write_all(&bytes).unwrap();
+    let file_cache =
+        FileCache::try_create(task_id.clone(), &CACHE_MANAGER, Arc::new(ram_cache)).unwrap();
+    CACHE_MANAGER.files.insert(task_id.clone(), file_cache);
+
+    let data = CACHE_MANAGER.fetch_data(&task_id).unwrap();
+    assert!(matches!(data, CacheData::Ram(_)));
+    assert_eq!(data.bytes(), bytes.as_slice());
+}
@@ -0,0 +1,98 @@
+// Copyright (C) 2024 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+use std::io::Write;
+use std::sync::LazyLock;
+
+use request_utils::fastrand::fast_random;
+use request_utils::test::log::init;
+
+use super::*;
+use crate::data::{init_curr_store_dir, PARTIAL_MIN_SIZE};
+use crate::{CacheManager, Updater};
+
+const TEST_VALIDATOR: &str = "\"5d8c72a5edda8\"";
+
+fn test_bytes(size: usize) -> Vec<u8> {
+    (0..size).map(|i| (i % 251) as u8).collect()
+}
+
+// @tc.name: ut_partial_save_open_load
+// @tc.desc: Test storing and reading back a partial body
+// @tc.precon: NA
+// @tc.step: 1. Save a RamCache as the partial body of a task
+//           2. Open it and load it into a new RamCache
+//           3. Remove it
+// @tc.expect: Size, validator and bytes are restored and the partial body is
+// gone after removal
+// @tc.type: FUNC
+// @tc.require: issue#ICN31I
+// @tc.level: level1
+#[test]
+fn ut_partial_save_open_load() {
+    init();
+    static CACHE_MANAGER: LazyLock<CacheManager> = LazyLock::new(CacheManager::new);
+    init_curr_store_dir();
+
+    let bytes = test_bytes(PARTIAL_MIN_SIZE + 100);
+    let task_id = TaskId::new(fast_random().to_string());
+    let mut cache = RamCache::new(task_id.clone(), &CACHE_MANAGER, None);
+    cache.write_all(&bytes).unwrap();
+    PartialCache::save(&task_id, &cache, TEST_VALIDATOR).unwrap();
+
+    let partial = PartialCache::open(&task_id).unwrap();
+    assert_eq!(partial.size(), bytes.len() as u64);
+    assert_eq!(partial.validator(), TEST_VALIDATOR);
+    let mut loaded = RamCache::new(task_id.clone(), &CACHE_MANAGER, None);
+    partial.load(&mut loaded).unwrap();
+    assert_eq!(loaded.bytes(), bytes.as_slice());
+
+    PartialCache::remove(&task_id);
+    assert!(PartialCache::open(&task_id).is_none());
+}
+
+// @tc.name: ut_partial_updater_resume
+// @tc.desc: Test continuing a download from its partial body
+// @tc.precon: NA
+// @tc.step: 1. Store a partial body for a task
+//           2. Resume an Updater from it and receive the rest of the body
+//           3. Finish the cache
+// @tc.expect: The finished cache holds prefix and rest in order and the
+// partial body is removed
+// @tc.type: FUNC
+// @tc.require: issue#ICN31I
+// @tc.level: level1
+#[test]
+fn ut_partial_updater_resume() {
+    init();
+    static CACHE_MANAGER: LazyLock<CacheManager> = LazyLock::new(CacheManager::new);
+    init_curr_store_dir();
+
+    let bytes = test_bytes(PARTIAL_MIN_SIZE * 2);
+    let (prefix, rest) = bytes.split_at(PARTIAL_MIN_SIZE);
+    let task_id = TaskId::new(fast_random().to_string());
+    let mut cache = RamCache::new(task_id.clone(), &CACHE_MANAGER, None);
+    cache.write_all(prefix).unwrap();
+    PartialCache::save(&task_id, &cache, TEST_VALIDATOR).unwrap();
+
+    let mut updater = Updater::new(task_id.clone(), &CACHE_MANAGER);
+    updater.set_partial(PartialCache::open(&task_id).unwrap());
+    assert_eq!(updater.partial_size(), Some(prefix.len() as u64));
+    assert!(updater.cache_resume(Some(rest.len())));
+    updater.cache_receive(rest, || Some(rest.len()));
+
+    let cache = updater.cache_finish();
+    assert_eq!(cache.bytes(), bytes.as_slice());
+    assert!(PartialCache::open(&task_id).is_none());
+}
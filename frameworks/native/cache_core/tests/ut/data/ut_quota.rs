@@ -0,0 +1,56 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use super::*;
+
+const MB: u64 = 1024 * 1024;
+
+// @tc.name: ut_quota_adaptive_size
+// @tc.desc: Test the file cache size for the free space of its disk
+// @tc.precon: NA
+// @tc.step: 1. Size caches on disks with much, some and no free space
+//           2. Create bounds with a maximum below the minimum
+// @tc.expect: The share of the free and used space is taken within the
+//             bounds, the maximum is raised to the minimum
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_quota_adaptive_size() {
+    let adaptive = AdaptiveSize::new(10, 50 * MB, 500 * MB);
+    assert_eq!(adaptive.size(100_000 * MB, 0), 500 * MB);
+    assert_eq!(adaptive.size(1500 * MB, 500 * MB), 200 * MB);
+    assert_eq!(adaptive.size(0, 100 * MB), 50 * MB);
+    assert_eq!(adaptive.size(u64::MAX, u64::MAX), 500 * MB);
+
+    let adaptive = AdaptiveSize::new(200, 50 * MB, 10 * MB);
+    assert_eq!(adaptive, AdaptiveSize::new(100, 50 * MB, 50 * MB));
+    assert_eq!(adaptive.size(1000 * MB, 0), 50 * MB);
+}
+
+// @tc.name: ut_quota_free_space
+// @tc.desc: Test reading the free space of a disk
+// @tc.precon: NA
+// @tc.step: 1. Read the free space of the directory of the test
+//           2. Read the free space of a missing directory
+// @tc.expect: The free space is read for the directory, the missing one
+//             fails
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_quota_free_space() {
+    let dir = std::env::current_dir().unwrap();
+    assert!(free_space(&dir).unwrap() > 0);
+    assert!(free_space(Path::new("/missing/cache/dir")).is_err());
+}
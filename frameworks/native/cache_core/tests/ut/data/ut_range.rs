@@ -0,0 +1,113 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use std::io::Write;
+use std::sync::LazyLock;
+
+use request_utils::fastrand::fast_random;
+use request_utils::task_id::TaskId;
+use request_utils::test::log::init;
+
+use super::*;
+use crate::data::{init_curr_store_dir, CacheData, FileCache, MMAP_MIN_SIZE};
+use crate::CacheManager;
+
+fn test_bytes(size: usize) -> Vec<u8> {
+    (0..size).map(|i| (i % 251) as u8).collect()
+}
+
+// @tc.name: ut_range_ram_chunks
+// @tc.desc: Test windows of a RAM cache stored in several chunks
+// @tc.precon: NA
+// @tc.step: 1. Write more than two chunks of data to a RamCache of unknown
+//              size
+//           2. Take windows inside a chunk, across chunks and past the end
+// @tc.expect: Each window holds the bytes at its position, a window inside
+// a chunk is not copied and a window past the end is cut
+// @tc.type: FUNC
+// @tc.require: issue#ICN31I
+// @tc.level: level1
+#[test]
+fn ut_range_ram_chunks() {
+    init();
+    static CACHE_MANAGER: LazyLock<CacheManager> = LazyLock::new(CacheManager::new);
+
+    let chunk_size = 64 * 1024;
+    let bytes = test_bytes(chunk_size * 2 + 100);
+    let mut ram_cache = RamCache::new(TaskId::new(fast_random().to_string()), &CACHE_MANAGER, None);
+    ram_cache.write_all(&bytes).unwrap();
+    let ram_cache: Arc<RamCache> = ram_cache.finish_write();
+    assert_eq!(ram_cache.chunks().count(), 3);
+
+    let inside = RamRange::new(ram_cache.clone(), 10, 100);
+    assert_eq!(inside.chunks().count(), 1);
+    assert_eq!(inside.bytes(), &bytes[10..110]);
+    assert_eq!(
+        inside.bytes().as_ptr(),
+        ram_cache.chunks().next().unwrap()[10..].as_ptr()
+    );
+
+    let across = RamRange::new(ram_cache.clone(), chunk_size as u64 - 10, chunk_size as u64);
+    assert_eq!(across.chunks().count(), 2);
+    assert_eq!(across.bytes(), &bytes[chunk_size - 10..chunk_size * 2 - 10]);
+
+    let tail = RamRange::new(ram_cache.clone(), bytes.len() as u64 - 50, 1000);
+    assert_eq!(tail.bytes(), &bytes[bytes.len() - 50..]);
+    let past = RamRange::new(ram_cache, bytes.len() as u64 + 1, 1000);
+    assert_eq!(past.size(), 0);
+    assert_eq!(past.chunks().count(), 0);
+}
+
+// @tc.name: ut_range_fetch_file
+// @tc.desc: Test fetching windows of a file cache
+// @tc.precon: NA
+// @tc.step: 1. Create a file cache larger than twice MMAP_MIN_SIZE
+//           2. Fetch a large window at an unaligned offset and a small one
+//              with fetch_range
+// @tc.expect: The large window is mapped and the small one read, both hold
+// the bytes at their position and nothing is loaded into the RAM cache
+// @tc.type: FUNC
+// @tc.require: issue#ICN31I
+// @tc.level: level1
+#[test]
+fn ut_range_fetch_file() {
+    init();
+    static CACHE_MANAGER: LazyLock<CacheManager> = LazyLock::new(CacheManager::new);
+    init_curr_store_dir();
+
+    let bytes = test_bytes(MMAP_MIN_SIZE as usize * 3);
+    let task_id = TaskId::new(fast_random().to_string());
+    let mut ram_cache = RamCache::new(task_id.clone(), &CACHE_MANAGER, Some(bytes.len()));
+    ram_cache.write_all(&bytes).unwrap();
+    let file_cache =
+        FileCache::try_create(task_id.clone(), &CACHE_MANAGER, Arc::new(ram_cache)).unwrap();
+    CACHE_MANAGER.files.insert(task_id.clone(), file_cache);
+
+    let offset = MMAP_MIN_SIZE as usize + 123;
+    let len = MMAP_MIN_SIZE as usize;
+    let data = CACHE_MANAGER
+        .fetch_range(&task_id, offset as u64, len as u64)
+        .unwrap();
+    assert!(matches!(data, CacheData::Mapped(_)));
+    assert_eq!(data.bytes(), &bytes[offset..offset + len]);
+
+    let data = CACHE_MANAGER.fetch_range(&task_id, 7, 1000).unwrap();
+    assert!(matches!(data, CacheData::Read(_)));
+    assert_eq!(data.bytes(), &bytes[7..1007]);
+
+    assert_eq!(CACHE_MANAGER.ram_handle.used_capacity(), 0);
+    assert!(!CACHE_MANAGER.rams.contains_key(&task_id));
+    assert!(CACHE_MANAGER
+        .fetch_range(&TaskId::new(fast_random().to_string()), 0, 1)
+        .is_none());
+}
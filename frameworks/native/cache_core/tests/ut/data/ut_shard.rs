@@ -0,0 +1,178 @@
+// Copyright (C) 2024 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use super::*;
+
+impl Weight for u64 {
+    fn weight(&self) -> u64 {
+        *self
+    }
+}
+
+fn task_id(i: usize) -> TaskId {
+    TaskId::from_url(&format!("https://example.com/{}", i))
+}
+
+// @tc.name: ut_shard_insert_get_remove
+// @tc.desc: Test basic operations of the sharded LRU
+// @tc.precon: NA
+// @tc.step: 1. Insert entries of many tasks
+//           2. Get, replace and remove some of them
+// @tc.expect: Every operation behaves like a single LRU and shard bytes follow
+// the stored entries
+// @tc.type: FUNC
+// @tc.require: issue#ICN31I
+// @tc.level: level1
+#[test]
+fn ut_shard_insert_get_remove() {
+    let cache = ShardedLru::new();
+    for i in 0..100 {
+        assert!(cache.insert(task_id(i), i as u64).is_none());
+    }
+    assert_eq!(cache.keys().len(), 100);
+    assert_eq!(cache.get(&task_id(7), |v| *v), Some(7));
+    assert_eq!(cache.insert(task_id(7), 70), Some(7));
+    assert_eq!(cache.remove(&task_id(7)), Some(70));
+    assert!(!cache.contains_key(&task_id(7)));
+
+    let bytes: u64 = cache
+        .shards
+        .iter()
+        .map(|shard| shard.bytes.load(Ordering::Acquire))
+        .sum();
+    assert_eq!(bytes, (0..100u64).sum::<u64>() - 7);
+}
+
+// @tc.name: ut_shard_pop_heaviest
+// @tc.desc: Test that eviction starts from the shard holding the most bytes
+// @tc.precon: NA
+// @tc.step: 1. Insert one large entry and many small ones
+//           2. Pop a single entry
+//           3. Pop until the cache is empty
+// @tc.expect: The large entry is evicted first and every entry is evicted once
+// @tc.type: FUNC
+// @tc.require: issue#ICN31I
+// @tc.level: level1
+#[test]
+fn ut_shard_pop_heaviest() {
+    let cache = ShardedLru::new();
+    cache.insert(task_id(0), 1 << 20);
+    for i in 1..50 {
+        cache.insert(task_id(i), 1);
+    }
+    assert_eq!(cache.pop(), Some(1 << 20));
+
+    let mut popped = 1;
+    while cache.pop().is_some() {
+        popped += 1;
+    }
+    assert_eq!(popped, 50);
+    assert!(cache.keys().is_empty());
+}
+
+// @tc.name: ut_shard_tiny_lfu_admission
+// @tc.desc: Test that TinyLFU keeps hot entries against one-time ones
+// @tc.precon: NA
+// @tc.step: 1. Switch to TinyLfu and insert an entry accessed many times
+//           2. Try to evict for a candidate never accessed before
+//           3. Try again once the candidate is accessed more often
+// @tc.expect: The cold candidate is not admitted, the hot one evicts the entry
+// @tc.type: FUNC
+// @tc.require: issue#ICN31I
+// @tc.level: level1
+#[test]
+fn ut_shard_tiny_lfu_admission() {
+    let cache = ShardedLru::new();
+    cache.set_policy(RamCachePolicy::TinyLfu);
+    cache.record(&task_id(0));
+    cache.insert(task_id(0), 1);
+    for _ in 0..5 {
+        assert_eq!(cache.get(&task_id(0), |v| *v), Some(1));
+    }
+
+    cache.record(&task_id(1));
+    assert!(cache.evict_for(&task_id(1)).is_none());
+    assert!(cache.contains_key(&task_id(0)));
+
+    for _ in 0..10 {
+        cache.record(&task_id(1));
+    }
+    assert_eq!(cache.evict_for(&task_id(1)), Some(1));
+    assert!(cache.keys().is_empty());
+}
+
+// @tc.name: ut_shard_slru_segments
+// @tc.desc: Test segmented LRU promotion and switching back to LRU
+// @tc.precon: NA
+// @tc.step: 1. Switch to TinyLfu and insert entries
+//           2. Hit one of them
+//           3. Switch back to Lru
+// @tc.expect: The hit entry moves to protected, entries survive the policy
+// switch in probation and lookups are counted in stats
+// @tc.type: FUNC
+// @tc.require: issue#ICN31I
+// @tc.level: level1
+#[test]
+fn ut_shard_slru_segments() {
+    let cache = ShardedLru::new();
+    cache.set_policy(RamCachePolicy::TinyLfu);
+    for i in 0..10 {
+        cache.insert(task_id(i), 1);
+    }
+    assert_eq!(cache.lookup(&task_id(3), |v| *v), Some(1));
+    assert_eq!(cache.lookup(&task_id(100), |v| *v), None);
+    assert_eq!(cache.stats(), CacheStats { hits: 1, misses: 1 });
+    assert_eq!(cache.stats().hit_ratio(), 0.5);
+
+    let protected = |cache: &ShardedLru<u64>, i: usize| {
+        let (shard, _) = cache.shard(&task_id(i));
+        shard.segments.lock().unwrap().protected.contains_key(&task_id(i))
+    };
+    assert!(protected(&cache, 3));
+    assert!(!protected(&cache, 4));
+
+    cache.set_policy(RamCachePolicy::Lru);
+    assert_eq!(cache.policy(), RamCachePolicy::Lru);
+    assert_eq!(cache.stats(), CacheStats::default());
+    assert!(!protected(&cache, 3));
+    assert_eq!(cache.keys().len(), 10);
+}
+
+// @tc.name: ut_shard_greedy_dual_size
+// @tc.desc: Test GreedyDual-Size eviction by credit
+// @tc.precon: NA
+// @tc.step: 1. Switch to GreedyDualSize and insert one large and small entries
+//           2. Pop entries
+// @tc.expect: The large entry is evicted first, the inflation value rises to
+// its credit and every entry is evicted once
+// @tc.type: FUNC
+// @tc.require: issue#ICN31I
+// @tc.level: level1
+#[test]
+fn ut_shard_greedy_dual_size() {
+    let cache = ShardedLru::new();
+    cache.set_policy(RamCachePolicy::GreedyDualSize);
+    for i in 1..10 {
+        cache.insert(task_id(i), 1);
+    }
+    cache.insert(task_id(0), CREDIT_SCALE);
+    assert_eq!(cache.pop(), Some(CREDIT_SCALE));
+    assert_eq!(cache.inflation.load(Ordering::Acquire), DEFAULT_COST);
+
+    let mut popped = 1;
+    while cache.pop().is_some() {
+        popped += 1;
+    }
+    assert_eq!(popped, 10);
+    assert!(cache.keys().is_empty());
+}
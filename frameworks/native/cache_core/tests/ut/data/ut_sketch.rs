@@ -0,0 +1,64 @@
+// Copyright (C) 2024 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use super::*;
+
+const HOT: u64 = 0x1234_5678_9abc_def0;
+const COLD: u64 = 0x0fed_cba9_8765_4321;
+
+// @tc.name: ut_sketch_frequency
+// @tc.desc: Test frequency estimates of the sketch
+// @tc.precon: NA
+// @tc.step: 1. Record one key many times and another once
+//           2. Read both frequencies
+// @tc.expect: The hot key is estimated higher than the cold one and counters
+// saturate at MAX_COUNT
+// @tc.type: FUNC
+// @tc.require: issue#ICN31I
+// @tc.level: level1
+#[test]
+fn ut_sketch_frequency() {
+    let mut sketch = FrequencySketch::new(64);
+    assert_eq!(sketch.frequency(HOT), 0);
+    for _ in 0..20 {
+        sketch.record(HOT);
+    }
+    sketch.record(COLD);
+    assert_eq!(sketch.frequency(HOT), MAX_COUNT);
+    assert!(sketch.frequency(COLD) >= 1);
+    assert!(sketch.frequency(COLD) < sketch.frequency(HOT));
+}
+
+// @tc.name: ut_sketch_aging
+// @tc.desc: Test that old accesses fade out
+// @tc.precon: NA
+// @tc.step: 1. Record a key until it saturates
+//           2. Record other keys until the sample size is reached
+// @tc.expect: The frequency of the first key is halved
+// @tc.type: FUNC
+// @tc.require: issue#ICN31I
+// @tc.level: level1
+#[test]
+fn ut_sketch_aging() {
+    let mut sketch = FrequencySketch::new(8);
+    for _ in 0..MAX_COUNT {
+        sketch.record(HOT);
+    }
+    let before = sketch.frequency(HOT);
+    let mut key = COLD;
+    while sketch.frequency(HOT) == before {
+        key = key.wrapping_mul(6364136223846793005).wrapping_add(1);
+        sketch.record(key);
+    }
+    assert!(sketch.frequency(HOT) <= before / 2 + 1);
+}
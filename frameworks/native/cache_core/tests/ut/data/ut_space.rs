@@ -11,6 +11,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+use std::sync::atomic::Ordering;
+
 use super::ResourceManager;
 const TEST_TOTAL_SIZE: u64 = 1024;
 
@@ -28,11 +30,41 @@ const TEST_TOTAL_SIZE: u64 = 1024;
 // @tc.level: level1
 #[test]
 fn ut_cache_space() {
-    let mut handle = ResourceManager::new(TEST_TOTAL_SIZE);
+    let handle = ResourceManager::new(TEST_TOTAL_SIZE);
     handle.apply_cache_size(TEST_TOTAL_SIZE / 2);
-    assert_eq!(handle.used_capacity, TEST_TOTAL_SIZE / 2);
+    assert_eq!(handle.used_capacity(), TEST_TOTAL_SIZE / 2);
     handle.release(TEST_TOTAL_SIZE / 4);
-    assert_eq!(handle.used_capacity, TEST_TOTAL_SIZE / 4);
+    assert_eq!(handle.used_capacity(), TEST_TOTAL_SIZE / 4);
     handle.change_total_size(TEST_TOTAL_SIZE * 2);
-    assert_eq!(handle.total_capacity, TEST_TOTAL_SIZE * 2);
+    assert_eq!(handle.total_capacity.load(Ordering::Acquire), TEST_TOTAL_SIZE * 2);
+}
+
+// @tc.name: ut_cache_space_budget
+// @tc.desc: Test that the byte budget is never exceeded by concurrent applies
+// @tc.precon: NA
+// @tc.step: 1. Create a ResourceManager with TEST_TOTAL_SIZE
+//           2. Apply one byte from several threads more often than it fits
+// @tc.expect: Exactly TEST_TOTAL_SIZE applies succeed and the used capacity
+// equals the total capacity
+// @tc.type: FUNC
+// @tc.require: issue#ICN31I
+// @tc.level: level1
+#[test]
+fn ut_cache_space_budget() {
+    use std::sync::Arc;
+
+    let handle = Arc::new(ResourceManager::new(TEST_TOTAL_SIZE));
+    let threads = (0..4)
+        .map(|_| {
+            let handle = handle.clone();
+            std::thread::spawn(move || {
+                (0..TEST_TOTAL_SIZE)
+                    .filter(|_| handle.apply_cache_size(1))
+                    .count() as u64
+            })
+        })
+        .collect::<Vec<_>>();
+    let applied: u64 = threads.into_iter().map(|t| t.join().unwrap()).sum();
+    assert_eq!(applied, TEST_TOTAL_SIZE);
+    assert_eq!(handle.used_capacity(), TEST_TOTAL_SIZE);
 }
\ No newline at end of file
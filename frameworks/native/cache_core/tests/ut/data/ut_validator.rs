@@ -0,0 +1,85 @@
+// Copyright (C) 2024 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use request_utils::fastrand::fast_random;
+use request_utils::test::log::init;
+
+use super::*;
+use crate::data::init_curr_store_dir;
+
+const TEST_ETAG: &str = "\"5d8c72a5edda8\"";
+const TEST_LAST_MODIFIED: &str = "Wed, 21 Oct 2015 07:28:00 GMT";
+
+// @tc.name: ut_validator_save_load
+// @tc.desc: Test storing and reading back the validators of a task
+// @tc.precon: NA
+// @tc.step: 1. Save validators with only Last-Modified, then with both values
+//           2. Load them after each save
+//           3. Remove them
+// @tc.expect: The loaded validators equal the saved ones and nothing is
+// loaded after removal
+// @tc.type: FUNC
+// @tc.require: issue#ICN31I
+// @tc.level: level1
+#[test]
+fn ut_validator_save_load() {
+    init();
+    init_curr_store_dir();
+    let task_id = TaskId::new(fast_random().to_string());
+
+    let validators = Validators {
+        etag: None,
+        last_modified: Some(TEST_LAST_MODIFIED.to_string()),
+    };
+    validators.save(&task_id).unwrap();
+    assert_eq!(Validators::load(&task_id), Some(validators));
+
+    let validators = Validators {
+        etag: Some(TEST_ETAG.to_string()),
+        last_modified: Some(TEST_LAST_MODIFIED.to_string()),
+    };
+    validators.save(&task_id).unwrap();
+    assert_eq!(Validators::load(&task_id), Some(validators));
+
+    Validators::remove(&task_id);
+    assert!(Validators::load(&task_id).is_none());
+}
+
+// @tc.name: ut_validator_if_range
+// @tc.desc: Test choosing the If-Range validator
+// @tc.precon: NA
+// @tc.step: 1. Build validators with a strong, a weak and no entity tag
+//           2. Call if_range on each
+// @tc.expect: The strong entity tag is preferred, Last-Modified is used
+// otherwise
+// @tc.type: FUNC
+// @tc.require: issue#ICN31I
+// @tc.level: level1
+#[test]
+fn ut_validator_if_range() {
+    let strong = Validators {
+        etag: Some(TEST_ETAG.to_string()),
+        last_modified: Some(TEST_LAST_MODIFIED.to_string()),
+    };
+    assert_eq!(strong.if_range(), Some(TEST_ETAG));
+
+    let weak = Validators {
+        etag: Some(format!("W/{}", TEST_ETAG)),
+        last_modified: Some(TEST_LAST_MODIFIED.to_string()),
+    };
+    assert_eq!(weak.if_range(), Some(TEST_LAST_MODIFIED));
+
+    let none = Validators::default();
+    assert!(none.is_empty());
+    assert_eq!(none.if_range(), None);
+}
@@ -0,0 +1,90 @@
+// Copyright (C) 2024 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use std::sync::atomic::{AtomicBool, Ordering};
+use std::sync::LazyLock;
+use std::thread;
+use std::time::Duration;
+
+use request_utils::fastrand::fast_random;
+use request_utils::test::log::init;
+
+use super::*;
+use crate::manage::CacheManager;
+
+static CACHE_MANAGER: LazyLock<CacheManager> = LazyLock::new(CacheManager::new);
+
+fn ram_cache(task_id: &TaskId) -> Arc<RamCache> {
+    Arc::new(RamCache::new(task_id.clone(), &CACHE_MANAGER, Some(1)))
+}
+
+// @tc.name: ut_writer_coalesce
+// @tc.desc: Test that queued writes of the same task are coalesced
+// @tc.precon: NA
+// @tc.step: 1. Queue two bodies of one task and one of another task
+//           2. Take writes until the queue is drained
+// @tc.expect: Only the latest body of each task is taken, in queue order, and
+// only the first pushes ask for a worker
+// @tc.type: FUNC
+// @tc.require: issue#ICN31I
+// @tc.level: level1
+#[test]
+fn ut_writer_coalesce() {
+    init();
+    let writer = FileWriter::new();
+    let first = TaskId::new(fast_random().to_string());
+    let second = TaskId::new(fast_random().to_string());
+    let latest = ram_cache(&first);
+
+    assert!(writer.push(first.clone(), ram_cache(&first)));
+    assert!(!writer.push(first.clone(), latest.clone()));
+    assert_eq!(writer.push(second.clone(), ram_cache(&second)), MAX_WRITERS > 1);
+
+    let (task_id, cache) = writer.next().unwrap();
+    assert!(task_id == first);
+    assert!(Arc::ptr_eq(&cache, &latest));
+    writer.done();
+    let (task_id, _) = writer.next().unwrap();
+    assert!(task_id == second);
+    writer.done();
+    assert!(writer.next().is_none());
+}
+
+// @tc.name: ut_writer_flush
+// @tc.desc: Test that flush waits for queued writes
+// @tc.precon: NA
+// @tc.step: 1. Queue a write and drain it in another thread after a delay
+//           2. Flush the writer
+// @tc.expect: Flush returns only after the write is done
+// @tc.type: FUNC
+// @tc.require: issue#ICN31I
+// @tc.level: level1
+#[test]
+fn ut_writer_flush() {
+    init();
+    static WRITER: LazyLock<FileWriter> = LazyLock::new(FileWriter::new);
+    static WRITTEN: AtomicBool = AtomicBool::new(false);
+    let task_id = TaskId::new(fast_random().to_string());
+    assert!(WRITER.push(task_id.clone(), ram_cache(&task_id)));
+
+    let worker = thread::spawn(|| {
+        while WRITER.next().is_some() {
+            thread::sleep(Duration::from_millis(50));
+            WRITTEN.store(true, Ordering::Release);
+            WRITER.done();
+        }
+    });
+    WRITER.flush();
+    assert!(WRITTEN.load(Ordering::Acquire));
+    worker.join().unwrap();
+}
@@ -47,8 +47,6 @@ fn ut_cache_manager_update_file() {
     // files contain cache
     let mut file = CACHE_MANAGER
         .files
-        .lock()
-        .unwrap()
         .remove(&task_id)
         .unwrap()
         .open()
@@ -58,11 +56,7 @@ fn ut_cache_manager_update_file() {
     assert_eq!(buf, TEST_STRING);
 
     // backup caches removed for file exist
-    assert!(!CACHE_MANAGER
-        .backup_rams
-        .lock()
-        .unwrap()
-        .contains_key(&task_id));
+    assert!(!CACHE_MANAGER.backup_rams.contains_key(&task_id));
 }
 
 // @tc.name: ut_cache_manager_get
@@ -111,7 +105,7 @@ fn ut_cache_manager_cache_from_file() {
     cache.finish_write();
 
     thread::sleep(Duration::from_millis(100));
-    CACHE_MANAGER.rams.lock().unwrap().remove(&task_id);
+    CACHE_MANAGER.rams.remove(&task_id);
 
     let mut v = vec![];
     for _ in 0..1 {
@@ -147,15 +141,11 @@ fn ut_cache_manager_cache_from_file_clean() {
     cache.write_all(TEST_STRING.as_bytes()).unwrap();
     cache.finish_write();
     thread::sleep(Duration::from_millis(100));
-    CACHE_MANAGER.rams.lock().unwrap().remove(&task_id);
+    CACHE_MANAGER.rams.remove(&task_id);
 
     CACHE_MANAGER.get_cache(&task_id).unwrap();
-    assert!(CACHE_MANAGER.rams.lock().unwrap().contains_key(&task_id));
-    assert!(!CACHE_MANAGER
-        .backup_rams
-        .lock()
-        .unwrap()
-        .contains_key(&task_id));
+    assert!(CACHE_MANAGER.rams.contains_key(&task_id));
+    assert!(!CACHE_MANAGER.backup_rams.contains_key(&task_id));
     assert!(!CACHE_MANAGER
         .update_from_file_once
         .lock()
@@ -195,9 +185,95 @@ fn ut_cache_manager_update_same() {
     cache.cursor().read_to_string(&mut buf).unwrap();
     assert_eq!(buf, test_string);
 
-    CACHE_MANAGER.rams.lock().unwrap().remove(&task_id);
+    CACHE_MANAGER.rams.remove(&task_id);
 
     let mut buf = String::new();
     cache.cursor().read_to_string(&mut buf).unwrap();
     assert_eq!(buf, test_string);
-}
\ No newline at end of file
+}
+// @tc.name: ut_cache_manager_trim_memory
+// @tc.desc: Test cache manager trims the RAM cache under memory pressure
+// @tc.precon: NA
+// @tc.step: 1. Fill the RAM cache budget with four entries
+//           2. Drop their file caches and trim for low memory
+//           3. Trim for critical memory
+// @tc.expect: Half and then a quarter of the budget stays in RAM, the
+//             evicted entries are written back to the file cache
+// @tc.type: FUNC
+// @tc.require: issueNumber
+#[test]
+fn ut_cache_manager_trim_memory() {
+    init();
+    const SIZE: usize = 1000;
+    static CACHE_MANAGER: LazyLock<CacheManager> = LazyLock::new(CacheManager::new);
+    CACHE_MANAGER.set_ram_cache_size(4 * SIZE as u64);
+
+    let task_ids = (0..4)
+        .map(|_| TaskId::new(fast_random().to_string()))
+        .collect::<Vec<_>>();
+    for task_id in task_ids.iter() {
+        let mut cache = RamCache::new(task_id.clone(), &CACHE_MANAGER, Some(SIZE));
+        cache.write_all(&[b'a'; SIZE]).unwrap();
+        cache.finish_write();
+    }
+    thread::sleep(Duration::from_millis(100));
+    for task_id in task_ids.iter() {
+        CACHE_MANAGER.files.remove(task_id);
+    }
+
+    assert_eq!(
+        CACHE_MANAGER.trim_memory_cache(MemoryLevel::Low),
+        2 * SIZE as u64
+    );
+    assert_eq!(CACHE_MANAGER.rams.keys().len(), 2);
+    thread::sleep(Duration::from_millis(100));
+    for task_id in task_ids.iter() {
+        assert_eq!(
+            CACHE_MANAGER.rams.contains_key(task_id),
+            !CACHE_MANAGER.files.contains_key(task_id)
+        );
+    }
+    assert_eq!(CACHE_MANAGER.ram_handle.used_capacity(), 2 * SIZE as u64);
+
+    assert_eq!(
+        CACHE_MANAGER.trim_memory_cache(MemoryLevel::Critical),
+        SIZE as u64
+    );
+    assert_eq!(CACHE_MANAGER.rams.keys().len(), 1);
+    assert_eq!(CACHE_MANAGER.trim_memory_cache(MemoryLevel::Critical), 0);
+}
+
+// @tc.name: ut_cache_manager_memory_stats
+// @tc.desc: Test the memory of bodies kept out of the RAM cache is counted
+// @tc.precon: NA
+// @tc.step: 1. Finish a body larger than the RAM cache entry limit
+//           2. Read the memory stats while the body is held and after it
+//              is written and dropped
+// @tc.expect: The body is not in the RAM cache, its bytes are counted while
+//             it is alive and released afterwards
+// @tc.type: FUNC
+// @tc.require: issueNumber
+#[test]
+fn ut_cache_manager_memory_stats() {
+    init();
+    const SIZE: usize = 4096;
+    static CACHE_MANAGER: LazyLock<CacheManager> = LazyLock::new(CacheManager::new);
+    CACHE_MANAGER.set_ram_entry_max_size(SIZE as u64 / 2);
+
+    let task_id = TaskId::new(fast_random().to_string());
+    let mut cache = RamCache::new(task_id.clone(), &CACHE_MANAGER, None);
+    cache.write_all(&[b'a'; SIZE]).unwrap();
+    let cache = cache.finish_write();
+    assert!(!CACHE_MANAGER.rams.contains_key(&task_id));
+    let stats = CACHE_MANAGER.memory_stats();
+    assert_eq!(stats.used, SIZE as u64);
+    assert_eq!(stats.ram_entries, 0);
+
+    thread::sleep(Duration::from_millis(100));
+    assert!(CACHE_MANAGER.files.contains_key(&task_id));
+    drop(cache);
+    let stats = CACHE_MANAGER.memory_stats();
+    assert_eq!(stats.used, 0);
+    assert_eq!(stats.backup_entries, 0);
+    assert_eq!(stats.backup_bytes, 0);
+}
@@ -0,0 +1,250 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Contention benchmarks of the cache download service.
+//!
+//! `fetch`, `contains` and `preload` are called from 1 to 16 threads at once
+//! on URLs picked with a Zipfian popularity. The most popular URLs are in the
+//! RAM cache, the next ones only in the file cache and the rarest are never
+//! cached, so every run mixes RAM hits, file hits and misses. File hits
+//! fetched are loaded into RAM and push out other entries, as they would in
+//! an application.
+//!
+//! Criterion reports the time per call of each thread and the calls per
+//! second of all threads. After each run the hold times of the shard locks of
+//! `rams` and `files` and of the applies on the `ram_handle` budget are
+//! printed as one JSON line, e.g.
+//! {"bench":"contention","op":"fetch","threads":8,
+//!  "rams":{"count":812345,"mean_ns":88.1,"p50_ns":127,"p99_ns":511,"max_ns":40211},
+//!  "files":{...},"ram_handle":{...}}
+//!
+//! Run with `cargo bench --bench contention --features lock_stats,ylong`.
+
+mod utils;
+
+use std::sync::mpsc::{self, Sender};
+use std::sync::Arc;
+use std::thread;
+use std::time::{Duration, Instant};
+
+use cache_core::{LockHoldStats, RamCache};
+use cache_download::services::{CacheDownloadService, DownloadRequest, PreloadCallback};
+use cache_download::Downloader;
+use criterion::{black_box, criterion_group, criterion_main, BenchmarkId, Criterion, Throughput};
+use utils::{content_server, init};
+
+/// Distinct URLs requested, ordered by popularity.
+const URLS: usize = 1024;
+
+/// Most popular URLs kept in the RAM cache.
+const RAM_ENTRIES: usize = 64;
+
+/// Most popular URLs kept in the file cache, those not in the RAM cache are
+/// file hits and the rest are misses.
+const FILE_ENTRIES: usize = 512;
+
+/// Bytes of every cached body.
+const BODY_SIZE: usize = 4096;
+
+/// Exponent of the Zipfian popularity, close to 1 like web content.
+const ZIPF_EXPONENT: f64 = 0.99;
+
+/// Numbers of threads calling at once.
+const THREADS: [usize; 5] = [1, 2, 4, 8, 16];
+
+/// Longest time the cache is waited for to be populated.
+const POPULATE_TIMEOUT: Duration = Duration::from_secs(30);
+
+/// Reports a finished download to the populating thread, which gives up on
+/// failed ones at `POPULATE_TIMEOUT`.
+struct Done(Sender<()>);
+
+impl PreloadCallback for Done {
+    fn on_success(&mut self, _data: Arc<RamCache>, _task_id: &str) {
+        let _ = self.0.send(());
+    }
+}
+
+/// Preload callback of the measured calls, which ignores every event.
+struct Callback;
+
+impl PreloadCallback for Callback {}
+
+/// URLs of the benchmark by popularity, with the cumulative distribution of
+/// their Zipfian popularity.
+struct Urls {
+    urls: Vec<String>,
+    cdf: Vec<f64>,
+}
+
+impl Urls {
+    fn new(server: &str) -> Self {
+        let urls = (0..URLS)
+            .map(|rank| match rank < FILE_ENTRIES {
+                true => format!("{}/hit/{}", server, rank),
+                false => format!("{}/miss/{}", server, rank),
+            })
+            .collect();
+        let weights = (1..=URLS)
+            .map(|rank| 1.0 / (rank as f64).powf(ZIPF_EXPONENT))
+            .collect::<Vec<_>>();
+        let sum = weights.iter().sum::<f64>();
+        let cdf = weights
+            .iter()
+            .scan(0.0, |acc, weight| {
+                *acc += weight / sum;
+                Some(*acc)
+            })
+            .collect();
+        Self { urls, cdf }
+    }
+
+    /// Picks a URL with `rng`.
+    fn pick(&self, rng: &mut XorShift) -> &str {
+        let u = rng.next_f64();
+        let rank = self.cdf.partition_point(|p| *p < u).min(URLS - 1);
+        &self.urls[rank]
+    }
+}
+
+/// Cheap generator of uniform numbers, one per thread so that picking a URL
+/// does not contend itself.
+struct XorShift(u64);
+
+impl XorShift {
+    fn new(seed: usize) -> Self {
+        Self((seed as u64 + 1).wrapping_mul(0x9E37_79B9_7F4A_7C15))
+    }
+
+    fn next_f64(&mut self) -> f64 {
+        self.0 ^= self.0 << 13;
+        self.0 ^= self.0 >> 7;
+        self.0 ^= self.0 << 17;
+        (self.0 >> 11) as f64 / (1u64 << 53) as f64
+    }
+}
+
+/// Downloads the `FILE_ENTRIES` most popular URLs, least popular first, and
+/// shrinks the RAM cache to the `RAM_ENTRIES` most recent ones once the
+/// bodies are written to their files.
+fn populate(agent: &'static CacheDownloadService, urls: &Urls) {
+    agent.set_ram_cache_size((FILE_ENTRIES * BODY_SIZE * 2) as u64);
+    for url in urls.urls[..FILE_ENTRIES].iter().rev() {
+        let (tx, rx) = mpsc::channel();
+        let request = DownloadRequest::new(url);
+        agent.preload(request, Box::new(Done(tx)), false, Downloader::Ylong);
+        assert!(rx.recv_timeout(POPULATE_TIMEOUT).is_ok(), "{} failed", url);
+    }
+    let start = Instant::now();
+    while agent.memory_stats().backup_entries != 0 {
+        assert!(
+            start.elapsed() < POPULATE_TIMEOUT,
+            "file caches not written"
+        );
+        thread::sleep(Duration::from_millis(10));
+    }
+    agent.set_ram_cache_size((RAM_ENTRIES * BODY_SIZE) as u64);
+}
+
+/// Calls `op` with a picked URL `iters` times on each of `threads` threads.
+///
+/// # Returns
+/// The time until the last thread finished
+fn hammer(threads: usize, iters: u64, urls: &Urls, op: &(dyn Fn(&str) + Sync)) -> Duration {
+    thread::scope(|s| {
+        let start = Instant::now();
+        let handles = (0..threads)
+            .map(|i| {
+                s.spawn(move || {
+                    let mut rng = XorShift::new(i);
+                    for _ in 0..iters {
+                        op(black_box(urls.pick(&mut rng)));
+                    }
+                })
+            })
+            .collect::<Vec<_>>();
+        for handle in handles {
+            handle.join().unwrap();
+        }
+        start.elapsed()
+    })
+}
+
+/// Formats the hold times of a lock as a JSON object.
+fn holds_json(stats: &LockHoldStats) -> String {
+    format!(
+        "{{\"count\":{},\"mean_ns\":{:.1},\"p50_ns\":{},\"p99_ns\":{},\"max_ns\":{}}}",
+        stats.count, stats.mean_ns, stats.p50_ns, stats.p99_ns, stats.max_ns
+    )
+}
+
+/// Benchmarks every operation at every number of threads.
+fn contention_benchmark(c: &mut Criterion) {
+    init();
+    let agent = CacheDownloadService::get_instance();
+    let server = content_server(BODY_SIZE);
+    let urls = Urls::new(&server);
+    populate(agent, &urls);
+
+    let fetch = |url: &str| {
+        black_box(agent.fetch(url));
+    };
+    let contains = |url: &str| {
+        black_box(agent.contains(url));
+    };
+    let preload = |url: &str| {
+        let request = DownloadRequest::new(url);
+        black_box(agent.preload(request, Box::new(Callback), false, Downloader::Ylong));
+    };
+    let ops: [(&str, &(dyn Fn(&str) + Sync)); 3] = [
+        ("fetch", &fetch),
+        ("contains", &contains),
+        ("preload", &preload),
+    ];
+
+    let mut group = c.benchmark_group("contention");
+    for (name, op) in ops {
+        for threads in THREADS {
+            group.throughput(Throughput::Elements(threads as u64));
+            agent.lock_stats(true);
+            group.bench_with_input(BenchmarkId::new(name, threads), &threads, |b, threads| {
+                b.iter_custom(|iters| hammer(*threads, iters, &urls, op))
+            });
+            let stats = agent.lock_stats(true);
+            println!(
+                "{{\"bench\":\"contention\",\"op\":\"{}\",\"threads\":{},\"rams\":{},\
+                 \"files\":{},\"ram_handle\":{}}}",
+                name,
+                threads,
+                holds_json(&stats.rams),
+                holds_json(&stats.files),
+                holds_json(&stats.ram_handle)
+            );
+        }
+    }
+    group.finish();
+}
+
+/// Configures the benchmark settings.
+///
+/// Every run spawns its threads again, so fewer samples than the agent
+/// benchmarks keep the runs short.
+fn config() -> Criterion {
+    Criterion::default()
+        .sample_size(50)
+        .measurement_time(Duration::from_secs(3))
+}
+
+criterion_group! {name = contention; config = config(); targets = contention_benchmark}
+
+criterion_main!(contention);
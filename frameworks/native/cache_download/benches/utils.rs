@@ -16,10 +16,15 @@
 //! This module provides helper functions for setting up test environments, including
 //! logging initialization and mock HTTP server creation for performance benchmarking.
 
+// Each benchmark uses its own share of the helpers
+#![allow(dead_code)]
+
 use std::io::{BufRead, BufReader, Lines, Write};
 use std::net::{TcpListener, TcpStream};
 use std::{fs, thread};
 
+use request_utils::test::shaping::{NetProfile, Shaped};
+
 /// Initializes the logging system for benchmark tests.
 ///
 /// Sets up the environment logger to write to a test log file with millisecond precision
@@ -88,6 +93,72 @@ where
     format!("http://{}:{}", server, port)
 }
 
+/// Creates a keep-alive HTTP server serving any number of requests.
+///
+/// Paths starting with `/hit/` are answered with `body_size` bytes, any other
+/// path with 404 Not Found, so that benchmarks can mix cached URLs with URLs
+/// that never will be. The answers are sent as a link of the net profile
+/// named by `REQUEST_NET_PROFILE`, the loopback if unset.
+///
+/// # Parameters
+/// - `body_size`: Length of the bodies served
+///
+/// # Returns
+/// The URL of the running server
+pub fn content_server(body_size: usize) -> String {
+    shaped_content_server(body_size, NetProfile::from_env())
+}
+
+/// Creates the server of `content_server` sending as a link of `profile`.
+///
+/// # Parameters
+/// - `body_size`: Length of the bodies served
+/// - `profile`: Conditions of the link to the clients
+///
+/// # Returns
+/// The URL of the running server
+pub fn shaped_content_server(body_size: usize, profile: NetProfile) -> String {
+    let listener = TcpListener::bind(("127.0.0.1", 0)).unwrap();
+    let addr = listener.local_addr().unwrap();
+    thread::spawn(move || {
+        for stream in listener.incoming().flatten() {
+            thread::spawn(move || serve_content(stream, body_size, profile));
+        }
+    });
+    format!("http://{}", addr)
+}
+
+/// Answers the requests of a connection until the client closes it.
+fn serve_content(stream: TcpStream, body_size: usize, profile: NetProfile) {
+    let body = vec![b'x'; body_size];
+    let mut reader = BufReader::new(stream.try_clone().unwrap());
+    let mut stream = Shaped::new(stream, profile);
+    loop {
+        let mut request = String::new();
+        if reader.read_line(&mut request).unwrap_or(0) == 0 {
+            return;
+        }
+        // Skip the headers up to the empty line
+        let mut line = String::new();
+        while reader.read_line(&mut line).unwrap_or(0) > 2 {
+            line.clear();
+        }
+        let path = request.split_whitespace().nth(1).unwrap_or("/");
+        stream.respond();
+        let res = if path.starts_with("/hit/") {
+            let head = format!("HTTP/1.1 200 OK\r\nContent-Length: {}\r\n\r\n", body_size);
+            stream
+                .write_all(head.as_bytes())
+                .and_then(|_| stream.write_all(&body))
+        } else {
+            stream.write_all(b"HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n")
+        };
+        if res.is_err() {
+            return;
+        }
+    }
+}
+
 /// Handles an incoming TCP connection for the test server.
 ///
 /// Creates a buffered reader from the TCP stream, extracts the request lines,
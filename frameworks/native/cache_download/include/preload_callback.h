@@ -32,11 +32,14 @@ public:
     void OnSuccess(const std::shared_ptr<Data> data, rust::str TaskId) const;
     void OnFail(rust::Box<CacheDownloadError> error, rust::Box<RustDownloadInfo> info, rust::str TaskId) const;
     void OnCancel() const;
+    bool HasDataChunk() const;
+    void OnDataChunk(rust::Slice<const uint8_t> data, uint64_t offset) const;
 
 private:
     std::function<void(const std::shared_ptr<Data> &&, const std::string &TaskId)> onSuccess_;
     std::function<void(const PreloadError &, const std::string &TaskId)> onFail_;
     std::function<void()> onCancel_;
+    std::function<void(const uint8_t *data, size_t offset, size_t len)> onDataChunk_;
 };
 
 class PreloadProgressCallbackWrapper {
@@ -56,6 +59,8 @@ std::shared_ptr<Data> SharedData(rust::Box<RustData> data);
 std::unique_ptr<Data> UniqueData(rust::Box<RustData> data);
 std::unique_ptr<CppDownloadInfo> UniqueInfo(rust::Box<RustDownloadInfo> info);
 std::shared_ptr<PreloadHandle> ShareTaskHandle(rust::Box<TaskHandle> handle);
+int32_t OpenSharedCache(rust::Str url);
+int32_t PublishSharedCache(rust::Str url, int32_t fd);
 } // namespace OHOS::Request
 
 #endif // REQUEST_PRE_DOWNLOAD_CALLBACK_H
@@ -18,6 +18,7 @@
 #include <memory>
 
 #include "cxx.h"
+#include "request_manager.h"
 #include "request_preload.h"
 namespace OHOS::Request {
 
@@ -27,6 +28,7 @@ PreloadCallbackWrapper::PreloadCallbackWrapper(std::unique_ptr<PreloadCallback>
         this->onSuccess_ = callback->OnSuccess;
         this->onCancel_ = callback->OnCancel;
         this->onFail_ = callback->OnFail;
+        this->onDataChunk_ = callback->OnDataChunk;
     }
 }
 
@@ -53,6 +55,18 @@ void PreloadCallbackWrapper::OnCancel() const
     }
 }
 
+bool PreloadCallbackWrapper::HasDataChunk() const
+{
+    return this->onDataChunk_ != nullptr;
+}
+
+void PreloadCallbackWrapper::OnDataChunk(rust::Slice<const uint8_t> data, uint64_t offset) const
+{
+    if (this->onDataChunk_ != nullptr) {
+        this->onDataChunk_(data.data(), static_cast<size_t>(offset), data.size());
+    }
+}
+
 PreloadProgressCallbackWrapper::PreloadProgressCallbackWrapper(std::unique_ptr<PreloadCallback> &callback)
 {
     if (callback != nullptr) {
@@ -87,4 +101,18 @@ std::shared_ptr<PreloadHandle> ShareTaskHandle(rust::Box<TaskHandle> handle)
     return std::make_shared<PreloadHandle>(std::move(handle));
 }
 
+int32_t OpenSharedCache(rust::Str url)
+{
+    int32_t fd = -1;
+    if (RequestManager::GetInstance()->OpenSharedCache(std::string(url), fd) != E_OK) {
+        return -1;
+    }
+    return fd;
+}
+
+int32_t PublishSharedCache(rust::Str url, int32_t fd)
+{
+    return RequestManager::GetInstance()->PublishSharedCache(std::string(url), fd);
+}
+
 } // namespace OHOS::Request
\ No newline at end of file
@@ -18,7 +18,9 @@
 #include <cstdint>
 #include <memory>
 
+#include "application_context.h"
 #include "cxx.h"
+#include "environment_callback.h"
 #include "log.h"
 #include "utf8_utils.h"
 #include "wrapper.rs.h"
@@ -181,6 +183,33 @@ std::vector<std::string> CppDownloadInfo::dns_servers() const
     return result;
 }
 
+/**
+ * @brief Check whether the download reused a pooled connection
+ * @return true if no new connection was opened
+ */
+bool CppDownloadInfo::connection_reused() const
+{
+    return rust_info_->connection_reused();
+}
+
+/**
+ * @brief Get how many recorded downloads reused a pooled connection
+ * @return Pool hits up to and including this download
+ */
+uint64_t CppDownloadInfo::pool_hits() const
+{
+    return rust_info_->pool_hits();
+}
+
+/**
+ * @brief Get how many recorded downloads opened a new connection
+ * @return Pool misses up to and including this download
+ */
+uint64_t CppDownloadInfo::pool_misses() const
+{
+    return rust_info_->pool_misses();
+}
+
 /**
  * @class Slice
  * @brief Template class wrapping Rust slice with common operations
@@ -189,6 +218,10 @@ template<typename T> Slice<T>::Slice(std::unique_ptr<rust::Slice<T>> &&slice) :
 {
 }
 
+template<typename T> Slice<T>::Slice(Slice<T> &&other) noexcept : slice_(std::move(other.slice_))
+{
+}
+
 template<typename T> Slice<T>::~Slice()
 {
 }
@@ -221,7 +254,8 @@ template<typename T> T &Slice<T>::operator[](std::size_t n) const noexcept
 
 /**
  * @brief Get data as a byte slice
- * @return Slice of const uint8_t
+ * @return Slice of const uint8_t, it may point into a mapped cache file and is
+ *         only valid while this Data is alive
  */
 Slice<const uint8_t> Data::bytes() const
 {
@@ -229,6 +263,21 @@ Slice<const uint8_t> Data::bytes() const
     return Slice<const uint8_t>(std::move(bytes));
 }
 
+/**
+ * @brief Get the data as the chunks it is stored in, without copying it
+ * @return Slices of const uint8_t in data order, valid as long as this object
+ */
+std::vector<Slice<const uint8_t>> Data::chunks() const
+{
+    std::vector<Slice<const uint8_t>> chunks;
+    size_t count = data_->chunk_count();
+    chunks.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        chunks.emplace_back(std::make_unique<rust::Slice<const uint8_t>>(data_->chunk(i)));
+    }
+    return chunks;
+}
+
 /**
  * @brief Get raw Rust slice
  * @return rust::Slice of const uint8_t
@@ -289,11 +338,40 @@ ErrorKind PreloadError::GetErrorKind() const
 {
     return static_cast<ErrorKind>(error_->ffi_kind());
 }
+
+bool PreloadError::IsCached() const
+{
+    return error_->is_cached();
+}
 std::shared_ptr<CppDownloadInfo> PreloadError::GetDownloadInfo() const
 {
     return download_info_;
 }
 
+/**
+ * @class MemoryLevelListener
+ * @brief Trims the memory cache when the system reports memory pressure
+ */
+class MemoryLevelListener : public AbilityRuntime::EnvironmentCallback {
+public:
+    explicit MemoryLevelListener(const CacheDownloadService *agent) : agent_(agent)
+    {
+    }
+
+    void OnConfigurationUpdated(const AppExecFwk::Configuration &config) override
+    {
+    }
+
+    void OnMemoryLevel(const int level) override
+    {
+        REQUEST_HILOGI("memory level %{public}d", level);
+        agent_->ffi_trim_memory_cache(level);
+    }
+
+private:
+    const CacheDownloadService *agent_;
+};
+
 /**
  * @class Preload
  * @brief Main class for preloading resources
@@ -302,6 +380,11 @@ Preload::Preload()
 {
     // Initialize with Rust service
     agent_ = cache_download_service();
+    // Processes without an application context are not told their memory level
+    auto context = AbilityRuntime::ApplicationContext::GetInstance();
+    if (context != nullptr) {
+        context->RegisterEnvironmentCallback(std::make_shared<MemoryLevelListener>(agent_));
+    }
 }
 
 /**
@@ -332,6 +415,38 @@ const std::unordered_map<SslType, std::string> SslTypeName = {
     { SslType::TLCP, "TLCP" },
 };
 
+/**
+ * @brief Convert preload options for the FFI call
+ * @param options Options of the request, may be null
+ * @param ffiOptions Receives the options, borrowing the strings of options
+ * @return false if a header is not valid UTF-8
+ */
+static bool ToFfiOptions(const PreloadOptions *options, FfiPredownloadOptions &ffiOptions)
+{
+    if (options == nullptr) {
+        return true;
+    }
+    // Validate and set headers
+    for (const auto &[key, value] : options->headers) {
+        if (!Utf8Utils::RunUtf8Validation(key) || !Utf8Utils::RunUtf8Validation(value)) {
+            return false;
+        }
+        ffiOptions.headers.push_back(rust::str(key));
+        ffiOptions.headers.push_back(rust::str(value));
+    }
+
+    ffiOptions.ssl_type = rust::str(SslTypeName.at(options->sslType));
+    ffiOptions.ca_path = rust::str(options->caPath);
+    ffiOptions.priority = options->priority;
+    ffiOptions.compression = options->compression;
+    ffiOptions.shared = options->shared;
+    if (!Utf8Utils::RunUtf8Validation(options->tag)) {
+        return false;
+    }
+    ffiOptions.tag = rust::str(options->tag);
+    return true;
+}
+
 /**
  * @brief Start a preload task
  * @param url URL to preload
@@ -342,6 +457,21 @@ const std::unordered_map<SslType, std::string> SslTypeName = {
  */
 std::shared_ptr<PreloadHandle> Preload::load(std::string const &url, std::unique_ptr<PreloadCallback> callback,
     std::unique_ptr<PreloadOptions> options, bool update)
+{
+    return load(url, std::move(callback), std::move(options), update ? CacheStrategy::FORCE : CacheStrategy::LAZY);
+}
+
+/**
+ * @brief Start a preload task
+ * @param url URL to preload
+ * @param callback Callback for task events
+ * @param options Additional options for the request
+ * @param strategy How a cached resource is used, STALE_WHILE_REVALIDATE
+ *        delivers it right away and refreshes it in the background
+ * @return Shared pointer to PreloadHandle
+ */
+std::shared_ptr<PreloadHandle> Preload::load(std::string const &url, std::unique_ptr<PreloadCallback> callback,
+    std::unique_ptr<PreloadOptions> options, CacheStrategy strategy)
 {
     // Wrap C++ callback for Rust
     auto callback_wrapper = std::make_unique<PreloadCallbackWrapper>(callback);
@@ -355,34 +485,91 @@ std::shared_ptr<PreloadHandle> Preload::load(std::string const &url, std::unique
     FfiPredownloadOptions ffiOptions = {
         .headers = rust::Vec<rust::str>(),
     };
-
-    if (options != nullptr) {
-        // Validate and set headers
-        for (const auto &[key, value] : options->headers) {
-            std::vector<uint8_t> key_bytes(key.begin(), key.end());
-            std::vector<uint8_t> value_bytes(value.begin(), value.end());
-
-            if (!Utf8Utils::RunUtf8Validation(key_bytes) || !Utf8Utils::RunUtf8Validation(value_bytes)) {
-                return nullptr;
-            }
-            ffiOptions.headers.push_back(rust::str(key));
-            ffiOptions.headers.push_back(rust::str(value));
-        }
-
-        ffiOptions.ssl_type = rust::str(SslTypeName.at(options->sslType));
-        ffiOptions.ca_path = rust::str(options->caPath);
+    if (!ToFfiOptions(options.get(), ffiOptions)) {
+        return nullptr;
     }
 
-    if (!Utf8Utils::RunUtf8Validation(std::vector<uint8_t>(url.begin(), url.end()))) {
+    if (!Utf8Utils::RunUtf8Validation(url)) {
         return nullptr;
     }
 
     // Start preload task through Rust agent
     auto taskHandle = agent_->ffi_preload(
-        rust::str(url), std::move(callback_wrapper), std::move(progress_callback_wrapper), update, ffiOptions);
+        rust::str(url), std::move(callback_wrapper), std::move(progress_callback_wrapper),
+        static_cast<uint32_t>(strategy), ffiOptions);
     return taskHandle;
 }
 
+/**
+ * @brief Start preload tasks for many URLs at once
+ * @param urls URLs to preload
+ * @param callbacks Callback of each URL, in the order of urls
+ * @param options Additional options shared by every request
+ * @param strategy How cached resources are used
+ * @return Handle of each URL in the order of urls, nullptr where the URL is
+ *         not valid UTF-8 or its task could not be started
+ */
+std::vector<std::shared_ptr<PreloadHandle>> Preload::loadBatch(std::vector<std::string> const &urls,
+    std::vector<std::unique_ptr<PreloadCallback>> callbacks, std::unique_ptr<PreloadOptions> options,
+    CacheStrategy strategy)
+{
+    std::vector<std::shared_ptr<PreloadHandle>> handles(urls.size(), nullptr);
+    FfiPredownloadOptions ffiOptions = {
+        .headers = rust::Vec<rust::str>(),
+    };
+    if (callbacks.size() != urls.size() || !ToFfiOptions(options.get(), ffiOptions)) {
+        return handles;
+    }
+
+    // Positions in urls of the URLs pushed to the batch
+    std::vector<size_t> positions;
+    positions.reserve(urls.size());
+    rust::Box<PreloadBatch> batch = preload_batch();
+    for (size_t i = 0; i < urls.size(); i++) {
+        const std::string &url = urls[i];
+        if (!Utf8Utils::RunUtf8Validation(url)) {
+            continue;
+        }
+        std::unique_ptr<PreloadCallback> &callback = callbacks[i];
+        auto callback_wrapper = std::make_unique<PreloadCallbackWrapper>(callback);
+        std::shared_ptr<PreloadProgressCallbackWrapper> progress_callback_wrapper = nullptr;
+        if (callback != nullptr && callback->OnProgress != nullptr) {
+            progress_callback_wrapper = std::make_shared<PreloadProgressCallbackWrapper>(callback);
+        }
+        batch->push(rust::str(url), std::move(callback_wrapper), std::move(progress_callback_wrapper));
+        positions.push_back(i);
+    }
+
+    agent_->ffi_preload_batch(*batch, static_cast<uint32_t>(strategy), ffiOptions);
+    for (size_t i = 0; i < positions.size(); i++) {
+        handles[positions[i]] = batch->take_handle(i);
+    }
+    return handles;
+}
+
+/**
+ * @brief Subscribe to the body of a URL without starting a download
+ * @param url URL being preloaded
+ * @param callback Callback set, OnDataChunk first receives the already
+ *        downloaded bytes and then the rest of the body as it arrives
+ * @return Shared pointer to PreloadHandle, nullptr if the URL is neither being
+ *         downloaded nor cached
+ */
+std::shared_ptr<PreloadHandle> Preload::stream(std::string const &url, std::unique_ptr<PreloadCallback> callback)
+{
+    auto callback_wrapper = std::make_unique<PreloadCallbackWrapper>(callback);
+
+    std::shared_ptr<PreloadProgressCallbackWrapper> progress_callback_wrapper = nullptr;
+    if (callback != nullptr && callback->OnProgress != nullptr) {
+        progress_callback_wrapper = std::make_shared<PreloadProgressCallbackWrapper>(callback);
+    }
+
+    if (!Utf8Utils::RunUtf8Validation(url)) {
+        return nullptr;
+    }
+    return agent_->ffi_stream(rust::str(url), std::move(callback_wrapper), std::move(progress_callback_wrapper));
+}
+
 /**
  * @brief Fetch data from cache or network
  * @param url URL to fetch
@@ -390,7 +577,7 @@ std::shared_ptr<PreloadHandle> Preload::load(std::string const &url, std::unique
  */
 std::optional<Data> Preload::fetch(std::string const &url)
 {
-    if (!Utf8Utils::RunUtf8Validation(std::vector<uint8_t>(url.begin(), url.end()))) {
+    if (!Utf8Utils::RunUtf8Validation(url)) {
         return std::nullopt;
     }
     std::unique_ptr<Data> data = agent_->ffi_fetch(rust::str(url));
@@ -400,6 +587,25 @@ std::optional<Data> Preload::fetch(std::string const &url)
     return std::move(*data);
 }
 
+/**
+ * @brief Fetch a window of cached data without loading the rest of it
+ * @param url URL to fetch
+ * @param offset Position of the window in the data
+ * @param length Length of the window, cut at the end of the data
+ * @return Optional containing the window if the URL is cached
+ */
+std::optional<Data> Preload::fetch(std::string const &url, uint64_t offset, uint64_t length)
+{
+    if (!Utf8Utils::RunUtf8Validation(url)) {
+        return std::nullopt;
+    }
+    std::unique_ptr<Data> data = agent_->ffi_fetch_range(rust::str(url), offset, length);
+    if (data == nullptr) {
+        return std::nullopt;
+    }
+    return std::move(*data);
+}
+
 /**
  * @brief Get download information for a URL
  * @param url URL to query
@@ -407,7 +613,7 @@ std::optional<Data> Preload::fetch(std::string const &url)
  */
 std::optional<CppDownloadInfo> Preload::GetDownloadInfo(std::string const &url)
 {
-    if (!Utf8Utils::RunUtf8Validation(std::vector<uint8_t>(url.begin(), url.end()))) {
+    if (!Utf8Utils::RunUtf8Validation(url)) {
         return std::nullopt;
     }
     std::unique_ptr<CppDownloadInfo> info = agent_->ffi_get_download_info(rust::str(url));
@@ -417,19 +623,101 @@ std::optional<CppDownloadInfo> Preload::GetDownloadInfo(std::string const &url)
     return std::move(*info);
 }
 
+static TimingPercentiles ToTimingPercentiles(const FfiPercentiles &percentiles)
+{
+    return TimingPercentiles {
+        .p50 = percentiles.p50,
+        .p95 = percentiles.p95,
+        .p99 = percentiles.p99,
+    };
+}
+
+/**
+ * @brief Get timing percentiles of recent downloads grouped by origin
+ * @param windowSecs Length of the window ending now, in seconds
+ * @return Statistics of every origin downloaded from within the window
+ */
+std::vector<OriginTimingStats> Preload::GetTimingStats(uint64_t windowSecs)
+{
+    std::vector<OriginTimingStats> result;
+    rust::Vec<FfiOriginStats> stats = agent_->ffi_timing_stats(windowSecs);
+    result.reserve(stats.size());
+    for (const auto &origin : stats) {
+        result.push_back(OriginTimingStats {
+            .origin = std::string(origin.origin),
+            .count = origin.count,
+            .dns = ToTimingPercentiles(origin.dns),
+            .connect = ToTimingPercentiles(origin.connect),
+            .tls = ToTimingPercentiles(origin.tls),
+            .ttfb = ToTimingPercentiles(origin.ttfb),
+            .total = ToTimingPercentiles(origin.total),
+        });
+    }
+    return result;
+}
+
 // Cache configuration methods
 void Preload::SetRamCacheSize(uint64_t size)
 {
     agent_->set_ram_cache_size(size);
 }
+void Preload::SetRamCacheEntryMaxSize(uint64_t size)
+{
+    agent_->set_ram_entry_max_size(size);
+}
+void Preload::SetRamCachePolicy(RamCachePolicy policy)
+{
+    agent_->ffi_set_ram_cache_policy(static_cast<uint32_t>(policy));
+}
+void Preload::SetFailureCacheTime(ErrorKind kind, uint64_t seconds)
+{
+    agent_->ffi_set_failure_ttl(static_cast<int32_t>(kind), seconds);
+}
+RamCacheStats Preload::GetRamCacheStats()
+{
+    FfiMemoryStats memory = agent_->ffi_memory_stats();
+    return RamCacheStats {
+        .hits = agent_->ram_cache_hits(),
+        .misses = agent_->ram_cache_misses(),
+        .usedBytes = memory.used,
+        .totalBytes = memory.total,
+        .backupEntries = memory.backup_entries,
+        .backupBytes = memory.backup_bytes,
+    };
+}
 void Preload::SetFileCacheSize(uint64_t size)
 {
     agent_->set_file_cache_size(size);
 }
+void Preload::SetAdaptiveFileCacheSize(uint8_t percent, uint64_t minSize, uint64_t maxSize)
+{
+    agent_->set_adaptive_file_cache_size(percent, minSize, maxSize);
+}
+void Preload::VerifyFileCaches(uint64_t bytesPerSec)
+{
+    agent_->verify_file_caches(bytesPerSec);
+}
 void Preload::SetDownloadInfoListSize(uint16_t size)
 {
     agent_->set_info_list_size(size);
 }
+void Preload::SetDownloadLimits(size_t maxRunning, size_t maxPerHost)
+{
+    agent_->set_download_limits(maxRunning, maxPerHost);
+}
+
+/**
+ * @brief Resolve an origin and open a connection to it in the background
+ * @param origin Scheme, host and optional port of the origin
+ * @return false if the origin is invalid
+ */
+bool Preload::Prewarm(std::string const &origin)
+{
+    if (!Utf8Utils::RunUtf8Validation(origin)) {
+        return false;
+    }
+    return agent_->prewarm(rust::str(origin));
+}
 
 /**
  * @brief Cancel a preload task
@@ -437,7 +725,7 @@ void Preload::SetDownloadInfoListSize(uint16_t size)
  */
 void Preload::Cancel(std::string const &url)
 {
-    if (!Utf8Utils::RunUtf8Validation(std::vector<uint8_t>(url.begin(), url.end()))) {
+    if (!Utf8Utils::RunUtf8Validation(url)) {
         return;
     }
     agent_->cancel(rust::str(url));
@@ -449,12 +737,49 @@ void Preload::Cancel(std::string const &url)
  */
 void Preload::Remove(std::string const &url)
 {
-    if (!Utf8Utils::RunUtf8Validation(std::vector<uint8_t>(url.begin(), url.end()))) {
+    if (!Utf8Utils::RunUtf8Validation(url)) {
         return;
     }
     agent_->remove(rust::str(url));
 }
 
+/**
+ * @brief Cancel the running preload tasks loaded with a tag
+ * @param tag Tag of the tasks to cancel
+ */
+void Preload::CancelTag(std::string const &tag)
+{
+    if (!Utf8Utils::RunUtf8Validation(tag)) {
+        return;
+    }
+    agent_->cancel_tag(rust::str(tag));
+}
+
+/**
+ * @brief Change the priority of the waiting preload tasks loaded with a tag
+ * @param tag Tag of the tasks
+ * @param priority New priority, higher values start first
+ */
+void Preload::SetTagPriority(std::string const &tag, int32_t priority)
+{
+    if (!Utf8Utils::RunUtf8Validation(tag)) {
+        return;
+    }
+    agent_->set_tag_priority(rust::str(tag), priority);
+}
+
+/**
+ * @brief Cancel the preload tasks loaded with a tag and remove their cached data
+ * @param tag Tag of the tasks to remove
+ */
+void Preload::RemoveTag(std::string const &tag)
+{
+    if (!Utf8Utils::RunUtf8Validation(tag)) {
+        return;
+    }
+    agent_->remove_tag(rust::str(tag));
+}
+
 /**
  * @brief Set file cache path
  * @param path Filesystem path for cache
@@ -475,7 +800,7 @@ void Preload::SetFileCachePath(const std::string &path)
  */
 bool Preload::Contains(const std::string &url)
 {
-    if (!Utf8Utils::RunUtf8Validation(std::vector<uint8_t>(url.begin(), url.end()))) {
+    if (!Utf8Utils::RunUtf8Validation(url)) {
         return false;
     }
     return agent_->contains(rust::str(url));
@@ -550,6 +875,15 @@ PreloadState PreloadHandle::GetState()
     return static_cast<PreloadState>(handle_->state());
 }
 
+/**
+ * @brief Set the priority of the task while it waits to start
+ * @param priority Higher values start first
+ */
+void PreloadHandle::SetPriority(int32_t priority)
+{
+    handle_->set_priority(priority);
+}
+
 // Explicit template instantiation
 template class Slice<const uint8_t>;
 
@@ -21,13 +21,17 @@ use std::collections::VecDeque;
 use std::sync::atomic::{AtomicBool, AtomicUsize, Ordering};
 use std::sync::{Arc, Mutex};
 
-use super::common::{CommonError, CommonResponse};
+use super::common::{CommonError, CommonResponse, ResponseHead, STATUS_NOT_MODIFIED};
+use super::scheduler::Permit;
+use super::shared;
 use super::{CacheDownloadError, RUNNING};
 use crate::download::{CANCEL, FAIL, SUCCESS};
 use crate::info::RustDownloadInfo;
 use crate::services::{CacheDownloadService, PreloadCallback};
-use cache_core::{CacheManager, Updater};
+use cache_core::{CacheManager, PartialCache, RamCache, Updater, Validators};
+use netstack_rs::error::{HttpClientError, HttpErrorCode};
 use netstack_rs::info::DownloadInfo;
+use request_utils::compress::{ContentDecoder, DecodeError};
 use request_utils::task_id::TaskId;
 
 /// Interval for reporting progress updates.
@@ -36,6 +40,22 @@ use request_utils::task_id::TaskId;
 /// excessive callback invocations during rapid data reception.
 const PROGRESS_INTERVAL: usize = 8;
 
+/// Delivers already received body chunks to a callback, starting at offset 0.
+///
+/// # Parameters
+/// - `callback`: Callback to deliver the chunks to
+/// - `chunks`: Body chunks in order
+pub(crate) fn replay_chunks<'a>(
+    callback: &mut dyn PreloadCallback,
+    chunks: impl Iterator<Item = &'a [u8]>,
+) {
+    let mut offset = 0;
+    for chunk in chunks {
+        callback.on_data_chunk(chunk, offset);
+        offset += chunk.len() as u64;
+    }
+}
+
 /// Primary callback handler for managing download operations and notifications.
 ///
 /// Handles download lifecycle events, cache updates, progress reporting,
@@ -53,8 +73,31 @@ pub(crate) struct PrimeCallback {
     callbacks: Arc<Mutex<VecDeque<Box<dyn PreloadCallback>>>>,
     /// Restricts how frequently progress updates are reported
     progress_restriction: ProgressRestriction,
+    /// Number of callbacks at the front of `callbacks` that have been given
+    /// every byte received so far
+    synced: usize,
+    /// Number of body bytes received so far
+    received: u64,
+    /// Whether the body of the current attempt has started
+    started: bool,
+    /// Position in the body the current response starts at
+    base: u64,
+    /// Validators of the current response, kept with its body
+    validators: Validators,
     /// Sequence number for task ordering
     seq: usize,
+    /// Admission of the download by the scheduler, returned when it finishes
+    permit: Option<Permit>,
+    /// Whether encoded bodies are decoded before they are cached
+    decode: bool,
+    /// Decoder of the body of the current response, if it is encoded
+    decoder: Option<ContentDecoder>,
+    /// Decoded bytes of the last data received, kept for its capacity
+    decoded: Vec<u8>,
+    /// Error that made the download abort while decoding the body
+    decode_error: Option<DecodeError>,
+    /// URL the body is published for to the shared cache, if it is shared
+    share: Option<String>,
 }
 
 /// Restricts the frequency of progress updates.
@@ -109,7 +152,18 @@ impl PrimeCallback {
             cache_handle: Updater::new(task_id, cache_manager),
             callbacks,
             progress_restriction: ProgressRestriction::new(),
+            synced: 0,
+            received: 0,
+            started: false,
+            base: 0,
+            validators: Validators::default(),
             seq,
+            permit: None,
+            decode: false,
+            decoder: None,
+            decoded: Vec::new(),
+            decode_error: None,
+            share: None,
         }
     }
 
@@ -118,6 +172,40 @@ impl PrimeCallback {
         self.state.store(RUNNING, Ordering::Release);
     }
 
+    /// Decodes complete bodies sent with a supported content encoding before
+    /// they are cached and given to the callbacks.
+    pub(crate) fn decode_content(&mut self) {
+        self.decode = true;
+    }
+
+    /// Publishes the body to the cache shared with other applications once
+    /// it is downloaded.
+    pub(crate) fn share(&mut self, url: String) {
+        self.share = Some(url);
+    }
+
+    /// Sets the scheduler admission held while the download runs.
+    pub(crate) fn set_permit(&mut self, permit: Permit) {
+        self.permit = Some(permit);
+    }
+
+    /// Sets the stored prefix the request of this download asks to continue.
+    ///
+    /// # Parameters
+    /// - `partial`: Prefix stored by an earlier, interrupted download
+    pub(crate) fn set_partial(&mut self, partial: PartialCache) {
+        self.cache_handle.set_partial(partial);
+    }
+
+    /// Sets the cached entry the conditional request of this download asks
+    /// the server to validate.
+    ///
+    /// # Parameters
+    /// - `cache`: Cached entry the validators were taken from
+    pub(crate) fn set_revalidating(&mut self, cache: Arc<RamCache>) {
+        self.cache_handle.set_revalidating(cache);
+    }
+
     /// Gets the task ID associated with this callback.
     ///
     /// # Returns
@@ -132,7 +220,8 @@ impl PrimeCallback {
     ///
     /// Updates the cache, changes the download state to success, and notifies all
     /// registered callbacks of the successful completion. Reports 100% progress
-    /// before calling each callback's success method.
+    /// before calling each callback's success method. A `304 Not Modified`
+    /// response keeps the cached entry instead.
     ///
     /// # Type Parameters
     /// - `R`: Type implementing `CommonResponse` containing the HTTP status code
@@ -145,9 +234,37 @@ impl PrimeCallback {
     {
         let code = response.code();
         info!("{} status {}", self.task_id.brief(), code);
+        if let Some(decoder) = self.decoder.take() {
+            if let Err(e) = decoder.finish() {
+                error!("{} decode body failed {}", self.task_id.brief(), e);
+                let error = HttpClientError::new(HttpErrorCode::HttpPartialFile, e.to_string());
+                self.common_fail(error, DownloadInfo::new());
+                return;
+            }
+            info!(
+                "{} decoded {} bytes from {}",
+                self.task_id.brief(),
+                decoder.decoded_bytes(),
+                decoder.wire_bytes()
+            );
+        }
 
         // Finalize cache storage
-        let cache = self.cache_handle.cache_finish();
+        let cache = if code == STATUS_NOT_MODIFIED {
+            self.cache_handle.cache_revalidated()
+        } else {
+            self.cache_handle.set_validators(self.validators.clone());
+            // The download time is the cost of fetching the entry again
+            let service = CacheDownloadService::get_instance();
+            if let Some(millis) = service.download_time(&self.task_id) {
+                self.cache_handle.set_cost(millis as u64);
+            }
+            let cache = self.cache_handle.cache_finish();
+            if let Some(url) = self.share.take() {
+                shared::publish(self.task_id.clone(), url, cache.clone());
+            }
+            cache
+        };
         // Update task state to success
         self.state.store(SUCCESS, Ordering::Release);
         self.finish.store(true, Ordering::Release);
@@ -155,11 +272,18 @@ impl PrimeCallback {
         // Notify all registered callbacks
         let mut callbacks = self.callbacks.lock().unwrap();
 
+        let mut index = 0;
         while let Some(mut callback) = callbacks.pop_front() {
             let clone_cache = cache.clone();
             let task_id = self.task_id.brief().to_string();
+            // Callbacks attached after the last received data have not seen the body
+            let replay = index >= self.synced;
+            index += 1;
             // Spawn in separate tasks to avoid blocking
             crate::spawn(move || {
+                if replay {
+                    replay_chunks(callback.as_mut(), clone_cache.chunks());
+                }
                 // Report 100% progress before success
                 callback.on_progress(clone_cache.size() as u64, clone_cache.size() as u64);
                 callback.on_success(clone_cache, &task_id)
@@ -168,6 +292,8 @@ impl PrimeCallback {
 
         // Explicit drop to release the mutex
         drop(callbacks);
+        // Let a waiting download use the network
+        self.permit = None;
         // Notify the service that the task has finished
         self.notify_agent_finish();
     }
@@ -187,6 +313,10 @@ impl PrimeCallback {
         E: CommonError,
     {
         info!("{} download failed {}", self.task_id.brief(), error.code());
+        self.keep_partial();
+        // Convert to the standard cache download error type
+        let error = CacheDownloadError::from(&error);
+        CacheDownloadService::get_instance().download_failed(&self.task_id, &error);
         // Update task state to failed
         self.state.store(FAIL, Ordering::Release);
         self.finish.store(true, Ordering::Release);
@@ -196,8 +326,7 @@ impl PrimeCallback {
 
         while let Some(mut callback) = callbacks.pop_front() {
             let task_id = self.task_id.brief().to_string();
-            // Convert to the standard cache download error type
-            let error = CacheDownloadError::from(&error);
+            let error = error.clone();
             let info = RustDownloadInfo::from_download_info(info.clone());
             // Spawn in separate tasks to avoid blocking
             crate::spawn(move || callback.on_fail(error, info, &task_id));
@@ -205,6 +334,8 @@ impl PrimeCallback {
 
         // Explicit drop to release the mutex
         drop(callbacks);
+        // Let a waiting download use the network
+        self.permit = None;
         // Notify the service that the task has finished
         self.notify_agent_finish();
     }
@@ -214,7 +345,14 @@ impl PrimeCallback {
     /// Updates the download state to canceled, and notifies all registered callbacks
     /// of the cancellation.
     pub(crate) fn common_cancel(&mut self) {
+        // An invalid encoded body aborts the download, which is a failure
+        if let Some(e) = self.decode_error.take() {
+            let error = HttpClientError::new(HttpErrorCode::HttpBadContentEncoding, e.to_string());
+            self.common_fail(error, DownloadInfo::new());
+            return;
+        }
         info!("{} is cancel", self.task_id.brief());
+        self.keep_partial();
         // Update task state to canceled
         self.state.store(CANCEL, Ordering::Release);
         self.finish.store(true, Ordering::Release);
@@ -229,6 +367,8 @@ impl PrimeCallback {
 
         // Explicit drop to release the mutex
         drop(callbacks);
+        // Let a waiting download use the network
+        self.permit = None;
         // Notify the service that the task has finished
         self.notify_agent_finish();
     }
@@ -250,6 +390,10 @@ impl PrimeCallback {
         _ul_total: u64,
         _ul_now: u64,
     ) {
+        // Count the stored prefix a resumed response continues
+        let dl_now = dl_now + self.base;
+        let dl_total = if dl_total == 0 { 0 } else { dl_total + self.base };
+
         // Skip if no data has been received yet, or if no progress has been made,
         // or if the download is complete (which will be handled by common_success)
         if !self.progress_restriction.data_receive
@@ -281,22 +425,120 @@ impl PrimeCallback {
 
     /// Processes received data and updates the cache.
     ///
-    /// Marks that data reception has started and forwards the data to the cache handler.
+    /// Marks that data reception has started and forwards the data, decoded if the
+    /// body is encoded, to the cache handler. Callbacks attached since the previous
+    /// call are first given the data buffered so far, then every callback is given
+    /// the new data.
     ///
     /// # Type Parameters
-    /// - `F`: Function type that returns the content length when called
+    /// - `F`: Function type that returns the response head when called
     ///
     /// # Parameters
     /// - `data`: Buffer containing the received data
-    /// - `content_length`: Function that returns the total content length if available
-    pub(crate) fn common_data_receive<F>(&mut self, data: &[u8], content_length: F)
+    /// - `head`: Function that returns the response head, called once per attempt
+    ///
+    /// # Returns
+    /// `false` if the response does not continue the stored partial body or its
+    /// encoded body is invalid, the download must then be aborted
+    pub(crate) fn common_data_receive<F>(&mut self, data: &[u8], head: F) -> bool
     where
-        F: FnOnce() -> Option<usize>,
+        F: FnOnce() -> ResponseHead,
     {
         // Mark that data reception has started
         self.progress_restriction.data_receive = true;
+
+        let mut content_length = None;
+        if !self.started {
+            self.started = true;
+            let head = head();
+            content_length = head.content_length;
+            if !self.start_body(head) {
+                return false;
+            }
+            if self.decoder.is_some() {
+                // The length of the encoded body is not the size of the entry
+                content_length = None;
+            }
+        }
+
+        let mut decoded = std::mem::take(&mut self.decoded);
+        decoded.clear();
+        let data = match self.decoder.as_mut() {
+            Some(decoder) => match decoder.decode(data, &mut decoded) {
+                Ok(()) => decoded.as_slice(),
+                Err(e) => {
+                    error!("{} decode body failed {}", self.task_id.brief(), e);
+                    self.decode_error = Some(e);
+                    return false;
+                }
+            },
+            None => data,
+        };
+
+        let mut callbacks = self.callbacks.lock().unwrap();
+        for callback in callbacks.iter_mut().skip(self.synced) {
+            replay_chunks(callback.as_mut(), self.cache_handle.received());
+        }
         // Forward data to cache storage
-        self.cache_handle.cache_receive(data, content_length);
+        self.cache_handle.cache_receive(data, || content_length);
+        for callback in callbacks.iter_mut() {
+            callback.on_data_chunk(data, self.received);
+        }
+        self.received += data.len() as u64;
+        self.synced = callbacks.len();
+        drop(callbacks);
+        self.decoded = decoded;
+        true
+    }
+
+    /// Decides how the body of a response is stored, before its first bytes.
+    ///
+    /// A partial response starting where the stored prefix ends continues it,
+    /// any other partial response cannot be used while a prefix is stored. A
+    /// complete response replaces the prefix.
+    ///
+    /// # Returns
+    /// `false` if the body cannot be used
+    fn start_body(&mut self, head: ResponseHead) -> bool {
+        self.validators = head.validators;
+        // Only complete bodies are decoded, ranges are offsets in the decoded body
+        self.decoder = head
+            .content_encoding
+            .filter(|_| self.decode && !head.partial)
+            .map(ContentDecoder::new);
+        let Some(size) = self.cache_handle.partial_size() else {
+            return true;
+        };
+        if !head.partial {
+            info!("{} full body sent, drop partial", self.task_id.brief());
+            self.cache_handle.drop_partial();
+            return true;
+        }
+        if head.range_start != Some(size) {
+            error!(
+                "{} range start {:?} not partial size {}",
+                self.task_id.brief(),
+                head.range_start,
+                size
+            );
+            self.cache_handle.drop_partial();
+            return false;
+        }
+        if !self.cache_handle.cache_resume(head.content_length) {
+            return false;
+        }
+        self.base = size;
+        self.received = size;
+        true
+    }
+
+    /// Keeps the body received so far for a later range request, if the
+    /// response can be validated.
+    fn keep_partial(&mut self) {
+        let validators = std::mem::take(&mut self.validators);
+        if let Some(validator) = validators.if_range() {
+            self.cache_handle.cache_partial(validator.to_string());
+        }
     }
 
     /// Restarts the download by resetting the cache.
@@ -306,6 +548,12 @@ impl PrimeCallback {
     #[cfg(feature = "netstack")]
     pub(crate) fn common_restart(&mut self) {
         self.cache_handle.reset_cache();
+        self.validators = Validators::default();
+        self.received = 0;
+        self.started = false;
+        self.base = 0;
+        self.decoder = None;
+        self.decode_error = None;
     }
 
     /// Notifies the cache download service that the task has finished.
@@ -315,3 +563,18 @@ impl PrimeCallback {
         CacheDownloadService::get_instance().task_finish(&self.task_id, self.seq);
     }
 }
+
+impl Drop for PrimeCallback {
+    /// Reports the failure of a queued download that could not be started,
+    /// its caller was already given a handle and waits for a result.
+    fn drop(&mut self) {
+        if self.permit.take().is_some_and(|permit| permit.queued()) {
+            error!("{} queued download start failed", self.task_id.brief());
+            let error = HttpClientError::new(
+                HttpErrorCode::HttpFailedInit,
+                "download start failed".to_string(),
+            );
+            self.common_fail(error, DownloadInfo::new());
+        }
+    }
+}
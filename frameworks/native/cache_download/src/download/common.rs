@@ -16,6 +16,86 @@
 //! This module defines common interfaces used across download implementations,
 //! including traits for responses, errors, and operation handles.
 
+use std::collections::HashMap;
+
+use cache_core::Validators;
+use request_utils::compress::ContentEncoding;
+
+/// HTTP status of a complete response.
+const STATUS_OK: u32 = 200;
+
+/// HTTP status of a range response.
+const STATUS_PARTIAL_CONTENT: u32 = 206;
+
+/// HTTP status confirming that the cached body is still current.
+pub(crate) const STATUS_NOT_MODIFIED: u32 = 304;
+
+/// Response head fields needed when the first body bytes arrive.
+pub(crate) struct ResponseHead {
+    /// Length of the body in this response, `None` if unknown or chunked
+    pub(crate) content_length: Option<usize>,
+    /// Whether the response only carries a range of the body
+    pub(crate) partial: bool,
+    /// Start of the range carried by a partial response
+    pub(crate) range_start: Option<u64>,
+    /// `ETag` and `Last-Modified` of a successful response
+    pub(crate) validators: Validators,
+    /// Encoding of the body, `None` if it is not encoded in a way that can
+    /// be decoded
+    pub(crate) content_encoding: Option<ContentEncoding>,
+}
+
+impl ResponseHead {
+    /// Extracts the head fields from a status code and lowercase headers.
+    ///
+    /// # Parameters
+    /// - `status`: HTTP status code of the response
+    /// - `headers`: Response headers with lowercase names
+    pub(crate) fn parse(status: u32, headers: &HashMap<String, String>) -> Self {
+        let is_chunked = headers
+            .get("transfer-encoding")
+            .map(|s| s == "chunked")
+            .unwrap_or(false);
+        let content_length = if is_chunked {
+            None
+        } else {
+            headers
+                .get("content-length")
+                .and_then(|s| s.parse::<usize>().ok())
+        };
+
+        let partial = status == STATUS_PARTIAL_CONTENT;
+        // Content-Range: bytes <start>-<end>/<total>
+        let range_start = headers
+            .get("content-range")
+            .filter(|_| partial)
+            .and_then(|s| s.trim().strip_prefix("bytes "))
+            .and_then(|s| s.split('-').next())
+            .and_then(|s| s.trim().parse::<u64>().ok());
+
+        let validators = if status == STATUS_OK || partial {
+            Validators {
+                etag: headers.get("etag").cloned(),
+                last_modified: headers.get("last-modified").cloned(),
+            }
+        } else {
+            Validators::default()
+        };
+
+        let content_encoding = headers
+            .get("content-encoding")
+            .and_then(|s| ContentEncoding::parse(s));
+
+        Self {
+            content_length,
+            partial,
+            range_start,
+            validators,
+            content_encoding,
+        }
+    }
+}
+
 /// Common interface for response objects.
 ///
 /// Provides a consistent way to access status codes from different response types.
@@ -27,6 +107,16 @@ pub(crate) trait CommonResponse {
     fn code(&self) -> u32;
 }
 
+/// Stand-in response for a `304 Not Modified` answer that the HTTP client
+/// reported as a failure.
+pub(crate) struct NotModified;
+
+impl CommonResponse for NotModified {
+    fn code(&self) -> u32 {
+        STATUS_NOT_MODIFIED
+    }
+}
+
 /// Common interface for error objects.
 ///
 /// Provides consistent access to error codes and messages across different error types.
@@ -66,4 +156,11 @@ pub(crate) trait CommonHandle: Send + Sync {
     /// Only available when the `netstack` feature is enabled.
     #[cfg(feature = "netstack")]
     fn reset(&self);
+
+    /// Changes the priority of the operation while it waits to start.
+    ///
+    /// # Parameters
+    /// - `priority`: New priority, higher values start first
+    #[allow(unused_variables)]
+    fn set_priority(&self, priority: i32) {}
 }
@@ -80,7 +80,7 @@ const OTHERS_ERROR_CODES: &[i32] = &[
 /// Primary error type for cache download operations.
 ///
 /// Encapsulates error information including error code, message, and error kind.
-#[derive(Debug)]
+#[derive(Debug, Clone)]
 pub struct CacheDownloadError {
     /// Numeric error code, if available
     code: Option<i32>,
@@ -88,6 +88,8 @@ pub struct CacheDownloadError {
     message: String,
     /// Categorizes the type of error that occurred
     kind: ErrorKind,
+    /// Whether the error is a remembered failure of an earlier download
+    cached: bool,
 }
 
 impl CacheDownloadError {
@@ -114,6 +116,25 @@ impl CacheDownloadError {
     pub fn ffi_kind(&self) -> i32 {
         self.kind.clone() as i32
     }
+
+    /// Returns whether the error is the remembered failure of an earlier
+    /// download, reported without downloading again.
+    pub fn is_cached(&self) -> bool {
+        self.cached
+    }
+
+    /// Returns the kind of the error.
+    pub(crate) fn kind(&self) -> &ErrorKind {
+        &self.kind
+    }
+
+    /// Returns a copy of the error marked as remembered.
+    pub(crate) fn cached(&self) -> Self {
+        Self {
+            cached: true,
+            ..self.clone()
+        }
+    }
 }
 
 /// Categorizes the type of error that occurred.
@@ -133,6 +154,24 @@ pub enum ErrorKind {
     Others,
 }
 
+impl ErrorKind {
+    /// Number of error kinds.
+    pub(crate) const COUNT: usize = 6;
+
+    /// Returns the error kind of its integer code, `None` if unknown.
+    pub(crate) fn from_ffi(kind: i32) -> Option<Self> {
+        match kind {
+            0 => Some(ErrorKind::Http),
+            1 => Some(ErrorKind::Io),
+            2 => Some(ErrorKind::Dns),
+            3 => Some(ErrorKind::Tcp),
+            4 => Some(ErrorKind::Ssl),
+            5 => Some(ErrorKind::Others),
+            _ => None,
+        }
+    }
+}
+
 impl From<io::Error> for CacheDownloadError {
     /// Converts an I/O error into a cache download error.
     ///
@@ -148,6 +187,7 @@ impl From<io::Error> for CacheDownloadError {
             code: err.raw_os_error(),
             message: err.to_string(),
             kind: ErrorKind::Io,
+            cached: false,
         }
     }
 }
@@ -184,6 +224,7 @@ where
             code: Some(code),
             message: err.msg().to_string(),
             kind,
+            cached: false,
         }
     }
 }
@@ -0,0 +1,116 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Recently failed downloads.
+//!
+//! A URL whose download failed with an error likely to happen again, like a
+//! missing resource or an unknown host, fails again at once for a while
+//! instead of starting a new download. How long depends on the kind of the
+//! error, errors of a kind given no time are not remembered. The cache is an
+//! LRU of at most `MAX_FAILURES` URLs.
+
+use std::sync::atomic::{AtomicU64, Ordering};
+use std::sync::Mutex;
+use std::time::{Duration, Instant};
+
+use request_utils::lru::LRUCache;
+use request_utils::task_id::TaskId;
+
+use super::error::{CacheDownloadError, ErrorKind};
+
+/// Largest number of failed URLs remembered.
+pub(crate) const MAX_FAILURES: usize = 256;
+
+/// Default seconds a failure is remembered for, by error kind. Only missing
+/// resources and unknown hosts are remembered, other errors are often
+/// transient.
+const DEFAULT_TTLS: [u64; ErrorKind::COUNT] = [
+    30, // Http
+    0,  // Io
+    10, // Dns
+    0,  // Tcp
+    0,  // Ssl
+    0,  // Others
+];
+
+/// Error of a failed download and when it failed.
+struct Failure {
+    error: CacheDownloadError,
+    failed: Instant,
+}
+
+/// Recently failed downloads, by task.
+pub(crate) struct FailureCache {
+    entries: Mutex<LRUCache<TaskId, Failure>>,
+    /// Seconds a failure is remembered for, by error kind
+    ttls: [AtomicU64; ErrorKind::COUNT],
+}
+
+impl FailureCache {
+    /// Creates an empty cache with the default times.
+    pub(crate) fn new() -> Self {
+        Self {
+            entries: Mutex::new(LRUCache::new()),
+            ttls: DEFAULT_TTLS.map(AtomicU64::new),
+        }
+    }
+
+    /// Sets how long the failures of a kind are remembered, 0 to forget
+    /// them. Applies to the failures already remembered as well.
+    pub(crate) fn set_ttl(&self, kind: ErrorKind, secs: u64) {
+        self.ttls[kind as usize].store(secs, Ordering::Relaxed);
+    }
+
+    fn ttl(&self, kind: &ErrorKind) -> Duration {
+        Duration::from_secs(self.ttls[kind.clone() as usize].load(Ordering::Relaxed))
+    }
+
+    /// Remembers the failure of a task, if its kind is remembered.
+    pub(crate) fn record(&self, task_id: &TaskId, error: &CacheDownloadError) {
+        if self.ttl(error.kind()).is_zero() {
+            return;
+        }
+        info!("{} failure remembered", task_id.brief());
+        let failure = Failure {
+            error: error.clone(),
+            failed: Instant::now(),
+        };
+        let mut entries = self.entries.lock().unwrap();
+        entries.insert(task_id.clone(), failure);
+        while entries.len() > MAX_FAILURES {
+            entries.pop();
+        }
+    }
+
+    /// Returns the remembered failure of a task, marked as cached.
+    pub(crate) fn get(&self, task_id: &TaskId) -> Option<CacheDownloadError> {
+        let mut entries = self.entries.lock().unwrap();
+        let failure = entries.get(task_id)?;
+        if failure.failed.elapsed() < self.ttl(failure.error.kind()) {
+            return Some(failure.error.cached());
+        }
+        entries.remove(task_id);
+        None
+    }
+
+    /// Forgets the failure of a task.
+    pub(crate) fn remove(&self, task_id: &TaskId) {
+        self.entries.lock().unwrap().remove(task_id);
+    }
+}
+
+#[cfg(test)]
+mod ut_failures {
+    // Include test module containing unit tests for FailureCache
+    include!("../../tests/ut/download/ut_failures.rs");
+}
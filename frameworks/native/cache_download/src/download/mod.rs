@@ -29,6 +29,12 @@ cfg_ylong! {
 
 pub(crate) mod common;
 mod error;
+pub(crate) mod failures;
+pub(crate) mod prewarm;
+pub(crate) mod scheduler;
+pub(crate) mod shared;
 
+pub(crate) use callback::replay_chunks;
 pub(crate) use error::CacheDownloadError;
+pub use error::ErrorKind;
 pub(crate) mod task;
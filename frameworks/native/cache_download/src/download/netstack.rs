@@ -20,14 +20,16 @@
 use std::sync::atomic::AtomicUsize;
 use std::sync::Arc;
 
-use netstack_rs::error::HttpClientError;
+use netstack_rs::error::{HttpClientError, HttpErrorCode};
 use netstack_rs::info::{DownloadInfo, DownloadInfoMgr};
 use netstack_rs::request::{Request, RequestCallback};
 use netstack_rs::response::Response;
 use netstack_rs::task::RequestTask;
 
 use super::callback::PrimeCallback;
-use super::common::{CommonError, CommonHandle, CommonResponse};
+use super::common::{
+    CommonError, CommonHandle, CommonResponse, NotModified, ResponseHead, STATUS_NOT_MODIFIED,
+};
 use crate::services::DownloadRequest;
 
 impl<'a> CommonResponse for Response<'a> {
@@ -69,9 +71,19 @@ impl RequestCallback for PrimeCallback {
 
     /// Handles failure response from the HTTP client.
     ///
+    /// The client reports every status outside 2xx as a failure carrying the
+    /// status as message, a `304 Not Modified` answer to a conditional request
+    /// is a success for the cache.
+    ///
     /// # Parameters
     /// - `error`: The HTTP client error object.
     fn on_fail(&mut self, error: HttpClientError, info: DownloadInfo) {
+        if *error.code() == HttpErrorCode::HttpNoneErr
+            && error.msg() == STATUS_NOT_MODIFIED.to_string()
+        {
+            self.common_success(NotModified);
+            return;
+        }
         self.common_fail(error, info);
     }
 
@@ -82,28 +94,21 @@ impl RequestCallback for PrimeCallback {
 
     /// Handles data received notification from the HTTP client.
     ///
-    /// Extracts content length information from headers if available and not chunked encoding.
+    /// Extracts the response head from the task when the body starts, and cancels
+    /// the task if the body cannot be used.
     ///
     /// # Parameters
     /// - `data`: The received data buffer.
     /// - `task`: The request task containing response metadata.
     fn on_data_receive(&mut self, data: &[u8], mut task: RequestTask) {
         let f = || {
-            let headers = task.headers();
-            let is_chunked = headers
-                .get("transfer-encoding")
-                .map(|s| s == "chunked")
-                .unwrap_or(false);
-            if is_chunked {
-                None
-            } else {
-                headers
-                    .get("content-length")
-                    .and_then(|s| s.parse::<usize>().ok())
-            }
+            let status = task.response().status() as u32;
+            ResponseHead::parse(status, &task.headers())
         };
 
-        self.common_data_receive(data, f)
+        if !self.common_data_receive(data, f) {
+            task.cancel();
+        }
     }
 
     /// Handles progress update notification from the HTTP client.
@@ -143,9 +148,39 @@ impl DownloadTask {
         input: DownloadRequest,
         callback: PrimeCallback,
         info_mgr: Arc<DownloadInfoMgr>,
+    ) -> Option<Arc<dyn CommonHandle>> {
+        Self::start(input, callback, info_mgr, false)
+    }
+
+    /// Creates and starts a new download task using the netstack HTTP client
+    /// over HTTP/3 if the origin advertised it, see `Request::http3`.
+    ///
+    /// # Parameters
+    /// - `input`: The download request configuration.
+    /// - `callback`: The callback handler for download events.
+    /// - `info_mgr`: Manager for download information.
+    ///
+    /// # Returns
+    /// An `Arc<dyn CommonHandle>` for controlling the download task if successful,
+    /// otherwise `None`.
+    pub(super) fn run_http3(
+        input: DownloadRequest,
+        callback: PrimeCallback,
+        info_mgr: Arc<DownloadInfoMgr>,
+    ) -> Option<Arc<dyn CommonHandle>> {
+        Self::start(input, callback, info_mgr, true)
+    }
+
+    /// Builds and starts the request of a download task.
+    fn start(
+        input: DownloadRequest,
+        callback: PrimeCallback,
+        info_mgr: Arc<DownloadInfoMgr>,
+        http3: bool,
     ) -> Option<Arc<dyn CommonHandle>> {
         let mut request = Request::new();
         request.url(input.url);
+        request.http3(http3);
         if let Some(headers) = input.headers {
             for (key, value) in headers {
                 request.header(key, value);
@@ -0,0 +1,183 @@
+// Copyright (C) 2024 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Connection pre-warming for origins that are about to be loaded.
+//!
+//! Prewarming an origin resolves its host and sends a `HEAD` request to it
+//! through the HTTP client, which leaves a connection with a finished TLS
+//! handshake in the client pool. Resolved addresses are kept for `DNS_TTL`,
+//! prewarming an origin again during that time does nothing.
+
+use std::collections::HashMap;
+use std::net::{SocketAddr, ToSocketAddrs};
+use std::sync::{Arc, Mutex};
+use std::time::{Duration, Instant};
+
+use netstack_rs::info::DownloadInfoMgr;
+use netstack_rs::request::{Request, RequestCallback};
+use request_utils::task_id::TaskId;
+
+/// How long resolved addresses are kept. The system resolver does not report
+/// record TTLs, so one minute is assumed.
+pub(crate) const DNS_TTL: Duration = Duration::from_secs(60);
+
+/// Origins are not kept once this many are cached.
+const MAX_ORIGINS: usize = 128;
+
+/// Timeout of the `HEAD` request in seconds.
+const PREWARM_TIMEOUT: u32 = 10;
+
+/// Scheme, host and port of an origin.
+#[derive(Clone, PartialEq, Eq, Hash)]
+pub(crate) struct Origin {
+    pub(crate) scheme: String,
+    pub(crate) host: String,
+    pub(crate) port: u16,
+}
+
+impl Origin {
+    /// Parses an origin, anything after the authority is ignored.
+    ///
+    /// # Returns
+    /// `None` if the scheme is not `http` or `https` or the host is empty
+    pub(crate) fn parse(origin: &str) -> Option<Self> {
+        let (scheme, rest) = origin.split_once("://")?;
+        let scheme = scheme.to_ascii_lowercase();
+        let default_port = match scheme.as_str() {
+            "http" => 80,
+            "https" => 443,
+            _ => return None,
+        };
+        let end = rest.find(['/', '?', '#']).unwrap_or(rest.len());
+        let authority = &rest[..end];
+        let authority = authority.rsplit_once('@').map_or(authority, |(_, a)| a);
+        // The colon of a port follows the closing bracket of an IPv6 literal
+        let (host, port) = match authority.rfind(':') {
+            Some(i) if !authority[i..].contains(']') => {
+                (&authority[..i], authority[i + 1..].parse().ok()?)
+            }
+            _ => (authority, default_port),
+        };
+        if host.is_empty() {
+            return None;
+        }
+        Some(Self {
+            scheme,
+            host: host.to_ascii_lowercase(),
+            port,
+        })
+    }
+
+    fn url(&self) -> String {
+        format!("{}://{}:{}/", self.scheme, self.host, self.port)
+    }
+}
+
+struct Resolved {
+    addrs: Vec<SocketAddr>,
+    at: Instant,
+}
+
+/// Resolves and connects to origins ahead of their first load.
+pub(crate) struct Prewarmer {
+    dns: Mutex<HashMap<Origin, Resolved>>,
+    /// Download infos of the prewarm requests, kept apart from real loads
+    info_mgr: Arc<DownloadInfoMgr>,
+}
+
+impl Prewarmer {
+    pub(crate) fn new() -> Self {
+        Self {
+            dns: Mutex::new(HashMap::new()),
+            info_mgr: Arc::new(DownloadInfoMgr::new()),
+        }
+    }
+
+    /// Resolves and connects to an origin in the background.
+    ///
+    /// # Returns
+    /// `false` if the origin is invalid
+    pub(crate) fn prewarm(&'static self, origin: &str) -> bool {
+        let Some(origin) = Origin::parse(origin) else {
+            error!("prewarm invalid origin");
+            return false;
+        };
+        if self.addresses(&origin).is_some() {
+            debug!("prewarm {} skipped, still resolved", origin.host);
+            return true;
+        }
+        crate::spawn_prefetch(move || {
+            let addrs = match (origin.host.as_str(), origin.port).to_socket_addrs() {
+                Ok(addrs) => addrs.collect::<Vec<_>>(),
+                Err(e) => {
+                    error!("prewarm resolve {} failed {}", origin.host, e);
+                    return;
+                }
+            };
+            info!("prewarm {} resolved {} addresses", origin.host, addrs.len());
+            self.insert(origin.clone(), addrs, Instant::now());
+            self.connect(&origin);
+        });
+        true
+    }
+
+    /// Returns the addresses of an origin resolved less than `DNS_TTL` ago.
+    pub(crate) fn addresses(&self, origin: &Origin) -> Option<Vec<SocketAddr>> {
+        self.addresses_at(origin, Instant::now())
+    }
+
+    fn addresses_at(&self, origin: &Origin, now: Instant) -> Option<Vec<SocketAddr>> {
+        let dns = self.dns.lock().unwrap();
+        dns.get(origin)
+            .filter(|resolved| now.saturating_duration_since(resolved.at) < DNS_TTL)
+            .map(|resolved| resolved.addrs.clone())
+    }
+
+    fn insert(&self, origin: Origin, addrs: Vec<SocketAddr>, now: Instant) {
+        let mut dns = self.dns.lock().unwrap();
+        if dns.len() >= MAX_ORIGINS {
+            dns.retain(|_, resolved| now.saturating_duration_since(resolved.at) < DNS_TTL);
+        }
+        if dns.len() < MAX_ORIGINS || dns.contains_key(&origin) {
+            dns.insert(origin, Resolved { addrs, at: now });
+        }
+    }
+
+    /// Sends a `HEAD` request to the origin so the client keeps a connection.
+    fn connect(&self, origin: &Origin) {
+        let url = origin.url();
+        let mut request = Request::new();
+        request
+            .url(&url)
+            .method("HEAD")
+            .timeout(PREWARM_TIMEOUT)
+            .callback(PrewarmCallback)
+            .info_mgr(self.info_mgr.clone())
+            .task_id(TaskId::from_url(&url));
+        match request.build() {
+            Some(mut task) if task.start() => {}
+            _ => error!("prewarm {} connect failed", origin.host),
+        }
+    }
+}
+
+/// Callback of prewarm requests, whose responses are not used.
+struct PrewarmCallback;
+
+impl RequestCallback for PrewarmCallback {}
+
+#[cfg(test)]
+mod ut_prewarm {
+    // Include test module containing unit tests for Prewarmer
+    include!("../../tests/ut/download/ut_prewarm.rs");
+}
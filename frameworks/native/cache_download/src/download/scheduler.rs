@@ -0,0 +1,448 @@
+// Copyright (C) 2024 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Admission queue of network downloads.
+//!
+//! At most `max_running` downloads use the network at the same time, and at
+//! most `max_per_host` of them go to the same host. A download started beyond
+//! these limits waits in the queue and is started when a running one finishes,
+//! highest priority first and in arrival order among equal priorities. A
+//! waiting download can be reprioritized, or cancelled without ever reaching
+//! the network.
+
+use std::cmp::Reverse;
+use std::collections::HashMap;
+use std::mem;
+use std::sync::atomic::{AtomicI32, AtomicUsize, Ordering};
+use std::sync::{Arc, Mutex};
+
+use netstack_rs::info::DownloadInfoMgr;
+
+use super::callback::PrimeCallback;
+use super::common::CommonHandle;
+use crate::services::DownloadRequest;
+
+/// Default largest number of downloads running at the same time.
+pub(crate) const DEFAULT_MAX_RUNNING: usize = 16;
+
+/// Default largest number of downloads running to the same host.
+pub(crate) const DEFAULT_MAX_PER_HOST: usize = 6;
+
+/// Function starting a download on the network.
+pub(crate) type Run =
+    fn(DownloadRequest, PrimeCallback, Arc<DownloadInfoMgr>) -> Option<Arc<dyn CommonHandle>>;
+
+/// Global and per-host limits of running downloads with their queue.
+pub(crate) struct Scheduler {
+    state: Mutex<SchedulerState>,
+}
+
+struct SchedulerState {
+    /// Largest number of running downloads
+    max_running: usize,
+    /// Largest number of running downloads per host
+    max_per_host: usize,
+    /// Downloads holding a permit
+    running: usize,
+    /// Downloads holding a permit, by host
+    hosts: HashMap<String, usize>,
+    /// Downloads waiting for a permit
+    queue: Vec<Arc<ScheduledHandle>>,
+    /// Arrival counter ordering the queue among equal priorities
+    arrivals: u64,
+}
+
+impl SchedulerState {
+    fn admits(&self, host: &str) -> bool {
+        self.running < self.max_running
+            && self.hosts.get(host).copied().unwrap_or(0) < self.max_per_host
+    }
+
+    fn acquire(&mut self, host: &str) {
+        self.running += 1;
+        *self.hosts.entry(host.to_string()).or_insert(0) += 1;
+    }
+
+    /// Takes the waiting downloads the limits now admit out of the queue.
+    fn admit(&mut self) -> Vec<Arc<ScheduledHandle>> {
+        let mut admitted = Vec::new();
+        while self.running < self.max_running {
+            let next = self
+                .queue
+                .iter()
+                .enumerate()
+                .filter(|(_, handle)| self.admits(&handle.host))
+                .max_by_key(|(_, handle)| (handle.priority(), Reverse(handle.arrival)))
+                .map(|(index, _)| index);
+            let Some(index) = next else {
+                break;
+            };
+            let handle = self.queue.swap_remove(index);
+            self.acquire(&handle.host);
+            admitted.push(handle);
+        }
+        admitted
+    }
+}
+
+impl Scheduler {
+    /// Creates a scheduler with the default limits and an empty queue.
+    pub(crate) fn new() -> Self {
+        Self {
+            state: Mutex::new(SchedulerState {
+                max_running: DEFAULT_MAX_RUNNING,
+                max_per_host: DEFAULT_MAX_PER_HOST,
+                running: 0,
+                hosts: HashMap::new(),
+                queue: Vec::new(),
+                arrivals: 0,
+            }),
+        }
+    }
+
+    /// Sets the limits of running downloads, 0 is taken as 1.
+    ///
+    /// Raising a limit starts the waiting downloads it admits, lowering one
+    /// lets the running downloads finish.
+    pub(crate) fn set_limits(&'static self, max_running: usize, max_per_host: usize) {
+        let admitted = {
+            let mut state = self.state.lock().unwrap();
+            state.max_running = max_running.max(1);
+            state.max_per_host = max_per_host.max(1);
+            state.admit()
+        };
+        self.launch(admitted);
+    }
+
+    /// Starts a download now if the limits admit it, queues it otherwise.
+    ///
+    /// # Parameters
+    /// - `request`: Request of the download
+    /// - `callback`: Callback of the download
+    /// - `info_mgr`: Manager for download information
+    /// - `run`: Starts the download on the network
+    ///
+    /// # Returns
+    /// The handle of the download, `None` only if it was started right away
+    /// and failed to start
+    pub(crate) fn start(
+        &'static self,
+        request: DownloadRequest,
+        mut callback: PrimeCallback,
+        info_mgr: Arc<DownloadInfoMgr>,
+        run: Run,
+    ) -> Option<Arc<dyn CommonHandle>> {
+        let host = host(request.url);
+        let priority = request.priority;
+        let mut state = self.state.lock().unwrap();
+        if state.admits(&host) {
+            state.acquire(&host);
+            drop(state);
+            callback.set_permit(Permit::new(self, host.clone(), false));
+            let inner = run(request, callback, info_mgr)?;
+            return Some(Arc::new(ScheduledHandle::new(
+                self,
+                host,
+                priority,
+                0,
+                Slot::Running(inner),
+            )));
+        }
+
+        info!("{} queued", callback.task_id().brief());
+        state.arrivals += 1;
+        let pending = Pending {
+            request: OwnedRequest::from(&request),
+            callback,
+            info_mgr,
+            run,
+        };
+        let handle = Arc::new(ScheduledHandle::new(
+            self,
+            host,
+            priority,
+            state.arrivals,
+            Slot::Waiting(Box::new(pending)),
+        ));
+        state.queue.push(handle.clone());
+        Some(handle)
+    }
+
+    /// Returns a permit and starts the waiting downloads it admits.
+    fn release(&'static self, host: &str) {
+        let admitted = {
+            let mut state = self.state.lock().unwrap();
+            state.running -= 1;
+            if let Some(count) = state.hosts.get_mut(host) {
+                *count -= 1;
+                if *count == 0 {
+                    state.hosts.remove(host);
+                }
+            }
+            state.admit()
+        };
+        self.launch(admitted);
+    }
+
+    /// Removes a cancelled download from the queue.
+    fn dequeue(&self, handle: &ScheduledHandle) {
+        let mut state = self.state.lock().unwrap();
+        state
+            .queue
+            .retain(|queued| !std::ptr::eq(Arc::as_ptr(queued), handle));
+    }
+
+    fn launch(&'static self, admitted: Vec<Arc<ScheduledHandle>>) {
+        for handle in admitted {
+            // Starting may block, and the caller may hold task locks
+            crate::spawn(move || handle.launch());
+        }
+    }
+}
+
+/// Returns the lowercase host of a URL, with its port.
+pub(crate) fn host(url: &str) -> String {
+    let rest = url.split_once("://").map(|(_, rest)| rest).unwrap_or(url);
+    let authority = rest.split(['/', '?', '#']).next().unwrap_or_default();
+    let host = authority
+        .rsplit_once('@')
+        .map(|(_, host)| host)
+        .unwrap_or(authority);
+    host.to_ascii_lowercase()
+}
+
+/// Right to use the network, given back to the scheduler when dropped.
+pub(crate) struct Permit {
+    scheduler: &'static Scheduler,
+    host: String,
+    /// Whether the download waited in the queue
+    queued: bool,
+}
+
+impl Permit {
+    fn new(scheduler: &'static Scheduler, host: String, queued: bool) -> Self {
+        Self {
+            scheduler,
+            host,
+            queued,
+        }
+    }
+
+    /// Returns `true` if the download waited in the queue, its caller was
+    /// then already given a handle.
+    pub(crate) fn queued(&self) -> bool {
+        self.queued
+    }
+}
+
+impl Drop for Permit {
+    fn drop(&mut self) {
+        self.scheduler.release(&self.host);
+    }
+}
+
+/// Request of a waiting download, owning its values.
+struct OwnedRequest {
+    url: String,
+    headers: Option<Vec<(String, String)>>,
+    ssl_type: Option<String>,
+    ca_path: Option<String>,
+    priority: i32,
+    compression: bool,
+    shared: bool,
+    tag: Option<String>,
+}
+
+impl OwnedRequest {
+    fn from(request: &DownloadRequest) -> Self {
+        Self {
+            url: request.url.to_string(),
+            headers: request.headers.as_ref().map(|headers| {
+                headers
+                    .iter()
+                    .map(|(k, v)| (k.to_string(), v.to_string()))
+                    .collect()
+            }),
+            ssl_type: request.ssl_type.map(str::to_string),
+            ca_path: request.ca_path.map(str::to_string),
+            priority: request.priority,
+            compression: request.compression,
+            shared: request.shared,
+            tag: request.tag.map(str::to_string),
+        }
+    }
+
+    fn request(&self) -> DownloadRequest {
+        DownloadRequest {
+            url: &self.url,
+            headers: self.headers.as_ref().map(|headers| {
+                headers
+                    .iter()
+                    .map(|(k, v)| (k.as_str(), v.as_str()))
+                    .collect()
+            }),
+            ssl_type: self.ssl_type.as_deref(),
+            ca_path: self.ca_path.as_deref(),
+            priority: self.priority,
+            compression: self.compression,
+            shared: self.shared,
+            tag: self.tag.as_deref(),
+        }
+    }
+}
+
+/// Everything needed to start a waiting download.
+struct Pending {
+    request: OwnedRequest,
+    callback: PrimeCallback,
+    info_mgr: Arc<DownloadInfoMgr>,
+    run: Run,
+}
+
+enum Slot {
+    /// Waiting in the queue
+    Waiting(Box<Pending>),
+    /// Admitted and being started
+    Starting,
+    /// Cancelled while being started
+    Cancelled,
+    /// Started on the network
+    Running(Arc<dyn CommonHandle>),
+    /// Cancelled or failed to start
+    Done,
+}
+
+/// Handle of a scheduled download, waiting or running.
+///
+/// The handle counts the callers of the download itself, the download is
+/// cancelled, or removed from the queue, when the last of them cancels.
+pub(crate) struct ScheduledHandle {
+    scheduler: &'static Scheduler,
+    host: String,
+    priority: AtomicI32,
+    /// Arrival in the queue, 0 if started right away
+    arrival: u64,
+    count: AtomicUsize,
+    slot: Mutex<Slot>,
+}
+
+impl ScheduledHandle {
+    fn new(
+        scheduler: &'static Scheduler,
+        host: String,
+        priority: i32,
+        arrival: u64,
+        slot: Slot,
+    ) -> Self {
+        Self {
+            scheduler,
+            host,
+            priority: AtomicI32::new(priority),
+            arrival,
+            count: AtomicUsize::new(1),
+            slot: Mutex::new(slot),
+        }
+    }
+
+    fn priority(&self) -> i32 {
+        self.priority.load(Ordering::Acquire)
+    }
+
+    /// Starts an admitted download, it already holds a permit.
+    fn launch(&self) {
+        let permit = Permit::new(self.scheduler, self.host.clone(), true);
+        let pending = {
+            let mut slot = self.slot.lock().unwrap();
+            match mem::replace(&mut *slot, Slot::Starting) {
+                Slot::Waiting(pending) => pending,
+                // Cancelled after being admitted, the permit goes back
+                other => {
+                    *slot = other;
+                    return;
+                }
+            }
+        };
+        let Pending {
+            request,
+            mut callback,
+            info_mgr,
+            run,
+        } = *pending;
+        info!("{} dequeued", callback.task_id().brief());
+        callback.set_permit(permit);
+        // A failed start reports the failure when the callback is dropped
+        let inner = run(request.request(), callback, info_mgr);
+
+        let mut slot = self.slot.lock().unwrap();
+        match (mem::replace(&mut *slot, Slot::Done), inner) {
+            (Slot::Starting, Some(inner)) => *slot = Slot::Running(inner),
+            (Slot::Cancelled, Some(inner)) => {
+                drop(slot);
+                inner.cancel();
+            }
+            _ => {}
+        }
+    }
+}
+
+impl CommonHandle for ScheduledHandle {
+    /// Cancels the download when the last caller cancels, a waiting download
+    /// is removed from the queue and reports the cancellation itself.
+    fn cancel(&self) -> bool {
+        if self.count.fetch_sub(1, Ordering::SeqCst) != 1 {
+            return false;
+        }
+        let mut slot = self.slot.lock().unwrap();
+        match mem::replace(&mut *slot, Slot::Done) {
+            Slot::Waiting(pending) => {
+                drop(slot);
+                self.scheduler.dequeue(self);
+                info!("{} cancelled in queue", pending.callback.task_id().brief());
+                // The caller holds the callbacks of the task
+                crate::spawn(move || {
+                    let mut pending = pending;
+                    pending.callback.common_cancel();
+                });
+            }
+            Slot::Starting => *slot = Slot::Cancelled,
+            Slot::Running(inner) => {
+                drop(slot);
+                inner.cancel();
+            }
+            Slot::Cancelled | Slot::Done => {}
+        }
+        true
+    }
+
+    fn add_count(&self) {
+        self.count.fetch_add(1, Ordering::SeqCst);
+    }
+
+    #[cfg(feature = "netstack")]
+    fn reset(&self) {
+        if let Slot::Running(inner) = &*self.slot.lock().unwrap() {
+            inner.reset();
+        }
+    }
+
+    /// Moves a waiting download in the queue, no effect once it runs.
+    fn set_priority(&self, priority: i32) {
+        self.priority.store(priority, Ordering::Release);
+    }
+}
+
+#[cfg(test)]
+mod ut_scheduler {
+    // Include test module containing unit tests for Scheduler
+    include!("../../tests/ut/download/ut_scheduler.rs");
+}
@@ -0,0 +1,148 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Cache shared with other applications.
+//!
+//! The request service keeps a cache of bodies shared by the preloads of all
+//! applications. Preloads that opt in look their URL up there when it is not
+//! cached locally, and publish the bodies they download to it. The service
+//! decides what an application is served, see its `shared_cache` module.
+
+use std::ffi::CString;
+use std::fs::File;
+use std::io::{self, Read, Seek, SeekFrom, Write};
+use std::os::fd::FromRawFd;
+use std::os::raw::{c_char, c_int, c_uint};
+use std::sync::Arc;
+
+use cache_core::{CacheManager, RamCache, Updater};
+use request_utils::task_id::TaskId;
+
+use crate::services::DownloadRequest;
+
+/// Largest body exchanged with the shared cache, the limit of the service.
+const SHARED_MAX_SIZE: u64 = 4 * 1024 * 1024;
+
+/// Closes the memory file on exec.
+const MFD_CLOEXEC: c_uint = 1;
+
+extern "C" {
+    fn memfd_create(name: *const c_char, flags: c_uint) -> c_int;
+}
+
+/// Returns whether a request uses the shared cache.
+///
+/// Requests with headers never do, their bodies may depend on them.
+pub(crate) fn shareable(request: &DownloadRequest) -> bool {
+    request.shared
+        && request
+            .headers
+            .as_ref()
+            .map_or(true, |headers| headers.is_empty())
+}
+
+/// Caches locally the body the shared cache holds for a URL.
+///
+/// # Returns
+/// The cached body, `None` if the shared cache cannot serve it
+pub(crate) fn fetch(
+    task_id: &TaskId,
+    url: &str,
+    cache_manager: &'static CacheManager,
+) -> Option<Arc<RamCache>> {
+    let file = open(url)?;
+    let mut body = Vec::new();
+    if let Err(e) = file.take(SHARED_MAX_SIZE + 1).read_to_end(&mut body) {
+        error!("{} read shared cache failed {}", task_id.brief(), e);
+        return None;
+    }
+    if body.len() as u64 > SHARED_MAX_SIZE {
+        error!("{} shared cache body too large", task_id.brief());
+        return None;
+    }
+    info!("{} shared cache hit, {} bytes", task_id.brief(), body.len());
+    let mut updater = Updater::new(task_id.clone(), cache_manager);
+    updater.cache_receive(&body, || Some(body.len()));
+    Some(updater.cache_finish())
+}
+
+/// Publishes a downloaded body to the shared cache in the background.
+pub(crate) fn publish(task_id: TaskId, url: String, cache: Arc<RamCache>) {
+    if cache.size() as u64 > SHARED_MAX_SIZE {
+        return;
+    }
+    crate::spawn_prefetch(move || {
+        let file = match body_file(&cache) {
+            Ok(file) => file,
+            Err(e) => {
+                error!("{} shared cache body failed {}", task_id.brief(), e);
+                return;
+            }
+        };
+        if send(&url, file) {
+            info!("{} published to shared cache", task_id.brief());
+        }
+    });
+}
+
+/// Copies a body into an anonymous memory file, which is sent to the
+/// service.
+fn body_file(cache: &RamCache) -> io::Result<File> {
+    let name = CString::new("preload-shared")?;
+    // SAFETY: `name` is a valid C string for the duration of the call.
+    let fd = unsafe { memfd_create(name.as_ptr(), MFD_CLOEXEC) };
+    if fd < 0 {
+        return Err(io::Error::last_os_error());
+    }
+    // SAFETY: `fd` was just created and is owned by nobody else.
+    let mut file = unsafe { File::from_raw_fd(fd) };
+    for chunk in cache.chunks() {
+        file.write_all(chunk)?;
+    }
+    file.seek(SeekFrom::Start(0))?;
+    Ok(file)
+}
+
+cfg_ohos! {
+    use std::os::fd::AsRawFd;
+
+    use crate::wrapper::ffi;
+
+    fn open(url: &str) -> Option<File> {
+        let fd = ffi::OpenSharedCache(url);
+        if fd < 0 {
+            return None;
+        }
+        // SAFETY: The descriptor was received for this call and is owned by
+        // nobody else.
+        Some(unsafe { File::from_raw_fd(fd) })
+    }
+
+    fn send(url: &str, file: File) -> bool {
+        let ret = ffi::PublishSharedCache(url, file.as_raw_fd());
+        if ret != 0 {
+            error!("publish to shared cache failed {}", ret);
+        }
+        ret == 0
+    }
+}
+
+cfg_not_ohos! {
+    fn open(_url: &str) -> Option<File> {
+        None
+    }
+
+    fn send(_url: &str, _file: File) -> bool {
+        false
+    }
+}
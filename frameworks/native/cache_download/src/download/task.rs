@@ -20,14 +20,17 @@ use std::collections::VecDeque;
 use std::sync::atomic::{AtomicBool, AtomicUsize, Ordering};
 use std::sync::{Arc, Mutex};
 
-use cache_core::CacheManager;
+use cache_core::{CacheManager, PartialCache};
 use netstack_rs::info::DownloadInfoMgr;
+use request_utils::compress::ACCEPT_ENCODING;
 use request_utils::info;
 use request_utils::task_id::TaskId;
 
 use super::callback::PrimeCallback;
 use super::common::CommonHandle;
-use super::{INIT, SUCCESS};
+use super::scheduler::Scheduler;
+use super::shared;
+use super::{FAIL, INIT, SUCCESS};
 
 cfg_ylong! {
     use crate::download::ylong;
@@ -42,11 +45,15 @@ use crate::services::{DownloadRequest, PreloadCallback};
 /// Enum representing available download backends.
 ///
 /// Used to select between different HTTP client implementations for download operations.
+#[derive(Clone, Copy)]
 pub enum Downloader {
     /// Netstack-based HTTP client implementation.
     Netstack,
     /// Ylong-based HTTP client implementation.
     Ylong,
+    /// Netstack-based HTTP client implementation using HTTP/3 on origins
+    /// that advertised it, falling back to HTTP/1.1 or HTTP/2 if it fails.
+    Http3,
 }
 
 /// Main download task structure for managing download operations.
@@ -68,6 +75,7 @@ impl DownloadTask {
     /// - `task_id`: Unique identifier for the download task.
     /// - `cache_manager`: Reference to the cache manager for storing downloaded content.
     /// - `info_mgr`: Manager for download information.
+    /// - `scheduler`: Admission queue limiting the running downloads.
     /// - `request`: Download request configuration.
     /// - `callback`: Callback for download events.
     /// - `downloader`: Type of download backend to use.
@@ -79,6 +87,7 @@ impl DownloadTask {
         task_id: TaskId,
         cache_manager: &'static CacheManager,
         info_mgr: Arc<DownloadInfoMgr>,
+        scheduler: &'static Scheduler,
         request: DownloadRequest,
         callback: Box<dyn PreloadCallback>,
         downloader: Downloader,
@@ -87,16 +96,22 @@ impl DownloadTask {
         info!("new task {} seq {}", task_id.brief(), seq);
         let mut handle = None;
         match downloader {
-            Downloader::Netstack => {
+            Downloader::Netstack | Downloader::Http3 => {
                 #[cfg(feature = "netstack")]
                 {
+                    let run = match downloader {
+                        Downloader::Http3 => netstack::DownloadTask::run_http3,
+                        _ => netstack::DownloadTask::run,
+                    };
                     handle = download_inner(
                         task_id,
                         cache_manager,
                         info_mgr,
                         request,
                         Some(callback),
-                        netstack::DownloadTask::run,
+                        |request, callback, info_mgr| {
+                            scheduler.start(request, callback, info_mgr, run)
+                        },
                         seq,
                     );
                 }
@@ -204,6 +219,20 @@ impl TaskHandle {
         }
     }
 
+    /// Changes the priority of the download task while it waits to start.
+    ///
+    /// # Parameters
+    /// - `priority`: New priority, higher values start first
+    pub fn set_priority(&self, priority: i32) {
+        if self.finish.load(Ordering::Acquire) {
+            return;
+        }
+        if let Some(handle) = self.handle.as_ref() {
+            info!("task {} priority {}", self.task_id.brief(), priority);
+            handle.set_priority(priority);
+        }
+    }
+
     /// Resets the download task if it hasn't finished.
     pub(crate) fn reset(&mut self) {
         if self.finish.load(Ordering::Acquire) {
@@ -244,6 +273,12 @@ impl TaskHandle {
         self.finish.store(true, Ordering::Relaxed);
     }
 
+    /// Marks the task as failed.
+    pub(crate) fn set_failed(&self) {
+        self.state.store(FAIL, Ordering::Relaxed);
+        self.finish.store(true, Ordering::Relaxed);
+    }
+
     /// Attempts to add a callback to the task if it hasn't finished.
     ///
     /// # Parameters
@@ -338,7 +373,31 @@ where
         handle.callbacks.lock().unwrap().push_back(callback);
     }
 
-    let callback = PrimeCallback::new(
+    let asks = |name: &str| {
+        request
+            .headers
+            .as_ref()
+            .is_some_and(|headers| headers.iter().any(|(k, _)| k.eq_ignore_ascii_case(name)))
+    };
+    // Continue the body stored by an interrupted download, unless the caller
+    // asks for a range itself
+    let partial = if asks("range") {
+        None
+    } else {
+        PartialCache::open(&task_id)
+    };
+    // Otherwise ask whether the cached body is still current, unless the
+    // caller sends conditions itself
+    let revalidate = if partial.is_some() || asks("if-none-match") || asks("if-modified-since")
+    {
+        None
+    } else {
+        cache_manager
+            .validators(&task_id)
+            .and_then(|validators| Some((validators, cache_manager.fetch(&task_id)?)))
+    };
+
+    let mut callback = PrimeCallback::new(
         task_id,
         cache_manager,
         handle.finish_flag(),
@@ -346,7 +405,58 @@ where
         handle.callbacks(),
         seq,
     );
-    downloader(request, callback, info_mgr).map(move |command| {
+
+    let mut extra: Vec<(&'static str, String)> = Vec::new();
+    if request.compression && !asks("accept-encoding") {
+        // A stored prefix is decoded, so it is continued as it is
+        let encoding = if partial.is_some() {
+            "identity"
+        } else {
+            ACCEPT_ENCODING
+        };
+        extra.push(("Accept-Encoding", encoding.to_string()));
+    }
+    if request.compression {
+        callback.decode_content();
+    }
+    if shared::shareable(&request) {
+        callback.share(request.url.to_string());
+    }
+    if let Some(partial) = partial {
+        let range = format!("bytes={}-", partial.size());
+        info!("{} request {}", callback.task_id().brief(), range);
+        extra.push(("Range", range));
+        extra.push(("If-Range", partial.validator().to_string()));
+        callback.set_partial(partial);
+    } else if let Some((validators, cache)) = revalidate {
+        info!("{} revalidate cache", callback.task_id().brief());
+        if let Some(etag) = validators.etag {
+            extra.push(("If-None-Match", etag));
+        }
+        if let Some(last_modified) = validators.last_modified {
+            extra.push(("If-Modified-Since", last_modified));
+        }
+        callback.set_revalidating(cache);
+    }
+
+    let command = if extra.is_empty() {
+        downloader(request, callback, info_mgr)
+    } else {
+        let mut headers = request.headers.unwrap_or_default();
+        headers.extend(extra.iter().map(|(k, v)| (*k, v.as_str())));
+        let request = DownloadRequest {
+            url: request.url,
+            headers: Some(headers),
+            ssl_type: request.ssl_type,
+            ca_path: request.ca_path,
+            priority: request.priority,
+            compression: request.compression,
+            shared: request.shared,
+            tag: request.tag,
+        };
+        downloader(request, callback, info_mgr)
+    };
+    command.map(move |command| {
         handle.set_handle(command);
         handle
     })
@@ -17,14 +17,23 @@
 //! for cache download operations, including timeout settings, TLS configuration, and
 //! redirect handling.
 
+use std::io;
+use std::net::{SocketAddr, ToSocketAddrs};
 use std::sync::LazyLock;
+use std::time::{SystemTime, UNIX_EPOCH};
 
-use ylong_http_client::async_impl::Client;
+use request_utils::eyeballs::Families;
+use ylong_http_client::async_impl::{Addrs, Client, Resolver, SocketFuture};
 use ylong_http_client::{Redirect, Timeout, TlsVersion};
 
 /// Timeout for establishing a connection (in seconds).
 const CONNECT_TIMEOUT: u64 = 60;
 
+/// Largest number of HTTP/1.1 connections kept per host. Idle connections
+/// stay in the pool for keep-alive reuse, HTTP/2 connections multiplex all
+/// requests to a host over one connection.
+const MAX_H1_CONNECTIONS: usize = 6;
+
 /// Maximum request timeout value (one week in seconds).
 ///
 /// Used as the upper limit for long-running download operations to avoid premature
@@ -40,6 +49,9 @@ const SECONDS_IN_ONE_WEEK: u64 = 7 * 24 * 60 * 60;
 /// - TLS 1.2 or higher
 /// - Unlimited redirects
 /// - Built-in root certificates for TLS validation
+/// - Up to 6 pooled HTTP/1.1 connections per host, HTTP/2 when the server
+///   negotiates it
+/// - Addresses of dual-stack hosts ordered by the family they answer over
 ///
 /// # Returns
 /// A static reference to the configured HTTP client
@@ -61,8 +73,49 @@ pub(crate) fn client() -> &'static Client {
             // Allow unlimited redirects for maximum compatibility
             .redirect(Redirect::limited(usize::MAX))
             // Use system's built-in root certificates for TLS validation
-            .tls_built_in_root_certs(true);
+            .tls_built_in_root_certs(true)
+            // Bound the keep-alive pool to the per-host download limit
+            .max_h1_conn_number(MAX_H1_CONNECTIONS)
+            // Try the address family the host answers over first
+            .dns_resolver(FamilyResolver);
         client.build().unwrap()
     });
     &CLIENT
 }
+
+/// Resolver ordering the addresses of dual-stack hosts by the family they
+/// answered over first, so that a broken IPv6 path does not hold the
+/// connections.
+struct FamilyResolver;
+
+impl Resolver for FamilyResolver {
+    fn resolve(&self, authority: &str) -> SocketFuture {
+        static FAMILIES: LazyLock<Families> = LazyLock::new(Families::new);
+        let authority = authority.to_ascii_lowercase();
+        Box::pin(async move {
+            let addrs = ylong_runtime::spawn_blocking(move || {
+                let addrs = authority.to_socket_addrs()?.collect::<Vec<_>>();
+                let now = SystemTime::now()
+                    .duration_since(UNIX_EPOCH)
+                    .map_or(0, |time| time.as_millis() as u64);
+                Ok::<_, io::Error>(FAMILIES.order(&authority, addrs, now))
+            })
+            .await
+            .map_err(|e| io::Error::new(io::ErrorKind::Other, e))??;
+            Ok(Box::new(ResolvedAddrs(addrs.into_iter())) as Box<dyn Addrs>)
+        })
+    }
+}
+
+/// Addresses returned to the client.
+struct ResolvedAddrs(std::vec::IntoIter<SocketAddr>);
+
+impl Iterator for ResolvedAddrs {
+    type Item = SocketAddr;
+
+    fn next(&mut self) -> Option<Self::Item> {
+        self.0.next()
+    }
+}
+
+impl Addrs for ResolvedAddrs {}
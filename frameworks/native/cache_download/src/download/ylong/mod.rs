@@ -34,7 +34,7 @@ use ylong_http_client::async_impl::{
 use ylong_http_client::{ErrorKind, HttpClientError, StatusCode};
 
 use super::callback::PrimeCallback;
-use super::common::{CommonHandle, CommonError, CommonResponse};
+use super::common::{CommonHandle, CommonError, CommonResponse, ResponseHead};
 use crate::services::DownloadRequest;
 
 /// Implements the `CommonError` trait for the `HttpClientError` type.
@@ -69,6 +69,8 @@ struct Operator<'a> {
     callback: &'a mut PrimeCallback,
     /// Flag used to signal download cancellation
     abort_flag: Arc<AtomicBool>,
+    /// HTTP status code of the response
+    status: u32,
     /// HTTP headers received from the response
     headers: HashMap<String, String>,
 }
@@ -84,9 +86,14 @@ impl<'a> DownloadOperator for Operator<'a> {
         data: &[u8],
     ) -> Poll<Result<usize, HttpClientError>> {
         let me = self.get_mut();
-        me.callback.common_data_receive(data, || {
-            me.headers.get("content-length").and_then(|v| v.parse().ok())
-        });
+        let (status, headers) = (me.status, &me.headers);
+        if !me
+            .callback
+            .common_data_receive(data, || ResponseHead::parse(status, headers))
+        {
+            // The body does not continue the stored partial body
+            return Poll::Ready(Err(HttpClientError::user_aborted()));
+        }
         Poll::Ready(Ok(data.len()))
     }
 
@@ -214,6 +221,7 @@ pub async fn download(
     let operator = Operator {
         callback: callback,
         abort_flag: abort_flag,
+        status: status.as_u16() as u32,
         headers: response
             .headers()
             .into_iter()
@@ -108,6 +108,21 @@ impl RustDownloadInfo {
         self.info.dns_servers()
     }
 
+    /// Returns `true` if the download reused a pooled connection.
+    pub fn connection_reused(&self) -> bool {
+        self.info.connection_reused()
+    }
+
+    /// Returns how many recorded downloads reused a pooled connection.
+    pub fn pool_hits(&self) -> u64 {
+        self.info.pool_hits()
+    }
+
+    /// Returns how many recorded downloads opened a new connection.
+    pub fn pool_misses(&self) -> u64 {
+        self.info.pool_misses()
+    }
+
     /// Creates a new `RustDownloadInfo` from a `DownloadInfo`.
     ///
     /// # Parameters
@@ -49,15 +49,29 @@ pub use services::{CacheDownloadService, DownloadRequest, PreloadCallback};
 // Re-export downloader enum for public API use
 pub use download::task::Downloader;
 
+// Re-export error kinds, the failures of each kind are remembered for their own time
+pub use download::ErrorKind;
+
+// Re-export RAM cache policy types used by the service API
+pub use cache_core::{CacheStats, RamCachePolicy};
+
 // Conditional compilation for OpenHarmony platform
 cfg_ohos! {
     mod wrapper; // Platform-specific wrapper for OpenHarmony
-    use ffrt_rs::ffrt_spawn as spawn; // Use ffrt task spawning on OpenHarmony
+    // Callbacks and task launches are waited for by users, above cache writes
+    fn spawn<F: FnOnce() + 'static>(f: F) {
+        ffrt_rs::ffrt_spawn_qos(ffrt_rs::Qos::UserInitiated, f);
+    }
+    // Prefetches are only needed by later fetches
+    fn spawn_prefetch<F: FnOnce() + 'static>(f: F) {
+        ffrt_rs::ffrt_spawn_qos(ffrt_rs::Qos::Utility, f);
+    }
 }
 
 // Conditional compilation for non-OpenHarmony platforms
 cfg_not_ohos! {
     use ylong_runtime::spawn_blocking as spawn; // Use ylong runtime for other platforms
+    use ylong_runtime::spawn_blocking as spawn_prefetch;
 }
 
 use hilog_rust::{HiLogLabel, LogType};
@@ -21,19 +21,31 @@
 use std::collections::hash_map::Entry;
 use std::collections::{HashMap, HashSet};
 use std::sync::{Arc, Mutex, Once, OnceLock};
+use std::time::Duration;
 
 // External dependencies
-use cache_core::{CacheManager, RamCache};
+use cache_core::{
+    CacheData, CacheManager, CacheStats, MemoryLevel, MemoryStats, RamCache, RamCachePolicy,
+};
 use netstack_rs::info::{DownloadInfo, DownloadInfoMgr};
+use netstack_rs::stats::OriginStats;
 use request_utils::observe::network::NetRegistrar;
 use request_utils::task_id::TaskId;
 
 // Internal dependencies
+use crate::download::failures::FailureCache;
+use crate::download::prewarm::Prewarmer;
+use crate::download::scheduler::Scheduler;
+use crate::download::shared;
 use crate::download::task::{DownloadTask, Downloader, TaskHandle};
-use crate::download::CacheDownloadError;
+use crate::download::{replay_chunks, CacheDownloadError, ErrorKind};
 use crate::info::RustDownloadInfo;
 use crate::observe::NetObserver;
 
+/// Number of tasks of a tag above which the tasks neither running nor cached
+/// are forgotten.
+const MAX_TAG_TASKS: usize = 1024;
+
 /// Trait defining callback methods for preload operations.
 ///
 /// Implementations of this trait receive notifications about various download events
@@ -64,8 +76,26 @@ pub trait PreloadCallback: Send {
     /// - `progress`: Number of bytes downloaded so far
     /// - `total`: Total number of bytes to download
     fn on_progress(&mut self, progress: u64, total: u64) {}
+
+    /// Called with each piece of the body, in order, before `on_success`.
+    ///
+    /// A callback attached to a running download first receives the bytes
+    /// already buffered. Pieces received from the network are delivered on
+    /// the download thread, so implementations must not block. An `offset` of
+    /// 0 after earlier pieces means the download restarted from the beginning.
+    ///
+    /// # Parameters
+    /// - `data`: Body bytes, only valid during the call
+    /// - `offset`: Position of `data` in the body
+    fn on_data_chunk(&mut self, data: &[u8], offset: u64) {}
 }
 
+/// Callback of background refreshes started by `preload_stale`, whose
+/// caller has already been served the cached copy.
+struct RevalidateCallback;
+
+impl PreloadCallback for RevalidateCallback {}
+
 /// Main service for managing cache downloads.
 ///
 /// Implements the singleton pattern to provide a global instance for handling
@@ -79,6 +109,14 @@ pub struct CacheDownloadService {
     info_mgr: Arc<DownloadInfoMgr>,
     /// Registrar for network state observation and notifications.
     net_registrar: NetRegistrar,
+    /// Admission queue limiting the downloads running at the same time.
+    scheduler: Scheduler,
+    /// Resolved addresses and connections of prewarmed origins.
+    prewarmer: Prewarmer,
+    /// Tasks of the preloads started with each tag.
+    tags: Mutex<HashMap<String, HashSet<TaskId>>>,
+    /// Recent failures reported again without downloading.
+    failures: FailureCache,
 }
 
 /// Builder-style request for configuring downloads.
@@ -94,6 +132,15 @@ pub struct DownloadRequest<'a> {
     pub ssl_type: Option<&'a str>,
     /// Optional path to CA certificates.
     pub ca_path: Option<&'a str>,
+    /// Priority of the download while it waits to start, higher values
+    /// start first.
+    pub priority: i32,
+    /// Whether to ask for a compressed body, which is cached decoded.
+    pub compression: bool,
+    /// Whether to use the cache shared with other applications.
+    pub shared: bool,
+    /// Optional tag grouping the preload with others.
+    pub tag: Option<&'a str>,
 }
 
 impl<'a> DownloadRequest<'a> {
@@ -113,6 +160,10 @@ impl<'a> DownloadRequest<'a> {
             headers: None,
             ssl_type: None,
             ca_path: None,
+            priority: 0,
+            compression: false,
+            shared: false,
+            tag: None,
         }
     }
 
@@ -161,6 +212,62 @@ impl<'a> DownloadRequest<'a> {
         self.ca_path = Some(ca_path);
         self
     }
+
+    /// Sets the priority of the download while it waits for the concurrency
+    /// limits.
+    ///
+    /// # Parameters
+    /// - `priority`: Priority of the download, 0 by default, higher values
+    ///   start first
+    ///
+    /// # Returns
+    /// A mutable reference to self for method chaining
+    pub fn priority(&mut self, priority: i32) -> &mut Self {
+        self.priority = priority;
+        self
+    }
+
+    /// Asks for a compressed body, which is decoded before it is cached.
+    ///
+    /// # Parameters
+    /// - `compression`: Whether to advertise the encodings that can be
+    ///   decoded, `false` by default
+    ///
+    /// # Returns
+    /// A mutable reference to self for method chaining
+    pub fn compression(&mut self, compression: bool) -> &mut Self {
+        self.compression = compression;
+        self
+    }
+
+    /// Looks the URL up in the cache shared with other applications before
+    /// downloading it, and publishes the downloaded body to that cache.
+    ///
+    /// Requests with headers never use the shared cache, as their bodies may
+    /// depend on them.
+    ///
+    /// # Parameters
+    /// - `shared`: Whether to use the shared cache, `false` by default
+    ///
+    /// # Returns
+    /// A mutable reference to self for method chaining
+    pub fn shared(&mut self, shared: bool) -> &mut Self {
+        self.shared = shared;
+        self
+    }
+
+    /// Groups the preload under a tag, so the preloads of the tag can be
+    /// cancelled, reprioritized or removed together.
+    ///
+    /// # Parameters
+    /// - `tag`: Tag of the preload, none by default
+    ///
+    /// # Returns
+    /// A mutable reference to self for method chaining
+    pub fn tag(&mut self, tag: &'a str) -> &mut Self {
+        self.tag = Some(tag);
+        self
+    }
 }
 
 impl CacheDownloadService {
@@ -174,6 +281,10 @@ impl CacheDownloadService {
             cache_manager: CacheManager::new(),
             info_mgr: Arc::new(DownloadInfoMgr::new()),
             net_registrar: NetRegistrar::new(),
+            scheduler: Scheduler::new(),
+            prewarmer: Prewarmer::new(),
+            tags: Mutex::new(HashMap::new()),
+            failures: FailureCache::new(),
         }
     }
 
@@ -220,6 +331,82 @@ impl CacheDownloadService {
         }
     }
 
+    /// Cancels the running preloads started with a tag.
+    ///
+    /// Each preload is cancelled as by `cancel` with its URL. The tag keeps
+    /// its preloads, so their cached contents can still be removed with
+    /// `remove_tag`.
+    ///
+    /// # Parameters
+    /// - `tag`: Tag of the preloads to cancel
+    pub fn cancel_tag(&self, tag: &str) {
+        let tasks = self.tagged_tasks(tag);
+        info!("cancel tag {}, {} running", tag, tasks.len());
+        for task in tasks {
+            task.lock().unwrap().cancel();
+        }
+    }
+
+    /// Changes the priority of the preloads started with a tag while they
+    /// wait to start.
+    ///
+    /// # Parameters
+    /// - `tag`: Tag of the preloads
+    /// - `priority`: New priority, higher values start first
+    pub fn set_tag_priority(&self, tag: &str, priority: i32) {
+        for task in self.tagged_tasks(tag) {
+            task.lock().unwrap().handle.set_priority(priority);
+        }
+    }
+
+    /// Cancels the preloads started with a tag, removes their cached
+    /// contents and forgets the tag.
+    ///
+    /// # Parameters
+    /// - `tag`: Tag of the preloads to remove
+    pub fn remove_tag(&self, tag: &str) {
+        self.cancel_tag(tag);
+        let Some(task_ids) = self.tags.lock().unwrap().remove(tag) else {
+            return;
+        };
+        info!("remove tag {}, {} tasks", tag, task_ids.len());
+        for task_id in task_ids {
+            self.cache_manager.remove(task_id);
+        }
+    }
+
+    /// Adds a task to the tag of its request, if any.
+    ///
+    /// A tag holding `MAX_TAG_TASKS` tasks first forgets those neither
+    /// running nor cached.
+    fn tag_task(&self, request: &DownloadRequest, task_id: &TaskId) {
+        let Some(tag) = request.tag else {
+            return;
+        };
+        let mut tags = self.tags.lock().unwrap();
+        let task_ids = tags.entry(tag.to_string()).or_default();
+        if task_ids.len() >= MAX_TAG_TASKS && !task_ids.contains(task_id) {
+            let running_tasks = self.running_tasks.lock().unwrap();
+            task_ids.retain(|task_id| {
+                running_tasks.contains_key(task_id) || self.cache_manager.contains(task_id)
+            });
+        }
+        task_ids.insert(task_id.clone());
+    }
+
+    /// Returns the running tasks of a tag.
+    fn tagged_tasks(&self, tag: &str) -> Vec<Arc<Mutex<DownloadTask>>> {
+        // The tag index is never locked after the task map
+        let Some(task_ids) = self.tags.lock().unwrap().get(tag).cloned() else {
+            return Vec::new();
+        };
+        let running_tasks = self.running_tasks.lock().unwrap();
+        task_ids
+            .iter()
+            .filter_map(|task_id| running_tasks.get(task_id).cloned())
+            .collect()
+    }
+
     /// Resets all currently running download tasks.
     ///
     /// Called when network connectivity is restored to resume paused downloads.
@@ -230,12 +417,14 @@ impl CacheDownloadService {
         }
     }
 
-    /// Removes a cached item identified by URL.
+    /// Removes a cached item identified by URL, and forgets a recent failure
+    /// of its download.
     ///
     /// # Parameters
     /// - `url`: URL of the cached item to remove
     pub fn remove(&self, url: &str) {
         let task_id = TaskId::from_url(url);
+        self.failures.remove(&task_id);
         self.cache_manager.remove(task_id);
     }
 
@@ -274,6 +463,7 @@ impl CacheDownloadService {
         let url = request.url;
         let task_id = TaskId::from_url(url);
         info!("preload {}", task_id.brief());
+        self.tag_task(&request, &task_id);
 
         // Try to fetch from cache first if not updating
         if !update {
@@ -287,6 +477,26 @@ impl CacheDownloadService {
             }
         }
 
+        // Try the cache shared with other applications before the network
+        if !update && shared::shareable(&request) {
+            if let Some(cache) = shared::fetch(&task_id, url, &self.cache_manager) {
+                let brief = task_id.brief().to_string();
+                crate::spawn(move || {
+                    replay_chunks(callback.as_mut(), cache.chunks());
+                    callback.on_success(cache, &brief)
+                });
+                let handle = TaskHandle::new(task_id);
+                handle.set_completed();
+                return Some(handle);
+            }
+        }
+
+        // A URL that failed recently fails again without downloading
+        callback = match self.fail_with_callback(&task_id, callback) {
+            Ok(handle) => return Some(handle),
+            Err(callback) => callback,
+        };
+
         // Main loop to manage task creation and callback handling
         loop {
             let updater = match self.running_tasks.lock().unwrap().entry(task_id.clone()) {
@@ -297,6 +507,7 @@ impl CacheDownloadService {
                         task_id.clone(),
                         &self.cache_manager,
                         self.info_mgr.clone(),
+                        &self.scheduler,
                         request,
                         callback,
                         downloader,
@@ -337,6 +548,7 @@ impl CacheDownloadService {
                             task_id.clone(),
                             &self.cache_manager,
                             self.info_mgr.clone(),
+                            &self.scheduler,
                             request,
                             cb,
                             downloader,
@@ -357,6 +569,159 @@ impl CacheDownloadService {
         }
     }
 
+    /// Preloads content from many URLs at once.
+    ///
+    /// Behaves like calling `preload` for every request, but downloads are
+    /// started for all URLs without a running task while the task map is
+    /// locked once. URLs that already have a running task go through
+    /// `preload` afterwards.
+    ///
+    /// # Parameters
+    /// - `requests`: Download requests, each with the callback of its events
+    /// - `update`: Whether to update existing cached content
+    /// - `downloader`: Type of downloader to use for the operations
+    ///
+    /// # Returns
+    /// The task handle of each request, in order, `None` where a download
+    /// could not be started
+    pub fn preload_batch(
+        &'static self,
+        requests: Vec<(DownloadRequest, Box<dyn PreloadCallback>)>,
+        update: bool,
+        downloader: Downloader,
+    ) -> Vec<Option<TaskHandle>> {
+        info!("preload batch of {}", requests.len());
+        let mut handles = Vec::with_capacity(requests.len());
+        let mut remaining = Vec::with_capacity(requests.len());
+        for (index, (request, callback)) in requests.into_iter().enumerate() {
+            let task_id = TaskId::from_url(request.url);
+            self.tag_task(&request, &task_id);
+            handles.push(None);
+            if update {
+                remaining.push((index, task_id, request, callback));
+                continue;
+            }
+            match self.fetch_with_callback(&task_id, callback) {
+                Ok(()) => {
+                    let handle = TaskHandle::new(task_id);
+                    handle.set_completed();
+                    handles[index] = Some(handle);
+                }
+                Err(callback) => match self.fail_with_callback(&task_id, callback) {
+                    Ok(handle) => handles[index] = Some(handle),
+                    Err(callback) => remaining.push((index, task_id, request, callback)),
+                },
+            }
+        }
+
+        let mut attach = Vec::new();
+        {
+            let mut running_tasks = self.running_tasks.lock().unwrap();
+            for (index, task_id, request, callback) in remaining {
+                let Entry::Vacant(entry) = running_tasks.entry(task_id.clone()) else {
+                    attach.push((index, request, callback));
+                    continue;
+                };
+                let download_task = DownloadTask::new(
+                    task_id,
+                    &self.cache_manager,
+                    self.info_mgr.clone(),
+                    &self.scheduler,
+                    request,
+                    callback,
+                    downloader,
+                    0,
+                );
+                if let Some(task) = download_task {
+                    handles[index] = Some(task.task_handle());
+                    entry.insert(Arc::new(Mutex::new(task)));
+                }
+            }
+        }
+
+        // Running tasks are locked on their own, after the task map
+        for (index, request, callback) in attach {
+            handles[index] = self.preload(request, callback, update, downloader);
+        }
+        handles
+    }
+
+    /// Preloads content from a URL, serving a cached copy while it is refreshed.
+    ///
+    /// A cached copy is delivered to `callback` right away and the URL is
+    /// downloaded again in the background, conditionally if the copy carries
+    /// validators, so a later `fetch` gets the refreshed content. Without a
+    /// cached copy this behaves like `preload` with `update` set.
+    ///
+    /// # Parameters
+    /// - `request`: Download request with URL and optional configuration
+    /// - `callback`: Callback to receive download events
+    /// - `downloader`: Type of downloader to use for the operation
+    ///
+    /// # Returns
+    /// An optional task handle, already completed if a cached copy was served
+    pub fn preload_stale(
+        &'static self,
+        request: DownloadRequest,
+        callback: Box<dyn PreloadCallback>,
+        downloader: Downloader,
+    ) -> Option<TaskHandle> {
+        let task_id = TaskId::from_url(request.url);
+        match self.fetch_with_callback(&task_id, callback) {
+            Ok(()) => {
+                info!("{} stale served, revalidate", task_id.brief());
+                self.preload(request, Box::new(RevalidateCallback), true, downloader);
+                let handle = TaskHandle::new(task_id);
+                handle.set_completed();
+                Some(handle)
+            }
+            Err(callback) => self.preload(request, callback, true, downloader),
+        }
+    }
+
+    /// Subscribes to the body of a URL without starting a download.
+    ///
+    /// The callback is attached to the running download of the URL, if any,
+    /// and receives the already buffered bytes followed by the rest of the body
+    /// through `on_data_chunk`. A URL that is already cached is delivered from
+    /// the cache instead.
+    ///
+    /// # Parameters
+    /// - `url`: URL of the content to subscribe to
+    /// - `callback`: Callback to receive download events
+    ///
+    /// # Returns
+    /// A task handle if the URL is being downloaded or cached, `None` otherwise
+    pub fn stream(
+        &'static self,
+        url: &str,
+        mut callback: Box<dyn PreloadCallback>,
+    ) -> Option<TaskHandle> {
+        let task_id = TaskId::from_url(url);
+        let task = self.running_tasks.lock().unwrap().get(&task_id).cloned();
+        if let Some(task) = task {
+            let mut task = task.lock().unwrap();
+            match task.try_add_callback(callback) {
+                Ok(()) => {
+                    info!("stream {} attached", task_id.brief());
+                    return Some(task.task_handle());
+                }
+                Err(cb) => callback = cb,
+            }
+        }
+
+        // The download finished before the callback could be attached.
+        if self.fetch_with_callback(&task_id, callback).is_ok() {
+            info!("stream {} fetch success", task_id.brief());
+            let handle = TaskHandle::new(task_id);
+            handle.set_completed();
+            Some(handle)
+        } else {
+            info!("stream {} not found", task_id.brief());
+            None
+        }
+    }
+
     /// Fetches cached content for a URL.
     ///
     /// # Parameters
@@ -369,6 +734,34 @@ impl CacheDownloadService {
         self.cache_manager.fetch(&task_id)
     }
 
+    /// Fetches cached content for a URL, mapping large cache files instead of
+    /// loading them into RAM.
+    ///
+    /// # Parameters
+    /// - `url`: URL of the content to fetch
+    ///
+    /// # Returns
+    /// The cached content if found
+    pub fn fetch_data(&'static self, url: &str) -> Option<CacheData> {
+        let task_id = TaskId::from_url(url);
+        self.cache_manager.fetch_data(&task_id)
+    }
+
+    /// Fetches a window of the cached content for a URL, without loading the
+    /// rest of it into RAM.
+    ///
+    /// # Parameters
+    /// - `url`: URL of the content to fetch
+    /// - `offset`: Position of the window in the content
+    /// - `len`: Length of the window, cut at the end of the content
+    ///
+    /// # Returns
+    /// The window of the cached content if found
+    pub fn fetch_range(&self, url: &str, offset: u64, len: u64) -> Option<CacheData> {
+        let task_id = TaskId::from_url(url);
+        self.cache_manager.fetch_range(&task_id, offset, len)
+    }
+
     /// Handles task completion notification.
     ///
     /// Removes the task from tracking if the sequence number matches the current task.
@@ -396,6 +789,31 @@ impl CacheDownloadService {
         self.cache_manager.set_file_cache_size(size);
     }
 
+    /// Sizes the file cache to a share of the free space of its disk, within
+    /// bounds, until a fixed size is set again.
+    ///
+    /// # Parameters
+    /// - `percent`: Share of the free space taken, at most 100
+    /// - `min`: Smallest file cache size in bytes
+    /// - `max`: Largest file cache size in bytes
+    pub fn set_adaptive_file_cache_size(&'static self, percent: u8, min: u64, max: u64) {
+        self.cache_manager
+            .set_adaptive_file_cache_size(percent, min, max);
+    }
+
+    /// Checks the file caches restored from a previous run against their
+    /// CRC-32C in the background, discarding corrupted ones.
+    ///
+    /// Without this pass each file cache is checked the first time it is
+    /// served.
+    ///
+    /// # Parameters
+    /// - `bytes_per_sec`: Most bytes read per second, 0 for no limit
+    pub fn verify_file_caches(&'static self, bytes_per_sec: u64) {
+        info!("verify file caches at {} bytes per sec", bytes_per_sec);
+        self.cache_manager.verify_file_caches(bytes_per_sec);
+    }
+
     /// Sets the maximum RAM cache size.
     ///
     /// # Parameters
@@ -405,6 +823,72 @@ impl CacheDownloadService {
         self.cache_manager.set_ram_cache_size(size);
     }
 
+    /// Sets the largest body that is kept in the RAM cache.
+    ///
+    /// Larger bodies are only cached in files.
+    ///
+    /// # Parameters
+    /// - `size`: Maximum size in bytes of a single RAM cache entry
+    pub fn set_ram_entry_max_size(&self, size: u64) {
+        info!("set ram entry max size to {}", size);
+        self.cache_manager.set_ram_entry_max_size(size);
+    }
+
+    /// Sets how many downloads use the network at the same time.
+    ///
+    /// Downloads started beyond the limits wait until a running one finishes,
+    /// highest priority first.
+    ///
+    /// # Parameters
+    /// - `max_running`: Maximum number of running downloads, 16 by default
+    /// - `max_per_host`: Maximum number of running downloads to the same
+    ///   host, 6 by default
+    pub fn set_download_limits(&'static self, max_running: usize, max_per_host: usize) {
+        info!("set download limits to {} {}", max_running, max_per_host);
+        self.scheduler.set_limits(max_running, max_per_host);
+    }
+
+    /// Resolves an origin and opens a connection to it in the background, so
+    /// the first load from it can skip the DNS lookup and handshakes.
+    ///
+    /// # Parameters
+    /// - `origin`: Scheme, host and optional port, such as
+    ///   `https://example.com`, a path is ignored
+    ///
+    /// # Returns
+    /// `false` if the origin is not a valid `http` or `https` origin
+    pub fn prewarm(&'static self, origin: &str) -> bool {
+        self.prewarmer.prewarm(origin)
+    }
+
+    /// Sets the eviction policy of the RAM cache.
+    ///
+    /// # Parameters
+    /// - `policy`: New eviction policy, the hit counters restart from zero
+    pub fn set_ram_cache_policy(&self, policy: RamCachePolicy) {
+        info!("set ram cache policy to {:?}", policy);
+        self.cache_manager.set_ram_cache_policy(policy);
+    }
+
+    /// Returns the RAM cache hit and miss counts of fetches since the policy
+    /// was last set.
+    pub fn ram_cache_stats(&self) -> CacheStats {
+        self.cache_manager.ram_cache_stats()
+    }
+
+    /// Returns the memory held by the RAM caches, including the bodies
+    /// waiting to be written to the file cache.
+    pub fn memory_stats(&self) -> MemoryStats {
+        self.cache_manager.memory_stats()
+    }
+
+    /// Returns the hold times of the cache locks since the last reset, and
+    /// resets them if `reset`.
+    #[cfg(feature = "lock_stats")]
+    pub fn lock_stats(&self, reset: bool) -> cache_core::CacheLockStats {
+        self.cache_manager.lock_stats(reset)
+    }
+
     /// Sets the maximum number of download info entries to keep.
     ///
     /// # Parameters
@@ -425,6 +909,42 @@ impl CacheDownloadService {
         self.info_mgr.get_download_info(task_id)
     }
 
+    /// Returns timing percentiles of the downloads finished within a window,
+    /// grouped by origin.
+    ///
+    /// # Parameters
+    /// - `window_secs`: Length of the window ending now, in seconds
+    pub fn timing_stats(&self, window_secs: u64) -> Vec<OriginStats> {
+        self.info_mgr.timing_stats(Duration::from_secs(window_secs))
+    }
+
+    /// Sets how long the failed downloads of a kind are reported again
+    /// without downloading, 0 to always download again.
+    ///
+    /// By default HTTP errors, such as a missing resource, are remembered for
+    /// 30 seconds and DNS errors for 10 seconds. Failures already remembered
+    /// follow the new time.
+    ///
+    /// # Parameters
+    /// - `kind`: Kind of the errors
+    /// - `secs`: Seconds a failure is remembered for
+    pub fn set_failure_ttl(&self, kind: ErrorKind, secs: u64) {
+        info!("set failure ttl of {:?} to {}", kind, secs);
+        self.failures.set_ttl(kind, secs);
+    }
+
+    /// Remembers the failure of a download, if its kind is remembered.
+    pub(crate) fn download_failed(&self, task_id: &TaskId, error: &CacheDownloadError) {
+        self.failures.record(task_id, error);
+    }
+
+    /// Returns how long the last download of a task took, in milliseconds.
+    pub(crate) fn download_time(&self, task_id: &TaskId) -> Option<f64> {
+        self.info_mgr
+            .get_download_info(task_id.clone())
+            .map(|info| info.total_time())
+    }
+
     /// Clears all memory cache.
     pub fn clear_memory_cache(&self) {
         let running_tasks = self
@@ -438,6 +958,15 @@ impl CacheDownloadService {
         info!("clear memory cache");
     }
 
+    /// Trims the memory cache to a share of its size under memory pressure,
+    /// the evicted bodies are kept in the file cache.
+    ///
+    /// # Parameters
+    /// - `level`: Memory pressure reported by the system
+    pub fn trim_memory_cache(&'static self, level: MemoryLevel) {
+        self.cache_manager.trim_memory_cache(level);
+    }
+
     /// Clears all file cache.
     pub fn clear_file_cache(&self) {
         let running_tasks = self
@@ -451,6 +980,33 @@ impl CacheDownloadService {
         info!("clear file cache");
     }
 
+    /// Reports a recent failure of a task to a callback, marked as cached.
+    ///
+    /// # Parameters
+    /// - `task_id`: ID of the task to look up
+    /// - `callback`: Callback to notify of the failure or return without one
+    ///
+    /// # Returns
+    /// A failed handle if the task failed recently, Err(callback) otherwise
+    fn fail_with_callback(
+        &self,
+        task_id: &TaskId,
+        mut callback: Box<dyn PreloadCallback>,
+    ) -> Result<TaskHandle, Box<dyn PreloadCallback>> {
+        let Some(error) = self.failures.get(task_id) else {
+            return Err(callback);
+        };
+        info!("{} failed recently", task_id.brief());
+        let brief = task_id.brief().to_string();
+        crate::spawn(move || {
+            let info = RustDownloadInfo::from_download_info(DownloadInfo::new());
+            callback.on_fail(error, info, &brief)
+        });
+        let handle = TaskHandle::new(task_id.clone());
+        handle.set_failed();
+        Ok(handle)
+    }
+
     /// Fetches content from cache with callback notification.
     ///
     /// # Parameters
@@ -467,7 +1023,10 @@ impl CacheDownloadService {
         let task_id = task_id.clone();
         if let Some(cache) = self.cache_manager.fetch(&task_id) {
             // Spawn callback in a separate thread to avoid blocking
-            crate::spawn(move || callback.on_success(cache, task_id.brief()));
+            crate::spawn(move || {
+                replay_chunks(callback.as_mut(), cache.chunks());
+                callback.on_success(cache, task_id.brief())
+            });
             Ok(())
         } else {
             Err(callback)
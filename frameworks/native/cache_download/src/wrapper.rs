@@ -22,16 +22,38 @@ use std::sync::{mpsc, Arc, Mutex};
 
 // External dependencies for cache core and FFI bridge
 use cache_core::observe::observe_image_file_delete;
-use cache_core::RamCache;
+use cache_core::{CacheData, MemoryLevel, RamCache, RamCachePolicy};
 use cxx::{SharedPtr, UniquePtr};
 use ffi::{FfiPredownloadOptions, PreloadCallbackWrapper, PreloadProgressCallbackWrapper};
+use netstack_rs::stats::Percentiles;
 
 // Internal dependencies from cache_download
 use crate::download::task::{Downloader, TaskHandle};
-use crate::download::CacheDownloadError;
+use crate::download::{CacheDownloadError, ErrorKind};
 use crate::info::RustDownloadInfo;
 use crate::services::{CacheDownloadService, DownloadRequest, PreloadCallback};
 
+/// `CacheStrategy::LAZY` of the C++ interface.
+const CACHE_STRATEGY_LAZY: u32 = 1;
+
+/// `CacheStrategy::STALE_WHILE_REVALIDATE` of the C++ interface.
+const CACHE_STRATEGY_STALE_WHILE_REVALIDATE: u32 = 2;
+
+/// `RamCachePolicy::TINY_LFU` of the C++ interface.
+const RAM_CACHE_POLICY_TINY_LFU: u32 = 1;
+
+/// `RamCachePolicy::GREEDY_DUAL_SIZE` of the C++ interface.
+const RAM_CACHE_POLICY_GREEDY_DUAL_SIZE: u32 = 2;
+
+/// `MEMORY_LEVEL_MODERATE` of the memory levels of the system.
+const MEMORY_LEVEL_MODERATE: i32 = 0;
+
+/// `MEMORY_LEVEL_LOW` of the memory levels of the system.
+const MEMORY_LEVEL_LOW: i32 = 1;
+
+/// `MEMORY_LEVEL_CRITICAL` of the memory levels of the system.
+const MEMORY_LEVEL_CRITICAL: i32 = 2;
+
 /// FFI implementation of the PreloadCallback trait for C++ interoperability.
 ///
 /// Translates Rust download events into C++ callback invocations, managing
@@ -45,6 +67,8 @@ pub(super) struct FfiCallback {
     tx: Option<mpsc::Sender<(u64, u64)>>,
     /// Mutex to track if download is finished
     finish_lock: Arc<Mutex<bool>>,
+    /// Whether the C++ callback handles body chunks
+    stream: bool,
 }
 
 // Safety: FfiCallback is Send because it contains Send-compatible components
@@ -66,29 +90,33 @@ impl FfiCallback {
         callback: UniquePtr<PreloadCallbackWrapper>,
         progress_callback: SharedPtr<PreloadProgressCallbackWrapper>,
     ) -> Self {
+        let stream = !callback.is_null() && callback.HasDataChunk();
         Self {
             callback,
             progress_callback,
             tx: None,
             finish_lock: Arc::new(Mutex::new(false)),
+            stream,
         }
     }
 }
 
 /// Rust data wrapper for exposing cached content to C++.
 ///
-/// Provides a safe interface for accessing RamCache data from C++ code.
+/// Provides a safe interface for accessing cached data from C++ code. The
+/// content is either a RamCache or a mapped cache file, and stays valid as
+/// long as the wrapper is alive.
 pub struct RustData {
     /// Underlying cached data
-    data: Arc<RamCache>,
+    data: CacheData,
 }
 
 impl RustData {
     /// Creates a new RustData wrapper.
     ///
     /// # Parameters
-    /// - `data`: Shared reference to the cached data
-    fn new(data: Arc<RamCache>) -> Self {
+    /// - `data`: The cached data
+    fn new(data: CacheData) -> Self {
         Self { data }
     }
 
@@ -97,7 +125,103 @@ impl RustData {
     /// # Returns
     /// A slice of the underlying data bytes
     fn bytes(&self) -> &[u8] {
-        self.data.cursor().get_ref()
+        self.data.bytes()
+    }
+
+    /// Gets the number of chunks holding the cached data.
+    fn chunk_count(&self) -> usize {
+        self.data.chunk_count()
+    }
+
+    /// Gets a chunk of the cached data without copying it.
+    ///
+    /// # Parameters
+    /// - `index`: Index of the chunk, below `chunk_count`
+    fn chunk(&self, index: usize) -> &[u8] {
+        self.data.chunk(index)
+    }
+}
+
+/// URLs and callbacks of a batch preload from C++, holding the task handles
+/// once the batch is started.
+pub struct PreloadBatch {
+    /// URLs to preload
+    urls: Vec<String>,
+    /// Callback of each URL
+    callbacks: Vec<FfiCallback>,
+    /// Task handle of each URL after the batch is started
+    handles: Vec<Option<TaskHandle>>,
+}
+
+impl PreloadBatch {
+    /// Adds a URL with its callbacks to the batch.
+    ///
+    /// # Parameters
+    /// - `url`: URL to preload
+    /// - `callback`: C++ callback for completion events
+    /// - `progress_callback`: C++ callback for progress events
+    fn push(
+        &mut self,
+        url: &str,
+        callback: UniquePtr<PreloadCallbackWrapper>,
+        progress_callback: SharedPtr<PreloadProgressCallbackWrapper>,
+    ) {
+        self.urls.push(url.to_string());
+        self.callbacks.push(FfiCallback::from_ffi(callback, progress_callback));
+    }
+
+    /// Takes the task handle of a URL of a started batch.
+    ///
+    /// # Parameters
+    /// - `index`: Position of the URL in the batch
+    ///
+    /// # Returns
+    /// A C++ shared pointer to a PreloadHandle, null if no download was started
+    fn take_handle(&mut self, index: usize) -> SharedPtr<ffi::PreloadHandle> {
+        match self.handles.get_mut(index).and_then(Option::take) {
+            Some(handle) => ffi::ShareTaskHandle(Box::new(handle)),
+            None => SharedPtr::null(),
+        }
+    }
+}
+
+/// Creates an empty batch of URLs to preload.
+fn preload_batch() -> Box<PreloadBatch> {
+    Box::new(PreloadBatch {
+        urls: Vec::new(),
+        callbacks: Vec::new(),
+        handles: Vec::new(),
+    })
+}
+
+/// Applies the download options from C++ to a request.
+///
+/// # Parameters
+/// - `request`: Request to configure
+/// - `options`: Additional download options from C++
+fn apply_options<'a>(request: &mut DownloadRequest<'a>, options: &FfiPredownloadOptions<'a>) {
+    // Convert C++ headers format to Rust format
+    if !options.headers.is_empty() {
+        let headers = options
+            .headers
+            .chunks(2)
+            .map(|a| (a[0], a[1]))
+            .collect::<Vec<(&str, &str)>>();
+        request.headers(headers);
+    }
+
+    // Add SSL configuration if provided
+    if !options.ssl_type.is_empty() {
+        request.ssl_type(options.ssl_type);
+    }
+    if !options.ca_path.is_empty() {
+        request.ca_path(options.ca_path);
+    }
+    request.priority(options.priority);
+    request.compression(options.compression);
+    request.shared(options.shared);
+    if !options.tag.is_empty() {
+        request.tag(options.tag);
     }
 }
 
@@ -114,7 +238,7 @@ impl PreloadCallback for FfiCallback {
         if self.callback.is_null() {
             return;
         }
-        let rust_data = RustData::new(data);
+        let rust_data = RustData::new(CacheData::Ram(data));
         let shared_data = ffi::SharedData(Box::new(rust_data));
         self.callback.OnSuccess(shared_data, task_id);
     }
@@ -202,6 +326,17 @@ impl PreloadCallback for FfiCallback {
             }
         });
     }
+
+    /// Forwards a piece of the body to the C++ chunk callback, if it has one.
+    ///
+    /// # Parameters
+    /// - `data`: Body bytes, only valid during the call
+    /// - `offset`: Position of `data` in the body
+    fn on_data_chunk(&mut self, data: &[u8], offset: u64) {
+        if self.stream {
+            self.callback.OnDataChunk(data, offset);
+        }
+    }
 }
 
 impl CacheDownloadService {
@@ -214,7 +349,7 @@ impl CacheDownloadService {
     /// - `url`: URL to download
     /// - `callback`: C++ callback for completion events
     /// - `progress_callback`: C++ callback for progress events
-    /// - `update`: Whether to update existing cached content
+    /// - `strategy`: `CacheStrategy` value, how existing cached content is used
     /// - `options`: Additional download options from C++
     ///
     /// # Returns
@@ -224,44 +359,189 @@ impl CacheDownloadService {
         url: &str,
         callback: cxx::UniquePtr<PreloadCallbackWrapper>,
         progress_callback: cxx::SharedPtr<PreloadProgressCallbackWrapper>,
-        update: bool,
+        strategy: u32,
         options: &FfiPredownloadOptions,
     ) -> SharedPtr<ffi::PreloadHandle> {
         let callback = FfiCallback::from_ffi(callback, progress_callback);
         let mut request = DownloadRequest::new(url);
+        apply_options(&mut request, options);
 
-        // Convert C++ headers format to Rust format
-        if !options.headers.is_empty() {
-            let headers = options
-                .headers
-                .chunks(2)
-                .map(|a| (a[0], a[1]))
-                .collect::<Vec<(&str, &str)>>();
-            request.headers(headers);
+        // Perform preload and convert the result to C++ format
+        let callback = Box::new(callback);
+        let handle = match strategy {
+            CACHE_STRATEGY_STALE_WHILE_REVALIDATE => {
+                self.preload_stale(request, callback, Downloader::Netstack)
+            }
+            CACHE_STRATEGY_LAZY => self.preload(request, callback, false, Downloader::Netstack),
+            _ => self.preload(request, callback, true, Downloader::Netstack),
+        };
+        match handle {
+            Some(handle) => ffi::ShareTaskHandle(Box::new(handle)),
+            None => SharedPtr::null(),
         }
+    }
 
-        // Add SSL configuration if provided
-        if !options.ssl_type.is_empty() {
-            request.ssl_type(options.ssl_type);
-        }
-        if !options.ca_path.is_empty() {
-            request.ca_path(options.ca_path);
+    /// FFI-compatible batch preload method for C++.
+    ///
+    /// Starts the downloads of all URLs in the batch with the same options,
+    /// the task handles are then taken from the batch.
+    ///
+    /// # Parameters
+    /// - `batch`: URLs and callbacks to preload
+    /// - `strategy`: `CacheStrategy` value, how existing cached content is used
+    /// - `options`: Download options shared by every URL
+    fn ffi_preload_batch(
+        &'static self,
+        batch: &mut PreloadBatch,
+        strategy: u32,
+        options: &FfiPredownloadOptions,
+    ) {
+        let requests = batch
+            .urls
+            .iter()
+            .zip(batch.callbacks.drain(..))
+            .map(|(url, callback)| {
+                let mut request = DownloadRequest::new(url);
+                apply_options(&mut request, options);
+                (request, Box::new(callback) as Box<dyn PreloadCallback>)
+            })
+            .collect::<Vec<_>>();
+        let handles = match strategy {
+            // Each stale copy is served and refreshed on its own
+            CACHE_STRATEGY_STALE_WHILE_REVALIDATE => requests
+                .into_iter()
+                .map(|(request, callback)| {
+                    self.preload_stale(request, callback, Downloader::Netstack)
+                })
+                .collect(),
+            CACHE_STRATEGY_LAZY => self.preload_batch(requests, false, Downloader::Netstack),
+            _ => self.preload_batch(requests, true, Downloader::Netstack),
+        };
+        batch.handles = handles;
+    }
+
+    /// FFI-compatible method to set the RAM cache eviction policy.
+    ///
+    /// # Parameters
+    /// - `policy`: `RamCachePolicy` value of the C++ interface, unknown values
+    ///   select LRU
+    fn ffi_set_ram_cache_policy(&self, policy: u32) {
+        let policy = match policy {
+            RAM_CACHE_POLICY_TINY_LFU => RamCachePolicy::TinyLfu,
+            RAM_CACHE_POLICY_GREEDY_DUAL_SIZE => RamCachePolicy::GreedyDualSize,
+            _ => RamCachePolicy::Lru,
+        };
+        self.set_ram_cache_policy(policy);
+    }
+
+    /// FFI-compatible method to set how long failed downloads are remembered.
+    ///
+    /// # Parameters
+    /// - `kind`: `ErrorKind` value of the C++ interface, unknown kinds are
+    ///   ignored
+    /// - `secs`: Seconds a failure is remembered for, 0 to forget them
+    fn ffi_set_failure_ttl(&self, kind: i32, secs: u64) {
+        match ErrorKind::from_ffi(kind) {
+            Some(kind) => self.set_failure_ttl(kind, secs),
+            None => error!("set failure ttl of unknown kind {}", kind),
         }
+    }
 
-        // Perform preload and convert the result to C++ format
-        match self.preload(request, Box::new(callback), update, Downloader::Netstack) {
+    /// FFI-compatible method to trim the memory cache under memory pressure.
+    ///
+    /// # Parameters
+    /// - `level`: Memory level reported by the system, unknown levels are
+    ///   ignored
+    fn ffi_trim_memory_cache(&'static self, level: i32) {
+        let level = match level {
+            MEMORY_LEVEL_MODERATE => MemoryLevel::Moderate,
+            MEMORY_LEVEL_LOW => MemoryLevel::Low,
+            MEMORY_LEVEL_CRITICAL => MemoryLevel::Critical,
+            _ => return,
+        };
+        self.trim_memory_cache(level);
+    }
+
+    /// Returns the RAM cache hits of fetches since the policy was last set.
+    fn ram_cache_hits(&self) -> u64 {
+        self.ram_cache_stats().hits
+    }
+
+    /// Returns the RAM cache misses of fetches since the policy was last set.
+    fn ram_cache_misses(&self) -> u64 {
+        self.ram_cache_stats().misses
+    }
+
+    /// FFI-compatible stream method for C++.
+    ///
+    /// # Parameters
+    /// - `url`: URL to subscribe to
+    /// - `callback`: C++ callback for completion and chunk events
+    /// - `progress_callback`: C++ callback for progress events
+    ///
+    /// # Returns
+    /// A C++ shared pointer to a PreloadHandle if the URL is being downloaded
+    /// or cached, null otherwise
+    fn ffi_stream(
+        &'static self,
+        url: &str,
+        callback: cxx::UniquePtr<PreloadCallbackWrapper>,
+        progress_callback: cxx::SharedPtr<PreloadProgressCallbackWrapper>,
+    ) -> SharedPtr<ffi::PreloadHandle> {
+        let callback = FfiCallback::from_ffi(callback, progress_callback);
+        match self.stream(url, Box::new(callback)) {
             Some(handle) => ffi::ShareTaskHandle(Box::new(handle)),
             None => SharedPtr::null(),
         }
     }
 
     fn ffi_fetch(&'static self, url: &str) -> UniquePtr<ffi::Data> {
-        match self.fetch(url).map(RustData::new) {
+        match self.fetch_data(url).map(RustData::new) {
+            Some(data) => ffi::UniqueData(Box::new(data)),
+            _ => UniquePtr::null(),
+        }
+    }
+
+    /// FFI-compatible method fetching a window of cached data for C++.
+    fn ffi_fetch_range(&self, url: &str, offset: u64, len: u64) -> UniquePtr<ffi::Data> {
+        match self.fetch_range(url, offset, len).map(RustData::new) {
             Some(data) => ffi::UniqueData(Box::new(data)),
             _ => UniquePtr::null(),
         }
     }
 
+    /// FFI-compatible memory statistics method for C++.
+    fn ffi_memory_stats(&self) -> ffi::FfiMemoryStats {
+        let stats = self.memory_stats();
+        ffi::FfiMemoryStats {
+            used: stats.used,
+            total: stats.total,
+            backup_entries: stats.backup_entries,
+            backup_bytes: stats.backup_bytes,
+        }
+    }
+
+    /// FFI-compatible timing statistics method for C++.
+    fn ffi_timing_stats(&self, window_secs: u64) -> Vec<ffi::FfiOriginStats> {
+        let percentiles = |p: Percentiles| ffi::FfiPercentiles {
+            p50: p.p50,
+            p95: p.p95,
+            p99: p.p99,
+        };
+        self.timing_stats(window_secs)
+            .into_iter()
+            .map(|stats| ffi::FfiOriginStats {
+                origin: stats.origin,
+                count: stats.count as u64,
+                dns: percentiles(stats.dns),
+                connect: percentiles(stats.connect),
+                tls: percentiles(stats.tls),
+                ttfb: percentiles(stats.ttfb),
+                total: percentiles(stats.total),
+            })
+            .collect()
+    }
+
     fn ffi_get_download_info(&'static self, url: &str) -> UniquePtr<ffi::CppDownloadInfo> {
         match self.get_download_info(url) {
             Some(info) => ffi::UniqueInfo(Box::new(RustDownloadInfo::from_download_info(info))),
@@ -299,6 +579,36 @@ pub(crate) mod ffi {
         headers: Vec<&'a str>,
         ssl_type: &'a str,
         ca_path: &'a str,
+        priority: i32,
+        compression: bool,
+        shared: bool,
+        tag: &'a str,
+    }
+
+    /// 50th, 95th and 99th percentiles of a timing in milliseconds
+    struct FfiPercentiles {
+        p50: f64,
+        p95: f64,
+        p99: f64,
+    }
+
+    /// Timing percentiles of the downloads from an origin
+    struct FfiOriginStats {
+        origin: String,
+        count: u64,
+        dns: FfiPercentiles,
+        connect: FfiPercentiles,
+        tls: FfiPercentiles,
+        ttfb: FfiPercentiles,
+        total: FfiPercentiles,
+    }
+
+    /// Memory held by the RAM caches
+    struct FfiMemoryStats {
+        used: u64,
+        total: u64,
+        backup_entries: usize,
+        backup_bytes: u64,
     }
 
     // Rust functions and types exposed to C++
@@ -308,9 +618,12 @@ pub(crate) mod ffi {
         type TaskHandle;
         type CacheDownloadError;
         type RustDownloadInfo;
+        type PreloadBatch;
 
         // RustData methods
         fn bytes(self: &RustData) -> &[u8];
+        fn chunk_count(self: &RustData) -> usize;
+        fn chunk(self: &RustData, index: usize) -> &[u8];
 
         // CacheDownloadService methods
         fn ffi_preload(
@@ -318,14 +631,53 @@ pub(crate) mod ffi {
             url: &str,
             callback: UniquePtr<PreloadCallbackWrapper>,
             progress_callback: SharedPtr<PreloadProgressCallbackWrapper>,
-            update: bool,
+            strategy: u32,
             options: &FfiPredownloadOptions,
         ) -> SharedPtr<PreloadHandle>;
+        fn ffi_preload_batch(
+            self: &'static CacheDownloadService,
+            batch: &mut PreloadBatch,
+            strategy: u32,
+            options: &FfiPredownloadOptions,
+        );
+        fn ffi_stream(
+            self: &'static CacheDownloadService,
+            url: &str,
+            callback: UniquePtr<PreloadCallbackWrapper>,
+            progress_callback: SharedPtr<PreloadProgressCallbackWrapper>,
+        ) -> SharedPtr<PreloadHandle>;
         fn ffi_fetch(self: &'static CacheDownloadService, url: &str) -> UniquePtr<Data>;
+        fn ffi_fetch_range(
+            self: &CacheDownloadService,
+            url: &str,
+            offset: u64,
+            len: u64,
+        ) -> UniquePtr<Data>;
 
         fn set_file_cache_size(self: &CacheDownloadService, size: u64);
+        fn set_adaptive_file_cache_size(
+            self: &'static CacheDownloadService,
+            percent: u8,
+            min: u64,
+            max: u64,
+        );
+        fn verify_file_caches(self: &'static CacheDownloadService, bytes_per_sec: u64);
         fn set_ram_cache_size(self: &CacheDownloadService, size: u64);
+        fn set_ram_entry_max_size(self: &CacheDownloadService, size: u64);
+        fn set_download_limits(
+            self: &'static CacheDownloadService,
+            max_running: usize,
+            max_per_host: usize,
+        );
+        fn prewarm(self: &'static CacheDownloadService, origin: &str) -> bool;
+        fn ffi_set_ram_cache_policy(self: &CacheDownloadService, policy: u32);
+        fn ffi_trim_memory_cache(self: &'static CacheDownloadService, level: i32);
+        fn ffi_set_failure_ttl(self: &CacheDownloadService, kind: i32, secs: u64);
+        fn ram_cache_hits(self: &CacheDownloadService) -> u64;
+        fn ram_cache_misses(self: &CacheDownloadService) -> u64;
+        fn ffi_memory_stats(self: &CacheDownloadService) -> FfiMemoryStats;
         fn set_info_list_size(self: &CacheDownloadService, size: u16);
+        fn ffi_timing_stats(self: &CacheDownloadService, window_secs: u64) -> Vec<FfiOriginStats>;
 
         fn dns_time(self: &RustDownloadInfo) -> f64;
         fn connect_time(self: &RustDownloadInfo) -> f64;
@@ -337,16 +689,32 @@ pub(crate) mod ffi {
         fn resource_size(self: &RustDownloadInfo) -> i64;
         fn server_addr(self: &RustDownloadInfo) -> String;
         fn dns_servers(self: &RustDownloadInfo) -> Vec<String>;
+        fn connection_reused(self: &RustDownloadInfo) -> bool;
+        fn pool_hits(self: &RustDownloadInfo) -> u64;
+        fn pool_misses(self: &RustDownloadInfo) -> u64;
 
         fn ffi_get_download_info(
             self: &'static CacheDownloadService,
             url: &str,
         ) -> UniquePtr<CppDownloadInfo>;
 
+        // PreloadBatch methods
+        fn preload_batch() -> Box<PreloadBatch>;
+        fn push(
+            self: &mut PreloadBatch,
+            url: &str,
+            callback: UniquePtr<PreloadCallbackWrapper>,
+            progress_callback: SharedPtr<PreloadProgressCallbackWrapper>,
+        );
+        fn take_handle(self: &mut PreloadBatch, index: usize) -> SharedPtr<PreloadHandle>;
+
         fn cache_download_service() -> *const CacheDownloadService;
         fn set_file_cache_path(path: String);
         fn cancel(self: &CacheDownloadService, url: &str);
         fn remove(self: &CacheDownloadService, url: &str);
+        fn cancel_tag(self: &CacheDownloadService, tag: &str);
+        fn set_tag_priority(self: &CacheDownloadService, tag: &str, priority: i32);
+        fn remove_tag(self: &CacheDownloadService, tag: &str);
         fn contains(self: &CacheDownloadService, url: &str) -> bool;
         fn clear_memory_cache(self: &CacheDownloadService);
         fn clear_file_cache(self: &CacheDownloadService);
@@ -355,11 +723,13 @@ pub(crate) mod ffi {
         fn task_id(self: &TaskHandle) -> String;
         fn is_finish(self: &TaskHandle) -> bool;
         fn state(self: &TaskHandle) -> usize;
+        fn set_priority(self: &TaskHandle, priority: i32);
 
         // CacheDownloadError methods
         fn code(self: &CacheDownloadError) -> i32;
         fn message(self: &CacheDownloadError) -> &str;
         fn ffi_kind(self: &CacheDownloadError) -> i32;
+        fn is_cached(self: &CacheDownloadError) -> bool;
     }
 
     // C++ types and functions imported into Rust
@@ -382,6 +752,10 @@ pub(crate) mod ffi {
         fn UniqueData(data: Box<RustData>) -> UniquePtr<Data>;
         fn UniqueInfo(data: Box<RustDownloadInfo>) -> UniquePtr<CppDownloadInfo>;
 
+        // Cache shared with other applications by the request service
+        fn OpenSharedCache(url: &str) -> i32;
+        fn PublishSharedCache(url: &str, fd: i32) -> i32;
+
         // C++ callback methods
         fn OnSuccess(self: &PreloadCallbackWrapper, data: SharedPtr<Data>, task_id: &str);
         fn OnFail(
@@ -391,6 +765,8 @@ pub(crate) mod ffi {
             task_id: &str,
         );
         fn OnCancel(self: &PreloadCallbackWrapper);
+        fn HasDataChunk(self: &PreloadCallbackWrapper) -> bool;
+        fn OnDataChunk(self: &PreloadCallbackWrapper, data: &[u8], offset: u64);
         fn OnProgress(self: &PreloadProgressCallbackWrapper, progress: u64, total: u64);
     }
 }
@@ -0,0 +1,94 @@
+// Copyright (C) 2024 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use std::io;
+
+use super::*;
+
+fn io_error() -> CacheDownloadError {
+    CacheDownloadError::from(io::Error::from(io::ErrorKind::NotFound))
+}
+
+// @tc.name: ut_failures_remembered
+// @tc.desc: Test that failures are remembered by the time of their kind
+// @tc.precon: NA
+// @tc.step: 1. Record an IO failure with the default time of IO errors
+//           2. Give IO errors a time and record the failure again
+//           3. Remove the failure
+// @tc.expect: The failure is remembered only once its kind has a time, it is
+//             reported marked as cached, and removing it forgets it
+// @tc.type: FUNC
+// @tc.require: issue#ICN31I
+// @tc.level: level1
+#[test]
+fn ut_failures_remembered() {
+    let failures = FailureCache::new();
+    let task_id = TaskId::from_url("https://example.com/missing.png");
+    failures.record(&task_id, &io_error());
+    assert!(failures.get(&task_id).is_none());
+
+    failures.set_ttl(ErrorKind::Io, 30);
+    failures.record(&task_id, &io_error());
+    let error = failures.get(&task_id).unwrap();
+    assert!(error.is_cached());
+    assert!(!io_error().is_cached());
+    assert_eq!(error.message(), io_error().message());
+
+    failures.remove(&task_id);
+    assert!(failures.get(&task_id).is_none());
+}
+
+// @tc.name: ut_failures_expired
+// @tc.desc: Test that failures are forgotten once their time is over
+// @tc.precon: NA
+// @tc.step: 1. Record a failure of a kind with a time
+//           2. Set the time of the kind to 0
+// @tc.expect: The failure is no longer reported
+// @tc.type: FUNC
+// @tc.require: issue#ICN31I
+// @tc.level: level1
+#[test]
+fn ut_failures_expired() {
+    let failures = FailureCache::new();
+    let task_id = TaskId::from_url("https://example.com/expired.png");
+    failures.set_ttl(ErrorKind::Io, 30);
+    failures.record(&task_id, &io_error());
+    assert!(failures.get(&task_id).is_some());
+
+    failures.set_ttl(ErrorKind::Io, 0);
+    assert!(failures.get(&task_id).is_none());
+}
+
+// @tc.name: ut_failures_bounded
+// @tc.desc: Test the bound of the remembered failures
+// @tc.precon: NA
+// @tc.step: 1. Record more failures than the bound
+// @tc.expect: The oldest failures are forgotten, the newest are reported
+// @tc.type: FUNC
+// @tc.require: issue#ICN31I
+// @tc.level: level1
+#[test]
+fn ut_failures_bounded() {
+    let failures = FailureCache::new();
+    failures.set_ttl(ErrorKind::Io, 30);
+    let task_ids: Vec<_> = (0..MAX_FAILURES + 1)
+        .map(|i| TaskId::from_url(&format!("https://example.com/{}.png", i)))
+        .collect();
+    for task_id in task_ids.iter() {
+        failures.record(task_id, &io_error());
+    }
+    assert!(failures.get(&task_ids[0]).is_none());
+    for task_id in task_ids[1..].iter() {
+        assert!(failures.get(task_id).is_some());
+    }
+}
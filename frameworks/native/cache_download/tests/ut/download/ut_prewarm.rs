@@ -0,0 +1,68 @@
+// Copyright (C) 2024 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use super::*;
+
+fn origin(scheme: &str, host: &str, port: u16) -> Origin {
+    Origin {
+        scheme: scheme.to_string(),
+        host: host.to_string(),
+        port,
+    }
+}
+
+// @tc.name: ut_prewarm_origin_parse
+// @tc.desc: Test parsing the origin to prewarm
+// @tc.precon: NA
+// @tc.step: 1. Parse origins with default and explicit ports, paths and user info
+//           2. Parse origins with unsupported schemes and empty hosts
+// @tc.expect: Valid origins give the lowercase host and port, others give None
+// @tc.type: FUNC
+// @tc.require: issue#ICN31I
+// @tc.level: level1
+#[test]
+fn ut_prewarm_origin_parse() {
+    assert!(Origin::parse("https://Example.com") == Some(origin("https", "example.com", 443)));
+    assert!(Origin::parse("HTTP://example.com/a.png") == Some(origin("http", "example.com", 80)));
+    let parsed = Origin::parse("https://u:p@example.com:8443?x");
+    assert!(parsed == Some(origin("https", "example.com", 8443)));
+    assert!(Origin::parse("https://[::1]/") == Some(origin("https", "[::1]", 443)));
+    assert!(Origin::parse("https://[::1]:8080") == Some(origin("https", "[::1]", 8080)));
+    assert!(Origin::parse("ftp://example.com").is_none());
+    assert!(Origin::parse("https:///path").is_none());
+    assert!(Origin::parse("https://example.com:port").is_none());
+    assert!(Origin::parse("example.com").is_none());
+}
+
+// @tc.name: ut_prewarm_dns_ttl
+// @tc.desc: Test that resolved addresses expire after the TTL
+// @tc.precon: NA
+// @tc.step: 1. Insert resolved addresses of an origin
+//           2. Look them up before and after DNS_TTL
+// @tc.expect: The addresses are returned only before DNS_TTL has passed
+// @tc.type: FUNC
+// @tc.require: issue#ICN31I
+// @tc.level: level1
+#[test]
+fn ut_prewarm_dns_ttl() {
+    let prewarmer = Prewarmer::new();
+    let origin = origin("https", "example.com", 443);
+    let addr: SocketAddr = "127.0.0.1:443".parse().unwrap();
+    let now = Instant::now();
+    prewarmer.insert(origin.clone(), vec![addr], now);
+
+    assert_eq!(prewarmer.addresses_at(&origin, now), Some(vec![addr]));
+    let later = now + DNS_TTL - Duration::from_secs(1);
+    assert_eq!(prewarmer.addresses_at(&origin, later), Some(vec![addr]));
+    assert_eq!(prewarmer.addresses_at(&origin, now + DNS_TTL), None);
+}
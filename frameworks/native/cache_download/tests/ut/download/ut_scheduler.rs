@@ -0,0 +1,84 @@
+// Copyright (C) 2024 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use std::sync::LazyLock;
+
+use super::*;
+
+static SCHEDULER: LazyLock<Scheduler> = LazyLock::new(Scheduler::new);
+
+fn queued(host: &str, priority: i32, arrival: u64) -> Arc<ScheduledHandle> {
+    Arc::new(ScheduledHandle::new(
+        &SCHEDULER,
+        host.to_string(),
+        priority,
+        arrival,
+        Slot::Done,
+    ))
+}
+
+// @tc.name: ut_scheduler_host
+// @tc.desc: Test extracting the host a download is limited by
+// @tc.precon: NA
+// @tc.step: 1. Call host with URLs carrying ports, user info, paths and queries
+// @tc.expect: The lowercase host and port are returned
+// @tc.type: FUNC
+// @tc.require: issue#ICN31I
+// @tc.level: level1
+#[test]
+fn ut_scheduler_host() {
+    assert_eq!(host("https://Example.com/a/b.png"), "example.com");
+    assert_eq!(host("http://user:pw@example.com:8080?x=1"), "example.com:8080");
+    assert_eq!(host("https://example.com#top"), "example.com");
+    assert_eq!(host("example.com/path"), "example.com");
+}
+
+// @tc.name: ut_scheduler_admit
+// @tc.desc: Test the order waiting downloads are admitted in
+// @tc.precon: NA
+// @tc.step: 1. Queue downloads to two hosts with a per-host limit of 1
+//           2. Admit them with a global limit of 2
+//           3. Raise the priority of a waiting download and admit again
+// @tc.expect: Higher priorities are admitted first, the per-host limit is
+// kept and a raised priority overtakes earlier arrivals
+// @tc.type: FUNC
+// @tc.require: issue#ICN31I
+// @tc.level: level1
+#[test]
+fn ut_scheduler_admit() {
+    let mut state = Scheduler::new().state.into_inner().unwrap();
+    state.max_running = 2;
+    state.max_per_host = 1;
+    let first = queued("a.com", 0, 1);
+    let urgent = queued("a.com", 5, 2);
+    let other = queued("b.com", 0, 3);
+    let later = queued("b.com", 0, 4);
+    state.queue = vec![first.clone(), urgent.clone(), other.clone(), later.clone()];
+
+    let admitted = state.admit();
+    assert_eq!(admitted.len(), 2);
+    assert!(Arc::ptr_eq(&admitted[0], &urgent));
+    assert!(Arc::ptr_eq(&admitted[1], &other));
+    assert_eq!(state.running, 2);
+    assert_eq!(state.hosts.get("a.com"), Some(&1));
+    assert!(state.admit().is_empty());
+
+    state.running = 0;
+    state.hosts.clear();
+    later.set_priority(1);
+    let admitted = state.admit();
+    assert_eq!(admitted.len(), 2);
+    assert!(Arc::ptr_eq(&admitted[0], &later));
+    assert!(Arc::ptr_eq(&admitted[1], &first));
+    assert!(state.queue.is_empty());
+}
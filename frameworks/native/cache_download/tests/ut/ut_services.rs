@@ -435,6 +435,202 @@ fn ut_preload_fetch() {
     assert_eq!(success_flag.load(Ordering::SeqCst), 1);
 }
 
+struct TestCallbackStream {
+    body: Vec<u8>,
+    flag: Arc<AtomicUsize>,
+}
+
+impl PreloadCallback for TestCallbackStream {
+    fn on_data_chunk(&mut self, data: &[u8], offset: u64) {
+        if offset == 0 {
+            self.body.clear();
+        }
+        assert_eq!(offset, self.body.len() as u64);
+        self.body.extend_from_slice(data);
+    }
+
+    fn on_success(&mut self, data: Arc<RamCache>, _task_id: &str) {
+        if data.bytes() == self.body.as_slice() {
+            self.flag.fetch_add(1, Ordering::SeqCst);
+        }
+    }
+}
+
+// @tc.name: ut_preload_stream
+// @tc.desc: Test streaming the body of a running preload
+// @tc.precon: NA
+// @tc.step: 1. Initialize CacheDownloadService
+//           2. Start a preload and subscribe to it with stream
+//           3. Subscribe again after the preload finished
+//           4. Subscribe to a URL that is neither running nor cached
+// @tc.expect: Both subscribers receive the whole body in order through
+// on_data_chunk before on_success, the unknown URL returns None
+// @tc.type: FUNC
+// @tc.require: issue#ICN31I
+// @tc.level: level1
+#[test]
+fn ut_preload_stream() {
+    init();
+    static SERVICE: LazyLock<CacheDownloadService> = LazyLock::new(CacheDownloadService::new);
+    let handle = SERVICE.preload(
+        DownloadRequest::new(TEST_URL),
+        Box::new(TestCallbackN),
+        true,
+        DOWNLOADER,
+    );
+    assert!(handle.is_some());
+
+    let stream_flag = Arc::new(AtomicUsize::new(0));
+    let callback = Box::new(TestCallbackStream {
+        body: vec![],
+        flag: stream_flag.clone(),
+    });
+    let handle = SERVICE.stream(TEST_URL, callback).unwrap();
+    while !handle.is_finish() {
+        thread::sleep(Duration::from_millis(500));
+    }
+
+    let callback = Box::new(TestCallbackStream {
+        body: vec![],
+        flag: stream_flag.clone(),
+    });
+    assert!(SERVICE.stream(TEST_URL, callback).is_some());
+    thread::sleep(Duration::from_millis(500));
+    assert_eq!(stream_flag.load(Ordering::SeqCst), 2);
+
+    let callback = Box::new(TestCallbackN);
+    assert!(SERVICE.stream(ERROR_IP, callback).is_none());
+}
+
+// @tc.name: ut_preload_stale
+// @tc.desc: Test serving a cached copy while it is refreshed
+// @tc.precon: NA
+// @tc.step: 1. Initialize CacheDownloadService
+//           2. Call preload_stale for a URL that is not cached
+//           3. Call preload_stale again after the download finished
+// @tc.expect: The first call downloads the URL, the second one succeeds
+// immediately from the cache with a completed handle
+// @tc.type: FUNC
+// @tc.require: issue#ICN31I
+// @tc.level: level1
+#[test]
+fn ut_preload_stale() {
+    init();
+    static SERVICE: LazyLock<CacheDownloadService> = LazyLock::new(CacheDownloadService::new);
+    let success_flag = Arc::new(AtomicUsize::new(0));
+    let callback = Box::new(TestCallbackS {
+        flag: success_flag.clone(),
+    });
+    let handle = SERVICE
+        .preload_stale(DownloadRequest::new(TEST_URL), callback, DOWNLOADER)
+        .unwrap();
+    while !handle.is_finish() {
+        thread::sleep(Duration::from_millis(500));
+    }
+    thread::sleep(Duration::from_millis(50));
+    assert_eq!(success_flag.load(Ordering::SeqCst), 1);
+
+    let callback = Box::new(TestCallbackS {
+        flag: success_flag.clone(),
+    });
+    let handle = SERVICE
+        .preload_stale(DownloadRequest::new(TEST_URL), callback, DOWNLOADER)
+        .unwrap();
+    assert!(handle.is_finish());
+    thread::sleep(Duration::from_millis(50));
+    assert_eq!(success_flag.load(Ordering::SeqCst), 2);
+}
+
+// @tc.name: ut_preload_batch
+// @tc.desc: Test preloading several requests in one call
+// @tc.precon: NA
+// @tc.step: 1. Initialize CacheDownloadService
+//           2. Call preload_batch with a URL and a second request of the same URL
+//           3. Wait for the returned handles to finish
+// @tc.expect: A handle is returned for each request and both callbacks
+// succeed, the second one attached to the download of the first
+// @tc.type: FUNC
+// @tc.require: issue#ICN31I
+// @tc.level: level1
+#[test]
+fn ut_preload_batch() {
+    init();
+    static SERVICE: LazyLock<CacheDownloadService> = LazyLock::new(CacheDownloadService::new);
+    let success_flag = Arc::new(AtomicUsize::new(0));
+    let requests = (0..2)
+        .map(|_| {
+            let callback: Box<dyn PreloadCallback> = Box::new(TestCallbackS {
+                flag: success_flag.clone(),
+            });
+            (DownloadRequest::new(TEST_URL), callback)
+        })
+        .collect();
+    let handles = SERVICE.preload_batch(requests, true, DOWNLOADER);
+    assert_eq!(handles.len(), 2);
+    for handle in handles {
+        let handle = handle.unwrap();
+        while !handle.is_finish() {
+            thread::sleep(Duration::from_millis(500));
+        }
+    }
+    thread::sleep(Duration::from_millis(50));
+    assert_eq!(success_flag.load(Ordering::SeqCst), 2);
+}
+
+// @tc.name: ut_preload_cancel_tag
+// @tc.desc: Test cancelling the preloads of a tag at once
+// @tc.precon: NA
+// @tc.step: 1. Initialize CacheDownloadService
+//           2. Preload two URLs with a tag and one without
+//           3. Cancel the tag and then remove it
+// @tc.expect: Both preloads of the tag are cancelled, the other one is not,
+// and the tag is forgotten once removed
+// @tc.type: FUNC
+// @tc.require: issue#ICN31I
+// @tc.level: level2
+#[test]
+fn ut_preload_cancel_tag() {
+    init();
+    static SERVICE: LazyLock<CacheDownloadService> = LazyLock::new(CacheDownloadService::new);
+    let cancel_flag = Arc::new(AtomicUsize::new(0));
+    let mut handles = Vec::new();
+    for url in [TEST_URL, "https://www.gitee.com"] {
+        let callback = Box::new(TestCallbackC {
+            flag: cancel_flag.clone(),
+        });
+        let mut request = DownloadRequest::new(url);
+        request.tag("feed");
+        let handle = SERVICE.preload(request, callback, true, DOWNLOADER);
+        handles.push(handle.unwrap());
+    }
+    let other_flag = Arc::new(AtomicUsize::new(0));
+    let callback = Box::new(TestCallbackC {
+        flag: other_flag.clone(),
+    });
+    let other = SERVICE.preload(
+        DownloadRequest::new(TEST_VIDEO_URL),
+        callback,
+        true,
+        DOWNLOADER,
+    );
+    let mut other = other.unwrap();
+
+    SERVICE.set_tag_priority("feed", 1);
+    SERVICE.cancel_tag("feed");
+    for handle in handles {
+        while handle.state() != CANCEL {
+            std::thread::sleep(Duration::from_millis(500));
+        }
+    }
+    assert_eq!(cancel_flag.load(Ordering::SeqCst), 2);
+    assert_eq!(other_flag.load(Ordering::SeqCst), 0);
+    assert_eq!(SERVICE.tags.lock().unwrap().get("feed").unwrap().len(), 2);
+
+    SERVICE.remove_tag("feed");
+    assert!(!SERVICE.tags.lock().unwrap().contains_key("feed"));
+    other.cancel();
+}
+
 // @tc.name: ut_download_request_ssl_type
 // @tc.desc: Test DownloadRequest set ssl_type
 // @tc.precon: NA
@@ -0,0 +1,221 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "request_common.h"
+#include "request_manager_impl.h"
+#include "response_message_receiver.h"
+
+namespace {
+using namespace OHOS::Request;
+
+std::atomic<uint64_t> g_allocations{ 0 };
+
+// Frames handed to the receiver the way the service writes them.
+class FrameWriter {
+public:
+    explicit FrameWriter(int16_t msgType)
+    {
+        Put<uint32_t>(ResponseMessageReceiver::RESPONSE_MAGIC_NUM);
+        Put<int32_t>(0);
+        Put<int16_t>(msgType);
+        Put<int16_t>(0);
+    }
+
+    template<typename T> void Put(T value)
+    {
+        const char *bytes = reinterpret_cast<const char *>(&value);
+        buffer_.insert(buffer_.end(), bytes, bytes + sizeof(T));
+    }
+
+    void PutString(const std::string &str)
+    {
+        buffer_.insert(buffer_.end(), str.begin(), str.end());
+        buffer_.push_back('\0');
+    }
+
+    void PutRaw(const std::string &str)
+    {
+        buffer_.insert(buffer_.end(), str.begin(), str.end());
+    }
+
+    std::vector<char> Finish()
+    {
+        int16_t size = static_cast<int16_t>(buffer_.size());
+        memcpy(buffer_.data() + SIZE_OFFSET, &size, sizeof(size));
+        return buffer_;
+    }
+
+private:
+    static constexpr size_t SIZE_OFFSET = 10;
+    std::vector<char> buffer_;
+};
+
+std::vector<char> ProgressFrame(uint32_t taskId)
+{
+    FrameWriter writer(MessageType::NOTIFY_DATA);
+    writer.Put<uint32_t>(static_cast<uint32_t>(SubscribeType::PROGRESS));
+    writer.Put<uint32_t>(taskId);
+    writer.Put<uint32_t>(static_cast<uint32_t>(State::RUNNING));
+    writer.Put<uint32_t>(0);
+    writer.Put<uint64_t>(1024 * 1024);
+    writer.Put<uint64_t>(1024 * 1024);
+    writer.Put<uint32_t>(1);
+    writer.Put<int64_t>(8 * 1024 * 1024);
+    writer.Put<uint32_t>(2);
+    writer.PutString("content-type");
+    writer.PutString("application/octet-stream");
+    writer.PutString("etag");
+    writer.PutString("\"5d8c72a5edda8\"");
+    writer.Put<uint32_t>(static_cast<uint32_t>(Action::DOWNLOAD));
+    writer.Put<uint32_t>(static_cast<uint32_t>(Version::API10));
+    writer.Put<uint32_t>(1);
+    writer.PutString("");
+    writer.Put<uint32_t>(static_cast<uint32_t>(Reason::REASON_OK));
+    writer.PutString("");
+    return writer.Finish();
+}
+
+std::vector<char> ResponseFrame(uint32_t taskId, int32_t headerCount)
+{
+    FrameWriter writer(MessageType::HTTP_RESPONSE);
+    writer.Put<int32_t>(static_cast<int32_t>(taskId));
+    writer.PutString("HTTP/1.1");
+    writer.Put<int32_t>(200);
+    writer.PutString("OK");
+    std::string headers;
+    for (int32_t i = 0; i < headerCount; ++i) {
+        headers += "x-benchmark-header-" + std::to_string(i) + ":value-" + std::to_string(i) + ",other\n";
+    }
+    writer.PutRaw(headers);
+    return writer.Finish();
+}
+
+class NullHandler : public IResponseMessageHandler {
+public:
+    void OnChannelBroken() override
+    {
+    }
+    void OnResponseReceive(const std::shared_ptr<Response> &response) override
+    {
+        benchmark::DoNotOptimize(response->GetHeaders());
+    }
+    void OnNotifyDataReceive(const std::shared_ptr<NotifyData> &notifyData) override
+    {
+        benchmark::DoNotOptimize(notifyData.get());
+    }
+    void OnFaultsReceive(const std::shared_ptr<int32_t> &tid, const std::shared_ptr<SubscribeType> &type,
+        const std::shared_ptr<Reason> &reason) override
+    {
+    }
+    void OnWaitReceive(std::int32_t taskId, WaitingReason reason) override
+    {
+    }
+    void OnRunCountReceive(int64_t runCount) override
+    {
+    }
+};
+
+// Feeds one frame per iteration through a socketpair into ResponseMessageReceiver::OnReadable.
+void RunReceiver(benchmark::State &state, IResponseMessageHandler *handler, std::vector<char> frame)
+{
+    int fds[2] = { -1, -1 };
+    if (socketpair(AF_UNIX, SOCK_DGRAM, 0, fds) != 0) {
+        state.SkipWithError("socketpair failed");
+        return;
+    }
+    auto receiver = std::make_shared<ResponseMessageReceiver>(handler, fds[0]);
+    std::shared_ptr<OHOS::AppExecFwk::FileDescriptorListener> listener = receiver;
+    char grants[ResponseMessageReceiver::RESPONSE_MAX_SIZE];
+    int32_t msgId = 1;
+    uint64_t allocations = 0;
+    for (auto _ : state) {
+        memcpy(frame.data() + sizeof(uint32_t), &msgId, sizeof(msgId));
+        ++msgId;
+        if (write(fds[1], frame.data(), frame.size()) < 0) {
+            state.SkipWithError("write frame failed");
+            break;
+        }
+        uint64_t before = g_allocations.load(std::memory_order_relaxed);
+        listener->OnReadable(fds[0]);
+        allocations += g_allocations.load(std::memory_order_relaxed) - before;
+        // Credits granted back by the receiver.
+        while (recv(fds[1], grants, sizeof(grants), MSG_DONTWAIT) > 0) {
+        }
+    }
+    state.counters["ns/message"] =
+        benchmark::Counter(state.iterations(), benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+    state.counters["allocations/message"] =
+        benchmark::Counter(static_cast<double>(allocations) / static_cast<double>(state.iterations()));
+    close(fds[0]);
+    close(fds[1]);
+}
+
+void BM_NotifyDataDecode(benchmark::State &state)
+{
+    NullHandler handler;
+    RunReceiver(state, &handler, ProgressFrame(1));
+}
+
+void BM_NotifyDataToManager(benchmark::State &state)
+{
+    IResponseMessageHandler *handler = RequestManagerImpl::GetInstance().get();
+    RunReceiver(state, handler, ProgressFrame(1));
+}
+
+void BM_ResponseDecode(benchmark::State &state)
+{
+    NullHandler handler;
+    RunReceiver(state, &handler, ResponseFrame(1, static_cast<int32_t>(state.range(0))));
+}
+
+BENCHMARK(BM_NotifyDataDecode);
+BENCHMARK(BM_NotifyDataToManager);
+BENCHMARK(BM_ResponseDecode)->Arg(8)->Arg(64)->Arg(256);
+} // namespace
+
+void *operator new(size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    void *ptr = malloc(size == 0 ? 1 : size);
+    if (ptr == nullptr) {
+        abort();
+    }
+    return ptr;
+}
+
+void operator delete(void *ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete(void *ptr, size_t size) noexcept
+{
+    free(ptr);
+}
+
+BENCHMARK_MAIN();
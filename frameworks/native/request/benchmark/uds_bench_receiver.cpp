@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Client end of the UDS channel benchmark of the service, linked into the rust_request_uds_benchmark target.
+// The service side sends notify data through a real client handler, this side receives them with
+// ResponseMessageReceiver on its own thread, the way the dedicated reader of an application does.
+
+#include <poll.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "i_response_message_handler.h"
+#include "request_common.h"
+#include "response_message_receiver.h"
+
+namespace {
+using namespace OHOS::Request;
+
+constexpr int POLL_TIMEOUT_MS = 10;
+
+uint64_t MonotonicNs()
+{
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+}
+
+// Counts the notify data, whose total processed carries the time they were sent at.
+class LatencyHandler : public IResponseMessageHandler {
+public:
+    void OnChannelBroken() override
+    {
+    }
+    void OnResponseReceive(const std::shared_ptr<Response> &response) override
+    {
+    }
+    void OnNotifyDataReceive(const std::shared_ptr<NotifyData> &notifyData) override
+    {
+        uint64_t now = MonotonicNs();
+        uint64_t sent = notifyData->progress.totalProcessed;
+        std::lock_guard<std::mutex> lock(mutex_);
+        latencies_.push_back(now > sent ? now - sent : 0);
+    }
+    void OnFaultsReceive(const std::shared_ptr<int32_t> &tid, const std::shared_ptr<SubscribeType> &type,
+        const std::shared_ptr<Reason> &reason) override
+    {
+    }
+    void OnWaitReceive(std::int32_t taskId, WaitingReason reason) override
+    {
+    }
+    void OnRunCountReceive(int64_t runCount) override
+    {
+    }
+
+    uint64_t Received()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return latencies_.size();
+    }
+
+    size_t Latencies(uint64_t *out, size_t capacity)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        size_t count = std::min(capacity, latencies_.size());
+        std::copy(latencies_.begin(), latencies_.begin() + count, out);
+        return count;
+    }
+
+private:
+    std::mutex mutex_;
+    std::vector<uint64_t> latencies_;
+};
+
+struct UdsBench {
+    LatencyHandler handler;
+    std::shared_ptr<ResponseMessageReceiver> receiver;
+    std::atomic<bool> stop{ false };
+    std::thread reader;
+};
+} // namespace
+
+extern "C" {
+// Time of the clock the sent times are read against, in nanoseconds.
+uint64_t RequestUdsBenchNow()
+{
+    return MonotonicNs();
+}
+
+// Receives on `fd` until stopped. Without credits the service stays in ack mode until the first grant the
+// receiver returns, otherwise the first grant announces `capabilities` like BeginReceive does.
+void *RequestUdsBenchStart(int32_t fd, bool credits, uint32_t capabilities)
+{
+    UdsBench *bench = new UdsBench();
+    bench->receiver = std::make_shared<ResponseMessageReceiver>(&bench->handler, fd);
+    if (credits) {
+        uint32_t grant[3] = { ResponseMessageReceiver::CREDIT_MAGIC_NUM, ResponseMessageReceiver::CREDIT_WINDOW,
+            capabilities };
+        size_t grantSize = capabilities == 0 ? sizeof(uint32_t) * 2 : sizeof(grant);
+        if (write(fd, grant, grantSize) <= 0) {
+            delete bench;
+            return nullptr;
+        }
+    }
+    bench->reader = std::thread([bench, fd]() {
+        std::shared_ptr<OHOS::AppExecFwk::FileDescriptorListener> listener = bench->receiver;
+        while (!bench->stop.load(std::memory_order_relaxed)) {
+            pollfd pfd = { fd, POLLIN, 0 };
+            int ret = poll(&pfd, 1, POLL_TIMEOUT_MS);
+            if (ret > 0 && (pfd.revents & POLLIN) != 0) {
+                listener->OnReadable(fd);
+            } else if (ret > 0) {
+                break;
+            }
+        }
+    });
+    return bench;
+}
+
+// Number of notify data received.
+uint64_t RequestUdsBenchReceived(void *bench)
+{
+    return static_cast<UdsBench *>(bench)->handler.Received();
+}
+
+// Copies at most `capacity` latencies of the notify data received, in nanoseconds, returning their number.
+size_t RequestUdsBenchLatencies(void *bench, uint64_t *out, size_t capacity)
+{
+    return static_cast<UdsBench *>(bench)->handler.Latencies(out, capacity);
+}
+
+// Stops receiving, the socket is left to its owner.
+void RequestUdsBenchStop(void *bench)
+{
+    UdsBench *udsBench = static_cast<UdsBench *>(bench);
+    udsBench->stop.store(true, std::memory_order_relaxed);
+    udsBench->reader.join();
+    delete udsBench;
+}
+}
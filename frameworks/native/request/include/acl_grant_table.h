@@ -0,0 +1,39 @@
+/*
+ * Copyright (C) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_REQUEST_ACL_GRANT_TABLE_H
+#define OHOS_REQUEST_ACL_GRANT_TABLE_H
+
+#include <string>
+
+#include "visibility.h"
+
+namespace OHOS::Request {
+
+// ACL grants of the paths given to the service, counted by the tasks using them and shared by all the
+// frontends of a process. Entries look like "g:3815:rwx": a path gets its access when first acquired
+// by a principal, widened to the permissions of all its references, and loses it on the last release.
+// ACLs are set without the table locked, references to a path being set wait for the call to finish.
+class AclGrantTable {
+public:
+    // Takes a reference even if setting the ACL fails, so every call is paired with a `Release`. With
+    // `refresh` the ACL is set even if granted already, for files that may have been created again.
+    REQUEST_API static bool Acquire(const std::string &path, const std::string &entry, bool refresh = false);
+    // Only the principal of `entry` is used, its permissions may differ from those acquired.
+    REQUEST_API static bool Release(const std::string &path, const std::string &entry);
+};
+
+} // namespace OHOS::Request
+#endif // OHOS_REQUEST_ACL_GRANT_TABLE_H
@@ -45,6 +45,12 @@ enum class RequestInterfaceCode {
     CMD_SHOW_PROGRESS,
     CMD_SET_MODE = 100,
     CMD_DISABLE_TASK_NOTIFICATIONS,
+    CMD_SET_SCHEDULE_POLICY,
+    CMD_OPEN_PROGRESS_TABLE,
+    CMD_GET_STATS,
+    CMD_OPEN_SHARED_CACHE,
+    CMD_PUBLISH_SHARED_CACHE,
+    CMD_SUBSCRIBE_TASKS,
 };
 
 enum class RequestNotifyInterfaceCode {
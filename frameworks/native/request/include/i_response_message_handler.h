@@ -26,6 +26,8 @@ class IResponseMessageHandler
     , public INotifyDataListener {
 public:
     virtual void OnChannelBroken() = 0;
+    // Run count subscribed to, sent over the channel instead of the RunCountNotifyStub.
+    virtual void OnRunCountReceive(int64_t runCount) = 0;
 };
 
 } // namespace OHOS::Request
@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_REQUEST_NOTIFY_DELIVERY_H
+#define OHOS_REQUEST_NOTIFY_DELIVERY_H
+
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include "request_common.h"
+
+namespace OHOS::Request {
+
+// Whether a notification is a progress a later one of the same task makes useless.
+bool IsIntermediateProgress(const std::shared_ptr<NotifyData> &notifyData);
+
+// Makes room for one more item in a queue of at most `capacity` items by dropping its oldest droppable
+// item. Returns false if the queue is full of items that cannot be dropped, which are then kept anyway.
+template<typename Container, typename Droppable>
+bool MakeRoom(Container &items, size_t capacity, Droppable droppable)
+{
+    if (items.size() < capacity) {
+        return true;
+    }
+    auto it = std::find_if(items.begin(), items.end(), droppable);
+    if (it == items.end()) {
+        return false;
+    }
+    items.erase(it);
+    return true;
+}
+
+// Callbacks of one listener, called in order by a worker thread shared by all the listeners of the process
+// instead of the thread receiving the notifications, so that a slow callback holds neither the receiving of
+// the notifications nor, beyond its turn, the callbacks of the other listeners back.
+class NotifyDelivery : public std::enable_shared_from_this<NotifyDelivery> {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 64;
+
+    explicit NotifyDelivery(size_t capacity = DEFAULT_CAPACITY);
+    // Queues a callback, `droppable` if a later one makes it useless, like an intermediate progress.
+    void Push(std::function<void()> callback, bool droppable);
+    // Drops the callbacks not called yet, the one being called goes on.
+    void Cancel();
+
+private:
+    friend class NotifyDeliveryWorker;
+    struct Item {
+        std::function<void()> callback;
+        bool droppable;
+    };
+    // Calls the oldest callback, returns whether others are waiting.
+    bool DeliverOne();
+
+    const size_t capacity_;
+    std::mutex mutex_;
+    std::deque<Item> items_;
+    bool scheduled_ = false;
+};
+
+} // namespace OHOS::Request
+
+#endif // OHOS_REQUEST_NOTIFY_DELIVERY_H
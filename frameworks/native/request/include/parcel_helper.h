@@ -36,6 +36,7 @@ private:
     static bool UnMarshalMapProgressExtras(MessageParcel &data, TaskInfo &info);
     static bool UnMarshalMapExtras(MessageParcel &data, TaskInfo &info);
     static bool UnMarshalTaskState(MessageParcel &data, TaskInfo &info);
+    static void UnMarshalPerformance(MessageParcel &data, TaskInfo &info);
     static bool UnMarshalConfigHeaders(MessageParcel &data, Config &config);
     static bool UnMarshalConfigExtras(MessageParcel &data, Config &config);
     static bool UnMarshalConfigFormItem(MessageParcel &data, Config &config);
@@ -26,6 +26,8 @@ class PathControl {
 public:
     static bool AddPathsToMap(const std::string &path);
     static bool SubPathsToMap(const std::string &path);
+    static bool AddDirToMap(const std::string &dir);
+    static bool SubDirToMap(const std::string &dir);
     static bool CheckBelongAppBaseDir(const std::string &filepath);
     static void InsureMapAcl();
     static std::string ShieldPath(const std::string &path);
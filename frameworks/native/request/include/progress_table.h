@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_REQUEST_PROGRESS_TABLE_H
+#define OHOS_REQUEST_PROGRESS_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "request_common.h"
+
+namespace OHOS::Request {
+
+// Read-only mapping of the progress table the service keeps for this process.
+// Each slot is written under a sequence lock by the service, so reads take no
+// lock and retry while a slot is being written. The layout mirrors
+// services/src/service/client/progress_table.rs.
+class ProgressTable {
+public:
+    // Maps the table and closes the fd, nullptr if the table is not valid.
+    static std::shared_ptr<ProgressTable> Map(int32_t fd);
+    ~ProgressTable();
+    bool Read(uint32_t tid, ProgressSnapshot &snapshot) const;
+
+private:
+    ProgressTable(void *base, size_t len, uint32_t capacity);
+    ProgressTable(const ProgressTable &) = delete;
+    ProgressTable &operator=(const ProgressTable &) = delete;
+
+    void *base_;
+    size_t len_;
+    uint32_t capacity_;
+};
+
+} // namespace OHOS::Request
+
+#endif // OHOS_REQUEST_PROGRESS_TABLE_H
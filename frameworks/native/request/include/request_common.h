@@ -20,6 +20,7 @@
 #include <map>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "constant.h"
@@ -38,6 +39,12 @@ enum class Mode : uint32_t {
     ANY,
 };
 
+// Order of the tasks of an application after their mode and deadline.
+enum class SchedulePolicy : uint32_t {
+    PRIORITY = 0,
+    SHORTEST_FIRST,
+};
+
 enum class Visibility : uint32_t {
     NONE = 0b00,
     COMPLETION = 0b01,
@@ -90,6 +97,9 @@ enum Reason : uint32_t {
     APP_ACCOUNT,
     NETWORK_APP_ACCOUNT,
     LOW_SPEED,
+    CHECKSUM_MISMATCH,
+    BODY_TOO_LARGE,
+    ORIGIN_UNAVAILABLE,
 };
 
 enum WaitingReason : uint32_t {
@@ -97,6 +107,7 @@ enum WaitingReason : uint32_t {
     NetworkNotMatch = 0x01,
     AppBackground = 0x02,
     UserInactivated = 0x03,
+    OriginUnavailable = 0x04,
 };
 
 enum class SubscribeType : uint32_t {
@@ -152,6 +163,11 @@ struct Timeout {
     uint64_t totalTimeout = 0;
 };
 
+struct StallDetection {
+    int64_t window = 0;
+    int64_t ratio = 0;
+};
+
 struct Config {
     Action action;
     std::string url;
@@ -184,6 +200,7 @@ struct Config {
     std::string data;
     std::string proxy;
     std::string certificatePins;
+    std::string checksum;
     std::map<std::string, std::string> headers;
     std::vector<FormItem> forms;
     std::vector<FileSpec> files;
@@ -192,6 +209,27 @@ struct Config {
     Notification notification;
     MinSpeed minSpeed;
     Timeout timeout;
+    StallDetection stallDetection;
+    uint32_t concurrency = 0;
+    uint64_t chunkSize = 0;
+    uint64_t deadline = 0;
+    // Whether a download may share its transfer with the identical downloads running at the same time.
+    bool coalesce = false;
+    // Whether a download asks for a compressed body and stores it decoded.
+    bool compression = false;
+    // Cap in bytes of a download body delivered in memory instead of a file, 0 to download to a file.
+    uint32_t memoryLimit = 0;
+    // Whether a background task waits for the prefetch window: charging, idle and on unmetered Wi-Fi.
+    bool prefetch = false;
+    // Whether a download keeps its written data out of the page cache, for very large files.
+    bool bypassCache = false;
+    // Trace of the request from its creation to its notifications, 0 if untraced. Set when the task is created.
+    uint64_t traceId = 0;
+    // Maximum progress callbacks per second, 0 for no limit. Only used by the JS listeners.
+    uint32_t maxCallbackFrequency = 0;
+    // Body the application preloaded for the URL, handed over to the service so it is not downloaded again,
+    // -1 if none. Only open while the task is created.
+    int32_t cachedBodyFd = -1;
 };
 
 enum class State : uint32_t {
@@ -216,6 +254,20 @@ struct Progress {
     std::vector<int64_t> sizes;
     std::map<std::string, std::string> extras;
     std::vector<uint8_t> bodyBytes;
+    // Average speed of the running task in bytes per second, 0 otherwise.
+    uint64_t speed = 0;
+    // Estimated seconds left of the running task, -1 if unknown.
+    int64_t eta = -1;
+};
+
+// Latest progress of a task read from the shared progress table.
+struct ProgressSnapshot {
+    State state;
+    uint64_t processed;
+    // Bytes of all files, -1 if the size of a file is unknown.
+    int64_t total;
+    // Time of the snapshot in milliseconds since the epoch.
+    uint64_t mtime;
 };
 
 enum class Faults : uint32_t {
@@ -263,6 +315,17 @@ struct Notify {
     Progress progress;
 };
 
+// Transport timings of the latest attempt of a task, in milliseconds, -1 if unknown.
+struct TaskPerformance {
+    uint32_t attempt = 0;
+    int64_t dns = -1;
+    int64_t connect = -1;
+    int64_t tls = -1;
+    int64_t ttfb = -1;
+    int64_t transfer = -1;
+    std::string server;
+};
+
 struct TaskInfo {
     Version version;
     std::string uid;
@@ -291,6 +354,7 @@ struct TaskInfo {
     uint64_t taskTime = 0;
     std::map<std::string, std::string> extras;
     std::vector<TaskState> taskStates;
+    TaskPerformance performance;
 };
 
 struct TaskInfoRet {
@@ -315,6 +379,12 @@ struct Filter {
     State state = State::ANY;
     Action action = Action::ANY;
     Mode mode = Mode::ANY;
+    // Maximum number of tids of a page, 0 to get all of them at once.
+    uint32_t limit = 0;
+    // Token of the page to get, returned with the previous page.
+    std::string cursor;
+    // Text to find in the title, description or url, empty for any task.
+    std::string keyword;
 };
 
 enum DownloadErrorCode {
@@ -365,7 +435,13 @@ struct Response {
     std::string version;
     int32_t statusCode;
     std::string reason;
-    std::map<std::string, std::vector<std::string>> headers;
+    // Header lines as received, "key:value1,value2\n" each; parsed on the first GetHeaders call.
+    std::string rawHeaders;
+
+    const std::map<std::string, std::vector<std::string>> &GetHeaders() const;
+
+private:
+    mutable std::optional<std::map<std::string, std::vector<std::string>>> headers_;
 };
 
 struct TaskRet {
@@ -378,5 +454,12 @@ static uint64_t REQUEST_FDSAN_TAG = 0xC01C50;
 static uint32_t VISIBILITY_COMPLETION = 0b00000001;
 static uint32_t VISIBILITY_PROGRESS = 0b00000010;
 
+// Optional parts of a queried TaskInfo, the parts not asked for are left empty.
+static uint32_t TASK_INFO_FORM_ITEMS = 0x01;
+static uint32_t TASK_INFO_FILE_SPECS = 0x02;
+static uint32_t TASK_INFO_EXTRAS = 0x04;
+static uint32_t TASK_INFO_EACH_FILE_STATUS = 0x08;
+static uint32_t TASK_INFO_ALL = 0x0F;
+
 } // namespace OHOS::Request
 #endif //REQUEST_COMMON_H
\ No newline at end of file
@@ -66,6 +66,9 @@ private:
                                                             "app is"
                                                             "background or terminate";
     static constexpr const char *LOW_SPEED_INFO = "Below low speed limit";
+    static constexpr const char *CHECKSUM_MISMATCH_INFO = "Checksum mismatch";
+    static constexpr const char *BODY_TOO_LARGE_INFO = "Body exceeds the memory limit";
+    static constexpr const char *ORIGIN_UNAVAILABLE_INFO = "The server is unreachable, waiting to retry";
 
 public:
     REQUEST_API static Faults GetFaultByReason(Reason code);
@@ -16,6 +16,7 @@
 #ifndef OHOS_REQUEST_DOWNLOAD_MANAGER_H
 #define OHOS_REQUEST_DOWNLOAD_MANAGER_H
 
+#include <map>
 #include <optional>
 
 #include "i_notify_data_listener.h"
@@ -39,7 +40,10 @@ public:
         const std::vector<std::string> &tids, const Version version, std::vector<ExceptionErrorCode> &rets);
     REQUEST_API ExceptionErrorCode PauseTasks(
         const std::vector<std::string> &tids, const Version version, std::vector<ExceptionErrorCode> &rets);
-    REQUEST_API ExceptionErrorCode ShowTasks(const std::vector<std::string> &tids, std::vector<TaskInfoRet> &rets);
+    REQUEST_API ExceptionErrorCode QueryTasks(
+        const std::vector<std::string> &tids, std::vector<TaskInfoRet> &rets, uint32_t fields = TASK_INFO_ALL);
+    REQUEST_API ExceptionErrorCode ShowTasks(
+        const std::vector<std::string> &tids, std::vector<TaskInfoRet> &rets, uint32_t fields = TASK_INFO_ALL);
     REQUEST_API ExceptionErrorCode TouchTasks(
         const std::vector<TaskIdAndToken> &tidTokens, std::vector<TaskInfoRet> &rets);
     REQUEST_API ExceptionErrorCode SetMaxSpeeds(
@@ -47,6 +51,7 @@ public:
     REQUEST_API ExceptionErrorCode DisableTaskNotification(
         const std::vector<std::string> &tids, std::vector<ExceptionErrorCode> &rets);
     REQUEST_API ExceptionErrorCode SetMode(const std::string &tid, const Mode mode);
+    REQUEST_API ExceptionErrorCode SetSchedulePolicy(const SchedulePolicy policy);
 
     REQUEST_API int32_t Create(const Config &config, int32_t seq, std::string &tid);
     REQUEST_API int32_t GetTask(const std::string &tid, const std::string &token, Config &config);
@@ -55,15 +60,22 @@ public:
     REQUEST_API int32_t Query(const std::string &tid, TaskInfo &info);
     REQUEST_API int32_t Touch(const std::string &tid, const std::string &token, TaskInfo &info);
     REQUEST_API int32_t Search(const Filter &filter, std::vector<std::string> &tids);
+    REQUEST_API int32_t SearchPage(const Filter &filter, std::vector<std::string> &tids, std::string &next);
     REQUEST_API int32_t Show(const std::string &tid, TaskInfo &info);
     REQUEST_API int32_t Pause(const std::string &tid, const Version version);
     REQUEST_API int32_t QueryMimeType(const std::string &tid, std::string &mimeType);
     REQUEST_API int32_t Remove(const std::string &tid, const Version version);
     REQUEST_API int32_t Resume(const std::string &tid);
     REQUEST_API int32_t SetMaxSpeed(const std::string &tid, const int64_t maxSpeed);
+    REQUEST_API int32_t GetStats(std::map<std::string, uint64_t> &stats);
+    REQUEST_API int32_t OpenSharedCache(const std::string &url, int32_t &fd);
+    REQUEST_API int32_t PublishSharedCache(const std::string &url, int32_t fd);
 
     REQUEST_API int32_t Subscribe(const std::string &taskId);
+    REQUEST_API ExceptionErrorCode SubscribeTasks(
+        const std::vector<std::string> &tids, std::vector<ExceptionErrorCode> &rets);
     REQUEST_API int32_t Unsubscribe(const std::string &taskId);
+    REQUEST_API int32_t ReadProgressSnapshot(const std::string &tid, ProgressSnapshot &snapshot);
 
     REQUEST_API int32_t AddListener(
         const std::string &taskId, const SubscribeType &type, const std::shared_ptr<IResponseListener> &listener);
@@ -77,8 +89,11 @@ public:
 
     REQUEST_API void RestoreListener(void (*callback)());
     REQUEST_API void LoadRequestServer();
+    // Loads the service and opens the channel ahead of the first request.
+    REQUEST_API int32_t Prewarm();
     REQUEST_API bool IsSaReady();
     REQUEST_API void ReopenChannel();
+    REQUEST_API void SetDedicatedReader(bool enable);
     REQUEST_API bool SubscribeSA();
     REQUEST_API bool UnsubscribeSA();
     REQUEST_API int32_t GetNextSeq();
@@ -28,10 +28,12 @@
 #include "iremote_object.h"
 #include "iservice_registry.h"
 #include "log.h"
+#include "progress_table.h"
 #include "refbase.h"
 #include "request.h"
 #include "request_common.h"
 #include "request_service_interface.h"
+#include "request_task_registry.h"
 #include "response_message_receiver.h"
 #include "system_ability_status_change_stub.h"
 #include "visibility.h"
@@ -51,11 +53,14 @@ public:
         const std::vector<std::string> &tids, const Version version, std::vector<ExceptionErrorCode> &rets);
     ExceptionErrorCode PauseTasks(
         const std::vector<std::string> &tids, const Version version, std::vector<ExceptionErrorCode> &rets);
-    ExceptionErrorCode QueryTasks(const std::vector<std::string> &tids, std::vector<TaskInfoRet> &rets);
-    ExceptionErrorCode ShowTasks(const std::vector<std::string> &tids, std::vector<TaskInfoRet> &rets);
+    ExceptionErrorCode QueryTasks(
+        const std::vector<std::string> &tids, std::vector<TaskInfoRet> &rets, uint32_t fields = TASK_INFO_ALL);
+    ExceptionErrorCode ShowTasks(
+        const std::vector<std::string> &tids, std::vector<TaskInfoRet> &rets, uint32_t fields = TASK_INFO_ALL);
     ExceptionErrorCode TouchTasks(const std::vector<TaskIdAndToken> &tids, std::vector<TaskInfoRet> &rets);
     ExceptionErrorCode SetMaxSpeeds(const std::vector<SpeedConfig> &speedConfig, std::vector<ExceptionErrorCode> &rets);
     ExceptionErrorCode SetMode(const std::string &tid, const Mode mode);
+    ExceptionErrorCode SetSchedulePolicy(const SchedulePolicy policy);
     ExceptionErrorCode DisableTaskNotification(
         const std::vector<std::string> &tids, std::vector<ExceptionErrorCode> &rets);
 
@@ -66,15 +71,23 @@ public:
     int32_t Query(const std::string &tid, TaskInfo &info);
     int32_t Touch(const std::string &tid, const std::string &token, TaskInfo &info);
     int32_t Search(const Filter &filter, std::vector<std::string> &tids);
+    int32_t SearchPage(const Filter &filter, std::vector<std::string> &tids, std::string &next);
     int32_t Show(const std::string &tid, TaskInfo &info);
     int32_t Pause(const std::string &tid, const Version version);
     int32_t QueryMimeType(const std::string &tid, std::string &mimeType);
     int32_t Remove(const std::string &tid, const Version version);
     int32_t Resume(const std::string &tid);
     int32_t SetMaxSpeed(const std::string &tid, const int64_t maxSpeed);
+    int32_t GetStats(std::map<std::string, uint64_t> &stats);
+    int32_t OpenSharedCache(const std::string &url, int32_t &fd);
+    int32_t PublishSharedCache(const std::string &url, int32_t fd);
 
     int32_t Subscribe(const std::string &taskId);
+    // Subscribes to the tasks with one call per SUBSCRIBE_TASKS_MAX tasks, opening the channel in the first one
+    // if it is closed, and delivers the state of the unfinished tasks to their listeners.
+    ExceptionErrorCode SubscribeTasks(const std::vector<std::string> &tids, std::vector<ExceptionErrorCode> &rets);
     int32_t Unsubscribe(const std::string &taskId);
+    int32_t ReadProgressSnapshot(const std::string &tid, ProgressSnapshot &snapshot);
 
     int32_t AddListener(
         const std::string &taskId, const SubscribeType &type, const std::shared_ptr<IResponseListener> &listener);
@@ -92,8 +105,11 @@ public:
     void RestoreListener(void (*callback)());
     void RestoreSubRunCount();
     void LoadRequestServer();
+    int32_t Prewarm();
     bool IsSaReady();
     void ReopenChannel();
+    // Takes effect the next time the channel is opened.
+    void SetDedicatedReader(bool enable);
     int32_t GetNextSeq();
     bool SubscribeSA();
     bool UnsubscribeSA();
@@ -108,27 +124,43 @@ private:
     RequestManagerImpl(RequestManagerImpl &&) = delete;
     RequestManagerImpl &operator=(const RequestManagerImpl &) = delete;
     sptr<RequestServiceInterface> GetRequestServiceProxy(bool load);
+    void PublishServiceProxy(const sptr<RequestServiceInterface> &proxy);
     int32_t EnsureChannelOpen();
+    // Must be called with msgReceiverMutex_ held.
+    void BeginReceive(int32_t sockFd);
+    // Delivers the state read on subscription of an unfinished task as a progress notification.
+    void CatchUp(const TaskInfo &info);
+    std::shared_ptr<ProgressTable> OpenProgressTable(int32_t &ret);
     std::shared_ptr<Request> GetTask(const std::string &taskId);
+    std::shared_ptr<Request> GetTask(uint32_t taskId);
     void OnChannelBroken() override;
     void OnResponseReceive(const std::shared_ptr<Response> &response) override;
     void OnNotifyDataReceive(const std::shared_ptr<NotifyData> &notifyData) override;
     void OnFaultsReceive(const std::shared_ptr<int32_t> &tid, const std::shared_ptr<SubscribeType> &type,
         const std::shared_ptr<Reason> &reason) override;
     void OnWaitReceive(std::int32_t taskId, WaitingReason reason) override;
+    void OnRunCountReceive(int64_t runCount) override;
 
 private:
     std::mutex serviceProxyMutex_;
     std::mutex saChangeListenerMutex_;
 
     sptr<RequestServiceInterface> requestServiceProxy_;
+    // Raw pointer of requestServiceProxy_ for the lock-free read in GetRequestServiceProxy.
+    std::atomic<RequestServiceInterface *> cachedProxy_{ nullptr };
+    std::vector<sptr<RequestServiceInterface>> retiredProxies_;
     sptr<ISystemAbilityStatusChange> saChangeListener_;
     static constexpr int LOAD_SA_TIMEOUT_MS = 15000;
+    // Tasks the service subscribes to per call.
+    static constexpr size_t SUBSCRIBE_TASKS_MAX = 200;
     void (*callback_)() = nullptr;
-    std::mutex tasksMutex_;
-    std::map<std::string, std::shared_ptr<Request>> tasks_;
+    TaskRegistry tasks_;
     std::recursive_mutex msgReceiverMutex_;
     std::shared_ptr<ResponseMessageReceiver> msgReceiver_;
+    std::atomic<bool> dedicatedReader_{ false };
+    std::mutex progressTableMutex_;
+    // Loaded with std::atomic_load so that snapshots are read without a lock.
+    std::shared_ptr<ProgressTable> progressTable_;
 
     class SystemAbilityStatusChangeListener : public OHOS::SystemAbilityStatusChangeStub {
     public:
@@ -152,7 +184,7 @@ private:
                 REQUEST_HILOGE("Remote died, retry times: %{public}d", i);
                 {
                     std::lock_guard<std::mutex> lock(serviceProxyMutex_);
-                    requestServiceProxy_ = nullptr;
+                    PublishServiceProxy(nullptr);
                 }
                 continue;
             }
@@ -17,6 +17,7 @@
 #define DOWNLOAD_SERVICE_INTERFACE_H
 
 #include <cstdint>
+#include <map>
 #include <string>
 
 #include "constant.h"
@@ -39,16 +40,22 @@ public:
         const std::vector<std::string> &tids, const Version version, std::vector<ExceptionErrorCode> &rets) = 0;
     virtual ExceptionErrorCode PauseTasks(
         const std::vector<std::string> &tids, const Version version, std::vector<ExceptionErrorCode> &rets) = 0;
-    virtual ExceptionErrorCode QueryTasks(const std::vector<std::string> &tids, std::vector<TaskInfoRet> &rets) = 0;
-    virtual ExceptionErrorCode ShowTasks(const std::vector<std::string> &tids, std::vector<TaskInfoRet> &rets) = 0;
+    virtual ExceptionErrorCode QueryTasks(
+        const std::vector<std::string> &tids, uint32_t fields, std::vector<TaskInfoRet> &rets) = 0;
+    virtual ExceptionErrorCode ShowTasks(
+        const std::vector<std::string> &tids, uint32_t fields, std::vector<TaskInfoRet> &rets) = 0;
     virtual ExceptionErrorCode TouchTasks(
         const std::vector<TaskIdAndToken> &tidTokens, std::vector<TaskInfoRet> &rets) = 0;
     virtual ExceptionErrorCode SetMaxSpeeds(
         const std::vector<SpeedConfig> &speedConfig, std::vector<ExceptionErrorCode> &rets) = 0;
 
     virtual ExceptionErrorCode SetMode(const std::string &tid, const Mode mode) = 0;
+    virtual ExceptionErrorCode SetSchedulePolicy(const SchedulePolicy policy) = 0;
     virtual ExceptionErrorCode DisableTaskNotification(
         const std::vector<std::string> &tids, std::vector<ExceptionErrorCode> &rets) = 0;
+    // Subscribes to the tasks and reads their state, opening the channel first if `openChannel`.
+    virtual ExceptionErrorCode SubscribeTasks(const std::vector<std::string> &tids, bool openChannel,
+        int32_t &sockFd, std::vector<TaskInfoRet> &rets) = 0;
 
     virtual int32_t Create(const Config &config, std::string &taskId) = 0;
     virtual int32_t GetTask(const std::string &tid, const std::string &token, Config &config) = 0;
@@ -62,10 +69,14 @@ public:
     virtual int32_t Stop(const std::string &tid) = 0;
     virtual int32_t Query(const std::string &tid, TaskInfo &info) = 0;
     virtual int32_t Touch(const std::string &tid, const std::string &token, TaskInfo &info) = 0;
-    virtual int32_t Search(const Filter &filter, std::vector<std::string> &tids) = 0;
+    virtual int32_t Search(const Filter &filter, std::vector<std::string> &tids, std::string &next) = 0;
     virtual int32_t Show(const std::string &tid, TaskInfo &info) = 0;
 
     virtual int32_t OpenChannel(int32_t &sockFd) = 0;
+    virtual int32_t OpenProgressTable(int32_t &fd) = 0;
+    virtual int32_t GetStats(std::map<std::string, uint64_t> &stats) = 0;
+    virtual int32_t OpenSharedCache(const std::string &url, int32_t &fd) = 0;
+    virtual int32_t PublishSharedCache(const std::string &url, int32_t fd) = 0;
     virtual int32_t Subscribe(const std::string &taskId) = 0;
     virtual int32_t Unsubscribe(const std::string &taskId) = 0;
     virtual int32_t SubRunCount(const sptr<NotifyInterface> &listener) = 0;
@@ -44,15 +44,20 @@ public:
     ExceptionErrorCode RemoveTasks(
         const std::vector<std::string> &tids, const Version version, std::vector<ExceptionErrorCode> &rets) override;
 
-    ExceptionErrorCode QueryTasks(const std::vector<std::string> &tids, std::vector<TaskInfoRet> &rets) override;
-    ExceptionErrorCode ShowTasks(const std::vector<std::string> &tids, std::vector<TaskInfoRet> &rets) override;
+    ExceptionErrorCode QueryTasks(
+        const std::vector<std::string> &tids, uint32_t fields, std::vector<TaskInfoRet> &rets) override;
+    ExceptionErrorCode ShowTasks(
+        const std::vector<std::string> &tids, uint32_t fields, std::vector<TaskInfoRet> &rets) override;
     ExceptionErrorCode TouchTasks(
         const std::vector<TaskIdAndToken> &tidTokens, std::vector<TaskInfoRet> &rets) override;
     ExceptionErrorCode SetMaxSpeeds(
         const std::vector<SpeedConfig> &speedConfig, std::vector<ExceptionErrorCode> &rets) override;
     ExceptionErrorCode SetMode(const std::string &tid, const Mode mode) override;
+    ExceptionErrorCode SetSchedulePolicy(const SchedulePolicy policy) override;
     ExceptionErrorCode DisableTaskNotification(
         const std::vector<std::string> &tids, std::vector<ExceptionErrorCode> &rets) override;
+    ExceptionErrorCode SubscribeTasks(const std::vector<std::string> &tids, bool openChannel, int32_t &sockFd,
+        std::vector<TaskInfoRet> &rets) override;
 
     int32_t Create(const Config &config, std::string &tid) override;
     int32_t GetTask(const std::string &tid, const std::string &token, Config &config) override;
@@ -66,10 +71,14 @@ public:
     int32_t Stop(const std::string &tid) override;
     int32_t Query(const std::string &tid, TaskInfo &info) override;
     int32_t Touch(const std::string &tid, const std::string &token, TaskInfo &info) override;
-    int32_t Search(const Filter &filter, std::vector<std::string> &tids) override;
+    int32_t Search(const Filter &filter, std::vector<std::string> &tids, std::string &next) override;
     int32_t Show(const std::string &tid, TaskInfo &info) override;
 
     int32_t OpenChannel(int32_t &sockFd) override;
+    int32_t OpenProgressTable(int32_t &fd) override;
+    int32_t GetStats(std::map<std::string, uint64_t> &stats) override;
+    int32_t OpenSharedCache(const std::string &url, int32_t &fd) override;
+    int32_t PublishSharedCache(const std::string &url, int32_t fd) override;
     int32_t Subscribe(const std::string &tid) override;
     int32_t Unsubscribe(const std::string &tid) override;
     int32_t SubRunCount(const sptr<NotifyInterface> &listener) override;
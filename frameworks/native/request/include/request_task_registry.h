@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_REQUEST_TASK_REGISTRY_H
+#define OHOS_REQUEST_TASK_REGISTRY_H
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+#include "request.h"
+
+namespace OHOS::Request {
+
+// Tasks of the process keyed by their numeric id, sharded so that lookups from the
+// receive path only take a shared lock of one shard and never allocate.
+class TaskRegistry {
+public:
+    static bool ParseTaskId(const std::string &taskId, uint32_t &id);
+    std::shared_ptr<Request> Get(uint32_t id);
+    std::shared_ptr<Request> GetOrCreate(uint32_t id);
+    void Erase(uint32_t id);
+
+private:
+    static constexpr uint32_t SHARD_COUNT = 16;
+    struct Shard {
+        std::shared_mutex mutex;
+        std::unordered_map<uint32_t, std::shared_ptr<Request>> tasks;
+    };
+    Shard &ShardOf(uint32_t id);
+
+    std::array<Shard, SHARD_COUNT> shards_;
+};
+
+} // namespace OHOS::Request
+
+#endif // OHOS_REQUEST_TASK_REGISTRY_H
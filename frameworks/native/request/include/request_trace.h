@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_REQUEST_TRACE_H
+#define OHOS_REQUEST_TRACE_H
+
+#include <cstdint>
+#include <string>
+
+#include "visibility.h"
+
+namespace OHOS::Request {
+
+// Trace of a request from the API call to its notifications. The id is made when the task is created and sent
+// to the service in its config, and the async spans of both processes are named after it, so one trace view
+// shows every stage of the request.
+class RequestTrace {
+public:
+    // Returns a new trace id, never 0.
+    REQUEST_API static uint64_t NewId();
+    // Binds the task `tid` to the trace `traceId`, the callbacks of its notifications are then traced.
+    static void Bind(const std::string &tid, uint64_t traceId);
+    static void Unbind(uint32_t taskId);
+    // Returns the trace of the task `taskId`, 0 if untraced.
+    static uint64_t Of(uint32_t taskId);
+};
+
+// Async span of a stage of a trace, nothing if the trace id is 0. It ends when destroyed, possibly on another
+// thread.
+class TraceSpan {
+public:
+    REQUEST_API TraceSpan(uint64_t traceId, const char *stage);
+    REQUEST_API ~TraceSpan();
+    TraceSpan(const TraceSpan &) = delete;
+    TraceSpan &operator=(const TraceSpan &) = delete;
+
+private:
+    std::string name_;
+    int32_t id_ = 0;
+};
+
+} // namespace OHOS::Request
+
+#endif // OHOS_REQUEST_TRACE_H
@@ -16,6 +16,11 @@
 #ifndef OHOS_REQUEST_RESPONSE_MESSAGE_RECEIVER_H
 #define OHOS_REQUEST_RESPONSE_MESSAGE_RECEIVER_H
 
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <vector>
+
 #include "event_handler.h"
 #include "event_runner.h"
 #include "i_response_message_handler.h"
@@ -27,6 +32,17 @@ enum MessageType {
     NOTIFY_DATA,
     FAULTS,
     WAIT,
+    BATCH,
+    NOTIFY_DATA_V2,
+    RUN_COUNT,
+    BODY,
+};
+
+// Last values decoded for a task, the base of the next v2 notify data deltas.
+struct NotifyTaskState {
+    uint64_t processed{ 0 };
+    uint64_t totalProcessed{ 0 };
+    std::vector<int64_t> sizes;
 };
 
 class ResponseMessageReceiver
@@ -35,10 +51,22 @@ class ResponseMessageReceiver
 public:
     static constexpr uint32_t RESPONSE_MAX_SIZE = 16 * 1024;
     static constexpr uint32_t RESPONSE_MAGIC_NUM = 0x43434646;
+    static constexpr int32_t MSG_HEADER_SIZE = 12;
+    static constexpr uint32_t CREDIT_MAGIC_NUM = 0x43524454;
+    static constexpr uint32_t CREDIT_WINDOW = 32;
+    static constexpr uint32_t CAPABILITY_NOTIFY_DATA_V2 = 0x01;
+    static constexpr uint32_t CAPABILITY_RUN_COUNT = 0x02;
+    static constexpr uint8_t NOTIFY_V2_FLAG_SIZES = 0x01;
+    static constexpr uint8_t NOTIFY_V2_FLAG_ABSOLUTE = 0x02;
+    static constexpr uint8_t NOTIFY_V2_FLAG_RESET = 0x04;
 
-    ResponseMessageReceiver(IResponseMessageHandler *handler, int32_t sockFd);
+    // With a dedicated reader the socket is drained and decoded on its own thread, and the handler
+    // callbacks are handed over to the main thread in batches.
+    ResponseMessageReceiver(IResponseMessageHandler *handler, int32_t sockFd, bool dedicatedReader = false);
     void BeginReceive();
     void Shutdown(void);
+    static void ParseResponseHeaders(
+        std::string_view raw, std::map<std::string, std::vector<std::string>> &headers);
 
 private:
     static int32_t Int64FromParcel(int64_t &num, char *&parcel, int32_t &size);
@@ -51,32 +79,60 @@ private:
     static int32_t VersionFromParcel(Version &version, char *&parcel, int32_t &size);
     static int32_t SubscribeTypeFromParcel(SubscribeType &type, char *&parcel, int32_t &size);
     static int32_t StringFromParcel(std::string &str, char *&parcel, int32_t &size);
-    static int32_t ResponseHeaderFromParcel(
-        std::map<std::string, std::vector<std::string>> &headers, char *&parcel, int32_t &size);
+    static int32_t ResponseHeaderFromParcel(std::string &rawHeaders, char *&parcel, int32_t &size);
     static int32_t ProgressExtrasFromParcel(std::map<std::string, std::string> &extras, char *&parcel, int32_t &size);
     void OnReadable(int32_t fd) override;
     bool ReadUdsData(char *buffer, int32_t readSize, int32_t &length);
+    void SendCredits(uint32_t credits, uint32_t capabilities = 0);
     static int32_t VecInt64FromParcel(std::vector<int64_t> &vec, char *&parcel, int32_t &size);
     static int32_t MsgHeaderParcel(int32_t &msgId, int16_t &msgType, int16_t &bodySize, char *&parcel, int32_t &size);
     static int32_t ResponseFromParcel(std::shared_ptr<Response> &response, char *&parcel, int32_t &size);
     static int32_t TaskStatesFromParcel(std::vector<TaskState> &taskStates, char *&parcel, int32_t &size);
     static int32_t NotifyDataFromParcel(std::shared_ptr<NotifyData> &notifyData, char *&parcel, int32_t &size);
+    static int32_t VarintFromParcel(uint64_t &num, char *&parcel, int32_t &size);
+    static int32_t SignedVarintFromParcel(int64_t &num, char *&parcel, int32_t &size);
+    static int32_t BytesFromParcel(std::string &str, char *&parcel, int32_t &size);
+    int32_t NotifyDataV2FromParcel(std::shared_ptr<NotifyData> &notifyData, char *&parcel, int32_t &size);
+    int32_t NotifyExtrasV2FromParcel(std::map<std::string, std::string> &extras, char *&parcel, int32_t &size);
     static int32_t ReasonFromParcel(Reason &reason, char *&parcel, int32_t &size);
     static int32_t ReasonDataFromParcel(std::shared_ptr<int32_t> &tid, std::shared_ptr<SubscribeType> &type,
         std::shared_ptr<Reason> &reason, char *&parcel, int32_t &size);
+    void HandMessage(int16_t msgType, char *&leftBuf, int32_t &leftLen);
+    void HandBatchData(char *&leftBuf, int32_t &leftLen);
     void HandResponseData(char *&leftBuf, int32_t &leftLen);
     void HandNotifyData(char *&leftBuf, int32_t &leftLen);
+    void HandNotifyDataV2(char *&leftBuf, int32_t &leftLen);
+    void DeliverNotifyData(const std::shared_ptr<NotifyData> &notifyData);
     void HandFaultsData(char *&leftBuf, int32_t &leftLen);
     void HandWaitData(char *&leftBuf, int32_t &leftLen);
+    void HandRunCountData(char *&leftBuf, int32_t &leftLen);
+    void HandBodyData(char *&leftBuf, int32_t &leftLen);
+    void AttachBody(const std::shared_ptr<NotifyData> &notifyData);
     void OnShutdown(int32_t fd) override;
     void OnException(int32_t fd) override;
-    void ShutdownChannel();
+    void ShutdownChannel(bool fromReader);
+    void Deliver(std::function<void()> callback);
+    void FlushDeliveries();
+    void RunDeliveries();
 
 private:
     IResponseMessageHandler *handler_;
     int32_t messageId_{ 1 };
     int32_t sockFd_{ -1 };
+    uint32_t consumedCredits_{ 0 };
+    std::vector<std::string> notifyKeys_;
+    std::map<uint32_t, NotifyTaskState> notifyTasks_;
+    // Bodies of in-memory downloads received so far, attached to their completed notify data.
+    std::map<uint32_t, std::vector<uint8_t>> bodies_;
     std::mutex sockFdMutex_;
+    bool dedicatedReader_{ false };
+    std::atomic<bool> brokenNotified_{ false };
+    std::shared_ptr<OHOS::AppExecFwk::EventRunner> readerRunner_;
+    std::shared_ptr<OHOS::AppExecFwk::EventHandler> fdHandler_;
+    std::shared_ptr<OHOS::AppExecFwk::EventHandler> mainHandler_;
+    std::mutex deliveriesMutex_;
+    std::vector<std::function<void()>> deliveries_;
+    bool deliveriesPosted_{ false };
 };
 
 } // namespace OHOS::Request
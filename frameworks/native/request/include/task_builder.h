@@ -16,46 +16,69 @@
 #ifndef RUNCOUNT_TASK_BUILDER_H
 #define RUNCOUNT_TASK_BUILDER_H
 
+#include <deque>
+#include <utility>
+#include <vector>
+
 #include "request_common.h"
 
 namespace OHOS::Request {
 
 class TaskBuilder {
 public:
+    // The overloads taking an rvalue move the value into the config instead of copying it.
     TaskBuilder &setAction(Action action);
     TaskBuilder &setUrl(const std::string &url);
+    TaskBuilder &setUrl(std::string &&url);
     TaskBuilder &setTitle(const std::string &title);
+    TaskBuilder &setTitle(std::string &&title);
     TaskBuilder &setDescription(const std::string &description);
+    TaskBuilder &setDescription(std::string &&description);
     TaskBuilder &setMode(Mode mode);
     TaskBuilder &setOverwrite(bool overwrite);
     TaskBuilder &setMethod(const std::string &method);
+    TaskBuilder &setMethod(std::string &&method);
     TaskBuilder &setHeaders(const std::map<std::string, std::string> &headers);
+    TaskBuilder &setHeaders(std::map<std::string, std::string> &&headers);
     TaskBuilder &setData(const std::string &data);
+    TaskBuilder &setData(std::string &&data);
     TaskBuilder &setData(const std::vector<FormItem> &data);
+    TaskBuilder &setData(std::vector<FormItem> &&data);
     TaskBuilder &setData(const std::vector<FileSpec> &data);
+    TaskBuilder &setData(std::vector<FileSpec> &&data);
     TaskBuilder &setSaveAs(const std::string &saveas);
+    TaskBuilder &setSaveAs(std::string &&saveas);
     TaskBuilder &setNetwork(Network network);
     TaskBuilder &setMetered(bool metered);
     TaskBuilder &setRoaming(bool roaming);
     TaskBuilder &setRetry(bool retry);
     TaskBuilder &setRedirect(bool redirect);
     TaskBuilder &setProxy(const std::string &proxy);
+    TaskBuilder &setProxy(std::string &&proxy);
     TaskBuilder &setIndex(uint32_t index);
     TaskBuilder &setBegins(int begins);
     TaskBuilder &setEnds(int ends);
     TaskBuilder &setGauge(bool gauge);
     TaskBuilder &setPrecise(bool precise);
     TaskBuilder &setToken(const std::string &token);
+    TaskBuilder &setToken(std::string &&token);
     TaskBuilder &setPriority(uint32_t priority);
     TaskBuilder &setExtras(const std::map<std::string, std::string> &extras);
+    TaskBuilder &setExtras(std::map<std::string, std::string> &&extras);
+    TaskBuilder &setNotification(const Notification &notification);
+    TaskBuilder &setNotification(Notification &&notification);
 
 public:
-    std::pair<Config, ExceptionErrorCode> build();
+    // Checks the config and returns a copy of it, the builder can be built again.
+    std::pair<Config, ExceptionErrorCode> build() &;
+    // Checks the config and moves it out, the builder is left empty.
+    std::pair<Config, ExceptionErrorCode> build() &&;
 
 private:
     Config config{
         .roaming = true,
     };
+    ExceptionErrorCode check();
     bool checkAction();
     bool checkUrl();
     bool checkData();
@@ -71,5 +94,33 @@ private:
     void checkMethod();
     void checkOtherConfig();
 };
+
+// Builds many tasks sharing some fields, such as the headers, network, proxy or notification, which are
+// only set once for the whole batch.
+class TaskBatchBuilder {
+public:
+    TaskBatchBuilder &setAction(Action action);
+    TaskBatchBuilder &setMode(Mode mode);
+    TaskBatchBuilder &setHeaders(const std::map<std::string, std::string> &headers);
+    TaskBatchBuilder &setHeaders(std::map<std::string, std::string> &&headers);
+    TaskBatchBuilder &setNetwork(Network network);
+    TaskBatchBuilder &setMetered(bool metered);
+    TaskBatchBuilder &setRoaming(bool roaming);
+    TaskBatchBuilder &setProxy(const std::string &proxy);
+    TaskBatchBuilder &setProxy(std::string &&proxy);
+    TaskBatchBuilder &setNotification(const Notification &notification);
+    TaskBatchBuilder &setNotification(Notification &&notification);
+
+    // Adds a task starting from the shared fields set so far, its own fields are set on the returned builder,
+    // which stays valid as long as the batch.
+    TaskBuilder &add();
+    size_t size() const;
+    // Checks every task and moves the configs out, in the order the tasks were added.
+    std::vector<std::pair<Config, ExceptionErrorCode>> build() &&;
+
+private:
+    TaskBuilder shared_;
+    std::deque<TaskBuilder> builders_;
+};
 } // namespace OHOS::Request
 #endif // RUNCOUNT_TASK_BUILDER_H
\ No newline at end of file
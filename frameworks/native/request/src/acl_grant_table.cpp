@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "acl_grant_table.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include "log.h"
+#include "storage_acl.h"
+
+namespace OHOS::Request {
+
+static constexpr int ACL_SUCC = 0;
+static const std::string PERMISSIONS = "rwx";
+static const std::string PERMISSIONS_CLEAN = "---";
+
+struct AclGrant {
+    uint32_t count = 0;
+    // Permissions set for the principal, empty when it has no access.
+    std::string permissions;
+    // Whether an ACL of the path is being set, with the table unlocked.
+    bool busy = false;
+};
+
+using GrantKey = std::pair<std::string, std::string>;
+
+static std::mutex grantMutex_;
+static std::condition_variable grantCv_;
+static std::map<GrantKey, std::shared_ptr<AclGrant>> grantMap_;
+
+// "u:3815:rw" -> ("u:3815", "rw")
+static bool SplitEntry(const std::string &entry, std::string &principal, std::string &permissions)
+{
+    size_t pos = entry.rfind(':');
+    if (pos == std::string::npos || pos == 0) {
+        return false;
+    }
+    principal = entry.substr(0, pos);
+    permissions = entry.substr(pos + 1);
+    return true;
+}
+
+// ("r", "wx") -> "rwx"
+static std::string MergePermissions(const std::string &left, const std::string &right)
+{
+    std::string merged;
+    for (char c : PERMISSIONS) {
+        if (left.find(c) != std::string::npos || right.find(c) != std::string::npos) {
+            merged.push_back(c);
+        }
+    }
+    return merged;
+}
+
+// Sets the ACL with the table unlocked; other references to the path wait for it on `busy`.
+static bool SetAcl(std::unique_lock<std::mutex> &lock, AclGrant &grant, const std::string &path,
+    const std::string &entry)
+{
+    grant.busy = true;
+    lock.unlock();
+    bool ret = StorageDaemon::AclSetAccess(path, entry) == ACL_SUCC;
+    lock.lock();
+    grant.busy = false;
+    grantCv_.notify_all();
+    return ret;
+}
+
+bool AclGrantTable::Acquire(const std::string &path, const std::string &entry, bool refresh)
+{
+    std::string principal;
+    std::string permissions;
+    if (!SplitEntry(entry, principal, permissions)) {
+        REQUEST_HILOGE("Acquire acl invalid entry");
+        return false;
+    }
+    std::unique_lock<std::mutex> lock(grantMutex_);
+    auto &slot = grantMap_[GrantKey(path, principal)];
+    if (slot == nullptr) {
+        slot = std::make_shared<AclGrant>();
+    }
+    std::shared_ptr<AclGrant> grant = slot;
+    grant->count++;
+    grantCv_.wait(lock, [&grant]() { return !grant->busy; });
+    std::string merged = MergePermissions(grant->permissions, permissions);
+    if (merged == grant->permissions && !refresh) {
+        return true;
+    }
+    if (!SetAcl(lock, *grant, path, principal + ":" + merged)) {
+        REQUEST_HILOGE("Acquire acl failed");
+        return false;
+    }
+    grant->permissions = merged;
+    return true;
+}
+
+bool AclGrantTable::Release(const std::string &path, const std::string &entry)
+{
+    std::string principal;
+    std::string permissions;
+    if (!SplitEntry(entry, principal, permissions)) {
+        REQUEST_HILOGE("Release acl invalid entry");
+        return false;
+    }
+    GrantKey key(path, principal);
+    std::unique_lock<std::mutex> lock(grantMutex_);
+    auto it = grantMap_.find(key);
+    if (it == grantMap_.end() || it->second->count == 0) {
+        REQUEST_HILOGE("Release acl not acquired");
+        return false;
+    }
+    std::shared_ptr<AclGrant> grant = it->second;
+    grant->count--;
+    if (grant->count > 0) {
+        return true;
+    }
+    grantCv_.wait(lock, [&grant]() { return !grant->busy; });
+    bool ret = true;
+    // Acquired again while waiting, the access is still in use.
+    if (grant->count == 0 && !grant->permissions.empty()) {
+        ret = SetAcl(lock, *grant, path, principal + ":" + PERMISSIONS_CLEAN);
+        if (!ret) {
+            REQUEST_HILOGE("Release acl failed");
+        }
+        grant->permissions.clear();
+    }
+    it = grantMap_.find(key);
+    if (grant->count == 0 && it != grantMap_.end() && it->second == grant) {
+        grantMap_.erase(it);
+    }
+    return ret;
+}
+
+} // namespace OHOS::Request
@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "notify_delivery.h"
+
+#include <pthread.h>
+
+#include <condition_variable>
+#include <thread>
+
+#include "log.h"
+
+namespace OHOS::Request {
+
+bool IsIntermediateProgress(const std::shared_ptr<NotifyData> &notifyData)
+{
+    return notifyData->type == SubscribeType::PROGRESS && notifyData->progress.state == State::RUNNING;
+}
+
+// Listeners with callbacks waiting, served in turn one callback at a time.
+class NotifyDeliveryWorker {
+public:
+    static NotifyDeliveryWorker &GetInstance()
+    {
+        // Never destroyed, its thread may still wait on it at exit.
+        static NotifyDeliveryWorker *worker = new NotifyDeliveryWorker();
+        return *worker;
+    }
+
+    void Schedule(const std::shared_ptr<NotifyDelivery> &delivery)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!started_) {
+            // The worker lives as long as the process, so does its thread.
+            std::thread(&NotifyDeliveryWorker::Run, this).detach();
+            started_ = true;
+        }
+        ready_.push_back(delivery);
+        cond_.notify_one();
+    }
+
+private:
+    void Run()
+    {
+        pthread_setname_np(pthread_self(), "req_notify");
+        while (true) {
+            std::shared_ptr<NotifyDelivery> delivery;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cond_.wait(lock, [this]() { return !ready_.empty(); });
+                delivery = ready_.front();
+                ready_.pop_front();
+            }
+            if (delivery->DeliverOne()) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                ready_.push_back(delivery);
+            }
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    std::deque<std::shared_ptr<NotifyDelivery>> ready_;
+    bool started_ = false;
+};
+
+NotifyDelivery::NotifyDelivery(size_t capacity) : capacity_(capacity)
+{
+}
+
+void NotifyDelivery::Push(std::function<void()> callback, bool droppable)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!MakeRoom(items_, capacity_, [](const Item &item) { return item.droppable; })) {
+            REQUEST_HILOGW("notify delivery full, %{public}zu callbacks waiting", items_.size());
+        }
+        items_.push_back(Item{ std::move(callback), droppable });
+        if (scheduled_) {
+            return;
+        }
+        scheduled_ = true;
+    }
+    NotifyDeliveryWorker::GetInstance().Schedule(shared_from_this());
+}
+
+void NotifyDelivery::Cancel()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    items_.clear();
+}
+
+bool NotifyDelivery::DeliverOne()
+{
+    std::function<void()> callback;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (items_.empty()) {
+            scheduled_ = false;
+            return false;
+        }
+        callback = std::move(items_.front().callback);
+        items_.pop_front();
+    }
+    callback();
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (items_.empty()) {
+        scheduled_ = false;
+        return false;
+    }
+    return true;
+}
+
+} // namespace OHOS::Request
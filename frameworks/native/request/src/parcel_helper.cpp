@@ -15,10 +15,23 @@
 
 #include "parcel_helper.h"
 
+#include <algorithm>
+#include <utility>
+
 #include "log.h"
 
 namespace OHOS {
 namespace Request {
+// A string takes at least 8 bytes of a parcel, its length and its padded terminator.
+static constexpr size_t MIN_STRING_BYTES = 8;
+
+// Capacity to reserve for `size` elements of `strings` strings each. Counts the rest of the parcel
+// cannot hold are not trusted.
+static size_t ReserveSize(MessageParcel &data, uint32_t size, size_t strings)
+{
+    return std::min(static_cast<size_t>(size), data.GetReadableBytes() / (strings * MIN_STRING_BYTES));
+}
+
 void ParcelHelper::UnMarshal(MessageParcel &data, TaskInfo &info)
 {
     UnMarshalBase(data, info);
@@ -39,6 +52,7 @@ void ParcelHelper::UnMarshal(MessageParcel &data, TaskInfo &info)
     if (!UnMarshalTaskState(data, info)) {
         return;
     }
+    UnMarshalPerformance(data, info);
 }
 
 void ParcelHelper::UnMarshalBase(MessageParcel &data, TaskInfo &info)
@@ -73,11 +87,12 @@ bool ParcelHelper::UnMarshalFormItem(MessageParcel &data, TaskInfo &info)
         REQUEST_HILOGE("Size exceeds the upper limit, size = %{public}u", size);
         return false;
     }
+    info.forms.reserve(ReserveSize(data, size, 2));
     for (uint32_t i = 0; i < size; i++) {
         FormItem form;
         form.name = data.ReadString();
         form.value = data.ReadString();
-        info.forms.push_back(form);
+        info.forms.push_back(std::move(form));
     }
     return true;
 }
@@ -89,13 +104,14 @@ bool ParcelHelper::UnMarshalFileSpec(MessageParcel &data, TaskInfo &info)
         REQUEST_HILOGE("Size exceeds the upper limit, size = %{public}u", size);
         return false;
     }
+    info.files.reserve(ReserveSize(data, size, 4));
     for (uint32_t i = 0; i < size; i++) {
         FileSpec file;
         file.name = data.ReadString();
         file.uri = data.ReadString();
         file.filename = data.ReadString();
         file.type = data.ReadString();
-        info.files.push_back(file);
+        info.files.push_back(std::move(file));
     }
     return true;
 }
@@ -107,6 +123,8 @@ void ParcelHelper::UnMarshalProgress(MessageParcel &data, TaskInfo &info)
     info.progress.processed = data.ReadUint64();
     info.progress.totalProcessed = data.ReadUint64();
     data.ReadInt64Vector(&info.progress.sizes);
+    info.progress.speed = data.ReadUint64();
+    info.progress.eta = data.ReadInt64();
 }
 
 bool ParcelHelper::UnMarshalMapProgressExtras(MessageParcel &data, TaskInfo &info)
@@ -118,7 +136,7 @@ bool ParcelHelper::UnMarshalMapProgressExtras(MessageParcel &data, TaskInfo &inf
     }
     for (uint32_t i = 0; i < size; i++) {
         std::string key = data.ReadString();
-        info.progress.extras[key] = data.ReadString();
+        info.progress.extras.insert_or_assign(std::move(key), data.ReadString());
     }
     return true;
 }
@@ -132,7 +150,7 @@ bool ParcelHelper::UnMarshalMapExtras(MessageParcel &data, TaskInfo &info)
     }
     for (uint32_t i = 0; i < size; i++) {
         std::string key = data.ReadString();
-        info.extras[key] = data.ReadString();
+        info.extras.insert_or_assign(std::move(key), data.ReadString());
     }
     return true;
 }
@@ -144,16 +162,28 @@ bool ParcelHelper::UnMarshalTaskState(MessageParcel &data, TaskInfo &info)
         REQUEST_HILOGE("Size exceeds the upper limit, size = %{public}u", size);
         return false;
     }
+    info.taskStates.reserve(ReserveSize(data, size, 2));
     for (uint32_t i = 0; i < size; i++) {
         TaskState taskState;
         taskState.path = data.ReadString();
         taskState.responseCode = data.ReadUint32();
         taskState.message = data.ReadString();
-        info.taskStates.push_back(taskState);
+        info.taskStates.push_back(std::move(taskState));
     }
     return true;
 }
 
+void ParcelHelper::UnMarshalPerformance(MessageParcel &data, TaskInfo &info)
+{
+    info.performance.attempt = data.ReadUint32();
+    info.performance.dns = data.ReadInt64();
+    info.performance.connect = data.ReadInt64();
+    info.performance.tls = data.ReadInt64();
+    info.performance.ttfb = data.ReadInt64();
+    info.performance.transfer = data.ReadInt64();
+    info.performance.server = data.ReadString();
+}
+
 void ParcelHelper::UnMarshalConfig(MessageParcel &data, Config &config)
 {
     config.action = static_cast<Action>(data.ReadUint32());
@@ -204,6 +234,25 @@ void ParcelHelper::UnMarshalConfig(MessageParcel &data, Config &config)
     // read min speed
     config.minSpeed.speed = data.ReadInt64();
     config.minSpeed.duration = data.ReadInt64();
+    // read stall detection
+    config.stallDetection.window = data.ReadInt64();
+    config.stallDetection.ratio = data.ReadInt64();
+    // read concurrency
+    config.concurrency = data.ReadUint32();
+    // read chunk size
+    config.chunkSize = data.ReadUint64();
+    // read deadline
+    config.deadline = data.ReadUint64();
+    // read coalesce
+    config.coalesce = data.ReadBool();
+    // read compression
+    config.compression = data.ReadBool();
+    // read memoryLimit
+    config.memoryLimit = data.ReadUint32();
+    // read prefetch
+    config.prefetch = data.ReadBool();
+    // read bypassCache
+    config.bypassCache = data.ReadBool();
 }
 
 bool ParcelHelper::UnMarshalConfigHeaders(MessageParcel &data, Config &config)
@@ -215,7 +264,7 @@ bool ParcelHelper::UnMarshalConfigHeaders(MessageParcel &data, Config &config)
     }
     for (uint32_t i = 0; i < headerLen; i++) {
         std::string key = data.ReadString();
-        config.headers[key] = data.ReadString();
+        config.headers.insert_or_assign(std::move(key), data.ReadString());
     }
     return true;
 }
@@ -229,7 +278,7 @@ bool ParcelHelper::UnMarshalConfigExtras(MessageParcel &data, Config &config)
     }
     for (uint32_t i = 0; i < extraLen; i++) {
         std::string key = data.ReadString();
-        config.extras[key] = data.ReadString();
+        config.extras.insert_or_assign(std::move(key), data.ReadString());
     }
     return true;
 }
@@ -241,11 +290,12 @@ bool ParcelHelper::UnMarshalConfigFormItem(MessageParcel &data, Config &config)
         REQUEST_HILOGE("Size exceeds the upper limit, size = %{public}u", size);
         return false;
     }
+    config.forms.reserve(ReserveSize(data, size, 2));
     for (uint32_t i = 0; i < size; i++) {
         FormItem form;
         form.name = data.ReadString();
         form.value = data.ReadString();
-        config.forms.push_back(form);
+        config.forms.push_back(std::move(form));
     }
     return true;
 }
@@ -257,13 +307,14 @@ bool ParcelHelper::UnMarshalConfigFileSpec(MessageParcel &data, Config &config)
         REQUEST_HILOGE("Size exceeds the upper limit, size = %{public}u", size);
         return false;
     }
+    config.files.reserve(ReserveSize(data, size, 4));
     for (uint32_t i = 0; i < size; i++) {
         FileSpec file;
         file.name = data.ReadString();
         file.uri = data.ReadString();
         file.filename = data.ReadString();
         file.type = data.ReadString();
-        config.files.push_back(file);
+        config.files.push_back(std::move(file));
     }
     return true;
 }
@@ -275,9 +326,9 @@ bool ParcelHelper::UnMarshalConfigBodyFileName(MessageParcel &data, Config &conf
         REQUEST_HILOGE("Size exceeds the upper limit, size = %{public}u", size);
         return false;
     }
+    config.bodyFileNames.reserve(ReserveSize(data, size, 1));
     for (uint32_t i = 0; i < size; i++) {
-        std::string name = data.ReadString();
-        config.bodyFileNames.push_back(name);
+        config.bodyFileNames.push_back(data.ReadString());
     }
     return true;
 }
@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "progress_table.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+
+#include "log.h"
+
+namespace OHOS::Request {
+namespace {
+constexpr uint32_t PROGRESS_TABLE_MAGIC = 0x52505447;
+constexpr uint32_t PROGRESS_TABLE_VERSION = 1;
+constexpr uint32_t SLOT_USED = 0x01;
+// A slot left odd by a service that died while writing it is given up on.
+constexpr int READ_RETRY_MAX = 64;
+
+struct Header {
+    std::atomic<uint32_t> magic;
+    std::atomic<uint32_t> version;
+    std::atomic<uint32_t> capacity;
+    std::atomic<uint32_t> reserved;
+};
+
+struct Slot {
+    std::atomic<uint32_t> seq;
+    std::atomic<uint32_t> tid;
+    std::atomic<uint32_t> state;
+    std::atomic<uint32_t> flags;
+    std::atomic<uint64_t> processed;
+    std::atomic<int64_t> total;
+    std::atomic<uint64_t> mtime;
+};
+
+static_assert(sizeof(Header) == 16 && sizeof(Slot) == 40, "layout shared with the service");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "slots are read from shared memory");
+
+const Slot *SlotAt(const void *base, uint32_t index)
+{
+    return reinterpret_cast<const Slot *>(static_cast<const uint8_t *>(base) + sizeof(Header)) + index;
+}
+} // namespace
+
+std::shared_ptr<ProgressTable> ProgressTable::Map(int32_t fd)
+{
+    struct stat st = {};
+    void *base = MAP_FAILED;
+    size_t len = 0;
+    if (fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= sizeof(Header)) {
+        len = static_cast<size_t>(st.st_size);
+        base = mmap(nullptr, len, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    fdsan_close_with_tag(fd, REQUEST_FDSAN_TAG);
+    if (base == MAP_FAILED) {
+        REQUEST_HILOGE("Map progress table failed");
+        return nullptr;
+    }
+    const Header *header = static_cast<const Header *>(base);
+    uint32_t capacity = header->capacity.load(std::memory_order_relaxed);
+    if (header->magic.load(std::memory_order_acquire) != PROGRESS_TABLE_MAGIC
+        || header->version.load(std::memory_order_relaxed) != PROGRESS_TABLE_VERSION
+        || sizeof(Header) + static_cast<size_t>(capacity) * sizeof(Slot) > len) {
+        REQUEST_HILOGE("Bad progress table, capacity %{public}u", capacity);
+        munmap(base, len);
+        return nullptr;
+    }
+    return std::shared_ptr<ProgressTable>(new ProgressTable(base, len, capacity));
+}
+
+ProgressTable::ProgressTable(void *base, size_t len, uint32_t capacity)
+    : base_(base), len_(len), capacity_(capacity)
+{
+}
+
+ProgressTable::~ProgressTable()
+{
+    munmap(base_, len_);
+}
+
+bool ProgressTable::Read(uint32_t tid, ProgressSnapshot &snapshot) const
+{
+    for (uint32_t i = 0; i < capacity_; i++) {
+        const Slot *slot = SlotAt(base_, i);
+        for (int retry = 0; retry < READ_RETRY_MAX; retry++) {
+            uint32_t seq = slot->seq.load(std::memory_order_acquire);
+            if ((seq & 1) != 0) {
+                continue;
+            }
+            uint32_t slotTid = slot->tid.load(std::memory_order_relaxed);
+            uint32_t flags = slot->flags.load(std::memory_order_relaxed);
+            ProgressSnapshot read;
+            read.state = static_cast<State>(slot->state.load(std::memory_order_relaxed));
+            read.processed = slot->processed.load(std::memory_order_relaxed);
+            read.total = slot->total.load(std::memory_order_relaxed);
+            read.mtime = slot->mtime.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot->seq.load(std::memory_order_relaxed) != seq) {
+                continue;
+            }
+            if ((flags & SLOT_USED) == 0 || slotTid != tid) {
+                break;
+            }
+            snapshot = read;
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace OHOS::Request
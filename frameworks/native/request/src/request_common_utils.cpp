@@ -51,6 +51,9 @@ Faults CommonUtils::GetFaultByReason(Reason code)
         { APP_ACCOUNT, Faults::OTHERS },
         { NETWORK_APP_ACCOUNT, Faults::DISCONNECTED },
         { LOW_SPEED, Faults::LOW_SPEED },
+        { CHECKSUM_MISMATCH, Faults::FSIO },
+        { BODY_TOO_LARGE, Faults::OTHERS },
+        { ORIGIN_UNAVAILABLE, Faults::TCP },
     };
     static const std::unordered_set<Faults> downgradeFaults = { Faults::PARAM, Faults::DNS, Faults::TCP, Faults::SSL,
         Faults::REDIRECT };
@@ -104,6 +107,9 @@ std::string CommonUtils::GetMsgByReason(Reason code)
         { APP_ACCOUNT, APP_ACCOUNT_INFO },
         { NETWORK_APP_ACCOUNT, NETWORK_ACCOUNT_APP_INFO },
         { LOW_SPEED, LOW_SPEED_INFO },
+        { CHECKSUM_MISMATCH, CHECKSUM_MISMATCH_INFO },
+        { BODY_TOO_LARGE, BODY_TOO_LARGE_INFO },
+        { ORIGIN_UNAVAILABLE, ORIGIN_UNAVAILABLE_INFO },
     };
     auto iter = reasonMsg.find(code);
     if (iter == reasonMsg.end()) {
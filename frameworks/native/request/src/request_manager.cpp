@@ -64,9 +64,16 @@ ExceptionErrorCode RequestManager::PauseTasks(
     return RequestManagerImpl::GetInstance()->PauseTasks(tids, version, rets);
 }
 
-ExceptionErrorCode RequestManager::ShowTasks(const std::vector<std::string> &tids, std::vector<TaskInfoRet> &rets)
+ExceptionErrorCode RequestManager::QueryTasks(
+    const std::vector<std::string> &tids, std::vector<TaskInfoRet> &rets, uint32_t fields)
 {
-    return RequestManagerImpl::GetInstance()->ShowTasks(tids, rets);
+    return RequestManagerImpl::GetInstance()->QueryTasks(tids, rets, fields);
+}
+
+ExceptionErrorCode RequestManager::ShowTasks(
+    const std::vector<std::string> &tids, std::vector<TaskInfoRet> &rets, uint32_t fields)
+{
+    return RequestManagerImpl::GetInstance()->ShowTasks(tids, rets, fields);
 }
 
 ExceptionErrorCode RequestManager::TouchTasks(
@@ -86,6 +93,11 @@ ExceptionErrorCode RequestManager::SetMode(const std::string &tid, const Mode mo
     return RequestManagerImpl::GetInstance()->SetMode(tid, mode);
 }
 
+ExceptionErrorCode RequestManager::SetSchedulePolicy(const SchedulePolicy policy)
+{
+    return RequestManagerImpl::GetInstance()->SetSchedulePolicy(policy);
+}
+
 ExceptionErrorCode RequestManager::DisableTaskNotification(
     const std::vector<std::string> &tids, std::vector<ExceptionErrorCode> &rets)
 {
@@ -124,6 +136,11 @@ int32_t RequestManager::Search(const Filter &filter, std::vector<std::string> &t
     return RequestManagerImpl::GetInstance()->Search(filter, tids);
 }
 
+int32_t RequestManager::SearchPage(const Filter &filter, std::vector<std::string> &tids, std::string &next)
+{
+    return RequestManagerImpl::GetInstance()->SearchPage(filter, tids, next);
+}
+
 int32_t RequestManager::Show(const std::string &tid, TaskInfo &info)
 {
     return RequestManagerImpl::GetInstance()->Show(tid, info);
@@ -154,16 +171,42 @@ int32_t RequestManager::SetMaxSpeed(const std::string &tid, const int64_t maxSpe
     return RequestManagerImpl::GetInstance()->SetMaxSpeed(tid, maxSpeed);
 }
 
+int32_t RequestManager::GetStats(std::map<std::string, uint64_t> &stats)
+{
+    return RequestManagerImpl::GetInstance()->GetStats(stats);
+}
+
+int32_t RequestManager::OpenSharedCache(const std::string &url, int32_t &fd)
+{
+    return RequestManagerImpl::GetInstance()->OpenSharedCache(url, fd);
+}
+
+int32_t RequestManager::PublishSharedCache(const std::string &url, int32_t fd)
+{
+    return RequestManagerImpl::GetInstance()->PublishSharedCache(url, fd);
+}
+
 int32_t RequestManager::Subscribe(const std::string &taskId)
 {
     return RequestManagerImpl::GetInstance()->Subscribe(taskId);
 }
 
+ExceptionErrorCode RequestManager::SubscribeTasks(
+    const std::vector<std::string> &tids, std::vector<ExceptionErrorCode> &rets)
+{
+    return RequestManagerImpl::GetInstance()->SubscribeTasks(tids, rets);
+}
+
 int32_t RequestManager::Unsubscribe(const std::string &taskId)
 {
     return RequestManagerImpl::GetInstance()->Unsubscribe(taskId);
 }
 
+int32_t RequestManager::ReadProgressSnapshot(const std::string &tid, ProgressSnapshot &snapshot)
+{
+    return RequestManagerImpl::GetInstance()->ReadProgressSnapshot(tid, snapshot);
+}
+
 void RequestManager::RestoreListener(void (*callback)())
 {
     return RequestManagerImpl::GetInstance()->RestoreListener(callback);
@@ -174,6 +217,11 @@ void RequestManager::LoadRequestServer()
     RequestManagerImpl::GetInstance()->LoadRequestServer();
 }
 
+int32_t RequestManager::Prewarm()
+{
+    return RequestManagerImpl::GetInstance()->Prewarm();
+}
+
 bool RequestManager::SubscribeSA()
 {
     return RequestManagerImpl::GetInstance()->SubscribeSA();
@@ -194,6 +242,11 @@ void RequestManager::ReopenChannel()
     return RequestManagerImpl::GetInstance()->ReopenChannel();
 }
 
+void RequestManager::SetDedicatedReader(bool enable)
+{
+    RequestManagerImpl::GetInstance()->SetDedicatedReader(enable);
+}
+
 int32_t RequestManager::AddListener(
     const std::string &taskId, const SubscribeType &type, const std::shared_ptr<IResponseListener> &listener)
 {
@@ -15,6 +15,7 @@
 
 #include "request_manager_impl.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cstdint>
 #include <memory>
@@ -33,6 +34,7 @@
 #include "request_manager.h"
 #include "request_running_task_count.h"
 #include "request_service_interface.h"
+#include "request_trace.h"
 #include "response_message_receiver.h"
 #include "result_set.h"
 #include "runcount_notify_stub.h"
@@ -52,6 +54,11 @@ ExceptionErrorCode RequestManagerImpl::SetMode(const std::string &tid, const Mod
     return static_cast<ExceptionErrorCode>(CallProxyMethod(&RequestServiceInterface::SetMode, tid, mode));
 }
 
+ExceptionErrorCode RequestManagerImpl::SetSchedulePolicy(const SchedulePolicy policy)
+{
+    return static_cast<ExceptionErrorCode>(CallProxyMethod(&RequestServiceInterface::SetSchedulePolicy, policy));
+}
+
 ExceptionErrorCode RequestManagerImpl::DisableTaskNotification(
     const std::vector<std::string> &tids, std::vector<ExceptionErrorCode> &rets)
 {
@@ -67,17 +74,32 @@ ExceptionErrorCode RequestManagerImpl::CreateTasks(const std::vector<Config> &co
     this->EnsureChannelOpen();
     int ret = CallProxyMethod(&RequestServiceInterface::CreateTasks, configs, rets);
     if (ret == E_OK) {
-        bool channelOpened = false;
-        for (auto taskRet : rets) {
-            if (taskRet.code != E_CHANNEL_NOT_OPEN) {
-                continue;
+        std::vector<std::string> tids;
+        std::vector<size_t> indexes;
+        for (size_t i = 0; i < rets.size(); i++) {
+            if (rets[i].code == E_CHANNEL_NOT_OPEN) {
+                tids.push_back(rets[i].tid);
+                indexes.push_back(i);
             }
-            if (!channelOpened) {
-                this->ReopenChannel();
-                channelOpened = true;
+        }
+        if (!tids.empty()) {
+            // The service lost the channel, a new one is opened by the call subscribing to the tasks.
+            std::lock_guard<std::recursive_mutex> lock(msgReceiverMutex_);
+            if (msgReceiver_) {
+                msgReceiver_->Shutdown();
+            }
+            std::vector<ExceptionErrorCode> subRets;
+            this->SubscribeTasks(tids, subRets);
+            for (size_t i = 0; i < indexes.size(); i++) {
+                rets[indexes[i]].code = subRets[i];
+            }
+        }
+    }
+    for (auto &config : configs) {
+        for (auto &file : config.files) {
+            if (file.fd > 0) {
+                fdsan_close_with_tag(file.fd, REQUEST_FDSAN_TAG);
             }
-            taskRet.code =
-                static_cast<ExceptionErrorCode>(CallProxyMethod(&RequestServiceInterface::Subscribe, taskRet.tid));
         }
     }
     return static_cast<ExceptionErrorCode>(ret);
@@ -113,14 +135,16 @@ ExceptionErrorCode RequestManagerImpl::PauseTasks(
     return static_cast<ExceptionErrorCode>(CallProxyMethod(&RequestServiceInterface::PauseTasks, tids, version, rets));
 }
 
-ExceptionErrorCode RequestManagerImpl::QueryTasks(const std::vector<std::string> &tids, std::vector<TaskInfoRet> &rets)
+ExceptionErrorCode RequestManagerImpl::QueryTasks(
+    const std::vector<std::string> &tids, std::vector<TaskInfoRet> &rets, uint32_t fields)
 {
-    return static_cast<ExceptionErrorCode>(CallProxyMethod(&RequestServiceInterface::QueryTasks, tids, rets));
+    return static_cast<ExceptionErrorCode>(CallProxyMethod(&RequestServiceInterface::QueryTasks, tids, fields, rets));
 }
 
-ExceptionErrorCode RequestManagerImpl::ShowTasks(const std::vector<std::string> &tids, std::vector<TaskInfoRet> &rets)
+ExceptionErrorCode RequestManagerImpl::ShowTasks(
+    const std::vector<std::string> &tids, std::vector<TaskInfoRet> &rets, uint32_t fields)
 {
-    return static_cast<ExceptionErrorCode>(CallProxyMethod(&RequestServiceInterface::ShowTasks, tids, rets));
+    return static_cast<ExceptionErrorCode>(CallProxyMethod(&RequestServiceInterface::ShowTasks, tids, fields, rets));
 }
 
 ExceptionErrorCode RequestManagerImpl::TouchTasks(
@@ -137,6 +161,7 @@ ExceptionErrorCode RequestManagerImpl::SetMaxSpeeds(
 
 int32_t RequestManagerImpl::Create(const Config &config, int32_t seq, std::string &tid)
 {
+    TraceSpan span(config.traceId, "ipc create");
     this->EnsureChannelOpen();
 
     int ret = CallProxyMethod(&RequestServiceInterface::Create, config, tid);
@@ -149,14 +174,17 @@ int32_t RequestManagerImpl::Create(const Config &config, int32_t seq, std::strin
     }
     if (ret != E_OK) {
         REQUEST_HILOGE("Request create, seq: %{public}d, failed: %{public}d", seq, ret);
+    } else {
+        RequestTrace::Bind(tid, config.traceId);
     }
     for (auto &file : config.files) {
-        if (file.isUserFile) {
-            if (file.fd > 0) {
-                fdsan_close_with_tag(file.fd, REQUEST_FDSAN_TAG);
-            }
+        if (file.fd > 0) {
+            fdsan_close_with_tag(file.fd, REQUEST_FDSAN_TAG);
         }
     }
+    if (config.cachedBodyFd >= 0) {
+        fdsan_close_with_tag(config.cachedBodyFd, REQUEST_FDSAN_TAG);
+    }
     return ret;
 }
 
@@ -198,7 +226,13 @@ int32_t RequestManagerImpl::Touch(const std::string &tid, const std::string &tok
 
 int32_t RequestManagerImpl::Search(const Filter &filter, std::vector<std::string> &tids)
 {
-    return CallProxyMethod(&RequestServiceInterface::Search, filter, tids);
+    std::string next;
+    return CallProxyMethod(&RequestServiceInterface::Search, filter, tids, next);
+}
+
+int32_t RequestManagerImpl::SearchPage(const Filter &filter, std::vector<std::string> &tids, std::string &next)
+{
+    return CallProxyMethod(&RequestServiceInterface::Search, filter, tids, next);
 }
 
 int32_t RequestManagerImpl::Show(const std::string &tid, TaskInfo &info)
@@ -249,6 +283,21 @@ int32_t RequestManagerImpl::SetMaxSpeed(const std::string &tid, const int64_t ma
     return CallProxyMethod(&RequestServiceInterface::SetMaxSpeed, tid, maxSpeed);
 }
 
+int32_t RequestManagerImpl::GetStats(std::map<std::string, uint64_t> &stats)
+{
+    return CallProxyMethod(&RequestServiceInterface::GetStats, stats);
+}
+
+int32_t RequestManagerImpl::OpenSharedCache(const std::string &url, int32_t &fd)
+{
+    return CallProxyMethod(&RequestServiceInterface::OpenSharedCache, url, fd);
+}
+
+int32_t RequestManagerImpl::PublishSharedCache(const std::string &url, int32_t fd)
+{
+    return CallProxyMethod(&RequestServiceInterface::PublishSharedCache, url, fd);
+}
+
 int32_t RequestManagerImpl::AddListener(
     const std::string &taskId, const SubscribeType &type, const std::shared_ptr<IResponseListener> &listener)
 {
@@ -305,8 +354,10 @@ int32_t RequestManagerImpl::RemoveListener(
 void RequestManagerImpl::RemoveAllListeners(const std::string &taskId)
 {
     REQUEST_HILOGD("RemoveAllListeners in, tid:%{public}s", taskId.c_str());
-    std::lock_guard<std::mutex> lock(tasksMutex_);
-    tasks_.erase(taskId);
+    uint32_t id = 0;
+    if (TaskRegistry::ParseTaskId(taskId, id)) {
+        tasks_.Erase(id);
+    }
 }
 
 int32_t RequestManagerImpl::Subscribe(const std::string &taskId)
@@ -320,6 +371,66 @@ int32_t RequestManagerImpl::Subscribe(const std::string &taskId)
     return ret;
 }
 
+ExceptionErrorCode RequestManagerImpl::SubscribeTasks(
+    const std::vector<std::string> &tids, std::vector<ExceptionErrorCode> &rets)
+{
+    rets.assign(tids.size(), E_OTHER);
+    std::vector<TaskInfo> states;
+    std::unique_lock<std::recursive_mutex> lock(msgReceiverMutex_);
+    for (size_t begin = 0; begin < tids.size(); begin += SUBSCRIBE_TASKS_MAX) {
+        size_t end = std::min(tids.size(), begin + SUBSCRIBE_TASKS_MAX);
+        std::vector<std::string> chunk(tids.begin() + begin, tids.begin() + end);
+        bool openChannel = !msgReceiver_;
+        int32_t sockFd = -1;
+        std::vector<TaskInfoRet> infoRets;
+        int32_t ret =
+            CallProxyMethod(&RequestServiceInterface::SubscribeTasks, chunk, openChannel, sockFd, infoRets);
+        if (ret != E_OK) {
+            REQUEST_HILOGE("SubscribeTasks failed: %{public}d", ret);
+            return static_cast<ExceptionErrorCode>(ret);
+        }
+        if (openChannel) {
+            if (sockFd == -1) {
+                REQUEST_HILOGE("SubscribeTasks but fd -1");
+                return E_SERVICE_ERROR;
+            }
+            this->BeginReceive(sockFd);
+        }
+        for (size_t i = 0; i < infoRets.size() && begin + i < end; i++) {
+            rets[begin + i] = infoRets[i].code;
+            if (infoRets[i].code == E_OK) {
+                states.push_back(std::move(infoRets[i].info));
+            }
+        }
+    }
+    lock.unlock();
+    for (const TaskInfo &info : states) {
+        this->CatchUp(info);
+    }
+    return E_OK;
+}
+
+void RequestManagerImpl::CatchUp(const TaskInfo &info)
+{
+    State state = info.progress.state;
+    // Finished tasks already notified their end, those not started have nothing to catch up on.
+    if (state != State::WAITING && state != State::RUNNING && state != State::RETRYING && state != State::PAUSED) {
+        return;
+    }
+    uint32_t id = 0;
+    if (!TaskRegistry::ParseTaskId(info.tid, id)) {
+        return;
+    }
+    auto notifyData = std::make_shared<NotifyData>();
+    notifyData->type = SubscribeType::PROGRESS;
+    notifyData->taskId = id;
+    notifyData->progress = info.progress;
+    notifyData->action = info.action;
+    notifyData->version = info.version;
+    notifyData->mode = info.mode;
+    this->OnNotifyDataReceive(notifyData);
+}
+
 int32_t RequestManagerImpl::Unsubscribe(const std::string &taskId)
 {
     return CallProxyMethod(&RequestServiceInterface::Unsubscribe, taskId);
@@ -366,35 +477,88 @@ int32_t RequestManagerImpl::EnsureChannelOpen()
         REQUEST_HILOGE("EnsureChannelOpen but fd -1: %{public}d", sockFd);
         return ret;
     }
-    fdsan_exchange_owner_tag(sockFd, 0, REQUEST_FDSAN_TAG);
     REQUEST_HILOGD("EnsureChannelOpen ok: %{public}d", sockFd);
-    msgReceiver_ = std::make_shared<ResponseMessageReceiver>(this, sockFd);
-    msgReceiver_->BeginReceive();
+    this->BeginReceive(sockFd);
     return E_OK;
 }
 
+void RequestManagerImpl::BeginReceive(int32_t sockFd)
+{
+    fdsan_exchange_owner_tag(sockFd, 0, REQUEST_FDSAN_TAG);
+    msgReceiver_ = std::make_shared<ResponseMessageReceiver>(this, sockFd, dedicatedReader_.load());
+    msgReceiver_->BeginReceive();
+}
+
+int32_t RequestManagerImpl::ReadProgressSnapshot(const std::string &tid, ProgressSnapshot &snapshot)
+{
+    uint32_t id = 0;
+    if (!TaskRegistry::ParseTaskId(tid, id)) {
+        return E_TASK_NOT_FOUND;
+    }
+    std::shared_ptr<ProgressTable> table = std::atomic_load(&progressTable_);
+    if (table == nullptr) {
+        int32_t ret = E_OK;
+        table = this->OpenProgressTable(ret);
+        if (table == nullptr) {
+            return ret;
+        }
+    }
+    return table->Read(id, snapshot) ? E_OK : E_TASK_NOT_FOUND;
+}
+
+std::shared_ptr<ProgressTable> RequestManagerImpl::OpenProgressTable(int32_t &ret)
+{
+    std::lock_guard<std::mutex> lock(progressTableMutex_);
+    std::shared_ptr<ProgressTable> table = std::atomic_load(&progressTable_);
+    if (table != nullptr) {
+        return table;
+    }
+    ret = this->EnsureChannelOpen();
+    if (ret != E_OK) {
+        return nullptr;
+    }
+    int32_t fd = -1;
+    ret = CallProxyMethod(&RequestServiceInterface::OpenProgressTable, fd);
+    if (ret != E_OK || fd == -1) {
+        REQUEST_HILOGE("OpenProgressTable failed: %{public}d, %{public}d", ret, fd);
+        ret = E_SERVICE_ERROR;
+        return nullptr;
+    }
+    fdsan_exchange_owner_tag(fd, 0, REQUEST_FDSAN_TAG);
+    table = ProgressTable::Map(fd);
+    if (table == nullptr) {
+        ret = E_SERVICE_ERROR;
+        return nullptr;
+    }
+    std::atomic_store(&progressTable_, table);
+    return table;
+}
+
 std::shared_ptr<Request> RequestManagerImpl::GetTask(const std::string &taskId)
 {
-    std::lock_guard<std::mutex> lock(tasksMutex_);
-    auto it = tasks_.find(taskId);
-    if (it != tasks_.end()) {
-        return it->second;
+    uint32_t id = 0;
+    if (!TaskRegistry::ParseTaskId(taskId, id)) {
+        REQUEST_HILOGE("Bad task id: %{public}s", taskId.c_str());
+        return std::shared_ptr<Request>(nullptr);
     }
+    return this->GetTask(id);
+}
 
-    auto retPair = this->tasks_.emplace(taskId, std::make_shared<Request>(taskId));
-    if (retPair.second) {
-        return retPair.first->second;
-    } else {
-        this->tasks_.erase(taskId);
+std::shared_ptr<Request> RequestManagerImpl::GetTask(uint32_t taskId)
+{
+    std::shared_ptr<Request> task = this->tasks_.GetOrCreate(taskId);
+    if (task.get() == nullptr) {
         REQUEST_HILOGE("Response Task create fail");
-        return std::shared_ptr<Request>(nullptr);
     }
+    return task;
 }
 
 void RequestManagerImpl::OnChannelBroken()
 {
     std::lock_guard<std::recursive_mutex> lock(msgReceiverMutex_);
     this->msgReceiver_.reset();
+    // The table of a restarted service is opened again with the new channel.
+    std::atomic_store(&progressTable_, std::shared_ptr<ProgressTable>(nullptr));
 }
 
 void RequestManagerImpl::OnResponseReceive(const std::shared_ptr<Response> &response)
@@ -409,7 +573,7 @@ void RequestManagerImpl::OnResponseReceive(const std::shared_ptr<Response> &resp
 
 void RequestManagerImpl::OnNotifyDataReceive(const std::shared_ptr<NotifyData> &notifyData)
 {
-    std::shared_ptr<Request> task = this->GetTask(std::to_string(notifyData->taskId));
+    std::shared_ptr<Request> task = this->GetTask(notifyData->taskId);
     if (task.get() == nullptr) {
         REQUEST_HILOGE("OnNotifyDataReceive task not found");
         return;
@@ -420,7 +584,7 @@ void RequestManagerImpl::OnNotifyDataReceive(const std::shared_ptr<NotifyData> &
 void RequestManagerImpl::OnFaultsReceive(const std::shared_ptr<int32_t> &tid,
     const std::shared_ptr<SubscribeType> &type, const std::shared_ptr<Reason> &reason)
 {
-    std::shared_ptr<Request> task = this->GetTask(std::to_string(*tid));
+    std::shared_ptr<Request> task = this->GetTask(static_cast<uint32_t>(*tid));
     if (task.get() == nullptr) {
         REQUEST_HILOGE("OnFaultsReceive task not found");
         return;
@@ -430,7 +594,7 @@ void RequestManagerImpl::OnFaultsReceive(const std::shared_ptr<int32_t> &tid,
 
 void RequestManagerImpl::OnWaitReceive(std::int32_t taskId, WaitingReason reason)
 {
-    std::shared_ptr<Request> task = this->GetTask(std::to_string(taskId));
+    std::shared_ptr<Request> task = this->GetTask(static_cast<uint32_t>(taskId));
     if (task.get() == nullptr) {
         REQUEST_HILOGE("OnWaitReceive task not found");
         return;
@@ -438,8 +602,23 @@ void RequestManagerImpl::OnWaitReceive(std::int32_t taskId, WaitingReason reason
     task->OnWaitReceive(taskId, reason);
 }
 
+void RequestManagerImpl::OnRunCountReceive(int64_t runCount)
+{
+    int count = static_cast<int>(runCount);
+    REQUEST_HILOGD("RunCount num %{public}d", count);
+    FwkRunningTaskCountManager::GetInstance()->SetCount(count);
+    FwkRunningTaskCountManager::GetInstance()->NotifyAllObservers();
+}
+
 sptr<RequestServiceInterface> RequestManagerImpl::GetRequestServiceProxy(bool needLoadSA)
 {
+    // Steady state: the published proxy is read without taking serviceProxyMutex_.
+    if (needLoadSA) {
+        RequestServiceInterface *cached = cachedProxy_.load(std::memory_order_acquire);
+        if (cached != nullptr) {
+            return sptr<RequestServiceInterface>(cached);
+        }
+    }
     std::lock_guard<std::mutex> lock(serviceProxyMutex_);
     // When SubRuncount/UnSubRuncount/RestoreSubRunCount/Remove need to get proxy but not need to load
     if (!needLoadSA) {
@@ -453,7 +632,7 @@ sptr<RequestServiceInterface> RequestManagerImpl::GetRequestServiceProxy(bool ne
         // Update the proxy to avoid holding an expired object
         auto systemAbility = systemAbilityManager->GetSystemAbility(DOWNLOAD_SERVICE_ID, "");
         if (systemAbility != nullptr) {
-            requestServiceProxy_ = iface_cast<RequestServiceInterface>(systemAbility);
+            PublishServiceProxy(iface_cast<RequestServiceInterface>(systemAbility));
         } else {
             REQUEST_HILOGI("Get SystemAbility failed.");
         }
@@ -477,11 +656,26 @@ sptr<RequestServiceInterface> RequestManagerImpl::GetRequestServiceProxy(bool ne
         SysEventLog::SendSysEventLog(FAULT_EVENT, SAMGR_FAULT_01, "Load SA failed");
         return nullptr;
     }
-    requestServiceProxy_ = iface_cast<RequestServiceInterface>(systemAbility);
+    PublishServiceProxy(iface_cast<RequestServiceInterface>(systemAbility));
 
     return requestServiceProxy_;
 }
 
+// Must be called with serviceProxyMutex_ held.
+void RequestManagerImpl::PublishServiceProxy(const sptr<RequestServiceInterface> &proxy)
+{
+    if (proxy == requestServiceProxy_) {
+        return;
+    }
+    // Lock-free readers may still be taking a reference from the old raw pointer, so it is kept alive.
+    // Proxies only change when the SA dies or reloads, which keeps this list short.
+    if (requestServiceProxy_ != nullptr) {
+        retiredProxies_.push_back(requestServiceProxy_);
+    }
+    requestServiceProxy_ = proxy;
+    cachedProxy_.store(proxy.GetRefPtr(), std::memory_order_release);
+}
+
 bool RequestManagerImpl::SubscribeSA()
 {
     std::lock_guard<std::mutex> lock(saChangeListenerMutex_);
@@ -586,7 +780,7 @@ void RequestManagerImpl::SystemAbilityStatusChangeListener::OnRemoveSystemAbilit
     }
     {
         std::lock_guard<std::mutex> locks(RequestManagerImpl::GetInstance()->serviceProxyMutex_);
-        RequestManagerImpl::GetInstance()->requestServiceProxy_ = nullptr;
+        RequestManagerImpl::GetInstance()->PublishServiceProxy(nullptr);
     }
     FwkRunningTaskCountManager::GetInstance()->SetCount(0);
     FwkRunningTaskCountManager::GetInstance()->SetSaStatus(false);
@@ -603,6 +797,15 @@ void RequestManagerImpl::LoadRequestServer()
     this->GetRequestServiceProxy(true);
 }
 
+int32_t RequestManagerImpl::Prewarm()
+{
+    if (this->GetRequestServiceProxy(true) == nullptr) {
+        REQUEST_HILOGE("Prewarm load SA failed");
+        return E_SERVICE_ERROR;
+    }
+    return this->EnsureChannelOpen();
+}
+
 bool RequestManagerImpl::IsSaReady()
 {
     sptr<ISystemAbilityManager> systemAbilityManager =
@@ -622,9 +825,15 @@ void RequestManagerImpl::ReopenChannel()
         return;
     }
     msgReceiver_->Shutdown();
+    std::atomic_store(&progressTable_, std::shared_ptr<ProgressTable>(nullptr));
     this->EnsureChannelOpen();
 }
 
+void RequestManagerImpl::SetDedicatedReader(bool enable)
+{
+    dedicatedReader_.store(enable);
+}
+
 int32_t RequestManagerImpl::GetNextSeq()
 {
     static std::atomic<int32_t> seq{ 0 };
@@ -22,6 +22,7 @@
 #include <cstdint>
 #include <ctime>
 #include <optional>
+#include <utility>
 
 #include "constant.h"
 #include "download_server_ipc_interface_code.h"
@@ -243,7 +244,8 @@ ExceptionErrorCode RequestServiceProxy::RemoveTasks(
     return ExceptionErrorCode::E_OK;
 }
 
-ExceptionErrorCode RequestServiceProxy::QueryTasks(const std::vector<std::string> &tids, std::vector<TaskInfoRet> &rets)
+ExceptionErrorCode RequestServiceProxy::QueryTasks(
+    const std::vector<std::string> &tids, uint32_t fields, std::vector<TaskInfoRet> &rets)
 {
     TaskInfoRet infoRet{ .code = ExceptionErrorCode::E_OTHER };
     uint32_t len = static_cast<uint32_t>(tids.size());
@@ -256,6 +258,7 @@ ExceptionErrorCode RequestServiceProxy::QueryTasks(const std::vector<std::string
     for (const std::string &tid : tids) {
         data.WriteString(tid);
     }
+    data.WriteUint32(fields);
     int32_t ret = Remote()->SendRequest(static_cast<uint32_t>(RequestInterfaceCode::CMD_QUERY), data, reply, option);
     if (ret != ERR_NONE) {
         REQUEST_HILOGE("End Request QueryTasks, failed: %{public}d", ret);
@@ -274,12 +277,13 @@ ExceptionErrorCode RequestServiceProxy::QueryTasks(const std::vector<std::string
         rets[i].code = static_cast<ExceptionErrorCode>(reply.ReadInt32());
         TaskInfo info;
         ParcelHelper::UnMarshal(reply, info);
-        rets[i].info = info;
+        rets[i].info = std::move(info);
     }
     return ExceptionErrorCode::E_OK;
 }
 
-ExceptionErrorCode RequestServiceProxy::ShowTasks(const std::vector<std::string> &tids, std::vector<TaskInfoRet> &rets)
+ExceptionErrorCode RequestServiceProxy::ShowTasks(
+    const std::vector<std::string> &tids, uint32_t fields, std::vector<TaskInfoRet> &rets)
 {
     TaskInfoRet infoRet{ .code = ExceptionErrorCode::E_OTHER };
     uint32_t len = static_cast<uint32_t>(tids.size());
@@ -292,6 +296,7 @@ ExceptionErrorCode RequestServiceProxy::ShowTasks(const std::vector<std::string>
     for (const std::string &tid : tids) {
         data.WriteString(tid);
     }
+    data.WriteUint32(fields);
     int32_t ret = Remote()->SendRequest(static_cast<uint32_t>(RequestInterfaceCode::CMD_SHOW), data, reply, option);
     if (ret != ERR_NONE) {
         REQUEST_HILOGE("End Request ShowTasks, failed: %{public}d", ret);
@@ -310,7 +315,7 @@ ExceptionErrorCode RequestServiceProxy::ShowTasks(const std::vector<std::string>
         rets[i].code = static_cast<ExceptionErrorCode>(reply.ReadInt32());
         TaskInfo info;
         ParcelHelper::UnMarshal(reply, info);
-        rets[i].info = info;
+        rets[i].info = std::move(info);
     }
     return ExceptionErrorCode::E_OK;
 }
@@ -348,7 +353,7 @@ ExceptionErrorCode RequestServiceProxy::TouchTasks(
         rets[i].code = static_cast<ExceptionErrorCode>(reply.ReadInt32());
         TaskInfo info;
         ParcelHelper::UnMarshal(reply, info);
-        rets[i].info = info;
+        rets[i].info = std::move(info);
     }
     return ExceptionErrorCode::E_OK;
 }
@@ -414,6 +419,30 @@ ExceptionErrorCode RequestServiceProxy::SetMode(const std::string &tid, const Mo
     return code;
 }
 
+ExceptionErrorCode RequestServiceProxy::SetSchedulePolicy(const SchedulePolicy policy)
+{
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option;
+    data.WriteInterfaceToken(GetDescriptor());
+    data.WriteUint32(static_cast<uint32_t>(policy));
+    int32_t ret = Remote()->SendRequest(
+        static_cast<uint32_t>(RequestInterfaceCode::CMD_SET_SCHEDULE_POLICY), data, reply, option);
+    if (ret != ERR_NONE) {
+        REQUEST_HILOGE("End send SetSchedulePolicy request, failed: %{public}d", ret);
+        if (ret != REMOTE_DIED_ERROR) {
+            SysEventLog::SendSysEventLog(FAULT_EVENT, IPC_FAULT_00, std::to_string(ret));
+        }
+        return ExceptionErrorCode::E_SERVICE_ERROR;
+    }
+    ExceptionErrorCode code = static_cast<ExceptionErrorCode>(reply.ReadInt32());
+    if (code != ExceptionErrorCode::E_OK) {
+        REQUEST_HILOGE("End Request SetSchedulePolicy, failed: %{public}d", code);
+        SysEventLog::SendSysEventLog(FAULT_EVENT, IPC_FAULT_01, std::to_string(code));
+    }
+    return code;
+}
+
 ExceptionErrorCode RequestServiceProxy::DisableTaskNotification(
     const std::vector<std::string> &tids, std::vector<ExceptionErrorCode> &rets)
 {
@@ -439,6 +468,51 @@ ExceptionErrorCode RequestServiceProxy::DisableTaskNotification(
     return ExceptionErrorCode::E_OK;
 }
 
+ExceptionErrorCode RequestServiceProxy::SubscribeTasks(
+    const std::vector<std::string> &tids, bool openChannel, int32_t &sockFd, std::vector<TaskInfoRet> &rets)
+{
+    TaskInfoRet infoRet{ .code = ExceptionErrorCode::E_OTHER };
+    uint32_t len = static_cast<uint32_t>(tids.size());
+    rets.resize(len, infoRet);
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option;
+    data.WriteInterfaceToken(GetDescriptor());
+    data.WriteBool(openChannel);
+    data.WriteUint32(len);
+    for (const std::string &tid : tids) {
+        data.WriteString(tid);
+    }
+    // Only the state and progress are needed to catch up, none of the optional parts.
+    data.WriteUint32(0);
+    int32_t ret = Remote()->SendRequest(
+        static_cast<uint32_t>(RequestInterfaceCode::CMD_SUBSCRIBE_TASKS), data, reply, option);
+    if (ret != ERR_NONE) {
+        REQUEST_HILOGE("End Request SubscribeTasks, failed: %{public}d", ret);
+        if (ret != REMOTE_DIED_ERROR) {
+            SysEventLog::SendSysEventLog(FAULT_EVENT, IPC_FAULT_00, std::to_string(ret));
+        }
+        return ExceptionErrorCode::E_SERVICE_ERROR;
+    }
+    ExceptionErrorCode code = static_cast<ExceptionErrorCode>(reply.ReadInt32());
+    if (code != ExceptionErrorCode::E_OK) {
+        REQUEST_HILOGE("End Request SubscribeTasks, failed: %{public}d", code);
+        SysEventLog::SendSysEventLog(FAULT_EVENT, IPC_FAULT_01, std::to_string(code));
+        return code;
+    }
+    if (openChannel) {
+        sockFd = reply.ReadFileDescriptor();
+    }
+    for (uint32_t i = 0; i < len; i++) {
+        rets[i].code = static_cast<ExceptionErrorCode>(reply.ReadInt32());
+        TaskInfo info;
+        ParcelHelper::UnMarshal(reply, info);
+        rets[i].info = std::move(info);
+    }
+    REQUEST_HILOGD("End Request SubscribeTasks ok, size: %{public}u", len);
+    return ExceptionErrorCode::E_OK;
+}
+
 void SerializeNotification(MessageParcel &data, const Notification &notification)
 {
     if (notification.title != std::nullopt) {
@@ -504,6 +578,17 @@ void RequestServiceProxy::WriteConfigData(const Config &config, MessageParcel &d
     data.WriteInt64(config.minSpeed.duration);
     data.WriteUint64(config.timeout.connectionTimeout);
     data.WriteUint64(config.timeout.totalTimeout);
+    data.WriteInt64(config.stallDetection.window);
+    data.WriteInt64(config.stallDetection.ratio);
+    data.WriteUint32(config.concurrency);
+    data.WriteUint64(config.chunkSize);
+    data.WriteUint64(config.deadline);
+    data.WriteBool(config.coalesce);
+    data.WriteBool(config.compression);
+    data.WriteUint32(config.memoryLimit);
+    data.WriteBool(config.prefetch);
+    data.WriteBool(config.bypassCache);
+    data.WriteUint64(config.traceId);
     data.WriteString(config.url);
     data.WriteString(config.title);
     data.WriteString(config.method);
@@ -512,8 +597,25 @@ void RequestServiceProxy::WriteConfigData(const Config &config, MessageParcel &d
     data.WriteString(config.data);
     data.WriteString(config.proxy);
     data.WriteString(config.certificatePins);
+    data.WriteString(config.checksum);
     GetVectorData(config, data);
     SerializeNotification(data, config.notification);
+    data.WriteBool(config.cachedBodyFd >= 0);
+    if (config.cachedBodyFd >= 0) {
+        data.WriteFileDescriptor(config.cachedBodyFd);
+    }
+    // Files of the sandbox already opened, the service uses them instead of their paths.
+    std::vector<uint32_t> openedFiles;
+    for (uint32_t i = 0; i < config.files.size(); i++) {
+        if (!config.files[i].isUserFile && config.files[i].fd >= 0) {
+            openedFiles.push_back(i);
+        }
+    }
+    data.WriteUint32(openedFiles.size());
+    for (uint32_t index : openedFiles) {
+        data.WriteUint32(index);
+        data.WriteFileDescriptor(config.files[index].fd);
+    }
 }
 
 void RequestServiceProxy::GetVectorData(const Config &config, MessageParcel &data)
@@ -619,7 +721,7 @@ int32_t RequestServiceProxy::Query(const std::string &tid, TaskInfo &info)
     TaskInfoRet infoRet{ .code = ExceptionErrorCode::E_OTHER };
     std::vector<TaskInfoRet> rets = { infoRet };
 
-    int32_t ret = RequestServiceProxy::QueryTasks(tids, rets);
+    int32_t ret = RequestServiceProxy::QueryTasks(tids, TASK_INFO_ALL, rets);
     if (ret != ExceptionErrorCode::E_OK) {
         REQUEST_HILOGE("End Request Query err, tid: %{public}s, failed: %{public}d", tid.c_str(), ret);
         return ret;
@@ -658,7 +760,7 @@ int32_t RequestServiceProxy::Touch(const std::string &tid, const std::string &to
     return E_OK;
 }
 
-int32_t RequestServiceProxy::Search(const Filter &filter, std::vector<std::string> &tids)
+int32_t RequestServiceProxy::Search(const Filter &filter, std::vector<std::string> &tids, std::string &next)
 {
     REQUEST_HILOGD("Request Search");
     MessageParcel data;
@@ -671,6 +773,9 @@ int32_t RequestServiceProxy::Search(const Filter &filter, std::vector<std::strin
     data.WriteUint32(static_cast<uint32_t>(filter.state));
     data.WriteUint32(static_cast<uint32_t>(filter.action));
     data.WriteUint32(static_cast<uint32_t>(filter.mode));
+    data.WriteUint32(filter.limit);
+    data.WriteString(filter.cursor);
+    data.WriteString(filter.keyword);
     int32_t ret = Remote()->SendRequest(static_cast<uint32_t>(RequestInterfaceCode::CMD_SEARCH), data, reply, option);
     if (ret != ERR_NONE) {
         REQUEST_HILOGE("End Request Search, failed: %{public}d", ret);
@@ -683,6 +788,7 @@ int32_t RequestServiceProxy::Search(const Filter &filter, std::vector<std::strin
     for (uint32_t i = 0; i < size; i++) {
         tids.push_back(reply.ReadString());
     }
+    next = reply.ReadString();
     REQUEST_HILOGD("End Request Search ok");
     return E_OK;
 }
@@ -694,7 +800,7 @@ int32_t RequestServiceProxy::Show(const std::string &tid, TaskInfo &info)
     TaskInfoRet infoRet{ .code = ExceptionErrorCode::E_OTHER };
     std::vector<TaskInfoRet> rets = { infoRet };
 
-    int32_t ret = RequestServiceProxy::ShowTasks(tids, rets);
+    int32_t ret = RequestServiceProxy::ShowTasks(tids, TASK_INFO_ALL, rets);
     if (ret != ExceptionErrorCode::E_OK) {
         REQUEST_HILOGE("End Request Show err, tid: %{public}s, failed: %{public}d", tid.c_str(), ret);
         return ret;
@@ -829,6 +935,117 @@ int32_t RequestServiceProxy::OpenChannel(int32_t &sockFd)
     return E_OK;
 }
 
+int32_t RequestServiceProxy::OpenProgressTable(int32_t &fd)
+{
+    REQUEST_HILOGD("Request OpenProgressTable");
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option;
+    data.WriteInterfaceToken(GetDescriptor());
+    int32_t ret = Remote()->SendRequest(
+        static_cast<uint32_t>(RequestInterfaceCode::CMD_OPEN_PROGRESS_TABLE), data, reply, option);
+    if (ret != ERR_NONE) {
+        REQUEST_HILOGE("End Request OpenProgressTable, failed: %{public}d", ret);
+        if (ret != REMOTE_DIED_ERROR) {
+            SysEventLog::SendSysEventLog(FAULT_EVENT, IPC_FAULT_00, std::to_string(ret));
+        }
+        return E_SERVICE_ERROR;
+    }
+    int32_t errCode = reply.ReadInt32();
+    if (errCode != E_OK) {
+        REQUEST_HILOGE("End Request OpenProgressTable, failed: %{public}d", errCode);
+        return errCode;
+    }
+    fd = reply.ReadFileDescriptor();
+    REQUEST_HILOGD("End Request OpenProgressTable ok, fd: %{public}d", fd);
+    return E_OK;
+}
+
+int32_t RequestServiceProxy::GetStats(std::map<std::string, uint64_t> &stats)
+{
+    REQUEST_HILOGD("Request GetStats");
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option;
+    data.WriteInterfaceToken(GetDescriptor());
+    int32_t ret =
+        Remote()->SendRequest(static_cast<uint32_t>(RequestInterfaceCode::CMD_GET_STATS), data, reply, option);
+    if (ret != ERR_NONE) {
+        REQUEST_HILOGE("End Request GetStats, failed: %{public}d", ret);
+        if (ret != REMOTE_DIED_ERROR) {
+            SysEventLog::SendSysEventLog(FAULT_EVENT, IPC_FAULT_00, std::to_string(ret));
+        }
+        return E_SERVICE_ERROR;
+    }
+    int32_t errCode = reply.ReadInt32();
+    if (errCode != E_OK) {
+        REQUEST_HILOGE("End Request GetStats, failed: %{public}d", errCode);
+        return errCode;
+    }
+    uint32_t size = reply.ReadUint32();
+    stats.clear();
+    for (uint32_t i = 0; i < size; i++) {
+        std::string name = reply.ReadString();
+        stats[name] = reply.ReadUint64();
+    }
+    REQUEST_HILOGD("End Request GetStats ok, size: %{public}u", size);
+    return E_OK;
+}
+
+int32_t RequestServiceProxy::OpenSharedCache(const std::string &url, int32_t &fd)
+{
+    REQUEST_HILOGD("Request OpenSharedCache");
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option;
+    data.WriteInterfaceToken(GetDescriptor());
+    data.WriteString(url);
+    int32_t ret = Remote()->SendRequest(
+        static_cast<uint32_t>(RequestInterfaceCode::CMD_OPEN_SHARED_CACHE), data, reply, option);
+    if (ret != ERR_NONE) {
+        REQUEST_HILOGE("End Request OpenSharedCache, failed: %{public}d", ret);
+        if (ret != REMOTE_DIED_ERROR) {
+            SysEventLog::SendSysEventLog(FAULT_EVENT, IPC_FAULT_00, std::to_string(ret));
+        }
+        return E_SERVICE_ERROR;
+    }
+    int32_t errCode = reply.ReadInt32();
+    if (errCode != E_OK) {
+        REQUEST_HILOGD("End Request OpenSharedCache, miss: %{public}d", errCode);
+        return errCode;
+    }
+    fd = reply.ReadFileDescriptor();
+    REQUEST_HILOGD("End Request OpenSharedCache ok, fd: %{public}d", fd);
+    return E_OK;
+}
+
+int32_t RequestServiceProxy::PublishSharedCache(const std::string &url, int32_t fd)
+{
+    REQUEST_HILOGD("Request PublishSharedCache");
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option;
+    data.WriteInterfaceToken(GetDescriptor());
+    data.WriteString(url);
+    data.WriteFileDescriptor(fd);
+    int32_t ret = Remote()->SendRequest(
+        static_cast<uint32_t>(RequestInterfaceCode::CMD_PUBLISH_SHARED_CACHE), data, reply, option);
+    if (ret != ERR_NONE) {
+        REQUEST_HILOGE("End Request PublishSharedCache, failed: %{public}d", ret);
+        if (ret != REMOTE_DIED_ERROR) {
+            SysEventLog::SendSysEventLog(FAULT_EVENT, IPC_FAULT_00, std::to_string(ret));
+        }
+        return E_SERVICE_ERROR;
+    }
+    int32_t errCode = reply.ReadInt32();
+    if (errCode != E_OK) {
+        REQUEST_HILOGE("End Request PublishSharedCache, failed: %{public}d", errCode);
+        return errCode;
+    }
+    REQUEST_HILOGD("End Request PublishSharedCache ok");
+    return E_OK;
+}
+
 int32_t RequestServiceProxy::Subscribe(const std::string &tid)
 {
     REQUEST_HILOGD("Request Subscribe, tid: %{public}s", tid.c_str());
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "request_task_registry.h"
+
+#include <charconv>
+#include <mutex>
+
+namespace OHOS::Request {
+
+bool TaskRegistry::ParseTaskId(const std::string &taskId, uint32_t &id)
+{
+    const char *end = taskId.data() + taskId.size();
+    auto [ptr, ec] = std::from_chars(taskId.data(), end, id);
+    return ec == std::errc() && ptr == end && !taskId.empty();
+}
+
+TaskRegistry::Shard &TaskRegistry::ShardOf(uint32_t id)
+{
+    return shards_[id % SHARD_COUNT];
+}
+
+std::shared_ptr<Request> TaskRegistry::Get(uint32_t id)
+{
+    Shard &shard = ShardOf(id);
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.tasks.find(id);
+    if (it == shard.tasks.end()) {
+        return nullptr;
+    }
+    return it->second;
+}
+
+std::shared_ptr<Request> TaskRegistry::GetOrCreate(uint32_t id)
+{
+    std::shared_ptr<Request> task = Get(id);
+    if (task != nullptr) {
+        return task;
+    }
+    Shard &shard = ShardOf(id);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    auto retPair = shard.tasks.emplace(id, nullptr);
+    if (retPair.second) {
+        retPair.first->second = std::make_shared<Request>(std::to_string(id));
+    }
+    return retPair.first->second;
+}
+
+void TaskRegistry::Erase(uint32_t id)
+{
+    Shard &shard = ShardOf(id);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    shard.tasks.erase(id);
+}
+
+} // namespace OHOS::Request
@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "request_trace.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
+#include <cstdio>
+#include <mutex>
+#include <unordered_map>
+
+#include "hitrace_meter.h"
+#include "request_task_registry.h"
+
+namespace OHOS::Request {
+namespace {
+std::mutex g_tracesMutex;
+std::unordered_map<uint32_t, uint64_t> g_traces;
+} // namespace
+
+uint64_t RequestTrace::NewId()
+{
+    // The pid keeps the ids of the processes apart, the pid is never 0.
+    static std::atomic<uint32_t> count{ 0 };
+    return (static_cast<uint64_t>(getpid()) << 32) | count.fetch_add(1, std::memory_order_relaxed);
+}
+
+void RequestTrace::Bind(const std::string &tid, uint64_t traceId)
+{
+    uint32_t taskId = 0;
+    if (traceId == 0 || !TaskRegistry::ParseTaskId(tid, taskId)) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(g_tracesMutex);
+    g_traces[taskId] = traceId;
+}
+
+void RequestTrace::Unbind(uint32_t taskId)
+{
+    std::lock_guard<std::mutex> lock(g_tracesMutex);
+    g_traces.erase(taskId);
+}
+
+uint64_t RequestTrace::Of(uint32_t taskId)
+{
+    std::lock_guard<std::mutex> lock(g_tracesMutex);
+    auto it = g_traces.find(taskId);
+    return it == g_traces.end() ? 0 : it->second;
+}
+
+TraceSpan::TraceSpan(uint64_t traceId, const char *stage)
+{
+    if (traceId == 0) {
+        return;
+    }
+    // Named like the spans of the service.
+    char name[64];
+    int len = snprintf(name, sizeof(name), "request:%" PRIx64 " %s", traceId, stage);
+    if (len <= 0) {
+        return;
+    }
+    name_.assign(name, std::min(static_cast<size_t>(len), sizeof(name) - 1));
+    id_ = static_cast<int32_t>(traceId);
+    StartAsyncTrace(HITRACE_TAG_MISC, name_, id_);
+}
+
+TraceSpan::~TraceSpan()
+{
+    if (!name_.empty()) {
+        FinishAsyncTrace(HITRACE_TAG_MISC, name_, id_);
+    }
+}
+
+} // namespace OHOS::Request
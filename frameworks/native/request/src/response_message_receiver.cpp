@@ -17,14 +17,16 @@
 
 #include <unistd.h>
 
+#include <cinttypes>
 #include <cstdint>
 #include <cstdlib>
-#include <sstream>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "log.h"
 #include "request_common.h"
+#include "request_trace.h"
 #include "sys_event.h"
 
 namespace OHOS::Request {
@@ -32,9 +34,11 @@ namespace OHOS::Request {
 static constexpr int32_t INT64_SIZE = 8;
 static constexpr int32_t INT32_SIZE = 4;
 static constexpr int32_t INT16_SIZE = 2;
-// static constexpr int32_t INT8_SIZE = 1;
-
-std::shared_ptr<OHOS::AppExecFwk::EventHandler> serviceHandler_;
+static constexpr int32_t INT8_SIZE = 1;
+static constexpr int32_t VARINT_MAX_SHIFT = 63;
+static constexpr uint8_t VARINT_MORE = 0x80;
+static constexpr uint8_t VARINT_MASK = 0x7F;
+static constexpr int32_t VARINT_BITS = 7;
 
 int32_t ResponseMessageReceiver::Int64FromParcel(int64_t &num, char *&parcel, int32_t &size)
 {
@@ -165,25 +169,49 @@ int32_t ResponseMessageReceiver::StringFromParcel(std::string &str, char *&parce
     }
 }
 
-int32_t ResponseMessageReceiver::ResponseHeaderFromParcel(
-    std::map<std::string, std::vector<std::string>> &headers, char *&parcel, int32_t &size)
+int32_t ResponseMessageReceiver::ResponseHeaderFromParcel(std::string &rawHeaders, char *&parcel, int32_t &size)
 {
-    std::string s(parcel, size);
-    std::stringstream ss(s);
-    std::string line;
-    while (std::getline(ss, line, '\n')) {
-        std::stringstream keyValue(line);
-        std::string key;
-        std::string valueLine;
-        std::getline(keyValue, key, ':');
-        std::getline(keyValue, valueLine);
-        std::stringstream values(valueLine);
-        std::string value;
-        while (getline(values, value, ',')) {
-            headers[key].push_back(value);
+    // Headers are the rest of the message, they are only tokenized if a listener asks for them.
+    rawHeaders.assign(parcel, size);
+    return 0;
+}
+
+void ResponseMessageReceiver::ParseResponseHeaders(
+    std::string_view raw, std::map<std::string, std::vector<std::string>> &headers)
+{
+    while (!raw.empty()) {
+        size_t lineEnd = raw.find('\n');
+        std::string_view line = raw.substr(0, lineEnd);
+        raw.remove_prefix(lineEnd == std::string_view::npos ? raw.size() : lineEnd + 1);
+
+        size_t colon = line.find(':');
+        if (colon == std::string_view::npos) {
+            continue;
+        }
+        std::string_view key = line.substr(0, colon);
+        std::string_view values = line.substr(colon + 1);
+        std::vector<std::string> *entry = nullptr;
+        while (!values.empty()) {
+            size_t comma = values.find(',');
+            if (entry == nullptr) {
+                entry = &headers[std::string(key)];
+            }
+            entry->emplace_back(values.substr(0, comma));
+            if (comma == std::string_view::npos) {
+                break;
+            }
+            values.remove_prefix(comma + 1);
         }
     }
-    return 0;
+}
+
+const std::map<std::string, std::vector<std::string>> &Response::GetHeaders() const
+{
+    if (!headers_.has_value()) {
+        headers_.emplace();
+        ResponseMessageReceiver::ParseResponseHeaders(rawHeaders, *headers_);
+    }
+    return *headers_;
 }
 
 int32_t ResponseMessageReceiver::ProgressExtrasFromParcel(
@@ -226,8 +254,9 @@ int32_t ResponseMessageReceiver::VecInt64FromParcel(std::vector<int64_t> &vec, c
     return 0;
 }
 
-ResponseMessageReceiver::ResponseMessageReceiver(IResponseMessageHandler *handler, int32_t sockFd)
-    : handler_(handler), sockFd_(sockFd)
+ResponseMessageReceiver::ResponseMessageReceiver(
+    IResponseMessageHandler *handler, int32_t sockFd, bool dedicatedReader)
+    : handler_(handler), sockFd_(sockFd), dedicatedReader_(dedicatedReader)
 {
 }
 
@@ -237,15 +266,43 @@ void ResponseMessageReceiver::BeginReceive()
     if (!runner) {
         SysEventLog::SendSysEventLog(FAULT_EVENT, ABMS_FAULT_10, "GetMainEventRunner failed");
     }
-    serviceHandler_ = std::make_shared<OHOS::AppExecFwk::EventHandler>(runner);
+    mainHandler_ = std::make_shared<OHOS::AppExecFwk::EventHandler>(runner);
+    fdHandler_ = mainHandler_;
+    if (dedicatedReader_) {
+        readerRunner_ = OHOS::AppExecFwk::EventRunner::Create("RequestUdsReader");
+        if (readerRunner_) {
+            fdHandler_ = std::make_shared<OHOS::AppExecFwk::EventHandler>(readerRunner_);
+        } else {
+            REQUEST_HILOGE("create uds reader runner failed, fall back to main runner");
+            dedicatedReader_ = false;
+        }
+    }
     {
         std::lock_guard<std::mutex> lock(sockFdMutex_);
-        auto err = serviceHandler_->AddFileDescriptorListener(
+        auto err = fdHandler_->AddFileDescriptorListener(
             sockFd_, OHOS::AppExecFwk::FILE_DESCRIPTOR_INPUT_EVENT, shared_from_this(), "subscribe");
         if (err != ERR_OK) {
             REQUEST_HILOGE("handler addlisterner err: %{public}d", err);
             SysEventLog::SendSysEventLog(FAULT_EVENT, ABMS_FAULT_11, "handler addlisterner err");
         }
+        // The first grant switches the service from per-message acks to credits.
+        SendCredits(CREDIT_WINDOW, CAPABILITY_NOTIFY_DATA_V2 | CAPABILITY_RUN_COUNT);
+    }
+}
+
+// Must be called with sockFdMutex_ held.
+void ResponseMessageReceiver::SendCredits(uint32_t credits, uint32_t capabilities)
+{
+    if (sockFd_ < 0) {
+        return;
+    }
+    // Capabilities are only announced once, in the first grant.
+    uint32_t grant[3] = { CREDIT_MAGIC_NUM, credits, capabilities };
+    size_t grantSize = capabilities == 0 ? sizeof(uint32_t) * 2 : sizeof(grant);
+    int32_t ret = write(sockFd_, grant, grantSize);
+    if (ret <= 0) {
+        REQUEST_HILOGE("send credits failed: %{public}d, %{public}d", ret, errno);
+        SysEventLog::SendSysEventLog(FAULT_EVENT, UDS_FAULT_02, "write" + std::to_string(ret));
     }
 }
 
@@ -318,7 +375,7 @@ int32_t ResponseMessageReceiver::ResponseFromParcel(std::shared_ptr<Response> &r
         return -1;
     }
 
-    ResponseHeaderFromParcel(response->headers, parcel, size);
+    ResponseHeaderFromParcel(response->rawHeaders, parcel, size);
     return 0;
 }
 
@@ -383,6 +440,14 @@ int32_t ResponseMessageReceiver::NotifyDataFromParcel(
         REQUEST_HILOGE("Bad extras");
         return -1;
     }
+    if (Uint64FromParcel(notifyData->progress.speed, parcel, size) != 0) {
+        REQUEST_HILOGE("Bad speed");
+        return -1;
+    }
+    if (Int64FromParcel(notifyData->progress.eta, parcel, size) != 0) {
+        REQUEST_HILOGE("Bad eta");
+        return -1;
+    }
 
     if (ActionFromParcel(notifyData->action, parcel, size) != 0) {
         REQUEST_HILOGE("Bad action");
@@ -399,6 +464,207 @@ int32_t ResponseMessageReceiver::NotifyDataFromParcel(
     return 0;
 }
 
+int32_t ResponseMessageReceiver::VarintFromParcel(uint64_t &num, char *&parcel, int32_t &size)
+{
+    num = 0;
+    for (int32_t shift = 0; shift <= VARINT_MAX_SHIFT; shift += VARINT_BITS) {
+        if (size < INT8_SIZE) {
+            REQUEST_HILOGE("message not complete");
+            return -1;
+        }
+        uint8_t byte = static_cast<uint8_t>(*parcel);
+        parcel += INT8_SIZE;
+        size -= INT8_SIZE;
+        num |= static_cast<uint64_t>(byte & VARINT_MASK) << shift;
+        if ((byte & VARINT_MORE) == 0) {
+            return 0;
+        }
+    }
+    REQUEST_HILOGE("varint too long");
+    return -1;
+}
+
+int32_t ResponseMessageReceiver::SignedVarintFromParcel(int64_t &num, char *&parcel, int32_t &size)
+{
+    uint64_t zigzag = 0;
+    if (VarintFromParcel(zigzag, parcel, size) != 0) {
+        return -1;
+    }
+    num = static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1);
+    return 0;
+}
+
+int32_t ResponseMessageReceiver::BytesFromParcel(std::string &str, char *&parcel, int32_t &size)
+{
+    uint64_t length = 0;
+    if (VarintFromParcel(length, parcel, size) != 0) {
+        return -1;
+    }
+    if (length > static_cast<uint64_t>(size)) {
+        REQUEST_HILOGE("message not complete");
+        return -1;
+    }
+    str.assign(parcel, length);
+    parcel += length;
+    size -= static_cast<int32_t>(length);
+    return 0;
+}
+
+int32_t ResponseMessageReceiver::NotifyExtrasV2FromParcel(
+    std::map<std::string, std::string> &extras, char *&parcel, int32_t &size)
+{
+    uint64_t length = 0;
+    if (VarintFromParcel(length, parcel, size) != 0) {
+        return -1;
+    }
+    for (uint64_t i = 0; i < length; ++i) {
+        // 0 introduces a new key, otherwise the key is notifyKeys_[ref - 1].
+        uint64_t ref = 0;
+        if (VarintFromParcel(ref, parcel, size) != 0) {
+            return -1;
+        }
+        std::string key;
+        if (ref == 0) {
+            if (BytesFromParcel(key, parcel, size) != 0) {
+                return -1;
+            }
+            notifyKeys_.push_back(key);
+        } else if (ref <= notifyKeys_.size()) {
+            key = notifyKeys_[ref - 1];
+        } else {
+            REQUEST_HILOGE("Bad extras key ref %{public}" PRIu64, ref);
+            return -1;
+        }
+        if (BytesFromParcel(extras[key], parcel, size) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int32_t ResponseMessageReceiver::NotifyDataV2FromParcel(
+    std::shared_ptr<NotifyData> &notifyData, char *&parcel, int32_t &size)
+{
+    if (size < INT8_SIZE) {
+        REQUEST_HILOGE("Bad flags");
+        return -1;
+    }
+    uint8_t flags = static_cast<uint8_t>(*parcel);
+    parcel += INT8_SIZE;
+    size -= INT8_SIZE;
+    if ((flags & NOTIFY_V2_FLAG_RESET) != 0) {
+        notifyKeys_.clear();
+        notifyTasks_.clear();
+    }
+
+    uint64_t value = 0;
+    if (VarintFromParcel(value, parcel, size) != 0 || value > static_cast<uint64_t>(SubscribeType::BUTT)) {
+        REQUEST_HILOGE("Bad type");
+        return -1;
+    }
+    notifyData->type = static_cast<SubscribeType>(value);
+    if (VarintFromParcel(value, parcel, size) != 0) {
+        REQUEST_HILOGE("Bad tid");
+        return -1;
+    }
+    notifyData->taskId = static_cast<uint32_t>(value);
+    if (VarintFromParcel(value, parcel, size) != 0 || value > static_cast<uint64_t>(State::ANY)) {
+        REQUEST_HILOGE("Bad state");
+        return -1;
+    }
+    notifyData->progress.state = static_cast<State>(value);
+    if (VarintFromParcel(value, parcel, size) != 0) {
+        REQUEST_HILOGE("Bad index");
+        return -1;
+    }
+    notifyData->progress.index = static_cast<uint32_t>(value);
+
+    NotifyTaskState &task = notifyTasks_[notifyData->taskId];
+    if ((flags & NOTIFY_V2_FLAG_ABSOLUTE) != 0) {
+        task.processed = 0;
+        task.totalProcessed = 0;
+    }
+    int64_t delta = 0;
+    if (SignedVarintFromParcel(delta, parcel, size) != 0) {
+        REQUEST_HILOGE("Bad processed");
+        return -1;
+    }
+    task.processed += static_cast<uint64_t>(delta);
+    if (SignedVarintFromParcel(delta, parcel, size) != 0) {
+        REQUEST_HILOGE("Bad totalProcessed");
+        return -1;
+    }
+    task.totalProcessed += static_cast<uint64_t>(delta);
+    notifyData->progress.processed = task.processed;
+    notifyData->progress.totalProcessed = task.totalProcessed;
+
+    if ((flags & NOTIFY_V2_FLAG_SIZES) != 0) {
+        uint64_t length = 0;
+        if (VarintFromParcel(length, parcel, size) != 0 || length > static_cast<uint64_t>(size)) {
+            REQUEST_HILOGE("Bad sizes");
+            return -1;
+        }
+        task.sizes.clear();
+        for (uint64_t i = 0; i < length; ++i) {
+            int64_t fileSize = 0;
+            if (SignedVarintFromParcel(fileSize, parcel, size) != 0) {
+                REQUEST_HILOGE("Bad sizes");
+                return -1;
+            }
+            task.sizes.push_back(fileSize);
+        }
+    }
+    notifyData->progress.sizes = task.sizes;
+
+    if (NotifyExtrasV2FromParcel(notifyData->progress.extras, parcel, size) != 0) {
+        REQUEST_HILOGE("Bad extras");
+        return -1;
+    }
+    if (VarintFromParcel(notifyData->progress.speed, parcel, size) != 0) {
+        REQUEST_HILOGE("Bad speed");
+        return -1;
+    }
+    if (SignedVarintFromParcel(notifyData->progress.eta, parcel, size) != 0) {
+        REQUEST_HILOGE("Bad eta");
+        return -1;
+    }
+    if (VarintFromParcel(value, parcel, size) != 0 || value > static_cast<uint64_t>(Action::ANY)) {
+        REQUEST_HILOGE("Bad action");
+        return -1;
+    }
+    notifyData->action = static_cast<Action>(value);
+    if (VarintFromParcel(value, parcel, size) != 0 || value > static_cast<uint64_t>(Version::API10)) {
+        REQUEST_HILOGE("Bad version");
+        return -1;
+    }
+    notifyData->version = static_cast<Version>(value);
+
+    uint64_t length = 0;
+    if (VarintFromParcel(length, parcel, size) != 0) {
+        REQUEST_HILOGE("Bad taskStates");
+        return -1;
+    }
+    for (uint64_t i = 0; i < length; ++i) {
+        TaskState taskState;
+        if (BytesFromParcel(taskState.path, parcel, size) != 0 || VarintFromParcel(value, parcel, size) != 0) {
+            REQUEST_HILOGE("Bad taskStates");
+            return -1;
+        }
+        taskState.responseCode = static_cast<uint32_t>(value);
+        if (BytesFromParcel(taskState.message, parcel, size) != 0) {
+            REQUEST_HILOGE("Bad taskStates");
+            return -1;
+        }
+        notifyData->taskStates.push_back(taskState);
+    }
+
+    if (notifyData->type == SubscribeType::COMPLETED || notifyData->type == SubscribeType::FAILED
+        || notifyData->type == SubscribeType::REMOVE) {
+        notifyTasks_.erase(notifyData->taskId);
+    }
+    return 0;
+}
+
 bool ResponseMessageReceiver::ReadUdsData(char *buffer, int32_t readSize, int32_t &length)
 {
     std::lock_guard<std::mutex> lock(sockFdMutex_);
@@ -413,12 +679,11 @@ bool ResponseMessageReceiver::ReadUdsData(char *buffer, int32_t readSize, int32_
     }
     REQUEST_HILOGD("read message: %{public}d", length);
 
-    char lenBuf[4];
-    *reinterpret_cast<uint32_t *>(lenBuf) = length;
-    int32_t ret = write(sockFd_, lenBuf, 4);
-    if (ret <= 0) {
-        REQUEST_HILOGE("send length back failed: %{public}d, %{public}d", ret, errno);
-        SysEventLog::SendSysEventLog(FAULT_EVENT, UDS_FAULT_02, "write" + std::to_string(ret));
+    // Return credits in chunks of half a window so the service never runs dry.
+    ++consumedCredits_;
+    if (consumedCredits_ >= CREDIT_WINDOW / 2) {
+        SendCredits(consumedCredits_);
+        consumedCredits_ = 0;
     }
     return true;
 }
@@ -446,16 +711,107 @@ void ResponseMessageReceiver::OnReadable(int32_t fd)
     if (headerSize != static_cast<int16_t>(length)) {
         REQUEST_HILOGE("Bad headerSize, %{public}d, %{public}d", length, headerSize);
     }
+
+    // A batch carries the id of its first record, which is checked again when the record is parsed.
+    if (msgType == MessageType::BATCH) {
+        HandBatchData(leftBuf, leftLen);
+        return;
+    }
     ++messageId_;
+    HandMessage(msgType, leftBuf, leftLen);
+    FlushDeliveries();
+}
+
+void ResponseMessageReceiver::Deliver(std::function<void()> callback)
+{
+    if (!dedicatedReader_) {
+        callback();
+        return;
+    }
+    std::lock_guard<std::mutex> lock(deliveriesMutex_);
+    deliveries_.push_back(std::move(callback));
+}
+
+// Posts at most one task to the main thread at a time, callbacks decoded meanwhile join its batch.
+void ResponseMessageReceiver::FlushDeliveries()
+{
+    if (!dedicatedReader_) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(deliveriesMutex_);
+        if (deliveries_.empty() || deliveriesPosted_) {
+            return;
+        }
+        deliveriesPosted_ = true;
+    }
+    std::shared_ptr<ResponseMessageReceiver> self = shared_from_this();
+    if (!mainHandler_->PostTask([self]() { self->RunDeliveries(); }, "RequestUdsDeliver")) {
+        REQUEST_HILOGE("post uds deliveries failed");
+        RunDeliveries();
+    }
+}
+
+void ResponseMessageReceiver::RunDeliveries()
+{
+    std::vector<std::function<void()>> deliveries;
+    {
+        std::lock_guard<std::mutex> lock(deliveriesMutex_);
+        deliveries.swap(deliveries_);
+        deliveriesPosted_ = false;
+    }
+    for (auto &callback : deliveries) {
+        callback();
+    }
+}
 
+void ResponseMessageReceiver::HandMessage(int16_t msgType, char *&leftBuf, int32_t &leftLen)
+{
     if (msgType == MessageType::HTTP_RESPONSE) {
         HandResponseData(leftBuf, leftLen);
     } else if (msgType == MessageType::NOTIFY_DATA) {
         HandNotifyData(leftBuf, leftLen);
+    } else if (msgType == MessageType::NOTIFY_DATA_V2) {
+        HandNotifyDataV2(leftBuf, leftLen);
     } else if (msgType == MessageType::FAULTS) {
         HandFaultsData(leftBuf, leftLen);
     } else if (msgType == MessageType::WAIT) {
         HandWaitData(leftBuf, leftLen);
+    } else if (msgType == MessageType::RUN_COUNT) {
+        HandRunCountData(leftBuf, leftLen);
+    } else if (msgType == MessageType::BODY) {
+        HandBodyData(leftBuf, leftLen);
+    }
+}
+
+void ResponseMessageReceiver::HandBatchData(char *&leftBuf, int32_t &leftLen)
+{
+    while (leftLen > 0) {
+        int32_t msgId = -1;
+        int16_t msgType = -1;
+        int16_t recordSize = -1;
+        if (MsgHeaderParcel(msgId, msgType, recordSize, leftBuf, leftLen) != 0) {
+            REQUEST_HILOGE("Bad batch record header");
+            SysEventLog::SendSysEventLog(FAULT_EVENT, UDS_FAULT_01, "Bad batch record header");
+            return;
+        }
+        int32_t bodyLen = static_cast<int32_t>(static_cast<uint16_t>(recordSize)) - MSG_HEADER_SIZE;
+        if (bodyLen < 0 || bodyLen > leftLen || msgType == MessageType::BATCH) {
+            REQUEST_HILOGE("Bad batch record, %{public}d, %{public}d", recordSize, leftLen);
+            SysEventLog::SendSysEventLog(FAULT_EVENT, UDS_FAULT_01, "Bad batch record");
+            return;
+        }
+        if (msgId != messageId_) {
+            REQUEST_HILOGE("Bad messageId, expect %{public}d = %{public}d", msgId, messageId_);
+        }
+        ++messageId_;
+
+        // Each record is parsed within its own bounds, whatever its parser consumes.
+        char *recordBuf = leftBuf;
+        int32_t recordLen = bodyLen;
+        HandMessage(msgType, recordBuf, recordLen);
+        leftBuf += bodyLen;
+        leftLen -= bodyLen;
     }
 }
 
@@ -463,7 +819,7 @@ void ResponseMessageReceiver::HandResponseData(char *&leftBuf, int32_t &leftLen)
 {
     std::shared_ptr<Response> response = std::make_shared<Response>();
     if (ResponseFromParcel(response, leftBuf, leftLen) == 0) {
-        this->handler_->OnResponseReceive(response);
+        Deliver([this, response]() { this->handler_->OnResponseReceive(response); });
     } else {
         REQUEST_HILOGE("Bad Response");
         SysEventLog::SendSysEventLog(FAULT_EVENT, UDS_FAULT_01, "Bad Response");
@@ -474,20 +830,48 @@ void ResponseMessageReceiver::HandNotifyData(char *&leftBuf, int32_t &leftLen)
 {
     std::shared_ptr<NotifyData> notifyData = std::make_shared<NotifyData>();
     if (NotifyDataFromParcel(notifyData, leftBuf, leftLen) == 0) {
-        this->handler_->OnNotifyDataReceive(notifyData);
+        AttachBody(notifyData);
+        DeliverNotifyData(notifyData);
     } else {
         REQUEST_HILOGE("Bad NotifyData");
         SysEventLog::SendSysEventLog(FAULT_EVENT, UDS_FAULT_01, "Bad NotifyData");
     }
 }
 
+void ResponseMessageReceiver::HandNotifyDataV2(char *&leftBuf, int32_t &leftLen)
+{
+    std::shared_ptr<NotifyData> notifyData = std::make_shared<NotifyData>();
+    if (NotifyDataV2FromParcel(notifyData, leftBuf, leftLen) == 0) {
+        AttachBody(notifyData);
+        DeliverNotifyData(notifyData);
+    } else {
+        REQUEST_HILOGE("Bad NotifyData v2");
+        SysEventLog::SendSysEventLog(FAULT_EVENT, UDS_FAULT_01, "Bad NotifyData v2");
+    }
+}
+
+// The callback of a notification of a traced task is traced from its receiving to its end.
+void ResponseMessageReceiver::DeliverNotifyData(const std::shared_ptr<NotifyData> &notifyData)
+{
+    uint64_t traceId = RequestTrace::Of(notifyData->taskId);
+    if (notifyData->type == SubscribeType::REMOVE) {
+        RequestTrace::Unbind(notifyData->taskId);
+    }
+    if (traceId == 0) {
+        Deliver([this, notifyData]() { this->handler_->OnNotifyDataReceive(notifyData); });
+        return;
+    }
+    auto span = std::make_shared<TraceSpan>(traceId, "callback");
+    Deliver([this, notifyData, span]() { this->handler_->OnNotifyDataReceive(notifyData); });
+}
+
 void ResponseMessageReceiver::HandFaultsData(char *&leftBuf, int32_t &leftLen)
 {
     std::shared_ptr<int32_t> tid = std::make_shared<int32_t>();
     std::shared_ptr<Reason> reason = std::make_shared<Reason>();
     std::shared_ptr<SubscribeType> type = std::make_shared<SubscribeType>();
     if (ReasonDataFromParcel(tid, type, reason, leftBuf, leftLen) == 0) {
-        this->handler_->OnFaultsReceive(tid, type, reason);
+        Deliver([this, tid, type, reason]() { this->handler_->OnFaultsReceive(tid, type, reason); });
     } else {
         REQUEST_HILOGE("Bad faults");
         SysEventLog::SendSysEventLog(FAULT_EVENT, UDS_FAULT_01, "Bad faults");
@@ -506,35 +890,101 @@ void ResponseMessageReceiver::HandWaitData(char *&leftBuf, int32_t &leftLen)
         REQUEST_HILOGE("Bad reason");
         return;
     }
-    this->handler_->OnWaitReceive(taskId, static_cast<WaitingReason>(reason));
+    Deliver([this, taskId, reason]() { this->handler_->OnWaitReceive(taskId, static_cast<WaitingReason>(reason)); });
+}
+
+void ResponseMessageReceiver::HandRunCountData(char *&leftBuf, int32_t &leftLen)
+{
+    int64_t runCount;
+    if (Int64FromParcel(runCount, leftBuf, leftLen) != 0) {
+        REQUEST_HILOGE("Bad runCount");
+        return;
+    }
+    Deliver([this, runCount]() { this->handler_->OnRunCountReceive(runCount); });
+}
+
+// Pieces of a body arrive in order, each with the length of the whole body and its own offset.
+void ResponseMessageReceiver::HandBodyData(char *&leftBuf, int32_t &leftLen)
+{
+    uint32_t taskId = 0;
+    uint32_t total = 0;
+    uint32_t offset = 0;
+    if (Uint32FromParcel(taskId, leftBuf, leftLen) != 0 || Uint32FromParcel(total, leftBuf, leftLen) != 0
+        || Uint32FromParcel(offset, leftBuf, leftLen) != 0) {
+        REQUEST_HILOGE("Bad Body");
+        SysEventLog::SendSysEventLog(FAULT_EVENT, UDS_FAULT_01, "Bad Body");
+        return;
+    }
+    std::vector<uint8_t> &body = bodies_[taskId];
+    if (offset == 0) {
+        body.clear();
+    }
+    if (offset != body.size() || static_cast<uint64_t>(offset) + static_cast<uint64_t>(leftLen) > total) {
+        REQUEST_HILOGE("Bad Body piece, %{public}u, %{public}u, %{public}d", offset, total, leftLen);
+        SysEventLog::SendSysEventLog(FAULT_EVENT, UDS_FAULT_01, "Bad Body piece");
+        bodies_.erase(taskId);
+        return;
+    }
+    body.insert(body.end(), leftBuf, leftBuf + leftLen);
+    leftBuf += leftLen;
+    leftLen = 0;
+}
+
+// The body of an in-memory download is sent right before its completed notify data.
+void ResponseMessageReceiver::AttachBody(const std::shared_ptr<NotifyData> &notifyData)
+{
+    auto it = bodies_.find(notifyData->taskId);
+    if (it == bodies_.end()) {
+        return;
+    }
+    if (notifyData->type == SubscribeType::COMPLETED) {
+        notifyData->progress.bodyBytes = std::move(it->second);
+    } else if (notifyData->type != SubscribeType::FAILED && notifyData->type != SubscribeType::REMOVE) {
+        return;
+    }
+    bodies_.erase(it);
 }
 
 void ResponseMessageReceiver::OnShutdown(int32_t fd)
 {
-    ShutdownChannel();
+    ShutdownChannel(true);
 }
 
 void ResponseMessageReceiver::OnException(int32_t fd)
 {
-    ShutdownChannel();
+    ShutdownChannel(true);
 }
 
 void ResponseMessageReceiver::Shutdown()
 {
-    ShutdownChannel();
+    ShutdownChannel(false);
 }
 
-void ResponseMessageReceiver::ShutdownChannel()
+void ResponseMessageReceiver::ShutdownChannel(bool fromReader)
 {
     {
         std::lock_guard<std::mutex> lock(sockFdMutex_);
         REQUEST_HILOGI("uds ShutdownChannel, %{public}d", sockFd_);
         if (sockFd_ > 0) {
-            serviceHandler_->RemoveFileDescriptorListener(sockFd_);
+            fdHandler_->RemoveFileDescriptorListener(sockFd_);
             fdsan_close_with_tag(sockFd_, REQUEST_FDSAN_TAG);
         }
         sockFd_ = -1;
     }
+    if (readerRunner_ != nullptr && !fromReader) {
+        readerRunner_->Stop();
+    }
+    // The handler drops this receiver on the first notification, a later one could drop its successor.
+    if (brokenNotified_.exchange(true)) {
+        return;
+    }
+    if (fromReader) {
+        // Keeps the broken channel behind the callbacks already decoded from it.
+        Deliver([this]() { this->handler_->OnChannelBroken(); });
+        FlushDeliveries();
+        return;
+    }
+    // An explicit shutdown has to be observed synchronously, e.g. before the channel is reopened.
     this->handler_->OnChannelBroken();
 }
 
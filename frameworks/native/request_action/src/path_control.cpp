@@ -20,6 +20,7 @@
 #include <tuple>
 #include <utility>
 
+#include "acl_grant_table.h"
 #include "log.h"
 #include "storage_acl.h"
 
@@ -27,6 +28,7 @@ namespace OHOS::Request {
 
 static constexpr int ACL_SUCC = 0;
 static const std::string SA_PERMISSION_U_RW = "u:3815:rw";
+static const std::string SA_PERMISSION_U_RWX = "u:3815:rwx";
 static const std::string SA_PERMISSION_G_X = "g:3815:x";
 static const std::string SA_PERMISSION_U_CLEAN = "u:3815:---";
 static const std::string SA_PERMISSION_G_CLEAN = "g:3815:---";
@@ -59,7 +61,8 @@ std::vector<std::string> SplitPath(const std::string &path)
             nextPos = path.size();
         }
         if (nextPos > pos) {
-            currentPath += ("/" + path.substr(pos, nextPos - pos));
+            currentPath.push_back('/');
+            currentPath.append(path, pos, nextPos - pos);
             result.emplace_back(currentPath);
         }
         pos = nextPos + 1;
@@ -194,6 +197,45 @@ bool PathControl::SubPathsToMap(const std::string &path)
     return SubPathsVec(paths);
 }
 
+// The directory an archive is extracted to, the service creates its entries. Its ancestors are
+// counted in the map, the directory itself in the grant table so its access is not narrowed.
+bool PathControl::AddDirToMap(const std::string &dir)
+{
+    std::vector<std::pair<std::string, bool>> paths = SelectPath(SplitPath(dir));
+    if (paths.empty()) {
+        return false;
+    }
+    std::string target = paths.back().first;
+    paths.pop_back();
+    std::vector<std::pair<std::string, bool>> completePaths;
+    completePaths.reserve(paths.size());
+    for (auto &elem : paths) {
+        if (!AddOnePathToMap(elem.first, false)) {
+            SubPathsVec(completePaths);
+            return false;
+        }
+        completePaths.emplace_back(elem);
+    }
+    if (!AclGrantTable::Acquire(target, SA_PERMISSION_U_RWX)) {
+        REQUEST_HILOGE("Add Dir Acl Failed, %{public}s", PathControl::ShieldPath(target).c_str());
+        AclGrantTable::Release(target, SA_PERMISSION_U_CLEAN);
+        SubPathsVec(completePaths);
+        return false;
+    }
+    return true;
+}
+
+bool PathControl::SubDirToMap(const std::string &dir)
+{
+    std::vector<std::pair<std::string, bool>> paths = SelectPath(SplitPath(dir));
+    if (paths.empty()) {
+        return false;
+    }
+    bool ret = AclGrantTable::Release(paths.back().first, SA_PERMISSION_U_CLEAN);
+    paths.pop_back();
+    return SubPathsVec(paths) && ret;
+}
+
 void PathControl::InsureMapAcl()
 {
     std::lock_guard<std::mutex> lockGuard(pathMutex_);
@@ -47,6 +47,36 @@ namespace fs = std::filesystem;
 static std::mutex taskMutex_;
 static std::map<std::string, Config> taskMap_;
 
+static const std::string EXTRACT_EXTRA = "extract";
+
+// The service extracts the archive of a download into this directory of the application.
+static bool GrantExtractDir(const Config &config)
+{
+    auto it = config.extras.find(EXTRACT_EXTRA);
+    if (it == config.extras.end() || it->second.empty()) {
+        return true;
+    }
+    const std::string &dir = it->second;
+    if (!PathControl::CheckBelongAppBaseDir(dir) || dir.find("..") != std::string::npos) {
+        REQUEST_HILOGE("Extract dir not in the app base dir");
+        return false;
+    }
+    std::error_code err;
+    fs::create_directories(dir, err);
+    if (err) {
+        REQUEST_HILOGE("Create extract dir failed, %{public}d", err.value());
+        return false;
+    }
+    return PathControl::AddDirToMap(dir);
+}
+
+// Serial, so the asynchronous calls reach the service in the order they were made.
+static ffrt::queue &AsyncQueue()
+{
+    static ffrt::queue queue("Os_Request_Async", ffrt::queue_attr().qos(ffrt::qos_default));
+    return queue;
+}
+
 const std::unique_ptr<RequestAction> &RequestAction::GetInstance()
 {
     static std::unique_ptr<RequestAction> instance = std::make_unique<RequestAction>();
@@ -87,6 +117,75 @@ int32_t RequestAction::SetMaxSpeed(const std::string &tid, const int64_t maxSpee
     return RequestManager::GetInstance()->SetMaxSpeed(tid, maxSpeed);
 }
 
+void RequestAction::QueueAsync(
+    const std::string &tid, int32_t (RequestAction::*method)(const std::string &), AsyncCallback callback)
+{
+    AsyncQueue().submit([this, tid, method, callback = std::move(callback)]() {
+        int32_t ret = (this->*method)(tid);
+        if (callback != nullptr) {
+            callback(ret);
+        }
+    });
+}
+
+void RequestAction::CreateAsync(TaskBuilder builder, CreateCallback callback)
+{
+    AsyncQueue().submit([this, builder = std::move(builder), callback = std::move(callback)]() mutable {
+        std::string tid;
+        int32_t ret = Create(builder, tid);
+        if (callback != nullptr) {
+            callback(ret, tid);
+        }
+    });
+}
+
+void RequestAction::StartAsync(const std::string &tid, AsyncCallback callback)
+{
+    QueueAsync(tid, &RequestAction::Start, std::move(callback));
+}
+
+void RequestAction::StopAsync(const std::string &tid, AsyncCallback callback)
+{
+    QueueAsync(tid, &RequestAction::Stop, std::move(callback));
+}
+
+void RequestAction::PauseAsync(const std::string &tid, AsyncCallback callback)
+{
+    QueueAsync(tid, &RequestAction::Pause, std::move(callback));
+}
+
+void RequestAction::ResumeAsync(const std::string &tid, AsyncCallback callback)
+{
+    QueueAsync(tid, &RequestAction::Resume, std::move(callback));
+}
+
+void RequestAction::RemoveAsync(const std::string &tid, AsyncCallback callback)
+{
+    QueueAsync(tid, &RequestAction::Remove, std::move(callback));
+}
+
+void RequestAction::ShowAsync(const std::string &tid, InfoCallback callback)
+{
+    AsyncQueue().submit([this, tid, callback = std::move(callback)]() {
+        TaskInfo info;
+        int32_t ret = Show(tid, info);
+        if (callback != nullptr) {
+            callback(ret, info);
+        }
+    });
+}
+
+void RequestAction::TouchAsync(const std::string &tid, const std::string &token, InfoCallback callback)
+{
+    AsyncQueue().submit([this, tid, token, callback = std::move(callback)]() {
+        TaskInfo info;
+        int32_t ret = Touch(tid, token, info);
+        if (callback != nullptr) {
+            callback(ret, info);
+        }
+    });
+}
+
 ExceptionErrorCode RequestAction::StartTasks(
     const std::vector<std::string> &tids, std::unordered_map<std::string, ExceptionErrorCode> &rets)
 {
@@ -216,21 +315,29 @@ ExceptionErrorCode RequestAction::DisableTaskNotification(
     return code;
 }
 
-bool RequestAction::CreateDirs(const std::vector<std::string> &pathDirs)
+// `dir` is a normal path, every prefix ending before a '/' is a parent of it.
+bool RequestAction::CreateDirs(const std::string &dir, PathCache &cache)
 {
-    std::string path;
+    if (dir.empty() || cache.existing.count(dir) != 0) {
+        return true;
+    }
     std::error_code err;
-    for (auto elem : pathDirs) {
-        path += "/" + elem;
-        if (std::filesystem::exists(path, err)) {
+    size_t pos = 0;
+    while (pos != std::string::npos) {
+        pos = dir.find('/', pos + 1);
+        std::string path = dir.substr(0, pos);
+        if (cache.existing.count(path) != 0) {
             continue;
         }
-        err.clear();
-        // create_directory noexcept.
-        if (!std::filesystem::create_directory(path, err)) {
-            REQUEST_HILOGE("Create Dir Err: %{public}d, %{public}s", err.value(), err.message().c_str());
-            return false;
+        if (!std::filesystem::exists(path, err)) {
+            err.clear();
+            // create_directory noexcept.
+            if (!std::filesystem::create_directory(path, err)) {
+                REQUEST_HILOGE("Create Dir Err: %{public}d, %{public}s", err.value(), err.message().c_str());
+                return false;
+            }
         }
+        cache.existing.insert(std::move(path));
     }
     return true;
 }
@@ -247,30 +354,25 @@ bool RequestAction::FileToWhole(
     return true;
 }
 
-bool RequestAction::BaseToWhole(const std::shared_ptr<OHOS::AbilityRuntime::Context> &context, std::string &path)
+bool RequestAction::BaseToWhole(PathCache &cache, std::string &path)
 {
-    std::string base = context->GetBaseDir();
-    if (base.empty()) {
-        REQUEST_HILOGE("GetBaseDir error.");
+    if (!GetAppBaseDir(cache)) {
         return false;
     }
-    path = base + "/" + path;
+    path = cache.baseDir + "/" + path;
     return true;
 }
 
-bool RequestAction::CacheToWhole(const std::shared_ptr<OHOS::AbilityRuntime::Context> &context, std::string &path)
+bool RequestAction::CacheToWhole(PathCache &cache, std::string &path)
 {
-    std::string cache = context->GetCacheDir();
-    if (cache.empty()) {
-        REQUEST_HILOGE("GetCacheDir error.");
+    if (!GetAppCacheDir(cache)) {
         return false;
     }
-    path = cache + "/" + path;
+    path = cache.cacheDir + "/" + path;
     return true;
 }
 
-bool RequestAction::StandardizePath(
-    const std::shared_ptr<OHOS::AbilityRuntime::Context> &context, const Config &config, std::string &path)
+bool RequestAction::StandardizePath(PathCache &cache, const Config &config, std::string &path)
 {
     std::string wholePrefix = "/";
     std::string filePrefix = "file://";
@@ -282,17 +384,17 @@ bool RequestAction::StandardizePath(
     }
     if (path.find(filePrefix) == 0) {
         path.erase(0, filePrefix.size());
-        return FileToWhole(context, config, path);
+        return FileToWhole(cache.context, config, path);
     }
     if (path.find(internalPrefix) == 0) {
         path.erase(0, internalPrefix.size());
-        return BaseToWhole(context, path);
+        return BaseToWhole(cache, path);
     }
     if (path.find(currentPrefix) == 0) {
         path.erase(0, currentPrefix.size());
-        return CacheToWhole(context, path);
+        return CacheToWhole(cache, path);
     }
-    return CacheToWhole(context, path);
+    return CacheToWhole(cache, path);
 }
 
 void RequestAction::StringSplit(const std::string &str, const char delim, std::vector<std::string> &elems)
@@ -338,24 +440,33 @@ bool RequestAction::WholeToNormal(std::string &path, std::vector<std::string> &o
     return true;
 }
 
-bool RequestAction::GetAppBaseDir(std::string &baseDir)
+bool RequestAction::GetAppBaseDir(PathCache &cache)
 {
-    auto context = AbilityRuntime::Context::GetApplicationContext();
-    if (context == nullptr) {
-        REQUEST_HILOGE("AppContext is null.");
-        return false;
+    if (cache.baseDir.empty()) {
+        cache.baseDir = cache.context->GetBaseDir();
     }
-    baseDir = context->GetBaseDir();
-    if (baseDir.empty()) {
+    if (cache.baseDir.empty()) {
         REQUEST_HILOGE("Base dir not found.");
         return false;
     }
     return true;
 }
 
-bool RequestAction::CheckBelongAppBaseDir(const std::string &filepath, std::string &baseDir)
+bool RequestAction::GetAppCacheDir(PathCache &cache)
 {
-    if (!GetAppBaseDir(baseDir)) {
+    if (cache.cacheDir.empty()) {
+        cache.cacheDir = cache.context->GetCacheDir();
+    }
+    if (cache.cacheDir.empty()) {
+        REQUEST_HILOGE("GetCacheDir error.");
+        return false;
+    }
+    return true;
+}
+
+bool RequestAction::CheckBelongAppBaseDir(const std::string &filepath, PathCache &cache)
+{
+    if (!GetAppBaseDir(cache)) {
         return false;
     }
     return FindAreaPath(filepath);
@@ -371,35 +482,47 @@ bool RequestAction::FindAreaPath(const std::string &filepath)
     }
 }
 
-bool RequestAction::GetSandboxPath(const std::shared_ptr<OHOS::AbilityRuntime::Context> &context, const Config &config,
-    std::string &path, std::vector<std::string> &pathVec)
+bool RequestAction::GetSandboxPath(PathCache &cache, const Config &config, std::string &path, std::string &dir)
 {
-    if (!StandardizePath(context, config, path)) {
+    if (!StandardizePath(cache, config, path)) {
         REQUEST_HILOGE("StandardizePath Err");
         return false;
     };
-    if (!WholeToNormal(path, pathVec) || pathVec.empty()) {
-        REQUEST_HILOGE("WholeToNormal Err");
-        return false;
-    };
-    std::string baseDir;
-    if (!CheckBelongAppBaseDir(path, baseDir)) {
+    // Files in a normalized directory only append their names to it.
+    size_t pos = path.rfind('/');
+    std::string name = path.substr(pos + 1);
+    bool plainName = !name.empty() && name != "." && name != "..";
+    std::string wholeDir = path.substr(0, pos);
+    auto it = plainName ? cache.normalDirs.find(wholeDir) : cache.normalDirs.end();
+    if (it != cache.normalDirs.end()) {
+        dir = it->second;
+        path = dir + "/" + name;
+    } else {
+        std::vector<std::string> pathVec;
+        if (!WholeToNormal(path, pathVec) || pathVec.empty()) {
+            REQUEST_HILOGE("WholeToNormal Err");
+            return false;
+        };
+        dir = path.substr(0, path.rfind('/'));
+        if (plainName) {
+            cache.normalDirs.emplace(std::move(wholeDir), dir);
+        }
+    }
+    if (!CheckBelongAppBaseDir(path, cache)) {
         REQUEST_HILOGE("CheckBelongAppBaseDir Err");
         return false;
     };
     return true;
 }
 
-bool RequestAction::CheckDownloadFilePath(const std::shared_ptr<OHOS::AbilityRuntime::Context> &context, Config &config)
+bool RequestAction::CheckDownloadFilePath(PathCache &cache, Config &config)
 {
     std::string path = config.saveas;
-    std::vector<std::string> pathVec;
-    if (!GetSandboxPath(context, config, path, pathVec)) {
+    std::string dir;
+    if (!GetSandboxPath(cache, config, path, dir)) {
         return false;
     }
-    // pop filename.
-    pathVec.pop_back();
-    if (!CreateDirs(pathVec)) {
+    if (!CreateDirs(dir, cache)) {
         REQUEST_HILOGE("CreateDirs Err");
         return false;
     }
@@ -445,8 +568,7 @@ bool RequestAction::IsPathValid(const std::string &filePath)
     return true;
 }
 
-bool RequestAction::GetInternalPath(
-    const std::shared_ptr<OHOS::AbilityRuntime::Context> &context, const Config &config, std::string &path)
+bool RequestAction::GetInternalPath(PathCache &cache, const Config &config, std::string &path)
 {
     std::string fileName;
     std::string pattern = "internal://cache/";
@@ -459,12 +581,11 @@ bool RequestAction::GetInternalPath(
     if (fileName.empty()) {
         return false;
     }
-    path = context->GetCacheDir();
-    if (path.empty()) {
+    if (!GetAppCacheDir(cache)) {
         REQUEST_HILOGE("internal to cache error");
         return false;
     }
-    path += "/" + fileName;
+    path = cache.cacheDir + "/" + fileName;
     if (!IsPathValid(path)) {
         REQUEST_HILOGE("IsPathValid error");
         return false;
@@ -478,7 +599,7 @@ bool RequestAction::FindDir(const std::string &pathDir)
     return std::filesystem::exists(pathDir, err);
 }
 
-ExceptionErrorCode RequestAction::GetFdDownload(const std::string &path, const Config &config)
+ExceptionErrorCode RequestAction::GetFdDownload(const std::string &path, const Config &config, int32_t &fd)
 {
     // File is exist.
     if (FindDir(path)) {
@@ -487,31 +608,26 @@ ExceptionErrorCode RequestAction::GetFdDownload(const std::string &path, const C
         }
     }
 
-    FILE *file = nullptr;
-    if (config.firstInit) {
-        file = fopen(path.c_str(), "w+");
-    } else {
-        file = fopen(path.c_str(), "a+");
+    // The service writes to this descriptor, it appends as it does to the files it opens itself.
+    int32_t flags = O_RDWR | O_CREAT | O_APPEND;
+    // A delta download keeps the old content, the service fetches only the blocks that changed.
+    if (config.firstInit && config.extras.find("delta") == config.extras.end()) {
+        flags |= O_TRUNC;
     }
-
-    if (file == nullptr) {
+    fd = open(path.c_str(), flags, S_IRUSR | S_IWUSR | S_IRGRP);
+    if (fd < 0) {
         return E_FILE_IO;
     }
+    fdsan_exchange_owner_tag(fd, 0, REQUEST_FDSAN_TAG);
 
     int32_t ret = chmod(path.c_str(), S_IRUSR | S_IWUSR | S_IRGRP);
     if (ret != 0) {
         REQUEST_HILOGE("download file chmod fail: %{public}d", ret);
     };
-
-    int32_t retClose = fclose(file);
-    if (retClose != 0) {
-        REQUEST_HILOGE("download fclose fail: %{public}d", ret);
-    }
     return E_OK;
 }
 
-ExceptionErrorCode RequestAction::CheckDownloadFile(
-    const std::shared_ptr<OHOS::AbilityRuntime::Context> &context, Config &config)
+ExceptionErrorCode RequestAction::CheckDownloadFile(PathCache &cache, Config &config)
 {
     ExceptionErrorCode ret;
     if (IsUserFile(config.saveas)) {
@@ -519,7 +635,7 @@ ExceptionErrorCode RequestAction::CheckDownloadFile(
             return E_PARAMETER_CHECK;
         }
         FileSpec file = { .uri = config.saveas, .isUserFile = true };
-        ret = CheckUserFileSpec(context, config, file, false);
+        ret = CheckUserFileSpec(cache.context, config, file, false);
         if (ret == ExceptionErrorCode::E_OK) {
             config.files.push_back(file);
         }
@@ -529,25 +645,32 @@ ExceptionErrorCode RequestAction::CheckDownloadFile(
         std::string path = config.saveas;
         if (config.saveas.find('/') == 0) {
             // API9 do not check.
-        } else if (!GetInternalPath(context, config, path)) {
+        } else if (!GetInternalPath(cache, config, path)) {
             return E_PARAMETER_CHECK;
         }
         config.saveas = path;
     } else {
-        if (!CheckDownloadFilePath(context, config)) {
+        if (!CheckDownloadFilePath(cache, config)) {
             return E_PARAMETER_CHECK;
         }
     }
     FileSpec file = { .uri = config.saveas, .isUserFile = false };
     StandardizeFileSpec(file);
-    config.files.push_back(file);
-    ret = GetFdDownload(file.uri, config);
+    ret = GetFdDownload(file.uri, config, file.fd);
     if (ret != ExceptionErrorCode::E_OK) {
         return ret;
     }
+    // Tasks restored after the service restarts open the file by its path.
     if (!PathControl::AddPathsToMap(config.saveas)) {
+        fdsan_close_with_tag(file.fd, REQUEST_FDSAN_TAG);
         return ExceptionErrorCode::E_FILE_IO;
     }
+    if (!GrantExtractDir(config)) {
+        PathControl::SubPathsToMap(config.saveas);
+        fdsan_close_with_tag(file.fd, REQUEST_FDSAN_TAG);
+        return ExceptionErrorCode::E_PARAMETER_CHECK;
+    }
+    config.files.push_back(file);
     return ExceptionErrorCode::E_OK;
 }
 
@@ -602,58 +725,55 @@ bool RequestAction::CheckPathIsFile(const std::string &path)
     return true;
 }
 
-ExceptionErrorCode RequestAction::GetFdUpload(const std::string &path, const Config &config)
+ExceptionErrorCode RequestAction::GetFdUpload(const std::string &path, const Config &config, int32_t &fd)
 {
     if (!CheckPathIsFile(path)) {
         return config.version == Version::API10 ? E_FILE_IO : E_FILE_PATH;
     }
-    FILE *file = fopen(path.c_str(), "r");
-    if (file == nullptr) {
+    fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
         return config.version == Version::API10 ? E_FILE_IO : E_FILE_PATH;
     }
-    REQUEST_HILOGD("upload file fopen ok");
+    fdsan_exchange_owner_tag(fd, 0, REQUEST_FDSAN_TAG);
+    REQUEST_HILOGD("upload file open ok");
     int32_t ret = chmod(path.c_str(), S_IRUSR | S_IWUSR | S_IRGRP);
     if (ret != 0) {
         REQUEST_HILOGE("upload file chmod fail: %{public}d", ret);
     }
-    int32_t retClose = fclose(file);
-    if (retClose != 0) {
-        REQUEST_HILOGE("upload fclose fail: %{public}d", ret);
-    }
     return E_OK;
 }
 
-ExceptionErrorCode RequestAction::CheckUploadFileSpec(
-    const std::shared_ptr<OHOS::AbilityRuntime::Context> &context, Config &config, FileSpec &file)
+ExceptionErrorCode RequestAction::CheckUploadFileSpec(PathCache &cache, Config &config, FileSpec &file)
 {
     ExceptionErrorCode ret;
     file.isUserFile = false;
     std::string path = file.uri;
     if (config.version == Version::API9) {
-        if (!GetInternalPath(context, config, path)) {
+        if (!GetInternalPath(cache, config, path)) {
             return E_PARAMETER_CHECK;
         }
     } else {
-        std::vector<std::string> pathVec;
-        if (!GetSandboxPath(context, config, path, pathVec)) {
+        std::string dir;
+        if (!GetSandboxPath(cache, config, path, dir)) {
             return E_PARAMETER_CHECK;
         }
     }
     REQUEST_HILOGD("CheckUploadFileSpec path");
     file.uri = path;
-    ret = GetFdUpload(path, config);
+    ret = GetFdUpload(path, config, file.fd);
     if (ret != E_OK) {
         return ret;
     }
     if (!PathControl::AddPathsToMap(file.uri)) {
+        fdsan_close_with_tag(file.fd, REQUEST_FDSAN_TAG);
+        file.fd = -1;
         return E_FILE_IO;
     }
     StandardizeFileSpec(file);
     return E_OK;
 }
 
-ExceptionErrorCode RequestAction::CheckUploadFiles(
-    const std::shared_ptr<OHOS::AbilityRuntime::Context> &context, Config &config)
+ExceptionErrorCode RequestAction::CheckUploadFiles(PathCache &cache, Config &config)
 {
     // need reconstruction.
     ExceptionErrorCode ret;
@@ -663,7 +783,7 @@ ExceptionErrorCode RequestAction::CheckUploadFiles(
             if (config.version == Version::API9) {
                 return E_PARAMETER_CHECK;
             }
-            ret = CheckUserFileSpec(context, config, file, true);
+            ret = CheckUserFileSpec(cache.context, config, file, true);
             if (ret != ExceptionErrorCode::E_OK) {
                 return ret;
             }
@@ -671,7 +791,7 @@ ExceptionErrorCode RequestAction::CheckUploadFiles(
             continue;
         }
 
-        ret = CheckUploadFileSpec(context, config, file);
+        ret = CheckUploadFileSpec(cache, config, file);
         if (ret != ExceptionErrorCode::E_OK) {
             return ret;
         }
@@ -720,15 +840,13 @@ ExceptionErrorCode RequestAction::CheckUploadBodyFiles(const std::string &filePa
     return E_OK;
 }
 
-bool RequestAction::SetDirsPermission(std::vector<std::string> &dirs)
+bool RequestAction::SetDirsPermission(std::vector<std::string> &dirs, PathCache &cache)
 {
     if (dirs.empty()) {
         return true;
     }
     std::string newPath = "/data/storage/el2/base/.ohos/.request/.certs";
-    std::vector<std::string> dirElems;
-    StringSplit(newPath, '/', dirElems);
-    if (!CreateDirs(dirElems)) {
+    if (!CreateDirs(newPath, cache)) {
         REQUEST_HILOGE("CreateDirs Error");
         return false;
     }
@@ -742,8 +860,11 @@ bool RequestAction::SetDirsPermission(std::vector<std::string> &dirs)
             fs::path path = entry.path();
             std::string existfilePath = folder.string() + "/" + path.filename().string();
             std::string newfilePath = newPath + "/" + path.filename().string();
-            if (!fs::exists(newfilePath)) {
-                fs::copy(existfilePath, newfilePath);
+            if (cache.existing.count(newfilePath) == 0) {
+                if (!fs::exists(newfilePath)) {
+                    fs::copy(existfilePath, newfilePath);
+                }
+                cache.existing.insert(newfilePath);
             }
             if (chmod(newfilePath.c_str(), S_IRUSR | S_IWUSR | S_IRGRP) != 0) {
                 REQUEST_HILOGD("File add OTH access Failed.");
@@ -761,31 +882,33 @@ bool RequestAction::SetDirsPermission(std::vector<std::string> &dirs)
     return true;
 }
 
-ExceptionErrorCode RequestAction::CheckFilePath(Config &config)
+ExceptionErrorCode RequestAction::CheckFilePath(Config &config, PathCache &cache)
 {
-    auto context = AbilityRuntime::Context::GetApplicationContext();
+    if (cache.context == nullptr) {
+        cache.context = AbilityRuntime::Context::GetApplicationContext();
+    }
     ExceptionErrorCode ret;
-    if (context == nullptr) {
+    if (cache.context == nullptr) {
         REQUEST_HILOGE("AppContext is null.");
         return E_FILE_IO;
     }
     if (config.action == Action::DOWNLOAD) {
-        ret = CheckDownloadFile(context, config);
+        ret = CheckDownloadFile(cache, config);
         if (ret != ExceptionErrorCode::E_OK) {
             return ret;
         }
     } else {
-        ret = CheckUploadFiles(context, config);
+        ret = CheckUploadFiles(cache, config);
         if (ret != ExceptionErrorCode::E_OK) {
             return ret;
         }
-        std::string filePath = context->GetCacheDir();
-        ret = CheckUploadBodyFiles(filePath, config);
+        GetAppCacheDir(cache);
+        ret = CheckUploadBodyFiles(cache.cacheDir, config);
         if (ret != ExceptionErrorCode::E_OK) {
             return ret;
         }
     }
-    if (!SetDirsPermission(config.certsPath)) {
+    if (!SetDirsPermission(config.certsPath, cache)) {
         return ExceptionErrorCode::E_FILE_IO;
     }
     return ExceptionErrorCode::E_OK;
@@ -797,7 +920,8 @@ int32_t RequestAction::Create(TaskBuilder &builder, std::string &tid)
     if (ret.second != ExceptionErrorCode::E_OK) {
         return ret.second;
     }
-    int32_t err = CheckFilePath(ret.first);
+    PathCache cache;
+    int32_t err = CheckFilePath(ret.first, cache);
     if (err != ExceptionErrorCode::E_OK) {
         return err;
     }
@@ -813,25 +937,45 @@ int32_t RequestAction::Create(TaskBuilder &builder, std::string &tid)
 }
 
 ExceptionErrorCode RequestAction::CreateTasks(std::vector<TaskBuilder> &builders, std::vector<TaskRet> &rets)
+{
+    std::vector<std::pair<Config, ExceptionErrorCode>> built;
+    built.reserve(builders.size());
+    for (auto &builder : builders) {
+        built.push_back(builder.build());
+    }
+    return CreateBuiltTasks(built, rets);
+}
+
+ExceptionErrorCode RequestAction::CreateTasks(TaskBatchBuilder &&batch, std::vector<TaskRet> &rets)
+{
+    std::vector<std::pair<Config, ExceptionErrorCode>> built = std::move(batch).build();
+    return CreateBuiltTasks(built, rets);
+}
+
+ExceptionErrorCode RequestAction::CreateBuiltTasks(
+    std::vector<std::pair<Config, ExceptionErrorCode>> &built, std::vector<TaskRet> &rets)
 {
     std::vector<Config> configs;
-    size_t len = builders.size();
+    size_t len = built.size();
+    configs.reserve(len);
     rets.resize(len, {
                          .code = ExceptionErrorCode::E_OTHER,
                      });
+    // Shared by the configs, most of them are saved to or uploaded from the same directories.
+    PathCache cache;
     for (size_t i = 0; i < len; i++) {
-        auto ret = builders[i].build();
+        auto &ret = built[i];
         if (ret.second != ExceptionErrorCode::E_OK) {
             rets[i].code = ret.second;
             continue;
         }
-        ExceptionErrorCode err = CheckFilePath(ret.first);
+        ExceptionErrorCode err = CheckFilePath(ret.first, cache);
         if (err != ExceptionErrorCode::E_OK) {
             rets[i].code = err;
             continue;
         }
         // If config is invalid, do not add it to configs.
-        configs.push_back(ret.first);
+        configs.push_back(std::move(ret.first));
     }
     PathControl::InsureMapAcl();
 
@@ -907,6 +1051,10 @@ bool RequestAction::ClearTaskTemp(const std::string &tid)
     for (auto &file : config.files) {
         PathControl::SubPathsToMap(file.uri);
     }
+    auto extract = config.extras.find(EXTRACT_EXTRA);
+    if (extract != config.extras.end() && !extract->second.empty()) {
+        PathControl::SubDirToMap(extract->second);
+    }
 
     RemoveDirsPermission(config.certsPath);
     return true;
@@ -16,10 +16,12 @@
 #include "task_builder.h"
 
 #include <regex>
+#include <utility>
 
 #include "application_context.h"
 #include "log.h"
 #include "network_security_config.h"
+#include "url_view.h"
 
 namespace OHOS::Request {
 
@@ -35,18 +37,36 @@ TaskBuilder &TaskBuilder::setUrl(const std::string &url)
     return *this;
 }
 
+TaskBuilder &TaskBuilder::setUrl(std::string &&url)
+{
+    this->config.url = std::move(url);
+    return *this;
+}
+
 TaskBuilder &TaskBuilder::setTitle(const std::string &title)
 {
     this->config.title = title;
     return *this;
 }
 
+TaskBuilder &TaskBuilder::setTitle(std::string &&title)
+{
+    this->config.title = std::move(title);
+    return *this;
+}
+
 TaskBuilder &TaskBuilder::setDescription(const std::string &description)
 {
     this->config.description = description;
     return *this;
 }
 
+TaskBuilder &TaskBuilder::setDescription(std::string &&description)
+{
+    this->config.description = std::move(description);
+    return *this;
+}
+
 TaskBuilder &TaskBuilder::setMode(Mode mode)
 {
     this->config.mode = mode;
@@ -65,36 +85,72 @@ TaskBuilder &TaskBuilder::setMethod(const std::string &method)
     return *this;
 }
 
+TaskBuilder &TaskBuilder::setMethod(std::string &&method)
+{
+    this->config.method = std::move(method);
+    return *this;
+}
+
 TaskBuilder &TaskBuilder::setHeaders(const std::map<std::string, std::string> &headers)
 {
     this->config.headers = headers;
     return *this;
 }
 
+TaskBuilder &TaskBuilder::setHeaders(std::map<std::string, std::string> &&headers)
+{
+    this->config.headers = std::move(headers);
+    return *this;
+}
+
 TaskBuilder &TaskBuilder::setData(const std::string &data)
 {
     this->config.data = data;
     return *this;
 }
 
+TaskBuilder &TaskBuilder::setData(std::string &&data)
+{
+    this->config.data = std::move(data);
+    return *this;
+}
+
 TaskBuilder &TaskBuilder::setData(const std::vector<FormItem> &data)
 {
     this->config.forms = data;
     return *this;
 }
 
+TaskBuilder &TaskBuilder::setData(std::vector<FormItem> &&data)
+{
+    this->config.forms = std::move(data);
+    return *this;
+}
+
 TaskBuilder &TaskBuilder::setData(const std::vector<FileSpec> &data)
 {
     this->config.files = data;
     return *this;
 }
 
+TaskBuilder &TaskBuilder::setData(std::vector<FileSpec> &&data)
+{
+    this->config.files = std::move(data);
+    return *this;
+}
+
 TaskBuilder &TaskBuilder::setSaveAs(const std::string &saveas)
 {
     this->config.saveas = saveas;
     return *this;
 }
 
+TaskBuilder &TaskBuilder::setSaveAs(std::string &&saveas)
+{
+    this->config.saveas = std::move(saveas);
+    return *this;
+}
+
 TaskBuilder &TaskBuilder::setNetwork(Network network)
 {
     this->config.network = network;
@@ -131,6 +187,12 @@ TaskBuilder &TaskBuilder::setProxy(const std::string &proxy)
     return *this;
 }
 
+TaskBuilder &TaskBuilder::setProxy(std::string &&proxy)
+{
+    this->config.proxy = std::move(proxy);
+    return *this;
+}
+
 TaskBuilder &TaskBuilder::setIndex(uint32_t index)
 {
     this->config.index = index;
@@ -167,6 +229,12 @@ TaskBuilder &TaskBuilder::setToken(const std::string &token)
     return *this;
 }
 
+TaskBuilder &TaskBuilder::setToken(std::string &&token)
+{
+    this->config.token = std::move(token);
+    return *this;
+}
+
 TaskBuilder &TaskBuilder::setPriority(uint32_t priority)
 {
     this->config.priority = priority;
@@ -179,44 +247,73 @@ TaskBuilder &TaskBuilder::setExtras(const std::map<std::string, std::string> &ex
     return *this;
 }
 
-std::pair<Config, ExceptionErrorCode> TaskBuilder::build()
+TaskBuilder &TaskBuilder::setExtras(std::map<std::string, std::string> &&extras)
+{
+    this->config.extras = std::move(extras);
+    return *this;
+}
+
+TaskBuilder &TaskBuilder::setNotification(const Notification &notification)
+{
+    this->config.notification = notification;
+    return *this;
+}
+
+TaskBuilder &TaskBuilder::setNotification(Notification &&notification)
+{
+    this->config.notification = std::move(notification);
+    return *this;
+}
+
+std::pair<Config, ExceptionErrorCode> TaskBuilder::build() &
+{
+    ExceptionErrorCode code = this->check();
+    return { this->config, code };
+}
+
+std::pair<Config, ExceptionErrorCode> TaskBuilder::build() &&
+{
+    ExceptionErrorCode code = this->check();
+    return { std::move(this->config), code };
+}
+
+ExceptionErrorCode TaskBuilder::check()
 {
     if (!this->checkAction()) {
-        return { this->config, ExceptionErrorCode::E_PARAMETER_CHECK };
+        return ExceptionErrorCode::E_PARAMETER_CHECK;
     }
     if (!this->checkUrl()) {
-        return { this->config, ExceptionErrorCode::E_PARAMETER_CHECK };
+        return ExceptionErrorCode::E_PARAMETER_CHECK;
     }
     if (!this->checkData()) {
-        return { this->config, ExceptionErrorCode::E_PARAMETER_CHECK };
+        return ExceptionErrorCode::E_PARAMETER_CHECK;
     }
     if (!this->checkIndex()) {
-        return { this->config, ExceptionErrorCode::E_PARAMETER_CHECK };
+        return ExceptionErrorCode::E_PARAMETER_CHECK;
     }
     if (!this->checkProxy()) {
-        return { this->config, ExceptionErrorCode::E_PARAMETER_CHECK };
+        return ExceptionErrorCode::E_PARAMETER_CHECK;
     }
     if (!this->checkTitle()) {
-        return { this->config, ExceptionErrorCode::E_PARAMETER_CHECK };
+        return ExceptionErrorCode::E_PARAMETER_CHECK;
     }
     if (!this->checkToken()) {
-        return { this->config, ExceptionErrorCode::E_PARAMETER_CHECK };
+        return ExceptionErrorCode::E_PARAMETER_CHECK;
     }
     if (!this->checkDescription()) {
-        return { this->config, ExceptionErrorCode::E_PARAMETER_CHECK };
+        return ExceptionErrorCode::E_PARAMETER_CHECK;
     }
     if (!this->checkSaveas()) {
-        return { this->config, ExceptionErrorCode::E_PARAMETER_CHECK };
+        return ExceptionErrorCode::E_PARAMETER_CHECK;
     }
     if (!this->checkBundle()) {
-        return { this->config, ExceptionErrorCode::E_PARAMETER_CHECK };
+        return ExceptionErrorCode::E_PARAMETER_CHECK;
     }
     this->checkCertsPath();
     this->checkCertificatePins();
     this->checkMethod();
     this->checkOtherConfig();
-
-    return { this->config, ExceptionErrorCode::E_OK };
+    return ExceptionErrorCode::E_OK;
 }
 
 bool TaskBuilder::checkAction()
@@ -243,33 +340,12 @@ bool TaskBuilder::checkUrl()
 
 void TaskBuilder::checkCertsPath()
 {
-    typedef std::string::const_iterator iter_t;
-
-    iter_t urlEnd = this->config.url.end();
-    iter_t protocolStart = this->config.url.cbegin();
-    iter_t protocolEnd = std::find(protocolStart, urlEnd, ':');
-    std::string protocol = std::string(protocolStart, protocolEnd);
-    if (protocol != "https") {
+    UrlView view = ParseUrlView(this->config.url);
+    if (view.scheme != "https") {
         REQUEST_HILOGD("Using Http");
         return;
     }
-    if (protocolEnd != urlEnd) {
-        std::string afterProtocol = &*(protocolEnd);
-        // 3 is the num of ://
-        if ((afterProtocol.length() > 3) && (afterProtocol.substr(0, 3) == "://")) {
-            // 3 means go beyound :// in protocolEnd
-            protocolEnd += 3;
-        } else {
-            protocolEnd = this->config.url.cbegin();
-        }
-    } else {
-        protocolEnd = this->config.url.cbegin();
-    }
-    iter_t hostStart = protocolEnd;
-    iter_t pathStart = std::find(hostStart, urlEnd, '/');
-    iter_t queryStart = std::find(this->config.url.cbegin(), urlEnd, '?');
-    iter_t hostEnd = std::find(protocolEnd, (pathStart != urlEnd) ? pathStart : queryStart, ':');
-    std::string hostname = std::string(hostStart, hostEnd);
+    std::string hostname(view.host);
     REQUEST_HILOGD("Hostname is %{public}s", hostname.c_str());
     NetManagerStandard::NetworkSecurityConfig::GetInstance().
         GetTrustAnchorsForHostName(hostname, this->config.certsPath);
@@ -388,28 +464,7 @@ bool TaskBuilder::checkSaveas()
 
 std::string GetHostnameFromURL(const std::string &url)
 {
-    if (url.empty()) {
-        return "";
-    }
-    std::string delimiter = "://";
-    std::string tempUrl = url;
-    std::replace(tempUrl.begin(), tempUrl.end(), '\\', '/');
-    size_t posStart = tempUrl.find(delimiter);
-    if (posStart != std::string::npos) {
-        posStart += delimiter.length();
-    } else {
-        posStart = 0;
-    }
-    size_t notSlash = tempUrl.find_first_not_of('/', posStart);
-    if (notSlash != std::string::npos) {
-        posStart = notSlash;
-    }
-    size_t posEnd =
-        std::min({ tempUrl.find(':', posStart), tempUrl.find('/', posStart), tempUrl.find('?', posStart) });
-    if (posEnd != std::string::npos) {
-        return tempUrl.substr(posStart, posEnd - posStart);
-    }
-    return tempUrl.substr(posStart);
+    return std::string(ParseUrlView(url).host);
 }
 
 void TaskBuilder::checkCertificatePins()
@@ -474,4 +529,91 @@ bool TaskBuilder::checkBundle()
     return true;
 }
 
+TaskBatchBuilder &TaskBatchBuilder::setAction(Action action)
+{
+    this->shared_.setAction(action);
+    return *this;
+}
+
+TaskBatchBuilder &TaskBatchBuilder::setMode(Mode mode)
+{
+    this->shared_.setMode(mode);
+    return *this;
+}
+
+TaskBatchBuilder &TaskBatchBuilder::setHeaders(const std::map<std::string, std::string> &headers)
+{
+    this->shared_.setHeaders(headers);
+    return *this;
+}
+
+TaskBatchBuilder &TaskBatchBuilder::setHeaders(std::map<std::string, std::string> &&headers)
+{
+    this->shared_.setHeaders(std::move(headers));
+    return *this;
+}
+
+TaskBatchBuilder &TaskBatchBuilder::setNetwork(Network network)
+{
+    this->shared_.setNetwork(network);
+    return *this;
+}
+
+TaskBatchBuilder &TaskBatchBuilder::setMetered(bool metered)
+{
+    this->shared_.setMetered(metered);
+    return *this;
+}
+
+TaskBatchBuilder &TaskBatchBuilder::setRoaming(bool roaming)
+{
+    this->shared_.setRoaming(roaming);
+    return *this;
+}
+
+TaskBatchBuilder &TaskBatchBuilder::setProxy(const std::string &proxy)
+{
+    this->shared_.setProxy(proxy);
+    return *this;
+}
+
+TaskBatchBuilder &TaskBatchBuilder::setProxy(std::string &&proxy)
+{
+    this->shared_.setProxy(std::move(proxy));
+    return *this;
+}
+
+TaskBatchBuilder &TaskBatchBuilder::setNotification(const Notification &notification)
+{
+    this->shared_.setNotification(notification);
+    return *this;
+}
+
+TaskBatchBuilder &TaskBatchBuilder::setNotification(Notification &&notification)
+{
+    this->shared_.setNotification(std::move(notification));
+    return *this;
+}
+
+TaskBuilder &TaskBatchBuilder::add()
+{
+    return this->builders_.emplace_back(this->shared_);
+}
+
+size_t TaskBatchBuilder::size() const
+{
+    return this->builders_.size();
+}
+
+std::vector<std::pair<Config, ExceptionErrorCode>> TaskBatchBuilder::build() &&
+{
+    std::vector<std::pair<Config, ExceptionErrorCode>> built;
+    built.reserve(this->builders_.size());
+    for (auto &builder : this->builders_) {
+        built.push_back(std::move(builder).build());
+    }
+    this->builders_.clear();
+    return built;
+}
+
 } // namespace OHOS::Request
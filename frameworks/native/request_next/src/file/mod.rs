@@ -21,7 +21,7 @@ use request_core::{
 use request_utils::context::Context;
 use request_utils::storage;
 use std::os::unix::fs::PermissionsExt;
-use std::os::unix::io::AsRawFd;
+use std::os::unix::io::IntoRawFd;
 use std::{
     collections::HashMap,
     fs::{self, File, OpenOptions},
@@ -79,7 +79,7 @@ impl FileManager {
     ) -> Result<Option<PermissionToken>, i32> {
         Self::parse_saveas(config)?;
         if Self::is_user_file(&config.saveas.clone()) {
-            Self::check_download_user_file(config)?;
+            Self::check_download_user_file(config, context)?;
             return Ok(None);
         }
         let path = Self::convert_download_path(config, context)?;
@@ -259,7 +259,10 @@ impl FileManager {
         Ok(())
     }
 
-    fn check_download_user_file(config: &mut TaskConfig) -> Result<(), i32> {
+    /// Opens the user file a download is written to. The fd is sent to the
+    /// service, which writes the body to it directly, so the file is never
+    /// staged in the sandbox of the application and copied afterwards.
+    fn check_download_user_file(config: &mut TaskConfig, context: &Context) -> Result<(), i32> {
         if matches!(config.version, Version::API9) {
             return Err(401);
         }
@@ -270,19 +273,29 @@ impl FileManager {
             if !config.overwrite {
                 return Err(401);
             }
-            let_cxx_string!(target_file = config.saveas.clone());
-            let file_uri = request_utils::wrapper::FileUriGetRealPath(&target_file);
             // todo first_init, fdsan
-            let fd = OpenOptions::new()
-                .write(true)
-                .create(true)
-                .truncate(true)
-                .open(file_uri)
-                .map_err(|_| {
-                    error!("open fail");
-                    13400001
-                })?
-                .as_raw_fd();
+            let fd = if config.saveas.starts_with(MEDIA_PREFIX) {
+                // Files of the media library are opened by their data ability
+                let fd = Self::data_ability_open_file(context, config.saveas.clone(), "rwt");
+                if fd < 0 {
+                    error!("data ability open fail");
+                    return Err(13400001);
+                }
+                fd
+            } else {
+                let_cxx_string!(target_file = config.saveas.clone());
+                let file_uri = request_utils::wrapper::FileUriGetRealPath(&target_file);
+                OpenOptions::new()
+                    .write(true)
+                    .create(true)
+                    .truncate(true)
+                    .open(file_uri)
+                    .map_err(|_| {
+                        error!("open fail");
+                        13400001
+                    })?
+                    .into_raw_fd()
+            };
             let file_name = config
                 .saveas
                 .clone()
@@ -307,13 +320,14 @@ impl FileManager {
         Ok(())
     }
 
-    fn data_ability_open_file(context: &Context, target_file: String) -> i32 {
+    fn data_ability_open_file(context: &Context, target_file: String, mode: &str) -> i32 {
         let_cxx_string!(target_file = target_file);
-        request_data_ability::dataability::DataAbilityOpenFile(&context.inner, &target_file)
+        let_cxx_string!(mode = mode);
+        request_data_ability::dataability::DataAbilityOpenFile(&context.inner, &target_file, &mode)
     }
 
     fn check_upload_user_file(file_spec: &mut FileSpec, context: &Context) -> Result<(), i32> {
-        let fd = Self::data_ability_open_file(context, file_spec.path.clone());
+        let fd = Self::data_ability_open_file(context, file_spec.path.clone(), "r");
         if fd < 0 {
             return Err(401);
         }
@@ -38,7 +38,7 @@ pub use client::RequestClient;
 mod listen;
 
 /// Re-export of the callback trait for request state monitoring.
-pub use listen::Callback;
+pub use listen::{Callback, NotifyDataRef, ProgressRef};
 
 // Import utility macros
 #[macro_use]
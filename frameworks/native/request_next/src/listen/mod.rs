@@ -12,7 +12,10 @@
 // limitations under the License.
 
 mod observe;
+mod registry;
 mod ser;
 mod uds;
+mod view;
 
 pub use observe::{Callback, Observer};
+pub use view::{NotifyDataRef, ProgressRef};
@@ -19,19 +19,20 @@
 //! interface for handling these events.
 
 // Standard library imports
-use std::collections::HashMap;
 use std::fs::File;
 use std::sync::{Arc, Mutex};
 
 // External dependencies
 use request_core::config::{Action, Version};
-use request_core::info::{Faults, Progress, Response, SubscribeType, TaskState, NotifyData};
+use request_core::info::{Faults, Progress, Response, SubscribeType, TaskState};
 use ylong_runtime::task::JoinHandle;
 use crate::client::RequestClient;
 use crate::file::FileManager;
 
 // Internal dependencies
+use crate::listen::registry::CallbackRegistry;
 use crate::listen::uds::{Message, UdsListener};
+use crate::listen::view::{NotifyDataRef, ProgressRef};
 
 /// Manages callbacks and dispatches task events to registered observers.
 ///
@@ -40,7 +41,7 @@ use crate::listen::uds::{Message, UdsListener};
 /// they are dispatched to the appropriate callback based on the task ID and event type.
 pub struct Observer {
     /// Registry mapping task IDs to their corresponding callback implementations
-    callbacks: Arc<Mutex<HashMap<i64, Arc<dyn Callback + Send + Sync + 'static>>>>,
+    callbacks: Arc<CallbackRegistry>,
     /// Handle to the background task listening for events
     listener: Mutex<Option<JoinHandle<()>>>,
 }
@@ -57,13 +58,14 @@ pub struct Observer {
 /// ```rust
 /// use request_core::info::{Progress, Response};
 /// use request_next::listen::observe::Callback;
+/// use request_next::ProgressRef;
 /// use std::sync::Arc;
 ///
 /// // Custom callback implementation that logs download progress
 /// struct ProgressLogger;
 ///
 /// impl Callback for ProgressLogger {
-///     fn on_progress(&self, progress: &Progress) {
+///     fn on_progress(&self, progress: &ProgressRef<'_>) {
 ///         println!("Download progress: {} bytes downloaded of {} total",
 ///                  progress.download_size, progress.total_size);
 ///     }
@@ -85,9 +87,12 @@ pub struct Observer {
 pub trait Callback {
     /// Called when download progress is updated.
     ///
+    /// The progress is borrowed from the received message, call
+    /// [`ProgressRef::to_progress`] to keep it.
+    ///
     /// # Parameters
     /// - `progress`: Current progress information including bytes downloaded and total size
-    fn on_progress(&self, progress: &Progress) {}
+    fn on_progress(&self, progress: &ProgressRef<'_>) {}
 
     /// Called when a download completes successfully.
     ///
@@ -147,7 +152,7 @@ impl Observer {
     /// ```
     pub fn new() -> Self {
         Observer {
-            callbacks: Arc::new(Mutex::new(HashMap::new())),
+            callbacks: Arc::new(CallbackRegistry::new()),
             listener: Mutex::new(None),
         }
     }
@@ -184,96 +189,25 @@ impl Observer {
         let handle = ylong_runtime::spawn(async move {
             loop {
                 match listener.recv().await {
-                    Ok(mut message) => match &mut message {
+                    Ok(message) => match &message {
                         Message::HttpResponse(response) => {
                             // Convert task_id from string to i64 for lookup
                             let task_id = response.task_id.parse().unwrap();
-                            if let Some(callback) = callbacks.lock().unwrap().get(&task_id) {
+                            if let Some(callback) = callbacks.get(task_id) {
                                 callback.on_response(&response);
                             }
                         }
                         Message::NotifyData(data) => {
                             let task_id = data.task_id as i64;
-                            Observer::process_header_receive(data);
-                            let mut progress = &data.progress;
 
                             // Find the appropriate callback for the task
-                            if let Some(callback) = callbacks.lock().unwrap().get(&task_id) {
-                                // Dispatch to the appropriate callback method based on event type
-                                match data.version {
-                                    Version::API10 => match data.subscribe_type {
-                                        SubscribeType::Progress => {
-                                            callback.on_progress(&progress);
-                                        }
-                                        SubscribeType::Completed => {
-                                            callback.on_completed(&progress);
-                                        }
-                                        SubscribeType::Failed => {
-                                            callback.on_failed(
-                                                &progress,
-                                                data.task_states[0].response_code as i32,
-                                            );
-                                        }
-                                        SubscribeType::Pause => {
-                                            callback.on_pause(&progress);
-                                        }
-                                        SubscribeType::Resume => {
-                                            callback.on_resume(&progress);
-                                        }
-                                        SubscribeType::Remove => {
-                                            callback.on_remove(&progress);
-                                        }
-                                        _ => {}
-                                    },
-                                    Version::API9 => match data.action {
-                                        Action::Download => match data.subscribe_type {
-                                            SubscribeType::Completed => {
-                                                callback.on_completed(&progress);
-                                            }
-                                            SubscribeType::Pause => {
-                                                callback.on_pause(&progress);
-                                            }
-                                            SubscribeType::Remove => {
-                                                callback.on_remove(&progress);
-                                            }
-                                            SubscribeType::Failed => {
-                                                callback.on_failed(
-                                                    &progress,
-                                                    data.task_states[0].response_code as i32,
-                                                );
-                                            }
-                                            SubscribeType::Progress => {
-                                                callback.on_progress(&progress);
-                                            }
-                                            _ => {
-                                                error!("bad subscribeType ");
-                                            }
-                                        },
-                                        Action::Upload => match data.subscribe_type {
-                                            SubscribeType::Progress => {
-                                                callback.on_progress(&progress);
-                                            }
-                                            SubscribeType::Completed => {
-                                                callback.on_complete_upload(data.task_states.clone());
-                                            }
-                                            SubscribeType::Failed => {
-                                                callback.on_fail_upload(data.task_states.clone());
-                                            }
-                                            SubscribeType::HeaderReceive => {
-                                                callback.on_header_receive(&progress);
-                                            }
-                                            _ => {
-                                                error!("bad subscribeType ");
-                                            }
-                                        },
-                                    },
-                                }
-
+                            if let Some(callback) = callbacks.get(task_id) {
+                                Observer::dispatch_notify(callback.as_ref(), data);
                             }
                         }
                         Message::Faults(faultOccur) => {
                             let task_id = faultOccur.task_id as i64;
-                            if let Some(callback) = callbacks.lock().unwrap().get(&task_id) {
+                            if let Some(callback) = callbacks.get(task_id) {
                                 callback.on_fault(faultOccur.faults);
                             }
                         }
@@ -301,14 +235,14 @@ impl Observer {
     /// # Examples
     ///
     /// ```rust
-    /// use request_core::info::{Progress, Response};
+    /// use request_next::ProgressRef;
     /// use request_next::listen::observe::{Callback, Observer};
     /// use std::sync::Arc;
     ///
     /// struct SimpleCallback;
     ///
     /// impl Callback for SimpleCallback {
-    ///     fn on_progress(&self, progress: &Progress) {
+    ///     fn on_progress(&self, progress: &ProgressRef<'_>) {
     ///         println!("Progress: {}/{} bytes", progress.download_size, progress.total_size);
     ///     }
     /// }
@@ -325,7 +259,7 @@ impl Observer {
         task_id: i64,
         callback: Arc<dyn Callback + Send + Sync + 'static>,
     ) {
-        self.callbacks.lock().unwrap().insert(task_id, callback);
+        self.callbacks.insert(task_id, callback);
     }
 
     /// Unregisters a callback for a specific task.
@@ -348,31 +282,104 @@ impl Observer {
     /// observer.unregister_callback(task_id);
     /// ```
     pub fn unregister_callback(&self, task_id: i64) {
-        self.callbacks.lock().unwrap().remove(&task_id);
+        self.callbacks.remove(task_id);
     }
 
-    pub fn process_header_receive(notify_data: &mut NotifyData) {
-        let mut index = notify_data.progress.index as usize;
-        let mut file_path = String::new();
-        let mut len = 0;
-        let item = RequestClient::get_instance().task_manager.get_by_id(&(notify_data.task_id as i64));
+    /// Dispatches a notification to the callback method of its event type.
+    ///
+    /// Only progress notifications are passed as borrowed views, the rarer events
+    /// get their progress copied, with the body bytes read for header receive.
+    fn dispatch_notify(callback: &(dyn Callback + Send + Sync), data: &NotifyDataRef<'_>) {
+        let progress = || data.progress.to_progress();
+        let response_code = || data.first_response_code().unwrap_or_default() as i32;
+        match data.version {
+            Version::API10 => match data.subscribe_type {
+                SubscribeType::Progress => {
+                    callback.on_progress(&data.progress);
+                }
+                SubscribeType::Completed => {
+                    callback.on_completed(&progress());
+                }
+                SubscribeType::Failed => {
+                    callback.on_failed(&progress(), response_code());
+                }
+                SubscribeType::Pause => {
+                    callback.on_pause(&progress());
+                }
+                SubscribeType::Resume => {
+                    callback.on_resume(&progress());
+                }
+                SubscribeType::Remove => {
+                    callback.on_remove(&progress());
+                }
+                _ => {}
+            },
+            Version::API9 => match data.action {
+                Action::Download => match data.subscribe_type {
+                    SubscribeType::Completed => {
+                        callback.on_completed(&progress());
+                    }
+                    SubscribeType::Pause => {
+                        callback.on_pause(&progress());
+                    }
+                    SubscribeType::Remove => {
+                        callback.on_remove(&progress());
+                    }
+                    SubscribeType::Failed => {
+                        callback.on_failed(&progress(), response_code());
+                    }
+                    SubscribeType::Progress => {
+                        callback.on_progress(&data.progress);
+                    }
+                    _ => {
+                        error!("bad subscribeType ");
+                    }
+                },
+                Action::Upload => match data.subscribe_type {
+                    SubscribeType::Progress => {
+                        callback.on_progress(&data.progress);
+                    }
+                    SubscribeType::Completed => {
+                        callback.on_complete_upload(data.task_states());
+                    }
+                    SubscribeType::Failed => {
+                        callback.on_fail_upload(data.task_states());
+                    }
+                    SubscribeType::HeaderReceive => {
+                        let mut progress = progress();
+                        progress.body_bytes =
+                            Observer::read_body_bytes(data.task_id, progress.index);
+                        callback.on_header_receive(&progress);
+                    }
+                    _ => {
+                        error!("bad subscribeType ");
+                    }
+                },
+            },
+        }
+    }
 
-        if item.is_none() {
+    /// Reads the response body the service saved for the file at `index` of a task.
+    fn read_body_bytes(task_id: u32, index: u32) -> Vec<u8> {
+        let mut index = index as usize;
+        let item = RequestClient::get_instance()
+            .task_manager
+            .get_by_id(&(task_id as i64));
+
+        let Some(item) = item else {
             error!("Task ID not found");
-            return;
-        }
+            return Vec::new();
+        };
 
-        let config = &item.unwrap().config;
+        let config = &item.config;
         if config.common_data.multipart {
             index = 0;
         }
-        len = config.body_file_paths.len();
-        if index >= len {
-            return;
-        }
-        file_path = config.body_file_paths[index].clone();
+        let Some(file_path) = config.body_file_paths.get(index) else {
+            return Vec::new();
+        };
 
-        notify_data.progress.body_bytes = FileManager::read_bytes_from_file(&file_path).unwrap_or_default();
         // Waiting for "complete" to read and delete.
+        FileManager::read_bytes_from_file(file_path).unwrap_or_default()
     }
 }
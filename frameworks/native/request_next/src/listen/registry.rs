@@ -0,0 +1,73 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Registry of the callbacks of the tasks.
+//!
+//! The listener looks up a callback for every message received while the
+//! application registers and unregisters tasks from its own threads. The
+//! registry is split into shards by task ID, so those only contend when they
+//! touch the same shard, and lookups take a read lock.
+
+// Standard library imports
+use std::collections::HashMap;
+use std::sync::{Arc, RwLock};
+
+// Local dependencies
+use crate::listen::observe::Callback;
+
+/// Number of shards of the registry.
+const REGISTRY_SHARDS: usize = 16;
+
+/// Callback shared between the registry and the dispatch of a message.
+pub(crate) type SharedCallback = Arc<dyn Callback + Send + Sync + 'static>;
+
+/// Callbacks of the tasks, sharded by task ID.
+pub(crate) struct CallbackRegistry {
+    /// Shards mapping task IDs to their callbacks
+    shards: [RwLock<HashMap<i64, SharedCallback>>; REGISTRY_SHARDS],
+}
+
+impl CallbackRegistry {
+    /// Creates an empty registry.
+    pub(crate) fn new() -> Self {
+        Self {
+            shards: std::array::from_fn(|_| RwLock::new(HashMap::new())),
+        }
+    }
+
+    /// Returns the shard holding the callback of `task_id`.
+    fn shard(&self, task_id: i64) -> &RwLock<HashMap<i64, SharedCallback>> {
+        &self.shards[task_id.rem_euclid(REGISTRY_SHARDS as i64) as usize]
+    }
+
+    /// Registers the callback of a task, replacing any previous one.
+    pub(crate) fn insert(&self, task_id: i64, callback: SharedCallback) {
+        self.shard(task_id)
+            .write()
+            .unwrap()
+            .insert(task_id, callback);
+    }
+
+    /// Unregisters the callback of a task.
+    pub(crate) fn remove(&self, task_id: i64) {
+        self.shard(task_id).write().unwrap().remove(&task_id);
+    }
+
+    /// Returns the callback of a task.
+    ///
+    /// The callback is cloned out of its shard, so it runs with no lock held and
+    /// may register or unregister callbacks itself.
+    pub(crate) fn get(&self, task_id: i64) -> Option<SharedCallback> {
+        self.shard(task_id).read().unwrap().get(&task_id).cloned()
+    }
+}
@@ -88,6 +88,37 @@ impl UdsSer<'_> {
     }
 }
 
+impl<'a> UdsSer<'a> {
+    /// Takes the next `len` bytes without copying them.
+    ///
+    /// # Returns
+    /// The bytes borrowed from the buffer, or `None` if fewer than `len` are left
+    pub fn take(&mut self, len: usize) -> Option<&'a [u8]> {
+        if self.inner.len() < len {
+            return None;
+        }
+        let (head, tail) = self.inner.split_at(len);
+        self.inner = tail;
+        Some(head)
+    }
+
+    /// Takes the bytes of the next NUL terminated string, without the terminator.
+    ///
+    /// # Returns
+    /// The bytes borrowed from the buffer, or `None` if the string is not terminated
+    pub fn take_str(&mut self) -> Option<&'a [u8]> {
+        let end = self.inner.iter().position(|b| *b == b'\0')?;
+        let s = &self.inner[..end];
+        self.inner = &self.inner[end + 1..];
+        Some(s)
+    }
+
+    /// Returns the bytes not read yet, without consuming them.
+    pub fn remaining(&self) -> &'a [u8] {
+        self.inner
+    }
+}
+
 /// Trait for types that can be deserialized from a `UdsSer` buffer.
 ///
 /// Despite its name, this trait defines the deserialization behavior for types,
@@ -351,7 +382,7 @@ impl Serialize for Vec<TaskState> {
 /// Deserializes a `Progress` from the binary stream.
 ///
 /// Reads all fields of a Progress sequentially: state, index, processed, total_processed,
-/// sizes, and extras.
+/// sizes, extras, speed and eta.
 impl Serialize for Progress {
     fn read(ser: &mut UdsSer) -> Self {
         let state: State = ser.read();
@@ -361,6 +392,8 @@ impl Serialize for Progress {
         let sizes: Vec<i64> = ser.read();
         let extras: HashMap<String, String> = ser.read();
         // let body_bytes: Vec<u8> = ser.read();
+        let speed: u64 = ser.read();
+        let eta: i64 = ser.read();
 
         Progress {
             state,
@@ -370,6 +403,8 @@ impl Serialize for Progress {
             sizes,
             extras,
             body_bytes: Vec::new(),
+            speed,
+            eta,
         }
     }
 }
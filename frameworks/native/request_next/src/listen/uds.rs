@@ -18,16 +18,19 @@
 //! provides a structured interface for accessing different types of messages.
 
 // Standard library imports
+use std::collections::VecDeque;
 use std::fs::File;
 use std::io;
+use std::ops::Range;
 use std::os::fd::{FromRawFd, IntoRawFd};
 use std::os::unix;
 
-use request_core::info::{FaultOccur, Faults, NotifyData, Response};
+use request_core::info::{FaultOccur, Response};
 use ylong_runtime::net::UnixDatagram;
 
 // Local dependencies
 use crate::listen::ser::UdsSer;
+use crate::listen::view::NotifyDataRef;
 
 /// Magic number for message validation.
 ///
@@ -46,6 +49,17 @@ const HTTP_RESPONSE: i16 = 0;
 const NOTIFY_DATA: i16 = 1;
 const FAULTS: i16 = 2;
 
+/// Message type identifier for batches.
+///
+/// Indicates that the message body is a sequence of complete messages, each with its own header.
+const BATCH: i16 = 4;
+
+/// Size of the common message header in bytes.
+const HEADER_SIZE: usize = 12;
+
+/// Size of the receive buffer, the largest datagram the service sends.
+const BUF_SIZE: usize = 4096;
+
 /// Listener for Unix Domain Socket messages.
 ///
 /// Provides methods to receive and process messages from the download service.
@@ -56,6 +70,12 @@ pub struct UdsListener {
 
     /// Tracks the expected message ID for sequential validation
     message_id: i32,
+
+    /// Receive buffer, the messages returned by `recv` borrow from it
+    buf: Box<[u8]>,
+
+    /// Body ranges in `buf` and types of the checked messages not yet returned
+    pending: VecDeque<(Range<usize>, i16)>,
 }
 
 impl UdsListener {
@@ -83,6 +103,8 @@ impl UdsListener {
         Self {
             socket,
             message_id: 1, // Start with message ID 1
+            buf: vec![0u8; BUF_SIZE].into_boxed_slice(),
+            pending: VecDeque::new(),
         }
     }
 
@@ -93,7 +115,7 @@ impl UdsListener {
     ///
     /// # Returns
     /// A `Result` containing either:
-    /// - `Ok(Message)` with the deserialized message
+    /// - `Ok(Message)` with the deserialized message, borrowing from the listener until the next call
     /// - `Err(io::Error)` if there was an error receiving or processing the message
     ///
     /// # Errors
@@ -124,17 +146,28 @@ impl UdsListener {
     ///     Ok(())
     /// }
     /// ```
-    pub async fn recv(&mut self) -> Result<Message, io::Error> {
-        // Buffer for receiving data
-        let mut buf = [0u8; 4096];
+    pub async fn recv(&mut self) -> Result<Message<'_>, io::Error> {
+        // Messages left over from the last batch are returned first
+        if self.pending.is_empty() {
+            self.recv_datagram().await?;
+        }
+        let (range, msg_type) = self
+            .pending
+            .pop_front()
+            .ok_or(io::Error::new(io::ErrorKind::InvalidData, "Empty batch"))?;
+        decode(&self.buf[range], msg_type)
+    }
+
+    /// Receives a datagram into the buffer and queues the messages it holds.
+    async fn recv_datagram(&mut self) -> Result<(), io::Error> {
         // Receive data from socket
-        let size = self.socket.recv(&mut buf).await?;
+        let size = self.socket.recv(&mut self.buf[..]).await?;
         // Send acknowledgment with received size
         let ret = (size as u32).to_ne_bytes();
         self.socket.send(&ret).await?;
 
         // Create deserializer with received data
-        let mut uds = UdsSer::new(&buf[..size]);
+        let mut uds = UdsSer::new(&self.buf[..size]);
 
         // Variable to store message type
         let mut msg_type: i16 = 0;
@@ -147,38 +180,79 @@ impl UdsListener {
             ));
         }
 
+        // A batch reuses the ID of its first record, which is checked per record
+        if msg_type == BATCH {
+            self.queue_batch(size);
+            return Ok(());
+        }
+
         // Increment message ID for next expected message
         self.message_id += 1;
 
         info!("Message ID: {}, Type: {}", self.message_id, msg_type);
+        self.pending.push_back((HEADER_SIZE..size, msg_type));
+        Ok(())
+    }
 
-        // Deserialize based on message type
-        if msg_type == HTTP_RESPONSE {
-            let response: Response = uds.read();
-            Ok(Message::HttpResponse(response))
-        } else if msg_type == NOTIFY_DATA {
-            let notify_data: NotifyData = uds.read();
-            Ok(Message::NotifyData(notify_data))
-        } else if msg_type == FAULTS {
-            let fault_occur: FaultOccur = uds.read();
-            Ok(Message::Faults(fault_occur))
-        } else {
-            Err(io::Error::new(
+    /// Checks every record of a batch of `size` bytes and queues their bodies,
+    /// which are decoded when returned.
+    fn queue_batch(&mut self, size: usize) {
+        let mut start = HEADER_SIZE;
+        while size - start >= HEADER_SIZE {
+            let body = &self.buf[start..size];
+            let record_size = u16::from_ne_bytes([body[10], body[11]]) as usize;
+            if record_size < HEADER_SIZE || record_size > body.len() {
+                error!("Invalid batch record size: {}", record_size);
+                break;
+            }
+            let mut uds = UdsSer::new(&body[..record_size]);
+            let mut msg_type: i16 = 0;
+            if !message_check(&mut uds, record_size as i16, self.message_id, &mut msg_type) {
+                break;
+            }
+            self.message_id += 1;
+            self.pending
+                .push_back((start + HEADER_SIZE..start + record_size, msg_type));
+            start += record_size;
+        }
+    }
+}
+
+/// Deserializes a message body according to its message type.
+///
+/// Notifications are only viewed, their variable length parts stay in `body`.
+fn decode(body: &[u8], msg_type: i16) -> Result<Message<'_>, io::Error> {
+    let mut uds = UdsSer::new(body);
+    if msg_type == HTTP_RESPONSE {
+        let response: Response = uds.read();
+        Ok(Message::HttpResponse(response))
+    } else if msg_type == NOTIFY_DATA {
+        NotifyDataRef::parse(body)
+            .map(Message::NotifyData)
+            .ok_or(io::Error::new(
                 io::ErrorKind::InvalidData,
-                format!("Unknown message type: {}", msg_type),
+                "Truncated notify data",
             ))
-        }
+    } else if msg_type == FAULTS {
+        let fault_occur: FaultOccur = uds.read();
+        Ok(Message::Faults(fault_occur))
+    } else {
+        Err(io::Error::new(
+            io::ErrorKind::InvalidData,
+            format!("Unknown message type: {}", msg_type),
+        ))
     }
 }
 
 /// Enum representing the types of messages received from the download service.
 ///
 /// Provides a structured way to handle different message types with pattern matching.
-pub enum Message {
+pub enum Message<'a> {
     /// HTTP response message containing response data for a download task
     HttpResponse(Response),
-    /// Notification data message containing status updates for download tasks
-    NotifyData(NotifyData),
+    /// Notification data message containing status updates for download tasks,
+    /// borrowed from the receive buffer of the listener
+    NotifyData(NotifyDataRef<'a>),
     Faults(FaultOccur),
 }
 
@@ -0,0 +1,233 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Borrowed views of notification messages.
+//!
+//! Progress notifications are by far the most frequent messages of the socket.
+//! The views here read their fixed fields when the message is received and keep
+//! the variable length parts as slices of the receive buffer, decoding them only
+//! when a callback asks for them.
+
+// Standard library imports
+use std::borrow::Cow;
+use std::collections::HashMap;
+
+// External dependencies
+use request_core::config::{Action, Version};
+use request_core::info::{Progress, State, SubscribeType, TaskState};
+
+// Local dependencies
+use crate::listen::ser::UdsSer;
+
+/// Size in bytes of every file size of a progress.
+const SIZE_LEN: usize = 8;
+
+fn read_u32(ser: &mut UdsSer<'_>) -> Option<u32> {
+    let bytes = ser.take(4)?;
+    Some(u32::from_ne_bytes([bytes[0], bytes[1], bytes[2], bytes[3]]))
+}
+
+fn read_u64(ser: &mut UdsSer<'_>) -> Option<u64> {
+    let mut bytes = [0u8; 8];
+    bytes.copy_from_slice(ser.take(8)?);
+    Some(u64::from_ne_bytes(bytes))
+}
+
+fn text(bytes: &[u8]) -> Cow<'_, str> {
+    String::from_utf8_lossy(bytes)
+}
+
+/// Progress of a task, borrowed from the message it was received in.
+///
+/// Holds the same information as [`Progress`] without the body bytes, which are
+/// only read for header receive notifications.
+pub struct ProgressRef<'a> {
+    /// Current state of the task
+    pub state: State,
+    /// Index of the file being transferred
+    pub index: u32,
+    /// Bytes processed of the current file
+    pub processed: u64,
+    /// Bytes processed of all the files
+    pub total_processed: u64,
+    /// Sizes of the files, each a native endian `i64`
+    sizes: &'a [u8],
+    /// Number of extras entries
+    extras_len: u32,
+    /// Extras entries, each a pair of NUL terminated strings
+    extras: &'a [u8],
+    /// Average speed of the running task in bytes per second, 0 otherwise
+    pub speed: u64,
+    /// Estimated seconds left of the running task, -1 if unknown
+    pub eta: i64,
+}
+
+impl<'a> ProgressRef<'a> {
+    fn parse(ser: &mut UdsSer<'a>) -> Option<Self> {
+        let state = State::from(read_u32(ser)?);
+        let index = read_u32(ser)?;
+        let processed = read_u64(ser)?;
+        let total_processed = read_u64(ser)?;
+        let sizes_len = read_u32(ser)? as usize;
+        let sizes = ser.take(sizes_len.checked_mul(SIZE_LEN)?)?;
+
+        // Extras are only skipped here, to know where the progress ends.
+        let extras_len = read_u32(ser)?;
+        let start = ser.remaining();
+        for _ in 0..extras_len {
+            ser.take_str()?;
+            ser.take_str()?;
+        }
+        let extras = &start[..start.len() - ser.remaining().len()];
+        let speed = read_u64(ser)?;
+        let eta = read_u64(ser)? as i64;
+        Some(ProgressRef {
+            state,
+            index,
+            processed,
+            total_processed,
+            sizes,
+            extras_len,
+            extras,
+            speed,
+            eta,
+        })
+    }
+
+    /// Returns the number of files of the task.
+    pub fn size_count(&self) -> usize {
+        self.sizes.len() / SIZE_LEN
+    }
+
+    /// Returns the size of the file at `index`, `None` if there is no such file.
+    pub fn size(&self, index: usize) -> Option<i64> {
+        let start = index.checked_mul(SIZE_LEN)?;
+        let mut bytes = [0u8; SIZE_LEN];
+        bytes.copy_from_slice(self.sizes.get(start..start + SIZE_LEN)?);
+        Some(i64::from_ne_bytes(bytes))
+    }
+
+    /// Returns the sizes of all the files, in order.
+    pub fn sizes(&self) -> impl Iterator<Item = i64> + 'a {
+        self.sizes.chunks_exact(SIZE_LEN).map(|chunk| {
+            let mut bytes = [0u8; SIZE_LEN];
+            bytes.copy_from_slice(chunk);
+            i64::from_ne_bytes(bytes)
+        })
+    }
+
+    /// Returns the extras entries, borrowed unless they are not valid UTF-8.
+    pub fn extras(&self) -> impl Iterator<Item = (Cow<'a, str>, Cow<'a, str>)> + 'a {
+        let mut ser = UdsSer::new(self.extras);
+        (0..self.extras_len).map_while(move |_| {
+            let key = ser.take_str()?;
+            let value = ser.take_str()?;
+            Some((text(key), text(value)))
+        })
+    }
+
+    /// Copies the progress out of the receive buffer, with empty body bytes.
+    pub fn to_progress(&self) -> Progress {
+        Progress {
+            state: self.state.clone(),
+            index: self.index,
+            processed: self.processed,
+            total_processed: self.total_processed,
+            sizes: self.sizes().collect(),
+            extras: self
+                .extras()
+                .map(|(key, value)| (key.into_owned(), value.into_owned()))
+                .collect::<HashMap<_, _>>(),
+            body_bytes: Vec::new(),
+            speed: self.speed,
+            eta: self.eta,
+        }
+    }
+}
+
+/// Notification about a task, borrowed from the message it was received in.
+///
+/// The task states are kept undecoded, only upload completion and failures use
+/// them.
+pub struct NotifyDataRef<'a> {
+    /// Kind of event notified
+    pub subscribe_type: SubscribeType,
+    /// ID of the task the notification is about
+    pub task_id: u32,
+    /// Progress of the task when notified
+    pub progress: ProgressRef<'a>,
+    /// Whether the task downloads or uploads
+    pub action: Action,
+    /// API version the task was created with
+    pub version: Version,
+    /// Number of task states
+    task_states_len: u32,
+    /// Task states, each a path, a response code and a message
+    task_states: &'a [u8],
+}
+
+impl<'a> NotifyDataRef<'a> {
+    /// Views a notification message body, `None` if it is truncated.
+    pub(crate) fn parse(body: &'a [u8]) -> Option<Self> {
+        let mut ser = UdsSer::new(body);
+        let subscribe_type = SubscribeType::from(read_u32(&mut ser)?);
+        let task_id = read_u32(&mut ser)?;
+        let progress = ProgressRef::parse(&mut ser)?;
+        let action = Action::from(read_u32(&mut ser)?);
+        let version = Version::from(read_u32(&mut ser)?);
+        let task_states_len = read_u32(&mut ser)?;
+        Some(NotifyDataRef {
+            subscribe_type,
+            task_id,
+            progress,
+            action,
+            version,
+            task_states_len,
+            task_states: ser.remaining(),
+        })
+    }
+
+    /// Returns the response code of the first task state, the one failure
+    /// notifications report.
+    pub fn first_response_code(&self) -> Option<u32> {
+        if self.task_states_len == 0 {
+            return None;
+        }
+        let mut ser = UdsSer::new(self.task_states);
+        ser.take_str()?;
+        read_u32(&mut ser)
+    }
+
+    /// Decodes the task states, stopping at the first truncated one.
+    pub fn task_states(&self) -> Vec<TaskState> {
+        let mut ser = UdsSer::new(self.task_states);
+        let mut task_states = Vec::with_capacity(self.task_states_len.min(64) as usize);
+        for _ in 0..self.task_states_len {
+            let Some(path) = ser.take_str() else {
+                break;
+            };
+            let Some(response_code) = read_u32(&mut ser) else {
+                break;
+            };
+            let Some(message) = ser.take_str() else {
+                break;
+            };
+            task_states.push(TaskState {
+                path: text(path).into_owned(),
+                response_code,
+                message: text(message).into_owned(),
+            });
+        }
+        task_states
+    }
+}
@@ -13,6 +13,7 @@
 
 use cxx::let_cxx_string;
 use request_core::config::TaskConfig;
+use request_utils::url::UrlView;
 
 use crate::verify::ConfigVerifier;
 
@@ -46,26 +47,6 @@ impl ConfigVerifier for UrlVerifier {
     }
 }
 
-pub(crate) fn get_hostname_from_url(url: &str) -> String {
-    if url.is_empty() {
-        return String::new();
-    }
-
-    let delimiter = "://";
-    let temp_url = url.replace('\\', "/");
-
-    let mut pos_start = match temp_url.find(delimiter) {
-        Some(pos) => pos + delimiter.len(),
-        None => 0,
-    };
-
-    if let Some(not_slash) = temp_url[pos_start..].find(|c: char| c != '/') {
-        pos_start += not_slash;
-    }
-
-    if let Some(end) = temp_url[pos_start..].find(|c| c == ':' || c == '/' || c == '?') {
-        temp_url[pos_start..pos_start + end].to_string()
-    } else {
-        temp_url[pos_start..].to_string()
-    }
+pub(crate) fn get_hostname_from_url(url: &str) -> &str {
+    UrlView::parse(url).host
 }
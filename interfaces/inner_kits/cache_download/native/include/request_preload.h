@@ -34,6 +34,7 @@ template<typename T> class Slice;
 namespace OHOS::Request {
 struct RustData;
 struct TaskHandle;
+struct PreloadBatch;
 struct CacheDownloadService;
 struct CacheDownloadError;
 struct RustDownloadInfo;
@@ -55,11 +56,47 @@ enum SslType {
 enum class CacheStrategy : uint32_t {
     FORCE = 0,
     LAZY = 1,
+    STALE_WHILE_REVALIDATE = 2,
+};
+
+enum class RamCachePolicy : uint32_t {
+    LRU = 0,
+    TINY_LFU = 1,
+    GREEDY_DUAL_SIZE = 2,
+};
+
+struct RamCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    // Bytes counted against the RAM cache size, bodies waiting to be written
+    // to the file cache included.
+    uint64_t usedBytes = 0;
+    uint64_t totalBytes = 0;
+    // Bodies waiting to be written to the file cache.
+    uint64_t backupEntries = 0;
+    uint64_t backupBytes = 0;
+};
+
+struct TimingPercentiles {
+    double p50 = 0;
+    double p95 = 0;
+    double p99 = 0;
+};
+
+struct OriginTimingStats {
+    std::string origin;
+    uint64_t count = 0;
+    TimingPercentiles dns;
+    TimingPercentiles connect;
+    TimingPercentiles tls;
+    TimingPercentiles ttfb;
+    TimingPercentiles total;
 };
 
 template<typename T> class Slice {
 public:
     Slice(std::unique_ptr<rust::Slice<T>> &&slice);
+    Slice(Slice &&) noexcept;
     ~Slice();
     T *data() const noexcept;
     std::size_t size() const noexcept;
@@ -79,6 +116,7 @@ public:
     Data &operator=(Data &&) &noexcept;
 
     Slice<const uint8_t> bytes() const;
+    std::vector<Slice<const uint8_t>> chunks() const;
     rust::Slice<const uint8_t> rustSlice() const;
 
 private:
@@ -115,6 +153,9 @@ public:
     int64_t resource_size() const;
     std::string server_addr() const;
     std::vector<std::string> dns_servers() const;
+    bool connection_reused() const;
+    uint64_t pool_hits() const;
+    uint64_t pool_misses() const;
 
 private:
     RustDownloadInfo *rust_info_;
@@ -130,6 +171,9 @@ public:
     int32_t GetCode() const;
     std::string GetMessage() const;
     ErrorKind GetErrorKind() const;
+    // Whether the error is a recent failure of the URL reported again
+    // without downloading.
+    bool IsCached() const;
     std::shared_ptr<CppDownloadInfo> GetDownloadInfo() const;
 
 private:
@@ -142,6 +186,7 @@ struct PreloadCallback {
     std::function<void(const PreloadError &, const std::string &TaskId)> OnFail;
     std::function<void()> OnCancel;
     std::function<void(uint64_t current, uint64_t total)> OnProgress;
+    std::function<void(const uint8_t *data, size_t offset, size_t len)> OnDataChunk;
 };
 
 class PreloadHandle {
@@ -155,6 +200,7 @@ public:
     std::string GetTaskId();
     bool IsFinish();
     PreloadState GetState();
+    void SetPriority(int32_t priority);
 
 private:
     TaskHandle *handle_;
@@ -164,6 +210,14 @@ struct PreloadOptions {
     std::vector<std::tuple<std::string, std::string>> headers;
     SslType sslType;
     std::string caPath;
+    int32_t priority = 0;
+    // Ask for a compressed body and cache it decoded.
+    bool compression = false;
+    // Look the URL up in, and publish its body to, the cache shared with
+    // other applications. Ignored for requests with headers.
+    bool shared = false;
+    // Groups the preload with the others of the same tag, none if empty.
+    std::string tag;
 };
 
 class Preload {
@@ -174,10 +228,28 @@ public:
     void Cancel(std::string const &url);
     void Remove(std::string const &url);
     bool Contains(std::string const &url);
+    // Cancels, reprioritizes or removes the preloads loaded with a tag.
+    void CancelTag(std::string const &tag);
+    void SetTagPriority(std::string const &tag, int32_t priority);
+    void RemoveTag(std::string const &tag);
 
     void SetRamCacheSize(uint64_t size);
+    void SetRamCacheEntryMaxSize(uint64_t size);
+    void SetRamCachePolicy(RamCachePolicy policy);
+    RamCacheStats GetRamCacheStats();
     void SetFileCacheSize(uint64_t size);
+    // Sizes the file cache to percent of the free space of its disk, from
+    // minSize to maxSize bytes, until SetFileCacheSize is called again.
+    void SetAdaptiveFileCacheSize(uint8_t percent, uint64_t minSize, uint64_t maxSize);
+    // Checks the restored file caches against their checksums in the background,
+    // reading at most bytesPerSec bytes per second, 0 for no limit.
+    void VerifyFileCaches(uint64_t bytesPerSec);
     void SetDownloadInfoListSize(uint16_t size);
+    void SetDownloadLimits(size_t maxRunning, size_t maxPerHost);
+    // Sets how long failures of a kind fail the loads of their URL again
+    // without downloading, 0 to always download. Remove forgets a failure.
+    void SetFailureCacheTime(ErrorKind kind, uint64_t seconds);
+    bool Prewarm(std::string const &origin);
     static void SetFileCachePath(const std::string &path);
 
     void ClearMemoryCache();
@@ -185,9 +257,19 @@ public:
 
     std::shared_ptr<PreloadHandle> load(std::string const &url, std::unique_ptr<PreloadCallback>,
         std::unique_ptr<PreloadOptions> options = nullptr, bool update = false);
+    std::shared_ptr<PreloadHandle> load(std::string const &url, std::unique_ptr<PreloadCallback>,
+        std::unique_ptr<PreloadOptions> options, CacheStrategy strategy);
+    std::vector<std::shared_ptr<PreloadHandle>> loadBatch(std::vector<std::string> const &urls,
+        std::vector<std::unique_ptr<PreloadCallback>> callbacks, std::unique_ptr<PreloadOptions> options = nullptr,
+        CacheStrategy strategy = CacheStrategy::FORCE);
+    std::shared_ptr<PreloadHandle> stream(std::string const &url, std::unique_ptr<PreloadCallback>);
 
     std::optional<Data> fetch(std::string const &url);
+    // Fetches length bytes of the cached data from offset, cut at its end,
+    // without loading the rest of it.
+    std::optional<Data> fetch(std::string const &url, uint64_t offset, uint64_t length);
     std::optional<CppDownloadInfo> GetDownloadInfo(std::string const &url);
+    std::vector<OriginTimingStats> GetTimingStats(uint64_t windowSecs);
 
 private:
     const CacheDownloadService *agent_;
@@ -16,6 +16,10 @@
 #ifndef OHOS_REQUEST_ACTION_H
 #define OHOS_REQUEST_ACTION_H
 
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+
 #include "constant.h"
 #include "context.h"
 #include "request_common.h"
@@ -40,7 +44,24 @@ public:
     int32_t Resume(const std::string &tid);
     int32_t SetMaxSpeed(const std::string &tid, const int64_t maxSpeed);
 
+    // Non-blocking forms of the calls above. The call is queued and the callback gets its result on an
+    // ffrt worker. Queued calls run one after another in the order they were made, so one thread can
+    // pipeline operations on its tasks without waiting for each reply.
+    using AsyncCallback = std::function<void(int32_t)>;
+    using CreateCallback = std::function<void(int32_t, const std::string &)>;
+    using InfoCallback = std::function<void(int32_t, const TaskInfo &)>;
+    void CreateAsync(TaskBuilder builder, CreateCallback callback);
+    void StartAsync(const std::string &tid, AsyncCallback callback);
+    void StopAsync(const std::string &tid, AsyncCallback callback);
+    void PauseAsync(const std::string &tid, AsyncCallback callback);
+    void ResumeAsync(const std::string &tid, AsyncCallback callback);
+    void RemoveAsync(const std::string &tid, AsyncCallback callback);
+    void ShowAsync(const std::string &tid, InfoCallback callback);
+    void TouchAsync(const std::string &tid, const std::string &token, InfoCallback callback);
+
     ExceptionErrorCode CreateTasks(std::vector<TaskBuilder> &builders, std::vector<TaskRet> &rets);
+    // Creates the tasks of the batch in one call, moving their configs instead of copying them.
+    ExceptionErrorCode CreateTasks(TaskBatchBuilder &&batch, std::vector<TaskRet> &rets);
     ExceptionErrorCode StartTasks(
         const std::vector<std::string> &tids, std::unordered_map<std::string, ExceptionErrorCode> &rets);
     ExceptionErrorCode StopTasks(
@@ -62,43 +83,53 @@ public:
         const std::vector<std::string> &tids, std::unordered_map<std::string, ExceptionErrorCode> &rets);
 
 private:
-    static bool CreateDirs(const std::vector<std::string> &pathDirs);
+    // Paths resolved while checking the configs of one create call, so files sharing directories look them up once.
+    struct PathCache {
+        std::shared_ptr<OHOS::AbilityRuntime::Context> context;
+        std::string baseDir;
+        std::string cacheDir;
+        // Normalized directories by the whole ones they were resolved from.
+        std::unordered_map<std::string, std::string> normalDirs;
+        // Directories and certificate copies known to exist.
+        std::unordered_set<std::string> existing;
+    };
+
+    void QueueAsync(
+        const std::string &tid, int32_t (RequestAction::*method)(const std::string &), AsyncCallback callback);
+    ExceptionErrorCode CreateBuiltTasks(
+        std::vector<std::pair<Config, ExceptionErrorCode>> &built, std::vector<TaskRet> &rets);
+    static bool CreateDirs(const std::string &dir, PathCache &cache);
     static bool FileToWhole(
         const std::shared_ptr<OHOS::AbilityRuntime::Context> &context, const Config &config, std::string &path);
-    static bool BaseToWhole(const std::shared_ptr<OHOS::AbilityRuntime::Context> &context, std::string &path);
-    static bool CacheToWhole(const std::shared_ptr<OHOS::AbilityRuntime::Context> &context, std::string &path);
-    static bool StandardizePath(
-        const std::shared_ptr<OHOS::AbilityRuntime::Context> &context, const Config &config, std::string &path);
+    static bool BaseToWhole(PathCache &cache, std::string &path);
+    static bool CacheToWhole(PathCache &cache, std::string &path);
+    static bool StandardizePath(PathCache &cache, const Config &config, std::string &path);
     static void StringSplit(const std::string &str, const char delim, std::vector<std::string> &elems);
     static bool PathVecToNormal(const std::vector<std::string> &in, std::vector<std::string> &out);
     static bool WholeToNormal(std::string &path, std::vector<std::string> &out);
-    static bool GetAppBaseDir(std::string &baseDir);
-    static bool CheckBelongAppBaseDir(const std::string &filepath, std::string &baseDir);
+    static bool GetAppBaseDir(PathCache &cache);
+    static bool GetAppCacheDir(PathCache &cache);
+    static bool CheckBelongAppBaseDir(const std::string &filepath, PathCache &cache);
     static bool FindAreaPath(const std::string &filepath);
-    static bool GetSandboxPath(const std::shared_ptr<OHOS::AbilityRuntime::Context> &context, const Config &config,
-        std::string &path, std::vector<std::string> &pathVec);
-    static bool CheckDownloadFilePath(const std::shared_ptr<OHOS::AbilityRuntime::Context> &context, Config &config);
+    static bool GetSandboxPath(PathCache &cache, const Config &config, std::string &path, std::string &dir);
+    static bool CheckDownloadFilePath(PathCache &cache, Config &config);
     static bool InterceptData(const std::string &str, const std::string &in, std::string &out);
     static void StandardizeFileSpec(FileSpec &file);
     static bool IsPathValid(const std::string &filePath);
-    static bool GetInternalPath(
-        const std::shared_ptr<OHOS::AbilityRuntime::Context> &context, const Config &config, std::string &path);
+    static bool GetInternalPath(PathCache &cache, const Config &config, std::string &path);
     static bool FindDir(const std::string &pathDir);
-    static ExceptionErrorCode GetFdDownload(const std::string &path, const Config &config);
-    static ExceptionErrorCode CheckDownloadFile(
-        const std::shared_ptr<OHOS::AbilityRuntime::Context> &context, Config &config);
+    static ExceptionErrorCode GetFdDownload(const std::string &path, const Config &config, int32_t &fd);
+    static ExceptionErrorCode CheckDownloadFile(PathCache &cache, Config &config);
     static bool IsUserFile(const std::string &path);
     static ExceptionErrorCode CheckUserFileSpec(const std::shared_ptr<OHOS::AbilityRuntime::Context> &context,
         const Config &config, FileSpec &file, bool isUpload);
     static bool CheckPathIsFile(const std::string &path);
-    static ExceptionErrorCode GetFdUpload(const std::string &path, const Config &config);
-    static ExceptionErrorCode CheckUploadFileSpec(
-        const std::shared_ptr<OHOS::AbilityRuntime::Context> &context, Config &config, FileSpec &file);
-    static ExceptionErrorCode CheckUploadFiles(
-        const std::shared_ptr<OHOS::AbilityRuntime::Context> &context, Config &config);
+    static ExceptionErrorCode GetFdUpload(const std::string &path, const Config &config, int32_t &fd);
+    static ExceptionErrorCode CheckUploadFileSpec(PathCache &cache, Config &config, FileSpec &file);
+    static ExceptionErrorCode CheckUploadFiles(PathCache &cache, Config &config);
     static ExceptionErrorCode CheckUploadBodyFiles(const std::string &filePath, Config &config);
-    static bool SetDirsPermission(std::vector<std::string> &dirs);
-    static ExceptionErrorCode CheckFilePath(Config &config);
+    static bool SetDirsPermission(std::vector<std::string> &dirs, PathCache &cache);
+    static ExceptionErrorCode CheckFilePath(Config &config, PathCache &cache);
     static void RemoveFile(const std::string &filePath);
     static void RemoveDirsPermission(const std::vector<std::string> &dirs);
     static bool ClearTaskTemp(const std::string &tid);
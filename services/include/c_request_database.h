@@ -17,6 +17,7 @@
 #define C_REQUEST_DATABASE_H
 
 #include <cstdint>
+#include <memory>
 #include <vector>
 
 #include "c_progress.h"
@@ -33,12 +34,19 @@
 
 namespace OHOS::Request {
 constexpr const char *DB_NAME = "/data/service/el1/public/database/request/request.db";
-constexpr int DATABASE_VERSION = 1;
+constexpr int DATABASE_VERSION = 4;
+// Store version that moved the progress columns into `request_task_progress`.
+constexpr int DATABASE_VERSION_PROGRESS_TABLE = 2;
+// Store version that added the scheduler and search indexes of `request_task`.
+constexpr int DATABASE_VERSION_TASK_INDEXES = 3;
+// Store version that added the keyword search index `request_task_search`.
+constexpr int DATABASE_VERSION_TASK_SEARCH = 4;
 constexpr const char *REQUEST_DATABASE_VERSION_4_1_RELEASE = "API11_4.1-release";
 constexpr const char *REQUEST_DATABASE_VERSION_5_0_RELEASE = "API12_5.0-release";
 constexpr const char *REQUEST_DATABASE_VERSION_5_1_RELEASE = "API16_5.1-release";
 constexpr const char *REQUEST_DATABASE_VERSION = "API20_6.0-release";
 constexpr const char *REQUEST_TASK_TABLE_NAME = "request_task";
+constexpr const char *REQUEST_TASK_PROGRESS_TABLE_NAME = "request_task_progress";
 constexpr int QUERY_ERR = -1;
 constexpr int QUERY_OK = 0;
 constexpr int WITHOUT_VERSION_TABLE = 40;
@@ -48,10 +56,15 @@ constexpr int API16_5_1_RELEASE = 51;
 constexpr int API20_6_0_RELEASE = 60;
 constexpr int INVALID_VERSION = -50;
 constexpr int CHECK_VERSION_FAILED = -1;
+// Rows handed out per `RequestResultSet` call.
+constexpr size_t QUERY_CHUNK_ROWS = 128;
 
 constexpr const char *CHECK_REQUEST_VERSION = "SELECT name FROM sqlite_master WHERE type='table' AND "
                                               "name='request_version'";
 
+constexpr const char *CHECK_REQUEST_TASK = "SELECT name FROM sqlite_master WHERE type='table' AND "
+                                           "name='request_task'";
+
 constexpr const char *CREATE_REQUEST_VERSION_TABLE = "CREATE TABLE IF NOT EXISTS request_version "
                                                      "(id INTEGER PRIMARY KEY AUTOINCREMENT, "
                                                      "version TEXT, "
@@ -103,6 +116,33 @@ constexpr const char *CREATE_REQUEST_TASK_TABLE = "CREATE TABLE IF NOT EXISTS re
                                                   "body_file_names BLOB, "
                                                   "certs_paths BLOB)";
 
+// Columns rewritten by every progress update live in this narrow table, so that
+// those updates do not have to rewrite the wide `request_task` row. The same
+// columns in `request_task` are only kept for older readers and are not updated.
+constexpr const char *CREATE_REQUEST_TASK_PROGRESS_TABLE = "CREATE TABLE IF NOT EXISTS request_task_progress "
+                                                           "(task_id INTEGER PRIMARY KEY, "
+                                                           "mtime INTEGER, "
+                                                           "tries INTEGER, "
+                                                           "mime_type TEXT, "
+                                                           "idx INTEGER, "
+                                                           "total_processed INTEGER, "
+                                                           "sizes TEXT, "
+                                                           "processed TEXT, "
+                                                           "extras TEXT)";
+
+constexpr const char *REQUEST_TASK_PROGRESS_TABLE_MIGRATE = "INSERT OR IGNORE INTO request_task_progress "
+                                                            "(task_id, mtime, tries, mime_type, idx, "
+                                                            "total_processed, sizes, processed, extras) "
+                                                            "SELECT task_id, mtime, tries, mime_type, idx, "
+                                                            "total_processed, sizes, processed, extras "
+                                                            "FROM request_task";
+
+constexpr const char *REQUEST_TASK_PROGRESS_TABLE_ADD_DELETE_TRIGGER = "CREATE TRIGGER IF NOT EXISTS "
+                                                                      "request_task_progress_delete "
+                                                                      "AFTER DELETE ON request_task BEGIN "
+                                                                      "DELETE FROM request_task_progress "
+                                                                      "WHERE task_id = OLD.task_id; END";
+
 constexpr const char *REQUEST_TASK_TABLE_ADD_PROXY = "ALTER TABLE request_task ADD COLUMN proxy TEXT";
 
 constexpr const char *REQUEST_TASK_TABLE_ADD_CERTIFICATE_PINS = "ALTER TABLE request_task ADD COLUMN "
@@ -113,6 +153,61 @@ constexpr const char *REQUEST_TASK_TABLE_ADD_ATOMIC_ACCOUNT = "ALTER TABLE reque
 
 constexpr const char *REQUEST_TASK_TABLE_ADD_UID_INDEX = "CREATE INDEX uid_index on request_task(uid)";
 
+// Covers the columns read by `get_app_task_qos_infos`, so reloading the tasks of an
+// app never touches the table rows.
+constexpr const char *REQUEST_TASK_TABLE_ADD_QOS_INDEX = "CREATE INDEX IF NOT EXISTS task_qos_index ON "
+                                                         "request_task(uid, state, reason, action, mode, priority)";
+// Used by `clear_invalid_records` and the startup state fix-up.
+constexpr const char *REQUEST_TASK_TABLE_ADD_STATE_INDEX = "CREATE INDEX IF NOT EXISTS task_state_index ON "
+                                                           "request_task(state, reason)";
+// Used by system searches, which filter by bundle and creation time.
+constexpr const char *REQUEST_TASK_TABLE_ADD_BUNDLE_INDEX = "CREATE INDEX IF NOT EXISTS task_bundle_index ON "
+                                                            "request_task(bundle, ctime)";
+
+// Full-text index of the title, description and url of `request_task`, used by keyword
+// searches. It refers to the rows of `request_task` rather than copying them, the
+// triggers below keep it in sync. Trigrams match any part of a word, such as a URL
+// fragment, of at least 3 characters.
+constexpr const char *CREATE_REQUEST_TASK_SEARCH_TABLE = "CREATE VIRTUAL TABLE IF NOT EXISTS request_task_search "
+                                                         "USING fts5(title, description, url, "
+                                                         "content='request_task', content_rowid='task_id', "
+                                                         "tokenize='trigram')";
+
+constexpr const char *REQUEST_TASK_SEARCH_TABLE_ADD_INSERT_TRIGGER = "CREATE TRIGGER IF NOT EXISTS "
+                                                                     "request_task_search_insert "
+                                                                     "AFTER INSERT ON request_task BEGIN "
+                                                                     "INSERT INTO request_task_search "
+                                                                     "(rowid, title, description, url) "
+                                                                     "VALUES (NEW.task_id, NEW.title, "
+                                                                     "NEW.description, NEW.url); END";
+
+constexpr const char *REQUEST_TASK_SEARCH_TABLE_ADD_DELETE_TRIGGER = "CREATE TRIGGER IF NOT EXISTS "
+                                                                     "request_task_search_delete "
+                                                                     "AFTER DELETE ON request_task BEGIN "
+                                                                     "INSERT INTO request_task_search "
+                                                                     "(request_task_search, rowid, title, "
+                                                                     "description, url) VALUES ('delete', "
+                                                                     "OLD.task_id, OLD.title, OLD.description, "
+                                                                     "OLD.url); END";
+
+constexpr const char *REQUEST_TASK_SEARCH_TABLE_ADD_UPDATE_TRIGGER = "CREATE TRIGGER IF NOT EXISTS "
+                                                                     "request_task_search_update "
+                                                                     "AFTER UPDATE OF title, description, url "
+                                                                     "ON request_task BEGIN "
+                                                                     "INSERT INTO request_task_search "
+                                                                     "(request_task_search, rowid, title, "
+                                                                     "description, url) VALUES ('delete', "
+                                                                     "OLD.task_id, OLD.title, OLD.description, "
+                                                                     "OLD.url); "
+                                                                     "INSERT INTO request_task_search "
+                                                                     "(rowid, title, description, url) "
+                                                                     "VALUES (NEW.task_id, NEW.title, "
+                                                                     "NEW.description, NEW.url); END";
+
+// Indexes the tasks stored before the index existed.
+constexpr const char *REQUEST_TASK_SEARCH_TABLE_REBUILD = "INSERT INTO request_task_search "
+                                                          "(request_task_search) VALUES ('rebuild')";
+
 constexpr const char *REQUEST_TASK_TABLE_ADD_MAX_SPEED = "ALTER TABLE request_task ADD COLUMN max_speed INTEGER";
 constexpr const char *REQUEST_TASK_TABLE_ADD_MULTIPART = "ALTER TABLE request_task ADD COLUMN multipart INTEGER";
 constexpr const char *REQUEST_TASK_TABLE_ADD_MIN_SPEED = "ALTER TABLE request_task ADD COLUMN min_speed INTEGER";
@@ -124,6 +219,29 @@ constexpr const char *REQUEST_TASK_TABLE_ADD_TOTAL_TIMEOUT = "ALTER TABLE reques
                                                              "INTEGER";
 constexpr const char *REQUEST_TASK_TABLE_ADD_TASK_TIME = "ALTER TABLE request_task ADD COLUMN task_time "
                                                          "INTEGER";
+constexpr const char *REQUEST_TASK_TABLE_ADD_CHECKSUM = "ALTER TABLE request_task ADD COLUMN checksum TEXT";
+constexpr const char *REQUEST_TASK_TABLE_ADD_STALL_WINDOW = "ALTER TABLE request_task ADD COLUMN stall_window "
+                                                            "INTEGER";
+constexpr const char *REQUEST_TASK_TABLE_ADD_STALL_RATIO = "ALTER TABLE request_task ADD COLUMN stall_ratio "
+                                                           "INTEGER";
+constexpr const char *REQUEST_TASK_TABLE_ADD_CONCURRENCY = "ALTER TABLE request_task ADD COLUMN concurrency "
+                                                           "INTEGER";
+constexpr const char *REQUEST_TASK_TABLE_ADD_CHUNK_SIZE = "ALTER TABLE request_task ADD COLUMN chunk_size "
+                                                          "INTEGER";
+constexpr const char *REQUEST_TASK_TABLE_ADD_DEADLINE = "ALTER TABLE request_task ADD COLUMN deadline "
+                                                        "INTEGER";
+constexpr const char *REQUEST_TASK_TABLE_ADD_COALESCE = "ALTER TABLE request_task ADD COLUMN coalesce "
+                                                        "INTEGER";
+constexpr const char *REQUEST_TASK_TABLE_ADD_COMPRESSION = "ALTER TABLE request_task ADD COLUMN compression "
+                                                           "INTEGER";
+constexpr const char *REQUEST_TASK_TABLE_ADD_MEMORY_LIMIT = "ALTER TABLE request_task ADD COLUMN memory_limit "
+                                                            "INTEGER";
+constexpr const char *REQUEST_TASK_TABLE_ADD_PREFETCH = "ALTER TABLE request_task ADD COLUMN prefetch "
+                                                        "INTEGER";
+constexpr const char *REQUEST_TASK_TABLE_ADD_PERFORMANCE = "ALTER TABLE request_task ADD COLUMN performance "
+                                                           "TEXT";
+constexpr const char *REQUEST_TASK_TABLE_ADD_BYPASS_CACHE = "ALTER TABLE request_task ADD COLUMN bypass_cache "
+                                                            "INTEGER";
 
 constexpr const char *REQUEST_TASK_TABLE_COL_PROXY = "proxy";
 constexpr const char *REQUEST_TASK_TABLE_COL_CERTIFICATE_PINS = "certificate_pins";
@@ -136,22 +254,72 @@ constexpr const char *REQUEST_TASK_TABLE_COL_MIN_SPEED_DURATION = "min_speed_dur
 constexpr const char *REQUEST_TASK_TABLE_COL_CONNECTION_TIMEOUT = "connection_timeout";
 constexpr const char *REQUEST_TASK_TABLE_COL_TOTAL_TIMEOUT = "total_timeout";
 constexpr const char *REQUEST_TASK_TABLE_COL_TASK_TIME = "task_time";
+constexpr const char *REQUEST_TASK_TABLE_COL_CHECKSUM = "checksum";
+constexpr const char *REQUEST_TASK_TABLE_COL_STALL_WINDOW = "stall_window";
+constexpr const char *REQUEST_TASK_TABLE_COL_STALL_RATIO = "stall_ratio";
+constexpr const char *REQUEST_TASK_TABLE_COL_CONCURRENCY = "concurrency";
+constexpr const char *REQUEST_TASK_TABLE_COL_CHUNK_SIZE = "chunk_size";
+constexpr const char *REQUEST_TASK_TABLE_COL_DEADLINE = "deadline";
+constexpr const char *REQUEST_TASK_TABLE_COL_COALESCE = "coalesce";
+constexpr const char *REQUEST_TASK_TABLE_COL_COMPRESSION = "compression";
+constexpr const char *REQUEST_TASK_TABLE_COL_MEMORY_LIMIT = "memory_limit";
+constexpr const char *REQUEST_TASK_TABLE_COL_PREFETCH = "prefetch";
+constexpr const char *REQUEST_TASK_TABLE_COL_PERFORMANCE = "performance";
+constexpr const char *REQUEST_TASK_TABLE_COL_BYPASS_CACHE = "bypass_cache";
 
 struct TaskFilter;
 struct NetworkInfo;
 struct TaskQosInfo;
+struct SqlArg;
+
+// Forward-only rows of a query. Rows are stepped through once with `GoToNextRow` and
+// handed out in chunks of at most `limit` rows, so the row count is never computed.
+// Each `Next*` call returns the number of appended rows, fewer than `limit` once the
+// rows are exhausted, or -1 on error.
+class RequestResultSet {
+public:
+    explicit RequestResultSet(std::shared_ptr<OHOS::NativeRdb::ResultSet> resultSet);
+    ~RequestResultSet();
+    RequestResultSet(const RequestResultSet &) = delete;
+    RequestResultSet &operator=(const RequestResultSet &) = delete;
+    int NextIntegers(rust::vec<rust::i64> &res, size_t limit);
+    // Appends every column of the next row, returns 1 if there was a row.
+    int NextRow(rust::vec<rust::i64> &res);
+    // Appends every column of each of the next rows, row after row.
+    int NextColumns(rust::vec<rust::i64> &res, size_t limit);
+    int NextTexts(rust::vec<rust::string> &res, size_t limit);
+    int NextTaskQosInfos(rust::vec<TaskQosInfo> &res, size_t limit);
+
+private:
+    // Returns 1 if a row is available, 0 at the end of the rows and -1 on error.
+    int Step();
+
+private:
+    std::shared_ptr<OHOS::NativeRdb::ResultSet> resultSet_;
+    bool done_ = false;
+};
+
 class RequestDataBase {
 public:
     static RequestDataBase &GetInstance(std::string path, bool encryptStatus);
     RequestDataBase(const RequestDataBase &) = delete;
     RequestDataBase &operator=(const RequestDataBase &) = delete;
     bool Insert(const std::string &table, const OHOS::NativeRdb::ValuesBucket &insertValues);
+    bool Replace(const std::string &table, const OHOS::NativeRdb::ValuesBucket &values);
     bool Update(const OHOS::NativeRdb::ValuesBucket values, const OHOS::NativeRdb::AbsRdbPredicates &predicates);
     std::shared_ptr<OHOS::NativeRdb::ResultSet> Query(
         const OHOS::NativeRdb::AbsRdbPredicates &predicates, const std::vector<std::string> &columns);
+    std::shared_ptr<OHOS::NativeRdb::ResultSet> QuerySql(
+        const std::string &sql, const std::vector<OHOS::NativeRdb::ValueObject> &args);
     bool Delete(const OHOS::NativeRdb::AbsRdbPredicates &predicates);
     int ExecuteSql(rust::str sql);
+    int ExecuteSqlWithArgs(rust::str sql, rust::Slice<const SqlArg> args);
     int QueryInteger(rust::str sql, rust::vec<rust::i64> &res);
+    int QueryIntegerWithArgs(rust::str sql, rust::Slice<const SqlArg> args, rust::vec<rust::i64> &res);
+    std::unique_ptr<RequestResultSet> QueryStep(rust::str sql, rust::Slice<const SqlArg> args);
+    int BeginTransaction();
+    int Commit();
+    int RollBack();
     int QueryText(rust::str sql, rust::vec<rust::string> &res);
     int GetAppTaskQosInfos(rust::str sql, rust::vec<TaskQosInfo> &res);
     int GetTaskQosInfo(rust::str sql, TaskQosInfo &res);
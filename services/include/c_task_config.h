@@ -34,6 +34,11 @@ struct Timeout {
     uint64_t totalTimeout = 0;
 };
 
+struct StallDetection {
+    int64_t window;
+    int64_t ratio;
+};
+
 struct CommonTaskConfig {
     uint32_t taskId;
     uint64_t uid;
@@ -56,6 +61,15 @@ struct CommonTaskConfig {
     bool multipart;
     MinSpeed minSpeed;
     Timeout timeout;
+    StallDetection stallDetection;
+    uint32_t concurrency;
+    uint64_t chunkSize;
+    uint64_t deadline;
+    bool coalesce;
+    bool compression;
+    uint32_t memoryLimit;
+    bool prefetch;
+    bool bypassCache;
 };
 
 struct CStringMap {
@@ -76,6 +90,7 @@ struct CTaskConfig {
     CStringWrapper token;
     CStringWrapper proxy;
     CStringWrapper certificatePins;
+    CStringWrapper checksum;
     CStringWrapper extras;
     uint8_t version;
     CFormItem *formItemsPtr;
@@ -102,6 +117,7 @@ struct TaskConfig {
     std::string token;
     std::string proxy;
     std::string certificatePins;
+    std::string checksum;
     std::string extras;
     uint8_t version;
     std::vector<FormItem> formItems;
@@ -55,6 +55,7 @@ struct CTaskInfo {
     CommonTaskInfo commonData;
     int64_t maxSpeed;
     uint64_t taskTime;
+    CStringWrapper performance;
 };
 
 struct TaskInfo {
@@ -71,6 +72,7 @@ struct TaskInfo {
     CommonTaskInfo commonData;
     int64_t maxSpeed;
     uint64_t taskTime;
+    std::string performance;
 };
 
 struct CUpdateInfo {
@@ -100,9 +102,6 @@ struct TaskQosInfo {
 extern "C" {
 #endif
 
-void DeleteCFormItem(CFormItem *ptr);
-void DeleteCFileSpec(CFileSpec *ptr);
-void DeleteCStringPtr(CStringWrapper *ptr);
 void DeleteCTaskInfo(CTaskInfo *ptr);
 void DeleteTaskQosInfo(TaskQosInfo *ptr);
 
@@ -36,13 +36,13 @@ public:
     void OnReceiveEvent(const OHOS::EventFwk::CommonEventData &data) override;
 };
 
+using ProxyChangeCallback = void (*)(CStringWrapper host, CStringWrapper port, CStringWrapper exclusionList);
+
 class SysNetProxyManager {
 public:
     static SysNetProxyManager &GetInstance();
-    void SubscriberEvent();
-    CStringWrapper GetHost();
-    CStringWrapper GetPort();
-    CStringWrapper GetExclusionList();
+    void SubscriberEvent(ProxyChangeCallback callback);
+    void PublishProxy();
 
     void GetHttpProxy(const std::string proxyContent, std::string &host, std::string &port, std::string &exclusionList);
     void InitProxy(std::string &host, std::string &port, std::string &exclusion);
@@ -63,6 +63,7 @@ private:
     std::string port_;
     std::string exclusionList_;
     std::mutex proxyMutex;
+    ProxyChangeCallback callback_ = nullptr;
 };
 std::shared_ptr<SysNetProxySubscriber> SysNetProxyManager::subscriber_ = nullptr;
 
@@ -70,10 +71,7 @@ std::shared_ptr<SysNetProxySubscriber> SysNetProxyManager::subscriber_ = nullptr
 extern "C" {
 #endif
 
-void RegisterProxySubscriber();
-CStringWrapper GetHost();
-CStringWrapper GetPort();
-CStringWrapper GetExclusionList();
+void RegisterProxySubscriber(ProxyChangeCallback callback);
 
 #ifdef __cplusplus
 }
@@ -30,6 +30,7 @@ struct ProgressCircle;
 
 rust::string GetSystemResourceString(const rust::str);
 rust::string GetSystemLanguage();
+void ClearResourceCache();
 int PublishNotification(const NotifyContent &content);
 
 class NotificationSubscriber : public Notification::NotificationLocalLiveViewSubscriber {
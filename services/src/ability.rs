@@ -22,13 +22,18 @@ use samgr::manage::SystemAbilityManager;
 use system_ability_fwk::ability::{Ability, Handler};
 
 use crate::manage::app_state::AppStateListener;
+use crate::manage::database::RequestDb;
+use crate::manage::db_worker::DbWorker;
 use crate::manage::events::{ScheduleEvent, TaskManagerEvent};
 use crate::manage::task_manager::TaskManagerTx;
 use crate::manage::{account, SystemConfigManager, TaskManager};
 use crate::service::active_counter::ActiveCounter;
 use crate::service::client::ClientManager;
+use crate::service::permission::subscribe_permission_change;
 use crate::service::run_count::RunCountManager;
 use crate::service::RequestServiceStub;
+use crate::utils::runtime::init_control_runtime;
+use crate::utils::startup::{self, Phase};
 use crate::utils::update_policy;
 
 pub(crate) static mut PANIC_INFO: Option<String> = None;
@@ -63,44 +68,61 @@ impl RequestAbility {
             PANIC_INFO = Some(info);
         }));
 
-        if let Err(e) = ylong_runtime::builder::RuntimeBuilder::new_multi_thread()
-            .worker_num(4)
-            .build_global()
-        {
-            error!("ylong_runtime error: {}", e);
-        }
+        startup::measure(Phase::Runtime, init_control_runtime);
         info!("ylong_runtime init ok");
 
-        let runcount_manager = RunCountManager::init();
-        info!("runcount_manager init ok");
+        // The database is opened on its worker while the managers that do not
+        // need it start, only the task manager waits for it.
+        let database = DbWorker::get_instance().run(|| {
+            startup::measure(Phase::Database, || {
+                RequestDb::get_instance();
+            })
+        });
 
-        let client_manger = ClientManager::init();
+        let client_manger = startup::measure(Phase::ClientManager, ClientManager::init);
         info!("client_manger init ok");
 
+        let runcount_manager = startup::measure(Phase::RunCount, || {
+            RunCountManager::init_with_clients(client_manger.clone())
+        });
+        info!("runcount_manager init ok");
+
         // Use methods to handle rather than directly accessing members.
+        // Certificates and proxy are initialized by the first task to run.
         unsafe { SYSTEM_CONFIG_MANAGER.write(SystemConfigManager::init()) };
         info!("system_config_manager init ok");
 
-        let task_manager = TaskManager::init(
-            runcount_manager.clone(),
-            client_manger.clone(),
-            self.active_counter.clone(),
-        );
+        if ylong_runtime::block_on(database).is_err() {
+            // Opened by the first query of the task manager instead
+            error!("open database on its worker failed");
+        }
+        info!("database init ok");
+
+        let task_manager = startup::measure(Phase::TaskManager, || {
+            TaskManager::init(
+                runcount_manager.clone(),
+                client_manger.clone(),
+                self.active_counter.clone(),
+            )
+        });
         *self.task_manager.lock().unwrap() = Some(task_manager.clone());
         info!("task_manager init ok");
 
-        AppStateListener::init(client_manger.clone(), task_manager.clone());
-
-        SystemAbilityManager::subscribe_system_ability(
-            APP_MGR_SERVICE_ID,
-            |_, _| {
-                info!("app manager service init");
-                AppStateListener::register();
-            },
-            |_, _| {
-                error!("app manager service died");
-            },
-        );
+        startup::measure(Phase::AppState, || {
+            AppStateListener::init(client_manger.clone(), task_manager.clone());
+            subscribe_permission_change();
+
+            SystemAbilityManager::subscribe_system_ability(
+                APP_MGR_SERVICE_ID,
+                |_, _| {
+                    info!("app manager service init");
+                    AppStateListener::register();
+                },
+                |_, _| {
+                    error!("app manager service died");
+                },
+            );
+        });
 
         let stub = RequestServiceStub::new(
             handler.clone(),
@@ -111,7 +133,7 @@ impl RequestAbility {
         );
 
         info!("ability init succeed");
-        if !handler.publish(stub) {
+        if !startup::measure(Phase::Publish, || handler.publish(stub)) {
             service_start_fault();
         }
     }
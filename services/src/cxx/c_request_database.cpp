@@ -18,9 +18,13 @@
 #include <securec.h>
 
 #include <algorithm>
+#include <cctype>
 #include <cstdint>
+#include <cstdlib>
 #include <iostream>
+#include <new>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "base/request/request/common/include/log.h"
@@ -97,6 +101,19 @@ bool RequestDataBase::Insert(const std::string &table, const OHOS::NativeRdb::Va
     return ret == OHOS::NativeRdb::E_OK;
 }
 
+bool RequestDataBase::Replace(const std::string &table, const OHOS::NativeRdb::ValuesBucket &values)
+{
+    if (store_ == nullptr) {
+        return false;
+    }
+
+    int64_t outRowId = 0;
+    int ret = store_->Replace(outRowId, table, values);
+    REQUEST_HILOGD("Request databases replace values, ret: %{public}d", ret);
+    CheckAndRebuildDataBase(ret);
+    return ret == OHOS::NativeRdb::E_OK;
+}
+
 bool RequestDataBase::Update(
     const OHOS::NativeRdb::ValuesBucket values, const OHOS::NativeRdb::AbsRdbPredicates &predicates)
 {
@@ -120,6 +137,31 @@ std::shared_ptr<OHOS::NativeRdb::ResultSet> RequestDataBase::Query(
     return store_->QueryByStep(predicates, columns);
 }
 
+std::shared_ptr<OHOS::NativeRdb::ResultSet> RequestDataBase::QuerySql(
+    const std::string &sql, const std::vector<OHOS::NativeRdb::ValueObject> &args)
+{
+    if (store_ == nullptr) {
+        return nullptr;
+    }
+    return store_->QueryByStep(sql, args);
+}
+
+// Statements are keyed by their SQL text in the store's statement cache, so binding the
+// values instead of formatting them in lets repeated updates reuse the compiled statement.
+static std::vector<OHOS::NativeRdb::ValueObject> ToBindArgs(rust::Slice<const SqlArg> args)
+{
+    std::vector<OHOS::NativeRdb::ValueObject> bindArgs;
+    bindArgs.reserve(args.size());
+    for (const SqlArg &arg : args) {
+        if (arg.is_text) {
+            bindArgs.emplace_back(std::string(arg.text));
+        } else {
+            bindArgs.emplace_back(static_cast<int64_t>(arg.integer));
+        }
+    }
+    return bindArgs;
+}
+
 int RequestDataBase::ExecuteSql(rust::str sql)
 {
     if (store_ == nullptr) {
@@ -130,65 +172,252 @@ int RequestDataBase::ExecuteSql(rust::str sql)
     return ret;
 }
 
-int RequestDataBase::QueryInteger(rust::str sql, rust::vec<rust::i64> &res)
+int RequestDataBase::ExecuteSqlWithArgs(rust::str sql, rust::Slice<const SqlArg> args)
 {
     if (store_ == nullptr) {
         return -1;
     }
-    auto queryRet = store_->QueryByStep(std::string(sql));
-    if (queryRet == nullptr) {
-        REQUEST_HILOGE("Search failed with reason: result set is nullptr");
+    int ret = store_->ExecuteSql(std::string(sql), ToBindArgs(args));
+    CheckAndRebuildDataBase(ret);
+    return ret;
+}
+
+int RequestDataBase::BeginTransaction()
+{
+    if (store_ == nullptr) {
         return -1;
     }
-    int rowCount = 0;
+    return store_->BeginTransaction();
+}
 
-    int errCode = queryRet->GetRowCount(rowCount);
-    if (errCode != OHOS::NativeRdb::E_OK) {
-        REQUEST_HILOGE("GetRowCount failed: %{public}d", errCode);
-        CheckAndRebuildDataBase(errCode);
+int RequestDataBase::Commit()
+{
+    if (store_ == nullptr) {
         return -1;
     }
-    for (int i = 0; i < rowCount; i++) {
-        auto code = queryRet->GoToRow(i);
-        if (code != OHOS::NativeRdb::E_OK) {
-            REQUEST_HILOGE("result set go to %{public}d row failed %{public}d", i, code);
-            return -1;
+    int ret = store_->Commit();
+    CheckAndRebuildDataBase(ret);
+    return ret;
+}
+
+int RequestDataBase::RollBack()
+{
+    if (store_ == nullptr) {
+        return -1;
+    }
+    return store_->RollBack();
+}
+
+RequestResultSet::RequestResultSet(std::shared_ptr<OHOS::NativeRdb::ResultSet> resultSet)
+    : resultSet_{ std::move(resultSet) }
+{
+}
+
+RequestResultSet::~RequestResultSet()
+{
+    if (resultSet_ != nullptr) {
+        resultSet_->Close();
+    }
+}
+
+int RequestResultSet::Step()
+{
+    if (done_ || resultSet_ == nullptr) {
+        return 0;
+    }
+    int code = resultSet_->GoToNextRow();
+    if (code == OHOS::NativeRdb::E_OK) {
+        return 1;
+    }
+    done_ = true;
+    if (code == OHOS::NativeRdb::E_NO_MORE_ROWS || code == OHOS::NativeRdb::E_ROW_OUT_RANGE) {
+        return 0;
+    }
+    REQUEST_HILOGE("result set go to next row failed: %{public}d", code);
+    RequestDataBase::GetInstance(DB_NAME, true).CheckAndRebuildDataBase(code);
+    return -1;
+}
+
+int RequestResultSet::NextIntegers(rust::vec<rust::i64> &res, size_t limit)
+{
+    int count = 0;
+    for (size_t i = 0; i < limit; i++) {
+        int ret = Step();
+        if (ret <= 0) {
+            return ret < 0 ? -1 : count;
         }
         int64_t value = 0;
-        queryRet->GetLong(0, value);
+        resultSet_->GetLong(0, value);
         res.push_back(rust::i64(value));
+        count++;
     }
-    return 0;
+    return count;
 }
 
-int RequestDataBase::QueryText(rust::str sql, rust::vec<rust::String> &res)
+int RequestResultSet::NextRow(rust::vec<rust::i64> &res)
 {
-    if (store_ == nullptr) {
+    int ret = Step();
+    if (ret <= 0) {
+        return ret;
+    }
+    int columns = 0;
+    resultSet_->GetColumnCount(columns);
+    for (int i = 0; i < columns; i++) {
+        int64_t value = 0;
+        resultSet_->GetLong(i, value);
+        res.push_back(rust::i64(value));
+    }
+    return 1;
+}
+
+int RequestResultSet::NextColumns(rust::vec<rust::i64> &res, size_t limit)
+{
+    int count = 0;
+    for (size_t i = 0; i < limit; i++) {
+        int ret = Step();
+        if (ret <= 0) {
+            return ret < 0 ? -1 : count;
+        }
+        int columns = 0;
+        resultSet_->GetColumnCount(columns);
+        for (int column = 0; column < columns; column++) {
+            int64_t value = 0;
+            resultSet_->GetLong(column, value);
+            res.push_back(rust::i64(value));
+        }
+        count++;
+    }
+    return count;
+}
+
+int RequestResultSet::NextTexts(rust::vec<rust::string> &res, size_t limit)
+{
+    int count = 0;
+    for (size_t i = 0; i < limit; i++) {
+        int ret = Step();
+        if (ret <= 0) {
+            return ret < 0 ? -1 : count;
+        }
+        std::string value = "";
+        resultSet_->GetString(0, value);
+        res.push_back(rust::string(value));
+        count++;
+    }
+    return count;
+}
+
+// Bytes left of a task whose files have the stored `sizes`, or -1 if the size of a file is not known yet.
+static int64_t RemainingBytes(const std::string &sizes, int64_t totalProcessed)
+{
+    int64_t total = 0;
+    size_t files = 0;
+    const char *cur = sizes.c_str();
+    while (*cur != '\0') {
+        if (*cur == '-') {
+            return -1;
+        }
+        if (!std::isdigit(static_cast<unsigned char>(*cur))) {
+            cur++;
+            continue;
+        }
+        char *end = nullptr;
+        total += std::strtoll(cur, &end, 10);
+        cur = end;
+        files++;
+    }
+    if (files == 0) {
         return -1;
     }
-    auto queryRet = store_->QuerySql(std::string(sql));
+    return std::max<int64_t>(total - totalProcessed, 0);
+}
+
+int RequestResultSet::NextTaskQosInfos(rust::vec<TaskQosInfo> &res, size_t limit)
+{
+    int count = 0;
+    for (size_t i = 0; i < limit; i++) {
+        int ret = Step();
+        if (ret <= 0) {
+            return ret < 0 ? -1 : count;
+        }
+        int taskId;
+        int action;
+        int mode;
+        int state;
+        int priority;
+        int64_t totalProcessed = 0;
+        std::string sizes;
+        int64_t deadline = 0;
+        int64_t uid = 0;
+        int prefetch = 0;
+        resultSet_->GetInt(0, taskId);          // Line 0 is 'task_id'
+        resultSet_->GetInt(1, action);          // Line 1 is 'action'
+        resultSet_->GetInt(2, mode);            // Line 2 is 'mode'
+        resultSet_->GetInt(3, state);           // Line 3 is 'state'
+        resultSet_->GetInt(4, priority);        // Line 4 is 'priority'
+        resultSet_->GetLong(5, totalProcessed); // Line 5 is 'total_processed'
+        resultSet_->GetString(6, sizes);        // Line 6 is 'sizes'
+        resultSet_->GetLong(7, deadline);       // Line 7 is 'deadline'
+        resultSet_->GetLong(8, uid);            // Line 8 is 'uid'
+        resultSet_->GetInt(9, prefetch);        // Line 9 is 'prefetch'
+        res.push_back(TaskQosInfo{ static_cast<uint32_t>(taskId), static_cast<uint8_t>(action),
+            static_cast<uint8_t>(mode), static_cast<uint8_t>(state), static_cast<uint32_t>(priority),
+            RemainingBytes(sizes, totalProcessed), static_cast<uint64_t>(deadline), static_cast<uint64_t>(uid),
+            prefetch != 0 });
+        count++;
+    }
+    return count;
+}
+
+std::unique_ptr<RequestResultSet> RequestDataBase::QueryStep(rust::str sql, rust::Slice<const SqlArg> args)
+{
+    if (store_ == nullptr) {
+        return nullptr;
+    }
+    auto queryRet = store_->QueryByStep(std::string(sql), ToBindArgs(args));
     if (queryRet == nullptr) {
         REQUEST_HILOGE("Search failed with reason: result set is nullptr");
+        return nullptr;
+    }
+    return std::make_unique<RequestResultSet>(queryRet);
+}
+
+int RequestDataBase::QueryInteger(rust::str sql, rust::vec<rust::i64> &res)
+{
+    return QueryIntegerWithArgs(sql, rust::Slice<const SqlArg>(), res);
+}
+
+int RequestDataBase::QueryIntegerWithArgs(rust::str sql, rust::Slice<const SqlArg> args, rust::vec<rust::i64> &res)
+{
+    auto rows = QueryStep(sql, args);
+    if (rows == nullptr) {
         return -1;
     }
-    int rowCount = 0;
+    while (true) {
+        int ret = rows->NextIntegers(res, QUERY_CHUNK_ROWS);
+        if (ret < 0) {
+            return -1;
+        }
+        if (static_cast<size_t>(ret) < QUERY_CHUNK_ROWS) {
+            return 0;
+        }
+    }
+}
 
-    int errCode = queryRet->GetRowCount(rowCount);
-    if (errCode != OHOS::NativeRdb::E_OK) {
-        REQUEST_HILOGE("GetRowCount failed: %{public}d", errCode);
-        CheckAndRebuildDataBase(errCode);
+int RequestDataBase::QueryText(rust::str sql, rust::vec<rust::String> &res)
+{
+    auto rows = QueryStep(sql, rust::Slice<const SqlArg>());
+    if (rows == nullptr) {
         return -1;
     }
-    for (int i = 0; i < rowCount; i++) {
-        if (queryRet->GoToRow(i) != OHOS::NativeRdb::E_OK) {
-            REQUEST_HILOGE("result set go to %{public}d row failed", i);
+    while (true) {
+        int ret = rows->NextTexts(res, QUERY_CHUNK_ROWS);
+        if (ret < 0) {
             return -1;
         }
-        std::string value = "";
-        queryRet->GetString(i, value);
-        res.push_back(rust::string(value));
+        if (static_cast<size_t>(ret) < QUERY_CHUNK_ROWS) {
+            return 0;
+        }
     }
-    return 0;
 }
 
 bool RequestDataBase::Delete(const OHOS::NativeRdb::AbsRdbPredicates &predicates)
@@ -206,46 +435,21 @@ bool RequestDataBase::Delete(const OHOS::NativeRdb::AbsRdbPredicates &predicates
 
 int RequestDataBase::GetAppTaskQosInfos(rust::str sql, rust::vec<TaskQosInfo> &res)
 {
-    if (store_ == nullptr) {
-        return -1;
-    }
-    auto queryRet = store_->QueryByStep(std::string(sql));
-    int rowCount = 0;
-
-    if (queryRet == nullptr) {
+    auto rows = QueryStep(sql, rust::Slice<const SqlArg>());
+    if (rows == nullptr) {
         REQUEST_HILOGE("GetRunningTasksArray result set is nullptr");
         return -1;
     }
-
-    int errCode = queryRet->GetRowCount(rowCount);
-    if (errCode != OHOS::NativeRdb::E_OK) {
-        REQUEST_HILOGE("GetRowCount failed: %{public}d", errCode);
-        CheckAndRebuildDataBase(errCode);
-        return -1;
-    }
-
-    if (rowCount == 0) {
-        return -1;
-    }
-
-    for (auto i = 0; i < rowCount; i++) {
-        if (queryRet->GoToRow(i) != OHOS::NativeRdb::E_OK) {
-            REQUEST_HILOGE("GetRunningTasksArray result set go to %{public}d row failed", i);
+    while (true) {
+        int ret = rows->NextTaskQosInfos(res, QUERY_CHUNK_ROWS);
+        if (ret < 0) {
             return -1;
         }
-        int taskId;
-        int action;
-        int mode;
-        int state;
-        int priority;
-        queryRet->GetInt(0, taskId);   // Line 0 is 'task_id'
-        queryRet->GetInt(1, action);   // Line 1 is 'action'
-        queryRet->GetInt(2, mode);     // Line 2 is 'mode'
-        queryRet->GetInt(3, state);    // Line 3 is 'state'
-        queryRet->GetInt(4, priority); // Line 4 is 'priority'
-        res.push_back(TaskQosInfo{ taskId, action, mode, state, priority });
+        if (static_cast<size_t>(ret) < QUERY_CHUNK_ROWS) {
+            break;
+        }
     }
-    return 0;
+    return res.empty() ? -1 : 0;
 }
 
 int RequestDataBase::GetTaskQosInfo(rust::str sql, TaskQosInfo &res)
@@ -254,40 +458,45 @@ int RequestDataBase::GetTaskQosInfo(rust::str sql, TaskQosInfo &res)
         return -1;
     }
     auto queryRet = store_->QueryByStep(std::string(sql));
-    int rowCount = 0;
-
     if (queryRet == nullptr) {
         REQUEST_HILOGE("GetTaskQosInfo result set is nullptr");
         return -1;
     }
 
-    int errCode = queryRet->GetRowCount(rowCount);
+    int errCode = queryRet->GoToNextRow();
     if (errCode != OHOS::NativeRdb::E_OK) {
-        REQUEST_HILOGE("GetRowCount failed: %{public}d", errCode);
-        CheckAndRebuildDataBase(errCode);
-        return -1;
-    }
-
-    if (rowCount == 0) {
-        return -1;
-    }
-
-    if (queryRet->GoToRow(0) != OHOS::NativeRdb::E_OK) {
-        REQUEST_HILOGE("GetTaskQosInfo result set go to 0 row failed");
+        if (errCode != OHOS::NativeRdb::E_NO_MORE_ROWS && errCode != OHOS::NativeRdb::E_ROW_OUT_RANGE) {
+            REQUEST_HILOGE("GetTaskQosInfo result set go to next row failed: %{public}d", errCode);
+            CheckAndRebuildDataBase(errCode);
+        }
         return -1;
     }
     int64_t action;
     int64_t mode;
     int64_t state;
     int64_t priority;
-    queryRet->GetLong(0, action);   // Line 0 is 'action'
-    queryRet->GetLong(1, mode);     // Line 1 is 'mode'
-    queryRet->GetLong(2, state);    // Line 2 is 'state'
-    queryRet->GetLong(3, priority); // Line 3 is 'priority'
+    int64_t totalProcessed = 0;
+    std::string sizes;
+    int64_t deadline = 0;
+    int64_t uid = 0;
+    int64_t prefetch = 0;
+    queryRet->GetLong(0, action);         // Line 0 is 'action'
+    queryRet->GetLong(1, mode);           // Line 1 is 'mode'
+    queryRet->GetLong(2, state);          // Line 2 is 'state'
+    queryRet->GetLong(3, priority);       // Line 3 is 'priority'
+    queryRet->GetLong(4, totalProcessed); // Line 4 is 'total_processed'
+    queryRet->GetString(5, sizes);        // Line 5 is 'sizes'
+    queryRet->GetLong(6, deadline);       // Line 6 is 'deadline'
+    queryRet->GetLong(7, uid);            // Line 7 is 'uid'
+    queryRet->GetLong(8, prefetch);       // Line 8 is 'prefetch'
     res.action = static_cast<uint8_t>(action);
     res.mode = static_cast<uint8_t>(mode);
     res.state = static_cast<uint8_t>(state);
     res.priority = static_cast<uint32_t>(priority);
+    res.remaining = RemainingBytes(sizes, totalProcessed);
+    res.deadline = static_cast<uint64_t>(deadline);
+    res.uid = static_cast<uint64_t>(uid);
+    res.prefetch = prefetch != 0;
     return 0;
 }
 
@@ -423,6 +632,85 @@ int RequestDBCheckVersion(OHOS::NativeRdb::RdbStore &store)
     return ConvertDBVersion(version);
 }
 
+int RequestDBCreateProgressTable(OHOS::NativeRdb::RdbStore &store)
+{
+    int ret = store.ExecuteSql(CREATE_REQUEST_TASK_PROGRESS_TABLE);
+    if (ret != OHOS::NativeRdb::E_OK) {
+        REQUEST_HILOGE("Creates request_task_progress table failed, ret: %{public}d", ret);
+        return ret;
+    }
+    ret = store.ExecuteSql(REQUEST_TASK_PROGRESS_TABLE_ADD_DELETE_TRIGGER);
+    if (ret != OHOS::NativeRdb::E_OK) {
+        REQUEST_HILOGE("Creates request_task_progress trigger failed, ret: %{public}d", ret);
+        return ret;
+    }
+    REQUEST_HILOGI("Creates request_task_progress table success");
+    return ret;
+}
+
+bool RequestTaskTableExists(OHOS::NativeRdb::RdbStore &store)
+{
+    auto resultSet = store.QuerySql(CHECK_REQUEST_TASK);
+    if (resultSet == nullptr) {
+        return false;
+    }
+    int rowCount = 0;
+    int ret = resultSet->GetRowCount(rowCount);
+    resultSet->Close();
+    return ret == OHOS::NativeRdb::E_OK && rowCount != 0;
+}
+
+// Moves the progress columns of existing tasks into `request_task_progress`.
+int RequestDBSplitProgressTable(OHOS::NativeRdb::RdbStore &store)
+{
+    // Stores older than 4.1 have no `request_task` table yet, it is created
+    // together with the progress table when the store is opened.
+    if (!RequestTaskTableExists(store)) {
+        return OHOS::NativeRdb::E_OK;
+    }
+    int ret = RequestDBCreateProgressTable(store);
+    if (ret != OHOS::NativeRdb::E_OK) {
+        return ret;
+    }
+    ret = store.ExecuteSql(REQUEST_TASK_PROGRESS_TABLE_MIGRATE);
+    if (ret != OHOS::NativeRdb::E_OK) {
+        REQUEST_HILOGE("Migrates task progress failed, ret: %{public}d", ret);
+        return ret;
+    }
+    REQUEST_HILOGI("Migrates task progress success");
+    return ret;
+}
+
+int RequestDBCreateTaskIndexes(OHOS::NativeRdb::RdbStore &store)
+{
+    for (const char *sql : { REQUEST_TASK_TABLE_ADD_QOS_INDEX, REQUEST_TASK_TABLE_ADD_STATE_INDEX,
+             REQUEST_TASK_TABLE_ADD_BUNDLE_INDEX }) {
+        int ret = store.ExecuteSql(sql);
+        if (ret != OHOS::NativeRdb::E_OK) {
+            REQUEST_HILOGE("Creates request_task index failed, ret: %{public}d", ret);
+            return ret;
+        }
+    }
+    REQUEST_HILOGI("Creates request_task indexes success");
+    return OHOS::NativeRdb::E_OK;
+}
+
+// Searches fall back to scanning the tasks if the store cannot create the index, so
+// failures are only logged.
+void RequestDBCreateSearchIndex(OHOS::NativeRdb::RdbStore &store)
+{
+    for (const char *sql : { CREATE_REQUEST_TASK_SEARCH_TABLE, REQUEST_TASK_SEARCH_TABLE_ADD_INSERT_TRIGGER,
+             REQUEST_TASK_SEARCH_TABLE_ADD_DELETE_TRIGGER, REQUEST_TASK_SEARCH_TABLE_ADD_UPDATE_TRIGGER,
+             REQUEST_TASK_SEARCH_TABLE_REBUILD }) {
+        int ret = store.ExecuteSql(sql);
+        if (ret != OHOS::NativeRdb::E_OK) {
+            REQUEST_HILOGE("Creates request_task_search index failed, ret: %{public}d", ret);
+            return;
+        }
+    }
+    REQUEST_HILOGI("Creates request_task_search index success");
+}
+
 int RequestDBCreateTables(OHOS::NativeRdb::RdbStore &store)
 {
     // Creates request_version table first.
@@ -440,7 +728,15 @@ int RequestDBCreateTables(OHOS::NativeRdb::RdbStore &store)
         return ret;
     }
     REQUEST_HILOGI("Creates request_task table success");
-    return ret;
+
+    ret = RequestDBCreateTaskIndexes(store);
+    if (ret != OHOS::NativeRdb::E_OK) {
+        return ret;
+    }
+    RequestDBCreateSearchIndex(store);
+
+    // ..and the progress table that goes with it.
+    return RequestDBCreateProgressTable(store);
 }
 
 bool ColumnExists(OHOS::NativeRdb::RdbStore &store, const std::string& columnName)
@@ -590,6 +886,42 @@ void RequestDBUpgradeFrom60(OHOS::NativeRdb::RdbStore &store)
     if (!ColumnExists(store, REQUEST_TASK_TABLE_COL_TASK_TIME)) {
         store.ExecuteSql(REQUEST_TASK_TABLE_ADD_TASK_TIME);
     }
+    if (!ColumnExists(store, REQUEST_TASK_TABLE_COL_CHECKSUM)) {
+        store.ExecuteSql(REQUEST_TASK_TABLE_ADD_CHECKSUM);
+    }
+    if (!ColumnExists(store, REQUEST_TASK_TABLE_COL_STALL_WINDOW)) {
+        store.ExecuteSql(REQUEST_TASK_TABLE_ADD_STALL_WINDOW);
+    }
+    if (!ColumnExists(store, REQUEST_TASK_TABLE_COL_STALL_RATIO)) {
+        store.ExecuteSql(REQUEST_TASK_TABLE_ADD_STALL_RATIO);
+    }
+    if (!ColumnExists(store, REQUEST_TASK_TABLE_COL_CONCURRENCY)) {
+        store.ExecuteSql(REQUEST_TASK_TABLE_ADD_CONCURRENCY);
+    }
+    if (!ColumnExists(store, REQUEST_TASK_TABLE_COL_CHUNK_SIZE)) {
+        store.ExecuteSql(REQUEST_TASK_TABLE_ADD_CHUNK_SIZE);
+    }
+    if (!ColumnExists(store, REQUEST_TASK_TABLE_COL_DEADLINE)) {
+        store.ExecuteSql(REQUEST_TASK_TABLE_ADD_DEADLINE);
+    }
+    if (!ColumnExists(store, REQUEST_TASK_TABLE_COL_COALESCE)) {
+        store.ExecuteSql(REQUEST_TASK_TABLE_ADD_COALESCE);
+    }
+    if (!ColumnExists(store, REQUEST_TASK_TABLE_COL_COMPRESSION)) {
+        store.ExecuteSql(REQUEST_TASK_TABLE_ADD_COMPRESSION);
+    }
+    if (!ColumnExists(store, REQUEST_TASK_TABLE_COL_MEMORY_LIMIT)) {
+        store.ExecuteSql(REQUEST_TASK_TABLE_ADD_MEMORY_LIMIT);
+    }
+    if (!ColumnExists(store, REQUEST_TASK_TABLE_COL_PREFETCH)) {
+        store.ExecuteSql(REQUEST_TASK_TABLE_ADD_PREFETCH);
+    }
+    if (!ColumnExists(store, REQUEST_TASK_TABLE_COL_PERFORMANCE)) {
+        store.ExecuteSql(REQUEST_TASK_TABLE_ADD_PERFORMANCE);
+    }
+    if (!ColumnExists(store, REQUEST_TASK_TABLE_COL_BYPASS_CACHE)) {
+        store.ExecuteSql(REQUEST_TASK_TABLE_ADD_BYPASS_CACHE);
+    }
 }
 
 int RequestDBUpgrade(OHOS::NativeRdb::RdbStore &store)
@@ -690,6 +1022,23 @@ int RequestDBOpenCallback::OnOpen(OHOS::NativeRdb::RdbStore &store)
 
 int RequestDBOpenCallback::OnUpgrade(OHOS::NativeRdb::RdbStore &store, int oldVersion, int newVersion)
 {
+    REQUEST_HILOGI("Upgrades store version from %{public}d to %{public}d", oldVersion, newVersion);
+    if (oldVersion < DATABASE_VERSION_PROGRESS_TABLE) {
+        int ret = RequestDBSplitProgressTable(store);
+        if (ret != OHOS::NativeRdb::E_OK) {
+            return ret;
+        }
+    }
+    // Stores without `request_task` get the indexes when the table is created.
+    if (oldVersion < DATABASE_VERSION_TASK_INDEXES && RequestTaskTableExists(store)) {
+        int ret = RequestDBCreateTaskIndexes(store);
+        if (ret != OHOS::NativeRdb::E_OK) {
+            return ret;
+        }
+    }
+    if (oldVersion < DATABASE_VERSION_TASK_SEARCH && RequestTaskTableExists(store)) {
+        RequestDBCreateSearchIndex(store);
+    }
     return OHOS::NativeRdb::E_OK;
 }
 
@@ -700,153 +1049,305 @@ int RequestDBOpenCallback::OnDowngrade(OHOS::NativeRdb::RdbStore &store, int old
 } // namespace OHOS::Request
 
 namespace {
-std::vector<uint8_t> CFormItemToBlob(const CFormItem *cpointer, uint32_t length)
+// Blob layout written by this version, all integers are little endian `uint32_t`:
+//
+//   | magic "RQBLOB" | version | kind | count | offsets[count * fields + 1] | flags[count] | strings |
+//
+// Every entry has `fields` strings, string `i` spans `[offsets[i], offsets[i + 1])` of the
+// string area, so they are read in place. `flags` only exists for file specs and holds
+// `is_user_file`. Blobs without the magic were written by older versions, which copied
+// the raw C structs, and are read with the legacy loaders below.
+constexpr uint8_t TASK_BLOB_MAGIC[] = { 'R', 'Q', 'B', 'L', 'O', 'B' };
+constexpr uint8_t TASK_BLOB_VERSION = 1;
+constexpr size_t TASK_BLOB_HEADER_SIZE = sizeof(TASK_BLOB_MAGIC) + 2 + sizeof(uint32_t);
+
+enum class TaskBlobKind : uint8_t {
+    FORM_ITEMS = 1,
+    FILE_SPECS = 2,
+    STRINGS = 3,
+};
+
+constexpr uint32_t FORM_ITEM_FIELDS = 2;
+constexpr uint32_t FILE_SPEC_FIELDS = 4;
+constexpr uint32_t STRING_FIELDS = 1;
+
+void PutU32(std::vector<uint8_t> &blob, uint32_t value)
 {
+    for (size_t i = 0; i < sizeof(uint32_t); i++) {
+        blob.push_back(static_cast<uint8_t>(value >> (i * 8)));
+    }
+}
+
+uint32_t GetU32(const uint8_t *data)
+{
+    uint32_t value = 0;
+    for (size_t i = 0; i < sizeof(uint32_t); i++) {
+        value |= static_cast<uint32_t>(data[i]) << (i * 8);
+    }
+    return value;
+}
+
+std::vector<uint8_t> WriteTaskBlob(
+    TaskBlobKind kind, uint32_t count, const std::vector<std::string_view> &fields, const std::vector<uint8_t> &flags)
+{
+    size_t dataLen = 0;
+    for (const auto &field : fields) {
+        dataLen += field.size();
+    }
     std::vector<uint8_t> blob;
-    for (uint32_t i = 0; i < length; ++i) {
-        const CFormItem &obj = cpointer[i];
-        const uint8_t *objBytes = reinterpret_cast<const uint8_t *>(&obj);
-        blob.insert(blob.end(), objBytes, objBytes + sizeof(CFormItem));
-        blob.insert(blob.end(), obj.name.cStr, obj.name.cStr + obj.name.len);
-        blob.insert(blob.end(), obj.value.cStr, obj.value.cStr + obj.value.len);
+    blob.reserve(TASK_BLOB_HEADER_SIZE + (fields.size() + 1) * sizeof(uint32_t) + flags.size() + dataLen);
+    blob.insert(blob.end(), std::begin(TASK_BLOB_MAGIC), std::end(TASK_BLOB_MAGIC));
+    blob.push_back(TASK_BLOB_VERSION);
+    blob.push_back(static_cast<uint8_t>(kind));
+    PutU32(blob, count);
+    uint32_t offset = 0;
+    PutU32(blob, offset);
+    for (const auto &field : fields) {
+        offset += static_cast<uint32_t>(field.size());
+        PutU32(blob, offset);
+    }
+    blob.insert(blob.end(), flags.begin(), flags.end());
+    for (const auto &field : fields) {
+        blob.insert(blob.end(), field.begin(), field.end());
     }
     return blob;
 }
 
-std::vector<CFormItem> BlobToCFormItem(const std::vector<uint8_t> &blob)
-{
-    std::vector<CFormItem> vec;
-    size_t position = 0;
-    while (position < blob.size()) {
-        CFormItem obj;
-        memcpy_s(&obj, sizeof(CFormItem), blob.data() + position, sizeof(CFormItem));
-        position += sizeof(CFormItem);
+// A validated view into a blob in the current layout.
+class TaskBlobView {
+public:
+    // Returns false if `blob` is not a well formed blob of `kind`.
+    bool Parse(const std::vector<uint8_t> &blob, TaskBlobKind kind, uint32_t fields, bool hasFlags)
+    {
+        if (blob.size() < TASK_BLOB_HEADER_SIZE ||
+            !std::equal(std::begin(TASK_BLOB_MAGIC), std::end(TASK_BLOB_MAGIC), blob.begin()) ||
+            blob[sizeof(TASK_BLOB_MAGIC)] != TASK_BLOB_VERSION ||
+            blob[sizeof(TASK_BLOB_MAGIC) + 1] != static_cast<uint8_t>(kind)) {
+            return false;
+        }
+        uint64_t count = GetU32(blob.data() + sizeof(TASK_BLOB_MAGIC) + 2);
+        uint64_t offsetsLen = (count * fields + 1) * sizeof(uint32_t);
+        uint64_t flagsLen = hasFlags ? count : 0;
+        if (blob.size() - TASK_BLOB_HEADER_SIZE < offsetsLen + flagsLen) {
+            return false;
+        }
+        offsets_ = blob.data() + TASK_BLOB_HEADER_SIZE;
+        flags_ = offsets_ + offsetsLen;
+        data_ = reinterpret_cast<const char *>(flags_ + flagsLen);
+        size_t dataLen = blob.size() - TASK_BLOB_HEADER_SIZE - offsetsLen - flagsLen;
+        count_ = static_cast<uint32_t>(count);
+        fields_ = fields;
+
+        uint32_t previous = GetU32(offsets_);
+        if (previous != 0) {
+            return false;
+        }
+        for (uint64_t i = 1; i <= count * fields; i++) {
+            uint32_t offset = GetU32(offsets_ + i * sizeof(uint32_t));
+            if (offset < previous) {
+                return false;
+            }
+            previous = offset;
+        }
+        return previous == dataLen;
+    }
 
-        obj.name.cStr = new char[obj.name.len];
-        memcpy_s(obj.name.cStr, obj.name.len, blob.data() + position, obj.name.len);
-        position += obj.name.len;
+    uint32_t Count() const
+    {
+        return count_;
+    }
 
-        obj.value.cStr = new char[obj.value.len];
-        memcpy_s(obj.value.cStr, obj.value.len, blob.data() + position, obj.value.len);
-        position += obj.value.len;
+    std::string_view Field(uint32_t entry, uint32_t field) const
+    {
+        size_t index = static_cast<size_t>(entry) * fields_ + field;
+        uint32_t begin = GetU32(offsets_ + index * sizeof(uint32_t));
+        uint32_t end = GetU32(offsets_ + (index + 1) * sizeof(uint32_t));
+        return std::string_view(data_ + begin, end - begin);
+    }
 
-        vec.push_back(obj);
+    bool Flag(uint32_t entry) const
+    {
+        return flags_[entry] != 0;
     }
-    return vec;
+
+private:
+    const uint8_t *offsets_ = nullptr;
+    const uint8_t *flags_ = nullptr;
+    const char *data_ = nullptr;
+    uint32_t count_ = 0;
+    uint32_t fields_ = 0;
+};
+
+std::string_view View(const CStringWrapper &str)
+{
+    return std::string_view(str.cStr, str.len);
+}
+
+std::vector<uint8_t> CFormItemToBlob(const CFormItem *cpointer, uint32_t length)
+{
+    std::vector<std::string_view> fields;
+    fields.reserve(static_cast<size_t>(length) * FORM_ITEM_FIELDS);
+    for (uint32_t i = 0; i < length; ++i) {
+        fields.push_back(View(cpointer[i].name));
+        fields.push_back(View(cpointer[i].value));
+    }
+    return WriteTaskBlob(TaskBlobKind::FORM_ITEMS, length, fields, {});
 }
 
 std::vector<uint8_t> CFileSpecToBlob(const CFileSpec *cpointer, uint32_t length)
 {
-    std::vector<uint8_t> blob;
+    std::vector<std::string_view> fields;
+    std::vector<uint8_t> flags;
+    fields.reserve(static_cast<size_t>(length) * FILE_SPEC_FIELDS);
+    flags.reserve(length);
     for (uint32_t i = 0; i < length; ++i) {
         const CFileSpec &obj = cpointer[i];
-        const uint8_t *objBytes = reinterpret_cast<const uint8_t *>(&obj);
-        blob.insert(blob.end(), objBytes, objBytes + sizeof(CFileSpec));
-        blob.insert(blob.end(), obj.name.cStr, obj.name.cStr + obj.name.len);
-        blob.insert(blob.end(), obj.path.cStr, obj.path.cStr + obj.path.len);
-        blob.insert(blob.end(), obj.fileName.cStr, obj.fileName.cStr + obj.fileName.len);
-        blob.insert(blob.end(), obj.mimeType.cStr, obj.mimeType.cStr + obj.mimeType.len);
-        blob.emplace_back(obj.is_user_file);
+        fields.push_back(View(obj.name));
+        fields.push_back(View(obj.path));
+        fields.push_back(View(obj.fileName));
+        fields.push_back(View(obj.mimeType));
+        flags.push_back(static_cast<uint8_t>(obj.is_user_file));
     }
-    return blob;
+    return WriteTaskBlob(TaskBlobKind::FILE_SPECS, length, fields, flags);
 }
 
-std::vector<CFileSpec> BlobToCFileSpec(const std::vector<uint8_t> &blob)
+std::vector<uint8_t> CStringToBlob(const CStringWrapper *cpointer, uint32_t length)
 {
-    std::vector<CFileSpec> vec;
-    size_t position = 0;
-    while (position < blob.size()) {
-        CFileSpec obj;
-        memcpy_s(&obj, sizeof(CFileSpec), blob.data() + position, sizeof(CFileSpec));
-        position += sizeof(CFileSpec);
-
-        obj.name.cStr = new char[obj.name.len];
-        memcpy_s(obj.name.cStr, obj.name.len, blob.data() + position, obj.name.len);
-        position += obj.name.len;
-
-        obj.path.cStr = new char[obj.path.len];
-        memcpy_s(obj.path.cStr, obj.path.len, blob.data() + position, obj.path.len);
-        position += obj.path.len;
-
-        obj.fileName.cStr = new char[obj.fileName.len];
-        memcpy_s(obj.fileName.cStr, obj.fileName.len, blob.data() + position, obj.fileName.len);
-        position += obj.fileName.len;
+    std::vector<std::string_view> fields;
+    fields.reserve(length);
+    for (uint32_t i = 0; i < length; ++i) {
+        fields.push_back(View(cpointer[i]));
+    }
+    return WriteTaskBlob(TaskBlobKind::STRINGS, length, fields, {});
+}
 
-        obj.mimeType.cStr = new char[obj.mimeType.len];
-        memcpy_s(obj.mimeType.cStr, obj.mimeType.len, blob.data() + position, obj.mimeType.len);
-        position += obj.mimeType.len;
+// Reads `len` bytes at `position` of a legacy blob into `str`, returns false if the
+// blob is too short.
+bool LegacyReadString(const std::vector<uint8_t> &blob, size_t &position, size_t len, std::string &str)
+{
+    if (blob.size() - position < len) {
+        return false;
+    }
+    str.assign(reinterpret_cast<const char *>(blob.data()) + position, len);
+    position += len;
+    return true;
+}
 
-        obj.is_user_file = blob[position];
-        position += 1;
+// Loads form items written by versions that copied the raw `CFormItem` structs.
+std::vector<FormItem> LegacyBlobToFormItems(const std::vector<uint8_t> &blob)
+{
+    std::vector<FormItem> vec;
+    size_t position = 0;
+    while (blob.size() - position >= sizeof(CFormItem)) {
+        CFormItem obj;
+        memcpy_s(&obj, sizeof(CFormItem), blob.data() + position, sizeof(CFormItem));
+        position += sizeof(CFormItem);
 
-        vec.push_back(obj);
+        FormItem formItem;
+        if (!LegacyReadString(blob, position, obj.name.len, formItem.name) ||
+            !LegacyReadString(blob, position, obj.value.len, formItem.value)) {
+            break;
+        }
+        vec.push_back(std::move(formItem));
     }
     return vec;
 }
 
-std::vector<uint8_t> CStringToBlob(const CStringWrapper *cpointer, uint32_t length)
+// Loads file specs written by versions that copied the raw `CFileSpec` structs.
+std::vector<FileSpec> LegacyBlobToFileSpecs(const std::vector<uint8_t> &blob)
 {
-    std::vector<uint8_t> blob;
-    for (uint32_t i = 0; i < length; ++i) {
-        const CStringWrapper &obj = cpointer[i];
-        blob.push_back(static_cast<uint8_t>(obj.len));
-        blob.insert(blob.end(), obj.cStr, obj.cStr + obj.len);
+    std::vector<FileSpec> vec;
+    size_t position = 0;
+    while (blob.size() - position >= sizeof(CFileSpec)) {
+        CFileSpec obj;
+        memcpy_s(&obj, sizeof(CFileSpec), blob.data() + position, sizeof(CFileSpec));
+        position += sizeof(CFileSpec);
+
+        FileSpec fileSpec;
+        if (!LegacyReadString(blob, position, obj.name.len, fileSpec.name) ||
+            !LegacyReadString(blob, position, obj.path.len, fileSpec.path) ||
+            !LegacyReadString(blob, position, obj.fileName.len, fileSpec.fileName) ||
+            !LegacyReadString(blob, position, obj.mimeType.len, fileSpec.mimeType) || position >= blob.size()) {
+            break;
+        }
+        fileSpec.is_user_file = blob[position];
+        position += 1;
+        vec.push_back(std::move(fileSpec));
     }
-    return blob;
+    return vec;
 }
 
-std::vector<std::string> BlobToStringVec(const std::vector<uint8_t> &blob)
+// Loads strings written by versions that prefixed every string with a `uint8_t` length.
+std::vector<std::string> LegacyBlobToStrings(const std::vector<uint8_t> &blob)
 {
     std::vector<std::string> vec;
-    uint32_t position = 0;
+    size_t position = 0;
     while (position < blob.size()) {
-        uint32_t len = static_cast<uint32_t>(blob[position++]);
-        std::string str(blob.begin() + position, blob.begin() + position + len);
-        position += len;
-
+        size_t len = blob[position++];
+        std::string str;
+        if (!LegacyReadString(blob, position, len, str)) {
+            break;
+        }
         vec.push_back(std::move(str));
     }
+    return vec;
+}
 
+std::vector<FormItem> BlobToFormItems(const std::vector<uint8_t> &blob)
+{
+    TaskBlobView view;
+    if (!view.Parse(blob, TaskBlobKind::FORM_ITEMS, FORM_ITEM_FIELDS, false)) {
+        return LegacyBlobToFormItems(blob);
+    }
+    std::vector<FormItem> vec(view.Count());
+    for (uint32_t i = 0; i < view.Count(); i++) {
+        vec[i].name = view.Field(i, 0);
+        vec[i].value = view.Field(i, 1);
+    }
     return vec;
 }
 
-// convert vector<CFormItem> to vector<FormItem>
-std::vector<FormItem> VecToFormItem(const std::vector<CFormItem> &cvec)
+std::vector<FileSpec> BlobToFileSpecs(const std::vector<uint8_t> &blob)
 {
-    std::vector<FormItem> vec;
-    for (const CFormItem &obj : cvec) {
-        FormItem formItem;
-        formItem.name = std::string(obj.name.cStr, obj.name.len);
-        formItem.value = std::string(obj.value.cStr, obj.value.len);
-        vec.push_back(std::move(formItem));
-        //release memory of obj(new)
-        delete[] obj.name.cStr;
-        delete[] obj.value.cStr;
+    TaskBlobView view;
+    if (!view.Parse(blob, TaskBlobKind::FILE_SPECS, FILE_SPEC_FIELDS, true)) {
+        return LegacyBlobToFileSpecs(blob);
+    }
+    std::vector<FileSpec> vec(view.Count());
+    for (uint32_t i = 0; i < view.Count(); i++) {
+        vec[i].name = view.Field(i, 0);
+        vec[i].path = view.Field(i, 1);
+        vec[i].fileName = view.Field(i, 2);
+        vec[i].mimeType = view.Field(i, 3);
+        vec[i].is_user_file = view.Flag(i);
     }
     return vec;
 }
 
-// convert vector<CFileSpec> to vector<FileSpec>
-std::vector<FileSpec> VecToFileSpec(const std::vector<CFileSpec> &cvec)
+std::vector<std::string> BlobToStringVec(const std::vector<uint8_t> &blob)
 {
-    std::vector<FileSpec> vec;
-    for (const CFileSpec &obj : cvec) {
-        FileSpec fileSpec;
-        fileSpec.name = std::string(obj.name.cStr, obj.name.len);
-        fileSpec.path = std::string(obj.path.cStr, obj.path.len);
-        fileSpec.fileName = std::string(obj.fileName.cStr, obj.fileName.len);
-        fileSpec.mimeType = std::string(obj.mimeType.cStr, obj.mimeType.len);
-        fileSpec.is_user_file = obj.is_user_file;
-        vec.push_back(std::move(fileSpec));
-        //release memory of obj(new)
-        delete[] obj.name.cStr;
-        delete[] obj.path.cStr;
-        delete[] obj.fileName.cStr;
-        delete[] obj.mimeType.cStr;
+    TaskBlobView view;
+    if (!view.Parse(blob, TaskBlobKind::STRINGS, STRING_FIELDS, false)) {
+        return LegacyBlobToStrings(blob);
+    }
+    std::vector<std::string> vec;
+    vec.reserve(view.Count());
+    for (uint32_t i = 0; i < view.Count(); i++) {
+        vec.emplace_back(view.Field(i, 0));
     }
     return vec;
 }
 
+template<typename T> void WriteProgressData(OHOS::NativeRdb::ValuesBucket &values, T *info)
+{
+    values.PutString("mime_type", std::string(info->mimeType.cStr, info->mimeType.len));
+    values.PutLong("idx", info->progress.commonData.index);
+    values.PutLong("total_processed", info->progress.commonData.totalProcessed);
+    values.PutString("sizes", std::string(info->progress.sizes.cStr, info->progress.sizes.len));
+    values.PutString("processed", std::string(info->progress.processed.cStr, info->progress.processed.len));
+    values.PutString("extras", std::string(info->progress.extras.cStr, info->progress.extras.len));
+}
+
 template<typename T> bool WriteUpdateData(OHOS::NativeRdb::ValuesBucket &insertValues, T *info)
 {
     // write to insertValues
@@ -929,58 +1430,163 @@ void FillOtherTaskInfo(std::shared_ptr<OHOS::NativeRdb::ResultSet> set, TaskInfo
     std::vector<uint8_t> formSpecsBlob;
 
     set->GetBlob(25, formItemsBlob); // Line 25 is 'form_items'
-    info.formItems = VecToFormItem(BlobToCFormItem(formItemsBlob));
+    info.formItems = BlobToFormItems(formItemsBlob);
     set->GetBlob(26, formSpecsBlob); // Line 26 is 'file_specs'
-    info.fileSpecs = VecToFileSpec(BlobToCFileSpec(formSpecsBlob));
+    info.fileSpecs = BlobToFileSpecs(formSpecsBlob);
     set->GetLong(27, info.maxSpeed); // Line 27 is 'max_speed'
     info.taskTime = static_cast<uint64_t>(GetLong(set, 28)); //  line 28 is 'task_time'
+    set->GetString(29, info.performance); // Line 29 is 'performance'
+}
+
+// Lays out a C struct in a single allocation: the struct, then its arrays, then the bytes of all its strings. Rust
+// reads it in place and releases it at once, with no allocation nor copy per field.
+class FlatBuffer {
+public:
+    FlatBuffer(size_t fixedSize, size_t stringsSize)
+        : buffer_(new (std::nothrow) char[fixedSize + stringsSize]), size_(fixedSize + stringsSize), next_(0),
+          nextString_(fixedSize)
+    {
+    }
+
+    char *Get() const
+    {
+        return buffer_;
+    }
+
+    // Places `count` values after the previous ones, which keeps them aligned as the sizes of all the C structs
+    // are multiples of their 8 bytes alignment.
+    template<typename T> T *Place(size_t count = 1)
+    {
+        T *values = reinterpret_cast<T *>(buffer_ + next_);
+        for (size_t i = 0; i < count; i++) {
+            new (values + i) T();
+        }
+        next_ += sizeof(T) * count;
+        return values;
+    }
+
+    CStringWrapper Wrap(const std::string &str)
+    {
+        CStringWrapper wrapper = { .cStr = buffer_ + nextString_, .len = static_cast<uint32_t>(str.size()) };
+        if (!str.empty()) {
+            memcpy_s(wrapper.cStr, size_ - nextString_, str.data(), str.size());
+        }
+        nextString_ += str.size();
+        return wrapper;
+    }
+
+private:
+    char *buffer_;
+    size_t size_;
+    size_t next_;
+    size_t nextString_;
+};
+
+template<typename... Strings> size_t StringsSize(const Strings &...strings)
+{
+    return (strings.size() + ... + 0);
 }
 
-CProgress BuildCProgress(const Progress &progress)
+size_t StringsSize(const std::vector<std::string> &strings)
+{
+    size_t size = 0;
+    for (const auto &str : strings) {
+        size += str.size();
+    }
+    return size;
+}
+
+size_t StringsSize(const std::vector<FormItem> &formItems)
+{
+    size_t size = 0;
+    for (const auto &formItem : formItems) {
+        size += StringsSize(formItem.name, formItem.value);
+    }
+    return size;
+}
+
+size_t StringsSize(const std::vector<FileSpec> &fileSpecs)
+{
+    size_t size = 0;
+    for (const auto &fileSpec : fileSpecs) {
+        size += StringsSize(fileSpec.name, fileSpec.path, fileSpec.fileName, fileSpec.mimeType);
+    }
+    return size;
+}
+
+CFormItem *PlaceCFormItems(FlatBuffer &buffer, const std::vector<FormItem> &formItems)
+{
+    CFormItem *formItemsPtr = buffer.Place<CFormItem>(formItems.size());
+    for (size_t i = 0; i < formItems.size(); i++) {
+        formItemsPtr[i].name = buffer.Wrap(formItems[i].name);
+        formItemsPtr[i].value = buffer.Wrap(formItems[i].value);
+    }
+    return formItemsPtr;
+}
+
+CFileSpec *PlaceCFileSpecs(FlatBuffer &buffer, const std::vector<FileSpec> &fileSpecs)
+{
+    CFileSpec *fileSpecsPtr = buffer.Place<CFileSpec>(fileSpecs.size());
+    for (size_t i = 0; i < fileSpecs.size(); i++) {
+        fileSpecsPtr[i].name = buffer.Wrap(fileSpecs[i].name);
+        fileSpecsPtr[i].path = buffer.Wrap(fileSpecs[i].path);
+        fileSpecsPtr[i].fileName = buffer.Wrap(fileSpecs[i].fileName);
+        fileSpecsPtr[i].mimeType = buffer.Wrap(fileSpecs[i].mimeType);
+        fileSpecsPtr[i].is_user_file = fileSpecs[i].is_user_file;
+    }
+    return fileSpecsPtr;
+}
+
+CStringWrapper *PlaceCStrings(FlatBuffer &buffer, const std::vector<std::string> &strings)
+{
+    CStringWrapper *stringsPtr = buffer.Place<CStringWrapper>(strings.size());
+    for (size_t i = 0; i < strings.size(); i++) {
+        stringsPtr[i] = buffer.Wrap(strings[i]);
+    }
+    return stringsPtr;
+}
+
+CProgress BuildCProgress(FlatBuffer &buffer, const Progress &progress)
 {
     return CProgress{
         .commonData = progress.commonData,
-        .sizes = WrapperCString(progress.sizes),
-        .processed = WrapperCString(progress.processed),
-        .extras = WrapperCString(progress.extras),
+        .sizes = buffer.Wrap(progress.sizes),
+        .processed = buffer.Wrap(progress.processed),
+        .extras = buffer.Wrap(progress.extras),
     };
 }
 
 CTaskInfo *BuildCTaskInfo(const TaskInfo &taskInfo)
 {
-    uint32_t formItemsLen = taskInfo.formItems.size();
-    CFormItem *formItemsPtr = new CFormItem[formItemsLen];
-    for (uint32_t i = 0; i < formItemsLen; i++) {
-        formItemsPtr[i].name = WrapperCString(taskInfo.formItems[i].name);
-        formItemsPtr[i].value = WrapperCString(taskInfo.formItems[i].value);
-    }
-
-    uint32_t fileSpecsLen = taskInfo.fileSpecs.size();
-    CFileSpec *fileSpecsPtr = new CFileSpec[fileSpecsLen];
-    for (uint32_t i = 0; i < fileSpecsLen; i++) {
-        fileSpecsPtr[i].name = WrapperCString(taskInfo.fileSpecs[i].name);
-        fileSpecsPtr[i].path = WrapperCString(taskInfo.fileSpecs[i].path);
-        fileSpecsPtr[i].fileName = WrapperCString(taskInfo.fileSpecs[i].fileName);
-        fileSpecsPtr[i].mimeType = WrapperCString(taskInfo.fileSpecs[i].mimeType);
-        fileSpecsPtr[i].is_user_file = taskInfo.fileSpecs[i].is_user_file;
-    }
-
-    CTaskInfo *cTaskInfo = new CTaskInfo;
-    cTaskInfo->bundle = WrapperCString(taskInfo.bundle);
-    cTaskInfo->url = WrapperCString(taskInfo.url);
-    cTaskInfo->data = WrapperCString(taskInfo.data);
-    cTaskInfo->token = WrapperCString(taskInfo.token);
-    cTaskInfo->formItemsPtr = formItemsPtr;
-    cTaskInfo->formItemsLen = formItemsLen;
-    cTaskInfo->fileSpecsPtr = fileSpecsPtr;
-    cTaskInfo->fileSpecsLen = fileSpecsLen;
-    cTaskInfo->title = WrapperCString(taskInfo.title);
-    cTaskInfo->description = WrapperCString(taskInfo.description);
-    cTaskInfo->mimeType = WrapperCString(taskInfo.mimeType);
-    cTaskInfo->progress = BuildCProgress(taskInfo.progress);
+    size_t fixedSize = sizeof(CTaskInfo) + sizeof(CFormItem) * taskInfo.formItems.size() +
+                       sizeof(CFileSpec) * taskInfo.fileSpecs.size();
+    size_t stringsSize = StringsSize(taskInfo.bundle, taskInfo.url, taskInfo.data, taskInfo.token, taskInfo.title,
+                             taskInfo.description, taskInfo.mimeType, taskInfo.progress.sizes,
+                             taskInfo.progress.processed, taskInfo.progress.extras, taskInfo.performance) +
+                         StringsSize(taskInfo.formItems) + StringsSize(taskInfo.fileSpecs);
+    FlatBuffer buffer(fixedSize, stringsSize);
+    if (buffer.Get() == nullptr) {
+        REQUEST_HILOGE("alloc task info failed, task_id: %{public}d", taskInfo.commonData.taskId);
+        return nullptr;
+    }
+
+    CTaskInfo *cTaskInfo = buffer.Place<CTaskInfo>();
+    cTaskInfo->bundle = buffer.Wrap(taskInfo.bundle);
+    cTaskInfo->url = buffer.Wrap(taskInfo.url);
+    cTaskInfo->data = buffer.Wrap(taskInfo.data);
+    cTaskInfo->token = buffer.Wrap(taskInfo.token);
+    cTaskInfo->formItemsPtr = PlaceCFormItems(buffer, taskInfo.formItems);
+    cTaskInfo->formItemsLen = taskInfo.formItems.size();
+    cTaskInfo->fileSpecsPtr = PlaceCFileSpecs(buffer, taskInfo.fileSpecs);
+    cTaskInfo->fileSpecsLen = taskInfo.fileSpecs.size();
+    cTaskInfo->title = buffer.Wrap(taskInfo.title);
+    cTaskInfo->description = buffer.Wrap(taskInfo.description);
+    cTaskInfo->mimeType = buffer.Wrap(taskInfo.mimeType);
+    cTaskInfo->progress = BuildCProgress(buffer, taskInfo.progress);
     cTaskInfo->commonData = taskInfo.commonData;
     cTaskInfo->maxSpeed = taskInfo.maxSpeed;
     cTaskInfo->taskTime = taskInfo.taskTime;
+    cTaskInfo->performance = buffer.Wrap(taskInfo.performance);
     return cTaskInfo;
 }
 
@@ -1017,6 +1623,17 @@ void BuildRequestTaskConfigWithInt(std::shared_ptr<OHOS::NativeRdb::ResultSet> s
     config.commonData.timeout.connectionTimeout = static_cast<uint64_t>(GetLong(set, 39));
     // Line 40 is 'totalTimeout'
     config.commonData.timeout.totalTimeout = static_cast<uint64_t>(GetLong(set, 40));
+    config.commonData.stallDetection.window = GetLong(set, 42);        // Line 42 is 'stall_window'
+    config.commonData.stallDetection.ratio = GetLong(set, 43);         // Line 43 is 'stall_ratio'
+    // Line 44 is 'concurrency'
+    config.commonData.concurrency = static_cast<uint32_t>(GetInt(set, 44));
+    config.commonData.chunkSize = static_cast<uint64_t>(GetLong(set, 45)); // Line 45 is 'chunk_size'
+    config.commonData.deadline = static_cast<uint64_t>(GetLong(set, 46));  // Line 46 is 'deadline'
+    config.commonData.coalesce = static_cast<bool>(GetInt(set, 47));       // Line 47 is 'coalesce'
+    config.commonData.compression = static_cast<bool>(GetInt(set, 48));    // Line 48 is 'compression'
+    config.commonData.memoryLimit = static_cast<uint32_t>(GetLong(set, 49)); // Line 49 is 'memory_limit'
+    config.commonData.prefetch = static_cast<bool>(GetInt(set, 50));         // Line 50 is 'prefetch'
+    config.commonData.bypassCache = static_cast<bool>(GetInt(set, 51));      // Line 51 is 'bypass_cache'
 }
 
 void BuildRequestTaskConfigWithString(std::shared_ptr<OHOS::NativeRdb::ResultSet> set, TaskConfig &config)
@@ -1033,6 +1650,7 @@ void BuildRequestTaskConfigWithString(std::shared_ptr<OHOS::NativeRdb::ResultSet
     set->GetString(32, config.proxy);           // Line 32 is 'proxy'
     set->GetString(33, config.certificatePins); // Line 33 is 'certificate_pins'
     set->GetString(35, config.atomicAccount);   // Line 35 is 'atomic_account'
+    set->GetString(41, config.checksum);        // Line 41 is 'checksum'
 }
 
 void BuildRequestTaskConfigWithBlob(std::shared_ptr<OHOS::NativeRdb::ResultSet> set, TaskConfig &config)
@@ -1043,9 +1661,9 @@ void BuildRequestTaskConfigWithBlob(std::shared_ptr<OHOS::NativeRdb::ResultSet>
     std::vector<uint8_t> certsPathsBlob;
 
     set->GetBlob(28, formItemsBlob); // Line 28 is 'form_items'
-    config.formItems = VecToFormItem(BlobToCFormItem(formItemsBlob));
+    config.formItems = BlobToFormItems(formItemsBlob);
     set->GetBlob(29, formSpecsBlob); // Line 29 is 'file_specs'
-    config.fileSpecs = VecToFileSpec(BlobToCFileSpec(formSpecsBlob));
+    config.fileSpecs = BlobToFileSpecs(formSpecsBlob);
     set->GetBlob(30, bodyFileNamesBlob); // Line 30 is 'body_file_names'
     config.bodyFileNames = BlobToStringVec(bodyFileNamesBlob);
     set->GetBlob(31, certsPathsBlob); // Line 31 is 'certs_paths'
@@ -1069,6 +1687,7 @@ void RecordRequestTaskInfo(OHOS::NativeRdb::ValuesBucket &insertValues, CTaskInf
     insertValues.PutInt("retry", taskInfo->commonData.retry);
     insertValues.PutInt("max_speed", taskInfo->maxSpeed);
     insertValues.PutLong("task_time", taskInfo->taskTime);
+    insertValues.PutString("performance", std::string(taskInfo->performance.cStr, taskInfo->performance.len));
 }
 
 void RecordRequestTaskConfig(OHOS::NativeRdb::ValuesBucket &insertValues, CTaskConfig *taskConfig)
@@ -1111,6 +1730,17 @@ void RecordRequestTaskConfig(OHOS::NativeRdb::ValuesBucket &insertValues, CTaskC
     insertValues.PutLong("min_speed_duration", taskConfig->commonData.minSpeed.duration);
     insertValues.PutLong("connection_timeout", taskConfig->commonData.timeout.connectionTimeout);
     insertValues.PutLong("total_timeout", taskConfig->commonData.timeout.totalTimeout);
+    insertValues.PutLong("stall_window", taskConfig->commonData.stallDetection.window);
+    insertValues.PutLong("stall_ratio", taskConfig->commonData.stallDetection.ratio);
+    insertValues.PutInt("concurrency", taskConfig->commonData.concurrency);
+    insertValues.PutLong("chunk_size", taskConfig->commonData.chunkSize);
+    insertValues.PutLong("deadline", taskConfig->commonData.deadline);
+    insertValues.PutInt("coalesce", taskConfig->commonData.coalesce);
+    insertValues.PutInt("compression", taskConfig->commonData.compression);
+    insertValues.PutLong("memory_limit", taskConfig->commonData.memoryLimit);
+    insertValues.PutInt("prefetch", taskConfig->commonData.prefetch);
+    insertValues.PutInt("bypass_cache", taskConfig->commonData.bypassCache);
+    insertValues.PutString("checksum", std::string(taskConfig->checksum.cStr, taskConfig->checksum.len));
 }
 
 bool RecordRequestTask(CTaskInfo *taskInfo, CTaskConfig *taskConfig)
@@ -1125,32 +1755,38 @@ bool RecordRequestTask(CTaskInfo *taskInfo, CTaskConfig *taskConfig)
         REQUEST_HILOGE("write blob data failed");
         return false;
     }
-    if (!OHOS::Request::RequestDataBase::GetInstance(OHOS::Request::DB_NAME, true)
-             .Insert(std::string("request_task"), insertValues)) {
+    OHOS::Request::RequestDataBase &database =
+        OHOS::Request::RequestDataBase::GetInstance(OHOS::Request::DB_NAME, true);
+    if (!database.Insert(std::string("request_task"), insertValues)) {
         REQUEST_HILOGE("insert to request_task failed, task_id: %{public}d", taskConfig->commonData.taskId);
         return false;
     }
     REQUEST_HILOGD("insert to request_task success");
+
+    OHOS::NativeRdb::ValuesBucket progressValues;
+    progressValues.PutLong("task_id", taskConfig->commonData.taskId);
+    progressValues.PutLong("mtime", taskInfo->commonData.mtime);
+    progressValues.PutLong("tries", taskInfo->commonData.tries);
+    WriteProgressData(progressValues, taskInfo);
+    if (!database.Replace(std::string(OHOS::Request::REQUEST_TASK_PROGRESS_TABLE_NAME), progressValues)) {
+        REQUEST_HILOGE("insert to request_task_progress failed, task_id: %{public}d", taskConfig->commonData.taskId);
+        return false;
+    }
     return true;
 }
 
 bool UpdateRequestTask(uint32_t taskId, CUpdateInfo *updateInfo)
 {
-    REQUEST_HILOGD("update request_task");
+    REQUEST_HILOGD("update request_task_progress");
     OHOS::NativeRdb::ValuesBucket values;
+    values.PutLong("task_id", taskId);
     values.PutLong("mtime", updateInfo->mtime);
     values.PutLong("tries", updateInfo->tries);
-    // write to insertValues
-    values.PutString("mime_type", std::string(updateInfo->mimeType.cStr, updateInfo->mimeType.len));
-    values.PutLong("idx", updateInfo->progress.commonData.index);
-    values.PutLong("total_processed", updateInfo->progress.commonData.totalProcessed);
-    values.PutString("processed", std::string(updateInfo->progress.processed.cStr, updateInfo->progress.processed.len));
-    values.PutString("extras", std::string(updateInfo->progress.extras.cStr, updateInfo->progress.extras.len));
+    WriteProgressData(values, updateInfo);
 
-    OHOS::NativeRdb::RdbPredicates rdbPredicates("request_task");
-    rdbPredicates.EqualTo("task_id", std::to_string(taskId));
-    if (!OHOS::Request::RequestDataBase::GetInstance(OHOS::Request::DB_NAME, true).Update(values, rdbPredicates)) {
-        REQUEST_HILOGE("update table1 failed, task_id: %{public}d", taskId);
+    if (!OHOS::Request::RequestDataBase::GetInstance(OHOS::Request::DB_NAME, true)
+             .Replace(std::string(OHOS::Request::REQUEST_TASK_PROGRESS_TABLE_NAME), values)) {
+        REQUEST_HILOGE("update request_task_progress failed, task_id: %{public}d", taskId);
         return false;
     }
     return true;
@@ -1188,14 +1824,24 @@ bool UpdateRequestTaskState(uint32_t taskId, CUpdateStateInfo *updateStateInfo)
     return true;
 }
 
-int GetTaskInfoInner(const OHOS::NativeRdb::RdbPredicates &rdbPredicates, TaskInfo &taskInfo)
+// Progress columns are read from `request_task_progress`, falling back to the legacy
+// `request_task` columns for rows that have not been migrated.
+constexpr const char *QUERY_TASK_INFO = "SELECT t.task_id, t.uid, t.action, t.mode, t.ctime, "
+                                        "MAX(IFNULL(t.mtime, 0), IFNULL(p.mtime, 0)), t.reason, t.gauge, "
+                                        "t.retry, IFNULL(p.tries, t.tries), t.version, t.priority, t.bundle, "
+                                        "t.url, t.data, t.token, t.title, t.description, "
+                                        "IFNULL(p.mime_type, t.mime_type), t.state, IFNULL(p.idx, t.idx), "
+                                        "IFNULL(p.total_processed, t.total_processed), "
+                                        "IFNULL(p.sizes, t.sizes), IFNULL(p.processed, t.processed), "
+                                        "IFNULL(p.extras, t.extras), t.form_items, t.file_specs, "
+                                        "t.max_speed, t.task_time, IFNULL(t.performance, '') FROM request_task AS t "
+                                        "LEFT JOIN request_task_progress AS p ON p.task_id = t.task_id "
+                                        "WHERE t.task_id = ?";
+
+int GetTaskInfoInner(uint32_t taskId, TaskInfo &taskInfo)
 {
-    auto resultSet =
-        OHOS::Request::RequestDataBase::GetInstance(OHOS::Request::DB_NAME, true)
-            .Query(rdbPredicates, { "task_id", "uid", "action", "mode", "ctime", "mtime", "reason", "gauge", "retry",
-                                      "tries", "version", "priority", "bundle", "url", "data", "token", "title",
-                                      "description", "mime_type", "state", "idx", "total_processed", "sizes",
-                                      "processed", "extras", "form_items", "file_specs", "max_speed", "task_time" });
+    auto resultSet = OHOS::Request::RequestDataBase::GetInstance(OHOS::Request::DB_NAME, true)
+                         .QuerySql(QUERY_TASK_INFO, { OHOS::NativeRdb::ValueObject(static_cast<int64_t>(taskId)) });
     if (resultSet == nullptr || resultSet->GoToFirstRow() != OHOS::NativeRdb::E_OK) {
         REQUEST_HILOGE("result set is nullptr or go to first row failed");
         return OHOS::Request::QUERY_ERR;
@@ -1208,11 +1854,8 @@ int GetTaskInfoInner(const OHOS::NativeRdb::RdbPredicates &rdbPredicates, TaskIn
 
 CTaskInfo *GetTaskInfo(uint32_t taskId)
 {
-    OHOS::NativeRdb::RdbPredicates rdbPredicates("request_task");
-    rdbPredicates.EqualTo("task_id", std::to_string(taskId));
-
     TaskInfo taskInfo;
-    if (GetTaskInfoInner(rdbPredicates, taskInfo) == OHOS::Request::QUERY_ERR) {
+    if (GetTaskInfoInner(taskId, taskInfo) == OHOS::Request::QUERY_ERR) {
         REQUEST_HILOGE("QueryRequestTaskInfo failed: result set is nullptr or go to first row failed, "
                        "task_id: %{public}d",
             taskId);
@@ -1222,59 +1865,49 @@ CTaskInfo *GetTaskInfo(uint32_t taskId)
     return BuildCTaskInfo(taskInfo);
 }
 
-void BuildCTaskConfig(CTaskConfig *cTaskConfig, const TaskConfig &taskConfig)
+CTaskConfig *BuildCTaskConfig(const TaskConfig &taskConfig)
 {
-    cTaskConfig->bundle = WrapperCString(taskConfig.bundle);
-    cTaskConfig->url = WrapperCString(taskConfig.url);
-    cTaskConfig->title = WrapperCString(taskConfig.title);
-    cTaskConfig->description = WrapperCString(taskConfig.description);
-    cTaskConfig->method = WrapperCString(taskConfig.method);
-    cTaskConfig->headers = WrapperCString(taskConfig.headers);
-    cTaskConfig->data = WrapperCString(taskConfig.data);
-    cTaskConfig->token = WrapperCString(taskConfig.token);
-    cTaskConfig->extras = WrapperCString(taskConfig.extras);
-    cTaskConfig->proxy = WrapperCString(taskConfig.proxy);
-    cTaskConfig->certificatePins = WrapperCString(taskConfig.certificatePins);
+    size_t fixedSize = sizeof(CTaskConfig) + sizeof(CFormItem) * taskConfig.formItems.size() +
+                       sizeof(CFileSpec) * taskConfig.fileSpecs.size() +
+                       sizeof(CStringWrapper) * (taskConfig.bodyFileNames.size() + taskConfig.certsPath.size());
+    size_t stringsSize = StringsSize(taskConfig.bundle, taskConfig.url, taskConfig.title, taskConfig.description,
+                             taskConfig.method, taskConfig.headers, taskConfig.data, taskConfig.token,
+                             taskConfig.extras, taskConfig.proxy, taskConfig.certificatePins, taskConfig.checksum,
+                             taskConfig.atomicAccount) +
+                         StringsSize(taskConfig.formItems) + StringsSize(taskConfig.fileSpecs) +
+                         StringsSize(taskConfig.bodyFileNames) + StringsSize(taskConfig.certsPath);
+    FlatBuffer buffer(fixedSize, stringsSize);
+    if (buffer.Get() == nullptr) {
+        REQUEST_HILOGE("alloc task config failed, task_id: %{public}d", taskConfig.commonData.taskId);
+        return nullptr;
+    }
+
+    CTaskConfig *cTaskConfig = buffer.Place<CTaskConfig>();
+    cTaskConfig->bundle = buffer.Wrap(taskConfig.bundle);
+    cTaskConfig->url = buffer.Wrap(taskConfig.url);
+    cTaskConfig->title = buffer.Wrap(taskConfig.title);
+    cTaskConfig->description = buffer.Wrap(taskConfig.description);
+    cTaskConfig->method = buffer.Wrap(taskConfig.method);
+    cTaskConfig->headers = buffer.Wrap(taskConfig.headers);
+    cTaskConfig->data = buffer.Wrap(taskConfig.data);
+    cTaskConfig->token = buffer.Wrap(taskConfig.token);
+    cTaskConfig->extras = buffer.Wrap(taskConfig.extras);
+    cTaskConfig->proxy = buffer.Wrap(taskConfig.proxy);
+    cTaskConfig->certificatePins = buffer.Wrap(taskConfig.certificatePins);
+    cTaskConfig->checksum = buffer.Wrap(taskConfig.checksum);
     cTaskConfig->version = taskConfig.version;
     cTaskConfig->bundleType = taskConfig.bundleType;
-    cTaskConfig->atomicAccount = WrapperCString(taskConfig.atomicAccount);
-
-    uint32_t formItemsLen = taskConfig.formItems.size();
-    CFormItem *formItemsPtr = new CFormItem[formItemsLen];
-    for (uint32_t j = 0; j < formItemsLen; j++) {
-        formItemsPtr[j].name = WrapperCString(taskConfig.formItems[j].name);
-        formItemsPtr[j].value = WrapperCString(taskConfig.formItems[j].value);
-    }
-    uint32_t fileSpecsLen = taskConfig.fileSpecs.size();
-    CFileSpec *fileSpecsPtr = new CFileSpec[fileSpecsLen];
-    for (uint32_t j = 0; j < fileSpecsLen; j++) {
-        fileSpecsPtr[j].name = WrapperCString(taskConfig.fileSpecs[j].name);
-        fileSpecsPtr[j].path = WrapperCString(taskConfig.fileSpecs[j].path);
-        fileSpecsPtr[j].fileName = WrapperCString(taskConfig.fileSpecs[j].fileName);
-        fileSpecsPtr[j].mimeType = WrapperCString(taskConfig.fileSpecs[j].mimeType);
-        fileSpecsPtr[j].is_user_file = taskConfig.fileSpecs[j].is_user_file;
-    }
-    uint32_t bodyFileNamesLen = taskConfig.bodyFileNames.size();
-    CStringWrapper *bodyFileNamesPtr = new CStringWrapper[bodyFileNamesLen];
-    for (uint32_t j = 0; j < bodyFileNamesLen; j++) {
-        bodyFileNamesPtr[j] = WrapperCString(taskConfig.bodyFileNames[j]);
-    }
-
-    uint32_t certsPathLen = taskConfig.certsPath.size();
-    CStringWrapper *certsPathPtr = new CStringWrapper[certsPathLen];
-    for (uint32_t j = 0; j < certsPathLen; j++) {
-        certsPathPtr[j] = WrapperCString(taskConfig.certsPath[j]);
-    }
-
-    cTaskConfig->formItemsPtr = formItemsPtr;
-    cTaskConfig->formItemsLen = formItemsLen;
-    cTaskConfig->fileSpecsPtr = fileSpecsPtr;
-    cTaskConfig->fileSpecsLen = fileSpecsLen;
-    cTaskConfig->bodyFileNamesPtr = bodyFileNamesPtr;
-    cTaskConfig->bodyFileNamesLen = bodyFileNamesLen;
-    cTaskConfig->certsPathPtr = certsPathPtr;
-    cTaskConfig->certsPathLen = certsPathLen;
+    cTaskConfig->atomicAccount = buffer.Wrap(taskConfig.atomicAccount);
+    cTaskConfig->formItemsPtr = PlaceCFormItems(buffer, taskConfig.formItems);
+    cTaskConfig->formItemsLen = taskConfig.formItems.size();
+    cTaskConfig->fileSpecsPtr = PlaceCFileSpecs(buffer, taskConfig.fileSpecs);
+    cTaskConfig->fileSpecsLen = taskConfig.fileSpecs.size();
+    cTaskConfig->bodyFileNamesPtr = PlaceCStrings(buffer, taskConfig.bodyFileNames);
+    cTaskConfig->bodyFileNamesLen = taskConfig.bodyFileNames.size();
+    cTaskConfig->certsPathPtr = PlaceCStrings(buffer, taskConfig.certsPath);
+    cTaskConfig->certsPathLen = taskConfig.certsPath.size();
     cTaskConfig->commonData = taskConfig.commonData;
+    return cTaskConfig;
 }
 
 CTaskConfig *QueryTaskConfig(uint32_t taskId)
@@ -1288,7 +1921,10 @@ CTaskConfig *QueryTaskConfig(uint32_t taskId)
             "redirect", "config_idx", "begins", "ends", "gauge", "precise", "priority", "background", "bundle", "url",
             "title", "description", "method", "headers", "data", "token", "config_extras", "version", "form_items",
             "file_specs", "body_file_names", "certs_paths", "proxy", "certificate_pins", "bundle_type",
-            "atomic_account", "multipart", "min_speed", "min_speed_duration", "connection_timeout", "total_timeout" });
+            "atomic_account", "multipart", "min_speed", "min_speed_duration", "connection_timeout", "total_timeout",
+            "checksum", "stall_window", "stall_ratio", "concurrency",
+            "chunk_size", "deadline", "coalesce", "compression", "memory_limit",
+            "prefetch", "bypass_cache" });
 
     int rowCount = 0;
     if (resultSet == nullptr) {
@@ -1313,7 +1949,5 @@ CTaskConfig *QueryTaskConfig(uint32_t taskId)
     TaskConfig taskConfig = BuildRequestTaskConfig(resultSet);
     REQUEST_HILOGD(
         "QuerySingleTaskConfig in, after BuildRequestTaskConfig, task_id: %{public}u", taskConfig.commonData.taskId);
-    CTaskConfig *cTaskConfig = new CTaskConfig;
-    BuildCTaskConfig(cTaskConfig, taskConfig);
-    return cTaskConfig;
+    return BuildCTaskConfig(taskConfig);
 }
\ No newline at end of file
@@ -15,7 +15,8 @@
 
 #include "c_task_config.h"
 
+// The task config, its arrays and its strings are a single allocation, see `BuildCTaskConfig`.
 void DeleteCTaskConfig(CTaskConfig *ptr)
 {
-    delete ptr;
+    delete[] reinterpret_cast<char *>(ptr);
 }
@@ -15,24 +15,10 @@
 
 #include "c_task_info.h"
 
-void DeleteCFormItem(CFormItem *ptr)
-{
-    delete[] ptr;
-}
-
-void DeleteCFileSpec(CFileSpec *ptr)
-{
-    delete[] ptr;
-}
-
-void DeleteCStringPtr(CStringWrapper *ptr)
-{
-    delete[] ptr;
-}
-
+// The task info, its arrays and its strings are a single allocation, see `BuildCTaskInfo`.
 void DeleteCTaskInfo(CTaskInfo *ptr)
 {
-    delete ptr;
+    delete[] reinterpret_cast<char *>(ptr);
 }
 
 void DeleteTaskQosInfo(TaskQosInfo *ptr)
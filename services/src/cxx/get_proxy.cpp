@@ -35,22 +35,16 @@ SysNetProxyManager &SysNetProxyManager::GetInstance()
     return proxyManager;
 }
 
-CStringWrapper SysNetProxyManager::GetHost()
+// Hands a copy of the proxy to the service, which owns the copied strings.
+void SysNetProxyManager::PublishProxy()
 {
-    return WrapperCString(host_);
-}
-CStringWrapper SysNetProxyManager::GetPort()
-{
-    REQUEST_HILOGD("SysNetProxyManager::GetPort() is %{public}s", port_.c_str());
-    return WrapperCString(port_);
-}
-CStringWrapper SysNetProxyManager::GetExclusionList()
-{
-    REQUEST_HILOGD("SysNetProxyManager::GetExclusionList() is %{public}s", exclusionList_.c_str());
-    return WrapperCString(exclusionList_);
+    if (callback_ == nullptr) {
+        return;
+    }
+    callback_(WrapperCString(host_), WrapperCString(port_), WrapperCString(exclusionList_));
 }
 
-void SysNetProxyManager::SubscriberEvent()
+void SysNetProxyManager::SubscriberEvent(ProxyChangeCallback callback)
 {
     REQUEST_HILOGD("SubscriberEvent start.");
     if (subscriber_) {
@@ -59,7 +53,9 @@ void SysNetProxyManager::SubscriberEvent()
     }
     {
         std::lock_guard<std::mutex> lock(proxyMutex);
+        callback_ = callback;
         InitProxy(host_, port_, exclusionList_);
+        PublishProxy();
     }
     OHOS::EventFwk::MatchingSkills matchingSkills;
     matchingSkills.AddEvent(OHOS::EventFwk::CommonEventSupport::COMMON_EVENT_HTTP_PROXY_CHANGE);
@@ -117,6 +113,7 @@ void SysNetProxySubscriber::OnReceiveEvent(const OHOS::EventFwk::CommonEventData
     SysNetProxyManager::GetInstance().GetHttpProxy(proxyContent, host, port, exclusionList);
     g_proxyMutex.lock();
     SysNetProxyManager::GetInstance().SetHttpProxy(host, port, exclusionList);
+    SysNetProxyManager::GetInstance().PublishProxy();
     g_proxyMutex.unlock();
 }
 
@@ -142,22 +139,7 @@ void SysNetProxyManager::GetHttpProxy(
     }
 }
 
-void RegisterProxySubscriber()
-{
-    SysNetProxyManager::GetInstance().SubscriberEvent();
-}
-
-CStringWrapper GetHost()
-{
-    return SysNetProxyManager::GetInstance().GetHost();
-}
-
-CStringWrapper GetPort()
-{
-    return SysNetProxyManager::GetInstance().GetPort();
-}
-
-CStringWrapper GetExclusionList()
+void RegisterProxySubscriber(ProxyChangeCallback callback)
 {
-    return SysNetProxyManager::GetInstance().GetExclusionList();
+    SysNetProxyManager::GetInstance().SubscriberEvent(callback);
 }
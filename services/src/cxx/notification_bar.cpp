@@ -17,7 +17,9 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 
 #include "cxx.h"
 #include "image_source.h"
@@ -47,34 +49,84 @@ static constexpr int32_t REQUEST_STYLE_SIMPLE = 8;
 
 static const std::string CLOSE_ICON_PATH = "/etc/request/xmark.svg";
 
-rust::string GetSystemResourceString(const rust::str name)
+// System language and the resource strings resolved in it, so that publishing
+// progress does not go through the resource manager each time.
+struct ResourceCache {
+    std::mutex mutex;
+    std::string language;
+    std::unordered_map<std::string, std::string> strings;
+};
+
+static ResourceCache &GetResourceCache()
+{
+    static ResourceCache *cache = new ResourceCache();
+    return *cache;
+}
+
+static const std::string &CachedLanguage(ResourceCache &cache)
+{
+    if (cache.language.empty()) {
+        cache.language = I18n::LocaleConfig::GetSystemLanguage();
+    }
+    return cache.language;
+}
+
+static bool LoadSystemResourceString(const std::string &language, const char *name, std::string &outValue)
 {
     auto resourceMgr = Resource::GetSystemResourceManagerNoSandBox();
     if (resourceMgr == nullptr) {
         REQUEST_HILOGE("GetSystemResourceManagerNoSandBox failed");
-        return "";
+        return false;
     }
     std::unique_ptr<Resource::ResConfig> config(Resource::CreateResConfig());
     if (config == nullptr) {
         REQUEST_HILOGE("Create ResConfig failed");
-        return "";
+        return false;
     }
     UErrorCode status = U_ZERO_ERROR;
-    icu::Locale locale = icu::Locale::forLanguageTag(I18n::LocaleConfig::GetSystemLanguage(), status);
+    icu::Locale locale = icu::Locale::forLanguageTag(language, status);
     config->SetLocaleInfo(locale);
     resourceMgr->UpdateResConfig(*config);
 
-    std::string outValue;
-    auto ret = resourceMgr->GetStringByName(name.data(), outValue);
+    auto ret = resourceMgr->GetStringByName(name, outValue);
     if (ret != Resource::RState::SUCCESS) {
         REQUEST_HILOGE("GetStringById failed: %{public}d", ret);
+        return false;
+    }
+    return true;
+}
+
+rust::string GetSystemResourceString(const rust::str name)
+{
+    auto &cache = GetResourceCache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    std::string key(name.data(), name.size());
+    auto it = cache.strings.find(key);
+    if (it != cache.strings.end()) {
+        return rust::string(it->second);
+    }
+    std::string outValue;
+    // Failed lookups are not cached and are retried by the next notification.
+    if (LoadSystemResourceString(CachedLanguage(cache), name.data(), outValue)) {
+        cache.strings.emplace(std::move(key), outValue);
     }
     return rust::string(outValue);
 }
 
 rust::string GetSystemLanguage()
 {
-    return rust::string(I18n::LocaleConfig::GetSystemLanguage().c_str());
+    auto &cache = GetResourceCache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    return rust::string(CachedLanguage(cache));
+}
+
+void ClearResourceCache()
+{
+    auto &cache = GetResourceCache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    cache.language.clear();
+    cache.strings.clear();
+    REQUEST_HILOGI("Locale changed, resource cache cleared");
 }
 
 std::shared_ptr<Media::PixelMap> CreatePixelMap()
@@ -11,12 +11,16 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+use std::fs;
+use std::sync::atomic::{AtomicU64, Ordering};
 use std::sync::LazyLock;
-use std::time::{SystemTime, UNIX_EPOCH};
+use std::time::{Instant, SystemTime, UNIX_EPOCH};
 
 use rdb::{OpenConfig, RdbStore, SecurityLevel};
 
+use crate::manage::database::RequestDb;
 use crate::service::notification_bar::NotificationDispatcher;
+use crate::utils::{get_current_timestamp, metrics};
 
 const DB_PATH: &str = if cfg!(test) {
     "/data/test/notification.db"
@@ -26,9 +30,14 @@ const DB_PATH: &str = if cfg!(test) {
 
 const MILLIS_IN_A_WEEK: u64 = 7 * 24 * 60 * 60 * 1000;
 
+/// Store version of request.db, must match `DATABASE_VERSION` in
+/// c_request_database.h so that opening the store here never downgrades it.
+pub(crate) const DB_VERSION: i32 = 3;
+
 pub(crate) static REQUEST_DB: LazyLock<RdbStore<'static>> = LazyLock::new(|| {
     let mut config = OpenConfig::new(DB_PATH);
     config.security_level(SecurityLevel::S1);
+    config.version(DB_VERSION);
     if cfg!(test) {
         config.encrypt_status(false);
         config.bundle_name("Test");
@@ -38,8 +47,60 @@ pub(crate) static REQUEST_DB: LazyLock<RdbStore<'static>> = LazyLock::new(|| {
     RdbStore::open(config).unwrap()
 });
 
+/// Rows the idle reaper deletes per tick.
+pub(crate) const REAP_CHUNK_ROWS: usize = 200;
+
+/// Free pages the idle reaper returns to the file system per tick.
+const VACUUM_CHUNK_PAGES: i64 = 256;
+
+/// `PRAGMA auto_vacuum` value of incremental mode.
+const AUTO_VACUUM_INCREMENTAL: i64 = 2;
+
+/// Bytes of the WAL file from which the idle maintenance truncates it.
+const WAL_TRUNCATE_BYTES: u64 = 4 * 1024 * 1024;
+
+/// Milliseconds between two `ANALYZE` of the idle maintenance.
+const ANALYZE_INTERVAL_MS: u64 = 24 * 60 * 60 * 1000;
+
+/// Outcome of one reaper tick.
+#[derive(Debug, Default)]
+pub(crate) struct ReapStats {
+    /// Expired tasks deleted by this tick.
+    pub(crate) deleted: usize,
+    /// Whether more expired tasks are left.
+    pub(crate) remain: bool,
+    /// Remaining rows of `request_task`.
+    pub(crate) rows: i64,
+    /// Pages of the database file after the tick.
+    pub(crate) pages: i64,
+    /// Free pages returned to the file system by this tick.
+    pub(crate) reclaimed: i64,
+}
+
+/// Outcome of one idle maintenance.
+#[derive(Debug, Default)]
+pub(crate) struct MaintainStats {
+    /// Bytes of the WAL file before the checkpoint.
+    pub(crate) wal_bytes: u64,
+    /// Whether the checkpoint truncated the WAL file.
+    pub(crate) truncated: bool,
+    /// Whether the checkpoint was kept from completing by another connection.
+    pub(crate) blocked: bool,
+    /// Frames in the WAL and frames copied back to the database, `-1` if the
+    /// store is not in WAL mode.
+    pub(crate) wal_frames: i64,
+    pub(crate) checkpointed: i64,
+    /// Whether the planner statistics were refreshed.
+    pub(crate) analyzed: bool,
+}
+
 pub(crate) fn clear_database_part(pre_count: usize) -> Result<bool, ()> {
-    let mut remain = true;
+    clear_expired_tasks(pre_count).map(|(_, remain)| remain)
+}
+
+/// Deletes at most `pre_count` tasks that have been overdue for more than a
+/// week, returns how many were deleted and whether more are left.
+fn clear_expired_tasks(pre_count: usize) -> Result<(usize, bool), ()> {
     // rdb not support RETURNING expr.
     let current_time = match SystemTime::now().duration_since(UNIX_EPOCH) {
         Ok(duration) => duration,
@@ -51,7 +112,8 @@ pub(crate) fn clear_database_part(pre_count: usize) -> Result<bool, ()> {
     .as_millis() as u64;
 
     let task_ids: Vec<_> = match REQUEST_DB.query::<u32>(
-        "SELECT task_id from request_task WHERE mtime < ? LIMIT ?",
+        // Progress updates only refresh the mtime of request_task_progress.
+        "SELECT t.task_id from request_task AS t LEFT JOIN request_task_progress AS p ON p.task_id = t.task_id WHERE MAX(IFNULL(t.mtime, 0), IFNULL(p.mtime, 0)) < ? LIMIT ?",
         (current_time - MILLIS_IN_A_WEEK, pre_count as u64),
     ) {
         Ok(rows) => rows.collect(),
@@ -61,21 +123,153 @@ pub(crate) fn clear_database_part(pre_count: usize) -> Result<bool, ()> {
         }
     };
 
-    if task_ids.len() < pre_count {
-        remain = false;
+    let remain = task_ids.len() >= pre_count;
+    if task_ids.is_empty() {
+        return Ok((0, remain));
+    }
+
+    // One statement per chunk, the ids are integers read from the table.
+    let ids = task_ids
+        .iter()
+        .map(|id| id.to_string())
+        .collect::<Vec<_>>()
+        .join(",");
+    let sql = format!("DELETE from request_task WHERE task_id IN ({})", ids);
+    if let Err(e) = REQUEST_DB.execute(&sql, ()) {
+        error!("Failed to clear {} tasks info: {}", task_ids.len(), e);
+        return Err(());
     }
 
-    for task_id in task_ids {
+    for task_id in task_ids.iter() {
         debug!(
             "clear {} info for have been overdue for more than a week.",
             task_id
         );
-        if let Err(e) = REQUEST_DB.execute("DELETE from request_task WHERE task_id = ?", task_id) {
-            error!("Failed to clear task {} info: {}", task_id, e);
+        RequestDb::get_instance().forget_task(*task_id);
+        NotificationDispatcher::get_instance().clear_task_info(*task_id);
+    }
+    Ok((task_ids.len(), remain))
+}
+
+/// Runs one tick of the idle reaper.
+///
+/// Deletes at most `chunk` expired tasks and returns up to
+/// `VACUUM_CHUNK_PAGES` free pages to the file system. A store created before
+/// incremental vacuum was enabled is converted once it is idle and has no
+/// expired tasks left.
+pub(crate) fn reap_expired_tasks(chunk: usize) -> Result<ReapStats, ()> {
+    let (deleted, remain) = clear_expired_tasks(chunk)?;
+
+    let free_before = query_pragma("PRAGMA freelist_count");
+    if query_pragma("PRAGMA auto_vacuum") == AUTO_VACUUM_INCREMENTAL {
+        let sql = format!("PRAGMA incremental_vacuum({})", VACUUM_CHUNK_PAGES);
+        if let Err(e) = REQUEST_DB.execute(&sql, ()) {
+            error!("Failed to run incremental vacuum: {}", e);
+        }
+    } else if !remain && free_before > 0 {
+        info!("Enable incremental vacuum of request.db");
+        if REQUEST_DB
+            .execute("PRAGMA auto_vacuum = INCREMENTAL", ())
+            .and_then(|_| REQUEST_DB.execute("VACUUM", ()))
+            .is_err()
+        {
+            error!("Failed to enable incremental vacuum");
+        }
+    }
+    let free_after = query_pragma("PRAGMA freelist_count");
+
+    let stats = ReapStats {
+        deleted,
+        remain,
+        rows: query_pragma("SELECT COUNT(*) FROM request_task"),
+        pages: query_pragma("PRAGMA page_count"),
+        reclaimed: (free_before - free_after).max(0),
+    };
+    info!(
+        "reap {} tasks, remain {}, rows {}, pages {}, reclaimed {} pages",
+        stats.deleted, stats.remain, stats.rows, stats.pages, stats.reclaimed
+    );
+    Ok(stats)
+}
+
+/// Runs the idle maintenance of request.db.
+///
+/// Checkpoints the WAL out of the busy transfers, so that the automatic
+/// checkpoint of a progress write rarely has to. While tasks are running the
+/// checkpoint is passive and never waits for their writes, otherwise a WAL
+/// grown to `WAL_TRUNCATE_BYTES` is truncated and the planner statistics are
+/// refreshed once per `ANALYZE_INTERVAL_MS`. Free pages are returned to the
+/// file system by `reap_expired_tasks`.
+pub(crate) fn maintain(tasks_running: bool) -> MaintainStats {
+    let wal_bytes = fs::metadata(format!("{}-wal", DB_PATH))
+        .map(|meta| meta.len())
+        .unwrap_or(0);
+    metrics::DB_WAL_BYTES.record(wal_bytes);
+
+    let truncated = !tasks_running && wal_bytes >= WAL_TRUNCATE_BYTES;
+    let sql = match truncated {
+        true => "PRAGMA wal_checkpoint(TRUNCATE)",
+        false => "PRAGMA wal_checkpoint(PASSIVE)",
+    };
+    let start = Instant::now();
+    let (blocked, wal_frames, checkpointed) = match REQUEST_DB.query::<(i64, i64, i64)>(sql, ()) {
+        Ok(mut rows) => rows.next().unwrap_or((0, -1, -1)),
+        Err(e) => {
+            error!("Failed to run {}: {}", sql, e);
+            (1, -1, -1)
+        }
+    };
+    metrics::DB_CHECKPOINT_US.record_since(start);
+
+    let analyzed = !tasks_running && analyze_due(get_current_timestamp());
+    if analyzed {
+        if let Err(e) = REQUEST_DB.execute("ANALYZE", ()) {
+            error!("Failed to analyze request.db: {}", e);
+        }
+    }
+
+    let stats = MaintainStats {
+        wal_bytes,
+        truncated,
+        blocked: blocked != 0,
+        wal_frames,
+        checkpointed,
+        analyzed,
+    };
+    info!(
+        "maintain wal {} bytes, truncated {}, blocked {}, frames {}/{} in {} us, analyzed {}",
+        stats.wal_bytes,
+        stats.truncated,
+        stats.blocked,
+        stats.checkpointed,
+        stats.wal_frames,
+        start.elapsed().as_micros(),
+        stats.analyzed
+    );
+    stats
+}
+
+/// Returns whether `ANALYZE` is due at `now` in milliseconds, and if so
+/// records that it runs.
+fn analyze_due(now: u64) -> bool {
+    static LAST_ANALYZE_MS: AtomicU64 = AtomicU64::new(0);
+    let last = LAST_ANALYZE_MS.load(Ordering::Relaxed);
+    if last != 0 && now.saturating_sub(last) < ANALYZE_INTERVAL_MS {
+        return false;
+    }
+    LAST_ANALYZE_MS.store(now, Ordering::Relaxed);
+    true
+}
+
+/// Reads the single integer returned by `sql`, `0` if it fails.
+fn query_pragma(sql: &str) -> i64 {
+    match REQUEST_DB.query::<i64>(sql, ()) {
+        Ok(mut rows) => rows.next().unwrap_or(0),
+        Err(e) => {
+            error!("Failed to query {}: {}", sql, e);
+            0
         }
-        NotificationDispatcher::get_instance().clear_task_info(task_id);
     }
-    Ok(remain)
 }
 
 #[cfg(test)]
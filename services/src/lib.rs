@@ -89,6 +89,7 @@ mod tests {
                     if let Err(e) = RequestDb::get_instance().execute("DELETE FROM request_task") {
                         error!("lock delete failed: {}", e);
                     }
+                    RequestDb::get_instance().forget_all_tasks();
                     DB_LOCK = std::sync::Mutex::new(());
                     DB_LOCK.lock().unwrap()
                 }
@@ -106,6 +107,7 @@ mod tests {
             if let Err(e) = RequestDb::get_instance().execute("DELETE FROM request_task") {
                 error!("drop delete failed: {}", e);
             }
+            RequestDb::get_instance().forget_all_tasks();
         }
     }
 
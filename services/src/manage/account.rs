@@ -24,6 +24,7 @@ use std::sync::{Mutex, Once};
 pub(crate) use ffi::*;
 
 use super::database::RequestDb;
+use crate::manage::environment;
 use crate::manage::events::TaskManagerEvent;
 use crate::manage::task_manager::TaskManagerTx;
 use crate::utils::{call_once, runtime_spawn};
@@ -102,10 +103,16 @@ pub(crate) fn update_accounts(task_manager: TaskManagerTx) {
 /// 
 /// # Notes
 /// 
-/// This function safely accesses the global account state to provide the current
-/// active account information. This is typically used for task filtering and
+/// The accounts are read from the environment snapshot, where each account
+/// update publishes them. This is typically used for task filtering and
 /// permission checks based on user identity.
 pub(crate) fn query_active_accounts() -> (u64, HashSet<u64>) {
+    let env = environment::snapshot();
+    (env.foreground_account, env.active_accounts.clone())
+}
+
+/// Publishes the accounts to the environment snapshot of the tasks.
+fn publish_accounts() {
     let mut active_accounts = HashSet::new();
     let foreground_account = FOREGROUND_ACCOUNT.load(Ordering::SeqCst) as u64;
     active_accounts.insert(foreground_account);
@@ -116,8 +123,12 @@ pub(crate) fn query_active_accounts() -> (u64, HashSet<u64>) {
             active_accounts.insert(*account as u64);
         }
     }
-    
-    (foreground_account, active_accounts)
+
+    environment::update(|env| {
+        env.foreground_account = foreground_account;
+        env.active_accounts = active_accounts;
+        true
+    });
 }
 
 /// Internal utility for updating account information asynchronously.
@@ -182,6 +193,10 @@ impl Drop for AccountUpdater {
     /// 2. Sends a change notification to the task manager if any account state changed
     fn drop(&mut self) {
         info!("AccountUpdate Finished");
+        // Publish before another update may start
+        if self.change_flag {
+            publish_accounts();
+        }
         // Reset the update flag to allow new update operations
         UPDATE_FLAG.store(false, Ordering::SeqCst);
         
@@ -432,6 +447,7 @@ impl RequestDb {
                 &format!("delete_all_account_tasks failed: {}", e)
             );
         };
+        self.forget_tasks_if(|meta| meta.uid / 200000 == user_id as u64);
     }
 }
 
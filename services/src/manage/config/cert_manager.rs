@@ -17,7 +17,9 @@
 //! used for secure network communications. It includes certificate loading from
 //! system locations and user-provided sources, with automatic periodic updates.
 
-use std::sync::{Arc, RwLock};
+use std::collections::hash_map::DefaultHasher;
+use std::hash::{Hash, Hasher};
+use std::sync::{Arc, Mutex, RwLock};
 use std::time::Duration;
 
 use ylong_http_client::Certificate;
@@ -35,6 +37,8 @@ const UPDATE_SYSTEM_CERT_INTERVAL_IN_SECS: u64 = 60 * 60;
 pub(crate) struct CertManager {
     /// Thread-safe storage for certificate information.
     info: Arc<RwLock<CertInfo>>,
+    /// Certificates parsed by the previous updates.
+    parsed: Arc<Mutex<ParsedCerts>>,
 }
 
 impl CertManager {
@@ -50,8 +54,9 @@ impl CertManager {
     /// `UPDATE_SYSTEM_CERT_INTERVAL_IN_SECS` intervals.
     pub(crate) fn init() -> Self {
         let info = Arc::new(RwLock::new(CertInfo::default()));
-        runtime_spawn(run(info.clone()));
-        Self { info }
+        let parsed = Arc::new(Mutex::new(ParsedCerts::default()));
+        runtime_spawn(run(info.clone(), parsed.clone()));
+        Self { info, parsed }
     }
 
     /// Retrieves the current certificates.
@@ -68,7 +73,7 @@ impl CertManager {
     /// Bypasses the periodic update interval and performs a certificate refresh
     /// immediately.
     pub(crate) fn force_update(&self) {
-        update_system_cert(&self.info);
+        update_system_cert(&self.info, &self.parsed);
     }
 }
 
@@ -84,13 +89,14 @@ struct CertInfo {
 /// # Arguments
 ///
 /// * `info` - Thread-safe reference to certificate storage
+/// * `parsed` - Certificates parsed by the previous updates
 ///
 /// # Notes
 ///
 /// Runs indefinitely, updating certificates at the configured interval.
-async fn run(info: Arc<RwLock<CertInfo>>) {
+async fn run(info: Arc<RwLock<CertInfo>>, parsed: Arc<Mutex<ParsedCerts>>) {
     loop {
-        update_system_cert(&info);
+        update_system_cert(&info, &parsed);
         // Sleep for the configured update interval before refreshing certificates
         ylong_runtime::time::sleep(Duration::from_secs(UPDATE_SYSTEM_CERT_INTERVAL_IN_SECS)).await;
     }
@@ -101,60 +107,109 @@ async fn run(info: Arc<RwLock<CertInfo>>) {
 /// # Arguments
 ///
 /// * `info` - Thread-safe reference to certificate storage
+/// * `parsed` - Certificates parsed by the previous updates
 ///
 /// # Notes
 ///
 /// Loads certificates from both user-provided sources and system certificate paths.
-/// Returns early if any certificate parsing fails.
-fn update_system_cert(info: &Arc<RwLock<CertInfo>>) {
-    let mut info = info.write().unwrap();
-
-    let mut certificates = Vec::new();
-
-    // Load user certificates through the C API
-    let c_certs_ptr = unsafe { GetUserCertsData() };
-    if !c_certs_ptr.is_null() {
-        info!("GetUserCertsData valid");
-        let certs = unsafe { &*c_certs_ptr };
-        // Convert C pointer array to safe Rust slice
-        let c_cert_list_ptr =
-            unsafe { std::slice::from_raw_parts(certs.cert_data_list, certs.len as usize) };
-        for item in c_cert_list_ptr.iter() {
-            let cert = unsafe { &**item };
-            // Convert certificate data pointer to safe slice
-            let cert_slice = unsafe { std::slice::from_raw_parts(cert.data, cert.size as usize) };
-            // Parse PEM-encoded certificate
-            match Certificate::from_pem(cert_slice) {
-                Ok(cert) => {
-                    certificates.push(cert);
-                }
-                Err(e) => {
-                    error!("parse security cert path failed, error is {:?}", e);
-                    return;
-                }
-            };
-        }
-        // Free the allocated C memory
-        unsafe { FreeCertDataList(c_certs_ptr) };
-    }
+/// The system certificates only change with the system image and are parsed
+/// once, the user certificates are parsed again only when their data changed.
+/// Parsing is done without holding `info`, so building clients is not blocked.
+/// Returns early if the system certificates fail to parse, user certificates
+/// failing to parse leave the previous ones in use.
+fn update_system_cert(info: &RwLock<CertInfo>, parsed: &Mutex<ParsedCerts>) {
+    // Serializes the updates, readers only wait for the certificates to be swapped.
+    let mut parsed = parsed.lock().unwrap();
 
     // Load system certificates
-    match Certificate::from_path("/system/etc/security/certificates/") {
-        Ok(cert) => {
-            certificates.push(cert);
-        }
-        Err(e) => {
-            error!("parse security cert path failed, error is {:?}", e);
-            return;
-        }
-    };
+    if parsed.system.is_none() {
+        match Certificate::from_path("/system/etc/security/certificates/") {
+            Ok(cert) => parsed.system = Some(cert),
+            Err(e) => {
+                error!("parse security cert path failed, error is {:?}", e);
+                return;
+            }
+        };
+    }
+
+    // Load user certificates, nothing changes if they are the same as before
+    if !parsed.update_user() && info.read().unwrap().cert.is_some() {
+        return;
+    }
+
+    let mut certificates = parsed.user.clone();
+    certificates.extend(parsed.system.clone());
 
     // Update stored certificates
-    *info = CertInfo {
+    *info.write().unwrap() = CertInfo {
         cert: Some(certificates),
     };
 }
 
+/// Certificates parsed by the previous updates.
+#[derive(Default)]
+struct ParsedCerts {
+    /// Parsed certificates of the system path.
+    system: Option<Certificate>,
+    /// Parsed user certificates.
+    user: Vec<Certificate>,
+    /// Fingerprint of the data of the user certificates last parsed.
+    user_fingerprint: Option<u64>,
+}
+
+impl ParsedCerts {
+    /// Loads the user certificates through the C API and parses them if their
+    /// data changed since the last call.
+    ///
+    /// # Returns
+    ///
+    /// `true` if `user` changed.
+    fn update_user(&mut self) -> bool {
+        let c_certs_ptr = unsafe { GetUserCertsData() };
+        let mut data = Vec::new();
+        if !c_certs_ptr.is_null() {
+            info!("GetUserCertsData valid");
+            let certs = unsafe { &*c_certs_ptr };
+            // Convert C pointer array to safe Rust slice
+            let c_cert_list_ptr =
+                unsafe { std::slice::from_raw_parts(certs.cert_data_list, certs.len as usize) };
+            for item in c_cert_list_ptr.iter() {
+                let cert = unsafe { &**item };
+                // Convert certificate data pointer to safe slice
+                data.push(unsafe { std::slice::from_raw_parts(cert.data, cert.size as usize) });
+            }
+        }
+
+        let mut hasher = DefaultHasher::new();
+        data.hash(&mut hasher);
+        let fingerprint = hasher.finish();
+
+        // Data that failed to parse is not parsed again until it changes.
+        let mut changed = false;
+        if self.user_fingerprint != Some(fingerprint) {
+            self.user_fingerprint = Some(fingerprint);
+            // Parse PEM-encoded certificates
+            match data
+                .iter()
+                .map(|cert| Certificate::from_pem(cert))
+                .collect::<Result<Vec<_>, _>>()
+            {
+                Ok(user) => {
+                    self.user = user;
+                    changed = true;
+                }
+                Err(e) => error!("parse security cert path failed, error is {:?}", e),
+            }
+        }
+
+        // Free the allocated C memory
+        if !c_certs_ptr.is_null() {
+            unsafe { FreeCertDataList(c_certs_ptr) };
+        }
+        changed
+    }
+}
+
 // C API functions for accessing user certificates
 #[cfg(feature = "oh")]
 extern "C" {
@@ -20,21 +20,28 @@
 mod cert_manager;
 mod system_proxy;
 
+use std::sync::OnceLock;
+
 use cert_manager::CertManager;
 use system_proxy::SystemProxyManager;
 use ylong_http_client::Certificate;
 
+use crate::utils::startup::{self, Phase};
+
 /// Manages system-wide configurations for the request service.
 ///
 /// Provides unified access to various system configurations including certificates
 /// and proxy settings. Combines specialized configuration managers into a single
 /// interface for easy access and management.
-#[derive(Clone)]
+///
+/// Only tasks about to run need the configuration, so the managers are
+/// initialized by the first `system_config` rather than when the service
+/// starts, which requests such as queries do not wait for.
 pub(crate) struct SystemConfigManager {
     /// Certificate manager for handling SSL/TLS certificates.
-    cert: CertManager,
+    cert: OnceLock<CertManager>,
     /// Proxy manager for handling system proxy settings.
-    proxy: SystemProxyManager,
+    proxy: OnceLock<SystemProxyManager>,
 }
 
 impl SystemConfigManager {
@@ -42,14 +49,25 @@ impl SystemConfigManager {
     ///
     /// # Returns
     ///
-    /// A new instance of `SystemConfigManager` with initialized certificate and proxy managers.
+    /// A new instance of `SystemConfigManager`, whose certificate and proxy
+    /// managers are initialized on first use.
     pub(crate) fn init() -> Self {
         Self {
-            cert: CertManager::init(),
-            proxy: SystemProxyManager::init(),
+            cert: OnceLock::new(),
+            proxy: OnceLock::new(),
         }
     }
 
+    fn cert(&self) -> &CertManager {
+        self.cert
+            .get_or_init(|| startup::measure(Phase::Certificates, CertManager::init))
+    }
+
+    fn proxy(&self) -> &SystemProxyManager {
+        self.proxy
+            .get_or_init(|| startup::measure(Phase::Proxy, SystemProxyManager::init))
+    }
+
     /// Retrieves the current system configuration.
     ///
     /// # Returns
@@ -61,18 +79,20 @@ impl SystemConfigManager {
     /// If certificates are not available, this method forces an immediate certificate update
     /// attempt before returning.
     pub(crate) fn system_config(&self) -> SystemConfig {
-        let mut certs = self.cert.certificate();
+        let cert = self.cert();
+        let mut certs = cert.certificate();
 
         // Force certificate update if no certificates are available
         if certs.is_none() {
-            self.cert.force_update();
-            certs = self.cert.certificate();
+            cert.force_update();
+            certs = cert.certificate();
         }
 
+        let proxy = self.proxy().proxy();
         SystemConfig {
-            proxy_host: self.proxy.host(),
-            proxy_port: self.proxy.port(),
-            proxy_exlist: self.proxy.exlist(),
+            proxy_host: proxy.host,
+            proxy_port: proxy.port,
+            proxy_exlist: proxy.exlist,
             certs,
         }
     }
@@ -13,16 +13,18 @@
 
 //! System proxy configuration management.
 //! 
-//! This module provides functionality to manage and access system proxy settings
-//! for network requests. It interacts with the underlying system to retrieve proxy
-//! configuration parameters including host, port, and exclusion lists.
+//! This module subscribes to the proxy settings of the system. The host, port
+//! and exclusion list are handed over by the platform when subscribing and on
+//! each change, and published to the environment snapshot of the tasks, so
+//! building a task reads them without calling into the platform.
 
+use crate::manage::environment::{self, SystemProxy};
 use crate::utils::c_wrapper::CStringWrapper;
 
 /// Manages system proxy settings for network requests.
 ///
-/// Provides access to the system's proxy configuration and subscribes to proxy
-/// setting changes. Acts as a wrapper around system-level proxy functionality.
+/// Subscribes to the system proxy settings, which are then read from the
+/// environment snapshot.
 #[derive(Clone)]
 pub(crate) struct SystemProxyManager;
 
@@ -39,51 +41,47 @@ impl SystemProxyManager {
     /// proxy changes.
     pub(crate) fn init() -> Self {
         unsafe {
-            RegisterProxySubscriber();
+            RegisterProxySubscriber(proxy_change_callback);
         }
         Self
     }
 
-    /// Retrieves the current proxy host address.
+    /// Retrieves the current proxy settings.
     ///
     /// # Returns
     ///
-    /// A `String` containing the proxy host address, or empty string if no proxy is set.
-    ///
-    /// # Safety
-    ///
-    /// Calls unsafe FFI function `GetHost()` to retrieve the proxy host from the system.
-    pub(crate) fn host(&self) -> String {
-        unsafe { GetHost() }.to_string()
-    }
-
-    /// Retrieves the current proxy port number.
-    ///
-    /// # Returns
-    ///
-    /// A `String` containing the proxy port number, or empty string if no proxy is set.
-    ///
-    /// # Safety
-    ///
-    /// Calls unsafe FFI function `GetPort()` to retrieve the proxy port from the system.
-    pub(crate) fn port(&self) -> String {
-        unsafe { GetPort() }.to_string()
+    /// The proxy host, port and exclusion list, empty strings if no proxy is set.
+    pub(crate) fn proxy(&self) -> SystemProxy {
+        environment::snapshot().proxy.clone()
     }
+}
 
-    /// Retrieves the current proxy exclusion list.
-    ///
-    /// # Returns
-    ///
-    /// A `String` containing domains/hosts that should bypass the proxy, or empty string
-    /// if no exclusions are set.
-    ///
-    /// # Safety
-    ///
-    /// Calls unsafe FFI function `GetExclusionList()` to retrieve the proxy exclusion
-    /// list from the system.
-    pub(crate) fn exlist(&self) -> String {
-        unsafe { GetExclusionList() }.to_string()
-    }
+/// C callback invoked with the proxy settings when subscribing and on each
+/// change.
+///
+/// # Arguments
+///
+/// * `host` - Proxy host address.
+/// * `port` - Proxy port number.
+/// * `exlist` - Domains or hosts that should bypass the proxy.
+extern "C" fn proxy_change_callback(
+    host: CStringWrapper,
+    port: CStringWrapper,
+    exlist: CStringWrapper,
+) {
+    let proxy = SystemProxy {
+        host: host.to_string(),
+        port: port.to_string(),
+        exlist: exlist.to_string(),
+    };
+    environment::update(|env| {
+        if env.proxy == proxy {
+            return false;
+        }
+        info!("system proxy changed");
+        env.proxy = proxy;
+        true
+    });
 }
 
 // C API functions for accessing system proxy settings
@@ -91,41 +89,15 @@ impl SystemProxyManager {
 extern "C" {
     /// Registers a subscriber for system proxy configuration changes.
     ///
-    /// # Safety
-    ///
-    /// This is an FFI function that interacts with system components.
-    pub(crate) fn RegisterProxySubscriber();
-    
-    /// Retrieves the current proxy host address.
-    ///
-    /// # Returns
-    ///
-    /// A `CStringWrapper` containing the proxy host address.
-    ///
-    /// # Safety
-    ///
-    /// This is an FFI function that interacts with system components.
-    pub(crate) fn GetHost() -> CStringWrapper;
-    
-    /// Retrieves the current proxy port number.
-    ///
-    /// # Returns
-    ///
-    /// A `CStringWrapper` containing the proxy port number.
-    ///
-    /// # Safety
-    ///
-    /// This is an FFI function that interacts with system components.
-    pub(crate) fn GetPort() -> CStringWrapper;
-    
-    /// Retrieves the current proxy exclusion list.
-    ///
-    /// # Returns
+    /// # Arguments
     ///
-    /// A `CStringWrapper` containing the proxy exclusion list.
+    /// * `callback` - Called with the proxy settings when subscribing and on
+    ///   each change.
     ///
     /// # Safety
     ///
     /// This is an FFI function that interacts with system components.
-    pub(crate) fn GetExclusionList() -> CStringWrapper;
+    pub(crate) fn RegisterProxySubscriber(
+        callback: extern "C" fn(CStringWrapper, CStringWrapper, CStringWrapper),
+    );
 }
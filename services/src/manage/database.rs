@@ -16,29 +16,105 @@ use std::fmt::Display;
 use std::mem::MaybeUninit;
 use std::pin::Pin;
 use std::sync::{Arc, Mutex, Once};
+use std::time::Instant;
 
 pub(crate) use ffi::*;
 
 cfg_oh! {
+    use cxx::UniquePtr;
+
     use crate::manage::SystemConfig;
 }
 
 cfg_not_oh! {
     use rusqlite::Connection;
-    const CREATE_TABLE: &'static str = "CREATE TABLE IF NOT EXISTS request_task (task_id INTEGER PRIMARY KEY, uid INTEGER, token_id INTEGER, action INTEGER, mode INTEGER, cover INTEGER, network INTEGER, metered INTEGER, roaming INTEGER, ctime INTEGER, mtime INTEGER, reason INTEGER, gauge INTEGER, retry INTEGER, redirect INTEGER, tries INTEGER, version INTEGER, config_idx INTEGER, begins INTEGER, ends INTEGER, precise INTEGER, priority INTEGER, background INTEGER, bundle TEXT, url TEXT, data TEXT, token TEXT, title TEXT, description TEXT, method TEXT, headers TEXT, config_extras TEXT, mime_type TEXT, state INTEGER, idx INTEGER, total_processed INTEGER, sizes TEXT, processed TEXT, extras TEXT, form_items BLOB, file_specs BLOB, each_file_status BLOB, body_file_names BLOB, certs_paths BLOB)";
+    const CREATE_TABLE: &'static str = "CREATE TABLE IF NOT EXISTS request_task (task_id INTEGER PRIMARY KEY, uid INTEGER, token_id INTEGER, action INTEGER, mode INTEGER, cover INTEGER, network INTEGER, metered INTEGER, roaming INTEGER, ctime INTEGER, mtime INTEGER, reason INTEGER, gauge INTEGER, retry INTEGER, redirect INTEGER, tries INTEGER, version INTEGER, config_idx INTEGER, begins INTEGER, ends INTEGER, precise INTEGER, priority INTEGER, background INTEGER, bundle TEXT, url TEXT, data TEXT, token TEXT, title TEXT, description TEXT, method TEXT, headers TEXT, config_extras TEXT, mime_type TEXT, state INTEGER, idx INTEGER, total_processed INTEGER, sizes TEXT, processed TEXT, extras TEXT, form_items BLOB, file_specs BLOB, each_file_status BLOB, body_file_names BLOB, certs_paths BLOB, deadline INTEGER, prefetch INTEGER, performance TEXT)";
+    const CREATE_PROGRESS_TABLE: &'static str = "CREATE TABLE IF NOT EXISTS request_task_progress (task_id INTEGER PRIMARY KEY, mtime INTEGER, tries INTEGER, mime_type TEXT, idx INTEGER, total_processed INTEGER, sizes TEXT, processed TEXT, extras TEXT)";
+    const CREATE_INDEXES: [&'static str; 3] = [
+        "CREATE INDEX IF NOT EXISTS task_qos_index ON request_task(uid, state, reason, action, mode, priority)",
+        "CREATE INDEX IF NOT EXISTS task_state_index ON request_task(state, reason)",
+        "CREATE INDEX IF NOT EXISTS task_bundle_index ON request_task(bundle, ctime)",
+    ];
+    const CREATE_PROGRESS_TRIGGER: &'static str = "CREATE TRIGGER IF NOT EXISTS request_task_progress_delete AFTER DELETE ON request_task BEGIN DELETE FROM request_task_progress WHERE task_id = OLD.task_id; END";
+    const CREATE_SEARCH_INDEX: [&'static str; 4] = [
+        "CREATE VIRTUAL TABLE IF NOT EXISTS request_task_search USING fts5(title, description, url, content='request_task', content_rowid='task_id', tokenize='trigram')",
+        "CREATE TRIGGER IF NOT EXISTS request_task_search_insert AFTER INSERT ON request_task BEGIN INSERT INTO request_task_search (rowid, title, description, url) VALUES (NEW.task_id, NEW.title, NEW.description, NEW.url); END",
+        "CREATE TRIGGER IF NOT EXISTS request_task_search_delete AFTER DELETE ON request_task BEGIN INSERT INTO request_task_search (request_task_search, rowid, title, description, url) VALUES ('delete', OLD.task_id, OLD.title, OLD.description, OLD.url); END",
+        "CREATE TRIGGER IF NOT EXISTS request_task_search_update AFTER UPDATE OF title, description, url ON request_task BEGIN INSERT INTO request_task_search (request_task_search, rowid, title, description, url) VALUES ('delete', OLD.task_id, OLD.title, OLD.description, OLD.url); INSERT INTO request_task_search (rowid, title, description, url) VALUES (NEW.task_id, NEW.title, NEW.description, NEW.url); END",
+    ];
 }
 use crate::config::Action;
 use crate::error::ErrorCode;
+use crate::manage::db_worker::DbWorker;
+use crate::manage::progress_writer::{ProgressWriter, PROGRESS_PERSIST_INTERVAL};
+use crate::manage::task_meta::{TaskMeta, TaskMetaCache, TASK_META_CAPACITY};
 use crate::service::client::ClientManagerEntry;
 use crate::task::config::TaskConfig;
+use crate::task::cpu::{self, Path};
 use crate::task::ffi::{CTaskConfig, CTaskInfo, CUpdateInfo};
+use crate::task::files::AttachedFiles;
 use crate::task::info::{State, TaskInfo, UpdateInfo};
+use crate::task::performance::Performance;
 use crate::task::reason::Reason;
 use crate::task::request_task::RequestTask;
-use crate::utils::{call_once, get_current_timestamp, hashmap_to_string};
+#[cfg(feature = "oh")]
+use crate::trace;
+use crate::utils::{call_once, get_current_timestamp, hashmap_to_string, metrics, runtime_spawn};
+
+const QUERY_TASK_META: &str = "SELECT uid, token_id, action FROM request_task WHERE task_id = ?";
+const QUERY_TASK_TOTAL_PROCESSED: &str = "SELECT IFNULL(p.total_processed, t.total_processed) FROM request_task AS t LEFT JOIN request_task_progress AS p ON p.task_id = t.task_id WHERE t.task_id = ?";
+const QUERY_TASK_QOS_INFO: &str = "SELECT t.action, t.mode, t.state, t.priority, IFNULL(p.total_processed, t.total_processed), IFNULL(p.sizes, t.sizes), IFNULL(t.deadline, 0), t.uid, IFNULL(t.prefetch, 0) FROM request_task AS t LEFT JOIN request_task_progress AS p ON p.task_id = t.task_id";
+const QUERY_TASK_QOS_INFOS: &str = "SELECT t.task_id, t.action, t.mode, t.state, t.priority, IFNULL(p.total_processed, t.total_processed), IFNULL(p.sizes, t.sizes), IFNULL(t.deadline, 0), t.uid, IFNULL(t.prefetch, 0) FROM request_task AS t LEFT JOIN request_task_progress AS p ON p.task_id = t.task_id";
+const QUERY_TASK_STATE: &str = "SELECT state FROM request_task WHERE task_id = ?";
+const QUERY_TASKS_PROGRESS: &str = "SELECT t.task_id, t.state, IFNULL(p.total_processed, t.total_processed) FROM request_task AS t LEFT JOIN request_task_progress AS p ON p.task_id = t.task_id WHERE t.task_id IN";
+const UPDATE_TASK_STATE: &str =
+    "UPDATE request_task SET state = ?, mtime = ?, reason = ? WHERE task_id = ?";
+const UPDATE_TASK_MAX_SPEED: &str = "UPDATE request_task SET max_speed = ? WHERE task_id = ?";
+const UPDATE_TASK_PERFORMANCE: &str = "UPDATE request_task SET performance = ? WHERE task_id = ?";
+const UPDATE_TASK_SIZES: &str = "UPDATE request_task_progress SET sizes = ? WHERE task_id = ?";
+const CREATE_TASK_ID_TABLE: &str =
+    "CREATE TABLE IF NOT EXISTS request_task_id (id INTEGER PRIMARY KEY, seed INTEGER, reserved INTEGER)";
+const QUERY_TASK_ID_STATE: &str = "SELECT seed, reserved FROM request_task_id WHERE id = 0";
+const UPDATE_TASK_ID_STATE: &str =
+    "INSERT OR REPLACE INTO request_task_id (id, seed, reserved) VALUES (0, ?, ?)";
+const QUERY_TASK_IDS: &str = "SELECT task_id FROM request_task";
+
+impl SqlArg {
+    /// Binds an integer value.
+    pub(crate) fn integer<T: Into<i64>>(value: T) -> Self {
+        Self {
+            is_text: false,
+            integer: value.into(),
+            text: String::new(),
+        }
+    }
+
+    /// Binds a text value.
+    pub(crate) fn text(value: String) -> Self {
+        Self {
+            is_text: true,
+            integer: 0,
+            text: value,
+        }
+    }
+
+    #[cfg(not(feature = "oh"))]
+    fn to_value(&self) -> rusqlite::types::Value {
+        if self.is_text {
+            rusqlite::types::Value::Text(self.text.clone())
+        } else {
+            rusqlite::types::Value::Integer(self.integer)
+        }
+    }
+}
 
 pub(crate) struct RequestDb {
-    user_file_tasks: Mutex<HashMap<u32, Arc<RequestTask>>>,
+    /// Files of the queued tasks with user files, whose descriptors cannot be
+    /// reopened from the stored configuration. Everything else of a queued
+    /// task is built again from the database when it is scheduled.
+    user_files: Mutex<HashMap<u32, AttachedFiles>>,
+    progress_writer: ProgressWriter,
+    task_metas: TaskMetaCache,
     #[cfg(feature = "oh")]
     pub(crate) inner: *mut RequestDataBase,
     #[cfg(not(feature = "oh"))]
@@ -62,7 +138,9 @@ impl RequestDb {
             unsafe {
                 DB.write(RequestDb {
                     inner,
-                    user_file_tasks: Mutex::new(HashMap::new()),
+                    user_files: Mutex::new(HashMap::new()),
+                    progress_writer: ProgressWriter::new(),
+                    task_metas: TaskMetaCache::new(TASK_META_CAPACITY),
                 });
             }
         });
@@ -77,10 +155,23 @@ impl RequestDb {
         call_once(&ONCE, || {
             let inner = Connection::open_in_memory().unwrap();
             inner.execute(&CREATE_TABLE, ()).unwrap();
+            for sql in CREATE_INDEXES {
+                inner.execute(sql, ()).unwrap();
+            }
+            inner.execute(&CREATE_PROGRESS_TABLE, ()).unwrap();
+            inner.execute(&CREATE_PROGRESS_TRIGGER, ()).unwrap();
+            // Keyword searches scan the tasks without FTS5.
+            for sql in CREATE_SEARCH_INDEX {
+                if inner.execute(sql, ()).is_err() {
+                    break;
+                }
+            }
             unsafe {
                 DATABASE.write(RequestDb {
                     inner,
-                    user_file_tasks: Mutex::new(HashMap::new()),
+                    user_files: Mutex::new(HashMap::new()),
+                    progress_writer: ProgressWriter::new(),
+                    task_metas: TaskMetaCache::new(TASK_META_CAPACITY),
                 })
             };
         });
@@ -90,7 +181,19 @@ impl RequestDb {
 
     #[cfg(feature = "oh")]
     pub(crate) fn execute(&self, sql: &str) -> Result<(), i32> {
-        let ret = unsafe { Pin::new_unchecked(&mut *self.inner).ExecuteSql(sql) };
+        self.execute_with(sql, &[])
+    }
+
+    /// Executes `sql` with `args` bound to its placeholders.
+    ///
+    /// Statements with the same SQL text reuse the compiled statement of the
+    /// store, so callers keep their SQL constant and bind the values instead.
+    #[cfg(feature = "oh")]
+    pub(crate) fn execute_with(&self, sql: &str, args: &[SqlArg]) -> Result<(), i32> {
+        let start = Instant::now();
+        let ret = unsafe { Pin::new_unchecked(&mut *self.inner).ExecuteSqlWithArgs(sql, args) };
+        metrics::DB_STATEMENTS.add(1);
+        metrics::DB_STATEMENT_US.record_since(start);
         if ret == 0 {
             Ok(())
         } else {
@@ -106,9 +209,17 @@ impl RequestDb {
 
     #[cfg(not(feature = "oh"))]
     pub(crate) fn execute(&self, sql: &str) -> Result<(), i32> {
-        let res = self.inner.execute(sql, ());
+        self.execute_with(sql, &[])
+    }
 
-        self.inner.execute(sql, ()).map(|_| ()).map_err(|e| {
+    #[cfg(not(feature = "oh"))]
+    pub(crate) fn execute_with(&self, sql: &str, args: &[SqlArg]) -> Result<(), i32> {
+        let params = rusqlite::params_from_iter(args.iter().map(SqlArg::to_value));
+        let start = Instant::now();
+        let result = self.inner.execute(sql, params);
+        metrics::DB_STATEMENTS.add(1);
+        metrics::DB_STATEMENT_US.record_since(start);
+        result.map(|_| ()).map_err(|e| {
             error!("execute sql failed: {}", e);
             sys_event!(
                 ExecFault,
@@ -119,15 +230,24 @@ impl RequestDb {
         })
     }
 
-    #[cfg(feature = "oh")]
     pub(crate) fn query_integer<T: TryFrom<i64> + Default>(&self, sql: &str) -> Vec<T>
     where
         T::Error: Display,
     {
-        let mut v = vec![];
-        let ret = unsafe { Pin::new_unchecked(&mut *self.inner).QueryInteger(sql, &mut v) };
-        let v = v
-            .into_iter()
+        self.query_integer_with(sql, &[])
+    }
+
+    /// Runs the query `sql` with `args` bound to its placeholders.
+    #[cfg(feature = "oh")]
+    pub(crate) fn query_integer_with<T: TryFrom<i64> + Default>(
+        &self,
+        sql: &str,
+        args: &[SqlArg],
+    ) -> Vec<T>
+    where
+        T::Error: Display,
+    {
+        self.query_rows(sql, args, RequestResultSet::NextIntegers)
             .map(|a| {
                 a.try_into().unwrap_or_else(|e| {
                     error!("query_integer failed, value: {}", e);
@@ -139,67 +259,161 @@ impl RequestDb {
                     Default::default()
                 })
             })
-            .collect();
+            .collect()
+    }
 
-        if ret != 0 {
-            error!("query integer err:{}", ret);
+    /// Runs the query `sql` and streams its rows, `fetch` reads the next chunk
+    /// of rows from the result set.
+    #[cfg(feature = "oh")]
+    fn query_rows<T>(&self, sql: &str, args: &[SqlArg], fetch: FetchRows<T>) -> Rows<T> {
+        let start = Instant::now();
+        let set = unsafe { Pin::new_unchecked(&mut *self.inner).QueryStep(sql, args) };
+        metrics::DB_STATEMENTS.add(1);
+        metrics::DB_STATEMENT_US.record_since(start);
+        if set.is_null() {
+            error!("query {} failed", sql);
             sys_event!(
                 ExecFault,
                 DfxCode::RDB_FAULT_06,
-                &format!("query integer err:{}", ret)
+                &format!("query {} failed", sql)
             );
         }
-        v
+        Rows {
+            set,
+            fetch,
+            chunk: Vec::new().into_iter(),
+        }
     }
 
     #[cfg(not(feature = "oh"))]
-    pub(crate) fn query_integer<T: TryFrom<i64> + Default>(&self, sql: &str) -> Vec<T>
+    pub(crate) fn query_integer_with<T: TryFrom<i64> + Default>(
+        &self,
+        sql: &str,
+        args: &[SqlArg],
+    ) -> Vec<T>
     where
         T::Error: Display,
     {
-        let mut stmt = self.inner.prepare(sql).unwrap();
-        let rows = stmt.query_map([], |row| Ok(row.get(0).unwrap())).unwrap();
+        let start = Instant::now();
+        let mut stmt = self.inner.prepare_cached(sql).unwrap();
+        let params = rusqlite::params_from_iter(args.iter().map(SqlArg::to_value));
+        let rows = stmt.query_map(params, |row| Ok(row.get(0).unwrap())).unwrap();
         let v: Vec<i64> = rows.into_iter().map(|a| a.unwrap()).collect();
+        metrics::DB_STATEMENTS.add(1);
+        metrics::DB_STATEMENT_US.record_since(start);
         v.into_iter()
             .map(|a| a.try_into().unwrap_or_else(|_| Default::default()))
             .collect()
     }
 
-    pub(crate) fn contains_task(&self, task_id: u32) -> bool {
-        let sql = format!(
-            "SELECT COUNT(*) FROM request_task WHERE task_id = {}",
-            task_id
-        );
-        let v = self.query_integer::<u32>(&sql);
-        if v.is_empty() {
-            error!("contains_task check failed, empty result");
-            sys_event!(
-                ExecFault,
-                DfxCode::RDB_FAULT_06,
-                "contains_task check failed, empty result"
-            );
-            false
+    /// Reads all columns of the rows of `sql` as integers, `columns` per row.
+    #[cfg(feature = "oh")]
+    fn query_integer_rows(&self, sql: &str, columns: usize) -> Vec<Vec<i64>> {
+        let values: Vec<i64> = self
+            .query_rows(sql, &[], RequestResultSet::NextColumns)
+            .collect();
+        values.chunks_exact(columns).map(<[i64]>::to_vec).collect()
+    }
+
+    #[cfg(not(feature = "oh"))]
+    fn query_integer_rows(&self, sql: &str, columns: usize) -> Vec<Vec<i64>> {
+        let start = Instant::now();
+        let mut stmt = self.inner.prepare_cached(sql).unwrap();
+        let rows = stmt
+            .query_map([], |row| (0..columns).map(|i| row.get(i)).collect())
+            .unwrap();
+        let rows = rows.into_iter().filter_map(Result::ok).collect();
+        metrics::DB_STATEMENTS.add(1);
+        metrics::DB_STATEMENT_US.record_since(start);
+        rows
+    }
+
+    /// Reads all columns of the first row of `sql` as integers.
+    #[cfg(feature = "oh")]
+    fn query_row(&self, sql: &str, args: &[SqlArg]) -> Option<Vec<i64>> {
+        let start = Instant::now();
+        let mut set = unsafe { Pin::new_unchecked(&mut *self.inner).QueryStep(sql, args) };
+        metrics::DB_STATEMENTS.add(1);
+        metrics::DB_STATEMENT_US.record_since(start);
+        let set = set.as_mut()?;
+        let mut row = vec![];
+        if set.NextRow(&mut row) == 1 {
+            Some(row)
         } else {
-            v[0] == 1
+            None
         }
     }
 
+    #[cfg(not(feature = "oh"))]
+    fn query_row(&self, sql: &str, args: &[SqlArg]) -> Option<Vec<i64>> {
+        let start = Instant::now();
+        let mut stmt = self.inner.prepare_cached(sql).ok()?;
+        let columns = stmt.column_count();
+        let params = rusqlite::params_from_iter(args.iter().map(SqlArg::to_value));
+        let mut rows = stmt.query(params).ok()?;
+        let row = rows.next().ok()??;
+        metrics::DB_STATEMENTS.add(1);
+        metrics::DB_STATEMENT_US.record_since(start);
+        (0..columns).map(|i| row.get(i).ok()).collect()
+    }
+
+    /// Gets the immutable attributes of a task, from the cache if possible.
+    fn task_meta(&self, task_id: u32) -> Option<TaskMeta> {
+        if let Some(meta) = self.task_metas.get(task_id) {
+            metrics::TASK_META_HITS.add(1);
+            return Some(meta);
+        }
+        metrics::TASK_META_MISSES.add(1);
+        let row = self.query_row(QUERY_TASK_META, &[SqlArg::integer(task_id)])?;
+        let [uid, token_id, action] = row[..] else {
+            return None;
+        };
+        let meta = TaskMeta {
+            uid: uid as u64,
+            token_id: token_id as u64,
+            action: Action {
+                repr: action as u8,
+            },
+        };
+        self.task_metas.insert(task_id, meta);
+        Some(meta)
+    }
+
+    /// Forgets the cached attributes of a task whose row was deleted.
+    pub(crate) fn forget_task(&self, task_id: u32) {
+        self.task_metas.remove(task_id);
+        cpu::forget(task_id);
+        #[cfg(feature = "oh")]
+        trace::unbind(task_id);
+    }
+
+    /// Forgets the cached attributes of all tasks `f` returns `true` for,
+    /// after their rows were deleted.
+    pub(crate) fn forget_tasks_if(&self, f: impl Fn(&TaskMeta) -> bool) {
+        self.task_metas.remove_if(f);
+    }
+
+    /// Forgets the cached attributes of all tasks.
+    pub(crate) fn forget_all_tasks(&self) {
+        self.task_metas.clear();
+    }
+
+    pub(crate) fn contains_task(&self, task_id: u32) -> bool {
+        self.task_meta(task_id).is_some()
+    }
+
     pub(crate) fn query_task_token_id(&self, task_id: u32) -> Result<u64, i32> {
-        let sql = format!(
-            "SELECT token_id FROM request_task WHERE task_id = {}",
-            task_id
-        );
-        let v = self.query_integer::<u64>(&sql);
-        if v.is_empty() {
-            error!("query_task_token_id failed, empty result");
-            sys_event!(
-                ExecFault,
-                DfxCode::RDB_FAULT_06,
-                "query_task_token_id failed, empty result"
-            );
-            Err(-1)
-        } else {
-            Ok(v[0])
+        match self.task_meta(task_id) {
+            Some(meta) => Ok(meta.token_id),
+            None => {
+                error!("query_task_token_id failed, empty result");
+                sys_event!(
+                    ExecFault,
+                    DfxCode::RDB_FAULT_06,
+                    "query_task_token_id failed, empty result"
+                );
+                Err(-1)
+            }
         }
     }
 
@@ -222,17 +436,19 @@ impl RequestDb {
         let info_set = task_info.build_info_set();
         let c_task_info = task_info.to_c_struct(&info_set);
 
-        if !unsafe { RecordRequestTask(&c_task_info, &c_task_config) } {
+        if unsafe { RecordRequestTask(&c_task_info, &c_task_config) } {
+            self.task_metas.insert(
+                task_id,
+                TaskMeta {
+                    uid,
+                    token_id: task_config.common_data.token_id,
+                    action: task_config.common_data.action,
+                },
+            );
+        } else {
             info!("task {} insert database fail", task_id);
         }
 
-        // For some tasks contains user_file, we must save it to map first.
-        if task.conf.contains_user_file() {
-            self.user_file_tasks
-                .lock()
-                .unwrap()
-                .insert(task.task_id(), Arc::new(task));
-        };
         true
     }
 
@@ -287,25 +503,103 @@ impl RequestDb {
             State::Initialized.repr,
         );
         self.execute(&sql).unwrap();
+        let sql = format!(
+            "INSERT OR REPLACE INTO request_task_progress (task_id, mtime, tries, idx, total_processed, sizes, processed, extras) VALUES ({}, {}, 0, 0, 0, '[]', '[]', '')",
+            config.common_data.task_id,
+            get_current_timestamp(),
+        );
+        self.execute(&sql).unwrap();
 
-        // For some tasks contains user_file, we must save it to map first.
-        if task.conf.contains_user_file() {
-            self.user_file_tasks
-                .lock()
-                .unwrap()
-                .insert(task.task_id(), Arc::new(task));
-        };
         true
     }
 
+    /// Keeps the files of a task with user files until it is removed.
+    pub(crate) fn keep_user_files(&self, task_id: u32, files: AttachedFiles) {
+        self.user_files.lock().unwrap().insert(task_id, files);
+    }
+
     pub(crate) fn remove_user_file_task(&self, task_id: u32) {
-        let mut task_map = self.user_file_tasks.lock().unwrap();
+        let mut task_map = self.user_files.lock().unwrap();
         task_map.remove(&task_id);
         debug!("Remove completed user file task, task_id: {}", task_id);
     }
 
-    #[cfg(feature = "oh")]
+    /// Buffers a progress update of a task, it is written together with the
+    /// other buffered updates once `PROGRESS_PERSIST_INTERVAL` elapsed.
     pub(crate) fn update_task(&self, task_id: u32, update_info: UpdateInfo) {
+        if !self.progress_writer.push(task_id, update_info) {
+            return;
+        }
+        runtime_spawn(async {
+            ylong_runtime::time::sleep(PROGRESS_PERSIST_INTERVAL).await;
+            DbWorker::get_instance().post(|| RequestDb::get_instance().flush_progress());
+        });
+    }
+
+    /// Writes the buffered progress update of a task, if any.
+    pub(crate) fn flush_task_progress(&self, task_id: u32) {
+        if let Some(update_info) = self.progress_writer.take(task_id) {
+            cpu::measure(task_id, Path::Database, || {
+                self.write_task(task_id, update_info)
+            });
+        }
+    }
+
+    /// Writes all buffered progress updates in a single transaction.
+    pub(crate) fn flush_progress(&self) {
+        let updates = self.progress_writer.drain();
+        if updates.is_empty() {
+            return;
+        }
+        debug!("Flush {} progress updates to database", updates.len());
+        let transaction = self.begin_transaction();
+        for (task_id, update_info) in updates {
+            cpu::measure(task_id, Path::Database, || {
+                self.write_task(task_id, update_info)
+            });
+        }
+        if transaction {
+            self.commit();
+        }
+    }
+
+    #[cfg(feature = "oh")]
+    fn begin_transaction(&self) -> bool {
+        let ret = unsafe { Pin::new_unchecked(&mut *self.inner).BeginTransaction() };
+        if ret != 0 {
+            error!("begin transaction failed: {}", ret);
+        }
+        ret == 0
+    }
+
+    #[cfg(feature = "oh")]
+    fn commit(&self) {
+        let ret = unsafe { Pin::new_unchecked(&mut *self.inner).Commit() };
+        if ret != 0 {
+            error!("commit transaction failed: {}", ret);
+            sys_event!(
+                ExecFault,
+                DfxCode::RDB_FAULT_04,
+                &format!("commit transaction failed: {}", ret)
+            );
+            unsafe { Pin::new_unchecked(&mut *self.inner).RollBack() };
+        }
+    }
+
+    #[cfg(not(feature = "oh"))]
+    fn begin_transaction(&self) -> bool {
+        self.execute("BEGIN TRANSACTION").is_ok()
+    }
+
+    #[cfg(not(feature = "oh"))]
+    fn commit(&self) {
+        if self.execute("COMMIT").is_err() {
+            let _ = self.execute("ROLLBACK");
+        }
+    }
+
+    #[cfg(feature = "oh")]
+    fn write_task(&self, task_id: u32, update_info: UpdateInfo) {
         debug!("Update task in database, task_id: {}", task_id);
         if !self.contains_task(task_id) {
             return;
@@ -334,63 +628,104 @@ impl RequestDb {
     }
 
     pub(crate) fn query_task_uid(&self, task_id: u32) -> Option<u64> {
-        let sql = format!("SELECT uid FROM request_task WHERE task_id = {}", task_id);
-        self.query_integer(&sql).first().copied()
+        self.task_meta(task_id).map(|meta| meta.uid)
     }
 
-    pub(crate) fn query_task_action(&self, task_id: u32) -> Option<Action> {
+    /// Looks up the owners of several tasks with a single query.
+    ///
+    /// Tasks that do not exist are missing from the returned map.
+    pub(crate) fn query_tasks_uid(&self, task_ids: &[u32]) -> HashMap<u32, u64> {
+        let mut uids = HashMap::with_capacity(task_ids.len());
+        let mut missing = Vec::new();
+        for task_id in task_ids {
+            match self.task_metas.get(*task_id) {
+                Some(meta) => {
+                    uids.insert(*task_id, meta.uid);
+                }
+                None => missing.push(*task_id),
+            }
+        }
+        if missing.is_empty() {
+            return uids;
+        }
+        let ids = missing
+            .iter()
+            .map(|id| id.to_string())
+            .collect::<Vec<_>>()
+            .join(",");
+        // Both columns are packed into one integer, uids fit in the upper 32 bits.
         let sql = format!(
-            "SELECT action FROM request_task WHERE task_id = {}",
-            task_id
+            "SELECT (uid << 32) | task_id FROM request_task WHERE task_id IN ({})",
+            ids
         );
-        self.query_integer(&sql).first().map(|action: &i32| Action {
-            repr: *action as u8,
-        })
+        for packed in self.query_integer::<i64>(&sql) {
+            let packed = packed as u64;
+            uids.insert(packed as u32, packed >> 32);
+        }
+        uids
+    }
+
+    pub(crate) fn query_task_action(&self, task_id: u32) -> Option<Action> {
+        self.task_meta(task_id).map(|meta| meta.action)
     }
 
     #[cfg(not(feature = "oh"))]
-    pub(crate) fn update_task(&self, task_id: u32, update_info: UpdateInfo) {
+    fn write_task(&self, task_id: u32, update_info: UpdateInfo) {
         if !self.contains_task(task_id) {
             return;
         }
         let sql = format!(
-            "UPDATE request_task SET sizes = {:?}, processed = {:?}, extras = {} WHERE task_id = {}",
-            update_info.progress.sizes, update_info.progress.processed, hashmap_to_string(&update_info.progress.extras),
+            "INSERT OR REPLACE INTO request_task_progress (task_id, mtime, tries, mime_type, idx, total_processed, sizes, processed, extras) VALUES ({}, {}, {}, '{}', {}, {}, '{:?}', '{:?}', '{}')",
             task_id,
+            update_info.mtime,
+            update_info.tries,
+            update_info.mime_type,
+            update_info.progress.common_data.index,
+            update_info.progress.common_data.total_processed,
+            update_info.progress.sizes,
+            update_info.progress.processed,
+            hashmap_to_string(&update_info.progress.extras),
         );
         self.execute(&sql).unwrap();
     }
 
     pub(crate) fn update_task_state(&self, task_id: u32, state: State, reason: Reason) {
-        let sql = format!(
-            "UPDATE request_task SET state = {}, mtime = {}, reason = {} WHERE task_id = {}",
-            state.repr,
-            get_current_timestamp(),
-            reason.repr,
-            task_id
-        );
-        let _ = self.execute(&sql);
+        // State changes, terminal ones in particular, are written synchronously
+        // together with the progress they were reached with.
+        self.flush_task_progress(task_id);
+        let args = [
+            SqlArg::integer(state.repr),
+            SqlArg::integer(get_current_timestamp() as i64),
+            SqlArg::integer(reason.repr),
+            SqlArg::integer(task_id),
+        ];
+        let _ = self.execute_with(UPDATE_TASK_STATE, &args);
     }
 
     pub(crate) fn update_task_max_speed(&self, task_id: u32, max_speed: i64) {
-        let sql = format!(
-            "UPDATE request_task SET max_speed = {} WHERE task_id = {}",
-            max_speed, task_id
-        );
-        let _ = self.execute(&sql);
+        let args = [SqlArg::integer(max_speed), SqlArg::integer(task_id)];
+        let _ = self.execute_with(UPDATE_TASK_MAX_SPEED, &args);
+    }
+
+    pub(crate) fn update_task_performance(&self, task_id: u32, performance: &Performance) {
+        let args = [SqlArg::text(performance.encode()), SqlArg::integer(task_id)];
+        let _ = self.execute_with(UPDATE_TASK_PERFORMANCE, &args);
     }
 
     pub(crate) fn update_task_sizes(&self, task_id: u32, sizes: &Vec<i64>) {
-        let sql = format!(
-            "UPDATE request_task SET sizes = '{:?}' WHERE task_id = {}",
-            sizes, task_id
-        );
-        let _ = self.execute(&sql);
+        // A buffered progress update carries the sizes it was made with.
+        self.flush_task_progress(task_id);
+        let args = [
+            SqlArg::text(format!("{:?}", sizes)),
+            SqlArg::integer(task_id),
+        ];
+        let _ = self.execute_with(UPDATE_TASK_SIZES, &args);
     }
 
     #[cfg(feature = "oh")]
     pub(crate) fn get_task_info(&self, task_id: u32) -> Option<TaskInfo> {
         debug!("Get task info from database");
+        self.flush_task_progress(task_id);
         let c_task_info = unsafe { GetTaskInfo(task_id) };
         if c_task_info.is_null() {
             info!("No task found in database");
@@ -403,26 +738,70 @@ impl RequestDb {
     }
 
     pub(crate) fn query_task_total_processed(&self, task_id: u32) -> Option<i64> {
-        let sql = format!(
-            "SELECT total_processed FROM request_task WHERE task_id = {}",
-            task_id
-        );
-        self.query_integer(&sql).first().copied()
+        self.flush_task_progress(task_id);
+        self.query_integer_with(QUERY_TASK_TOTAL_PROCESSED, &[SqlArg::integer(task_id)])
+            .first()
+            .copied()
+    }
+
+    /// Loads the seed and the high-water mark of the task ID allocator, `None`
+    /// if they were never stored.
+    pub(crate) fn task_id_state(&self) -> Option<(i64, i64)> {
+        self.execute(CREATE_TASK_ID_TABLE).ok()?;
+        let row = self.query_row(QUERY_TASK_ID_STATE, &[])?;
+        let [seed, reserved] = row[..] else {
+            return None;
+        };
+        Some((seed, reserved))
+    }
+
+    /// Stores the seed and the high-water mark of the task ID allocator.
+    pub(crate) fn store_task_id_state(&self, seed: i64, reserved: i64) -> Result<(), i32> {
+        self.execute_with(
+            UPDATE_TASK_ID_STATE,
+            &[SqlArg::integer(seed), SqlArg::integer(reserved)],
+        )
+    }
+
+    /// Gets the IDs of all the stored tasks.
+    pub(crate) fn task_ids(&self) -> Vec<u32> {
+        self.query_integer(QUERY_TASK_IDS)
     }
 
     pub(crate) fn query_task_state(&self, task_id: u32) -> Option<u8> {
-        let sql = format!("SELECT state FROM request_task WHERE task_id = {}", task_id);
-        self.query_integer(&sql)
+        self.query_integer_with(QUERY_TASK_STATE, &[SqlArg::integer(task_id)])
             .first()
             .map(|state: &i32| *state as u8)
     }
 
+    /// Looks up the state and the processed bytes of several tasks with a
+    /// single query, once their buffered progress is written.
+    ///
+    /// Tasks that do not exist are missing from the returned rows.
+    pub(crate) fn query_tasks_progress(&self, task_ids: &[u32]) -> Vec<(u32, u8, u64)> {
+        if task_ids.is_empty() {
+            return Vec::new();
+        }
+        self.flush_progress();
+        let ids = task_ids
+            .iter()
+            .map(|id| id.to_string())
+            .collect::<Vec<_>>()
+            .join(",");
+        let sql = format!("{} ({})", QUERY_TASKS_PROGRESS, ids);
+        self.query_integer_rows(&sql, 3)
+            .into_iter()
+            .map(|row| (row[0] as u32, row[1] as u8, row[2] as u64))
+            .collect()
+    }
+
     #[cfg(not(feature = "oh"))]
     pub(crate) fn get_task_info(&self, task_id: u32) -> Option<TaskInfo> {
         use crate::info::CommonTaskInfo;
         use crate::task::notify::Progress;
 
-        let sql = format!("SELECT task_id, uid, action, mode, mtime, reason, gauge, retry, version, priority, ctime, tries, url, data, token, state, idx from request_task where task_id = {}", task_id);
+        self.flush_task_progress(task_id);
+        let sql = format!("SELECT t.task_id, t.uid, t.action, t.mode, MAX(IFNULL(t.mtime, 0), IFNULL(p.mtime, 0)), t.reason, t.gauge, t.retry, t.version, t.priority, t.ctime, IFNULL(p.tries, t.tries), t.url, t.data, t.token, t.state, IFNULL(p.idx, t.idx) from request_task AS t LEFT JOIN request_task_progress AS p ON p.task_id = t.task_id where t.task_id = {}", task_id);
         let mut stmt = self.inner.prepare(&sql).unwrap();
         let mut row = stmt
             .query_map([], |row| {
@@ -524,9 +903,10 @@ impl RequestDb {
                     bundle: Default::default(),
                     bundle_type: 0,
                     body_file_paths: vec![],
-                    certs_path: vec![],
+                    certs_path: Default::default(),
                     proxy: Default::default(),
                     certificate_pins: Default::default(),
+                    checksum: Default::default(),
                     atomic_account: Default::default(),
                 })
             })
@@ -544,11 +924,12 @@ impl RequestDb {
                 mode: 0,
                 state: 0,
                 priority: 0,
+                remaining: -1,
+                deadline: 0,
+                uid: 0,
+                prefetch: false,
             };
-            let sql = format!(
-                "SELECT action, mode, state, priority FROM request_task WHERE task_id = {}",
-                task_id
-            );
+            let sql = format!("{} WHERE t.task_id = {}", QUERY_TASK_QOS_INFO, task_id);
             let ret =
                 unsafe { Pin::new_unchecked(&mut *self.inner).GetTaskQosInfo(&sql, &mut info) };
             if ret == 0 {
@@ -561,10 +942,7 @@ impl RequestDb {
 
     #[cfg(not(feature = "oh"))]
     pub(crate) fn get_task_qos_info(&self, task_id: u32) -> Option<TaskQosInfo> {
-        let sql = format!(
-            "SELECT action, mode, state, priority FROM request_task WHERE task_id = {}",
-            task_id,
-        );
+        let sql = format!("{} WHERE t.task_id = {}", QUERY_TASK_QOS_INFO, task_id);
         let mut stmt = self.inner.prepare(&sql).unwrap();
         let mut rows = stmt
             .query_map([], |row| {
@@ -574,6 +952,13 @@ impl RequestDb {
                     mode: row.get::<_, u8>(1).unwrap().into(),
                     state: row.get(2).unwrap(),
                     priority: row.get(3).unwrap(),
+                    remaining: remaining_bytes(
+                        &row.get::<_, String>(5).unwrap_or_default(),
+                        row.get(4).unwrap_or(0),
+                    ),
+                    deadline: row.get(6).unwrap_or(0),
+                    uid: row.get(7).unwrap(),
+                    prefetch: row.get(8).unwrap_or(false),
                 })
             })
             .unwrap();
@@ -583,9 +968,8 @@ impl RequestDb {
     pub(crate) fn get_app_task_qos_infos_inner(&self, sql: &str) -> Vec<TaskQosInfo> {
         #[cfg(feature = "oh")]
         {
-            let mut v = vec![];
-            let _ = unsafe { Pin::new_unchecked(&mut *self.inner).GetAppTaskQosInfos(sql, &mut v) };
-            v
+            self.query_rows(sql, &[], RequestResultSet::NextTaskQosInfos)
+                .collect()
         }
         #[cfg(not(feature = "oh"))]
         {
@@ -598,6 +982,13 @@ impl RequestDb {
                         mode: row.get::<_, u8>(2).unwrap().into(),
                         state: row.get(3).unwrap(),
                         priority: row.get(4).unwrap(),
+                        remaining: remaining_bytes(
+                            &row.get::<_, String>(6).unwrap_or_default(),
+                            row.get(5).unwrap_or(0),
+                        ),
+                        deadline: row.get(7).unwrap_or(0),
+                        uid: row.get(8).unwrap(),
+                        prefetch: row.get(9).unwrap_or(false),
                     })
                 })
                 .unwrap();
@@ -607,12 +998,24 @@ impl RequestDb {
 
     pub(crate) fn get_app_task_qos_infos(&self, uid: u64) -> Vec<TaskQosInfo> {
         let sql = format!(
-            "SELECT task_id, action, mode, state, priority FROM request_task WHERE uid = {} AND ((state = {} AND reason = {}) OR state = {} OR state = {})",
+            "{} WHERE t.uid = {} AND {}",
+            QUERY_TASK_QOS_INFOS,
             uid,
-            State::Waiting.repr,
-            Reason::RunningTaskMeetLimits.repr,
-            State::Running.repr,
-            State::Retrying.repr,
+            qos_states_condition(),
+        );
+        self.get_app_task_qos_infos_inner(&sql)
+    }
+
+    /// Retrieves the QoS information of the tasks of all applications in one
+    /// query, grouped by application.
+    ///
+    /// This replaces a query of the application list followed by one query
+    /// per application when the scheduler restores its tasks.
+    pub(crate) fn get_all_task_qos_infos(&self) -> Vec<TaskQosInfo> {
+        let sql = format!(
+            "{} WHERE {} ORDER BY t.uid",
+            QUERY_TASK_QOS_INFOS,
+            qos_states_condition(),
         );
         self.get_app_task_qos_infos_inner(&sql)
     }
@@ -624,11 +1027,6 @@ impl RequestDb {
         client_manager: &ClientManagerEntry,
         upload_resume: bool,
     ) -> Result<Arc<RequestTask>, ErrorCode> {
-        // If this task exists in `user_file_map`，get it from this map.
-        if let Some(task) = self.user_file_tasks.lock().unwrap().get(&task_id) {
-            return Ok(task.clone());
-        }
-
         // 此处需要根据 task_id 从数据库构造指定的任务。
         let config = match self.get_task_config(task_id) {
             Some(config) => config,
@@ -653,14 +1051,28 @@ impl RequestDb {
             return Err(ErrorCode::TaskStateErr);
         }
 
-        match RequestTask::new_by_info(
-            config,
-            #[cfg(feature = "oh")]
-            system,
-            task_info,
-            client_manager.clone(),
-            upload_resume,
-        ) {
+        // Tasks with user files are built with the files they kept.
+        let user_files = self.user_files.lock().unwrap().get(&task_id).cloned();
+        let task = match user_files {
+            Some(files) => RequestTask::new_by_info_with_files(
+                config,
+                #[cfg(feature = "oh")]
+                system,
+                task_info,
+                files,
+                client_manager.clone(),
+                upload_resume,
+            ),
+            None => RequestTask::new_by_info(
+                config,
+                #[cfg(feature = "oh")]
+                system,
+                task_info,
+                client_manager.clone(),
+                upload_resume,
+            ),
+        };
+        match task {
             Ok(task) => Ok(Arc::new(task)),
             Err(e) => {
                 error!("new RequestTask failed {}, err: {:?}", task_id, e);
@@ -675,6 +1087,82 @@ impl RequestDb {
     }
 }
 
+/// Returns the condition selecting the tasks the scheduler holds, those
+/// waiting for a slot, running or retrying.
+fn qos_states_condition() -> String {
+    format!(
+        "((t.state = {} AND t.reason = {}) OR t.state = {} OR t.state = {})",
+        State::Waiting.repr,
+        Reason::RunningTaskMeetLimits.repr,
+        State::Running.repr,
+        State::Retrying.repr,
+    )
+}
+
+/// Returns the bytes left of a task whose files have the stored `sizes`, or
+/// -1 if the size of a file is not known yet.
+#[cfg(not(feature = "oh"))]
+fn remaining_bytes(sizes: &str, total_processed: i64) -> i64 {
+    let sizes = sizes
+        .trim_matches(|c| c == '[' || c == ']')
+        .split(',')
+        .map(|size| size.trim().parse::<i64>().ok().filter(|size| *size >= 0))
+        .collect::<Option<Vec<_>>>();
+    match sizes {
+        Some(sizes) => (sizes.iter().sum::<i64>() - total_processed).max(0),
+        None => -1,
+    }
+}
+
+/// Reads up to `limit` rows of a result set into the vector, see `Rows`.
+#[cfg(feature = "oh")]
+type FetchRows<T> = fn(Pin<&mut RequestResultSet>, &mut Vec<T>, usize) -> i32;
+
+/// Rows handed over from the result set per call.
+#[cfg(feature = "oh")]
+const QUERY_CHUNK_ROWS: usize = 128;
+
+/// Forward-only rows of a query.
+///
+/// Rows are stepped through once and fetched in chunks of `QUERY_CHUNK_ROWS`,
+/// so memory stays bounded by the chunk and the first rows are available
+/// before the whole statement has run.
+#[cfg(feature = "oh")]
+pub(crate) struct Rows<T> {
+    /// Remaining rows, null once they are exhausted.
+    set: UniquePtr<RequestResultSet>,
+    fetch: FetchRows<T>,
+    chunk: std::vec::IntoIter<T>,
+}
+
+#[cfg(feature = "oh")]
+impl<T> Iterator for Rows<T> {
+    type Item = T;
+
+    fn next(&mut self) -> Option<T> {
+        if let Some(row) = self.chunk.next() {
+            return Some(row);
+        }
+        let set = self.set.as_mut()?;
+        let mut chunk = Vec::with_capacity(QUERY_CHUNK_ROWS);
+        let ret = (self.fetch)(set, &mut chunk, QUERY_CHUNK_ROWS);
+        if ret < 0 {
+            error!("query next rows failed: {}", ret);
+            sys_event!(
+                ExecFault,
+                DfxCode::RDB_FAULT_06,
+                &format!("query next rows failed: {}", ret)
+            );
+        }
+        if ret < QUERY_CHUNK_ROWS as i32 {
+            // Closes the result set right away instead of on drop.
+            self.set = UniquePtr::null();
+        }
+        self.chunk = chunk.into_iter();
+        self.chunk.next()
+    }
+}
+
 unsafe impl Send for RequestDb {}
 unsafe impl Sync for RequestDb {}
 
@@ -699,14 +1187,55 @@ mod ffi {
         pub(crate) mode: u8,
         pub(crate) state: u8,
         pub(crate) priority: u32,
+        /// Bytes left to transfer, -1 if the size of a file is unknown.
+        pub(crate) remaining: i64,
+        /// Time in milliseconds since the epoch the task should be done by, 0
+        /// for none.
+        pub(crate) deadline: u64,
+        /// The user ID of the application owning the task.
+        pub(crate) uid: u64,
+        /// Whether the task waits for the prefetch window.
+        pub(crate) prefetch: bool,
+    }
+
+    /// A value bound to a `?` placeholder of a statement.
+    #[derive(Clone, Debug)]
+    pub(crate) struct SqlArg {
+        pub(crate) is_text: bool,
+        pub(crate) integer: i64,
+        pub(crate) text: String,
     }
 
     unsafe extern "C++" {
         include!("c_request_database.h");
         type RequestDataBase;
+        type RequestResultSet;
+        fn NextIntegers(self: Pin<&mut RequestResultSet>, v: &mut Vec<i64>, limit: usize) -> i32;
+        fn NextRow(self: Pin<&mut RequestResultSet>, v: &mut Vec<i64>) -> i32;
+        fn NextColumns(self: Pin<&mut RequestResultSet>, v: &mut Vec<i64>, limit: usize) -> i32;
+        fn NextTaskQosInfos(
+            self: Pin<&mut RequestResultSet>,
+            v: &mut Vec<TaskQosInfo>,
+            limit: usize,
+        ) -> i32;
         fn GetDatabaseInstance(path: &str, encrypt: bool) -> *mut RequestDataBase;
         fn ExecuteSql(self: Pin<&mut RequestDataBase>, sql: &str) -> i32;
+        fn ExecuteSqlWithArgs(self: Pin<&mut RequestDataBase>, sql: &str, args: &[SqlArg]) -> i32;
         fn QueryInteger(self: Pin<&mut RequestDataBase>, sql: &str, v: &mut Vec<i64>) -> i32;
+        fn QueryIntegerWithArgs(
+            self: Pin<&mut RequestDataBase>,
+            sql: &str,
+            args: &[SqlArg],
+            v: &mut Vec<i64>,
+        ) -> i32;
+        fn QueryStep(
+            self: Pin<&mut RequestDataBase>,
+            sql: &str,
+            args: &[SqlArg],
+        ) -> UniquePtr<RequestResultSet>;
+        fn BeginTransaction(self: Pin<&mut RequestDataBase>) -> i32;
+        fn Commit(self: Pin<&mut RequestDataBase>) -> i32;
+        fn RollBack(self: Pin<&mut RequestDataBase>) -> i32;
         fn GetAppTaskQosInfos(
             self: Pin<&mut RequestDataBase>,
             sql: &str,
@@ -722,3 +1251,9 @@ mod ffi {
 mod ut_database {
     include!("../../tests/ut/manage/ut_database.rs");
 }
+
+// Built by the `rust_request_db_benchmark` target only.
+#[cfg(all(test, db_bench))]
+mod bench_database {
+    include!("../../tests/bench/bench_database.rs");
+}
@@ -0,0 +1,97 @@
+// Copyright (C) 2024 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Dedicated executor for database I/O.
+//!
+//! Database jobs are queued to a single worker thread and run in submission
+//! order, so writes posted by the task manager are never reordered against
+//! each other. Callers that need the result await the returned receiver from
+//! a spawned future instead of blocking the task manager event loop.
+
+use std::mem::MaybeUninit;
+use std::sync::mpsc::{self, Sender};
+use std::sync::{Mutex, Once};
+use std::thread;
+
+use ylong_runtime::sync::oneshot::{self, Receiver};
+
+use crate::utils::call_once;
+
+type Job = Box<dyn FnOnce() + Send>;
+
+/// Runs database jobs on its own thread.
+pub(crate) struct DbWorker {
+    tx: Mutex<Sender<Job>>,
+}
+
+impl DbWorker {
+    /// Gets the worker of the request database.
+    pub(crate) fn get_instance() -> &'static Self {
+        static mut WORKER: MaybeUninit<DbWorker> = MaybeUninit::uninit();
+        static ONCE: Once = Once::new();
+
+        call_once(&ONCE, || unsafe {
+            WORKER.write(DbWorker::new("RequestDbWorker"));
+        });
+        unsafe { WORKER.assume_init_ref() }
+    }
+
+    /// Starts a worker thread called `name`.
+    pub(crate) fn new(name: &str) -> Self {
+        let (tx, rx) = mpsc::channel::<Job>();
+        let spawned = thread::Builder::new()
+            .name(name.to_string())
+            .spawn(move || {
+                while let Ok(job) = rx.recv() {
+                    job();
+                }
+            });
+        if let Err(e) = spawned {
+            error!("spawn database worker failed {:?}", e);
+        }
+        Self { tx: Mutex::new(tx) }
+    }
+
+    /// Queues `f` and returns a receiver that resolves to its result.
+    pub(crate) fn run<T, F>(&self, f: F) -> Receiver<T>
+    where
+        T: Send + 'static,
+        F: FnOnce() -> T + Send + 'static,
+    {
+        let (tx, rx) = oneshot::channel();
+        self.post(move || {
+            let _ = tx.send(f());
+        });
+        rx
+    }
+
+    /// Queues `f` without waiting for it.
+    ///
+    /// If the worker thread is gone the job runs on the calling thread, so no
+    /// write is ever lost.
+    pub(crate) fn post<F>(&self, f: F)
+    where
+        F: FnOnce() + Send + 'static,
+    {
+        let job: Job = Box::new(f);
+        if let Err(e) = self.tx.lock().unwrap().send(job) {
+            error!("database worker stopped, run job inline");
+            (e.0)();
+        }
+    }
+}
+
+#[cfg(test)]
+mod ut_db_worker {
+    include!("../../tests/ut/manage/ut_db_worker.rs");
+}
@@ -0,0 +1,85 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Device state monitoring for prefetch windows.
+//!
+//! Prefetch tasks wait until the device is charging and idle. The power
+//! supply is read from the sticky battery event, delivered once on
+//! subscription and on every change, and the device is considered idle while
+//! its screen is off.
+
+use super::task_manager::TaskManagerTx;
+use crate::manage::events::{StateEvent, TaskManagerEvent};
+use crate::utils::{CommonEventSubscriber, CommonEventWant};
+
+/// Battery event parameter of the type of the plugged power supply, 0 for
+/// none.
+const PLUGGED_TYPE: &str = "pluggedType";
+
+/// Change of the state of the device.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub(crate) enum DeviceChange {
+    /// The device started or stopped charging.
+    Charging(bool),
+    /// The device became idle or was woken up.
+    Idle(bool),
+}
+
+/// Subscriber for battery events, which tell whether the device is charging.
+pub(crate) struct BatterySubscriber {
+    /// Task manager transmitter for sending device state events.
+    task_manager: TaskManagerTx,
+}
+
+impl BatterySubscriber {
+    /// Creates a new battery subscriber.
+    pub(crate) fn new(task_manager: TaskManagerTx) -> Self {
+        Self { task_manager }
+    }
+}
+
+impl CommonEventSubscriber for BatterySubscriber {
+    fn on_receive_event(&self, _code: i32, _data: String, want: CommonEventWant) {
+        if let Some(plugged) = want.get_int_param(PLUGGED_TYPE) {
+            self.task_manager
+                .send_event(TaskManagerEvent::State(StateEvent::Device(
+                    DeviceChange::Charging(plugged != 0),
+                )));
+        }
+    }
+}
+
+/// Subscriber for screen events, which tell whether the device is idle.
+pub(crate) struct ScreenSubscriber {
+    /// Task manager transmitter for sending device state events.
+    task_manager: TaskManagerTx,
+    /// Whether the subscribed event makes the device idle.
+    idle: bool,
+}
+
+impl ScreenSubscriber {
+    /// Creates a subscriber for the screen event making the device `idle` or
+    /// not.
+    pub(crate) fn new(task_manager: TaskManagerTx, idle: bool) -> Self {
+        Self { task_manager, idle }
+    }
+}
+
+impl CommonEventSubscriber for ScreenSubscriber {
+    fn on_receive_event(&self, _code: i32, _data: String, _want: CommonEventWant) {
+        self.task_manager
+            .send_event(TaskManagerEvent::State(StateEvent::Device(
+                DeviceChange::Idle(self.idle),
+            )));
+    }
+}
@@ -0,0 +1,118 @@
+// Copyright (C) 2024 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Snapshot of the environment the tasks run in.
+//!
+//! The network, the system proxy, the foreground applications and the
+//! accounts change through their own callbacks. Each change publishes a new
+//! immutable `Environment` with a higher version, instead of the readers
+//! asking the system, or locking the state of the callbacks, for every task.
+//!
+//! A thread keeps the last snapshot it read and only takes the lock of the
+//! current snapshot again once the version changed, so reading the
+//! environment is a load of the version and a reference count increment.
+
+use std::cell::RefCell;
+use std::collections::HashSet;
+use std::sync::atomic::{AtomicU64, Ordering};
+use std::sync::{Arc, LazyLock, RwLock};
+
+use crate::manage::network::NetworkState;
+
+/// Proxy of the system, empty strings if none is set.
+#[derive(Clone, Default, Debug, PartialEq, Eq)]
+pub(crate) struct SystemProxy {
+    /// Proxy host.
+    pub(crate) host: String,
+    /// Proxy port.
+    pub(crate) port: String,
+    /// Hosts reached without the proxy, separated by commas.
+    pub(crate) exlist: String,
+}
+
+/// Environment of the tasks at one point in time.
+#[derive(Clone, Debug)]
+pub(crate) struct Environment {
+    /// Incremented by each published change.
+    pub(crate) version: u64,
+    /// Network the tasks run on.
+    pub(crate) network: NetworkState,
+    /// Proxy of the system.
+    pub(crate) proxy: SystemProxy,
+    /// Uids of the applications in foreground.
+    pub(crate) foreground_uids: HashSet<u64>,
+    /// Account in foreground.
+    pub(crate) foreground_account: u64,
+    /// Accounts in foreground or background.
+    pub(crate) active_accounts: HashSet<u64>,
+}
+
+impl Environment {
+    fn new() -> Self {
+        Self {
+            version: 0,
+            network: NetworkState::Offline,
+            proxy: SystemProxy::default(),
+            foreground_uids: HashSet::new(),
+            foreground_account: 0,
+            active_accounts: HashSet::from([0]),
+        }
+    }
+}
+
+static VERSION: AtomicU64 = AtomicU64::new(0);
+
+static CURRENT: LazyLock<RwLock<Arc<Environment>>> =
+    LazyLock::new(|| RwLock::new(Arc::new(Environment::new())));
+
+thread_local! {
+    static CACHED: RefCell<Option<Arc<Environment>>> = RefCell::new(None);
+}
+
+/// Returns the current environment.
+pub(crate) fn snapshot() -> Arc<Environment> {
+    let version = VERSION.load(Ordering::Acquire);
+    CACHED.with(|cached| {
+        let mut cached = cached.borrow_mut();
+        match cached.as_ref() {
+            Some(environment) if environment.version == version => environment.clone(),
+            _ => {
+                let environment = CURRENT.read().unwrap().clone();
+                *cached = Some(environment.clone());
+                environment
+            }
+        }
+    })
+}
+
+/// Publishes a change of the environment.
+///
+/// `f` changes a copy of the current environment and returns whether it
+/// changed anything, nothing is published otherwise.
+pub(crate) fn update<F: FnOnce(&mut Environment) -> bool>(f: F) {
+    let mut current = CURRENT.write().unwrap();
+    let mut environment = Environment::clone(&current);
+    if !f(&mut environment) {
+        return;
+    }
+    environment.version += 1;
+    let version = environment.version;
+    *current = Arc::new(environment);
+    // Readers seeing the new version find the new snapshot under the lock.
+    VERSION.store(version, Ordering::Release);
+}
+
+#[cfg(test)]
+mod ut_environment {
+    include!("../../tests/ut/manage/ut_environment.rs");
+}
@@ -19,6 +19,7 @@
 
 cfg_oh! {
     use crate::ability::SYSTEM_CONFIG_MANAGER;
+    use crate::trace::{self, RequestTrace};
 }
 
 use crate::config::Mode;
@@ -65,6 +66,10 @@ impl TaskManager {
         // Generate a unique task ID and assign it to the configuration
         let task_id = TaskIdGenerator::generate();
         config.common_data.task_id = task_id;
+        #[cfg(feature = "oh")]
+        let trace_id = config.common_data.trace_id;
+        #[cfg(feature = "oh")]
+        let _trace = RequestTrace::start(trace_id, "create");
 
         // Extract user ID and version for logging and validation
         let uid = config.common_data.uid;
@@ -107,10 +112,11 @@ impl TaskManager {
         let rest_time = get_rest_time(&config, 0);
         let (files, client) = check_config(
             &config,
-            rest_time,
             #[cfg(feature = "oh")]
             system_config,
         )?;
+        // User files cannot be reopened later, the queued task keeps them.
+        let user_files = config.contains_user_file().then(|| files.clone());
         // Create a new request task with validated configuration and resources
         let task = RequestTask::new(
             config,
@@ -122,7 +128,15 @@ impl TaskManager {
         );
         // New task: State::Initialized, Reason::Default
         // Insert the new task into the database for persistence
-        RequestDb::get_instance().insert_task(task);
+        let database = RequestDb::get_instance();
+        if database.insert_task(task) {
+            if let Some(files) = user_files {
+                database.keep_user_files(task_id, files);
+            }
+        }
+        // Later stages of the task are traced with the trace of its client.
+        #[cfg(feature = "oh")]
+        trace::bind(task_id, trace_id);
         Ok(task_id)
     }
 }
@@ -22,9 +22,11 @@ use std::fmt::Debug;
 use ylong_runtime::sync::oneshot::{channel, Sender};
 
 use super::account::AccountEvent;
-use crate::config::{Action, Mode};
+use super::device_state::DeviceChange;
+use super::scheduler::state::sql::QosUpdate;
+use super::scheduler::SchedulePolicy;
+use crate::config::Mode;
 use crate::error::ErrorCode;
-use crate::info::TaskInfo;
 use crate::task::config::TaskConfig;
 use crate::task::info::{DumpAllInfo, DumpOneInfo};
 use crate::task::reason::Reason;
@@ -38,6 +40,7 @@ mod remove;
 mod resume;
 mod set_max_speed;
 mod set_mode;
+mod set_schedule_policy;
 mod start;
 mod stop;
 
@@ -59,8 +62,6 @@ pub(crate) enum TaskManagerEvent {
     Device(i32),
     /// Account-related events.
     Account(AccountEvent),
-    /// Task information query events.
-    Query(QueryEvent),
     /// Trigger to reschedule all tasks.
     Reschedule,
 }
@@ -204,6 +205,16 @@ impl TaskManagerEvent {
         )
     }
 
+    /// Creates a new event to dump the trace of the scheduling decisions.
+    ///
+    /// # Returns
+    ///
+    /// A tuple containing the event and a receiver for the formatted trace.
+    pub(crate) fn dump_trace() -> (Self, Recv<String>) {
+        let (tx, rx) = channel::<String>();
+        (Self::Service(ServiceEvent::DumpTrace(tx)), Recv::new(rx))
+    }
+
     /// Creates a new event to set the mode of a specific task.
     ///
     /// # Arguments
@@ -223,6 +234,28 @@ impl TaskManagerEvent {
         )
     }
 
+    /// Creates a new event to select the policy ordering the tasks of an
+    /// application.
+    ///
+    /// # Arguments
+    ///
+    /// * `uid` - The user ID of the application.
+    /// * `policy` - The policy to order its tasks with.
+    ///
+    /// # Returns
+    ///
+    /// A tuple containing the event and a receiver for the operation result.
+    pub(crate) fn set_schedule_policy(
+        uid: u64,
+        policy: SchedulePolicy,
+    ) -> (Self, Recv<ErrorCode>) {
+        let (tx, rx) = channel::<ErrorCode>();
+        (
+            Self::Service(ServiceEvent::SetSchedulePolicy(uid, policy, tx)),
+            Recv::new(rx),
+        )
+    }
+
     /// Creates a new event to notify about network state changes.
     ///
     /// # Returns
@@ -293,17 +326,6 @@ impl TaskManagerEvent {
     }
 }
 
-/// Events for querying task information.
-#[derive(Debug)]
-pub(crate) enum QueryEvent {
-    /// Query task information by ID and action type.
-    Query(u32, Action, Sender<Option<TaskInfo>>),
-    /// Show task information by ID and user ID.
-    Show(u32, u64, Sender<Option<TaskInfo>>),
-    /// Touch (update last access time) and get task information.
-    Touch(u32, u64, String, Sender<Option<TaskInfo>>),
-}
-
 /// Service operation events for task management.
 #[derive(Debug)]
 pub(crate) enum ServiceEvent {
@@ -323,12 +345,16 @@ pub(crate) enum ServiceEvent {
     DumpOne(u32, Sender<Option<DumpOneInfo>>),
     /// Dump information for all tasks.
     DumpAll(Sender<DumpAllInfo>),
+    /// Dump the trace of the scheduling decisions.
+    DumpTrace(Sender<String>),
     /// Attach multiple tasks to a group.
     AttachGroup(u64, Vec<u32>, u32, Sender<ErrorCode>),
     /// Set maximum speed limit for a specific task.
     SetMaxSpeed(u64, u32, i64, Sender<ErrorCode>),
     /// Set the execution mode for a specific task.
     SetMode(u64, u32, Mode, Sender<ErrorCode>),
+    /// Select the policy ordering the tasks of an application.
+    SetSchedulePolicy(u64, SchedulePolicy, Sender<ErrorCode>),
 }
 
 /// Task state and lifecycle events.
@@ -361,6 +387,8 @@ pub(crate) enum StateEvent {
     AppUninstall(u64),
     /// Application has been terminated specially.
     SpecialTerminate(u64),
+    /// Charging or idleness of the device has changed.
+    Device(DeviceChange),
 }
 
 /// Message containing task configuration for task construction.
@@ -402,6 +430,16 @@ pub(crate) enum ScheduleEvent {
     Unload,
     /// Shutdown the service completely.
     Shutdown,
+    /// Update the QoS queue after state changes were written to the
+    /// database.
+    UpdateQos(QosUpdate),
+    /// Timed out tasks were stopped in the database.
+    TimeoutTasksStopped(Vec<(u64, u32)>),
+    /// Delete a chunk of expired tasks and maintain the database if the
+    /// service or the device is idle.
+    ReapExpiredTasks,
+    /// Sample the bytes transferred by the running tasks.
+    SampleBandwidth,
 }
 
 #[cfg(not(feature = "oh"))]
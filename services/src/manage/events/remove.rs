@@ -20,6 +20,7 @@ use crate::error::ErrorCode;
 use crate::info::State;
 use crate::manage::database::RequestDb;
 use crate::manage::TaskManager;
+use crate::task::handoff;
 
 impl TaskManager {
     /// Removes a task with the specified user ID and task ID.
@@ -67,6 +68,8 @@ impl TaskManager {
             }
         }
 
+        handoff::discard(task_id);
+
         // Delegate to the scheduler to remove the task
         match self.scheduler.remove_task(uid, task_id) {
             Ok(_) => ErrorCode::ErrOk,
@@ -0,0 +1,40 @@
+// Copyright (C) 2023 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Schedule policy selection implementation for the task manager.
+//!
+//! This module provides the implementation for selecting the policy that
+//! orders the tasks of an application within the `TaskManager`. It delegates
+//! the selection to the scheduler component.
+
+use crate::error::ErrorCode;
+use crate::manage::scheduler::SchedulePolicy;
+use crate::manage::TaskManager;
+
+impl TaskManager {
+    /// Selects the policy ordering the tasks of the application `uid`.
+    ///
+    /// # Arguments
+    ///
+    /// * `uid` - The user ID of the application.
+    /// * `policy` - The policy to order its tasks with.
+    ///
+    /// # Returns
+    ///
+    /// * `ErrorCode::ErrOk` - The policy applies from the next reschedule on.
+    pub(crate) fn set_schedule_policy(&mut self, uid: u64, policy: SchedulePolicy) -> ErrorCode {
+        debug!("TaskManager set_schedule_policy, uid{} policy{:?}", uid, policy);
+        self.scheduler.set_schedule_policy(uid, policy);
+        ErrorCode::ErrOk
+    }
+}
@@ -0,0 +1,93 @@
+// Copyright (C) 2024 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Adaptive idle timeout of the service.
+//!
+//! The service unloads when it has been idle for a while, and the next
+//! request then waits for it to load again. Users whose apps create a task
+//! every few minutes would pay that on every task. The creation times of the
+//! tasks are kept in `request_task`, so the gaps between the tasks of a user
+//! are known across unloads. While a user is expected to create its next task
+//! soon, the service stays loaded until that time has passed.
+
+use crate::manage::database::{RequestDb, SqlArg};
+
+/// Idle time (in milliseconds) the service is kept loaded for at most. Users
+/// creating tasks less often than this pay the load of the service.
+pub(crate) const MAX_KEEP_ALIVE: u64 = 10 * 60 * 1000;
+
+/// Number of the latest tasks of a user the gap between tasks is estimated
+/// from.
+const ARRIVAL_SAMPLES: usize = 8;
+
+/// Range of the uids of one user.
+const USER_UID_RANGE: u64 = 200000;
+
+const QUERY_RECENT_USERS: &str = "SELECT DISTINCT uid / 200000 FROM request_task WHERE ctime > ?";
+const QUERY_USER_ARRIVALS: &str =
+    "SELECT ctime FROM request_task WHERE uid >= ? AND uid < ? ORDER BY ctime DESC LIMIT ?";
+
+/// Returns the time in milliseconds until which the service should be kept
+/// loaded after `now`, or `None` if no user is expected to create a task
+/// within `MAX_KEEP_ALIVE`.
+pub(crate) fn keep_alive_until(now: u64) -> Option<u64> {
+    let db = RequestDb::get_instance();
+    // A user whose latest task is older than this is overdue by more than
+    // the margin of any gap kept alive for.
+    let since = now.saturating_sub(2 * MAX_KEEP_ALIVE);
+    let users = db.query_integer_with::<u64>(QUERY_RECENT_USERS, &[SqlArg::integer(since as i64)]);
+    users
+        .into_iter()
+        .filter_map(|user| {
+            let arrivals = db.query_integer_with::<u64>(
+                QUERY_USER_ARRIVALS,
+                &[
+                    SqlArg::integer((user * USER_UID_RANGE) as i64),
+                    SqlArg::integer(((user + 1) * USER_UID_RANGE) as i64),
+                    SqlArg::integer(ARRIVAL_SAMPLES as i64),
+                ],
+            );
+            next_arrival(&arrivals)
+        })
+        .filter(|until| *until > now)
+        .max()
+}
+
+/// Returns the time the next task of a user is expected by, given the
+/// creation times of its latest tasks, newest first.
+///
+/// The gap is the median of the gaps between the tasks, so a single burst or
+/// pause does not move it, plus a quarter for the jitter of the app. Users
+/// with fewer than two tasks or a gap above `MAX_KEEP_ALIVE` are not waited
+/// for.
+pub(crate) fn next_arrival(arrivals: &[u64]) -> Option<u64> {
+    let mut gaps = arrivals
+        .windows(2)
+        .map(|pair| pair[0].saturating_sub(pair[1]))
+        .collect::<Vec<_>>();
+    if gaps.is_empty() {
+        return None;
+    }
+    gaps.sort_unstable();
+    let gap = gaps[gaps.len() / 2];
+    if gap > MAX_KEEP_ALIVE {
+        return None;
+    }
+    Some(arrivals[0] + gap + gap / 4)
+}
+
+#[cfg(feature = "oh")]
+#[cfg(test)]
+mod ut_keep_alive {
+    include!("../../tests/ut/manage/ut_keep_alive.rs");
+}
@@ -19,14 +19,21 @@ cfg_oh! {
 pub(crate) mod account;
 pub(crate) mod app_state;
 pub(crate) mod database;
+pub(crate) mod db_worker;
+pub(crate) mod device_state;
+pub(crate) mod environment;
 pub(crate) mod events;
+pub(crate) mod keep_alive;
 pub(crate) mod query;
 pub(crate) use task_manager::TaskManager;
 pub(crate) mod network;
 pub(crate) mod network_manager;
 pub(crate) mod notifier;
+pub(crate) mod progress_writer;
 pub(crate) mod scheduler;
+pub(crate) mod shared_cache;
 pub(crate) mod task_manager;
+pub(crate) mod task_meta;
 
 #[cfg(test)]
 mod ut_mod {
@@ -24,7 +24,9 @@ use ffi::NetworkRegistry;
 pub(crate) use ffi::{NetworkInfo, NetworkType};
 use NetworkState::{Offline, Online};
 
+use crate::manage::environment;
 use crate::manage::network_manager::NetworkManager;
+use crate::task::dns::DnsCache;
 
 cfg_oh! {
     // OpenHarmony-specific imports for task management events
@@ -153,6 +155,8 @@ pub(crate) fn register_network_change() {
 #[derive(Clone)]
 pub struct NetworkInner {
     state: Arc<RwLock<NetworkState>>,
+    /// Whether the changes are published to the environment of the tasks.
+    published: bool,
 }
 
 /// Adapter for the task manager to receive network change notifications.
@@ -169,6 +173,30 @@ impl NetworkInner {
     pub(crate) fn new() -> Self {
         Self {
             state: Arc::new(RwLock::new(NetworkState::Offline)),
+            published: false,
+        }
+    }
+
+    /// Creates the network state of the service, whose changes are published
+    /// to the environment of the tasks.
+    pub(crate) fn published() -> Self {
+        Self {
+            state: Arc::new(RwLock::new(NetworkState::Offline)),
+            published: true,
+        }
+    }
+
+    /// Publishes the network state to the environment of the tasks.
+    ///
+    /// The cached resolutions are dropped, hosts may resolve differently on
+    /// the new network.
+    fn publish(&self, network: &NetworkState) {
+        if self.published {
+            DnsCache::get_instance().clear();
+            environment::update(|env| {
+                env.network = network.clone();
+                true
+            });
         }
     }
 
@@ -184,6 +212,7 @@ impl NetworkInner {
         if *state != Offline {
             info!("network is offline");
             *state = Offline;
+            self.publish(&state);
         }
     }
 
@@ -207,6 +236,7 @@ impl NetworkInner {
         if !matches!(&*state, Online(old_info) if old_info == &info  ) {
             info!("network online {:?}", info);
             *state = Online(info.clone());
+            self.publish(&state);
             true
         } else {
             false
@@ -21,6 +21,7 @@ use std::sync::{Mutex, Once};
 
 use super::network::{NetworkInner, NetworkState};
 use super::task_manager::TaskManagerTx;
+use crate::manage::environment;
 use crate::manage::network::Network;
 use crate::utils::call_once;
 
@@ -60,7 +61,7 @@ impl NetworkManager {
         unsafe {
             call_once(&ONCE, || {
                 // Create the network interface and initialize the network manager
-                let inner = NetworkInner::new();
+                let inner = NetworkInner::published();
                 let network = Network {
                     inner,
                     _registry: None,
@@ -78,25 +79,20 @@ impl NetworkManager {
     /// 
     /// Returns `true` if the network is in an `Online` state, otherwise `false`.
     /// 
-    /// # Panics
+    /// # Notes
     /// 
-    /// Panics if the mutex cannot be locked, which typically indicates a deadlock.
+    /// Reads the environment snapshot, without locking the network manager.
     pub(crate) fn is_online() -> bool {
-        let network_manager = NetworkManager::get_instance().lock().unwrap();
-        matches!(network_manager.network.state(), NetworkState::Online(_))
+        matches!(environment::snapshot().network, NetworkState::Online(_))
     }
 
     /// Queries the current network state.
     /// 
     /// # Returns
     /// 
-    /// Returns the current `NetworkState` of the network interface.
-    /// 
-    /// # Panics
-    /// 
-    /// Panics if the mutex cannot be locked, which typically indicates a deadlock.
+    /// Returns the current `NetworkState` of the network interface, as
+    /// published to the environment snapshot.
     pub(super) fn query_network() -> NetworkState {
-        let network_manager = NetworkManager::get_instance().lock().unwrap();
-        network_manager.network.state()
+        environment::snapshot().network.clone()
     }
 }
@@ -121,6 +121,8 @@ impl Notifier {
     /// Notifies clients about the current progress of a task.
     /// Skips notification if total processed bytes is zero and file size is negative,
     /// which indicates an invalid state.
+    /// The client manager coalesces progress per task, so only the latest
+    /// progress is delivered at each flush.
     /// 
     /// # Arguments
     /// 
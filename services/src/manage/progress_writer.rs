@@ -0,0 +1,86 @@
+// Copyright (C) 2024 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Write-behind persistence of task progress.
+//!
+//! Progress updates are buffered per task, keeping only the latest one, and
+//! written to the database in a single transaction once the persist interval
+//! elapsed. A task's buffered update is written synchronously before its state
+//! changes or its row is read, so terminal states and queries always observe
+//! the latest progress.
+
+use std::collections::HashMap;
+use std::sync::Mutex;
+use std::time::Duration;
+
+use crate::task::info::UpdateInfo;
+
+/// Interval after which buffered progress updates are written.
+pub(crate) const PROGRESS_PERSIST_INTERVAL: Duration = Duration::from_secs(1);
+
+struct Pending {
+    /// Latest unwritten update per task.
+    updates: HashMap<u32, UpdateInfo>,
+    /// Whether a write of the buffered updates is already scheduled.
+    armed: bool,
+}
+
+/// Buffers the latest progress update of every task.
+pub(crate) struct ProgressWriter {
+    pending: Mutex<Pending>,
+}
+
+impl ProgressWriter {
+    /// Creates an empty writer.
+    pub(crate) fn new() -> Self {
+        Self {
+            pending: Mutex::new(Pending {
+                updates: HashMap::new(),
+                armed: false,
+            }),
+        }
+    }
+
+    /// Buffers an update, replacing the older one of the task.
+    ///
+    /// # Returns
+    ///
+    /// `true` if no write was scheduled yet, in which case the caller has to
+    /// schedule one.
+    pub(crate) fn push(&self, task_id: u32, update_info: UpdateInfo) -> bool {
+        let mut pending = self.pending.lock().unwrap();
+        pending.updates.insert(task_id, update_info);
+        if pending.armed {
+            return false;
+        }
+        pending.armed = true;
+        true
+    }
+
+    /// Takes the buffered update of a task.
+    pub(crate) fn take(&self, task_id: u32) -> Option<UpdateInfo> {
+        self.pending.lock().unwrap().updates.remove(&task_id)
+    }
+
+    /// Takes all buffered updates and disarms the scheduled write.
+    pub(crate) fn drain(&self) -> Vec<(u32, UpdateInfo)> {
+        let mut pending = self.pending.lock().unwrap();
+        pending.armed = false;
+        pending.updates.drain().collect()
+    }
+}
+
+#[cfg(test)]
+mod ut_progress_writer {
+    include!("../../tests/ut/manage/ut_progress_writer.rs");
+}
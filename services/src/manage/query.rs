@@ -14,16 +14,21 @@
 //! Task querying and searching functionality.
 //! 
 //! This module provides various methods for retrieving and searching task information,
-//! including filtering tasks by different criteria and handling query-related events.
+//! including filtering tasks by different criteria. Queries are served on the
+//! IPC threads, running tasks are looked up in the `RunningTasks` registry
+//! rather than through the task manager.
+
+use std::sync::{Arc, OnceLock};
 
 pub(crate) use ffi::TaskFilter;
 
-use super::events::QueryEvent;
-use super::TaskManager;
 use crate::config::{Action, Mode};
-use crate::manage::database::RequestDb;
+use crate::manage::database::{RequestDb, SqlArg};
+use crate::manage::scheduler::RunningTasks;
 use crate::service::permission::ManagerPermission;
 use crate::task::config::TaskConfig;
+use crate::task::cpu;
+use crate::task::request_task::RequestTask;
 use crate::task::info::{State, TaskInfo};
 
 /// Retrieves a task configuration by ID and token.
@@ -68,142 +73,148 @@ pub(crate) fn search(filter: TaskFilter, method: SearchMethod) -> Vec<u32> {
     }
 }
 
-impl TaskManager {
-    /// Handles a query event by processing the appropriate query operation.
-    /// 
-    /// Processes different types of query events (Show, Query, Touch) and sends the result
-    /// back through the provided channel.
-    /// 
-    /// # Arguments
-    /// 
-    /// * `event` - The query event to handle
-    pub(crate) fn handle_query_event(&self, event: QueryEvent) {
-        let (info, tx) = match event {
-            QueryEvent::Show(task_id, uid, tx) => {
-                let info = self.show(uid, task_id);
-                (info, tx)
-            }
-            QueryEvent::Query(task_id, action, tx) => {
-                let info = self.query(task_id, action);
-                (info, tx)
-            }
-            QueryEvent::Touch(task_id, uid, token, tx) => {
-                let info = self.touch(uid, task_id, token);
-                (info, tx)
-            }
-        };
-        let _ = tx.send(info);
-    }
-
-    /// Retrieves task information for a specific user.
-    /// 
-    /// Updates the task's progress in the database if the task is currently running,
-    /// then retrieves the task information if the UIDs match.
-    /// 
-    /// # Arguments
-    /// 
-    /// * `uid` - The user ID to verify ownership
-    /// * `task_id` - The ID of the task to retrieve
-    /// 
-    /// # Returns
-    /// 
-    /// Returns `Some(TaskInfo)` if the task exists and is owned by the specified user,
-    /// otherwise `None`.
-    pub(crate) fn show(&self, uid: u64, task_id: u32) -> Option<TaskInfo> {
-        if let Some(task) = self.scheduler.get_task(uid, task_id) {
-            task.update_progress_in_database()
-        }
-
-        match RequestDb::get_instance().get_task_info(task_id) {
-            Some(info) if info.uid() == uid => Some(info),
-            _ => {
-                info!("TaskManger Show: no task found");
-                None
-            }
-        }
-    }
-
-    /// Retrieves task information with token authentication.
-    /// 
-    /// Updates the task's progress in the database if the task is currently running,
-    /// then retrieves and sanitizes the task information if the UIDs and token match.
-    /// 
-    /// # Arguments
-    /// 
-    /// * `uid` - The user ID to verify ownership
-    /// * `task_id` - The ID of the task to retrieve
-    /// * `token` - The authentication token for the task
-    /// 
-    /// # Returns
-    /// 
-    /// Returns `Some(TaskInfo)` with the bundle name sanitized if the task exists,
-    /// is owned by the specified user, and the token matches, otherwise `None`.
-    pub(crate) fn touch(&self, uid: u64, task_id: u32, token: String) -> Option<TaskInfo> {
-        if let Some(task) = self.scheduler.get_task(uid, task_id) {
-            task.update_progress_in_database()
-        }
+/// Searches one page of the tasks matching the given filter, newest first.
+///
+/// # Arguments
+///
+/// * `filter` - The filter criteria for the search
+/// * `method` - The search method to use (user-specific or system-wide)
+/// * `limit` - The maximum number of task IDs in the page, at least 1
+/// * `cursor` - The token returned with the previous page, empty for the first
+///
+/// # Returns
+///
+/// Returns the task IDs of the page and the token of the next page, which is
+/// empty after the last page, or `None` if the cursor is not valid.
+pub(crate) fn search_page(
+    filter: TaskFilter,
+    method: SearchMethod,
+    limit: u32,
+    cursor: &str,
+) -> Option<(Vec<u32>, String)> {
+    let cursor = if cursor.is_empty() {
+        None
+    } else {
+        Some(parse_cursor(cursor)?)
+    };
+    Some(RequestDb::get_instance().search_task_page(filter, &method, limit.max(1), cursor))
+}
 
-        let mut info = match RequestDb::get_instance().get_task_info(task_id) {
-            Some(info) => info,
-            None => {
-                info!("TaskManger Touch: no task found");
-                return None;
-            }
-        };
+/// Parses a page token made of the creation time and ID of the last task of
+/// the previous page.
+fn parse_cursor(cursor: &str) -> Option<(u64, u32)> {
+    let (ctime, task_id) = cursor.split_once('.')?;
+    Some((ctime.parse().ok()?, task_id.parse().ok()?))
+}
 
-        if info.uid() == uid && info.token() == token {
-            info.bundle = "".to_string();
-            Some(info)
-        } else {
-            info!("TaskManger Touch: no task found");
+/// Retrieves task information for a specific user.
+/// 
+/// The information of a running task is taken from memory, that of other tasks
+/// from the database, then returned if the UIDs match.
+/// 
+/// # Arguments
+/// 
+/// * `uid` - The user ID to verify ownership
+/// * `task_id` - The ID of the task to retrieve
+/// 
+/// # Returns
+/// 
+/// Returns `Some(TaskInfo)` if the task exists and is owned by the specified user,
+/// otherwise `None`.
+pub(crate) fn show(uid: u64, task_id: u32) -> Option<TaskInfo> {
+    match task_info(RunningTasks::get_instance().get(uid, task_id), task_id) {
+        Some(info) if info.uid() == uid => Some(info),
+        _ => {
+            info!("TaskManger Show: no task found");
             None
         }
     }
+}
 
-    /// Queries task information with action permission checking.
-    /// 
-    /// Updates the task's progress in the database if the task is currently running,
-    /// then retrieves and sanitizes the task information if the action has sufficient
-    /// permissions.
-    /// 
-    /// # Arguments
-    /// 
-    /// * `task_id` - The ID of the task to retrieve
-    /// * `action` - The action to check permissions against
-    /// 
-    /// # Returns
-    /// 
-    /// Returns `Some(TaskInfo)` with sensitive data sanitized if the task exists and
-    /// the action has sufficient permissions, otherwise `None`.
-    pub(crate) fn query(&self, task_id: u32, action: Action) -> Option<TaskInfo> {
-        if let Some(task) = self
-            .scheduler
-            .tasks()
-            .find(|task| task.task_id() == task_id)
-        {
-            task.update_progress_in_database()
+/// Retrieves task information with token authentication.
+/// 
+/// The information of a running task is taken from memory, that of other tasks
+/// from the database, then sanitized and returned if the UIDs and token match.
+/// 
+/// # Arguments
+/// 
+/// * `uid` - The user ID to verify ownership
+/// * `task_id` - The ID of the task to retrieve
+/// * `token` - The authentication token for the task
+/// 
+/// # Returns
+/// 
+/// Returns `Some(TaskInfo)` with the bundle name sanitized if the task exists,
+/// is owned by the specified user, and the token matches, otherwise `None`.
+pub(crate) fn touch(uid: u64, task_id: u32, token: String) -> Option<TaskInfo> {
+    let mut info = match task_info(RunningTasks::get_instance().get(uid, task_id), task_id) {
+        Some(info) => info,
+        None => {
+            info!("TaskManger Touch: no task found");
+            return None;
         }
+    };
 
-        let mut info = match RequestDb::get_instance().get_task_info(task_id) {
-            Some(info) => info,
-            None => {
-                info!("TaskManger Query: no task found");
-                return None;
-            }
-        };
+    if info.uid() == uid && info.token() == token {
+        info.bundle = "".to_string();
+        Some(info)
+    } else {
+        info!("TaskManger Touch: no task found");
+        None
+    }
+}
 
-        let task_action = info.action();
-        if ManagerPermission::check_action(action, task_action) {
-            info.data = "".to_string();
-            info.url = "".to_string();
-            Some(info)
-        } else {
+/// Queries task information with action permission checking.
+/// 
+/// The information of a running task is taken from memory, that of other tasks
+/// from the database, then sanitized and returned if the action has sufficient
+/// permissions.
+/// 
+/// # Arguments
+/// 
+/// * `task_id` - The ID of the task to retrieve
+/// * `action` - The action to check permissions against
+/// 
+/// # Returns
+/// 
+/// Returns `Some(TaskInfo)` with sensitive data sanitized if the task exists and
+/// the action has sufficient permissions, otherwise `None`.
+pub(crate) fn query(task_id: u32, action: Action) -> Option<TaskInfo> {
+    let mut info = match task_info(RunningTasks::get_instance().find(task_id), task_id) {
+        Some(info) => info,
+        None => {
             info!("TaskManger Query: no task found");
-            None
+            return None;
         }
+    };
+
+    let task_action = info.action();
+    if ManagerPermission::check_action(action, task_action) {
+        info.data = "".to_string();
+        info.url = "".to_string();
+        Some(info)
+    } else {
+        info!("TaskManger Query: no task found");
+        None
     }
 }
 
+/// Returns the information of a task, from memory if it is `running`.
+///
+/// A running task holds its latest progress, which it only writes to the
+/// database from time to time, so polling it costs no database read. Waiting
+/// and finished tasks are read from the database.
+///
+/// The CPU the service spent on the task is added to its extras.
+fn task_info(running: Option<Arc<RequestTask>>, task_id: u32) -> Option<TaskInfo> {
+    let mut info = match running {
+        Some(task) => task.info(),
+        None => RequestDb::get_instance().get_task_info(task_id)?,
+    };
+    cpu::add_extras(task_id, &mut info.extras);
+    Some(info)
+}
+
 impl RequestDb {
     /// Searches for tasks belonging to a specific user that match filter criteria.
     /// 
@@ -216,9 +227,9 @@ impl RequestDb {
     /// 
     /// Returns a vector of task IDs that match the user and filter criteria.
     pub(crate) fn search_task(&self, filter: TaskFilter, uid: u64) -> Vec<u32> {
-        let mut sql = format!("SELECT task_id from request_task WHERE uid = {} AND ", uid);
-        Self::search_filter(&mut sql, &filter);
-        self.query_integer(&sql)
+        let mut sql = Self::search_prefix(&SearchMethod::User(uid));
+        let args = self.search_filter(&mut sql, &filter);
+        self.query_integer_with(&sql, &args)
     }
 
     /// Searches for tasks across the system with optional bundle filtering.
@@ -232,23 +243,92 @@ impl RequestDb {
     /// 
     /// Returns a vector of task IDs that match the bundle and filter criteria.
     pub(crate) fn system_search_task(&self, filter: TaskFilter, bundle_name: String) -> Vec<u32> {
-        let mut sql = "SELECT task_id from request_task WHERE ".to_string();
-        if bundle_name != "*" {
-            sql.push_str(&format!("bundle = '{}' AND ", bundle_name));
+        let mut sql = Self::search_prefix(&SearchMethod::System(bundle_name));
+        let args = self.search_filter(&mut sql, &filter);
+        self.query_integer_with(&sql, &args)
+    }
+
+    /// Searches one page of the tasks matching filter criteria.
+    ///
+    /// Tasks are ordered by creation time then ID, newest first, so that a
+    /// page continues after the last task of the previous one even if tasks
+    /// were created or removed in between.
+    ///
+    /// # Arguments
+    ///
+    /// * `filter` - The filter criteria for the search
+    /// * `method` - The search method to use (user-specific or system-wide)
+    /// * `limit` - The maximum number of task IDs in the page
+    /// * `cursor` - Creation time and ID of the last task of the previous page
+    ///
+    /// # Returns
+    ///
+    /// Returns the task IDs of the page and the token of the next page, which
+    /// is empty after the last page.
+    pub(crate) fn search_task_page(
+        &self,
+        filter: TaskFilter,
+        method: &SearchMethod,
+        limit: u32,
+        cursor: Option<(u64, u32)>,
+    ) -> (Vec<u32>, String) {
+        let mut sql = Self::search_prefix(method);
+        let args = self.search_filter(&mut sql, &filter);
+        if let Some((ctime, task_id)) = cursor {
+            sql.push_str(&format!(
+                "AND (ctime < {} OR (ctime = {} AND task_id < {})) ",
+                ctime, ctime, task_id
+            ));
+        }
+        // One more row tells whether there is a next page.
+        sql.push_str(&format!(
+            "ORDER BY ctime DESC, task_id DESC LIMIT {}",
+            limit as u64 + 1
+        ));
+        let mut task_ids: Vec<u32> = self.query_integer_with(&sql, &args);
+        if task_ids.len() <= limit as usize {
+            return (task_ids, String::new());
+        }
+        task_ids.truncate(limit as usize);
+        let last = task_ids[task_ids.len() - 1];
+        let ctime: Vec<u64> = self.query_integer(&format!(
+            "SELECT ctime FROM request_task WHERE task_id = {}",
+            last
+        ));
+        match ctime.first() {
+            Some(ctime) => (task_ids, format!("{}.{}", ctime, last)),
+            None => (task_ids, String::new()),
+        }
+    }
+
+    /// Returns the start of a search query, restricted to the tasks of the
+    /// user or bundle of the search method.
+    fn search_prefix(method: &SearchMethod) -> String {
+        match method {
+            SearchMethod::User(uid) => {
+                format!("SELECT task_id from request_task WHERE uid = {} AND ", uid)
+            }
+            SearchMethod::System(bundle_name) if bundle_name != "*" => format!(
+                "SELECT task_id from request_task WHERE bundle = '{}' AND ",
+                bundle_name
+            ),
+            SearchMethod::System(_) => "SELECT task_id from request_task WHERE ".to_string(),
         }
-        Self::search_filter(&mut sql, &filter);
-        self.query_integer(&sql)
     }
 
     /// Appends filter conditions to an SQL query string.
     /// 
-    /// Adds conditions for time range, state, action, and mode to the provided SQL query.
+    /// Adds conditions for time range, state, action, mode and keyword to the provided SQL query.
     /// 
     /// # Arguments
     /// 
     /// * `sql` - The SQL query string to modify
     /// * `filter` - The filter criteria to apply
-    fn search_filter(sql: &mut String, filter: &TaskFilter) {
+    ///
+    /// # Returns
+    ///
+    /// The values to bind to the placeholders of the conditions.
+    fn search_filter(&self, sql: &mut String, filter: &TaskFilter) -> Vec<SqlArg> {
         // Always include time range filtering
         sql.push_str(&format!(
             "ctime BETWEEN {} AND {} ",
@@ -269,6 +349,45 @@ impl RequestDb {
         if filter.mode != Mode::Any.repr {
             sql.push_str(&format!("AND mode = {} ", filter.mode));
         }
+
+        // Only add keyword filter if a keyword is given
+        if filter.keyword.is_empty() {
+            return vec![];
+        }
+        // The trigram index only matches keywords of 3 characters or more.
+        if filter.keyword.chars().count() >= 3 && self.has_search_index() {
+            sql.push_str(
+                "AND task_id IN (SELECT rowid FROM request_task_search \
+                 WHERE request_task_search MATCH ?) ",
+            );
+            // Quoted as a single string so that the keyword is not parsed as a query.
+            let phrase = format!("\"{}\"", filter.keyword.replace('"', "\"\""));
+            return vec![SqlArg::text(phrase)];
+        }
+        sql.push_str(
+            "AND (title LIKE ? ESCAPE '\\' OR description LIKE ? ESCAPE '\\' \
+             OR url LIKE ? ESCAPE '\\') ",
+        );
+        let pattern = format!(
+            "%{}%",
+            filter
+                .keyword
+                .replace('\\', "\\\\")
+                .replace('%', "\\%")
+                .replace('_', "\\_")
+        );
+        vec![SqlArg::text(pattern); 3]
+    }
+
+    /// Whether the store has the keyword search index, which needs FTS5.
+    fn has_search_index(&self) -> bool {
+        static HAS_SEARCH_INDEX: OnceLock<bool> = OnceLock::new();
+        *HAS_SEARCH_INDEX.get_or_init(|| {
+            let count: Vec<u32> = self.query_integer(
+                "SELECT COUNT(*) FROM sqlite_master WHERE name = 'request_task_search'",
+            );
+            count.first().is_some_and(|count| *count > 0)
+        })
     }
 }
 
@@ -316,6 +435,8 @@ mod ffi {
         state: u8,
         action: u8,
         mode: u8,
+        // Text searched in the title, description and url, empty for any
+        keyword: String,
     }
 }
 
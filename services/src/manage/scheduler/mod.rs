@@ -20,21 +20,30 @@
 
 mod qos;
 mod queue;
+mod ramp;
 pub(crate) mod state;
 use std::collections::HashMap;
-use std::sync::atomic::Ordering;
+use std::sync::atomic::{AtomicU64, Ordering};
 use std::sync::Arc;
+use std::time::{Duration, Instant};
 
 mod sql;
-use qos::Qos;
+mod trace;
+use qos::{BandwidthEstimator, Qos, SAMPLE_INTERVAL};
+pub(crate) use qos::{QosLevel, SchedulePolicy};
+pub(crate) use queue::registry::RunningTasks;
 use queue::RunningQueue;
-use state::sql::SqlList;
+use ramp::RestoreRamp;
+use state::sql::{QosUpdate, SqlList};
+use trace::{Decision, DecisionTrace, Moves, Tiers, Trigger};
 
-use super::events::TaskManagerEvent;
+use super::events::{ScheduleEvent, TaskManagerEvent};
 use crate::config::Mode;
 use crate::error::ErrorCode;
 use crate::info::TaskInfo;
 use crate::manage::database::RequestDb;
+use crate::manage::db_worker::DbWorker;
+use crate::manage::network_manager::NetworkManager;
 use crate::manage::notifier::Notifier;
 use crate::manage::task_manager::TaskManagerTx;
 use crate::service::active_counter::ActiveCounter;
@@ -42,14 +51,23 @@ use crate::service::client::ClientManagerEntry;
 use crate::service::notification_bar::NotificationDispatcher;
 use crate::service::run_count::RunCountManagerEntry;
 use crate::task::config::Action;
+use crate::task::dns::DnsCache;
 use crate::task::info::State;
 use crate::task::notify::WaitingCause;
 use crate::task::reason::Reason;
 use crate::task::request_task::RequestTask;
+use crate::task::timeline::{Phase, Timelines};
 use crate::utils::get_current_timestamp;
 
 const MILLISECONDS_IN_ONE_MONTH: u64 = 30 * 24 * 60 * 60 * 1000;
 
+/// Time the reschedules triggered by task events wait, so that a burst of
+/// events is handled by a single reschedule.
+const RESCHEDULE_WINDOW: Duration = Duration::from_millis(20);
+
+/// Tasks next in line whose hosts are resolved ahead of their start.
+const DNS_PREFETCH_TASKS: usize = 4;
+
 // Scheduler 的基本处理逻辑如下：
 // 1. Scheduler 维护一个当前所有 运行中 和
 //    待运行的任务优先级队列（scheduler.qos），
@@ -76,6 +94,21 @@ pub(crate) struct Scheduler {
     state_handler: state::Handler,
     /// Flag indicating whether a reschedule operation is pending.
     pub(crate) resort_scheduled: bool,
+    /// Number of reschedules done, a delayed reschedule is dropped if another
+    /// one was done while it waited.
+    reschedules: Arc<AtomicU64>,
+    /// Event that caused the pending reschedule, if any.
+    trigger: Option<Trigger>,
+    /// Trace of the last reschedules.
+    trace: DecisionTrace,
+    /// Estimator of the bandwidth the QoS zones are sized for.
+    bandwidth: BandwidthEstimator,
+    /// Flag indicating whether a bandwidth sample is pending.
+    bandwidth_sampling: bool,
+    /// Pace of the tasks started after the service started.
+    ramp: RestoreRamp,
+    /// Tasks next in line at the last reschedule, whose hosts were prefetched.
+    upcoming: Vec<u32>,
     /// Transmitter for sending events to the task manager.
     task_manager: TaskManagerTx,
 }
@@ -120,6 +153,13 @@ impl Scheduler {
             client_manager,
             state_handler,
             resort_scheduled: false,
+            reschedules: Arc::new(AtomicU64::new(0)),
+            trigger: None,
+            trace: DecisionTrace::new(),
+            bandwidth: BandwidthEstimator::new(),
+            bandwidth_sampling: false,
+            ramp: RestoreRamp::new(get_current_timestamp()),
+            upcoming: Vec::new(),
             task_manager: tx,
         }
     }
@@ -156,6 +196,11 @@ impl Scheduler {
         self.running_queue.running_tasks()
     }
 
+    /// Returns whether the device is idle, its screen is off.
+    pub(crate) fn device_idle(&self) -> bool {
+        self.state_handler.device_idle()
+    }
+
     /// Restores all tasks and triggers a reschedule operation.
     ///
     /// This method schedules a reschedule operation to re-evaluate all tasks
@@ -163,7 +208,7 @@ impl Scheduler {
     pub(crate) fn restore_all_tasks(&mut self) {
         info!("reschedule restore all tasks");
         // Reschedule tasks based on the current QoS status
-        self.schedule_if_not_scheduled();
+        self.schedule_if_not_scheduled(Trigger::Restore);
     }
 
     /// Starts a new task.
@@ -227,8 +272,10 @@ impl Scheduler {
             .get_task_info(task_id)
             .ok_or(ErrorCode::TaskNotFound)?;
         if is_resume {
+            Timelines::get_instance().record(task_id, Phase::Resumed);
             Notifier::resume(&self.client_manager, info.build_notify_data());
         } else {
+            Timelines::get_instance().record(task_id, Phase::Queued);
             // For new task starts, reset the task time
             database.update_task_time(task_id, 0);
         }
@@ -251,7 +298,7 @@ impl Scheduler {
             .get_task_qos_info(task_id)
             .ok_or(ErrorCode::TaskNotFound)?;
         self.qos.start_task(uid, qos_info);
-        self.schedule_if_not_scheduled();
+        self.schedule_if_not_scheduled(Trigger::Start);
         Ok(())
     }
 
@@ -270,6 +317,7 @@ impl Scheduler {
         let database = RequestDb::get_instance();
         // Update task state in database
         database.change_status(task_id, State::Paused)?;
+        Timelines::get_instance().record(task_id, Phase::Paused);
         // Remove from QoS system
         self.qos.remove_task(uid, task_id);
 
@@ -277,7 +325,7 @@ impl Scheduler {
         if self.running_queue.cancel_task(task_id, uid) {
             // For upload tasks, mark for potential resume
             self.running_queue.upload_resume.insert(task_id);
-            self.schedule_if_not_scheduled();
+            self.schedule_if_not_scheduled(Trigger::Pause);
         }
         
         // Notify client of the pause
@@ -308,7 +356,7 @@ impl Scheduler {
 
         // If the task was running, cancel it and schedule a reschedule
         if self.running_queue.cancel_task(task_id, uid) {
-            self.schedule_if_not_scheduled();
+            self.schedule_if_not_scheduled(Trigger::Remove);
         }
         
         // Clean up user file task association
@@ -342,7 +390,7 @@ impl Scheduler {
 
         // If the task was running, cancel it and schedule a reschedule
         if self.running_queue.cancel_task(task_id, uid) {
-            self.schedule_if_not_scheduled();
+            self.schedule_if_not_scheduled(Trigger::Stop);
         }
         Ok(())
     }
@@ -371,6 +419,19 @@ impl Scheduler {
         Ok(())
     }
 
+    /// Selects the policy ordering the tasks of an application and triggers
+    /// a reschedule.
+    ///
+    /// # Arguments
+    ///
+    /// * `uid` - The user ID of the application.
+    /// * `policy` - The policy to order its tasks with.
+    pub(crate) fn set_schedule_policy(&mut self, uid: u64, policy: SchedulePolicy) {
+        info!("app {} schedule policy {:?}", uid, policy);
+        self.qos.set_policy(uid, policy);
+        self.schedule_if_not_scheduled(Trigger::Config);
+    }
+
     /// Changes the execution mode of a task.
     ///
     /// # Arguments
@@ -395,7 +456,7 @@ impl Scheduler {
 
         // Update QoS and trigger reschedule if needed
         if self.qos.task_set_mode(uid, task_id, mode) {
-            self.schedule_if_not_scheduled();
+            self.schedule_if_not_scheduled(Trigger::Config);
         }
         
         // Update mode for running task
@@ -426,7 +487,7 @@ impl Scheduler {
         let database = RequestDb::get_instance();
         // Remove from QoS system and trigger reschedule if needed
         if self.qos.remove_task(uid, task_id) {
-            self.schedule_if_not_scheduled();
+            self.schedule_if_not_scheduled(Trigger::Complete);
         }
 
         // Check if task state needs special handling
@@ -446,6 +507,7 @@ impl Scheduler {
         }
 
         // Mark as completed and clean up
+        Timelines::get_instance().record(task_id, Phase::Completed);
         database.update_task_state(task_id, State::Completed, Reason::Default);
         database.remove_user_file_task(task_id);
         
@@ -529,6 +591,7 @@ impl Scheduler {
                         WaitingCause::TaskQueue
                     }
                     reason if reason == Reason::AccountStopped.repr => WaitingCause::UserState,
+                    reason if reason == Reason::OriginUnavailable.repr => WaitingCause::Origin,
                     reason => {
                         error!("task {} cancel with other reason {}", task_id, reason);
                         WaitingCause::TaskQueue
@@ -563,7 +626,7 @@ impl Scheduler {
         let database = RequestDb::get_instance();
         // Remove from QoS system and trigger reschedule if needed
         if self.qos.remove_task(uid, task_id) {
-            self.schedule_if_not_scheduled();
+            self.schedule_if_not_scheduled(Trigger::Fail);
         }
 
         // Check if task state needs updating
@@ -575,6 +638,7 @@ impl Scheduler {
         }
 
         // Update task state to failed
+        Timelines::get_instance().record(task_id, Phase::Failed(reason));
         database.update_task_state(task_id, State::Failed, reason);
         
         // Send failure notifications
@@ -673,26 +737,47 @@ impl Scheduler {
         let Some(sql_list) = f(&mut self.state_handler, t) else {
             return;
         };
-        
-        // Execute SQL statements to update database
-        let db = RequestDb::get_instance();
-        for sql in sql_list {
-            if let Err(e) = db.execute(&sql) {
-                error!("TaskManager update network failed {:?}", e);
-            };
+        let qos_update = sql_list.qos_update();
+        if sql_list.is_empty() {
+            self.update_qos(qos_update);
+            return;
         }
         
-        // Reload and reschedule all tasks based on new state
-        self.reload_all_tasks();
+        // Execute SQL statements on the database worker, the QoS queue is
+        // updated once they were written, as cancelled tasks read their state
+        let task_manager = self.task_manager.clone();
+        DbWorker::get_instance().post(move || {
+            let db = RequestDb::get_instance();
+            for sql in sql_list {
+                if let Err(e) = db.execute(&sql) {
+                    error!("TaskManager update network failed {:?}", e);
+                };
+            }
+            task_manager.send_event(TaskManagerEvent::Schedule(ScheduleEvent::UpdateQos(
+                qos_update,
+            )));
+        });
     }
 
-    /// Reloads all tasks and triggers a reschedule.
+    /// Applies a change of the system state to the QoS queue and triggers a
+    /// reschedule.
+    ///
+    /// Only a change that may affect any application reloads all tasks, a
+    /// foreground switch or background timeout touches the tasks of its
+    /// application alone.
     ///
-    /// This method reloads all tasks in the QoS system and schedules a reschedule
-    /// operation to re-evaluate all tasks based on updated information.
-    pub(crate) fn reload_all_tasks(&mut self) {
-        self.qos.reload_all_tasks();
-        self.schedule_if_not_scheduled();
+    /// # Arguments
+    ///
+    /// * `qos_update` - The change of the QoS queue.
+    pub(crate) fn update_qos(&mut self, qos_update: QosUpdate) {
+        match qos_update {
+            QosUpdate::ReloadAll => self.qos.reload_all_tasks(),
+            QosUpdate::ReloadApp(uid) => self.qos.reload_app_tasks(uid),
+            QosUpdate::RemoveFrontend(uid) => self.qos.remove_frontend_tasks(uid),
+            QosUpdate::Resort => {}
+        }
+        // Updates follow changes of the system state, such as a foreground switch
+        self.schedule_now(Trigger::SystemState);
     }
 
     /// Handles changes to the Resource Scheduling Service (RSS) level.
@@ -706,7 +791,7 @@ impl Scheduler {
             // Apply new RSS settings to QoS system
             self.qos.change_rss(new_rss);
             // Trigger reschedule
-            self.schedule_if_not_scheduled();
+            self.schedule_if_not_scheduled(Trigger::Rss);
         }
     }
 
@@ -714,13 +799,38 @@ impl Scheduler {
     ///
     /// This method prevents multiple reschedule operations from being scheduled
     /// concurrently by setting a flag and sending a single reschedule event.
-    fn schedule_if_not_scheduled(&mut self) {
+    /// The event is sent after `RESCHEDULE_WINDOW`, every task event in the
+    /// window is handled by the same reschedule.
+    ///
+    /// # Arguments
+    ///
+    /// * `trigger` - The event asking for the reschedule, traced if it is the
+    ///   first one of the window.
+    fn schedule_if_not_scheduled(&mut self, trigger: Trigger) {
+        self.trigger.get_or_insert(trigger);
         if self.resort_scheduled {
             return;
         }
         self.resort_scheduled = true;
         let task_manager = self.task_manager.clone();
-        task_manager.send_event(TaskManagerEvent::Reschedule);
+        let reschedules = self.reschedules.clone();
+        let seq = reschedules.load(Ordering::Acquire);
+        ylong_runtime::spawn(async move {
+            ylong_runtime::time::sleep(RESCHEDULE_WINDOW).await;
+            if reschedules.load(Ordering::Acquire) == seq {
+                task_manager.send_event(TaskManagerEvent::Reschedule);
+            }
+        });
+    }
+
+    /// Schedules a reschedule operation right after the events already sent,
+    /// for changes that must not wait for the window of task events.
+    ///
+    /// A reschedule pending in the window is done by this one instead.
+    fn schedule_now(&mut self, trigger: Trigger) {
+        self.trigger.get_or_insert(trigger);
+        self.resort_scheduled = true;
+        self.task_manager.send_event(TaskManagerEvent::Reschedule);
     }
 
     /// Performs the reschedule operation to update task priorities and execution.
@@ -731,27 +841,153 @@ impl Scheduler {
     /// 3. Applies changes to the running queue
     /// 4. Removes tasks that should no longer be scheduled
     /// 5. Reloads tasks if any were removed
+    /// 6. Traces the decision
     pub(crate) fn reschedule(&mut self) {
         // Clear the reschedule flag
         self.resort_scheduled = false;
-        
+        self.reschedules.fetch_add(1, Ordering::AcqRel);
+        // Reschedules nobody asked for are the ones at the next boost
+        let trigger = self.trigger.take().unwrap_or(Trigger::Deadline);
+        let time = get_current_timestamp();
+        let start = Instant::now();
+
         // Get QoS changes based on current system state
         let changes = self.qos.reschedule(&self.state_handler);
-        
+        let tiers = Tiers::of(&changes);
+
         // Apply changes to running queue and collect tasks to remove
         let mut qos_remove_queue = vec![];
-        self.running_queue
-            .reschedule(changes, &mut qos_remove_queue);
-        
+        let mut moves = Moves::default();
+        if self.ramp.is_open() {
+            self.ramp
+                .set_foreground(self.state_handler.foreground_abilities());
+        }
+        if !self.running_queue.reschedule(
+            changes,
+            &mut self.ramp,
+            &mut qos_remove_queue,
+            &mut moves,
+        ) {
+            // Directions not applied in full are given again next time
+            self.qos.forget_directions();
+        }
+        self.trace.record(Decision {
+            time,
+            trigger,
+            tiers,
+            moves,
+            elapsed: start.elapsed().as_micros() as u64,
+        });
+
         // Remove tasks that should no longer be in the QoS system
         for (uid, task_id) in qos_remove_queue.iter() {
             self.qos.apps.remove_task(*uid, *task_id);
         }
-        
-        // Reload all tasks if any were removed
+
+        // Reload all tasks if any were removed, they failed to load
         if !qos_remove_queue.is_empty() {
-            self.reload_all_tasks();
+            self.qos.reload_all_tasks();
+            self.schedule_now(Trigger::Fail);
         }
+        self.sample_bandwidth_later();
+        self.reschedule_at_next_boost();
+        if let Some(delay) = self.ramp.finish(get_current_timestamp()) {
+            self.restore_later(delay);
+        }
+        self.prefetch_upcoming();
+    }
+
+    /// Resolves the hosts of the tasks next in line, so that they connect
+    /// without waiting for the DNS when they start.
+    fn prefetch_upcoming(&mut self) {
+        let upcoming = self.qos.upcoming(DNS_PREFETCH_TASKS);
+        for task_id in upcoming.iter() {
+            if self.upcoming.contains(task_id) {
+                continue;
+            }
+            if let Some(config) = RequestDb::get_instance().get_task_config(*task_id) {
+                DnsCache::get_instance().prefetch(&config.url);
+            }
+        }
+        self.upcoming = upcoming;
+    }
+
+    /// Schedules the next step of the restore ramp `delay` milliseconds
+    /// later.
+    ///
+    /// It is dropped if another reschedule is done before, which schedules
+    /// its own.
+    fn restore_later(&self, delay: u64) {
+        let task_manager = self.task_manager.clone();
+        let reschedules = self.reschedules.clone();
+        let seq = reschedules.load(Ordering::Acquire);
+        ylong_runtime::spawn(async move {
+            ylong_runtime::time::sleep(Duration::from_millis(delay)).await;
+            if reschedules.load(Ordering::Acquire) == seq {
+                task_manager.send_event(TaskManagerEvent::Schedule(ScheduleEvent::RestoreAllTasks));
+            }
+        });
+    }
+
+    /// Schedules a reschedule for when the next task nears its deadline.
+    ///
+    /// It is dropped if another reschedule is done before, which schedules
+    /// its own.
+    fn reschedule_at_next_boost(&self) {
+        let now = get_current_timestamp();
+        let Some(boost) = self.qos.next_boost(now) else {
+            return;
+        };
+        let task_manager = self.task_manager.clone();
+        let reschedules = self.reschedules.clone();
+        let seq = reschedules.load(Ordering::Acquire);
+        ylong_runtime::spawn(async move {
+            ylong_runtime::time::sleep(Duration::from_millis(boost - now)).await;
+            if reschedules.load(Ordering::Acquire) == seq {
+                task_manager.send_event(TaskManagerEvent::Reschedule);
+            }
+        });
+    }
+
+    /// Formats the trace of the last reschedules for dumping.
+    pub(crate) fn dump_trace(&self) -> String {
+        self.trace.dump()
+    }
+
+    /// Samples the bytes transferred by the running tasks and reschedules if
+    /// the measured bandwidth changes the QoS zones.
+    ///
+    /// Samples are taken every `SAMPLE_INTERVAL` while tasks are running.
+    pub(crate) fn sample_bandwidth(&mut self) {
+        self.bandwidth_sampling = false;
+        self.bandwidth.sample(
+            get_current_timestamp(),
+            self.running_queue.tasks().map(|task| {
+                let transferred = task.transferred.load(Ordering::Acquire);
+                ((task.uid(), task.task_id()), transferred)
+            }),
+        );
+        if let Some(bandwidth) = self.bandwidth.bandwidth() {
+            if self.qos.change_bandwidth(bandwidth) {
+                info!("reschedule for bandwidth {} B/s", bandwidth);
+                self.schedule_if_not_scheduled(Trigger::Bandwidth);
+            }
+        }
+        self.sample_bandwidth_later();
+    }
+
+    /// Schedules the next bandwidth sample if tasks are running and none is
+    /// pending yet.
+    fn sample_bandwidth_later(&mut self) {
+        if self.bandwidth_sampling || self.running_tasks() == 0 {
+            return;
+        }
+        self.bandwidth_sampling = true;
+        let task_manager = self.task_manager.clone();
+        ylong_runtime::spawn(async move {
+            ylong_runtime::time::sleep(SAMPLE_INTERVAL).await;
+            task_manager.send_event(TaskManagerEvent::Schedule(ScheduleEvent::SampleBandwidth));
+        });
     }
 
     /// Checks if a task's configuration requirements are currently satisfied.
@@ -764,7 +1000,7 @@ impl Scheduler {
     ///
     /// `Ok(true)` if all requirements are satisfied, `Ok(false)` if requirements
     /// are not met but the task can wait, or an error if the task could not be found.
-    pub(crate) fn check_config_satisfy(&self, task_id: u32) -> Result<bool, ErrorCode> {
+    pub(crate) fn check_config_satisfy(&mut self, task_id: u32) -> Result<bool, ErrorCode> {
         let database = RequestDb::get_instance();
         let config = database
             .get_task_config(task_id)
@@ -791,6 +1027,7 @@ impl Scheduler {
             );
             // Put task in waiting state due to app state
             database.update_task_state(task_id, State::Waiting, Reason::AppBackgroundOrTerminate);
+            self.state_handler.update_app_waiting(config.common_data.uid);
             Notifier::waiting(&self.client_manager, task_id, WaitingCause::AppState);
             return Ok(false);
         }
@@ -816,27 +1053,57 @@ impl Scheduler {
             return;
         }
         
-        let database = RequestDb::get_instance();
-        for task in timeout_tasks {
-            // Try to stop the task and remove from QoS if successful
-            if database
-                .change_status(task.task_id(), State::Stopped)
-                .is_ok()
-            {
-                self.qos.apps.remove_task(task.uid(), task.task_id());
+        let tasks = timeout_tasks
+            .iter()
+            .map(|task| (task.uid(), task.task_id()))
+            .collect::<Vec<_>>();
+        let task_manager = self.task_manager.clone();
+        DbWorker::get_instance().post(move || {
+            let database = RequestDb::get_instance();
+            // Try to stop the tasks, only stopped ones are removed from QoS
+            let stopped = tasks
+                .into_iter()
+                .filter(|(_, task_id)| database.change_status(*task_id, State::Stopped).is_ok())
+                .collect::<Vec<_>>();
+            if !stopped.is_empty() {
+                task_manager.send_event(TaskManagerEvent::Schedule(
+                    ScheduleEvent::TimeoutTasksStopped(stopped),
+                ));
             }
+        });
+    }
+
+    /// Removes timed out tasks that were stopped in the database from QoS.
+    ///
+    /// # Arguments
+    ///
+    /// * `tasks` - The (uid, task_id) pairs of the stopped tasks.
+    pub(crate) fn timeout_tasks_stopped(&mut self, tasks: Vec<(u64, u32)>) {
+        for (uid, task_id) in tasks {
+            self.qos.apps.remove_task(uid, task_id);
         }
-        
+
         // Schedule reschedule to update task execution
-        self.schedule_if_not_scheduled();
+        self.schedule_if_not_scheduled(Trigger::Timeout);
     }
 
-    /// Attempts to retry all tasks in the running queue.
-    ///
-    /// This method delegates to the running queue to retry any tasks that failed
-    /// but are eligible for retry.
-    pub(crate) fn retry_all_tasks(&mut self) {
-        self.running_queue.retry_all_tasks();
+    /// Handles a change of the network.
+    ///
+    /// Running tasks that can still run on the new network reconnect in place
+    /// and resume from their progress. Tasks whose network, metered or roaming
+    /// constraints the new network breaks are not restarted; the reschedule
+    /// after the state update pauses or fails them.
+    pub(crate) fn on_network_change(&mut self) {
+        let network = NetworkManager::query_network();
+        let retried = self
+            .running_queue
+            .retry_tasks(|task| task.conf.satisfy_network(&network).is_ok());
+        info!(
+            "network changed, {} of {} running tasks reconnect",
+            retried,
+            self.running_tasks()
+        );
+        self.on_state_change(state::Handler::update_network, network);
     }
 
     /// Shuts down the scheduler and running queue.
@@ -16,14 +16,21 @@
 //! This module implements a priority-based scheduling system for tasks across different applications.
 //! It manages sorted collections of applications and their tasks, with sorting based on application
 //! priority (foreground vs background) and user focus. Tasks within applications are further sorted
-//! by their mode and priority.
+//! by their mode, their deadline and the `SchedulePolicy` of the application.
 
 use std::cmp;
-use std::collections::HashSet;
+use std::collections::{HashMap, HashSet};
 use std::ops::Deref;
 
+use super::policy::{urgency, SchedulePolicy, DEADLINE_HORIZON};
+use super::share::app_weight;
+#[cfg(feature = "oh")]
+use super::share::fair_queuing;
 use crate::manage::database::{RequestDb, TaskQosInfo};
 use crate::task::config::{Action, Mode};
+use crate::utils::get_current_timestamp;
+#[cfg(feature = "oh")]
+use crate::utils::is_system_token;
 
 /// A collection of applications sorted by priority.
 ///
@@ -33,6 +40,14 @@ use crate::task::config::{Action, Mode};
 pub(crate) struct SortedApps {
     /// The inner list of applications.
     inner: Vec<App>,
+    /// Position of each application in the list, by UID.
+    index: HashMap<u64, usize>,
+    /// Whether the download tasks changed since they were last scheduled.
+    download_changed: bool,
+    /// Whether the upload tasks changed since they were last scheduled.
+    upload_changed: bool,
+    /// Policies the applications selected other than the default, by UID.
+    policies: HashMap<u64, SchedulePolicy>,
 }
 
 impl SortedApps {
@@ -40,8 +55,52 @@ impl SortedApps {
     ///
     /// Returns a `SortedApps` with all applications and their tasks loaded from persistent storage.
     pub(crate) fn init() -> Self {
-        Self {
-            inner: reload_all_app_from_database(),
+        Self::from_raw(reload_all_app_from_database(&HashMap::new()))
+    }
+
+    /// Creates a `SortedApps` of the given applications, whose tasks are all
+    /// changed.
+    fn from_raw(inner: Vec<App>) -> Self {
+        let mut apps = Self {
+            inner,
+            index: HashMap::new(),
+            download_changed: true,
+            upload_changed: true,
+            policies: HashMap::new(),
+        };
+        apps.reindex();
+        apps
+    }
+
+    /// Rebuilds the positions of the applications after the list changed.
+    fn reindex(&mut self) {
+        self.index = self
+            .inner
+            .iter()
+            .enumerate()
+            .map(|(i, app)| (app.uid, i))
+            .collect();
+    }
+
+    /// Marks the tasks of `action` as changed.
+    pub(crate) fn mark_changed(&mut self, action: Action) {
+        match action {
+            Action::Download => self.download_changed = true,
+            Action::Upload => self.upload_changed = true,
+            _ => {
+                self.download_changed = true;
+                self.upload_changed = true;
+            }
+        }
+    }
+
+    /// Returns whether the tasks of `action` changed since the last call,
+    /// either by a task or by the order of the applications.
+    pub(crate) fn take_changed(&mut self, action: Action) -> bool {
+        match action {
+            Action::Download => std::mem::take(&mut self.download_changed),
+            Action::Upload => std::mem::take(&mut self.upload_changed),
+            _ => false,
         }
     }
 
@@ -56,25 +115,150 @@ impl SortedApps {
     ///
     /// Applications are sorted first by whether they belong to the top user (user ID divided by 200000),
     /// and then by whether they are in the foreground.
+    /// The sort is stable, so the applications only move, and their tasks
+    /// only count as changed, when the focus or the foreground changes.
     pub(crate) fn sort(&mut self, foreground_abilities: &HashSet<u64>, top_user: u64) {
-        self.inner.sort_by(|a, b| {
-            // First sort by top user status
-            (a.uid / 200000 == top_user)
-                .cmp(&(b.uid / 200000 == top_user))
-                .then(
-                    // Then sort by foreground status
-                    foreground_abilities
-                        .contains(&a.uid)
-                        .cmp(&(foreground_abilities.contains(&b.uid))),
-                )
-        })
+        for app in self.inner.iter_mut() {
+            // First sort by top user status, then by foreground status
+            app.rank = (
+                app.uid / 200000 == top_user,
+                foreground_abilities.contains(&app.uid),
+            );
+        }
+        self.inner.sort_by(|a, b| a.rank.cmp(&b.rank));
+        let moved = self
+            .inner
+            .iter()
+            .enumerate()
+            .any(|(i, app)| self.index.get(&app.uid) != Some(&i));
+        if moved {
+            self.reindex();
+            self.mark_changed(Action::Any);
+        }
+
+        // Tasks nearing their deadline meanwhile move up within their app
+        let now = get_current_timestamp();
+        let mut reordered = false;
+        for app in self.inner.iter_mut() {
+            reordered |= app.resort_tasks(now);
+        }
+        if reordered {
+            self.mark_changed(Action::Any);
+        }
     }
 
     /// Reloads all tasks from the database.
     ///
     /// This replaces the current application and task data with fresh data from persistent storage.
+    /// The policies of the applications are kept.
     pub(crate) fn reload_all_tasks(&mut self) {
-        self.inner = reload_all_app_from_database();
+        let policies = std::mem::take(&mut self.policies);
+        *self = Self::from_raw(reload_all_app_from_database(&policies));
+        self.policies = policies;
+    }
+
+    /// Reloads the tasks of one application from the database.
+    ///
+    /// The other applications are not read again. The policy of the
+    /// application is kept.
+    ///
+    /// # Arguments
+    ///
+    /// * `uid` - The user ID of the application.
+    pub(crate) fn reload_app(&mut self, uid: u64) {
+        let tasks = RequestDb::get_instance()
+            .get_app_task_qos_infos(uid)
+            .iter()
+            .map(|info| Task::from_info(uid, info))
+            .collect::<Vec<_>>();
+        self.replace_app_tasks(uid, tasks);
+    }
+
+    /// Replaces the tasks of an application, adding it if it is new.
+    fn replace_app_tasks(&mut self, uid: u64, tasks: Vec<Task>) {
+        let now = get_current_timestamp();
+        if let Some(app) = self.get_app_mut(uid) {
+            app.tasks = tasks;
+            app.resort_tasks(now);
+        } else if !tasks.is_empty() {
+            let mut app = App::from_raw(uid, tasks);
+            app.policy = self.policies.get(&uid).copied().unwrap_or_default();
+            app.resort_tasks(now);
+            self.index.insert(uid, self.inner.len());
+            self.inner.push(app);
+        } else {
+            return;
+        }
+        self.mark_changed(Action::Any);
+    }
+
+    /// Removes the tasks of `mode` of an application.
+    ///
+    /// # Arguments
+    ///
+    /// * `uid` - The user ID of the application.
+    /// * `mode` - The mode of the tasks to remove.
+    ///
+    /// # Returns
+    ///
+    /// `true` if a task was removed.
+    pub(crate) fn remove_mode_tasks(&mut self, uid: u64, mode: Mode) -> bool {
+        let Some(app) = self.get_app_mut(uid) else {
+            return false;
+        };
+        let len = app.tasks.len();
+        app.tasks.retain(|task| task.mode != mode);
+        if app.tasks.len() == len {
+            return false;
+        }
+        self.mark_changed(Action::Any);
+        true
+    }
+
+    /// Selects the policy ordering the tasks of an application.
+    ///
+    /// # Arguments
+    ///
+    /// * `uid` - The user ID of the application.
+    /// * `policy` - The policy to order its tasks with.
+    pub(crate) fn set_policy(&mut self, uid: u64, policy: SchedulePolicy) {
+        if policy == SchedulePolicy::default() {
+            self.policies.remove(&uid);
+        } else {
+            self.policies.insert(uid, policy);
+        }
+        let reordered = self
+            .get_app_mut(uid)
+            .map_or(false, |app| app.set_policy(policy));
+        if reordered {
+            self.mark_changed(Action::Any);
+        }
+    }
+
+    /// Returns the applications grouped by rank in their sorted order, the
+    /// applications of a group share the slots in fair queuing.
+    pub(crate) fn ranks(&self) -> Vec<&[App]> {
+        let mut ranks = Vec::new();
+        let mut start = 0;
+        for i in 1..=self.inner.len() {
+            if i == self.inner.len() || self.inner[i].rank != self.inner[start].rank {
+                ranks.push(&self.inner[start..i]);
+                start = i;
+            }
+        }
+        ranks
+    }
+
+    /// Returns the next time in milliseconds after `now` a task comes within
+    /// `DEADLINE_HORIZON` of its deadline, the tasks then need a reschedule.
+    pub(crate) fn next_boost(&self, now: u64) -> Option<u64> {
+        self.inner
+            .iter()
+            .flat_map(|app| app.tasks.iter())
+            .filter_map(|task| task.deadline)
+            .map(|deadline| deadline.saturating_sub(DEADLINE_HORIZON))
+            .filter(|boost| *boost > now)
+            .min()
     }
 
     /// Inserts a new task into the appropriate application.
@@ -89,23 +273,21 @@ impl SortedApps {
     /// If the application doesn't exist, a new one is created and added to the list.
     pub(crate) fn insert_task(&mut self, uid: u64, task: TaskQosInfo) {
         // Convert database task info to internal task representation
-        let task = Task {
-            uid,
-            task_id: task.task_id,
-            mode: Mode::from(task.mode),
-            action: Action::from(task.action),
-            priority: task.priority,
-        };
+        let task = Task::from_info(uid, &task);
+        self.mark_changed(task.action);
 
         // Check if the app already exists and add the task
-        if let Some(app) = self.inner.iter_mut().find(|app| app.uid == uid) {
+        if let Some(app) = self.get_app_mut(uid) {
             app.insert(task);
             return;
         }
 
         // Create a new app with the task if it doesn't exist
         let mut app = App::new(uid);
+        app.policy = self.policies.get(&uid).copied().unwrap_or_default();
+        app.weight = weight_of(task.task_id);
         app.insert(task);
+        self.index.insert(uid, self.inner.len());
         self.inner.push(app);
     }
 
@@ -119,7 +301,8 @@ impl SortedApps {
     ///
     /// An `Option` containing a mutable reference to the application if found, otherwise `None`.
     fn get_app_mut(&mut self, uid: u64) -> Option<&mut App> {
-        self.inner.iter_mut().find(|app| app.uid == uid)
+        let i = *self.index.get(&uid)?;
+        self.inner.get_mut(i)
     }
 
     /// Removes a task from an application.
@@ -133,10 +316,11 @@ impl SortedApps {
     ///
     /// `true` if the task was successfully removed, `false` if either the application or task wasn't found.
     pub(crate) fn remove_task(&mut self, uid: u64, task_id: u32) -> bool {
-        match self.get_app_mut(uid) {
-            Some(app) => app.remove(task_id),
-            None => false,
-        }
+        let Some(action) = self.get_app_mut(uid).and_then(|app| app.remove(task_id)) else {
+            return false;
+        };
+        self.mark_changed(action);
+        true
     }
 
     /// Changes the mode of a task.
@@ -151,10 +335,14 @@ impl SortedApps {
     ///
     /// `true` if the task's mode was successfully changed, `false` if either the application or task wasn't found.
     pub(crate) fn task_set_mode(&mut self, uid: u64, task_id: u32, mode: Mode) -> bool {
-        match self.get_app_mut(uid) {
-            Some(app) => app.task_set_mode(task_id, mode),
-            None => false,
-        }
+        let Some(action) = self
+            .get_app_mut(uid)
+            .and_then(|app| app.task_set_mode(task_id, mode))
+        else {
+            return false;
+        };
+        self.mark_changed(action);
+        true
     }
 }
 
@@ -177,6 +365,14 @@ pub(crate) struct App {
     pub(crate) uid: u64,
     /// The list of tasks associated with this application, sorted by priority.
     pub(crate) tasks: Vec<Task>,
+    /// The policy ordering the tasks.
+    policy: SchedulePolicy,
+    /// Whether the application belongs to the top user and is in the
+    /// foreground, as of the last sort.
+    rank: (bool, bool),
+    /// Share of the slots of the application among those of its rank in fair
+    /// queuing.
+    weight: u64,
 }
 
 impl App {
@@ -189,6 +385,9 @@ impl App {
         Self {
             uid,
             tasks: Vec::new(),
+            policy: SchedulePolicy::default(),
+            rank: (false, false),
+            weight: app_weight(false),
         }
     }
 
@@ -199,7 +398,21 @@ impl App {
     /// * `uid` - The user ID of the application.
     /// * `tasks` - The initial list of tasks for the application.
     fn from_raw(uid: u64, tasks: Vec<Task>) -> Self {
-        Self { uid, tasks }
+        let weight = tasks
+            .first()
+            .map_or(app_weight(false), |task| weight_of(task.task_id));
+        Self {
+            uid,
+            tasks,
+            policy: SchedulePolicy::default(),
+            rank: (false, false),
+            weight,
+        }
+    }
+
+    /// Returns the share of the slots of the application in fair queuing.
+    pub(crate) fn weight(&self) -> u64 {
+        self.weight
     }
 
     /// Inserts a task into the application in sorted order.
@@ -210,9 +423,25 @@ impl App {
     ///
     /// # Notes
     ///
-    /// Uses binary search to maintain sorted order based on task priority.
+    /// Uses binary search to maintain the order of the policy, a task goes
+    /// after the tasks it is equal to.
     fn insert(&mut self, task: Task) {
-        self.tasks.binary_insert(task)
+        let now = get_current_timestamp();
+        let policy = self.policy;
+        let n = self
+            .tasks
+            .partition_point(|t| t.cmp_with(&task, policy, now) != cmp::Ordering::Greater);
+        self.tasks.insert(n, task);
+    }
+
+    /// Changes the policy ordering the tasks and re-sorts them.
+    ///
+    /// # Returns
+    ///
+    /// `true` if the order of the tasks changed.
+    fn set_policy(&mut self, policy: SchedulePolicy) -> bool {
+        self.policy = policy;
+        self.resort_tasks(get_current_timestamp())
     }
 
     /// Finds a task by its ID.
@@ -239,23 +468,31 @@ impl App {
     ///
     /// # Returns
     ///
-    /// `true` if the task was successfully removed, `false` if the task wasn't found.
-    fn remove(&mut self, task_id: u32) -> bool {
-        match self.get_task_mut(task_id) {
-            Some((index, _task)) => {
-                self.tasks.remove(index);
-                // Sorting isn't needed after removal as the remaining elements are already in order
-                true
-            }
-            None => false,
-        }
+    /// The action of the removed task, or `None` if the task wasn't found.
+    fn remove(&mut self, task_id: u32) -> Option<Action> {
+        let (index, _task) = self.get_task_mut(task_id)?;
+        // Sorting isn't needed after removal as the remaining elements are already in order
+        Some(self.tasks.remove(index).action)
     }
 
-    /// Re-sorts the tasks based on their priority.
+    /// Re-sorts the tasks by the policy of the application at `now`.
     ///
     /// This should be called after modifying a task's properties that affect its sort order.
-    fn resort_tasks(&mut self) {
-        self.tasks.sort();
+    ///
+    /// # Returns
+    ///
+    /// `true` if the order of the tasks changed.
+    fn resort_tasks(&mut self, now: u64) -> bool {
+        let policy = self.policy;
+        let sorted = self
+            .tasks
+            .windows(2)
+            .all(|pair| pair[0].cmp_with(&pair[1], policy, now) != cmp::Ordering::Greater);
+        if sorted {
+            return false;
+        }
+        self.tasks.sort_by(|a, b| a.cmp_with(b, policy, now));
+        true
     }
 
     /// Changes the mode of a task and re-sorts the task list.
@@ -267,23 +504,20 @@ impl App {
     ///
     /// # Returns
     ///
-    /// `true` if the task's mode was successfully changed, `false` if the task wasn't found.
-    fn task_set_mode(&mut self, task_id: u32, mode: Mode) -> bool {
-        match self.get_task_mut(task_id) {
-            Some((_index, task)) => {
-                task.set_mode(mode);
-                // Re-sort tasks since mode affects priority
-                self.resort_tasks();
-                true
-            }
-            None => false,
-        }
+    /// The action of the changed task, or `None` if the task wasn't found.
+    fn task_set_mode(&mut self, task_id: u32, mode: Mode) -> Option<Action> {
+        let (_index, task) = self.get_task_mut(task_id)?;
+        task.set_mode(mode);
+        let action = task.action;
+        // Re-sort tasks since mode affects priority
+        self.resort_tasks(get_current_timestamp());
+        Some(action)
     }
 }
 
 /// Represents a task with its scheduling parameters.
 ///
-/// Tasks are sorted by mode and priority within their parent application.
+/// Tasks are sorted by mode, deadline and the policy of their parent application.
 pub(crate) struct Task {
     /// The user ID of the application that owns this task.
     uid: u64,
@@ -295,9 +529,48 @@ pub(crate) struct Task {
     action: Action,
     /// The priority level of the task within its mode.
     priority: u32,
+    /// Bytes left to transfer, if the sizes of all files are known.
+    remaining: Option<u64>,
+    /// Time in milliseconds since the epoch the task should be done by.
+    deadline: Option<u64>,
+    /// Whether the task only runs in the prefetch window.
+    prefetch: bool,
 }
 
 impl Task {
+    /// Creates a task of the application `uid` from its database record.
+    fn from_info(uid: u64, info: &TaskQosInfo) -> Self {
+        Self {
+            uid,
+            task_id: info.task_id,
+            mode: Mode::from(info.mode),
+            action: Action::from(info.action),
+            priority: info.priority,
+            remaining: u64::try_from(info.remaining).ok(),
+            deadline: Some(info.deadline).filter(|deadline| *deadline != 0),
+            prefetch: info.prefetch,
+        }
+    }
+
+    /// Compares tasks by mode, then by urgency at `now`, then as `policy`
+    /// orders them.
+    fn cmp_with(&self, other: &Self, policy: SchedulePolicy, now: u64) -> cmp::Ordering {
+        let order = self
+            .mode
+            .cmp(&other.mode)
+            .then(urgency(self.deadline, now).cmp(&urgency(other.deadline, now)));
+        match policy {
+            SchedulePolicy::Priority => order.then(self.priority.cmp(&other.priority)),
+            SchedulePolicy::ShortestFirst => order
+                .then(
+                    self.remaining
+                        .unwrap_or(u64::MAX)
+                        .cmp(&other.remaining.unwrap_or(u64::MAX)),
+                )
+                .then(self.priority.cmp(&other.priority)),
+        }
+    }
+
     /// Returns the task's owning user ID.
     pub(crate) fn uid(&self) -> u64 {
         self.uid
@@ -313,6 +586,11 @@ impl Task {
         self.action
     }
 
+    /// Returns whether the task only runs in the prefetch window.
+    pub(crate) fn prefetch(&self) -> bool {
+        self.prefetch
+    }
+
     /// Updates the task's execution mode.
     ///
     /// # Arguments
@@ -326,7 +604,8 @@ impl Task {
 impl Eq for Task {}
 
 impl Ord for Task {
-    /// Compares tasks by mode first, then by priority.
+    /// Compares tasks by mode first, then by priority, which is the order of
+    /// `SchedulePolicy::Priority` for tasks without a deadline.
     ///
     /// This ensures that tasks are sorted by their mode and then by their priority
     /// within the same mode, allowing for efficient prioritized task scheduling.
@@ -351,104 +630,60 @@ impl PartialOrd for Task {
     }
 }
 
-/// A trait for binary insertion into sorted collections.
-///
-/// This trait provides a method to insert elements into a sorted collection while maintaining
-/// the sorted order using binary search.
-trait Binary<T: Ord> {
-    /// Inserts a value into the collection in sorted order.
-    ///
-    /// # Arguments
-    ///
-    /// * `value` - The value to insert.
-    fn binary_insert(&mut self, value: T);
-}
-
-impl<T: Ord> Binary<T> for Vec<T> {
-    /// Inserts a value into a sorted vector in the correct position.
-    ///
-    /// # Arguments
-    ///
-    /// * `value` - The value to insert.
-    ///
-    /// # Notes
-    ///
-    /// Uses binary search to find the correct insertion point, maintaining the sorted order.
-    /// Both equal and not found cases insert at the same position.
-    fn binary_insert(&mut self, value: T) {
-        match self.binary_search(&value) {
-            Ok(n) => self.insert(n, value),
-            Err(n) => self.insert(n, value),
-        }
-    }
+/// Returns the weight in fair queuing of the application owning `task_id`,
+/// system applications weigh more than third-party ones.
+fn weight_of(task_id: u32) -> u64 {
+    #[cfg(feature = "oh")]
+    let system = fair_queuing() && {
+        let db = RequestDb::get_instance();
+        db.contains_task(task_id)
+            && db
+                .query_task_token_id(task_id)
+                .map_or(false, is_system_token)
+    };
+    #[cfg(not(feature = "oh"))]
+    let system = {
+        let _ = task_id;
+        false
+    };
+    app_weight(system)
 }
 
 /// Reloads all applications and their tasks from the database.
 ///
-/// # Returns
-///
-/// A vector of `App` instances, each containing their sorted tasks.
-fn reload_all_app_from_database() -> Vec<App> {
-    let mut inner = Vec::new();
-    // Get all application UIDs from the database
-    for uid in reload_app_list_from_database() {
-        // Load all tasks for this application
-        let mut tasks = reload_tasks_of_app_from_database(uid);
-        // Ensure tasks are sorted by priority
-        tasks.sort();
-        inner.push(App::from_raw(uid, tasks));
-    }
-    inner
-}
-
-/// Loads all tasks for a specific application from the database.
-///
 /// # Arguments
 ///
-/// * `uid` - The user ID of the application.
+/// * `policies` - The policies the applications selected, by UID.
 ///
 /// # Returns
 ///
-/// A vector of `Task` instances for the application.
-fn reload_tasks_of_app_from_database(uid: u64) -> Vec<Task> {
-    // Get task information from the database and convert to Task instances
-    RequestDb::get_instance()
-        .get_app_task_qos_infos(uid)
-        .iter()
-        .map(|info| Task {
-            uid,
-            task_id: info.task_id,
-            mode: Mode::from(info.mode),
-            action: Action::from(info.action),
-            priority: info.priority,
-        })
-        .collect()
-}
-
-/// Loads the list of application UIDs from the database.
+/// A vector of `App` instances, each containing their sorted tasks.
 ///
-/// # Returns
+/// # Notes
 ///
-/// A set of unique user IDs representing all applications with tasks.
-fn reload_app_list_from_database() -> HashSet<u64> {
-    // Get all unique application UIDs from the database
-    RequestDb::get_instance()
-        .get_app_infos()
-        .into_iter()
-        .collect()
-}
+/// The tasks of all applications are read in a single query ordered by UID,
+/// so a restore costs one query however many applications have tasks.
+fn reload_all_app_from_database(policies: &HashMap<u64, SchedulePolicy>) -> Vec<App> {
+    let infos = RequestDb::get_instance().get_all_task_qos_infos();
+    let mut inner: Vec<App> = Vec::new();
+    for info in infos.iter() {
+        // Rows come grouped by application, a new UID starts a new app
+        match inner.last_mut() {
+            Some(app) if app.uid == info.uid => app.tasks.push(Task::from_info(info.uid, info)),
+            _ => inner.push(App::from_raw(
+                info.uid,
+                vec![Task::from_info(info.uid, info)],
+            )),
+        }
+    }
 
-impl RequestDb {
-    /// Retrieves all unique application UIDs from the database.
-    ///
-    /// # Returns
-    ///
-    /// A vector of user IDs representing all applications that have tasks in the database.
-    fn get_app_infos(&self) -> Vec<u64> {
-        // SQL query to get distinct UIDs from the request_task table
-        let sql = "SELECT DISTINCT uid FROM request_task";
-        self.query_integer(sql)
+    let now = get_current_timestamp();
+    for app in inner.iter_mut() {
+        // Ensure tasks are sorted by the policy of the app
+        app.policy = policies.get(&app.uid).copied().unwrap_or_default();
+        app.resort_tasks(now);
     }
+    inner
 }
 
 #[cfg(feature = "oh")]
@@ -0,0 +1,92 @@
+// Copyright (C) 2023 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Bandwidth estimation from the throughput of the running tasks.
+//!
+//! The bytes transferred by every running task are sampled periodically. The
+//! estimate is the peak of the aggregate throughput, which follows a faster
+//! link at once and a slower one gradually, so the tiers of the scheduler do
+//! not shrink whenever the tasks pause between two files.
+
+use std::collections::HashMap;
+use std::time::Duration;
+
+/// Interval between two samples of the running tasks.
+pub(crate) const SAMPLE_INTERVAL: Duration = Duration::from_secs(2);
+
+/// Fraction of the distance to a lower throughput the peak falls per sample.
+const PEAK_DECAY: u64 = 8;
+
+/// Estimates the bandwidth of the link from the running tasks.
+pub(crate) struct BandwidthEstimator {
+    /// Bytes transferred by each task when last sampled.
+    transferred: HashMap<(u64, u32), u64>,
+    /// Time in milliseconds of the last sample.
+    sampled_at: Option<u64>,
+    /// Peak throughput in bytes per second.
+    peak: Option<u64>,
+}
+
+impl BandwidthEstimator {
+    /// Creates an estimator without any sample.
+    pub(crate) fn new() -> Self {
+        Self {
+            transferred: HashMap::new(),
+            sampled_at: None,
+            peak: None,
+        }
+    }
+
+    /// Samples the bytes transferred by the running tasks at `now`.
+    ///
+    /// Only the tasks running at both this and the last sample count, a task
+    /// started or restarted meanwhile has no known bytes before them.
+    pub(crate) fn sample<I>(&mut self, now: u64, tasks: I)
+    where
+        I: IntoIterator<Item = ((u64, u32), u64)>,
+    {
+        let transferred = tasks.into_iter().collect::<HashMap<_, _>>();
+        let bytes = transferred
+            .iter()
+            .filter_map(|(task, now)| {
+                let last = self.transferred.get(task)?;
+                now.checked_sub(*last)
+            })
+            .sum::<u64>();
+        let running = transferred.keys().any(|task| self.transferred.contains_key(task));
+        let elapsed = self.sampled_at.map_or(0, |last| now.saturating_sub(last));
+        self.transferred = transferred;
+        self.sampled_at = Some(now);
+
+        // Nothing ran for the whole interval, the link stays as estimated
+        if !running || elapsed == 0 {
+            return;
+        }
+        let rate = bytes * 1000 / elapsed;
+        self.peak = Some(match self.peak {
+            Some(peak) if rate < peak => peak - (peak - rate) / PEAK_DECAY,
+            _ => rate,
+        });
+    }
+
+    /// Returns the estimated bandwidth in bytes per second, if a task ran for
+    /// a whole sample interval yet.
+    pub(crate) fn bandwidth(&self) -> Option<u64> {
+        self.peak
+    }
+}
+
+#[cfg(test)]
+mod ut_bandwidth {
+    include!("../../../../tests/ut/manage/scheduler/qos/ut_bandwidth.rs");
+}
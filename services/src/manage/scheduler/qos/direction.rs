@@ -43,7 +43,7 @@ impl QosChanges {
 ///
 /// This struct associates a task with a new QoS level, allowing the scheduler to
 /// adjust the task's priority and resource allocation.
-#[derive(Debug)]
+#[derive(Clone, PartialEq, Eq, Debug)]
 pub(crate) struct QosDirection {
     /// The user ID of the application that owns the task.
     uid: u64,
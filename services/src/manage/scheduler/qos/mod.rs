@@ -22,12 +22,20 @@
 //! resources while maintaining overall system performance.
 
 mod apps;
+mod bandwidth;
 mod direction;
+mod policy;
 mod rss;
+mod share;
 
-use apps::SortedApps;
+use std::collections::HashSet;
+
+use apps::{SortedApps, Task};
+pub(crate) use bandwidth::{BandwidthEstimator, SAMPLE_INTERVAL};
 pub(crate) use direction::{QosChanges, QosDirection, QosLevel};
+pub(crate) use policy::SchedulePolicy;
 pub(crate) use rss::RssCapacity;
+use share::{deficit_round_robin, fair_queuing};
 
 use super::state;
 use crate::config::Mode;
@@ -44,6 +52,14 @@ pub(crate) struct Qos {
     pub(crate) apps: SortedApps,
     /// Current RSS memory capacity level that determines task allocation limits.
     capacity: RssCapacity,
+    /// Measured bandwidth in bytes per second the zones are sized for.
+    bandwidth: Option<u64>,
+    /// Directions of the download tasks given by the last reschedule.
+    download: Option<Vec<QosDirection>>,
+    /// Directions of the upload tasks given by the last reschedule.
+    upload: Option<Vec<QosDirection>>,
+    /// Whether the prefetch window was open at the last reschedule.
+    prefetch_window: bool,
 }
 
 impl Qos {
@@ -55,6 +71,10 @@ impl Qos {
         Self {
             apps: SortedApps::init(),
             capacity: RssCapacity::LEVEL0,
+            bandwidth: None,
+            download: None,
+            upload: None,
+            prefetch_window: false,
         }
     }
 
@@ -97,15 +117,79 @@ impl Qos {
         self.apps.reload_all_tasks();
     }
 
+    /// Reloads the tasks of one application from the database.
+    ///
+    /// # Arguments
+    ///
+    /// * `uid` - The user ID of the application whose tasks changed.
+    pub(crate) fn reload_app_tasks(&mut self, uid: u64) {
+        self.apps.reload_app(uid);
+    }
+
+    /// Removes the frontend tasks of an application, which stop being
+    /// runnable once it timed out in the background.
+    ///
+    /// # Arguments
+    ///
+    /// * `uid` - The user ID of the application.
+    pub(crate) fn remove_frontend_tasks(&mut self, uid: u64) {
+        self.apps.remove_mode_tasks(uid, Mode::FrontEnd);
+    }
+
     /// Updates the RSS memory capacity level used for task allocation.
     ///
     /// # Arguments
     ///
     /// * `rss` - The new RSS capacity level to use for scheduling decisions.
     pub(crate) fn change_rss(&mut self, rss: RssCapacity) {
+        if self.capacity != rss {
+            self.apps.mark_changed(Action::Any);
+        }
         self.capacity = rss;
     }
 
+    /// Updates the measured bandwidth the zones of the capacity are sized for.
+    ///
+    /// # Arguments
+    ///
+    /// * `bandwidth` - The bandwidth of the link in bytes per second.
+    ///
+    /// # Returns
+    ///
+    /// `true` if the zones changed and the tasks need a reschedule.
+    pub(crate) fn change_bandwidth(&mut self, bandwidth: u64) -> bool {
+        let zones = self.zones();
+        self.bandwidth = Some(bandwidth);
+        if self.zones() == zones {
+            return false;
+        }
+        self.apps.mark_changed(Action::Any);
+        true
+    }
+
+    /// Returns the zones of the capacity for the measured bandwidth, the
+    /// task counts of the RSS level stay the upper bound.
+    ///
+    /// The device is idle in the prefetch window, which then runs as many
+    /// tasks as the highest level allows.
+    fn zones(&self) -> RssCapacity {
+        let capacity = if self.prefetch_window {
+            &RssCapacity::LEVEL0
+        } else {
+            &self.capacity
+        };
+        match self.bandwidth {
+            Some(bandwidth) => capacity.with_bandwidth(bandwidth),
+            None => capacity.clone(),
+        }
+    }
+
+    /// Whether a task may be given a direction, prefetch tasks wait for the
+    /// prefetch window.
+    fn runnable(&self, task: &Task, action: Action) -> bool {
+        task.action() == action && (self.prefetch_window || !task.prefetch())
+    }
+
     /// Changes the execution mode of a specific task.
     ///
     /// # Arguments
@@ -121,6 +205,22 @@ impl Qos {
         self.apps.task_set_mode(uid, task_id, mode)
     }
 
+    /// Selects the policy ordering the tasks of an application.
+    ///
+    /// # Arguments
+    ///
+    /// * `uid` - The user ID of the application.
+    /// * `policy` - The policy to order its tasks with.
+    pub(crate) fn set_policy(&mut self, uid: u64, policy: SchedulePolicy) {
+        self.apps.set_policy(uid, policy);
+    }
+
+    /// Returns the next time in milliseconds after `now` a task nears its
+    /// deadline, the tasks then need a reschedule.
+    pub(crate) fn next_boost(&self, now: u64) -> Option<u64> {
+        self.apps.next_boost(now)
+    }
+
     /// Reschedules all tasks and generates QoS direction changes.
     ///
     /// # Arguments
@@ -130,17 +230,75 @@ impl Qos {
     /// # Returns
     ///
     /// A `QosChanges` object containing the updated QoS directions for both download and upload tasks.
+    /// An action is `None` if its directions are the same as the last ones.
     pub(crate) fn reschedule(&mut self, state: &state::Handler) -> QosChanges {
         // Only sort apps before assigning priorities
         self.apps
             .sort(state.foreground_abilities(), state.top_user());
+        let prefetch_window = state.prefetch_window();
+        if prefetch_window != self.prefetch_window {
+            self.prefetch_window = prefetch_window;
+            self.apps.mark_changed(Action::Any);
+        }
         let mut changes = QosChanges::new();
         // Generate QoS directions for both download and upload tasks separately
-        changes.download = Some(self.reschedule_inner(Action::Download));
-        changes.upload = Some(self.reschedule_inner(Action::Upload));
+        changes.download = self.reschedule_changed(Action::Download);
+        changes.upload = self.reschedule_changed(Action::Upload);
         changes
     }
 
+    /// Returns up to `n` tasks next in line: tasks without a direction in the
+    /// last reschedule, in the order they would be given one.
+    pub(crate) fn upcoming(&self, n: usize) -> Vec<u32> {
+        let directed = self
+            .download
+            .iter()
+            .chain(self.upload.iter())
+            .flatten()
+            .map(|direction| direction.task_id())
+            .collect::<HashSet<_>>();
+        self.apps
+            .iter()
+            .flat_map(|app| app.tasks.iter())
+            .filter(|task| {
+                (self.runnable(task, Action::Download) || self.runnable(task, Action::Upload))
+                    && !directed.contains(&task.task_id())
+            })
+            .map(|task| task.task_id())
+            .take(n)
+            .collect()
+    }
+
+    /// Forgets the directions of the last reschedule, the next one gives the
+    /// directions of both actions again.
+    pub(crate) fn forget_directions(&mut self) {
+        self.download = None;
+        self.upload = None;
+        self.apps.mark_changed(Action::Any);
+    }
+
+    /// Reschedules the tasks of an action if its tasks, the order of the
+    /// applications or the capacity changed since the last reschedule.
+    ///
+    /// # Returns
+    ///
+    /// The new QoS directions of the tasks, or `None` if they did not change.
+    fn reschedule_changed(&mut self, action: Action) -> Option<Vec<QosDirection>> {
+        if !self.apps.take_changed(action) {
+            return None;
+        }
+        let directions = self.reschedule_inner(action);
+        let last = match action {
+            Action::Download => &mut self.download,
+            _ => &mut self.upload,
+        };
+        if last.as_ref() == Some(&directions) {
+            return None;
+        }
+        *last = Some(directions.clone());
+        Some(directions)
+    }
+
     /// Inner method that handles the core scheduling algorithm for a specific action type.
     ///
     /// # Arguments
@@ -155,14 +313,20 @@ impl Qos {
     ///
     /// This method implements a three-tier priority system (M1, M2, M3) with different speed limits.
     /// Tasks are assigned to tiers based on their application's priority and position in the sorted list.
+    /// With fair queuing the applications of a rank share the tiers instead, see `reschedule_fair`.
     fn reschedule_inner(&mut self, action: Action) -> Vec<QosDirection> {
+        if fair_queuing() {
+            return self.reschedule_fair(action);
+        }
+
         // Get capacity limits and corresponding speed levels for each priority tier
-        let m1 = self.capacity.m1();
-        let m1_speed = self.capacity.m1_speed();
-        let m2 = self.capacity.m2();
-        let m2_speed = self.capacity.m2_speed();
-        let m3 = self.capacity.m3();
-        let m3_speed = self.capacity.m3_speed();
+        let capacity = self.zones();
+        let m1 = capacity.m1();
+        let m1_speed = capacity.m1_speed();
+        let m2 = capacity.m2();
+        let m2_speed = capacity.m2_speed();
+        let m3 = capacity.m3();
+        let m3_speed = capacity.m3_speed();
 
         // Track current task count and positions for fair distribution
         let mut count = 0;
@@ -180,8 +344,9 @@ impl Qos {
             }
             app.tasks.iter().enumerate()
         }) {
-            // Skip tasks that don't match the current action type
-            if task.action() != action {
+            // Skip tasks that don't match the current action type or wait
+            // for the prefetch window
+            if !self.runnable(task, action) {
                 continue;
             }
             
@@ -222,8 +387,9 @@ impl Qos {
                     None => continue,
                 };
 
-                // Skip tasks that don't match the current action type
-                if task.action() != action {
+                // Skip tasks that don't match the current action type or wait
+                // for the prefetch window
+                if !self.runnable(task, action) {
                     continue;
                 }
 
@@ -253,8 +419,9 @@ impl Qos {
             .take(1)
             .flat_map(|app| app.tasks.iter().skip(task_i + 1))
         {
-            // Skip tasks that don't match the current action type
-            if task.action() != action {
+            // Skip tasks that don't match the current action type or wait
+            // for the prefetch window
+            if !self.runnable(task, action) {
                 continue;
             }
 
@@ -268,4 +435,62 @@ impl Qos {
         }
         qos_vec
     }
+
+    /// Schedules the tasks of an action with fair queuing across applications.
+    ///
+    /// # Arguments
+    ///
+    /// * `action` - The action type (Download or Upload) to schedule.
+    ///
+    /// # Returns
+    ///
+    /// A vector of `QosDirection` objects specifying the new QoS levels for tasks.
+    ///
+    /// # Notes
+    ///
+    /// Ranks are served in their sorted order, each taking the slots left by
+    /// the ranks before it. Within a rank the applications take the slots by
+    /// deficit round-robin in proportion to their weights, so an application
+    /// with many tasks cannot starve the others. The tasks then fill the M1,
+    /// M2 and M3 tiers in the order they were taken.
+    fn reschedule_fair(&self, action: Action) -> Vec<QosDirection> {
+        let capacity = self.zones();
+        let m1 = capacity.m1();
+        let m2 = capacity.m2();
+        let slots = m1 + m2 + capacity.m3();
+
+        let mut taken = Vec::new();
+        for rank in self.apps.ranks() {
+            if taken.len() >= slots {
+                break;
+            }
+            let queues = rank
+                .iter()
+                .map(|app| {
+                    let tasks = app
+                        .tasks
+                        .iter()
+                        .filter(|task| self.runnable(task, action))
+                        .collect::<Vec<_>>();
+                    (app.weight(), tasks)
+                })
+                .collect();
+            taken.extend(deficit_round_robin(queues, slots - taken.len()));
+        }
+
+        taken
+            .into_iter()
+            .enumerate()
+            .map(|(count, task)| {
+                let speed = if count < m1 {
+                    capacity.m1_speed()
+                } else if count < m1 + m2 {
+                    capacity.m2_speed()
+                } else {
+                    capacity.m3_speed()
+                };
+                QosDirection::new(task.uid(), task.task_id(), speed)
+            })
+            .collect()
+    }
 }
@@ -0,0 +1,55 @@
+// Copyright (C) 2023 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Policies ordering the tasks within an application.
+//!
+//! Tasks are always ordered by their mode first. Within a mode, a task within
+//! `DEADLINE_HORIZON` of its deadline goes before the others, the earliest
+//! deadline first. The remaining order is given by the policy the application
+//! selected.
+
+/// Time in milliseconds before its deadline a task is run first.
+pub(crate) const DEADLINE_HORIZON: u64 = 5 * 60 * 1000;
+
+/// Order of the tasks of an application after their mode and deadline.
+#[derive(Clone, Copy, PartialEq, Eq, Debug, Default)]
+#[repr(u8)]
+pub(crate) enum SchedulePolicy {
+    /// By the priority of the tasks.
+    #[default]
+    Priority = 0,
+    /// By the bytes left to transfer, fewest first, then by priority. Tasks
+    /// of unknown size go last.
+    ShortestFirst,
+}
+
+impl TryFrom<u32> for SchedulePolicy {
+    type Error = ();
+
+    fn try_from(value: u32) -> Result<Self, Self::Error> {
+        match value {
+            0 => Ok(Self::Priority),
+            1 => Ok(Self::ShortestFirst),
+            _ => Err(()),
+        }
+    }
+}
+
+/// Returns the deadline of a task if it is within `DEADLINE_HORIZON` of
+/// `now`, `u64::MAX` otherwise, so that urgent tasks order first.
+pub(crate) fn urgency(deadline: Option<u64>, now: u64) -> u64 {
+    match deadline {
+        Some(deadline) if deadline <= now.saturating_add(DEADLINE_HORIZON) => deadline,
+        _ => u64::MAX,
+    }
+}
@@ -20,6 +20,14 @@
 
 use super::QosLevel;
 
+/// Throughput in bytes per second a running task should get at least, a link
+/// runs no more tasks than it can give this.
+const MIN_TASK_SHARE: u64 = 64 * 1024;
+
+/// Throughput in bytes per second of a task at full speed, above the limits
+/// of the other zones.
+const FULL_SPEED_SHARE: u64 = 1024 * 1024;
+
 /// Memory capacity configuration for QoS scheduling based on RSS levels.
 ///
 /// This struct defines the task allocation limits and associated QoS levels for
@@ -35,7 +43,7 @@ use super::QosLevel;
 /// 4. QoS level for m1 tasks
 /// 5. QoS level for m2 tasks
 /// 6. QoS level for m3 tasks
-#[derive(PartialEq, Eq)]
+#[derive(Clone, PartialEq, Eq, Debug)]
 pub(crate) struct RssCapacity(usize, usize, usize, QosLevel, QosLevel, QosLevel);
 
 impl RssCapacity {
@@ -115,6 +123,26 @@ impl RssCapacity {
     pub(crate) fn m3_speed(&self) -> QosLevel {
         self.5
     }
+
+    /// Sizes the zones for a link of `bandwidth` bytes per second, within the
+    /// number of tasks of this level.
+    ///
+    /// The link runs as many tasks as get `MIN_TASK_SHARE` each, but never
+    /// fewer than the full-speed zone of the level. As many of them run at
+    /// full speed as get `FULL_SPEED_SHARE` each, the fair-adjustment zone
+    /// keeps its size as far as the other tasks allow and the rest run at
+    /// medium speed.
+    pub(crate) fn with_bandwidth(&self, bandwidth: u64) -> Self {
+        let total = self.0 + self.1 + self.2;
+        let running = usize::try_from(bandwidth / MIN_TASK_SHARE)
+            .unwrap_or(usize::MAX)
+            .clamp(self.0, total);
+        let m1 = usize::try_from(bandwidth / FULL_SPEED_SHARE)
+            .unwrap_or(usize::MAX)
+            .clamp(1, running);
+        let m3 = self.2.min(running - m1);
+        Self(m1, running - m1 - m3, m3, self.3, self.4, self.5)
+    }
 }
 
 #[cfg(test)]
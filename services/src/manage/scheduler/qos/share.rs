@@ -0,0 +1,103 @@
+// Copyright (C) 2024 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Sharing of the QoS slots across applications.
+//!
+//! By default the slots go to the applications in their sorted order, so the
+//! first application with many tasks takes most of them. With fair queuing,
+//! applications of the same rank share the slots by deficit round-robin,
+//! each in proportion to its weight. System applications and third-party
+//! applications have separate weights.
+//!
+//! Fair queuing and the weights are set at build time by the
+//! `request_fair_queuing`, `request_system_app_weight` and
+//! `request_third_party_weight` GN arguments.
+
+/// Weight of a system application if the build does not set it.
+const DEFAULT_SYSTEM_APP_WEIGHT: u64 = 2;
+
+/// Weight of a third-party application if the build does not set it.
+const DEFAULT_THIRD_PARTY_WEIGHT: u64 = 1;
+
+/// Returns whether applications of the same rank share the slots fairly.
+pub(crate) fn fair_queuing() -> bool {
+    option_env!("REQUEST_FAIR_QUEUING") == Some("true")
+}
+
+/// Returns the weight of an application in fair queuing.
+pub(crate) fn app_weight(system: bool) -> u64 {
+    let (configured, default) = if system {
+        (
+            option_env!("REQUEST_SYSTEM_APP_WEIGHT"),
+            DEFAULT_SYSTEM_APP_WEIGHT,
+        )
+    } else {
+        (
+            option_env!("REQUEST_THIRD_PARTY_WEIGHT"),
+            DEFAULT_THIRD_PARTY_WEIGHT,
+        )
+    };
+    configured
+        .and_then(|weight| weight.parse().ok())
+        .filter(|weight| *weight > 0)
+        .unwrap_or(default)
+}
+
+/// Takes up to `limit` items from the queues by deficit round-robin.
+///
+/// Each round, every queue earns its weight in credit and hands out one item
+/// per credit while it has items. A queue that runs empty loses its credit,
+/// so the others share what it did not use. Within a round the queues go in
+/// their given order.
+///
+/// # Arguments
+///
+/// * `queues` - The weight and the ordered items of each queue.
+/// * `limit` - The maximum number of items to take.
+pub(crate) fn deficit_round_robin<T>(queues: Vec<(u64, Vec<T>)>, limit: usize) -> Vec<T> {
+    let mut queues = queues
+        .into_iter()
+        .map(|(weight, items)| (weight.max(1), 0, items.into_iter().peekable()))
+        .collect::<Vec<_>>();
+    let mut taken = Vec::new();
+    while taken.len() < limit {
+        let mut any_left = false;
+        for (weight, deficit, items) in queues.iter_mut() {
+            if items.peek().is_none() {
+                continue;
+            }
+            *deficit += *weight;
+            while *deficit > 0 && taken.len() < limit {
+                let Some(item) = items.next() else {
+                    break;
+                };
+                taken.push(item);
+                *deficit -= 1;
+            }
+            if items.peek().is_none() {
+                *deficit = 0;
+            } else {
+                any_left = true;
+            }
+        }
+        if !any_left {
+            break;
+        }
+    }
+    taken
+}
+
+#[cfg(test)]
+mod ut_share {
+    include!("../../../../tests/ut/manage/scheduler/qos/ut_share.rs");
+}
@@ -18,12 +18,14 @@
 //! and resource optimization through the service ability keeper.
 
 mod keeper;
+pub(crate) mod registry;
 mod running_task;
 use std::collections::{HashMap, HashSet};
 use std::sync::atomic::{AtomicBool, Ordering};
 use std::sync::Arc;
 
 use keeper::SAKeeper;
+use registry::RunningTasks;
 
 cfg_oh! {
     use crate::ability::SYSTEM_CONFIG_MANAGER;
@@ -36,6 +38,8 @@ use crate::manage::database::RequestDb;
 use crate::manage::events::{TaskEvent, TaskManagerEvent};
 use crate::manage::scheduler::qos::{QosChanges, QosDirection};
 use crate::manage::scheduler::queue::running_task::RunningTask;
+use crate::manage::scheduler::ramp::RestoreRamp;
+use crate::manage::scheduler::trace::Moves;
 use crate::manage::task_manager::TaskManagerTx;
 use crate::service::active_counter::ActiveCounter;
 use crate::service::client::ClientManagerEntry;
@@ -44,7 +48,9 @@ use crate::task::config::Action;
 use crate::task::info::State;
 use crate::task::reason::Reason;
 use crate::task::request_task::RequestTask;
-use crate::utils::runtime_spawn;
+use crate::task::timeline::{Phase, Timelines};
+use crate::utils::get_current_timestamp;
+use crate::utils::runtime::io_spawn;
 
 /// Task queue manager for running download and upload operations.
 ///
@@ -169,7 +175,7 @@ impl RunningQueue {
             let running_task = RunningTask::new(task.clone(), self.tx.clone(), self.keeper.clone());
             let abort_flag = Arc::new(AtomicBool::new(false));
             let abort_flag_clone = abort_flag.clone();
-            let join_handle = runtime_spawn(async move {
+            let join_handle = io_spawn(async move {
                 running_task.run(abort_flag_clone.clone()).await;
             });
             let uid = task.uid();
@@ -209,14 +215,29 @@ impl RunningQueue {
     /// # Arguments
     ///
     /// * `qos` - Contains new QoS directions for download and upload tasks.
+    /// * `ramp` - Pace of the tasks started after the service started.
     /// * `qos_remove_queue` - Vector to collect tasks that need to be removed from QoS management.
-    pub(crate) fn reschedule(&mut self, qos: QosChanges, qos_remove_queue: &mut Vec<(u64, u32)>) {
+    /// * `moves` - Counts of the tasks started and stopped, for the trace.
+    ///
+    /// # Returns
+    ///
+    /// `true` if every task of the directions is queued, `false` if some could
+    /// not be loaded and should be tried again by the next reschedule.
+    pub(crate) fn reschedule(
+        &mut self,
+        qos: QosChanges,
+        ramp: &mut RestoreRamp,
+        qos_remove_queue: &mut Vec<(u64, u32)>,
+        moves: &mut Moves,
+    ) -> bool {
+        let mut complete = true;
         if let Some(vec) = qos.download {
-            self.reschedule_inner(Action::Download, vec, qos_remove_queue)
+            complete &= self.reschedule_inner(Action::Download, vec, ramp, qos_remove_queue, moves);
         }
         if let Some(vec) = qos.upload {
-            self.reschedule_inner(Action::Upload, vec, qos_remove_queue)
+            complete &= self.reschedule_inner(Action::Upload, vec, ramp, qos_remove_queue, moves);
         }
+        complete
     }
 
     /// Internal implementation for rescheduling tasks based on QoS directions.
@@ -225,13 +246,22 @@ impl RunningQueue {
     ///
     /// * `action` - The type of tasks to reschedule (Download or Upload).
     /// * `qos_vec` - List of QoS directions for specific tasks.
+    /// * `ramp` - Pace of the tasks started after the service started.
     /// * `qos_remove_queue` - Vector to collect tasks that need to be removed from QoS management.
+    /// * `moves` - Counts of the tasks started and stopped, for the trace.
+    ///
+    /// # Returns
+    ///
+    /// `true` if every task of the directions is queued.
     pub(crate) fn reschedule_inner(
         &mut self,
         action: Action,
         qos_vec: Vec<QosDirection>,
+        ramp: &mut RestoreRamp,
         qos_remove_queue: &mut Vec<(u64, u32)>,
-    ) {
+        moves: &mut Moves,
+    ) -> bool {
+        let now = get_current_timestamp();
         // Create a new queue to hold tasks that should continue running
         let mut new_queue = HashMap::new();
 
@@ -254,6 +284,11 @@ impl RunningQueue {
                 continue;
             }
 
+            // Held back for a later step of the restore ramp
+            if !ramp.admit(uid, now) {
+                continue;
+            }
+
             // Task not in current queue - retrieve from database and start it
             #[cfg(feature = "oh")]
             let system_config = unsafe { SYSTEM_CONFIG_MANAGER.assume_init_ref().system_config() };
@@ -289,6 +324,7 @@ impl RunningQueue {
             task.speed_limit(qos_direction.direction() as u64);
 
             new_queue.insert((uid, task_id), task.clone());
+            moves.promoted += 1;
 
             // Skip if task is already running
             if self.running_tasks.contains_key(&(uid, task_id)) {
@@ -298,6 +334,7 @@ impl RunningQueue {
 
             // Start the task execution
             info!("{} begin", task_id);
+            Timelines::get_instance().record(task_id, Phase::Scheduled(qos_direction.direction()));
             let running_task = RunningTask::new(task.clone(), self.tx.clone(), self.keeper.clone());
             // Update task state in database
             RequestDb::get_instance().update_task_state(
@@ -308,7 +345,7 @@ impl RunningQueue {
             // Set up abort mechanism and spawn the task
             let abort_flag = Arc::new(AtomicBool::new(false));
             let abort_flag_clone = abort_flag.clone();
-            let join_handle = runtime_spawn(async move {
+            let join_handle = io_spawn(async move {
                 running_task.run(abort_flag_clone).await;
             });
 
@@ -320,6 +357,7 @@ impl RunningQueue {
             );
         }
         // Cancel any tasks that weren't included in the new queue (no longer satisfy QoS)
+        moves.demoted += queue.len();
         for task in queue.values() {
             if let Some(join_handle) = self.running_tasks.get_mut(&(task.uid(), task.task_id())) {
                 if let Some(join_handle) = join_handle.take() {
@@ -327,24 +365,55 @@ impl RunningQueue {
                 };
             }
         }
-        // Replace the old queue with the new filtered queue
+        // Replace the old queue with the new filtered queue, in the registry
+        // the IPC threads read as well
+        let registry = RunningTasks::get_instance();
+        for &(uid, task_id) in queue.keys() {
+            registry.remove(uid, task_id);
+        }
+        for task in new_queue.values() {
+            registry.insert(task.clone());
+        }
+        let complete = new_queue.len() == qos_vec.len();
         *queue = new_queue;
 
         // Notify run count manager about the updated number of running tasks
         #[cfg(feature = "oh")]
         self.run_count_manager
             .notify_run_count(self.download_queue.len() + self.upload_queue.len());
+        complete
     }
 
-    /// Cancels all currently running tasks.
+    /// Cancels the running tasks accepted by `retry`, which then restart in
+    /// place from their progress.
+    ///
+    /// # Arguments
     ///
-    /// This method cancels all tasks managed by this queue, clearing all abort handles.
-    pub(crate) fn retry_all_tasks(&mut self) {
-        for task in self.running_tasks.iter_mut() {
-            if let Some(handle) = task.1.take() {
+    /// * `retry` - Whether a queued task should reconnect. Running tasks no
+    ///   longer queued are always retried.
+    ///
+    /// # Returns
+    ///
+    /// The number of tasks cancelled for retrying.
+    pub(crate) fn retry_tasks<F>(&mut self, retry: F) -> usize
+    where
+        F: Fn(&RequestTask) -> bool,
+    {
+        let mut retried = 0;
+        for (key, handle) in self.running_tasks.iter_mut() {
+            let task = self
+                .download_queue
+                .get(key)
+                .or_else(|| self.upload_queue.get(key));
+            if task.is_some_and(|task| !retry(task)) {
+                continue;
+            }
+            if let Some(handle) = handle.take() {
                 handle.cancel();
+                retried += 1;
             }
         }
+        retried
     }
 
     /// Cancels a specific task by its ID and user ID.
@@ -0,0 +1,83 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Running tasks shared with the IPC threads.
+//!
+//! The running queue belongs to the task manager actor. Its tasks are
+//! mirrored here, sharded by uid, so the queries of an application find its
+//! running tasks without waiting behind the events of the actor, and without
+//! contending with the queries of other applications.
+
+use std::collections::HashMap;
+use std::sync::{Arc, LazyLock, Mutex};
+
+use crate::task::request_task::RequestTask;
+
+/// Number of shards, applications are spread over them by uid.
+const SHARDS: usize = 8;
+
+static RUNNING_TASKS: LazyLock<RunningTasks> = LazyLock::new(RunningTasks::new);
+
+/// Running tasks by uid and task ID, sharded by uid.
+pub(crate) struct RunningTasks {
+    shards: [Mutex<HashMap<(u64, u32), Arc<RequestTask>>>; SHARDS],
+}
+
+impl RunningTasks {
+    fn new() -> Self {
+        Self {
+            shards: std::array::from_fn(|_| Mutex::new(HashMap::new())),
+        }
+    }
+
+    pub(crate) fn get_instance() -> &'static Self {
+        &RUNNING_TASKS
+    }
+
+    fn shard(&self, uid: u64) -> &Mutex<HashMap<(u64, u32), Arc<RequestTask>>> {
+        &self.shards[(uid % SHARDS as u64) as usize]
+    }
+
+    /// Gets a running task of an application.
+    pub(crate) fn get(&self, uid: u64, task_id: u32) -> Option<Arc<RequestTask>> {
+        self.shard(uid)
+            .lock()
+            .unwrap()
+            .get(&(uid, task_id))
+            .cloned()
+    }
+
+    /// Finds a running task of any application, looking through every shard.
+    pub(crate) fn find(&self, task_id: u32) -> Option<Arc<RequestTask>> {
+        self.shards.iter().find_map(|shard| {
+            shard
+                .lock()
+                .unwrap()
+                .iter()
+                .find(|((_, id), _)| *id == task_id)
+                .map(|(_, task)| task.clone())
+        })
+    }
+
+    pub(super) fn insert(&self, task: Arc<RequestTask>) {
+        let uid = task.uid();
+        self.shard(uid)
+            .lock()
+            .unwrap()
+            .insert((uid, task.task_id()), task);
+    }
+
+    pub(super) fn remove(&self, uid: u64, task_id: u32) {
+        self.shard(uid).lock().unwrap().remove(&(uid, task_id));
+    }
+}
@@ -29,10 +29,13 @@ use crate::manage::scheduler::queue::keeper::SAKeeper;
 use crate::manage::task_manager::TaskManagerTx;
 use crate::service::notification_bar::NotificationDispatcher;
 use crate::task::config::Action;
+use crate::task::cpu;
 use crate::task::download::download;
 use crate::task::reason::Reason;
 use crate::task::request_task::RequestTask;
 use crate::task::upload::upload;
+#[cfg(feature = "oh")]
+use crate::trace::RequestTrace;
 use crate::utils::get_current_duration;
 
 /// A task in the process of being executed.
@@ -80,16 +83,26 @@ impl RunningTask {
     ///
     /// This method dispatches to either the download or upload implementation
     /// based on the task's action type. It consumes the `RunningTask` instance.
+    /// The CPU of the polls and the bytes transferred are charged to the task.
     pub(crate) async fn run(self, abort_flag: Arc<AtomicBool>) {
+        #[cfg(feature = "oh")]
+        let _trace = RequestTrace::of_task(self.task.task_id(), "run");
+        let transferred = self.task.transferred.load(Ordering::Acquire);
         match self.conf.common_data.action {
             Action::Download => {
-                download(self.task.clone(), abort_flag).await;
+                cpu::charged(&self.task, download(self.task.clone(), abort_flag)).await;
             }
             Action::Upload => {
-                upload(self.task.clone(), abort_flag).await;
+                cpu::charged(&self.task, upload(self.task.clone(), abort_flag)).await;
             }
             _ => {}
         }
+        let transferred = self
+            .task
+            .transferred
+            .load(Ordering::Acquire)
+            .saturating_sub(transferred);
+        cpu::of(&self.task).add_bytes(transferred);
     }
 
     /// Checks if a download task has completed.
@@ -113,7 +126,7 @@ impl RunningTask {
             if *total == -1 {
                 return false;
             }
-            return mutex_guard.common_data.total_processed == (*total as usize);
+            return self.task.processed.total() == (*total as usize);
         }
         false
     }
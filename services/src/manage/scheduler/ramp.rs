@@ -0,0 +1,132 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Ramp-up of the tasks restored when the service starts.
+//!
+//! After a reboot or a restart of the service, every restorable task is in
+//! the QoS queue and the first reschedule would start them all at once, each
+//! connecting at the same moment. While the ramp is open, a reschedule starts
+//! at most `ramp_step` tasks that are not running yet per step, and the steps
+//! are `ramp_interval` apart plus a random jitter of up to half of it. Tasks
+//! are started in the order of the QoS directions: foreground applications
+//! first, then the order each application selected for its tasks. The tasks
+//! of foreground applications are never held back. The ramp closes with the
+//! first reschedule that holds back no task.
+
+use std::collections::HashSet;
+
+use ylong_runtime::fastrand::fast_random;
+
+use crate::utils::metrics;
+
+/// Tasks started per step if the build does not set it.
+const DEFAULT_RAMP_STEP: usize = 4;
+
+/// Milliseconds between two steps if the build does not set it.
+const DEFAULT_RAMP_INTERVAL: u64 = 1000;
+
+/// Returns the number of restored tasks started per step.
+fn ramp_step() -> usize {
+    option_env!("REQUEST_RESTORE_RAMP_STEP")
+        .and_then(|step| step.parse().ok())
+        .filter(|step| *step > 0)
+        .unwrap_or(DEFAULT_RAMP_STEP)
+}
+
+/// Returns the milliseconds between two steps, before the jitter.
+fn ramp_interval() -> u64 {
+    option_env!("REQUEST_RESTORE_RAMP_INTERVAL_MS")
+        .and_then(|interval| interval.parse().ok())
+        .unwrap_or(DEFAULT_RAMP_INTERVAL)
+}
+
+/// Pace of the tasks started after the service started.
+pub(crate) struct RestoreRamp {
+    /// Time the ramp opened in milliseconds, `None` once it closed.
+    since: Option<u64>,
+    /// Tasks that may still be started in the current step.
+    left: usize,
+    /// Time the next step begins in milliseconds.
+    next_step: u64,
+    /// Whether the current reschedule held back a task.
+    held: bool,
+    /// Applications in the foreground, whose tasks are not held back.
+    foreground: HashSet<u64>,
+}
+
+impl RestoreRamp {
+    /// Creates a ramp opened at `now`, in milliseconds.
+    pub(crate) fn new(now: u64) -> Self {
+        Self {
+            since: Some(now),
+            left: 0,
+            next_step: now,
+            held: false,
+            foreground: HashSet::new(),
+        }
+    }
+
+    /// Whether started tasks are still paced.
+    pub(crate) fn is_open(&self) -> bool {
+        self.since.is_some()
+    }
+
+    /// Updates the applications in the foreground before a reschedule.
+    pub(crate) fn set_foreground(&mut self, foreground: &HashSet<u64>) {
+        self.foreground.clone_from(foreground);
+    }
+
+    /// Whether a task of `uid` that is not running yet may be started at
+    /// `now`, in milliseconds.
+    pub(crate) fn admit(&mut self, uid: u64, now: u64) -> bool {
+        let Some(since) = self.since else {
+            return true;
+        };
+        if !self.foreground.contains(&uid) {
+            if now >= self.next_step {
+                let interval = ramp_interval();
+                self.left = ramp_step();
+                self.next_step = now + interval + fast_random() % (interval / 2 + 1);
+            }
+            if self.left == 0 {
+                self.held = true;
+                return false;
+            }
+            self.left -= 1;
+        }
+        metrics::RESTORE_START_MS.record(now.saturating_sub(since));
+        true
+    }
+
+    /// Ends a reschedule at `now`, in milliseconds.
+    ///
+    /// # Returns
+    ///
+    /// The milliseconds until the next step if tasks were held back, which
+    /// then need a reschedule. Otherwise the ramp closes.
+    pub(crate) fn finish(&mut self, now: u64) -> Option<u64> {
+        let since = self.since?;
+        if std::mem::take(&mut self.held) {
+            return Some(self.next_step.saturating_sub(now));
+        }
+        info!("restore ramp closed after {} ms", now.saturating_sub(since));
+        self.since = None;
+        self.foreground = HashSet::new();
+        None
+    }
+}
+
+#[cfg(test)]
+mod ut_ramp {
+    include!("../../../tests/ut/manage/scheduler/ut_ramp.rs");
+}
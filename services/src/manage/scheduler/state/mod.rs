@@ -25,6 +25,9 @@ use ylong_runtime::task::JoinHandle;
 
 use super::qos::RssCapacity;
 use crate::manage::account;
+use crate::manage::database::RequestDb;
+use crate::manage::device_state::DeviceChange;
+use crate::manage::environment;
 use crate::manage::network::NetworkState;
 use crate::manage::network_manager::NetworkManager;
 use crate::manage::task_manager::TaskManagerTx;
@@ -111,13 +114,35 @@ impl Handler {
                     .collect(),
             )
         };
+        // Applications whose tasks wait for them, later foreground switches
+        // of other applications need no statement
+        let waiting_apps = RequestDb::get_instance()
+            .query_integer::<u64>(&sql::app_state_waiting_uids())
+            .into_iter()
+            .collect();
         // Initialize the state recorder with collected information
-        self.recorder.init(
+        let sql_list = self.recorder.init(
             network_info,
             foreground_abilities,
             foreground_account,
             active_accounts,
-        )
+            waiting_apps,
+        );
+        self.publish_foreground_abilities();
+        sql_list
+    }
+
+    /// Publishes the foreground applications to the environment snapshot of
+    /// the tasks if they changed.
+    fn publish_foreground_abilities(&self) {
+        let foreground_abilities = self.foreground_abilities();
+        environment::update(|env| {
+            if env.foreground_uids == *foreground_abilities {
+                return false;
+            }
+            env.foreground_uids = foreground_abilities.clone();
+            true
+        });
     }
 
     /// Updates the RSS (Resource Scheduling Service) level.
@@ -137,15 +162,13 @@ impl Handler {
     ///
     /// # Arguments
     ///
-    /// * `_a` - Unused parameter, placeholder for API consistency.
+    /// * `network` - The network state queried when the change was handled.
     ///
     /// # Returns
     ///
     /// SQL statements to update the database if network state changed.
-    pub(crate) fn update_network(&mut self, _a: ()) -> Option<SqlList> {
-        // Query current network state
-        let network_info = NetworkManager::query_network();
-        self.recorder.update_network(network_info)
+    pub(crate) fn update_network(&mut self, network: NetworkState) -> Option<SqlList> {
+        self.recorder.update_network(network)
     }
 
     /// Updates account state information.
@@ -172,7 +195,8 @@ impl Handler {
     ///
     /// # Returns
     ///
-    /// SQL statements to update the database if top UID changed.
+    /// SQL statements to update the database if top UID changed, none if no
+    /// task of the application waits for it.
     pub(crate) fn update_top_uid(&mut self, top_uid: u64) -> Option<SqlList> {
         // Skip if already tracked as foreground ability
         if self.foreground_abilities().contains(&top_uid) {
@@ -182,7 +206,9 @@ impl Handler {
         if let Some(handle) = self.background_timeout.remove(&top_uid) {
             handle.cancel();
         }
-        self.recorder.update_top_uid(top_uid)
+        let sql_list = self.recorder.update_top_uid(top_uid);
+        self.publish_foreground_abilities();
+        sql_list
     }
 
     /// Updates the background state for a UID.
@@ -211,6 +237,7 @@ impl Handler {
         );
         // Update background state in recorder
         self.recorder.update_background(uid);
+        self.publish_foreground_abilities();
         None
     }
 
@@ -227,6 +254,29 @@ impl Handler {
         self.recorder.update_background_timeout(uid)
     }
 
+    /// Records that a task of a background application was made to wait for
+    /// it to be in the foreground.
+    ///
+    /// # Arguments
+    ///
+    /// * `uid` - The UID of the application owning the task.
+    pub(crate) fn update_app_waiting(&mut self, uid: u64) {
+        self.recorder.update_app_waiting(uid);
+    }
+
+    /// Updates the charging or idle state of the device.
+    ///
+    /// # Arguments
+    ///
+    /// * `change` - The change of the device state.
+    ///
+    /// # Returns
+    ///
+    /// A reschedule if the prefetch window opened or closed.
+    pub(crate) fn update_device(&mut self, change: DeviceChange) -> Option<SqlList> {
+        self.recorder.update_device(change)
+    }
+
     /// Handles application uninstallation for a UID.
     ///
     /// # Arguments
@@ -284,4 +334,14 @@ impl Handler {
     pub(crate) fn network(&self) -> &NetworkState {
         &self.recorder.network
     }
+
+    /// Whether the prefetch window is open, prefetch tasks may run.
+    pub(crate) fn prefetch_window(&self) -> bool {
+        self.recorder.prefetch_window()
+    }
+
+    /// Whether the device is idle, its screen is off.
+    pub(crate) fn device_idle(&self) -> bool {
+        self.recorder.idle
+    }
 }
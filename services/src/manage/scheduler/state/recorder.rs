@@ -18,8 +18,9 @@
 //! and resource levels.
 use std::collections::HashSet;
 
-use super::sql::SqlList;
-use crate::manage::network::NetworkState;
+use super::sql::{QosUpdate, SqlList};
+use crate::manage::device_state::DeviceChange;
+use crate::manage::network::{NetworkState, NetworkType};
 use crate::manage::scheduler::qos::RssCapacity;
 
 /// Records and maintains current system state information.
@@ -28,6 +29,10 @@ use crate::manage::scheduler::qos::RssCapacity;
 pub(super) struct StateRecord {
     /// Set of UIDs currently in the foreground.
     pub(super) foreground_abilities: HashSet<u64>,
+    /// Set of UIDs that may have tasks waiting for them to be in the
+    /// foreground. Switching other applications to the foreground leaves the
+    /// database untouched.
+    pub(super) waiting_apps: HashSet<u64>,
     /// User ID currently in the foreground.
     pub(super) top_user: u64,
     /// Current network connection state.
@@ -36,6 +41,10 @@ pub(super) struct StateRecord {
     pub(super) active_accounts: HashSet<u64>,
     /// Current Resource Scheduling Service level.
     pub(super) rss_level: i32,
+    /// Whether the device is charging.
+    pub(super) charging: bool,
+    /// Whether the device is idle, its screen is off.
+    pub(super) idle: bool,
 }
 
 impl StateRecord {
@@ -47,10 +56,13 @@ impl StateRecord {
     pub(crate) fn new() -> Self {
         StateRecord {
             foreground_abilities: HashSet::new(),
+            waiting_apps: HashSet::new(),
             top_user: 0,
             network: NetworkState::Offline,
             active_accounts: HashSet::new(),
             rss_level: 0,
+            charging: false,
+            idle: false,
         }
     }
 
@@ -62,6 +74,8 @@ impl StateRecord {
     /// * `foreground_abilities` - Optional list of foreground application UIDs.
     /// * `foreground_account` - User ID currently in the foreground.
     /// * `active_accounts` - Set of currently active user accounts.
+    /// * `waiting_apps` - UIDs having tasks waiting for them to be in the
+    ///   foreground in the database.
     ///
     /// # Returns
     ///
@@ -72,6 +86,7 @@ impl StateRecord {
         foreground_abilities: Option<Vec<u64>>,
         foreground_account: u64,
         active_accounts: HashSet<u64>,
+        waiting_apps: HashSet<u64>,
     ) -> SqlList {
         let mut sql_list = SqlList::new();
         // Add network change SQL statement
@@ -87,6 +102,12 @@ impl StateRecord {
             }
         }
         
+        // Tasks of foreground applications stop waiting with the statements
+        self.waiting_apps = waiting_apps
+            .into_iter()
+            .filter(|uid| !self.foreground_abilities.contains(uid))
+            .collect();
+
         // Update internal state
         self.top_user = foreground_account;
         self.active_accounts = active_accounts;
@@ -175,12 +196,16 @@ impl StateRecord {
     ///
     /// # Returns
     ///
-    /// SQL statements to update the database with the new foreground application state.
+    /// SQL statements to update the database with the new foreground application state,
+    /// none if no task of the application waits for it.
     pub(crate) fn update_top_uid(&mut self, uid: u64) -> Option<SqlList> {
         info!("update top uid {}", uid);
-        let mut sql_list = SqlList::new();
-        sql_list.add_app_state_available(uid);
         self.foreground_abilities.insert(uid);
+        if !self.waiting_apps.remove(&uid) {
+            return Some(SqlList::with_qos_update(QosUpdate::Resort));
+        }
+        let mut sql_list = SqlList::with_qos_update(QosUpdate::ReloadApp(uid));
+        sql_list.add_app_state_available(uid);
         Some(sql_list)
     }
 
@@ -206,15 +231,66 @@ impl StateRecord {
     ///
     /// SQL statements to update the database if the UID is in background,
     /// or `None` if the UID is still in foreground.
-    pub(crate) fn update_background_timeout(&self, uid: u64) -> Option<SqlList> {
+    pub(crate) fn update_background_timeout(&mut self, uid: u64) -> Option<SqlList> {
         // Skip if the UID is still in foreground
         if self.foreground_abilities.contains(&uid) {
             return None;
         }
         
         info!("{} background timeout", uid);
-        let mut sql_list = SqlList::new();
+        self.waiting_apps.insert(uid);
+        let mut sql_list = SqlList::with_qos_update(QosUpdate::RemoveFrontend(uid));
         sql_list.add_app_state_unavailable(uid);
         Some(sql_list)
     }
+
+    /// Records that a task of a background application was made to wait for
+    /// it to be in the foreground.
+    ///
+    /// # Arguments
+    ///
+    /// * `uid` - The UID of the application owning the task.
+    pub(crate) fn update_app_waiting(&mut self, uid: u64) {
+        self.waiting_apps.insert(uid);
+    }
+
+    /// Whether prefetch tasks may run: the device is charging and idle, on
+    /// an unmetered Wi-Fi network.
+    pub(crate) fn prefetch_window(&self) -> bool {
+        let unmetered_wifi = match &self.network {
+            NetworkState::Online(info) => {
+                info.network_type == NetworkType::Wifi && !info.is_metered
+            }
+            NetworkState::Offline => false,
+        };
+        self.charging && self.idle && unmetered_wifi
+    }
+
+    /// Updates the charging or idle state of the device.
+    ///
+    /// # Arguments
+    ///
+    /// * `change` - The change of the device state.
+    ///
+    /// # Returns
+    ///
+    /// A reschedule if the prefetch window opened or closed, or `None` if it
+    /// did not.
+    pub(crate) fn update_device(&mut self, change: DeviceChange) -> Option<SqlList> {
+        let window = self.prefetch_window();
+        match change {
+            DeviceChange::Charging(charging) => self.charging = charging,
+            DeviceChange::Idle(idle) => self.idle = idle,
+        }
+        if self.prefetch_window() == window {
+            return None;
+        }
+        info!("prefetch window open {}", !window);
+        Some(SqlList::with_qos_update(QosUpdate::Resort))
+    }
+}
+
+#[cfg(test)]
+mod ut_recorder {
+    include!("../../../../tests/ut/manage/scheduler/state/ut_recorder.rs");
 }
@@ -56,6 +56,22 @@ const FRONTEND: u8 = Mode::FrontEnd.repr;
 const API9: u8 = Version::API9 as u8;
 const API10: u8 = Version::API10 as u8;
 
+/// Change of the QoS queue once the statements of a `SqlList` were written.
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub(crate) enum QosUpdate {
+    /// The tasks of any application may have changed, all are reloaded.
+    ReloadAll,
+    /// Only the tasks of the application with this UID may have been made
+    /// runnable, they alone are reloaded.
+    ReloadApp(u64),
+    /// The frontend tasks of the application with this UID stopped being
+    /// runnable, they are removed without reading the database.
+    RemoveFrontend(u64),
+    /// No task changed but the order of the applications, the tasks are
+    /// only rescheduled.
+    Resort,
+}
+
 /// Collection of SQL statements for database updates.
 ///
 /// This struct provides methods to generate and store SQL statements that update
@@ -63,6 +79,8 @@ const API10: u8 = Version::API10 as u8;
 pub(crate) struct SqlList {
     /// Internal storage for SQL statements.
     sqls: Vec<String>,
+    /// Change of the QoS queue following the statements.
+    qos_update: QosUpdate,
 }
 
 impl SqlList {
@@ -70,9 +88,32 @@ impl SqlList {
     ///
     /// # Returns
     ///
-    /// A new `SqlList` with an empty statement collection.
+    /// A new `SqlList` with an empty statement collection, after which all
+    /// tasks are reloaded.
     pub(crate) fn new() -> Self {
-        SqlList { sqls: Vec::new() }
+        SqlList {
+            sqls: Vec::new(),
+            qos_update: QosUpdate::ReloadAll,
+        }
+    }
+
+    /// Creates a new empty collection of SQL statements followed by
+    /// `qos_update` of the QoS queue.
+    pub(crate) fn with_qos_update(qos_update: QosUpdate) -> Self {
+        SqlList {
+            sqls: Vec::new(),
+            qos_update,
+        }
+    }
+
+    /// Returns the change of the QoS queue once the statements were written.
+    pub(crate) fn qos_update(&self) -> QosUpdate {
+        self.qos_update
+    }
+
+    /// Returns `true` if there is no statement to write.
+    pub(crate) fn is_empty(&self) -> bool {
+        self.sqls.is_empty()
     }
 
     /// Adds SQL statements for network state changes.
@@ -214,6 +255,19 @@ pub(crate) fn app_state_unavailable(uid: u64) -> String {
     )
 }
 
+/// Generates SQL to query the applications having tasks that wait for them to
+/// be in the foreground.
+///
+/// # Returns
+///
+/// SQL statement selecting the distinct UIDs of the waiting tasks whose
+/// reason includes the application state.
+pub(crate) fn app_state_waiting_uids() -> String {
+    format!(
+        "SELECT DISTINCT uid FROM request_task WHERE state = {WAITING} AND reason IN ({APP_BACKGROUND_OR_TERMINATE}, {NETWORK_APP}, {APP_ACCOUNT}, {NETWORK_APP_ACCOUNT})",
+    )
+}
+
 /// Generates SQL to update task states when an application becomes available.
 ///
 /// # Arguments
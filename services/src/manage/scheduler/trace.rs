@@ -0,0 +1,246 @@
+// Copyright (C) 2024 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Trace of the scheduling decisions.
+//!
+//! Every reschedule records what triggered it, how many tasks the QoS gave
+//! each speed tier, how many tasks it started and stopped and how long it
+//! took. The last `TRACE_CAPACITY` decisions are kept, and the time taken is
+//! also counted in a latency histogram per trigger. Both are shown by the
+//! `-s` option of hidumper.
+
+use std::collections::VecDeque;
+use std::fmt::Write;
+
+use super::qos::{QosChanges, QosLevel};
+
+/// Number of decisions kept in the trace.
+pub(crate) const TRACE_CAPACITY: usize = 64;
+
+/// Number of buckets of a latency histogram. Bucket `i` counts decisions
+/// taking less than `2^i` microseconds, the last one all the slower ones.
+pub(crate) const LATENCY_BUCKETS: usize = 16;
+
+/// Event that caused a reschedule.
+///
+/// Events arriving while a reschedule is pending are merged into it, which is
+/// then traced with the first of them.
+#[derive(Clone, Copy, PartialEq, Eq, Debug)]
+pub(crate) enum Trigger {
+    /// Tasks were restored at startup.
+    Restore = 0,
+    /// A task was started or resumed.
+    Start,
+    /// A task was paused.
+    Pause,
+    /// A task was removed.
+    Remove,
+    /// A task was stopped.
+    Stop,
+    /// A task finished.
+    Complete,
+    /// A task failed.
+    Fail,
+    /// Tasks timed out.
+    Timeout,
+    /// The mode or schedule policy of tasks changed.
+    Config,
+    /// The network, account or foreground application changed.
+    SystemState,
+    /// The resource schedule level changed.
+    Rss,
+    /// The measured bandwidth changed the QoS zones.
+    Bandwidth,
+    /// A task neared its deadline.
+    Deadline,
+}
+
+/// All triggers, in the order of their histograms.
+const TRIGGERS: [Trigger; 13] = [
+    Trigger::Restore,
+    Trigger::Start,
+    Trigger::Pause,
+    Trigger::Remove,
+    Trigger::Stop,
+    Trigger::Complete,
+    Trigger::Fail,
+    Trigger::Timeout,
+    Trigger::Config,
+    Trigger::SystemState,
+    Trigger::Rss,
+    Trigger::Bandwidth,
+    Trigger::Deadline,
+];
+
+impl Trigger {
+    /// Returns the name of the trigger shown in the dump.
+    pub(crate) fn name(&self) -> &'static str {
+        match self {
+            Trigger::Restore => "restore",
+            Trigger::Start => "start",
+            Trigger::Pause => "pause",
+            Trigger::Remove => "remove",
+            Trigger::Stop => "stop",
+            Trigger::Complete => "complete",
+            Trigger::Fail => "fail",
+            Trigger::Timeout => "timeout",
+            Trigger::Config => "config",
+            Trigger::SystemState => "system",
+            Trigger::Rss => "rss",
+            Trigger::Bandwidth => "bandwidth",
+            Trigger::Deadline => "deadline",
+        }
+    }
+}
+
+/// Number of tasks the QoS gave each speed tier.
+#[derive(Clone, Copy, Default, PartialEq, Eq, Debug)]
+pub(crate) struct Tiers {
+    /// Tasks running at full speed.
+    pub(crate) high: usize,
+    /// Tasks limited to the middle speed.
+    pub(crate) middle: usize,
+    /// Tasks limited to the low speed.
+    pub(crate) low: usize,
+}
+
+impl Tiers {
+    /// Counts the tasks of each tier in the QoS changes of both actions.
+    pub(crate) fn of(changes: &QosChanges) -> Self {
+        let mut tiers = Tiers::default();
+        let directions = changes.download.iter().chain(changes.upload.iter());
+        for direction in directions.flatten() {
+            match direction.direction() {
+                QosLevel::High => tiers.high += 1,
+                QosLevel::Middle => tiers.middle += 1,
+                QosLevel::Low => tiers.low += 1,
+            }
+        }
+        tiers
+    }
+}
+
+/// Tasks the running queue started and stopped in a reschedule.
+#[derive(Clone, Copy, Default, PartialEq, Eq, Debug)]
+pub(crate) struct Moves {
+    /// Tasks loaded into the running queue.
+    pub(crate) promoted: usize,
+    /// Running tasks cancelled as they lost their place.
+    pub(crate) demoted: usize,
+}
+
+/// A traced reschedule.
+#[derive(Clone, Copy, Debug)]
+pub(crate) struct Decision {
+    /// Time of the reschedule, in milliseconds since the epoch.
+    pub(crate) time: u64,
+    /// Event that caused the reschedule.
+    pub(crate) trigger: Trigger,
+    /// Tasks given each speed tier.
+    pub(crate) tiers: Tiers,
+    /// Tasks started and stopped.
+    pub(crate) moves: Moves,
+    /// Time the reschedule took, in microseconds.
+    pub(crate) elapsed: u64,
+}
+
+/// The last decisions and the latency histogram of each trigger.
+pub(crate) struct DecisionTrace {
+    decisions: VecDeque<Decision>,
+    histograms: [[u64; LATENCY_BUCKETS]; TRIGGERS.len()],
+}
+
+impl DecisionTrace {
+    /// Creates an empty trace.
+    pub(crate) fn new() -> Self {
+        Self {
+            decisions: VecDeque::with_capacity(TRACE_CAPACITY),
+            histograms: [[0; LATENCY_BUCKETS]; TRIGGERS.len()],
+        }
+    }
+
+    /// Records a decision, dropping the oldest one if the trace is full.
+    pub(crate) fn record(&mut self, decision: Decision) {
+        if self.decisions.len() == TRACE_CAPACITY {
+            self.decisions.pop_front();
+        }
+        self.histograms[decision.trigger as usize][latency_bucket(decision.elapsed)] += 1;
+        self.decisions.push_back(decision);
+    }
+
+    /// Returns the traced decisions, oldest first.
+    pub(crate) fn decisions(&self) -> impl Iterator<Item = &Decision> {
+        self.decisions.iter()
+    }
+
+    /// Returns the latency histogram of a trigger.
+    pub(crate) fn histogram(&self, trigger: Trigger) -> &[u64; LATENCY_BUCKETS] {
+        &self.histograms[trigger as usize]
+    }
+
+    /// Formats the trace and the histograms of the triggers seen for dumping.
+    pub(crate) fn dump(&self) -> String {
+        let mut out = String::new();
+        let _ = writeln!(out, "decision num: {}", self.decisions.len());
+        let _ = writeln!(
+            out,
+            "{:<16}{:<12}{:<8}{:<8}{:<8}{:<10}{:<10}{:<12}",
+            "time", "trigger", "high", "middle", "low", "promoted", "demoted", "elapsed(us)"
+        );
+        for decision in self.decisions.iter() {
+            let _ = writeln!(
+                out,
+                "{:<16}{:<12}{:<8}{:<8}{:<8}{:<10}{:<10}{:<12}",
+                decision.time,
+                decision.trigger.name(),
+                decision.tiers.high,
+                decision.tiers.middle,
+                decision.tiers.low,
+                decision.moves.promoted,
+                decision.moves.demoted,
+                decision.elapsed
+            );
+        }
+        let _ = writeln!(out, "latency histogram (us, upper bound: count):");
+        for trigger in TRIGGERS {
+            let histogram = self.histogram(trigger);
+            if histogram.iter().all(|count| *count == 0) {
+                continue;
+            }
+            let _ = write!(out, "{:<12}", trigger.name());
+            for (bucket, count) in histogram.iter().enumerate() {
+                if *count == 0 {
+                    continue;
+                }
+                if bucket == LATENCY_BUCKETS - 1 {
+                    let _ = write!(out, " inf:{}", count);
+                } else {
+                    let _ = write!(out, " {}:{}", 1u64 << bucket, count);
+                }
+            }
+            let _ = writeln!(out);
+        }
+        out
+    }
+}
+
+/// Returns the histogram bucket of a latency in microseconds.
+fn latency_bucket(elapsed: u64) -> usize {
+    let bucket = (u64::BITS - elapsed.leading_zeros()) as usize;
+    bucket.min(LATENCY_BUCKETS - 1)
+}
+
+#[cfg(test)]
+mod ut_trace {
+    include!("../../../tests/ut/manage/scheduler/ut_trace.rs");
+}
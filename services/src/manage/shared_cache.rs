@@ -0,0 +1,331 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Cache of resources shared by applications.
+//!
+//! Preloads that opt in publish the bodies they downloaded here and look
+//! their URLs up here before using the network, so a resource common to
+//! several applications is downloaded and stored once. Bodies are stored by
+//! their SHA-256 digest, computed by the service, and indexed by URL.
+//!
+//! An application is always served what it published itself. Other
+//! applications are only served an entry once a second application
+//! published the same body for the same URL, so no single application can
+//! plant content for the others. Every application owns the entries it
+//! published first, within a quota, and the least recently used entries are
+//! evicted beyond the size of the cache.
+
+use std::fs::{self, File};
+use std::io::{self, Read, Write};
+use std::path::{Path, PathBuf};
+use std::sync::{LazyLock, Mutex};
+
+use request_utils::hash::Sha256;
+use request_utils::lru::LRUCache;
+
+use crate::error::ErrorCode;
+
+/// Directory of the shared cache.
+const SHARED_CACHE_DIR: &str = "/data/service/el1/public/request/shared_cache";
+
+/// Index of the entries, from the least to the most recently used.
+const INDEX_FILE: &str = "index";
+
+/// Largest body kept in the shared cache.
+pub(crate) const ENTRY_MAX_SIZE: u64 = 4 * 1024 * 1024;
+
+/// Size of all the bodies kept in the shared cache.
+const TOTAL_MAX_SIZE: u64 = 128 * 1024 * 1024;
+
+/// Size of the bodies an application may own.
+const APP_QUOTA: u64 = 32 * 1024 * 1024;
+
+/// Applications that must publish the same body before it is served to
+/// applications that did not publish it.
+const CONFIRMATIONS: usize = 2;
+
+/// Shared cache of the service.
+pub(crate) static SHARED_CACHE: LazyLock<SharedCache> =
+    LazyLock::new(|| SharedCache::new(PathBuf::from(SHARED_CACHE_DIR)));
+
+/// Body cached for a URL.
+#[derive(Clone, Debug, PartialEq, Eq)]
+struct Entry {
+    /// Hex SHA-256 digest of the body, also the name of its file.
+    digest: String,
+    /// Size of the body.
+    size: u64,
+    /// Applications that published the body, the first one owns it.
+    uids: Vec<u64>,
+}
+
+impl Entry {
+    fn servable_to(&self, uid: u64) -> bool {
+        self.uids.len() >= CONFIRMATIONS || self.uids.contains(&uid)
+    }
+}
+
+/// Content-addressed cache of bodies shared by applications.
+pub(crate) struct SharedCache {
+    dir: PathBuf,
+    /// Entries by URL, `None` until the index is loaded.
+    entries: Mutex<Option<LRUCache<String, Entry>>>,
+}
+
+impl SharedCache {
+    pub(crate) fn new(dir: PathBuf) -> Self {
+        Self {
+            dir,
+            entries: Mutex::new(None),
+        }
+    }
+
+    /// Opens the cached body of a URL for an application, read only.
+    ///
+    /// Returns `None` if no body is cached for the URL or if it cannot be
+    /// served to the application yet.
+    pub(crate) fn open(&self, uid: u64, url: &str) -> Option<File> {
+        let mut guard = self.entries.lock().unwrap();
+        let entries = guard.get_or_insert_with(|| load_index(&self.dir));
+        let key = url.to_string();
+        let digest = match entries.get(&key) {
+            Some(entry) if entry.servable_to(uid) => entry.digest.clone(),
+            Some(_) => {
+                debug!("shared cache entry not confirmed for {}", uid);
+                return None;
+            }
+            None => return None,
+        };
+        match File::open(self.dir.join(&digest)) {
+            Ok(file) => Some(file),
+            Err(e) => {
+                error!("shared cache open {} failed {}", digest, e);
+                entries.remove(&key);
+                self.release(entries, &digest);
+                self.store_index(entries);
+                None
+            }
+        }
+    }
+
+    /// Publishes the body an application downloaded for a URL.
+    ///
+    /// The body is read from `file` and stored under its own digest. The
+    /// same body published again by another application confirms the entry,
+    /// a different body replaces it.
+    ///
+    /// # Errors
+    ///
+    /// Returns `ErrorCode::ParameterCheck` if the body exceeds
+    /// `ENTRY_MAX_SIZE` or the quota of the application, and
+    /// `ErrorCode::FileOperationErr` if it cannot be stored.
+    pub(crate) fn publish(&self, uid: u64, url: &str, mut file: File) -> Result<(), ErrorCode> {
+        let mut body = Vec::new();
+        (&mut file)
+            .take(ENTRY_MAX_SIZE + 1)
+            .read_to_end(&mut body)
+            .map_err(|e| {
+                error!("shared cache read body failed {}", e);
+                ErrorCode::FileOperationErr
+            })?;
+        let size = body.len() as u64;
+        if size > ENTRY_MAX_SIZE || size > APP_QUOTA {
+            error!("shared cache body of {} too large", uid);
+            return Err(ErrorCode::ParameterCheck);
+        }
+        let mut sha256 = Sha256::new();
+        sha256.update(&body);
+        let digest = hex(&sha256.finish());
+
+        let mut guard = self.entries.lock().unwrap();
+        let entries = guard.get_or_insert_with(|| load_index(&self.dir));
+        let key = url.to_string();
+        if let Some(entry) = entries.get_mut(&key) {
+            if entry.digest == digest {
+                if !entry.uids.contains(&uid) {
+                    entry.uids.push(uid);
+                    info!("shared cache entry confirmed by {}", uid);
+                    self.store_index(entries);
+                }
+                return Ok(());
+            }
+        }
+        if let Some(old) = entries.remove(&key) {
+            info!("shared cache entry replaced by {}", uid);
+            self.release(entries, &old.digest);
+        }
+
+        // Make room within the quota of the application, then the cache
+        evict_while(
+            entries,
+            |entries| owned(entries, uid) + size > APP_QUOTA,
+            Some(uid),
+        )
+        .into_iter()
+        .for_each(|digest| self.release(entries, &digest));
+        evict_while(
+            entries,
+            |entries| total(entries) + size > TOTAL_MAX_SIZE,
+            None,
+        )
+        .into_iter()
+        .for_each(|digest| self.release(entries, &digest));
+
+        self.store_body(&digest, &body).map_err(|e| {
+            error!("shared cache store body failed {}", e);
+            ErrorCode::FileOperationErr
+        })?;
+        entries.insert(
+            key,
+            Entry {
+                digest,
+                size,
+                uids: vec![uid],
+            },
+        );
+        self.store_index(entries);
+        Ok(())
+    }
+
+    /// Writes a body to its file unless another entry already stored it.
+    fn store_body(&self, digest: &str, body: &[u8]) -> io::Result<()> {
+        let path = self.dir.join(digest);
+        if path.exists() {
+            return Ok(());
+        }
+        fs::create_dir_all(&self.dir)?;
+        let tmp = self.dir.join(format!("{}.tmp", digest));
+        let mut file = File::create(&tmp)?;
+        file.write_all(body)?;
+        file.sync_all()?;
+        fs::rename(tmp, path)
+    }
+
+    /// Deletes the file of a body no entry refers to anymore.
+    fn release(&self, entries: &LRUCache<String, Entry>, digest: &str) {
+        if entries.values().any(|entry| entry.digest == digest) {
+            return;
+        }
+        if let Err(e) = fs::remove_file(self.dir.join(digest)) {
+            error!("shared cache remove {} failed {}", digest, e);
+        }
+    }
+
+    /// Rewrites the index, which is small, through a temporary file.
+    fn store_index(&self, entries: &LRUCache<String, Entry>) {
+        let mut index = String::new();
+        for (url, entry) in entries.keys().zip(entries.values()) {
+            let uids = entry
+                .uids
+                .iter()
+                .map(u64::to_string)
+                .collect::<Vec<_>>()
+                .join(",");
+            index.push_str(&format!(
+                "{} {} {} {}\n",
+                entry.digest, entry.size, uids, url
+            ));
+        }
+        let tmp = self.dir.join(format!("{}.tmp", INDEX_FILE));
+        let result = fs::create_dir_all(&self.dir)
+            .and_then(|()| fs::write(&tmp, index))
+            .and_then(|()| fs::rename(&tmp, self.dir.join(INDEX_FILE)));
+        if let Err(e) = result {
+            error!("shared cache store index failed {}", e);
+        }
+    }
+}
+
+/// Reads the index of a cache directory, skipping malformed lines.
+fn load_index(dir: &Path) -> LRUCache<String, Entry> {
+    let mut entries = LRUCache::new();
+    let Ok(index) = fs::read_to_string(dir.join(INDEX_FILE)) else {
+        return entries;
+    };
+    for line in index.lines() {
+        let mut fields = line.splitn(4, ' ');
+        let (Some(digest), Some(size), Some(uids), Some(url)) =
+            (fields.next(), fields.next(), fields.next(), fields.next())
+        else {
+            continue;
+        };
+        let (Ok(size), Ok(uids)) = (
+            size.parse::<u64>(),
+            uids.split(',')
+                .map(str::parse::<u64>)
+                .collect::<Result<Vec<_>, _>>(),
+        ) else {
+            continue;
+        };
+        entries.insert(
+            url.to_string(),
+            Entry {
+                digest: digest.to_string(),
+                size,
+                uids,
+            },
+        );
+    }
+    info!("shared cache loaded {} entries", entries.len());
+    entries
+}
+
+/// Evicts the least recently used entries, of `owner` only if given, while
+/// `over` holds. Returns the digests of the evicted entries.
+fn evict_while<F>(entries: &mut LRUCache<String, Entry>, over: F, owner: Option<u64>) -> Vec<String>
+where
+    F: Fn(&LRUCache<String, Entry>) -> bool,
+{
+    let mut evicted = Vec::new();
+    while over(entries) {
+        let url = entries
+            .keys()
+            .zip(entries.values())
+            .find(|(_, entry)| owner.map_or(true, |uid| entry.uids[0] == uid))
+            .map(|(url, _)| url.clone());
+        let Some(entry) = url.and_then(|url| entries.remove(&url)) else {
+            break;
+        };
+        evicted.push(entry.digest);
+    }
+    evicted
+}
+
+/// Size of the bodies an application owns.
+fn owned(entries: &LRUCache<String, Entry>, uid: u64) -> u64 {
+    entries
+        .values()
+        .filter(|entry| entry.uids[0] == uid)
+        .map(|entry| entry.size)
+        .sum()
+}
+
+/// Size of the bodies kept, each file counted once.
+fn total(entries: &LRUCache<String, Entry>) -> u64 {
+    let mut digests = entries
+        .values()
+        .map(|entry| (&entry.digest, entry.size))
+        .collect::<Vec<_>>();
+    digests.sort();
+    digests.dedup();
+    digests.iter().map(|(_, size)| size).sum()
+}
+
+fn hex(bytes: &[u8]) -> String {
+    bytes.iter().map(|b| format!("{:02x}", b)).collect()
+}
+
+#[cfg(test)]
+mod ut_shared_cache {
+    include!("../../tests/ut/manage/ut_shared_cache.rs");
+}
@@ -23,7 +23,6 @@ use std::time::Duration;
 
 use samgr::definition::COMM_NET_CONN_MANAGER_SYS_ABILITY_ID;
 use ylong_runtime::sync::mpsc::{unbounded_channel, UnboundedReceiver, UnboundedSender};
-use ylong_runtime::sync::oneshot;
 use ylong_runtime::time::sleep;
 
 cfg_oh! {
@@ -33,14 +32,15 @@ cfg_oh! {
 }
 use super::account::{remove_account_tasks, AccountEvent};
 use super::database::RequestDb;
-use super::events::{
-    QueryEvent, ScheduleEvent, ServiceEvent, StateEvent, TaskEvent, TaskManagerEvent,
-};
+use super::events::{ScheduleEvent, ServiceEvent, StateEvent, TaskEvent, TaskManagerEvent};
 use crate::config::{Action, Mode};
-use crate::database::clear_database_part;
+use crate::database::{self, clear_database_part, REAP_CHUNK_ROWS};
 use crate::error::ErrorCode;
-use crate::info::{State, TaskInfo};
+use crate::info::State;
 use crate::manage::app_state::AppUninstallSubscriber;
+use crate::manage::db_worker::DbWorker;
+use crate::manage::device_state::{BatterySubscriber, ScreenSubscriber};
+use crate::manage::keep_alive::keep_alive_until;
 use crate::manage::network::register_network_change;
 use crate::manage::network_manager::NetworkManager;
 use crate::manage::query::TaskFilter;
@@ -50,12 +50,17 @@ use crate::service::active_counter::ActiveCounter;
 use crate::service::client::ClientManagerEntry;
 use crate::service::notification_bar::{subscribe_notification_bar, NotificationDispatcher};
 use crate::service::run_count::RunCountManagerEntry;
+use crate::task::dns::warm_recent_hosts;
+use crate::utils::startup;
 use crate::utils::task_event_count::{task_complete_add, task_fail_add, task_unload};
 use crate::utils::{get_current_timestamp, runtime_spawn, subscribe_common_event, update_policy};
 
 /// Interval (in seconds) for clearing timeout tasks.
 const CLEAR_INTERVAL: u64 = 30 * 60;
 
+/// Interval (in seconds) between two ticks of the expired tasks reaper.
+const REAP_INTERVAL: u64 = 60;
+
 /// Interval (in seconds) before restoring all tasks after service initialization.
 const RESTORE_ALL_TASKS_INTERVAL: u64 = 10;
 
@@ -110,8 +115,20 @@ impl TaskManager {
         let tx = TaskManagerTx::new(tx);
         let rx = TaskManagerRx::new(rx);
 
+        // Retried until the account service answers, which the other
+        // subsystems do not wait for
         #[cfg(feature = "oh")]
-        registry_account_subscribe(tx.clone());
+        {
+            let tx = tx.clone();
+            let spawned = std::thread::Builder::new()
+                .name("RequestAccount".to_string())
+                .spawn(move || {
+                    startup::measure(startup::Phase::Account, || registry_account_subscribe(tx))
+                });
+            if let Err(e) = spawned {
+                error!("spawn account subscriber failed {:?}", e);
+            }
+        }
 
         #[cfg(feature = "oh")]
         {
@@ -147,6 +164,25 @@ impl TaskManager {
             );
         }
 
+        // Device state opening the prefetch window
+        let device_subscriptions = [
+            subscribe_common_event(
+                vec!["usual.event.BATTERY_CHANGED"],
+                BatterySubscriber::new(tx.clone()),
+            ),
+            subscribe_common_event(
+                vec!["usual.event.SCREEN_OFF"],
+                ScreenSubscriber::new(tx.clone(), true),
+            ),
+            subscribe_common_event(
+                vec!["usual.event.SCREEN_ON"],
+                ScreenSubscriber::new(tx.clone(), false),
+            ),
+        ];
+        for e in device_subscriptions.into_iter().filter_map(Result::err) {
+            error!("Subscribe device state event failed: {}", e);
+        }
+
         let task_manager = Self::new(
             tx.clone(),
             rx,
@@ -170,7 +206,11 @@ impl TaskManager {
         // startup logic of the new task.
         runtime_spawn(restore_all_tasks(tx.clone()));
 
+        // The DNS cache was lost with the last unload of the service
+        DbWorker::get_instance().post(warm_recent_hosts);
+
         runtime_spawn(clear_timeout_tasks(tx.clone()));
+        runtime_spawn(reap_expired_tasks(tx.clone()));
         runtime_spawn(task_manager.run());
         tx
     }
@@ -213,8 +253,7 @@ impl TaskManager {
     /// Continuously receives and processes events, delegating to specialized
     /// handlers based on event type.
     async fn run(mut self) {
-        let db = RequestDb::get_instance();
-        db.clear_invalid_records();
+        DbWorker::get_instance().post(|| RequestDb::get_instance().clear_invalid_records());
         loop {
             let event = match self.rx.recv().await {
                 Ok(event) => event,
@@ -238,7 +277,6 @@ impl TaskManager {
                     self.scheduler.on_rss_change(level);
                 }
                 TaskManagerEvent::Account(event) => self.handle_account_event(event),
-                TaskManagerEvent::Query(query) => self.handle_query_event(query),
                 TaskManagerEvent::Reschedule => self.scheduler.reschedule(),
             }
 
@@ -300,12 +338,18 @@ impl TaskManager {
             ServiceEvent::DumpOne(task_id, tx) => {
                 let _ = tx.send(self.query_one_task(task_id));
             }
+            ServiceEvent::DumpTrace(tx) => {
+                let _ = tx.send(self.scheduler.dump_trace());
+            }
             ServiceEvent::AttachGroup(uid, task_ids, group, tx) => {
                 let _ = tx.send(self.attach_group(uid, task_ids, group));
             }
             ServiceEvent::SetMode(uid, task_id, mode, tx) => {
                 let _ = tx.send(self.set_mode(uid, task_id, mode));
             }
+            ServiceEvent::SetSchedulePolicy(uid, policy, tx) => {
+                let _ = tx.send(self.set_schedule_policy(uid, policy));
+            }
         }
     }
 
@@ -322,8 +366,7 @@ impl TaskManager {
 
         match event {
             StateEvent::Network => {
-                self.scheduler.retry_all_tasks();
-                self.scheduler.on_state_change(Handler::update_network, ());
+                self.scheduler.on_network_change();
             }
 
             StateEvent::ForegroundApp(uid) => {
@@ -337,11 +380,19 @@ impl TaskManager {
                 .on_state_change(Handler::update_background_timeout, uid),
             StateEvent::AppUninstall(uid) => {
                 self.scheduler.on_state_change(Handler::app_uninstall, uid);
+                // Forget the tasks after the worker removed them
+                DbWorker::get_instance().post(move || {
+                    RequestDb::get_instance().forget_tasks_if(|meta| meta.uid == uid)
+                });
             }
             StateEvent::SpecialTerminate(uid) => {
                 self.scheduler
                     .on_state_change(Handler::special_process_terminate, uid);
             }
+            StateEvent::Device(change) => {
+                self.scheduler
+                    .on_state_change(Handler::update_device, change);
+            }
         }
     }
 
@@ -401,6 +452,12 @@ impl TaskManager {
             ScheduleEvent::RestoreAllTasks => self.restore_all_tasks(),
             ScheduleEvent::Unload => return self.unload_sa(),
             ScheduleEvent::Shutdown => self.shutdown(),
+            ScheduleEvent::UpdateQos(qos_update) => self.scheduler.update_qos(qos_update),
+            ScheduleEvent::TimeoutTasksStopped(tasks) => {
+                self.scheduler.timeout_tasks_stopped(tasks)
+            }
+            ScheduleEvent::ReapExpiredTasks => self.reap_expired_tasks(),
+            ScheduleEvent::SampleBandwidth => self.scheduler.sample_bandwidth(),
         }
         false
     }
@@ -429,6 +486,7 @@ impl TaskManager {
     /// Terminates all ongoing tasks and prepares for service shutdown.
     fn shutdown(&mut self) {
         self.scheduler.shutdown();
+        RequestDb::get_instance().flush_progress();
     }
 
     /// Clears tasks that have timed out.
@@ -439,11 +497,31 @@ impl TaskManager {
         self.scheduler.clear_timeout_tasks();
     }
 
+    /// Deletes a chunk of expired tasks and maintains the database while the
+    /// service is idle.
+    /// 
+    /// While tasks are running the database is only maintained if the device
+    /// is idle, and then without deleting or blocking their writes. The work
+    /// runs on the database worker, so a task started meanwhile is not
+    /// delayed by it.
+    fn reap_expired_tasks(&mut self) {
+        let tasks_running = self.check_any_tasks();
+        if tasks_running && !self.scheduler.device_idle() {
+            return;
+        }
+        DbWorker::get_instance().post(move || {
+            if !tasks_running {
+                let _ = database::reap_expired_tasks(REAP_CHUNK_ROWS);
+            }
+            database::maintain(tasks_running);
+        });
+    }
+
     /// Restores all tasks from the database.
     /// 
     /// Delegates to the scheduler to reload and resume tasks that were saved in the database.
     fn restore_all_tasks(&mut self) {
-        self.scheduler.restore_all_tasks();
+        startup::restored(|| self.scheduler.restore_all_tasks());
     }
 
     /// Checks if there are any running tasks or pending events.
@@ -471,7 +549,8 @@ impl TaskManager {
     /// Unloads the system ability.
     /// 
     /// Cleans up resources, removes old tasks from the database, and unloads the system ability
-    /// if there are no running tasks or pending events.
+    /// if there are no running tasks or pending events and no user is expected to create a
+    /// task soon, see `keep_alive_until`.
     /// 
     /// # Returns
     /// 
@@ -481,6 +560,13 @@ impl TaskManager {
             return false;
         }
 
+        // Users expected to create a task soon would pay the load of the
+        // service again, the unload is retried after the next countdown.
+        if let Some(until) = keep_alive_until(get_current_timestamp()) {
+            info!("keep SA alive until {}", until);
+            return false;
+        }
+
         const TIMES: usize = 10;
         const PRE_COUNT: usize = 1000;
 
@@ -506,6 +592,7 @@ impl TaskManager {
             state: State::Waiting.repr,
             action: Action::Any.repr,
             mode: Mode::Any.repr,
+            keyword: String::new(),
         };
 
         let bundle_name = "*".to_string();
@@ -539,6 +626,15 @@ mod ffi {
         pub(crate) mode: u8,
         pub(crate) state: u8,
         pub(crate) priority: u32,
+        /// Bytes left to transfer, -1 if the size of a file is unknown.
+        pub(crate) remaining: i64,
+        /// Time in milliseconds since the epoch the task should be done by, 0
+        /// for none.
+        pub(crate) deadline: u64,
+        /// The user ID of the application owning the task.
+        pub(crate) uid: u64,
+        /// Whether the task waits for the prefetch window.
+        pub(crate) prefetch: bool,
     }
 
     // C++ interface includes
@@ -632,79 +728,6 @@ impl TaskManagerTx {
     pub(crate) fn notify_special_process_terminate(&self, uid: u64) {
         let _ = self.send_event(TaskManagerEvent::State(StateEvent::SpecialTerminate(uid)));
     }
-
-    /// Retrieves task information for a specific user.
-    /// 
-    /// # Arguments
-    /// 
-    /// * `uid` - The user ID to verify ownership
-    /// * `task_id` - The ID of the task to retrieve
-    /// 
-    /// # Returns
-    /// 
-    /// Returns `Some(TaskInfo)` if the task exists and is owned by the specified user,
-    /// otherwise `None`
-    pub(crate) fn show(&self, uid: u64, task_id: u32) -> Option<TaskInfo> {
-        let (tx, rx) = oneshot::channel();
-        let event = QueryEvent::Show(task_id, uid, tx);
-        let _ = self.send_event(TaskManagerEvent::Query(event));
-        match ylong_runtime::block_on(rx) {
-            Ok(task_info) => task_info,
-            Err(error) => {
-                error!("In `show`, block on failed, err {}", error);
-                None
-            }
-        }
-    }
-
-    /// Queries task information with action permission checking.
-    /// 
-    /// # Arguments
-    /// 
-    /// * `task_id` - The ID of the task to retrieve
-    /// * `action` - The action to check permissions against
-    /// 
-    /// # Returns
-    /// 
-    /// Returns `Some(TaskInfo)` with sensitive data sanitized if the task exists and
-    /// the action has sufficient permissions, otherwise `None`
-    pub(crate) fn query(&self, task_id: u32, action: Action) -> Option<TaskInfo> {
-        let (tx, rx) = oneshot::channel();
-        let event = QueryEvent::Query(task_id, action, tx);
-        let _ = self.send_event(TaskManagerEvent::Query(event));
-        match ylong_runtime::block_on(rx) {
-            Ok(task_info) => task_info,
-            Err(error) => {
-                error!("In `query`, block on failed, err {}", error);
-                None
-            }
-        }
-    }
-
-    /// Retrieves task information with token authentication.
-    /// 
-    /// # Arguments
-    /// 
-    /// * `uid` - The user ID to verify ownership
-    /// * `task_id` - The ID of the task to retrieve
-    /// * `token` - The authentication token for the task
-    /// 
-    /// # Returns
-    /// 
-    /// Returns `Some(TaskInfo)` with the bundle name sanitized if the task exists,
-    /// is owned by the specified user, and the token matches, otherwise `None`
-    pub(crate) fn touch(&self, uid: u64, task_id: u32, token: String) -> Option<TaskInfo> {
-        let (tx, rx) = oneshot::channel();
-        let event = QueryEvent::Touch(task_id, uid, token, tx);
-        let _ = self.send_event(TaskManagerEvent::Query(event));
-        match ylong_runtime::block_on(rx) {
-            Ok(task_info) => task_info,
-            Err(error) => {
-                error!("In `touch`, block on failed, err {}", error);
-                None
-            }
-        }
-    }
 }
 
 /// Receiver for task manager events.
@@ -771,3 +794,21 @@ async fn clear_timeout_tasks(tx: TaskManagerTx) {
         let _ = tx.send_event(TaskManagerEvent::Schedule(ScheduleEvent::ClearTimeoutTasks));
     }
 }
+
+/// Periodically triggers the expired tasks reaper.
+/// 
+/// # Arguments
+/// 
+/// * `tx` - The task manager event sender to use for triggering the reaper
+async fn reap_expired_tasks(tx: TaskManagerTx) {
+    loop {
+        sleep(Duration::from_secs(REAP_INTERVAL)).await;
+        let _ = tx.send_event(TaskManagerEvent::Schedule(ScheduleEvent::ReapExpiredTasks));
+    }
+}
+
+// Built by the `rust_request_load_benchmark` target only.
+#[cfg(all(test, load_bench))]
+mod bench_load {
+    include!("../../tests/bench/bench_load.rs");
+}
@@ -0,0 +1,106 @@
+// Copyright (C) 2024 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Cache of the immutable attributes of tasks.
+//!
+//! The owner, token and action of a task never change after it was created,
+//! but they are looked up on almost every IPC. The cache is filled on reads,
+//! evicts the oldest entries once full and has to be told whenever rows are
+//! deleted from `request_task`.
+
+use std::collections::{HashMap, VecDeque};
+use std::sync::Mutex;
+
+use crate::config::Action;
+
+/// Number of tasks kept in the cache.
+pub(crate) const TASK_META_CAPACITY: usize = 4096;
+
+/// Immutable attributes of a task.
+#[derive(Clone, Copy, Debug, PartialEq)]
+pub(crate) struct TaskMeta {
+    pub(crate) uid: u64,
+    pub(crate) token_id: u64,
+    pub(crate) action: Action,
+}
+
+struct Inner {
+    metas: HashMap<u32, TaskMeta>,
+    /// Insertion order of the cached tasks, may contain removed ones.
+    order: VecDeque<u32>,
+}
+
+/// Bounded cache of `TaskMeta` keyed by task id.
+pub(crate) struct TaskMetaCache {
+    inner: Mutex<Inner>,
+    capacity: usize,
+}
+
+impl TaskMetaCache {
+    /// Creates an empty cache holding at most `capacity` tasks.
+    pub(crate) fn new(capacity: usize) -> Self {
+        Self {
+            inner: Mutex::new(Inner {
+                metas: HashMap::new(),
+                order: VecDeque::new(),
+            }),
+            capacity,
+        }
+    }
+
+    pub(crate) fn get(&self, task_id: u32) -> Option<TaskMeta> {
+        self.inner.lock().unwrap().metas.get(&task_id).copied()
+    }
+
+    /// Caches the attributes of a task, evicting the oldest tasks if full.
+    pub(crate) fn insert(&self, task_id: u32, meta: TaskMeta) {
+        let mut inner = self.inner.lock().unwrap();
+        if inner.metas.insert(task_id, meta).is_some() {
+            return;
+        }
+        inner.order.push_back(task_id);
+        while inner.metas.len() > self.capacity {
+            let Some(oldest) = inner.order.pop_front() else {
+                break;
+            };
+            inner.metas.remove(&oldest);
+        }
+        // Drops the ids of removed tasks so that `order` stays bounded too.
+        if inner.order.len() > self.capacity * 2 {
+            let Inner { metas, order } = &mut *inner;
+            order.retain(|task_id| metas.contains_key(task_id));
+        }
+    }
+
+    /// Forgets a task whose row was deleted.
+    pub(crate) fn remove(&self, task_id: u32) {
+        self.inner.lock().unwrap().metas.remove(&task_id);
+    }
+
+    /// Forgets all tasks `f` returns `true` for.
+    pub(crate) fn remove_if(&self, f: impl Fn(&TaskMeta) -> bool) {
+        self.inner.lock().unwrap().metas.retain(|_, meta| !f(meta));
+    }
+
+    /// Forgets all tasks.
+    pub(crate) fn clear(&self) {
+        let mut inner = self.inner.lock().unwrap();
+        inner.metas.clear();
+        inner.order.clear();
+    }
+}
+
+#[cfg(test)]
+mod ut_task_meta {
+    include!("../../tests/ut/manage/ut_task_meta.rs");
+}
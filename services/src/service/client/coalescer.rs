@@ -0,0 +1,123 @@
+// Copyright (C) 2024 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Progress coalescing for client notifications.
+//!
+//! Progress notifications are buffered per client process and task, keeping only
+//! the latest one. Buffered progress is flushed periodically by the client
+//! manager, or immediately once enough bytes were processed since the last
+//! notification the client has seen.
+
+use std::collections::HashMap;
+use std::time::Duration;
+
+use crate::task::notify::NotifyData;
+
+/// Interval at which buffered progress notifications are flushed.
+pub(crate) const PROGRESS_FLUSH_INTERVAL: Duration = Duration::from_millis(100);
+
+/// Processed bytes since the last forwarded progress that force a flush.
+pub(crate) const PROGRESS_FLUSH_BYTES: usize = 4 * 1024 * 1024;
+
+/// Buffers the latest progress notification of every (pid, task id) pair.
+pub(crate) struct ProgressCoalescer {
+    /// Latest unsent progress per client process and task.
+    pending: HashMap<(u64, u32), NotifyData>,
+    /// Total processed bytes of the last forwarded progress per task.
+    flushed: HashMap<u32, usize>,
+    /// Processed bytes that force a flush of a single task.
+    flush_bytes: usize,
+    /// Whether a periodic flush is already scheduled.
+    armed: bool,
+}
+
+impl ProgressCoalescer {
+    /// Creates an empty coalescer.
+    ///
+    /// # Arguments
+    ///
+    /// * `flush_bytes` - Processed bytes since the last forwarded progress of a
+    ///   task that make its new progress to be forwarded immediately
+    pub(crate) fn new(flush_bytes: usize) -> Self {
+        Self {
+            pending: HashMap::new(),
+            flushed: HashMap::new(),
+            flush_bytes,
+            armed: false,
+        }
+    }
+
+    /// Buffers a progress notification, replacing the older one of the task.
+    ///
+    /// # Returns
+    ///
+    /// The notification if it has to be forwarded right away.
+    pub(crate) fn push(&mut self, pid: u64, notify_data: NotifyData) -> Option<NotifyData> {
+        let task_id = notify_data.task_id;
+        let processed = notify_data.progress.common_data.total_processed;
+        let flushed = self.flushed.get(&task_id).copied().unwrap_or(0);
+        if processed.saturating_sub(flushed) >= self.flush_bytes {
+            self.pending.remove(&(pid, task_id));
+            self.flushed.insert(task_id, processed);
+            return Some(notify_data);
+        }
+        self.pending.insert((pid, task_id), notify_data);
+        None
+    }
+
+    /// Takes the buffered progress of a task, so that it can be forwarded ahead
+    /// of another notification of the same task.
+    pub(crate) fn take(&mut self, pid: u64, task_id: u32) -> Option<NotifyData> {
+        let notify_data = self.pending.remove(&(pid, task_id))?;
+        self.flushed
+            .insert(task_id, notify_data.progress.common_data.total_processed);
+        Some(notify_data)
+    }
+
+    /// Takes all buffered progress notifications and disarms the flush.
+    pub(crate) fn drain(&mut self) -> Vec<(u64, NotifyData)> {
+        self.armed = false;
+        let mut drained = Vec::with_capacity(self.pending.len());
+        for ((pid, task_id), notify_data) in self.pending.drain() {
+            self.flushed
+                .insert(task_id, notify_data.progress.common_data.total_processed);
+            drained.push((pid, notify_data));
+        }
+        drained
+    }
+
+    /// Forgets everything about a task that reached a terminal state.
+    pub(crate) fn finish(&mut self, pid: u64, task_id: u32) {
+        self.pending.remove(&(pid, task_id));
+        self.flushed.remove(&task_id);
+    }
+
+    /// Marks a periodic flush as scheduled.
+    ///
+    /// # Returns
+    ///
+    /// `true` if progress is buffered and no flush was scheduled yet, in which
+    /// case the caller has to schedule one.
+    pub(crate) fn arm(&mut self) -> bool {
+        if self.armed || self.pending.is_empty() {
+            return false;
+        }
+        self.armed = true;
+        true
+    }
+}
+
+#[cfg(test)]
+mod ut_coalescer {
+    include!("../../../tests/ut/client/ut_coalescer.rs");
+}
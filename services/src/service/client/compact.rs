@@ -0,0 +1,190 @@
+// Copyright (C) 2024 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Compact (v2) encoding of notification data.
+//!
+//! The v2 body keeps the field order of the v1 `NotifyData` message, but:
+//! - integers are LEB128 varints, signed ones zigzag encoded;
+//! - `processed` and `total_processed` are deltas against the previous message
+//!   of the same task;
+//! - `sizes` is only sent when it differs from the previous message of the task;
+//! - keys of `extras` are interned in a per-connection string table and sent
+//!   once, later messages only refer to their index.
+//!
+//! The client keeps a mirror of this state. Both sides drop the state of a
+//! task after a Complete, Fail or Remove notification, and the encoder resets
+//! everything after a failed send so the two sides can never diverge.
+
+use std::collections::HashMap;
+
+use crate::config::Version;
+use crate::task::notify::{NotifyData, SubscribeType};
+
+/// The message carries the full `sizes` vector.
+pub(crate) const FLAG_SIZES: u8 = 0x01;
+/// `processed` and `total_processed` are absolute values instead of deltas.
+pub(crate) const FLAG_ABSOLUTE: u8 = 0x02;
+/// The string table has to be cleared before decoding this message.
+pub(crate) const FLAG_RESET: u8 = 0x04;
+
+/// Last values the client has seen for a task.
+struct TaskState {
+    processed: u64,
+    total_processed: u64,
+    sizes: Vec<i64>,
+}
+
+/// Per-connection encoder state for v2 notification data.
+pub(crate) struct NotifyEncoder {
+    /// Interned keys and their index in the client's table.
+    keys: HashMap<String, u64>,
+    /// Last encoded values per task.
+    tasks: HashMap<u32, TaskState>,
+    /// Whether the next message has to reset the client's string table.
+    reset: bool,
+}
+
+impl NotifyEncoder {
+    /// Creates an encoder for a fresh connection.
+    pub(crate) fn new() -> Self {
+        Self {
+            keys: HashMap::new(),
+            tasks: HashMap::new(),
+            reset: false,
+        }
+    }
+
+    /// Drops all state after a message could not be delivered.
+    pub(crate) fn reset(&mut self) {
+        self.keys.clear();
+        self.tasks.clear();
+        self.reset = true;
+    }
+
+    /// Appends the v2 body of `notify_data` to `message`.
+    pub(crate) fn encode(
+        &mut self,
+        message: &mut Vec<u8>,
+        subscribe_type: SubscribeType,
+        notify_data: NotifyData,
+        extras_limit: usize,
+    ) {
+        let task_id = notify_data.task_id;
+        let progress = notify_data.progress;
+        let index = progress.common_data.index;
+        let processed = progress.processed.get(index).copied().unwrap_or(0) as u64;
+        let total_processed = progress.common_data.total_processed as u64;
+
+        let mut flags = 0;
+        if self.reset {
+            flags |= FLAG_RESET;
+            self.reset = false;
+        }
+        let (processed_base, total_base) = match self.tasks.get(&task_id) {
+            Some(state) => {
+                if state.sizes != progress.sizes {
+                    flags |= FLAG_SIZES;
+                }
+                (state.processed, state.total_processed)
+            }
+            None => {
+                flags |= FLAG_SIZES | FLAG_ABSOLUTE;
+                (0, 0)
+            }
+        };
+
+        message.push(flags);
+        write_varint(message, subscribe_type as u64);
+        write_varint(message, task_id as u64);
+        write_varint(message, progress.common_data.state as u64);
+        write_varint(message, index as u64);
+        write_signed(message, processed.wrapping_sub(processed_base) as i64);
+        write_signed(message, total_processed.wrapping_sub(total_base) as i64);
+        if flags & FLAG_SIZES != 0 {
+            write_varint(message, progress.sizes.len() as u64);
+            for size in progress.sizes.iter() {
+                write_signed(message, *size);
+            }
+        }
+
+        write_varint(message, extras_limit as u64);
+        for (key, value) in progress.extras.iter().take(extras_limit) {
+            match self.keys.get(key) {
+                Some(index) => write_varint(message, index + 1),
+                None => {
+                    write_varint(message, 0);
+                    write_bytes(message, key.as_bytes());
+                    self.keys.insert(key.clone(), self.keys.len() as u64);
+                }
+            }
+            write_bytes(message, value.as_bytes());
+        }
+        write_varint(message, progress.speed);
+        write_signed(message, progress.eta);
+
+        write_varint(message, notify_data.action.repr as u64);
+        write_varint(message, notify_data.version as u64);
+        write_varint(message, notify_data.each_file_status.len() as u64);
+        for status in notify_data.each_file_status.iter() {
+            // Path is only included in API9
+            if notify_data.version == Version::API9 {
+                write_bytes(message, status.path.as_bytes());
+            } else {
+                write_varint(message, 0);
+            }
+            write_varint(message, status.reason.repr as u64);
+            write_bytes(message, status.message.as_bytes());
+        }
+
+        match subscribe_type {
+            SubscribeType::Complete | SubscribeType::Fail | SubscribeType::Remove => {
+                self.tasks.remove(&task_id);
+            }
+            _ => {
+                self.tasks.insert(
+                    task_id,
+                    TaskState {
+                        processed,
+                        total_processed,
+                        sizes: progress.sizes,
+                    },
+                );
+            }
+        }
+    }
+}
+
+/// Appends `value` as an LEB128 varint.
+pub(crate) fn write_varint(message: &mut Vec<u8>, mut value: u64) {
+    while value >= 0x80 {
+        message.push((value as u8) | 0x80);
+        value >>= 7;
+    }
+    message.push(value as u8);
+}
+
+/// Appends `value` as a zigzag encoded varint.
+pub(crate) fn write_signed(message: &mut Vec<u8>, value: i64) {
+    write_varint(message, ((value << 1) ^ (value >> 63)) as u64);
+}
+
+/// Appends `bytes` prefixed with their length.
+fn write_bytes(message: &mut Vec<u8>, bytes: &[u8]) {
+    write_varint(message, bytes.len() as u64);
+    message.extend_from_slice(bytes);
+}
+
+#[cfg(test)]
+mod ut_compact {
+    include!("../../../tests/ut/client/ut_compact.rs");
+}
@@ -0,0 +1,70 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Progress lane of the notifications of a client.
+//!
+//! The handler of a client sends its events in two lanes. Responses, state
+//! changes, faults, waiting reasons and bodies go in the priority lane and
+//! are sent as soon as they are received. Progress waits in this lane, which
+//! keeps the latest progress of each task and is only sent, a part at a time,
+//! while the priority lane is empty. An end of a task is not overtaken by its
+//! own progress: the progress of the task leaves the lane right before it.
+
+use std::collections::HashMap;
+
+use crate::task::notify::NotifyData;
+use crate::utils::metrics;
+
+/// Latest unsent progress of the tasks of a client.
+#[derive(Default)]
+pub(crate) struct ProgressLane {
+    pending: HashMap<u32, NotifyData>,
+}
+
+impl ProgressLane {
+    /// Queues the progress of a task, dropping the one it supersedes.
+    pub(crate) fn push(&mut self, notify_data: NotifyData) {
+        if self
+            .pending
+            .insert(notify_data.task_id, notify_data)
+            .is_some()
+        {
+            metrics::CLIENT_PROGRESS_SUPERSEDED.add(1);
+        }
+    }
+
+    /// Takes the progress of a task out of the lane, to send it ahead of an
+    /// event of the task in the priority lane.
+    pub(crate) fn take(&mut self, task_id: u32) -> Option<NotifyData> {
+        self.pending.remove(&task_id)
+    }
+
+    /// Takes the progress of at most `max` tasks out of the lane.
+    pub(crate) fn take_some(&mut self, max: usize) -> Vec<NotifyData> {
+        let task_ids = self.pending.keys().take(max).copied().collect::<Vec<_>>();
+        task_ids
+            .into_iter()
+            .filter_map(|task_id| self.pending.remove(&task_id))
+            .collect()
+    }
+
+    /// Whether no progress waits in the lane.
+    pub(crate) fn is_empty(&self) -> bool {
+        self.pending.is_empty()
+    }
+}
+
+#[cfg(test)]
+mod ut_lanes {
+    include!("../../../tests/ut/client/ut_lanes.rs");
+}
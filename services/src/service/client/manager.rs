@@ -17,18 +17,22 @@
 //! and sending notifications between the service and its clients through Unix domain sockets.
 
 use std::collections::{hash_map, HashMap};
+use std::fs::File;
 use std::sync::Arc;
 
 use ylong_runtime::net::UnixDatagram;
 use ylong_runtime::sync::mpsc::{unbounded_channel, UnboundedReceiver, UnboundedSender};
 use ylong_runtime::sync::oneshot::Sender;
 
+use super::coalescer::{ProgressCoalescer, PROGRESS_FLUSH_BYTES, PROGRESS_FLUSH_INTERVAL};
+use super::progress_table::{ProgressRecord, ProgressTable};
 use super::{Client, ClientEvent};
 
 cfg_oh! {
     use crate::ability::PANIC_INFO;
 }
 use crate::error::ErrorCode;
+use crate::task::notify::{NotifyData, SubscribeType};
 use crate::utils::runtime_spawn;
 
 /// Lightweight handle for sending events to the `ClientManager`.
@@ -100,6 +104,12 @@ pub(crate) struct ClientManager {
     clients: HashMap<u64, (UnboundedSender<ClientEvent>, Arc<UnixDatagram>)>,
     /// Map of task IDs to process IDs for notification routing.
     pid_map: HashMap<u32, u64>,
+    /// Latest progress notifications not yet forwarded to the clients.
+    progress: ProgressCoalescer,
+    /// Shared progress tables of the clients that opened one.
+    tables: HashMap<u64, ProgressTable>,
+    /// Sender used to schedule flushes of buffered progress.
+    tx: UnboundedSender<ClientEvent>,
     /// Receiver channel for incoming events to process.
     rx: UnboundedReceiver<ClientEvent>,
 }
@@ -119,6 +129,9 @@ impl ClientManager {
         let client_manager = ClientManager {
             clients: HashMap::new(),
             pid_map: HashMap::new(),
+            progress: ProgressCoalescer::new(PROGRESS_FLUSH_BYTES),
+            tables: HashMap::new(),
+            tx: tx.clone(),
             rx,
         };
         // Spawn the client manager's main loop in a separate task
@@ -149,6 +162,7 @@ impl ClientManager {
             // Route the received event to the appropriate handler
             match recv {
                 ClientEvent::OpenChannel(pid, tx) => self.handle_open_channel(pid, tx),
+                ClientEvent::OpenProgressTable(pid, tx) => self.handle_open_progress_table(pid, tx),
                 ClientEvent::Subscribe(tid, pid, uid, token_id, tx) => {
                     self.handle_subscribe(tid, pid, uid, token_id, tx)
                 }
@@ -184,28 +198,12 @@ impl ClientManager {
                 
                 // Notification data routing
                 ClientEvent::SendNotifyData(subscribe_type, notify_data) => {
-                    if let Some(&pid) = self.pid_map.get(&(notify_data.task_id)) {
-                        if let Some((tx, _fd)) = self.clients.get_mut(&pid) {
-                            if let Err(err) = 
-                                tx.send(ClientEvent::SendNotifyData(subscribe_type, notify_data))
-                            {
-                                error!("send notify data error, {}", err);
-                                sys_event!(
-                                    ExecFault,
-                                    DfxCode::UDS_FAULT_02,
-                                    &format!("send notify data error, {}", err)
-                                );
-                            }
-                        } else {
-                            debug!("response client not found");
-                        }
-                    } else {
-                        debug!("notify data pid not found");
-                    }
+                    self.handle_send_notify_data(subscribe_type, notify_data)
                 }
-                
+
                 // Fault notification routing
                 ClientEvent::SendFaults(tid, subscribe_type, reason) => {
+                    self.flush_task_progress(tid);
                     if let Some(&pid) = self.pid_map.get(&tid) {
                         if let Some((tx, _fd)) = self.clients.get_mut(&pid) {
                             if let Err(err) = 
@@ -224,6 +222,7 @@ impl ClientManager {
                 
                 // Wait notification routing
                 ClientEvent::SendWaitNotify(tid, reason) => {
+                    self.flush_task_progress(tid);
                     if let Some(&pid) = self.pid_map.get(&tid) {
                         if let Some((tx, _fd)) = self.clients.get_mut(&pid) {
                             if let Err(err) = tx.send(ClientEvent::SendWaitNotify(tid, reason)) {
@@ -238,6 +237,36 @@ impl ClientManager {
                     }
                 }
                 
+                // Body routing, ahead of the completed notification
+                ClientEvent::SendBody(tid, body, reservation) => {
+                    self.flush_task_progress(tid);
+                    if let Some(&pid) = self.pid_map.get(&tid) {
+                        if let Some((tx, _fd)) = self.clients.get_mut(&pid) {
+                            let event = ClientEvent::SendBody(tid, body, reservation);
+                            if let Err(err) = tx.send(event) {
+                                error!("send body error, {}", err);
+                                sys_event!(
+                                    ExecFault,
+                                    DfxCode::UDS_FAULT_02,
+                                    &format!("send body error, {}", err)
+                                );
+                            }
+                        }
+                    }
+                }
+
+                ClientEvent::FlushProgress => self.handle_flush_progress(),
+
+                // Run count routing, clients without a channel get it another way
+                ClientEvent::SendRunCount(pid, run_count, tx) => match self.clients.get(&pid) {
+                    Some((client, _fd)) => {
+                        let _ = client.send(ClientEvent::SendRunCount(pid, run_count, tx));
+                    }
+                    None => {
+                        let _ = tx.send(false);
+                    }
+                },
+
                 // Ignore unhandled events
                 _ => {}
             }
@@ -246,6 +275,103 @@ impl ClientManager {
         }
     }
 
+    /// Routes notification data to the client subscribed to the task.
+    ///
+    /// The progress table of the client, if any, is updated with every
+    /// notification. Progress notifications are coalesced and only the latest one per task is
+    /// forwarded when the next periodic flush happens. Any other notification
+    /// first forwards the buffered progress of its task, so that clients observe
+    /// the notifications of a task in order, and is then forwarded immediately.
+    ///
+    /// # Arguments
+    ///
+    /// * `subscribe_type` - Type of subscription
+    /// * `notify_data` - Notification data
+    fn handle_send_notify_data(&mut self, subscribe_type: SubscribeType, notify_data: NotifyData) {
+        let tid = notify_data.task_id;
+        let Some(&pid) = self.pid_map.get(&tid) else {
+            debug!("notify data pid not found");
+            return;
+        };
+        if let Some(table) = self.tables.get_mut(&pid) {
+            table.update(tid, ProgressRecord::from_notify_data(&notify_data));
+        }
+        if subscribe_type == SubscribeType::Progress {
+            if let Some(notify_data) = self.progress.push(pid, notify_data) {
+                self.forward_notify_data(pid, subscribe_type, notify_data);
+            } else if self.progress.arm() {
+                let tx = self.tx.clone();
+                runtime_spawn(async move {
+                    ylong_runtime::time::sleep(PROGRESS_FLUSH_INTERVAL).await;
+                    let _ = tx.send(ClientEvent::FlushProgress);
+                });
+            }
+            return;
+        }
+
+        if let Some(progress) = self.progress.take(pid, tid) {
+            self.forward_notify_data(pid, SubscribeType::Progress, progress);
+        }
+        if matches!(
+            subscribe_type,
+            SubscribeType::Complete | SubscribeType::Fail | SubscribeType::Remove
+        ) {
+            self.progress.finish(pid, tid);
+        }
+        self.forward_notify_data(pid, subscribe_type, notify_data);
+    }
+
+    /// Forwards all buffered progress notifications to their clients.
+    fn handle_flush_progress(&mut self) {
+        for (pid, notify_data) in self.progress.drain() {
+            // Skip tasks unsubscribed since the progress was buffered
+            if self.pid_map.get(&notify_data.task_id) != Some(&pid) {
+                continue;
+            }
+            self.forward_notify_data(pid, SubscribeType::Progress, notify_data);
+        }
+    }
+
+    /// Forwards the buffered progress of a task ahead of another event.
+    ///
+    /// # Arguments
+    ///
+    /// * `tid` - Task ID
+    fn flush_task_progress(&mut self, tid: u32) {
+        if let Some(&pid) = self.pid_map.get(&tid) {
+            if let Some(progress) = self.progress.take(pid, tid) {
+                self.forward_notify_data(pid, SubscribeType::Progress, progress);
+            }
+        }
+    }
+
+    /// Sends notification data to the handler of a client process.
+    ///
+    /// # Arguments
+    ///
+    /// * `pid` - Process ID of the client
+    /// * `subscribe_type` - Type of subscription
+    /// * `notify_data` - Notification data
+    fn forward_notify_data(
+        &mut self,
+        pid: u64,
+        subscribe_type: SubscribeType,
+        notify_data: NotifyData,
+    ) {
+        if let Some((tx, _fd)) = self.clients.get_mut(&pid) {
+            if let Err(err) = tx.send(ClientEvent::SendNotifyData(subscribe_type, notify_data)) {
+                error!("send notify data error, {}", err);
+                sys_event!(
+                    ExecFault,
+                    DfxCode::UDS_FAULT_02,
+                    &format!("send notify data error, {}", err)
+                );
+            }
+        } else {
+            debug!("response client not found");
+        }
+    }
+
     /// Handles client channel opening requests.
     ///
     /// This method either returns an existing channel for a process or creates a new one.
@@ -274,6 +400,42 @@ impl ClientManager {
         }
     }
 
+    /// Handles progress table opening requests.
+    ///
+    /// The table of a process is created the first time it is opened, and
+    /// every request gets a new descriptor of it.
+    ///
+    /// # Arguments
+    ///
+    /// * `pid` - Process ID of the client requesting the table
+    /// * `tx` - One-shot sender to return the result (table or error)
+    fn handle_open_progress_table(&mut self, pid: u64, tx: Sender<Result<File, ErrorCode>>) {
+        if !self.clients.contains_key(&pid) {
+            info!("channel not open, pid {}", pid);
+            let _ = tx.send(Err(ErrorCode::ChannelNotOpen));
+            return;
+        }
+        let table = match self.tables.entry(pid) {
+            hash_map::Entry::Occupied(o) => o.into_mut(),
+            hash_map::Entry::Vacant(v) => match ProgressTable::new() {
+                Some(table) => v.insert(table),
+                None => {
+                    let _ = tx.send(Err(ErrorCode::Other));
+                    return;
+                }
+            },
+        };
+        match table.share() {
+            Ok(file) => {
+                let _ = tx.send(Ok(file));
+            }
+            Err(e) => {
+                error!("share progress table failed {:?}", e);
+                let _ = tx.send(Err(ErrorCode::Other));
+            }
+        }
+    }
+
     /// Handles task subscription requests from clients.
     ///
     /// Maps a task ID to a client process for future event routing.
@@ -314,6 +476,7 @@ impl ClientManager {
     fn handle_unsubscribe(&mut self, tid: u32, tx: Sender<ErrorCode>) {
         if let Some(&pid) = self.pid_map.get(&tid) {
             self.pid_map.remove(&tid);
+            self.remove_progress(pid, tid);
             if let Some(_client) = self.clients.get_mut(&pid) {
                 let _ = tx.send(ErrorCode::ErrOk);
                 return;
@@ -334,13 +497,26 @@ impl ClientManager {
     ///
     /// * `tid` - Task ID that has finished
     fn handle_task_finished(&mut self, tid: u32) {
-        if self.pid_map.remove(&tid).is_some() {
+        if let Some(pid) = self.pid_map.remove(&tid) {
+            self.remove_progress(pid, tid);
             debug!("unsubscribe tid {:?}", tid);
         } else {
             debug!("unsubscribe tid not found");
         }
     }
 
+    /// Frees the slot of a task in the progress table of its client.
+    ///
+    /// # Arguments
+    ///
+    /// * `pid` - Process ID of the client
+    /// * `tid` - Task ID
+    fn remove_progress(&mut self, pid: u64, tid: u32) {
+        if let Some(table) = self.tables.get_mut(&pid) {
+            table.remove(tid);
+        }
+    }
+
     /// Handles process termination notifications.
     ///
     /// Cleans up resources associated with a terminated process.
@@ -355,6 +531,7 @@ impl ClientManager {
             let _ = tx.send(ClientEvent::Shutdown);
             // Remove all traces of the client
             self.clients.remove(&pid);
+            self.tables.remove(&pid);
         } else {
             debug!("terminate pid not found");
         }
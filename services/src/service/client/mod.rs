@@ -17,12 +17,16 @@
 //! communication through Unix domain sockets. It provides components for sending and
 //! receiving various types of events and notifications between the request service and its clients.
 
+mod coalescer;
+mod compact;
+mod lanes;
 mod manager;
+mod progress_table;
 
-use std::collections::HashMap;
+use std::fs::File;
 use std::net::Shutdown;
 use std::sync::Arc;
-use std::time::Duration;
+use std::time::{Duration, Instant};
 
 pub(crate) use manager::{ClientManager, ClientManagerEntry};
 use ylong_http_client::Headers;
@@ -30,21 +34,62 @@ use ylong_runtime::net::UnixDatagram;
 use ylong_runtime::sync::mpsc::{unbounded_channel, UnboundedReceiver, UnboundedSender};
 use ylong_runtime::sync::oneshot::{channel, Sender};
 
+use compact::NotifyEncoder;
+use lanes::ProgressLane;
+
 use crate::config::Version;
 use crate::error::ErrorCode;
+use crate::task::cpu::{self, Path};
 use crate::task::notify::{NotifyData, SubscribeType, WaitingCause};
 use crate::task::reason::Reason;
-use crate::utils::{runtime_spawn, Recv};
+#[cfg(feature = "oh")]
+use crate::trace::RequestTrace;
+use crate::utils::memory_budget::Reservation;
+use crate::utils::{metrics, runtime_spawn, Recv};
 
 /// Magic number used to identify request service messages.
 const REQUEST_MAGIC_NUM: u32 = 0x43434646;
 
+/// Magic number used to identify credit grants sent back by the client.
+const CREDIT_MAGIC_NUM: u32 = 0x43524454;
+
+/// Capability bit announced in the first credit grant: the client decodes
+/// compact v2 notification data.
+const CAPABILITY_NOTIFY_DATA_V2: u32 = 0x01;
+
+/// Capability bit announced in the first credit grant: the client receives
+/// the run count over its channel instead of a binder call.
+const CAPABILITY_RUN_COUNT: u32 = 0x02;
+
+/// Maximum time to wait for an acknowledgment or a credit grant.
+const FLOW_CONTROL_TIMEOUT: Duration = Duration::from_millis(500);
+
 /// Maximum size of headers allowed in message payloads.
 const HEADERS_MAX_SIZE: u16 = 8 * 1024;
 
 /// Position in the message buffer where the length field is stored.
 const POSITION_OF_LENGTH: u32 = 10;
 
+/// Size of the common message header: magic number, message id, message type
+/// and message size.
+const MESSAGE_HEADER_SIZE: usize = 12;
+
+/// Maximum size of a batch datagram.
+///
+/// Kept within the smallest receive buffer used by the client side listeners.
+const BATCH_MAX_SIZE: usize = 4096;
+
+/// Size of the fields of a body message after the common header: task id,
+/// body length and offset of the piece.
+const BODY_FIELDS_SIZE: usize = 12;
+
+/// Maximum bytes of a body carried by one message, which stays within the
+/// same receive buffers as a batch.
+const BODY_PIECE_SIZE: usize = BATCH_MAX_SIZE - MESSAGE_HEADER_SIZE - BODY_FIELDS_SIZE;
+
+/// Tasks whose progress is sent between two checks for other events.
+const PROGRESS_LANE_CHUNK: usize = 16;
+
 /// Events used for communication between the client manager and client handlers.
 #[derive(Debug)]
 pub(crate) enum ClientEvent {
@@ -55,6 +100,14 @@ pub(crate) enum ClientEvent {
     /// * `0` - Process ID of the client
     /// * `1` - Sender to return the socket result
     OpenChannel(u64, Sender<Result<Arc<UnixDatagram>, ErrorCode>>),
+
+    /// Opens the shared progress table of a client process.
+    ///
+    /// # Fields
+    ///
+    /// * `0` - Process ID of the client
+    /// * `1` - Sender to return a descriptor of the table
+    OpenProgressTable(u64, Sender<Result<File, ErrorCode>>),
     
     /// Subscribes a client to notifications for a specific task.
     /// 
@@ -125,6 +178,27 @@ pub(crate) enum ClientEvent {
     /// * `0` - Task ID
     /// * `1` - Cause of waiting
     SendWaitNotify(u32, WaitingCause),
+
+    /// Sends the body of an in-memory download to a client.
+    ///
+    /// # Fields
+    ///
+    /// * `0` - Task ID
+    /// * `1` - Body of the download
+    /// * `2` - Memory budget reserved for the body until it is sent
+    SendBody(u32, Vec<u8>, Reservation),
+
+    /// Flushes the progress notifications buffered by the client manager.
+    FlushProgress,
+
+    /// Sends the number of running tasks to a client.
+    ///
+    /// # Fields
+    ///
+    /// * `0` - Process ID of the client
+    /// * `1` - Number of running tasks
+    /// * `2` - Sender returning whether the client receives it over its channel
+    SendRunCount(u64, i64, Sender<bool>),
     
     /// Signals to shutdown the client handler.
     Shutdown,
@@ -141,6 +215,42 @@ pub(crate) enum MessageType {
     Faults,
     /// Waiting state notification message.
     Waiting,
+    /// Several NotifyData, Faults and Waiting records packed into one datagram.
+    Batch,
+    /// Notification data in the compact v2 encoding.
+    NotifyDataV2,
+    /// Number of running tasks.
+    RunCount,
+    /// Piece of the body of an in-memory download.
+    Body,
+}
+
+impl MessageType {
+    /// Returns whether messages of this type can be packed into a batch.
+    fn batchable(&self) -> bool {
+        matches!(
+            self,
+            MessageType::NotifyData
+                | MessageType::NotifyDataV2
+                | MessageType::Faults
+                | MessageType::Waiting
+                | MessageType::RunCount
+        )
+    }
+}
+
+/// Flow control mode used on the socket of a client.
+///
+/// Clients start in `Ack` mode, acknowledging every datagram with its length.
+/// Clients that support credits send a grant as their first datagram, which
+/// switches the connection to `Credit` mode: the service then keeps up to the
+/// granted number of datagrams in flight and only waits when it runs out.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub(crate) enum FlowControl {
+    /// Wait for a length acknowledgment after every datagram.
+    Ack,
+    /// Number of datagrams that may still be sent without waiting.
+    Credit(u32),
 }
 
 impl ClientManagerEntry {
@@ -175,6 +285,35 @@ impl ClientManagerEntry {
         }
     }
 
+    /// Opens the shared progress table of a client process.
+    ///
+    /// The channel of the client must be open. The table then holds the
+    /// latest progress of every task the client subscribed to.
+    ///
+    /// # Arguments
+    ///
+    /// * `pid` - Process ID of the client
+    ///
+    /// # Returns
+    ///
+    /// * `Ok(File)` - A descriptor of the table to map read-only
+    /// * `Err(ErrorCode)` - An error if the table couldn't be opened
+    pub(crate) fn open_progress_table(&self, pid: u64) -> Result<File, ErrorCode> {
+        let (tx, rx) = channel::<Result<File, ErrorCode>>();
+        let event = ClientEvent::OpenProgressTable(pid, tx);
+        if !self.send_event(event) {
+            return Err(ErrorCode::Other);
+        }
+        let rx = Recv::new(rx);
+        match rx.get() {
+            Some(ret) => ret,
+            None => {
+                error!("open progress table fail, recv none");
+                Err(ErrorCode::Other)
+            }
+        }
+    }
+
     /// Subscribes a client to notifications for a specific task.
     ///
     /// # Arguments
@@ -328,6 +467,38 @@ impl ClientManagerEntry {
         let event = ClientEvent::SendWaitNotify(tid, reason);
         let _ = self.send_event(event);
     }
+
+    /// Sends the body of an in-memory download to the client subscribed to
+    /// the task, ahead of its completed notification.
+    ///
+    /// # Arguments
+    ///
+    /// * `tid` - Task ID
+    /// * `body` - Body of the download
+    /// * `reservation` - Memory budget reserved for the body
+    pub(crate) fn send_body(&self, tid: u32, body: Vec<u8>, reservation: Reservation) {
+        let event = ClientEvent::SendBody(tid, body, reservation);
+        let _ = self.send_event(event);
+    }
+
+    /// Sends the number of running tasks to a client over its channel.
+    ///
+    /// # Arguments
+    ///
+    /// * `pid` - Process ID of the client
+    /// * `run_count` - Number of running tasks
+    ///
+    /// # Returns
+    ///
+    /// `true` if the client has a channel and receives the run count over it,
+    /// `false` if it has to be sent another way.
+    pub(crate) async fn send_run_count(&self, pid: u64, run_count: i64) -> bool {
+        let (tx, rx) = channel::<bool>();
+        if !self.send_event(ClientEvent::SendRunCount(pid, run_count, tx)) {
+            return false;
+        }
+        rx.await.unwrap_or(false)
+    }
 }
 
 // uid and token_id will be used later
@@ -344,6 +515,14 @@ pub(crate) struct Client {
     pub(crate) server_sock_fd: UnixDatagram,
     /// Client-side socket file descriptor (shared with the client).
     pub(crate) client_sock_fd: Arc<UnixDatagram>,
+    /// Flow control mode negotiated with the client.
+    pub(crate) flow_control: FlowControl,
+    /// Encoder state, present once the client announced v2 notification data.
+    notify_encoder: Option<NotifyEncoder>,
+    /// Whether the client announced it receives the run count.
+    run_count: bool,
+    /// Messages sent to the client.
+    sent: u64,
     /// Receiver for client events.
     rx: UnboundedReceiver<ClientEvent>,
 }
@@ -384,6 +563,10 @@ impl Client {
             message_id: 1,
             server_sock_fd,
             client_sock_fd: client_sock_fd.clone(),
+            flow_control: FlowControl::Ack,
+            notify_encoder: None,
+            run_count: false,
+            sent: 0,
             rx,
         };
 
@@ -396,16 +579,24 @@ impl Client {
     ///
     /// This async method continuously receives events, batches them for processing,
     /// and sends the appropriate messages to the client through the socket.
+    ///
+    /// Progress waits in the progress lane while other events are sent, and
+    /// only the latest progress of a task is kept. Once no other event waits,
+    /// the progress of `PROGRESS_LANE_CHUNK` tasks is sent before the events
+    /// received meanwhile are checked, so a completion is never queued behind
+    /// the progress of many tasks.
     async fn run(mut self) {
+        let mut progress = ProgressLane::default();
         loop {
-            // for one task, only send last progress message
-            let mut progress_index = HashMap::new();
-            let mut temp_notify_data: Vec<(SubscribeType, NotifyData)> = Vec::new();
+            let mut messages: Vec<(MessageType, Vec<u8>)> = Vec::new();
+            // Memory budget of the bodies, released once their messages are sent
+            let mut reservations = Vec::new();
             let mut len = self.rx.len();
-            if len == 0 {
+            // Only waits for an event once no progress is left to send
+            if len == 0 && progress.is_empty() {
                 len = 1;
             }
-            for index in 0..len {
+            for _ in 0..len {
                 let recv = match self.rx.recv().await {
                     Ok(message) => message,
                     Err(e) => {
@@ -424,46 +615,77 @@ impl Client {
                         let _ = self.client_sock_fd.shutdown(Shutdown::Both);
                         let _ = self.server_sock_fd.shutdown(Shutdown::Both);
                         self.rx.close();
-                        info!("client terminate, pid {}", self.pid);
+                        info!("client terminate, pid {}, sent {}", self.pid, self.sent);
                         return;
                     }
                     ClientEvent::SendResponse(tid, version, status_code, reason, headers) => {
-                        self.handle_send_response(tid, version, status_code, reason, headers)
-                            .await;
+                        let message =
+                            self.build_response(tid, version, status_code, reason, headers);
+                        messages.push((MessageType::HttpResponse, message));
                     }
                     ClientEvent::SendFaults(tid, subscribe_type, reason) => {
-                        self.handle_send_faults(tid, subscribe_type, reason).await;
+                        self.overtake_progress(&mut progress, tid, &mut messages);
+                        let message = self.build_faults(tid, subscribe_type, reason);
+                        messages.push((MessageType::Faults, message));
+                    }
+                    ClientEvent::SendNotifyData(SubscribeType::Progress, notify_data) => {
+                        progress.push(notify_data);
                     }
                     ClientEvent::SendNotifyData(subscribe_type, notify_data) => {
-                        // Track progress messages to only send the latest one per task
-                        if subscribe_type == SubscribeType::Progress {
-                            progress_index.insert(notify_data.task_id, index);
-                        }
-                        temp_notify_data.push((subscribe_type, notify_data));
+                        let tid = notify_data.task_id;
+                        self.overtake_progress(&mut progress, tid, &mut messages);
+                        messages.push(self.build_notify_data(subscribe_type, notify_data));
                     }
                     ClientEvent::SendWaitNotify(task_id, waiting_reason) => {
-                        self.handle_send_waiting_notify(task_id, waiting_reason)
-                            .await;
+                        self.overtake_progress(&mut progress, task_id, &mut messages);
+                        let message = self.build_waiting_notify(task_id, waiting_reason);
+                        messages.push((MessageType::Waiting, message));
+                    }
+                    ClientEvent::SendBody(task_id, body, reservation) => {
+                        self.overtake_progress(&mut progress, task_id, &mut messages);
+                        for message in self.build_body(task_id, &body) {
+                            messages.push((MessageType::Body, message));
+                        }
+                        reservations.push(reservation);
+                    }
+                    ClientEvent::SendRunCount(_, run_count, tx) => {
+                        if self.run_count {
+                            let message = self.build_run_count(run_count);
+                            messages.push((MessageType::RunCount, message));
+                        }
+                        let _ = tx.send(self.run_count);
                     }
                     _ => {}
                 }
             }
-            // Process notify data, skipping old progress messages
-            for (index, (subscribe_type, notify_data)) in temp_notify_data.into_iter().enumerate() {
-                if subscribe_type != SubscribeType::Progress
-                    || progress_index.get(&notify_data.task_id) == Some(&index)
-                {
-                    self.handle_send_notify_data(subscribe_type, notify_data)
-                        .await;
+            // The progress lane is only sent while no other event waits
+            if messages.is_empty() {
+                for notify_data in progress.take_some(PROGRESS_LANE_CHUNK) {
+                    messages.push(self.build_notify_data(SubscribeType::Progress, notify_data));
                 }
             }
+            self.flush_messages(messages).await;
+            drop(reservations);
             debug!("Client handle message done");
         }
     }
 
-    /// Handles sending fault information to the client.
+    /// Moves the progress of a task waiting in the progress lane to the
+    /// messages, ahead of another event of the task.
+    fn overtake_progress(
+        &mut self,
+        progress: &mut ProgressLane,
+        task_id: u32,
+        messages: &mut Vec<(MessageType, Vec<u8>)>,
+    ) {
+        if let Some(notify_data) = progress.take(task_id) {
+            messages.push(self.build_notify_data(SubscribeType::Progress, notify_data));
+        }
+    }
+
+    /// Builds a fault information message for the client.
     ///
-    /// This method constructs and sends a fault notification message with the given task ID,
+    /// This method constructs a fault notification message with the given task ID,
     /// subscription type, and reason.
     ///
     /// # Arguments
@@ -471,12 +693,12 @@ impl Client {
     /// * `tid` - Task ID
     /// * `subscribe_type` - Type of subscription
     /// * `reason` - Reason for the fault
-    async fn handle_send_faults(
+    fn build_faults(
         &mut self,
         tid: u32,
         subscribe_type: SubscribeType,
         reason: Reason,
-    ) {
+    ) -> Vec<u8> {
         let mut message = Vec::<u8>::new();
         // Message header with magic number
         message.extend_from_slice(&REQUEST_MAGIC_NUM.to_le_bytes());
@@ -508,21 +730,19 @@ impl Client {
         let size = size.to_le_bytes();
         message[POSITION_OF_LENGTH as usize] = size[0];
         message[(POSITION_OF_LENGTH + 1) as usize] = size[1];
-        
-        // Send the constructed message
-        self.send_message(message).await;
+        message
     }
 
-    /// Handles sending waiting notifications to the client.
+    /// Builds a waiting notification message for the client.
     ///
-    /// This method constructs and sends a waiting notification message with the given task ID
+    /// This method constructs a waiting notification message with the given task ID
     /// and waiting reason.
     ///
     /// # Arguments
     ///
     /// * `task_id` - Task ID
     /// * `waiting_reason` - Reason the task is waiting
-    async fn handle_send_waiting_notify(&mut self, task_id: u32, waiting_reason: WaitingCause) {
+    fn build_waiting_notify(&mut self, task_id: u32, waiting_reason: WaitingCause) -> Vec<u8> {
         let mut message = Vec::<u8>::new();
 
         // Message header with magic number
@@ -555,14 +775,92 @@ impl Client {
         let size = size.to_le_bytes();
         message[POSITION_OF_LENGTH as usize] = size[0];
         message[(POSITION_OF_LENGTH + 1) as usize] = size[1];
+        message
+    }
 
-        // Send the constructed message
-        self.send_message(message).await;
+    /// Builds a run count message for the client.
+    ///
+    /// # Arguments
+    ///
+    /// * `run_count` - Number of running tasks
+    fn build_run_count(&mut self, run_count: i64) -> Vec<u8> {
+        let mut message = Vec::<u8>::with_capacity(MESSAGE_HEADER_SIZE + 8);
+
+        // Message header with magic number
+        message.extend_from_slice(&REQUEST_MAGIC_NUM.to_le_bytes());
+
+        // Unique message identifier
+        message.extend_from_slice(&self.message_id.to_le_bytes());
+        self.message_id += 1;
+
+        // Message type for run counts
+        message.extend_from_slice(&(MessageType::RunCount as u16).to_le_bytes());
+
+        // Message size, known up front
+        message.extend_from_slice(&((MESSAGE_HEADER_SIZE + 8) as u16).to_le_bytes());
+
+        // Number of running tasks
+        message.extend_from_slice(&run_count.to_le_bytes());
+        message
     }
 
-    /// Handles sending HTTP responses to the client.
+    /// Builds the messages carrying the body of an in-memory download.
+    ///
+    /// The body is split into pieces of at most `BODY_PIECE_SIZE` bytes, each
+    /// sent with the length of the whole body and its own offset, so the
+    /// client can check it received all of them in order. An empty body is
+    /// sent as one empty piece.
+    ///
+    /// # Arguments
     ///
-    /// This method constructs and sends an HTTP response message with the given task ID,
+    /// * `task_id` - Task ID
+    /// * `body` - Body of the download
+    fn build_body(&mut self, task_id: u32, body: &[u8]) -> Vec<Vec<u8>> {
+        let mut pieces = body.chunks(BODY_PIECE_SIZE).collect::<Vec<_>>();
+        if pieces.is_empty() {
+            pieces.push(&[]);
+        }
+        let mut messages = Vec::with_capacity(pieces.len());
+        let mut offset = 0;
+        for piece in pieces {
+            let size = MESSAGE_HEADER_SIZE + BODY_FIELDS_SIZE + piece.len();
+            let mut message = Vec::<u8>::with_capacity(size);
+
+            // Message header with magic number
+            message.extend_from_slice(&REQUEST_MAGIC_NUM.to_le_bytes());
+
+            // Unique message identifier
+            message.extend_from_slice(&self.message_id.to_le_bytes());
+            self.message_id += 1;
+
+            // Message type for body pieces
+            message.extend_from_slice(&(MessageType::Body as u16).to_le_bytes());
+
+            // Message size, known up front
+            message.extend_from_slice(&(size as u16).to_le_bytes());
+
+            // Task ID, body length and offset of the piece
+            message.extend_from_slice(&task_id.to_le_bytes());
+            message.extend_from_slice(&(body.len() as u32).to_le_bytes());
+            message.extend_from_slice(&(offset as u32).to_le_bytes());
+
+            // Bytes of the piece
+            message.extend_from_slice(piece);
+            offset += piece.len();
+            messages.push(message);
+        }
+        debug!(
+            "send body, tid {} size {} messages {}",
+            task_id,
+            body.len(),
+            messages.len()
+        );
+        messages
+    }
+
+    /// Builds an HTTP response message for the client.
+    ///
+    /// This method constructs an HTTP response message with the given task ID,
     /// version, status code, reason, and headers.
     ///
     /// # Arguments
@@ -572,14 +870,14 @@ impl Client {
     /// * `status_code` - HTTP status code
     /// * `reason` - Reason phrase
     /// * `headers` - HTTP headers
-    async fn handle_send_response(
+    fn build_response(
         &mut self,
         tid: u32,
         version: String,
         status_code: u32,
         reason: String,
         headers: Headers,
-    ) {
+    ) -> Vec<u8> {
         let mut response = Vec::<u8>::new();
 
         // Message header with magic number
@@ -645,26 +943,29 @@ impl Client {
         let size = size.to_le_bytes();
         response[POSITION_OF_LENGTH as usize] = size[0];
         response[(POSITION_OF_LENGTH + 1) as usize] = size[1];
-
-        // Send the constructed message
-        self.send_message(response).await;
+        response
     }
 
-    /// Handles sending notification data to the client.
+    /// Builds a notification data message for the client.
     ///
-    /// This method constructs and sends a notification message with the given subscription type
+    /// This method constructs a notification message with the given subscription type
     /// and notification data, including progress information, state, and file statuses.
+    /// Clients that negotiated it get the compact v2 encoding.
     ///
     /// # Arguments
     ///
     /// * `subscribe_type` - Type of subscription
     /// * `notify_data` - Notification data containing task information
-    async fn handle_send_notify_data(
+    fn build_notify_data(
         &mut self,
         subscribe_type: SubscribeType,
         notify_data: NotifyData,
-    ) {
+    ) -> (MessageType, Vec<u8>) {
         let mut message = Vec::<u8>::new();
+        let message_type = match self.notify_encoder {
+            Some(_) => MessageType::NotifyDataV2,
+            None => MessageType::NotifyData,
+        };
 
         // Message header with magic number
         message.extend_from_slice(&REQUEST_MAGIC_NUM.to_le_bytes());
@@ -674,13 +975,70 @@ impl Client {
         self.message_id += 1;
 
         // Message type for notification data
-        let message_type = MessageType::NotifyData as u16;
-        message.extend_from_slice(&message_type.to_le_bytes());
+        message.extend_from_slice(&(message_type as u16).to_le_bytes());
 
         // Message body size (initially 0, will be updated later)
         let message_body_size: u16 = 0;
         message.extend_from_slice(&message_body_size.to_le_bytes());
 
+        // Add extra information, respecting size limit
+        // The maximum length of the headers in uds should not exceed 8192
+        let mut buf_size = 0;
+        let extras_limit = notify_data
+            .progress
+            .extras
+            .iter()
+            .take_while(|x| {
+                buf_size += x.0.len() + x.1.len();
+                buf_size < HEADERS_MAX_SIZE as usize
+            })
+            .count();
+
+        let task_id = notify_data.task_id;
+        #[cfg(feature = "oh")]
+        let _trace = RequestTrace::of_task(task_id, "notify");
+        cpu::measure(task_id, Path::Notify, || {
+            match self.notify_encoder.as_mut() {
+                Some(encoder) => {
+                    encoder.encode(&mut message, subscribe_type, notify_data, extras_limit)
+                }
+                None => Self::encode_notify_data(
+                    &mut message,
+                    subscribe_type,
+                    notify_data,
+                    extras_limit,
+                ),
+            }
+        });
+
+        // Update the message size
+        let size = message.len() as u16;
+        if subscribe_type == SubscribeType::Progress {
+            debug!("send tid {} {:?} size {}", task_id, subscribe_type, size);
+        } else {
+            info!("send {} {:?}", task_id, subscribe_type);
+        }
+
+        let size = size.to_le_bytes();
+        message[POSITION_OF_LENGTH as usize] = size[0];
+        message[(POSITION_OF_LENGTH + 1) as usize] = size[1];
+        (message_type, message)
+    }
+
+    /// Appends the v1 body of a notification data message.
+    ///
+    /// # Arguments
+    ///
+    /// * `message` - Message buffer, already holding the header
+    /// * `subscribe_type` - Type of subscription
+    /// * `notify_data` - Notification data containing task information
+    /// * `extras_limit` - Number of extras that fit into the message
+    fn encode_notify_data(
+        message: &mut Vec<u8>,
+        subscribe_type: SubscribeType,
+        notify_data: NotifyData,
+        extras_limit: usize,
+    ) {
         // Subscription type
         message.extend_from_slice(&(subscribe_type as u32).to_le_bytes());
 
@@ -707,28 +1065,19 @@ impl Client {
             message.extend_from_slice(&size.to_le_bytes());
         }
 
-        // Add extra information, respecting size limit
-        // The maximum length of the headers in uds should not exceed 8192
-        let mut buf_size = 0;
-        let index = notify_data
-            .progress
-            .extras
-            .iter()
-            .take_while(|x| {
-                buf_size += x.0.len() + x.1.len();
-                buf_size < HEADERS_MAX_SIZE as usize
-            })
-            .count();
-
-        message.extend_from_slice(&(index as u32).to_le_bytes());
+        message.extend_from_slice(&(extras_limit as u32).to_le_bytes());
         // Add key-value pairs as null-terminated strings
-        for (key, value) in notify_data.progress.extras.iter().take(index) {
+        for (key, value) in notify_data.progress.extras.iter().take(extras_limit) {
             message.extend_from_slice(key.as_bytes());
             message.push(b'\0');
             message.extend_from_slice(value.as_bytes());
             message.push(b'\0');
         }
 
+        // Average speed and estimated seconds left
+        message.extend_from_slice(&notify_data.progress.speed.to_le_bytes());
+        message.extend_from_slice(&notify_data.progress.eta.to_le_bytes());
+
         // Action code
         message.extend_from_slice(&(notify_data.action.repr as u32).to_le_bytes());
 
@@ -747,78 +1096,251 @@ impl Client {
             message.extend_from_slice(&status.message.into_bytes());
             message.push(b'\0');
         }
+    }
 
-        // Update the message size
-        let size = message.len() as u16;
-        if subscribe_type == SubscribeType::Progress {
-            debug!(
-                "send tid {} {:?} size {}",
-                notify_data.task_id, subscribe_type, size
-            );
-        } else {
-            info!(
-                "send {} {:?}",
-                notify_data.task_id, subscribe_type
-            );
+    /// Sends the built messages to the client in order.
+    ///
+    /// Consecutive NotifyData, Faults and Waiting messages are packed into batch
+    /// datagrams of at most `BATCH_MAX_SIZE` bytes, so that the client is woken up
+    /// and acknowledges once per batch instead of once per message. HTTP responses
+    /// and oversized messages are always sent on their own.
+    ///
+    /// # Arguments
+    ///
+    /// * `messages` - Built messages together with their types
+    async fn flush_messages(&mut self, messages: Vec<(MessageType, Vec<u8>)>) {
+        let mut batch: Vec<Vec<u8>> = Vec::new();
+        let mut batch_size = MESSAGE_HEADER_SIZE;
+        for (message_type, message) in messages {
+            let oversized = message.len() + MESSAGE_HEADER_SIZE > BATCH_MAX_SIZE;
+            if !message_type.batchable() || oversized {
+                self.send_batch(std::mem::take(&mut batch)).await;
+                batch_size = MESSAGE_HEADER_SIZE;
+                self.send_message(message).await;
+                continue;
+            }
+            if batch_size + message.len() > BATCH_MAX_SIZE {
+                self.send_batch(std::mem::take(&mut batch)).await;
+                batch_size = MESSAGE_HEADER_SIZE;
+            }
+            batch_size += message.len();
+            batch.push(message);
         }
+        self.send_batch(batch).await;
+    }
 
-        let size = size.to_le_bytes();
-        message[POSITION_OF_LENGTH as usize] = size[0];
-        message[(POSITION_OF_LENGTH + 1) as usize] = size[1];
+    /// Packs the given messages into one batch datagram and sends it.
+    ///
+    /// The batch header reuses the message id of its first record, and each record
+    /// keeps its own complete header, so the client checks the message sequence
+    /// exactly as for unbatched messages. A single message is sent unwrapped.
+    ///
+    /// # Arguments
+    ///
+    /// * `records` - Complete messages to pack, at most `BATCH_MAX_SIZE` in total
+    async fn send_batch(&mut self, mut records: Vec<Vec<u8>>) {
+        match records.len() {
+            0 => return,
+            1 => {
+                if let Some(message) = records.pop() {
+                    self.send_message(message).await;
+                }
+                return;
+            }
+            _ => {}
+        }
+        let size: usize = MESSAGE_HEADER_SIZE + records.iter().map(|r| r.len()).sum::<usize>();
+        let mut message = Vec::<u8>::with_capacity(size);
+
+        // Message header with magic number
+        message.extend_from_slice(&REQUEST_MAGIC_NUM.to_le_bytes());
+
+        // The id of the first record, the batch itself does not consume one
+        message.extend_from_slice(&records[0][4..8]);
+
+        // Message type for batches
+        let message_type = MessageType::Batch as u16;
+        message.extend_from_slice(&message_type.to_le_bytes());
+
+        // Message size, including the header
+        message.extend_from_slice(&(size as u16).to_le_bytes());
 
-        // Send the constructed message
+        // Complete records, each with its own header
+        for record in records.iter() {
+            message.extend_from_slice(record);
+        }
+        debug!(
+            "send batch, pid {} records {} size {}",
+            self.pid,
+            records.len(),
+            size
+        );
         self.send_message(message).await;
     }
 
     /// Sends a message to the client through the Unix domain socket.
     ///
-    /// This method sends a message to the client and waits for an acknowledgment
-    /// to ensure delivery. It includes a timeout to prevent hanging if the client
-    /// doesn't respond.
+    /// In `Ack` mode this waits for the client to acknowledge the message, in
+    /// `Credit` mode it only waits when no credits are left. Both waits are
+    /// bounded by `FLOW_CONTROL_TIMEOUT` so a stuck client can not block the
+    /// handler forever.
     ///
     /// # Arguments
     ///
     /// * `message` - The message buffer to send
     async fn send_message(&mut self, message: Vec<u8>) {
+        if self.flow_control == FlowControl::Credit(0) {
+            self.wait_for_credits().await;
+        }
+
         // Send the message
         let ret = self.server_sock_fd.send(&message).await;
         match ret {
             Ok(size) => {
                 debug!("send message ok, pid: {}, size: {}", self.pid, size);
-                let mut buf: [u8; 4] = [0; 4];
-
-                // Wait for acknowledgment with a 500ms timeout
-                match ylong_runtime::time::timeout(
-                    Duration::from_millis(500),
-                    self.server_sock_fd.recv(&mut buf),
-                )
-                .await
-                {
-                    Ok(ret) => match ret {
-                        Ok(len) => {
-                            debug!("message recv len {:}", len);
-                        }
-                        Err(e) => {
-                            debug!("message recv error: {:?}", e);
-                        }
-                    },
-                    Err(e) => {
-                        debug!("message recv {}", e);
-                        return;
+                self.sent += 1;
+                metrics::CLIENT_MESSAGES.add(1);
+                metrics::CLIENT_MESSAGE_BYTES.add(size as u64);
+                match self.flow_control {
+                    FlowControl::Credit(credits) => {
+                        self.flow_control = FlowControl::Credit(credits.saturating_sub(1));
+                    }
+                    FlowControl::Ack => {
+                        let start = Instant::now();
+                        self.wait_for_ack(message.len()).await;
+                        metrics::CLIENT_ACK_WAIT_US.record_since(start);
                     }
-                };
-
-                // Verify the acknowledgment contains the correct message length
-                let len: u32 = u32::from_le_bytes(buf);
-                if len != message.len() as u32 {
-                    debug!("message len bad, send {:?}, recv {:?}", message.len(), len);
-                } else {
-                    debug!("notify done, pid: {}", self.pid);
                 }
             }
             Err(err) => {
                 error!("message send error: {:?}", err);
+                metrics::CLIENT_SEND_ERRORS.add(1);
+                // The client missed a message, so it can not follow the v2 deltas anymore
+                if let Some(encoder) = self.notify_encoder.as_mut() {
+                    encoder.reset();
+                }
+            }
+        }
+    }
+
+    /// Waits for the acknowledgment of a message sent in `Ack` mode.
+    ///
+    /// A credit grant received instead switches the connection to `Credit` mode.
+    ///
+    /// # Arguments
+    ///
+    /// * `message_len` - Length of the message waiting to be acknowledged
+    async fn wait_for_ack(&mut self, message_len: usize) {
+        let mut buf: [u8; 12] = [0; 12];
+        let len = match self.recv_flow_control(&mut buf).await {
+            Some(len) => len,
+            None => return,
+        };
+        if let Some((credits, capabilities)) = credit_grant(&buf[..len]) {
+            info!(
+                "client pid {} uses credits, granted {} capabilities {}",
+                self.pid, credits, capabilities
+            );
+            self.flow_control = FlowControl::Credit(credits);
+            if capabilities & CAPABILITY_NOTIFY_DATA_V2 != 0 {
+                self.notify_encoder = Some(NotifyEncoder::new());
+            }
+            if capabilities & CAPABILITY_RUN_COUNT != 0 {
+                self.run_count = true;
+            }
+            return;
+        }
+
+        // Verify the acknowledgment contains the correct message length
+        let mut ack: [u8; 4] = [0; 4];
+        ack.copy_from_slice(&buf[..4]);
+        let len: u32 = u32::from_le_bytes(ack);
+        if len != message_len as u32 {
+            debug!("message len bad, send {:?}, recv {:?}", message_len, len);
+        } else {
+            debug!("notify done, pid: {}", self.pid);
+        }
+    }
+
+    /// Waits for a credit grant once all credits have been used.
+    ///
+    /// On timeout the next message is sent anyway, which is the same worst case
+    /// as waiting for an acknowledgment.
+    async fn wait_for_credits(&mut self) {
+        let mut buf: [u8; 12] = [0; 12];
+        let len = match self.recv_flow_control(&mut buf).await {
+            Some(len) => len,
+            None => return,
+        };
+        match credit_grant(&buf[..len]) {
+            Some((credits, _)) => {
+                debug!("client pid {} granted {}", self.pid, credits);
+                self.flow_control = FlowControl::Credit(credits);
             }
+            None => debug!("client pid {} bad credit grant, len {}", self.pid, len),
         }
     }
+
+    /// Receives one flow control datagram from the client.
+    ///
+    /// # Returns
+    ///
+    /// The received length, or `None` on error or timeout.
+    async fn recv_flow_control(&mut self, buf: &mut [u8; 12]) -> Option<usize> {
+        match ylong_runtime::time::timeout(FLOW_CONTROL_TIMEOUT, self.server_sock_fd.recv(buf))
+            .await
+        {
+            Ok(Ok(len)) if len >= 4 => {
+                debug!("message recv len {:}", len);
+                Some(len)
+            }
+            Ok(Ok(len)) => {
+                debug!("message recv short len {:}", len);
+                None
+            }
+            Ok(Err(e)) => {
+                debug!("message recv error: {:?}", e);
+                None
+            }
+            Err(e) => {
+                debug!("message recv {}", e);
+                metrics::CLIENT_ACK_TIMEOUTS.add(1);
+                None
+            }
+        }
+    }
+}
+
+/// Parses a credit grant: the credit magic number followed by the number of
+/// credits and, in the first grant only, the capabilities of the client, all as
+/// little endian u32.
+///
+/// # Returns
+///
+/// The credits and capabilities, or `None` if `buf` is not a credit grant.
+pub(crate) fn credit_grant(buf: &[u8]) -> Option<(u32, u32)> {
+    if buf.len() != 8 && buf.len() != 12 {
+        return None;
+    }
+    let read = |i: usize| {
+        let mut bytes: [u8; 4] = [0; 4];
+        bytes.copy_from_slice(&buf[i..i + 4]);
+        u32::from_le_bytes(bytes)
+    };
+    if read(0) != CREDIT_MAGIC_NUM {
+        return None;
+    }
+    let capabilities = if buf.len() == 12 { read(8) } else { 0 };
+    Some((read(4), capabilities))
+}
+
+#[cfg(test)]
+mod ut_body {
+    include!("../../../tests/ut/client/ut_body.rs");
+}
+
+// Built by the `rust_request_uds_benchmark` target only.
+#[cfg(all(test, uds_bench))]
+mod bench_uds {
+    include!("../../../tests/bench/bench_uds.rs");
 }
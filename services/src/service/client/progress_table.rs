@@ -0,0 +1,275 @@
+// Copyright (C) 2024 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Shared-memory progress table of a client process.
+//!
+//! Next to its channel, a client can map a table holding the latest progress
+//! of each task it subscribed to, and poll it without any IPC. The table is a
+//! sealed memfd the service writes and the client maps read-only. Each slot is
+//! guarded by a sequence lock: the service, the only writer, makes the
+//! sequence odd while it writes the slot, and a reader retries if it saw an
+//! odd sequence or the sequence changed during its read.
+//!
+//! The layout, in native byte order, is mirrored by `RequestManagerImpl` in
+//! `frameworks/native/request`:
+//!
+//! - header: magic `u32`, version `u32`, capacity `u32`, reserved `u32`
+//! - `capacity` slots: seq `u32`, tid `u32`, state `u32`, flags `u32`,
+//!   processed `u64`, total `i64`, mtime `u64`
+
+use std::collections::HashMap;
+use std::fs::File;
+use std::mem::size_of;
+use std::os::fd::FromRawFd;
+use std::os::raw::{c_char, c_int, c_uint, c_void};
+use std::ptr;
+use std::sync::atomic::{fence, AtomicI64, AtomicU32, AtomicU64, Ordering};
+
+use crate::task::notify::NotifyData;
+use crate::utils::get_current_timestamp;
+
+/// Magic number of the table header.
+pub(crate) const PROGRESS_TABLE_MAGIC: u32 = 0x52505447;
+
+/// Version of the table layout.
+pub(crate) const PROGRESS_TABLE_VERSION: u32 = 1;
+
+/// Number of slots of a table. Tasks beyond it are only notified.
+pub(crate) const PROGRESS_TABLE_CAPACITY: usize = 256;
+
+/// Flag of a slot holding the progress of a task.
+const SLOT_USED: u32 = 0x01;
+
+const MFD_CLOEXEC: c_uint = 0x01;
+const MFD_ALLOW_SEALING: c_uint = 0x02;
+const F_ADD_SEALS: c_int = 1033;
+const F_SEAL_SEAL: c_int = 0x01;
+const F_SEAL_SHRINK: c_int = 0x02;
+const F_SEAL_GROW: c_int = 0x04;
+const PROT_READ: c_int = 0x01;
+const PROT_WRITE: c_int = 0x02;
+const MAP_SHARED: c_int = 0x01;
+
+extern "C" {
+    fn memfd_create(name: *const c_char, flags: c_uint) -> c_int;
+    fn fcntl(fd: c_int, cmd: c_int, ...) -> c_int;
+    fn mmap(
+        addr: *mut c_void,
+        len: usize,
+        prot: c_int,
+        flags: c_int,
+        fd: c_int,
+        offset: i64,
+    ) -> *mut c_void;
+    fn munmap(addr: *mut c_void, len: usize) -> c_int;
+}
+
+#[repr(C)]
+struct Header {
+    magic: AtomicU32,
+    version: AtomicU32,
+    capacity: AtomicU32,
+    reserved: AtomicU32,
+}
+
+#[repr(C)]
+struct Slot {
+    seq: AtomicU32,
+    tid: AtomicU32,
+    state: AtomicU32,
+    flags: AtomicU32,
+    processed: AtomicU64,
+    total: AtomicI64,
+    mtime: AtomicU64,
+}
+
+/// Progress of a task as published in its slot.
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub(crate) struct ProgressRecord {
+    /// Raw state of the task.
+    pub(crate) state: u32,
+    /// Bytes processed across all files.
+    pub(crate) processed: u64,
+    /// Bytes of all files, -1 if the size of a file is unknown.
+    pub(crate) total: i64,
+    /// Time of the record, in milliseconds since the epoch.
+    pub(crate) mtime: u64,
+}
+
+impl ProgressRecord {
+    /// Builds the record of a notification, stamped with the current time.
+    pub(crate) fn from_notify_data(notify_data: &NotifyData) -> Self {
+        let sizes = &notify_data.progress.sizes;
+        let total = if sizes.iter().any(|size| *size < 0) {
+            -1
+        } else {
+            sizes.iter().sum()
+        };
+        Self {
+            state: notify_data.progress.common_data.state as u32,
+            processed: notify_data.progress.common_data.total_processed as u64,
+            total,
+            mtime: get_current_timestamp(),
+        }
+    }
+}
+
+/// Progress table of a client process, written by the `ClientManager`.
+pub(crate) struct ProgressTable {
+    file: File,
+    base: *mut c_void,
+    len: usize,
+    slots: HashMap<u32, usize>,
+    free: Vec<usize>,
+}
+
+// Safety: the mapping is owned by the table and only written through it.
+unsafe impl Send for ProgressTable {}
+
+impl ProgressTable {
+    /// Creates and maps an empty table, `None` if the memfd cannot be set up.
+    pub(crate) fn new() -> Option<Self> {
+        let name = b"request_progress\0";
+        // Safety: the name is nul terminated.
+        let fd = unsafe {
+            memfd_create(
+                name.as_ptr() as *const c_char,
+                MFD_CLOEXEC | MFD_ALLOW_SEALING,
+            )
+        };
+        if fd < 0 {
+            error!("progress table memfd_create failed");
+            return None;
+        }
+        // Safety: the fd was just created and is owned by nobody else.
+        let file = unsafe { File::from_raw_fd(fd) };
+        let len = size_of::<Header>() + PROGRESS_TABLE_CAPACITY * size_of::<Slot>();
+        if let Err(e) = file.set_len(len as u64) {
+            error!("progress table set_len failed {:?}", e);
+            return None;
+        }
+        // Clients must not resize the table under the mapping of the service.
+        // Safety: F_ADD_SEALS takes an int argument.
+        if unsafe { fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) } < 0 {
+            error!("progress table seal failed");
+            return None;
+        }
+        // Safety: the file is `len` bytes long and outlives the mapping.
+        let base = unsafe {
+            mmap(
+                ptr::null_mut(),
+                len,
+                PROT_READ | PROT_WRITE,
+                MAP_SHARED,
+                fd,
+                0,
+            )
+        };
+        if base as isize == -1 {
+            error!("progress table mmap failed");
+            return None;
+        }
+        let table = Self {
+            file,
+            base,
+            len,
+            slots: HashMap::new(),
+            free: (0..PROGRESS_TABLE_CAPACITY).rev().collect(),
+        };
+        let header = table.header();
+        header.version.store(PROGRESS_TABLE_VERSION, Ordering::Relaxed);
+        header
+            .capacity
+            .store(PROGRESS_TABLE_CAPACITY as u32, Ordering::Relaxed);
+        header.magic.store(PROGRESS_TABLE_MAGIC, Ordering::Release);
+        Some(table)
+    }
+
+    /// Returns a new descriptor of the table to send to the client.
+    pub(crate) fn share(&self) -> std::io::Result<File> {
+        self.file.try_clone()
+    }
+
+    /// Publishes the progress of a task, taking a free slot for a new task.
+    ///
+    /// Returns `false` if the task is new and the table is full.
+    pub(crate) fn update(&mut self, tid: u32, record: ProgressRecord) -> bool {
+        let index = match self.slots.get(&tid) {
+            Some(index) => *index,
+            None => {
+                let Some(index) = self.free.pop() else {
+                    return false;
+                };
+                self.slots.insert(tid, index);
+                index
+            }
+        };
+        self.write(index, tid, SLOT_USED, record);
+        true
+    }
+
+    /// Frees the slot of a task.
+    pub(crate) fn remove(&mut self, tid: u32) {
+        if let Some(index) = self.slots.remove(&tid) {
+            let record = ProgressRecord {
+                state: 0,
+                processed: 0,
+                total: 0,
+                mtime: 0,
+            };
+            self.write(index, 0, 0, record);
+            self.free.push(index);
+        }
+    }
+
+    fn write(&self, index: usize, tid: u32, flags: u32, record: ProgressRecord) {
+        let slot = self.slot(index);
+        let seq = slot.seq.load(Ordering::Relaxed);
+        slot.seq.store(seq.wrapping_add(1), Ordering::Relaxed);
+        fence(Ordering::Release);
+        slot.tid.store(tid, Ordering::Relaxed);
+        slot.state.store(record.state, Ordering::Relaxed);
+        slot.flags.store(flags, Ordering::Relaxed);
+        slot.processed.store(record.processed, Ordering::Relaxed);
+        slot.total.store(record.total, Ordering::Relaxed);
+        slot.mtime.store(record.mtime, Ordering::Relaxed);
+        slot.seq.store(seq.wrapping_add(2), Ordering::Release);
+    }
+
+    fn header(&self) -> &Header {
+        // Safety: the mapping starts with the header and lives as long as self.
+        unsafe { &*(self.base as *const Header) }
+    }
+
+    fn slot(&self, index: usize) -> &Slot {
+        // Safety: `index` is below the capacity, so the slot is in the mapping.
+        unsafe {
+            let slots = (self.base as *const u8).add(size_of::<Header>()) as *const Slot;
+            &*slots.add(index)
+        }
+    }
+}
+
+impl Drop for ProgressTable {
+    fn drop(&mut self) {
+        // Safety: `base` and `len` are those of the mapping made in `new`.
+        unsafe {
+            munmap(self.base, self.len);
+        }
+    }
+}
+
+#[cfg(test)]
+mod ut_progress_table {
+    include!("../../../tests/ut/client/ut_progress_table.rs");
+}
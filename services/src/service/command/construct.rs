@@ -16,6 +16,9 @@
 //! This module implements the task construction logic for the request service, including
 //! permission checking, task creation, notification configuration, and client subscription.
 
+use std::fs::File;
+use std::os::fd::{FromRawFd, IntoRawFd};
+
 use ipc::parcel::MsgParcel;
 use ipc::{IpcResult, IpcStatusCode};
 
@@ -27,6 +30,7 @@ use crate::service::notification_bar::{NotificationConfig, NotificationDispatche
 use crate::service::permission::PermissionChecker;
 use crate::service::RequestServiceStub;
 use crate::task::config::TaskConfig;
+use crate::task::handoff;
 use crate::utils::{check_permission, is_system_api};
 
 impl RequestServiceStub {
@@ -85,13 +89,18 @@ impl RequestServiceStub {
         let notification_permission = 
             check_permission("ohos.permission.REQUEST_DISABLE_NOTIFICATION");
 
+        // Construct events sent to the task manager, with their result receivers
+        let mut pending = Vec::with_capacity(len);
+
         for i in 0..len {
             // Read both configurations before processing to ensure complete data retrieval
             let task_config = data.read::<TaskConfig>();
             let notification_config = data.read::<NotificationConfig>();
+            let cached_body = read_cached_body(data).unwrap_or(None);
+            let opened_files = read_opened_files(data).unwrap_or_default();
 
             // Validate task configuration
-            let task_config = match task_config {
+            let mut task_config = match task_config {
                 Ok(config) => config,
                 Err(e) => {
                     // Set error code for this task and continue to next task
@@ -102,7 +111,7 @@ impl RequestServiceStub {
             };
 
             // Validate notification configuration
-            let mut notification_config = match notification_config {
+            let notification_config = match notification_config {
                 Ok(config) => config,
                 Err(e) => {
                     set_code_with_index_other(&mut vec, i, ErrorCode::ParameterCheck);
@@ -112,6 +121,16 @@ impl RequestServiceStub {
             };
 
             debug!("Service construct: task_config constructed");
+            // The files the application opened are used instead of their paths
+            for (idx, file) in opened_files {
+                match task_config.file_specs.get_mut(idx) {
+                    Some(spec) if !spec.is_user_file && spec.fd.is_none() => {
+                        spec.fd = Some(file.into_raw_fd());
+                    }
+                    _ => error!("Service construct: invalid opened file {}", idx),
+                }
+            }
+            let cached_body = cached_body.filter(|_| handoff::accepts(&task_config));
             // Extract task mode for notification configuration
             let mode = task_config.common_data.mode;
             // Create construction event and response channel
@@ -121,6 +140,12 @@ impl RequestServiceStub {
                 set_code_with_index_other(&mut vec, i, ErrorCode::Other);
                 continue;
             }
+            pending.push((i, mode, notification_config, cached_body, rx));
+        }
+
+        // Every event is queued before waiting for any result, so the task
+        // manager creates the whole batch back to back
+        for (i, mode, mut notification_config, cached_body, rx) in pending {
             // Wait for task creation result
             let ret = match rx.get() {
                 Some(ret) => ret,
@@ -151,6 +176,15 @@ impl RequestServiceStub {
                 }
             };
 
+            if let Some(body) = cached_body {
+                if !handoff::hand_over(task_id, body) {
+                    info!(
+                        "Service construct: too many bodies handed over, {}",
+                        task_id
+                    );
+                }
+            }
+
             // Associate notification config with the newly created task
             notification_config.task_id = task_id;
             // Update notification settings for this task
@@ -202,3 +236,43 @@ impl RequestServiceStub {
         Ok(())
     }
 }
+
+/// Reads the body the application preloaded for the URL of a task, if it
+/// handed one over.
+fn read_cached_body(data: &mut MsgParcel) -> IpcResult<Option<File>> {
+    let handed_over: bool = data.read()?;
+    if !handed_over {
+        return Ok(None);
+    }
+    // Safety: Assumes the IPC system provides a valid file descriptor
+    let raw_fd = unsafe { data.read_raw_fd() };
+    if raw_fd < 0 {
+        error!("Service construct: invalid cached body fd {}", raw_fd);
+        return Err(IpcStatusCode::Failed);
+    }
+    // Safety: Transfers ownership of the raw file descriptor
+    Ok(Some(unsafe { File::from_raw_fd(raw_fd) }))
+}
+
+/// Reads the files of the sandbox the application already opened for a
+/// task, with the indexes of their file specs.
+fn read_opened_files(data: &mut MsgParcel) -> IpcResult<Vec<(usize, File)>> {
+    let len: u32 = data.read()?;
+    if len > data.readable() as u32 {
+        error!("Service construct: opened files size too large {}", len);
+        return Err(IpcStatusCode::Failed);
+    }
+    let mut files = Vec::with_capacity(len as usize);
+    for _ in 0..len {
+        let idx: u32 = data.read()?;
+        // Safety: Assumes the IPC system provides a valid file descriptor
+        let raw_fd = unsafe { data.read_raw_fd() };
+        if raw_fd < 0 {
+            error!("Service construct: invalid opened file fd {}", raw_fd);
+            return Err(IpcStatusCode::Failed);
+        }
+        // Safety: Transfers ownership of the raw file descriptor
+        files.push((idx as usize, unsafe { File::from_raw_fd(raw_fd) }));
+    }
+    Ok(files)
+}
@@ -23,12 +23,25 @@ use ipc::IpcResult;
 
 use crate::manage::events::TaskManagerEvent;
 use crate::service::RequestServiceStub;
+use crate::task::cpu;
+use crate::task::timeline::Timelines;
+use crate::utils::{metrics, startup};
 
 /// Help message displayed when the dump command is used incorrectly or with `-h` flag.
 const HELP_MSG: &str = "usage:\n\
                          -h                    help text for the tool\n\
                          -t [taskid]           without taskid: display all task summary info; \
-                         taskid: display one task detail info\n";
+                         taskid: display one task detail info\n\
+                         -s                    display the last scheduling decisions and \
+                         their latency histograms\n\
+                         -p [taskid]           without taskid: display the timelines of the \
+                         last tasks as JSON; taskid: display the timeline of one task\n\
+                         -m                    display the counters and latency \
+                         histograms of the service\n\
+                         -b                    display the time of each init phase of \
+                         the last start of the service\n\
+                         -c                    display the CPU the service spent on the \
+                         tasks of each uid\n";
 impl RequestServiceStub {
     /// Dumps task information to a file based on provided arguments.
     ///
@@ -47,6 +60,12 @@ impl RequestServiceStub {
     /// - `-h`: Display help message
     /// - `-t`: Dump summary information for all tasks
     /// - `-t [taskid]`: Dump detailed information for a specific task
+    /// - `-s`: Dump the trace of the scheduling decisions
+    /// - `-p [taskid]`: Dump the performance timelines of the last tasks or
+    ///   of a specific task
+    /// - `-m`: Dump the counters and histograms of the service
+    /// - `-b`: Dump the startup breakdown of the service
+    /// - `-c`: Dump the CPU spent on the tasks of each uid
     pub(crate) fn dump(&self, mut file: File, args: Vec<String>) -> IpcResult<()> {
         info!("Service dump");
 
@@ -57,6 +76,66 @@ impl RequestServiceStub {
             return Ok(());
         }
 
+        // Dump the scheduling decisions when `-s` is provided
+        if args[0] == "-s" {
+            if len == 1 {
+                self.dump_schedule_trace(file);
+            } else {
+                let _ = file.write("too many args, -s accept no arg".as_bytes());
+            }
+            return Ok(());
+        }
+
+        // Dump the metrics when `-m` is provided
+        if args[0] == "-m" {
+            if len == 1 {
+                info!("Service dump metrics");
+                let _ = file.write(metrics::dump().as_bytes());
+            } else {
+                let _ = file.write("too many args, -m accept no arg".as_bytes());
+            }
+            return Ok(());
+        }
+
+        // Dump the startup breakdown when `-b` is provided
+        if args[0] == "-b" {
+            if len == 1 {
+                info!("Service dump startup");
+                let _ = file.write(startup::dump().as_bytes());
+            } else {
+                let _ = file.write("too many args, -b accept no arg".as_bytes());
+            }
+            return Ok(());
+        }
+
+        // Dump the CPU of the uids when `-c` is provided
+        if args[0] == "-c" {
+            if len == 1 {
+                info!("Service dump cpu");
+                let _ = file.write(cpu::dump().as_bytes());
+            } else {
+                let _ = file.write("too many args, -c accept no arg".as_bytes());
+            }
+            return Ok(());
+        }
+
+        // Dump the performance timelines when `-p` is provided
+        if args[0] == "-p" {
+            match len {
+                1 => self.dump_timeline(file, None),
+                2 => match args[1].parse::<u32>() {
+                    Ok(id) => self.dump_timeline(file, Some(id)),
+                    Err(_) => {
+                        let _ = file.write("-p accept a number".as_bytes());
+                    }
+                },
+                _ => {
+                    let _ = file.write("too many args, -p accept no arg or one arg".as_bytes());
+                }
+            }
+            return Ok(());
+        }
+
         // Validate that the first argument is `-t`
         if args[0] != "-t" {
             let _ = file.write("invalid args".as_bytes());
@@ -138,6 +217,52 @@ impl RequestServiceStub {
         }
     }
 
+    /// Dumps the trace of the last scheduling decisions to the provided file.
+    ///
+    /// # Arguments
+    ///
+    /// * `file` - File to write the trace to.
+    fn dump_schedule_trace(&self, mut file: File) {
+        info!("Service dump schedule trace");
+
+        let (event, rx) = TaskManagerEvent::dump_trace();
+        if !self.task_manager.lock().unwrap().send_event(event) {
+            return;
+        }
+        match rx.get() {
+            Some(trace) => {
+                let _ = file.write(trace.as_bytes());
+            }
+            None => {
+                error!("Service dump: receives trace failed");
+                sys_event!(ExecFault, DfxCode::UDS_FAULT_03, "Service dump: receives trace failed");
+            }
+        }
+    }
+
+    /// Dumps the performance timelines of the last tasks, or of one task, as
+    /// JSON to the provided file.
+    ///
+    /// # Arguments
+    ///
+    /// * `file` - File to write the timelines to.
+    /// * `task_id` - Task whose timeline is dumped, `None` for all of them.
+    fn dump_timeline(&self, mut file: File, task_id: Option<u32>) {
+        info!("Service dump timeline");
+
+        match Timelines::get_instance().dump(task_id) {
+            Some(timeline) => {
+                let _ = file.write(timeline.as_bytes());
+            }
+            // Only a single task may have no timeline
+            None => {
+                let _ = file.write(
+                    format!("no timeline of task {}", task_id.unwrap_or_default()).as_bytes(),
+                );
+            }
+        }
+    }
+
     /// Dumps detailed information for a specific task to the provided file.
     ///
     /// # Arguments
@@ -0,0 +1,55 @@
+// Copyright (C) 2024 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Reading of the counters and latency histograms of the service.
+
+use ipc::parcel::MsgParcel;
+use ipc::{IpcResult, IpcStatusCode};
+
+use crate::error::ErrorCode;
+use crate::service::RequestServiceStub;
+use crate::utils::{is_system_api, metrics};
+
+impl RequestServiceStub {
+    /// Writes the metrics of the service to the reply parcel.
+    ///
+    /// # Arguments
+    ///
+    /// * `reply` - Output parcel to write the result code, the number of
+    ///   metrics and the name and value of each metric to.
+    ///
+    /// # Returns
+    ///
+    /// * `Ok(())` - The metrics were written to the reply parcel.
+    /// * `Err(IpcStatusCode::Failed)` - The caller is not a system application.
+    ///
+    /// # Notes
+    ///
+    /// The values only grow, callers compute rates from two readings.
+    pub(crate) fn get_stats(&self, reply: &mut MsgParcel) -> IpcResult<()> {
+        if !is_system_api() {
+            error!("Service get_stats: not system api");
+            reply.write(&(ErrorCode::SystemApi as i32))?;
+            return Err(IpcStatusCode::Failed);
+        }
+        debug!("Service get_stats");
+        let values = metrics::snapshot();
+        reply.write(&(ErrorCode::ErrOk as i32))?;
+        reply.write(&(values.len() as u32))?;
+        for (name, value) in values.iter() {
+            reply.write(name)?;
+            reply.write(value)?;
+        }
+        Ok(())
+    }
+}
@@ -17,13 +17,21 @@
 //! including task creation, control operations, information retrieval, and subscription management.
 //! Submodules implement specific command handlers for different operations.
 
+use std::collections::HashMap;
+
+use ipc::parcel::MsgParcel;
+use ipc::IpcResult;
+
 use crate::error::ErrorCode;
+use crate::manage::database::RequestDb;
 
 mod construct;      // Task creation and configuration
 mod dump;           // Task information dumping utilities
+mod get_stats;      // Counters and histograms of the service
 mod get_task;       // Task configuration retrieval
 mod notification_bar; // Notification system integration
 mod open_channel;   // Channel establishment for data transfer
+mod open_progress_table; // Shared progress table of the caller
 mod pause;          // Task pause operations
 mod query;          // Task state and information queries
 mod query_mime_type; // MIME type detection for resources
@@ -32,11 +40,14 @@ mod resume;         // Task resumption operations
 mod search;         // Task searching functionality
 mod set_max_speed;  // Bandwidth control for tasks
 mod set_mode;       // Task execution mode configuration
+mod set_schedule_policy; // Task order of the calling application
+mod shared_cache;   // Cache of bodies shared by preloads
 mod show;           // Task visibility management
 mod start;          // Task start operations
 mod stop;           // Task termination operations
 mod sub_runcount;   // Running count subscription
 mod subscribe;      // Task event subscription
+mod subscribe_tasks; // Bulk subscription after reconnection
 mod touch;          // Task metadata updates
 mod unsub_runcount; // Running count unsubscription
 mod unsubscribe;    // Task event unsubscription
@@ -102,3 +113,31 @@ pub(crate) fn set_code_with_index_other<T>(
         error!("out index: {}", index);
     }
 }
+
+/// Reads `len` task IDs and looks up the owners of all of them at once.
+///
+/// # Arguments
+///
+/// * `data` - Message parcel positioned at the first task ID.
+/// * `len` - Number of task IDs to read.
+///
+/// # Returns
+///
+/// The task IDs as sent by the client, and the owner uid of every valid ID
+/// that exists in the database.
+pub(crate) fn read_task_ids(
+    data: &mut MsgParcel,
+    len: usize,
+) -> IpcResult<(Vec<String>, HashMap<u32, u64>)> {
+    let mut task_ids = Vec::with_capacity(len);
+    for _ in 0..len {
+        let task_id: String = data.read()?;
+        task_ids.push(task_id);
+    }
+    let parsed = task_ids
+        .iter()
+        .filter_map(|task_id| task_id.parse::<u32>().ok())
+        .collect::<Vec<_>>();
+    let uids = RequestDb::get_instance().query_tasks_uid(&parsed);
+    Ok((task_ids, uids))
+}
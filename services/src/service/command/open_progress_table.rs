@@ -0,0 +1,60 @@
+// Copyright (C) 2024 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Progress table opening for lock-free progress polling.
+//!
+//! This module hands a client process a descriptor of its shared progress
+//! table, which the service keeps updated with the latest progress of the
+//! tasks the client subscribed to.
+
+use ipc::parcel::MsgParcel;
+use ipc::IpcResult;
+
+use crate::error::ErrorCode;
+use crate::service::RequestServiceStub;
+
+impl RequestServiceStub {
+    /// Opens the shared progress table of the calling process.
+    ///
+    /// The channel of the caller must have been opened first.
+    ///
+    /// # Arguments
+    ///
+    /// * `reply` - Output parcel to write the result code and, on success,
+    ///   the file descriptor of the table.
+    ///
+    /// # Returns
+    ///
+    /// * `Ok(())` - The result was written to the reply parcel.
+    ///
+    /// # Errors
+    ///
+    /// Writes an error code in the reply parcel if:
+    /// * The channel of the caller is not open (`ErrorCode::ChannelNotOpen`).
+    /// * The table could not be created or shared (`ErrorCode::Other`).
+    pub(crate) fn open_progress_table(&self, reply: &mut MsgParcel) -> IpcResult<()> {
+        let pid = ipc::Skeleton::calling_pid();
+        debug!("Service open_progress_table pid {}", pid);
+        match self.client_manager.open_progress_table(pid) {
+            Ok(file) => {
+                reply.write(&(ErrorCode::ErrOk as i32))?;
+                reply.write_file(file)?;
+            }
+            Err(err) => {
+                error!("End Service open_progress_table, failed: {:?}", err);
+                reply.write(&(err as i32))?;
+            }
+        }
+        Ok(())
+    }
+}
@@ -90,6 +90,9 @@ impl RequestServiceStub {
         let ipc_uid = ipc::Skeleton::calling_uid();
         // Initialize result vector with default error values
         let mut vec = vec![ErrorCode::Other; len];
+
+        // Pause events sent to the task manager, with their result receivers
+        let mut pending = Vec::with_capacity(len);
         for i in 0..len {
             let task_id: String = data.read()?;
             info!("Service pause tid {}", task_id);
@@ -152,7 +155,12 @@ impl RequestServiceStub {
                 set_code_with_index(&mut vec, i, ErrorCode::Other);
                 continue;
             }
+            pending.push((i, task_id, rx));
+        }
 
+        // Every event is queued before waiting for any result, so the task
+        // manager handles the whole batch back to back
+        for (i, task_id, rx) in pending {
             // Wait for pause operation result from task manager
             let ret = match rx.get() {
                 Some(ret) => ret,
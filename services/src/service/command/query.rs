@@ -21,10 +21,10 @@ use ipc::{IpcResult, IpcStatusCode};
 
 use crate::error::ErrorCode;
 use crate::info::TaskInfo;
-use crate::manage::database::RequestDb;
-use crate::service::command::{set_code_with_index_other, GET_INFO_MAX};
+use crate::manage::query;
+use crate::service::command::{read_task_ids, set_code_with_index_other, GET_INFO_MAX};
 use crate::service::permission::PermissionChecker;
-use crate::service::{serialize_task_info, RequestServiceStub};
+use crate::service::{serialize_task_info, RequestServiceStub, TASK_INFO_ALL};
 use crate::task::files::check_current_account;
 use crate::utils::is_system_api;
 
@@ -95,9 +95,14 @@ impl RequestServiceStub {
         // Initialize results vector with default error codes and empty task info
         let mut vec = vec![(ErrorCode::Other, TaskInfo::new()); len];
         
+        // Read every task ID up front, their owners come from a single query
+        let (task_ids, uids) = read_task_ids(data, len)?;
+
+        // Read the optional parts of the task info to send, all by default
+        let fields: u32 = data.read().unwrap_or(TASK_INFO_ALL);
+
         // Process each task ID individually
-        for i in 0..len {
-            let task_id: String = data.read()?;
+        for (i, task_id) in task_ids.into_iter().enumerate() {
             info!("Service query tid {}", task_id);
 
             // Validate and convert task ID format
@@ -113,8 +118,8 @@ impl RequestServiceStub {
             };
 
             // Check if task exists and get its UID
-            let task_uid = match RequestDb::get_instance().query_task_uid(task_id) {
-                Some(uid) => uid,
+            let task_uid = match uids.get(&task_id) {
+                Some(uid) => *uid,
                 None => {
                     set_code_with_index_other(&mut vec, i, ErrorCode::TaskNotFound);
                     continue;
@@ -128,7 +133,7 @@ impl RequestServiceStub {
             }
 
             // Query task manager for detailed information
-            let info = self.task_manager.lock().unwrap().query(task_id, action);
+            let info = query::query(task_id, action);
             match info {
                 Some(task_info) => {
                     if let Some((c, info)) = vec.get_mut(i) {
@@ -155,7 +160,7 @@ impl RequestServiceStub {
         for (c, info) in vec {
             reply.write(&(c as i32))?;
             // TODO: Sends info only when ErrOk.
-            serialize_task_info(info, reply)?;
+            serialize_task_info(info, fields, reply)?;
         }
         Ok(())
     }
@@ -88,6 +88,9 @@ impl RequestServiceStub {
         
         // Initialize results vector with default error codes
         let mut vec = vec![ErrorCode::Other; len];
+
+        // Remove events sent to the task manager, with their result receivers
+        let mut pending = Vec::with_capacity(len);
         
         // Process each task ID individually
         for i in 0..len {
@@ -151,7 +154,12 @@ impl RequestServiceStub {
                 set_code_with_index(&mut vec, i, ErrorCode::Other);
                 continue;
             }
-            
+            pending.push((i, task_id, rx));
+        }
+
+        // Every event is queued before waiting for any result, so the task
+        // manager handles the whole batch back to back
+        for (i, task_id, rx) in pending {
             // Get result from task manager
             let ret = match rx.get() {
                 Some(ret) => ret,
@@ -29,7 +29,8 @@ impl RequestServiceStub {
     /// # Arguments
     ///
     /// * `data` - Message parcel containing search parameters: bundle name, time range,
-    ///   state, action, and mode
+    ///   state, action, and mode, then optionally the page size, page token and
+    ///   keyword
     /// * `reply` - Message parcel to write the search results to
     ///
     /// # Returns
@@ -40,7 +41,8 @@ impl RequestServiceStub {
     /// # Notes
     ///
     /// * System APIs search by bundle name, while user APIs search by UID
-    /// * Returns a list of matching task IDs as strings
+    /// * Returns a list of matching task IDs as strings, followed by the token
+    ///   of the next page
     pub(crate) fn search(&self, data: &mut MsgParcel, reply: &mut MsgParcel) -> IpcResult<()> {
         debug!("Service search");
         // Read bundle name for system API or UID for user API
@@ -74,6 +76,14 @@ impl RequestServiceStub {
         let mode: u32 = data.read()?;
         debug!("Service search: mode is {}", mode);
 
+        // Read the optional page size and page token, callers not sending
+        // them get all the tasks at once
+        let limit: u32 = data.read().unwrap_or(0);
+        let cursor: String = data.read().unwrap_or_default();
+
+        // Read the optional keyword, empty to match any task
+        let keyword: String = data.read().unwrap_or_default();
+
         // Construct task filter with all search criteria
         let filter = TaskFilter {
             before,
@@ -81,10 +91,21 @@ impl RequestServiceStub {
             state: state as u8,
             action: action as u8,
             mode: mode as u8,
+            keyword,
         };
 
         // Perform the search operation
-        let ids = query::search(filter, method);
+        let (ids, next) = if limit == 0 {
+            (query::search(filter, method), String::new())
+        } else {
+            match query::search_page(filter, method, limit, &cursor) {
+                Some(page) => page,
+                None => {
+                    error!("Service search: cursor not valid: {}", cursor);
+                    (Vec::new(), String::new())
+                }
+            }
+        };
         debug!("End Service search ok: search task ids is {:?}", ids);
         
         // Send the count of results first
@@ -94,6 +115,9 @@ impl RequestServiceStub {
         for it in ids.iter() {
             reply.write(&(it.to_string()))?;
         }
+
+        // Send the token of the next page, empty after the last one
+        reply.write(&next)?;
         Ok(())
     }
 }
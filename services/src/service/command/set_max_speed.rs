@@ -82,10 +82,25 @@ impl RequestServiceStub {
         // Initialize result vector with default error values
         let mut vec = vec![ErrorCode::Other; len];
         
-        // Process each task individually
-        for i in 0..len {
+        // Read every task ID and speed up front, the owners of the tasks come
+        // from a single query
+        let mut requests = Vec::with_capacity(len);
+        for _ in 0..len {
             let task_id: String = data.read()?;
             let max_speed: i64 = data.read()?;
+            requests.push((task_id, max_speed));
+        }
+        let parsed = requests
+            .iter()
+            .filter_map(|(task_id, _)| task_id.parse::<u32>().ok())
+            .collect::<Vec<_>>();
+        let uids = RequestDb::get_instance().query_tasks_uid(&parsed);
+
+        // Speed events sent to the task manager, with their result receivers
+        let mut pending = Vec::with_capacity(len);
+
+        // Process each task individually
+        for (i, (task_id, max_speed)) in requests.into_iter().enumerate() {
             
             // Validate speed limit is above minimum threshold
             if max_speed < MIN_SPEED_LIMIT {
@@ -122,14 +137,14 @@ impl RequestServiceStub {
             // For privileged callers, get the actual task owner UID from database
             if permission {
                 // skip uid check if task used by innerkits
-                match RequestDb::get_instance().query_task_uid(task_id) {
-                    Some(id) => uid = id,
+                match uids.get(&task_id) {
+                    Some(id) => uid = *id,
                     None => {
                         set_code_with_index(&mut vec, i, ErrorCode::TaskNotFound);
                         continue;
                     }
                 };
-            } else if !self.check_task_uid(task_id, uid) {
+            } else if uids.get(&task_id) != Some(&uid) {
                 // Verify task ownership for non-privileged callers
                 set_code_with_index(&mut vec, i, ErrorCode::TaskNotFound);
                 error!(
@@ -165,7 +180,12 @@ impl RequestServiceStub {
                 set_code_with_index(&mut vec, i, ErrorCode::Other);
                 continue;
             }
+            pending.push((i, task_id, rx));
+        }
 
+        // Every event is queued before waiting for any result, so the task
+        // manager handles the whole batch back to back
+        for (i, task_id, rx) in pending {
             // Receive result from task manager
             let Some(ret) = rx.get() else {
                 error!(
@@ -0,0 +1,80 @@
+// Copyright (C) 2023 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Schedule policy selection for the tasks of the calling application.
+//!
+//! This module provides a method to select how the scheduler orders the
+//! tasks of an application among themselves.
+
+use ipc::parcel::MsgParcel;
+use ipc::{IpcResult, IpcStatusCode};
+
+use crate::error::ErrorCode;
+use crate::manage::events::TaskManagerEvent;
+use crate::manage::scheduler::SchedulePolicy;
+use crate::service::RequestServiceStub;
+
+impl RequestServiceStub {
+    /// Selects the policy ordering the tasks of the calling application.
+    ///
+    /// # Arguments
+    ///
+    /// * `data` - Message parcel containing the policy
+    /// * `reply` - Message parcel to write the operation result to
+    ///
+    /// # Returns
+    ///
+    /// * `Ok(())` - If the policy was selected
+    /// * `Err(IpcStatusCode::Failed)` - If the policy is unknown or the task
+    ///   manager failed
+    ///
+    /// # Errors
+    ///
+    /// Returns error codes in the reply parcel:
+    /// * `ErrOk` - Policy selected successfully
+    /// * `ParameterCheck` - The policy is unknown
+    /// * `Other` - General failure in task manager or result retrieval
+    ///
+    /// # Notes
+    ///
+    /// The policy only applies to the tasks of the caller and is kept until
+    /// the service stops.
+    pub(crate) fn set_schedule_policy(
+        &self,
+        data: &mut MsgParcel,
+        reply: &mut MsgParcel,
+    ) -> IpcResult<()> {
+        let policy: u32 = data.read()?;
+        let Ok(policy) = SchedulePolicy::try_from(policy) else {
+            error!("Service set_schedule_policy, failed: policy not valid: {}", policy);
+            reply.write(&(ErrorCode::ParameterCheck as i32))?;
+            return Err(IpcStatusCode::Failed);
+        };
+        let uid = ipc::Skeleton::calling_uid();
+        info!("Service set_schedule_policy uid {} policy {:?}", uid, policy);
+
+        let (event, rx) = TaskManagerEvent::set_schedule_policy(uid, policy);
+        if !self.task_manager.lock().unwrap().send_event(event) {
+            error!("Service set_schedule_policy, failed: task_manager err: {}", uid);
+            reply.write(&(ErrorCode::Other as i32))?;
+            return Err(IpcStatusCode::Failed);
+        }
+        let Some(ret) = rx.get() else {
+            error!("Service set_schedule_policy, uid: {}, failed: receives ret failed", uid);
+            reply.write(&(ErrorCode::Other as i32))?;
+            return Err(IpcStatusCode::Failed);
+        };
+        reply.write(&(ret as i32))?;
+        Ok(())
+    }
+}
@@ -0,0 +1,111 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Shared cache access for preloads.
+//!
+//! This module lets preloads of applications look up and publish the bodies
+//! of the cache they share, see `crate::manage::shared_cache`.
+
+use std::fs::File;
+use std::os::fd::FromRawFd;
+
+use ipc::parcel::MsgParcel;
+use ipc::{IpcResult, IpcStatusCode};
+
+use crate::error::ErrorCode;
+use crate::manage::shared_cache::SHARED_CACHE;
+use crate::service::permission::PermissionChecker;
+use crate::service::RequestServiceStub;
+
+impl RequestServiceStub {
+    /// Opens the shared cached body of a URL for the calling application.
+    ///
+    /// # Arguments
+    ///
+    /// * `data` - Input parcel containing the URL.
+    /// * `reply` - Output parcel to write the result code and, on success,
+    ///   the read only file descriptor of the body.
+    ///
+    /// # Errors
+    ///
+    /// Writes an error code in the reply parcel if:
+    /// * The caller lacks the INTERNET permission (`ErrorCode::Permission`).
+    /// * No body can be served to the caller (`ErrorCode::TaskNotFound`).
+    pub(crate) fn open_shared_cache(
+        &self,
+        data: &mut MsgParcel,
+        reply: &mut MsgParcel,
+    ) -> IpcResult<()> {
+        if !PermissionChecker::check_internet() {
+            error!("Service open_shared_cache: no INTERNET permission");
+            reply.write(&(ErrorCode::Permission as i32))?;
+            return Err(IpcStatusCode::Failed);
+        }
+        let url: String = data.read()?;
+        let uid = ipc::Skeleton::calling_uid();
+        match SHARED_CACHE.open(uid, &url) {
+            Some(file) => {
+                debug!("Service open_shared_cache hit for {}", uid);
+                reply.write(&(ErrorCode::ErrOk as i32))?;
+                reply.write_file(file)?;
+            }
+            None => reply.write(&(ErrorCode::TaskNotFound as i32))?,
+        }
+        Ok(())
+    }
+
+    /// Publishes the body the calling application downloaded for a URL.
+    ///
+    /// # Arguments
+    ///
+    /// * `data` - Input parcel containing the URL and the file descriptor of
+    ///   the body.
+    /// * `reply` - Output parcel to write the result code.
+    ///
+    /// # Errors
+    ///
+    /// Writes an error code in the reply parcel if:
+    /// * The caller lacks the INTERNET permission (`ErrorCode::Permission`).
+    /// * The body is too large (`ErrorCode::ParameterCheck`).
+    /// * The body cannot be read or stored (`ErrorCode::FileOperationErr`).
+    pub(crate) fn publish_shared_cache(
+        &self,
+        data: &mut MsgParcel,
+        reply: &mut MsgParcel,
+    ) -> IpcResult<()> {
+        if !PermissionChecker::check_internet() {
+            error!("Service publish_shared_cache: no INTERNET permission");
+            reply.write(&(ErrorCode::Permission as i32))?;
+            return Err(IpcStatusCode::Failed);
+        }
+        let url: String = data.read()?;
+        // Safety: Assumes the IPC system provides a valid file descriptor
+        let raw_fd = unsafe { data.read_raw_fd() };
+        if raw_fd < 0 {
+            error!("Service publish_shared_cache: invalid fd {}", raw_fd);
+            reply.write(&(ErrorCode::ParameterCheck as i32))?;
+            return Err(IpcStatusCode::Failed);
+        }
+        // Safety: Transfers ownership of the raw file descriptor
+        let file = unsafe { File::from_raw_fd(raw_fd) };
+        let uid = ipc::Skeleton::calling_uid();
+        match SHARED_CACHE.publish(uid, &url, file) {
+            Ok(()) => reply.write(&(ErrorCode::ErrOk as i32))?,
+            Err(err) => {
+                error!("End Service publish_shared_cache, failed: {:?}", err);
+                reply.write(&(err as i32))?;
+            }
+        }
+        Ok(())
+    }
+}
@@ -21,10 +21,10 @@ use ipc::{IpcResult, IpcStatusCode};
 
 use crate::error::ErrorCode;
 use crate::info::TaskInfo;
-use crate::manage::database::RequestDb;
-use crate::service::command::{set_code_with_index_other, GET_INFO_MAX};
+use crate::manage::query;
+use crate::service::command::{read_task_ids, set_code_with_index_other, GET_INFO_MAX};
 use crate::service::permission::PermissionChecker;
-use crate::service::{serialize_task_info, RequestServiceStub};
+use crate::service::{serialize_task_info, RequestServiceStub, TASK_INFO_ALL};
 use crate::task::files::check_current_account;
 
 impl RequestServiceStub {
@@ -71,10 +71,14 @@ impl RequestServiceStub {
         // Pre-allocate results vector with default error values
         let mut vec = vec![(ErrorCode::Other, TaskInfo::new()); len];
         
+        // Read every task ID up front, their owners come from a single query
+        let (task_ids, uids) = read_task_ids(data, len)?;
+
+        // Read the optional parts of the task info to send, all by default
+        let fields: u32 = data.read().unwrap_or(TASK_INFO_ALL);
+
         // Process each task individually
-        for i in 0..len {
-            // Read task ID from input parcel
-            let task_id: String = data.read()?;
+        for (i, task_id) in task_ids.into_iter().enumerate() {
             info!("Service show tid {}", task_id);
 
             // Parse and validate task ID format
@@ -90,8 +94,8 @@ impl RequestServiceStub {
             };
 
             // Get task owner UID from database
-            let task_uid = match RequestDb::get_instance().query_task_uid(task_id) {
-                Some(uid) => uid,
+            let task_uid = match uids.get(&task_id) {
+                Some(uid) => *uid,
                 None => {
                     set_code_with_index_other(&mut vec, i, ErrorCode::TaskNotFound);
                     continue;
@@ -123,7 +127,7 @@ impl RequestServiceStub {
             }
 
             // Request task information from task manager
-            let info = self.task_manager.lock().unwrap().show(task_uid, task_id);
+            let info = query::show(task_uid, task_id);
             match info {
                 Some(task_info) => {
                     // Update results with success code and task info
@@ -151,7 +155,7 @@ impl RequestServiceStub {
         for (c, info) in vec {
             reply.write(&(c as i32))?;
             // TODO: Sends info only when ErrOk.
-            serialize_task_info(info, reply)?;
+            serialize_task_info(info, fields, reply)?;
         }
         Ok(())
     }
@@ -20,9 +20,8 @@ use ipc::parcel::MsgParcel;
 use ipc::{IpcResult, IpcStatusCode};
 
 use crate::error::ErrorCode;
-use crate::manage::database::RequestDb;
 use crate::manage::events::TaskManagerEvent;
-use crate::service::command::{set_code_with_index, CONTROL_MAX};
+use crate::service::command::{read_task_ids, set_code_with_index, CONTROL_MAX};
 use crate::service::permission::PermissionChecker;
 use crate::service::RequestServiceStub;
 use crate::task::files::check_current_account;
@@ -88,10 +87,14 @@ impl RequestServiceStub {
         // Get caller's UID for permission validation
         let ipc_uid = ipc::Skeleton::calling_uid();
 
+        // Read every task ID up front, their owners come from a single query
+        let (task_ids, uids) = read_task_ids(data, len)?;
+
+        // Start events sent to the task manager, with their result receivers
+        let mut pending = Vec::with_capacity(len);
+
         // Process each task individually
-        for i in 0..len {
-            // Read task ID from input parcel
-            let task_id: String = data.read()?;
+        for (i, task_id) in task_ids.into_iter().enumerate() {
             info!("Service start {}", task_id);
             
             // Parse and validate task ID format
@@ -107,8 +110,8 @@ impl RequestServiceStub {
             };
 
             // Get task owner UID from database
-            let task_uid = match RequestDb::get_instance().query_task_uid(task_id) {
-                Some(uid) => uid,
+            let task_uid = match uids.get(&task_id) {
+                Some(uid) => *uid,
                 None => {
                     set_code_with_index(&mut vec, i, ErrorCode::TaskNotFound);
                     continue;
@@ -151,7 +154,12 @@ impl RequestServiceStub {
                 set_code_with_index(&mut vec, i, ErrorCode::Other);
                 continue;
             }
-            
+            pending.push((i, task_id, rx));
+        }
+
+        // Every event is queued before waiting for any result, so the task
+        // manager handles the whole batch back to back
+        for (i, task_id, rx) in pending {
             // Receive result from task manager
             let ret = match rx.get() {
                 Some(ret) => ret,
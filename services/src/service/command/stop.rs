@@ -74,6 +74,9 @@ impl RequestServiceStub {
         
         // Pre-allocate results vector with default error values
         let mut vec = vec![ErrorCode::Other; len];
+
+        // Stop events sent to the task manager, with their result receivers
+        let mut pending = Vec::with_capacity(len);
         
         // Process each task individually
         for i in 0..len {
@@ -133,7 +136,12 @@ impl RequestServiceStub {
                 set_code_with_index(&mut vec, i, ErrorCode::Other);
                 continue;
             }
-            
+            pending.push((i, task_id, rx));
+        }
+
+        // Every event is queued before waiting for any result, so the task
+        // manager handles the whole batch back to back
+        for (i, task_id, rx) in pending {
             // Receive result from task manager
             let ret = match rx.get() {
                 Some(ret) => ret,
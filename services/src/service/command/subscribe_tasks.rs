@@ -0,0 +1,180 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Bulk task subscription for request service.
+//!
+//! A client whose channel broke, usually because the service restarted,
+//! subscribes to all of its tasks again with a single call. The call can
+//! open the new channel of the client as well, and replies with the current
+//! state of every task so the client catches up on the notifications it
+//! missed.
+
+use std::fs::File;
+use std::os::fd::AsRawFd;
+use std::os::unix::io::FromRawFd;
+
+use ipc::parcel::MsgParcel;
+use ipc::{IpcResult, IpcStatusCode};
+
+use crate::error::ErrorCode;
+use crate::info::TaskInfo;
+use crate::manage::events::TaskManagerEvent;
+use crate::manage::query;
+use crate::service::command::{read_task_ids, set_code_with_index_other, GET_INFO_MAX};
+use crate::service::{serialize_task_info, RequestServiceStub};
+
+impl RequestServiceStub {
+    /// Subscribes the calling process to notifications of several tasks.
+    ///
+    /// # Arguments
+    ///
+    /// * `data` - Message parcel containing whether to open the channel,
+    ///   count, task IDs and the `TASK_INFO_*` parts of the states to send
+    /// * `reply` - Message parcel to write operation results to
+    ///
+    /// # Returns
+    ///
+    /// * `Ok(())` - If the subscriptions were processed
+    /// * `Err(IpcStatusCode::Failed)` - If input validation failed or the
+    ///   channel could not be opened
+    ///
+    /// # Errors
+    ///
+    /// Returns error codes in the reply parcel:
+    /// * `ErrOk` - Subscriptions processed, followed by the channel if it was
+    ///   opened, then by the result and state of each task
+    /// * `Other` - Input size exceeds `GET_INFO_MAX`
+    /// * `ParameterCheck` - The channel could not be opened
+    ///
+    /// # Notes
+    ///
+    /// * The channel is opened before any task is subscribed, so no
+    ///   notification of the tasks goes to the broken one
+    /// * Subscription events are all queued before waiting for their results
+    pub(crate) fn subscribe_tasks(
+        &self,
+        data: &mut MsgParcel,
+        reply: &mut MsgParcel,
+    ) -> IpcResult<()> {
+        let open_channel: bool = data.read()?;
+        let len: u32 = data.read()?;
+        let len = len as usize;
+        if len > GET_INFO_MAX {
+            info!("Service subscribe_tasks: out of size: {}", len);
+            reply.write(&(ErrorCode::Other as i32))?;
+            return Err(IpcStatusCode::Failed);
+        }
+        let (task_ids, uids) = read_task_ids(data, len)?;
+        let fields: u32 = data.read()?;
+
+        let pid = ipc::Skeleton::calling_pid();
+        let uid = ipc::Skeleton::calling_uid();
+        let token_id = ipc::Skeleton::calling_full_token_id();
+        info!(
+            "Service subscribe_tasks pid {}, {} tasks, open channel {}",
+            pid, len, open_channel
+        );
+
+        let channel = if open_channel {
+            match self.client_manager.open_channel(pid) {
+                // Safety: as in `open_channel`, the ownership of the fd is
+                // transferred to the reply parcel
+                Ok(ud_fd) => Some(unsafe { File::from_raw_fd(ud_fd.as_raw_fd()) }),
+                Err(err) => {
+                    error!("End Service subscribe_tasks, failed: {:?}", err);
+                    sys_event!(
+                        ExecError,
+                        DfxCode::INVALID_IPC_MESSAGE_A28,
+                        &format!("End Service subscribe_tasks, failed: {:?}", err)
+                    );
+                    reply.write(&(ErrorCode::ParameterCheck as i32))?;
+                    return Err(IpcStatusCode::Failed);
+                }
+            }
+        } else {
+            None
+        };
+
+        let mut vec = vec![(ErrorCode::Other, TaskInfo::new()); len];
+
+        // Subscribe events sent to the task manager, with their result receivers
+        let mut pending = Vec::with_capacity(len);
+        for (i, task_id) in task_ids.into_iter().enumerate() {
+            let Ok(task_id) = task_id.parse::<u32>() else {
+                error!(
+                    "Service subscribe_tasks, failed: tid not valid: {}",
+                    task_id
+                );
+                set_code_with_index_other(&mut vec, i, ErrorCode::TaskNotFound);
+                continue;
+            };
+            if uids.get(&task_id) != Some(&uid) {
+                set_code_with_index_other(&mut vec, i, ErrorCode::TaskNotFound);
+                continue;
+            }
+            let (event, rx) = TaskManagerEvent::subscribe(task_id, token_id);
+            if !self.task_manager.lock().unwrap().send_event(event) {
+                error!(
+                    "Service subscribe_tasks, tid: {}, failed: send event failed",
+                    task_id
+                );
+                continue;
+            }
+            pending.push((i, task_id, rx));
+        }
+
+        for (i, task_id, rx) in pending {
+            let ret = match rx.get() {
+                Some(ErrorCode::ErrOk) => {
+                    self.client_manager.subscribe(task_id, pid, uid, token_id)
+                }
+                Some(ret) => ret,
+                None => {
+                    error!(
+                        "Service subscribe_tasks, tid: {}, failed: receives ret failed",
+                        task_id
+                    );
+                    ErrorCode::Other
+                }
+            };
+            if ret != ErrorCode::ErrOk {
+                error!(
+                    "Service subscribe_tasks, tid: {}, failed: {:?}",
+                    task_id, ret
+                );
+                set_code_with_index_other(&mut vec, i, ret);
+                continue;
+            }
+            match query::show(uid, task_id) {
+                Some(task_info) => {
+                    if let Some((c, info)) = vec.get_mut(i) {
+                        *c = ErrorCode::ErrOk;
+                        *info = task_info;
+                    }
+                }
+                None => set_code_with_index_other(&mut vec, i, ErrorCode::TaskNotFound),
+            }
+        }
+
+        reply.write(&(ErrorCode::ErrOk as i32))?;
+        if let Some(file) = channel {
+            reply.write_file(file)?;
+        }
+        for (c, info) in vec {
+            reply.write(&(c as i32))?;
+            serialize_task_info(info, fields, reply)?;
+        }
+        debug!("End Service subscribe_tasks ok, pid {}", pid);
+        Ok(())
+    }
+}
@@ -22,9 +22,10 @@ use ipc::{IpcResult, IpcStatusCode};
 use crate::error::ErrorCode;
 use crate::info::TaskInfo;
 use crate::manage::database::RequestDb;
+use crate::manage::query;
 use crate::service::command::{set_code_with_index_other, GET_INFO_MAX};
 use crate::service::permission::PermissionChecker;
-use crate::service::{serialize_task_info, RequestServiceStub};
+use crate::service::{serialize_task_info, RequestServiceStub, TASK_INFO_ALL};
 use crate::task::files::check_current_account;
 
 impl RequestServiceStub {
@@ -65,13 +66,23 @@ impl RequestServiceStub {
         // Pre-allocate result vector to avoid reallocations
         let mut vec = vec![(ErrorCode::Other, TaskInfo::new()); len];
         
-        // Process each task individually
-        for i in 0..len {
-            // Read task ID and token from input parcel
+        // Read every task ID and token up front, the owners of the tasks come
+        // from a single query
+        let mut requests = Vec::with_capacity(len);
+        for _ in 0..len {
             let task_id: String = data.read()?;
-            info!("Service touch tid {}", task_id);
-
             let token: String = data.read()?;
+            requests.push((task_id, token));
+        }
+        let parsed = requests
+            .iter()
+            .filter_map(|(task_id, _)| task_id.parse::<u32>().ok())
+            .collect::<Vec<_>>();
+        let uids = RequestDb::get_instance().query_tasks_uid(&parsed);
+
+        // Process each task individually
+        for (i, (task_id, token)) in requests.into_iter().enumerate() {
+            info!("Service touch tid {}", task_id);
 
             // Parse and validate task ID format
             let Ok(task_id) = task_id.parse::<u32>() else {
@@ -86,8 +97,8 @@ impl RequestServiceStub {
             };
 
             // Get task owner UID from database
-            let task_uid = match RequestDb::get_instance().query_task_uid(task_id) {
-                Some(uid) => uid,
+            let task_uid = match uids.get(&task_id) {
+                Some(uid) => *uid,
                 None => {
                     set_code_with_index_other(&mut vec, i, ErrorCode::TaskNotFound);
                     continue;
@@ -119,11 +130,7 @@ impl RequestServiceStub {
             }
 
             // Attempt to touch the task with the provided token
-            let info = self
-                .task_manager
-                .lock()
-                .unwrap()
-                .touch(task_uid, task_id, token);
+            let info = query::touch(task_uid, task_id, token);
                 
             // Process touch result for this task
             match info {
@@ -152,7 +159,7 @@ impl RequestServiceStub {
         for (c, info) in vec {
             reply.write(&(c as i32))?;
             // TODO: Sends info only when ErrOk.
-            serialize_task_info(info, reply)?;
+            serialize_task_info(info, TASK_INFO_ALL, reply)?;
         }
         Ok(())
     }
@@ -67,6 +67,18 @@ pub const SHOW_PROGRESS: u32 = 22;
 pub const SET_MODE: u32 = 100;
 /// Disables notifications for a specific task.
 pub const DISABLE_TASK_NOTIFICATION: u32 = 101;
+/// Selects the policy ordering the tasks of the calling application.
+pub const SET_SCHEDULE_POLICY: u32 = 102;
+/// Opens the shared progress table of the calling process.
+pub const OPEN_PROGRESS_TABLE: u32 = 103;
+/// Reads the counters and latency histograms of the service.
+pub const GET_STATS: u32 = 104;
+/// Opens the body of a URL in the cache shared by applications.
+pub const OPEN_SHARED_CACHE: u32 = 105;
+/// Publishes a body to the cache shared by applications.
+pub const PUBLISH_SHARED_CACHE: u32 = 106;
+/// Subscribes to updates for several requests, opening the channel if asked.
+pub const SUBSCRIBE_TASKS: u32 = 107;
 
 /// Function code for the request notification interface to notify run count changes.
 pub(crate) const NOTIFY_RUN_COUNT: u32 = 2;
@@ -99,5 +111,11 @@ mod test {
         assert_eq!(20, DELETE_GROUP);
         assert_eq!(100, SET_MODE);
         assert_eq!(101, DISABLE_TASK_NOTIFICATION);
+        assert_eq!(102, SET_SCHEDULE_POLICY);
+        assert_eq!(103, OPEN_PROGRESS_TABLE);
+        assert_eq!(104, GET_STATS);
+        assert_eq!(105, OPEN_SHARED_CACHE);
+        assert_eq!(106, PUBLISH_SHARED_CACHE);
+        assert_eq!(107, SUBSCRIBE_TASKS);
     }
 }
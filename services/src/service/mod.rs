@@ -43,7 +43,7 @@ cfg_oh! {
     /// Main service interface implementation.
     pub(crate) use stub::RequestServiceStub;
     /// Utility for serializing task information.
-    pub(crate) use stub::serialize_task_info;
+    pub(crate) use stub::{serialize_task_info, TASK_INFO_ALL};
     /// Utility for serializing task configuration.
     pub(crate) use stub::serialize_task_config;
 }
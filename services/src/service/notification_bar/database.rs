@@ -16,6 +16,14 @@
 //! This module provides database functionality for storing and managing notification
 //! configurations, group settings, and notification content for download tasks.
 //! It handles creation, updates, queries, and cleanup operations.
+//!
+//! The settings read on every progress publish, such as task display flags,
+//! task groups, group configurations and visibilities, are mirrored in memory.
+//! The mirror is loaded once at start and written through by the same calls
+//! that update the tables, so reading them needs no SQL query.
+
+use std::collections::HashMap;
+use std::sync::{Mutex, MutexGuard, OnceLock};
 
 use crate::database::REQUEST_DB;
 use crate::service::notification_bar::NotificationConfig;
@@ -55,6 +63,9 @@ use std::time::{SystemTime, UNIX_EPOCH};
 
 const MILLIS_IN_A_WEEK: u64 = 7 * 24 * 60 * 60 * 1000;
 
+/// Mirror shared by all handlers, `None` if the tables could not be loaded.
+static MIRROR: OnceLock<Option<Mutex<Mirror>>> = OnceLock::new();
+
 /// Notification database handler for managing notification configurations.
 /// 
 /// This struct provides methods for storing, retrieving, and modifying notification
@@ -62,6 +73,31 @@ const MILLIS_IN_A_WEEK: u64 = 7 * 24 * 60 * 60 * 1000;
 /// database schema.
 pub(crate) struct NotificationDb {
     inner: &'static rdb::RdbStore<'static>,
+    /// In-memory mirror of the settings, reads fall back to SQL without it
+    mirror: Option<&'static Mutex<Mirror>>,
+}
+
+/// Group configuration mirrored from `group_notification_config`.
+#[derive(Clone, Copy)]
+struct GroupConfig {
+    gauge: bool,
+    attach_able: bool,
+    display: bool,
+    /// Visibility bits, 0 if unset
+    visibility: i32,
+}
+
+/// In-memory mirror of the notification settings read on every publish.
+#[derive(Default)]
+struct Mirror {
+    /// `display` of `task_config`, by task
+    task_display: HashMap<u32, bool>,
+    /// `group_id` of `group_notification`, by task
+    task_group: HashMap<u32, u32>,
+    /// `visibility` of `task_notification_content`, by task, 0 if unset
+    task_visibility: HashMap<u32, i32>,
+    /// `group_notification_config`, by group
+    groups: HashMap<u32, GroupConfig>,
 }
 
 /// Customized notification content for download tasks or groups.
@@ -81,7 +117,10 @@ impl NotificationDb {
     /// Initializes the database by creating required tables and updating schema
     /// if necessary. Logs errors if initialization fails.
     pub(crate) fn new() -> Self {
-        let me = Self { inner: &REQUEST_DB };
+        let mut me = Self {
+            inner: &REQUEST_DB,
+            mirror: None,
+        };
         if let Err(e) = me.create_db() {
             error!("Failed to create notification database: {}", e);
             sys_event!(
@@ -92,9 +131,74 @@ impl NotificationDb {
         }
 
         me.update();
+        me.mirror = MIRROR.get_or_init(|| me.load().map(Mutex::new)).as_ref();
         me
     }
 
+    /// Loads the mirrored settings from the tables.
+    ///
+    /// # Returns
+    ///
+    /// * `Some(Mirror)` - The settings of all tasks and groups
+    /// * `None` - If a table cannot be read, the settings are then queried
+    ///   with SQL
+    fn load(&self) -> Option<Mirror> {
+        match self.load_tables() {
+            Ok(mirror) => Some(mirror),
+            Err(e) => {
+                error!("Failed to load notification settings: {}", e);
+                sys_event!(
+                    ExecFault,
+                    DfxCode::RDB_FAULT_04,
+                    &format!("Failed to load notification settings: {}", e)
+                );
+                None
+            }
+        }
+    }
+
+    fn load_tables(&self) -> Result<Mirror, i32> {
+        let mut mirror = Mirror::default();
+        mirror.task_display = self
+            .inner
+            .query::<(u32, bool)>("SELECT task_id, display FROM task_config", ())?
+            .collect();
+        mirror.task_group = self
+            .inner
+            .query::<(u32, u32)>("SELECT task_id, group_id FROM group_notification", ())?
+            .collect();
+        mirror.task_visibility = self
+            .inner
+            .query::<(u32, Option<i32>)>(
+                "SELECT task_id, visibility FROM task_notification_content",
+                (),
+            )?
+            .map(|(task_id, visibility)| (task_id, visibility.unwrap_or(0)))
+            .collect();
+        mirror.groups = self
+            .inner
+            .query::<(u32, bool, bool, bool, Option<i32>)>(
+                "SELECT group_id, gauge, attach_able, display, visibility FROM group_notification_config",
+                (),
+            )?
+            .map(|(group_id, gauge, attach_able, display, visibility)| {
+                let config = GroupConfig {
+                    gauge,
+                    attach_able,
+                    display,
+                    visibility: visibility.unwrap_or(0),
+                };
+                (group_id, config)
+            })
+            .collect();
+        Ok(mirror)
+    }
+
+    /// Locks the mirror, `None` if the settings are not mirrored.
+    fn mirror(&self) -> Option<MutexGuard<'static, Mirror>> {
+        self.mirror.map(|mirror| mirror.lock().unwrap())
+    }
+
     /// Creates the notification database tables if they don't exist.
     /// 
     /// # Returns
@@ -185,15 +289,32 @@ impl NotificationDb {
     /// 
     /// * `task_id` - The ID of the task whose notification information should be cleared
     pub(crate) fn clear_task_info(&self, task_id: u32) {
-        let sqls = [
-            "DELETE FROM task_config WHERE task_id = ?",
-            "DELETE FROM task_notification_content WHERE task_id = ?",
-            "DELETE FROM group_notification WHERE task_id = ?",
+        let sqls: [(&str, fn(&mut Mirror, u32)); 3] = [
+            (
+                "DELETE FROM task_config WHERE task_id = ?",
+                |mirror, task_id| {
+                    mirror.task_display.remove(&task_id);
+                },
+            ),
+            (
+                "DELETE FROM task_notification_content WHERE task_id = ?",
+                |mirror, task_id| {
+                    mirror.task_visibility.remove(&task_id);
+                },
+            ),
+            (
+                "DELETE FROM group_notification WHERE task_id = ?",
+                |mirror, task_id| {
+                    mirror.task_group.remove(&task_id);
+                },
+            ),
         ];
         // Execute each delete statement and log any errors
-        for sql in sqls.iter() {
+        for (sql, clear_mirror) in sqls.iter() {
             if let Err(e) = self.inner.execute(sql, task_id) {
                 error!("Failed to clear task {} notification info: {}", task_id, e);
+            } else if let Some(mut mirror) = self.mirror() {
+                clear_mirror(&mut mirror, task_id);
             }
         }
     }
@@ -207,17 +328,32 @@ impl NotificationDb {
     /// 
     /// * `group_id` - The ID of the group whose notification information should be cleared
     pub(crate) fn clear_group_info(&self, group_id: u32) {
-        let sqls = [
-            "DELETE FROM group_notification WHERE group_id = ?",
-            "DELETE FROM group_notification_content WHERE group_id = ?",
-            "DELETE FROM group_notification_config WHERE group_id = ?",
+        let sqls: [(&str, fn(&mut Mirror, u32)); 3] = [
+            (
+                "DELETE FROM group_notification WHERE group_id = ?",
+                |mirror, group_id| {
+                    mirror.task_group.retain(|_, group| *group != group_id);
+                },
+            ),
+            (
+                "DELETE FROM group_notification_content WHERE group_id = ?",
+                |_, _| {},
+            ),
+            (
+                "DELETE FROM group_notification_config WHERE group_id = ?",
+                |mirror, group_id| {
+                    mirror.groups.remove(&group_id);
+                },
+            ),
         ];
-        for sql in sqls.iter() {
+        for (sql, clear_mirror) in sqls.iter() {
             if let Err(e) = self.inner.execute(sql, group_id) {
                 error!(
                     "Failed to clear group {} notification info: {}",
                     group_id, e
                 );
+            } else if let Some(mut mirror) = self.mirror() {
+                clear_mirror(&mut mirror, group_id);
             }
         }
     }
@@ -286,6 +422,12 @@ impl NotificationDb {
     /// * `true` - If group notifications are enabled or if the group doesn't exist
     /// * `false` - If group notifications are disabled
     pub(crate) fn check_group_notification_available(&self, group_id: &u32) -> bool {
+        if let Some(mirror) = self.mirror() {
+            return mirror
+                .groups
+                .get(group_id)
+                .map_or(true, |group| group.display);
+        }
         let mut set = match self.inner.query::<bool>(
             "SELECT display FROM group_notification_config WHERE group_id = ?",
             group_id,
@@ -313,6 +455,16 @@ impl NotificationDb {
     /// * `true` - If task notifications are enabled
     /// * `false` - If task notifications are disabled
     pub(crate) fn check_task_notification_available(&self, task_id: &u32) -> bool {
+        if let Some(mirror) = self.mirror() {
+            return match mirror.task_group.get(task_id) {
+                Some(group_id) => mirror
+                    .groups
+                    .get(group_id)
+                    .map_or(true, |group| group.display),
+                None => mirror.task_display.get(task_id).copied().unwrap_or(true),
+            };
+        }
+
         // Check if task belongs to a group
         if let Some(group) = self.query_task_gid(*task_id) {
             return self.check_group_notification_available(&group);
@@ -347,6 +499,8 @@ impl NotificationDb {
         ) {
             error!("Failed to update {} notification: {}", task_id, e);
             sys_event!(ExecFault, DfxCode::RDB_FAULT_04, &format!("Failed to update {} notification: {}", task_id, e));
+        } else if let Some(mut mirror) = self.mirror() {
+            mirror.task_display.insert(task_id, false);
         }
     }
 
@@ -365,6 +519,8 @@ impl NotificationDb {
         ) {
             error!("Failed to update {} notification: {}", task_id, e);
             sys_event!(ExecFault, DfxCode::RDB_FAULT_04, &format!("Failed to update {} notification: {}", task_id, e));
+        } else if let Some(mut mirror) = self.mirror() {
+            mirror.task_group.insert(task_id, group_id);
         }
     }
 
@@ -378,6 +534,14 @@ impl NotificationDb {
     /// 
     /// * A vector containing the IDs of all tasks in the specified group
     pub(crate) fn query_group_tasks(&self, group_id: u32) -> Vec<u32> {
+        if let Some(mirror) = self.mirror() {
+            return mirror
+                .task_group
+                .iter()
+                .filter(|(_, group)| **group == group_id)
+                .map(|(task_id, _)| *task_id)
+                .collect();
+        }
         let set = match self.inner.query::<u32>(
             "SELECT task_id FROM group_notification WHERE group_id = ?",
             group_id,
@@ -407,6 +571,9 @@ impl NotificationDb {
     /// * `Some(u32)` - The group ID if the task belongs to a group
     /// * `None` - If the task doesn't belong to any group
     pub(crate) fn query_task_gid(&self, task_id: u32) -> Option<u32> {
+        if let Some(mirror) = self.mirror() {
+            return mirror.task_group.get(&task_id).copied();
+        }
         let mut set = match self.inner.query::<u32>(
             "SELECT group_id FROM group_notification WHERE task_id = ?",
             task_id,
@@ -470,6 +637,9 @@ impl NotificationDb {
         ) {
             error!("Failed to insert {} notification: {}", config.task_id, e);
             sys_event!(ExecFault, DfxCode::RDB_FAULT_04, &format!("Failed to insert {} notification: {}", config.task_id, e));
+        } else if let Some(mut mirror) = self.mirror() {
+            let visibility = config.visibility as i32;
+            mirror.task_visibility.insert(config.task_id, visibility);
         }
     }
 
@@ -553,6 +723,17 @@ impl NotificationDb {
         ) {
             error!("Failed to update {} notification: {}", group_id, e);
             sys_event!(ExecFault, DfxCode::RDB_FAULT_04, &format!("Failed to update {} notification: {}", group_id, e));
+        } else if let Some(mut mirror) = self.mirror() {
+            // `attach_able` of an existing group is kept, as in the table
+            let group = mirror.groups.entry(group_id).or_insert(GroupConfig {
+                gauge,
+                attach_able: true,
+                display,
+                visibility: 0,
+            });
+            group.gauge = gauge;
+            group.display = display;
+            group.visibility = visibility as i32;
         }
     }
 
@@ -567,6 +748,9 @@ impl NotificationDb {
     /// * `true` - If the group exists
     /// * `false` - If the group doesn't exist or an error occurs
     pub(crate) fn contains_group(&self, group_id: u32) -> bool {
+        if let Some(mirror) = self.mirror() {
+            return mirror.groups.contains_key(&group_id);
+        }
         let mut set = match self.inner.query::<u32>(
             "SELECT group_id FROM group_notification_config where group_id = ?",
             group_id,
@@ -591,6 +775,12 @@ impl NotificationDb {
     /// * `true` - If tasks can be attached to the group
     /// * `false` - If tasks cannot be attached or the group doesn't exist
     pub(crate) fn attach_able(&self, group_id: u32) -> bool {
+        if let Some(mirror) = self.mirror() {
+            return mirror
+                .groups
+                .get(&group_id)
+                .is_some_and(|group| group.attach_able);
+        }
         let mut set = match self.inner.query::<bool>(
             "SELECT attach_able FROM group_notification_config where group_id = ?",
             group_id,
@@ -622,6 +812,10 @@ impl NotificationDb {
                 DfxCode::RDB_FAULT_04,
                 &format!("Failed to update {} notification: {}", group_id, e)
             );
+        } else if let Some(mut mirror) = self.mirror() {
+            if let Some(group) = mirror.groups.get_mut(&group_id) {
+                group.attach_able = false;
+            }
         }
     }
 
@@ -636,6 +830,12 @@ impl NotificationDb {
     /// * `true` - If the group should display a progress gauge
     /// * `false` - If no progress gauge should be displayed or the group doesn't exist
     pub(crate) fn is_gauge(&self, group_id: u32) -> bool {
+        if let Some(mirror) = self.mirror() {
+            return mirror
+                .groups
+                .get(&group_id)
+                .is_some_and(|group| group.gauge);
+        }
         let mut set = match self.inner.query::<bool>(
             "SELECT gauge FROM group_notification_config where group_id = ?",
             group_id,
@@ -665,6 +865,12 @@ impl NotificationDb {
     /// * Returns `true` if visibility is 0 or null (default behavior)
     /// * Otherwise checks the least significant bit of visibility (0b01)
     pub(crate) fn is_completion_visible(&self, task_id: u32) -> bool {
+        if let Some(mirror) = self.mirror() {
+            return match mirror.task_visibility.get(&task_id) {
+                Some(0) | None => true,
+                Some(visibility) => (visibility & 0b01) != 0,
+            };
+        }
         let mut set = match self.inner.query::<i32>(
             "SELECT visibility FROM task_notification_content where task_id = ?",
             task_id,
@@ -702,18 +908,13 @@ impl NotificationDb {
     /// * Returns the task's gauge setting if visibility is 0 or null
     /// * Otherwise checks the second bit of visibility (0b10)
     pub(crate) fn is_progress_visible(&self, task_id: u32) -> bool {
-        let mut set = match self.inner.query::<i32>(
-            "SELECT visibility FROM task_notification_content where task_id = ?",
-            task_id,
-        ) {
-            Ok(set) => set,
-            Err(e) => {
-                error!("Failed to query task {} notification: {}", task_id, e);
-                return false;
-            }
+        // The guard is dropped before asking the dispatcher for the gauge
+        let visibility = match self.mirror() {
+            Some(mirror) => mirror.task_visibility.get(&task_id).copied(),
+            None => self.query_task_visibility(task_id),
         };
 
-        match set.next() {
+        match visibility {
             // If visibility is 0, use the task's gauge setting from the dispatcher
             Some(0) => NotificationDispatcher::get_instance()
                 .get_task_gauge(task_id)
@@ -743,6 +944,12 @@ impl NotificationDb {
     /// * Returns `true` if visibility is 0 or null (default behavior)
     /// * Otherwise checks the least significant bit of visibility (0b01)
     pub(crate) fn is_completion_visible_from_group(&self, group_id: u32) -> bool {
+        if let Some(mirror) = self.mirror() {
+            return match mirror.groups.get(&group_id).map(|group| group.visibility) {
+                Some(0) | None => true,
+                Some(visibility) => (visibility & 0b01) != 0,
+            };
+        }
         let mut set = match self.inner.query::<i32>(
             "SELECT visibility FROM group_notification_config where group_id = ?",
             group_id,
@@ -780,6 +987,13 @@ impl NotificationDb {
     /// * Returns the group's gauge setting if visibility is 0 or null
     /// * Otherwise checks the second bit of visibility (0b10)
     pub(crate) fn is_progress_visible_from_group(&self, group_id: u32) -> bool {
+        if let Some(mirror) = self.mirror() {
+            return match mirror.groups.get(&group_id) {
+                Some(group) if group.visibility != 0 => (group.visibility & 0b10) != 0,
+                Some(group) => group.gauge,
+                None => false,
+            };
+        }
         let mut set = match self.inner.query::<i32>(
             "SELECT visibility FROM group_notification_config where group_id = ?",
             group_id,
@@ -800,6 +1014,26 @@ impl NotificationDb {
             None => self.is_gauge(group_id),
         }
     }
+
+    /// Queries the visibility of a task notification with SQL.
+    ///
+    /// # Returns
+    ///
+    /// * `Some(i32)` - The visibility bits of the task
+    /// * `None` - If the task has no customized notification or an error occurs
+    fn query_task_visibility(&self, task_id: u32) -> Option<i32> {
+        let mut set = match self.inner.query::<i32>(
+            "SELECT visibility FROM task_notification_content where task_id = ?",
+            task_id,
+        ) {
+            Ok(set) => set,
+            Err(e) => {
+                error!("Failed to query task {} notification: {}", task_id, e);
+                return None;
+            }
+        };
+        set.next()
+    }
 }
 
 #[cfg(test)]
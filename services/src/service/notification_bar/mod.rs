@@ -149,6 +149,10 @@ mod ffi {
         /// 
         /// The system language code
         fn GetSystemLanguage() -> String;
+
+        /// Drops the cached system language and the resource strings resolved
+        /// in it, so that they are resolved again in the new language.
+        fn ClearResourceCache();
         
         /// Publishes a notification to the system notification bar.
         /// 
@@ -26,6 +26,7 @@ use ylong_runtime::sync::mpsc::{self, UnboundedReceiver};
 
 use super::database::{CustomizedNotification, NotificationDb};
 use super::ffi::{NotifyContent, PublishNotification};
+use super::progress_size::progress_size;
 use super::task_handle::cancel_notification;
 use super::NotificationDispatcher;
 use crate::config::Action;
@@ -51,6 +52,8 @@ pub(crate) struct NotifyFlow {
 
     // Tracks last notification time for rate limiting
     last_notify_map: HashMap<u32, u64>,
+    // Last progress published per task or group, only changes are published
+    published_progress: HashMap<u32, ProgressView>,
 
     // Progress tracking for group notifications
     group_notify_progress: HashMap<u32, GroupProgress>,
@@ -103,11 +106,31 @@ impl GroupProgress {
             Entry::Occupied(entry) => entry.into_mut(),
             Entry::Vacant(entry) => entry.insert(0),
         };
-        // Update total progress by the delta between new and previous values
-        self.total_progress += processed - *prev;
+        // Update total progress by the delta between new and previous values,
+        // the progress of a restarted task may go down
+        self.total_progress = self.total_progress - *prev + processed;
         *prev = processed;
     }
 
+    /// Stops tracking a task that left the group before it finished.
+    ///
+    /// # Arguments
+    ///
+    /// * `task_id` - The ID of the task to remove
+    pub(crate) fn remove_unfinished_task(&mut self, task_id: u32) {
+        if !self
+            .task_state
+            .get(&task_id)
+            .is_some_and(|state| *state != State::Completed && *state != State::Failed)
+        {
+            return;
+        }
+        self.task_state.remove(&task_id);
+        if let Some(processed) = self.task_progress.remove(&task_id) {
+            self.total_progress -= processed;
+        }
+    }
+
     /// Updates the state for a specific task within the group.
     /// 
     /// # Arguments
@@ -236,6 +259,37 @@ pub(crate) enum NotifyInfo {
     GroupEventual(u32, u64),
 }
 
+/// Progress shown by a notification, at the granularity it is rendered.
+#[derive(Clone, PartialEq, Eq, Debug)]
+enum ProgressView {
+    /// Whole percentage of a task and the file of a multi-file upload.
+    Percent(u64, Option<(usize, usize)>),
+    /// Processed size of a task whose total is unknown and the file of a
+    /// multi-file upload.
+    Size(String, Option<(usize, usize)>),
+    /// Processed size of a group and its successful, failed and total tasks.
+    Group(String, usize, usize, usize),
+}
+
+impl ProgressView {
+    fn task(info: &ProgressNotify) -> Self {
+        match info.total {
+            Some(0) => ProgressView::Percent(100, info.multi_upload),
+            Some(total) => ProgressView::Percent(info.processed * 100 / total, info.multi_upload),
+            None => ProgressView::Size(progress_size(info.processed), info.multi_upload),
+        }
+    }
+
+    fn group(progress: &GroupProgress) -> Self {
+        ProgressView::Group(
+            progress_size(progress.processed()),
+            progress.successful(),
+            progress.failed(),
+            progress.total(),
+        )
+    }
+}
+
 #[derive(Clone, Copy)]
 enum NotifyType {
     /// Group notification with group ID
@@ -260,6 +314,7 @@ impl NotifyFlow {
             database,
             notify_type_map: HashMap::new(),
             last_notify_map: HashMap::new(),
+            published_progress: HashMap::new(),
             group_notify_progress: HashMap::new(),
             task_customized_notify: HashMap::new(),
             group_customized_notify: HashMap::new(),
@@ -325,6 +380,7 @@ impl NotifyFlow {
             "Unregister task: uid: {}, task_id: {}, group_id: {}",
             uid, task_id, group_id
         );
+        self.published_progress.remove(&group_id);
         let customized = self.group_customized_notify(group_id);
         let is_completion_visible = self.check_completion_visibility_from_group(group_id);
         let progress = match self.group_notify_progress.entry(group_id) {
@@ -334,13 +390,7 @@ impl NotifyFlow {
                 entry.insert(progress)
             }
         };
-        if progress
-            .task_state
-            .get(&task_id)
-            .is_some_and(|state| *state != State::Completed && *state != State::Failed)
-        {
-            progress.task_state.remove(&task_id);
-        }
+        progress.remove_unfinished_task(task_id);
         if progress.task_state.is_empty() {
             cancel_notification(group_id);
             return None;
@@ -363,24 +413,22 @@ impl NotifyFlow {
         ))
     }
 
-    /// Updates group progress from database for a specific task.
+    /// Updates group progress from database for some tasks, with a single
+    /// query whatever their number.
     /// 
     /// # Arguments
     /// 
     /// * `group_progress` - Group progress to update
-    /// * `task_id` - Task to update progress for
-    fn update_db_task_state_and_progress(group_progress: &mut GroupProgress, task_id: u32) {
-        let Some(processed) = RequestDb::get_instance().query_task_total_processed(task_id) else {
-            return;
-        };
-        let Some(state) = RequestDb::get_instance().query_task_state(task_id) else {
-            return;
-        };
-        if state == State::Removed.repr {
-            return;
+    /// * `task_ids` - Tasks to update progress for
+    fn update_db_tasks_state_and_progress(group_progress: &mut GroupProgress, task_ids: &[u32]) {
+        let rows = RequestDb::get_instance().query_tasks_progress(task_ids);
+        for (task_id, state, processed) in rows {
+            if state == State::Removed.repr {
+                continue;
+            }
+            group_progress.update_task_state(task_id, State::from(state));
+            group_progress.update_task_progress(task_id, processed);
         }
-        group_progress.update_task_state(task_id, State::from(state));
-        group_progress.update_task_progress(task_id, processed as u64);
     }
 
     /// Creates a group progress tracker initialized from database data.
@@ -395,9 +443,8 @@ impl NotifyFlow {
     /// A `GroupProgress` instance with current state from database
     fn get_group_progress(database: &NotificationDb, group_id: u32) -> GroupProgress {
         let mut group_progress = GroupProgress::new();
-        for task_id in database.query_group_tasks(group_id) {
-            Self::update_db_task_state_and_progress(&mut group_progress, task_id);
-        }
+        let task_ids = database.query_group_tasks(group_id);
+        Self::update_db_tasks_state_and_progress(&mut group_progress, &task_ids);
         group_progress
     }
 
@@ -419,14 +466,13 @@ impl NotifyFlow {
         task_ids: Vec<u32>,
         uid: u64,
     ) -> Option<NotifyContent> {
+        self.published_progress.remove(&group_id);
         let is_progress_visibility_from_group = self.check_progress_visibility_from_group(group_id);
         let customized = self.group_customized_notify(group_id);
         let progress = match self.group_notify_progress.entry(group_id) {
             Entry::Occupied(entry) => {
                 let progress = entry.into_mut();
-                for task_id in task_ids {
-                    Self::update_db_task_state_and_progress(progress, task_id);
-                }
+                Self::update_db_tasks_state_and_progress(progress, &task_ids);
                 progress
             }
             Entry::Vacant(entry) => {
@@ -576,9 +622,14 @@ impl NotifyFlow {
                 };
                 progress.update_task_progress(info.task_id, info.processed);
 
+                // The progress of the tasks is gathered between two publications.
                 if !progress_interval_check {
                     return None;
                 }
+                let view = ProgressView::group(progress);
+                if !Self::progress_changed(&mut self.published_progress, group_id, view) {
+                    return None;
+                }
                 NotifyContent::group_progress_notify(
                     customized,
                     info.action,
@@ -588,17 +639,21 @@ impl NotifyFlow {
                 )
             }
             NotifyType::Task => {
-                if info.version == Version::API9 {
-                    // Get gauge value and return notification content only when gauge is true
-                    return NotificationDispatcher::get_instance()
+                let visible = if info.version == Version::API9 {
+                    // API9 tasks show their progress only when gauge is true
+                    NotificationDispatcher::get_instance()
                         .get_task_gauge(info.task_id)
-                        .filter(|&gauge| gauge)
-                        .map(|_| NotifyContent::task_progress_notify(
-                            self.task_customized_notify(info.task_id),
-                            &info,
-                        ));
-                }
-                if !self.check_progress_visibility(info.task_id) {
+                        .unwrap_or(false)
+                } else {
+                    self.check_progress_visibility(info.task_id)
+                };
+                if !visible
+                    || !Self::progress_changed(
+                        &mut self.published_progress,
+                        info.task_id,
+                        ProgressView::task(&info),
+                    )
+                {
                     return None;
                 }
                 NotifyContent::task_progress_notify(
@@ -610,6 +665,37 @@ impl NotifyFlow {
         Some(content)
     }
 
+    /// Checks if the progress shown for a task or group changed since it was
+    /// last published, and remembers it if so.
+    ///
+    /// # Arguments
+    ///
+    /// * `published` - Last progress published per task or group
+    /// * `request_id` - Task or group ID to check
+    /// * `view` - Progress to show
+    ///
+    /// # Returns
+    ///
+    /// * `true` - If the progress changed (notification should be shown)
+    /// * `false` - If the notification would look the same
+    fn progress_changed(
+        published: &mut HashMap<u32, ProgressView>,
+        request_id: u32,
+        view: ProgressView,
+    ) -> bool {
+        match published.entry(request_id) {
+            Entry::Occupied(entry) if *entry.get() == view => false,
+            Entry::Occupied(mut entry) => {
+                entry.insert(view);
+                true
+            }
+            Entry::Vacant(entry) => {
+                entry.insert(view);
+                true
+            }
+        }
+    }
+
     /// Checks if enough time has passed since the last notification.
     /// 
     /// # Arguments
@@ -652,6 +738,7 @@ impl NotifyFlow {
     fn publish_completed_notify(&mut self, info: &EventualNotify) -> Option<NotifyContent> {
         let content = match self.get_request_id(info.task_id) {
             NotifyType::Group(group_id) => {
+                self.published_progress.remove(&group_id);
                 let is_progress_visible = self.check_progress_visibility_from_group(group_id);
                 let is_completion_visible = self.check_completion_visibility_from_group(group_id);
 
@@ -704,6 +791,7 @@ impl NotifyFlow {
                 }
             }
             NotifyType::Task => {
+                self.published_progress.remove(&info.task_id);
                 if !self.check_completion_visibility(info.task_id) {
                     cancel_notification(info.task_id);
                     return None;
@@ -718,6 +806,7 @@ impl NotifyFlow {
                 );
                 if info.is_successful {
                     self.database.clear_task_info(info.task_id);
+                    self.forget_task(info.task_id);
                 }
                 content
             }
@@ -737,6 +826,7 @@ impl NotifyFlow {
     /// * `Some(NotifyContent)` - If a notification should be published
     /// * `None` - If no notification is needed
     fn group_eventual(&mut self, group_id: u32, uid: u64) -> Option<NotifyContent> {
+        self.published_progress.remove(&group_id);
         let customized = self.group_customized_notify(group_id);
         let is_completion_visible = self.check_completion_visibility_from_group(group_id);
         let group_progress = match self.group_notify_progress.entry(group_id) {
@@ -767,6 +857,20 @@ impl NotifyFlow {
         ))
     }
 
+    /// Drops the cached notification settings of a task whose notification
+    /// information was cleared from the database.
+    ///
+    /// # Arguments
+    ///
+    /// * `task_id` - Task to forget
+    fn forget_task(&mut self, task_id: u32) {
+        self.notify_type_map.remove(&task_id);
+        self.last_notify_map.remove(&task_id);
+        self.task_customized_notify.remove(&task_id);
+        self.progress_visibility.remove(&task_id);
+        self.completion_visibility.remove(&task_id);
+    }
+
     /// Determines whether a task belongs to a group or is individual.
     /// 
     /// # Arguments
@@ -27,7 +27,7 @@ use ylong_runtime::sync::mpsc::{self, unbounded_channel};
 
 use super::database::NotificationDb;
 use super::notify_flow::{EventualNotify, NotifyFlow, NotifyInfo, ProgressNotify};
-use super::task_handle::{cancel_notification, NotificationCheck};
+use super::task_handle::{cancel_notification, ensure_notification_subscribed, NotificationCheck};
 use crate::info::TaskInfo;
 use crate::service::notification_bar::NotificationConfig;
 use crate::task::request_task::RequestTask;
@@ -53,8 +53,12 @@ impl NotificationDispatcher {
     /// Creates a new NotificationDispatcher instance.
     /// 
     /// Initializes the database, creates a notification channel, and starts the
-    /// notification flow for processing notifications asynchronously.
+    /// notification flow for processing notifications asynchronously. The
+    /// notification bar events are subscribed to here, when notifications are
+    /// first handled.
     fn new() -> Self {
+        ensure_notification_subscribed();
+
         // Create notification database
         let database = Arc::new(NotificationDb::new());
         // Set up channel for notification messages
@@ -263,7 +267,7 @@ impl NotificationDispatcher {
                     String::new()
                 }
             },
-            processed: progress.common_data.total_processed as u64,
+            processed: task.processed.total() as u64,
             total,
             multi_upload,
             version: task.conf.version,
@@ -18,6 +18,7 @@
 //! subscription management for the notification bar.
 
 use std::sync::atomic::Ordering;
+use std::sync::{Mutex, Once};
 
 use super::database::NotificationDb;
 use super::ffi::{self, SubscribeNotification};
@@ -30,7 +31,15 @@ use crate::manage::events::TaskManagerEvent;
 use crate::manage::task_manager::TaskManagerTx;
 use crate::manage::TaskManager;
 use crate::task::request_task::RequestTask;
-use crate::utils::Recv;
+use crate::utils::startup::{self, Phase};
+use crate::utils::{subscribe_common_event, CommonEventSubscriber, CommonEventWant, Recv};
+
+/// Common event published when the system locale changes.
+const LOCALE_CHANGED: &str = "usual.event.LOCALE_CHANGED";
+
+/// Task manager the notification bar events are sent to, set when the
+/// service starts.
+static TASK_MANAGER: Mutex<Option<TaskManagerTx>> = Mutex::new(None);
 
 /// Cancels a notification for a specific task.
 /// 
@@ -285,16 +294,53 @@ impl TaskManagerWrapper {
     }
 }
 
-/// Subscribes to notification bar events and connects them to task management.
+/// Drops the cached notification resources when the system locale changes.
+struct LocaleChangeSubscriber;
+
+impl CommonEventSubscriber for LocaleChangeSubscriber {
+    fn on_receive_event(&self, _code: i32, _data: String, _want: CommonEventWant) {
+        info!("Receive locale changed event");
+        ffi::ClearResourceCache();
+    }
+}
+
+/// Sets the task manager the notification bar events are sent to.
 /// 
-/// Creates a TaskManagerWrapper and registers it with the notification system
-/// to handle user interactions with notifications.
+/// The subscription itself is left to `ensure_notification_subscribed`, so
+/// that starting the service does not wait for the notification service.
 /// 
 /// # Arguments
 /// 
 /// * `task_manager` - Channel for sending task management events
 pub(crate) fn subscribe_notification_bar(task_manager: TaskManagerTx) {
-    SubscribeNotification(Box::new(TaskManagerWrapper::new(task_manager)));
+    *TASK_MANAGER.lock().unwrap() = Some(task_manager);
+}
+
+/// Subscribes to notification bar events and connects them to task
+/// management, once the first notification is handled.
+/// 
+/// Creates a TaskManagerWrapper and registers it with the notification system
+/// to handle user interactions with notifications, and subscribes to locale
+/// changes to resolve the notification strings again in the new language.
+pub(crate) fn ensure_notification_subscribed() {
+    static ONCE: Once = Once::new();
+    ONCE.call_once(|| {
+        let Some(task_manager) = TASK_MANAGER.lock().unwrap().clone() else {
+            error!("Subscribe notification before the task manager is set");
+            return;
+        };
+        startup::measure(Phase::Notification, || {
+            SubscribeNotification(Box::new(TaskManagerWrapper::new(task_manager)))
+        });
+        if let Err(e) = subscribe_common_event(vec![LOCALE_CHANGED], LocaleChangeSubscriber) {
+            error!("Subscribe locale changed event failed: {}", e);
+            sys_event!(
+                ExecFault,
+                DfxCode::EVENT_FAULT_01,
+                &format!("Subscribe locale changed event failed: {}", e)
+            );
+        }
+    });
 }
 
 impl RequestDb {
@@ -17,9 +17,21 @@
 //! for performing download and upload operations within the request system.
 //! It handles permission verification for both regular operations and management
 //! capabilities.
+//!
+//! Verdicts of the access token service are cached per caller token for
+//! `PERMISSION_CACHE_TTL`, so the several checks of a command, or of the
+//! commands of a batch, cost one round trip per permission. The checked
+//! permissions are granted at install time, the cache is cleared when a
+//! package is changed, replaced or removed.
+
+use std::collections::HashMap;
+use std::sync::{LazyLock, Mutex};
+use std::time::{Duration, Instant};
 
 use crate::config::Action;
-use crate::utils::check_permission;
+use crate::utils::{
+    check_permission, subscribe_common_event, CommonEventSubscriber, CommonEventWant,
+};
 
 /// Permission string for internet access.
 static INTERNET_PERMISSION: &str = "ohos.permission.INTERNET";
@@ -28,6 +40,104 @@ static MANAGER_DOWNLOAD: &str = "ohos.permission.DOWNLOAD_SESSION_MANAGER";
 /// Permission string for upload session management.
 static MANAGER_UPLOAD: &str = "ohos.permission.UPLOAD_SESSION_MANAGER";
 
+/// Time a verdict of the access token service is reused.
+const PERMISSION_CACHE_TTL: Duration = Duration::from_secs(10);
+
+/// Number of verdicts kept, a few per caller.
+const PERMISSION_CACHE_CAPACITY: usize = 512;
+
+/// Package events that may change the permissions of a token.
+const PACKAGE_EVENTS: [&str; 3] = [
+    "usual.event.PACKAGE_CHANGED",
+    "usual.event.PACKAGE_REPLACED",
+    "usual.event.PACKAGE_REMOVED",
+];
+
+/// Verdicts of the callers of the service.
+static PERMISSION_CACHE: LazyLock<PermissionCache> = LazyLock::new(PermissionCache::new);
+
+/// Checks a permission of the calling token through the cache.
+fn check_cached(permission: &'static str) -> bool {
+    let token_id = ipc::Skeleton::calling_full_token_id();
+    PERMISSION_CACHE.check(token_id, permission, Instant::now(), || {
+        check_permission(permission)
+    })
+}
+
+/// Cache of the verdicts of the access token service by token and
+/// permission.
+pub(crate) struct PermissionCache {
+    verdicts: Mutex<HashMap<(u64, &'static str), (Instant, bool)>>,
+}
+
+impl PermissionCache {
+    pub(crate) fn new() -> Self {
+        Self {
+            verdicts: Mutex::new(HashMap::new()),
+        }
+    }
+
+    /// Returns whether `token_id` was granted `permission`, asking `verify`
+    /// unless a verdict younger than `PERMISSION_CACHE_TTL` is cached.
+    pub(crate) fn check<F>(
+        &self,
+        token_id: u64,
+        permission: &'static str,
+        now: Instant,
+        verify: F,
+    ) -> bool
+    where
+        F: FnOnce() -> bool,
+    {
+        let key = (token_id, permission);
+        if let Some((checked, granted)) = self.verdicts.lock().unwrap().get(&key) {
+            if now.saturating_duration_since(*checked) < PERMISSION_CACHE_TTL {
+                return *granted;
+            }
+        }
+        // The lock is not held across the round trip to the service
+        let granted = verify();
+        let mut verdicts = self.verdicts.lock().unwrap();
+        if verdicts.len() >= PERMISSION_CACHE_CAPACITY && !verdicts.contains_key(&key) {
+            verdicts.retain(|_, (checked, _)| {
+                now.saturating_duration_since(*checked) < PERMISSION_CACHE_TTL
+            });
+            if verdicts.len() >= PERMISSION_CACHE_CAPACITY {
+                verdicts.clear();
+            }
+        }
+        verdicts.insert(key, (now, granted));
+        granted
+    }
+
+    /// Forgets every verdict.
+    pub(crate) fn clear(&self) {
+        self.verdicts.lock().unwrap().clear();
+    }
+}
+
+/// Clears the permission cache when a package changes.
+struct PackageChangeSubscriber;
+
+impl CommonEventSubscriber for PackageChangeSubscriber {
+    fn on_receive_event(&self, _code: i32, _data: String, _want: CommonEventWant) {
+        debug!("Receive package change event, clear permission cache");
+        PERMISSION_CACHE.clear();
+    }
+}
+
+/// Subscribes to the package events invalidating the permission cache.
+pub(crate) fn subscribe_permission_change() {
+    if let Err(e) = subscribe_common_event(PACKAGE_EVENTS.to_vec(), PackageChangeSubscriber) {
+        error!("Subscribe package change event failed: {}", e);
+        sys_event!(
+            ExecFault,
+            DfxCode::EVENT_FAULT_01,
+            &format!("Subscribe package change event failed: {}", e)
+        );
+    }
+}
+
 /// Utility struct for checking permissions.
 /// 
 /// Provides static methods to verify various permissions required for
@@ -41,7 +151,7 @@ impl PermissionChecker {
     /// 
     /// `true` if the caller has internet permission, `false` otherwise.
     pub(crate) fn check_internet() -> bool {
-        check_permission(INTERNET_PERMISSION)
+        check_cached(INTERNET_PERMISSION)
     }
 
     /// Checks if the caller has download session management permission.
@@ -50,7 +160,7 @@ impl PermissionChecker {
     /// 
     /// `true` if the caller has download management permission, `false` otherwise.
     pub(crate) fn check_down_permission() -> bool {
-        check_permission(MANAGER_DOWNLOAD)
+        check_cached(MANAGER_DOWNLOAD)
     }
 
     /// Checks the caller's management permissions for download and upload operations.
@@ -63,8 +173,8 @@ impl PermissionChecker {
         debug!("Checks MANAGER permission");
 
         // Check both download and upload management permissions
-        let manager_download = check_permission(MANAGER_DOWNLOAD);
-        let manager_upload = check_permission(MANAGER_UPLOAD);
+        let manager_download = check_cached(MANAGER_DOWNLOAD);
+        let manager_upload = check_cached(MANAGER_UPLOAD);
         info!(
             "Checks manager_download permission is {}, manager_upload permission is {}",
             manager_download, manager_upload
@@ -125,3 +235,8 @@ impl ManagerPermission {
         caller_action == task_action || caller_action == Action::Any
     }
 }
+
+#[cfg(test)]
+mod ut_permission {
+    include!("../../tests/ut/service/ut_permission.rs");
+}
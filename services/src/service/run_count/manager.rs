@@ -17,8 +17,14 @@
 //! notify interested clients when this count changes. It uses a manager-worker pattern
 //! where the `RunCountManagerEntry` provides an API for clients to interact with the
 //! background `RunCountManager` that handles event processing.
+//!
+//! Changes are coalesced: the first change is sent at once and opens a window
+//! of `RUN_COUNT_WINDOW`, changes within the window are only sent when it
+//! closes, and only if the count differs from the one sent last. Clients that
+//! support it get the count over their UDS channel instead of a binder call.
 
 use std::collections::HashMap;
+use std::time::Duration;
 
 use ylong_runtime::sync::mpsc::{unbounded_channel, UnboundedReceiver, UnboundedSender};
 use ylong_runtime::sync::oneshot::{self, Sender};
@@ -29,8 +35,12 @@ cfg_oh! {
 
 use super::{Client, RunCountEvent};
 use crate::error::ErrorCode;
+use crate::service::client::ClientManagerEntry;
 use crate::utils::runtime_spawn;
 
+/// Window within which changes of the run count are coalesced.
+const RUN_COUNT_WINDOW: Duration = Duration::from_millis(100);
+
 /// Entry point for interacting with the run count manager.
 /// 
 /// This struct provides a client-facing API to send events to the background
@@ -147,10 +157,14 @@ impl RunCountManagerEntry {
 /// Maintains the current count of running tasks and manages subscriptions,
 /// running in a dedicated asynchronous task to handle events.
 pub(crate) struct RunCountManager {
-    /// Current number of running tasks
-    count: usize,
+    /// Current number of running tasks and the coalescing window
+    window: RunCountWindow,
     /// Map of subscribers with their process IDs as keys
     remotes: HashMap<u64, Client>,
+    /// Client manager reaching the subscribers over their channels
+    clients: Option<ClientManagerEntry>,
+    /// Sender used to schedule the end of the coalescing window
+    tx: UnboundedSender<RunCountEvent>,
     /// Channel for receiving events from RunCountManagerEntry
     rx: UnboundedReceiver<RunCountEvent>,
 }
@@ -165,11 +179,31 @@ impl RunCountManager {
     /// 
     /// A new `RunCountManagerEntry` instance for client interaction
     pub(crate) fn init() -> RunCountManagerEntry {
+        Self::start(None)
+    }
+
+    /// Initializes the run count manager, sending the run count over the
+    /// channels of the clients that support it.
+    ///
+    /// # Arguments
+    ///
+    /// * `clients` - Client manager owning the channels of the clients
+    ///
+    /// # Returns
+    ///
+    /// A new `RunCountManagerEntry` instance for client interaction
+    pub(crate) fn init_with_clients(clients: ClientManagerEntry) -> RunCountManagerEntry {
+        Self::start(Some(clients))
+    }
+
+    fn start(clients: Option<ClientManagerEntry>) -> RunCountManagerEntry {
         debug!("RunCountManager init");
         let (tx, rx) = unbounded_channel();
         let run_count_manager = RunCountManager {
-            count: 0,
+            window: RunCountWindow::new(),
             remotes: HashMap::new(),
+            clients,
+            tx: tx.clone(),
             rx,
         };
         runtime_spawn(run_count_manager.run());
@@ -200,7 +234,9 @@ impl RunCountManager {
                 RunCountEvent::Subscribe(pid, obj, tx) => self.subscribe_run_count(pid, obj, tx),
                 RunCountEvent::Unsubscribe(pid, tx) => self.unsubscribe_run_count(pid, tx),
                 #[cfg(feature = "oh")]
-                RunCountEvent::Change(change) => self.change_run_count(change),
+                RunCountEvent::Change(change) => self.change_run_count(change).await,
+                #[cfg(feature = "oh")]
+                RunCountEvent::Flush => self.close_window().await,
             }
 
             debug!("RunCountManager handle message done");
@@ -221,7 +257,7 @@ impl RunCountManager {
     fn subscribe_run_count(&mut self, pid: u64, obj: RemoteObj, tx: Sender<ErrorCode>) {
         let client = Client::new(obj);
 
-        let _ = client.notify_run_count(self.count as i64);
+        let _ = client.notify_run_count(self.window.count as i64);
         self.remotes.insert(pid, client);
 
         let _ = tx.send(ErrorCode::ErrOk);
@@ -245,21 +281,111 @@ impl RunCountManager {
 
     #[cfg(feature = "oh")]
     /// Updates the run count and notifies all subscribers.
-    /// 
-    /// Updates the internal count and broadcasts the change to all registered clients.
-    /// Removes any clients that fail to receive the update.
-    /// 
+    ///
+    /// The change is sent at once unless a coalescing window is open.
+    ///
     /// # Arguments
-    /// 
+    ///
     /// * `new_count` - The new number of running tasks
-    fn change_run_count(&mut self, new_count: usize) {
-        // Skip update if count hasn't changed to avoid unnecessary notifications
-        if self.count == new_count {
-            return;
+    async fn change_run_count(&mut self, new_count: usize) {
+        if self.window.change(new_count) {
+            self.notify_all().await;
+        }
+    }
+
+    #[cfg(feature = "oh")]
+    /// Closes the coalescing window, notifying all subscribers if the run
+    /// count changed within it.
+    async fn close_window(&mut self) {
+        if self.window.close() {
+            self.notify_all().await;
+        }
+    }
+
+    #[cfg(feature = "oh")]
+    /// Broadcasts the run count to all registered clients and opens a
+    /// coalescing window.
+    ///
+    /// Clients are reached over their channel if they support it, and with a
+    /// binder call otherwise. Removes any clients that fail to receive the
+    /// update.
+    async fn notify_all(&mut self) {
+        let count = self.window.count as i64;
+        let mut failed = Vec::new();
+        for (&pid, remote) in self.remotes.iter() {
+            if let Some(clients) = self.clients.as_ref() {
+                if clients.send_run_count(pid, count).await {
+                    continue;
+                }
+            }
+            if remote.notify_run_count(count).is_err() {
+                failed.push(pid);
+            }
+        }
+        for pid in failed {
+            self.remotes.remove(&pid);
         }
-        self.count = new_count;
-        // Notify all clients and automatically remove any that fail to receive the update
-        self.remotes
-            .retain(|_, remote| remote.notify_run_count(self.count as i64).is_ok());
+
+        let tx = self.tx.clone();
+        runtime_spawn(async move {
+            ylong_runtime::time::sleep(RUN_COUNT_WINDOW).await;
+            let _ = tx.send(RunCountEvent::Flush);
+        });
     }
 }
+
+/// Coalescing window of the run count.
+///
+/// A change outside of a window is sent at once and opens a window. Changes
+/// within it are sent when it closes, if the count then differs from the one
+/// sent last, which opens a new window.
+pub(crate) struct RunCountWindow {
+    /// Current number of running tasks
+    count: usize,
+    /// Number of running tasks sent last
+    sent: usize,
+    /// Whether a window is open
+    open: bool,
+}
+
+impl RunCountWindow {
+    /// Creates a closed window with no running tasks.
+    pub(crate) fn new() -> Self {
+        Self {
+            count: 0,
+            sent: 0,
+            open: false,
+        }
+    }
+
+    /// Records a new run count.
+    ///
+    /// # Returns
+    ///
+    /// `true` if the count is to be sent now, which opens a window.
+    pub(crate) fn change(&mut self, count: usize) -> bool {
+        self.count = count;
+        if self.open || self.count == self.sent {
+            return false;
+        }
+        self.open = true;
+        self.sent = self.count;
+        true
+    }
+
+    /// Closes the window.
+    ///
+    /// # Returns
+    ///
+    /// `true` if the count changed within the window and is to be sent now,
+    /// which opens a new window.
+    pub(crate) fn close(&mut self) -> bool {
+        self.open = false;
+        self.change(self.count)
+    }
+}
+
+#[cfg(test)]
+mod ut_run_count_window {
+    include!("../../../tests/ut/service/run_count/ut_run_count_window.rs");
+}
@@ -42,6 +42,9 @@ pub(crate) enum RunCountEvent {
     /// Update the current run count.
     #[cfg(feature = "oh")]
     Change(usize),
+    /// Close the coalescing window, sending the run count if it changed.
+    #[cfg(feature = "oh")]
+    Flush,
 }
 
 /// Client for receiving run count notifications.
@@ -17,7 +17,9 @@
 //! for download and upload operations, task management, and status monitoring.
 
 use std::fs::File;
+use std::sync::atomic::{AtomicUsize, Ordering};
 use std::sync::Mutex;
+use std::time::Instant;
 
 use ipc::parcel::MsgParcel;
 use ipc::remote::RemoteStub;
@@ -33,6 +35,7 @@ use crate::manage::task_manager::TaskManagerTx;
 use crate::service::active_counter::ActiveCounter;
 use crate::task::config::TaskConfig;
 use crate::task::info::TaskInfo;
+use crate::utils::{metrics, startup};
 
 /// Service stub implementation for handling remote IPC requests for request operations.
 ///
@@ -158,7 +161,14 @@ impl RemoteStub for RequestServiceStub {
                 return IpcStatusCode::Failed as i32;
             }
         };
-        
+
+        // Binder threads inside the handlers, a pool full of threads blocked
+        // on the task manager shows as values near its size
+        static BUSY_THREADS: AtomicUsize = AtomicUsize::new(0);
+        let busy = BUSY_THREADS.fetch_add(1, Ordering::Relaxed) + 1;
+        metrics::IPC_BUSY_THREADS.record(busy as u64);
+        let start = Instant::now();
+
         // Route request to appropriate handler based on operation code
         let res = match code {
             interface::CONSTRUCT => self.construct(data, reply),
@@ -185,9 +195,19 @@ impl RemoteStub for RequestServiceStub {
             interface::SET_MAX_SPEED => self.set_max_speed(data, reply),
             interface::SET_MODE => self.set_mode(data, reply),
             interface::DISABLE_TASK_NOTIFICATION => self.disable_task_notifications(data, reply),
+            interface::SET_SCHEDULE_POLICY => self.set_schedule_policy(data, reply),
+            interface::OPEN_PROGRESS_TABLE => self.open_progress_table(reply),
+            interface::GET_STATS => self.get_stats(reply),
+            interface::OPEN_SHARED_CACHE => self.open_shared_cache(data, reply),
+            interface::PUBLISH_SHARED_CACHE => self.publish_shared_cache(data, reply),
+            interface::SUBSCRIBE_TASKS => self.subscribe_tasks(data, reply),
             _ => Err(IpcStatusCode::Failed),
         };
 
+        metrics::IPC_REPLY_US.record_since(start);
+        startup::served(start);
+        BUSY_THREADS.fetch_sub(1, Ordering::Relaxed);
+
         // Decrement active counter after request processing is complete
         self.active_counter.decrement();
         
@@ -216,20 +236,55 @@ impl RemoteStub for RequestServiceStub {
     }
 }
 
+/// The form items of a serialized `TaskInfo`.
+pub(crate) const TASK_INFO_FORM_ITEMS: u32 = 0x01;
+/// The file specs of a serialized `TaskInfo`.
+pub(crate) const TASK_INFO_FILE_SPECS: u32 = 0x02;
+/// The extras of a serialized `TaskInfo` and of its progress.
+pub(crate) const TASK_INFO_EXTRAS: u32 = 0x04;
+/// The status of each file of a serialized `TaskInfo`.
+pub(crate) const TASK_INFO_EACH_FILE_STATUS: u32 = 0x08;
+/// All the optional parts of a serialized `TaskInfo`.
+pub(crate) const TASK_INFO_ALL: u32 = 0x0F;
+
 /// Serializes task information into a message parcel for IPC transmission.
 ///
 /// This function converts a `TaskInfo` struct into a format suitable for IPC transmission
-/// by writing each field sequentially to the provided message parcel.
+/// by writing each field sequentially to the provided message parcel. The
+/// optional parts not selected by `fields` are written empty, so the layout
+/// of the parcel does not depend on them.
 ///
 /// # Arguments
 ///
 /// * `tf` - The task information to serialize
+/// * `fields` - The `TASK_INFO_*` parts to serialize
 /// * `reply` - The message parcel to write the serialized data to
 ///
 /// # Returns
 ///
 /// `Ok(())` on successful serialization, or an `IpcResult` error if any field fails to write.
-pub(crate) fn serialize_task_info(tf: TaskInfo, reply: &mut MsgParcel) -> IpcResult<()> {
+pub(crate) fn serialize_task_info(
+    mut tf: TaskInfo,
+    fields: u32,
+    reply: &mut MsgParcel,
+) -> IpcResult<()> {
+    // Built first, the status of the files comes from their specs
+    let each_file_status = if fields & TASK_INFO_EACH_FILE_STATUS == 0 {
+        Vec::new()
+    } else {
+        tf.build_each_file_status()
+    };
+    if fields & TASK_INFO_FORM_ITEMS == 0 {
+        tf.form_items.clear();
+    }
+    if fields & TASK_INFO_FILE_SPECS == 0 {
+        tf.file_specs.clear();
+    }
+    if fields & TASK_INFO_EXTRAS == 0 {
+        tf.progress.extras.clear();
+        tf.extras.clear();
+    }
+
     // Serialize common data fields
     reply.write(&(tf.common_data.gauge))?;
     reply.write(&(tf.common_data.retry))?;
@@ -272,6 +327,8 @@ pub(crate) fn serialize_task_info(tf: TaskInfo, reply: &mut MsgParcel) -> IpcRes
     reply.write(&(tf.progress.processed[index] as u64))?;
     reply.write(&(tf.progress.common_data.total_processed as u64))?;
     reply.write(&(tf.progress.sizes))?;
+    reply.write(&(tf.progress.speed))?;
+    reply.write(&(tf.progress.eta))?;
 
     // Serialize progress extras map with length prefix
     reply.write(&(tf.progress.extras.len() as u32))?;
@@ -289,13 +346,21 @@ pub(crate) fn serialize_task_info(tf: TaskInfo, reply: &mut MsgParcel) -> IpcRes
     
     // Serialize version and file status information
     reply.write(&(tf.common_data.version as u32))?;
-    let each_file_status = tf.build_each_file_status();
     reply.write(&(each_file_status.len() as u32))?;
     for item in each_file_status.iter() {
         reply.write(&(item.path))?;
         reply.write(&(item.reason.repr as u32))?;
         reply.write(&(item.message))?;
     }
+
+    // Serialize transport timings of the latest attempt
+    reply.write(&(tf.performance.attempt))?;
+    reply.write(&(tf.performance.dns))?;
+    reply.write(&(tf.performance.connect))?;
+    reply.write(&(tf.performance.tls))?;
+    reply.write(&(tf.performance.ttfb))?;
+    reply.write(&(tf.performance.transfer))?;
+    reply.write(&(tf.performance.server))?;
     Ok(())
 }
 
@@ -333,7 +398,7 @@ pub(crate) fn serialize_task_config(config: TaskConfig, reply: &mut MsgParcel) -
     reply.write(&(config.common_data.multipart))?;
     
     // Serialize task identification and metadata
-    reply.write(&(config.bundle))?;
+    reply.write(&(config.bundle.to_string()))?;
     reply.write(&(config.url))?;
     reply.write(&(config.title))?;
     reply.write(&(config.description))?;
@@ -385,5 +450,33 @@ pub(crate) fn serialize_task_config(config: TaskConfig, reply: &mut MsgParcel) -
     // Serialize minimum speed requirements
     reply.write(&(config.common_data.min_speed.speed))?;
     reply.write(&(config.common_data.min_speed.duration))?;
+
+    // Serialize stall detection settings
+    reply.write(&(config.common_data.stall_detection.window))?;
+    reply.write(&(config.common_data.stall_detection.ratio))?;
+
+    // Serialize upload concurrency
+    reply.write(&(config.common_data.concurrency))?;
+
+    // Serialize resumable upload chunk size
+    reply.write(&(config.common_data.chunk_size))?;
+
+    // Serialize scheduling deadline
+    reply.write(&(config.common_data.deadline))?;
+
+    // Serialize transfer coalescing
+    reply.write(&(config.common_data.coalesce))?;
+
+    // Serialize content decoding
+    reply.write(&(config.common_data.compression))?;
+
+    // Serialize in-memory body cap
+    reply.write(&(config.common_data.memory_limit))?;
+
+    // Serialize prefetch scheduling
+    reply.write(&(config.common_data.prefetch))?;
+
+    // Serialize page cache bypass
+    reply.write(&(config.common_data.bypass_cache))?;
     Ok(())
 }
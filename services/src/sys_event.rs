@@ -59,6 +59,14 @@ impl<'a> SysEvent<'a> {
         }
     }
 
+    pub(crate) fn service_startup() -> Self {
+        Self {
+            event_kind: EventKind::ServiceStartup,
+            inner_type: EventType::Statistic,
+            params: Vec::new(),
+        }
+    }
+
     pub(crate) fn param(mut self, param: HiSysEventParam<'a>) -> Self {
         self.params.push(param);
         self
@@ -78,6 +86,7 @@ pub(crate) enum EventKind {
     TaskFault,
     ExecError,
     ExecFault,
+    ServiceStartup,
 }
 
 impl EventKind {
@@ -86,6 +95,7 @@ impl EventKind {
             EventKind::TaskFault => "TASK_FAULT",
             EventKind::ExecError => "EXEC_ERROR",
             EventKind::ExecFault => "EXEC_FAULT",
+            EventKind::ServiceStartup => "SERVICE_STARTUP",
         }
     }
 }
@@ -0,0 +1,172 @@
+// Copyright (C) 2023 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Integrity verification of downloaded files.
+//!
+//! A download opts in with the `checksum` field of its config, written as
+//! `sha256:<hex>` or `md5:<hex>`. The digest is updated with every buffer the
+//! task operator writes to the file, so the file is not read again once the
+//! download completes. Only the bytes already on disk when a download resumes,
+//! and the files of segmented downloads, are read to compute it.
+
+use std::fs::File;
+use std::io;
+use std::os::unix::fs::FileExt;
+use std::sync::{Arc, Mutex};
+
+use request_utils::hash::{Md5, Sha256};
+
+use super::task_control;
+
+/// Bytes read at once when hashing a file.
+const READ_SIZE: usize = 256 * 1024;
+
+/// Key of the progress extra holding the digest of a completed download.
+pub(crate) const CHECKSUM_EXTRA: &str = "checksum";
+
+/// Digest algorithms a checksum can use.
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub(crate) enum Algorithm {
+    Sha256,
+    Md5,
+}
+
+impl Algorithm {
+    fn name(self) -> &'static str {
+        match self {
+            Algorithm::Sha256 => "sha256",
+            Algorithm::Md5 => "md5",
+        }
+    }
+
+    fn digest_len(self) -> usize {
+        match self {
+            Algorithm::Sha256 => 32,
+            Algorithm::Md5 => 16,
+        }
+    }
+}
+
+/// Expected digest of a downloaded file.
+#[derive(Clone, Debug, PartialEq, Eq)]
+pub(crate) struct Checksum {
+    pub(crate) algorithm: Algorithm,
+    pub(crate) expected: Vec<u8>,
+}
+
+impl Checksum {
+    /// Parses a checksum written as `<algorithm>:<hex>`, the algorithm name is
+    /// case insensitive.
+    ///
+    /// # Returns
+    ///
+    /// `None` if the algorithm is unknown or the digest has the wrong length.
+    pub(crate) fn parse(spec: &str) -> Option<Self> {
+        let (name, digest) = spec.trim().split_once(':')?;
+        let algorithm = match name.to_ascii_lowercase().as_str() {
+            "sha256" | "sha-256" => Algorithm::Sha256,
+            "md5" => Algorithm::Md5,
+            _ => return None,
+        };
+        let expected = from_hex(digest)?;
+        if expected.len() != algorithm.digest_len() {
+            return None;
+        }
+        Some(Self {
+            algorithm,
+            expected,
+        })
+    }
+}
+
+/// Running digest of the bytes written to a file.
+pub(crate) enum Digest {
+    Sha256(Sha256),
+    Md5(Md5),
+}
+
+impl Digest {
+    pub(crate) fn new(algorithm: Algorithm) -> Self {
+        match algorithm {
+            Algorithm::Sha256 => Digest::Sha256(Sha256::new()),
+            Algorithm::Md5 => Digest::Md5(Md5::new()),
+        }
+    }
+
+    pub(crate) fn update(&mut self, data: &[u8]) {
+        match self {
+            Digest::Sha256(sha) => sha.update(data),
+            Digest::Md5(md5) => md5.update(data),
+        }
+    }
+
+    pub(crate) fn finish(self) -> Vec<u8> {
+        match self {
+            Digest::Sha256(sha) => sha.finish().to_vec(),
+            Digest::Md5(md5) => md5.finish().to_vec(),
+        }
+    }
+}
+
+/// Formats a digest the way checksums are written, `<algorithm>:<hex>`.
+pub(crate) fn format(algorithm: Algorithm, digest: &[u8]) -> String {
+    let mut out = String::with_capacity(algorithm.name().len() + 1 + digest.len() * 2);
+    out.push_str(algorithm.name());
+    out.push(':');
+    for byte in digest {
+        out.push_str(&format!("{:02x}", byte));
+    }
+    out
+}
+
+fn from_hex(hex: &str) -> Option<Vec<u8>> {
+    if hex.len() % 2 != 0 || !hex.is_ascii() {
+        return None;
+    }
+    (0..hex.len())
+        .step_by(2)
+        .map(|i| u8::from_str_radix(&hex[i..i + 2], 16).ok())
+        .collect()
+}
+
+/// Adds the first `len` bytes of a file to a digest, without moving the file
+/// cursor.
+///
+/// # Errors
+///
+/// Returns an error if the file is shorter than `len` or cannot be read.
+pub(crate) async fn hash_file(
+    file: Arc<Mutex<File>>,
+    len: u64,
+    mut digest: Digest,
+) -> io::Result<Digest> {
+    task_control::runtime_spawn_blocking(move || {
+        let file = file.lock().unwrap();
+        let mut buf = vec![0u8; READ_SIZE];
+        let mut offset = 0u64;
+        while offset < len {
+            let size = READ_SIZE.min((len - offset) as usize);
+            file.read_exact_at(&mut buf[..size], offset)?;
+            digest.update(&buf[..size]);
+            offset += size as u64;
+        }
+        Ok(digest)
+    })
+    .await
+    .map_err(|e| io::Error::new(io::ErrorKind::Other, e))?
+}
+
+#[cfg(test)]
+mod ut_checksum {
+    include!("../../tests/ut/task/ut_checksum.rs");
+}
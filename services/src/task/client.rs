@@ -39,15 +39,21 @@ cfg_oh! {
 
 use super::files::BundleCache;
 use crate::task::config::{Action, TaskConfig};
+use crate::task::dns::CachedResolver;
+use crate::task::redirect::follows_redirects;
 use crate::task::files::convert_path;
+use crate::task::ATOMIC_SERVICE;
 
 /// Builds an HTTP client with configuration based on the provided task settings.
 ///
+/// The client has no total timeout, it is shared by the tasks of the client
+/// pool and each of them enforces its own. The domain policy of atomic
+/// services is checked by `check_domain_policy`.
+///
 /// # Arguments
 ///
 /// * `config` - The task configuration containing connection parameters, certificates,
 ///             proxy settings, and other client options.
-/// * `total_timeout` - The total timeout in seconds for the entire client operation.
 /// * `system` - [Only in OHOS] System configuration containing system-wide settings.
 ///
 /// # Returns
@@ -62,14 +68,13 @@ use crate::task::files::convert_path;
 ///
 /// // Assuming a TaskConfig instance
 /// let config = TaskConfig::default();
-/// let total_timeout = 300; // 5 minutes
 /// #[cfg(feature = "oh")]
 /// let system = SystemConfig::default();
 ///
 /// #[cfg(feature = "oh")]
-/// let client = build_client(&config, total_timeout, system)?;
+/// let client = build_client(&config, system)?;
 /// #[cfg(not(feature = "oh"))]
-/// let client = build_client(&config, total_timeout)?;
+/// let client = build_client(&config)?;
 /// ```
 ///
 /// # Errors
@@ -78,36 +83,29 @@ use crate::task::files::convert_path;
 /// - Proxy creation failures
 /// - Certificate loading issues
 /// - Client build errors
-/// - Domain policy validation failures
 pub(crate) fn build_client(
     config: &TaskConfig,
-    total_timeout: u64,
     #[cfg(feature = "oh")] mut system: SystemConfig,
 ) -> Result<Client, Box<dyn Error + Send + Sync>> {
-    const DEFAULT_CONNECTION_TIMEOUT: u64 = 60;
-
-    // Use default timeout if none specified
-    let mut connection_timeout = config.common_data.timeout.connection_timeout;
-    if connection_timeout == 0 {
-        connection_timeout = DEFAULT_CONNECTION_TIMEOUT;
-    }
-
     // Set up basic client configuration with required timeouts and TLS version
-    // Ensure connections are established within a reasonable time and operations complete promptly
+    // Ensure connections are established within a reasonable time
     let mut client = Client::builder()
-        .connect_timeout(Timeout::from_secs(connection_timeout))  // Time to establish connection
-        .total_timeout(Timeout::from_secs(total_timeout))         // Total time limit for entire request
-        .min_tls_version(TlsVersion::TLS_1_2);                    // Enforce secure TLS version
+        .connect_timeout(Timeout::from_secs(connection_timeout(config))) // Time to connect
+        .min_tls_version(TlsVersion::TLS_1_2);                           // Enforce secure TLS version
     
     // Set socket ownership for proper resource management
     client = client.sockets_owner(config.common_data.uid as u32, config.common_data.uid as u32);
+
+    // Resolve hosts through the DNS cache shared by all clients
+    client = client.dns_resolver(CachedResolver);
     
     // Configure redirect strategy based on task settings
-    if config.common_data.redirect {
+    if config.common_data.redirect && !follows_redirects(config) {
         // Allow unlimited redirects when explicitly requested
         client = client.redirect(Redirect::limited(usize::MAX));
     } else {
-        // Disable redirects by default for security and predictability
+        // Disable redirects by default for security and predictability, or
+        // leave them to the task that caches their targets
         client = client.redirect(Redirect::none());
     }
 
@@ -152,53 +150,14 @@ pub(crate) fn build_client(
         client = client.add_public_key_pins(pinned_key);
     }
 
-    // Apply domain policy checks for atomic services (system-specific security check)
-    const ATOMIC_SERVICE: u32 = 1;
+    // Add interceptor to check redirects against domain policy
+    // This ensures that any URLs encountered during redirects also comply with
+    // the domain access policies, providing comprehensive security coverage
+    #[cfg(feature = "oh")]
     if config.bundle_type == ATOMIC_SERVICE {
         let domain_type = action_to_domain_type(config.common_data.action);
-        info!(
-            "ApiPolicy Domain check, tid {}, bundle {}, domain_type {}, url {}",
-            config.common_data.task_id, &config.bundle, &domain_type, &config.url
-        );
-        
-        #[cfg(feature = "oh")]
-        if let Some(is_accessed) = check_url_domain(&config.bundle, &domain_type, &config.url) {
-            if !is_accessed {
-                // Log policy violation and return error
-                error!(
-                    "Intercept request by domain check, tid {}, bundle {}, domain_type {}, url {}",
-                    config.common_data.task_id, &config.bundle, &domain_type, &config.url
-                );
-                sys_event!(
-                    ExecFault,
-                    DfxCode::URL_POLICY_FAULT_00,
-                    &format!(
-                    "Intercept request by domain check, tid {}, bundle {}, domain_type {}, url {}",
-                config.common_data.task_id, &config.bundle, &domain_type, &config.url)
-                );
-
-                // Wrap the HttpClientError in a Box to fit the function's return type requirement
-                // This conversion allows us to return a trait object implementing Error + Send + Sync
-                return Err(Box::new(HttpClientError::other(
-                    "Intercept request by domain check",
-                )));
-            }
-        } else {
-            info!(
-                "Intercept request by domain check, tid {}, domain_type {}, url {}",
-                config.common_data.task_id, &domain_type, &config.url
-            );
-        }
-
-        // Add interceptor to check redirects against domain policy
-        // This ensures that any URLs encountered during redirects also comply with
-        // the domain access policies, providing comprehensive security coverage
-        #[cfg(feature = "oh")]
-        {
-            let interceptors = DomainInterceptor::new(config.bundle.clone(), domain_type);
-            client = client.interceptor(interceptors);
-        }
-
+        let interceptors = DomainInterceptor::new(config.bundle.to_string(), domain_type);
+        client = client.interceptor(interceptors);
         info!(
             "add interceptor domain check, tid {}",
             config.common_data.task_id
@@ -216,6 +175,64 @@ pub(crate) fn build_client(
     ))
 }
 
+/// Returns the connection timeout of a task in seconds.
+pub(crate) fn connection_timeout(config: &TaskConfig) -> u64 {
+    const DEFAULT_CONNECTION_TIMEOUT: u64 = 60;
+
+    // Use default timeout if none specified
+    match config.common_data.timeout.connection_timeout {
+        0 => DEFAULT_CONNECTION_TIMEOUT,
+        timeout => timeout,
+    }
+}
+
+/// Applies the domain policy of atomic services to the url of a task.
+///
+/// # Errors
+///
+/// Returns an error if the bundle of an atomic service may not access the
+/// domain of the url.
+pub(crate) fn check_domain_policy(config: &TaskConfig) -> Result<(), Box<dyn Error + Send + Sync>> {
+    if config.bundle_type != ATOMIC_SERVICE {
+        return Ok(());
+    }
+    let domain_type = action_to_domain_type(config.common_data.action);
+    info!(
+        "ApiPolicy Domain check, tid {}, bundle {}, domain_type {}, url {}",
+        config.common_data.task_id, &config.bundle, &domain_type, &config.url
+    );
+
+    #[cfg(feature = "oh")]
+    if let Some(is_accessed) = check_url_domain(&config.bundle, &domain_type, &config.url) {
+        if !is_accessed {
+            // Log policy violation and return error
+            error!(
+                "Intercept request by domain check, tid {}, bundle {}, domain_type {}, url {}",
+                config.common_data.task_id, &config.bundle, &domain_type, &config.url
+            );
+            sys_event!(
+                ExecFault,
+                DfxCode::URL_POLICY_FAULT_00,
+                &format!(
+                "Intercept request by domain check, tid {}, bundle {}, domain_type {}, url {}",
+            config.common_data.task_id, &config.bundle, &domain_type, &config.url)
+            );
+
+            // Wrap the HttpClientError in a Box to fit the function's return type requirement
+            // This conversion allows us to return a trait object implementing Error + Send + Sync
+            return Err(Box::new(HttpClientError::other(
+                "Intercept request by domain check",
+            )));
+        }
+    } else {
+        info!(
+            "Intercept request by domain check, tid {}, domain_type {}, url {}",
+            config.common_data.task_id, &domain_type, &config.url
+        );
+    }
+    Ok(())
+}
+
 /// Creates a proxy configuration from task settings.
 ///
 /// # Arguments
@@ -387,7 +404,7 @@ fn build_system_proxy(
 
 fn build_task_certs(config: &TaskConfig) -> Result<Vec<Certificate>, Box<dyn Error + Send + Sync>> {
     let uid = config.common_data.uid;
-    let paths = config.certs_path.as_slice();
+    let paths = &config.certs_path[..];
     let mut bundle_cache = BundleCache::new(config);
 
     let mut certs = Vec::new();
@@ -434,7 +451,7 @@ fn build_task_certs(config: &TaskConfig) -> Result<Vec<Certificate>, Box<dyn Err
 /// assert_eq!(action_to_domain_type(Action::Upload), "upload");
 /// assert_eq!(action_to_domain_type(Action::Any), "");
 /// ```
-fn action_to_domain_type(action: Action) -> String {
+pub(crate) fn action_to_domain_type(action: Action) -> String {
     match action {
         Action::Download => "download".to_string(),
         Action::Upload => "upload".to_string(),
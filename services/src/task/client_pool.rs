@@ -0,0 +1,350 @@
+// Copyright (C) 2023 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! HTTP clients shared by the tasks of the service.
+//!
+//! Tasks whose configs build the same client share it, so a task reuses the
+//! connections and TLS sessions the client kept from the tasks before it.
+//! Clients are keyed by everything `build_client` reads from a config, the
+//! total timeout is enforced by each task instead. A client no task used for
+//! `IDLE_TIMEOUT` is dropped with its connections, and a client older than
+//! `MAX_AGE` is no longer handed out, so refreshed system certificates and
+//! proxy settings reach new tasks.
+//!
+//! Requests to a host take one of its `MAX_CONNECTIONS_PER_HOST` slots while
+//! their connection is busy, which bounds the connections all clients open to
+//! the host.
+
+use std::collections::HashMap;
+use std::error::Error;
+use std::sync::atomic::{AtomicBool, Ordering};
+use std::sync::{Arc, LazyLock, Mutex};
+use std::time::Duration;
+
+use ylong_http_client::async_impl::Client;
+
+cfg_oh! {
+    use crate::manage::SystemConfig;
+}
+
+use crate::task::client::{
+    action_to_domain_type, build_client, check_domain_policy, connection_timeout,
+};
+use crate::task::config::TaskConfig;
+use crate::task::redirect::follows_redirects;
+use crate::task::ATOMIC_SERVICE;
+use crate::utils::{get_current_timestamp, runtime_spawn};
+
+/// Time in milliseconds after which a client no task uses is dropped.
+const IDLE_TIMEOUT: u64 = 60 * 1000;
+
+/// Time in milliseconds after which a client is no longer handed out.
+const MAX_AGE: u64 = 10 * 60 * 1000;
+
+/// Maximum number of clients kept.
+const MAX_CLIENTS: usize = 32;
+
+/// Maximum number of requests in flight to a host.
+pub(crate) const MAX_CONNECTIONS_PER_HOST: usize = 8;
+
+/// Interval in milliseconds between two tries to take a slot of a host.
+const HOST_SLOT_RETRY_INTERVAL: u64 = 50;
+
+/// Settings of a task config that make up its client.
+#[derive(Clone, Debug, PartialEq, Eq, Hash)]
+pub(crate) struct ClientKey {
+    /// Sockets are owned by the uid of the task
+    uid: u64,
+    connection_timeout: u64,
+    redirect: bool,
+    min_speed: (i64, i64),
+    proxy: Arc<str>,
+    /// Host, port and exclusion list of the system proxy
+    system_proxy: (String, String, String),
+    certs_path: Arc<[String]>,
+    /// The pins and the url they are bound to
+    pins: Option<(String, String)>,
+    /// Bundle and domain type of an atomic service, whose redirects are checked
+    domain: Option<(Arc<str>, String)>,
+}
+
+impl ClientKey {
+    /// Collects the settings of a config the client is built from.
+    pub(crate) fn new(
+        config: &TaskConfig,
+        #[cfg(feature = "oh")] system: &SystemConfig,
+    ) -> Self {
+        #[cfg(feature = "oh")]
+        let system_proxy = (
+            system.proxy_host.clone(),
+            system.proxy_port.clone(),
+            system.proxy_exlist.clone(),
+        );
+        #[cfg(not(feature = "oh"))]
+        let system_proxy = Default::default();
+
+        let pins = (!config.certificate_pins.is_empty())
+            .then(|| (config.url.clone(), config.certificate_pins.clone()));
+        let domain = (config.bundle_type == ATOMIC_SERVICE).then(|| {
+            (
+                config.bundle.clone(),
+                action_to_domain_type(config.common_data.action),
+            )
+        });
+        Self {
+            uid: config.common_data.uid,
+            connection_timeout: connection_timeout(config),
+            redirect: config.common_data.redirect && !follows_redirects(config),
+            min_speed: (
+                config.common_data.min_speed.speed,
+                config.common_data.min_speed.duration,
+            ),
+            proxy: config.proxy.clone(),
+            system_proxy,
+            certs_path: config.certs_path.clone(),
+            pins,
+            domain,
+        }
+    }
+}
+
+struct Entry<C> {
+    client: Arc<C>,
+    /// Build time in milliseconds
+    created: u64,
+    /// Time in milliseconds the client was last seen in use
+    used: u64,
+}
+
+/// Clients by key, with their age and last use.
+pub(crate) struct Clients<C> {
+    entries: HashMap<ClientKey, Entry<C>>,
+}
+
+impl<C> Clients<C> {
+    pub(crate) fn new() -> Self {
+        Self {
+            entries: HashMap::new(),
+        }
+    }
+
+    /// Returns the client of `key`, unless it is older than `MAX_AGE`.
+    pub(crate) fn get(&mut self, key: &ClientKey, now: u64) -> Option<Arc<C>> {
+        let entry = self.entries.get_mut(key)?;
+        if now.saturating_sub(entry.created) >= MAX_AGE {
+            return None;
+        }
+        entry.used = now;
+        Some(entry.client.clone())
+    }
+
+    /// Keeps a client under `key`, replacing an expired one. The client is not
+    /// kept once `MAX_CLIENTS` are in use, it is still returned.
+    pub(crate) fn insert(&mut self, key: ClientKey, client: C, now: u64) -> Arc<C> {
+        let client = Arc::new(client);
+        if self.entries.len() >= MAX_CLIENTS && !self.entries.contains_key(&key) {
+            self.evict(now);
+        }
+        if self.entries.len() < MAX_CLIENTS || self.entries.contains_key(&key) {
+            let entry = Entry {
+                client: client.clone(),
+                created: now,
+                used: now,
+            };
+            self.entries.insert(key, entry);
+        }
+        client
+    }
+
+    /// Drops the clients that expired or were idle for `IDLE_TIMEOUT`, a
+    /// client still held by a task counts as used.
+    pub(crate) fn evict(&mut self, now: u64) {
+        self.entries.retain(|_, entry| {
+            if Arc::strong_count(&entry.client) > 1 {
+                entry.used = now;
+                return true;
+            }
+            now.saturating_sub(entry.used) < IDLE_TIMEOUT
+                && now.saturating_sub(entry.created) < MAX_AGE
+        });
+    }
+
+    pub(crate) fn len(&self) -> usize {
+        self.entries.len()
+    }
+
+    pub(crate) fn is_empty(&self) -> bool {
+        self.entries.is_empty()
+    }
+}
+
+/// Requests in flight by host.
+pub(crate) struct HostSlots {
+    busy: Mutex<HashMap<String, usize>>,
+}
+
+impl HostSlots {
+    pub(crate) fn new() -> Self {
+        Self {
+            busy: Mutex::new(HashMap::new()),
+        }
+    }
+
+    /// Takes a slot of `host` if fewer than `MAX_CONNECTIONS_PER_HOST` are taken.
+    pub(crate) fn try_take(&self, host: &str) -> Option<HostSlot<'_>> {
+        let mut busy = self.busy.lock().unwrap();
+        let count = busy.entry(host.to_string()).or_insert(0);
+        if *count >= MAX_CONNECTIONS_PER_HOST {
+            return None;
+        }
+        *count += 1;
+        Some(HostSlot {
+            slots: self,
+            host: host.to_string(),
+        })
+    }
+
+    fn release(&self, host: &str) {
+        let mut busy = self.busy.lock().unwrap();
+        if let Some(count) = busy.get_mut(host) {
+            *count -= 1;
+            if *count == 0 {
+                busy.remove(host);
+            }
+        }
+    }
+}
+
+/// A slot of a host, released when dropped.
+pub(crate) struct HostSlot<'a> {
+    slots: &'a HostSlots,
+    host: String,
+}
+
+impl Drop for HostSlot<'_> {
+    fn drop(&mut self) {
+        self.slots.release(&self.host);
+    }
+}
+
+/// Returns the lowercase host and port of a url.
+pub(crate) fn host_of(url: &str) -> String {
+    let rest = url.split_once("://").map_or(url, |(_, rest)| rest);
+    let end = rest.find(['/', '?', '#']).unwrap_or(rest.len());
+    let authority = &rest[..end];
+    let authority = authority.rsplit_once('@').map_or(authority, |(_, a)| a);
+    authority.to_ascii_lowercase()
+}
+
+/// Pool of the clients shared by tasks.
+pub(crate) struct ClientPool {
+    clients: Mutex<Clients<Client>>,
+    hosts: HostSlots,
+    /// Whether idle clients are being swept
+    sweeping: AtomicBool,
+}
+
+static CLIENT_POOL: LazyLock<ClientPool> = LazyLock::new(|| ClientPool {
+    clients: Mutex::new(Clients::new()),
+    hosts: HostSlots::new(),
+    sweeping: AtomicBool::new(false),
+});
+
+impl ClientPool {
+    pub(crate) fn get_instance() -> &'static Self {
+        &CLIENT_POOL
+    }
+
+    /// Returns the client of a task, built if no task with an equivalent
+    /// config holds one.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if the url breaks the domain policy of an atomic
+    /// service or the client cannot be built.
+    pub(crate) fn client(
+        &'static self,
+        config: &TaskConfig,
+        #[cfg(feature = "oh")] system: SystemConfig,
+    ) -> Result<Arc<Client>, Box<dyn Error + Send + Sync>> {
+        // The policy applies to the url of every task, not to the client
+        check_domain_policy(config)?;
+
+        #[cfg(feature = "oh")]
+        let key = ClientKey::new(config, &system);
+        #[cfg(not(feature = "oh"))]
+        let key = ClientKey::new(config);
+
+        let now = get_current_timestamp();
+        if let Some(client) = self.clients.lock().unwrap().get(&key, now) {
+            debug!("task {} reuses a pooled client", config.common_data.task_id);
+            return Ok(client);
+        }
+
+        #[cfg(feature = "oh")]
+        let client = build_client(config, system)?;
+        #[cfg(not(feature = "oh"))]
+        let client = build_client(config)?;
+
+        let client = self.clients.lock().unwrap().insert(key, client, now);
+        self.start_sweep();
+        Ok(client)
+    }
+
+    /// Waits for a slot of the host of `url`.
+    ///
+    /// # Returns
+    ///
+    /// `None` if the task was aborted while waiting.
+    pub(crate) async fn host_slot(
+        &self,
+        url: &str,
+        abort_flag: &AtomicBool,
+    ) -> Option<HostSlot<'_>> {
+        let host = host_of(url);
+        loop {
+            if let Some(slot) = self.hosts.try_take(&host) {
+                return Some(slot);
+            }
+            if abort_flag.load(Ordering::Acquire) {
+                return None;
+            }
+            ylong_runtime::time::sleep(Duration::from_millis(HOST_SLOT_RETRY_INTERVAL)).await;
+        }
+    }
+
+    /// Sweeps idle clients every `IDLE_TIMEOUT` until the pool is empty.
+    fn start_sweep(&'static self) {
+        if self.sweeping.swap(true, Ordering::SeqCst) {
+            return;
+        }
+        runtime_spawn(async move {
+            loop {
+                ylong_runtime::time::sleep(Duration::from_millis(IDLE_TIMEOUT)).await;
+                let mut clients = self.clients.lock().unwrap();
+                clients.evict(get_current_timestamp());
+                debug!("client pool keeps {} clients", clients.len());
+                if clients.is_empty() {
+                    // Cleared under the lock, a client inserted later starts a new sweep
+                    self.sweeping.store(false, Ordering::SeqCst);
+                    break;
+                }
+            }
+        });
+    }
+}
+
+#[cfg(test)]
+mod ut_client_pool {
+    include!("../../tests/ut/task/ut_client_pool.rs");
+}
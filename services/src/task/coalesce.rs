@@ -0,0 +1,260 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Coalescing of identical downloads.
+//!
+//! Downloads that opt in with `coalesce` and send the same request share one
+//! transfer while they run at the same time. The first one to start, the
+//! leader, downloads the resource as usual. The others, its followers, send
+//! nothing: they mirror the progress of the leader to their own listeners and
+//! clone its file into theirs once it completes. A follower whose leader fails
+//! or stops takes the transfer over, so the failure of a task never ends
+//! another one.
+
+use std::collections::HashMap;
+use std::sync::atomic::{AtomicBool, Ordering};
+use std::sync::{Arc, LazyLock, Mutex};
+use std::time::Duration;
+
+use super::extract;
+use super::reason::Reason;
+use super::request_task::{TaskError, TaskPhase};
+use crate::task::config::{Action, TaskConfig};
+use crate::task::request_task::RequestTask;
+use crate::task::task_control;
+use crate::utils::get_current_timestamp;
+
+/// Interval in milliseconds followers check their leader at.
+const FOLLOW_INTERVAL: u64 = 200;
+
+static TRANSFERS: LazyLock<Mutex<HashMap<String, Arc<Transfer>>>> =
+    LazyLock::new(|| Mutex::new(HashMap::new()));
+
+/// How the leader of a transfer ended.
+#[derive(Clone, Copy, PartialEq, Eq, Debug)]
+enum Outcome {
+    /// The file of the leader is complete and verified.
+    Completed,
+    /// The leader failed or was stopped.
+    Stopped,
+}
+
+/// Transfer shared by identical downloads.
+pub(crate) struct Transfer {
+    key: String,
+    leader: Arc<RequestTask>,
+    /// How the leader ended, `None` while it runs
+    outcome: Mutex<Option<Outcome>>,
+}
+
+/// Part a download takes in its transfer.
+pub(crate) enum Role {
+    /// The download sends the request itself.
+    Leader(Leading),
+    /// The download waits for the leader of the transfer.
+    Follower(Arc<Transfer>),
+}
+
+/// Leadership of a transfer, which ends the transfer when dropped.
+pub(crate) struct Leading(Arc<Transfer>);
+
+impl Leading {
+    /// Ends the transfer, its followers clone the file of the leader if it
+    /// `completed` and take the transfer over otherwise.
+    pub(crate) fn finish(self, completed: bool) {
+        if completed {
+            *self.0.outcome.lock().unwrap() = Some(Outcome::Completed);
+        }
+    }
+}
+
+impl Drop for Leading {
+    fn drop(&mut self) {
+        let mut transfers = TRANSFERS.lock().unwrap();
+        if transfers
+            .get(&self.0.key)
+            .is_some_and(|transfer| Arc::ptr_eq(transfer, &self.0))
+        {
+            transfers.remove(&self.0.key);
+        }
+        // Set under the lock of the transfers, a download joining later
+        // starts a new transfer instead of following a stopped one.
+        self.0
+            .outcome
+            .lock()
+            .unwrap()
+            .get_or_insert(Outcome::Stopped);
+    }
+}
+
+/// Returns the key of the transfer a download can share, `None` if the task
+/// is not a download opting in.
+///
+/// Downloads share a transfer if they send the same request and check the
+/// response the same way, whoever sends it.
+pub(crate) fn key(config: &TaskConfig) -> Option<String> {
+    // Every extraction writes its own directory
+    if !config.common_data.coalesce
+        || config.common_data.action != Action::Download
+        || config.extras.contains_key(extract::EXTRACT_EXTRA)
+    {
+        return None;
+    }
+    let mut headers = config.headers.iter().collect::<Vec<_>>();
+    headers.sort();
+    Some(format!(
+        "{} {}\n{:?}\n{}\n{}-{}\n{} {} {} {}\n{}",
+        config.method,
+        config.url,
+        headers,
+        config.data,
+        config.common_data.begins,
+        config.common_data.ends,
+        config.common_data.redirect,
+        config.common_data.precise,
+        config.common_data.compression,
+        config.proxy,
+        config.checksum,
+    ))
+}
+
+/// Joins the transfer of the download of a task, starting it if none runs.
+///
+/// Returns `None` if the task does not coalesce its download.
+pub(crate) fn join(task: &Arc<RequestTask>) -> Option<Role> {
+    let key = key(&task.conf)?;
+    let mut transfers = TRANSFERS.lock().unwrap();
+    if let Some(transfer) = transfers.get(&key) {
+        if transfer.leader.task_id() != task.task_id() {
+            info!(
+                "task {} follows the download of task {}",
+                task.task_id(),
+                transfer.leader.task_id()
+            );
+            return Some(Role::Follower(transfer.clone()));
+        }
+    }
+    let transfer = Arc::new(Transfer {
+        key: key.clone(),
+        leader: task.clone(),
+        outcome: Mutex::new(None),
+    });
+    transfers.insert(key, transfer.clone());
+    Some(Role::Leader(Leading(transfer)))
+}
+
+/// Follows the transfer of a leader until it ends.
+///
+/// The progress of the leader is mirrored to the task meanwhile, and its file
+/// cloned into the file of the task once it completed.
+///
+/// Returns `None` if the leader stopped, the task then has to download the
+/// resource itself.
+pub(crate) async fn follow(
+    task: &Arc<RequestTask>,
+    transfer: &Transfer,
+    abort_flag: &AtomicBool,
+) -> Option<Result<(), TaskError>> {
+    if let Err(e) = task.prepare_download().await {
+        return Some(Err(e));
+    }
+    loop {
+        if abort_flag.load(Ordering::Acquire) {
+            return Some(Err(TaskError::Waiting(TaskPhase::UserAbort)));
+        }
+        let outcome = *transfer.outcome.lock().unwrap();
+        match outcome {
+            None => {
+                task.mirror_progress(&transfer.leader);
+                task.publish_progress(get_current_timestamp());
+                ylong_runtime::time::sleep(Duration::from_millis(FOLLOW_INTERVAL)).await;
+            }
+            Some(Outcome::Completed) => return Some(task.adopt_download(&transfer.leader).await),
+            Some(Outcome::Stopped) => {
+                info!(
+                    "task {} takes over the download of task {}",
+                    task.task_id(),
+                    transfer.leader.task_id()
+                );
+                return None;
+            }
+        }
+    }
+}
+
+impl RequestTask {
+    /// Takes the sizes and processed bytes of the leader of its transfer.
+    fn mirror_progress(&self, leader: &RequestTask) {
+        let processed = leader.processed.file(0);
+        let sizes = leader.progress.lock().unwrap().sizes.clone();
+        self.file_total_size.store(
+            leader.file_total_size.load(Ordering::SeqCst),
+            Ordering::SeqCst,
+        );
+        self.progress.lock().unwrap().sizes = sizes;
+        self.processed.update(|files, total| {
+            files[0] = processed;
+            *total = processed;
+        });
+    }
+
+    /// Clones the downloaded file of the leader of its transfer and takes
+    /// the response headers and sizes of the leader.
+    ///
+    /// # Errors
+    ///
+    /// Returns `TaskError::Failed(Reason::IoError)` if the file cannot be
+    /// cloned.
+    async fn adopt_download(&self, leader: &RequestTask) -> Result<(), TaskError> {
+        let (Some(file), Some(source)) = (self.files.get(0), leader.files.get(0)) else {
+            error!("task {} adopt download err, no file", self.task_id());
+            return Err(TaskError::Failed(Reason::OthersError));
+        };
+        let len = task_control::file_clone_from(file.clone(), source)
+            .await
+            .map_err(|e| {
+                error!(
+                    "task {} clone file of task {} failed {}",
+                    self.task_id(),
+                    leader.task_id(),
+                    e
+                );
+                TaskError::Failed(Reason::IoError)
+            })?;
+        task_control::file_sync_all(file).await?;
+
+        let mime_type = leader.mime_type.lock().unwrap().clone();
+        *self.mime_type.lock().unwrap() = mime_type;
+        let extras = leader.progress.lock().unwrap().extras.clone();
+        {
+            let mut progress = self.progress.lock().unwrap();
+            progress.extras = extras;
+            progress.sizes = vec![len as i64];
+        }
+        self.processed.update(|files, total| {
+            files[0] = len as usize;
+            *total = len as usize;
+        });
+        info!(
+            "task {} adopted the download of task {}",
+            self.task_id(),
+            leader.task_id()
+        );
+        Ok(())
+    }
+}
+
+#[cfg(test)]
+mod ut_coalesce {
+    include!("../../tests/ut/task/ut_coalesce.rs");
+}
@@ -14,6 +14,7 @@
 use std::collections::{HashMap, HashSet};
 use std::fs::File;
 use std::os::fd::{FromRawFd, IntoRawFd, RawFd};
+use std::sync::Arc;
 
 pub use ffi::{Action, Mode};
 use ipc::IpcStatusCode;
@@ -24,12 +25,14 @@ cfg_oh! {
     use ipc::parcel::Deserialize;
 }
 
+use super::checksum::Checksum;
 use super::reason::Reason;
 use super::ATOMIC_SERVICE;
 use crate::manage::account::GetOhosAccountUid;
 use crate::manage::network::{NetworkState, NetworkType};
 use crate::utils::c_wrapper::{CFileSpec, CFormItem, CStringWrapper};
 use crate::utils::form_item::{FileSpec, FormItem};
+use crate::utils::intern::{intern_str, intern_strings};
 use crate::utils::{hashmap_to_string, query_calling_bundle};
 
 // C++ bridge for exposing Rust types to C++
@@ -95,6 +98,22 @@ pub struct MinSpeed {
     pub(crate) duration: i64,
 }
 
+/// Stall detection of a download, which compares the recent throughput of the
+/// task with its own history.
+///
+/// A download whose throughput over the last `window` falls below `ratio`
+/// percent of its average is reconnected and resumed where it stopped.
+#[derive(Copy, Clone, Debug, Default)]
+pub struct StallDetection {
+    /// Length in milliseconds of the window the current throughput is
+    /// measured over, 0 for the default of the service.
+    pub(crate) window: i64,
+    /// Percent of the average throughput below which the window counts as a
+    /// stall, 0 for the default of the service and negative to disable the
+    /// detection.
+    pub(crate) ratio: i64,
+}
+
 /// Timeout configuration for network operations.
 #[derive(Copy, Clone, Debug, Default)]
 pub struct Timeout {
@@ -150,6 +169,34 @@ pub(crate) struct CommonTaskConfig {
     pub(crate) min_speed: MinSpeed,
     /// Timeout settings for the task.
     pub(crate) timeout: Timeout,
+    /// Stall detection settings of a download.
+    pub(crate) stall_detection: StallDetection,
+    /// Number of files of an upload sent at the same time, 0 or 1 to send
+    /// them one after another.
+    pub(crate) concurrency: u32,
+    /// Size in bytes of the chunks a resumable upload sends each file in, 0
+    /// to send every file in one request.
+    pub(crate) chunk_size: u64,
+    /// Time in milliseconds since the epoch the task should be done by, 0
+    /// for none. The scheduler runs a task nearing it first within its app.
+    pub(crate) deadline: u64,
+    /// Whether a download may share its transfer with the identical
+    /// downloads running at the same time.
+    pub(crate) coalesce: bool,
+    /// Whether a download advertises the encodings it can decode and stores
+    /// the body decoded.
+    pub(crate) compression: bool,
+    /// Cap in bytes of a download body kept in memory and delivered to the
+    /// client instead of a file, 0 to download to a file.
+    pub(crate) memory_limit: u32,
+    /// Whether a background task is held until the prefetch window of the
+    /// device opens.
+    pub(crate) prefetch: bool,
+    /// Whether a download keeps its written data out of the page cache.
+    pub(crate) bypass_cache: bool,
+    /// Trace the client made for the request, 0 if untraced. Not stored, a
+    /// restored task is untraced.
+    pub(crate) trace_id: u64,
 }
 
 /// Complete configuration for a network task.
@@ -157,10 +204,13 @@ pub(crate) struct CommonTaskConfig {
 /// Contains all necessary parameters to execute a download or upload operation,
 /// including network preferences, file specifications, authentication details,
 /// and execution constraints.
+///
+/// The bundle, proxy and certificate paths repeat across the tasks of an
+/// application, they are interned and shared by all the configs using them.
 #[derive(Clone, Debug)]
 pub struct TaskConfig {
     /// Bundle name of the requesting application.
-    pub(crate) bundle: String,
+    pub(crate) bundle: Arc<str>,
     /// Type identifier for the bundle.
     pub(crate) bundle_type: u32,
     /// Atomic account associated with the task.
@@ -180,9 +230,12 @@ pub struct TaskConfig {
     /// Authentication token.
     pub(crate) token: String,
     /// Proxy server configuration.
-    pub(crate) proxy: String,
+    pub(crate) proxy: Arc<str>,
     /// Certificate pins for secure connections.
     pub(crate) certificate_pins: String,
+    /// Expected digest of the downloaded file as `<algorithm>:<hex>`, empty if
+    /// the file is not verified.
+    pub(crate) checksum: String,
     /// Additional custom parameters.
     pub(crate) extras: HashMap<String, String>,
     /// API version compatibility indicator.
@@ -194,7 +247,7 @@ pub struct TaskConfig {
     /// Paths to body files for complex requests.
     pub(crate) body_file_paths: Vec<String>,
     /// Paths to custom certificates.
-    pub(crate) certs_path: Vec<String>,
+    pub(crate) certs_path: Arc<[String]>,
     /// Core configuration shared across task types.
     pub(crate) common_data: CommonTaskConfig,
 }
@@ -379,7 +432,7 @@ impl Default for TaskConfig {
         Self {
             bundle_type: 0,
             atomic_account: "ohosAnonymousUid".to_string(),
-            bundle: "xxx".to_string(),
+            bundle: intern_str("xxx"),
             url: "".to_string(),
             title: "xxx".to_string(),
             description: "xxx".to_string(),
@@ -387,14 +440,15 @@ impl Default for TaskConfig {
             headers: Default::default(),
             data: "".to_string(),
             token: "xxx".to_string(),
-            proxy: "".to_string(),
+            proxy: intern_str(""),
             extras: Default::default(),
             version: Version::API10,
             form_items: vec![],
             file_specs: vec![],
             body_file_paths: vec![],
-            certs_path: vec![],
+            certs_path: intern_strings(&[]),
             certificate_pins: "".to_string(),
+            checksum: "".to_string(),
             common_data: CommonTaskConfig {
                 task_id: 0,
                 uid: 0,
@@ -417,6 +471,16 @@ impl Default for TaskConfig {
                 multipart: false,
                 min_speed: MinSpeed::default(),
                 timeout: Timeout::default(),
+                stall_detection: StallDetection::default(),
+                concurrency: 0,
+                chunk_size: 0,
+                deadline: 0,
+                coalesce: false,
+                compression: false,
+                memory_limit: 0,
+                prefetch: false,
+                bypass_cache: false,
+                trace_id: 0,
             },
         }
     }
@@ -470,7 +534,7 @@ impl ConfigBuilder {
 
     /// Sets the name of the bundle requesting the task.
     pub fn bundle_name(&mut self, bundle_name: &str) -> &mut Self {
-        self.inner.bundle = bundle_name.to_string();
+        self.inner.bundle = intern_str(bundle_name);
         self
     }
 
@@ -562,6 +626,16 @@ impl Serialize for TaskConfig {
         parcel.write(&self.common_data.min_speed.duration)?;
         parcel.write(&self.common_data.timeout.connection_timeout)?;
         parcel.write(&self.common_data.timeout.total_timeout)?;
+        parcel.write(&self.common_data.stall_detection.window)?;
+        parcel.write(&self.common_data.stall_detection.ratio)?;
+        parcel.write(&self.common_data.concurrency)?;
+        parcel.write(&self.common_data.chunk_size)?;
+        parcel.write(&self.common_data.deadline)?;
+        parcel.write(&self.common_data.coalesce)?;
+        parcel.write(&self.common_data.compression)?;
+        parcel.write(&self.common_data.memory_limit)?;
+        parcel.write(&self.common_data.prefetch)?;
+        parcel.write(&self.common_data.bypass_cache)?;
 
         // Write string fields
         parcel.write(&self.url)?;
@@ -570,12 +644,13 @@ impl Serialize for TaskConfig {
         parcel.write(&self.token)?;
         parcel.write(&self.description)?;
         parcel.write(&self.data)?;
-        parcel.write(&self.proxy)?;
+        parcel.write(&self.proxy.to_string())?;
         parcel.write(&self.certificate_pins)?;
+        parcel.write(&self.checksum)?;
 
         // Write certificate paths
         parcel.write(&(self.certs_path.len() as u32))?;
-        for cert_path in &self.certs_path {
+        for cert_path in self.certs_path.iter() {
             parcel.write(cert_path)?;
         }
 
@@ -657,6 +732,17 @@ impl Deserialize for TaskConfig {
         let min_duration: i64 = parcel.read()?;
         let connection_timeout: u64 = parcel.read()?;
         let total_timeout: u64 = parcel.read()?;
+        let stall_window: i64 = parcel.read()?;
+        let stall_ratio: i64 = parcel.read()?;
+        let concurrency: u32 = parcel.read()?;
+        let chunk_size: u64 = parcel.read()?;
+        let deadline: u64 = parcel.read()?;
+        let coalesce: bool = parcel.read()?;
+        let compression: bool = parcel.read()?;
+        let memory_limit: u32 = parcel.read()?;
+        let prefetch: bool = parcel.read()?;
+        let bypass_cache: bool = parcel.read()?;
+        let trace_id: u64 = parcel.read()?;
 
         // Read string fields
         let url: String = parcel.read()?;
@@ -667,6 +753,16 @@ impl Deserialize for TaskConfig {
         let data_base: String = parcel.read()?;
         let proxy: String = parcel.read()?;
         let certificate_pins: String = parcel.read()?;
+        let checksum: String = parcel.read()?;
+        if !checksum.is_empty() && Checksum::parse(&checksum).is_none() {
+            error!("deserialize failed: invalid checksum");
+            sys_event!(
+                ExecFault,
+                DfxCode::INVALID_IPC_MESSAGE_A00,
+                "deserialize failed: invalid checksum"
+            );
+            return Err(IpcStatusCode::Failed);
+        }
 
         // Get caller information from IPC context
         let bundle = query_calling_bundle();
@@ -816,7 +912,7 @@ impl Deserialize for TaskConfig {
 
         // Construct the final TaskConfig
         let task_config = TaskConfig {
-            bundle,
+            bundle: intern_str(&bundle),
             bundle_type,
             atomic_account,
             url,
@@ -826,14 +922,15 @@ impl Deserialize for TaskConfig {
             headers,
             data: data_base,
             token,
-            proxy,
+            proxy: intern_str(&proxy),
             certificate_pins,
+            checksum,
             extras,
             version,
             form_items,
             file_specs,
             body_file_paths,
-            certs_path,
+            certs_path: intern_strings(&certs_path),
             common_data: CommonTaskConfig {
                 task_id: 0,
                 uid,
@@ -862,6 +959,19 @@ impl Deserialize for TaskConfig {
                     connection_timeout,
                     total_timeout,
                 },
+                stall_detection: StallDetection {
+                    window: stall_window,
+                    ratio: stall_ratio,
+                },
+                concurrency,
+                chunk_size,
+                deadline,
+                coalesce,
+                compression,
+                memory_limit,
+                prefetch,
+                bypass_cache,
+                trace_id,
             },
         };
         Ok(task_config)
@@ -0,0 +1,306 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! CPU time of the tasks.
+//!
+//! The CPU clock of the calling thread is read around each hot path of a
+//! task and the difference is charged to the task, whatever thread it ran
+//! on. A path measured within another one is only charged to the inner one.
+//! The CPU of a task is added to the extras of its `TaskInfo`, and the CPU of
+//! every uid is shown by the `-c` option of hidumper with the bytes its tasks
+//! transferred per CPU millisecond, which tells the clients whose usage is
+//! expensive, such as tiny writes or large extras notified often.
+
+use std::cell::Cell;
+use std::collections::HashMap;
+use std::ffi::{c_int, c_long};
+use std::fmt::Write;
+use std::future::Future;
+use std::pin::Pin;
+use std::sync::atomic::{AtomicU64, Ordering};
+use std::sync::{Arc, LazyLock, Mutex};
+use std::task::{Context, Poll};
+
+use crate::task::request_task::RequestTask;
+
+/// CPU clock of the calling thread.
+const CLOCK_THREAD_CPUTIME_ID: c_int = 3;
+
+/// Extras of a `TaskInfo` with the CPU of the task in microseconds on each
+/// path, then with the bytes it transferred per CPU millisecond.
+const CPU_EXTRAS: [&str; PATHS] = [
+    "cpu-http-us",
+    "cpu-write-us",
+    "cpu-notify-us",
+    "cpu-database-us",
+];
+const BYTES_PER_CPU_MS_EXTRA: &str = "bytes-per-cpu-ms";
+
+/// Number of paths.
+const PATHS: usize = 4;
+
+#[repr(C)]
+struct Timespec {
+    tv_sec: c_long,
+    tv_nsec: c_long,
+}
+
+extern "C" {
+    fn clock_gettime(clock_id: c_int, tp: *mut Timespec) -> c_int;
+}
+
+/// Hot paths the CPU of a task is charged to.
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub(crate) enum Path {
+    /// Polls of the transfer, the HTTP client and its TLS included
+    Http = 0,
+    /// `poll_write_file` and the file writes of its buffers
+    Write,
+    /// Encoding of the notifications sent to the clients
+    Notify,
+    /// Progress writes to the database
+    Database,
+}
+
+impl Path {
+    const ALL: [Path; PATHS] = [Path::Http, Path::Write, Path::Notify, Path::Database];
+
+    /// Returns the name of the path in the dump.
+    fn name(self) -> &'static str {
+        match self {
+            Path::Http => "http",
+            Path::Write => "write",
+            Path::Notify => "notify",
+            Path::Database => "database",
+        }
+    }
+}
+
+/// Returns the CPU time of the calling thread in nanoseconds.
+fn thread_cpu_ns() -> u64 {
+    let mut time = Timespec {
+        tv_sec: 0,
+        tv_nsec: 0,
+    };
+    // SAFETY: `time` is a valid timespec for the duration of the call.
+    if unsafe { clock_gettime(CLOCK_THREAD_CPUTIME_ID, &mut time) } != 0 {
+        return 0;
+    }
+    time.tv_sec as u64 * 1_000_000_000 + time.tv_nsec as u64
+}
+
+thread_local! {
+    /// CPU charged by the paths measured within the current one.
+    static NESTED_NS: Cell<u64> = const { Cell::new(0) };
+}
+
+/// Runs `f` and returns its result with the CPU it took in nanoseconds, the
+/// CPU of the paths measured within it excluded.
+fn own_cpu<T>(f: impl FnOnce() -> T) -> (T, u64) {
+    let outer = NESTED_NS.with(|nested| nested.replace(0));
+    let start = thread_cpu_ns();
+    let res = f();
+    let elapsed = thread_cpu_ns().saturating_sub(start);
+    let inner = NESTED_NS.with(|nested| nested.replace(outer + elapsed));
+    (res, elapsed.saturating_sub(inner))
+}
+
+/// CPU of a task on each path and the bytes it transferred.
+pub(crate) struct TaskCpu {
+    uid: u64,
+    ns: [AtomicU64; PATHS],
+    bytes: AtomicU64,
+}
+
+impl TaskCpu {
+    fn new(uid: u64) -> Self {
+        Self {
+            uid,
+            ns: std::array::from_fn(|_| AtomicU64::new(0)),
+            bytes: AtomicU64::new(0),
+        }
+    }
+
+    /// Runs `f` and charges its CPU to `path`.
+    pub(crate) fn measure<T>(&self, path: Path, f: impl FnOnce() -> T) -> T {
+        let (res, ns) = own_cpu(f);
+        self.ns[path as usize].fetch_add(ns, Ordering::Relaxed);
+        res
+    }
+
+    /// Adds `bytes` transferred by the task.
+    pub(crate) fn add_bytes(&self, bytes: u64) {
+        self.bytes.fetch_add(bytes, Ordering::Relaxed);
+    }
+
+    fn usage(&self) -> CpuUsage {
+        CpuUsage {
+            ns: std::array::from_fn(|i| self.ns[i].load(Ordering::Relaxed)),
+            bytes: self.bytes.load(Ordering::Relaxed),
+        }
+    }
+}
+
+/// CPU on each path and bytes transferred, of a task or of a uid.
+#[derive(Clone, Copy, Debug, Default, PartialEq, Eq)]
+pub(crate) struct CpuUsage {
+    pub(crate) ns: [u64; PATHS],
+    pub(crate) bytes: u64,
+}
+
+impl CpuUsage {
+    fn add(&mut self, other: &CpuUsage) {
+        for (ns, other) in self.ns.iter_mut().zip(other.ns.iter()) {
+            *ns += other;
+        }
+        self.bytes += other.bytes;
+    }
+
+    /// Returns the CPU on all paths in nanoseconds.
+    pub(crate) fn total_ns(&self) -> u64 {
+        self.ns.iter().sum()
+    }
+
+    /// Returns the bytes transferred per CPU millisecond, 0 without CPU.
+    pub(crate) fn bytes_per_cpu_ms(&self) -> u64 {
+        match self.total_ns() {
+            0 => 0,
+            ns => (self.bytes as u128 * 1_000_000 / ns as u128) as u64,
+        }
+    }
+}
+
+/// CPU of the tasks known to the service, and of the uids of the tasks it
+/// forgot.
+struct CpuTable {
+    tasks: HashMap<u32, Arc<TaskCpu>>,
+    forgotten: HashMap<u64, CpuUsage>,
+}
+
+static TABLE: LazyLock<Mutex<CpuTable>> = LazyLock::new(|| {
+    Mutex::new(CpuTable {
+        tasks: HashMap::new(),
+        forgotten: HashMap::new(),
+    })
+});
+
+/// Gets the CPU of `task`, its polls are charged without a lookup.
+pub(crate) fn of(task: &RequestTask) -> Arc<TaskCpu> {
+    let mut table = TABLE.lock().unwrap();
+    table
+        .tasks
+        .entry(task.task_id())
+        .or_insert_with(|| Arc::new(TaskCpu::new(task.uid())))
+        .clone()
+}
+
+/// Runs `f` and charges its CPU to `path` of the task `task_id`, if it is
+/// known.
+pub(crate) fn measure<T>(task_id: u32, path: Path, f: impl FnOnce() -> T) -> T {
+    let cpu = TABLE.lock().unwrap().tasks.get(&task_id).cloned();
+    match cpu {
+        Some(cpu) => cpu.measure(path, f),
+        None => f(),
+    }
+}
+
+/// Forgets the task `task_id`, its CPU stays counted for its uid.
+pub(crate) fn forget(task_id: u32) {
+    let mut table = TABLE.lock().unwrap();
+    if let Some(cpu) = table.tasks.remove(&task_id) {
+        let usage = cpu.usage();
+        table.forgotten.entry(cpu.uid).or_default().add(&usage);
+    }
+}
+
+/// Returns the CPU of the task `task_id`, if it is known.
+pub(crate) fn task_usage(task_id: u32) -> Option<CpuUsage> {
+    TABLE
+        .lock()
+        .unwrap()
+        .tasks
+        .get(&task_id)
+        .map(|cpu| cpu.usage())
+}
+
+/// Adds the CPU of the task `task_id` to the extras of its `TaskInfo`.
+pub(crate) fn add_extras(task_id: u32, extras: &mut HashMap<String, String>) {
+    let Some(usage) = task_usage(task_id) else {
+        return;
+    };
+    for (name, ns) in CPU_EXTRAS.iter().zip(usage.ns.iter()) {
+        extras.insert(name.to_string(), (ns / 1000).to_string());
+    }
+    extras.insert(
+        BYTES_PER_CPU_MS_EXTRA.to_string(),
+        usage.bytes_per_cpu_ms().to_string(),
+    );
+}
+
+/// Returns the CPU of every uid, most expensive first.
+pub(crate) fn uid_usages() -> Vec<(u64, CpuUsage)> {
+    let table = TABLE.lock().unwrap();
+    let mut uids = table.forgotten.clone();
+    for cpu in table.tasks.values() {
+        uids.entry(cpu.uid).or_default().add(&cpu.usage());
+    }
+    let mut uids = uids.into_iter().collect::<Vec<_>>();
+    uids.sort_by_key(|(_, usage)| u64::MAX - usage.total_ns());
+    uids
+}
+
+/// Formats the CPU of every uid for the `-c` option of hidumper.
+pub(crate) fn dump() -> String {
+    let mut out = String::new();
+    let _ = write!(out, "{:<12}{:>12}", "uid", "cpu_us");
+    for path in Path::ALL {
+        let _ = write!(out, "{:>12}", format!("{}_us", path.name()));
+    }
+    let _ = writeln!(out, "{:>16}{:>18}", "bytes", "bytes_per_cpu_ms");
+    for (uid, usage) in uid_usages() {
+        let _ = write!(out, "{:<12}{:>12}", uid, usage.total_ns() / 1000);
+        for ns in usage.ns {
+            let _ = write!(out, "{:>12}", ns / 1000);
+        }
+        let _ = writeln!(out, "{:>16}{:>18}", usage.bytes, usage.bytes_per_cpu_ms());
+    }
+    out
+}
+
+/// Future whose polls are charged to `Path::Http` of a task.
+pub(crate) struct Charged<F> {
+    cpu: Arc<TaskCpu>,
+    fut: Pin<Box<F>>,
+}
+
+/// Charges the polls of `fut` to `Path::Http` of `task`.
+pub(crate) fn charged<F: Future>(task: &RequestTask, fut: F) -> Charged<F> {
+    Charged {
+        cpu: of(task),
+        fut: Box::pin(fut),
+    }
+}
+
+impl<F: Future> Future for Charged<F> {
+    type Output = F::Output;
+
+    fn poll(mut self: Pin<&mut Self>, cx: &mut Context<'_>) -> Poll<Self::Output> {
+        let this = &mut *self;
+        this.cpu.measure(Path::Http, || this.fut.as_mut().poll(cx))
+    }
+}
+
+#[cfg(test)]
+mod ut_cpu {
+    include!("../../tests/ut/task/ut_cpu.rs");
+}
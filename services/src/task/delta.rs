@@ -0,0 +1,334 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Delta downloads of files downloaded again.
+//!
+//! A download opts in with the `delta` extra of its config, the url of the
+//! block manifest of the file, see `request_utils::delta`. The application
+//! does not truncate the file of such a task, the old content is moved to a
+//! base file of the service when the task starts. Once the server answered
+//! with the full body and accepts byte ranges, the manifest is fetched and
+//! the base scanned for the blocks of the new version: the blocks found are
+//! copied from the base at their offsets, and only the other ranges are
+//! fetched, as segments over a few connections. The file is hashed against
+//! the SHA-256 of the manifest when it has one, a mismatch downloads the
+//! whole body again.
+//!
+//! Anything that does not fit, a missing manifest, a body of another length,
+//! nothing to reuse, downloads the whole body over the first connection. The
+//! base is kept until the task completes or fails, so a paused download
+//! resumes with a plain range request.
+
+use std::fs::{self, File, OpenOptions};
+use std::io;
+use std::os::unix::fs::FileExt;
+use std::sync::atomic::{AtomicBool, Ordering};
+use std::sync::{Arc, Mutex};
+
+use request_utils::delta::{Assembly, Manifest};
+use request_utils::redirect;
+use ylong_http_client::async_impl::{Body, RequestBuilder, Response};
+
+use super::checksum::{self, Algorithm, Digest};
+use super::reason::Reason;
+use super::request_task::{RequestTask, TaskError, TaskPhase};
+use super::segment::{self, Segment};
+use crate::task::config::Action;
+use crate::task::task_control;
+use crate::utils::metrics;
+
+/// Key of the config extra holding the url of the manifest of the file.
+pub(crate) const DELTA_EXTRA: &str = "delta";
+
+/// Directory of the base files, named after their tasks.
+const DELTA_DIR: &str = "/data/service/el1/public/request/delta";
+
+/// Largest manifest accepted in bytes.
+const MAX_MANIFEST_SIZE: usize = 8 * 1024 * 1024;
+
+/// Connections fetching the missing ranges of a file.
+const DELTA_CONNECTIONS: usize = 4;
+
+/// Bytes copied from the base at once.
+const COPY_SIZE: usize = 256 * 1024;
+
+/// How the new version of a file is made from its base.
+pub(crate) struct Plan {
+    base: File,
+    length: u64,
+    sha256: Option<Vec<u8>>,
+    assembly: Assembly,
+}
+
+/// Whether a task asked for a delta download it can make: the download of
+/// a whole body into a file of the application.
+fn wanted(task: &RequestTask) -> bool {
+    let config = &task.conf;
+    config.common_data.action == Action::Download
+        && config.common_data.memory_limit == 0
+        && config.common_data.begins == 0
+        && config.common_data.ends < 0
+        && config.file_specs.len() == 1
+        && !config.file_specs[0].is_user_file
+        && config
+            .extras
+            .get(DELTA_EXTRA)
+            .is_some_and(|url| !url.is_empty())
+}
+
+fn base_path(task: &RequestTask) -> String {
+    format!("{}/{}", DELTA_DIR, task.task_id())
+}
+
+/// Moves the old content of the file of a task to its base, before the task
+/// downloads the new one.
+///
+/// A base kept from an earlier run is not replaced, the file then holds the
+/// start of the new version. The file is emptied even if the base cannot be
+/// made, the task then downloads the whole body.
+pub(crate) async fn take_base(task: &Arc<RequestTask>) {
+    if !wanted(task) {
+        return;
+    }
+    let path = base_path(task);
+    let Some(file) = task.files.get(0) else {
+        return;
+    };
+    let len = match task_control::file_metadata(file.clone()).await {
+        Ok(metadata) => metadata.len(),
+        Err(e) => {
+            error!("{} delta file metadata failed {}", task.task_id(), e);
+            return;
+        }
+    };
+    if len == 0 || fs::metadata(&path).is_ok() {
+        return;
+    }
+    let base = fs::create_dir_all(DELTA_DIR).and_then(|()| {
+        OpenOptions::new()
+            .read(true)
+            .write(true)
+            .create(true)
+            .truncate(true)
+            .open(&path)
+    });
+    let taken = match base {
+        Ok(base) => task_control::file_clone_from(Arc::new(Mutex::new(base)), file.clone()).await,
+        Err(e) => Err(e),
+    };
+    match taken {
+        Ok(len) => info!("{} delta base of {} bytes", task.task_id(), len),
+        Err(e) => {
+            error!("{} delta base failed {}", task.task_id(), e);
+            remove_base(task);
+        }
+    }
+    if let Err(e) = task_control::file_set_len(file.clone(), 0).await {
+        error!("{} delta clear file failed {}", task.task_id(), e);
+    }
+}
+
+/// Removes the base of a task that completed or failed.
+pub(crate) fn remove_base(task: &RequestTask) {
+    if !wanted(task) {
+        return;
+    }
+    if let Err(e) = fs::remove_file(base_path(task)) {
+        if e.kind() != io::ErrorKind::NotFound {
+            error!("{} delta remove base failed {}", task.task_id(), e);
+        }
+    }
+}
+
+/// Returns how the body of a response is made from the base of the task.
+///
+/// # Returns
+///
+/// `None` if the task did not opt in or has no base, the body cannot be
+/// fetched in ranges, the manifest cannot be fetched or does not describe
+/// the body, or no block of the base can be reused.
+pub(crate) async fn plan(task: &Arc<RequestTask>, response: &Response) -> Option<Plan> {
+    if !wanted(task) || task.processed.file(0) != 0 || !segment::accepts_ranges(task, response) {
+        return None;
+    }
+    let base = File::open(base_path(task)).ok()?;
+    let length = u64::try_from(task.file_total_size.load(Ordering::SeqCst)).ok()?;
+    let manifest = fetch_manifest(task).await?;
+    if manifest.length != length {
+        info!(
+            "{} delta manifest of {} bytes, body of {}",
+            task.task_id(),
+            manifest.length,
+            length
+        );
+        return None;
+    }
+    let scanned = base.try_clone().ok()?;
+    let scanned = task_control::runtime_spawn_blocking(move || {
+        let found = manifest.scan(scanned)?;
+        Ok((manifest, found))
+    })
+    .await
+    .ok()?;
+    let (manifest, found) = match scanned {
+        Ok(scanned) => scanned,
+        Err(e) => {
+            error!("{} delta scan failed {}", task.task_id(), e);
+            return None;
+        }
+    };
+    let assembly = manifest.assemble(&found);
+    if assembly.matched() == 0 {
+        info!("{} delta base has no block of the body", task.task_id());
+        return None;
+    }
+    Some(Plan {
+        base,
+        length,
+        sha256: manifest.sha256,
+        assembly,
+    })
+}
+
+/// Fetches the manifest of the file of a task.
+async fn fetch_manifest(task: &RequestTask) -> Option<Manifest> {
+    let url = redirect::resolve(&task.conf.url, task.conf.extras.get(DELTA_EXTRA)?)?;
+    let request = RequestBuilder::new()
+        .method("GET")
+        .url(url.as_str())
+        .body(Body::empty())
+        .ok()?;
+    let mut response = match task.client.request(request).await {
+        Ok(response) => response,
+        Err(e) => {
+            error!("{} delta manifest request failed {:?}", task.task_id(), e);
+            return None;
+        }
+    };
+    let status = response.status().as_u16();
+    if status != 200 {
+        info!("{} delta manifest response {}", task.task_id(), status);
+        return None;
+    }
+    let mut body = Vec::new();
+    let mut buf = [0u8; 8192];
+    loop {
+        let size = response.data(&mut buf).await.ok()?;
+        if size == 0 {
+            break;
+        }
+        body.extend_from_slice(&buf[..size]);
+        if body.len() > MAX_MANIFEST_SIZE {
+            error!("{} delta manifest too large", task.task_id());
+            return None;
+        }
+    }
+    let manifest = std::str::from_utf8(&body).ok().and_then(Manifest::parse);
+    if manifest.is_none() {
+        error!("{} delta manifest malformed", task.task_id());
+    }
+    manifest
+}
+
+/// Makes the file of a task from its base and the missing ranges of the
+/// body.
+///
+/// # Errors
+///
+/// Returns `TaskError::Failed(Reason::IoError)` if the blocks cannot be
+/// copied, the errors of `download_segments` if the ranges cannot be
+/// fetched, and `TaskError::Waiting(TaskPhase::NeedRetry)` if the file does
+/// not match the SHA-256 of the manifest, the base is then dropped and the
+/// whole body downloaded again.
+pub(crate) async fn download(
+    task: Arc<RequestTask>,
+    plan: Plan,
+    abort_flag: Arc<AtomicBool>,
+) -> Result<(), TaskError> {
+    let Some(file) = task.files.get(0) else {
+        error!("delta download err, no file in the `task`");
+        return Err(TaskError::Failed(Reason::OthersError));
+    };
+    let Plan {
+        base,
+        length,
+        sha256,
+        assembly,
+    } = plan;
+    let matched = assembly.matched();
+    info!(
+        "{} delta reuses {} of {} bytes, fetches {} ranges",
+        task.task_id(),
+        matched,
+        length,
+        assembly.missing.len()
+    );
+
+    task_control::file_set_len(file.clone(), length).await?;
+    let writer = file.clone();
+    let copies = assembly.copies;
+    let copied = task_control::runtime_spawn_blocking(move || {
+        let writer = task_control::file_positional(&writer.lock().unwrap())?;
+        let mut buf = vec![0u8; COPY_SIZE];
+        for (from, to, len) in copies {
+            let mut done = 0;
+            while done < len {
+                let size = COPY_SIZE.min((len - done) as usize);
+                base.read_exact_at(&mut buf[..size], from + done)?;
+                writer.write_all_at(&buf[..size], to + done)?;
+                done += size as u64;
+            }
+        }
+        Ok(())
+    })
+    .await
+    .map_err(|e| io::Error::new(io::ErrorKind::Other, e))
+    .and_then(|res| res);
+    if let Err(e) = copied {
+        error!("{} delta copy failed {}", task.task_id(), e);
+        task_control::file_set_len(file.clone(), 0).await?;
+        return Err(TaskError::Failed(Reason::IoError));
+    }
+    task.processed.update(|files, total| {
+        files.fill(0);
+        files[0] = matched as usize;
+        *total = matched as usize;
+    });
+    metrics::DELTA_BYTES_REUSED.add(matched);
+
+    let segments = assembly
+        .missing
+        .into_iter()
+        .map(|(start, end)| Segment::new(start, end))
+        .collect::<Vec<_>>();
+    if !segments.is_empty() {
+        segment::download_segments(task.clone(), segments, DELTA_CONNECTIONS, abort_flag).await?;
+    }
+
+    let Some(expected) = sha256 else {
+        return Ok(());
+    };
+    let digest = checksum::hash_file(file.clone(), length, Digest::new(Algorithm::Sha256))
+        .await
+        .map_err(|e| {
+            error!("{} delta hash file failed {}", task.task_id(), e);
+            TaskError::Failed(Reason::IoError)
+        })?;
+    if digest.finish() != expected {
+        error!("{} delta file mismatch, download again", task.task_id());
+        remove_base(&task);
+        task_control::clear_downloaded_file(task.clone()).await?;
+        return Err(TaskError::Waiting(TaskPhase::NeedRetry));
+    }
+    Ok(())
+}
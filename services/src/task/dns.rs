@@ -0,0 +1,250 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! DNS cache shared by the clients of the service.
+//!
+//! Every connection of a task resolved its host again. The clients now
+//! resolve through this cache, and the scheduler prefetches the hosts of the
+//! tasks next in line, so that their first connection does not wait for the
+//! resolution. The system resolver does not return the TTL of the records,
+//! entries expire after `DNS_TTL`, shorter than the TTL of most records. The
+//! cache is cleared when the network changes, the addresses of a host may
+//! differ on the new network.
+//!
+//! The service unloads when it is idle and loses the cache. When it starts
+//! again, the hosts of the latest tasks are resolved ahead of the tasks.
+//!
+//! The addresses of a dual-stack host are ordered by the family it answered
+//! over first, racing both families the first time, so that a broken IPv6
+//! path does not hold the connections of the tasks.
+
+use std::collections::HashMap;
+use std::io;
+use std::net::{SocketAddr, ToSocketAddrs};
+use std::sync::atomic::{AtomicU64, Ordering};
+use std::sync::{LazyLock, Mutex};
+
+use request_utils::eyeballs::Families;
+use ylong_http_client::async_impl::{Addrs, Resolver, SocketFuture};
+
+use crate::database::REQUEST_DB;
+use crate::task::client_pool::host_of;
+use crate::task::task_control::runtime_spawn_blocking;
+use crate::utils::{get_current_timestamp, metrics, runtime_spawn};
+
+/// Time in milliseconds a resolution is used for.
+const DNS_TTL: u64 = 60 * 1000;
+
+/// Most hosts cached, expired entries are dropped first when it is reached.
+const DNS_CACHE_CAPACITY: usize = 256;
+
+/// Latest tasks whose hosts are resolved when the service starts.
+const WARM_TASKS: u64 = 64;
+
+/// Most hosts resolved when the service starts.
+const WARM_HOSTS: usize = 8;
+
+/// Addresses of a host and the time they expire at in milliseconds.
+struct Entry {
+    addrs: Vec<SocketAddr>,
+    expires: u64,
+}
+
+/// Resolutions of the hosts the tasks connect to, keyed by authority.
+pub(crate) struct DnsCache {
+    entries: Mutex<HashMap<String, Entry>>,
+    /// Families the dual-stack hosts answered over first.
+    families: Families,
+    /// Network changes seen, a resolution started before one is not cached.
+    generation: AtomicU64,
+}
+
+impl DnsCache {
+    /// Returns the DNS cache of the service.
+    pub(crate) fn get_instance() -> &'static Self {
+        static DNS_CACHE: LazyLock<DnsCache> = LazyLock::new(DnsCache::new);
+        &DNS_CACHE
+    }
+
+    fn new() -> Self {
+        Self {
+            entries: Mutex::new(HashMap::new()),
+            families: Families::new(),
+            generation: AtomicU64::new(0),
+        }
+    }
+
+    /// Returns the addresses of `authority` cached and not expired at `now`.
+    fn lookup(&self, authority: &str, now: u64) -> Option<Vec<SocketAddr>> {
+        let entries = self.entries.lock().unwrap();
+        entries
+            .get(authority)
+            .filter(|entry| entry.expires > now)
+            .map(|entry| entry.addrs.clone())
+    }
+
+    /// Caches the addresses of `authority` resolved at `now`, unless the
+    /// network changed since `generation`.
+    fn insert(&self, authority: &str, addrs: Vec<SocketAddr>, now: u64, generation: u64) {
+        let mut entries = self.entries.lock().unwrap();
+        if self.generation.load(Ordering::Acquire) != generation {
+            return;
+        }
+        if entries.len() >= DNS_CACHE_CAPACITY && !entries.contains_key(authority) {
+            entries.retain(|_, entry| entry.expires > now);
+            if entries.len() >= DNS_CACHE_CAPACITY {
+                return;
+            }
+        }
+        let expires = now + DNS_TTL;
+        entries.insert(authority.to_string(), Entry { addrs, expires });
+    }
+
+    /// Forgets all resolutions, called when the network changes.
+    pub(crate) fn clear(&self) {
+        let mut entries = self.entries.lock().unwrap();
+        self.generation.fetch_add(1, Ordering::AcqRel);
+        entries.clear();
+        self.families.clear();
+    }
+
+    /// Resolves `authority`, a host and a port, from the cache if possible.
+    pub(crate) async fn resolve(&'static self, authority: String) -> io::Result<Vec<SocketAddr>> {
+        if let Some(addrs) = self.lookup(&authority, get_current_timestamp()) {
+            metrics::DNS_CACHE_HITS.add(1);
+            return Ok(addrs);
+        }
+        metrics::DNS_CACHE_MISSES.add(1);
+        let generation = self.generation.load(Ordering::Acquire);
+        let host = authority.clone();
+        let addrs = runtime_spawn_blocking(move || {
+            let addrs = host.to_socket_addrs()?.collect::<Vec<_>>();
+            Ok::<_, io::Error>(self.families.order(&host, addrs, get_current_timestamp()))
+        })
+        .await
+        .map_err(|e| io::Error::new(io::ErrorKind::Other, e))??;
+        if !addrs.is_empty() {
+            self.insert(
+                &authority,
+                addrs.clone(),
+                get_current_timestamp(),
+                generation,
+            );
+        }
+        Ok(addrs)
+    }
+
+    /// Resolves the host of `url` in the background if it is not cached, for
+    /// a task about to connect to it.
+    pub(crate) fn prefetch(&'static self, url: &str) {
+        let Some(authority) = authority_of(url) else {
+            return;
+        };
+        if self.lookup(&authority, get_current_timestamp()).is_some() {
+            return;
+        }
+        debug!("dns prefetch {}", authority);
+        runtime_spawn(async move {
+            let _ = self.resolve(authority).await;
+        });
+    }
+}
+
+/// Returns the host and port of `url`, the port being the default one of
+/// its scheme if it has none.
+pub(crate) fn authority_of(url: &str) -> Option<String> {
+    let host = host_of(url);
+    if host.is_empty() {
+        return None;
+    }
+    let has_port = host.rsplit_once(':').is_some_and(|(name, port)| {
+        (!name.contains(':') || name.ends_with(']')) && port.parse::<u16>().is_ok()
+    });
+    if has_port {
+        return Some(host);
+    }
+    let port = match url.split_once("://") {
+        Some((scheme, _)) if scheme.eq_ignore_ascii_case("http") => 80,
+        Some((scheme, _)) if scheme.eq_ignore_ascii_case("https") => 443,
+        _ => return None,
+    };
+    Some(format!("{}:{}", host, port))
+}
+
+/// Resolves the hosts the latest tasks connected to, so that the tasks
+/// created after the service started again do not wait for them.
+pub(crate) fn warm_recent_hosts() {
+    let urls = match REQUEST_DB.query::<String>(
+        "SELECT url FROM request_task ORDER BY mtime DESC LIMIT ?",
+        WARM_TASKS,
+    ) {
+        Ok(rows) => rows.collect::<Vec<_>>(),
+        Err(e) => {
+            error!("query recent urls failed: {}", e);
+            return;
+        }
+    };
+    for url in distinct_hosts(&urls, WARM_HOSTS) {
+        DnsCache::get_instance().prefetch(url);
+    }
+}
+
+/// Returns the first urls of `urls` with distinct authorities, at most `n`.
+fn distinct_hosts(urls: &[String], n: usize) -> Vec<&str> {
+    let mut authorities = Vec::new();
+    let mut distinct = Vec::new();
+    for url in urls {
+        if distinct.len() == n {
+            break;
+        }
+        match authority_of(url) {
+            Some(authority) if !authorities.contains(&authority) => {
+                authorities.push(authority);
+                distinct.push(url.as_str());
+            }
+            _ => {}
+        }
+    }
+    distinct
+}
+
+/// Addresses returned to a client.
+struct CachedAddrs(std::vec::IntoIter<SocketAddr>);
+
+impl Iterator for CachedAddrs {
+    type Item = SocketAddr;
+
+    fn next(&mut self) -> Option<Self::Item> {
+        self.0.next()
+    }
+}
+
+impl Addrs for CachedAddrs {}
+
+/// Resolver of the clients of the tasks, backed by the DNS cache.
+pub(crate) struct CachedResolver;
+
+impl Resolver for CachedResolver {
+    fn resolve(&self, authority: &str) -> SocketFuture {
+        let authority = authority.to_ascii_lowercase();
+        Box::pin(async move {
+            let addrs = DnsCache::get_instance().resolve(authority).await?;
+            Ok(Box::new(CachedAddrs(addrs.into_iter())) as Box<dyn Addrs>)
+        })
+    }
+}
+
+#[cfg(test)]
+mod ut_dns {
+    include!("../../tests/ut/task/ut_dns.rs");
+}
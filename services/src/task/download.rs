@@ -28,28 +28,46 @@ use std::sync::Arc;
 use std::task::{Context, Poll};
 use std::time::Instant;
 
+use request_utils::compress::{ContentDecoder, ContentEncoding};
 use ylong_http_client::async_impl::{DownloadOperator, Downloader, Response};
 use ylong_http_client::{ErrorKind, HttpClientError, SpeedLimit, Timeout};
 
+use super::checksum::{self, Digest, CHECKSUM_EXTRA};
+use super::coalesce::{self, Role};
+use super::delta;
+use super::extract;
+use super::handoff;
+use super::memory::BODY_TOO_LARGE_MESSAGE;
+#[cfg(feature = "oh")]
+use super::netstack;
 use super::operator::TaskOperator;
 use super::reason::Reason;
 use super::request_task::{TaskError, TaskPhase};
+use super::segment;
+use super::stall::{StallDetector, MAX_STALL_RECONNECTS, STALL_MESSAGE};
+use super::transport::Transport;
 use crate::manage::database::RequestDb;
+use crate::task::client_pool::ClientPool;
 use crate::task::info::State;
 use crate::task::request_task::RequestTask;
 use crate::task::task_control;
+use crate::task::timeline::{Phase, Timelines};
 #[cfg(feature = "oh")]
 use crate::trace::Trace;
-use crate::utils::get_current_duration;
+use crate::utils::{get_current_duration, get_current_timestamp};
 
 /// Maximum download timeout duration (one week in seconds).
-const SECONDS_IN_ONE_WEEK: u64 = 7 * 24 * 60 * 60;
+pub(crate) const SECONDS_IN_ONE_WEEK: u64 = 7 * 24 * 60 * 60;
+
+/// Minimum time (in seconds) to consider a connection as low speed. This fails
+/// the connections the stall detection of the task does not reconnect.
+pub(crate) const LOW_SPEED_TIME: u64 = 60;
 
-/// Minimum time (in seconds) to consider a connection as low speed.
-const LOW_SPEED_TIME: u64 = 60;
+/// Error number of a full disk.
+const ENOSPC: i32 = 28;
 
 /// Minimum download speed (in bytes per second) before considering connection stalled.
-const LOW_SPEED_LIMIT: u64 = 1;
+pub(crate) const LOW_SPEED_LIMIT: u64 = 1;
 
 /// Implementation of the `DownloadOperator` trait for `TaskOperator`.
 ///
@@ -57,7 +75,7 @@ const LOW_SPEED_LIMIT: u64 = 1;
 /// by providing file writing and progress reporting functionality.
 impl DownloadOperator for TaskOperator {
     fn poll_download(
-        self: Pin<&mut Self>,
+        mut self: Pin<&mut Self>,
         cx: &mut Context<'_>,
         data: &[u8],
     ) -> Poll<Result<usize, HttpClientError>> {
@@ -67,9 +85,16 @@ impl DownloadOperator for TaskOperator {
     fn poll_progress(
         mut self: Pin<&mut Self>,
         cx: &mut Context<'_>,
-        _downloaded: u64,
-        _total: Option<u64>,
+        downloaded: u64,
+        total: Option<u64>,
     ) -> Poll<Result<(), HttpClientError>> {
+        // The last bytes are written here so a failed write fails the download
+        if total.is_some_and(|total| downloaded >= total) {
+            match self.poll_flush(cx) {
+                Poll::Ready(Ok(())) => {}
+                other => return other,
+            }
+        }
         self.poll_progress_common(cx)
     }
 }
@@ -84,6 +109,8 @@ impl DownloadOperator for TaskOperator {
 /// * `task` - The download task containing configuration and state information.
 /// * `response` - The HTTP response to download from.
 /// * `abort_flag` - An atomic flag used to signal download cancellation.
+/// * `decoder` - The decoder of an encoded body and the flag it sets once the
+///   encoded data is complete.
 ///
 /// # Returns
 ///
@@ -103,7 +130,7 @@ impl DownloadOperator for TaskOperator {
 /// let abort_flag = Arc::new(AtomicBool::new(false));
 ///
 /// // Build the downloader
-/// let downloader = build_downloader(task, response, abort_flag);
+/// let downloader = build_downloader(task, response, abort_flag, None);
 ///
 /// // Start the download
 /// // tokio::spawn(async move { downloader.download().await });
@@ -112,9 +139,16 @@ pub(crate) fn build_downloader(
     task: Arc<RequestTask>,
     response: Response,
     abort_flag: Arc<AtomicBool>,
+    decoder: Option<(ContentDecoder, Arc<AtomicBool>)>,
 ) -> Downloader<TaskOperator> {
     // Create a task operator to handle file writing and progress updates
-    let task_operator = TaskOperator::new(task, abort_flag);
+    let mut task_operator = TaskOperator::new(task.clone(), abort_flag);
+    if let Some(detector) = task.stall_detector() {
+        task_operator = task_operator.detect_stall(detector);
+    }
+    if let Some((decoder, complete)) = decoder {
+        task_operator = task_operator.decode(decoder, complete);
+    }
 
     // Configure the downloader with appropriate settings
     Downloader::builder()
@@ -152,54 +186,266 @@ pub(crate) fn build_downloader(
 pub(crate) async fn download(task: Arc<RequestTask>, abort_flag: Arc<AtomicBool>) {
     // Initialize retry counter
     task.tries.store(0, Ordering::SeqCst);
-    
+    task.stall_reconnects.store(0, Ordering::SeqCst);
+
+    // A body the application preloaded is not downloaded again, unless it
+    // does not match the checksum of the task or has to be extracted
+    let handed_over = handoff::take(task.task_id()).filter(|_| !extract::wanted(&task));
+    if let Some(body) = handed_over {
+        let result = match task.adopt_handed_over(body).await {
+            Ok(len) => task.verify_checksum(len).await,
+            Err(e) => Err(e),
+        };
+        #[cfg(not(test))]
+        let result = result.and_then(|()| check_file_exist(&task));
+        match result {
+            Ok(()) => {
+                task.record_result(Ok(()));
+                return;
+            }
+            Err(e) => {
+                info!("task {} handed over body refused, {:?}", task.task_id(), e);
+                let _ = task_control::clear_downloaded_file(task.clone()).await;
+            }
+        }
+    }
+
+    // Identical downloads share the transfer of the first one to start
+    let mut leading = None;
+    while let Some(role) = coalesce::join(&task) {
+        match role {
+            Role::Leader(lead) => {
+                leading = Some(lead);
+                break;
+            }
+            Role::Follower(transfer) => {
+                let Some(result) = coalesce::follow(&task, &transfer, &abort_flag).await else {
+                    // The leader stopped, the transfer is joined again
+                    continue;
+                };
+                #[cfg(not(test))]
+                let result = result.and_then(|()| check_file_exist(&task));
+                let result = match result {
+                    Ok(()) => task.deliver_body().await,
+                    Err(e) => Err(e),
+                };
+                task.record_result(result);
+                return;
+            }
+        }
+    }
+    // The old content of a delta download is the base of the new one
+    delta::take_base(&task).await;
+
     // Main download loop with retry logic
-    loop {
+    let transport = Transport::of(&task);
+    let result = loop {
         let begin_time = Instant::now();
         
-        // Execute the actual download logic
-        if let Err(e) = download_inner(task.clone(), abort_flag.clone()).await {
-            match e {
-                TaskError::Waiting(phase) => match phase {
-                    // Handle retry case: update timeout and continue the loop
-                    TaskPhase::NeedRetry => {
-                        // Update the remaining time based on elapsed download time
-                        let download_time = begin_time.elapsed().as_secs();
-                        task.rest_time.fetch_sub(download_time, Ordering::SeqCst);
-                        
-                        // Adjust client timeout to match remaining task time
-                        let mut client = task.client.lock().await;
-                        client.total_timeout(Timeout::from_secs(
-                            task.rest_time.load(Ordering::SeqCst),
-                        ));
-                        
-                        // Continue to next iteration for retry
-                        continue;
-                    }
-                    // Handle user abort: break the loop without setting an error
-                    TaskPhase::UserAbort => {},
-                    // Handle network offline: record the error
-                    TaskPhase::NetworkOffline => {
-                        *task.running_result.lock().unwrap() = Some(Err(Reason::NetworkOffline));
-                    }
-                },
-                // Handle failure errors: record the specific failure reason
-                TaskError::Failed(reason) => {
-                    *task.running_result.lock().unwrap() = Some(Err(reason));
-                }
-            }
-        } else {
-            // Download completed successfully
-            *task.running_result.lock().unwrap() = Some(Ok(()));
+        // Execute the actual download logic over the client of the task
+        let result = task
+            .within_rest_time(transfer(task.clone(), abort_flag.clone(), transport))
+            .await;
+        // Handle retry case: update timeout and continue the loop
+        if let Err(TaskError::Waiting(TaskPhase::NeedRetry)) = result {
+            // Update the remaining time based on elapsed download time
+            let download_time = begin_time.elapsed().as_secs();
+            let rest_time = task.rest_time.load(Ordering::SeqCst);
+            task.rest_time
+                .store(rest_time.saturating_sub(download_time), Ordering::SeqCst);
+            continue;
         }
-        
         // Exit the loop after handling success or non-retryable errors
-        break;
+        break result;
+    };
+    if let Some(leading) = leading {
+        leading.finish(result.is_ok());
+    }
+    if !matches!(result, Err(TaskError::Waiting(_))) {
+        delta::remove_base(&task);
+    }
+    // The body of an in-memory download reaches the client before the
+    // completed notification
+    let result = match result {
+        Ok(()) => task.deliver_body().await,
+        Err(e) => Err(e),
+    };
+    task.record_result(result);
+}
+
+/// Runs one attempt of a download over a client.
+async fn transfer(
+    task: Arc<RequestTask>,
+    abort_flag: Arc<AtomicBool>,
+    transport: Transport,
+) -> Result<(), TaskError> {
+    match transport {
+        #[cfg(feature = "oh")]
+        Transport::Netstack => netstack::download(task, abort_flag).await,
+        _ => download_inner(task, abort_flag).await,
     }
 }
 
 impl RequestTask {
-    async fn prepare_download(&self) -> Result<(), TaskError> {
+    /// Records the result of a run of the download.
+    fn record_result(&self, result: Result<(), TaskError>) {
+        let running_result = match result {
+            // Download completed successfully
+            Ok(()) => Ok(()),
+            // Handle user abort: no result is recorded
+            Err(TaskError::Waiting(TaskPhase::UserAbort | TaskPhase::NeedRetry)) => return,
+            // Handle network offline: record the error
+            Err(TaskError::Waiting(TaskPhase::NetworkOffline)) => Err(Reason::NetworkOffline),
+            // Handle failure errors: record the specific failure reason
+            Err(TaskError::Failed(reason)) => Err(reason),
+        };
+        *self.running_result.lock().unwrap() = Some(running_result);
+    }
+
+    /// Returns the stall detector of a download connection.
+    ///
+    /// A stalled connection is only dropped if the download can continue
+    /// where it stopped, which needs a validator for `If-Range`, and only
+    /// `MAX_STALL_RECONNECTS` times per run.
+    fn stall_detector(&self) -> Option<StallDetector> {
+        if self.stall_reconnects.load(Ordering::SeqCst) >= MAX_STALL_RECONNECTS {
+            return None;
+        }
+        let resumable = {
+            let progress = self.progress.lock().unwrap();
+            progress.extras.contains_key("etag") || progress.extras.contains_key("last-modified")
+        };
+        if !resumable {
+            return None;
+        }
+        StallDetector::new(&self.conf.common_data.stall_detection)
+    }
+
+    /// Returns the decoder of the body of a response, `None` if the task does
+    /// not decode bodies or the body is not encoded.
+    ///
+    /// Only complete bodies are decoded, a resumed download asks for the rest
+    /// of the decoded body as it is.
+    fn content_decoder(&self, response: &Response) -> Option<ContentDecoder> {
+        if !self.conf.common_data.compression || response.status().as_u16() != 200 {
+            return None;
+        }
+        let value = response
+            .headers()
+            .get("content-encoding")?
+            .to_string()
+            .ok()?;
+        let Some(encoding) = ContentEncoding::parse(&value) else {
+            info!("task {} keeps body encoded as {}", self.task_id(), value);
+            return None;
+        };
+        Some(ContentDecoder::new(encoding))
+    }
+
+    /// Reserves disk space for the rest of the body once its length is known.
+    ///
+    /// The file size is kept, so the downloaded length of a resumed task still
+    /// comes from it. Reservation is skipped where the file system does not
+    /// support it.
+    ///
+    /// # Errors
+    ///
+    /// Returns `TaskError::Failed(Reason::InsufficientSpace)` if the rest of
+    /// the body does not fit on the disk.
+    pub(super) async fn preallocate_file(&self) -> Result<(), TaskError> {
+        let Ok(rest) = u64::try_from(self.file_total_size.load(Ordering::SeqCst)) else {
+            return Ok(());
+        };
+        let (Some(file), true) = (self.files.get(0), rest > 0) else {
+            return Ok(());
+        };
+        let downloaded = self.processed.file(0);
+        match task_control::file_preallocate(file, downloaded as u64, rest).await {
+            Ok(()) => Ok(()),
+            Err(e) if e.raw_os_error() == Some(ENOSPC) => {
+                error!("task {} preallocate {} failed {}", self.task_id(), rest, e);
+                Err(TaskError::Failed(Reason::InsufficientSpace))
+            }
+            Err(e) => {
+                debug!("task {} preallocate skipped {}", self.task_id(), e);
+                Ok(())
+            }
+        }
+    }
+
+    /// Starts the digest of the file if the task has a checksum, the bytes
+    /// already downloaded are hashed first.
+    ///
+    /// # Errors
+    ///
+    /// Returns `TaskError::Failed(Reason::IoError)` if the downloaded bytes
+    /// cannot be read.
+    pub(super) async fn start_digest(&self) -> Result<(), TaskError> {
+        let (Some(checksum), Some(file)) = (&self.checksum, self.files.get(0)) else {
+            return Ok(());
+        };
+        let downloaded = self.processed.file(0);
+        let mut digest = Digest::new(checksum.algorithm);
+        if downloaded > 0 {
+            digest = checksum::hash_file(file, downloaded as u64, digest)
+                .await
+                .map_err(|e| {
+                    error!("task {} hash downloaded bytes failed {}", self.task_id(), e);
+                    TaskError::Failed(Reason::IoError)
+                })?;
+        }
+        *self.digest.lock().unwrap() = Some(digest);
+        Ok(())
+    }
+
+    /// Compares the digest of the downloaded file with the checksum of the
+    /// task and records it in the progress extras.
+    ///
+    /// # Arguments
+    ///
+    /// * `len` - Length of the downloaded file, used when the file has to be
+    ///   hashed because no running digest was kept.
+    ///
+    /// # Errors
+    ///
+    /// Returns `TaskError::Failed(Reason::ChecksumMismatch)` if the digests
+    /// differ, the file is cleared so the next attempt downloads it again.
+    async fn verify_checksum(self: &Arc<Self>, len: u64) -> Result<(), TaskError> {
+        let (Some(checksum), Some(file)) = (&self.checksum, self.files.get(0)) else {
+            return Ok(());
+        };
+        let running = self.digest.lock().unwrap().take();
+        let digest = match running {
+            Some(digest) => digest,
+            None => checksum::hash_file(file, len, Digest::new(checksum.algorithm))
+                .await
+                .map_err(|e| {
+                    error!("task {} hash file failed {}", self.task_id(), e);
+                    TaskError::Failed(Reason::IoError)
+                })?,
+        };
+        let digest = digest.finish();
+        let formatted = checksum::format(checksum.algorithm, &digest);
+        if digest != checksum.expected {
+            error!("task {} checksum mismatch, got {}", self.task_id(), formatted);
+            sys_event!(
+                ExecFault,
+                DfxCode::TASK_FAULT_09,
+                &format!("task {} checksum mismatch", self.task_id())
+            );
+            task_control::clear_downloaded_file(self.clone()).await?;
+            return Err(TaskError::Failed(Reason::ChecksumMismatch));
+        }
+        info!("task {} checksum verified", self.task_id());
+        self.progress
+            .lock()
+            .unwrap()
+            .extras
+            .insert(CHECKSUM_EXTRA.to_string(), formatted);
+        Ok(())
+    }
+
+    pub(crate) async fn prepare_download(&self) -> Result<(), TaskError> {
         if let Some(file) = self.files.get(0) {
             // Seek to the end of the file to get the current size (for resuming downloads)
             task_control::file_seek(file.clone(), SeekFrom::End(0)).await?;
@@ -210,9 +456,13 @@ impl RequestTask {
             // Update progress tracking information
             let mut progress = self.progress.lock().unwrap();
             progress.common_data.index = 0;  // Set file index
-            progress.common_data.total_processed = downloaded;  // Set bytes already downloaded
             progress.common_data.state = State::Running.repr;  // Set task state to running
-            progress.processed = vec![downloaded];  // Track processed bytes for the file
+            // Track processed bytes for the file, the bytes already downloaded
+            self.processed.update(|files, total| {
+                files.fill(0);
+                files[0] = downloaded;
+                *total = downloaded;
+            });
         } else {
             // Log and return error if no file is available
             error!("prepare_download err, no file in the task");
@@ -256,23 +506,47 @@ pub(crate) async fn download_inner(
     // Log that the download has started
     info!("{} downloading", task.task_id());
 
-    // Build the HTTP request for downloading
+    // Build the HTTP request for downloading, sent to the cached target of
+    // the url if it redirects
+    task.start_redirects();
     let request = RequestTask::build_download_request(task.clone()).await?;
 
     // Record the start time for tracking
     let start_time = get_current_duration().as_secs() as u64;
     task.start_time.store(start_time as u64, Ordering::SeqCst);
 
-    // Acquire the client lock and send the request
+    // Wait for the origin to be reachable and for a connection slot of the
+    // host, then send the request
     // Send HTTP request and handle response with detailed error categorization
-    let client = task.client.lock().await;
-    let response = client.request(request).await;
+    task.wait_for_origin(&abort_flag).await?;
+    let Some(slot) = ClientPool::get_instance()
+        .host_slot(&task.conf.url, &abort_flag)
+        .await
+    else {
+        return Err(TaskError::Waiting(TaskPhase::UserAbort));
+    };
+    let sent = get_current_timestamp();
+    let mut response = task.client.request(request).await;
+    let mut hops = 0;
+    while task.follow_redirect(&response, &mut hops)? {
+        let request = RequestTask::build_download_request(task.clone()).await?;
+        response = task.client.request(request).await;
+    }
+    task.record_attempt(sent, response.as_ref().ok());
+    task.record_origin(&response);
 
     // Handle response and categorize errors based on status codes and error types
     match response.as_ref() {
         Ok(response) => {
             // Extract and log the status code
             let status_code = response.status();
+            Timelines::get_instance().record(
+                task.task_id(),
+                Phase::Response {
+                    status: status_code.as_u16() as u32,
+                    ttfb: get_current_timestamp().saturating_sub(sent),
+                },
+            );
             #[cfg(feature = "oh")]
             task.notify_response(response);
             info!(
@@ -438,6 +712,19 @@ pub(crate) async fn download_inner(
         }
     }
     task.get_file_info(&response)?;
+    let decoder = task.content_decoder(&response);
+    if decoder.is_some() {
+        // The length of the encoded body is not the size of the file, so the
+        // file is neither reserved nor split into segments.
+        task.file_total_size.store(-1, Ordering::SeqCst);
+        task.progress.lock().unwrap().sizes = vec![-1];
+    }
+    if let Ok(rest) = u64::try_from(task.file_total_size.load(Ordering::SeqCst)) {
+        task.check_memory_limit(rest + task.processed.file(0) as u64)?;
+    }
+    task.preallocate_file().await?;
+    task.start_digest().await?;
+    let extracting = extract::start(&task).await?;
     task.update_progress_in_database();
     RequestDb::get_instance()
         .update_task_sizes(task.task_id(), &task.progress.lock().unwrap().sizes);
@@ -456,27 +743,83 @@ pub(crate) async fn download_inner(
                 &0
             })
     ));
-    let mut downloader = build_downloader(task.clone(), response, abort_flag);
-
-    if let Err(e) = downloader.download().await {
-        return task.handle_download_error(e).await;
+    // An archive is extracted in order, from a single connection
+    let delta_plan = match extracting {
+        true => None,
+        false => delta::plan(&task, &response).await,
+    };
+    if let Some(plan) = delta_plan {
+        // Only the blocks the old file lacks are fetched, in ranges
+        drop(response);
+        drop(slot);
+        task.digest.lock().unwrap().take();
+        delta::download(task.clone(), plan, abort_flag).await?;
+    } else if let Some(segments) = (!extracting)
+        .then(|| segment::plan(&task, &response))
+        .flatten()
+    {
+        // The body is fetched again in ranges over parallel connections
+        drop(response);
+        drop(slot);
+        // Segments arrive out of order, the file is hashed once it is complete
+        task.digest.lock().unwrap().take();
+        let connections = segments.len();
+        segment::download_segments(task.clone(), segments, connections, abort_flag).await?;
+    } else {
+        let complete = Arc::new(AtomicBool::new(false));
+        let decoder = decoder.map(|decoder| (decoder, complete.clone()));
+        let decoding = decoder.is_some();
+        let mut downloader = build_downloader(task.clone(), response, abort_flag, decoder);
+        let res = downloader.download().await;
+        // Dropping the downloader writes the data its operator still buffers
+        drop(downloader);
+        if res.is_ok() && decoding && !complete.load(Ordering::Acquire) {
+            error!("task {} encoded body truncated", task.task_id());
+            return Err(TaskError::Failed(Reason::ProtocolError));
+        }
+        if let Err(e) = res {
+            // The next try asks for the rest of the body from the bytes written
+            if format!("{}", e).contains(STALL_MESSAGE) {
+                let reconnects = task.stall_reconnects.fetch_add(1, Ordering::SeqCst) + 1;
+                info!("task {} reconnects after a stall, {} times", task.task_id(), reconnects);
+                return Err(TaskError::Waiting(TaskPhase::NeedRetry));
+            }
+            if format!("{}", e).contains(BODY_TOO_LARGE_MESSAGE) {
+                error!("task {} body exceeds memory limit", task.task_id());
+                return Err(TaskError::Failed(Reason::BodyTooLarge));
+            }
+            return task.handle_download_error(e).await;
+        }
     }
+    task.record_transfer();
+    finish_file(&task).await
+}
 
+/// Checks the file of a download whose body is complete: every byte counted
+/// is on the disk, the body matches the checksum of the task, and the file
+/// is where the application expects it.
+///
+/// # Errors
+///
+/// Returns `TaskError::Failed(Reason::IoError)` if the file is missing or
+/// shorter than the bytes counted, `TaskError::Failed(Reason::ChecksumMismatch)`
+/// if the body does not match the checksum.
+pub(super) async fn finish_file(task: &Arc<RequestTask>) -> Result<(), TaskError> {
     let file_mutex = task.files.get(0).unwrap();
-    task_control::file_sync_all(file_mutex).await?;
+    task_control::file_sync_all(file_mutex.clone()).await?;
+    let written = task_control::file_metadata(file_mutex).await?.len() as usize;
+    let processed = task.processed.file(0);
+    // The archive extracted may not be stored
+    let unstored = extract::finish(task)?;
+    if processed != written && !unstored {
+        error!("task {} wrote {} of {} bytes", task.task_id(), written, processed);
+        return Err(TaskError::Failed(Reason::IoError));
+    }
+    task.verify_checksum(written as u64).await?;
 
     #[cfg(not(test))]
-    check_file_exist(&task)?;
-    {
-        let mut guard = task.progress.lock().unwrap();
-        guard.sizes = vec![guard.processed.first().map_or_else(
-            || {
-                error!("Failed to get a process size from an empty vector in RequestTask");
-                Default::default()
-            },
-            |x| *x as i64,
-        )];
-    }
+    check_file_exist(task)?;
+    task.progress.lock().unwrap().sizes = vec![task.processed.file(0) as i64];
 
     info!("{} downloaded", task.task_id());
     Ok(())
@@ -505,6 +848,10 @@ fn check_file_exist(task: &Arc<RequestTask>) -> Result<(), TaskError> {
     use crate::task::files::{convert_path, BundleCache};
 
     let config = task.config();
+    // Skip check for in-memory bodies, which have no file of the app
+    if task.memory_limit().is_some() {
+        return Ok(());
+    }
     // Skip check for user files which download_server cannot access directly
     if let Some(first_file_spec) = config.file_specs.first() {
         if first_file_spec.is_user_file {
@@ -0,0 +1,285 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Archives extracted while they download.
+//!
+//! A download opts in with the `extract` extra of its config, the directory
+//! of the application the archive is extracted to, which the application
+//! grants the service. Every buffer written to the file is also fed to a
+//! streaming extractor, see `request_utils::archive`, so the entries are in
+//! place when the download completes, without the archive being read again.
+//! The progress extras count the entries extracted and name the entry being
+//! extracted.
+//!
+//! With `extract_keep` set to `false` the archive itself is not stored: the
+//! file stays empty, and a download that stops starts over from the first
+//! byte, the entries being written again. Otherwise a resumed download feeds
+//! the bytes already in the file to the extractor first.
+//!
+//! The body is downloaded in order over one connection, neither in segments
+//! nor as a delta.
+
+use std::fs::{self, File, OpenOptions};
+use std::io::{self, Write};
+use std::os::unix::fs::{DirBuilderExt, FileExt, OpenOptionsExt, PermissionsExt};
+use std::path::{Path, PathBuf};
+use std::sync::Arc;
+
+use request_utils::archive::{ArchiveError, Entry, EntryKind, Extractor, Sink};
+
+use super::reason::Reason;
+use super::request_task::{RequestTask, TaskError};
+use crate::task::config::Action;
+use crate::task::files::{convert_path, BundleCache};
+use crate::task::task_control;
+
+/// Key of the config extra holding the directory the archive is extracted
+/// to.
+pub(crate) const EXTRACT_EXTRA: &str = "extract";
+
+/// Key of the config extra telling whether the archive is stored, `false`
+/// if it is not.
+pub(crate) const EXTRACT_KEEP_EXTRA: &str = "extract_keep";
+
+/// Key of the progress extra holding the number of entries extracted.
+pub(crate) const EXTRACTED_EXTRA: &str = "extracted";
+
+/// Key of the progress extra holding the path of the entry being extracted.
+pub(crate) const EXTRACTING_EXTRA: &str = "extracting";
+
+/// Bytes of the stored archive read at once on resume.
+const READ_SIZE: usize = 256 * 1024;
+
+/// Modes of the entries, readable and writable by the application.
+const FILE_MODE: u32 = 0o666;
+const DIR_MODE: u32 = 0o777;
+
+/// Extraction of the archive a task downloads.
+pub(crate) struct Extraction {
+    extractor: Extractor,
+    sink: DirSink,
+    /// Whether the archive is stored in the file of the task
+    keep: bool,
+}
+
+impl Extraction {
+    /// Whether the archive is written to the file of the task.
+    pub(crate) fn keeps_archive(&self) -> bool {
+        self.keep
+    }
+
+    /// Extracts the entries the next buffer of the archive completes or
+    /// continues, and records them in the progress of the task.
+    pub(crate) fn feed(&mut self, task: &RequestTask, buffer: &[u8]) -> io::Result<()> {
+        let before = self.extractor.entries();
+        let res = self.extractor.feed(buffer, &mut self.sink);
+        if self.extractor.entries() != before || self.sink.started {
+            self.sink.started = false;
+            let mut progress = task.progress.lock().unwrap();
+            progress.extras.insert(
+                EXTRACTED_EXTRA.to_string(),
+                self.extractor.entries().to_string(),
+            );
+            progress
+                .extras
+                .insert(EXTRACTING_EXTRA.to_string(), self.sink.current.clone());
+        }
+        res.map_err(|e| {
+            error!("task {} extract failed {}", task.task_id(), e);
+            match e {
+                ArchiveError::Io(e) => e,
+                e => io::Error::new(io::ErrorKind::InvalidData, e),
+            }
+        })
+    }
+
+    /// Checks that the whole archive was extracted.
+    pub(crate) fn finish(&self) -> Result<(), ArchiveError> {
+        self.extractor.finish()
+    }
+}
+
+/// Writes the entries of an archive under a directory.
+struct DirSink {
+    dir: PathBuf,
+    file: Option<File>,
+    /// Path of the latest entry started
+    current: String,
+    /// Whether an entry started since the progress was recorded
+    started: bool,
+}
+
+impl Sink for DirSink {
+    fn begin(&mut self, entry: &Entry) -> io::Result<()> {
+        let path = self.dir.join(&entry.path);
+        self.current = entry.path.clone();
+        self.started = true;
+        if let Some(parent) = path.parent() {
+            create_dirs(parent)?;
+        }
+        match entry.kind {
+            EntryKind::Dir => create_dirs(&path),
+            EntryKind::File => {
+                let file = OpenOptions::new()
+                    .write(true)
+                    .create(true)
+                    .truncate(true)
+                    .mode(FILE_MODE)
+                    .open(&path)?;
+                // The umask of the service does not apply to the application
+                file.set_permissions(fs::Permissions::from_mode(FILE_MODE))?;
+                self.file = Some(file);
+                Ok(())
+            }
+        }
+    }
+
+    fn data(&mut self, data: &[u8]) -> io::Result<()> {
+        match self.file.as_mut() {
+            Some(file) => file.write_all(data),
+            None => Ok(()),
+        }
+    }
+
+    fn end(&mut self) -> io::Result<()> {
+        self.file.take();
+        Ok(())
+    }
+}
+
+fn create_dirs(path: &Path) -> io::Result<()> {
+    if path.is_dir() {
+        return Ok(());
+    }
+    fs::DirBuilder::new()
+        .recursive(true)
+        .mode(DIR_MODE)
+        .create(path)?;
+    fs::set_permissions(path, fs::Permissions::from_mode(DIR_MODE))
+}
+
+/// Whether a task asked for its archive to be extracted and can be: the
+/// download of a file of the application.
+pub(crate) fn wanted(task: &RequestTask) -> bool {
+    let config = &task.conf;
+    config.common_data.action == Action::Download
+        && config.common_data.memory_limit == 0
+        && config.file_specs.len() == 1
+        && !config.file_specs[0].is_user_file
+        && config
+            .extras
+            .get(EXTRACT_EXTRA)
+            .is_some_and(|dir| !dir.is_empty())
+}
+
+/// Starts the extraction of the archive a task downloads, the bytes of it
+/// already in the file are extracted first.
+///
+/// # Returns
+///
+/// Whether the task extracts its archive.
+///
+/// # Errors
+///
+/// Returns `TaskError::Failed(Reason::IoError)` if the directory cannot be
+/// resolved or the stored bytes cannot be extracted.
+pub(crate) async fn start(task: &Arc<RequestTask>) -> Result<bool, TaskError> {
+    if !wanted(task) {
+        return Ok(false);
+    }
+    let config = &task.conf;
+    let bundle = BundleCache::new(config).get_value().map_err(|_| {
+        error!("task {} extract bundle name failed", task.task_id());
+        TaskError::Failed(Reason::IoError)
+    })?;
+    let dir = convert_path(
+        config.common_data.uid,
+        &bundle,
+        &config.extras[EXTRACT_EXTRA],
+    );
+    let keep = config
+        .extras
+        .get(EXTRACT_KEEP_EXTRA)
+        .map_or(true, |keep| keep != "false");
+    let mut extraction = Extraction {
+        extractor: Extractor::new(),
+        sink: DirSink {
+            dir: PathBuf::from(dir),
+            file: None,
+            current: String::new(),
+            started: false,
+        },
+        keep,
+    };
+    let downloaded = task.processed.file(0) as u64;
+    if let (true, Some(file)) = (downloaded > 0, task.files.get(0)) {
+        let resumed = task.clone();
+        let res = task_control::runtime_spawn_blocking(move || {
+            let file = file.lock().unwrap();
+            let mut buf = vec![0u8; READ_SIZE];
+            let mut offset = 0u64;
+            while offset < downloaded {
+                let size = READ_SIZE.min((downloaded - offset) as usize);
+                file.read_exact_at(&mut buf[..size], offset)?;
+                extraction.feed(&resumed, &buf[..size])?;
+                offset += size as u64;
+            }
+            Ok(extraction)
+        })
+        .await
+        .map_err(|e| io::Error::new(io::ErrorKind::Other, e))
+        .and_then(|res| res);
+        extraction = res.map_err(|e| {
+            error!(
+                "task {} extract downloaded bytes failed {}",
+                task.task_id(),
+                e
+            );
+            TaskError::Failed(Reason::IoError)
+        })?;
+    }
+    info!(
+        "task {} extracts from {} bytes, keeps archive {}",
+        task.task_id(),
+        downloaded,
+        keep
+    );
+    *task.extraction.lock().unwrap() = Some(extraction);
+    Ok(true)
+}
+
+/// Ends the extraction of the archive of a task whose body is complete.
+///
+/// # Returns
+///
+/// Whether the task extracted its archive and did not store it.
+///
+/// # Errors
+///
+/// Returns `TaskError::Failed(Reason::IoError)` if the archive is truncated
+/// or malformed.
+pub(crate) fn finish(task: &RequestTask) -> Result<bool, TaskError> {
+    let Some(extraction) = task.extraction.lock().unwrap().take() else {
+        return Ok(false);
+    };
+    if let Err(e) = extraction.finish() {
+        error!("task {} archive incomplete {}", task.task_id(), e);
+        return Err(TaskError::Failed(Reason::IoError));
+    }
+    info!(
+        "task {} extracted {} entries",
+        task.task_id(),
+        extraction.extractor.entries()
+    );
+    Ok(!extraction.keep)
+}
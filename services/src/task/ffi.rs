@@ -17,19 +17,17 @@
 //! between Rust and C code for task configuration, information, and progress updates.
 
 use super::config::{
-    Action, CommonTaskConfig, ConfigSet, MinSpeed, Mode, NetworkConfig, TaskConfig, Timeout,
-    Version,
+    Action, CommonTaskConfig, ConfigSet, MinSpeed, Mode, NetworkConfig, StallDetection, TaskConfig,
+    Timeout, Version,
 };
 use super::info::{CommonTaskInfo, InfoSet, TaskInfo, UpdateInfo};
 use super::notify::{CommonProgress, Progress};
+use super::performance::Performance;
 use crate::task::info::State;
 use crate::utils::c_wrapper::{CFileSpec, CFormItem, CStringWrapper};
 
-cfg_oh! {
-    use crate::utils::c_wrapper::{DeleteCFileSpec, DeleteCFormItem, DeleteCStringPtr};
-}
-
 use crate::utils::form_item::{FileSpec, FormItem};
+use crate::utils::intern::{intern_str, intern_strings};
 use crate::utils::{build_vec, split_string, string_to_hashmap};
 
 /// C-compatible representation of task configuration.
@@ -63,6 +61,8 @@ pub(crate) struct CTaskConfig {
     pub(crate) proxy: CStringWrapper,
     /// Certificate pins for SSL verification.
     pub(crate) certificate_pins: CStringWrapper,
+    /// Expected digest of the downloaded file.
+    pub(crate) checksum: CStringWrapper,
     /// Additional task-specific data as a JSON string.
     pub(crate) extras: CStringWrapper,
     /// API version identifier.
@@ -135,6 +135,24 @@ pub(crate) struct CommonCTaskConfig {
     pub(crate) min_speed: CMinSpeed,
     /// Timeout settings for the task.
     pub(crate) timeout: CTimeout,
+    /// Stall detection settings of a download.
+    pub(crate) stall_detection: CStallDetection,
+    /// Number of files of an upload sent at the same time.
+    pub(crate) concurrency: u32,
+    /// Size in bytes of the chunks of a resumable upload.
+    pub(crate) chunk_size: u64,
+    /// Time in milliseconds since the epoch the task should be done by.
+    pub(crate) deadline: u64,
+    /// Whether a download may share its transfer with identical ones.
+    pub(crate) coalesce: bool,
+    /// Whether a download asks for a compressed body and decodes it.
+    pub(crate) compression: bool,
+    /// Cap of a body kept in memory, 0 for a file.
+    pub(crate) memory_limit: u32,
+    /// Whether the task waits for the prefetch window.
+    pub(crate) prefetch: bool,
+    /// Whether a download keeps its data out of the page cache.
+    pub(crate) bypass_cache: bool,
 }
 
 /// C-compatible representation of minimum speed requirements.
@@ -161,6 +179,15 @@ pub(crate) struct CTimeout {
     pub(crate) total_timeout: u64,
 }
 
+/// C-compatible representation of the stall detection of a download.
+#[repr(C)]
+pub(crate) struct CStallDetection {
+    /// Window in milliseconds the current throughput is measured over.
+    pub(crate) window: i64,
+    /// Percent of the average throughput below which the download stalls.
+    pub(crate) ratio: i64,
+}
+
 /// C-compatible representation of task progress information.
 ///
 /// This struct provides a way to pass progress updates between Rust and C code,
@@ -215,15 +242,17 @@ impl Progress {
         Progress {
             common_data: c_struct.common_data.clone(),
             // Parse comma-separated string of sizes into a vector of i64
-            sizes: split_string(&mut c_struct.sizes.to_string())
+            sizes: split_string(c_struct.sizes.as_str())
                 .map(|s| s.parse::<i64>().unwrap_or_default())
                 .collect(),
             // Parse comma-separated string of processed bytes into a vector of usize
-            processed: split_string(&mut c_struct.processed.to_string())
+            processed: split_string(c_struct.processed.as_str())
                 .map(|s| s.parse::<usize>().unwrap_or_default())
                 .collect(),
             // Parse JSON string of extras into a HashMap
-            extras: string_to_hashmap(&mut c_struct.extras.to_string()),
+            extras: string_to_hashmap(c_struct.extras.as_str()),
+            speed: 0,
+            eta: -1,
         }
     }
 }
@@ -265,6 +294,8 @@ pub(crate) struct CTaskInfo {
     pub(crate) max_speed: i64,
     /// Total time elapsed for the task (milliseconds).
     pub(crate) task_time: u64,
+    /// Encoded transport timings of the latest attempt.
+    pub(crate) performance: CStringWrapper,
 }
 
 impl TaskInfo {
@@ -296,6 +327,7 @@ impl TaskInfo {
             common_data: self.common_data,
             max_speed: self.max_speed,
             task_time: self.task_time,
+            performance: CStringWrapper::from(&info.performance),
         }
     }
 
@@ -322,16 +354,16 @@ impl TaskInfo {
             || (c_struct.progress.common_data.state != State::Completed.repr
                 && c_struct.progress.common_data.state != State::Failed.repr)
         {
-            c_struct.mime_type.to_string()
+            c_struct.mime_type.as_str().to_string()
         } else {
             String::new()
         };
 
         let task_info = TaskInfo {
-            bundle: c_struct.bundle.to_string(),
-            url: c_struct.url.to_string(),
-            data: c_struct.data.to_string(),
-            token: c_struct.token.to_string(),
+            bundle: c_struct.bundle.as_str().to_string(),
+            url: c_struct.url.as_str().to_string(),
+            data: c_struct.data.as_str().to_string(),
+            token: c_struct.token.as_str().to_string(),
             form_items: build_vec(
                 c_struct.form_items_ptr,
                 c_struct.form_items_len as usize,
@@ -342,21 +374,17 @@ impl TaskInfo {
                 c_struct.file_specs_len as usize,
                 FileSpec::from_c_struct,
             ),
-            title: c_struct.title.to_string(),
-            description: c_struct.description.to_string(),
+            title: c_struct.title.as_str().to_string(),
+            description: c_struct.description.as_str().to_string(),
             mime_type,
             progress,
             extras,
             common_data: c_struct.common_data,
             max_speed: c_struct.max_speed,
             task_time: c_struct.task_time,
+            performance: Performance::decode(c_struct.performance.as_str()),
         };
 
-        #[cfg(feature = "oh")]
-        {
-            unsafe { DeleteCFormItem(c_struct.form_items_ptr) };
-            unsafe { DeleteCFileSpec(c_struct.file_specs_ptr) };
-        }
         task_info
     }
 }
@@ -417,7 +445,7 @@ impl TaskConfig {
     pub(crate) fn to_c_struct(&self, task_id: u32, uid: u64, set: &ConfigSet) -> CTaskConfig {
         CTaskConfig {
             // Basic task identifiers and metadata
-            bundle: CStringWrapper::from(&self.bundle),
+            bundle: CStringWrapper::from(&*self.bundle),
             bundle_type: self.bundle_type as u8, // Convert u32 to u8 for C compatibility
             atomic_account: CStringWrapper::from(&self.atomic_account),
             url: CStringWrapper::from(&self.url),
@@ -430,8 +458,9 @@ impl TaskConfig {
             data: CStringWrapper::from(&self.data),
             token: CStringWrapper::from(&self.token),
             extras: CStringWrapper::from(&set.extras), // Extras from ConfigSet
-            proxy: CStringWrapper::from(&self.proxy),
+            proxy: CStringWrapper::from(&*self.proxy),
             certificate_pins: CStringWrapper::from(&self.certificate_pins),
+            checksum: CStringWrapper::from(&self.checksum),
 
             // Version information
             version: self.version as u8, // Convert Version enum to u8
@@ -488,6 +517,18 @@ impl TaskConfig {
                     connection_timeout: self.common_data.timeout.connection_timeout,
                     total_timeout: self.common_data.timeout.total_timeout,
                 },
+                stall_detection: CStallDetection {
+                    window: self.common_data.stall_detection.window,
+                    ratio: self.common_data.stall_detection.ratio,
+                },
+                concurrency: self.common_data.concurrency,
+                chunk_size: self.common_data.chunk_size,
+                deadline: self.common_data.deadline,
+                coalesce: self.common_data.coalesce,
+                compression: self.common_data.compression,
+                memory_limit: self.common_data.memory_limit,
+                prefetch: self.common_data.prefetch,
+                bypass_cache: self.common_data.bypass_cache,
             },
         }
     }
@@ -504,29 +545,30 @@ impl TaskConfig {
     ///
     /// # Safety
     ///
-    /// Under the `oh` feature flag, this function calls C functions to deallocate
-    /// pointers. Callers must ensure that pointers are only passed once to prevent
-    /// double-free errors.
+    /// The strings and arrays are read in place, they must stay valid until this
+    /// function returns. Under the `oh` feature flag, they live in the buffer of
+    /// `QueryTaskConfig`, which the caller releases with `DeleteCTaskConfig`.
     pub(crate) fn from_c_struct(c_struct: &CTaskConfig) -> Self {
         let task_config: TaskConfig = TaskConfig {
             // Basic task identifiers and metadata
-            bundle: c_struct.bundle.to_string(),
+            bundle: intern_str(c_struct.bundle.as_str()),
             bundle_type: c_struct.bundle_type as u32, // Convert u8 back to u32
-            atomic_account: c_struct.atomic_account.to_string(),
-            url: c_struct.url.to_string(),
-            title: c_struct.title.to_string(),
-            description: c_struct.description.to_string(),
+            atomic_account: c_struct.atomic_account.as_str().to_string(),
+            url: c_struct.url.as_str().to_string(),
+            title: c_struct.title.as_str().to_string(),
+            description: c_struct.description.as_str().to_string(),
 
             // Request configuration
-            method: c_struct.method.to_string(),
+            method: c_struct.method.as_str().to_string(),
             // Parse headers from JSON string into HashMap
-            headers: string_to_hashmap(&mut c_struct.headers.to_string()),
-            data: c_struct.data.to_string(),
-            token: c_struct.token.to_string(),
+            headers: string_to_hashmap(c_struct.headers.as_str()),
+            data: c_struct.data.as_str().to_string(),
+            token: c_struct.token.as_str().to_string(),
             // Parse extras from JSON string into HashMap
-            extras: string_to_hashmap(&mut c_struct.extras.to_string()),
-            proxy: c_struct.proxy.to_string(),
-            certificate_pins: c_struct.certificate_pins.to_string(),
+            extras: string_to_hashmap(c_struct.extras.as_str()),
+            proxy: intern_str(c_struct.proxy.as_str()),
+            certificate_pins: c_struct.certificate_pins.as_str().to_string(),
+            checksum: c_struct.checksum.as_str().to_string(),
 
             // Version information - convert u8 back to Version enum
             version: Version::from(c_struct.version),
@@ -545,13 +587,13 @@ impl TaskConfig {
             body_file_paths: build_vec(
                 c_struct.body_file_names_ptr,
                 c_struct.body_file_names_len as usize,
-                CStringWrapper::to_string, // Conversion function for each element
+                |name| name.as_str().to_string(),
             ),
-            certs_path: build_vec(
+            certs_path: intern_strings(&build_vec(
                 c_struct.certs_path_ptr,
                 c_struct.certs_path_len as usize,
-                CStringWrapper::to_string, // Conversion function for each element
-            ),
+                |path| path.as_str().to_string(),
+            )),
 
             // Common task configuration data
             common_data: CommonTaskConfig {
@@ -595,22 +637,22 @@ impl TaskConfig {
                     connection_timeout: c_struct.common_data.timeout.connection_timeout,
                     total_timeout: c_struct.common_data.timeout.total_timeout,
                 },
+                stall_detection: StallDetection {
+                    window: c_struct.common_data.stall_detection.window,
+                    ratio: c_struct.common_data.stall_detection.ratio,
+                },
+                concurrency: c_struct.common_data.concurrency,
+                chunk_size: c_struct.common_data.chunk_size,
+                deadline: c_struct.common_data.deadline,
+                coalesce: c_struct.common_data.coalesce,
+                compression: c_struct.common_data.compression,
+                memory_limit: c_struct.common_data.memory_limit,
+                prefetch: c_struct.common_data.prefetch,
+                bypass_cache: c_struct.common_data.bypass_cache,
+                trace_id: 0,
             },
         };
 
-        // Under OH feature flag, free C-allocated memory to prevent memory leaks
-        #[cfg(feature = "oh")]
-        {
-            // Deallocate form items array
-            unsafe { DeleteCFormItem(c_struct.form_items_ptr) };
-            // Deallocate file specifications array
-            unsafe { DeleteCFileSpec(c_struct.file_specs_ptr) };
-            // Deallocate body file names array
-            unsafe { DeleteCStringPtr(c_struct.body_file_names_ptr) };
-            // Deallocate certificate paths array
-            unsafe { DeleteCStringPtr(c_struct.certs_path_ptr) };
-        }
-
         task_config
     }
 }
@@ -0,0 +1,103 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! File I/O of the transfers, run off the runtime workers.
+//!
+//! Writes of downloaded bodies and reads of uploaded files block on the
+//! storage, for long on slow or encrypted storage under sync pressure. They
+//! are submitted in large batches to the blocking pool of the runtime, and
+//! the workers poll their completion instead of blocking, so the network
+//! polling of the other tasks goes on meanwhile.
+
+use std::future::Future;
+use std::io;
+use std::pin::Pin;
+use std::sync::{Arc, Condvar, Mutex};
+use std::task::{Context, Poll, Waker};
+
+/// Result of a submission and the waker of its poller.
+struct Slot<T> {
+    result: Option<io::Result<T>>,
+    waker: Option<Waker>,
+}
+
+/// Completion of an operation submitted to the blocking pool.
+///
+/// Polled by the runtime workers, or waited for by the code that cannot
+/// return `Pending`, the drop of a writer.
+pub(crate) struct Submission<T> {
+    shared: Arc<(Mutex<Slot<T>>, Condvar)>,
+}
+
+/// Runs `op` on the blocking pool.
+pub(crate) fn submit<F, T>(op: F) -> Submission<T>
+where
+    F: FnOnce() -> io::Result<T> + Send + Sync + 'static,
+    T: Send + 'static,
+{
+    let shared = Arc::new((
+        Mutex::new(Slot {
+            result: None,
+            waker: None,
+        }),
+        Condvar::new(),
+    ));
+    let done = shared.clone();
+    // The handle is not kept, the operation signals its completion itself.
+    let _ = ylong_runtime::spawn_blocking(move || {
+        let result = op();
+        let (slot, cond) = &*done;
+        let mut slot = slot.lock().unwrap();
+        slot.result = Some(result);
+        cond.notify_all();
+        if let Some(waker) = slot.waker.take() {
+            waker.wake();
+        }
+    });
+    Submission { shared }
+}
+
+impl<T> Submission<T> {
+    /// Blocks until the operation completes.
+    pub(crate) fn wait(self) -> io::Result<T> {
+        let (slot, cond) = &*self.shared;
+        let mut slot = slot.lock().unwrap();
+        loop {
+            if let Some(result) = slot.result.take() {
+                return result;
+            }
+            slot = cond.wait(slot).unwrap();
+        }
+    }
+}
+
+impl<T> Future for Submission<T> {
+    type Output = io::Result<T>;
+
+    fn poll(self: Pin<&mut Self>, cx: &mut Context<'_>) -> Poll<Self::Output> {
+        let (slot, _) = &*self.shared;
+        let mut slot = slot.lock().unwrap();
+        match slot.result.take() {
+            Some(result) => Poll::Ready(result),
+            None => {
+                slot.waker = Some(cx.waker().clone());
+                Poll::Pending
+            }
+        }
+    }
+}
+
+#[cfg(test)]
+mod ut_file_io {
+    include!("../../tests/ut/task/ut_file_io.rs");
+}
@@ -17,15 +17,17 @@ use std::os::fd::FromRawFd;
 use std::sync::{Arc, Mutex};
 
 use crate::error::{ErrorCode, ServiceError};
-use crate::manage::account;
+use crate::manage::environment;
 use crate::task::bundle::get_name_and_index;
 use crate::task::config::{Action, TaskConfig};
+use crate::task::memory;
 use crate::task::ATOMIC_SERVICE;
 
 /// Container for all files associated with a network task.
 /// 
 /// Manages the main task files (upload/download targets) and their sizes,
 /// as well as any additional body files used for complex requests.
+#[derive(Clone)]
 pub(crate) struct AttachedFiles {
     /// Main files for the task (upload sources or download destinations).
     pub(crate) files: Files,
@@ -90,6 +92,9 @@ fn open_task_files(config: &TaskConfig) -> Result<(Files, Vec<i64>), ServiceErro
                             )));
                         }
                     }
+                } else if let Some(fd) = fs.fd {
+                    // The application opened the file when it created the task
+                    unsafe { File::from_raw_fd(fd) }
                 } else {
                     // For non-user files, open from the app's storage
                     let bundle_name = bundle_cache.get_value()?;
@@ -113,7 +118,10 @@ fn open_task_files(config: &TaskConfig) -> Result<(Files, Vec<i64>), ServiceErro
                 sizes.push(size as i64);
             }
             Action::Download => {
-                let file = if fs.is_user_file {
+                let file = if memory::limit(config).is_some() {
+                    // The body is kept in memory, no file of the app is opened
+                    memory::open_body(tid).map_err(ServiceError::IoError)?
+                } else if fs.is_user_file {
                     // For user-provided files, use the file descriptor directly
                     match fs.fd {
                         Some(fd) => unsafe { File::from_raw_fd(fd) },
@@ -130,6 +138,9 @@ fn open_task_files(config: &TaskConfig) -> Result<(Files, Vec<i64>), ServiceErro
                             )));
                         }
                     }
+                } else if let Some(fd) = fs.fd {
+                    // The application opened the file when it created the task
+                    unsafe { File::from_raw_fd(fd) }
                 } else {
                     // For non-user files, open from the app's storage in read-write mode
                     let bundle_name = bundle_cache.get_value()?;
@@ -250,7 +261,7 @@ fn get_uuid_from_uid(uid: u64) -> u64 {
 /// ```
 pub(crate) fn check_current_account(task_uid: u64) -> bool {
     let task_account = get_uuid_from_uid(task_uid);
-    let (foreground_account, _active_accounts) = account::query_active_accounts();
+    let foreground_account = environment::snapshot().foreground_account;
     // 0 account_id tasks can run under other account_ids
     let b = (task_account == 0) || (task_account == foreground_account);
     if !b {
@@ -318,7 +329,7 @@ impl<'a> BundleCache<'a> {
 /// Returns a `ServiceError` if the bundle name cannot be converted.
 fn convert_bundle_name(config: &TaskConfig) -> Result<String, ServiceError> {
     let is_account = config.bundle_type == ATOMIC_SERVICE;
-    let bundle_name = config.bundle.as_str();
+    let bundle_name: &str = &config.bundle;
     
     if is_account {
         // Format for atomic service bundles
@@ -363,6 +374,7 @@ fn check_app_clone_bundle_name(uid: u64, bundle_name: &str) -> Result<String, Se
 /// 
 /// Provides a safe interface to access multiple files concurrently,
 /// using `Arc<Mutex<File>>` to ensure thread-safe file operations.
+#[derive(Clone)]
 pub(crate) struct Files(Vec<Arc<Mutex<File>>>);
 
 impl Files {
@@ -0,0 +1,120 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Bodies handed over by the preloads of applications.
+//!
+//! An application that preloaded a URL hands the cached body over when it
+//! creates a download of the same URL. The body is kept for the task until
+//! it starts, the task then clones it into its file instead of downloading
+//! it again. Bodies are only kept in memory: a task whose body was lost with
+//! the service, or does not match its checksum, downloads as usual.
+
+use std::collections::HashMap;
+use std::fs::File;
+use std::sync::{Arc, LazyLock, Mutex};
+
+use super::reason::Reason;
+use super::request_task::TaskError;
+use crate::task::config::{Action, TaskConfig};
+use crate::task::request_task::RequestTask;
+use crate::task::task_control;
+
+/// Number of bodies kept for tasks not started yet, later ones are refused.
+const MAX_BODIES: usize = 64;
+
+static BODIES: LazyLock<Mutex<HashMap<u32, File>>> = LazyLock::new(|| Mutex::new(HashMap::new()));
+
+/// Whether a cached body can stand for the download of a task: a plain `GET`
+/// of the whole resource to a file, the request of the preload.
+pub(crate) fn accepts(config: &TaskConfig) -> bool {
+    config.common_data.action == Action::Download
+        && config.method.eq_ignore_ascii_case("GET")
+        && config.headers.is_empty()
+        && config.common_data.memory_limit == 0
+        && config.common_data.begins == 0
+        && config.common_data.ends < 0
+        && config.file_specs.len() == 1
+}
+
+/// Keeps the body handed over for a task until it starts.
+///
+/// Returns `false` if too many bodies are kept already, the task then
+/// downloads its body.
+pub(crate) fn hand_over(task_id: u32, body: File) -> bool {
+    let mut bodies = BODIES.lock().unwrap();
+    if bodies.len() >= MAX_BODIES {
+        return false;
+    }
+    bodies.insert(task_id, body);
+    true
+}
+
+/// Takes the body handed over for a task.
+pub(crate) fn take(task_id: u32) -> Option<File> {
+    BODIES.lock().unwrap().remove(&task_id)
+}
+
+/// Drops the body handed over for a task removed before it started.
+pub(crate) fn discard(task_id: u32) {
+    BODIES.lock().unwrap().remove(&task_id);
+}
+
+impl RequestTask {
+    /// Clones the body handed over for the task into its file.
+    ///
+    /// # Returns
+    ///
+    /// The length of the body.
+    ///
+    /// # Errors
+    ///
+    /// Returns `TaskError::Failed(Reason::IoError)` if the body cannot be
+    /// cloned.
+    pub(crate) async fn adopt_handed_over(&self, body: File) -> Result<u64, TaskError> {
+        let Some(file) = self.files.get(0) else {
+            error!(
+                "task {} adopt handed over body err, no file",
+                self.task_id()
+            );
+            return Err(TaskError::Failed(Reason::OthersError));
+        };
+        let len = task_control::file_clone_from(file.clone(), Arc::new(Mutex::new(body)))
+            .await
+            .map_err(|e| {
+                error!(
+                    "task {} clone handed over body failed {}",
+                    self.task_id(),
+                    e
+                );
+                TaskError::Failed(Reason::IoError)
+            })?;
+        task_control::file_sync_all(file).await?;
+
+        self.progress.lock().unwrap().sizes = vec![len as i64];
+        self.processed.update(|files, total| {
+            files[0] = len as usize;
+            *total = len as usize;
+        });
+        info!(
+            "task {} adopted a handed over body of {} bytes",
+            self.task_id(),
+            len
+        );
+        Ok(len)
+    }
+}
+
+#[cfg(test)]
+mod ut_handoff {
+    include!("../../tests/ut/task/ut_handoff.rs");
+}
@@ -17,6 +17,7 @@ use std::collections::HashMap;
 pub use ffi::State;
 
 use super::notify::{EachFileStatus, NotifyData, Progress};
+use super::performance::Performance;
 use crate::task::config::{Action, Version};
 use crate::task::reason::Reason;
 use crate::utils::c_wrapper::{CFileSpec, CFormItem};
@@ -54,6 +55,8 @@ pub(crate) struct TaskInfo {
     pub(crate) max_speed: i64,
     /// Time when the task was created.
     pub(crate) task_time: u64,
+    /// Transport timings of the latest attempt.
+    pub(crate) performance: Performance,
 }
 
 impl TaskInfo {
@@ -75,6 +78,7 @@ impl TaskInfo {
             common_data: CommonTaskInfo::new(),
             max_speed: 0,
             task_time: 0,
+            performance: Performance::default(),
         }
     }
 
@@ -161,6 +165,8 @@ pub(crate) struct InfoSet {
     pub(crate) processed: String,
     /// JSON string representation of extra parameters.
     pub(crate) extras: String,
+    /// Encoded transport timings of the latest attempt.
+    pub(crate) performance: String,
 }
 
 // C++ interoperability bridge for task state enumeration
@@ -240,16 +246,19 @@ impl TaskInfo {
             sizes: format!("{:?}", self.progress.sizes),
             processed: format!("{:?}", self.progress.processed),
             extras: hashmap_to_string(&self.extras),
+            performance: self.performance.encode(),
         }
     }
 
     /// Creates a list of `EachFileStatus` objects representing the status of each file.
     pub(crate) fn build_each_file_status(&self) -> Vec<EachFileStatus> {
-        EachFileStatus::create_each_file_status(
+        let mut statuses = EachFileStatus::create_each_file_status(
             &self.file_specs,
             self.progress.common_data.index,
             self.common_data.reason.into(),
-        )
+        );
+        EachFileStatus::clear_uploaded(&mut statuses, &self.progress);
+        statuses
     }
 
     /// Builds a `NotifyData` object for status notifications.
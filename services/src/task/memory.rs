@@ -0,0 +1,164 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! In-memory downloads.
+//!
+//! A download with a `memory_limit` keeps its body in an anonymous memory
+//! file instead of a file of the app, so the file system is never touched.
+//! The download itself runs as usual on that file, resumes included. Once it
+//! completes, the body is sent to the client over its channel right before
+//! the completed notification, which carries it to the app.
+
+use std::ffi::CString;
+use std::fs::File;
+use std::io::{self, Read, Seek, SeekFrom};
+use std::os::fd::FromRawFd;
+use std::os::raw::{c_char, c_int, c_uint};
+use std::sync::{Arc, Mutex};
+
+use super::reason::Reason;
+use super::request_task::TaskError;
+use crate::task::config::{Action, TaskConfig};
+use crate::task::request_task::RequestTask;
+use crate::task::task_control;
+use crate::utils::memory_budget::BUDGET;
+
+/// Largest body kept in memory, higher limits of tasks are lowered to it.
+pub(crate) const MEMORY_LIMIT_MAX: u32 = 1024 * 1024;
+
+/// Message of the error a download fails with when its body exceeds the
+/// memory limit.
+pub(crate) const BODY_TOO_LARGE_MESSAGE: &str = "Body exceeds the memory limit";
+
+/// Closes the memory file on exec.
+const MFD_CLOEXEC: c_uint = 1;
+
+extern "C" {
+    fn memfd_create(name: *const c_char, flags: c_uint) -> c_int;
+}
+
+/// Returns the limit of the body of a task kept in memory, `None` if the
+/// task is not an in-memory download.
+pub(crate) fn limit(config: &TaskConfig) -> Option<u64> {
+    if config.common_data.action != Action::Download || config.common_data.memory_limit == 0 {
+        return None;
+    }
+    Some(config.common_data.memory_limit.min(MEMORY_LIMIT_MAX) as u64)
+}
+
+/// Opens the anonymous memory file holding the body of a task.
+pub(crate) fn open_body(task_id: u32) -> io::Result<File> {
+    let name = CString::new(format!("request-{}", task_id))?;
+    // SAFETY: `name` is a valid C string for the duration of the call.
+    let fd = unsafe { memfd_create(name.as_ptr(), MFD_CLOEXEC) };
+    if fd < 0 {
+        return Err(io::Error::last_os_error());
+    }
+    // SAFETY: `fd` was just created and is owned by nobody else.
+    Ok(unsafe { File::from_raw_fd(fd) })
+}
+
+/// Reads a body of at most `limit` bytes from its memory file, `None` if it
+/// is longer.
+async fn read_body(file: Arc<Mutex<File>>, limit: u64) -> io::Result<Option<Vec<u8>>> {
+    task_control::runtime_spawn_blocking(move || {
+        let mut file = file.lock().unwrap();
+        let len = file.seek(SeekFrom::End(0))?;
+        if len > limit {
+            return Ok(None);
+        }
+        let mut body = Vec::with_capacity(len as usize);
+        file.seek(SeekFrom::Start(0))?;
+        file.read_to_end(&mut body)?;
+        Ok(Some(body))
+    })
+    .await
+    .map_err(|e| io::Error::new(io::ErrorKind::Other, e))?
+}
+
+impl RequestTask {
+    /// Returns the limit of the body kept in memory, `None` if the task
+    /// downloads to a file.
+    pub(crate) fn memory_limit(&self) -> Option<u64> {
+        limit(&self.conf)
+    }
+
+    /// Checks the announced length of the body against the memory limit
+    /// before any of it is received.
+    ///
+    /// # Errors
+    ///
+    /// Returns `TaskError::Failed(Reason::BodyTooLarge)` if the body cannot
+    /// fit.
+    pub(crate) fn check_memory_limit(&self, total: u64) -> Result<(), TaskError> {
+        match self.memory_limit() {
+            Some(limit) if total > limit => {
+                error!(
+                    "task {} body of {} exceeds memory limit {}",
+                    self.task_id(),
+                    total,
+                    limit
+                );
+                Err(TaskError::Failed(Reason::BodyTooLarge))
+            }
+            _ => Ok(()),
+        }
+    }
+
+    /// Sends the body of a completed in-memory download to the client.
+    ///
+    /// The body is queued on the channel of the client before the completed
+    /// notification, which the client attaches it to.
+    ///
+    /// # Errors
+    ///
+    /// Returns `TaskError::Failed(Reason::BodyTooLarge)` if the body exceeds
+    /// the memory limit, and `TaskError::Failed(Reason::IoError)` if it
+    /// cannot be read.
+    pub(crate) async fn deliver_body(&self) -> Result<(), TaskError> {
+        let Some(limit) = self.memory_limit() else {
+            return Ok(());
+        };
+        let Some(file) = self.files.get(0) else {
+            error!("task {} deliver body err, no file", self.task_id());
+            return Err(TaskError::Failed(Reason::OthersError));
+        };
+        // The body stays in memory until the client handler sent it
+        let reservation = BUDGET.reserve(limit as usize).await;
+        let body = read_body(file, limit).await.map_err(|e| {
+            error!("task {} read body failed {}", self.task_id(), e);
+            TaskError::Failed(Reason::IoError)
+        })?;
+        let Some(body) = body else {
+            error!(
+                "task {} body exceeds memory limit {}",
+                self.task_id(),
+                limit
+            );
+            return Err(TaskError::Failed(Reason::BodyTooLarge));
+        };
+        info!(
+            "task {} delivers {} bytes in memory",
+            self.task_id(),
+            body.len()
+        );
+        self.client_manager
+            .send_body(self.task_id(), body, reservation);
+        Ok(())
+    }
+}
+
+#[cfg(test)]
+mod ut_memory {
+    include!("../../tests/ut/task/ut_memory.rs");
+}
@@ -23,12 +23,33 @@ pub mod config;
 pub mod info;
 
 // Internal modules for task implementation
+mod checksum;                 // Integrity verification of downloads
+mod coalesce;                 // Downloads sharing one transfer
+pub(crate) mod cpu;           // CPU time of the tasks
+mod delta;                    // Delta downloads of files downloaded again
+mod extract;                  // Archives extracted while they download
+pub(crate) mod dns;           // DNS cache of the clients
+pub(crate) mod handoff;       // Bodies handed over by preloads
 pub(crate) mod download;     // Download task handling
+mod file_io;                  // File I/O off the runtime workers
 pub(crate) mod files;         // File management utilities
+mod memory;                   // In-memory downloads
+mod multipart;                // Multipart form bodies of uploads
+#[cfg(feature = "oh")]
+mod netstack;                 // Downloads sent with the netstack
 pub(crate) mod notify;        // Notification and event handling
 mod operator;                 // Task operation implementations
+mod origin;                   // Health of the origins of tasks
+pub(crate) mod performance;   // Transport timings of attempts
+mod processed;                // Lock-free processed bytes
 pub(crate) mod reason;        // Error and state reason codes
+mod redirect;                 // Redirects followed by downloads
 pub(crate) mod request_task;  // Core task abstraction
+mod segment;                  // Segmented parallel downloads
+mod stall;                    // Stall detection of downloads
+pub(crate) mod timeline;      // Performance timeline of tasks
+mod throughput;               // Throughput estimation of tasks
+mod transport;                // HTTP clients of the downloads
 
 /// Constant representing atomic service identifier.
 pub(crate) const ATOMIC_SERVICE: u32 = 1;
@@ -36,6 +57,7 @@ pub(crate) const ATOMIC_SERVICE: u32 = 1;
 // Additional internal modules
 pub(crate) mod bundle;          // Bundle-related utilities
 pub(crate) mod client;          // Client connection management
+pub(crate) mod client_pool;     // Clients shared by tasks
 pub(crate) mod ffi;             // Foreign function interface bindings
 pub(crate) mod speed_limiter;   // Speed limiting implementation
 pub(crate) mod task_control;    // Task control mechanisms
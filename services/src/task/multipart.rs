@@ -0,0 +1,245 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Multipart form bodies of uploads (RFC 7578).
+//!
+//! The body is planned before it is sent: the boundaries, the headers of the
+//! parts and the form values are encoded once into buffers, and the files
+//! are read in place between them. Its length is then known from the sizes
+//! of the files, so it is sent with a `Content-Length` rather than in
+//! chunks, which some servers and proxies buffer whole before forwarding.
+
+use std::collections::hash_map::RandomState;
+use std::future::Future;
+use std::hash::{BuildHasher, Hasher};
+use std::io;
+use std::pin::Pin;
+use std::task::{Context, Poll};
+
+use ylong_http_client::ReusableReader;
+use ylong_runtime::io::{AsyncRead, ReadBuf};
+
+use crate::utils::get_current_timestamp;
+
+/// Piece of a multipart body.
+enum Segment<R> {
+    /// Encoded boundaries, headers and form values.
+    Bytes(Vec<u8>),
+    /// Content of a file, `len` bytes read from `reader`.
+    Stream { reader: R, len: u64, read: u64 },
+}
+
+/// Multipart form body made of encoded buffers and the readers of files.
+pub(crate) struct MultipartBody<R> {
+    boundary: String,
+    segments: Vec<Segment<R>>,
+    /// Segment being sent, `segments.len()` for the closing delimiter.
+    current: usize,
+    /// Bytes of the buffer being sent already sent.
+    offset: usize,
+    closing: Vec<u8>,
+}
+
+/// Returns a boundary unlikely to occur in the parts of a body.
+pub(crate) fn boundary() -> String {
+    let mut hasher = RandomState::new().build_hasher();
+    hasher.write_u64(get_current_timestamp());
+    format!("----RequestFormBoundary{:016x}", hasher.finish())
+}
+
+/// Escapes a name or file name for a quoted header parameter, as browsers
+/// do.
+fn quote(value: &str) -> String {
+    value
+        .replace('"', "%22")
+        .replace('\r', "%0D")
+        .replace('\n', "%0A")
+}
+
+impl<R> MultipartBody<R> {
+    /// Creates an empty body whose parts are separated by `boundary`.
+    pub(crate) fn new(boundary: String) -> Self {
+        let closing = format!("\r\n--{}--\r\n", boundary).into_bytes();
+        Self {
+            boundary,
+            segments: Vec::new(),
+            current: 0,
+            offset: 0,
+            closing,
+        }
+    }
+
+    /// Appends encoded bytes, to the previous buffer if it is one.
+    fn push_bytes(&mut self, bytes: &[u8]) {
+        match self.segments.last_mut() {
+            Some(Segment::Bytes(buf)) => buf.extend_from_slice(bytes),
+            _ => self.segments.push(Segment::Bytes(bytes.to_vec())),
+        }
+    }
+
+    /// Appends the delimiter and the headers of a part.
+    fn push_headers(&mut self, headers: &str) {
+        // The line break before a delimiter belongs to it
+        let delimiter = match self.segments.is_empty() {
+            true => format!("--{}\r\n", self.boundary),
+            false => format!("\r\n--{}\r\n", self.boundary),
+        };
+        self.push_bytes(delimiter.as_bytes());
+        self.push_bytes(headers.as_bytes());
+    }
+
+    /// Appends a form field.
+    pub(crate) fn text(mut self, name: &str, value: &str) -> Self {
+        self.push_headers(&format!(
+            "Content-Disposition: form-data; name=\"{}\"\r\n\r\n",
+            quote(name)
+        ));
+        self.push_bytes(value.as_bytes());
+        self
+    }
+
+    /// Appends a file of `len` bytes read from `reader`, without a
+    /// `Content-Type` if `mime` is empty.
+    pub(crate) fn file(
+        mut self,
+        name: &str,
+        file_name: &str,
+        mime: &str,
+        len: u64,
+        reader: R,
+    ) -> Self {
+        let mut headers = format!(
+            "Content-Disposition: form-data; name=\"{}\"; filename=\"{}\"\r\n",
+            quote(name),
+            quote(file_name)
+        );
+        if !mime.is_empty() {
+            headers.push_str(&format!("Content-Type: {}\r\n", mime));
+        }
+        headers.push_str("\r\n");
+        self.push_headers(&headers);
+        self.segments.push(Segment::Stream {
+            reader,
+            len,
+            read: 0,
+        });
+        self
+    }
+
+    /// Returns the `Content-Type` of the body.
+    pub(crate) fn content_type(&self) -> String {
+        format!("multipart/form-data; boundary={}", self.boundary)
+    }
+
+    /// Returns the length of the body in bytes.
+    pub(crate) fn len(&self) -> u64 {
+        let parts = self
+            .segments
+            .iter()
+            .map(|segment| match segment {
+                Segment::Bytes(buf) => buf.len() as u64,
+                Segment::Stream { len, .. } => *len,
+            })
+            .sum::<u64>();
+        parts + self.closing.len() as u64
+    }
+}
+
+/// Copies the rest of `bytes` from `offset` to `buf`, returning the number
+/// of bytes copied.
+fn copy_bytes(bytes: &[u8], offset: &mut usize, buf: &mut ReadBuf<'_>) -> usize {
+    let unfilled = buf.initialize_unfilled();
+    let size = unfilled.len().min(bytes.len() - *offset);
+    unfilled[..size].copy_from_slice(&bytes[*offset..*offset + size]);
+    *offset += size;
+    let filled = buf.filled().len() + size;
+    buf.set_filled(filled);
+    size
+}
+
+impl<R: AsyncRead + Unpin> AsyncRead for MultipartBody<R> {
+    /// Reads the next bytes of the body, straight from the buffer or the file
+    /// of the segment being sent.
+    ///
+    /// # Errors
+    ///
+    /// Returns `UnexpectedEof` if a file ends before its length.
+    fn poll_read(
+        self: Pin<&mut Self>,
+        cx: &mut Context<'_>,
+        buf: &mut ReadBuf<'_>,
+    ) -> Poll<io::Result<()>> {
+        let this = self.get_mut();
+        loop {
+            let Some(segment) = this.segments.get_mut(this.current) else {
+                if this.offset < this.closing.len() {
+                    copy_bytes(&this.closing, &mut this.offset, buf);
+                }
+                return Poll::Ready(Ok(()));
+            };
+            match segment {
+                Segment::Bytes(bytes) if this.offset < bytes.len() => {
+                    copy_bytes(bytes, &mut this.offset, buf);
+                    return Poll::Ready(Ok(()));
+                }
+                Segment::Stream { reader, len, read } if *read < *len => {
+                    let size = {
+                        let unfilled = buf.initialize_unfilled();
+                        let limit = (unfilled.len() as u64).min(*len - *read) as usize;
+                        let mut part = ReadBuf::new(&mut unfilled[..limit]);
+                        match Pin::new(reader).poll_read(cx, &mut part) {
+                            Poll::Ready(Ok(())) => part.filled().len(),
+                            other => return other,
+                        }
+                    };
+                    if size == 0 {
+                        return Poll::Ready(Err(io::ErrorKind::UnexpectedEof.into()));
+                    }
+                    *read += size as u64;
+                    let filled = buf.filled().len() + size;
+                    buf.set_filled(filled);
+                    return Poll::Ready(Ok(()));
+                }
+                _ => {
+                    this.current += 1;
+                    this.offset = 0;
+                }
+            }
+        }
+    }
+}
+
+impl<R: ReusableReader + Send + Sync> ReusableReader for MultipartBody<R> {
+    /// Starts the body over, the readers of the files being reused.
+    fn reuse<'a>(&'a mut self) -> Pin<Box<dyn Future<Output = io::Result<()>> + Send + Sync + 'a>>
+    where
+        Self: 'a,
+    {
+        self.current = 0;
+        self.offset = 0;
+        Box::pin(async move {
+            for segment in self.segments.iter_mut() {
+                if let Segment::Stream { reader, read, .. } = segment {
+                    *read = 0;
+                    reader.reuse().await?;
+                }
+            }
+            Ok(())
+        })
+    }
+}
+
+#[cfg(test)]
+mod ut_multipart {
+    include!("../../tests/ut/task/ut_multipart.rs");
+}
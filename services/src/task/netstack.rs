@@ -0,0 +1,412 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Downloads sent with the netstack of the system.
+//!
+//! The netstack calls back on its own threads, which only pass what they
+//! receive to the runtime task of the download through a channel. The body
+//! is written by the same `TaskOperator` as with ylong_http_client, so the
+//! buffering, speed limits and progress of a task do not depend on its
+//! client. The netstack cannot be paused: while a speed limit or a slow disk
+//! holds the body back, the chunks wait in the channel.
+
+use std::collections::HashMap;
+use std::future::poll_fn;
+use std::sync::atomic::{AtomicBool, Ordering};
+use std::sync::{Arc, OnceLock};
+use std::time::Duration;
+
+use netstack_rs::error::{HttpClientError, HttpErrorCode};
+use netstack_rs::info::{DownloadInfo, DownloadInfoMgr};
+use netstack_rs::request::{Request, RequestCallback};
+use netstack_rs::response::Response;
+use netstack_rs::task::RequestTask as NetstackTask;
+use request_utils::task_id::TaskId;
+use ylong_runtime::sync::mpsc::{unbounded_channel, UnboundedSender};
+
+use super::download::finish_file;
+use super::memory::BODY_TOO_LARGE_MESSAGE;
+use super::operator::TaskOperator;
+use super::reason::Reason;
+use super::request_task::{RequestTask, TaskError, TaskPhase};
+use super::transport::TransportHandle;
+use crate::manage::database::RequestDb;
+use crate::task::client::connection_timeout;
+use crate::task::client_pool::ClientPool;
+use crate::task::task_control;
+use crate::task::timeline::{Phase, Timelines};
+use crate::utils::{get_current_duration, get_current_timestamp};
+
+/// Interval the abort flag of a task is checked at while no event arrives.
+const ABORT_CHECK_INTERVAL: Duration = Duration::from_millis(200);
+
+/// What the netstack reports of a download.
+enum Event {
+    /// The status and headers of the response, before its body.
+    Head {
+        status: u32,
+        headers: HashMap<String, String>,
+    },
+    /// A chunk of the body.
+    Data(Vec<u8>),
+    /// The download ended.
+    Done(Result<(), HttpClientError>),
+    /// The download was cancelled.
+    Cancelled,
+    /// The netstack retried the download from its first byte.
+    Restarted,
+}
+
+/// Callback of the netstack passing its events to the download.
+struct EventSender {
+    tx: UnboundedSender<Event>,
+    head_sent: bool,
+}
+
+impl EventSender {
+    fn send(&self, event: Event) {
+        // The download stopped waiting, nothing is left to tell
+        let _ = self.tx.send(event);
+    }
+
+    fn send_head(&mut self, status: u32, headers: HashMap<String, String>) {
+        if !self.head_sent {
+            self.head_sent = true;
+            self.send(Event::Head { status, headers });
+        }
+    }
+}
+
+impl RequestCallback for EventSender {
+    fn on_success(&mut self, response: Response) {
+        // A body without data calls back no chunk to carry the head
+        self.send_head(response.status() as u32, response.headers());
+        self.send(Event::Done(Ok(())));
+    }
+
+    fn on_fail(&mut self, error: HttpClientError, _info: DownloadInfo) {
+        self.send(Event::Done(Err(error)));
+    }
+
+    fn on_cancel(&mut self) {
+        self.send(Event::Cancelled);
+    }
+
+    fn on_data_receive(&mut self, data: &[u8], mut task: NetstackTask) {
+        if !self.head_sent {
+            let status = task.response().status() as u32;
+            self.send_head(status, task.headers());
+        }
+        self.send(Event::Data(data.to_vec()));
+    }
+
+    fn on_restart(&mut self) {
+        self.send(Event::Restarted);
+    }
+}
+
+/// Netstack download cancelled when its handle is dropped before it ends.
+struct CancelHandle {
+    inner: NetstackTask,
+    done: AtomicBool,
+}
+
+impl CancelHandle {
+    /// Records that the download ended, it is no longer cancelled.
+    fn finished(&self) {
+        self.done.store(true, Ordering::Release);
+    }
+}
+
+impl TransportHandle for CancelHandle {
+    fn cancel(&self) {
+        if !self.done.swap(true, Ordering::AcqRel) {
+            self.inner.cancel();
+        }
+    }
+}
+
+impl Drop for CancelHandle {
+    fn drop(&mut self) {
+        self.cancel();
+    }
+}
+
+/// Returns the manager of the timings of the netstack downloads.
+fn info_mgr() -> Arc<DownloadInfoMgr> {
+    static MGR: OnceLock<Arc<DownloadInfoMgr>> = OnceLock::new();
+    MGR.get_or_init(|| Arc::new(DownloadInfoMgr::new())).clone()
+}
+
+/// Downloads the file of a task with the netstack.
+///
+/// A task with bytes in its file and a validator asks for the rest of the
+/// body with `Range` and `If-Range`, its file is cleared otherwise.
+///
+/// # Errors
+///
+/// Returns a `TaskError` as `download_inner` does for the same failure.
+pub(crate) async fn download(
+    task: Arc<RequestTask>,
+    abort_flag: Arc<AtomicBool>,
+) -> Result<(), TaskError> {
+    task.prepare_download().await?;
+    info!("{} downloading over netstack", task.task_id());
+    let resumed = task.resume_point().await?;
+    task.start_time
+        .store(get_current_duration().as_secs(), Ordering::SeqCst);
+
+    task.wait_for_origin(&abort_flag).await?;
+    let Some(_slot) = ClientPool::get_instance()
+        .host_slot(&task.conf.url, &abort_flag)
+        .await
+    else {
+        return Err(TaskError::Waiting(TaskPhase::UserAbort));
+    };
+
+    let (tx, mut rx) = unbounded_channel();
+    let sent = get_current_timestamp();
+    let handle = start(&task, resumed, tx)?;
+    let mut operator = TaskOperator::new(task.clone(), abort_flag.clone());
+    loop {
+        let event = match ylong_runtime::time::timeout(ABORT_CHECK_INTERVAL, rx.recv()).await {
+            Ok(Ok(event)) => event,
+            Ok(Err(_)) => {
+                error!("task {} netstack callback dropped", task.task_id());
+                return Err(TaskError::Failed(Reason::OthersError));
+            }
+            Err(_) if abort_flag.load(Ordering::Acquire) => {
+                return Err(TaskError::Waiting(TaskPhase::UserAbort));
+            }
+            Err(_) => continue,
+        };
+        match event {
+            Event::Head { status, headers } => {
+                let ttfb = get_current_timestamp().saturating_sub(sent);
+                task.start_body(status, headers, resumed, ttfb).await?;
+            }
+            Event::Data(data) => {
+                let res = match poll_fn(|cx| operator.poll_write_file(cx, &data, 0)).await {
+                    Ok(_) => poll_fn(|cx| operator.poll_progress_common(cx)).await,
+                    Err(e) => Err(e),
+                };
+                if let Err(e) = res {
+                    if format!("{}", e).contains(BODY_TOO_LARGE_MESSAGE) {
+                        error!("task {} body exceeds memory limit", task.task_id());
+                        return Err(TaskError::Failed(Reason::BodyTooLarge));
+                    }
+                    return task.handle_download_error(e).await;
+                }
+            }
+            Event::Done(res) => {
+                handle.finished();
+                match res {
+                    Ok(()) => break,
+                    Err(e) => return Err(task.netstack_error(e).await),
+                }
+            }
+            Event::Cancelled => return Err(TaskError::Waiting(TaskPhase::UserAbort)),
+            Event::Restarted => {
+                // The next try resumes from the bytes written instead
+                info!("task {} netstack restarted, retries", task.task_id());
+                return Err(TaskError::Waiting(TaskPhase::NeedRetry));
+            }
+        }
+    }
+    if let Err(e) = poll_fn(|cx| operator.poll_flush(cx)).await {
+        return task.handle_download_error(e).await;
+    }
+    // Dropping the operator writes the data it still buffers
+    drop(operator);
+    task.record_transfer();
+    finish_file(&task).await
+}
+
+/// Builds and starts the netstack request of a task.
+fn start(
+    task: &RequestTask,
+    resumed: u64,
+    tx: UnboundedSender<Event>,
+) -> Result<CancelHandle, TaskError> {
+    let mut request = Request::new();
+    request
+        .url(&task.conf.url)
+        .method("GET")
+        .connect_timeout((connection_timeout(&task.conf) * 1000) as u32)
+        // The rest time of the task bounds the whole download
+        .timeout(0);
+    for (key, value) in task.conf.headers.iter() {
+        request.header(key, value);
+    }
+    if resumed > 0 {
+        let progress = task.progress.lock().unwrap();
+        let validator = progress
+            .extras
+            .get("etag")
+            .or_else(|| progress.extras.get("last-modified"));
+        if let Some(validator) = validator {
+            request.header("If-Range", validator);
+        }
+        request.header("Range", &format!("bytes={}-", resumed));
+    }
+    request
+        .callback(EventSender {
+            tx,
+            head_sent: false,
+        })
+        .info_mgr(info_mgr())
+        .task_id(TaskId::new(task.task_id().to_string()));
+    let Some(mut inner) = request.build() else {
+        error!("task {} netstack request build failed", task.task_id());
+        return Err(TaskError::Failed(Reason::RequestError));
+    };
+    if !inner.start() {
+        error!("task {} netstack request start failed", task.task_id());
+        return Err(TaskError::Failed(Reason::OthersError));
+    }
+    Ok(CancelHandle {
+        inner,
+        done: AtomicBool::new(false),
+    })
+}
+
+impl RequestTask {
+    /// Returns the byte the download resumes from, the file being cleared if
+    /// it cannot be resumed.
+    async fn resume_point(self: &Arc<Self>) -> Result<u64, TaskError> {
+        let downloaded = self.processed.file(0) as u64;
+        if downloaded == 0 {
+            return Ok(0);
+        }
+        let resumable = {
+            let progress = self.progress.lock().unwrap();
+            progress.extras.contains_key("etag") || progress.extras.contains_key("last-modified")
+        };
+        if resumable {
+            return Ok(downloaded);
+        }
+        info!("task {} not support range", self.task_id());
+        task_control::clear_downloaded_file(self.clone()).await?;
+        Ok(0)
+    }
+
+    /// Checks the response of a netstack download and prepares the file for
+    /// its body.
+    ///
+    /// # Errors
+    ///
+    /// Returns `TaskError::Failed(Reason::ProtocolError)` for a status other
+    /// than 2xx, `TaskError::Waiting(TaskPhase::NeedRetry)` for the first two
+    /// `408`s, or the error preparing the file.
+    async fn start_body(
+        self: &Arc<Self>,
+        status: u32,
+        headers: HashMap<String, String>,
+        resumed: u64,
+        ttfb: u64,
+    ) -> Result<(), TaskError> {
+        Timelines::get_instance().record(self.task_id(), Phase::Response { status, ttfb });
+        info!("{} response {} over netstack", self.task_id(), status);
+        if status == 408 && self.timeout_tries.fetch_add(1, Ordering::SeqCst) < 2 {
+            return Err(TaskError::Waiting(TaskPhase::NeedRetry));
+        }
+        if !(200..300).contains(&status) {
+            return Err(TaskError::Failed(Reason::ProtocolError));
+        }
+        self.timeout_tries.store(0, Ordering::SeqCst);
+        // A changed body comes back whole despite `If-Range`
+        if status == 200 && resumed > 0 {
+            info!("task {} body changed, downloads again", self.task_id());
+            task_control::clear_downloaded_file(self.clone()).await?;
+        }
+
+        if let Some(mime_type) = headers.get("content-type") {
+            *self.mime_type.lock().unwrap() = mime_type.clone();
+        }
+        let length = headers
+            .get("content-length")
+            .and_then(|v| v.parse::<i64>().ok());
+        match length {
+            Some(length) => {
+                let total = length + self.processed.file(0) as i64;
+                self.file_total_size.store(length, Ordering::SeqCst);
+                self.progress.lock().unwrap().sizes = vec![total];
+            }
+            None if self.conf.common_data.precise => {
+                error!("cannot get content-length of the task {}", self.task_id());
+                return Err(TaskError::Failed(Reason::GetFileSizeFailed));
+            }
+            None => {}
+        }
+        self.progress.lock().unwrap().extras = headers;
+
+        if let Ok(rest) = u64::try_from(self.file_total_size.load(Ordering::SeqCst)) {
+            self.check_memory_limit(rest + self.processed.file(0) as u64)?;
+        }
+        self.preallocate_file().await?;
+        self.start_digest().await?;
+        self.update_progress_in_database();
+        RequestDb::get_instance()
+            .update_task_sizes(self.task_id(), &self.progress.lock().unwrap().sizes);
+        Ok(())
+    }
+
+    /// Maps a failure of the netstack to the error of the task, retrying
+    /// the failures of the network as ylong_http_client ones are.
+    async fn netstack_error(&self, error: HttpClientError) -> TaskError {
+        error!(
+            "Task {} netstack {:?} {}",
+            self.task_id(),
+            error.code(),
+            error.msg()
+        );
+        let reason = match error.code() {
+            // Statuses other than 2xx are failures without an error code
+            HttpErrorCode::HttpNoneErr => Reason::ProtocolError,
+            HttpErrorCode::HttpUnsupportedProtocol | HttpErrorCode::HttpUrlMalformat => {
+                Reason::RequestError
+            }
+            HttpErrorCode::HttpTooManyRedirects => Reason::RedirectError,
+            HttpErrorCode::HttpOperationTimedout => Reason::ContinuousTaskTimeout,
+            HttpErrorCode::HttpCouldntResolveProxy | HttpErrorCode::HttpCouldntResolveHost => {
+                Reason::Dns
+            }
+            HttpErrorCode::HttpCouldntConnect => Reason::Tcp,
+            HttpErrorCode::HttpSslCertproblem
+            | HttpErrorCode::HttpSslCipher
+            | HttpErrorCode::HttpPeerFailedVerification
+            | HttpErrorCode::HttpSslCacertBadfile
+            | HttpErrorCode::HttpSslPinnedpubkeynotmatch => Reason::Ssl,
+            HttpErrorCode::HttpTaskCanceled => {
+                return TaskError::Waiting(TaskPhase::UserAbort);
+            }
+            _ => Reason::OthersError,
+        };
+        let network = matches!(
+            reason,
+            Reason::Dns | Reason::Tcp | Reason::Ssl | Reason::OthersError
+        );
+        if network {
+            if let Err(e) = self.network_retry().await {
+                return e;
+            }
+        }
+        TaskError::Failed(reason)
+    }
+}
+
+// Built by the `rust_request_transport_benchmark` target only.
+#[cfg(all(test, transport_bench))]
+mod bench_transport {
+    include!("../../tests/bench/bench_transport.rs");
+}
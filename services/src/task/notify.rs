@@ -52,6 +52,8 @@ pub(crate) enum WaitingCause {
     AppState,
     /// Task is waiting due to user state constraints.
     UserState,
+    /// Task is waiting for its origin to be reachable again.
+    Origin,
 }
 
 /// Contains task notification data sent to subscribers.
@@ -79,7 +81,9 @@ pub(crate) struct NotifyData {
 pub(crate) struct CommonProgress {
     /// Current state of the task as a raw byte value.
     pub(crate) state: u8,
-    /// Index of the current file being processed.
+    /// Index of the current file being processed. Files of an upload sent at
+    /// the same time complete out of order, the index is then the first file
+    /// not uploaded yet and `processed` tells the progress of every file.
     pub(crate) index: usize,
     /// Total number of bytes processed across all files.
     pub(crate) total_processed: usize,
@@ -97,6 +101,12 @@ pub(crate) struct Progress {
     pub(crate) processed: Vec<usize>,
     /// Additional progress-related parameters.
     pub(crate) extras: HashMap<String, String>,
+    /// Average speed of the running task in bytes per second, 0 otherwise.
+    /// Not persisted.
+    pub(crate) speed: u64,
+    /// Estimated seconds left of the running task, -1 if unknown. Not
+    /// persisted.
+    pub(crate) eta: i64,
 }
 
 /// Status information for an individual file in a multi-file task.
@@ -139,6 +149,20 @@ impl EachFileStatus {
         }
         vec
     }
+
+    /// Clears the reason of the files after the index of `progress` that were
+    /// uploaded completely, as files uploaded at the same time can be.
+    pub(crate) fn clear_uploaded(statuses: &mut [EachFileStatus], progress: &Progress) {
+        let index = progress.common_data.index;
+        for (i, status) in statuses.iter_mut().enumerate().skip(index + 1) {
+            let size = progress.sizes.get(i).copied().unwrap_or(0);
+            let processed = progress.processed.get(i).copied().unwrap_or(0);
+            if size > 0 && processed as i64 == size {
+                status.reason = Reason::Default;
+                status.message = Reason::Default.to_str().into();
+            }
+        }
+    }
 }
 
 impl Progress {
@@ -160,6 +184,8 @@ impl Progress {
             sizes,
             processed: vec![0; len],
             extras: HashMap::<String, String>::new(),
+            speed: 0,
+            eta: -1,
         }
     }
 
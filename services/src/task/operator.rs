@@ -17,22 +17,43 @@
 //! progress tracking, notifications, and file writing operations.
 
 use std::cmp::min;
-use std::io::Write;
+use std::future::Future;
+use std::io::{Seek, Write};
+use std::mem;
+use std::pin::Pin;
 use std::sync::atomic::{AtomicBool, Ordering};
 use std::sync::Arc;
 use std::task::{Context, Poll};
 
+use request_utils::compress::ContentDecoder;
 use ylong_http_client::HttpClientError;
 
 use crate::manage::notifier::Notifier;
 use crate::service::notification_bar::{NotificationDispatcher, NOTIFY_PROGRESS_INTERVAL};
+use crate::task::cpu::{self, Path, TaskCpu};
+use crate::task::file_io::{self, Submission};
+use crate::task::memory::BODY_TOO_LARGE_MESSAGE;
 use crate::task::request_task::RequestTask;
 use crate::task::speed_limiter::SpeedLimiter;
-use crate::utils::get_current_timestamp;
+use crate::task::stall::{StallDetector, STALL_MESSAGE};
+use crate::task::task_control;
+use crate::task::timeline::{Phase, Timelines};
+use crate::utils::memory_budget::{Reservation, BUDGET};
+use crate::utils::{get_current_timestamp, metrics};
 
 /// Interval in milliseconds for frontend progress notifications.
 const FRONT_NOTIFY_INTERVAL: u64 = 1000;
 
+/// Downloaded bytes buffered before they are written to the file.
+const WRITE_BUFFER_SIZE: usize = 512 * 1024;
+
+/// Maximum time in milliseconds downloaded bytes stay buffered.
+const WRITE_FLUSH_INTERVAL: u64 = 200;
+
+/// Progress extra holding the bytes a task received over the network, set
+/// for the tasks decoding their body.
+pub(crate) const WIRE_BYTES_EXTRA: &str = "wire-bytes";
+
 /// Task operator that handles task execution operations.
 /// 
 /// This struct manages the execution of download and upload tasks,
@@ -44,6 +65,57 @@ pub(crate) struct TaskOperator {
     pub(crate) speed_limiter: SpeedLimiter,
     /// Flag to signal task abortion requests.
     pub(crate) abort_flag: Arc<AtomicBool>,
+    /// Downloaded bytes not yet written to the file.
+    buffer: Vec<u8>,
+    /// Memory budget reserved for the buffer, released once it is written.
+    reservation: Option<Reservation>,
+    /// Size and completion of the buffer being written on the blocking pool.
+    writing: Option<(usize, Submission<()>)>,
+    /// Time in milliseconds of the last buffer flush.
+    flushed_at: u64,
+    /// Stall detection of the connection, if it can be resumed.
+    stall_detector: Option<StallDetector>,
+    /// Whether the first write was recorded in the timeline of the task.
+    written: bool,
+    /// Decoder of an encoded body and the flag set once its data is complete.
+    decoder: Option<(ContentDecoder, Arc<AtomicBool>)>,
+    /// Limit of the body of an in-memory download.
+    memory_limit: Option<u64>,
+    /// CPU of the task, charged by its writes.
+    cpu: Arc<TaskCpu>,
+}
+
+impl RequestTask {
+    /// Sends the progress of the task to its listeners once per
+    /// `FRONT_NOTIFY_INTERVAL`, and to the notification bar once per
+    /// `NOTIFY_PROGRESS_INTERVAL` if the task shows one.
+    ///
+    /// # Arguments
+    ///
+    /// * `current` - The current time in milliseconds.
+    pub(crate) fn publish_progress(&self, current: u64) {
+        // Check if it's time to send frontend notification
+        let next_notify_time = self.last_notify.load(Ordering::SeqCst) + FRONT_NOTIFY_INTERVAL;
+
+        if current >= next_notify_time {
+            let transferred = self.transferred.load(Ordering::Acquire);
+            self.throughput.lock().unwrap().sample(current, transferred);
+            // Build and send notification data
+            let notify_data = self.build_notify_data();
+            self.last_notify.store(current, Ordering::SeqCst);
+            Notifier::progress(&self.client_manager, notify_data);
+            Timelines::get_instance().sample(self.task_id(), transferred);
+        }
+
+        // Check if background notification should be sent
+        if self.background_notify.load(Ordering::Acquire)
+            && current
+                > self.background_notify_time.load(Ordering::SeqCst) + NOTIFY_PROGRESS_INTERVAL
+        {
+            self.background_notify_time.store(current, Ordering::SeqCst);
+            NotificationDispatcher::get_instance().publish_progress_notification(self);
+        }
+    }
 }
 
 impl TaskOperator {
@@ -54,13 +126,38 @@ impl TaskOperator {
     /// * `task` - The task to operate on.
     /// * `abort_flag` - Flag to signal task abortion requests.
     pub(crate) fn new(task: Arc<RequestTask>, abort_flag: Arc<AtomicBool>) -> Self {
+        let memory_limit = task.memory_limit();
+        let cpu = cpu::of(&task);
         Self {
             task,
             speed_limiter: SpeedLimiter::default(),
             abort_flag,
+            buffer: Vec::new(),
+            reservation: None,
+            writing: None,
+            flushed_at: get_current_timestamp(),
+            stall_detector: None,
+            written: false,
+            decoder: None,
+            memory_limit,
+            cpu,
         }
     }
 
+    /// Fails the connection with `STALL_MESSAGE` once its throughput falls
+    /// below the stall threshold of the task.
+    pub(crate) fn detect_stall(mut self, detector: StallDetector) -> Self {
+        self.stall_detector = Some(detector);
+        self
+    }
+
+    /// Writes the body decoded by `decoder`, `complete` is set once the
+    /// encoded data received is complete.
+    pub(crate) fn decode(mut self, decoder: ContentDecoder, complete: Arc<AtomicBool>) -> Self {
+        self.decoder = Some((decoder, complete));
+        self
+    }
+
     /// Polls for common progress updates and handles notifications.
     /// 
     /// This method checks for task abortion, sends progress notifications at appropriate
@@ -74,7 +171,8 @@ impl TaskOperator {
     /// 
     /// - `Poll::Ready(Ok(()))` if ready to continue processing.
     /// - `Poll::Pending` if the operation is blocked on speed limiting.
-    /// - `Poll::Ready(Err(HttpClientError))` if the task was aborted.
+    /// - `Poll::Ready(Err(HttpClientError))` if the task was aborted or the
+    ///   connection stalled.
     pub(crate) fn poll_progress_common(
         &mut self,
         cx: &mut Context<'_>,
@@ -85,36 +183,10 @@ impl TaskOperator {
         }
         
         let current = get_current_timestamp();
-
-        // Check if it's time to send frontend notification
-        let next_notify_time = self.task.last_notify.load(Ordering::SeqCst) + FRONT_NOTIFY_INTERVAL;
-
-        if current >= next_notify_time {
-            // Build and send notification data
-            let notify_data = self.task.build_notify_data();
-            self.task.last_notify.store(current, Ordering::SeqCst);
-            Notifier::progress(&self.task.client_manager, notify_data);
-        }
-
-        // Check if background notification should be sent
-        if self.task.background_notify.load(Ordering::Acquire)
-            && current
-                > self.task.background_notify_time.load(Ordering::SeqCst) + NOTIFY_PROGRESS_INTERVAL
-        {
-            self.task
-                .background_notify_time
-                .store(current, Ordering::SeqCst);
-            NotificationDispatcher::get_instance().publish_progress_notification(&self.task);
-        }
+        self.task.publish_progress(current);
 
         // Apply speed limiting
-        let total_processed = self
-            .task
-            .progress
-            .lock()
-            .unwrap()
-            .common_data
-            .total_processed as u64;
+        let total_processed = self.task.transferred.load(Ordering::Acquire);
 
         let rate_limiting = self.task.rate_limiting.load(Ordering::SeqCst);
         let max_speed = self.task.max_speed.load(Ordering::SeqCst) as u64;
@@ -126,63 +198,272 @@ impl TaskOperator {
             (rate_limiting, max_speed) => min(rate_limiting, max_speed), // Use the lower value
         };
 
-        self.speed_limiter.update_speed_limit(speed_limit);
-        self.speed_limiter
-            .poll_check_limit(cx, current, total_processed)
+        if let Some(detector) = self.stall_detector.as_mut() {
+            if detector.check(current, total_processed, speed_limit) {
+                info!("task {} stalled at {}", self.task.task_id(), total_processed);
+                return Poll::Ready(Err(HttpClientError::other(STALL_MESSAGE)));
+            }
+        }
+
+        let uid = self.task.uid();
+        self.speed_limiter.poll_check_limit(
+            cx,
+            current,
+            total_processed,
+            &self.task.speed_budget,
+            uid,
+            speed_limit,
+        )
     }
 
     /// Polls for file writing operations.
-    /// 
-    /// This method writes data to the first file associated with the task
-    /// and updates progress tracking information.
-    /// 
+    ///
+    /// This method buffers data for the first file associated with the task,
+    /// decoded if the body is encoded, and submits the buffer to the blocking
+    /// pool once it holds `WRITE_BUFFER_SIZE` bytes or is older than
+    /// `WRITE_FLUSH_INTERVAL`. One buffer is written at a time: data arriving
+    /// while the previous buffer is written fills the next one, and waits
+    /// once it is full. The rest is left to `poll_flush` and the drop of the
+    /// operator. A buffer is only filled once reserved from the memory budget
+    /// of the transfers.
+    ///
     /// # Arguments
-    /// 
-    /// * `_cx` - The task context (currently unused).
+    ///
+    /// * `cx` - The task context, woken when a full buffer can be submitted
+    ///   or the memory budget has room for a buffer.
     /// * `data` - The data to write to the file.
     /// * `skip_size` - Size to add to the reported written size (for resume operations).
-    /// 
+    ///
     /// # Returns
-    /// 
+    ///
     /// - `Poll::Ready(Ok(usize))` with the total bytes written (including skip_size).
+    /// - `Poll::Pending` if the buffer is full and the previous one is still
+    ///   being written, or the memory budget is spent, `data` is not taken.
     /// - `Poll::Ready(Err(HttpClientError))` if an error occurs.
-    /// 
+    ///
     /// # Errors
-    /// 
-    /// - Returns an error if no files are associated with the task.
+    ///
     /// - Returns an error if the task was aborted.
-    /// - Returns an error if writing to the file fails.
+    /// - Returns an error if the encoded body is invalid.
+    /// - Returns an error if the body exceeds the memory limit of the task.
+    /// - Returns an error if writing the previous buffer to the file failed.
     pub(crate) fn poll_write_file(
-        &self,
-        _cx: &mut Context<'_>,
+        &mut self,
+        cx: &mut Context<'_>,
         data: &[u8],
         skip_size: usize,
     ) -> Poll<Result<usize, HttpClientError>> {
-        // Get the first file from the task
-        let file_mutex = if let Some(mutex) = self.task.files.get(0) {
-            mutex
-        } else {
-            error!("poll_write_file err, no file in the `task`");
-            return Poll::Ready(Err(HttpClientError::other("error msg")));
-        };
-        
-        let mut file = file_mutex.lock().unwrap();
+        let cpu = self.cpu.clone();
+        cpu.measure(Path::Write, || self.poll_buffer(cx, data, skip_size))
+    }
 
+    /// Buffers `data` for `poll_write_file`.
+    fn poll_buffer(
+        &mut self,
+        cx: &mut Context<'_>,
+        data: &[u8],
+        skip_size: usize,
+    ) -> Poll<Result<usize, HttpClientError>> {
         // Check for task abortion before writing
         if self.abort_flag.load(Ordering::Acquire) {
             return Poll::Ready(Err(HttpClientError::user_aborted()));
         }
-        
-        // Perform the write operation
-        match file.write(data) {
-            Ok(size) => {
-                // Update progress tracking
-                let mut progress_guard = self.task.progress.lock().unwrap();
-                progress_guard.processed[0] += size;
-                progress_guard.common_data.total_processed += size;
-                Poll::Ready(Ok(size + skip_size))
+        if self.buffer.len() >= WRITE_BUFFER_SIZE {
+            match self.poll_written(cx) {
+                Poll::Ready(Ok(())) => self.submit(),
+                Poll::Ready(Err(e)) => return Poll::Ready(Err(e)),
+                Poll::Pending => return Poll::Pending,
+            }
+        }
+        if self.reservation.is_none() {
+            match BUDGET.poll_reserve(cx, WRITE_BUFFER_SIZE) {
+                Poll::Ready(reservation) => self.reservation = Some(reservation),
+                Poll::Pending => return Poll::Pending,
+            }
+        }
+        if self.buffer.capacity() == 0 {
+            self.buffer.reserve_exact(WRITE_BUFFER_SIZE);
+        }
+        match self.decoder.as_mut() {
+            Some((decoder, complete)) => {
+                if let Err(e) = decoder.decode(data, &mut self.buffer) {
+                    error!("task {} decode body failed {}", self.task.task_id(), e);
+                    return Poll::Ready(Err(HttpClientError::other(e)));
+                }
+                complete.store(decoder.finish().is_ok(), Ordering::Release);
+            }
+            None => self.buffer.extend_from_slice(data),
+        }
+        if let Some(limit) = self.memory_limit {
+            let writing = self.writing.as_ref().map_or(0, |(size, _)| *size);
+            if (self.task.processed.file(0) + writing + self.buffer.len()) as u64 > limit {
+                return Poll::Ready(Err(HttpClientError::other(BODY_TOO_LARGE_MESSAGE)));
+            }
+        }
+        self.task
+            .transferred
+            .fetch_add(data.len() as u64, Ordering::AcqRel);
+
+        let now = get_current_timestamp();
+        if self.buffer.len() >= WRITE_BUFFER_SIZE || now >= self.flushed_at + WRITE_FLUSH_INTERVAL
+        {
+            // A buffer due while the previous one is written keeps filling.
+            match self.poll_written(cx) {
+                Poll::Ready(Ok(())) => self.submit(),
+                Poll::Ready(Err(e)) => return Poll::Ready(Err(e)),
+                Poll::Pending => {}
+            }
+        }
+        Poll::Ready(Ok(data.len() + skip_size))
+    }
+
+    /// Polls until all the buffered data is written to the first file and
+    /// added to the progress.
+    ///
+    /// # Errors
+    ///
+    /// - Returns an error if no files are associated with the task.
+    /// - Returns an error if writing to the file fails, the buffer is dropped.
+    pub(crate) fn poll_flush(&mut self, cx: &mut Context<'_>) -> Poll<Result<(), HttpClientError>> {
+        loop {
+            match self.poll_written(cx) {
+                Poll::Ready(Ok(())) if self.buffer.is_empty() => return Poll::Ready(Ok(())),
+                Poll::Ready(Ok(())) => self.submit(),
+                other => return other,
+            }
+        }
+    }
+
+    /// Writes the buffered data to the first file and adds it to the
+    /// progress, blocking until the buffer being written is done as well.
+    ///
+    /// Only for the drop of the operator, which cannot wait otherwise.
+    ///
+    /// # Errors
+    ///
+    /// - Returns an error if no files are associated with the task.
+    /// - Returns an error if writing to the file fails, the buffer is dropped.
+    fn flush(&mut self) -> Result<(), HttpClientError> {
+        if let Some((size, submission)) = self.writing.take() {
+            self.add_written(size, submission.wait())?;
+        }
+        self.flushed_at = get_current_timestamp();
+        if self.buffer.is_empty() {
+            return Ok(());
+        }
+        let size = self.buffer.len();
+        let buffer = mem::take(&mut self.buffer);
+        let res = self
+            .cpu
+            .measure(Path::Write, || write_back(&self.task, buffer));
+        self.reservation = None;
+        self.add_written(size, res)
+    }
+
+    /// Submits the buffered data to be written to the first file.
+    ///
+    /// Only called with no buffer being written, buffers are written in
+    /// order.
+    fn submit(&mut self) {
+        self.flushed_at = get_current_timestamp();
+        if self.buffer.is_empty() {
+            return;
+        }
+        let size = self.buffer.len();
+        let buffer = mem::take(&mut self.buffer);
+        let reservation = self.reservation.take();
+        let task = self.task.clone();
+        let cpu = self.cpu.clone();
+        let submission = file_io::submit(move || {
+            let res = cpu.measure(Path::Write, || write_back(&task, buffer));
+            drop(reservation);
+            res
+        });
+        self.writing = Some((size, submission));
+    }
+
+    /// Polls the buffer being written, if any, and adds it to the progress
+    /// once written.
+    fn poll_written(&mut self, cx: &mut Context<'_>) -> Poll<Result<(), HttpClientError>> {
+        let Some((size, submission)) = self.writing.as_mut() else {
+            return Poll::Ready(Ok(()));
+        };
+        let size = *size;
+        let Poll::Ready(res) = Pin::new(submission).poll(cx) else {
+            return Poll::Pending;
+        };
+        self.writing = None;
+        Poll::Ready(self.add_written(size, res))
+    }
+
+    /// Adds a buffer of `size` bytes written to the file to the progress.
+    fn add_written(
+        &mut self,
+        size: usize,
+        res: std::io::Result<()>,
+    ) -> Result<(), HttpClientError> {
+        res.map_err(HttpClientError::other)?;
+
+        // Update progress tracking
+        self.task.processed.add(0, size);
+        if self.decoder.is_some() {
+            let wire = self.task.transferred.load(Ordering::Acquire);
+            self.task
+                .progress
+                .lock()
+                .unwrap()
+                .extras
+                .insert(WIRE_BYTES_EXTRA.to_string(), wire.to_string());
+        }
+        metrics::BYTES_WRITTEN.add(size as u64);
+        if !self.written {
+            self.written = true;
+            Timelines::get_instance().record(self.task.task_id(), Phase::FirstWrite);
+        }
+        Ok(())
+    }
+}
+
+/// Writes a buffer to the first file of the task and adds it to the digest
+/// of the body. A task bypassing the page cache then drops its earlier
+/// writes from it. A task extracting its archive extracts the buffer, and
+/// writes it only if the archive is stored.
+fn write_back(task: &RequestTask, buffer: Vec<u8>) -> std::io::Result<()> {
+    let Some(file_mutex) = task.files.get(0) else {
+        error!("poll_write_file err, no file in the `task`");
+        return Err(std::io::Error::new(
+            std::io::ErrorKind::NotFound,
+            "error msg",
+        ));
+    };
+    let mut store = true;
+    if let Some(extraction) = task.extraction.lock().unwrap().as_mut() {
+        extraction.feed(task, &buffer)?;
+        store = extraction.keeps_archive();
+    }
+    if store {
+        let mut file = file_mutex.lock().unwrap();
+        file.write_all(&buffer)?;
+        if task.conf.common_data.bypass_cache && task.memory_limit().is_none() {
+            let res = file
+                .stream_position()
+                .and_then(|end| task_control::file_write_behind(&file, end, buffer.len() as u64));
+            if let Err(e) = res {
+                debug!("task {} write behind skipped {}", task.task_id(), e);
             }
-            Err(e) => Poll::Ready(Err(HttpClientError::other(e))),
+        }
+    }
+    if let Some(digest) = task.digest.lock().unwrap().as_mut() {
+        digest.update(&buffer);
+    }
+    Ok(())
+}
+
+impl Drop for TaskOperator {
+    /// Writes the data still buffered when the download ends or is aborted.
+    fn drop(&mut self) {
+        if let Err(e) = self.flush() {
+            error!("{} flush download buffer failed {:?}", self.task.task_id(), e);
         }
     }
 }
@@ -0,0 +1,151 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Health of the origins the tasks connect to.
+//!
+//! The tasks of a host that is down used to retry their connections each on
+//! its own, and kept the radio busy. Connection failures and responses are
+//! now recorded per origin, the host of the URL, and the retries of a task
+//! back off exponentially with the failures of its origin, with a jitter.
+//! After `BREAKER_THRESHOLD` failures in a row the circuit of the origin
+//! opens: its tasks wait instead of connecting until the backoff elapsed,
+//! then a single task probes the origin. A response closes the circuit, a
+//! failure opens it again for longer.
+
+use std::collections::HashMap;
+use std::sync::{LazyLock, Mutex};
+
+use ylong_runtime::fastrand::fast_random;
+
+use crate::utils::metrics;
+
+/// Connection failures in a row that open the circuit of an origin.
+const BREAKER_THRESHOLD: u32 = 3;
+
+/// Backoff after the first failure in milliseconds, doubled by each of the
+/// following ones.
+const BASE_BACKOFF: u64 = 400;
+
+/// Longest backoff in milliseconds.
+const MAX_BACKOFF: u64 = 5 * 60 * 1000;
+
+/// Time in milliseconds a probe may take before another task probes again,
+/// in case the probing task ended without a result.
+const PROBE_TIMEOUT: u64 = 60 * 1000;
+
+/// Time in milliseconds the tasks wait while a probe is in flight.
+const PROBE_WAIT: u64 = 1000;
+
+/// Returns the backoff after `failures` failures in a row: exponential, half
+/// of it being a random jitter so that the tasks do not retry together.
+fn backoff_of(failures: u32) -> u64 {
+    let shift = failures.saturating_sub(1).min(20);
+    let backoff = (BASE_BACKOFF << shift).min(MAX_BACKOFF);
+    let half = backoff / 2;
+    half + fast_random() % (half + 1)
+}
+
+/// Health of an origin that failed lately.
+#[derive(Default)]
+struct Health {
+    /// Connection failures in a row.
+    failures: u32,
+    /// Time until which the circuit is open in milliseconds.
+    open_until: Option<u64>,
+    /// Time the probe in flight started in milliseconds.
+    probe: Option<u64>,
+}
+
+/// Health of the origins of the tasks, origins without failures are not
+/// kept.
+pub(crate) struct Origins {
+    health: Mutex<HashMap<String, Health>>,
+}
+
+impl Origins {
+    /// Returns the origins of the service.
+    pub(crate) fn get_instance() -> &'static Self {
+        static ORIGINS: LazyLock<Origins> = LazyLock::new(Origins::new);
+        &ORIGINS
+    }
+
+    fn new() -> Self {
+        Self {
+            health: Mutex::new(HashMap::new()),
+        }
+    }
+
+    /// Asks to connect to `origin` at `now`, in milliseconds.
+    ///
+    /// # Returns
+    ///
+    /// `None` if the task may connect, possibly as the probe of an open
+    /// circuit, otherwise the milliseconds to wait before asking again.
+    pub(crate) fn admit(&self, origin: &str, now: u64) -> Option<u64> {
+        let mut health = self.health.lock().unwrap();
+        let health = health.get_mut(origin)?;
+        let open_until = health.open_until?;
+        if now < open_until {
+            return Some(open_until - now);
+        }
+        match health.probe {
+            Some(probe) if now < probe + PROBE_TIMEOUT => Some(PROBE_WAIT),
+            _ => {
+                info!("origin {} probed", origin);
+                health.probe = Some(now);
+                None
+            }
+        }
+    }
+
+    /// Records a failed connection to `origin` at `now`, in milliseconds.
+    pub(crate) fn failure(&self, origin: &str, now: u64) {
+        let mut health = self.health.lock().unwrap();
+        let health = health.entry(origin.to_string()).or_default();
+        health.failures += 1;
+        health.probe = None;
+        if health.failures >= BREAKER_THRESHOLD {
+            if health.open_until.is_none() {
+                info!("origin {} circuit opened", origin);
+                metrics::ORIGIN_CIRCUITS_OPENED.add(1);
+            }
+            let backoff = backoff_of(health.failures - BREAKER_THRESHOLD + 1);
+            health.open_until = Some(now + backoff);
+        }
+    }
+
+    /// Records a response of `origin`, which closes its circuit.
+    pub(crate) fn success(&self, origin: &str) {
+        let health = self.health.lock().unwrap().remove(origin);
+        if health.is_some_and(|health| health.open_until.is_some()) {
+            info!("origin {} circuit closed", origin);
+        }
+    }
+
+    /// Returns the milliseconds a task waits before retrying a connection
+    /// to `origin`.
+    pub(crate) fn backoff(&self, origin: &str) -> u64 {
+        let failures = self
+            .health
+            .lock()
+            .unwrap()
+            .get(origin)
+            .map_or(1, |health| health.failures);
+        backoff_of(failures)
+    }
+}
+
+#[cfg(test)]
+mod ut_origin {
+    include!("../../tests/ut/task/ut_origin.rs");
+}
@@ -0,0 +1,139 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Transport timings of the attempts of tasks.
+//!
+//! Every request a task sends is an attempt. It records how long resolving
+//! the host, connecting, the TLS handshake and waiting for the response
+//! headers took, then how long the body took, and the server it talked to.
+//! The latest attempt is persisted with the task and shown in its
+//! `TaskInfo`, which tells a slow server from a slow device.
+
+use ylong_http_client::async_impl::Response;
+
+use crate::manage::database::RequestDb;
+use crate::task::client_pool::host_of;
+use crate::task::request_task::RequestTask;
+use crate::utils::get_current_timestamp;
+
+/// Timings of the latest attempt of a task, in milliseconds, -1 if unknown.
+#[derive(Clone, Debug, PartialEq, Eq)]
+pub(crate) struct Performance {
+    /// Number of the attempt, 0 before the first request was sent.
+    pub(crate) attempt: u32,
+    /// Time spent resolving the host.
+    pub(crate) dns: i64,
+    /// Time spent establishing the TCP connection.
+    pub(crate) connect: i64,
+    /// Time spent in the TLS handshake.
+    pub(crate) tls: i64,
+    /// Time from sending the request to receiving the response headers,
+    /// connection included.
+    pub(crate) ttfb: i64,
+    /// Time from the response headers to the end of the transfer.
+    pub(crate) transfer: i64,
+    /// Host and port of the server.
+    pub(crate) server: String,
+    /// Time the response headers arrived, not persisted.
+    received: u64,
+}
+
+impl Default for Performance {
+    fn default() -> Self {
+        Self {
+            attempt: 0,
+            dns: -1,
+            connect: -1,
+            tls: -1,
+            ttfb: -1,
+            transfer: -1,
+            server: String::new(),
+            received: 0,
+        }
+    }
+}
+
+impl Performance {
+    /// Encodes the timings as they are stored in the database, the server
+    /// last as it is the only text.
+    pub(crate) fn encode(&self) -> String {
+        format!(
+            "{} {} {} {} {} {} {}",
+            self.attempt, self.dns, self.connect, self.tls, self.ttfb, self.transfer, self.server
+        )
+    }
+
+    /// Decodes timings stored in the database, the default ones if there are
+    /// none or they are malformed.
+    pub(crate) fn decode(text: &str) -> Self {
+        let mut fields = text.splitn(7, ' ');
+        let mut next = || fields.next().and_then(|field| field.parse::<i64>().ok());
+        let (Some(attempt), Some(dns), Some(connect), Some(tls), Some(ttfb), Some(transfer)) =
+            (next(), next(), next(), next(), next(), next())
+        else {
+            return Self::default();
+        };
+        Self {
+            attempt: attempt as u32,
+            dns,
+            connect,
+            tls,
+            ttfb,
+            transfer,
+            server: fields.next().unwrap_or_default().to_string(),
+            received: 0,
+        }
+    }
+}
+
+impl RequestTask {
+    /// Records a new attempt sent at `sent`, with its response if one
+    /// arrived.
+    pub(crate) fn record_attempt(&self, sent: u64, response: Option<&Response>) {
+        let mut performance = self.performance.lock().unwrap();
+        *performance = Performance {
+            attempt: performance.attempt + 1,
+            server: host_of(&self.conf.url),
+            ..Default::default()
+        };
+        if response.is_some() {
+            performance.received = get_current_timestamp();
+            performance.ttfb = performance.received.saturating_sub(sent) as i64;
+        }
+        // The client measures the steps of establishing its connection
+        #[cfg(feature = "oh")]
+        if let Some(response) = response {
+            let millis = |d: Option<std::time::Duration>| d.map_or(-1, |d| d.as_millis() as i64);
+            let time_group = response.time_group();
+            performance.dns = millis(time_group.dns_duration());
+            performance.connect = millis(time_group.tcp_duration());
+            performance.tls = millis(time_group.tls_duration());
+        }
+        RequestDb::get_instance().update_task_performance(self.task_id(), &performance);
+    }
+
+    /// Records that the body of the latest attempt was transferred.
+    pub(crate) fn record_transfer(&self) {
+        let mut performance = self.performance.lock().unwrap();
+        if performance.ttfb < 0 {
+            return;
+        }
+        performance.transfer = get_current_timestamp().saturating_sub(performance.received) as i64;
+        RequestDb::get_instance().update_task_performance(self.task_id(), &performance);
+    }
+}
+
+#[cfg(test)]
+mod ut_performance {
+    include!("../../tests/ut/task/ut_performance.rs");
+}
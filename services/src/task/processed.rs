@@ -0,0 +1,131 @@
+// Copyright (C) 2023 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Processed bytes of a task, updated by the data plane without a lock.
+//!
+//! The counters are guarded by a sequence number that is odd while they are
+//! written. Readers never wait for the progress lock of the task, they retry
+//! a snapshot that overlapped a write. Writers only take turns among
+//! themselves, which matters for the segments of a download.
+
+use std::hint;
+use std::sync::atomic::{fence, AtomicU64, AtomicUsize, Ordering};
+
+/// Bytes processed per file and in total.
+pub(crate) struct ProcessedCounters {
+    seq: AtomicU64,
+    files: Box<[AtomicUsize]>,
+    total: AtomicUsize,
+}
+
+impl ProcessedCounters {
+    /// Creates counters of at least `len` files starting from the processed
+    /// bytes of a progress.
+    pub(crate) fn new(processed: &[usize], total: usize, len: usize) -> Self {
+        let files = (0..len.max(processed.len()))
+            .map(|i| AtomicUsize::new(processed.get(i).copied().unwrap_or(0)))
+            .collect();
+        Self {
+            seq: AtomicU64::new(0),
+            files,
+            total: AtomicUsize::new(total),
+        }
+    }
+
+    /// Adds `size` bytes to the file at `index` and to the total.
+    pub(crate) fn add(&self, index: usize, size: usize) {
+        self.write(|| {
+            if let Some(file) = self.files.get(index) {
+                file.fetch_add(size, Ordering::Relaxed);
+            }
+            self.total.fetch_add(size, Ordering::Relaxed);
+        });
+    }
+
+    /// Replaces the counters with the result of `f`, which gets the bytes of
+    /// every file and the total.
+    pub(crate) fn update<F: FnOnce(&mut [usize], &mut usize)>(&self, f: F) {
+        self.write(|| {
+            let mut files = self
+                .files
+                .iter()
+                .map(|file| file.load(Ordering::Relaxed))
+                .collect::<Vec<_>>();
+            let mut total = self.total.load(Ordering::Relaxed);
+            f(&mut files, &mut total);
+            for (file, n) in self.files.iter().zip(files) {
+                file.store(n, Ordering::Relaxed);
+            }
+            self.total.store(total, Ordering::Relaxed);
+        });
+    }
+
+    /// Returns the bytes processed of the file at `index`.
+    pub(crate) fn file(&self, index: usize) -> usize {
+        self.files
+            .get(index)
+            .map_or(0, |file| file.load(Ordering::Acquire))
+    }
+
+    /// Returns the bytes processed in total.
+    pub(crate) fn total(&self) -> usize {
+        self.total.load(Ordering::Acquire)
+    }
+
+    /// Returns the bytes of every file and the total, as of the same write.
+    pub(crate) fn snapshot(&self) -> (Vec<usize>, usize) {
+        loop {
+            let seq = self.seq.load(Ordering::Acquire);
+            if seq % 2 == 1 {
+                hint::spin_loop();
+                continue;
+            }
+            let files = self
+                .files
+                .iter()
+                .map(|file| file.load(Ordering::Relaxed))
+                .collect::<Vec<_>>();
+            let total = self.total.load(Ordering::Relaxed);
+            fence(Ordering::Acquire);
+            if self.seq.load(Ordering::Relaxed) == seq {
+                return (files, total);
+            }
+        }
+    }
+
+    fn write(&self, f: impl FnOnce()) {
+        let mut seq = self.seq.load(Ordering::Relaxed);
+        loop {
+            if seq % 2 == 1 {
+                hint::spin_loop();
+                seq = self.seq.load(Ordering::Relaxed);
+                continue;
+            }
+            match self
+                .seq
+                .compare_exchange_weak(seq, seq + 1, Ordering::Acquire, Ordering::Relaxed)
+            {
+                Ok(_) => break,
+                Err(current) => seq = current,
+            }
+        }
+        fence(Ordering::Release);
+        f();
+        self.seq.store(seq + 2, Ordering::Release);
+    }
+}
+
+#[cfg(test)]
+mod ut_processed {
+    include!("../../tests/ut/task/ut_processed.rs");
+}
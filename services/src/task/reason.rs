@@ -80,6 +80,12 @@ mod ffi {
         NetworkAppAccount = 30,
         /// Transfer speed below configured minimum threshold.
         LowSpeed = 31,
+        /// Downloaded file does not match the checksum of the task.
+        ChecksumMismatch = 32,
+        /// Body of an in-memory download exceeds the memory limit of the task.
+        BodyTooLarge = 33,
+        /// Origin of the task is unreachable, the task waits to retry it.
+        OriginUnavailable = 34,
     }
 }
 
@@ -121,6 +127,9 @@ impl From<u8> for Reason {
             29 => Reason::AppAccount,
             30 => Reason::NetworkAppAccount,
             31 => Reason::LowSpeed,
+            32 => Reason::ChecksumMismatch,
+            33 => Reason::BodyTooLarge,
+            34 => Reason::OriginUnavailable,
             _ => Reason::OthersError, // Fallback for unrecognized values
         }
     }
@@ -161,6 +170,9 @@ impl Reason {
             Reason::AppAccount => "The app is background or terminate and the account is stopped",
             Reason::NetworkAppAccount => "NetWork is offline and the app is background or terminate and the account is stopped",
             Reason::LowSpeed => "Below low speed limit",
+            Reason::ChecksumMismatch => "Checksum mismatch",
+            Reason::BodyTooLarge => "Body exceeds the memory limit",
+            Reason::OriginUnavailable => "The server is unreachable, waiting to retry",
             _ => "unknown error",
         }
     }
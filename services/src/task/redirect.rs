@@ -0,0 +1,137 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Redirects followed by the download tasks.
+//!
+//! The clients followed the redirects of the tasks, and every start of a
+//! task whose url redirects paid the round trip to its url again. Downloads
+//! now follow their redirects themselves and the targets the responses allow
+//! to store are kept in a `RedirectCache` of the service: the next request
+//! of any task with the same url goes to the target straight away. A cached
+//! target that fails is forgotten.
+//!
+//! The other tasks leave their redirects to their clients: uploads and
+//! requests with a body, whose method may change on a redirect, requests
+//! with credentials, whose redirects may be personal, and atomic services,
+//! whose client checks each redirect against their domain policy.
+
+use std::sync::LazyLock;
+
+use request_utils::redirect::RedirectCache;
+use ylong_http_client::async_impl::Response;
+use ylong_http_client::HttpClientError;
+
+use crate::task::config::{Action, TaskConfig};
+use crate::task::reason::Reason;
+use crate::task::request_task::{RequestTask, TaskError};
+use crate::task::ATOMIC_SERVICE;
+use crate::utils::{get_current_timestamp, metrics};
+
+/// Redirects an attempt of a task follows before it fails.
+const MAX_REDIRECTS: usize = 30;
+
+/// Most redirects cached by the service.
+const REDIRECT_CACHE_CAPACITY: usize = 256;
+
+static REDIRECTS: LazyLock<RedirectCache> =
+    LazyLock::new(|| RedirectCache::new(REDIRECT_CACHE_CAPACITY));
+
+/// Whether a task follows its redirects itself instead of its client.
+pub(crate) fn follows_redirects(config: &TaskConfig) -> bool {
+    let credentials = config
+        .headers
+        .keys()
+        .any(|key| key.eq_ignore_ascii_case("authorization") || key.eq_ignore_ascii_case("cookie"));
+    config.common_data.redirect
+        && config.common_data.action == Action::Download
+        && !matches!(config.method.to_uppercase().as_str(), "PUT" | "POST")
+        && config.bundle_type != ATOMIC_SERVICE
+        && !credentials
+}
+
+impl RequestTask {
+    /// Starts an attempt of the task at the cached target of its url, or at
+    /// its url if it has none.
+    pub(crate) fn start_redirects(&self) {
+        let target = follows_redirects(&self.conf)
+            .then(|| REDIRECTS.get(&self.conf.url, get_current_timestamp()))
+            .flatten();
+        if target.is_some() {
+            metrics::REDIRECT_CACHE_HITS.add(1);
+        }
+        *self.location.lock().unwrap() = target;
+    }
+
+    /// Follows the redirect a request of the task was answered with, the
+    /// next request goes to its target.
+    ///
+    /// `hops` counts the redirects followed by the current attempt.
+    ///
+    /// # Returns
+    ///
+    /// Whether the request is to be sent again to the new `location`.
+    ///
+    /// # Errors
+    ///
+    /// Returns `TaskError::Failed(Reason::ProtocolError)` after
+    /// `MAX_REDIRECTS` redirects.
+    pub(crate) fn follow_redirect(
+        &self,
+        response: &Result<Response, HttpClientError>,
+        hops: &mut usize,
+    ) -> Result<bool, TaskError> {
+        if !follows_redirects(&self.conf) {
+            return Ok(false);
+        }
+        let mut location = self.location.lock().unwrap();
+        let response = match response {
+            Ok(response) if matches!(response.status().as_u16(), 301 | 302 | 303 | 307 | 308) => {
+                response
+            }
+            Ok(response) if response.status().as_u16() < 400 => return Ok(false),
+            _ => {
+                // The next attempt asks the url of the task again
+                if *hops == 0 && location.is_some() {
+                    REDIRECTS.remove(&self.conf.url);
+                }
+                return Ok(false);
+            }
+        };
+        let header = |name: &str| {
+            let value = response.headers().get(name)?;
+            value.to_string().ok()
+        };
+        let Some(target) = header("location") else {
+            return Ok(false);
+        };
+        *hops += 1;
+        if *hops > MAX_REDIRECTS {
+            error!("task {} redirected too many times", self.task_id());
+            return Err(TaskError::Failed(Reason::ProtocolError));
+        }
+        let url = location.clone().unwrap_or_else(|| self.conf.url.clone());
+        let Some(target) = REDIRECTS.insert(
+            &url,
+            response.status().as_u16(),
+            &target,
+            header("cache-control").as_deref(),
+            get_current_timestamp(),
+        ) else {
+            return Ok(false);
+        };
+        metrics::REDIRECTS_FOLLOWED.add(1);
+        debug!("task {} redirected to {}", self.task_id(), target);
+        *location = Some(target);
+        Ok(true)
+    }
+}
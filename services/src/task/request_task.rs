@@ -18,6 +18,7 @@
 //! It defines the main `RequestTask` structure and associated components for
 //! controlling the lifecycle of network operations.
 
+use std::future::Future;
 use std::io::{self};
 use std::sync::atomic::{
     AtomicBool, AtomicI64, AtomicU32, AtomicU64, AtomicU8, Ordering,
@@ -25,6 +26,7 @@ use std::sync::atomic::{
 use std::sync::{Arc, Mutex};
 use std::time::Duration;
 
+use request_utils::compress::ACCEPT_ENCODING;
 use request_utils::file_control::{belong_app_base, check_standardized_path};
 use ylong_http_client::async_impl::{Body, Client, Request, RequestBuilder, Response};
 use ylong_http_client::{ErrorKind, HttpClientError};
@@ -33,19 +35,26 @@ cfg_oh! {
     use crate::manage::SystemConfig;
 }
 
+use super::checksum::{Checksum, Digest};
+use super::extract::Extraction;
 use super::config::Version;
 use super::info::{CommonTaskInfo, State, TaskInfo, UpdateInfo};
-use super::notify::{EachFileStatus, NotifyData, Progress};
+use super::notify::{EachFileStatus, NotifyData, Progress, WaitingCause};
+use super::origin::Origins;
+use super::performance::Performance;
+use super::processed::ProcessedCounters;
 use super::reason::Reason;
+use super::throughput::Throughput;
 use crate::error::ErrorCode;
 use crate::manage::database::RequestDb;
 use crate::manage::network_manager::NetworkManager;
 use crate::manage::notifier::Notifier;
 use crate::service::client::ClientManagerEntry;
 use crate::service::notification_bar::NotificationDispatcher;
-use crate::task::client::build_client;
+use crate::task::client_pool::{host_of, ClientPool};
 use crate::task::config::{Action, TaskConfig};
 use crate::task::files::{AttachedFiles, Files};
+use crate::task::speed_limiter::TaskBudget;
 use crate::task::task_control;
 use crate::utils::form_item::FileSpec;
 use crate::utils::{get_current_duration, get_current_timestamp};
@@ -53,8 +62,9 @@ use crate::utils::{get_current_duration, get_current_timestamp};
 /// Maximum number of network retry attempts.
 const RETRY_TIMES: u32 = 4;
 
-/// Interval between retry attempts in milliseconds.
-const RETRY_INTERVAL: u64 = 400;
+/// Longest wait in milliseconds between two checks of the origin of a
+/// waiting task, which checks for an abort in between.
+const ORIGIN_CHECK_INTERVAL: u64 = 1000;
 
 /// Represents an HTTP request task.
 ///
@@ -62,11 +72,16 @@ const RETRY_INTERVAL: u64 = 400;
 /// an HTTP request task, including configuration, client state, file information,
 /// progress tracking, and notification mechanisms.
 pub(crate) struct RequestTask {
-    /// Task configuration containing request parameters, headers, and metadata.
-    pub(crate) conf: TaskConfig,
+    /// Task configuration containing request parameters, headers, and metadata,
+    /// immutable once the task is built and shared by reference count.
+    pub(crate) conf: Arc<TaskConfig>,
     
-    /// HTTP client used to execute the request.
-    pub(crate) client: ylong_runtime::sync::Mutex<Client>,
+    /// HTTP client used to execute the request, shared through the client pool.
+    pub(crate) client: Arc<Client>,
+
+    /// Target the requests of the task are sent to instead of its url, after
+    /// a redirect it followed or from the cache of redirects.
+    pub(crate) location: Mutex<Option<String>>,
     
     /// Files associated with the task (for download or upload operations).
     pub(crate) files: Files,
@@ -80,8 +95,12 @@ pub(crate) struct RequestTask {
     /// MIME type of the downloaded file.
     pub(crate) mime_type: Mutex<String>,
     
-    /// Progress tracking information.
+    /// Progress tracking information. Its processed bytes are kept in
+    /// `processed`, `progress_snapshot` returns both together.
     pub(crate) progress: Mutex<Progress>,
+
+    /// Processed bytes, updated by the data plane without the progress lock.
+    pub(crate) processed: ProcessedCounters,
     
     /// Current status of the task.
     pub(crate) status: Mutex<TaskStatus>,
@@ -106,6 +125,24 @@ pub(crate) struct RequestTask {
     
     /// Maximum speed achieved during the task in bytes per second.
     pub(crate) max_speed: AtomicI64,
+
+    /// Speed budget shared by all transfers of the task.
+    pub(crate) speed_budget: TaskBudget,
+
+    /// Bytes sent or received by the transfers of the task, only grows.
+    pub(crate) transferred: AtomicU64,
+
+    /// Expected digest of the downloaded file, if it is verified.
+    pub(crate) checksum: Option<Checksum>,
+
+    /// Digest of the bytes written to the file so far by the running download.
+    pub(crate) digest: Mutex<Option<Digest>>,
+
+    /// Extraction of the archive the running download writes, if it has one.
+    pub(crate) extraction: Mutex<Option<Extraction>>,
+
+    /// ETags of the parts of a parallel upload the server stored, by part.
+    pub(crate) part_etags: Mutex<Vec<Option<String>>>,
     
     /// Last time progress was notified.
     pub(crate) last_notify: AtomicU64,
@@ -118,6 +155,9 @@ pub(crate) struct RequestTask {
     
     /// Number of timeout attempts.
     pub(crate) timeout_tries: AtomicU32,
+
+    /// Number of reconnections after a stall in the current run.
+    pub(crate) stall_reconnects: AtomicU32,
     
     /// Flag indicating whether upload resume is enabled.
     pub(crate) upload_resume: AtomicBool,
@@ -133,6 +173,12 @@ pub(crate) struct RequestTask {
     
     /// Remaining time until task timeout.
     pub(crate) rest_time: AtomicU64,
+
+    /// Transport timings of the latest attempt.
+    pub(crate) performance: Mutex<Performance>,
+
+    /// Smoothed throughput of the running task.
+    pub(crate) throughput: Mutex<Throughput>,
 }
 
 impl RequestTask {
@@ -189,13 +235,95 @@ impl RequestTask {
             if !NetworkManager::is_online() {
                 return Err(TaskError::Waiting(TaskPhase::NetworkOffline));
             } else {
-                // Wait before retrying to avoid overwhelming the network
-                ylong_runtime::time::sleep(Duration::from_millis(RETRY_INTERVAL)).await;
+                // Back off with the failures of the origin before retrying
+                let backoff = Origins::get_instance().backoff(&host_of(&self.conf.url));
+                ylong_runtime::time::sleep(Duration::from_millis(backoff)).await;
                 return Err(TaskError::Waiting(TaskPhase::NeedRetry));
             }
         }
         Ok(())
     }
+
+    /// Waits while the circuit of the origin of the task is open.
+    ///
+    /// The task is in the waiting state meanwhile and its clients are told
+    /// why. It runs again once it may connect, possibly as the probe of the
+    /// origin.
+    ///
+    /// # Errors
+    ///
+    /// Returns `TaskError::Waiting(TaskPhase::UserAbort)` if the task was
+    /// aborted while waiting.
+    pub(crate) async fn wait_for_origin(&self, abort_flag: &AtomicBool) -> Result<(), TaskError> {
+        let origin = host_of(&self.conf.url);
+        let mut waited = false;
+        while let Some(wait) = Origins::get_instance().admit(&origin, get_current_timestamp()) {
+            if abort_flag.load(Ordering::Acquire) {
+                return Err(TaskError::Waiting(TaskPhase::UserAbort));
+            }
+            if !waited {
+                waited = true;
+                info!("task {} waits for origin {}", self.task_id(), origin);
+                RequestDb::get_instance().update_task_state(
+                    self.task_id(),
+                    State::Waiting,
+                    Reason::OriginUnavailable,
+                );
+                Notifier::waiting(&self.client_manager, self.task_id(), WaitingCause::Origin);
+            }
+            let wait = wait.min(ORIGIN_CHECK_INTERVAL);
+            ylong_runtime::time::sleep(Duration::from_millis(wait)).await;
+        }
+        if waited {
+            RequestDb::get_instance().update_task_state(
+                self.task_id(),
+                State::Running,
+                Reason::Default,
+            );
+        }
+        Ok(())
+    }
+
+    /// Records the outcome of a connection of the task for the health of its
+    /// origin: any response shows the origin is reachable.
+    pub(crate) fn record_origin(&self, response: &Result<Response, HttpClientError>) {
+        let origin = host_of(&self.conf.url);
+        match response.as_ref().map_err(|e| e.error_kind()) {
+            Ok(_) => Origins::get_instance().success(&origin),
+            Err(ErrorKind::Connect | ErrorKind::ConnectionUpgrade) => {
+                Origins::get_instance().failure(&origin, get_current_timestamp());
+            }
+            Err(_) => {}
+        }
+    }
+
+    /// Runs an attempt of the task within the rest of its total timeout.
+    ///
+    /// Pooled clients are shared, so the total timeout of a task is enforced
+    /// here instead of by its client.
+    ///
+    /// # Errors
+    ///
+    /// Returns `TaskError::Failed(Reason::ContinuousTaskTimeout)` if the
+    /// timeout elapses before the attempt ends.
+    pub(crate) async fn within_rest_time<T>(
+        &self,
+        attempt: impl Future<Output = Result<T, TaskError>>,
+    ) -> Result<T, TaskError> {
+        let rest_time = Duration::from_secs(self.rest_time.load(Ordering::SeqCst));
+        match ylong_runtime::time::timeout(rest_time, attempt).await {
+            Ok(result) => result,
+            Err(_) => {
+                error!("Task {} total timeout", self.task_id());
+                sys_event!(
+                    ExecFault,
+                    DfxCode::TASK_FAULT_01,
+                    &format!("Task {} total timeout", self.task_id())
+                );
+                Err(TaskError::Failed(Reason::ContinuousTaskTimeout))
+            }
+        }
+    }
 }
 
 /// Calculates the effective size of a range for upload operations.
@@ -238,7 +366,7 @@ impl RequestTask {
     pub(crate) fn new(
         config: TaskConfig,
         files: AttachedFiles,
-        client: Client,
+        client: Arc<Client>,
         client_manager: ClientManagerEntry,
         upload_resume: bool,
         rest_time: u64,
@@ -273,14 +401,21 @@ impl RequestTask {
         let status = TaskStatus::new(time);
         let progress = Progress::new(sizes);
         let mode = AtomicU8::new(config.common_data.mode.repr);
+        let checksum = Checksum::parse(&config.checksum);
 
         RequestTask {
-            conf: config,
-            client: ylong_runtime::sync::Mutex::new(client),
+            conf: Arc::new(config),
+            client,
+            location: Mutex::new(None),
             files: files.files,
             body_files: files.body_files,
             ctime: time,
             mime_type: Mutex::new(String::new()),
+            processed: ProcessedCounters::new(
+                &progress.processed,
+                progress.common_data.total_processed,
+                file_len,
+            ),
             progress: Mutex::new(progress),
             tries: AtomicU32::new(0),
             status: Mutex::new(status),
@@ -290,15 +425,24 @@ impl RequestTask {
             file_total_size: AtomicI64::new(file_total_size),
             rate_limiting: AtomicU64::new(0),
             max_speed: AtomicI64::new(0),
+            speed_budget: TaskBudget::new(),
+            transferred: AtomicU64::new(0),
+            checksum,
+            digest: Mutex::new(None),
+            extraction: Mutex::new(None),
+            part_etags: Mutex::new(Vec::new()),
             last_notify: AtomicU64::new(time),
             client_manager,
             running_result: Mutex::new(None),
             timeout_tries: AtomicU32::new(0),
+            stall_reconnects: AtomicU32::new(0),
             upload_resume: AtomicBool::new(upload_resume),
             mode,
             start_time: AtomicU64::new(get_current_duration().as_secs()),
             task_time: AtomicU64::new(0),
             rest_time: AtomicU64::new(rest_time),
+            performance: Mutex::new(Performance::default()),
+            throughput: Mutex::new(Throughput::default()),
         }
     }
 
@@ -323,12 +467,64 @@ impl RequestTask {
         client_manager: ClientManagerEntry,
         upload_resume: bool,
     ) -> Result<RequestTask, ErrorCode> {
-        let rest_time = get_rest_time(&config, info.task_time);
         #[cfg(feature = "oh")]
-        let (files, client) = check_config(&config, rest_time, system)?;
+        let (files, client) = check_config(&config, system)?;
+        #[cfg(not(feature = "oh"))]
+        let (files, client) = check_config(&config)?;
+        Ok(Self::from_info(
+            config,
+            info,
+            files,
+            client,
+            client_manager,
+            upload_resume,
+        ))
+    }
+
+    /// Creates a request task from existing task information and the files the
+    /// task kept while it was queued, which cannot be reopened from its stored
+    /// configuration.
+    ///
+    /// # Arguments
+    ///
+    /// * `config` - The task configuration.
+    /// * `system` - System configuration (only on OH platform).
+    /// * `info` - Existing task information.
+    /// * `files` - The files kept by the queued task.
+    /// * `client_manager` - The client manager for handling client-specific operations.
+    /// * `upload_resume` - Whether to enable upload resume functionality.
+    pub(crate) fn new_by_info_with_files(
+        config: TaskConfig,
+        #[cfg(feature = "oh")] system: SystemConfig,
+        info: TaskInfo,
+        files: AttachedFiles,
+        client_manager: ClientManagerEntry,
+        upload_resume: bool,
+    ) -> Result<RequestTask, ErrorCode> {
+        #[cfg(feature = "oh")]
+        let client = ClientPool::get_instance().client(&config, system);
         #[cfg(not(feature = "oh"))]
-        let (files, client) = check_config(&config, rest_time)?;
+        let client = ClientPool::get_instance().client(&config);
+        let client = client.map_err(|_| ErrorCode::Other)?;
+        Ok(Self::from_info(
+            config,
+            info,
+            files,
+            client,
+            client_manager,
+            upload_resume,
+        ))
+    }
 
+    fn from_info(
+        config: TaskConfig,
+        info: TaskInfo,
+        files: AttachedFiles,
+        client: Arc<Client>,
+        client_manager: ClientManagerEntry,
+        upload_resume: bool,
+    ) -> RequestTask {
+        let rest_time = get_rest_time(&config, info.task_time);
         let file_len = files.files.len();
         let action = config.common_data.action;
         let time = get_current_timestamp();
@@ -357,14 +553,21 @@ impl RequestTask {
         };
         let progress = info.progress;
         let mode = AtomicU8::new(config.common_data.mode.repr);
+        let checksum = Checksum::parse(&config.checksum);
 
         let mut task = RequestTask {
-            conf: config,
-            client: ylong_runtime::sync::Mutex::new(client),
+            conf: Arc::new(config),
+            client,
+            location: Mutex::new(None),
             files: files.files,
             body_files: files.body_files,
             ctime,
             mime_type: Mutex::new(mime_type),
+            processed: ProcessedCounters::new(
+                &progress.processed,
+                progress.common_data.total_processed,
+                file_len,
+            ),
             progress: Mutex::new(progress),
             tries: AtomicU32::new(tries),
             status: Mutex::new(status),
@@ -374,19 +577,46 @@ impl RequestTask {
             file_total_size: AtomicI64::new(file_total_size),
             rate_limiting: AtomicU64::new(0),
             max_speed: AtomicI64::new(info.max_speed),
+            speed_budget: TaskBudget::new(),
+            transferred: AtomicU64::new(0),
+            checksum,
+            digest: Mutex::new(None),
+            extraction: Mutex::new(None),
+            part_etags: Mutex::new(Vec::new()),
             last_notify: AtomicU64::new(time),
             client_manager,
             running_result: Mutex::new(None),
             timeout_tries: AtomicU32::new(0),
+            stall_reconnects: AtomicU32::new(0),
             upload_resume: AtomicBool::new(upload_resume),
             mode,
             start_time: AtomicU64::new(get_current_duration().as_secs()),
             task_time: AtomicU64::new(info.task_time),
             rest_time: AtomicU64::new(rest_time),
+            performance: Mutex::new(info.performance),
+            throughput: Mutex::new(Throughput::default()),
         };
         let background_notify = NotificationDispatcher::get_instance().register_task(&task);
         task.background_notify = background_notify;
-        Ok(task)
+        task
+    }
+
+    /// Returns the progress of the task together with its processed bytes.
+    pub(crate) fn progress_snapshot(&self) -> Progress {
+        // `unwrap` for propagating panics among threads.
+        let mut progress = self.progress.lock().unwrap().clone();
+        let (processed, total) = self.processed.snapshot();
+        progress.processed = processed;
+        progress.common_data.total_processed = total;
+        if progress.common_data.state == State::Running.repr {
+            let throughput = self.throughput.lock().unwrap();
+            progress.speed = throughput.speed();
+            if progress.sizes.iter().all(|size| *size >= 0) {
+                let remaining = progress.sizes.iter().sum::<i64>() - total as i64;
+                progress.eta = throughput.eta(remaining.max(0));
+            }
+        }
+        progress
     }
 
     /// Builds notification data for the task.
@@ -397,9 +627,8 @@ impl RequestTask {
     pub(crate) fn build_notify_data(&self) -> NotifyData {
         let vec = self.get_each_file_status();
         NotifyData {
-            bundle: self.conf.bundle.clone(),
-            // `unwrap` for propagating panics among threads.
-            progress: self.progress.lock().unwrap().clone(),
+            bundle: self.conf.bundle.to_string(),
+            progress: self.progress_snapshot(),
             action: self.conf.common_data.action,
             version: self.conf.version,
             each_file_status: vec,
@@ -414,7 +643,7 @@ impl RequestTask {
     pub(crate) fn update_progress_in_database(&self) {
         let mtime = self.status.lock().unwrap().mtime;
         let reason = self.status.lock().unwrap().reason;
-        let progress = self.progress.lock().unwrap().clone();
+        let progress = self.progress_snapshot();
         let update_info = UpdateInfo {
             mtime,
             reason: reason.repr,
@@ -426,6 +655,8 @@ impl RequestTask {
     }
 
     /// Builds an HTTP request builder based on the task configuration.
+    ///
+    /// The request goes to the `location` of the task if it has one.
     /// 
     /// # Returns
     /// 
@@ -438,7 +669,12 @@ impl RequestTask {
     pub(crate) fn build_request_builder(&self) -> Result<RequestBuilder, HttpClientError> {
         use ylong_http_client::async_impl::PercentEncoder;
 
-        let url = self.conf.url.clone();
+        let url = self
+            .location
+            .lock()
+            .unwrap()
+            .clone()
+            .unwrap_or_else(|| self.conf.url.clone());
         let url = match PercentEncoder::encode(url.as_str()) {
             Ok(value) => value,
             Err(e) => {
@@ -515,7 +751,7 @@ impl RequestTask {
             resume_download,
             require_range
         );
-        match (resume_download, require_range) {
+        let ranged = match (resume_download, require_range) {
             (true, false) => {
                 let (builder, support_range) = task.support_range(request_builder);
                 request_builder = builder;
@@ -525,9 +761,11 @@ impl RequestTask {
                 } else {
                     task_control::clear_downloaded_file(task.clone()).await?;
                 }
+                support_range
             }
             (false, true) => {
                 request_builder = task.range_request(request_builder, begins, ends);
+                true
             }
             (true, true) => {
                 let (builder, support_range) = task.support_range(request_builder);
@@ -538,14 +776,45 @@ impl RequestTask {
                 } else {
                     return Err(TaskError::Failed(Reason::UnsupportedRangeRequest));
                 }
+                true
             }
-            (false, false) => {}
+            (false, false) => false,
         };
+        if task.conf.common_data.compression {
+            request_builder = task.accept_encoding(request_builder, ranged);
+        }
 
         let request = request_builder.body(Body::slice(task.conf.data.clone()))?;
         Ok(request)
     }
 
+    /// Advertises the encodings the task decodes, unless the request has an
+    /// `Accept-Encoding` header of its own.
+    ///
+    /// Ranges are offsets in the decoded body, so a `ranged` request and a
+    /// task needing the exact length of the body ask for the identity
+    /// encoding instead.
+    pub(crate) fn accept_encoding(
+        &self,
+        request_builder: RequestBuilder,
+        ranged: bool,
+    ) -> RequestBuilder {
+        if self
+            .conf
+            .headers
+            .keys()
+            .any(|key| key.eq_ignore_ascii_case("accept-encoding"))
+        {
+            return request_builder;
+        }
+        let encoding = if ranged || self.conf.common_data.precise {
+            "identity"
+        } else {
+            ACCEPT_ENCODING
+        };
+        request_builder.header("Accept-Encoding", encoding)
+    }
+
     /// Configures a request builder to include range headers.
     /// 
     /// # Arguments
@@ -557,7 +826,7 @@ impl RequestTask {
     /// # Returns
     /// 
     /// The configured request builder with range headers.
-    fn range_request(
+    pub(crate) fn range_request(
         &self,
         request_builder: RequestBuilder,
         begins: u64,
@@ -580,7 +849,7 @@ impl RequestTask {
     /// # Returns
     /// 
     /// A tuple containing the configured request builder and a boolean indicating whether range requests are supported.
-    fn support_range(&self, mut request_builder: RequestBuilder) -> (RequestBuilder, bool) {
+    pub(crate) fn support_range(&self, mut request_builder: RequestBuilder) -> (RequestBuilder, bool) {
         let progress_guard = self.progress.lock().unwrap();
         let mut support_range = false;
         if let Some(etag) = progress_guard.extras.get("etag") {
@@ -621,14 +890,7 @@ impl RequestTask {
             match len.parse::<i64>() {
                 Ok(v) => {
                     let mut progress = self.progress.lock().unwrap();
-                    progress.sizes =
-                        vec![v + progress.processed.first().map_or_else(
-                        || {
-                            error!("Failed to get a process size from an empty vector in Progress");
-                            Default::default()
-                        },
-                        |x| *x as i64,
-                    )];
+                    progress.sizes = vec![v + self.processed.file(0) as i64];
                     self.file_total_size.store(v, Ordering::SeqCst);
                     debug!("the download task content-length is {}", v);
                 }
@@ -830,11 +1092,11 @@ impl RequestTask {
     /// 
     /// A `TaskInfo` struct containing all current information about the task.
     pub(crate) fn info(&self) -> TaskInfo {
+        let progress = self.progress_snapshot();
         let status = self.status.lock().unwrap();
-        let progress = self.progress.lock().unwrap();
         let mode = self.mode.load(Ordering::Acquire);
         TaskInfo {
-            bundle: self.conf.bundle.clone(),
+            bundle: self.conf.bundle.to_string(),
             url: self.conf.url.clone(),
             data: self.conf.data.clone(),
             token: self.conf.token.clone(),
@@ -873,6 +1135,7 @@ impl RequestTask {
             },
             max_speed: self.max_speed.load(Ordering::SeqCst),
             task_time: self.task_time.load(Ordering::SeqCst),
+            performance: self.performance.lock().unwrap().clone(),
         }
     }
 
@@ -962,18 +1225,16 @@ fn check_path(path: &str) -> bool {
 /// # Arguments
 /// 
 /// * `config` - The task configuration to validate.
-/// * `total_timeout` - Total timeout for the task.
 /// * `system` - System configuration (only on OH platform).
 /// 
 /// # Returns
 /// 
-/// * `Ok((AttachedFiles, Client))` - The attached files and configured client.
+/// * `Ok((AttachedFiles, Arc<Client>))` - The attached files and the pooled client.
 /// * `Err(ErrorCode)` - If the configuration is invalid or files cannot be opened.
 pub(crate) fn check_config(
     config: &TaskConfig,
-    total_timeout: u64,
     #[cfg(feature = "oh")] system: SystemConfig,
-) -> Result<(AttachedFiles, Client), ErrorCode> {
+) -> Result<(AttachedFiles, Arc<Client>), ErrorCode> {
     if !check_file_specs(&config.file_specs) {
         return Err(ErrorCode::Other);
     }
@@ -985,10 +1246,14 @@ pub(crate) fn check_config(
     }
     let files = AttachedFiles::open(config).map_err(|_| ErrorCode::FileOperationErr)?;
     #[cfg(feature = "oh")]
-    let client = build_client(config, total_timeout, system).map_err(|_| ErrorCode::Other)?;
+    let client = ClientPool::get_instance()
+        .client(config, system)
+        .map_err(|_| ErrorCode::Other)?;
 
     #[cfg(not(feature = "oh"))]
-    let client = build_client(config, total_timeout).map_err(|_| ErrorCode::Other)?;
+    let client = ClientPool::get_instance()
+        .client(config)
+        .map_err(|_| ErrorCode::Other)?;
     Ok((files, client))
 }
 
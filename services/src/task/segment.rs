@@ -0,0 +1,529 @@
+// Copyright (C) 2023 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Segmented downloads over parallel connections.
+//!
+//! A download opts in with the `segments` extra of its config. If the server
+//! accepts byte ranges and reports a validator, the body is split into up to
+//! that many segments. Each segment is fetched with its own range request and
+//! written at its offset into the task file, and a failed segment is retried
+//! on its own from where it stopped. If the download still fails the file is
+//! truncated to its contiguous prefix, so resuming it with a single range
+//! request stays valid.
+//!
+//! Connections do not keep the same throughput, equal segments left the
+//! fast ones idle while the slowest one finished. A connection whose segment
+//! is done takes the end of the segment expected to finish last, in
+//! proportion to the throughput measured on both, until the parts left are
+//! too small to be worth a new request.
+//!
+//! Delta downloads fetch the ranges their old file lacks as segments too,
+//! over fewer connections than ranges, each taking the next range queued.
+
+use std::collections::VecDeque;
+use std::fs::File;
+use std::os::unix::fs::FileExt;
+use std::pin::Pin;
+use std::sync::atomic::{AtomicBool, AtomicU64, Ordering};
+use std::sync::{Arc, Mutex};
+use std::task::{Context, Poll};
+use std::time::Instant;
+
+use ylong_http_client::async_impl::{Body, DownloadOperator, Downloader, Response};
+use ylong_http_client::{ErrorKind, HttpClientError, SpeedLimit, Timeout};
+
+use super::client_pool::ClientPool;
+use super::cpu;
+use super::download::{LOW_SPEED_LIMIT, LOW_SPEED_TIME, SECONDS_IN_ONE_WEEK};
+use super::operator::TaskOperator;
+use super::reason::Reason;
+use super::request_task::{RequestTask, TaskError};
+use crate::task::task_control;
+use crate::utils::metrics;
+use crate::utils::runtime::io_spawn;
+
+/// Key of the config extra holding the number of segments to download in.
+pub(crate) const SEGMENTS_EXTRA: &str = "segments";
+
+/// Maximum number of segments of a download.
+const MAX_SEGMENTS: u64 = 8;
+
+/// Minimum size of a segment in bytes, smaller bodies use fewer segments.
+const MIN_SEGMENT_SIZE: u64 = 1024 * 1024;
+
+/// Attempts of a segment before the download fails.
+const SEGMENT_TRIES: u32 = 3;
+
+/// Minimum size in bytes of the part of a segment taken by another
+/// connection.
+const MIN_REBALANCE_SIZE: u64 = 256 * 1024;
+
+/// A byte range of the body, fetched over its own connection.
+pub(crate) struct Segment {
+    /// Offset of the first byte
+    start: u64,
+    /// Offset of the last byte, lowered when another connection takes the
+    /// end of the segment
+    end: Mutex<u64>,
+    /// Bytes of the segment written so far
+    written: AtomicU64,
+    /// Time the segment was created at
+    created: Instant,
+}
+
+impl Segment {
+    /// Creates a segment of the bytes from `start` to `end`, both included.
+    pub(crate) fn new(start: u64, end: u64) -> Self {
+        Self {
+            start,
+            end: Mutex::new(end),
+            written: AtomicU64::new(0),
+            created: Instant::now(),
+        }
+    }
+
+    /// Returns the offset of the last byte.
+    fn end(&self) -> u64 {
+        *self.end.lock().unwrap()
+    }
+
+    /// Returns the offset of the next byte to write.
+    fn next(&self) -> u64 {
+        self.start + self.written.load(Ordering::Acquire)
+    }
+
+    /// Returns the number of bytes not yet written.
+    fn remaining(&self) -> u64 {
+        (self.end() + 1).saturating_sub(self.next())
+    }
+
+    /// Returns the bytes written per millisecond since the segment was
+    /// created.
+    fn throughput(&self) -> f64 {
+        let elapsed = self.created.elapsed().as_millis().max(1) as f64;
+        self.written.load(Ordering::Acquire) as f64 / elapsed
+    }
+
+    /// Returns the milliseconds the segment is expected to take to finish.
+    fn time_left(&self) -> f64 {
+        match self.throughput() {
+            throughput if throughput > 0.0 => self.remaining() as f64 / throughput,
+            _ => f64::INFINITY,
+        }
+    }
+
+    /// Gives the end of the segment to a connection that fetches
+    /// `throughput` bytes per millisecond, in proportion to the throughput
+    /// of the segment.
+    ///
+    /// # Returns
+    ///
+    /// The new segment of the end, or `None` if it would be smaller than
+    /// `MIN_REBALANCE_SIZE`.
+    fn split_off(&self, throughput: f64) -> Option<Segment> {
+        let mut end = self.end.lock().unwrap();
+        let remaining = (*end + 1).saturating_sub(self.next());
+        let own = self.throughput();
+        let share = if own + throughput > 0.0 {
+            (remaining as f64 * throughput / (own + throughput)) as u64
+        } else {
+            remaining / 2
+        };
+        // The segment keeps a part, its connection is already open
+        let share = share.min(remaining.saturating_sub(MIN_REBALANCE_SIZE));
+        if share < MIN_REBALANCE_SIZE {
+            return None;
+        }
+        let old_end = *end;
+        *end -= share;
+        Some(Segment::new(*end + 1, old_end))
+    }
+}
+
+/// Error of a segment download.
+enum SegmentError {
+    /// The range request was answered with this status instead of 206
+    NotPartial(u16),
+    Http(HttpClientError),
+}
+
+impl SegmentError {
+    fn is_abort(&self) -> bool {
+        matches!(self, Self::Http(e) if e.error_kind() == ErrorKind::UserAborted)
+    }
+}
+
+impl From<HttpClientError> for SegmentError {
+    fn from(value: HttpClientError) -> Self {
+        Self::Http(value)
+    }
+}
+
+/// Splits `total` bytes into `count` contiguous segments of near equal size.
+///
+/// # Arguments
+///
+/// * `total` - Size of the body in bytes, at least 1.
+/// * `count` - Number of segments, at most `total`.
+pub(crate) fn split(total: u64, count: u64) -> Vec<Segment> {
+    let count = count.clamp(1, total.max(1));
+    let base = total / count;
+    let extra = total % count;
+    let mut start = 0;
+    (0..count)
+        .map(|i| {
+            let len = base + u64::from(i < extra);
+            let segment = Segment::new(start, start + len - 1);
+            start += len;
+            segment
+        })
+        .collect()
+}
+
+/// Returns the segments to download a response body in.
+///
+/// # Returns
+///
+/// `None` if the task did not opt in or the body must be downloaded over the
+/// connection of the response, because the response is not a full body, the
+/// server does not accept byte ranges, reports no validator or encodes the
+/// body, or the body is too small for two segments.
+pub(crate) fn plan(task: &RequestTask, response: &Response) -> Option<Vec<Segment>> {
+    let requested = task
+        .conf
+        .extras
+        .get(SEGMENTS_EXTRA)?
+        .parse::<u64>()
+        .ok()?
+        .min(MAX_SEGMENTS);
+    if !accepts_ranges(task, response) {
+        return None;
+    }
+    let total = u64::try_from(task.file_total_size.load(Ordering::SeqCst)).ok()?;
+    let count = requested.min(total / MIN_SEGMENT_SIZE);
+    if count < 2 {
+        return None;
+    }
+    Some(split(total, count))
+}
+
+/// Checks that the body of a response can be fetched again in ranges: the
+/// response is a full body that is not encoded, and the server accepts byte
+/// ranges and reports a validator for `If-Range`.
+pub(crate) fn accepts_ranges(task: &RequestTask, response: &Response) -> bool {
+    if response.status().as_u16() != 200 || task.require_range() {
+        return false;
+    }
+    let header = |name: &str| {
+        response
+            .headers()
+            .get(name)
+            .and_then(|value| value.to_string().ok())
+            .map(|value| value.trim().to_ascii_lowercase())
+    };
+    header("accept-ranges").as_deref() == Some("bytes")
+        && header("content-encoding").map_or(true, |encoding| encoding == "identity")
+        && (header("etag").is_some() || header("last-modified").is_some())
+}
+
+/// Returns the length of the written prefix of the body.
+pub(crate) fn contiguous(segments: &[Arc<Segment>]) -> u64 {
+    let mut segments = segments.iter().collect::<Vec<_>>();
+    segments.sort_by_key(|segment| segment.start);
+    segments
+        .iter()
+        .find(|segment| segment.remaining() > 0)
+        .or(segments.last())
+        .map_or(0, |segment| segment.next())
+}
+
+/// Splits the segment expected to finish last for a connection that fetched
+/// `throughput` bytes per millisecond, and adds the new segment to
+/// `segments`.
+fn rebalance(segments: &Mutex<Vec<Arc<Segment>>>, throughput: f64) -> Option<Arc<Segment>> {
+    let mut segments = segments.lock().unwrap();
+    let slowest = segments
+        .iter()
+        .filter(|segment| segment.remaining() > MIN_REBALANCE_SIZE)
+        .max_by(|a, b| a.time_left().total_cmp(&b.time_left()))?;
+    let segment = Arc::new(slowest.split_off(throughput)?);
+    segments.push(segment.clone());
+    Some(segment)
+}
+
+/// Downloads the segments in parallel into the first file of the task.
+///
+/// # Arguments
+///
+/// * `task` - The download task, whose first response was not downloaded.
+/// * `segments` - The segments returned by `plan`.
+/// * `connections` - Most connections opened at once, each one takes the next
+///   segment queued when it finishes its own.
+/// * `abort_flag` - An atomic flag used to signal download cancellation.
+///
+/// # Errors
+///
+/// Returns the error of the first segment that failed all its attempts, as
+/// `download_inner` reports it for a single connection.
+pub(crate) async fn download_segments(
+    task: Arc<RequestTask>,
+    segments: Vec<Segment>,
+    connections: usize,
+    abort_flag: Arc<AtomicBool>,
+) -> Result<(), TaskError> {
+    let Some(file) = task.files.get(0) else {
+        error!("download_segments err, no file in the `task`");
+        return Err(TaskError::Failed(Reason::OthersError));
+    };
+    let writer = match task_control::file_positional(&file.lock().unwrap()) {
+        Ok(writer) => Arc::new(writer),
+        Err(e) => {
+            error!("{} open segment writer failed {}", task.task_id(), e);
+            return Err(TaskError::Failed(Reason::IoError));
+        }
+    };
+    info!("{} downloading in {} segments", task.task_id(), segments.len());
+
+    let segments = segments.into_iter().map(Arc::new).collect::<Vec<_>>();
+    // Segments split off by the connections are added to the shared list
+    let all = Arc::new(Mutex::new(segments.clone()));
+    let queue = Arc::new(Mutex::new(VecDeque::from(segments)));
+    let stop = Arc::new(AtomicBool::new(false));
+    let connections = connections.clamp(1, queue.lock().unwrap().len().max(1));
+    let handles = (0..connections)
+        .map(|_| {
+            io_spawn(cpu::charged(
+                &task,
+                run_connection(
+                    task.clone(),
+                    writer.clone(),
+                    queue.clone(),
+                    all.clone(),
+                    abort_flag.clone(),
+                    stop.clone(),
+                ),
+            ))
+        })
+        .collect::<Vec<_>>();
+
+    let mut error = None;
+    for handle in handles {
+        let res = handle
+            .await
+            .unwrap_or_else(|e| Err(SegmentError::Http(HttpClientError::other(e))));
+        if let Err(e) = res {
+            // Segments stopped by a failed one report an abort, keep the cause
+            if error.as_ref().map_or(true, SegmentError::is_abort) {
+                error = Some(e);
+            }
+        }
+    }
+    let Some(error) = error else {
+        return Ok(());
+    };
+
+    let prefix = contiguous(&all.lock().unwrap());
+    info!("{} segments failed, keep {} bytes", task.task_id(), prefix);
+    task_control::file_set_len(file, prefix).await?;
+    task.processed.update(|files, total| {
+        if let Some(processed) = files.get_mut(0) {
+            *processed = prefix as usize;
+        }
+        *total = prefix as usize;
+    });
+    match error {
+        SegmentError::NotPartial(status) => {
+            error!("{} segment response {}", task.task_id(), status);
+            Err(TaskError::Failed(Reason::UnsupportedRangeRequest))
+        }
+        SegmentError::Http(e) => task.handle_download_error(e).await,
+    }
+}
+
+/// Downloads the segments queued over a connection, then the parts of the
+/// other segments it takes from them.
+async fn run_connection(
+    task: Arc<RequestTask>,
+    file: Arc<File>,
+    queue: Arc<Mutex<VecDeque<Arc<Segment>>>>,
+    segments: Arc<Mutex<Vec<Arc<Segment>>>>,
+    abort_flag: Arc<AtomicBool>,
+    stop: Arc<AtomicBool>,
+) -> Result<(), SegmentError> {
+    let mut throughput = 0.0;
+    loop {
+        let queued = queue.lock().unwrap().pop_front();
+        let segment = match queued {
+            Some(segment) => segment,
+            None => {
+                let Some(next) = rebalance(&segments, throughput) else {
+                    return Ok(());
+                };
+                debug!("{} segment rebalanced at {}", task.task_id(), next.start);
+                metrics::SEGMENTS_REBALANCED.add(1);
+                next
+            }
+        };
+        run_segment(&task, &file, &segment, &abort_flag, &stop).await?;
+        if stop.load(Ordering::Acquire) {
+            return Ok(());
+        }
+        throughput = segment.throughput();
+    }
+}
+
+/// Downloads a segment, retrying it from where it stopped.
+///
+/// A segment that fails all its attempts stops the other segments.
+async fn run_segment(
+    task: &Arc<RequestTask>,
+    file: &Arc<File>,
+    segment: &Arc<Segment>,
+    abort_flag: &Arc<AtomicBool>,
+    stop: &Arc<AtomicBool>,
+) -> Result<(), SegmentError> {
+    let mut tries = 1;
+    loop {
+        let e = match fetch_segment(task, file, segment, abort_flag, stop).await {
+            Ok(()) => return Ok(()),
+            Err(e) => e,
+        };
+        if e.is_abort() {
+            return Err(e);
+        }
+        if matches!(e, SegmentError::Http(_)) && tries < SEGMENT_TRIES {
+            tries += 1;
+            info!(
+                "{} retry segment at {}, try {}",
+                task.task_id(),
+                segment.next(),
+                tries
+            );
+            continue;
+        }
+        stop.store(true, Ordering::Release);
+        return Err(e);
+    }
+}
+
+/// Requests the rest of a segment and writes it into the file.
+async fn fetch_segment(
+    task: &Arc<RequestTask>,
+    file: &Arc<File>,
+    segment: &Arc<Segment>,
+    abort_flag: &Arc<AtomicBool>,
+    stop: &Arc<AtomicBool>,
+) -> Result<(), SegmentError> {
+    if segment.remaining() == 0 {
+        return Ok(());
+    }
+    // If-Range makes a changed body come back whole instead of mixed
+    let (builder, _) = task.support_range(task.build_request_builder()?);
+    let builder = task.range_request(builder, segment.next(), segment.end() as i64);
+    let request = builder.body(Body::slice(task.conf.data.clone()))?;
+    // The slot of the host is held until the body of the segment is written
+    let Some(_slot) = ClientPool::get_instance()
+        .host_slot(&task.conf.url, abort_flag)
+        .await
+    else {
+        return Err(HttpClientError::user_aborted().into());
+    };
+    let response = task.client.request(request).await?;
+    let status = response.status().as_u16();
+    if status != 206 {
+        return Err(SegmentError::NotPartial(status));
+    }
+
+    let operator = SegmentOperator {
+        inner: TaskOperator::new(task.clone(), abort_flag.clone()),
+        file: file.clone(),
+        segment: segment.clone(),
+        stop: stop.clone(),
+    };
+    let mut downloader = Downloader::builder()
+        .body(response)
+        .operator(operator)
+        .timeout(Timeout::from_secs(SECONDS_IN_ONE_WEEK))
+        .speed_limit(SpeedLimit::new().min_speed(LOW_SPEED_LIMIT, LOW_SPEED_TIME))
+        .build();
+    if let Err(e) = downloader.download().await {
+        // The connection is cut once another one took the rest of the range
+        if segment.remaining() == 0 && e.error_kind() != ErrorKind::UserAborted {
+            return Ok(());
+        }
+        return Err(e.into());
+    }
+    if segment.remaining() > 0 {
+        return Err(HttpClientError::other("segment body ended early").into());
+    }
+    Ok(())
+}
+
+/// Writes the body of a segment at its offset into the task file.
+///
+/// The task progress aggregates the bytes written by all segments.
+struct SegmentOperator {
+    /// Reports progress and applies the speed limit of the task
+    inner: TaskOperator,
+    /// Writer of the task file at offsets
+    file: Arc<File>,
+    segment: Arc<Segment>,
+    /// Set once another segment failed
+    stop: Arc<AtomicBool>,
+}
+
+impl DownloadOperator for SegmentOperator {
+    fn poll_download(
+        self: Pin<&mut Self>,
+        _cx: &mut Context<'_>,
+        data: &[u8],
+    ) -> Poll<Result<usize, HttpClientError>> {
+        if self.inner.abort_flag.load(Ordering::Acquire) || self.stop.load(Ordering::Acquire) {
+            return Poll::Ready(Err(HttpClientError::user_aborted()));
+        }
+        // The end is held so that no connection takes the bytes being written
+        let end = self.segment.end.lock().unwrap();
+        let offset = self.segment.next();
+        let len = data.len().min((*end + 1).saturating_sub(offset) as usize);
+        if let Err(e) = self.file.write_all_at(&data[..len], offset) {
+            return Poll::Ready(Err(HttpClientError::other(e)));
+        }
+        self.segment.written.fetch_add(len as u64, Ordering::Release);
+        drop(end);
+        self.inner
+            .task
+            .transferred
+            .fetch_add(len as u64, Ordering::AcqRel);
+        self.inner.task.processed.add(0, len);
+        if len < data.len() {
+            // Bytes past the end of the range, which may belong to another
+            // connection now, are not fetched
+            return Poll::Ready(Err(HttpClientError::other("segment range ended")));
+        }
+        Poll::Ready(Ok(data.len()))
+    }
+
+    fn poll_progress(
+        mut self: Pin<&mut Self>,
+        cx: &mut Context<'_>,
+        _downloaded: u64,
+        _total: Option<u64>,
+    ) -> Poll<Result<(), HttpClientError>> {
+        self.inner.poll_progress_common(cx)
+    }
+}
+
+#[cfg(test)]
+mod ut_segment {
+    include!("../../tests/ut/task/ut_segment.rs");
+}
@@ -12,100 +12,252 @@
 // limitations under the License.
 
 //! Speed limiting implementation for network operations.
-//! 
-//! This module provides a `SpeedLimiter` struct that can be used to control the rate
-//! of data transfer operations, ensuring they don't exceed specified speed limits.
+//!
+//! Transfers are limited by token buckets refilled every millisecond and
+//! holding at most `BURST_MILLIS` worth of tokens, so a limited transfer is
+//! smoothed instead of sent in bursts. Every transfer draws from the bucket of
+//! its task, the bucket of its uid if one is set and the global bucket, and
+//! waits until all of them are out of debt. Tasks of a uid share its bucket,
+//! so budget left unused by one task is taken by its siblings.
 
+use std::collections::HashMap;
 use std::future::Future;
 use std::pin::Pin;
+use std::sync::atomic::{AtomicU64, Ordering};
+use std::sync::{Arc, LazyLock, Mutex};
 use std::task::{Context, Poll};
 use std::time::Duration;
 
 use ylong_http_client::HttpClientError;
 use ylong_runtime::time::{sleep, Sleep};
 
-/// Controls the rate of data transfer operations.
-/// 
-/// This struct implements a token bucket-like algorithm to limit the speed of data transfers.
+/// Tokens kept by a bucket, in milliseconds of its rate.
+const BURST_MILLIS: u64 = 50;
+
+/// Token bucket limiting the transfers drawing from one budget.
+pub(crate) struct TokenBucket {
+    /// Refill rate in bytes per second, 0 if unlimited
+    rate: AtomicU64,
+    state: Mutex<BucketState>,
+}
+
+struct BucketState {
+    /// Tokens in thousandths of a byte, negative while in debt
+    tokens: i64,
+    /// Time of the last refill in milliseconds
+    last: u64,
+}
+
+impl TokenBucket {
+    /// Creates an unlimited bucket.
+    pub(crate) fn new() -> Self {
+        Self::with_rate(0)
+    }
+
+    fn with_rate(rate: u64) -> Self {
+        Self {
+            rate: AtomicU64::new(rate),
+            state: Mutex::new(BucketState { tokens: 0, last: 0 }),
+        }
+    }
+
+    /// Sets the rate in bytes per second, 0 to remove the limit.
+    pub(crate) fn set_rate(&self, rate: u64) {
+        if self.rate.swap(rate, Ordering::AcqRel) != rate {
+            // Tokens or debt of the old rate do not apply to the new one
+            let mut state = self.state.lock().unwrap();
+            state.tokens = 0;
+            state.last = 0;
+        }
+    }
+
+    /// Takes the tokens of transferred bytes, which may leave the bucket in
+    /// debt.
+    ///
+    /// # Arguments
+    ///
+    /// * `now` - Current timestamp in milliseconds.
+    /// * `bytes` - Bytes transferred since the last charge.
+    ///
+    /// # Returns
+    ///
+    /// Milliseconds until the debt is paid off, 0 if the bucket is not in debt.
+    pub(crate) fn charge(&self, now: u64, bytes: u64) -> u64 {
+        let rate = self.rate.load(Ordering::Acquire);
+        if rate == 0 {
+            return 0;
+        }
+        // One millisecond of a rate in bytes per second is the rate in
+        // thousandths of a byte
+        let capacity = rate.saturating_mul(BURST_MILLIS).min(i64::MAX as u64) as i64;
+        let mut state = self.state.lock().unwrap();
+        // A bucket charged for the first time starts full
+        let refill = match state.last {
+            0 => capacity,
+            last => rate.saturating_mul(now.saturating_sub(last)).min(i64::MAX as u64) as i64,
+        };
+        state.last = now;
+        state.tokens = state
+            .tokens
+            .saturating_add(refill)
+            .min(capacity)
+            .saturating_sub(bytes.saturating_mul(1000).min(i64::MAX as u64) as i64);
+        if state.tokens >= 0 {
+            0
+        } else {
+            (state.tokens.unsigned_abs() + rate - 1) / rate
+        }
+    }
+}
+
+/// Budget of a task, shared by all transfers of the task.
+pub(crate) struct TaskBudget {
+    bucket: TokenBucket,
+    /// Bytes of the task charged so far
+    charged: AtomicU64,
+}
+
+impl TaskBudget {
+    pub(crate) fn new() -> Self {
+        Self {
+            bucket: TokenBucket::new(),
+            charged: AtomicU64::new(0),
+        }
+    }
+
+    /// Returns the bytes processed since the last call, each byte is returned
+    /// once even if several transfers of the task report it.
+    fn take_uncharged(&self, processed: u64) -> u64 {
+        processed.saturating_sub(self.charged.swap(processed, Ordering::AcqRel))
+    }
+}
+
+/// Speed budgets above the tasks: a global one and one per uid.
+pub(crate) struct SpeedBudgets {
+    global: TokenBucket,
+    uids: Mutex<HashMap<u64, Arc<TokenBucket>>>,
+    /// Incremented whenever a uid budget is added or removed
+    generation: AtomicU64,
+}
+
+impl SpeedBudgets {
+    fn new() -> Self {
+        Self {
+            global: TokenBucket::new(),
+            uids: Mutex::new(HashMap::new()),
+            generation: AtomicU64::new(0),
+        }
+    }
+
+    /// Returns the budgets of the service.
+    pub(crate) fn get_instance() -> &'static Self {
+        static BUDGETS: LazyLock<SpeedBudgets> = LazyLock::new(SpeedBudgets::new);
+        &BUDGETS
+    }
+
+    /// Caps the sum of the speeds of all tasks, 0 to remove the cap.
+    pub(crate) fn set_global_limit(&self, rate: u64) {
+        info!("global speed limit {}", rate);
+        self.global.set_rate(rate);
+    }
+
+    /// Caps the sum of the speeds of the tasks of a uid, 0 to remove the cap.
+    pub(crate) fn set_uid_limit(&self, uid: u64, rate: u64) {
+        info!("uid {} speed limit {}", uid, rate);
+        let mut uids = self.uids.lock().unwrap();
+        match (uids.get(&uid), rate) {
+            (Some(bucket), rate) if rate != 0 => bucket.set_rate(rate),
+            (None, 0) => {}
+            (Some(_), _) => {
+                uids.remove(&uid);
+                self.generation.fetch_add(1, Ordering::Release);
+            }
+            (None, rate) => {
+                uids.insert(uid, Arc::new(TokenBucket::with_rate(rate)));
+                self.generation.fetch_add(1, Ordering::Release);
+            }
+        }
+    }
+
+    fn uid_bucket(&self, uid: u64) -> Option<Arc<TokenBucket>> {
+        self.uids.lock().unwrap().get(&uid).cloned()
+    }
+}
+
+/// Controls the rate of data transfer operations of one transfer.
 #[derive(Default)]
 pub(crate) struct SpeedLimiter {
-    /// Timestamp of the last speed check in milliseconds.
-    pub(crate) last_time: u64,
-    
-    /// Amount of data transferred at the last check in bytes.
-    pub(crate) last_size: u64,
-    
-    /// Maximum allowed transfer rate in bytes per second.
-    pub(crate) speed_limit: u64,
-    
+    /// Uid bucket of the task and the budget generation it was looked up in
+    uid_bucket: Option<(u64, Option<Arc<TokenBucket>>)>,
+
     /// Optional future for sleep operations when rate limiting is active.
     pub(crate) sleep: Option<Pin<Box<Sleep>>>,
 }
 
 impl SpeedLimiter {
-    /// Updates the speed limit and resets internal state if changed.
-    /// 
-    /// # Arguments
-    /// 
-    /// * `speed_limit` - New speed limit in bytes per second. A value of 0 disables limiting.
-    pub(crate) fn update_speed_limit(&mut self, speed_limit: u64) {
-        if self.speed_limit != speed_limit {
-            // Reset state when limit changes to ensure accurate speed measurement
-            self.last_size = 0;
-            self.last_time = 0;
-            self.sleep = None;
-            self.speed_limit = speed_limit;
-        }
-    }
-
-    /// Checks if the transfer rate exceeds the limit and applies throttling if needed.
-    /// 
+    /// Charges the bytes processed by the task and waits until its buckets
+    /// are out of debt.
+    ///
     /// This method implements a polling interface to integrate with asynchronous operations.
-    /// It calculates the current transfer speed and returns `Poll::Pending` if throttling is
-    /// required, causing the executor to wait until the speed is back within limits.
-    /// 
+    /// It returns `Poll::Pending` while the task, its uid or the service is over its
+    /// budget, causing the executor to wait until the budgets are refilled.
+    ///
     /// # Arguments
-    /// 
+    ///
     /// * `cx` - The task context for registering wakeups.
     /// * `current_time` - Current timestamp in milliseconds.
-    /// * `current_size` - Total number of bytes transferred so far.
-    /// 
+    /// * `current_size` - Total number of bytes processed by the task so far.
+    /// * `budget` - Budget of the task.
+    /// * `uid` - Uid of the task.
+    /// * `speed_limit` - Speed limit of the task in bytes per second, 0 for none.
+    ///
     /// # Returns
-    /// 
+    ///
     /// * `Poll::Ready(Ok(()))` - When the operation can proceed without throttling.
-    /// * `Poll::Pending` - When the transfer rate exceeds the limit and the operation should wait.
+    /// * `Poll::Pending` - When a budget is in debt and the operation should wait.
     pub(crate) fn poll_check_limit(
         &mut self,
         cx: &mut Context<'_>,
         current_time: u64,
         current_size: u64,
+        budget: &TaskBudget,
+        uid: u64,
+        speed_limit: u64,
     ) -> Poll<Result<(), HttpClientError>> {
-        // Interval for speed measurement in milliseconds
-        const SPEED_LIMIT_INTERVAL: u64 = 1000;
-        
-        self.sleep = None;
-        if self.speed_limit != 0 {
-            if self.last_time == 0 || current_time - self.last_time >= SPEED_LIMIT_INTERVAL {
-                // Initialize or reset measurement period
-                self.last_time = current_time;
-                self.last_size = current_size;
-            } else if current_time - self.last_time < SPEED_LIMIT_INTERVAL
-                && ((current_size - self.last_size) >= self.speed_limit)
-            {
-                // Calculate required sleep time to maintain speed limit
-                let limit_time = (current_size - self.last_size) * SPEED_LIMIT_INTERVAL
-                    / self.speed_limit
-                    - (current_time - self.last_time);
-                self.sleep = Some(Box::pin(sleep(Duration::from_millis(limit_time))));
+        // A transfer waiting out a debt checks again once it is paid off
+        if let Some(sleep) = self.sleep.as_mut() {
+            if sleep.as_mut().poll(cx).is_pending() {
+                return Poll::Pending;
             }
+            self.sleep = None;
         }
 
-        // Check if we need to wait for the sleep future
-        if let Some(sleep) = self.sleep.as_mut() {
-            if Pin::new(sleep).poll(cx).is_pending() {
+        let budgets = SpeedBudgets::get_instance();
+        let generation = budgets.generation.load(Ordering::Acquire);
+        if self.uid_bucket.as_ref().map(|(g, _)| *g) != Some(generation) {
+            self.uid_bucket = Some((generation, budgets.uid_bucket(uid)));
+        }
+
+        budget.bucket.set_rate(speed_limit);
+        let bytes = budget.take_uncharged(current_size);
+        let mut wait = budget.bucket.charge(current_time, bytes);
+        if let Some((_, Some(bucket))) = self.uid_bucket.as_ref() {
+            wait = wait.max(bucket.charge(current_time, bytes));
+        }
+        wait = wait.max(budgets.global.charge(current_time, bytes));
+
+        if wait > 0 {
+            let mut sleep = Box::pin(sleep(Duration::from_millis(wait)));
+            if sleep.as_mut().poll(cx).is_pending() {
+                self.sleep = Some(sleep);
                 return Poll::Pending;
             }
         }
         Poll::Ready(Ok(()))
     }
 }
+
+#[cfg(test)]
+mod ut_speed_limiter {
+    include!("../../tests/ut/task/ut_speed_limiter.rs");
+}
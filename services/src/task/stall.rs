@@ -0,0 +1,147 @@
+// Copyright (C) 2023 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Stall detection of a download connection.
+//!
+//! The bytes received are sampled at most once per `SAMPLE_INTERVAL` while
+//! the body arrives. The throughput over the last window is compared with
+//! the throughput of up to `HISTORY` before it, so the threshold follows what
+//! the connection of the task achieved instead of a fixed speed. A window
+//! below the configured ratio of that history is a stall, the download is
+//! then reconnected and resumed with a range request.
+
+use std::collections::VecDeque;
+
+use crate::task::config::StallDetection;
+
+/// Default window in milliseconds the current throughput is measured over.
+pub(crate) const DEFAULT_STALL_WINDOW: u64 = 10 * 1000;
+
+/// Default percent of the history throughput below which a window stalls.
+pub(crate) const DEFAULT_STALL_RATIO: u64 = 10;
+
+/// Maximum number of reconnections after a stall in a run of a task, later
+/// stalls are left to the minimum speed of the downloader.
+pub(crate) const MAX_STALL_RECONNECTS: u32 = 3;
+
+/// Message of the error a download fails with when it stalls.
+pub(crate) const STALL_MESSAGE: &str = "Download stalled";
+
+/// Minimum interval in milliseconds between two samples.
+const SAMPLE_INTERVAL: u64 = 1000;
+
+/// Time in milliseconds before the window whose throughput is the history.
+const HISTORY: u64 = 60 * 1000;
+
+/// Minimum window in milliseconds, shorter ones are mostly sampling noise.
+const MIN_WINDOW: u64 = 2 * SAMPLE_INTERVAL;
+
+/// Throughput in bytes per second below which the history is too slow to
+/// tell a stall from the usual speed of the connection.
+const MIN_HISTORY_SPEED: u64 = 1024;
+
+/// Compares the throughput of a connection with its own history.
+pub(crate) struct StallDetector {
+    /// Window in milliseconds
+    window: u64,
+    /// Percent of the history throughput
+    ratio: u64,
+    /// Time in milliseconds and bytes received when sampled
+    samples: VecDeque<(u64, u64)>,
+    /// Speed limit of the task when the samples were taken
+    speed_limit: u64,
+}
+
+impl StallDetector {
+    /// Creates a detector from the settings of a task.
+    ///
+    /// # Returns
+    ///
+    /// `None` if the task disabled the detection with a negative ratio.
+    pub(crate) fn new(config: &StallDetection) -> Option<Self> {
+        if config.ratio < 0 {
+            return None;
+        }
+        let window = match config.window {
+            0 => DEFAULT_STALL_WINDOW,
+            window => (window as u64).max(MIN_WINDOW),
+        };
+        let ratio = match config.ratio {
+            0 => DEFAULT_STALL_RATIO,
+            ratio => ratio as u64,
+        };
+        Some(Self {
+            window,
+            ratio,
+            samples: VecDeque::new(),
+            speed_limit: 0,
+        })
+    }
+
+    /// Samples the bytes `received` by `now` and checks the last window.
+    ///
+    /// A change of the speed limit drops the history, the throughput before
+    /// it says nothing about the connection after it.
+    ///
+    /// # Returns
+    ///
+    /// `true` if the connection stalled.
+    pub(crate) fn check(&mut self, now: u64, received: u64, speed_limit: u64) -> bool {
+        if speed_limit != self.speed_limit {
+            self.speed_limit = speed_limit;
+            self.samples.clear();
+        }
+        if let Some(&(last, _)) = self.samples.back() {
+            if now < last + SAMPLE_INTERVAL {
+                return false;
+            }
+        }
+        self.samples.push_back((now, received));
+
+        // The front stays the latest sample at the start of the history
+        let start = now.saturating_sub(self.window + HISTORY);
+        while self.samples.len() > 1 && self.samples[1].0 <= start {
+            self.samples.pop_front();
+        }
+
+        // The latest sample a whole window ago splits history and window
+        let Some(&(split, split_bytes)) = self
+            .samples
+            .iter()
+            .rev()
+            .find(|(time, _)| *time + self.window <= now)
+        else {
+            return false;
+        };
+        let (first, first_bytes) = self.samples[0];
+        let history = split - first;
+        if history < self.window {
+            return false;
+        }
+        let history_bytes = split_bytes.saturating_sub(first_bytes) as u128;
+        if history_bytes * 1000 < MIN_HISTORY_SPEED as u128 * history as u128 {
+            return false;
+        }
+
+        // current / window < ratio% * history_bytes / history
+        let history = history as u128;
+        let window = (now - split) as u128;
+        let window_bytes = received.saturating_sub(split_bytes) as u128;
+        window_bytes * 100 * history < history_bytes * self.ratio as u128 * window
+    }
+}
+
+#[cfg(test)]
+mod ut_stall {
+    include!("../../tests/ut/task/ut_stall.rs");
+}
@@ -16,14 +16,49 @@
 //! This module provides utility functions for spawning blocking operations in async context
 //! and performing file operations in a thread-safe manner, primarily used for HTTP request tasks.
 
-use std::fs::{File, Metadata};
+use std::fs::{File, Metadata, OpenOptions};
 use std::io::{self, Seek, SeekFrom, Write};
+use std::os::fd::AsRawFd;
+use std::os::raw::{c_int, c_uint, c_ulong};
+use std::os::unix::fs::MetadataExt;
 use std::sync::{Arc, Mutex};
 
 use ylong_runtime::task::JoinHandle;
 
 use crate::task::request_task::RequestTask;
 
+/// Allocates the range without changing the file size.
+const FALLOC_FL_KEEP_SIZE: c_int = 1;
+
+/// Expects the file to be read from lower to higher offsets.
+const POSIX_FADV_SEQUENTIAL: c_int = 2;
+
+/// Drops the cached pages of a range that are not dirty.
+const POSIX_FADV_DONTNEED: c_int = 4;
+
+/// Waits for the write-back of the range already started.
+const SYNC_FILE_RANGE_WAIT_BEFORE: c_uint = 1;
+
+/// Starts the write-back of the dirty pages of the range.
+const SYNC_FILE_RANGE_WRITE: c_uint = 2;
+
+/// Waits for the write-back of the range to complete.
+const SYNC_FILE_RANGE_WAIT_AFTER: c_uint = 4;
+
+/// Bytes before a write that are dropped from the page cache after it, more
+/// than any single write so no range is skipped.
+const WRITE_BEHIND_WINDOW: u64 = 8 * 1024 * 1024;
+
+/// Shares the extents of another file, `_IOW(0x94, 9, int)`.
+const FICLONE: c_ulong = 0x4004_9409;
+
+extern "C" {
+    fn fallocate(fd: c_int, mode: c_int, offset: i64, len: i64) -> c_int;
+    fn posix_fadvise(fd: c_int, offset: i64, len: i64, advice: c_int) -> c_int;
+    fn sync_file_range(fd: c_int, offset: i64, nbytes: i64, flags: c_uint) -> c_int;
+    fn ioctl(fd: c_int, request: c_ulong, ...) -> c_int;
+}
+
 /// Spawns a blocking operation that returns a result.
 /// 
 /// This function wraps `ylong_runtime::spawn_blocking` to provide a consistent interface
@@ -167,6 +202,101 @@ pub(crate) async fn file_set_len(file: Arc<Mutex<File>>, size: u64) -> io::Resul
     .map_err(|e| io::Error::new(io::ErrorKind::Other, e))?
 }
 
+/// Reserves disk space for a range of a file asynchronously, without changing
+/// the file size.
+///
+/// # Arguments
+///
+/// * `file` - A thread-safe reference to the file.
+/// * `offset` - The start of the range.
+/// * `len` - The length of the range.
+///
+/// # Returns
+///
+/// `Ok(())` if the operation succeeds.
+///
+/// # Errors
+///
+/// Returns the OS error if the space cannot be reserved, or an error if the
+/// blocking task fails.
+pub(crate) async fn file_preallocate(
+    file: Arc<Mutex<File>>,
+    offset: u64,
+    len: u64,
+) -> io::Result<()> {
+    runtime_spawn_blocking(move || {
+        let file = file.lock().unwrap();
+        let (Ok(offset), Ok(len)) = (i64::try_from(offset), i64::try_from(len)) else {
+            return Err(io::Error::from(io::ErrorKind::InvalidInput));
+        };
+        // SAFETY: The descriptor stays open while the file lock is held.
+        let ret = unsafe { fallocate(file.as_raw_fd(), FALLOC_FL_KEEP_SIZE, offset, len) };
+        if ret == 0 {
+            Ok(())
+        } else {
+            Err(io::Error::last_os_error())
+        }
+    })
+    .await
+    .map_err(|e| io::Error::new(io::ErrorKind::Other, e))?
+}
+
+/// Tells the kernel a file is read sequentially from `offset` to its end,
+/// which makes it read ahead further.
+///
+/// # Errors
+///
+/// Returns the OS error if the advice is rejected.
+pub(crate) fn file_advise_sequential(file: &File, offset: u64) -> io::Result<()> {
+    let Ok(offset) = i64::try_from(offset) else {
+        return Err(io::Error::from(io::ErrorKind::InvalidInput));
+    };
+    // SAFETY: The descriptor is owned by `file`, which outlives the call.
+    match unsafe { posix_fadvise(file.as_raw_fd(), offset, 0, POSIX_FADV_SEQUENTIAL) } {
+        0 => Ok(()),
+        errno => Err(io::Error::from_raw_os_error(errno)),
+    }
+}
+
+/// Keeps the data written to a file out of the page cache, once `len` bytes
+/// were written up to `end`.
+///
+/// The write-back of the new bytes is started without waiting. The bytes
+/// written before them, whose write-back the previous call started, are
+/// waited for and dropped from the page cache. A large download then keeps
+/// about two writes of its file cached instead of evicting the pages of the
+/// applications. Blocks on the storage, only for the blocking pool.
+///
+/// # Errors
+///
+/// Returns the OS error if the file system rejects the calls, the data is
+/// then written through the page cache as usual.
+pub(crate) fn file_write_behind(file: &File, end: u64, len: u64) -> io::Result<()> {
+    let (Ok(end), Ok(len)) = (i64::try_from(end), i64::try_from(len)) else {
+        return Err(io::Error::from(io::ErrorKind::InvalidInput));
+    };
+    let start = end - len;
+    let fd = file.as_raw_fd();
+    // SAFETY: The descriptor is owned by `file`, which outlives the calls.
+    if unsafe { sync_file_range(fd, start, len, SYNC_FILE_RANGE_WRITE) } != 0 {
+        return Err(io::Error::last_os_error());
+    }
+    let behind = start.min(WRITE_BEHIND_WINDOW as i64);
+    if behind == 0 {
+        return Ok(());
+    }
+    let flags = SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER;
+    // SAFETY: As above.
+    if unsafe { sync_file_range(fd, start - behind, behind, flags) } != 0 {
+        return Err(io::Error::last_os_error());
+    }
+    // SAFETY: As above.
+    match unsafe { posix_fadvise(fd, start - behind, behind, POSIX_FADV_DONTNEED) } {
+        0 => Ok(()),
+        errno => Err(io::Error::from_raw_os_error(errno)),
+    }
+}
+
 /// Writes all bytes from a buffer to a file asynchronously.
 /// 
 /// # Arguments
@@ -192,6 +322,60 @@ pub(crate) async fn file_write_all<'a>(file: Arc<Mutex<File>>, buf: &[u8]) -> io
     .map_err(|e| io::Error::new(io::ErrorKind::Other, e))?
 }
 
+/// Replaces the content of a file with the content of another.
+///
+/// The extents of `src` are shared with `dst` where the file system supports
+/// reflinks, the bytes are copied otherwise. Nothing is done if both are the
+/// same file.
+///
+/// # Returns
+///
+/// The length of `dst` afterwards, its cursor is left at the end.
+///
+/// # Errors
+///
+/// Returns an error if the file operations fail or if the blocking task fails.
+pub(crate) async fn file_clone_from(
+    dst: Arc<Mutex<File>>,
+    src: Arc<Mutex<File>>,
+) -> io::Result<u64> {
+    runtime_spawn_blocking(move || {
+        if Arc::ptr_eq(&dst, &src) {
+            return src.lock().unwrap().seek(SeekFrom::End(0));
+        }
+        let mut src = src.lock().unwrap();
+        let mut dst = dst.lock().unwrap();
+        let (src_meta, dst_meta) = (src.metadata()?, dst.metadata()?);
+        if src_meta.dev() == dst_meta.dev() && src_meta.ino() == dst_meta.ino() {
+            return dst.seek(SeekFrom::End(0));
+        }
+        dst.set_len(0)?;
+        // Task files are opened for appending, which reflinks reject, so the
+        // extents are shared through a plain writer of the same file.
+        let cloned = file_positional(&dst)
+            // SAFETY: Both descriptors stay open for the duration of the call.
+            .map(|writer| unsafe { ioctl(writer.as_raw_fd(), FICLONE, src.as_raw_fd()) } == 0)
+            .unwrap_or(false);
+        if !cloned {
+            src.seek(SeekFrom::Start(0))?;
+            io::copy(&mut *src, &mut *dst)?;
+        }
+        dst.seek(SeekFrom::End(0))
+    })
+    .await
+    .map_err(|e| io::Error::new(io::ErrorKind::Other, e))?
+}
+
+/// Opens another descriptor of a task file that writes at offsets.
+///
+/// Task files are opened for appending, the kernel moves the positional
+/// writes to them to the end of the file.
+pub(crate) fn file_positional(file: &File) -> io::Result<File> {
+    OpenOptions::new()
+        .write(true)
+        .open(format!("/proc/self/fd/{}", file.as_raw_fd()))
+}
+
 /// Clears a downloaded file and resets its progress tracking.
 /// 
 /// This function truncates the first file in the task to zero length and resets
@@ -228,17 +412,22 @@ pub(crate) async fn clear_downloaded_file(task: Arc<RequestTask>) -> Result<(),
         }
         
         // Reset progress tracking
-        {
-            let mut progress_guard = task.progress.lock().unwrap();
-            progress_guard.common_data.total_processed = 0;
-            if let Some(elem) = progress_guard.processed.get_mut(0) {
+        task.processed.update(|files, total| {
+            *total = 0;
+            if let Some(elem) = files.get_mut(0) {
                 *elem = 0; // Reset individual file progress
             } else {
                 info!("Failed to get a process size from an empty vector in Progress");
             }
-        }
+        });
         Ok(())
     })
     .await
     .map_err(|e| io::Error::new(io::ErrorKind::Other, e))?
 }
+
+// Built by the `rust_request_io_benchmark` target only.
+#[cfg(all(test, io_bench))]
+mod bench_cache_bypass {
+    include!("../../tests/bench/bench_cache_bypass.rs");
+}
@@ -0,0 +1,82 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Throughput estimation of the running tasks.
+//!
+//! The bytes a task transferred are sampled with its progress notifications
+//! and smoothed into an exponentially weighted moving average, from which
+//! the time left is estimated. Both are sent with the progress, so that
+//! applications no longer diff the processed bytes of their callbacks.
+
+/// Time constant of the average in milliseconds: a sample weighs about as
+/// much as the samples of the previous `SMOOTHING` milliseconds together.
+const SMOOTHING: f64 = 3000.0;
+
+/// Gap between samples in milliseconds after which the task is considered
+/// to have stopped transferring, paused or waiting for the scheduler, and
+/// the average starts over.
+const IDLE_GAP: u64 = 5000;
+
+/// Smoothed throughput of a task.
+#[derive(Default)]
+pub(crate) struct Throughput {
+    /// Average speed in bytes per second, 0 before the first interval.
+    speed: f64,
+    /// Time and bytes transferred when last sampled.
+    last: Option<(u64, u64)>,
+}
+
+impl Throughput {
+    /// Samples the bytes the task transferred so far at `time`, in
+    /// milliseconds.
+    pub(crate) fn sample(&mut self, time: u64, transferred: u64) {
+        match self.last {
+            Some((last_time, last_transferred))
+                if time > last_time && time - last_time <= IDLE_GAP =>
+            {
+                let elapsed = (time - last_time) as f64;
+                let speed = transferred.saturating_sub(last_transferred) as f64 * 1000.0 / elapsed;
+                if self.speed == 0.0 {
+                    self.speed = speed;
+                } else {
+                    // The weight depends on the interval, notifications are
+                    // not evenly spaced.
+                    let alpha = 1.0 - (-elapsed / SMOOTHING).exp();
+                    self.speed += alpha * (speed - self.speed);
+                }
+            }
+            Some((last_time, _)) if time <= last_time => return,
+            Some(_) => self.speed = 0.0,
+            None => {}
+        }
+        self.last = Some((time, transferred));
+    }
+
+    /// Average speed in bytes per second.
+    pub(crate) fn speed(&self) -> u64 {
+        self.speed as u64
+    }
+
+    /// Estimated seconds left to transfer `remaining` bytes, -1 if unknown.
+    pub(crate) fn eta(&self, remaining: i64) -> i64 {
+        if remaining < 0 || self.speed < 1.0 {
+            return -1;
+        }
+        (remaining as f64 / self.speed).ceil() as i64
+    }
+}
+
+#[cfg(test)]
+mod ut_throughput {
+    include!("../../tests/ut/task/ut_throughput.rs");
+}
@@ -0,0 +1,248 @@
+// Copyright (C) 2024 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Performance timeline of the tasks.
+//!
+//! Each task records when it was queued, scheduled and with which QoS tier,
+//! when the response headers of a transfer arrived and how long after the
+//! request, when its first bytes were written, its pauses, resumes and end.
+//! The speed of a running task is sampled with its progress notifications.
+//! The last `TIMELINE_EVENTS` events and `TIMELINE_SAMPLES` samples of the
+//! last `TIMELINE_TASKS` tasks are kept, also after the tasks ended, and are
+//! shown as JSON by the `-p` option of hidumper.
+
+use std::collections::{HashMap, VecDeque};
+use std::fmt::Write;
+use std::sync::{LazyLock, Mutex};
+
+use crate::manage::scheduler::QosLevel;
+use crate::task::reason::Reason;
+use crate::utils::get_current_timestamp;
+
+/// Number of tasks whose timeline is kept.
+pub(crate) const TIMELINE_TASKS: usize = 128;
+
+/// Number of events kept in the timeline of a task.
+pub(crate) const TIMELINE_EVENTS: usize = 64;
+
+/// Number of speed samples kept in the timeline of a task.
+pub(crate) const TIMELINE_SAMPLES: usize = 60;
+
+/// Step of a task recorded in its timeline.
+#[derive(Clone, Copy, PartialEq, Debug)]
+pub(crate) enum Phase {
+    /// The task was started and waits for the scheduler.
+    Queued,
+    /// The scheduler started the task with a QoS tier.
+    Scheduled(QosLevel),
+    /// The response headers of a transfer arrived, `ttfb` milliseconds after
+    /// the request was sent, connection included.
+    Response { status: u32, ttfb: u64 },
+    /// The first bytes of the run were written to the file.
+    FirstWrite,
+    /// The task was paused.
+    Paused,
+    /// The task was resumed.
+    Resumed,
+    /// The task completed.
+    Completed,
+    /// The task failed.
+    Failed(Reason),
+}
+
+impl Phase {
+    fn write_json(&self, out: &mut String) {
+        match self {
+            Phase::Queued => out.push_str("\"phase\":\"queued\""),
+            Phase::Scheduled(level) => {
+                let tier = match level {
+                    QosLevel::High => "high",
+                    QosLevel::Middle => "middle",
+                    QosLevel::Low => "low",
+                };
+                let _ = write!(out, "\"phase\":\"scheduled\",\"tier\":\"{}\"", tier);
+            }
+            Phase::Response { status, ttfb } => {
+                let _ = write!(
+                    out,
+                    "\"phase\":\"response\",\"status\":{},\"ttfb\":{}",
+                    status, ttfb
+                );
+            }
+            Phase::FirstWrite => out.push_str("\"phase\":\"first_write\""),
+            Phase::Paused => out.push_str("\"phase\":\"paused\""),
+            Phase::Resumed => out.push_str("\"phase\":\"resumed\""),
+            Phase::Completed => out.push_str("\"phase\":\"completed\""),
+            Phase::Failed(reason) => {
+                let _ = write!(out, "\"phase\":\"failed\",\"reason\":{}", reason.repr);
+            }
+        }
+    }
+}
+
+/// Events and speed samples of a task, times in milliseconds since the epoch.
+pub(crate) struct Timeline {
+    events: VecDeque<(u64, Phase)>,
+    /// Time and speed in bytes per second.
+    samples: VecDeque<(u64, u64)>,
+    /// Time and bytes transferred by the run when last sampled.
+    last_sample: Option<(u64, u64)>,
+    /// Whether the first write of the run was recorded.
+    written: bool,
+    updated: u64,
+}
+
+impl Timeline {
+    fn new() -> Self {
+        Self {
+            events: VecDeque::with_capacity(TIMELINE_EVENTS),
+            samples: VecDeque::new(),
+            last_sample: None,
+            written: false,
+            updated: 0,
+        }
+    }
+
+    /// Records an event, dropping the oldest one if the timeline is full.
+    pub(crate) fn record(&mut self, time: u64, phase: Phase) {
+        match phase {
+            // A new run counts its bytes and its first write from zero.
+            Phase::Scheduled(_) => {
+                self.last_sample = None;
+                self.written = false;
+            }
+            Phase::FirstWrite if self.written => return,
+            Phase::FirstWrite => self.written = true,
+            _ => {}
+        }
+        if self.events.len() == TIMELINE_EVENTS {
+            self.events.pop_front();
+        }
+        self.events.push_back((time, phase));
+        self.updated = time;
+    }
+
+    /// Samples the speed of the run from the bytes it transferred so far.
+    pub(crate) fn sample(&mut self, time: u64, transferred: u64) {
+        if let Some((last_time, last_transferred)) = self.last_sample {
+            if time > last_time {
+                let speed =
+                    transferred.saturating_sub(last_transferred) * 1000 / (time - last_time);
+                if self.samples.len() == TIMELINE_SAMPLES {
+                    self.samples.pop_front();
+                }
+                self.samples.push_back((time, speed));
+            }
+        }
+        self.last_sample = Some((time, transferred));
+        self.updated = time;
+    }
+
+    fn write_json(&self, task_id: u32, out: &mut String) {
+        let _ = write!(out, "{{\"task_id\":{},\"events\":[", task_id);
+        for (i, (time, phase)) in self.events.iter().enumerate() {
+            if i != 0 {
+                out.push(',');
+            }
+            let _ = write!(out, "{{\"time\":{},", time);
+            phase.write_json(out);
+            out.push('}');
+        }
+        out.push_str("],\"samples\":[");
+        for (i, (time, speed)) in self.samples.iter().enumerate() {
+            if i != 0 {
+                out.push(',');
+            }
+            let _ = write!(out, "{{\"time\":{},\"speed\":{}}}", time, speed);
+        }
+        out.push_str("]}");
+    }
+}
+
+/// Timelines of the last tasks of the service.
+pub(crate) struct Timelines {
+    tasks: Mutex<HashMap<u32, Timeline>>,
+}
+
+impl Timelines {
+    fn new() -> Self {
+        Self {
+            tasks: Mutex::new(HashMap::new()),
+        }
+    }
+
+    /// Returns the timelines of the service.
+    pub(crate) fn get_instance() -> &'static Self {
+        static TIMELINES: LazyLock<Timelines> = LazyLock::new(Timelines::new);
+        &TIMELINES
+    }
+
+    /// Records an event of a task now.
+    pub(crate) fn record(&self, task_id: u32, phase: Phase) {
+        let now = get_current_timestamp();
+        self.with_timeline(task_id, |timeline| timeline.record(now, phase));
+    }
+
+    /// Samples the speed of a task from the bytes its run transferred.
+    pub(crate) fn sample(&self, task_id: u32, transferred: u64) {
+        let now = get_current_timestamp();
+        self.with_timeline(task_id, |timeline| timeline.sample(now, transferred));
+    }
+
+    fn with_timeline<F: FnOnce(&mut Timeline)>(&self, task_id: u32, f: F) {
+        let mut tasks = self.tasks.lock().unwrap();
+        if !tasks.contains_key(&task_id) && tasks.len() == TIMELINE_TASKS {
+            // Forgets the task updated the longest ago.
+            let oldest = tasks
+                .iter()
+                .min_by_key(|(_, timeline)| timeline.updated)
+                .map(|(task_id, _)| *task_id);
+            if let Some(oldest) = oldest {
+                tasks.remove(&oldest);
+            }
+        }
+        f(tasks.entry(task_id).or_insert_with(Timeline::new));
+    }
+
+    /// Formats the timeline of a task as a JSON object, or those of all the
+    /// kept tasks as a JSON array if `task_id` is `None`.
+    ///
+    /// # Returns
+    ///
+    /// `None` if the timeline of the task is not kept.
+    pub(crate) fn dump(&self, task_id: Option<u32>) -> Option<String> {
+        let tasks = self.tasks.lock().unwrap();
+        let mut out = String::new();
+        match task_id {
+            Some(task_id) => tasks.get(&task_id)?.write_json(task_id, &mut out),
+            None => {
+                let mut ids = tasks.keys().copied().collect::<Vec<_>>();
+                ids.sort_unstable();
+                out.push('[');
+                for (i, task_id) in ids.iter().enumerate() {
+                    if i != 0 {
+                        out.push(',');
+                    }
+                    tasks[task_id].write_json(*task_id, &mut out);
+                }
+                out.push(']');
+            }
+        }
+        Some(out)
+    }
+}
+
+#[cfg(test)]
+mod ut_timeline {
+    include!("../../tests/ut/task/ut_timeline.rs");
+}
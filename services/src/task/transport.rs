@@ -0,0 +1,111 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! HTTP clients the downloads of the service are sent with.
+//!
+//! Tasks use ylong_http_client unless the build selects the netstack of the
+//! system with `request_transport = "netstack"`, or a task asks for a client
+//! with the `transport` extra of its config, `ylong` or `netstack`. The
+//! netstack shares the connection pool, proxy and certificates of the
+//! system with the other components already warming them up.
+//!
+//! The netstack sends a download as one plain GET to the first byte of the
+//! file or where it stopped. A task needing more than that, a range, a
+//! proxy or certificates of its own, a decoded, extracted, segmented or
+//! delta body, is sent with ylong_http_client whatever it asked for.
+//! Uploads are always sent with ylong_http_client, their bodies streaming
+//! from the files.
+
+use super::config::{Action, TaskConfig};
+use super::extract::EXTRACT_EXTRA;
+use super::request_task::RequestTask;
+
+/// Key of the config extra selecting the client of a task.
+pub(crate) const TRANSPORT_EXTRA: &str = "transport";
+
+/// HTTP client a download is sent with.
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub(crate) enum Transport {
+    /// ylong_http_client, in the service.
+    Ylong,
+    /// The netstack of the system.
+    Netstack,
+}
+
+impl Transport {
+    /// Parses the name of a client.
+    fn parse(name: &str) -> Option<Self> {
+        match name {
+            "ylong" => Some(Self::Ylong),
+            "netstack" => Some(Self::Netstack),
+            _ => None,
+        }
+    }
+
+    /// Returns the client the build selects for the tasks.
+    pub(crate) fn global() -> Self {
+        option_env!("REQUEST_TRANSPORT")
+            .and_then(Self::parse)
+            .unwrap_or(Self::Ylong)
+    }
+
+    /// Returns the client a task asked for, or the one of the build.
+    fn wanted(config: &TaskConfig) -> Self {
+        config
+            .extras
+            .get(TRANSPORT_EXTRA)
+            .and_then(|name| Self::parse(name))
+            .unwrap_or_else(Self::global)
+    }
+
+    /// Returns the client a task is sent with, the one it wants if it can
+    /// be.
+    pub(crate) fn of(task: &RequestTask) -> Self {
+        match Self::wanted(&task.conf) {
+            Self::Netstack if !cfg!(feature = "oh") || !netstack_supports(&task.conf) => {
+                debug!("task {} sent with ylong", task.task_id());
+                Self::Ylong
+            }
+            wanted => wanted,
+        }
+    }
+}
+
+/// Whether the netstack can send a task: a GET of a whole file without
+/// options of ylong_http_client. The netstack always follows redirects.
+fn netstack_supports(config: &TaskConfig) -> bool {
+    let common = &config.common_data;
+    common.action == Action::Download
+        && config.file_specs.len() == 1
+        && matches!(config.method.to_uppercase().as_str(), "" | "GET")
+        && common.begins == 0
+        && common.ends < 0
+        && common.redirect
+        && !common.compression
+        && config.proxy.is_empty()
+        && config.certs_path.is_empty()
+        && config.certificate_pins.is_empty()
+        && !config.extras.contains_key(EXTRACT_EXTRA)
+}
+
+/// Handle of a transfer of a client, the transfer being cancelled when the
+/// handle is dropped.
+pub(crate) trait TransportHandle: Send + Sync {
+    /// Cancels the transfer.
+    fn cancel(&self);
+}
+
+#[cfg(test)]
+mod ut_transport {
+    include!("../../tests/ut/task/ut_transport.rs");
+}
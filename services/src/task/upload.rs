@@ -17,28 +17,71 @@
 //! multipart form data uploads, and batch uploads. It handles file reading, progress tracking,
 //! request construction, and error handling for upload tasks.
 
+use std::collections::VecDeque;
 use std::future::Future;
-use std::io::{Read, SeekFrom};
+use std::fs::File;
+use std::io::{Seek, SeekFrom};
+use std::os::unix::fs::FileExt;
 use std::pin::Pin;
 use std::sync::atomic::{AtomicBool, Ordering};
-use std::sync::Arc;
+use std::sync::{Arc, Mutex};
 use std::task::{Context, Poll};
 use std::time::Instant;
 
-use ylong_http_client::async_impl::{Body, MultiPart, Part, Request, UploadOperator, Uploader};
-use ylong_http_client::{ErrorKind, HttpClientError, ReusableReader, Timeout};
+use request_utils::compress::{ContentEncoder, ContentEncoding};
+use ylong_http_client::async_impl::{
+    Body, Request, RequestBuilder, Response, UploadOperator, Uploader,
+};
+use ylong_http_client::{ErrorKind, HttpClientError, ReusableReader};
 use ylong_runtime::io::{AsyncRead, ReadBuf};
 
+use super::client_pool::{ClientPool, MAX_CONNECTIONS_PER_HOST};
+use super::config::Action;
+use super::cpu;
+use super::file_io::{self, Submission};
 use super::info::State;
+use super::multipart::{self, MultipartBody};
 use super::operator::TaskOperator;
 use super::reason::Reason;
 use super::request_task::{TaskError, TaskPhase};
 use super::task_control;
 use crate::manage::database::RequestDb;
 use crate::task::request_task::RequestTask;
+use crate::task::timeline::{Phase, Timelines};
 #[cfg(feature = "oh")]
 use crate::trace::Trace;
-use crate::utils::get_current_duration;
+use crate::utils::memory_budget::{Reservation, BUDGET};
+use crate::utils::{get_current_duration, get_current_timestamp};
+use crate::utils::runtime::io_spawn;
+
+/// Builds the upload request of the file at an index.
+type BuildRequest = fn(Arc<RequestTask>, usize, Arc<AtomicBool>) -> Option<Request>;
+
+/// Version of the resumable upload protocol (tus) the chunks are sent with.
+const TUS_VERSION: &str = "1.0.0";
+
+/// Content type of the body of a chunk.
+const CHUNK_CONTENT_TYPE: &str = "application/offset+octet-stream";
+
+/// Bytes of a file read at once on the blocking pool.
+const READ_AHEAD_SIZE: usize = 256 * 1024;
+
+/// Key of the config extra holding the pre-signed urls the parts of a
+/// parallel upload are sent to, one per line in the order of the parts.
+pub(crate) const PART_URLS_EXTRA: &str = "part_urls";
+
+/// Key of the config extra holding the url completing a parallel upload.
+pub(crate) const PART_COMPLETE_EXTRA: &str = "part_complete_url";
+
+/// Key of the config extra holding the `Content-Encoding` the body of an
+/// upload is compressed with, `gzip` or `deflate`.
+pub(crate) const UPLOAD_ENCODING_EXTRA: &str = "upload_encoding";
+
+/// Parts of a parallel upload sent at the same time.
+const PART_CONNECTIONS: usize = 4;
+
+/// Tries of a part of a parallel upload before the upload fails.
+const PART_TRIES: usize = 3;
 
 /// A reader that reads data from a task's file for upload operations.
 /// 
@@ -51,6 +94,26 @@ struct TaskReader {
     pub(crate) index: usize,
     /// Tracks bytes read during reuse operations.
     pub(crate) reused: Option<usize>,
+    /// Size of the file to upload.
+    size: usize,
+    /// Whether the file was set as the current one of the progress.
+    index_reported: bool,
+    /// Duplicate descriptor of the file and offset of the next read.
+    source: Option<(Arc<File>, u64)>,
+    /// Bytes read ahead of the body and how many of them were sent.
+    ahead: (Vec<u8>, usize),
+    /// Completion of the read running on the blocking pool.
+    reading: Option<Submission<Vec<u8>>>,
+    /// Memory budget reserved for the read, released once its bytes are sent.
+    reservation: Option<Reservation>,
+    /// Offset in the file and length of the chunk of a resumable upload.
+    chunk: Option<(u64, usize)>,
+    /// Bytes of the chunk read since the body was started or reused.
+    chunk_read: usize,
+    /// Encoding the body is compressed with.
+    encoding: Option<ContentEncoding>,
+    /// Encoder of the body, until its end was encoded.
+    encoder: Option<ContentEncoder>,
 }
 
 impl TaskReader {
@@ -61,10 +124,87 @@ impl TaskReader {
     /// * `task` - The request task containing the file to read.
     /// * `index` - The index of the file to read from the task's files collection.
     pub(crate) fn new(task: Arc<RequestTask>, index: usize) -> Self {
+        let size = task.progress.lock().unwrap().sizes.get(index).copied().unwrap_or(0);
+        // Files sent at the same time leave the index to `upload_files`
+        let index_reported = task.upload_concurrency() > 1;
         Self {
             task,
             index,
             reused: None,
+            size: size as usize,
+            index_reported,
+            source: None,
+            ahead: (Vec::new(), 0),
+            reading: None,
+            reservation: None,
+            chunk: None,
+            chunk_read: 0,
+            encoding: None,
+            encoder: None,
+        }
+    }
+
+    /// Compresses the bytes read with `encoding`, the progress still counts
+    /// the bytes of the file.
+    fn encode(mut self, encoding: ContentEncoding) -> Self {
+        self.encoding = Some(encoding);
+        self.encoder = Some(ContentEncoder::new(encoding));
+        self
+    }
+
+    /// Limits the reader to the `len` bytes of the file from `offset`.
+    fn chunk(mut self, offset: u64, len: usize) -> Self {
+        self.chunk = Some((offset, len));
+        self
+    }
+
+    /// Returns the descriptor the file is read through and the offset of the
+    /// next read.
+    ///
+    /// The descriptor is duplicated on the first read, at the start of the
+    /// chunk or else at the cursor the file was positioned at. Later reads are
+    /// positioned and take neither the file lock nor the cursor shared with
+    /// the other users of the file.
+    fn source(&mut self) -> std::io::Result<&mut (Arc<File>, u64)> {
+        if self.source.is_none() {
+            let file = self
+                .task
+                .files
+                .get(self.index)
+                .ok_or(std::io::Error::from(std::io::ErrorKind::NotFound))?;
+            let mut file = file.lock().unwrap();
+            let offset = match self.chunk {
+                Some((offset, _)) => offset,
+                None => file.stream_position()?,
+            };
+            let file = file.try_clone()?;
+            if let Err(e) = task_control::file_advise_sequential(&file, offset) {
+                debug!("task {} advise file {} failed {}", self.task.task_id(), self.index, e);
+            }
+            self.source = Some((Arc::new(file), offset));
+        }
+        Ok(self.source.as_mut().unwrap())
+    }
+
+    /// Counts `size` bytes of the file as read, in the progress of the task
+    /// unless the body is sent again.
+    fn count_read(&mut self, size: usize, ranged: bool) {
+        match self.reused {
+            Some(uploaded) if ranged => self.reused = Some(uploaded + size),
+            _ => {
+                self.task.processed.add(self.index, size);
+                if ranged {
+                    self.report_index();
+                }
+            }
+        }
+    }
+
+    /// Sets the file as the current one of the progress, once.
+    fn report_index(&mut self) {
+        if !self.index_reported {
+            self.task.progress.lock().unwrap().common_data.index = self.index;
+            self.index_reported = true;
         }
     }
 }
@@ -72,78 +212,118 @@ impl TaskReader {
 impl AsyncRead for TaskReader {
     /// Attempts to read data from the task's file into the provided buffer.
     /// 
-    /// Handles progress tracking and resume operations for upload tasks.
+    /// Handles progress tracking and resume operations for upload tasks. The
+    /// file is read at the offset of the reader, without its lock, by reads
+    /// of up to `READ_AHEAD_SIZE` bytes run on the blocking pool. The bytes
+    /// read ahead are sent before the next read is submitted, which waits for
+    /// room in the memory budget of the transfers. A compressed body encodes
+    /// the bytes as they are read, counting them in the progress then.
     /// 
     /// # Arguments
     /// 
-    /// * `cx` - The task context (unused in this implementation).
+    /// * `cx` - The task context, woken when a read completes or the memory
+    ///   budget has room for one.
     /// * `buf` - The buffer to read data into.
     /// 
     /// # Returns
     /// 
     /// A `Poll` indicating whether the read is ready or pending.
     fn poll_read(
-        mut self: Pin<&mut Self>,
-        _cx: &mut Context<'_>,
+        self: Pin<&mut Self>,
+        cx: &mut Context<'_>,
         buf: &mut ReadBuf<'_>,
     ) -> Poll<std::io::Result<()>> {
-        let index = self.index;
-        let file = self
-            .task
-            .files
-            .get(index)
-            .ok_or(std::io::Error::from(std::io::ErrorKind::NotFound))?;
-
-        // Obtain `file`` first and then `progress` to prevent deadlocks.
-        // This lock ordering is critical to avoid deadlocks when multiple operations access
-        // the same task's resources concurrently.
-        let mut file = file.lock().unwrap();
-        let mut progress_guard = self.task.progress.lock().unwrap();
-
-        if self.task.conf.common_data.index == index as u32 || progress_guard.processed[index] != 0
-        {
-            let total_upload_bytes = if let Some(uploaded) = self.reused {
-                progress_guard.sizes[index] as usize - uploaded
-            } else {
-                progress_guard.sizes[index] as usize - progress_guard.processed[index]
-            };
-            let buf_filled_len = buf.filled().len();
-            let mut read_buf = buf.take(total_upload_bytes);
-            match file.read(read_buf.initialize_unfilled()) {
-                Ok(size) => {
-                    let upload_size = read_buf.filled().len() + size;
-                    read_buf.set_filled(upload_size);
-                    // need update buf.filled and buf.initialized
-                    buf.assume_init(upload_size);
-                    buf.set_filled(buf_filled_len + upload_size);
-                    match self.reused {
-                        None => {
-                            progress_guard.processed[index] += upload_size;
-                            progress_guard.common_data.total_processed += upload_size;
-                            progress_guard.common_data.index = index;
-                        }
-                        Some(uploaded) => {
-                            drop(progress_guard);
-                            self.reused = Some(uploaded + upload_size);
+        let this = self.get_mut();
+        let index = this.index;
+        let processed = this.task.processed.file(index);
+
+        // Only the rest of a chunk or a partially uploaded file is read
+        let ranged = this.chunk.is_some()
+            || this.task.conf.common_data.index == index as u32
+            || processed != 0;
+        while this.ahead.1 == this.ahead.0.len() {
+            let mut reading = match this.reading.take() {
+                Some(reading) => reading,
+                None => {
+                    // Nothing is read ahead, the bytes read so far were all sent
+                    let remaining = match (this.chunk, this.reused) {
+                        (Some((_, len)), _) => len - this.chunk_read,
+                        (None, Some(uploaded)) if ranged => this.size - uploaded,
+                        (None, None) if ranged => this.size - this.task.processed.file(index),
+                        _ => usize::MAX,
+                    };
+                    if remaining == 0 {
+                        match this.encoder.take() {
+                            Some(mut encoder) => {
+                                let mut encoded = Vec::new();
+                                encoder.finish(&mut encoded);
+                                this.ahead = (encoded, 0);
+                                continue;
+                            }
+                            None => return Poll::Ready(Ok(())),
                         }
                     }
-                    Poll::Ready(Ok(()))
+                    let len = READ_AHEAD_SIZE.min(remaining);
+                    match BUDGET.poll_reserve(cx, len) {
+                        Poll::Ready(reservation) => this.reservation = Some(reservation),
+                        Poll::Pending => return Poll::Pending,
+                    }
+                    let (file, offset) = this.source()?;
+                    let (file, offset) = (file.clone(), *offset);
+                    file_io::submit(move || {
+                        let mut data = vec![0; len];
+                        let size = file.read_at(&mut data, offset)?;
+                        data.truncate(size);
+                        Ok(data)
+                    })
                 }
-                Err(e) => Poll::Ready(Err(e)),
+            };
+            let Poll::Ready(res) = Pin::new(&mut reading).poll(cx) else {
+                this.reading = Some(reading);
+                return Poll::Pending;
+            };
+            let data = res?;
+            if let Some((_, offset)) = this.source.as_mut() {
+                *offset += data.len() as u64;
             }
-        } else {
-            match file.read(buf.initialize_unfilled()) {
-                Ok(size) => {
-                    let current_filled_len = buf.filled().len() + size;
-                    buf.set_filled(current_filled_len);
-
-                    progress_guard.processed[index] += size;
-                    progress_guard.common_data.total_processed += size;
-                    Poll::Ready(Ok(()))
-                }
-                Err(e) => Poll::Ready(Err(e)),
+            let Some(encoder) = this.encoder.as_mut() else {
+                this.ahead = (data, 0);
+                break;
+            };
+            // Bytes short of a block are encoded with the next read
+            let mut encoded = Vec::new();
+            if data.is_empty() {
+                encoder.finish(&mut encoded);
+                this.encoder = None;
+            } else {
+                encoder.encode(&data, &mut encoded);
             }
+            this.ahead = (encoded, 0);
+            this.count_read(data.len(), ranged);
+        }
+        let size = {
+            let (data, sent) = &mut this.ahead;
+            let unfilled = buf.initialize_unfilled();
+            let size = unfilled.len().min(data.len() - *sent);
+            unfilled[..size].copy_from_slice(&data[*sent..*sent + size]);
+            *sent += size;
+            size
+        };
+        if this.ahead.1 == this.ahead.0.len() {
+            this.ahead = (Vec::new(), 0);
+            this.reservation = None;
         }
+        let filled = buf.filled().len() + size;
+        buf.set_filled(filled);
+        this.chunk_read += size;
+
+        this.task
+            .transferred
+            .fetch_add(size as u64, Ordering::AcqRel);
+        if this.encoding.is_none() {
+            this.count_read(size, ranged);
+        }
+        Poll::Ready(Ok(()))
     }
 }
 
@@ -163,11 +343,26 @@ impl ReusableReader for TaskReader {
         Self: 'a,
     {
         self.reused = Some(0);
+        // The next read starts at the cursor positioned below
+        self.source = None;
+        self.ahead = (Vec::new(), 0);
+        self.reading = None;
+        self.reservation = None;
+        self.chunk_read = 0;
+        self.encoder = self.encoding.map(ContentEncoder::new);
         let index = self.index;
         let optional_file = self.task.files.get(index);
         
         // Determine the appropriate file position based on task configuration
-        if self.task.conf.common_data.index == index as u32 {
+        if let Some((offset, _)) = self.chunk {
+            let task = self.task.clone();
+            Box::pin(async move {
+                match task.seek_upload_file(index, offset).await {
+                    true => Ok(()),
+                    false => Err(std::io::Error::from(std::io::ErrorKind::NotFound)),
+                }
+            })
+        } else if self.task.conf.common_data.index == index as u32 {
             let begins = self.task.conf.common_data.begins;
             Box::pin(async move {
                 let file = optional_file.ok_or(std::io::Error::from(std::io::ErrorKind::NotFound))?;
@@ -228,8 +423,12 @@ fn build_stream_request(
     abort_flag: Arc<AtomicBool>,
 ) -> Option<Request> {
     debug!("build stream request");
-    let task_reader = TaskReader::new(task.clone(), index);
+    let mut task_reader = TaskReader::new(task.clone(), index);
     let task_operator = TaskOperator::new(task.clone(), abort_flag);
+    let encoding = task.upload_encoding();
+    if let Some(encoding) = encoding {
+        task_reader = task_reader.encode(encoding);
+    }
 
     match task.build_request_builder() {
         Ok(mut request_builder) => {
@@ -243,19 +442,31 @@ fn build_stream_request(
             let upload_length;
             {
                 let progress = task.progress.lock().unwrap();
-                upload_length = progress.sizes[index] as u64 - progress.processed[index] as u64;
+                upload_length = progress.sizes[index] as u64 - task.processed.file(index) as u64;
             }
             debug!("upload length is {}", upload_length);
             
-            // Set content length header
-            request_builder =
-                request_builder.header("Content-Length", upload_length.to_string().as_str());
+            // Set content length header, a compressed body is sent in chunks
+            // as its length is only known at its end
+            let total_bytes = match encoding {
+                Some(encoding) => {
+                    request_builder = request_builder
+                        .header("Content-Encoding", encoding.as_str())
+                        .header("Transfer-Encoding", "chunked");
+                    None
+                }
+                None => {
+                    request_builder = request_builder
+                        .header("Content-Length", upload_length.to_string().as_str());
+                    Some(upload_length)
+                }
+            };
             
             // Build the uploader with streaming body
             let uploader = Uploader::builder()
                 .reader(task_reader)
                 .operator(task_operator)
-                .total_bytes(Some(upload_length))
+                .total_bytes(total_bytes)
                 .build();
             let request = request_builder.body(Body::stream(uploader));
             build_request_common(&task, index, request)
@@ -264,6 +475,67 @@ fn build_stream_request(
     }
 }
 
+/// Builds the request asking the server how many bytes of the upload of
+/// the task it stored.
+///
+/// # Returns
+///
+/// A `HEAD` request to the url of the task, or `None` if construction fails.
+fn build_offset_request(task: &Arc<RequestTask>, index: usize) -> Option<Request> {
+    debug!("build offset request");
+    let request = task.build_request_builder().and_then(|request_builder| {
+        request_builder
+            .method("HEAD")
+            .header("Tus-Resumable", TUS_VERSION)
+            .body(Body::empty())
+    });
+    build_request_common(task, index, request)
+}
+
+/// Builds the request of a resumable upload sending the `len` bytes of the
+/// file at `index` from `offset`.
+///
+/// # Returns
+///
+/// A `PATCH` request to the url of the task, or `None` if construction fails.
+fn build_chunk_request(
+    task: Arc<RequestTask>,
+    index: usize,
+    offset: u64,
+    len: u64,
+    abort_flag: Arc<AtomicBool>,
+) -> Option<Request> {
+    debug!("build chunk request {} from {}", len, offset);
+    let task_reader = TaskReader::new(task.clone(), index).chunk(offset, len as usize);
+    let task_operator = TaskOperator::new(task.clone(), abort_flag);
+
+    let request = task.build_request_builder().and_then(|request_builder| {
+        let uploader = Uploader::builder()
+            .reader(task_reader)
+            .operator(task_operator)
+            .total_bytes(Some(len))
+            .build();
+        request_builder
+            .method("PATCH")
+            .header("Tus-Resumable", TUS_VERSION)
+            .header("Upload-Offset", offset.to_string().as_str())
+            .header("Content-Type", CHUNK_CONTENT_TYPE)
+            .header("Content-Length", len.to_string().as_str())
+            .body(Body::stream(uploader))
+    });
+    build_request_common(&task, index, request)
+}
+
+/// Returns the bytes of the upload the server stored, from the
+/// `Upload-Offset` header of a response.
+fn upload_offset(response: &Response) -> Option<u64> {
+    response
+        .headers()
+        .get("upload-offset")
+        .and_then(|value| value.to_string().ok())
+        .and_then(|value| value.trim().parse().ok())
+}
+
 /// Builds a multipart form-data upload request for a single file.
 /// 
 /// Constructs an HTTP request with multipart form data for file uploads,
@@ -287,49 +559,61 @@ fn build_multipart_request(
     let task_reader = TaskReader::new(task.clone(), index);
     let task_operator = TaskOperator::new(task.clone(), abort_flag);
     
-    // Create multipart form data
-    let mut multi_part = MultiPart::new();
-    
     // Add form fields
-    for item in task.conf.form_items.iter() {
-        let part = Part::new()
-            .name(item.name.as_str())
-            .body(item.value.as_str());
-        multi_part = multi_part.part(part);
-    }
+    let mut body = form_fields(&task);
     
     // Calculate upload length for the file
     let upload_length;
     {
         let progress = task.progress.lock().unwrap();
-        upload_length = progress.sizes[index] as u64 - progress.processed[index] as u64;
+        upload_length = progress.sizes[index] as u64 - task.processed.file(index) as u64;
     }
     debug!("upload length is {}", upload_length);
     
     // Add file part
-    let part = Part::new()
-        .name(task.conf.file_specs[index].name.as_str())
-        .file_name(task.conf.file_specs[index].file_name.as_str())
-        .mime(task.conf.file_specs[index].mime_type.as_str())
-        .length(Some(upload_length))
-        .stream(task_reader);
-
-    multi_part = multi_part.part(part);
-    
-    // Build the multipart uploader
-    let uploader = Uploader::builder()
-        .multipart(multi_part)
-        .operator(task_operator)
-        .build();
+    let spec = &task.conf.file_specs[index];
+    body = body.file(
+        spec.name.as_str(),
+        spec.file_name.as_str(),
+        spec.mime_type.as_str(),
+        upload_length,
+        task_reader,
+    );
+    build_form_request(&task, index, body, task_operator)
+}
 
-    match task.build_request_builder() {
-        Ok(request_builder) => {
-            let request: Result<Request, HttpClientError> =
-                request_builder.body(Body::multipart(uploader));
-            build_request_common(&task, index, request)
-        }
-        Err(err) => build_request_common(&task, index, Err(err)),
+/// Starts a multipart body with the form fields of a task.
+fn form_fields(task: &RequestTask) -> MultipartBody<TaskReader> {
+    let mut body = MultipartBody::new(multipart::boundary());
+    for item in task.conf.form_items.iter() {
+        body = body.text(item.name.as_str(), item.value.as_str());
     }
+    body
+}
+
+/// Builds the request sending a multipart body, whose exact length is sent
+/// as its `Content-Length`.
+fn build_form_request(
+    task: &Arc<RequestTask>,
+    index: usize,
+    body: MultipartBody<TaskReader>,
+    task_operator: TaskOperator,
+) -> Option<Request> {
+    let length = body.len();
+    debug!("multipart body length is {}", length);
+    let request = task.build_request_builder().and_then(|request_builder| {
+        let content_type = body.content_type();
+        let uploader = Uploader::builder()
+            .reader(body)
+            .operator(task_operator)
+            .total_bytes(Some(length))
+            .build();
+        request_builder
+            .header("Content-Type", content_type.as_str())
+            .header("Content-Length", length.to_string().as_str())
+            .body(Body::stream(uploader))
+    });
+    build_request_common(task, index, request)
 }
 
 /// Builds a multipart form-data upload request for multiple files in a batch.
@@ -351,52 +635,30 @@ fn build_batch_multipart_request(
     _index: usize,
     abort_flag: Arc<AtomicBool>,
 ) -> Option<Request> {
-    // Create multipart form data
-    let mut multi_part = MultiPart::new();
     let task_operator = TaskOperator::new(task.clone(), abort_flag);
     let start = task.progress.lock().unwrap().common_data.index;
     info!("multi part upload task {}", task.task_id());
 
     // Add form fields
-    for item in task.conf.form_items.iter() {
-        let part = Part::new()
-            .name(item.name.as_str())
-            .body(item.value.as_str());
-
-        multi_part = multi_part.part(part);
-    }
+    let mut body = form_fields(&task);
     
     // Add all files from the current progress index
     for index in start..task.conf.file_specs.len() {
         let task_reader = TaskReader::new(task.clone(), index);
         let upload_length = {
             let progress = task.progress.lock().unwrap();
-            progress.sizes[index] as u64 - progress.processed[index] as u64
+            progress.sizes[index] as u64 - task.processed.file(index) as u64
         };
-        let part = Part::new()
-            .name(task.conf.file_specs[index].name.as_str())
-            .file_name(task.conf.file_specs[index].file_name.as_str())
-            .mime(task.conf.file_specs[index].mime_type.as_str())
-            .length(Some(upload_length))
-            .stream(task_reader);
-
-        multi_part = multi_part.part(part);
-    }
-
-    // Build the multipart uploader
-    let uploader = Uploader::builder()
-        .multipart(multi_part)
-        .operator(task_operator)
-        .build();
-
-    match task.build_request_builder() {
-        Ok(request_builder) => {
-            let request: Result<Request, HttpClientError> =
-                request_builder.body(Body::multipart(uploader));
-            build_request_common(&task, 0, request)
-        }
-        Err(err) => build_request_common(&task, 0, Err(err)),
+        let spec = &task.conf.file_specs[index];
+        body = body.file(
+            spec.name.as_str(),
+            spec.file_name.as_str(),
+            spec.mime_type.as_str(),
+            upload_length,
+            task_reader,
+        );
     }
+    build_form_request(&task, 0, body, task_operator)
 }
 
 /// Common request construction handler.
@@ -446,27 +708,37 @@ impl RequestTask {
     /// 
     /// `true` if preparation succeeded, `false` otherwise.
     async fn prepare_single_upload(&self, index: usize) -> bool {
-        let Some(file) = self.files.get(index) else {
-            error!("task {} file {} not found", self.task_id(), index);
-            return false;
-        };
-        
         // Initialize or reset progress tracking
         {
             let mut progress = self.progress.lock().unwrap();
-            if self.upload_resume.load(Ordering::SeqCst) {
-                // Reset the resume flag without resetting progress
-                self.upload_resume.store(false, Ordering::SeqCst);
-            } else {
-                // Start fresh upload for this file
-                progress.processed[index] = 0;
-            }
+            // Reset the resume flag without resetting progress
+            let resume = self.upload_resume.swap(false, Ordering::SeqCst);
+            self.processed.update(|files, total| {
+                if !resume {
+                    // Start fresh upload for this file
+                    files[index] = 0;
+                }
+                *total = files.iter().take(index).sum();
+            });
             progress.common_data.index = index;
-            progress.common_data.total_processed = progress.processed.iter().take(index).sum();
         }
 
-        let processed = self.progress.lock().unwrap().processed[index] as u64;
-        
+        let processed = self.processed.file(index) as u64;
+        self.seek_upload_file(index, processed).await
+    }
+
+    /// Positions the cursor of the file at `index` after its `processed`
+    /// bytes.
+    ///
+    /// # Returns
+    ///
+    /// `true` if the file was found and positioned, `false` otherwise.
+    async fn seek_upload_file(&self, index: usize, processed: u64) -> bool {
+        let Some(file) = self.files.get(index) else {
+            error!("task {} file {} not found", self.task_id(), index);
+            return false;
+        };
+
         // Position the file cursor appropriately
         if self.conf.common_data.index == index as u32 {
             // Special handling for the current indexed file
@@ -492,6 +764,121 @@ impl RequestTask {
         .is_ok()
     }
 
+    /// Returns whether the files are sent as multipart form data.
+    fn upload_form_data(&self) -> bool {
+        match self.conf.headers.get("Content-Type") {
+            Some(s) => s.eq("multipart/form-data"),
+            None => self.conf.method.to_uppercase().eq("POST"),
+        }
+    }
+
+    /// Returns the size of the chunks the files are sent in, if the task is
+    /// a resumable upload.
+    ///
+    /// Only files sent as the whole body of a request can be resumed, batch
+    /// and form data uploads are sent in one request.
+    pub(crate) fn upload_chunk_size(&self) -> Option<u64> {
+        let common_data = &self.conf.common_data;
+        if common_data.action != Action::Upload
+            || common_data.multipart
+            || common_data.chunk_size == 0
+            || self.upload_form_data()
+            || self.upload_part_urls().is_some()
+        {
+            return None;
+        }
+        Some(common_data.chunk_size)
+    }
+
+    /// Returns the encoding the body of the upload is compressed with, if the
+    /// task asked for one and sends its files as whole bodies.
+    ///
+    /// Form data, batch, resumable and parallel uploads are sent as they
+    /// are, as are bodies the application encoded itself.
+    pub(crate) fn upload_encoding(&self) -> Option<ContentEncoding> {
+        let common_data = &self.conf.common_data;
+        if common_data.action != Action::Upload
+            || common_data.multipart
+            || self.upload_form_data()
+            || self.upload_chunk_size().is_some()
+            || self.upload_part_urls().is_some()
+            || self
+                .conf
+                .headers
+                .keys()
+                .any(|name| name.eq_ignore_ascii_case("Content-Encoding"))
+        {
+            return None;
+        }
+        ContentEncoding::parse(self.conf.extras.get(UPLOAD_ENCODING_EXTRA)?)
+    }
+
+    /// Returns the urls the parts of the file are sent to, if the task is a
+    /// parallel upload of a single file to object storage.
+    ///
+    /// The file is split into as many parts of the same size as there are
+    /// urls, the last one shorter.
+    pub(crate) fn upload_part_urls(&self) -> Option<Vec<String>> {
+        let common_data = &self.conf.common_data;
+        if common_data.action != Action::Upload
+            || common_data.multipart
+            || self.conf.file_specs.len() != 1
+            || self.upload_form_data()
+            || self
+                .conf
+                .extras
+                .get(PART_COMPLETE_EXTRA)
+                .map_or(true, |url| url.is_empty())
+        {
+            return None;
+        }
+        let urls = self
+            .conf
+            .extras
+            .get(PART_URLS_EXTRA)?
+            .lines()
+            .map(str::trim)
+            .filter(|url| !url.is_empty())
+            .map(String::from)
+            .collect::<Vec<_>>();
+        (!urls.is_empty()).then_some(urls)
+    }
+
+    /// Sets the bytes of the file at `index` the server confirmed as the
+    /// processed bytes of it.
+    fn checkpoint_upload(&self, index: usize, offset: u64) {
+        self.processed.update(|files, total| {
+            files[index] = offset as usize;
+            *total = files.iter().sum();
+        });
+    }
+
+    /// Returns the number of files uploaded at the same time.
+    ///
+    /// Only files sent in requests of their own are uploaded at the same time,
+    /// at most as many as requests to a host can be in flight.
+    pub(crate) fn upload_concurrency(&self) -> usize {
+        if self.conf.common_data.action != Action::Upload
+            || self.conf.common_data.multipart
+            || self.upload_chunk_size().is_some()
+        {
+            return 1;
+        }
+        (self.conf.common_data.concurrency as usize)
+            .min(MAX_CONNECTIONS_PER_HOST)
+            .min(self.conf.file_specs.len())
+            .max(1)
+    }
+
+    /// Returns whether the file at `index` was uploaded completely.
+    ///
+    /// A file whose upload failed is counted from zero again, so only the
+    /// files of a finished request are complete.
+    fn file_uploaded(&self, index: usize) -> bool {
+        let size = self.progress.lock().unwrap().sizes.get(index).copied().unwrap_or(0);
+        size > 0 && self.processed.file(index) as i64 == size
+    }
+
     /// Prepares multiple files for batch upload.
     /// 
     /// Determines the current file index based on total processed bytes,
@@ -513,7 +900,7 @@ impl RequestTask {
         {
             let mut progress = self.progress.lock().unwrap();
 
-            let total = progress.common_data.total_processed;
+            let total = self.processed.total();
             let file_sizes = &progress.sizes;
             let mut current_size = 0;
             
@@ -527,13 +914,14 @@ impl RequestTask {
             }
             
             // Handle resume or reset progress
-            if self.upload_resume.load(Ordering::SeqCst) {
-                self.upload_resume.store(false, Ordering::SeqCst);
-            } else {
-                progress.processed[current_index] = 0;
-            }
+            let resume = self.upload_resume.swap(false, Ordering::SeqCst);
+            self.processed.update(|files, total| {
+                if !resume {
+                    files[current_index] = 0;
+                }
+                *total = files.iter().take(current_index).sum();
+            });
             progress.common_data.index = current_index;
-            progress.common_data.total_processed = progress.processed.iter().take(current_index).sum();
         }
 
         // Prepare each file in the batch
@@ -542,7 +930,7 @@ impl RequestTask {
                 error!("task {} file {} not found", self.task_id(), index);
                 return false;
             };
-            let processed = self.progress.lock().unwrap().processed[index] as u64;
+            let processed = self.processed.file(index) as u64;
             
             // Calculate target seek position
             let target_start = if self.conf.common_data.index == index as u32 {
@@ -671,29 +1059,41 @@ async fn upload_inner(
         )
         .await?
     } else {
-        // Determine if multipart encoding is needed
-        let is_multipart = match task.conf.headers.get("Content-Type") {
-            Some(s) => s.eq("multipart/form-data"),
-            None => task.conf.method.to_uppercase().eq("POST"),
+        // Select appropriate request builder based on content type
+        let func: BuildRequest = match task.upload_form_data() {
+            true => build_multipart_request,
+            false => build_stream_request,
         };
-        
-        // Upload files one by one
-        for index in start..size {
-            #[cfg(feature = "oh")]
-            let _trace = Trace::new(&format!("upload file:{} index:{}", task.task_id(), index));
 
-            // Prepare individual file for upload
-            if !task.prepare_single_upload(index).await {
-                return Err(TaskError::Failed(Reason::OthersError));
-            }
+        let concurrency = task.upload_concurrency();
+        if concurrency > 1 {
+            upload_files(task.clone(), start, concurrency, abort_flag.clone(), func).await?;
+        } else {
+            // Upload files one by one
+            for index in start..size {
+                #[cfg(feature = "oh")]
+                let _trace =
+                    Trace::new(&format!("upload file:{} index:{}", task.task_id(), index));
 
-            // Select appropriate request builder based on content type
-            let func = match is_multipart {
-                true => build_multipart_request,
-                false => build_stream_request,
-            };
-            upload_one_file(task.clone(), index, abort_flag.clone(), func).await?;
-            task.notify_header_receive();
+                // Prepare individual file for upload
+                if !task.prepare_single_upload(index).await {
+                    return Err(TaskError::Failed(Reason::OthersError));
+                }
+                if let Some(urls) = task.upload_part_urls() {
+                    upload_parts(task.clone(), index, urls, abort_flag.clone()).await?
+                } else {
+                    match task.upload_chunk_size() {
+                        Some(chunk_size) => {
+                            upload_chunks(task.clone(), index, chunk_size, abort_flag.clone())
+                                .await?
+                        }
+                        None => {
+                            upload_one_file(task.clone(), index, abort_flag.clone(), func).await?
+                        }
+                    }
+                }
+                task.notify_header_receive();
+            }
         }
     }
 
@@ -701,9 +1101,169 @@ async fn upload_inner(
     Ok(())
 }
 
+/// Files of an upload sent at the same time.
+struct UploadQueue {
+    /// Files not started yet.
+    pending: Mutex<VecDeque<usize>>,
+    /// Whether each file was uploaded.
+    done: Mutex<Vec<bool>>,
+    /// Set once a file failed, no other file is started after it.
+    stop: AtomicBool,
+}
+
+impl UploadQueue {
+    /// Takes the next file to upload.
+    fn next(&self) -> Option<usize> {
+        if self.stop.load(Ordering::Acquire) {
+            return None;
+        }
+        self.pending.lock().unwrap().pop_front()
+    }
+
+    /// Marks a file as uploaded and moves the index of the task to the
+    /// first file not uploaded yet.
+    fn complete(&self, task: &RequestTask, index: usize) {
+        let mut done = self.done.lock().unwrap();
+        done[index] = true;
+        let first = done.iter().position(|done| !done).unwrap_or(done.len() - 1);
+        task.progress.lock().unwrap().common_data.index = first;
+    }
+
+    /// Records the failure of a file, which restarts from its first byte on
+    /// the next try of the task.
+    fn fail(&self, task: &RequestTask, index: usize, error: &TaskError) {
+        self.stop.store(true, Ordering::Release);
+        task.processed.update(|files, total| {
+            files[index] = 0;
+            *total = files.iter().sum();
+        });
+        if let TaskError::Failed(reason) = error {
+            if let Some(code) = task.code.lock().unwrap().get_mut(index) {
+                *code = *reason;
+            }
+        }
+    }
+}
+
+/// Uploads the files from `start` with up to `concurrency` requests in
+/// flight.
+///
+/// Files already uploaded by an earlier try are skipped, the others start
+/// from their first byte. The processed bytes of every file are counted as
+/// the files are read. Once a file fails no other file starts, the files in
+/// flight still complete, so the next try does not send them again.
+///
+/// # Errors
+///
+/// Returns the error of the first file that failed, preferring failures to
+/// the aborts of the files still in flight.
+async fn upload_files(
+    task: Arc<RequestTask>,
+    start: usize,
+    concurrency: usize,
+    abort_flag: Arc<AtomicBool>,
+    build_upload_request: BuildRequest,
+) -> Result<(), TaskError> {
+    let size = task.conf.file_specs.len();
+    // Parts of files are not resumed, the files in flight may be any
+    task.upload_resume.store(false, Ordering::SeqCst);
+    let done = (0..size)
+        .map(|index| index < start || task.file_uploaded(index))
+        .collect::<Vec<_>>();
+    task.processed.update(|files, total| {
+        for (processed, done) in files.iter_mut().zip(done.iter()) {
+            if !*done {
+                *processed = 0;
+            }
+        }
+        *total = files.iter().sum();
+    });
+    let pending = (start..size).filter(|index| !done[*index]).collect::<VecDeque<_>>();
+    info!(
+        "upload task {} sends {} files, {} at a time",
+        task.task_id(),
+        pending.len(),
+        concurrency
+    );
+    let queue = Arc::new(UploadQueue {
+        pending: Mutex::new(pending),
+        done: Mutex::new(done),
+        stop: AtomicBool::new(false),
+    });
+
+    // The files share the rest of the total timeout of the task
+    let begin_time = Instant::now();
+    let result = task
+        .within_rest_time(async {
+            let handles = (0..concurrency)
+                .map(|_| {
+                    io_spawn(cpu::charged(
+                        &task,
+                        upload_worker(
+                            task.clone(),
+                            queue.clone(),
+                            abort_flag.clone(),
+                            build_upload_request,
+                        ),
+                    ))
+                })
+                .collect::<Vec<_>>();
+            let mut error = None;
+            for handle in handles {
+                let res = handle.await.unwrap_or_else(|e| {
+                    error!("task {} upload worker failed {:?}", task.task_id(), e);
+                    Err(TaskError::Failed(Reason::OthersError))
+                });
+                if let Err(e) = res {
+                    let keep = matches!(error, Some(TaskError::Failed(_)));
+                    if !keep {
+                        error = Some(e);
+                    }
+                }
+            }
+            error.map_or(Ok(()), Err)
+        })
+        .await;
+    // Workers outliving a timeout start no other file
+    queue.stop.store(true, Ordering::Release);
+    let upload_time = begin_time.elapsed().as_secs();
+    let rest_time = task.rest_time.load(Ordering::SeqCst);
+    task.rest_time
+        .store(rest_time.saturating_sub(upload_time), Ordering::SeqCst);
+    result
+}
+
+/// Uploads files of the queue one after another until it is empty or stopped.
+async fn upload_worker(
+    task: Arc<RequestTask>,
+    queue: Arc<UploadQueue>,
+    abort_flag: Arc<AtomicBool>,
+    build_upload_request: BuildRequest,
+) -> Result<(), TaskError> {
+    while let Some(index) = queue.next() {
+        #[cfg(feature = "oh")]
+        let _trace = Trace::new(&format!("upload file:{} index:{}", task.task_id(), index));
+
+        let result = if task.seek_upload_file(index, 0).await {
+            upload_one_file_inner(task.clone(), index, abort_flag.clone(), build_upload_request)
+                .await
+        } else {
+            Err(TaskError::Failed(Reason::OthersError))
+        };
+        if let Err(e) = result {
+            queue.fail(&task, index, &e);
+            return Err(e);
+        }
+        queue.complete(&task, index);
+        task.notify_header_receive();
+    }
+    Ok(())
+}
+
 /// Uploads a single file with timeout management.
 /// 
-/// Tracks upload time and adjusts the client timeout for the remaining operation.
+/// Runs the upload within the rest of the total timeout of the task and
+/// subtracts the upload time from it.
 /// 
 /// # Type Parameters
 /// 
@@ -730,23 +1290,400 @@ where
 {
     // Track upload time
     let begin_time = Instant::now();
-    let result = upload_one_file_inner(
-        task.clone(),
-        index,
-        abort_flag.clone(),
-        build_upload_request,
-    )
-    .await;
+    let result = task
+        .within_rest_time(upload_one_file_inner(
+            task.clone(),
+            index,
+            abort_flag.clone(),
+            build_upload_request,
+        ))
+        .await;
     
     // Adjust timeout for remaining operations
     let upload_time = begin_time.elapsed().as_secs();
-    task.rest_time.fetch_sub(upload_time, Ordering::SeqCst);
-    let mut client = task.client.lock().await;
-    client.total_timeout(Timeout::from_secs(task.rest_time.load(Ordering::SeqCst)));
+    let rest_time = task.rest_time.load(Ordering::SeqCst);
+    task.rest_time
+        .store(rest_time.saturating_sub(upload_time), Ordering::SeqCst);
     
     result
 }
 
+/// Uploads a single file of a resumable upload with timeout management.
+///
+/// The server is asked for the bytes it stored first, then the rest of the
+/// file is sent in requests of up to `chunk_size` bytes. The processed bytes
+/// of the file are reset to the offset the server confirmed after every
+/// chunk, so a try after a failure resends only the chunk that failed.
+///
+/// # Errors
+///
+/// Returns `ProtocolError` if the server does not report a valid offset, or
+/// the error of `send_upload_request`.
+async fn upload_chunks(
+    task: Arc<RequestTask>,
+    index: usize,
+    chunk_size: u64,
+    abort_flag: Arc<AtomicBool>,
+) -> Result<(), TaskError> {
+    let begin_time = Instant::now();
+    let result = task
+        .within_rest_time(upload_chunks_inner(task.clone(), index, chunk_size, abort_flag))
+        .await;
+    let upload_time = begin_time.elapsed().as_secs();
+    let rest_time = task.rest_time.load(Ordering::SeqCst);
+    task.rest_time
+        .store(rest_time.saturating_sub(upload_time), Ordering::SeqCst);
+    result
+}
+
+/// Internal implementation for uploading a single file in chunks.
+async fn upload_chunks_inner(
+    task: Arc<RequestTask>,
+    index: usize,
+    chunk_size: u64,
+    abort_flag: Arc<AtomicBool>,
+) -> Result<(), TaskError> {
+    let size = task.progress.lock().unwrap().sizes[index] as u64;
+    info!(
+        "begin chunked upload tid {} index {} sizes {}",
+        task.task_id(),
+        index,
+        size
+    );
+
+    let Some(request) = build_offset_request(&task, index) else {
+        return Err(TaskError::Failed(Reason::BuildRequestFailed));
+    };
+    let mut response = send_upload_request(&task, request, &abort_flag).await?;
+    let mut offset = match upload_offset(&response) {
+        Some(offset) if offset <= size => offset,
+        offset => {
+            error!("task {} upload offset {:?} of {}", task.task_id(), offset, size);
+            return Err(TaskError::Failed(Reason::ProtocolError));
+        }
+    };
+    info!("task {} file {} resumes from {}", task.task_id(), index, offset);
+    task.checkpoint_upload(index, offset);
+
+    while offset < size {
+        if !task.seek_upload_file(index, offset).await {
+            return Err(TaskError::Failed(Reason::OthersError));
+        }
+        let len = chunk_size.min(size - offset);
+        let Some(request) =
+            build_chunk_request(task.clone(), index, offset, len, abort_flag.clone())
+        else {
+            return Err(TaskError::Failed(Reason::BuildRequestFailed));
+        };
+        response = match send_upload_request(&task, request, &abort_flag).await {
+            Ok(response) => response,
+            Err(e) => {
+                // Bytes of the chunk read before the failure are sent again
+                task.checkpoint_upload(index, offset);
+                return Err(e);
+            }
+        };
+        offset = match upload_offset(&response) {
+            Some(confirmed) if confirmed > offset && confirmed <= offset + len => confirmed,
+            confirmed => {
+                error!(
+                    "task {} chunk from {} confirmed {:?}",
+                    task.task_id(),
+                    offset,
+                    confirmed
+                );
+                task.checkpoint_upload(index, offset);
+                return Err(TaskError::Failed(Reason::ProtocolError));
+            }
+        };
+        task.checkpoint_upload(index, offset);
+    }
+
+    // Record the response of the last chunk
+    task.record_upload_response(index, Ok(response)).await;
+    task.record_transfer();
+    Ok(())
+}
+
+/// Splits `size` bytes into `count` parts of the same size, the last one
+/// shorter, as `(offset, len)` pairs.
+fn split_parts(size: u64, count: usize) -> Vec<(u64, u64)> {
+    let count = count.max(1) as u64;
+    let part_size = size.div_ceil(count).max(1);
+    (0..count)
+        .map(|part| {
+            let offset = (part * part_size).min(size);
+            (offset, part_size.min(size - offset))
+        })
+        .collect()
+}
+
+/// Returns the body of the request completing a parallel upload, listing
+/// the ETag of every part.
+fn complete_parts_body(etags: &[String]) -> String {
+    let mut body = String::from("<CompleteMultipartUpload>");
+    for (part, etag) in etags.iter().enumerate() {
+        body.push_str(&format!(
+            "<Part><PartNumber>{}</PartNumber><ETag>{}</ETag></Part>",
+            part + 1,
+            etag
+        ));
+    }
+    body.push_str("</CompleteMultipartUpload>");
+    body
+}
+
+/// Parts of a parallel upload not sent yet.
+struct PartQueue {
+    /// Parts not started yet.
+    pending: Mutex<VecDeque<usize>>,
+    /// Set once a part failed, no other part is started after it.
+    stop: AtomicBool,
+}
+
+impl PartQueue {
+    /// Takes the next part to send.
+    fn next(&self) -> Option<usize> {
+        if self.stop.load(Ordering::Acquire) {
+            return None;
+        }
+        self.pending.lock().unwrap().pop_front()
+    }
+}
+
+/// Sets the bytes of the parts the server stored as the processed bytes of
+/// the file at `index`.
+fn checkpoint_parts(task: &RequestTask, index: usize, parts: &[(u64, u64)]) {
+    let stored = task
+        .part_etags
+        .lock()
+        .unwrap()
+        .iter()
+        .zip(parts)
+        .filter(|(etag, _)| etag.is_some())
+        .map(|(_, (_, len))| len)
+        .sum::<u64>();
+    task.checkpoint_upload(index, stored);
+}
+
+/// Uploads the file at `index` in parts sent in parallel to pre-signed urls,
+/// as the multipart upload of object storage services.
+///
+/// Each part is sent in a `PUT` request of its own to its url, with up to
+/// `PART_CONNECTIONS` in flight, and the ETag the server answers with is
+/// kept in the task. A part that fails is sent again on its own, up to
+/// `PART_TRIES` times. The parts stored by an earlier try of the task are
+/// not sent again. Once every part is stored, the ETags are sent to the
+/// completion url in a `POST` request, whose response is the one recorded.
+///
+/// # Errors
+///
+/// Returns `ProtocolError` if a part is answered without an ETag, or the
+/// error of `send_upload_request` for the part that failed its last try or
+/// for the completion request, preferring failures to aborts.
+async fn upload_parts(
+    task: Arc<RequestTask>,
+    index: usize,
+    urls: Vec<String>,
+    abort_flag: Arc<AtomicBool>,
+) -> Result<(), TaskError> {
+    let size = task.progress.lock().unwrap().sizes[index] as u64;
+    let parts = Arc::new(split_parts(size, urls.len()));
+    let pending = {
+        let mut etags = task.part_etags.lock().unwrap();
+        if etags.len() != parts.len() {
+            *etags = vec![None; parts.len()];
+        }
+        (0..parts.len())
+            .filter(|part| etags[*part].is_none())
+            .collect::<VecDeque<_>>()
+    };
+    checkpoint_parts(&task, index, &parts);
+    let connections = PART_CONNECTIONS
+        .min(MAX_CONNECTIONS_PER_HOST)
+        .min(pending.len())
+        .max(1);
+    info!(
+        "upload task {} sends {} of {} parts of {} bytes, {} at a time",
+        task.task_id(),
+        pending.len(),
+        parts.len(),
+        size,
+        connections
+    );
+    let queue = Arc::new(PartQueue {
+        pending: Mutex::new(pending),
+        stop: AtomicBool::new(false),
+    });
+    let urls = Arc::new(urls);
+
+    let begin_time = Instant::now();
+    let result = task
+        .within_rest_time(async {
+            let handles = (0..connections)
+                .map(|_| {
+                    io_spawn(cpu::charged(
+                        &task,
+                        upload_part_worker(
+                            task.clone(),
+                            index,
+                            queue.clone(),
+                            urls.clone(),
+                            parts.clone(),
+                            abort_flag.clone(),
+                        ),
+                    ))
+                })
+                .collect::<Vec<_>>();
+            let mut error = None;
+            for handle in handles {
+                let res = handle.await.unwrap_or_else(|e| {
+                    error!("task {} upload part worker failed {:?}", task.task_id(), e);
+                    Err(TaskError::Failed(Reason::OthersError))
+                });
+                if let Err(e) = res {
+                    let keep = matches!(error, Some(TaskError::Failed(_)));
+                    if !keep {
+                        error = Some(e);
+                    }
+                }
+            }
+            checkpoint_parts(&task, index, &parts);
+            if let Some(e) = error {
+                return Err(e);
+            }
+            complete_parts(&task, index, &abort_flag).await
+        })
+        .await;
+    // Workers outliving a timeout start no other part
+    queue.stop.store(true, Ordering::Release);
+    let upload_time = begin_time.elapsed().as_secs();
+    let rest_time = task.rest_time.load(Ordering::SeqCst);
+    task.rest_time
+        .store(rest_time.saturating_sub(upload_time), Ordering::SeqCst);
+    result
+}
+
+/// Sends parts of the queue one after another until it is empty or stopped.
+async fn upload_part_worker(
+    task: Arc<RequestTask>,
+    index: usize,
+    queue: Arc<PartQueue>,
+    urls: Arc<Vec<String>>,
+    parts: Arc<Vec<(u64, u64)>>,
+    abort_flag: Arc<AtomicBool>,
+) -> Result<(), TaskError> {
+    while let Some(part) = queue.next() {
+        let mut tries = 1;
+        loop {
+            match upload_part(&task, index, &urls[part], parts[part], &abort_flag).await {
+                Ok(etag) => {
+                    task.part_etags.lock().unwrap()[part] = Some(etag);
+                    break;
+                }
+                Err(e) => {
+                    // Bytes of the part read before the failure are sent again
+                    checkpoint_parts(&task, index, &parts);
+                    if tries >= PART_TRIES || matches!(e, TaskError::Waiting(TaskPhase::UserAbort))
+                    {
+                        queue.stop.store(true, Ordering::Release);
+                        return Err(e);
+                    }
+                    info!(
+                        "task {} part {} failed try {}, sent again",
+                        task.task_id(),
+                        part,
+                        tries
+                    );
+                    tries += 1;
+                }
+            }
+        }
+    }
+    Ok(())
+}
+
+/// Sends the `len` bytes of the file at `index` from `offset` to the url of
+/// a part.
+///
+/// # Returns
+///
+/// The ETag the server stored the part under.
+async fn upload_part(
+    task: &Arc<RequestTask>,
+    index: usize,
+    url: &str,
+    (offset, len): (u64, u64),
+    abort_flag: &Arc<AtomicBool>,
+) -> Result<String, TaskError> {
+    debug!("build part request {} from {}", len, offset);
+    let task_reader = TaskReader::new(task.clone(), index).chunk(offset, len as usize);
+    let task_operator = TaskOperator::new(task.clone(), abort_flag.clone());
+    let uploader = Uploader::builder()
+        .reader(task_reader)
+        .operator(task_operator)
+        .total_bytes(Some(len))
+        .build();
+    let request = RequestBuilder::new()
+        .method("PUT")
+        .url(url)
+        .header("Content-Length", len.to_string().as_str())
+        .body(Body::stream(uploader));
+    let Some(request) = build_request_common(task, index, request) else {
+        return Err(TaskError::Failed(Reason::BuildRequestFailed));
+    };
+    let response = send_upload_request(task, request, abort_flag).await?;
+    match response
+        .headers()
+        .get("etag")
+        .and_then(|value| value.to_string().ok())
+        .filter(|etag| !etag.is_empty())
+    {
+        Some(etag) => Ok(etag),
+        None => {
+            error!("task {} part from {} has no etag", task.task_id(), offset);
+            Err(TaskError::Failed(Reason::ProtocolError))
+        }
+    }
+}
+
+/// Completes a parallel upload whose parts were all stored, and records the
+/// response of the completion request.
+async fn complete_parts(
+    task: &Arc<RequestTask>,
+    index: usize,
+    abort_flag: &Arc<AtomicBool>,
+) -> Result<(), TaskError> {
+    let etags = task
+        .part_etags
+        .lock()
+        .unwrap()
+        .iter()
+        .map(|etag| etag.clone().unwrap_or_default())
+        .collect::<Vec<_>>();
+    let url = task
+        .conf
+        .extras
+        .get(PART_COMPLETE_EXTRA)
+        .cloned()
+        .unwrap_or_default();
+    let request = RequestBuilder::new()
+        .method("POST")
+        .url(url.as_str())
+        .header("Content-Type", "application/xml")
+        .body(Body::slice(complete_parts_body(&etags)));
+    let Some(request) = build_request_common(task, index, request) else {
+        return Err(TaskError::Failed(Reason::BuildRequestFailed));
+    };
+    let response = send_upload_request(task, request, abort_flag).await?;
+    info!("task {} completed {} parts", task.task_id(), etags.len());
+    task.part_etags.lock().unwrap().clear();
+
+    task.record_upload_response(index, Ok(response)).await;
+    task.record_transfer();
+    Ok(())
+}
+
 /// Internal implementation for uploading a single file.
 /// 
 /// Handles request construction, execution, response processing, and error handling
@@ -769,16 +1706,8 @@ where
 /// 
 /// # Errors
 /// 
-/// Returns specific error reasons based on the failure type:
-/// - `BuildRequestFailed`: If request construction fails
-/// - `ProtocolError`: For server errors, most client errors, or redirections
-/// - `ContinuousTaskTimeout`: For request timeouts
-/// - `RequestError`, `RedirectError`: For specific HTTP errors
-/// - `Dns`, `Ssl`, `Tcp`: For network connection errors
-/// - `LowSpeed`: For slow transfer rates
-/// - `InsufficientSpace`: For storage space issues
-/// - `UserAbort`: When upload is cancelled by user
-/// - `OthersError`: For other miscellaneous errors
+/// Returns `BuildRequestFailed` if request construction fails, or the error
+/// of `send_upload_request`.
 async fn upload_one_file_inner<F>(
     task: Arc<RequestTask>,
     index: usize,
@@ -796,18 +1725,64 @@ where
     );
 
     // Build the upload request
-    let Some(request) = build_upload_request(task.clone(), index, abort_flag) else {
+    let Some(request) = build_upload_request(task.clone(), index, abort_flag.clone()) else {
         return Err(TaskError::Failed(Reason::BuildRequestFailed));
     };
+    let response = send_upload_request(&task, request, &abort_flag).await?;
 
-    // Execute the request
-    let client = task.client.lock().await;
-    let response = client.request(request).await;
+    // Record the response
+    task.record_upload_response(index, Ok(response)).await;
+    task.record_transfer();
+    Ok(())
+}
+
+/// Sends an upload request and checks its response.
+/// 
+/// # Returns
+/// 
+/// The response if the server accepted the request.
+/// 
+/// # Errors
+/// 
+/// Returns specific error reasons based on the failure type:
+/// - `ProtocolError`: For server errors, most client errors, or redirections
+/// - `ContinuousTaskTimeout`: For request timeouts
+/// - `RequestError`, `RedirectError`: For specific HTTP errors
+/// - `Dns`, `Ssl`, `Tcp`: For network connection errors
+/// - `LowSpeed`: For slow transfer rates
+/// - `InsufficientSpace`: For storage space issues
+/// - `UserAbort`: When upload is cancelled by user
+/// - `OthersError`: For other miscellaneous errors
+async fn send_upload_request(
+    task: &Arc<RequestTask>,
+    request: Request,
+    abort_flag: &Arc<AtomicBool>,
+) -> Result<Response, TaskError> {
+    // Wait for the origin to be reachable and for a connection slot of the
+    // host, then execute the request
+    task.wait_for_origin(abort_flag).await?;
+    let Some(_slot) = ClientPool::get_instance()
+        .host_slot(&task.conf.url, abort_flag)
+        .await
+    else {
+        return Err(TaskError::Waiting(TaskPhase::UserAbort));
+    };
+    let sent = get_current_timestamp();
+    let response = task.client.request(request).await;
+    task.record_attempt(sent, response.as_ref().ok());
+    task.record_origin(&response);
     
     // Process the response
     match response.as_ref() {
         Ok(response) => {
             let status_code = response.status();
+            Timelines::get_instance().record(
+                task.task_id(),
+                Phase::Response {
+                    status: status_code.as_u16() as u32,
+                    ttfb: get_current_timestamp().saturating_sub(sent),
+                },
+            );
             #[cfg(feature = "oh")]
             task.notify_response(response);
             info!(
@@ -881,10 +1856,9 @@ where
             };
         }
     };
-    
-    // Record the response
-    task.record_upload_response(index, response).await;
-    Ok(())
+
+    // Every failed request returned above
+    response.map_err(|_| TaskError::Failed(Reason::OthersError))
 }
 
 /// Unit tests for upload functionality.
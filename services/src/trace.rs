@@ -11,6 +11,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+use std::collections::HashMap;
+use std::sync::{LazyLock, Mutex};
+
 /// Hitrace adapter which provides timing capability.
 ///
 /// The timing will end automatically when the structure drops. Users should
@@ -34,3 +37,61 @@ impl Drop for Trace {
         hitrace_meter_rust::finish_trace(Self::HITRACE_TAG_MISC);
     }
 }
+
+/// Async hitrace span of a stage of a request traced by its client.
+///
+/// The client makes the trace id when the request is created and sends it in
+/// the config of the task. The spans of the client and of the service are
+/// named after it, so one trace view shows the stages of the request from the
+/// API call to its notifications. The span ends when the structure drops,
+/// possibly on another thread.
+pub(crate) struct RequestTrace {
+    name: String,
+    id: i32,
+}
+
+impl RequestTrace {
+    /// Starts the span of `stage` in the trace `trace_id`, `None` if the
+    /// request is untraced.
+    pub(crate) fn start(trace_id: u64, stage: &str) -> Option<Self> {
+        if trace_id == 0 {
+            return None;
+        }
+        // Named like the spans of the client.
+        let name = format!("request:{:x} {}", trace_id, stage);
+        let id = trace_id as i32;
+        hitrace_meter_rust::start_trace_async(Trace::HITRACE_TAG_MISC, &name, id);
+        Some(Self { name, id })
+    }
+
+    /// Starts the span of `stage` in the trace of the task `task_id`.
+    pub(crate) fn of_task(task_id: u32, stage: &str) -> Option<Self> {
+        Self::start(trace_of(task_id), stage)
+    }
+}
+
+impl Drop for RequestTrace {
+    fn drop(&mut self) {
+        hitrace_meter_rust::finish_trace_async(Trace::HITRACE_TAG_MISC, &self.name, self.id);
+    }
+}
+
+/// Traces of the tasks created traced.
+static TRACES: LazyLock<Mutex<HashMap<u32, u64>>> = LazyLock::new(|| Mutex::new(HashMap::new()));
+
+/// Binds the task `task_id` to the trace `trace_id`, if traced.
+pub(crate) fn bind(task_id: u32, trace_id: u64) {
+    if trace_id != 0 {
+        TRACES.lock().unwrap().insert(task_id, trace_id);
+    }
+}
+
+/// Unbinds the task `task_id` from its trace.
+pub(crate) fn unbind(task_id: u32) {
+    TRACES.lock().unwrap().remove(&task_id);
+}
+
+/// Returns the trace of the task `task_id`, 0 if untraced.
+pub(crate) fn trace_of(task_id: u32) -> u64 {
+    TRACES.lock().unwrap().get(&task_id).copied().unwrap_or(0)
+}
@@ -37,6 +37,18 @@ impl From<&String> for CStringWrapper {
     }
 }
 
+impl CStringWrapper {
+    /// Borrows a string from a buffer that C++ releases as a whole, such as
+    /// the ones of `GetTaskInfo` and `QueryTaskConfig`.
+    pub(crate) fn as_str(&self) -> &str {
+        if self.c_str.is_null() || self.len == 0 {
+            return "";
+        }
+        let bytes = unsafe { slice::from_raw_parts(self.c_str as *const u8, self.len as usize) };
+        unsafe { std::str::from_utf8_unchecked(bytes) }
+    }
+}
+
 impl ToString for CStringWrapper {
     fn to_string(&self) -> String {
         if self.c_str.is_null() || self.len == 0 {
@@ -78,10 +90,10 @@ impl FileSpec {
 
     pub(crate) fn from_c_struct(c_struct: &CFileSpec) -> Self {
         FileSpec {
-            name: c_struct.name.to_string(),
-            path: c_struct.path.to_string(),
-            file_name: c_struct.file_name.to_string(),
-            mime_type: c_struct.mime_type.to_string(),
+            name: c_struct.name.as_str().to_string(),
+            path: c_struct.path.as_str().to_string(),
+            file_name: c_struct.file_name.as_str().to_string(),
+            mime_type: c_struct.mime_type.as_str().to_string(),
             is_user_file: c_struct.is_user_file,
             fd: None,
         }
@@ -104,8 +116,8 @@ impl FormItem {
 
     pub(crate) fn from_c_struct(c_struct: &CFormItem) -> Self {
         FormItem {
-            name: c_struct.name.to_string(),
-            value: c_struct.value.to_string(),
+            name: c_struct.name.as_str().to_string(),
+            value: c_struct.value.as_str().to_string(),
         }
     }
 }
@@ -113,7 +125,4 @@ impl FormItem {
 #[cfg(feature = "oh")]
 extern "C" {
     pub(crate) fn DeleteChar(ptr: *const c_char);
-    pub(crate) fn DeleteCFormItem(ptr: *const CFormItem);
-    pub(crate) fn DeleteCFileSpec(ptr: *const CFileSpec);
-    pub(crate) fn DeleteCStringPtr(ptr: *const CStringWrapper);
 }
@@ -30,7 +30,9 @@ pub struct FileSpec {
     pub mime_type: String,
     /// Flag indicating whether this is a user-provided file.
     pub is_user_file: bool,
-    /// File descriptor for the opened file, only valid when `is_user_file` is true.
+    /// File descriptor for the opened file, always valid when `is_user_file`
+    /// is true, otherwise set if the application opened the file in its
+    /// sandbox when it created the task.
     pub fd: Option<RawFd>,
 }
 
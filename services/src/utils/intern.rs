@@ -0,0 +1,94 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Interning of the values repeated across task configs.
+//!
+//! The tasks of an application share its bundle name, and usually its proxy
+//! and certificate paths. Interned, they are stored once and cloned by
+//! reference count.
+
+use std::collections::HashSet;
+use std::hash::Hash;
+use std::sync::{Arc, LazyLock, Mutex};
+
+/// Number of values kept before values no longer used are first dropped.
+const PRUNE_THRESHOLD: usize = 64;
+
+static STRINGS: LazyLock<Interner<str>> = LazyLock::new(Interner::new);
+
+static STRING_LISTS: LazyLock<Interner<[String]>> = LazyLock::new(Interner::new);
+
+/// Returns the shared copy of a string.
+pub(crate) fn intern_str(value: &str) -> Arc<str> {
+    STRINGS.intern(value)
+}
+
+/// Returns the shared copy of a list of strings.
+pub(crate) fn intern_strings(value: &[String]) -> Arc<[String]> {
+    STRING_LISTS.intern(value)
+}
+
+/// Set of shared values.
+///
+/// A value stays in the set while it is used. Values only the set holds are
+/// dropped whenever the set doubled since it was last pruned.
+pub(crate) struct Interner<T: ?Sized> {
+    inner: Mutex<Inner<T>>,
+}
+
+struct Inner<T: ?Sized> {
+    values: HashSet<Arc<T>>,
+    /// Size of the set that triggers the next pruning.
+    prune_at: usize,
+}
+
+impl<T> Interner<T>
+where
+    T: ?Sized + Hash + Eq,
+    for<'a> Arc<T>: From<&'a T>,
+{
+    pub(crate) fn new() -> Self {
+        Self {
+            inner: Mutex::new(Inner {
+                values: HashSet::new(),
+                prune_at: PRUNE_THRESHOLD,
+            }),
+        }
+    }
+
+    /// Returns the shared copy of `value`, adding it if there is none.
+    pub(crate) fn intern(&self, value: &T) -> Arc<T> {
+        let mut inner = self.inner.lock().unwrap();
+        if let Some(shared) = inner.values.get(value) {
+            return shared.clone();
+        }
+        if inner.values.len() >= inner.prune_at {
+            inner.values.retain(|shared| Arc::strong_count(shared) > 1);
+            inner.prune_at = (inner.values.len() * 2).max(PRUNE_THRESHOLD);
+        }
+        let shared = Arc::from(value);
+        inner.values.insert(shared.clone());
+        shared
+    }
+
+    /// Number of values in the set, used or not.
+    #[cfg(test)]
+    pub(crate) fn len(&self) -> usize {
+        self.inner.lock().unwrap().values.len()
+    }
+}
+
+#[cfg(test)]
+mod ut_intern {
+    include!("../../tests/ut/utils/ut_intern.rs");
+}
@@ -0,0 +1,142 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Memory budget shared by the transfers of the service.
+//!
+//! The large buffers of the transfers, the write buffers of downloads, the
+//! read-ahead of uploads and the in-memory bodies queued for the clients,
+//! reserve their size from one budget before they are filled. Once the
+//! budget is spent, transfers wait for a reservation to be released instead
+//! of buffering more: a download stops taking data, so the connection stops
+//! being read. The highest use of the budget is reported with the metrics.
+
+use std::fmt;
+use std::future::poll_fn;
+use std::sync::atomic::{AtomicUsize, Ordering};
+use std::sync::Mutex;
+use std::task::{Context, Poll, Waker};
+
+use crate::utils::metrics;
+
+/// Bytes the transfers of the service buffer at most together.
+const MEMORY_BUDGET: usize = 32 * 1024 * 1024;
+
+/// Budget of the transfers of the service.
+pub(crate) static BUDGET: MemoryBudget = MemoryBudget::new(MEMORY_BUDGET);
+
+/// Bytes that buffers may reserve together.
+pub(crate) struct MemoryBudget {
+    limit: usize,
+    used: AtomicUsize,
+    high_water: AtomicUsize,
+    waiters: Mutex<Vec<Waker>>,
+}
+
+/// Bytes reserved from a budget, released on drop.
+pub(crate) struct Reservation {
+    budget: &'static MemoryBudget,
+    size: usize,
+}
+
+impl MemoryBudget {
+    /// Creates a budget of `limit` bytes.
+    pub(crate) const fn new(limit: usize) -> Self {
+        Self {
+            limit,
+            used: AtomicUsize::new(0),
+            high_water: AtomicUsize::new(0),
+            waiters: Mutex::new(Vec::new()),
+        }
+    }
+
+    /// Reserves `size` bytes if the budget has them left.
+    ///
+    /// A reservation larger than the whole budget is granted when nothing is
+    /// reserved, so it is not refused forever.
+    pub(crate) fn try_reserve(&'static self, size: usize) -> Option<Reservation> {
+        let mut used = self.used.load(Ordering::Relaxed);
+        loop {
+            if used != 0 && used + size > self.limit {
+                return None;
+            }
+            match self.used.compare_exchange_weak(
+                used,
+                used + size,
+                Ordering::AcqRel,
+                Ordering::Relaxed,
+            ) {
+                Ok(_) => break,
+                Err(current) => used = current,
+            }
+        }
+        self.high_water.fetch_max(used + size, Ordering::Relaxed);
+        Some(Reservation { budget: self, size })
+    }
+
+    /// Polls for a reservation of `size` bytes, `cx` is woken once a
+    /// reservation is released.
+    pub(crate) fn poll_reserve(
+        &'static self,
+        cx: &mut Context<'_>,
+        size: usize,
+    ) -> Poll<Reservation> {
+        if let Some(reservation) = self.try_reserve(size) {
+            return Poll::Ready(reservation);
+        }
+        self.waiters.lock().unwrap().push(cx.waker().clone());
+        metrics::MEMORY_BUDGET_WAITS.add(1);
+        // A release between the attempt and the registration found no waker.
+        match self.try_reserve(size) {
+            Some(reservation) => Poll::Ready(reservation),
+            None => Poll::Pending,
+        }
+    }
+
+    /// Waits for a reservation of `size` bytes.
+    pub(crate) async fn reserve(&'static self, size: usize) -> Reservation {
+        poll_fn(|cx| self.poll_reserve(cx, size)).await
+    }
+
+    /// Bytes currently reserved.
+    pub(crate) fn used(&self) -> usize {
+        self.used.load(Ordering::Relaxed)
+    }
+
+    /// Most bytes reserved at once since the service started.
+    pub(crate) fn high_water(&self) -> usize {
+        self.high_water.load(Ordering::Relaxed)
+    }
+}
+
+impl fmt::Debug for Reservation {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        f.debug_struct("Reservation")
+            .field("size", &self.size)
+            .finish()
+    }
+}
+
+impl Drop for Reservation {
+    fn drop(&mut self) {
+        self.budget.used.fetch_sub(self.size, Ordering::AcqRel);
+        let waiters = std::mem::take(&mut *self.budget.waiters.lock().unwrap());
+        for waker in waiters {
+            waker.wake();
+        }
+    }
+}
+
+#[cfg(test)]
+mod ut_memory_budget {
+    include!("../../tests/ut/utils/ut_memory_budget.rs");
+}
@@ -0,0 +1,315 @@
+// Copyright (C) 2024 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Counters and histograms of the hot paths of the service.
+//!
+//! The metrics are statics, so counting costs no lookup. A counter is split
+//! into cache line sized shards and each thread adds to its own shard with a
+//! relaxed atomic add, so threads counting the same event do not share a cache
+//! line. A histogram counts values in log-linear buckets, four per power of
+//! two, so any recorded value is known within 25%. The metrics are shown by
+//! the `-m` option of hidumper and returned by the `GET_STATS` interface.
+
+use std::fmt::Write;
+use std::sync::atomic::{AtomicU64, AtomicUsize, Ordering};
+use std::time::Instant;
+
+use crate::utils::memory_budget::BUDGET;
+
+/// Number of shards of a counter.
+pub(crate) const COUNTER_SHARDS: usize = 16;
+
+/// Sub-buckets of a histogram per power of two, as a power of two.
+const SUB_BUCKET_BITS: u32 = 2;
+
+/// Values below this are counted in a bucket each.
+const LINEAR_MAX: u64 = 1 << (SUB_BUCKET_BITS + 1);
+
+/// Number of buckets of a histogram, the last one counts all values from
+/// `2^40` on.
+pub(crate) const HISTOGRAM_BUCKETS: usize =
+    LINEAR_MAX as usize + ((40 - SUB_BUCKET_BITS - 1) << SUB_BUCKET_BITS) as usize;
+
+#[repr(align(64))]
+struct Shard(AtomicU64);
+
+#[allow(clippy::declare_interior_mutable_const)]
+const ZERO_SHARD: Shard = Shard(AtomicU64::new(0));
+
+#[allow(clippy::declare_interior_mutable_const)]
+const ZERO: AtomicU64 = AtomicU64::new(0);
+
+/// Returns the shard of the calling thread, threads take the shards in turn.
+fn shard() -> usize {
+    static NEXT: AtomicUsize = AtomicUsize::new(0);
+    thread_local! {
+        static SHARD: usize = NEXT.fetch_add(1, Ordering::Relaxed) % COUNTER_SHARDS;
+    }
+    SHARD.with(|shard| *shard)
+}
+
+/// Counter of events or bytes.
+pub(crate) struct Counter {
+    shards: [Shard; COUNTER_SHARDS],
+}
+
+impl Counter {
+    /// Creates a counter at zero.
+    pub(crate) const fn new() -> Self {
+        Self {
+            shards: [ZERO_SHARD; COUNTER_SHARDS],
+        }
+    }
+
+    /// Adds `n` to the counter.
+    #[inline]
+    pub(crate) fn add(&self, n: u64) {
+        self.shards[shard()].0.fetch_add(n, Ordering::Relaxed);
+    }
+
+    /// Returns the sum of the shards, additions racing with it may be missed.
+    pub(crate) fn get(&self) -> u64 {
+        self.shards
+            .iter()
+            .map(|shard| shard.0.load(Ordering::Relaxed))
+            .fold(0, u64::wrapping_add)
+    }
+}
+
+/// Distribution of values, like latencies in microseconds.
+pub(crate) struct Histogram {
+    buckets: [AtomicU64; HISTOGRAM_BUCKETS],
+    sum: AtomicU64,
+}
+
+impl Histogram {
+    /// Creates an empty histogram.
+    pub(crate) const fn new() -> Self {
+        Self {
+            buckets: [ZERO; HISTOGRAM_BUCKETS],
+            sum: AtomicU64::new(0),
+        }
+    }
+
+    /// Records a value.
+    #[inline]
+    pub(crate) fn record(&self, value: u64) {
+        self.buckets[bucket(value)].fetch_add(1, Ordering::Relaxed);
+        self.sum.fetch_add(value, Ordering::Relaxed);
+    }
+
+    /// Records the microseconds elapsed since `start`.
+    #[inline]
+    pub(crate) fn record_since(&self, start: Instant) {
+        self.record(start.elapsed().as_micros() as u64);
+    }
+
+    /// Returns the number of values recorded.
+    pub(crate) fn count(&self) -> u64 {
+        self.buckets
+            .iter()
+            .map(|bucket| bucket.load(Ordering::Relaxed))
+            .sum()
+    }
+
+    /// Returns the sum of the values recorded.
+    pub(crate) fn sum(&self) -> u64 {
+        self.sum.load(Ordering::Relaxed)
+    }
+
+    /// Returns the lower bound of the bucket holding the value at `percent`
+    /// of the recorded values, 0 if none was recorded.
+    pub(crate) fn percentile(&self, percent: u64) -> u64 {
+        let counts = self
+            .buckets
+            .iter()
+            .map(|bucket| bucket.load(Ordering::Relaxed))
+            .collect::<Vec<_>>();
+        let total: u64 = counts.iter().sum();
+        if total == 0 {
+            return 0;
+        }
+        let rank = (total * percent).div_ceil(100).max(1);
+        let mut seen = 0;
+        for (index, count) in counts.iter().enumerate() {
+            seen += count;
+            if seen >= rank {
+                return bucket_floor(index);
+            }
+        }
+        bucket_floor(HISTOGRAM_BUCKETS - 1)
+    }
+}
+
+/// Returns the bucket of a value.
+fn bucket(value: u64) -> usize {
+    if value < LINEAR_MAX {
+        return value as usize;
+    }
+    let exponent = u64::BITS - 1 - value.leading_zeros();
+    let sub = (value >> (exponent - SUB_BUCKET_BITS)) & ((1 << SUB_BUCKET_BITS) - 1);
+    let index = LINEAR_MAX as usize
+        + (((exponent - SUB_BUCKET_BITS - 1) as usize) << SUB_BUCKET_BITS)
+        + sub as usize;
+    index.min(HISTOGRAM_BUCKETS - 1)
+}
+
+/// Returns the smallest value of a bucket.
+fn bucket_floor(index: usize) -> u64 {
+    if index < LINEAR_MAX as usize {
+        return index as u64;
+    }
+    let index = index - LINEAR_MAX as usize;
+    let exponent = (index >> SUB_BUCKET_BITS) as u32 + SUB_BUCKET_BITS + 1;
+    let sub = (index & ((1 << SUB_BUCKET_BITS) - 1)) as u64;
+    (1 << exponent) + (sub << (exponent - SUB_BUCKET_BITS))
+}
+
+/// Messages sent to the clients.
+pub(crate) static CLIENT_MESSAGES: Counter = Counter::new();
+/// Bytes of the messages sent to the clients.
+pub(crate) static CLIENT_MESSAGE_BYTES: Counter = Counter::new();
+/// Messages the clients failed to receive.
+pub(crate) static CLIENT_SEND_ERRORS: Counter = Counter::new();
+/// Progress notifications dropped for a newer one of the same task before
+/// they were sent to the clients.
+pub(crate) static CLIENT_PROGRESS_SUPERSEDED: Counter = Counter::new();
+/// Acknowledgments and credit grants the clients did not send in time.
+pub(crate) static CLIENT_ACK_TIMEOUTS: Counter = Counter::new();
+/// Microseconds waited for the acknowledgment of a message.
+pub(crate) static CLIENT_ACK_WAIT_US: Histogram = Histogram::new();
+/// Database statements run.
+pub(crate) static DB_STATEMENTS: Counter = Counter::new();
+/// Microseconds taken by a database statement.
+pub(crate) static DB_STATEMENT_US: Histogram = Histogram::new();
+/// Task attributes found in the database cache.
+pub(crate) static TASK_META_HITS: Counter = Counter::new();
+/// Task attributes read from the database.
+pub(crate) static TASK_META_MISSES: Counter = Counter::new();
+/// Downloaded bytes written to the files.
+pub(crate) static BYTES_WRITTEN: Counter = Counter::new();
+/// Transfers that found the memory budget spent and waited for it.
+pub(crate) static MEMORY_BUDGET_WAITS: Counter = Counter::new();
+/// Hosts the clients resolved from the DNS cache.
+pub(crate) static DNS_CACHE_HITS: Counter = Counter::new();
+/// Hosts the clients resolved with the system resolver.
+pub(crate) static DNS_CACHE_MISSES: Counter = Counter::new();
+/// Downloads started at the cached target of their url.
+pub(crate) static REDIRECT_CACHE_HITS: Counter = Counter::new();
+/// Redirects followed by the downloads.
+pub(crate) static REDIRECTS_FOLLOWED: Counter = Counter::new();
+/// Origins whose circuit opened after connections to them failed in a row.
+pub(crate) static ORIGIN_CIRCUITS_OPENED: Counter = Counter::new();
+/// Segments split off the slowest segment of a download for a connection
+/// that finished its own.
+pub(crate) static SEGMENTS_REBALANCED: Counter = Counter::new();
+/// Bytes of delta downloads copied from the old file instead of fetched.
+pub(crate) static DELTA_BYTES_REUSED: Counter = Counter::new();
+/// Microseconds a binder thread took to handle a request and fill its reply.
+pub(crate) static IPC_REPLY_US: Histogram = Histogram::new();
+/// Binder threads handling a request when another one arrives, itself
+/// included. Values reaching the size of the binder pool mean requests wait in
+/// the kernel.
+pub(crate) static IPC_BUSY_THREADS: Histogram = Histogram::new();
+/// Microseconds a binder thread waited for the task manager or the client
+/// manager to answer an event.
+pub(crate) static EVENT_REPLY_WAIT_US: Histogram = Histogram::new();
+/// Milliseconds from the start of the service to the start of a task it
+/// restored, while the restore ramp paces them.
+pub(crate) static RESTORE_START_MS: Histogram = Histogram::new();
+/// Bytes of the WAL file of the database found by the idle maintenance.
+pub(crate) static DB_WAL_BYTES: Histogram = Histogram::new();
+/// Microseconds taken by a WAL checkpoint of the idle maintenance.
+pub(crate) static DB_CHECKPOINT_US: Histogram = Histogram::new();
+
+static COUNTERS: [(&str, &Counter); 17] = [
+    ("client_messages", &CLIENT_MESSAGES),
+    ("client_message_bytes", &CLIENT_MESSAGE_BYTES),
+    ("client_send_errors", &CLIENT_SEND_ERRORS),
+    ("client_progress_superseded", &CLIENT_PROGRESS_SUPERSEDED),
+    ("client_ack_timeouts", &CLIENT_ACK_TIMEOUTS),
+    ("db_statements", &DB_STATEMENTS),
+    ("task_meta_hits", &TASK_META_HITS),
+    ("task_meta_misses", &TASK_META_MISSES),
+    ("bytes_written", &BYTES_WRITTEN),
+    ("memory_budget_waits", &MEMORY_BUDGET_WAITS),
+    ("dns_cache_hits", &DNS_CACHE_HITS),
+    ("dns_cache_misses", &DNS_CACHE_MISSES),
+    ("redirect_cache_hits", &REDIRECT_CACHE_HITS),
+    ("redirects_followed", &REDIRECTS_FOLLOWED),
+    ("origin_circuits_opened", &ORIGIN_CIRCUITS_OPENED),
+    ("segments_rebalanced", &SEGMENTS_REBALANCED),
+    ("delta_bytes_reused", &DELTA_BYTES_REUSED),
+];
+
+static HISTOGRAMS: [(&str, &Histogram); 8] = [
+    ("client_ack_wait_us", &CLIENT_ACK_WAIT_US),
+    ("db_statement_us", &DB_STATEMENT_US),
+    ("ipc_reply_us", &IPC_REPLY_US),
+    ("ipc_busy_threads", &IPC_BUSY_THREADS),
+    ("event_reply_wait_us", &EVENT_REPLY_WAIT_US),
+    ("restore_start_ms", &RESTORE_START_MS),
+    ("db_wal_bytes", &DB_WAL_BYTES),
+    ("db_checkpoint_us", &DB_CHECKPOINT_US),
+];
+
+/// Returns the metrics as named values: the counters, then the count, sum,
+/// median and 99th percentile of each histogram as `<name>.count`,
+/// `<name>.sum`, `<name>.p50` and `<name>.p99`, then the bytes of the memory
+/// budget of the transfers in use and at most as `memory_budget_used` and
+/// `memory_budget_high_water`.
+///
+/// The values only grow, rates are the differences between two snapshots,
+/// except `memory_budget_used`.
+pub(crate) fn snapshot() -> Vec<(String, u64)> {
+    let mut values = Vec::with_capacity(COUNTERS.len() + HISTOGRAMS.len() * 4 + 2);
+    for (name, counter) in COUNTERS.iter() {
+        values.push((name.to_string(), counter.get()));
+    }
+    for (name, histogram) in HISTOGRAMS.iter() {
+        values.push((format!("{}.count", name), histogram.count()));
+        values.push((format!("{}.sum", name), histogram.sum()));
+        values.push((format!("{}.p50", name), histogram.percentile(50)));
+        values.push((format!("{}.p99", name), histogram.percentile(99)));
+    }
+    values.push(("memory_budget_used".to_string(), BUDGET.used() as u64));
+    values.push((
+        "memory_budget_high_water".to_string(),
+        BUDGET.high_water() as u64,
+    ));
+    values
+}
+
+/// Formats the metrics and the buckets of the histograms for dumping.
+pub(crate) fn dump() -> String {
+    let mut out = String::new();
+    for (name, value) in snapshot() {
+        let _ = writeln!(out, "{:<32}{}", name, value);
+    }
+    for (name, histogram) in HISTOGRAMS.iter() {
+        let _ = write!(out, "{} (lower bound: count):", name);
+        for (index, bucket) in histogram.buckets.iter().enumerate() {
+            let count = bucket.load(Ordering::Relaxed);
+            if count != 0 {
+                let _ = write!(out, " {}:{}", bucket_floor(index), count);
+            }
+        }
+        let _ = writeln!(out);
+    }
+    out
+}
+
+#[cfg(test)]
+mod ut_metrics {
+    include!("../../tests/ut/utils/ut_metrics.rs");
+}
@@ -20,11 +20,14 @@
 pub(crate) mod c_wrapper;
 pub(crate) mod common_event;
 pub(crate) mod form_item;
+pub(crate) mod intern;
+pub(crate) mod memory_budget;
+pub(crate) mod metrics;
 use std::collections::HashMap;
 use std::future::Future;
 use std::io::Write;
 use std::sync::Once;
-use std::time::{Duration, SystemTime, UNIX_EPOCH};
+use std::time::{Duration, Instant, SystemTime, UNIX_EPOCH};
 
 pub(crate) use common_event::{
     subscribe_common_event, CommonEventSubscriber, Want as CommonEventWant,
@@ -37,6 +40,8 @@ cfg_oh! {
     pub(crate) use ffi::GetForegroundAbilities;
 }
 
+pub(crate) mod runtime;
+pub(crate) mod startup;
 pub(crate) mod task_event_count;
 pub(crate) mod task_id_generator;
 use ylong_runtime::sync::oneshot::Receiver;
@@ -69,8 +74,11 @@ impl<T> Recv<T> {
     /// This implementation assumes the receiver will never be hung up in the
     /// expected usage pattern.
     pub(crate) fn get(self) -> Option<T> {
+        let start = Instant::now();
         // Here `self.rx` can never be hung up in the expected usage context
-        ylong_runtime::block_on(self.rx).ok()
+        let ret = ylong_runtime::block_on(self.rx).ok();
+        metrics::EVENT_REPLY_WAIT_US.record_since(start);
+        ret
     }
 }
 
@@ -238,7 +246,7 @@ pub(crate) fn hashmap_to_string(map: &HashMap<String, String>) -> String {
 /// assert_eq!(result.get("key1"), Some(&"value1".to_string()));
 /// assert_eq!(result.get("key2"), Some(&"value2".to_string()));
 /// ```
-pub(crate) fn string_to_hashmap(str: &mut str) -> HashMap<String, String> {
+pub(crate) fn string_to_hashmap(str: &str) -> HashMap<String, String> {
     let mut map = HashMap::<String, String>::new();
     if str.is_empty() {
         return map;
@@ -272,7 +280,7 @@ pub(crate) fn string_to_hashmap(str: &mut str) -> HashMap<String, String> {
 /// 
 /// assert_eq!(result, vec!["apple", "banana", "cherry"]);
 /// ```
-pub(crate) fn split_string(str: &mut str) -> std::str::Split<'_, &str> {
+pub(crate) fn split_string(str: &str) -> std::str::Split<'_, &str> {
     let pat: &[_] = &['[', ']'];
     // Trim surrounding brackets and split by ", " delimiter
     str.trim_matches(pat).split(", ")
@@ -308,6 +316,9 @@ pub(crate) fn call_once<F: FnOnce()>(once: &Once, func: F) {
 
 /// Spawns a future on the ylong runtime, returning a join handle.
 ///
+/// The global runtime is the control pool, transfers are spawned on the I/O
+/// pool with `runtime::io_spawn`.
+///
 /// This function boxes and pins the provided future before spawning it,
 /// allowing for dynamic dispatch of the future.
 ///
@@ -376,6 +387,16 @@ pub(crate) fn is_system_api() -> bool {
     ffi::IsSystemAPI(token_id)
 }
 
+/// Checks if a token ID belongs to a system application.
+///
+/// # Availability
+///
+/// This function is only available when the `oh` feature is enabled.
+#[cfg(feature = "oh")]
+pub(crate) fn is_system_token(token_id: u64) -> bool {
+    ffi::IsSystemAPI(token_id)
+}
+
 /// Checks if the calling process has a specific permission.
 ///
 /// This function verifies whether the calling process has been granted a specific
@@ -0,0 +1,102 @@
+// Copyright (C) 2024 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Executor pools of the service.
+//!
+//! Control work, such as `TaskManager`, `ClientManager` and the notifications,
+//! runs on the global runtime, the control pool. The transfers of the tasks run
+//! on a separate I/O pool, so their TLS and disk writes never hold the workers
+//! the IPC responses wait for. Both pools are multi-thread runtimes whose idle
+//! workers steal from the busy ones.
+//!
+//! The number of workers of each pool is set at build time by the
+//! `request_control_workers` and `request_io_workers` GN arguments.
+
+use std::future::Future;
+use std::sync::LazyLock;
+
+use ylong_runtime::builder::RuntimeBuilder;
+use ylong_runtime::executor::Runtime;
+use ylong_runtime::task::JoinHandle;
+
+/// Workers of the control pool if the build does not set them.
+const DEFAULT_CONTROL_WORKERS: usize = 2;
+
+/// Workers of the I/O pool if the build does not set them.
+const DEFAULT_IO_WORKERS: usize = 4;
+
+/// The I/O pool, `None` if it could not be built and the transfers share the
+/// control pool.
+static IO_RUNTIME: LazyLock<Option<Runtime>> = LazyLock::new(|| {
+    match RuntimeBuilder::new_multi_thread()
+        .worker_num(io_workers())
+        .build()
+    {
+        Ok(runtime) => Some(runtime),
+        Err(e) => {
+            error!("io runtime error: {}", e);
+            None
+        }
+    }
+});
+
+/// Returns the number of workers `configured` for a pool, or `default` if it
+/// is not set or not a positive number.
+fn workers(configured: Option<&str>, default: usize) -> usize {
+    configured
+        .and_then(|n| n.parse().ok())
+        .filter(|n| *n > 0)
+        .unwrap_or(default)
+}
+
+/// Returns the number of workers of the control pool.
+pub(crate) fn control_workers() -> usize {
+    workers(
+        option_env!("REQUEST_CONTROL_WORKERS"),
+        DEFAULT_CONTROL_WORKERS,
+    )
+}
+
+/// Returns the number of workers of the I/O pool.
+pub(crate) fn io_workers() -> usize {
+    workers(option_env!("REQUEST_IO_WORKERS"), DEFAULT_IO_WORKERS)
+}
+
+/// Builds the global runtime as the control pool.
+pub(crate) fn init_control_runtime() {
+    if let Err(e) = RuntimeBuilder::new_multi_thread()
+        .worker_num(control_workers())
+        .build_global()
+    {
+        error!("ylong_runtime error: {}", e);
+    }
+}
+
+/// Spawns a transfer, or a part of one, on the I/O pool.
+///
+/// Spawns on the control pool if the I/O pool could not be built.
+pub(crate) fn io_spawn<F, R>(fut: F) -> JoinHandle<R>
+where
+    F: Future<Output = R> + Send + 'static,
+    R: Send + 'static,
+{
+    match IO_RUNTIME.as_ref() {
+        Some(runtime) => runtime.spawn(fut),
+        None => ylong_runtime::spawn(fut),
+    }
+}
+
+#[cfg(test)]
+mod ut_runtime {
+    include!("../../tests/ut/utils/ut_runtime.rs");
+}
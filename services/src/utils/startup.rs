@@ -0,0 +1,265 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Breakdown of the cold start of the service.
+//!
+//! The service is loaded on demand, and a client waits for it up to
+//! `LOAD_SA_TIMEOUT_MS`. Every init phase of `RequestAbility::init` is timed
+//! with `measure`, then the restore of the tasks the scheduler runs a while
+//! after the service is published. Phases initialized on first use are timed
+//! when they run, and the first IPC served is timed from the start of the
+//! service, which is the latency the launching client sees. Once the tasks are
+//! restored the breakdown is written as one `SERVICE_STARTUP` sys event per
+//! launch. It is shown by the `-b` option of hidumper from the first phase on.
+
+use std::fmt::Write;
+use std::sync::atomic::{AtomicBool, Ordering};
+use std::sync::Mutex;
+use std::time::Instant;
+
+use hisysevent::build_number_param;
+
+use crate::sys_event::SysEvent;
+
+/// Init phases of the service, in the order they run.
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub(crate) enum Phase {
+    /// Control runtime of the service
+    Runtime = 0,
+    /// Client manager, serving the UDS channels of the applications
+    ClientManager,
+    /// Run count manager
+    RunCount,
+    /// Certificates of the system configuration, on first use
+    Certificates,
+    /// `RegisterProxySubscriber` of the system configuration, on first use
+    Proxy,
+    /// Opening the RDB store, `CheckAndRebuildDataBase` included
+    Database,
+    /// Task manager
+    TaskManager,
+    /// Account observer of the task manager, run along the other phases
+    Account,
+    /// `SubscribeNotification` of the notification bar, on first use
+    Notification,
+    /// App state and permission observers
+    AppState,
+    /// Publishing the service to the system ability manager
+    Publish,
+    /// `restore_all_tasks` of the scheduler, run after the service is
+    /// published
+    Restore,
+}
+
+impl Phase {
+    const ALL: [Phase; 12] = [
+        Phase::Runtime,
+        Phase::ClientManager,
+        Phase::RunCount,
+        Phase::Certificates,
+        Phase::Proxy,
+        Phase::Database,
+        Phase::TaskManager,
+        Phase::Account,
+        Phase::Notification,
+        Phase::AppState,
+        Phase::Publish,
+        Phase::Restore,
+    ];
+
+    /// Returns the name of the phase in the dump.
+    fn name(self) -> &'static str {
+        match self {
+            Phase::Runtime => "runtime",
+            Phase::ClientManager => "client_manager",
+            Phase::RunCount => "run_count",
+            Phase::Certificates => "certificates",
+            Phase::Proxy => "proxy",
+            Phase::Database => "database",
+            Phase::TaskManager => "task_manager",
+            Phase::Account => "account",
+            Phase::Notification => "notification",
+            Phase::AppState => "app_state",
+            Phase::Publish => "publish",
+            Phase::Restore => "restore",
+        }
+    }
+
+    /// Returns the parameter of the phase in the `SERVICE_STARTUP` event.
+    fn param(self) -> &'static str {
+        match self {
+            Phase::Runtime => "RUNTIME_US",
+            Phase::ClientManager => "CLIENT_MANAGER_US",
+            Phase::RunCount => "RUN_COUNT_US",
+            Phase::Certificates => "CERTIFICATES_US",
+            Phase::Proxy => "PROXY_US",
+            Phase::Database => "DATABASE_US",
+            Phase::TaskManager => "TASK_MANAGER_US",
+            Phase::Account => "ACCOUNT_US",
+            Phase::Notification => "NOTIFICATION_US",
+            Phase::AppState => "APP_STATE_US",
+            Phase::Publish => "PUBLISH_US",
+            Phase::Restore => "RESTORE_US",
+        }
+    }
+}
+
+/// Time of every phase of a launch.
+pub(crate) struct Startup {
+    /// Start of the first phase
+    begin: Option<Instant>,
+    /// Microseconds from `begin` to the end of `Phase::Publish`
+    published_us: Option<u64>,
+    /// Microseconds from `begin` to the reply of the first IPC, and of its
+    /// handling
+    first_ipc_us: Option<(u64, u64)>,
+    /// Microseconds of each phase, by `Phase` index
+    phases: [Option<u64>; Phase::ALL.len()],
+    /// Whether the breakdown was written as a sys event
+    reported: bool,
+}
+
+impl Startup {
+    pub(crate) const fn new() -> Self {
+        Self {
+            begin: None,
+            published_us: None,
+            first_ipc_us: None,
+            phases: [None; Phase::ALL.len()],
+            reported: false,
+        }
+    }
+
+    /// Records that `phase` started at `start` and took `elapsed_us`.
+    fn record(&mut self, phase: Phase, start: Instant, elapsed_us: u64) {
+        let begin = *self.begin.get_or_insert(start);
+        self.phases[phase as usize] = Some(elapsed_us);
+        if phase == Phase::Publish {
+            let published = start.saturating_duration_since(begin).as_micros() as u64;
+            self.published_us = Some(published + elapsed_us);
+        }
+    }
+
+    /// Records that the first IPC started at `start` and took `elapsed_us`.
+    fn record_first_ipc(&mut self, start: Instant, elapsed_us: u64) {
+        let begin = *self.begin.get_or_insert(start);
+        let served = start.saturating_duration_since(begin).as_micros() as u64;
+        self.first_ipc_us = Some((served + elapsed_us, elapsed_us));
+    }
+
+    /// Returns the time of `phase` in microseconds, if it ran.
+    pub(crate) fn phase_us(&self, phase: Phase) -> Option<u64> {
+        self.phases[phase as usize]
+    }
+
+    /// Returns the time from the first phase until the service was
+    /// published, in microseconds.
+    pub(crate) fn published_us(&self) -> Option<u64> {
+        self.published_us
+    }
+
+    /// Returns the time from the first phase until the reply of the first
+    /// IPC, and the time of its handling, in microseconds.
+    pub(crate) fn first_ipc_us(&self) -> Option<(u64, u64)> {
+        self.first_ipc_us
+    }
+
+    /// Formats the phases that ran for dumping.
+    pub(crate) fn dump(&self) -> String {
+        let mut out = String::new();
+        if self.begin.is_none() {
+            out.push_str("service not started\n");
+            return out;
+        }
+        for phase in Phase::ALL {
+            if let Some(us) = self.phase_us(phase) {
+                let _ = writeln!(out, "{:<32}{} us", phase.name(), us);
+            }
+        }
+        if let Some(us) = self.published_us {
+            let _ = writeln!(out, "{:<32}{} us", "published", us);
+        }
+        if let Some((served, handled)) = self.first_ipc_us {
+            let _ = writeln!(out, "{:<32}{} us", "first_ipc_handled", handled);
+            let _ = writeln!(out, "{:<32}{} us", "first_ipc_served", served);
+        }
+        out
+    }
+}
+
+/// Parameter of the `SERVICE_STARTUP` event with the time until the service
+/// was published.
+const TOTAL_US: &str = "TOTAL_US";
+
+/// Parameters of the `SERVICE_STARTUP` event with the time until the reply of
+/// the first IPC and the time of its handling.
+const FIRST_IPC_US: &str = "FIRST_IPC_US";
+const FIRST_IPC_HANDLED_US: &str = "FIRST_IPC_HANDLED_US";
+
+/// Startup of the running service.
+static STARTUP: Mutex<Startup> = Mutex::new(Startup::new());
+
+/// Runs the init phase `f` and records its time.
+pub(crate) fn measure<T>(phase: Phase, f: impl FnOnce() -> T) -> T {
+    let start = Instant::now();
+    let res = f();
+    let elapsed_us = start.elapsed().as_micros() as u64;
+    info!("startup {} took {} us", phase.name(), elapsed_us);
+    STARTUP.lock().unwrap().record(phase, start, elapsed_us);
+    res
+}
+
+/// Records the first IPC served, which started at `start`. Later ones only
+/// cost a relaxed load.
+pub(crate) fn served(start: Instant) {
+    static SERVED: AtomicBool = AtomicBool::new(false);
+    if SERVED.load(Ordering::Relaxed) || SERVED.swap(true, Ordering::Relaxed) {
+        return;
+    }
+    let elapsed_us = start.elapsed().as_micros() as u64;
+    info!("startup first ipc took {} us", elapsed_us);
+    STARTUP.lock().unwrap().record_first_ipc(start, elapsed_us);
+}
+
+/// Records the restore of the tasks and writes the `SERVICE_STARTUP` event,
+/// once per launch.
+pub(crate) fn restored(f: impl FnOnce()) {
+    measure(Phase::Restore, f);
+    let mut startup = STARTUP.lock().unwrap();
+    if startup.reported {
+        return;
+    }
+    startup.reported = true;
+    let mut event = SysEvent::service_startup();
+    for phase in Phase::ALL {
+        let us = startup.phase_us(phase).unwrap_or(0);
+        event = event.param(build_number_param!(phase.param(), us));
+    }
+    let total_us = startup.published_us().unwrap_or(0);
+    let (served_us, handled_us) = startup.first_ipc_us().unwrap_or_default();
+    event
+        .param(build_number_param!(TOTAL_US, total_us))
+        .param(build_number_param!(FIRST_IPC_US, served_us))
+        .param(build_number_param!(FIRST_IPC_HANDLED_US, handled_us))
+        .write();
+}
+
+/// Formats the startup breakdown for the `-b` option of hidumper.
+pub(crate) fn dump() -> String {
+    STARTUP.lock().unwrap().dump()
+}
+
+#[cfg(test)]
+mod ut_startup {
+    include!("../../tests/ut/utils/ut_startup.rs");
+}
@@ -12,70 +12,191 @@
 // limitations under the License.
 
 //! Provides utilities for generating unique task identifiers.
+//!
+//! Task IDs are the images of a sequence number through a keyed permutation of
+//! the `u32` values, so they are unique as long as the sequence numbers are and
+//! do not reveal how many tasks were created. The sequence numbers are handed
+//! out from an atomic counter in blocks whose end, the high-water mark, is
+//! persisted together with the key: creating a task reads nothing from the
+//! database and only writes to it once per block.
 
-cfg_oh! {
-    use std::sync::atomic::{AtomicU32, Ordering};
-    use std::time::{SystemTime, UNIX_EPOCH};
-    use crate::manage::database::RequestDb;
+use std::collections::hash_map::RandomState;
+use std::collections::HashSet;
+use std::hash::{BuildHasher, Hasher};
+use std::sync::atomic::{AtomicU64, Ordering};
+use std::sync::{LazyLock, Mutex};
+
+use crate::manage::database::RequestDb;
+
+/// Sequence numbers reserved by every write of the high-water mark.
+const ID_BLOCK: u64 = 1024;
+
+/// Sequence numbers available, one per `u32` value.
+const ID_SPACE: u64 = 1 << 32;
+
+/// Rounds of the permutation.
+const ROUNDS: usize = 4;
+
+static ALLOCATOR: LazyLock<IdAllocator> = LazyLock::new(IdAllocator::load);
+
+/// Keyed permutation of the `u32` values, a balanced Feistel network.
+pub(crate) struct IdPermutation {
+    round_keys: [u32; ROUNDS],
+}
+
+impl IdPermutation {
+    /// Creates the permutation of key `seed`.
+    pub(crate) fn new(seed: u64) -> Self {
+        let mut state = seed;
+        let mut round_keys = [0; ROUNDS];
+        for key in round_keys.iter_mut() {
+            // splitmix64
+            state = state.wrapping_add(0x9E37_79B9_7F4A_7C15);
+            let mut z = state;
+            z = (z ^ (z >> 30)).wrapping_mul(0xBF58_476D_1CE4_E5B9);
+            z = (z ^ (z >> 27)).wrapping_mul(0x94D0_49BB_1331_11EB);
+            *key = (z ^ (z >> 31)) as u32;
+        }
+        Self { round_keys }
+    }
+
+    fn round(half: u16, key: u32) -> u16 {
+        let x = (half as u32 ^ key).wrapping_mul(0x9E37_79B1);
+        ((x >> 16) as u16) ^ (x as u16)
+    }
+
+    /// Maps a sequence number to its task ID.
+    pub(crate) fn apply(&self, seq: u32) -> u32 {
+        let (mut left, mut right) = ((seq >> 16) as u16, seq as u16);
+        for key in self.round_keys {
+            (left, right) = (right, left ^ Self::round(right, key));
+        }
+        ((left as u32) << 16) | right as u32
+    }
+
+    /// Maps a task ID back to its sequence number.
+    pub(crate) fn invert(&self, id: u32) -> u32 {
+        let (mut left, mut right) = ((id >> 16) as u16, id as u16);
+        for key in self.round_keys.iter().rev() {
+            (left, right) = (right ^ Self::round(left, *key), left);
+        }
+        ((left as u32) << 16) | right as u32
+    }
+}
+
+/// Hands out the sequence numbers of the task IDs.
+struct IdAllocator {
+    seed: u64,
+    permutation: IdPermutation,
+    /// Next sequence number to hand out
+    next: AtomicU64,
+    /// End of the sequence numbers reserved in the database
+    reserved: AtomicU64,
+    /// Serializes the writes of the high-water mark
+    reserve_lock: Mutex<()>,
+    /// IDs of stored tasks the permutation can still produce, created by the
+    /// previous generator or with a lost high-water mark.
+    taken: HashSet<u32>,
+}
+
+impl IdAllocator {
+    fn load() -> Self {
+        let db = RequestDb::get_instance();
+        let (seed, start) = match db.task_id_state() {
+            Some((seed, reserved)) => (seed as u64, reserved as u64),
+            None => (RandomState::new().build_hasher().finish(), 0),
+        };
+        let permutation = IdPermutation::new(seed);
+        // Read once at startup, only IDs of tasks created before the allocator
+        // or before the high-water mark was stored are kept.
+        let taken = db
+            .task_ids()
+            .into_iter()
+            .filter(|id| permutation.invert(*id) as u64 >= start)
+            .collect::<HashSet<_>>();
+        info!(
+            "task id allocator starts at {}, {} ids taken",
+            start,
+            taken.len()
+        );
+        Self {
+            seed,
+            permutation,
+            next: AtomicU64::new(start),
+            reserved: AtomicU64::new(start),
+            reserve_lock: Mutex::new(()),
+            taken,
+        }
+    }
+
+    /// Returns an unused task ID, `None` once all the sequence numbers are
+    /// handed out.
+    fn allocate(&self) -> Option<u32> {
+        loop {
+            let seq = self.next.fetch_add(1, Ordering::Relaxed);
+            if seq >= ID_SPACE {
+                return None;
+            }
+            self.reserve(seq);
+            let task_id = self.permutation.apply(seq as u32);
+            if task_id != 0 && !self.taken.contains(&task_id) {
+                return Some(task_id);
+            }
+        }
+    }
+
+    /// Makes sure `seq` is below the persisted high-water mark, so it is not
+    /// handed out again after a restart.
+    fn reserve(&self, seq: u64) {
+        if seq < self.reserved.load(Ordering::Acquire) {
+            return;
+        }
+        let _lock = self.reserve_lock.lock().unwrap();
+        if seq < self.reserved.load(Ordering::Acquire) {
+            return;
+        }
+        let end = (seq / ID_BLOCK + 1) * ID_BLOCK;
+        let db = RequestDb::get_instance();
+        if let Err(e) = db.store_task_id_state(self.seed as i64, end as i64) {
+            // The ids are still unique in this run, only those of a restart may
+            // be handed out again, which `taken` then filters out.
+            error!("store task id high-water mark failed {}", e);
+        }
+        self.reserved.store(end, Ordering::Release);
+    }
 }
 
 /// Generator for unique task identifiers.
 ///
 /// This struct provides functionality to generate unique 32-bit identifiers
-/// for tasks, with different implementations based on feature flags.
+/// for tasks.
 pub(crate) struct TaskIdGenerator;
 
 impl TaskIdGenerator {
     /// Generates a unique task identifier.
     ///
-    /// # Feature Dependencies
-    /// This function has two different implementations:
-    /// - For `oh` feature: Uses system time nanoseconds with an atomic fallback
-    /// - For other cases: Uses random number generation
+    /// The identifier comes from the allocator without querying the database,
+    /// which is only probed once its `u32` sequence numbers are exhausted.
     ///
     /// # Examples
     /// ```rust
     /// // Generate a new unique task ID
     /// let task_id = TaskIdGenerator::generate();
     /// ```
-    #[cfg(feature = "oh")]
     pub(crate) fn generate() -> u32 {
+        if let Some(task_id) = ALLOCATOR.allocate() {
+            return task_id;
+        }
         loop {
-            debug!("generate task_id");
-            // Try to use system time's nanoseconds for unique ID generation
-            let task_id = match SystemTime::now().duration_since(UNIX_EPOCH) {
-                Ok(time) => time.subsec_nanos(),
-                Err(e) => {
-                    // Fallback to atomic counter if system time fails
-                    static ID: AtomicU32 = AtomicU32::new(0);
-                    error!("Generate task id from system time failed {:?}", e);
-                    sys_event!(
-                        ExecFault,
-                        DfxCode::SA_ERROR_00,
-                        &format!("Generate task id from system time failed {:?}", e)
-                    );
-                    // Increment and return atomic counter (relaxed ordering sufficient here)
-                    ID.fetch_add(1, Ordering::Relaxed)
-                }
-            };
-            // Ensure generated ID is unique by checking database
-            if !RequestDb::get_instance().contains_task(task_id) {
+            let task_id = RandomState::new().build_hasher().finish() as u32;
+            if task_id != 0 && !RequestDb::get_instance().contains_task(task_id) {
                 return task_id;
             }
         }
     }
-    
-    /// Generates a unique task identifier using random number generation.
-    ///
-    /// This implementation is used when the `oh` feature is not enabled.
-    ///
-    /// # Examples
-    /// ```rust
-    /// // Generate a random task ID
-    /// let task_id = TaskIdGenerator::generate();
-    /// ```
-    #[cfg(not(feature = "oh"))]
-    pub(crate) fn generate() -> u32 {
-        rand::random()
-    }
+}
+
+#[cfg(test)]
+mod ut_task_id_generator {
+    include!("../../tests/ut/utils/ut_task_id_generator.rs");
 }
@@ -15,9 +15,31 @@
 //! 
 //! This module contains utilities for verifying if an application has permission to access
 //! specific URL domains based on domain type policies.
+//!
+//! The policy is checked by a call into the api policy library for every
+//! created task and redirect. Its results are kept per application, domain
+//! type and host for `POLICY_TTL`, so creating many tasks towards the same
+//! hosts checks each of them once.
+
+use std::sync::{LazyLock, Mutex};
+use std::time::{Duration, Instant};
+
+use request_utils::lru::LRUCache;
+use request_utils::url::UrlView;
 
 use crate::utils::c_wrapper::CStringWrapper;
 
+/// Time a policy result is reused.
+const POLICY_TTL: Duration = Duration::from_secs(60);
+
+/// Number of policy results kept.
+const POLICY_CACHE_SIZE: usize = 256;
+
+/// Policy results and when they were checked, by application, domain type
+/// and host.
+static POLICY_CACHE: LazyLock<Mutex<LRUCache<String, (bool, Instant)>>> =
+    LazyLock::new(|| Mutex::new(LRUCache::new()));
+
 /// Checks if an application is allowed to access a specific URL domain.
 ///
 /// This function validates whether the given application has permission to access
@@ -47,13 +69,63 @@ use crate::utils::c_wrapper::CStringWrapper;
 /// # Safety
 /// This function calls an unsafe external C function to perform the actual policy check.
 /// String conversion to C-compatible format is handled internally.
+///
+/// # Notes
+/// The result of a host is reused for `POLICY_TTL`, failed checks are not
+/// reused.
 pub(crate) fn check_url_domain(app_id: &str, domain_type: &str, url: &str) -> Option<bool> {
+    let host = UrlView::parse(url).host;
+    let key = (!host.is_empty()).then(|| policy_key(app_id, domain_type, host));
+    if let Some(accessed) = key.as_ref().and_then(|key| cached_policy(key)) {
+        return Some(accessed);
+    }
+
     // Call external C policy check function with string conversions
-    match unsafe { PolicyCheckUrlDomain(app_id.into(), domain_type.into(), url.into()) } {
+    let code = unsafe { PolicyCheckUrlDomain(app_id.into(), domain_type.into(), url.into()) };
+    let accessed = match code {
         // Map C return codes to Rust Option<bool>
-        0 => Some(true),   // 0 indicates allowed
-        1 => Some(false),  // 1 indicates denied
-        _ => None,         // Any other value indicates failure
+        0 => Some(true),  // 0 indicates allowed
+        1 => Some(false), // 1 indicates denied
+        _ => None,        // Any other value indicates failure
+    };
+    if let (Some(key), Some(accessed)) = (key, accessed) {
+        cache_policy(key, accessed, Instant::now());
+    }
+    accessed
+}
+
+/// Returns the key of the policy result of a host.
+fn policy_key(app_id: &str, domain_type: &str, host: &str) -> String {
+    let mut key = String::with_capacity(app_id.len() + domain_type.len() + host.len() + 2);
+    key.push_str(app_id);
+    key.push('\0');
+    key.push_str(domain_type);
+    key.push('\0');
+    // Hosts are case insensitive.
+    key.extend(host.chars().map(|c| c.to_ascii_lowercase()));
+    key
+}
+
+/// Returns the policy result of `key` if it was checked less than
+/// `POLICY_TTL` ago.
+fn cached_policy(key: &String) -> Option<bool> {
+    let mut cache = POLICY_CACHE.lock().unwrap();
+    match cache.get(key) {
+        Some(&(accessed, checked)) if checked.elapsed() < POLICY_TTL => Some(accessed),
+        Some(_) => {
+            cache.remove(key);
+            None
+        }
+        None => None,
+    }
+}
+
+/// Keeps the policy result of `key` checked at `now`.
+fn cache_policy(key: String, accessed: bool, now: Instant) {
+    let mut cache = POLICY_CACHE.lock().unwrap();
+    cache.insert(key, (accessed, now));
+    if cache.len() > POLICY_CACHE_SIZE {
+        cache.pop();
     }
 }
 
@@ -76,3 +148,8 @@ extern "C" {
         url: CStringWrapper,
     ) -> i32;
 }
+
+#[cfg(test)]
+mod ut_url_policy {
+    include!("../../tests/ut/utils/ut_url_policy.rs");
+}
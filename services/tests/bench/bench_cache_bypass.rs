@@ -0,0 +1,123 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Cost of a large download for the foreground, with and without the page
+// cache bypass of `bypass_cache` downloads.
+//
+// A working set standing for the pages of the foreground application is read
+// into the page cache, a large download is written the way `TaskOperator`
+// writes it, then the working set is read again. The time of that second
+// read grows with the pages the download evicted. Every run is printed as one
+// JSON line, e.g.
+// {"bench":"cache_bypass","bypass":true,"download_mb":1024,"write_mean_us":910.4,
+//  "write_p99_us":5120.0,"write_max_us":20480.3,"working_set_reread_ms":31.2}
+
+use std::fs::OpenOptions;
+use std::io::Read;
+use std::path::PathBuf;
+use std::time::Instant;
+
+use super::*;
+
+/// Size of the working set of the foreground application.
+const WORKING_SET: usize = 128 * 1024 * 1024;
+
+/// Size of the download.
+const DOWNLOAD: usize = 1024 * 1024 * 1024;
+
+/// Size of a write of the download, the write buffer of `TaskOperator`.
+const WRITE: usize = 512 * 1024;
+
+fn bench_path(name: &str) -> PathBuf {
+    std::env::temp_dir().join(name)
+}
+
+/// Reads a whole file, returning the milliseconds taken.
+fn read_all(path: &PathBuf) -> f64 {
+    let start = Instant::now();
+    let mut file = File::open(path).unwrap();
+    let mut buf = vec![0; 1024 * 1024];
+    while file.read(&mut buf).unwrap() != 0 {}
+    start.elapsed().as_secs_f64() * 1000.0
+}
+
+fn run(bypass: bool) {
+    let working_set = bench_path("bench_cache_bypass_working_set");
+    let download = bench_path("bench_cache_bypass_download");
+    read_all(&working_set);
+
+    let mut file = OpenOptions::new()
+        .create(true)
+        .write(true)
+        .truncate(true)
+        .open(&download)
+        .unwrap();
+    let buf = vec![0x5a; WRITE];
+    let mut latencies = Vec::with_capacity(DOWNLOAD / WRITE);
+    for _ in 0..DOWNLOAD / WRITE {
+        let start = Instant::now();
+        file.write_all(&buf).unwrap();
+        if bypass {
+            let end = file.stream_position().unwrap();
+            file_write_behind(&file, end, WRITE as u64).unwrap();
+        }
+        latencies.push(start.elapsed().as_secs_f64() * 1_000_000.0);
+    }
+    file.sync_all().unwrap();
+    drop(file);
+    let reread = read_all(&working_set);
+    std::fs::remove_file(&download).unwrap();
+
+    latencies.sort_by(|a, b| a.partial_cmp(b).unwrap());
+    let mean = latencies.iter().sum::<f64>() / latencies.len() as f64;
+    let p99 = latencies[latencies.len() * 99 / 100];
+    println!(
+        "{{\"bench\":\"cache_bypass\",\"bypass\":{},\"download_mb\":{},\"write_mean_us\":{:.1},\
+         \"write_p99_us\":{:.1},\"write_max_us\":{:.1},\"working_set_reread_ms\":{:.1}}}",
+        bypass,
+        DOWNLOAD / 1024 / 1024,
+        mean,
+        p99,
+        latencies[latencies.len() - 1],
+        reread
+    );
+}
+
+// @tc.name: bench_cache_bypass
+// @tc.desc: Compare the eviction of a cached working set by a large download
+//           written through the page cache and bypassing it
+// @tc.precon: The temporary directory is on the storage of the downloads
+// @tc.step: 1. Write a working set file and read it into the page cache
+//           2. Write a large download through the page cache, then read the
+//              working set again
+//           3. Repeat with the page cache bypass
+//           4. Print one JSON line per run
+// @tc.expect: Every run reports its write latencies and the time to read the
+//             working set again
+// @tc.type: PERF
+// @tc.require: issueNumber
+#[test]
+fn bench_cache_bypass() {
+    let working_set = bench_path("bench_cache_bypass_working_set");
+    let mut file = File::create(&working_set).unwrap();
+    let buf = vec![0xa5; 1024 * 1024];
+    for _ in 0..WORKING_SET / buf.len() {
+        file.write_all(&buf).unwrap();
+    }
+    file.sync_all().unwrap();
+    drop(file);
+
+    run(false);
+    run(true);
+    std::fs::remove_file(&working_set).unwrap();
+}
@@ -0,0 +1,262 @@
+// Copyright (C) 2024 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Latency of the hot `request_task` paths over synthetic task populations.
+//
+// Every measurement is printed as one JSON line, e.g.
+// {"bench":"request_db","db_version":3,"rows":10000,"op":"update_task_state",
+//  "iters":200,"mean_us":41.2,"p50_us":38.0,"p99_us":97.5,"max_us":130.1}
+// so runs before and after a schema or index change can be diffed directly.
+
+use std::time::{Duration, Instant};
+
+use super::*;
+use crate::config::Mode;
+use crate::database::DB_VERSION;
+use crate::manage::query::TaskFilter;
+use crate::task::notify::Progress;
+use crate::tests::{lock_database, test_init};
+
+/// Task populations the harness runs against.
+const POPULATIONS: [usize; 3] = [1_000, 10_000, 100_000];
+
+/// Tasks per synthetic application.
+const TASKS_PER_UID: usize = 50;
+
+/// Rows inserted by one statement while populating.
+const INSERT_CHUNK: usize = 500;
+
+/// Measured calls per operation.
+const ITERS: usize = 200;
+
+/// First uid of the synthetic applications.
+const BASE_UID: u64 = 20_020_000;
+
+/// First task id of the synthetic population.
+const BASE_TASK_ID: u32 = 1_000_000;
+
+/// State of the `i`-th synthetic task, most of the history is terminal like
+/// on a real device.
+fn synthetic_state(i: usize) -> (State, Reason) {
+    match i % 10 {
+        0 => (State::Running, Reason::Default),
+        1 | 2 => (State::Waiting, Reason::RunningTaskMeetLimits),
+        3 => (State::Failed, Reason::Default),
+        4 => (State::Paused, Reason::Default),
+        _ => (State::Completed, Reason::Default),
+    }
+}
+
+fn populate(db: &RequestDb, rows: usize) {
+    let now = get_current_timestamp();
+    let transaction = db.begin_transaction();
+    for start in (0..rows).step_by(INSERT_CHUNK) {
+        let end = (start + INSERT_CHUNK).min(rows);
+        let mut tasks = Vec::with_capacity(end - start);
+        let mut progress = Vec::with_capacity(end - start);
+        for i in start..end {
+            let task_id = BASE_TASK_ID + i as u32;
+            let uid = BASE_UID + (i / TASKS_PER_UID) as u64;
+            let (state, reason) = synthetic_state(i);
+            let action = if i % 3 == 0 {
+                Action::Upload
+            } else {
+                Action::Download
+            };
+            let time = now - (i as u64) * 1000;
+            tasks.push(format!(
+                "({}, {}, {}, {}, {}, {}, {}, {}, {}, {}, 'com.bench.app{}')",
+                task_id,
+                uid,
+                uid,
+                action.repr,
+                Mode::BackGround.repr,
+                state.repr,
+                reason.repr,
+                i,
+                time,
+                time,
+                uid
+            ));
+            progress.push(format!("({}, {})", task_id, time));
+        }
+        db.execute(&format!(
+            "INSERT INTO request_task (task_id, uid, token_id, action, mode, state, reason, priority, ctime, mtime, bundle) VALUES {}",
+            tasks.join(",")
+        ))
+        .unwrap();
+        db.execute(&format!(
+            "INSERT OR REPLACE INTO request_task_progress (task_id, mtime) VALUES {}",
+            progress.join(",")
+        ))
+        .unwrap();
+    }
+    if transaction {
+        db.commit();
+    }
+}
+
+fn clear(db: &RequestDb) {
+    db.execute(&format!(
+        "DELETE FROM request_task WHERE task_id >= {}",
+        BASE_TASK_ID
+    ))
+    .unwrap();
+    db.forget_all_tasks();
+}
+
+fn update_info(processed: usize) -> UpdateInfo {
+    let mut progress = Progress::new(vec![1 << 20]);
+    progress.common_data.total_processed = processed;
+    progress.processed[0] = processed;
+    UpdateInfo {
+        mtime: get_current_timestamp(),
+        reason: Reason::Default.repr,
+        tries: 0,
+        mime_type: String::new(),
+        progress,
+    }
+}
+
+fn measure(mut f: impl FnMut(usize)) -> Vec<Duration> {
+    // Warm up the page cache and prepared statements first.
+    for i in 0..ITERS / 10 {
+        f(i);
+    }
+    (0..ITERS)
+        .map(|i| {
+            let start = Instant::now();
+            f(i);
+            start.elapsed()
+        })
+        .collect()
+}
+
+fn report(rows: usize, op: &str, mut samples: Vec<Duration>) {
+    samples.sort();
+    let us = |d: Duration| d.as_secs_f64() * 1e6;
+    let percentile = |p: usize| us(samples[(samples.len() - 1) * p / 100]);
+    let mean = samples.iter().map(|d| us(*d)).sum::<f64>() / samples.len() as f64;
+    println!(
+        "{{\"bench\":\"request_db\",\"db_version\":{},\"rows\":{},\"op\":\"{}\",\"iters\":{},\"mean_us\":{:.1},\"p50_us\":{:.1},\"p99_us\":{:.1},\"max_us\":{:.1}}}",
+        DB_VERSION,
+        rows,
+        op,
+        samples.len(),
+        mean,
+        percentile(50),
+        percentile(99),
+        us(samples[samples.len() - 1]),
+    );
+}
+
+fn run_population(db: &RequestDb, rows: usize) {
+    clear(db);
+    let start = Instant::now();
+    populate(db, rows);
+    report(rows, "populate", vec![start.elapsed()]);
+
+    let uids = (rows / TASKS_PER_UID).max(1);
+    let task_id = |i: usize| BASE_TASK_ID + ((i * 7919) % rows) as u32;
+    let uid = |i: usize| BASE_UID + (i % uids) as u64;
+
+    report(
+        rows,
+        "get_app_task_qos_infos",
+        measure(|i| {
+            db.get_app_task_qos_infos(uid(i));
+        }),
+    );
+
+    report(
+        rows,
+        "update_task",
+        measure(|i| {
+            db.update_task(task_id(i), update_info(i));
+            db.flush_task_progress(task_id(i));
+        }),
+    );
+
+    report(
+        rows,
+        "update_task_state",
+        measure(|i| {
+            let (state, reason) = synthetic_state(i);
+            db.update_task_state(task_id(i), state, reason);
+        }),
+    );
+
+    let now = get_current_timestamp() as i64;
+    let filter = || TaskFilter {
+        before: now,
+        after: now - (rows as i64) * 1000,
+        state: State::Any.repr,
+        action: Action::Any.repr,
+        mode: Mode::Any.repr,
+        keyword: String::new(),
+    };
+    report(
+        rows,
+        "search_task",
+        measure(|i| {
+            db.search_task(filter(), uid(i));
+        }),
+    );
+    report(
+        rows,
+        "system_search_task",
+        measure(|i| {
+            db.system_search_task(filter(), format!("com.bench.app{}", uid(i)));
+        }),
+    );
+
+    // Mirrors `reload_all_app_from_database`, which runs when the service
+    // restores all tasks on startup.
+    let restore = measure(|_| {
+        db.get_all_task_qos_infos();
+    });
+    report(rows, "restore_all_tasks", restore);
+
+    // The former restore, one query for the app list and one per app, kept
+    // as a baseline for the single query above.
+    let restore = measure(|_| {
+        let apps = db.query_integer::<u64>("SELECT DISTINCT uid FROM request_task");
+        for app in apps {
+            db.get_app_task_qos_infos(app);
+        }
+    });
+    report(rows, "restore_all_tasks_per_app", restore);
+
+    clear(db);
+}
+
+// @tc.name: bench_request_db
+// @tc.desc: Measure request_task latencies over 1k, 10k and 100k synthetic
+//           tasks spread across many applications
+// @tc.precon: NA
+// @tc.step: 1. Populate request_task with a synthetic population
+//           2. Measure qos lookups, progress and state writes, searches and
+//              the startup restore path
+//           3. Print one JSON line per measurement
+// @tc.expect: Every measured operation reports its latency distribution
+// @tc.type: PERF
+// @tc.require: issues#ICN16H
+#[test]
+fn bench_request_db() {
+    test_init();
+    let _lock = lock_database();
+    let db = RequestDb::get_instance();
+    for rows in POPULATIONS {
+        run_population(db, rows);
+    }
+}
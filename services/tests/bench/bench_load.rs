@@ -0,0 +1,527 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Load of many applications running many tasks at once through the task
+// manager.
+//
+// A local server, in the way of the `test_server` of the cache_download
+// benches, serves the downloads with range support and takes the uploads.
+// Each simulated application creates and starts its tasks, a mix of sizes,
+// uploads and downloads, some of them paused and resumed on the way. The
+// notifications of the tasks are collected in place of the client manager.
+// The server sends as a link of the net profile named by
+// `REQUEST_NET_PROFILE`, the loopback if unset, whose dropped connections the
+// tasks retry. Every run is printed as one JSON line, e.g.
+// {"bench":"load","profile":"3g","apps":4,"tasks_per_app":8,"tasks":32,"failed":0,"mb":52.1,
+//  "mb_per_s":41.7,"cpu_ms_per_mb":12.3,"notify_p50_ms":1.2,"notify_p99_ms":8.4,
+//  "sched_p50_ms":3.1,"sched_p99_ms":210.5,"peak_rss_kb":30512}
+//
+// The scheduling latency runs from the start or resume of a task to its
+// request reaching the server, so it includes the time the task waited for a
+// running slot. The notify latency runs from the end of the exchange on the
+// server to the completion notification. The CPU time and the peak RSS are
+// those of the whole test process, server included.
+
+use std::collections::HashMap;
+use std::fs::{self, File};
+use std::io::{Read, Write};
+use std::net::{TcpListener, TcpStream};
+use std::sync::{Arc, Mutex};
+use std::thread;
+use std::time::{Duration, Instant};
+
+use once_cell::sync::Lazy;
+use request_utils::test::shaping::{NetProfile, Shaped};
+use ylong_runtime::sync::mpsc::unbounded_channel;
+
+use crate::config::{Action, ConfigBuilder, Mode};
+use crate::error::ErrorCode;
+use crate::manage::events::TaskManagerEvent;
+use crate::manage::network::{NetworkInfo, NetworkType};
+use crate::manage::network_manager::NetworkManager;
+use crate::manage::task_manager::TaskManagerTx;
+use crate::manage::TaskManager;
+use crate::service::active_counter::ActiveCounter;
+use crate::service::client::{ClientEvent, ClientManagerEntry};
+use crate::service::run_count::RunCountManager;
+use crate::task::notify::SubscribeType;
+use crate::tests::test_init;
+
+/// Number of applications and of tasks per application of the runs.
+const RUNS: [(usize, usize); 3] = [(1, 32), (4, 8), (16, 4)];
+
+/// Sizes of the tasks, taken in turn.
+const SIZES: [usize; 4] = [16 * 1024, 256 * 1024, 1024 * 1024, 4 * 1024 * 1024];
+
+/// Every `UPLOAD_EVERY`th task is an upload.
+const UPLOAD_EVERY: usize = 4;
+
+/// Every `PAUSE_EVERY`th download of the largest size is paused and resumed.
+const PAUSE_EVERY: usize = 2;
+
+/// Size of the writes of the server, so that a pause cuts a body short.
+const WRITE: usize = 64 * 1024;
+
+/// Longest time a run waits for its tasks.
+const RUN_TIMEOUT: Duration = Duration::from_secs(300);
+
+/// Clock ticks per second of the CPU times of `/proc`.
+const USER_HZ: f64 = 100.0;
+
+/// Time of the requests reaching the server and of the end of the last
+/// exchange, by task index.
+#[derive(Default)]
+struct ServerLog {
+    requests: HashMap<usize, Vec<Instant>>,
+    ends: HashMap<usize, Instant>,
+}
+
+/// State of the tasks seen by the collector of the notifications.
+#[derive(Default)]
+struct Collected {
+    completed: HashMap<u32, Instant>,
+    failed: HashMap<u32, Instant>,
+}
+
+static SERVER_LOG: Lazy<Mutex<ServerLog>> = Lazy::new(|| Mutex::new(ServerLog::default()));
+
+static COLLECTED: Lazy<Mutex<Collected>> = Lazy::new(|| Mutex::new(Collected::default()));
+
+static TASK_MANAGER: Lazy<TaskManagerTx> = Lazy::new(|| {
+    {
+        let network_manager = NetworkManager::get_instance().lock().unwrap();
+        network_manager.network.inner.notify_online(NetworkInfo {
+            network_type: NetworkType::Wifi,
+            is_metered: false,
+            is_roaming: false,
+        });
+    }
+    let (tx, mut rx) = unbounded_channel();
+    thread::spawn(move || {
+        ylong_runtime::block_on(async {
+            while let Ok(event) = rx.recv().await {
+                let now = Instant::now();
+                let mut collected = COLLECTED.lock().unwrap();
+                match event {
+                    ClientEvent::SendNotifyData(SubscribeType::Complete, data) => {
+                        collected.completed.insert(data.task_id, now);
+                    }
+                    ClientEvent::SendNotifyData(SubscribeType::Fail, data) => {
+                        collected.failed.insert(data.task_id, now);
+                    }
+                    _ => {}
+                }
+            }
+        })
+    });
+    TaskManager::init(
+        RunCountManager::init(),
+        ClientManagerEntry::new(tx),
+        ActiveCounter::new(),
+    )
+});
+
+/// Buffered side of a connection of the server.
+struct Conn {
+    stream: TcpStream,
+    buf: Vec<u8>,
+}
+
+impl Conn {
+    /// Reads more bytes into the buffer, false at the end of the stream.
+    fn fill(&mut self) -> bool {
+        let mut chunk = [0u8; 16 * 1024];
+        match self.stream.read(&mut chunk) {
+            Ok(0) | Err(_) => false,
+            Ok(n) => {
+                self.buf.extend_from_slice(&chunk[..n]);
+                true
+            }
+        }
+    }
+
+    /// Reads up to and without the next `\r\n`.
+    fn line(&mut self) -> Option<String> {
+        loop {
+            if let Some(pos) = self.buf.windows(2).position(|w| w == b"\r\n") {
+                let line = String::from_utf8_lossy(&self.buf[..pos]).to_string();
+                self.buf.drain(..pos + 2);
+                return Some(line);
+            }
+            if !self.fill() {
+                return None;
+            }
+        }
+    }
+
+    /// Reads and drops `len` bytes.
+    fn skip(&mut self, mut len: usize) -> bool {
+        loop {
+            let taken = len.min(self.buf.len());
+            self.buf.drain(..taken);
+            len -= taken;
+            if len == 0 {
+                return true;
+            }
+            if !self.fill() {
+                return false;
+            }
+        }
+    }
+
+    /// Reads and drops a chunked body.
+    fn skip_chunked(&mut self) -> bool {
+        loop {
+            let Some(line) = self.line() else {
+                return false;
+            };
+            let size = line.split(';').next().unwrap_or("").trim();
+            let Ok(size) = usize::from_str_radix(size, 16) else {
+                return false;
+            };
+            if !self.skip(size) || self.line().is_none() {
+                return false;
+            }
+            if size == 0 {
+                return true;
+            }
+        }
+    }
+}
+
+/// Serves the requests of a connection.
+///
+/// `/d/<index>/<size>` answers with a body of `size` bytes, from the start of
+/// a `Range` if any, `/u/<index>` takes the body of the request. The answers
+/// are sent as a link of `profile`.
+fn serve_connection(stream: TcpStream, body: Arc<Vec<u8>>, profile: NetProfile) {
+    let Ok(writer) = stream.try_clone() else {
+        return;
+    };
+    let mut writer = Shaped::new(writer, profile);
+    let mut conn = Conn {
+        stream,
+        buf: Vec::new(),
+    };
+    while let Some(request) = conn.line() {
+        let mut headers = HashMap::new();
+        loop {
+            match conn.line() {
+                None => return,
+                Some(line) if line.is_empty() => break,
+                Some(line) => {
+                    if let Some((name, value)) = line.split_once(':') {
+                        headers.insert(name.trim().to_ascii_lowercase(), value.trim().to_string());
+                    }
+                }
+            }
+        }
+        let path = request.split(' ').nth(1).unwrap_or("").to_string();
+        let parts = path.split('/').collect::<Vec<_>>();
+        let Some(index) = parts.get(2).and_then(|index| index.parse::<usize>().ok()) else {
+            return;
+        };
+        SERVER_LOG
+            .lock()
+            .unwrap()
+            .requests
+            .entry(index)
+            .or_default()
+            .push(Instant::now());
+
+        writer.respond();
+        let served = if parts[1] == "u" {
+            let read = match headers.get("content-length") {
+                Some(len) => conn.skip(len.parse().unwrap_or(0)),
+                None if headers.contains_key("transfer-encoding") => conn.skip_chunked(),
+                None => true,
+            };
+            read && writer
+                .write_all(b"HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n")
+                .is_ok()
+        } else {
+            let size = parts
+                .get(3)
+                .and_then(|size| size.parse::<usize>().ok())
+                .unwrap_or(0)
+                .min(body.len());
+            let from = headers
+                .get("range")
+                .and_then(|range| range.strip_prefix("bytes="))
+                .and_then(|range| range.split('-').next())
+                .and_then(|from| from.parse::<usize>().ok())
+                .filter(|from| *from < size);
+            let head = match from {
+                Some(from) => format!(
+                    "HTTP/1.1 206 Partial Content\r\nContent-Length: {}\r\n\
+                     Content-Range: bytes {}-{}/{}\r\nETag: \"bench\"\r\n\r\n",
+                    size - from,
+                    from,
+                    size - 1,
+                    size
+                ),
+                None => format!(
+                    "HTTP/1.1 200 OK\r\nContent-Length: {}\r\nETag: \"bench\"\r\n\
+                     Accept-Ranges: bytes\r\n\r\n",
+                    size
+                ),
+            };
+            writer.write_all(head.as_bytes()).is_ok()
+                && body[from.unwrap_or(0)..size]
+                    .chunks(WRITE)
+                    .all(|chunk| writer.write_all(chunk).is_ok())
+        };
+        if !served {
+            return;
+        }
+        SERVER_LOG
+            .lock()
+            .unwrap()
+            .ends
+            .insert(index, Instant::now());
+    }
+}
+
+/// Starts the server sending as a link of `profile`, returning its address.
+fn serve(profile: NetProfile) -> String {
+    let listener = TcpListener::bind("127.0.0.1:0").unwrap();
+    let addr = listener.local_addr().unwrap();
+    let body = Arc::new(vec![0x5a; SIZES[SIZES.len() - 1]]);
+    thread::spawn(move || {
+        for stream in listener.incoming().flatten() {
+            let body = body.clone();
+            thread::spawn(move || serve_connection(stream, body, profile));
+        }
+    });
+    format!("http://{}", addr)
+}
+
+/// Returns the user and system CPU time of the process in milliseconds.
+fn cpu_ms() -> f64 {
+    let stat = fs::read_to_string("/proc/self/stat").unwrap_or_default();
+    // The name of the process is in parentheses and may hold spaces
+    let fields = stat
+        .rsplit_once(')')
+        .map(|(_, rest)| rest.split_whitespace().collect::<Vec<_>>())
+        .unwrap_or_default();
+    let ticks = |i: usize| {
+        fields
+            .get(i)
+            .and_then(|t| t.parse::<f64>().ok())
+            .unwrap_or(0.0)
+    };
+    // utime and stime, fields 14 and 15 of the line
+    (ticks(11) + ticks(12)) * 1000.0 / USER_HZ
+}
+
+/// Returns the peak resident set size of the process in KB.
+fn peak_rss_kb() -> u64 {
+    fs::read_to_string("/proc/self/status")
+        .unwrap_or_default()
+        .lines()
+        .find_map(|line| line.strip_prefix("VmHWM:"))
+        .and_then(|value| value.trim().trim_end_matches("kB").trim().parse().ok())
+        .unwrap_or(0)
+}
+
+/// Returns the value at `percent` of sorted milliseconds, 0 if there are none.
+fn percentile(sorted: &[f64], percent: usize) -> f64 {
+    match sorted.len() {
+        0 => 0.0,
+        len => sorted[(len * percent / 100).min(len - 1)],
+    }
+}
+
+/// A task of a run.
+struct Planned {
+    index: usize,
+    uid: u64,
+    task_id: u32,
+    size: usize,
+    /// When the task was started, then resumed
+    started: Vec<Instant>,
+}
+
+/// Creates and starts the tasks of an application, pausing and resuming
+/// some of them.
+fn run_app(uid: u64, first: usize, tasks: usize, server: &str) -> Vec<Planned> {
+    let mut planned = Vec::with_capacity(tasks);
+    for index in first..first + tasks {
+        let size = SIZES[index % SIZES.len()];
+        let path = format!("test_files/bench_load_{}", index);
+        let mut builder = ConfigBuilder::new();
+        builder.mode(Mode::BackGround).uid(uid).retry(true);
+        if index % UPLOAD_EVERY == 0 {
+            let mut file = File::create(&path).unwrap();
+            file.write_all(&vec![0xa5; size]).unwrap();
+            builder
+                .action(Action::Upload)
+                .method("PUT")
+                .url(&format!("{}/u/{}", server, index))
+                .file_spec(File::open(&path).unwrap());
+        } else {
+            builder
+                .action(Action::Download)
+                .url(&format!("{}/d/{}/{}", server, index, size))
+                .file_spec(File::create(&path).unwrap());
+        }
+        let (event, rx) = TaskManagerEvent::construct(builder.build());
+        TASK_MANAGER.send_event(event);
+        let task_id = rx.get().unwrap().unwrap();
+        let started = Instant::now();
+        let (event, rx) = TaskManagerEvent::start(uid, task_id);
+        TASK_MANAGER.send_event(event);
+        assert_eq!(rx.get().unwrap(), ErrorCode::ErrOk);
+        planned.push(Planned {
+            index,
+            uid,
+            task_id,
+            size,
+            started: vec![started],
+        });
+    }
+
+    let largest = SIZES[SIZES.len() - 1];
+    let paused = planned
+        .iter_mut()
+        .filter(|task| task.size == largest && task.index % UPLOAD_EVERY != 0)
+        .step_by(PAUSE_EVERY)
+        .collect::<Vec<_>>();
+    for task in paused {
+        thread::sleep(Duration::from_millis(20));
+        let (event, rx) = TaskManagerEvent::pause(task.uid, task.task_id);
+        TASK_MANAGER.send_event(event);
+        if rx.get() != Some(ErrorCode::ErrOk) {
+            continue;
+        }
+        thread::sleep(Duration::from_millis(50));
+        let resumed = Instant::now();
+        let (event, rx) = TaskManagerEvent::resume(task.uid, task.task_id);
+        TASK_MANAGER.send_event(event);
+        if rx.get() == Some(ErrorCode::ErrOk) {
+            task.started.push(resumed);
+        }
+    }
+    planned
+}
+
+fn run(profile: NetProfile, apps: usize, tasks_per_app: usize) {
+    *SERVER_LOG.lock().unwrap() = ServerLog::default();
+    let server = serve(profile);
+    let cpu_before = cpu_ms();
+    let start = Instant::now();
+
+    let handles = (0..apps)
+        .map(|app| {
+            let server = server.clone();
+            let uid = 20_000_000 + app as u64;
+            thread::spawn(move || run_app(uid, app * tasks_per_app, tasks_per_app, &server))
+        })
+        .collect::<Vec<_>>();
+    let planned = handles
+        .into_iter()
+        .flat_map(|handle| handle.join().unwrap())
+        .collect::<Vec<_>>();
+
+    loop {
+        let collected = COLLECTED.lock().unwrap();
+        let done = planned.iter().all(|task| {
+            collected.completed.contains_key(&task.task_id)
+                || collected.failed.contains_key(&task.task_id)
+        });
+        if done || start.elapsed() > RUN_TIMEOUT {
+            break;
+        }
+        drop(collected);
+        thread::sleep(Duration::from_millis(10));
+    }
+    let total = start.elapsed().as_secs_f64();
+    let cpu = cpu_ms() - cpu_before;
+
+    let collected = COLLECTED.lock().unwrap();
+    let log = SERVER_LOG.lock().unwrap();
+    let mut bytes = 0;
+    let mut failed = 0;
+    let mut notify = vec![];
+    let mut sched = vec![];
+    for task in planned.iter() {
+        match collected.completed.get(&task.task_id) {
+            Some(completed) => {
+                bytes += task.size;
+                if let Some(end) = log.ends.get(&task.index) {
+                    notify.push(completed.saturating_duration_since(*end).as_secs_f64() * 1000.0);
+                }
+            }
+            None => failed += 1,
+        }
+        let requests = log
+            .requests
+            .get(&task.index)
+            .map(Vec::as_slice)
+            .unwrap_or(&[]);
+        for started in task.started.iter() {
+            if let Some(request) = requests.iter().find(|request| *request >= started) {
+                sched.push(request.duration_since(*started).as_secs_f64() * 1000.0);
+            }
+        }
+    }
+    notify.sort_by(|a, b| a.partial_cmp(b).unwrap());
+    sched.sort_by(|a, b| a.partial_cmp(b).unwrap());
+    let mb = bytes as f64 / (1024.0 * 1024.0);
+    println!(
+        "{{\"bench\":\"load\",\"profile\":\"{}\",\"apps\":{},\"tasks_per_app\":{},\"tasks\":{},\"failed\":{},\
+         \"mb\":{:.1},\"mb_per_s\":{:.1},\"cpu_ms_per_mb\":{:.1},\"notify_p50_ms\":{:.1},\
+         \"notify_p99_ms\":{:.1},\"sched_p50_ms\":{:.1},\"sched_p99_ms\":{:.1},\
+         \"peak_rss_kb\":{}}}",
+        profile.name,
+        apps,
+        tasks_per_app,
+        planned.len(),
+        failed,
+        mb,
+        mb / total,
+        if mb > 0.0 { cpu / mb } else { 0.0 },
+        percentile(&notify, 50),
+        percentile(&notify, 99),
+        percentile(&sched, 50),
+        percentile(&sched, 99),
+        peak_rss_kb()
+    );
+
+    for task in planned.iter() {
+        let _ = fs::remove_file(format!("test_files/bench_load_{}", task.index));
+    }
+}
+
+// @tc.name: bench_load
+// @tc.desc: Measure the service under many applications running many tasks
+//           at once
+// @tc.precon: NA
+// @tc.step: 1. Serve downloads and take uploads on a local server, as a
+//              link of the net profile
+//           2. Start the tasks of each application from its own thread,
+//              pausing and resuming some of them
+//           3. Wait for the completion or failure notifications
+//           4. Print one JSON line per number of applications and tasks
+// @tc.expect: Every run reports its throughput, CPU cost, notify and
+//             scheduling latencies and peak RSS
+// @tc.type: PERF
+// @tc.require: issueNumber
+#[test]
+fn bench_load() {
+    test_init();
+    let profile = NetProfile::from_env();
+    for (apps, tasks_per_app) in RUNS {
+        run(profile, apps, tasks_per_app);
+    }
+}
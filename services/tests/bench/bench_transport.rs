@@ -0,0 +1,209 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Downloads of the same workloads with ylong_http_client and the netstack.
+//
+// A local server answers every request with a body of the size of the
+// workload over keep-alive connections. Each client downloads the bodies
+// one after another, reading them whole. The server sends as a link of the
+// net profile named by `REQUEST_NET_PROFILE`, the loopback if unset, and a
+// shaped link runs fewer downloads of a workload, about `SHAPED_RUN` worth
+// of its bandwidth. Every run is printed as one JSON line, e.g.
+// {"bench":"transport","transport":"netstack","profile":"3g","workload":"small",
+//  "body_kb":64,"count":200,"mean_ms":1.9,"p99_ms":4.2,"throughput_mbps":301.7}
+
+use std::io::{Read, Write as _};
+use std::net::{TcpListener, TcpStream};
+use std::sync::mpsc;
+use std::thread;
+use std::time::{Duration, Instant};
+
+use request_utils::test::shaping::{NetProfile, Shaped};
+use ylong_http_client::async_impl::{Body, Client, RequestBuilder};
+
+use super::*;
+
+/// Name, body size and number of downloads of the workloads.
+const WORKLOADS: [(&str, usize, usize); 3] = [
+    ("small", 64 * 1024, 200),
+    ("medium", 1024 * 1024, 50),
+    ("large", 32 * 1024 * 1024, 5),
+];
+
+/// Time the downloads of a workload take at the bandwidth of a shaped link.
+const SHAPED_RUN: Duration = Duration::from_secs(30);
+
+/// Answers every request of a connection with `body`, sent as a link of
+/// `profile`.
+fn serve_connection(stream: TcpStream, body: Arc<Vec<u8>>, profile: NetProfile) {
+    let mut reader = &stream;
+    let mut writer = Shaped::new(&stream, profile);
+    let mut request = Vec::new();
+    let mut buf = [0u8; 4096];
+    loop {
+        while !request.windows(4).any(|w| w == b"\r\n\r\n") {
+            match reader.read(&mut buf) {
+                Ok(0) | Err(_) => return,
+                Ok(n) => request.extend_from_slice(&buf[..n]),
+            }
+        }
+        request.clear();
+        writer.respond();
+        let head = format!(
+            "HTTP/1.1 200 OK\r\nContent-Length: {}\r\nContent-Type: application/octet-stream\r\n\r\n",
+            body.len()
+        );
+        if writer.write_all(head.as_bytes()).is_err() || writer.write_all(&body).is_err() {
+            return;
+        }
+    }
+}
+
+/// Starts a server answering with bodies of `size` bytes as a link of
+/// `profile`, returning its url.
+fn serve(size: usize, profile: NetProfile) -> String {
+    let listener = TcpListener::bind("127.0.0.1:0").unwrap();
+    let addr = listener.local_addr().unwrap();
+    let body = Arc::new(vec![0x5a; size]);
+    thread::spawn(move || {
+        for stream in listener.incoming().flatten() {
+            let body = body.clone();
+            thread::spawn(move || serve_connection(stream, body, profile));
+        }
+    });
+    format!("http://{}/file", addr)
+}
+
+/// Downloads `url` with ylong_http_client, returning the bytes read.
+fn ylong_get(client: &Client, url: &str) -> usize {
+    ylong_runtime::block_on(async {
+        let request = RequestBuilder::new()
+            .method("GET")
+            .url(url)
+            .body(Body::empty())
+            .unwrap();
+        let mut response = client.request(request).await.unwrap();
+        let mut buf = vec![0u8; 64 * 1024];
+        let mut read = 0;
+        loop {
+            match response.data(&mut buf).await.unwrap() {
+                0 => return read,
+                n => read += n,
+            }
+        }
+    })
+}
+
+/// Counts the bytes of a netstack download and reports its end.
+struct Count {
+    read: usize,
+    done: mpsc::Sender<usize>,
+}
+
+impl RequestCallback for Count {
+    fn on_success(&mut self, _response: Response) {
+        let _ = self.done.send(self.read);
+    }
+
+    fn on_fail(&mut self, error: HttpClientError, _info: DownloadInfo) {
+        panic!(
+            "netstack download failed {:?} {}",
+            error.code(),
+            error.msg()
+        );
+    }
+
+    fn on_data_receive(&mut self, data: &[u8], _task: NetstackTask) {
+        self.read += data.len();
+    }
+}
+
+/// Downloads `url` with the netstack, returning the bytes read.
+fn netstack_get(url: &str, index: usize) -> usize {
+    let (tx, rx) = mpsc::channel();
+    let mut request = Request::new();
+    request
+        .url(url)
+        .method("GET")
+        .callback(Count { read: 0, done: tx })
+        .info_mgr(info_mgr())
+        .task_id(TaskId::new(format!("bench_transport_{}", index)));
+    let mut task = request.build().unwrap();
+    assert!(task.start());
+    rx.recv().unwrap()
+}
+
+fn run(transport: &str, profile: NetProfile, workload: &str, size: usize, count: usize) {
+    let count = match profile.bandwidth {
+        0 => count,
+        bandwidth => {
+            let shaped = (bandwidth * SHAPED_RUN.as_secs()) as usize / size;
+            count.min(shaped.max(1))
+        }
+    };
+    let url = serve(size, profile);
+    let client = Client::new();
+    let mut latencies = Vec::with_capacity(count);
+    let start = Instant::now();
+    for i in 0..count {
+        let begin = Instant::now();
+        let read = match transport {
+            "ylong" => ylong_get(&client, &url),
+            _ => netstack_get(&url, i),
+        };
+        assert_eq!(read, size);
+        latencies.push(begin.elapsed().as_secs_f64() * 1000.0);
+    }
+    let total = start.elapsed().as_secs_f64();
+    latencies.sort_by(|a, b| a.partial_cmp(b).unwrap());
+    let mean = latencies.iter().sum::<f64>() / count as f64;
+    println!(
+        "{{\"bench\":\"transport\",\"transport\":\"{}\",\"profile\":\"{}\",\"workload\":\"{}\",\
+         \"body_kb\":{},\"count\":{},\"mean_ms\":{:.1},\"p99_ms\":{:.1},\"throughput_mbps\":{:.1}}}",
+        transport,
+        profile.name,
+        workload,
+        size / 1024,
+        count,
+        mean,
+        latencies[latencies.len() * 99 / 100],
+        (size * count) as f64 * 8.0 / total / 1_000_000.0
+    );
+}
+
+// @tc.name: bench_transport
+// @tc.desc: Compare the downloads of ylong_http_client and the netstack on
+//           the same workloads
+// @tc.precon: A net profile dropping connections is not set
+// @tc.step: 1. Serve bodies of small, medium and large sizes locally, as a
+//              link of the net profile
+//           2. Download each workload with both clients
+//           3. Print one JSON line per client and workload
+// @tc.expect: Every run reads whole bodies and reports its latencies and
+//             throughput
+// @tc.type: PERF
+// @tc.require: issueNumber
+#[test]
+fn bench_transport() {
+    let profile = NetProfile::from_env();
+    // The clients read whole bodies, the task benchmarks retry dropped ones.
+    assert!(
+        profile.disconnect_after.is_none(),
+        "{} drops the connections",
+        profile.name
+    );
+    for (workload, size, count) in WORKLOADS {
+        run("ylong", profile, workload, size, count);
+        run("netstack", profile, workload, size, count);
+    }
+}
@@ -0,0 +1,178 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Notify data sent over the UDS channel from the client handler of the
+// service to the `ResponseMessageReceiver` of the client, both in process.
+//
+// The handler is fed progress notifications at a given rate, for a given
+// number of tasks and size of extras, and sends them through its socket pair
+// to the receiver of `uds_bench_receiver.cpp`, reading on its own thread.
+// The total processed of each notification carries the time it was sent at,
+// so the receiver measures the latency from the event to the listener. Only
+// the latest progress of a task is sent, the progress superseded meanwhile is
+// counted apart. Every run is printed as one JSON line, e.g.
+// {"bench":"uds","flow":"credit_v2","rate":0,"tasks":16,"extras_bytes":256,
+//  "sent":20000,"received":19876,"superseded":124,"msgs_per_s":181023.4,
+//  "p50_us":41.0,"p99_us":212.7,"ack_timeouts":0}
+
+use std::collections::HashMap;
+use std::ffi::c_void;
+use std::os::fd::AsRawFd;
+use std::thread;
+use std::time::{Duration, Instant};
+
+use super::*;
+use crate::config::{Action, Version};
+use crate::task::notify::Progress;
+
+/// Notifications sent by a run.
+const MESSAGES: usize = 20000;
+
+/// Notifications sent by a run in ack mode, which waits for every message.
+const ACK_MESSAGES: usize = 200;
+
+/// Longest time a run waits for the last notifications.
+const DRAIN_TIMEOUT: Duration = Duration::from_secs(30);
+
+/// Flow control of the runs: name, whether the receiver grants credits and
+/// the capabilities it announces.
+const ACK: (&str, bool, u32) = ("ack", false, 0);
+const CREDIT: (&str, bool, u32) = ("credit", true, 0);
+const CREDIT_V2: (&str, bool, u32) = ("credit_v2", true, CAPABILITY_NOTIFY_DATA_V2);
+
+/// Flow control, notifications per second (0 for as fast as possible),
+/// number of tasks and bytes of extras of the runs. Each parameter is swept
+/// on its own around the first run.
+const RUNS: [((&str, bool, u32), u64, u32, usize); 10] = [
+    (CREDIT_V2, 0, 16, 256),
+    (ACK, 0, 16, 256),
+    (CREDIT, 0, 16, 256),
+    (CREDIT_V2, 2000, 16, 256),
+    (CREDIT_V2, 20000, 16, 256),
+    (CREDIT_V2, 0, 1, 256),
+    (CREDIT_V2, 0, 256, 256),
+    (CREDIT_V2, 0, 16, 0),
+    (CREDIT_V2, 0, 16, 2048),
+    (CREDIT_V2, 0, 16, 8192),
+];
+
+extern "C" {
+    fn RequestUdsBenchNow() -> u64;
+    fn RequestUdsBenchStart(fd: i32, credits: bool, capabilities: u32) -> *mut c_void;
+    fn RequestUdsBenchReceived(bench: *mut c_void) -> u64;
+    fn RequestUdsBenchLatencies(bench: *mut c_void, out: *mut u64, capacity: usize) -> usize;
+    fn RequestUdsBenchStop(bench: *mut c_void);
+}
+
+/// Progress of a task sent now, with extras of `extras_bytes` bytes in four
+/// entries.
+fn notify_data(task_id: u32, extras_bytes: usize) -> NotifyData {
+    let mut progress = Progress::new(vec![1024 * 1024]);
+    progress.common_data.total_processed = unsafe { RequestUdsBenchNow() } as usize;
+    progress.processed[0] = task_id as usize;
+    progress.extras = (0..4)
+        .filter(|_| extras_bytes > 0)
+        .map(|i| (format!("x-bench-{}", i), "v".repeat(extras_bytes / 4)))
+        .collect::<HashMap<_, _>>();
+    NotifyData {
+        bundle: "com.example.bench".to_string(),
+        progress,
+        action: Action::Download,
+        version: Version::API10,
+        each_file_status: vec![],
+        task_id,
+        uid: 0,
+    }
+}
+
+fn run(flow: (&str, bool, u32), rate: u64, tasks: u32, extras_bytes: usize) {
+    let (name, credits, capabilities) = flow;
+    let messages = if credits { MESSAGES } else { ACK_MESSAGES };
+    let (tx, client_sock) = Client::constructor(std::process::id() as u64).unwrap();
+    let bench = unsafe { RequestUdsBenchStart(client_sock.as_raw_fd(), credits, capabilities) };
+    assert!(!bench.is_null());
+
+    let superseded_before = metrics::CLIENT_PROGRESS_SUPERSEDED.get();
+    let timeouts_before = metrics::CLIENT_ACK_TIMEOUTS.get();
+    let start = Instant::now();
+    for i in 0..messages {
+        if rate != 0 {
+            let due = start + Duration::from_secs_f64(i as f64 / rate as f64);
+            if let Some(wait) = due.checked_duration_since(Instant::now()) {
+                thread::sleep(wait);
+            }
+        }
+        let data = notify_data(i as u32 % tasks, extras_bytes);
+        tx.send(ClientEvent::SendNotifyData(SubscribeType::Progress, data))
+            .unwrap();
+    }
+
+    let mut received = 0;
+    let mut superseded = 0;
+    while start.elapsed() < DRAIN_TIMEOUT {
+        received = unsafe { RequestUdsBenchReceived(bench) } as usize;
+        superseded = (metrics::CLIENT_PROGRESS_SUPERSEDED.get() - superseded_before) as usize;
+        if received + superseded >= messages {
+            break;
+        }
+        thread::sleep(Duration::from_millis(1));
+    }
+    let total = start.elapsed().as_secs_f64();
+    let timeouts = metrics::CLIENT_ACK_TIMEOUTS.get() - timeouts_before;
+
+    let mut latencies = vec![0u64; received];
+    let count = unsafe { RequestUdsBenchLatencies(bench, latencies.as_mut_ptr(), received) };
+    latencies.truncate(count);
+    latencies.sort_unstable();
+    let percentile = |percent: usize| match latencies.len() {
+        0 => 0.0,
+        len => latencies[(len * percent / 100).min(len - 1)] as f64 / 1000.0,
+    };
+    println!(
+        "{{\"bench\":\"uds\",\"flow\":\"{}\",\"rate\":{},\"tasks\":{},\"extras_bytes\":{},\
+         \"sent\":{},\"received\":{},\"superseded\":{},\"msgs_per_s\":{:.1},\
+         \"p50_us\":{:.1},\"p99_us\":{:.1},\"ack_timeouts\":{}}}",
+        name,
+        rate,
+        tasks,
+        extras_bytes,
+        messages,
+        received,
+        superseded,
+        received as f64 / total,
+        percentile(50),
+        percentile(99),
+        timeouts
+    );
+
+    unsafe { RequestUdsBenchStop(bench) };
+    let _ = tx.send(ClientEvent::Shutdown);
+}
+
+// @tc.name: bench_uds
+// @tc.desc: Measure the notify path from the client handler of the service
+//           to the message receiver of the client
+// @tc.precon: NA
+// @tc.step: 1. Open a client handler and a receiver over its socket pair
+//           2. Send progress notifications at each rate, number of tasks,
+//              size of extras and flow control
+//           3. Print one JSON line per run
+// @tc.expect: Every run reports its message rate, latencies and ack timeouts
+// @tc.type: PERF
+// @tc.require: issueNumber
+#[test]
+fn bench_uds() {
+    for (flow, rate, tasks, extras_bytes) in RUNS {
+        run(flow, rate, tasks, extras_bytes);
+    }
+}
@@ -0,0 +1,79 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use super::*;
+
+const TEST_TID: u32 = 42;
+
+fn client() -> Client {
+    let (_tx, rx) = unbounded_channel();
+    let (server_sock_fd, client_sock_fd) = UnixDatagram::pair().unwrap();
+    Client {
+        pid: 1,
+        message_id: 1,
+        server_sock_fd,
+        client_sock_fd: Arc::new(client_sock_fd),
+        flow_control: FlowControl::Ack,
+        notify_encoder: None,
+        run_count: false,
+        sent: 0,
+        rx,
+    }
+}
+
+// @tc.name: ut_body_pieces
+// @tc.desc: Test the messages carrying the body of an in-memory download
+// @tc.precon: NA
+// @tc.step: 1. Build the messages of a body longer than one message
+// @tc.expect: Each message fits a batch and the pieces hold the whole body
+//             in order with their offsets
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_body_pieces() {
+    let mut client = client();
+    let body = (0..10000u32).map(|i| i as u8).collect::<Vec<_>>();
+    let messages = client.build_body(TEST_TID, &body);
+    assert_eq!(messages.len(), 3);
+    let mut received = Vec::new();
+    for (i, message) in messages.iter().enumerate() {
+        assert!(message.len() <= BATCH_MAX_SIZE);
+        assert_eq!(message[4..8], (i as u32 + 1).to_le_bytes());
+        assert_eq!(message[8..10], (MessageType::Body as u16).to_le_bytes());
+        assert_eq!(message[10..12], (message.len() as u16).to_le_bytes());
+        assert_eq!(message[12..16], TEST_TID.to_le_bytes());
+        assert_eq!(message[16..20], 10000u32.to_le_bytes());
+        assert_eq!(message[20..24], (received.len() as u32).to_le_bytes());
+        received.extend_from_slice(&message[24..]);
+    }
+    assert_eq!(received, body);
+    assert!(!MessageType::Body.batchable());
+}
+
+// @tc.name: ut_body_empty
+// @tc.desc: Test the message carrying an empty body
+// @tc.precon: NA
+// @tc.step: 1. Build the messages of an empty body
+// @tc.expect: One message without bytes of the body is built
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_body_empty() {
+    let mut client = client();
+    let messages = client.build_body(TEST_TID, &[]);
+    assert_eq!(messages.len(), 1);
+    assert_eq!(messages[0].len(), MESSAGE_HEADER_SIZE + BODY_FIELDS_SIZE);
+    assert_eq!(messages[0][16..24], [0; 8]);
+}
@@ -19,7 +19,7 @@ use ylong_runtime::net::UnixDatagram;
 use ylong_runtime::sync::mpsc::{unbounded_channel, UnboundedSender};
 use ylong_runtime::sync::oneshot;
 
-use crate::service::client::{Client, ClientEvent, MessageType};
+use crate::service::client::{credit_grant, Client, ClientEvent, FlowControl, MessageType};
 use crate::task::notify::{NotifyData, SubscribeType, WaitingCause};
 use crate::task::reason::Reason;
 use crate::config::Version;
@@ -46,6 +46,25 @@ mod tests {
         assert_eq!(MessageType::NotifyData as u16, 1);
         assert_eq!(MessageType::Faults as u16, 2);
         assert_eq!(MessageType::Waiting as u16, 3);
+        assert_eq!(MessageType::Batch as u16, 4);
+        assert_eq!(MessageType::NotifyDataV2 as u16, 5);
+    }
+
+    // @tc.name: ut_client_message_type_batchable
+    // @tc.desc: Test which message types can be packed into a batch
+    // @tc.precon: MessageType enum is defined
+    // @tc.step: 1. Check batchable for each variant
+    // @tc.expect: Only NotifyData, Faults and Waiting are batchable
+    // @tc.type: FUNC
+    // @tc.require: issue#ICODTG
+    // @tc.level: Level 0
+    #[test]
+    fn ut_client_message_type_batchable_001() {
+        assert!(!MessageType::HttpResponse.batchable());
+        assert!(MessageType::NotifyData.batchable());
+        assert!(MessageType::Faults.batchable());
+        assert!(MessageType::Waiting.batchable());
+        assert!(!MessageType::Batch.batchable());
     }
 
     // @tc.name: ut_client_event_variants
@@ -115,6 +134,8 @@ mod tests {
             message_id: 1,
             server_sock_fd: server_sock,
             client_sock_fd: Arc::new(client_sock),
+            flow_control: FlowControl::Ack,
+            notify_encoder: None,
             rx: _receiver,
         };
 
@@ -124,6 +145,27 @@ mod tests {
         assert_eq!(client.message_id, 1);
     }
 
+    // @tc.name: ut_client_credit_grant
+    // @tc.desc: Test parsing of credit grants sent back by the client
+    // @tc.precon: NA
+    // @tc.step: 1. Parse a valid grant, a length ack and a grant with bad magic
+    // @tc.expect: Only the valid grant yields credits
+    // @tc.type: FUNC
+    // @tc.require: issue#ICODTG
+    // @tc.level: Level 0
+    #[test]
+    fn ut_client_credit_grant_001() {
+        let mut grant = Vec::new();
+        grant.extend_from_slice(&0x43524454u32.to_le_bytes());
+        grant.extend_from_slice(&32u32.to_le_bytes());
+        assert_eq!(credit_grant(&grant), Some((32, 0)));
+        grant.extend_from_slice(&1u32.to_le_bytes());
+        assert_eq!(credit_grant(&grant), Some((32, 1)));
+        assert_eq!(credit_grant(&64u32.to_le_bytes()), None);
+        grant[0] = 0;
+        assert_eq!(credit_grant(&grant), None);
+    }
+
     // Message format tests
     mod message_format_tests {
         use super::*;
@@ -0,0 +1,102 @@
+// Copyright (C) 2024 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use super::*;
+use crate::config::{Action, Version};
+use crate::task::notify::Progress;
+
+const TEST_PID: u64 = 100;
+const FLUSH_BYTES: usize = 1000;
+
+fn notify_data(task_id: u32, processed: usize) -> NotifyData {
+    let mut progress = Progress::new(vec![10000]);
+    progress.common_data.total_processed = processed;
+    progress.processed[0] = processed;
+    NotifyData {
+        bundle: "com.example.app".to_string(),
+        progress,
+        action: Action::Download,
+        version: Version::API10,
+        each_file_status: vec![],
+        task_id,
+        uid: 0,
+    }
+}
+
+// @tc.name: ut_coalescer_keep_latest
+// @tc.desc: Test that only the latest progress of a task is kept
+// @tc.precon: NA
+// @tc.step: 1. Push several small progress updates of two tasks
+//           2. Drain the coalescer
+// @tc.expect: One notification per task carrying the latest progress
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+// @tc.level: Level 1
+#[test]
+fn ut_coalescer_keep_latest() {
+    let mut coalescer = ProgressCoalescer::new(FLUSH_BYTES);
+    assert!(coalescer.push(TEST_PID, notify_data(1, 10)).is_none());
+    assert!(coalescer.push(TEST_PID, notify_data(1, 20)).is_none());
+    assert!(coalescer.push(TEST_PID, notify_data(2, 30)).is_none());
+    assert!(coalescer.arm());
+    assert!(!coalescer.arm());
+
+    let mut drained = coalescer.drain();
+    drained.sort_by_key(|(_, data)| data.task_id);
+    assert_eq!(drained.len(), 2);
+    assert_eq!(drained[0].1.progress.common_data.total_processed, 20);
+    assert_eq!(drained[1].1.progress.common_data.total_processed, 30);
+    assert!(coalescer.drain().is_empty());
+    assert!(!coalescer.arm());
+}
+
+// @tc.name: ut_coalescer_flush_bytes
+// @tc.desc: Test that progress is forwarded at once past the byte threshold
+// @tc.precon: NA
+// @tc.step: 1. Push progress above the threshold
+//           2. Push progress below the threshold relative to the last one
+// @tc.expect: Only the first one is returned immediately
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+// @tc.level: Level 1
+#[test]
+fn ut_coalescer_flush_bytes() {
+    let mut coalescer = ProgressCoalescer::new(FLUSH_BYTES);
+    assert!(coalescer.push(TEST_PID, notify_data(1, FLUSH_BYTES)).is_some());
+    assert!(coalescer.push(TEST_PID, notify_data(1, FLUSH_BYTES + 1)).is_none());
+    assert!(coalescer
+        .push(TEST_PID, notify_data(1, FLUSH_BYTES * 2))
+        .is_some());
+    assert!(coalescer.drain().is_empty());
+}
+
+// @tc.name: ut_coalescer_take_and_finish
+// @tc.desc: Test taking buffered progress ahead of a terminal notification
+// @tc.precon: NA
+// @tc.step: 1. Push progress, take it, push again and finish the task
+// @tc.expect: Taken progress is returned once and finished tasks are dropped
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+// @tc.level: Level 1
+#[test]
+fn ut_coalescer_take_and_finish() {
+    let mut coalescer = ProgressCoalescer::new(FLUSH_BYTES);
+    coalescer.push(TEST_PID, notify_data(1, 10));
+    assert!(coalescer.take(TEST_PID + 1, 1).is_none());
+    assert!(coalescer.take(TEST_PID, 1).is_some());
+    assert!(coalescer.take(TEST_PID, 1).is_none());
+
+    coalescer.push(TEST_PID, notify_data(1, 20));
+    coalescer.finish(TEST_PID, 1);
+    assert!(coalescer.drain().is_empty());
+}
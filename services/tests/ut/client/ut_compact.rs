@@ -0,0 +1,106 @@
+// Copyright (C) 2024 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use super::*;
+use crate::config::Action;
+use crate::task::notify::Progress;
+
+fn notify_data(task_id: u32, processed: usize) -> NotifyData {
+    let mut progress = Progress::new(vec![1000]);
+    progress.common_data.total_processed = processed;
+    progress.processed[0] = processed;
+    progress
+        .extras
+        .insert("content-type".to_string(), "text/plain".to_string());
+    NotifyData {
+        bundle: "com.example.app".to_string(),
+        progress,
+        action: Action::Download,
+        version: Version::API10,
+        each_file_status: vec![],
+        task_id,
+        uid: 0,
+    }
+}
+
+fn encode(encoder: &mut NotifyEncoder, subscribe_type: SubscribeType, data: NotifyData) -> Vec<u8> {
+    let mut message = Vec::new();
+    let extras = data.progress.extras.len();
+    encoder.encode(&mut message, subscribe_type, data, extras);
+    message
+}
+
+// @tc.name: ut_compact_varint
+// @tc.desc: Test varint and zigzag encoding
+// @tc.precon: NA
+// @tc.step: 1. Encode boundary values
+// @tc.expect: Encodings match LEB128 and zigzag
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+// @tc.level: Level 0
+#[test]
+fn ut_compact_varint() {
+    let mut buf = Vec::new();
+    write_varint(&mut buf, 0);
+    write_varint(&mut buf, 127);
+    write_varint(&mut buf, 128);
+    assert_eq!(buf, vec![0x00, 0x7f, 0x80, 0x01]);
+
+    let mut buf = Vec::new();
+    write_signed(&mut buf, 0);
+    write_signed(&mut buf, -1);
+    write_signed(&mut buf, 1);
+    assert_eq!(buf, vec![0x00, 0x01, 0x02]);
+}
+
+// @tc.name: ut_compact_delta
+// @tc.desc: Test that repeated progress of a task is delta encoded
+// @tc.precon: NA
+// @tc.step: 1. Encode two progress messages of the same task
+// @tc.expect: The second one has no sizes, no absolute values and is shorter
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+// @tc.level: Level 1
+#[test]
+fn ut_compact_delta() {
+    let mut encoder = NotifyEncoder::new();
+    let first = encode(&mut encoder, SubscribeType::Progress, notify_data(1, 100));
+    assert_eq!(first[0], FLAG_SIZES | FLAG_ABSOLUTE);
+    let second = encode(&mut encoder, SubscribeType::Progress, notify_data(1, 200));
+    assert_eq!(second[0], 0);
+    assert!(second.len() < first.len());
+}
+
+// @tc.name: ut_compact_terminal_and_reset
+// @tc.desc: Test state dropping after terminal events and failed sends
+// @tc.precon: NA
+// @tc.step: 1. Encode a Complete notification, then a progress
+//           2. Reset the encoder and encode again
+// @tc.expect: Values are absolute again and the reset flag is sent once
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+// @tc.level: Level 1
+#[test]
+fn ut_compact_terminal_and_reset() {
+    let mut encoder = NotifyEncoder::new();
+    encode(&mut encoder, SubscribeType::Progress, notify_data(1, 100));
+    encode(&mut encoder, SubscribeType::Complete, notify_data(1, 1000));
+    let message = encode(&mut encoder, SubscribeType::Progress, notify_data(1, 0));
+    assert_eq!(message[0], FLAG_SIZES | FLAG_ABSOLUTE);
+
+    encoder.reset();
+    let message = encode(&mut encoder, SubscribeType::Progress, notify_data(1, 0));
+    assert_eq!(message[0], FLAG_SIZES | FLAG_ABSOLUTE | FLAG_RESET);
+    let message = encode(&mut encoder, SubscribeType::Progress, notify_data(1, 0));
+    assert_eq!(message[0], 0);
+}
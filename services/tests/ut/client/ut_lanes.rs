@@ -0,0 +1,82 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use super::*;
+use crate::config::{Action, Version};
+use crate::task::notify::Progress;
+
+fn notify_data(task_id: u32, processed: usize) -> NotifyData {
+    let mut progress = Progress::new(vec![10000]);
+    progress.common_data.total_processed = processed;
+    progress.processed[0] = processed;
+    NotifyData {
+        bundle: "com.example.app".to_string(),
+        progress,
+        action: Action::Download,
+        version: Version::API10,
+        each_file_status: vec![],
+        task_id,
+        uid: 0,
+    }
+}
+
+// @tc.name: ut_lanes_progress_superseded
+// @tc.desc: Test that the progress lane keeps the latest progress of a task
+// @tc.precon: NA
+// @tc.step: 1. Push several progress updates of two tasks
+//           2. Take the progress of one task, then the rest
+// @tc.expect: Each task is taken once with its latest progress
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_lanes_progress_superseded() {
+    let mut lane = ProgressLane::default();
+    lane.push(notify_data(1, 100));
+    lane.push(notify_data(2, 200));
+    lane.push(notify_data(1, 300));
+
+    let first = lane.take(1).unwrap();
+    assert_eq!(first.progress.common_data.total_processed, 300);
+    assert!(lane.take(1).is_none());
+
+    let rest = lane.take_some(8);
+    assert_eq!(rest.len(), 1);
+    assert_eq!(rest[0].task_id, 2);
+    assert!(lane.is_empty());
+}
+
+// @tc.name: ut_lanes_take_some
+// @tc.desc: Test taking the progress lane a part at a time
+// @tc.precon: NA
+// @tc.step: 1. Push the progress of five tasks
+//           2. Take at most two tasks until the lane is empty
+// @tc.expect: Every task is taken once, at most two at a time
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_lanes_take_some() {
+    let mut lane = ProgressLane::default();
+    for task_id in 0..5 {
+        lane.push(notify_data(task_id, 0));
+    }
+    let mut taken = Vec::new();
+    while !lane.is_empty() {
+        let part = lane.take_some(2);
+        assert!(!part.is_empty() && part.len() <= 2);
+        taken.extend(part.into_iter().map(|data| data.task_id));
+    }
+    taken.sort();
+    assert_eq!(taken, vec![0, 1, 2, 3, 4]);
+}
@@ -0,0 +1,181 @@
+// Copyright (C) 2024 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use std::os::fd::AsRawFd;
+
+use super::*;
+
+fn record(processed: u64) -> ProgressRecord {
+    ProgressRecord {
+        state: 0x20,
+        processed,
+        total: 1000,
+        mtime: 1,
+    }
+}
+
+/// Reads the slot of a task from a read-only mapping of a shared table, as
+/// the client does.
+fn read(file: &File, tid: u32) -> Option<ProgressRecord> {
+    let len = size_of::<Header>() + PROGRESS_TABLE_CAPACITY * size_of::<Slot>();
+    let base = unsafe {
+        mmap(
+            ptr::null_mut(),
+            len,
+            PROT_READ,
+            MAP_SHARED,
+            file.as_raw_fd(),
+            0,
+        )
+    };
+    assert_ne!(base as isize, -1);
+    let header = unsafe { &*(base as *const Header) };
+    assert_eq!(header.magic.load(Ordering::Acquire), PROGRESS_TABLE_MAGIC);
+    assert_eq!(header.version.load(Ordering::Relaxed), PROGRESS_TABLE_VERSION);
+    let capacity = header.capacity.load(Ordering::Relaxed) as usize;
+    let slots = unsafe { (base as *const u8).add(size_of::<Header>()) as *const Slot };
+    let mut found = None;
+    for index in 0..capacity {
+        let slot = unsafe { &*slots.add(index) };
+        loop {
+            let seq = slot.seq.load(Ordering::Acquire);
+            if seq & 1 == 1 {
+                continue;
+            }
+            let used = slot.flags.load(Ordering::Relaxed) & SLOT_USED != 0;
+            let slot_tid = slot.tid.load(Ordering::Relaxed);
+            let record = ProgressRecord {
+                state: slot.state.load(Ordering::Relaxed),
+                processed: slot.processed.load(Ordering::Relaxed),
+                total: slot.total.load(Ordering::Relaxed),
+                mtime: slot.mtime.load(Ordering::Relaxed),
+            };
+            fence(Ordering::Acquire);
+            if slot.seq.load(Ordering::Relaxed) != seq {
+                continue;
+            }
+            if used && slot_tid == tid {
+                found = Some(record);
+            }
+            break;
+        }
+    }
+    unsafe { munmap(base, len) };
+    found
+}
+
+// @tc.name: ut_progress_table_update
+// @tc.desc: Test publishing and removing the progress of tasks
+// @tc.precon: NA
+// @tc.step: 1. Update the progress of two tasks, one of them twice
+//           2. Read the table through a shared descriptor
+//           3. Remove a task and read it again
+// @tc.expect: The shared table holds the latest progress of each task and
+//             nothing for a removed task
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+// @tc.level: Level 1
+#[test]
+fn ut_progress_table_update() {
+    let mut table = ProgressTable::new().unwrap();
+    let file = table.share().unwrap();
+    assert!(read(&file, 1).is_none());
+
+    assert!(table.update(1, record(10)));
+    assert!(table.update(2, record(20)));
+    assert!(table.update(1, record(30)));
+    assert_eq!(read(&file, 1), Some(record(30)));
+    assert_eq!(read(&file, 2), Some(record(20)));
+
+    table.remove(1);
+    assert!(read(&file, 1).is_none());
+    assert_eq!(read(&file, 2), Some(record(20)));
+}
+
+// @tc.name: ut_progress_table_full
+// @tc.desc: Test a table running out of slots
+// @tc.precon: NA
+// @tc.step: 1. Fill all the slots of a table
+//           2. Update a new task, then free a slot and update it again
+// @tc.expect: A new task is rejected while the table is full and takes the
+//             freed slot afterwards
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+// @tc.level: Level 1
+#[test]
+fn ut_progress_table_full() {
+    let mut table = ProgressTable::new().unwrap();
+    for tid in 1..=PROGRESS_TABLE_CAPACITY as u32 {
+        assert!(table.update(tid, record(tid as u64)));
+    }
+    let new_tid = PROGRESS_TABLE_CAPACITY as u32 + 1;
+    assert!(!table.update(new_tid, record(0)));
+    assert!(table.update(1, record(100)));
+
+    table.remove(2);
+    assert!(table.update(new_tid, record(200)));
+    let file = table.share().unwrap();
+    assert_eq!(read(&file, new_tid), Some(record(200)));
+    assert!(read(&file, 2).is_none());
+}
+
+// @tc.name: ut_progress_table_sealed
+// @tc.desc: Test that a client cannot resize the table
+// @tc.precon: NA
+// @tc.step: 1. Truncate a shared descriptor of a table
+// @tc.expect: The resize fails
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+// @tc.level: Level 1
+#[test]
+fn ut_progress_table_sealed() {
+    let table = ProgressTable::new().unwrap();
+    let file = table.share().unwrap();
+    assert!(file.set_len(0).is_err());
+    assert!(file.set_len(1 << 20).is_err());
+}
+
+// @tc.name: ut_progress_table_record
+// @tc.desc: Test building the record of a notification
+// @tc.precon: NA
+// @tc.step: 1. Build the records of notifications with known and unknown sizes
+// @tc.expect: The total is the sum of the sizes, or -1 if one is unknown
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+// @tc.level: Level 1
+#[test]
+fn ut_progress_table_record() {
+    use crate::config::{Action, Version};
+    use crate::task::notify::Progress;
+
+    let mut progress = Progress::new(vec![100, 200]);
+    progress.common_data.state = 0x20;
+    progress.common_data.total_processed = 50;
+    let mut notify_data = NotifyData {
+        bundle: "com.example.app".to_string(),
+        progress,
+        action: Action::Download,
+        version: Version::API10,
+        each_file_status: vec![],
+        task_id: 1,
+        uid: 0,
+    };
+    let record = ProgressRecord::from_notify_data(&notify_data);
+    assert_eq!(record.state, 0x20);
+    assert_eq!(record.processed, 50);
+    assert_eq!(record.total, 300);
+    assert!(record.mtime > 0);
+
+    notify_data.progress.sizes[1] = -1;
+    assert_eq!(ProgressRecord::from_notify_data(&notify_data).total, -1);
+}
@@ -34,4 +34,25 @@ fn test_cert_manager() {
         cert_manager.force_update();
     }
     assert!(cert_manager.certificate().is_some());
-}
\ No newline at end of file
+}
+// @tc.name: test_cert_manager_update_unchanged
+// @tc.desc: Test updating certificates that did not change
+// @tc.precon: NA
+// @tc.step: 1. Initialize test environment
+//           2. Create CertManager instance and force two updates
+// @tc.expect: The user certificates are parsed once and the certificates
+//             stay the same
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+#[test]
+fn test_cert_manager_update_unchanged() {
+    test_init();
+    let cert_manager = CertManager::init();
+    cert_manager.force_update();
+    let fingerprint = cert_manager.parsed.lock().unwrap().user_fingerprint;
+    let len = cert_manager.certificate().map(|certs| certs.len());
+    cert_manager.force_update();
+    assert!(fingerprint.is_some());
+    assert_eq!(cert_manager.parsed.lock().unwrap().user_fingerprint, fingerprint);
+    assert_eq!(cert_manager.certificate().map(|certs| certs.len()), len);
+}
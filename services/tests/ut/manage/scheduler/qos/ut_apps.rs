@@ -11,9 +11,12 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-use super::{App, Task};
-use crate::manage::database::RequestDb;
-use crate::task::config::Mode;
+use std::collections::HashSet;
+
+use super::{App, SchedulePolicy, SortedApps, Task, DEADLINE_HORIZON};
+use crate::manage::database::{RequestDb, TaskQosInfo};
+use crate::task::config::{Action, Mode};
+use crate::task::info::State;
 use crate::tests::{lock_database, test_init};
 use crate::utils::get_current_timestamp;
 use crate::utils::task_id_generator::TaskIdGenerator;
@@ -25,6 +28,17 @@ impl Task {
             task_id,
             mode,
             priority,
+            remaining: None,
+            deadline: None,
+            prefetch: false,
+        }
+    }
+
+    fn sized(task_id: u32, remaining: Option<u64>, deadline: Option<u64>) -> Self {
+        Self {
+            remaining,
+            deadline,
+            ..Self::new(task_id, Mode::BackGround, task_id)
         }
     }
 }
@@ -142,33 +156,207 @@ fn ut_task_partial_ord() {
     assert!(task3 < task4);
 }
 
-// @tc.name: ut_database_app_info
-// @tc.desc: Test retrieving app information from database
+// @tc.name: ut_database_all_task_qos_infos
+// @tc.desc: Test restoring the tasks of all apps in one query
 // @tc.precon: NA
 // @tc.step: 1. Initialize test database
-//           2. Insert test tasks with different UIDs
-//           3. Query app information
-//           4. Verify correct UIDs are returned
-// @tc.expect: Database returns correct app information for inserted tasks
+//           2. Insert running tasks of two UIDs and a paused task
+//           3. Query the qos information of all tasks
+//           4. Verify the rows are grouped by UID and skip the paused task
+// @tc.expect: Each running task is returned once with its UID, in UID order
 // @tc.type: FUNC
 // @tc.require: issues#ICN16H
 #[test]
-fn ut_database_app_info() {
+fn ut_database_all_task_qos_infos() {
     test_init();
     let db = RequestDb::get_instance();
     let _lock = lock_database();
     let uid = get_current_timestamp();
 
-    for i in 0..10 {
+    for i in 0..11 {
         db.execute(&format!(
-            "INSERT INTO request_task (task_id, uid, bundle) VALUES ({}, {}, '{}')",
+            "INSERT INTO request_task (task_id, uid, bundle, action, mode, state, reason, priority) VALUES ({}, {}, '{}', {}, {}, {}, 0, 0)",
             TaskIdGenerator::generate(),
             uid + i / 5,
             "test_bundle",
+            Action::Download.repr,
+            Mode::BackGround.repr,
+            if i == 10 { State::Paused.repr } else { State::Running.repr },
         ))
         .unwrap();
     }
-    let v = db.get_app_infos();
-    assert_eq!(v.iter().filter(|a| **a == uid).count(), 1);
-    assert_eq!(v.iter().filter(|a| **a == uid + 1).count(), 1);
-}
\ No newline at end of file
+    let v = db
+        .get_all_task_qos_infos()
+        .into_iter()
+        .map(|info| info.uid)
+        .filter(|a| *a >= uid && *a <= uid + 2)
+        .collect::<Vec<_>>();
+    assert_eq!(v, [vec![uid; 5], vec![uid + 1; 5]].concat());
+}
+
+fn qos_info(task_id: u32, action: Action) -> TaskQosInfo {
+    TaskQosInfo {
+        task_id,
+        action: action as u8,
+        mode: Mode::BackGround as u8,
+        state: 0,
+        priority: 0,
+        remaining: -1,
+        deadline: 0,
+        uid: 0,
+        prefetch: false,
+    }
+}
+
+// @tc.name: ut_sorted_apps_changed
+// @tc.desc: Test the change tracking of the tasks of each action
+// @tc.precon: NA
+// @tc.step: 1. Create SortedApps and take the initial changes
+//           2. Insert, change and remove tasks of one action
+//           3. Sort the apps with an unchanged and a changed foreground
+// @tc.expect: Only the action of a changed task and a moved app change
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+#[test]
+fn ut_sorted_apps_changed() {
+    let mut apps = SortedApps::from_raw(vec![]);
+    assert!(apps.take_changed(Action::Download));
+    assert!(apps.take_changed(Action::Upload));
+    assert!(!apps.take_changed(Action::Download));
+
+    apps.insert_task(1, qos_info(1, Action::Download));
+    apps.insert_task(2, qos_info(2, Action::Download));
+    assert!(apps.take_changed(Action::Download));
+    assert!(!apps.take_changed(Action::Upload));
+
+    assert!(apps.task_set_mode(2, 2, Mode::FrontEnd));
+    assert!(!apps.task_set_mode(3, 2, Mode::FrontEnd));
+    assert!(apps.take_changed(Action::Download));
+    assert!(!apps.take_changed(Action::Upload));
+
+    let mut foreground = HashSet::new();
+    apps.sort(&foreground, 0);
+    assert!(!apps.take_changed(Action::Download));
+    foreground.insert(1);
+    apps.sort(&foreground, 0);
+    assert_eq!(apps[0].uid, 2);
+    assert!(apps.take_changed(Action::Download));
+    assert!(apps.take_changed(Action::Upload));
+
+    assert!(apps.remove_task(1, 1));
+    assert!(!apps.remove_task(1, 1));
+    assert!(apps.take_changed(Action::Download));
+    assert!(!apps.take_changed(Action::Upload));
+}
+
+// @tc.name: ut_sorted_apps_replace_tasks
+// @tc.desc: Test changing the tasks of one application in place
+// @tc.precon: NA
+// @tc.step: 1. Remove the frontend tasks of an application
+//           2. Replace the tasks of an existing and of a new application
+// @tc.expect: Only the tasks of the application change, a new application is
+//             added and the tasks count as changed
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+#[test]
+fn ut_sorted_apps_replace_tasks() {
+    let mut apps = SortedApps::from_raw(vec![App::from_raw(
+        1,
+        vec![
+            Task::new(1, Mode::FrontEnd, 0),
+            Task::new(2, Mode::BackGround, 0),
+        ],
+    )]);
+    apps.take_changed(Action::Download);
+    apps.take_changed(Action::Upload);
+
+    assert!(apps.remove_mode_tasks(1, Mode::FrontEnd));
+    assert!(!apps.remove_mode_tasks(1, Mode::FrontEnd));
+    assert!(!apps.remove_mode_tasks(2, Mode::FrontEnd));
+    assert_eq!(apps[0].tasks.len(), 1);
+    assert_eq!(apps[0].tasks[0].task_id, 2);
+    assert!(apps.take_changed(Action::Download));
+
+    apps.replace_app_tasks(1, vec![Task::new(3, Mode::FrontEnd, 0)]);
+    assert_eq!(apps[0].tasks[0].task_id, 3);
+    apps.replace_app_tasks(2, vec![Task::new(4, Mode::BackGround, 0)]);
+    assert_eq!(apps.len(), 2);
+    assert_eq!(apps[1].uid, 2);
+    assert!(apps.take_changed(Action::Download));
+    assert!(apps.take_changed(Action::Upload));
+
+    apps.replace_app_tasks(3, vec![]);
+    assert_eq!(apps.len(), 2);
+    assert!(!apps.take_changed(Action::Download));
+}
+
+// @tc.name: ut_app_policy
+// @tc.desc: Test the task order of the schedule policies and deadlines
+// @tc.precon: NA
+// @tc.step: 1. Insert tasks of different sizes into an App by priority
+//           2. Switch the App to shortest-remaining-bytes-first
+//           3. Insert tasks nearing and far from their deadline
+// @tc.expect: Tasks near their deadline go first, then the policy orders them
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+#[test]
+fn ut_app_policy() {
+    let now = get_current_timestamp();
+    let mut app = App::new(1);
+    app.insert(Task::sized(1, Some(300), None));
+    app.insert(Task::sized(2, None, None));
+    app.insert(Task::sized(3, Some(100), None));
+    let order = |app: &App| app.tasks.iter().map(|t| t.task_id).collect::<Vec<_>>();
+    assert_eq!(order(&app), vec![1, 2, 3]);
+
+    assert!(app.set_policy(SchedulePolicy::ShortestFirst));
+    assert_eq!(order(&app), vec![3, 1, 2]);
+    assert!(!app.set_policy(SchedulePolicy::ShortestFirst));
+
+    app.insert(Task::sized(4, Some(1000), Some(now + DEADLINE_HORIZON * 2)));
+    app.insert(Task::sized(5, Some(1000), Some(now + 1000)));
+    assert_eq!(order(&app), vec![5, 3, 1, 4, 2]);
+
+    // Once within the horizon the far deadline goes first as well
+    assert!(app.resort_tasks(now + DEADLINE_HORIZON + 1));
+    assert_eq!(order(&app), vec![5, 4, 3, 1, 2]);
+
+    // Foreground tasks still go before all background ones
+    app.insert(Task::new(6, Mode::FrontEnd, 100));
+    assert_eq!(app.tasks[0].task_id, 6);
+}
+
+// @tc.name: ut_sorted_apps_policy
+// @tc.desc: Test selecting the policy of an app in SortedApps
+// @tc.precon: NA
+// @tc.step: 1. Insert tasks of two sizes into an app
+//           2. Select shortest-remaining-bytes-first for the app
+//           3. Check the next time a task nears its deadline
+// @tc.expect: The tasks are reordered and marked changed, the boost is known
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+#[test]
+fn ut_sorted_apps_policy() {
+    let now = get_current_timestamp();
+    let mut apps = SortedApps::from_raw(vec![]);
+    let mut large = qos_info(1, Action::Download);
+    large.remaining = 1000;
+    let mut small = qos_info(2, Action::Download);
+    small.remaining = 10;
+    small.priority = 1;
+    small.deadline = now + DEADLINE_HORIZON * 2;
+    apps.insert_task(1, large);
+    apps.insert_task(1, small);
+    assert_eq!(apps[0].tasks[0].task_id, 1);
+    apps.take_changed(Action::Download);
+
+    apps.set_policy(1, SchedulePolicy::ShortestFirst);
+    assert_eq!(apps[0].tasks[0].task_id, 2);
+    assert!(apps.take_changed(Action::Download));
+    apps.set_policy(1, SchedulePolicy::ShortestFirst);
+    assert!(!apps.take_changed(Action::Download));
+
+    let boost = apps.next_boost(now).unwrap();
+    assert_eq!(boost, now + DEADLINE_HORIZON);
+    assert!(apps.next_boost(boost).is_none());
+}
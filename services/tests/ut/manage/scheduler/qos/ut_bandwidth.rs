@@ -0,0 +1,59 @@
+// Copyright (C) 2023 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use super::*;
+
+// @tc.name: ut_bandwidth_sample
+// @tc.desc: Test the bandwidth estimated from the running tasks
+// @tc.precon: NA
+// @tc.step: 1. Sample two tasks, then replace one of them
+//           2. Sample the tasks at a lower throughput
+// @tc.expect: Only tasks running for a whole interval count and the
+//             estimate falls gradually
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+#[test]
+fn ut_bandwidth_sample() {
+    let mut estimator = BandwidthEstimator::new();
+    estimator.sample(0, [((1, 1), 0), ((1, 2), 0)]);
+    assert_eq!(estimator.bandwidth(), None);
+
+    estimator.sample(2000, [((1, 1), 2000), ((1, 2), 4000)]);
+    assert_eq!(estimator.bandwidth(), Some(3000));
+
+    // Task 3 started in the interval and task 2 left
+    estimator.sample(4000, [((1, 1), 8000), ((1, 3), 100000)]);
+    assert_eq!(estimator.bandwidth(), Some(3000));
+
+    estimator.sample(6000, [((1, 1), 8000), ((1, 3), 101600)]);
+    assert_eq!(estimator.bandwidth(), Some(3000 - (3000 - 800) / 8));
+}
+
+// @tc.name: ut_bandwidth_idle
+// @tc.desc: Test the estimate while no task is running
+// @tc.precon: NA
+// @tc.step: 1. Sample a task, then no task, then the task again
+// @tc.expect: The estimate is kept while no task runs
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+#[test]
+fn ut_bandwidth_idle() {
+    let mut estimator = BandwidthEstimator::new();
+    estimator.sample(0, [((1, 1), 0)]);
+    estimator.sample(1000, [((1, 1), 5000)]);
+    assert_eq!(estimator.bandwidth(), Some(5000));
+
+    estimator.sample(3000, []);
+    estimator.sample(5000, [((1, 1), 0)]);
+    assert_eq!(estimator.bandwidth(), Some(5000));
+}
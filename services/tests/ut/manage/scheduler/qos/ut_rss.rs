@@ -68,4 +68,41 @@ fn ut_rss_capacity() {
         RssCapacity::new(7),
         RssCapacity(4, 4, 2, QosLevel::High, QosLevel::Low, QosLevel::Low,)
     ));
-}
\ No newline at end of file
+}
+// @tc.name: ut_rss_with_bandwidth
+// @tc.desc: Test sizing the zones of a level for the bandwidth of the link
+// @tc.precon: NA
+// @tc.step: 1. Size level 0 and level 6 for a weak, a medium and a fast link
+// @tc.expect: Zones follow the link within the tasks and speeds of the level
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+#[test]
+fn ut_rss_with_bandwidth() {
+    const WEAK: u64 = 256 * 1024;
+    const MEDIUM: u64 = 5 * 1024 * 1024 / 2;
+    const FAST: u64 = 125 * 1000 * 1000;
+
+    let level0 = RssCapacity::LEVEL0;
+    assert_eq!(
+        level0.with_bandwidth(WEAK),
+        RssCapacity(1, 0, 7, QosLevel::High, QosLevel::Middle, QosLevel::Middle)
+    );
+    assert_eq!(
+        level0.with_bandwidth(MEDIUM),
+        RssCapacity(2, 30, 8, QosLevel::High, QosLevel::Middle, QosLevel::Middle)
+    );
+    assert_eq!(
+        level0.with_bandwidth(FAST),
+        RssCapacity(48, 0, 0, QosLevel::High, QosLevel::Middle, QosLevel::Middle)
+    );
+
+    let level6 = RssCapacity::LEVEL6;
+    assert_eq!(
+        level6.with_bandwidth(0),
+        RssCapacity(1, 1, 2, QosLevel::High, QosLevel::Low, QosLevel::Low)
+    );
+    assert_eq!(
+        level6.with_bandwidth(FAST),
+        RssCapacity(14, 0, 0, QosLevel::High, QosLevel::Low, QosLevel::Low)
+    );
+}
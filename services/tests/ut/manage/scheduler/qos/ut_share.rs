@@ -0,0 +1,60 @@
+// Copyright (C) 2024 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use super::*;
+
+// @tc.name: ut_share_deficit_round_robin
+// @tc.desc: Test the sharing of slots across queues by weight
+// @tc.precon: NA
+// @tc.step: 1. Share slots between a bulk queue and a small queue
+//           2. Share slots between queues of weight 2 and 1
+//           3. Share more slots than there are items
+// @tc.expect: Slots follow the weights, and the unused share of a queue
+//             that runs empty goes to the others
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+#[test]
+fn ut_share_deficit_round_robin() {
+    let bulk = (1, vec![1, 2, 3, 4, 5, 6]);
+    let small = (1, vec![11, 12]);
+    assert_eq!(
+        deficit_round_robin(vec![bulk.clone(), small.clone()], 4),
+        vec![1, 11, 2, 12]
+    );
+    assert_eq!(
+        deficit_round_robin(vec![bulk.clone(), small], 6),
+        vec![1, 11, 2, 12, 3, 4]
+    );
+
+    let system = (2, vec![21, 22, 23, 24]);
+    assert_eq!(
+        deficit_round_robin(vec![bulk.clone(), system.clone()], 6),
+        vec![1, 21, 22, 2, 23, 24]
+    );
+
+    let taken = deficit_round_robin(vec![bulk, system], 100);
+    assert_eq!(taken.len(), 10);
+}
+
+// @tc.name: ut_share_app_weight
+// @tc.desc: Test the default weights of applications
+// @tc.precon: NA
+// @tc.step: 1. Get the weights of a system and a third-party application
+// @tc.expect: A system application weighs more than a third-party one
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+#[test]
+fn ut_share_app_weight() {
+    assert!(app_weight(true) > app_weight(false));
+    assert!(app_weight(false) > 0);
+}
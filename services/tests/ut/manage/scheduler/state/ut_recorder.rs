@@ -0,0 +1,59 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use super::*;
+use crate::manage::network::NetworkInfo;
+
+fn online(network_type: NetworkType, is_metered: bool) -> NetworkState {
+    NetworkState::Online(NetworkInfo {
+        network_type,
+        is_metered,
+        is_roaming: false,
+    })
+}
+
+// @tc.name: ut_recorder_prefetch_window
+// @tc.desc: Test the prefetch window opened by charging, idleness and network
+// @tc.precon: NA
+// @tc.step: 1. Update the device state on an unmetered Wi-Fi network
+//           2. Repeat an update that leaves the window unchanged
+//           3. Switch to a metered and a cellular network
+// @tc.expect: The window is only open while the device is charging and idle
+//             on an unmetered Wi-Fi network, and only its changes reschedule
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_recorder_prefetch_window() {
+    let mut record = StateRecord::new();
+    record.network = online(NetworkType::Wifi, false);
+    assert!(record.update_device(DeviceChange::Charging(true)).is_none());
+    assert!(!record.prefetch_window());
+    assert!(record.update_device(DeviceChange::Idle(true)).is_some());
+    assert!(record.prefetch_window());
+    assert!(record.update_device(DeviceChange::Idle(true)).is_none());
+
+    record.network = online(NetworkType::Wifi, true);
+    assert!(!record.prefetch_window());
+    record.network = online(NetworkType::Cellular, false);
+    assert!(!record.prefetch_window());
+    record.network = NetworkState::Offline;
+    assert!(!record.prefetch_window());
+
+    record.network = online(NetworkType::Wifi, false);
+    assert!(record.prefetch_window());
+    assert!(record
+        .update_device(DeviceChange::Charging(false))
+        .is_some());
+    assert!(!record.prefetch_window());
+}
@@ -409,6 +409,43 @@ fn ut_app_state_available() {
     assert_eq!(reason, RUNNING_TASK_MEET_LIMITS);
 }
 
+// @tc.name: ut_app_state_waiting_uids
+// @tc.desc: Test querying the applications whose tasks wait for them
+// @tc.precon: NA
+// @tc.step: 1. Insert a task waiting for its application and one waiting for
+//              the network only
+//           2. Query the waiting applications, then make the first one
+//              available and query again
+// @tc.expect: Only the application of the task waiting for it is found, until
+//             it is available
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+#[test]
+fn ut_app_state_waiting_uids() {
+    test_init();
+    let _lock = lock_database();
+    let db = RequestDb::get_instance();
+    let uid = get_current_timestamp();
+    let other = uid + 1;
+
+    db.execute(&format!(
+        "INSERT OR REPLACE INTO request_task (task_id, uid, state, reason) VALUES ({}, {uid}, {WAITING}, {NETWORK_APP})",
+        TaskIdGenerator::generate()
+    )).unwrap();
+    db.execute(&format!(
+        "INSERT OR REPLACE INTO request_task (task_id, uid, state, reason) VALUES ({}, {other}, {WAITING}, {NETWORK_OFFLINE})",
+        TaskIdGenerator::generate()
+    )).unwrap();
+
+    let uids: Vec<u64> = db.query_integer(&app_state_waiting_uids());
+    assert!(uids.contains(&uid));
+    assert!(!uids.contains(&other));
+
+    db.execute(&app_state_available(uid)).unwrap();
+    let uids: Vec<u64> = db.query_integer(&app_state_waiting_uids());
+    assert!(!uids.contains(&uid));
+}
+
 // @tc.name: ut_account_unavailable
 // @tc.desc: Test task state handling when account is unavailable
 // @tc.precon: NA
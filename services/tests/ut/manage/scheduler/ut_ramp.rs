@@ -0,0 +1,69 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use super::*;
+
+// @tc.name: ut_ramp_steps
+// @tc.desc: Test the pace of the tasks started after a restore
+// @tc.precon: NA
+// @tc.step: 1. Admit tasks of a background application at the restore
+//           2. Finish the reschedule and admit again at the next step
+//           3. Finish a reschedule that held back no task
+// @tc.expect: A step of tasks is admitted per interval, then the ramp closes
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_ramp_steps() {
+    let mut ramp = RestoreRamp::new(1000);
+    for _ in 0..DEFAULT_RAMP_STEP {
+        assert!(ramp.admit(1, 1000));
+    }
+    assert!(!ramp.admit(1, 1000));
+    let delay = ramp.finish(1000).unwrap();
+    assert!(delay >= DEFAULT_RAMP_INTERVAL);
+    assert!(delay <= DEFAULT_RAMP_INTERVAL * 3 / 2);
+
+    assert!(!ramp.admit(1, 1000 + delay - 1));
+    assert!(ramp.admit(1, 1000 + delay));
+    assert!(ramp.finish(1000 + delay).is_some());
+
+    assert!(ramp.is_open());
+    assert_eq!(ramp.finish(3000), None);
+    assert!(!ramp.is_open());
+    for _ in 0..DEFAULT_RAMP_STEP * 2 {
+        assert!(ramp.admit(1, 3000));
+    }
+}
+
+// @tc.name: ut_ramp_foreground
+// @tc.desc: Test the tasks of a foreground application during the ramp
+// @tc.precon: NA
+// @tc.step: 1. Spend the step on a background application
+//           2. Admit tasks of a foreground application
+// @tc.expect: The foreground tasks are admitted without spending the step
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_ramp_foreground() {
+    let mut ramp = RestoreRamp::new(0);
+    ramp.set_foreground(&HashSet::from([2]));
+    for _ in 0..DEFAULT_RAMP_STEP {
+        assert!(ramp.admit(1, 0));
+    }
+    assert!(!ramp.admit(1, 0));
+    for _ in 0..DEFAULT_RAMP_STEP * 2 {
+        assert!(ramp.admit(2, 0));
+    }
+}
@@ -0,0 +1,105 @@
+// Copyright (C) 2024 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use super::*;
+use crate::manage::scheduler::qos::QosDirection;
+
+fn decision(time: u64, trigger: Trigger, elapsed: u64) -> Decision {
+    Decision {
+        time,
+        trigger,
+        tiers: Tiers::default(),
+        moves: Moves::default(),
+        elapsed,
+    }
+}
+
+// @tc.name: ut_trace_latency_bucket
+// @tc.desc: Test the histogram bucket of a latency
+// @tc.precon: NA
+// @tc.step: 1. Get the buckets of latencies around powers of two
+// @tc.expect: Bucket `i` holds latencies below `2^i`, the last one all the
+//             slower ones
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+// @tc.level: Level 1
+#[test]
+fn ut_trace_latency_bucket() {
+    assert_eq!(latency_bucket(0), 0);
+    assert_eq!(latency_bucket(1), 1);
+    assert_eq!(latency_bucket(3), 2);
+    assert_eq!(latency_bucket(4), 3);
+    assert_eq!(latency_bucket(u64::MAX), LATENCY_BUCKETS - 1);
+}
+
+// @tc.name: ut_trace_record
+// @tc.desc: Test recording decisions beyond the trace capacity
+// @tc.precon: NA
+// @tc.step: 1. Record more decisions than the trace holds
+//           2. Check the decisions kept and the histograms
+// @tc.expect: The oldest decisions are dropped, the histograms count all
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+// @tc.level: Level 1
+#[test]
+fn ut_trace_record() {
+    let mut trace = DecisionTrace::new();
+    for time in 0..TRACE_CAPACITY as u64 + 10 {
+        trace.record(decision(time, Trigger::Start, 3));
+    }
+    trace.record(decision(1000, Trigger::Deadline, 100));
+
+    assert_eq!(trace.decisions().count(), TRACE_CAPACITY);
+    assert_eq!(trace.decisions().next().unwrap().time, 11);
+    assert_eq!(trace.decisions().last().unwrap().time, 1000);
+    assert_eq!(
+        trace.histogram(Trigger::Start)[2],
+        TRACE_CAPACITY as u64 + 10
+    );
+    assert_eq!(trace.histogram(Trigger::Deadline)[7], 1);
+    assert!(trace.histogram(Trigger::Pause).iter().all(|n| *n == 0));
+
+    let dump = trace.dump();
+    assert!(dump.starts_with(&format!("decision num: {}\n", TRACE_CAPACITY)));
+    assert!(dump.contains("deadline     128:1"));
+    assert!(!dump.contains("pause"));
+}
+
+// @tc.name: ut_trace_tiers
+// @tc.desc: Test counting the tasks of each speed tier
+// @tc.precon: NA
+// @tc.step: 1. Count the tiers of download and upload directions
+// @tc.expect: The tasks of both actions are counted by their level
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+// @tc.level: Level 1
+#[test]
+fn ut_trace_tiers() {
+    let mut changes = QosChanges::new();
+    assert_eq!(Tiers::of(&changes), Tiers::default());
+
+    changes.download = Some(vec![
+        QosDirection::new(1, 1, QosLevel::High),
+        QosDirection::new(1, 2, QosLevel::Middle),
+        QosDirection::new(1, 3, QosLevel::Low),
+    ]);
+    changes.upload = Some(vec![QosDirection::new(2, 4, QosLevel::High)]);
+    assert_eq!(
+        Tiers::of(&changes),
+        Tiers {
+            high: 2,
+            middle: 1,
+            low: 1,
+        }
+    );
+}
@@ -124,4 +124,260 @@ fn ut_database_app_task_qos_info() {
     assert_eq!(info.mode, Mode::FrontEnd.repr);
     assert_eq!(info.state, State::Completed.repr);
     assert_eq!(info.priority, priority);
-}
\ No newline at end of file
+}
+// @tc.name: ut_database_query_tasks_uid
+// @tc.desc: Test querying the owners of several tasks at once
+// @tc.precon: NA
+// @tc.step: 1. Insert two tasks with different uids
+//           2. Query the uids of both tasks and of a missing task
+// @tc.expect: Both uids are returned and the missing task is absent
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+#[test]
+fn ut_database_query_tasks_uid() {
+    test_init();
+    let _lock = lock_database();
+    let db = RequestDb::get_instance();
+    let first = TaskIdGenerator::generate();
+    let second = TaskIdGenerator::generate();
+    let missing = TaskIdGenerator::generate();
+    db.execute(&format!(
+        "INSERT INTO request_task (task_id, uid) VALUES ({}, {}), ({}, {})",
+        first, 20020041, second, 100
+    ))
+    .unwrap();
+
+    let uids = db.query_tasks_uid(&[first, second, missing]);
+    assert_eq!(uids.get(&first), Some(&20020041));
+    assert_eq!(uids.get(&second), Some(&100));
+    assert!(!uids.contains_key(&missing));
+    assert!(db.query_tasks_uid(&[]).is_empty());
+}
+
+// @tc.name: ut_database_query_tasks_progress
+// @tc.desc: Test looking up the progress of several tasks with one query
+// @tc.precon: NA
+// @tc.step: 1. Insert two tasks, one with a progress row
+//           2. Query their progress along with a missing task
+// @tc.expect: The existing tasks are returned with their state and processed
+//             bytes, the missing task is skipped
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+#[test]
+fn ut_database_query_tasks_progress() {
+    test_init();
+    let _lock = lock_database();
+    let db = RequestDb::get_instance();
+    let first = TaskIdGenerator::generate();
+    let second = TaskIdGenerator::generate();
+    let missing = TaskIdGenerator::generate();
+    db.execute(&format!(
+        "INSERT INTO request_task (task_id, state, total_processed) VALUES ({}, {}, 10), ({}, {}, 30)",
+        first,
+        State::Running.repr,
+        second,
+        State::Completed.repr
+    ))
+    .unwrap();
+    db.execute(&format!(
+        "INSERT INTO request_task_progress (task_id, total_processed) VALUES ({}, 20)",
+        first
+    ))
+    .unwrap();
+
+    let mut rows = db.query_tasks_progress(&[first, second, missing]);
+    rows.sort();
+    let mut expected = vec![
+        (first, State::Running.repr, 20),
+        (second, State::Completed.repr, 30),
+    ];
+    expected.sort();
+    assert_eq!(rows, expected);
+    assert!(db.query_tasks_progress(&[]).is_empty());
+}
+
+// @tc.name: ut_database_progress_table
+// @tc.desc: Test that task progress is kept in the request_task_progress table
+// @tc.precon: NA
+// @tc.step: 1. Insert a task with a legacy total_processed value
+//           2. Query total_processed before and after writing its progress row
+//           3. Delete the task
+// @tc.expect: The progress row takes precedence and is deleted with the task
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+#[test]
+fn ut_database_progress_table() {
+    test_init();
+    let _lock = lock_database();
+    let db = RequestDb::get_instance();
+    let task_id = TaskIdGenerator::generate();
+    db.execute(&format!(
+        "INSERT INTO request_task (task_id, total_processed) VALUES ({}, {})",
+        task_id, 10
+    ))
+    .unwrap();
+    assert_eq!(db.query_task_total_processed(task_id), Some(10));
+
+    db.execute(&format!(
+        "INSERT INTO request_task_progress (task_id, total_processed) VALUES ({}, {})",
+        task_id, 20
+    ))
+    .unwrap();
+    assert_eq!(db.query_task_total_processed(task_id), Some(20));
+
+    db.execute(&format!("DELETE FROM request_task WHERE task_id = {}", task_id))
+        .unwrap();
+    let rows = db.query_integer::<u32>(&format!(
+        "SELECT task_id FROM request_task_progress WHERE task_id = {}",
+        task_id
+    ));
+    assert!(rows.is_empty());
+}
+
+fn query_plan(sql: &str) -> String {
+    use rdb::{OpenConfig, RdbStore, SecurityLevel};
+
+    // Opens a second connection to the test store to read the query plan rows.
+    let mut config = OpenConfig::new("/data/test/request.db");
+    config
+        .security_level(SecurityLevel::S1)
+        .encrypt_status(false)
+        .bundle_name("Test")
+        .version(crate::database::DB_VERSION);
+    let store = RdbStore::open(config).unwrap();
+    store
+        .query::<(i32, i32, i32, String)>(&format!("EXPLAIN QUERY PLAN {}", sql), ())
+        .unwrap()
+        .map(|(_, _, _, detail)| detail)
+        .collect::<Vec<_>>()
+        .join("; ")
+}
+
+// @tc.name: ut_database_task_indexes
+// @tc.desc: Test that scheduler and search queries are served by the task indexes
+// @tc.precon: NA
+// @tc.step: 1. Open the request database
+//           2. Insert historic tasks of several apps
+//           3. Explain the qos reload, invalid records and system search queries
+// @tc.expect: Every query plan uses its index instead of scanning request_task
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+#[test]
+fn ut_database_task_indexes() {
+    test_init();
+    let _lock = lock_database();
+    let db = RequestDb::get_instance();
+    for i in 0..100u64 {
+        db.execute(&format!(
+            "INSERT INTO request_task (task_id, uid, bundle, ctime, state, reason) VALUES ({}, {}, 'bundle_{}', {}, {}, 0)",
+            TaskIdGenerator::generate(),
+            i % 10,
+            i % 10,
+            i,
+            State::Completed.repr,
+        ))
+        .unwrap();
+    }
+    let _ = db.execute("ANALYZE");
+
+    let plan = query_plan(&format!(
+        "SELECT task_id, action, mode, state, priority FROM request_task WHERE uid = 1 AND ((state = {} AND reason = 0) OR state = {} OR state = {})",
+        State::Waiting.repr,
+        State::Running.repr,
+        State::Retrying.repr,
+    ));
+    assert!(plan.contains("task_qos_index"), "qos reload plan: {}", plan);
+    assert!(!plan.contains("SCAN"), "qos reload plan: {}", plan);
+
+    let plan = query_plan(&format!(
+        "SELECT task_id FROM request_task WHERE state = {} AND reason = 0",
+        State::Waiting.repr,
+    ));
+    assert!(plan.contains("task_state_index"), "invalid records plan: {}", plan);
+
+    let plan = query_plan(&format!(
+        "SELECT task_id FROM request_task WHERE bundle = 'bundle_1' AND ctime BETWEEN 0 AND {} AND state = {}",
+        get_current_timestamp(),
+        State::Completed.repr,
+    ));
+    assert!(plan.contains("task_bundle_index"), "system search plan: {}", plan);
+}
+
+// @tc.name: ut_database_query_rows_in_chunks
+// @tc.desc: Test that queries return every row when rows are fetched in chunks
+// @tc.precon: NA
+// @tc.step: 1. Insert exactly two chunks of running tasks for one uid
+//           2. Query the task ids and the qos infos of the uid
+//           3. Insert one more task and query again
+// @tc.expect: All inserted tasks are returned on chunk boundaries and past them
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+#[test]
+fn ut_database_query_rows_in_chunks() {
+    test_init();
+    let _lock = lock_database();
+    let db = RequestDb::get_instance();
+    let uid = get_current_timestamp();
+    let insert = |count: usize| {
+        for _ in 0..count {
+            db.execute(&format!(
+                "INSERT INTO request_task (task_id, uid, action, mode, state, reason, priority) VALUES ({}, {}, {}, {}, {}, 0, 0)",
+                TaskIdGenerator::generate(),
+                uid,
+                Action::Download.repr,
+                Mode::BackGround.repr,
+                State::Running.repr,
+            ))
+            .unwrap();
+        }
+    };
+    let sql = format!("SELECT task_id FROM request_task WHERE uid = {}", uid);
+
+    insert(2 * 128);
+    assert_eq!(db.query_integer::<u32>(&sql).len(), 2 * 128);
+    assert_eq!(db.get_app_task_qos_infos(uid).len(), 2 * 128);
+
+    insert(1);
+    assert_eq!(db.query_integer::<u32>(&sql).len(), 2 * 128 + 1);
+    assert_eq!(db.get_app_task_qos_infos(uid).len(), 2 * 128 + 1);
+}
+
+// @tc.name: ut_database_task_meta_cache
+// @tc.desc: Test the read-through cache of immutable task attributes
+// @tc.precon: NA
+// @tc.step: 1. Insert a task and query its uid, token id and action
+//           2. Delete the task row and query it again
+//           3. Forget the task and query it again
+// @tc.expect: Attributes are served from the cache until the task is forgotten
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+#[test]
+fn ut_database_task_meta_cache() {
+    test_init();
+    let _lock = lock_database();
+    let db = RequestDb::get_instance();
+    let task_id = TaskIdGenerator::generate();
+    db.execute(&format!(
+        "INSERT INTO request_task (task_id, uid, token_id, action) VALUES ({}, {}, {}, {})",
+        task_id,
+        20020041,
+        537000000,
+        Action::Upload.repr,
+    ))
+    .unwrap();
+
+    assert!(db.contains_task(task_id));
+    assert_eq!(db.query_task_uid(task_id), Some(20020041));
+    assert_eq!(db.query_task_token_id(task_id), Ok(537000000));
+    assert_eq!(db.query_task_action(task_id), Some(Action::Upload));
+
+    db.execute(&format!("DELETE FROM request_task WHERE task_id = {}", task_id))
+        .unwrap();
+    assert_eq!(db.query_task_uid(task_id), Some(20020041));
+    assert_eq!(db.query_tasks_uid(&[task_id]).get(&task_id), Some(&20020041));
+
+    db.forget_task(task_id);
+    assert!(!db.contains_task(task_id));
+    assert_eq!(db.query_task_uid(task_id), None);
+    assert!(db.query_tasks_uid(&[task_id]).is_empty());
+}
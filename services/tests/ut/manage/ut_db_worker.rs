@@ -0,0 +1,43 @@
+// Copyright (C) 2024 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use std::sync::Arc;
+
+use super::*;
+
+// @tc.name: ut_db_worker_run_in_order
+// @tc.desc: Test that queued jobs run in submission order off the caller
+// @tc.precon: NA
+// @tc.step: 1. Post several jobs appending to a shared list
+//           2. Await a job queued after them
+// @tc.expect: The awaited job observes every posted job in order and runs on
+//             the worker thread
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+// @tc.level: Level 1
+#[test]
+fn ut_db_worker_run_in_order() {
+    let worker = DbWorker::new("UtDbWorker");
+    let list = Arc::new(Mutex::new(vec![]));
+    for i in 0..10 {
+        let list = list.clone();
+        worker.post(move || list.lock().unwrap().push(i));
+    }
+
+    let caller = thread::current().id();
+    let seen = list.clone();
+    let rx = worker.run(move || (seen.lock().unwrap().clone(), thread::current().id()));
+    let (order, id) = ylong_runtime::block_on(rx).unwrap();
+    assert_eq!(order, (0..10).collect::<Vec<_>>());
+    assert_ne!(id, caller);
+}
@@ -0,0 +1,53 @@
+// Copyright (C) 2024 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use std::thread;
+
+use super::*;
+
+// @tc.name: ut_environment_update
+// @tc.desc: Test publishing changes of the environment
+// @tc.precon: NA
+// @tc.step: 1. Read a snapshot, then publish an unchanged environment
+//           2. Publish a new proxy and read snapshots on this and another
+//              thread
+// @tc.expect: Only a change is published, with a higher version, it is seen
+//             by all threads and the old snapshot is left as it was
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+// @tc.level: Level 1
+#[test]
+fn ut_environment_update() {
+    let old = snapshot();
+    update(|_| false);
+    assert!(Arc::ptr_eq(&old, &snapshot()) || snapshot().version > old.version);
+
+    let proxy = SystemProxy {
+        host: "ut_environment_update".to_string(),
+        port: "8080".to_string(),
+        exlist: String::new(),
+    };
+    let expected = proxy.clone();
+    update(move |env| {
+        env.proxy = proxy;
+        true
+    });
+    let new = snapshot();
+    assert!(new.version > old.version);
+    assert_ne!(old.proxy.host, "ut_environment_update");
+    assert_eq!(new.proxy, expected);
+
+    let version = new.version;
+    let seen = thread::spawn(move || snapshot().version).join().unwrap();
+    assert!(seen >= version);
+}
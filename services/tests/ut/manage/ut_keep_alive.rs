@@ -0,0 +1,83 @@
+// Copyright (C) 2024 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use super::*;
+use crate::tests::{lock_database, test_init};
+use crate::utils::get_current_timestamp;
+use crate::utils::task_id_generator::TaskIdGenerator;
+
+const MINUTE: u64 = 60 * 1000;
+
+// @tc.name: ut_keep_alive_next_arrival
+// @tc.desc: Test the expected time of the next task of a user
+// @tc.precon: NA
+// @tc.step: 1. Estimate with a single task
+//           2. Estimate with regular gaps and one outlier
+//           3. Estimate with gaps above the maximum keep-alive
+// @tc.expect: Only regular gaps within the maximum are waited for, by their
+//             median plus a quarter
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+// @tc.level: Level 1
+#[test]
+fn ut_keep_alive_next_arrival() {
+    assert_eq!(next_arrival(&[]), None);
+    assert_eq!(next_arrival(&[100 * MINUTE]), None);
+
+    let arrivals = [
+        100 * MINUTE,
+        96 * MINUTE,
+        92 * MINUTE,
+        60 * MINUTE,
+        56 * MINUTE,
+    ];
+    assert_eq!(next_arrival(&arrivals), Some(105 * MINUTE));
+
+    let arrivals = [100 * MINUTE, 80 * MINUTE, 60 * MINUTE];
+    assert_eq!(next_arrival(&arrivals), None);
+}
+
+// @tc.name: ut_keep_alive_until
+// @tc.desc: Test the keep-alive of the service from the stored tasks
+// @tc.precon: NA
+// @tc.step: 1. Insert tasks of a user created every two minutes
+//           2. Query the keep-alive right after and long after the last task
+// @tc.expect: The service is kept alive until the next task is overdue
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+// @tc.level: Level 1
+#[test]
+fn ut_keep_alive_until() {
+    test_init();
+    let _lock = lock_database();
+    let db = RequestDb::get_instance();
+    let now = get_current_timestamp();
+    // A user id far above the ones of the other tests.
+    let uid = 9999 * USER_UID_RANGE;
+    for i in 0..4 {
+        db.execute(&format!(
+            "INSERT INTO request_task (task_id, uid, ctime) VALUES ({}, {}, {})",
+            TaskIdGenerator::generate(),
+            uid,
+            now - i * 2 * MINUTE,
+        ))
+        .unwrap();
+    }
+
+    let until = keep_alive_until(now).unwrap();
+    assert!(until >= now + 2 * MINUTE);
+    assert_eq!(keep_alive_until(now + MAX_KEEP_ALIVE), None);
+
+    db.execute(&format!("DELETE FROM request_task WHERE uid = {}", uid))
+        .unwrap();
+}
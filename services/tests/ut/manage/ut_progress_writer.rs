@@ -0,0 +1,76 @@
+// Copyright (C) 2024 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use super::*;
+use crate::task::notify::Progress;
+
+fn update_info(processed: usize) -> UpdateInfo {
+    let mut progress = Progress::new(vec![10000]);
+    progress.common_data.total_processed = processed;
+    progress.processed[0] = processed;
+    UpdateInfo {
+        mtime: 0,
+        reason: 0,
+        tries: 0,
+        mime_type: String::new(),
+        progress,
+    }
+}
+
+// @tc.name: ut_progress_writer_keep_latest
+// @tc.desc: Test that only the latest update of a task is buffered
+// @tc.precon: NA
+// @tc.step: 1. Push several updates of two tasks
+//           2. Drain the writer
+// @tc.expect: One update per task carrying the latest progress, and only the
+//             first push asks for a write to be scheduled
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+// @tc.level: Level 1
+#[test]
+fn ut_progress_writer_keep_latest() {
+    let writer = ProgressWriter::new();
+    assert!(writer.push(1, update_info(10)));
+    assert!(!writer.push(1, update_info(20)));
+    assert!(!writer.push(2, update_info(30)));
+
+    let mut drained = writer.drain();
+    drained.sort_by_key(|(task_id, _)| *task_id);
+    assert_eq!(drained.len(), 2);
+    assert_eq!(drained[0].1.progress.common_data.total_processed, 20);
+    assert_eq!(drained[1].1.progress.common_data.total_processed, 30);
+    assert!(writer.drain().is_empty());
+    assert!(writer.push(1, update_info(40)));
+}
+
+// @tc.name: ut_progress_writer_take
+// @tc.desc: Test taking the buffered update of a single task
+// @tc.precon: NA
+// @tc.step: 1. Push updates of two tasks
+//           2. Take the update of the first task twice
+// @tc.expect: The first take returns the update, the second returns None and
+//             the other task stays buffered
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+// @tc.level: Level 1
+#[test]
+fn ut_progress_writer_take() {
+    let writer = ProgressWriter::new();
+    writer.push(1, update_info(10));
+    writer.push(2, update_info(20));
+
+    let taken = writer.take(1).unwrap();
+    assert_eq!(taken.progress.common_data.total_processed, 10);
+    assert!(writer.take(1).is_none());
+    assert_eq!(writer.drain().len(), 1);
+}
@@ -39,6 +39,7 @@ fn ut_search_user() {
         state: State::Completed.repr,
         action: Action::Any.repr,
         mode: Mode::Any.repr,
+        keyword: String::new(),
     };
     let res = db.search_task(filter, uid);
     assert_eq!(res, vec![]);
@@ -49,6 +50,7 @@ fn ut_search_user() {
         state: State::Any.repr,
         action: Action::Download.repr,
         mode: Mode::Any.repr,
+        keyword: String::new(),
     };
     let res = db.search_task(filter, uid);
     assert_eq!(res, vec![]);
@@ -59,6 +61,7 @@ fn ut_search_user() {
         state: State::Any.repr,
         action: Action::Any.repr,
         mode: Mode::FrontEnd.repr,
+        keyword: String::new(),
     };
     let res = db.search_task(filter, uid);
     assert_eq!(res, vec![]);
@@ -69,6 +72,7 @@ fn ut_search_user() {
         state: State::Removed.repr,
         action: Action::Upload.repr,
         mode: Mode::BackGround.repr,
+        keyword: String::new(),
     };
     let res = db.search_task(filter, uid);
     assert_eq!(res, vec![task_id as u32]);
@@ -79,6 +83,7 @@ fn ut_search_user() {
         state: State::Any.repr,
         action: Action::Any.repr,
         mode: Mode::Any.repr,
+        keyword: String::new(),
     };
     let res = db.search_task(filter, uid);
     assert_eq!(res, vec![task_id as u32]);
@@ -89,6 +94,7 @@ fn ut_search_user() {
         state: State::Any.repr,
         action: Action::Upload.repr,
         mode: Mode::BackGround.repr,
+        keyword: String::new(),
     };
     let res = db.search_task(filter, uid);
     assert_eq!(res, vec![task_id as u32]);
@@ -117,6 +123,7 @@ fn ut_search_system() {
         state: State::Completed.repr,
         action: Action::Any.repr,
         mode: Mode::Any.repr,
+        keyword: String::new(),
     };
     let res = db.system_search_task(filter, bundle_name.to_string());
     assert_eq!(res, vec![]);
@@ -127,6 +134,7 @@ fn ut_search_system() {
         state: State::Any.repr,
         action: Action::Any.repr,
         mode: Mode::Any.repr,
+        keyword: String::new(),
     };
     let res = db.system_search_task(filter, bundle_name.to_string());
     assert_eq!(res, vec![task_id as u32]);
@@ -137,7 +145,155 @@ fn ut_search_system() {
         state: State::Any.repr,
         action: Action::Download.repr,
         mode: Mode::BackGround.repr,
+        keyword: String::new(),
     };
     let res = db.system_search_task(filter, "*".to_string());
     assert_eq!(res, vec![task_id as u32]);
-}
\ No newline at end of file
+}
+// @tc.name: ut_search_page
+// @tc.desc: Test searching the tasks of a user page by page
+// @tc.precon: NA
+// @tc.step: 1. Insert tasks of a user, two of them created at the same time
+//           2. Search them two at a time following the page tokens
+//           3. Parse page tokens that are not valid
+// @tc.expect: Pages hold every task once, newest first, the last page has an
+//             empty token and bad tokens are rejected
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+// @tc.level: Level 1
+#[test]
+fn ut_search_page() {
+    test_init();
+    let _lock = lock_database();
+    let db = RequestDb::get_instance();
+    let uid = get_current_timestamp();
+    let now = get_current_timestamp();
+    let ctimes = [now - 40, now - 30, now - 30, now - 20, now - 10];
+    let mut expected = vec![];
+    for ctime in ctimes {
+        let task_id = TaskIdGenerator::generate();
+        db.execute(&format!(
+            "INSERT INTO request_task (task_id, uid, state, ctime, action, mode) VALUES ({}, {}, {}, {}, {}, {})",
+            task_id,
+            uid,
+            State::Completed.repr,
+            ctime,
+            Action::Download.repr,
+            Mode::BackGround.repr
+        ))
+        .unwrap();
+        expected.push((ctime, task_id));
+    }
+    expected.sort_by(|a, b| b.cmp(a));
+    let expected = expected
+        .into_iter()
+        .map(|(_, task_id)| task_id as u32)
+        .collect::<Vec<_>>();
+
+    let filter = || TaskFilter {
+        before: now as i64,
+        after: now as i64 - 200,
+        state: State::Any.repr,
+        action: Action::Any.repr,
+        mode: Mode::Any.repr,
+        keyword: String::new(),
+    };
+    let mut found = vec![];
+    let mut cursor = String::new();
+    loop {
+        let (ids, next) = search_page(filter(), SearchMethod::User(uid), 2, &cursor).unwrap();
+        assert!(ids.len() <= 2);
+        found.extend(ids);
+        if next.is_empty() {
+            break;
+        }
+        cursor = next;
+    }
+    assert_eq!(found, expected);
+
+    assert!(search_page(filter(), SearchMethod::User(uid), 2, "abc").is_none());
+    assert!(search_page(filter(), SearchMethod::User(uid), 2, "1.x").is_none());
+}
+
+// @tc.name: ut_search_keyword
+// @tc.desc: Test searching the tasks of a user by keyword
+// @tc.precon: NA
+// @tc.step: 1. Insert tasks of a user with different titles, descriptions and
+//              urls
+//           2. Search them by keywords of different lengths
+//           3. Change the title of a task and search again
+// @tc.expect: Only the tasks holding the keyword are found, in any case,
+//             wildcards in the keyword match themselves only
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+// @tc.level: Level 1
+#[test]
+fn ut_search_keyword() {
+    test_init();
+    let _lock = lock_database();
+    let db = RequestDb::get_instance();
+    let uid = get_current_timestamp();
+    let now = get_current_timestamp();
+    let tasks = [
+        ("Holiday photos", "", "https://example.com/album.zip"),
+        (
+            "Report",
+            "Quarterly 100% sales",
+            "https://example.com/report.pdf",
+        ),
+        ("Music", "", "https://cdn.example.org/song_1.mp3"),
+    ];
+    let mut task_ids = vec![];
+    for (title, description, url) in tasks {
+        let task_id = TaskIdGenerator::generate();
+        db.execute(&format!(
+            "INSERT INTO request_task (task_id, uid, state, ctime, action, mode, title, description, url) VALUES ({}, {}, {}, {}, {}, {}, '{}', '{}', '{}')",
+            task_id,
+            uid,
+            State::Completed.repr,
+            now,
+            Action::Download.repr,
+            Mode::BackGround.repr,
+            title,
+            description,
+            url
+        ))
+        .unwrap();
+        task_ids.push(task_id as u32);
+    }
+    let search = |keyword: &str| {
+        let filter = TaskFilter {
+            before: now as i64,
+            after: now as i64 - 200,
+            state: State::Any.repr,
+            action: Action::Any.repr,
+            mode: Mode::Any.repr,
+            keyword: keyword.to_string(),
+        };
+        let mut res = db.search_task(filter, uid);
+        res.sort();
+        res
+    };
+    let sorted = |mut ids: Vec<u32>| {
+        ids.sort();
+        ids
+    };
+
+    assert_eq!(search(""), sorted(task_ids.clone()));
+    assert_eq!(search("holiday"), vec![task_ids[0]]);
+    assert_eq!(search("QUARTERLY"), vec![task_ids[1]]);
+    assert_eq!(search("example.com"), sorted(task_ids[..2].to_vec()));
+    assert_eq!(search("mp"), vec![task_ids[2]]);
+    assert_eq!(search("0%"), vec![task_ids[1]]);
+    assert_eq!(search("g_1"), vec![task_ids[2]]);
+    assert_eq!(search("\"zip"), vec![]);
+    assert_eq!(search("missing"), vec![]);
+
+    db.execute(&format!(
+        "UPDATE request_task SET title = 'Vacation photos' WHERE task_id = {}",
+        task_ids[0]
+    ))
+    .unwrap();
+    assert_eq!(search("holiday"), vec![]);
+    assert_eq!(search("vacation"), vec![task_ids[0]]);
+}
@@ -0,0 +1,173 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use std::io::{Seek, SeekFrom};
+use std::sync::atomic::{AtomicUsize, Ordering};
+
+use super::*;
+
+const URL: &str = "https://cdn.example.com/font.ttf";
+
+fn cache_dir(name: &str) -> PathBuf {
+    let dir = std::env::temp_dir().join(format!("ut_shared_cache_{}", name));
+    let _ = fs::remove_dir_all(&dir);
+    dir
+}
+
+fn body_file(body: &[u8]) -> File {
+    static COUNT: AtomicUsize = AtomicUsize::new(0);
+    let count = COUNT.fetch_add(1, Ordering::Relaxed);
+    let path = std::env::temp_dir().join(format!("ut_shared_cache_body_{}", count));
+    let mut file = File::options()
+        .read(true)
+        .write(true)
+        .create(true)
+        .truncate(true)
+        .open(path)
+        .unwrap();
+    file.write_all(body).unwrap();
+    file.seek(SeekFrom::Start(0)).unwrap();
+    file
+}
+
+fn read(file: Option<File>) -> Option<Vec<u8>> {
+    let mut body = Vec::new();
+    file?.read_to_end(&mut body).unwrap();
+    Some(body)
+}
+
+// @tc.name: ut_shared_cache_confirm
+// @tc.desc: Test that an entry is served to other applications once confirmed
+// @tc.precon: NA
+// @tc.step: 1. Publish a body from one application
+//           2. Open it from the same and from another application
+//           3. Publish the same body from a second application
+//           4. Open it from a third application
+// @tc.expect: Only the publisher is served until a second application
+//             published the same body, then every application is served
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_shared_cache_confirm() {
+    let cache = SharedCache::new(cache_dir("confirm"));
+    assert!(cache.open(1, URL).is_none());
+    cache.publish(1, URL, body_file(b"font")).unwrap();
+    assert_eq!(read(cache.open(1, URL)), Some(b"font".to_vec()));
+    assert!(cache.open(2, URL).is_none());
+
+    cache.publish(2, URL, body_file(b"font")).unwrap();
+    assert_eq!(read(cache.open(3, URL)), Some(b"font".to_vec()));
+}
+
+// @tc.name: ut_shared_cache_replace
+// @tc.desc: Test publishing a different body for a cached URL
+// @tc.precon: NA
+// @tc.step: 1. Confirm an entry by two applications
+//           2. Publish another body for the same URL
+// @tc.expect: The new body replaces the entry, which needs confirming again,
+//             and the file of the old body is deleted
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_shared_cache_replace() {
+    let dir = cache_dir("replace");
+    let cache = SharedCache::new(dir.clone());
+    cache.publish(1, URL, body_file(b"old")).unwrap();
+    cache.publish(2, URL, body_file(b"old")).unwrap();
+    cache.publish(3, URL, body_file(b"new!")).unwrap();
+    assert!(cache.open(1, URL).is_none());
+    assert_eq!(read(cache.open(3, URL)), Some(b"new!".to_vec()));
+
+    let mut sha256 = Sha256::new();
+    sha256.update(b"old");
+    assert!(!dir.join(hex(&sha256.finish())).exists());
+}
+
+// @tc.name: ut_shared_cache_dedup
+// @tc.desc: Test that the same body under two URLs is stored once
+// @tc.precon: NA
+// @tc.step: 1. Publish the same body for two URLs
+//           2. Replace the body of the first URL
+// @tc.expect: Both URLs share one file, which stays while the second URL
+//             refers to it
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_shared_cache_dedup() {
+    let cache = SharedCache::new(cache_dir("dedup"));
+    let other = "https://mirror.example.com/font.ttf";
+    cache.publish(1, URL, body_file(b"font")).unwrap();
+    cache.publish(1, other, body_file(b"font")).unwrap();
+    {
+        let guard = cache.entries.lock().unwrap();
+        assert_eq!(total(guard.as_ref().unwrap()), 4);
+    }
+    cache.publish(1, URL, body_file(b"other")).unwrap();
+    assert_eq!(read(cache.open(1, other)), Some(b"font".to_vec()));
+}
+
+// @tc.name: ut_shared_cache_limits
+// @tc.desc: Test the entry size limit and the quota of an application
+// @tc.precon: NA
+// @tc.step: 1. Publish a body larger than `ENTRY_MAX_SIZE`
+//           2. Publish bodies of one application beyond its quota
+// @tc.expect: The large body is rejected, the oldest entries of the
+//             application are evicted to keep it within its quota
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_shared_cache_limits() {
+    let cache = SharedCache::new(cache_dir("limits"));
+    let large = vec![0u8; ENTRY_MAX_SIZE as usize + 1];
+    assert_eq!(
+        cache.publish(1, URL, body_file(&large)),
+        Err(ErrorCode::ParameterCheck)
+    );
+
+    let count = APP_QUOTA / ENTRY_MAX_SIZE;
+    for i in 0..=count {
+        let mut body = vec![0u8; ENTRY_MAX_SIZE as usize];
+        body[0] = i as u8;
+        cache
+            .publish(1, &format!("{}?{}", URL, i), body_file(&body))
+            .unwrap();
+    }
+    assert!(cache.open(1, &format!("{}?0", URL)).is_none());
+    assert!(cache.open(1, &format!("{}?{}", URL, count)).is_some());
+    let guard = cache.entries.lock().unwrap();
+    assert_eq!(owned(guard.as_ref().unwrap(), 1), APP_QUOTA);
+}
+
+// @tc.name: ut_shared_cache_index
+// @tc.desc: Test that the entries survive a restart of the service
+// @tc.precon: NA
+// @tc.step: 1. Publish and confirm an entry
+//           2. Load the cache again from its directory
+// @tc.expect: The entry is served as before the restart
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_shared_cache_index() {
+    let dir = cache_dir("index");
+    let cache = SharedCache::new(dir.clone());
+    cache.publish(1, URL, body_file(b"font")).unwrap();
+    cache.publish(2, URL, body_file(b"font")).unwrap();
+
+    let cache = SharedCache::new(dir);
+    assert_eq!(read(cache.open(3, URL)), Some(b"font".to_vec()));
+}
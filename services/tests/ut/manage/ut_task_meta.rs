@@ -0,0 +1,72 @@
+// Copyright (C) 2024 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use super::*;
+
+fn meta(uid: u64) -> TaskMeta {
+    TaskMeta {
+        uid,
+        token_id: uid + 1,
+        action: Action::Download,
+    }
+}
+
+// @tc.name: ut_task_meta_evict_oldest
+// @tc.desc: Test that the cache stays bounded by evicting the oldest tasks
+// @tc.precon: NA
+// @tc.step: 1. Insert more tasks than the capacity
+//           2. Look up the first and the last inserted tasks
+// @tc.expect: The oldest tasks are evicted and the newest ones are cached
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+// @tc.level: Level 1
+#[test]
+fn ut_task_meta_evict_oldest() {
+    let cache = TaskMetaCache::new(2);
+    cache.insert(1, meta(10));
+    cache.insert(2, meta(20));
+    cache.insert(3, meta(30));
+    assert_eq!(cache.get(1), None);
+    assert_eq!(cache.get(2), Some(meta(20)));
+    assert_eq!(cache.get(3), Some(meta(30)));
+
+    cache.remove(2);
+    cache.insert(4, meta(40));
+    assert_eq!(cache.get(3), Some(meta(30)));
+    assert_eq!(cache.get(4), Some(meta(40)));
+}
+
+// @tc.name: ut_task_meta_invalidate
+// @tc.desc: Test forgetting cached tasks after their rows were deleted
+// @tc.precon: NA
+// @tc.step: 1. Insert tasks of two uids
+//           2. Remove the tasks of one uid, then clear the cache
+// @tc.expect: Only the matching tasks are forgotten, then all of them
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+// @tc.level: Level 1
+#[test]
+fn ut_task_meta_invalidate() {
+    let cache = TaskMetaCache::new(TASK_META_CAPACITY);
+    cache.insert(1, meta(10));
+    cache.insert(2, meta(10));
+    cache.insert(3, meta(20));
+
+    cache.remove_if(|meta| meta.uid == 10);
+    assert_eq!(cache.get(1), None);
+    assert_eq!(cache.get(2), None);
+    assert_eq!(cache.get(3), Some(meta(20)));
+
+    cache.clear();
+    assert_eq!(cache.get(3), None);
+}
@@ -469,3 +469,67 @@ fn ut_notify_database_want_agent() {
     assert_eq!(customized.text.unwrap(), "new_text");
     assert!(customized.want_agent.is_none());
 }
+
+// @tc.name: ut_notify_database_mirror
+// @tc.desc: Test that the in-memory mirror matches the tables
+// @tc.precon: NA
+// @tc.step: 1. Create a NotificationDb instance
+//           2. Update the settings of a task and its group
+//           3. Load the settings from the tables again and compare them
+//              with the mirror
+//           4. Clear the task and group info
+// @tc.expect: The mirror holds the settings in the tables, and forgets them
+//             when they are cleared
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+#[test]
+fn ut_notify_database_mirror() {
+    let db = NotificationDb::new();
+    let task_id = fast_random() as u32;
+    let group_id = fast_random() as u32;
+    let config = NotificationConfig::new(task_id, None, None, None, false, 0b01);
+    db.disable_task_notification(task_id);
+    db.update_task_customized_notification(&config);
+    db.update_task_group(task_id, group_id);
+    db.update_group_config(group_id, true, 0, false, 0b10);
+    db.disable_attach_group(group_id);
+
+    let loaded = db.load().unwrap();
+    let group = |mirror: &Mirror| {
+        mirror.groups.get(&group_id).map(|group| {
+            (
+                group.gauge,
+                group.attach_able,
+                group.display,
+                group.visibility,
+            )
+        })
+    };
+    let mirror = db.mirror().unwrap();
+    assert_eq!(mirror.task_display.get(&task_id), Some(&false));
+    assert_eq!(
+        mirror.task_display.get(&task_id),
+        loaded.task_display.get(&task_id)
+    );
+    assert_eq!(
+        mirror.task_group.get(&task_id),
+        loaded.task_group.get(&task_id)
+    );
+    assert_eq!(
+        mirror.task_visibility.get(&task_id),
+        loaded.task_visibility.get(&task_id)
+    );
+    assert_eq!(group(&mirror), Some((true, false, false, 0b10)));
+    assert_eq!(group(&mirror), group(&loaded));
+    drop(mirror);
+    assert!(!db.check_task_notification_available(&task_id));
+    assert!(db.is_progress_visible_from_group(group_id));
+
+    db.clear_group_info(group_id);
+    db.clear_task_info(task_id);
+    let mirror = db.mirror().unwrap();
+    assert!(!mirror.task_display.contains_key(&task_id));
+    assert!(!mirror.task_group.contains_key(&task_id));
+    assert!(!mirror.task_visibility.contains_key(&task_id));
+    assert!(group(&mirror).is_none());
+}
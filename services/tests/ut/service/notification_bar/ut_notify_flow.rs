@@ -69,6 +69,36 @@ fn ut_notify_flow_group() {
     assert_eq!(group_progress.total(), 100);
 }
 
+// @tc.name: ut_notify_flow_group_remove
+// @tc.desc: Test group progress when tasks restart or leave the group
+// @tc.precon: NA
+// @tc.step: 1. Create a GroupProgress instance with a running and a
+//              completed task
+//           2. Lower the progress of the running task
+//           3. Remove both tasks as unfinished
+// @tc.expect: The processed bytes follow the lowered progress, only the
+//             running task is removed along with its bytes
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+#[test]
+fn ut_notify_flow_group_remove() {
+    let mut group_progress = GroupProgress::new();
+    group_progress.update_task_state(1, State::Running);
+    group_progress.update_task_progress(1, 100);
+    group_progress.update_task_state(2, State::Completed);
+    group_progress.update_task_progress(2, 200);
+
+    group_progress.update_task_progress(1, 40);
+    assert_eq!(group_progress.processed(), 240);
+
+    group_progress.remove_unfinished_task(1);
+    group_progress.remove_unfinished_task(2);
+    assert_eq!(group_progress.processed(), 200);
+    assert_eq!(group_progress.total(), 1);
+    assert_eq!(group_progress.successful(), 1);
+    assert!(group_progress.is_finish());
+}
+
 // @tc.name: ut_notify_flow_task_progress
 // @tc.desc: Test task progress notification generation
 // @tc.precon: NA
@@ -328,3 +358,50 @@ fn ut_group_visibility_completion() {
     let content = flow.publish_completed_notify(&info);
     assert!(content.is_none());
 }
+
+// @tc.name: ut_notify_flow_progress_changed
+// @tc.desc: Test that task progress is published only when it looks different
+// @tc.precon: NA
+// @tc.step: 1. Create a NotifyFlow instance with a task showing its progress
+//           2. Publish progress within the same whole percentage, then a new
+//              percentage
+//           3. Publish processed sizes of a task whose total is unknown
+// @tc.expect: Only progress changing the percentage or the shown size is
+//             published
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+#[test]
+fn ut_notify_flow_progress_changed() {
+    let (_, rx) = mpsc::unbounded_channel();
+    let db = Arc::new(NotificationDb::new());
+    let mut flow = NotifyFlow::new(rx, db.clone());
+    let task_id = fast_random() as u32;
+    let uid = fast_random();
+
+    let config = NotificationConfig::new(task_id, None, None, None, false, 0b10);
+    db.update_task_customized_notification(&config);
+
+    let mut progress = ProgressNotify {
+        action: Action::Download,
+        task_id,
+        uid,
+        processed: 100,
+        total: Some(10000),
+        multi_upload: None,
+        file_name: "test".to_string(),
+        version: Version::API10,
+    };
+    assert!(flow.publish_progress_notification(progress.clone()).is_some());
+    progress.processed = 150;
+    assert!(flow.publish_progress_notification(progress.clone()).is_none());
+    progress.processed = 200;
+    assert!(flow.publish_progress_notification(progress.clone()).is_some());
+
+    progress.total = None;
+    progress.processed = 1024 * 1024;
+    assert!(flow.publish_progress_notification(progress.clone()).is_some());
+    progress.processed += 1;
+    assert!(flow.publish_progress_notification(progress.clone()).is_none());
+    progress.processed = 2 * 1024 * 1024;
+    assert!(flow.publish_progress_notification(progress).is_some());
+}
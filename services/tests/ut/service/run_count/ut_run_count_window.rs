@@ -0,0 +1,44 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use super::*;
+
+// @tc.name: ut_run_count_window
+// @tc.desc: Test coalescing changes of the run count
+// @tc.precon: NA
+// @tc.step: 1. Change the run count outside of a window
+//           2. Change it several times within the window, then close it
+//           3. Change it back and forth within a window, then close it
+// @tc.expect: The first change is sent at once, changes within a window only
+//             when it closes and only if the count differs from the one sent
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+// @tc.level: Level 1
+#[test]
+fn ut_run_count_window() {
+    let mut window = RunCountWindow::new();
+    assert!(!window.change(0));
+    assert!(window.change(1));
+
+    assert!(!window.change(2));
+    assert!(!window.change(3));
+    assert!(window.close());
+    assert_eq!(window.count, 3);
+
+    assert!(!window.change(4));
+    assert!(!window.change(3));
+    assert!(!window.close());
+    assert!(!window.close());
+
+    assert!(window.change(5));
+}
@@ -0,0 +1,73 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use std::cell::Cell;
+
+use super::*;
+
+// @tc.name: ut_permission_cache_reuse
+// @tc.desc: Test that a verdict is reused within its time to live
+// @tc.precon: NA
+// @tc.step: 1. Check a permission of a token twice within the TTL
+//           2. Check another permission and another token
+//           3. Check the first permission again after the TTL
+// @tc.expect: The service is asked once per token and permission until the
+//             verdict expires
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_permission_cache_reuse() {
+    let cache = PermissionCache::new();
+    let asked = Cell::new(0);
+    let verify = |granted: bool| {
+        asked.set(asked.get() + 1);
+        granted
+    };
+    let now = Instant::now();
+    assert!(cache.check(1, INTERNET_PERMISSION, now, || verify(true)));
+    assert!(cache.check(1, INTERNET_PERMISSION, now, || verify(false)));
+    assert_eq!(asked.get(), 1);
+
+    assert!(!cache.check(1, MANAGER_DOWNLOAD, now, || verify(false)));
+    assert!(!cache.check(2, INTERNET_PERMISSION, now, || verify(false)));
+    assert_eq!(asked.get(), 3);
+
+    let later = now + PERMISSION_CACHE_TTL;
+    assert!(!cache.check(1, INTERNET_PERMISSION, later, || verify(false)));
+    assert_eq!(asked.get(), 4);
+}
+
+// @tc.name: ut_permission_cache_clear
+// @tc.desc: Test invalidating and bounding the cached verdicts
+// @tc.precon: NA
+// @tc.step: 1. Cache a verdict and clear the cache
+//           2. Cache more verdicts than `PERMISSION_CACHE_CAPACITY`
+// @tc.expect: The service is asked again after a clear, and the cache never
+//             holds more than its capacity
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_permission_cache_clear() {
+    let cache = PermissionCache::new();
+    let now = Instant::now();
+    assert!(cache.check(1, INTERNET_PERMISSION, now, || true));
+    cache.clear();
+    assert!(!cache.check(1, INTERNET_PERMISSION, now, || false));
+
+    for token_id in 0..=PERMISSION_CACHE_CAPACITY as u64 {
+        cache.check(token_id, INTERNET_PERMISSION, now, || true);
+    }
+    assert!(cache.verdicts.lock().unwrap().len() <= PERMISSION_CACHE_CAPACITY);
+}
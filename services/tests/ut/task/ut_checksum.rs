@@ -0,0 +1,97 @@
+// Copyright (C) 2023 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use super::*;
+
+const ABC_SHA256: &str = "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad";
+
+// @tc.name: ut_checksum_parse
+// @tc.desc: Test parsing the checksum of a task config
+// @tc.precon: NA
+// @tc.step: 1. Parse checksums with known and unknown algorithms
+//           2. Parse digests of the wrong length or with invalid characters
+// @tc.expect: Only known algorithms with digests of their length are accepted
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+// @tc.level: level1
+#[test]
+fn ut_checksum_parse() {
+    let checksum = Checksum::parse(&format!("SHA256:{}", ABC_SHA256.to_uppercase())).unwrap();
+    assert_eq!(checksum.algorithm, Algorithm::Sha256);
+    assert_eq!(format(checksum.algorithm, &checksum.expected), format!("sha256:{}", ABC_SHA256));
+
+    let checksum = Checksum::parse("md5:900150983cd24fb0d6963f7d28e17f72").unwrap();
+    assert_eq!(checksum.algorithm, Algorithm::Md5);
+    assert_eq!(checksum.expected.len(), 16);
+
+    assert!(Checksum::parse(ABC_SHA256).is_none());
+    assert!(Checksum::parse(&format!("sha1:{}", ABC_SHA256)).is_none());
+    assert!(Checksum::parse("md5:900150983cd24fb0d6963f7d28e17f").is_none());
+    assert!(Checksum::parse("md5:900150983cd24fb0d6963f7d28e17f7").is_none());
+    assert!(Checksum::parse("md5:900150983cd24fb0d6963f7d28e17fzz").is_none());
+}
+
+// @tc.name: ut_checksum_digest
+// @tc.desc: Test the running digest of written bytes
+// @tc.precon: NA
+// @tc.step: 1. Update a digest with the input in two writes
+// @tc.expect: The digest equals the expected checksum of the whole input
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+// @tc.level: level1
+#[test]
+fn ut_checksum_digest() {
+    let checksum = Checksum::parse(&format!("sha256:{}", ABC_SHA256)).unwrap();
+    let mut digest = Digest::new(checksum.algorithm);
+    digest.update(b"ab");
+    digest.update(b"c");
+    assert_eq!(digest.finish(), checksum.expected);
+}
+
+// @tc.name: ut_checksum_hash_file
+// @tc.desc: Test hashing the bytes already downloaded to a file
+// @tc.precon: NA
+// @tc.step: 1. Write a file and move its cursor to the end
+//           2. Hash its first three bytes
+// @tc.expect: The digest covers the prefix and the cursor is not moved
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+// @tc.level: level1
+#[test]
+fn ut_checksum_hash_file() {
+    use std::io::{Seek, SeekFrom, Write};
+
+    let path = std::env::temp_dir().join("ut_checksum_hash_file");
+    let mut file = File::options()
+        .read(true)
+        .write(true)
+        .create(true)
+        .truncate(true)
+        .open(&path)
+        .unwrap();
+    file.write_all(b"abcdef").unwrap();
+    let file = Arc::new(Mutex::new(file));
+
+    let digest = ylong_runtime::block_on(hash_file(
+        file.clone(),
+        3,
+        Digest::new(Algorithm::Sha256),
+    ))
+    .unwrap();
+    assert_eq!(format(Algorithm::Sha256, &digest.finish()), format!("sha256:{}", ABC_SHA256));
+    assert_eq!(file.lock().unwrap().seek(SeekFrom::Current(0)).unwrap(), 6);
+
+    let res = ylong_runtime::block_on(hash_file(file, 7, Digest::new(Algorithm::Md5)));
+    assert!(res.is_err());
+    let _ = std::fs::remove_file(path);
+}
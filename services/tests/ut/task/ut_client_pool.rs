@@ -0,0 +1,125 @@
+// Copyright (C) 2023 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use super::*;
+
+fn key_of(config: &TaskConfig) -> ClientKey {
+    #[cfg(feature = "oh")]
+    let key = ClientKey::new(
+        config,
+        &SystemConfig {
+            proxy_host: String::new(),
+            proxy_port: String::new(),
+            proxy_exlist: String::new(),
+            certs: None,
+        },
+    );
+    #[cfg(not(feature = "oh"))]
+    let key = ClientKey::new(config);
+    key
+}
+
+// @tc.name: ut_client_pool_key
+// @tc.desc: Test which configs share a pooled client
+// @tc.precon: NA
+// @tc.step: 1. Build keys of configs differing in url or total timeout
+//           2. Build keys of configs differing in proxy, uid or pins
+// @tc.expect: Only the settings the client is built from tell keys apart
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+// @tc.level: level1
+#[test]
+fn ut_client_pool_key() {
+    let mut config = TaskConfig::default();
+    config.url = "https://example.com/a".to_string();
+    let key = key_of(&config);
+
+    let mut other = config.clone();
+    other.url = "https://example.com/b".to_string();
+    other.common_data.timeout.total_timeout = 10;
+    assert_eq!(key_of(&other), key);
+
+    let mut other = config.clone();
+    other.proxy = "http://proxy.example.com:8080".into();
+    assert_ne!(key_of(&other), key);
+
+    let mut other = config.clone();
+    other.common_data.uid += 1;
+    assert_ne!(key_of(&other), key);
+
+    // Pins are bound to the url of the task
+    config.certificate_pins = "sha256//AAAA".to_string();
+    let key = key_of(&config);
+    let mut other = config.clone();
+    other.url = "https://example.com/b".to_string();
+    assert_ne!(key_of(&other), key);
+}
+
+// @tc.name: ut_client_pool_evict
+// @tc.desc: Test the expiry and idle eviction of pooled clients
+// @tc.precon: NA
+// @tc.step: 1. Insert a client and get it before and after MAX_AGE
+//           2. Evict while the client is held and once it is idle
+// @tc.expect: Expired clients are not handed out, held clients are kept
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+// @tc.level: level1
+#[test]
+fn ut_client_pool_evict() {
+    let key = key_of(&TaskConfig::default());
+    let mut clients = Clients::new();
+    let held = clients.insert(key.clone(), (), 0);
+    assert!(clients.get(&key, MAX_AGE - 1).is_some());
+    assert!(clients.get(&key, MAX_AGE).is_none());
+
+    clients.evict(MAX_AGE + IDLE_TIMEOUT);
+    assert_eq!(clients.len(), 1);
+    drop(held);
+    clients.evict(MAX_AGE + IDLE_TIMEOUT);
+    assert!(clients.is_empty());
+
+    // A held client is idle from the last eviction that saw it in use
+    let held = clients.insert(key.clone(), (), 0);
+    clients.evict(IDLE_TIMEOUT);
+    assert_eq!(clients.len(), 1);
+    drop(held);
+    clients.evict(2 * IDLE_TIMEOUT - 1);
+    assert_eq!(clients.len(), 1);
+    clients.evict(2 * IDLE_TIMEOUT);
+    assert!(clients.is_empty());
+}
+
+// @tc.name: ut_client_pool_host_slots
+// @tc.desc: Test the limit of requests in flight to a host
+// @tc.precon: NA
+// @tc.step: 1. Take all slots of a host
+//           2. Take a slot of another host and release one of the first
+// @tc.expect: A host has at most MAX_CONNECTIONS_PER_HOST slots taken
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+// @tc.level: level1
+#[test]
+fn ut_client_pool_host_slots() {
+    let slots = HostSlots::new();
+    let host = host_of("https://User@Example.com:8443/a?b");
+    assert_eq!(host, "example.com:8443");
+
+    let mut taken = (0..MAX_CONNECTIONS_PER_HOST)
+        .map(|_| slots.try_take(&host).unwrap())
+        .collect::<Vec<_>>();
+    assert!(slots.try_take(&host).is_none());
+    assert!(slots.try_take("example.com").is_some());
+
+    taken.pop();
+    assert!(slots.try_take(&host).is_some());
+}
@@ -0,0 +1,85 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use super::*;
+
+fn download_config(url: &str, headers: &[(&str, &str)]) -> TaskConfig {
+    let mut config = TaskConfig::default();
+    config.url = url.to_string();
+    config.method = "GET".to_string();
+    config.common_data.action = Action::Download;
+    config.common_data.coalesce = true;
+    for (k, v) in headers {
+        config.headers.insert(k.to_string(), v.to_string());
+    }
+    config
+}
+
+// @tc.name: ut_coalesce_key_same_request
+// @tc.desc: Test the transfer key of downloads sending the same request
+// @tc.precon: NA
+// @tc.step: 1. Build two download configs with the same url and headers
+//              inserted in different orders
+// @tc.expect: Both configs have the same key
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+// @tc.level: level1
+#[test]
+fn ut_coalesce_key_same_request() {
+    let a = download_config("https://example.com/a", &[("a", "1"), ("b", "2")]);
+    let b = download_config("https://example.com/a", &[("b", "2"), ("a", "1")]);
+    assert!(key(&a).is_some());
+    assert_eq!(key(&a), key(&b));
+}
+
+// @tc.name: ut_coalesce_key_different_request
+// @tc.desc: Test the transfer key of downloads sending different requests
+// @tc.precon: NA
+// @tc.step: 1. Build download configs differing in url, headers, range and
+//              checksum
+// @tc.expect: Every config has a different key
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+// @tc.level: level1
+#[test]
+fn ut_coalesce_key_different_request() {
+    let base = download_config("https://example.com/a", &[("a", "1")]);
+    let url = download_config("https://example.com/b", &[("a", "1")]);
+    let headers = download_config("https://example.com/a", &[("a", "2")]);
+    let mut range = base.clone();
+    range.common_data.begins = 100;
+    let mut checksum = base.clone();
+    checksum.checksum = "sha256:00".to_string();
+    for other in [&url, &headers, &range, &checksum] {
+        assert_ne!(key(&base), key(other));
+    }
+}
+
+// @tc.name: ut_coalesce_key_opt_out
+// @tc.desc: Test that only downloads opting in have a transfer key
+// @tc.precon: NA
+// @tc.step: 1. Build a download without `coalesce` and an upload with it
+// @tc.expect: Neither config has a key
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+// @tc.level: level1
+#[test]
+fn ut_coalesce_key_opt_out() {
+    let mut download = download_config("https://example.com/a", &[]);
+    download.common_data.coalesce = false;
+    assert!(key(&download).is_none());
+
+    let mut upload = download_config("https://example.com/a", &[]);
+    upload.common_data.action = Action::Upload;
+    assert!(key(&upload).is_none());
+}
@@ -77,3 +77,46 @@ fn ut_enum_network_config() {
     assert_eq!(NetworkConfig::Wifi as u32, 1);
     assert_eq!(NetworkConfig::Cellular as u32, 2);
 }
+
+// @tc.name: ut_config_satisfy_network
+// @tc.desc: Test whether a task can run on a network it switched to
+// @tc.precon: NA
+// @tc.step: 1. Check a Wi-Fi task on another Wi-Fi and on cellular
+//           2. Check a task not allowing metered networks on a metered one
+//           3. Check any task offline
+// @tc.expect: Only networks breaking the network, metered or roaming
+//             constraints of the task are refused
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+#[test]
+fn ut_config_satisfy_network() {
+    let online = |network_type, is_metered, is_roaming| {
+        NetworkState::Online(crate::manage::network::NetworkInfo {
+            network_type,
+            is_metered,
+            is_roaming,
+        })
+    };
+    let mut config = TaskConfig::default();
+    config.common_data.network_config = NetworkConfig::Wifi;
+    assert!(config
+        .satisfy_network(&online(NetworkType::Wifi, false, false))
+        .is_ok());
+    assert_eq!(
+        config.satisfy_network(&online(NetworkType::Cellular, false, false)),
+        Err(Reason::UnsupportedNetworkType)
+    );
+    assert_eq!(
+        config.satisfy_network(&online(NetworkType::Wifi, true, false)),
+        Err(Reason::UnsupportedNetworkType)
+    );
+
+    config.common_data.metered = true;
+    assert!(config
+        .satisfy_network(&online(NetworkType::Wifi, true, false))
+        .is_ok());
+    assert_eq!(
+        config.satisfy_network(&NetworkState::Offline),
+        Err(Reason::NetworkOffline)
+    );
+}
@@ -0,0 +1,100 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use super::*;
+
+/// Spins on the CPU for about `ms` milliseconds of the calling thread.
+fn spin(ms: u64) {
+    let start = thread_cpu_ns();
+    while thread_cpu_ns() - start < ms * 1_000_000 {
+        std::hint::black_box(0);
+    }
+}
+
+// @tc.name: ut_cpu_nested_paths
+// @tc.desc: Test that a path measured within another is only charged once
+// @tc.precon: NA
+// @tc.step: 1. Measure a write path within an http path of a task
+//           2. Read the CPU of the task
+// @tc.expect: Each path is charged its own CPU, the write path is not
+//             charged to the http path
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_cpu_nested_paths() {
+    let cpu = TaskCpu::new(0);
+    cpu.measure(Path::Http, || {
+        spin(5);
+        cpu.measure(Path::Write, || spin(20));
+    });
+    let usage = cpu.usage();
+    assert!(usage.ns[Path::Write as usize] >= 20_000_000);
+    assert!(usage.ns[Path::Http as usize] >= 5_000_000);
+    assert!(usage.ns[Path::Http as usize] < 20_000_000);
+    assert_eq!(usage.ns[Path::Notify as usize], 0);
+}
+
+// @tc.name: ut_cpu_bytes_per_cpu_ms
+// @tc.desc: Test the bytes transferred per CPU millisecond
+// @tc.precon: NA
+// @tc.step: 1. Compute the rate of usages with and without CPU
+// @tc.expect: The bytes are divided by the CPU on all paths, 0 without CPU
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_cpu_bytes_per_cpu_ms() {
+    let usage = CpuUsage {
+        ns: [1_000_000, 500_000, 250_000, 250_000],
+        bytes: 4_000_000,
+    };
+    assert_eq!(usage.total_ns(), 2_000_000);
+    assert_eq!(usage.bytes_per_cpu_ms(), 2_000_000);
+    assert_eq!(CpuUsage::default().bytes_per_cpu_ms(), 0);
+}
+
+// @tc.name: ut_cpu_forget_keeps_uid
+// @tc.desc: Test that the CPU of a forgotten task stays counted for its uid
+// @tc.precon: NA
+// @tc.step: 1. Charge a task known by id and add it to the extras of its info
+//           2. Forget the task and read the CPU of its uid
+// @tc.expect: The extras hold the CPU of each path, the uid keeps the CPU
+//             and bytes of the task once it is forgotten
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_cpu_forget_keeps_uid() {
+    const TASK_ID: u32 = 0xC9_0001;
+    const UID: u64 = 0xC9_0002;
+    let cpu = Arc::new(TaskCpu::new(UID));
+    TABLE.lock().unwrap().tasks.insert(TASK_ID, cpu.clone());
+    measure(TASK_ID, Path::Notify, || spin(2));
+    cpu.add_bytes(1024);
+
+    let mut extras = HashMap::new();
+    add_extras(TASK_ID, &mut extras);
+    assert_eq!(extras.len(), PATHS + 1);
+    assert!(extras["cpu-notify-us"].parse::<u64>().unwrap() >= 2000);
+
+    let usage = task_usage(TASK_ID).unwrap();
+    forget(TASK_ID);
+    assert!(task_usage(TASK_ID).is_none());
+    let (_, uid_usage) = uid_usages()
+        .into_iter()
+        .find(|(uid, _)| *uid == UID)
+        .unwrap();
+    assert_eq!(uid_usage, usage);
+    assert!(dump().contains(&UID.to_string()));
+}
@@ -0,0 +1,95 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use super::*;
+
+// @tc.name: ut_dns_authority
+// @tc.desc: Test the authority resolved for the url of a task
+// @tc.precon: NA
+// @tc.step: 1. Get the authority of urls with and without a port
+// @tc.expect: The default port of the scheme is added when missing
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_dns_authority() {
+    assert_eq!(
+        authority_of("https://Example.com/a").as_deref(),
+        Some("example.com:443")
+    );
+    assert_eq!(
+        authority_of("http://example.com:8080/a").as_deref(),
+        Some("example.com:8080")
+    );
+    assert_eq!(authority_of("http://[::1]/a").as_deref(), Some("[::1]:80"));
+    assert_eq!(
+        authority_of("https://[::1]:8443").as_deref(),
+        Some("[::1]:8443")
+    );
+    assert_eq!(authority_of("ftp://example.com/a"), None);
+}
+
+// @tc.name: ut_dns_cache_expire
+// @tc.desc: Test the expiry and the clearing of the DNS cache
+// @tc.precon: NA
+// @tc.step: 1. Insert a resolution and look it up before and after its TTL
+//           2. Clear the cache, then insert a resolution started before
+// @tc.expect: Expired and stale resolutions are not returned
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_dns_cache_expire() {
+    let cache = DnsCache::new();
+    let addr: SocketAddr = "127.0.0.1:80".parse().unwrap();
+    cache.insert("example.com:80", vec![addr], 0, 0);
+    assert_eq!(
+        cache.lookup("example.com:80", DNS_TTL - 1),
+        Some(vec![addr])
+    );
+    assert_eq!(cache.lookup("example.com:80", DNS_TTL), None);
+
+    cache.clear();
+    assert_eq!(cache.lookup("example.com:80", 0), None);
+    cache.insert("example.com:80", vec![addr], 0, 0);
+    assert_eq!(cache.lookup("example.com:80", 0), None);
+    cache.insert("example.com:80", vec![addr], 0, 1);
+    assert_eq!(cache.lookup("example.com:80", 0), Some(vec![addr]));
+}
+
+// @tc.name: ut_dns_distinct_hosts
+// @tc.desc: Test the hosts resolved when the service starts
+// @tc.precon: NA
+// @tc.step: 1. Select the hosts of urls of the latest tasks
+// @tc.expect: One url per host in the order of the tasks, at most as many
+//             as asked for
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_dns_distinct_hosts() {
+    let urls = [
+        "https://a.com/1",
+        "https://a.com/2",
+        "ftp://b.com/1",
+        "http://a.com/3",
+        "https://c.com/1",
+        "https://d.com/1",
+    ]
+    .map(String::from);
+    assert_eq!(
+        distinct_hosts(&urls, 3),
+        ["https://a.com/1", "http://a.com/3", "https://c.com/1"]
+    );
+    assert_eq!(distinct_hosts(&urls, 10).len(), 4);
+}
@@ -42,7 +42,7 @@ fn build_task(config: TaskConfig) -> Arc<RequestTask> {
     static TASK_MANGER: Lazy<TaskManagerTx> = Lazy::new(|| {
         TaskManager::init(RUN_COUNT_MANAGER.clone(), CLIENT.clone(), NETWORK.clone())
     });
-    let (files, client) = check_config(&config, 0).unwrap();
+    let (files, client) = check_config(&config).unwrap();
 
     let task = Arc::new(RequestTask::new(
         config,
@@ -415,14 +415,8 @@ fn ut_download_invalid_task() {
 
         assert_eq!(State::Completed, task.status.lock().unwrap().state);
         assert_eq!(0, task.progress.lock().unwrap().common_data.index);
-        assert_eq!(
-            GITEE_FILE_LEN,
-            task.progress.lock().unwrap().common_data.total_processed as u64
-        );
-        assert_eq!(
-            GITEE_FILE_LEN,
-            task.progress.lock().unwrap().processed[0] as u64
-        );
+        assert_eq!(GITEE_FILE_LEN, task.processed.total() as u64);
+        assert_eq!(GITEE_FILE_LEN, task.processed.file(0) as u64);
         assert_eq!(
             GITEE_FILE_LEN,
             task.progress.lock().unwrap().sizes[0] as u64
@@ -0,0 +1,38 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use super::*;
+
+// @tc.name: ut_file_io_submit
+// @tc.desc: Test the completion of operations submitted to the blocking pool
+// @tc.precon: NA
+// @tc.step: 1. Submit an operation and await it
+//           2. Submit a failing operation and wait for it
+// @tc.expect: The results of the operations are returned
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_file_io_submit() {
+    let submission = submit(|| {
+        std::thread::sleep(std::time::Duration::from_millis(50));
+        Ok(1)
+    });
+    assert_eq!(ylong_runtime::block_on(submission).unwrap(), 1);
+
+    let submission = submit(|| -> io::Result<()> { Err(io::ErrorKind::NotFound.into()) });
+    assert_eq!(
+        submission.wait().unwrap_err().kind(),
+        io::ErrorKind::NotFound
+    );
+}
@@ -0,0 +1,81 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use super::*;
+use crate::utils::form_item::FileSpec;
+
+fn download_config() -> TaskConfig {
+    let mut config = TaskConfig::default();
+    config.url = "https://example.com/a".to_string();
+    config.common_data.action = Action::Download;
+    config.file_specs.push(FileSpec {
+        name: "file".to_string(),
+        path: "/data/a".to_string(),
+        file_name: "a".to_string(),
+        mime_type: String::new(),
+        is_user_file: false,
+        fd: None,
+    });
+    config
+}
+
+// @tc.name: ut_handoff_accepts
+// @tc.desc: Test which downloads a cached body can stand for
+// @tc.precon: NA
+// @tc.step: 1. Check a plain download of a whole body to a file
+//           2. Check downloads with headers, a range, an in-memory body or
+//              another method
+// @tc.expect: Only the plain download accepts a cached body
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_handoff_accepts() {
+    assert!(accepts(&download_config()));
+
+    let mut headers = download_config();
+    headers.headers.insert("a".to_string(), "1".to_string());
+    let mut range = download_config();
+    range.common_data.ends = 100;
+    let mut memory = download_config();
+    memory.common_data.memory_limit = 1024;
+    let mut post = download_config();
+    post.method = "POST".to_string();
+    let mut upload = download_config();
+    upload.common_data.action = Action::Upload;
+    for config in [headers, range, memory, post, upload] {
+        assert!(!accepts(&config));
+    }
+}
+
+// @tc.name: ut_handoff_take
+// @tc.desc: Test keeping the bodies handed over for tasks
+// @tc.precon: NA
+// @tc.step: 1. Hand a body over for a task and take it twice
+//           2. Hand a body over for a task and discard it
+// @tc.expect: A body is taken once, a discarded body is not taken
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_handoff_take() {
+    let body = File::open("/proc/self/stat").unwrap();
+    assert!(hand_over(u32::MAX, body));
+    assert!(take(u32::MAX).is_some());
+    assert!(take(u32::MAX).is_none());
+
+    let body = File::open("/proc/self/stat").unwrap();
+    assert!(hand_over(u32::MAX - 1, body));
+    discard(u32::MAX - 1);
+    assert!(take(u32::MAX - 1).is_none());
+}
@@ -0,0 +1,62 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use std::io::Write;
+
+use super::*;
+
+fn config(action: Action, memory_limit: u32) -> TaskConfig {
+    let mut config = TaskConfig::default();
+    config.common_data.action = action;
+    config.common_data.memory_limit = memory_limit;
+    config
+}
+
+// @tc.name: ut_memory_limit
+// @tc.desc: Test the limit of the body of in-memory downloads
+// @tc.precon: NA
+// @tc.step: 1. Get the limit of downloads and uploads with and without one
+//           2. Get the limit of a download above the maximum
+// @tc.expect: Only downloads with a limit keep their body in memory, and at
+//             most `MEMORY_LIMIT_MAX` bytes of it
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_memory_limit() {
+    assert_eq!(limit(&config(Action::Download, 0)), None);
+    assert_eq!(limit(&config(Action::Upload, 4096)), None);
+    assert_eq!(limit(&config(Action::Download, 4096)), Some(4096));
+    assert_eq!(
+        limit(&config(Action::Download, u32::MAX)),
+        Some(MEMORY_LIMIT_MAX as u64)
+    );
+}
+
+// @tc.name: ut_memory_open_body
+// @tc.desc: Test the anonymous file holding a body
+// @tc.precon: NA
+// @tc.step: 1. Open the file of a body, write to it and read it back
+// @tc.expect: The body written is read back
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_memory_open_body() {
+    let mut file = open_body(1).unwrap();
+    file.write_all(b"hello").unwrap();
+    file.seek(SeekFrom::Start(0)).unwrap();
+    let mut body = Vec::new();
+    file.read_to_end(&mut body).unwrap();
+    assert_eq!(body, b"hello");
+}
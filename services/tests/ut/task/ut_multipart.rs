@@ -0,0 +1,135 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use super::*;
+
+/// File content read at most `step` bytes at a time.
+struct MemoryReader {
+    data: Vec<u8>,
+    pos: usize,
+    step: usize,
+}
+
+impl MemoryReader {
+    fn new(data: &[u8], step: usize) -> Self {
+        Self {
+            data: data.to_vec(),
+            pos: 0,
+            step,
+        }
+    }
+}
+
+impl AsyncRead for MemoryReader {
+    fn poll_read(
+        self: Pin<&mut Self>,
+        _cx: &mut Context<'_>,
+        buf: &mut ReadBuf<'_>,
+    ) -> Poll<io::Result<()>> {
+        let this = self.get_mut();
+        let mut offset = this.pos;
+        let end = this.data.len().min(this.pos + this.step);
+        copy_bytes(&this.data[..end], &mut offset, buf);
+        this.pos = offset;
+        Poll::Ready(Ok(()))
+    }
+}
+
+impl ReusableReader for MemoryReader {
+    fn reuse<'a>(&'a mut self) -> Pin<Box<dyn Future<Output = io::Result<()>> + Send + Sync + 'a>>
+    where
+        Self: 'a,
+    {
+        self.pos = 0;
+        Box::pin(async { Ok(()) })
+    }
+}
+
+/// Reads the whole body into buffers of `size` bytes.
+fn read_body(body: &mut MultipartBody<MemoryReader>, size: usize) -> io::Result<Vec<u8>> {
+    ylong_runtime::block_on(async {
+        let mut out = Vec::new();
+        loop {
+            let mut buf = vec![0u8; size];
+            let mut read_buf = ReadBuf::new(&mut buf);
+            std::future::poll_fn(|cx| Pin::new(&mut *body).poll_read(cx, &mut read_buf)).await?;
+            let n = read_buf.filled().len();
+            if n == 0 {
+                return Ok(out);
+            }
+            out.extend_from_slice(&buf[..n]);
+        }
+    })
+}
+
+// @tc.name: ut_multipart_body
+// @tc.desc: Test the encoding and the length of a multipart body
+// @tc.precon: NA
+// @tc.step: 1. Plan a body of form fields and files
+//           2. Read it into buffers of several sizes, and again after reuse
+// @tc.expect: The body is the encoded form with the files in place, its
+//             length is the one planned, and it reads the same after reuse
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_multipart_body() {
+    let plan = || {
+        MultipartBody::new("b0".to_string())
+            .text("key", "value")
+            .file(
+                "file",
+                "a\"b.txt",
+                "text/plain",
+                5,
+                MemoryReader::new(b"hello", 2),
+            )
+            .file("raw", "c", "", 3, MemoryReader::new(b"xyz", 1))
+    };
+    let expected = "--b0\r\n\
+                    Content-Disposition: form-data; name=\"key\"\r\n\r\n\
+                    value\r\n\
+                    --b0\r\n\
+                    Content-Disposition: form-data; name=\"file\"; filename=\"a%22b.txt\"\r\n\
+                    Content-Type: text/plain\r\n\r\n\
+                    hello\r\n\
+                    --b0\r\n\
+                    Content-Disposition: form-data; name=\"raw\"; filename=\"c\"\r\n\r\n\
+                    xyz\r\n\
+                    --b0--\r\n";
+    for size in [1, 7, 4096] {
+        let mut body = plan();
+        assert_eq!(body.len(), expected.len() as u64);
+        assert_eq!(body.content_type(), "multipart/form-data; boundary=b0");
+        assert_eq!(read_body(&mut body, size).unwrap(), expected.as_bytes());
+        ylong_runtime::block_on(body.reuse()).unwrap();
+        assert_eq!(read_body(&mut body, size).unwrap(), expected.as_bytes());
+    }
+}
+
+// @tc.name: ut_multipart_short_file
+// @tc.desc: Test a file ending before its planned length
+// @tc.precon: NA
+// @tc.step: 1. Plan a body with a file shorter than its length
+//           2. Read the body
+// @tc.expect: Reading fails with `UnexpectedEof`
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_multipart_short_file() {
+    let mut body =
+        MultipartBody::new(boundary()).file("file", "f", "", 10, MemoryReader::new(b"short", 3));
+    let err = read_body(&mut body, 64).unwrap_err();
+    assert_eq!(err.kind(), io::ErrorKind::UnexpectedEof);
+}
@@ -54,6 +54,7 @@ fn ut_waiting_cause_enum_values() {
     assert_eq!(WaitingCause::Network as u8, 1);
     assert_eq!(WaitingCause::AppState as u8, 2);
     assert_eq!(WaitingCause::UserState as u8, 3);
+    assert_eq!(WaitingCause::Origin as u8, 4);
 }
 
 // @tc.name: ut_each_file_status_create_empty_files
@@ -212,6 +213,40 @@ fn ut_each_file_status_create_index_beyond_length() {
     assert_eq!(result[1].reason, Reason::Default);
 }
 
+// @tc.name: ut_each_file_status_clear_uploaded
+// @tc.desc: Test clear_uploaded with files uploaded out of order
+// @tc.precon: NA
+// @tc.step: 1. Create statuses failing from index 1 of 4 files
+//           2. Mark files 1 and 3 as uploaded completely and clear
+// @tc.expect: Only the file at the index and the incomplete file keep the reason
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+// @tc.level: Level 1
+#[test]
+fn ut_each_file_status_clear_uploaded() {
+    let file_specs = (0..4)
+        .map(|i| FileSpec {
+            name: format!("file{}.txt", i),
+            path: format!("/tmp/file{}.txt", i),
+            file_name: format!("file{}.txt", i),
+            mime_type: "text/plain".to_string(),
+            is_user_file: false,
+            fd: None,
+        })
+        .collect::<Vec<_>>();
+    let mut result = EachFileStatus::create_each_file_status(&file_specs, 1, Reason::ProtocolError);
+
+    let mut progress = Progress::new(vec![10, 10, 10, 10]);
+    progress.common_data.index = 1;
+    progress.processed = vec![10, 10, 4, 10];
+    EachFileStatus::clear_uploaded(&mut result, &progress);
+    assert_eq!(result[0].reason, Reason::Default);
+    assert_eq!(result[1].reason, Reason::ProtocolError);
+    assert_eq!(result[2].reason, Reason::ProtocolError);
+    assert_eq!(result[3].reason, Reason::Default);
+    assert_eq!(result[3].message, Reason::Default.to_str());
+}
+
 // @tc.name: ut_progress_new_empty_sizes
 // @tc.desc: Test Progress::new with empty sizes vector
 // @tc.precon: NA
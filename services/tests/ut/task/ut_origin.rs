@@ -0,0 +1,88 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use super::*;
+
+// @tc.name: ut_origin_backoff
+// @tc.desc: Test the backoff of the retries of an origin
+// @tc.precon: NA
+// @tc.step: 1. Get the backoff after growing numbers of failures
+// @tc.expect: The backoff doubles with jitter and stops at the maximum
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_origin_backoff() {
+    for failures in 1..6 {
+        let backoff = backoff_of(failures);
+        let full = BASE_BACKOFF << (failures - 1);
+        assert!(backoff >= full / 2 && backoff <= full);
+    }
+    assert!(backoff_of(100) <= MAX_BACKOFF);
+    assert!(backoff_of(100) >= MAX_BACKOFF / 2);
+}
+
+// @tc.name: ut_origin_circuit
+// @tc.desc: Test the circuit breaker of an origin
+// @tc.precon: NA
+// @tc.step: 1. Record failures until the circuit opens
+//           2. Ask to connect before and after the backoff
+//           3. Record a response of the probe
+// @tc.expect: Tasks wait while open, a single task probes, the response
+//             closes the circuit
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_origin_circuit() {
+    let origins = Origins::new();
+    let origin = "example.com";
+    for _ in 1..BREAKER_THRESHOLD {
+        origins.failure(origin, 0);
+        assert_eq!(origins.admit(origin, 0), None);
+    }
+    origins.failure(origin, 0);
+    let wait = origins.admit(origin, 0).unwrap();
+    assert!(wait >= BASE_BACKOFF / 2 && wait <= BASE_BACKOFF);
+    assert_eq!(origins.admit("other.com", 0), None);
+
+    assert_eq!(origins.admit(origin, wait), None);
+    assert_eq!(origins.admit(origin, wait), Some(PROBE_WAIT));
+    assert_eq!(origins.admit(origin, wait + PROBE_TIMEOUT), None);
+
+    origins.success(origin);
+    assert_eq!(origins.admit(origin, wait + PROBE_TIMEOUT), None);
+    assert_eq!(origins.admit(origin, wait + PROBE_TIMEOUT), None);
+}
+
+// @tc.name: ut_origin_probe_failure
+// @tc.desc: Test a failed probe of an open circuit
+// @tc.precon: NA
+// @tc.step: 1. Open the circuit of an origin and let a task probe it
+//           2. Record a failure of the probe
+// @tc.expect: The circuit opens again for a longer backoff
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_origin_probe_failure() {
+    let origins = Origins::new();
+    let origin = "example.com";
+    for _ in 0..BREAKER_THRESHOLD {
+        origins.failure(origin, 0);
+    }
+    assert_eq!(origins.admit(origin, BASE_BACKOFF), None);
+    origins.failure(origin, BASE_BACKOFF);
+    let wait = origins.admit(origin, BASE_BACKOFF).unwrap();
+    assert!(wait >= BASE_BACKOFF && wait <= BASE_BACKOFF * 2);
+}
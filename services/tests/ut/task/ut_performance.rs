@@ -0,0 +1,59 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use super::*;
+
+// @tc.name: ut_performance_encode
+// @tc.desc: Test that the timings of an attempt survive the database
+// @tc.precon: NA
+// @tc.step: 1. Encode the timings of an attempt, unknown ones included
+//           2. Decode them again
+// @tc.expect: The decoded timings equal the encoded ones
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_performance_encode() {
+    let performance = Performance {
+        attempt: 3,
+        dns: 12,
+        connect: 40,
+        tls: -1,
+        ttfb: 230,
+        transfer: 1800,
+        server: "cdn.example.com:8443".to_string(),
+        ..Default::default()
+    };
+    assert_eq!(Performance::decode(&performance.encode()), performance);
+    let performance = Performance::default();
+    assert_eq!(Performance::decode(&performance.encode()), performance);
+}
+
+// @tc.name: ut_performance_decode_malformed
+// @tc.desc: Test decoding missing or malformed timings
+// @tc.precon: NA
+// @tc.step: 1. Decode an empty text, as stored before the first attempt
+//           2. Decode a truncated and a non numeric text
+// @tc.expect: The default timings are returned
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_performance_decode_malformed() {
+    assert_eq!(Performance::decode(""), Performance::default());
+    assert_eq!(Performance::decode("1 2 3"), Performance::default());
+    assert_eq!(
+        Performance::decode("1 a 3 4 5 6 host"),
+        Performance::default()
+    );
+}
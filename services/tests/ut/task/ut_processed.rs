@@ -0,0 +1,80 @@
+// Copyright (C) 2023 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use std::sync::Arc;
+use std::thread;
+
+use super::*;
+
+// @tc.name: ut_processed_update
+// @tc.desc: Test adding to and replacing the processed counters
+// @tc.precon: NA
+// @tc.step: 1. Create counters of two files and add bytes to both
+//           2. Reset the second file and the total with update
+// @tc.expect: The files and the total hold the expected bytes
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+// @tc.level: level1
+#[test]
+fn ut_processed_update() {
+    let counters = ProcessedCounters::new(&[10], 10, 2);
+    counters.add(0, 5);
+    counters.add(1, 7);
+    assert_eq!(counters.snapshot(), (vec![15, 7], 22));
+
+    counters.update(|files, total| {
+        files[1] = 0;
+        *total = files.iter().take(1).sum();
+    });
+    assert_eq!(counters.file(1), 0);
+    assert_eq!(counters.total(), 15);
+
+    // Bytes of an unknown file only count in the total
+    counters.add(2, 1);
+    assert_eq!(counters.snapshot(), (vec![15, 0], 16));
+}
+
+// @tc.name: ut_processed_concurrent
+// @tc.desc: Test snapshots taken while several writers add bytes
+// @tc.precon: NA
+// @tc.step: 1. Add bytes to one file from several threads
+//           2. Take snapshots meanwhile
+// @tc.expect: Every snapshot has a total equal to the sum of its files
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+// @tc.level: level1
+#[test]
+fn ut_processed_concurrent() {
+    const WRITERS: usize = 4;
+    const ADDS: usize = 10000;
+
+    let counters = Arc::new(ProcessedCounters::new(&[], 0, 2));
+    let writers = (0..WRITERS)
+        .map(|i| {
+            let counters = counters.clone();
+            thread::spawn(move || {
+                for _ in 0..ADDS {
+                    counters.add(i % 2, 3);
+                }
+            })
+        })
+        .collect::<Vec<_>>();
+    for _ in 0..ADDS {
+        let (files, total) = counters.snapshot();
+        assert_eq!(files.iter().sum::<usize>(), total);
+    }
+    for writer in writers {
+        writer.join().unwrap();
+    }
+    assert_eq!(counters.total(), WRITERS * ADDS * 3);
+}
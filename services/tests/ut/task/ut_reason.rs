@@ -49,6 +49,9 @@ fn ut_reason_enum_values() {
     assert_eq!(Reason::AppAccount.repr, 29);
     assert_eq!(Reason::NetworkAppAccount.repr, 30);
     assert_eq!(Reason::LowSpeed.repr, 31);
+    assert_eq!(Reason::ChecksumMismatch.repr, 32);
+    assert_eq!(Reason::BodyTooLarge.repr, 33);
+    assert_eq!(Reason::OriginUnavailable.repr, 34);
 }
 
 // @tc.name: ut_reason_from_u8_valid_values
@@ -89,6 +92,9 @@ fn ut_reason_from_u8_valid_values() {
     assert_eq!(Reason::from(29), Reason::AppAccount);
     assert_eq!(Reason::from(30), Reason::NetworkAppAccount);
     assert_eq!(Reason::from(31), Reason::LowSpeed);
+    assert_eq!(Reason::from(32), Reason::ChecksumMismatch);
+    assert_eq!(Reason::from(33), Reason::BodyTooLarge);
+    assert_eq!(Reason::from(34), Reason::OriginUnavailable);
 }
 
 // @tc.name: ut_reason_from_u8_invalid_values
@@ -102,7 +108,7 @@ fn ut_reason_from_u8_valid_values() {
 // @tc.level: Level 2
 #[test]
 fn ut_reason_from_u8_invalid_values() {
-    let invalid_values = vec![2, 3, 9, 13, 22, 32, 100, 200, 255];
+    let invalid_values = vec![2, 3, 9, 13, 22, 33, 100, 200, 255];
     for value in invalid_values {
         assert_eq!(Reason::from(value), Reason::OthersError);
     }
@@ -146,6 +152,12 @@ fn ut_reason_to_str_all_variants() {
     assert_eq!(Reason::AppAccount.to_str(), "The app is background or terminate and the account is stopped");
     assert_eq!(Reason::NetworkAppAccount.to_str(), "NetWork is offline and the app is background or terminate and the account is stopped");
     assert_eq!(Reason::LowSpeed.to_str(), "Below low speed limit");
+    assert_eq!(Reason::ChecksumMismatch.to_str(), "Checksum mismatch");
+    assert_eq!(Reason::BodyTooLarge.to_str(), "Body exceeds the memory limit");
+    assert_eq!(
+        Reason::OriginUnavailable.to_str(),
+        "The server is unreachable, waiting to retry"
+    );
 }
 
 // @tc.name: ut_reason_partial_eq
@@ -0,0 +1,110 @@
+// Copyright (C) 2023 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use super::*;
+
+// @tc.name: ut_segment_split
+// @tc.desc: Test splitting a body into segments
+// @tc.precon: NA
+// @tc.step: 1. Split sizes that are and are not divisible by the count
+//           2. Split a body smaller than the count
+// @tc.expect: The segments are contiguous, cover the body and differ in size
+// by at most one byte
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+#[test]
+fn ut_segment_split() {
+    for (total, count) in [(100, 4), (10, 3), (1024 * 1024 + 7, 8)] {
+        let segments = split(total, count);
+        assert_eq!(segments.len() as u64, count);
+        assert_eq!(segments[0].start, 0);
+        assert_eq!(segments.last().unwrap().end(), total - 1);
+        for pair in segments.windows(2) {
+            assert_eq!(pair[0].end() + 1, pair[1].start);
+        }
+        let lens = segments
+            .iter()
+            .map(|s| s.end() + 1 - s.start)
+            .collect::<Vec<_>>();
+        assert!(lens.iter().max().unwrap() - lens.iter().min().unwrap() <= 1);
+    }
+    assert_eq!(split(2, 4).len(), 2);
+}
+
+// @tc.name: ut_segment_contiguous
+// @tc.desc: Test the written prefix of a segmented body
+// @tc.precon: NA
+// @tc.step: 1. Split a body and mark segments as partially or fully written
+// @tc.expect: The prefix ends at the first byte not written of the first
+// segment not fully written
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+#[test]
+fn ut_segment_contiguous() {
+    let segments = split(100, 4).into_iter().map(Arc::new).collect::<Vec<_>>();
+    assert_eq!(contiguous(&segments), 0);
+
+    segments[1].written.store(25, Ordering::Release);
+    segments[2].written.store(10, Ordering::Release);
+    assert_eq!(contiguous(&segments), 0);
+
+    segments[0].written.store(25, Ordering::Release);
+    assert_eq!(contiguous(&segments), 60);
+
+    segments[2].written.store(25, Ordering::Release);
+    segments[3].written.store(25, Ordering::Release);
+    assert_eq!(contiguous(&segments), 100);
+    assert_eq!(segments[3].remaining(), 0);
+}
+
+// @tc.name: ut_segment_rebalance
+// @tc.desc: Test giving the end of the slowest segment to another connection
+// @tc.precon: NA
+// @tc.step: 1. Split a body and write part of the segments
+//           2. Rebalance for a connection whose segment is done
+//           3. Rebalance until the parts left are too small
+// @tc.expect: The segment expected to finish last is split, the new segment
+// covers its end and the body stays covered without overlaps
+// @tc.type: FUNC
+// @tc.require: issueNumber
+#[test]
+fn ut_segment_rebalance() {
+    let total = 16 * MIN_REBALANCE_SIZE;
+    let all = split(total, 2)
+        .into_iter()
+        .map(Arc::new)
+        .collect::<Vec<_>>();
+    all[0]
+        .written
+        .store(8 * MIN_REBALANCE_SIZE, Ordering::Release);
+    all[1].written.store(MIN_REBALANCE_SIZE, Ordering::Release);
+    let segments = Mutex::new(all.clone());
+
+    let next = rebalance(&segments, all[0].throughput()).unwrap();
+    assert_eq!(next.start, all[1].end() + 1);
+    assert_eq!(next.end(), total - 1);
+    assert!(next.end() - next.start + 1 > all[1].remaining());
+
+    while rebalance(&segments, all[0].throughput()).is_some() {}
+    let mut segments = segments.into_inner().unwrap();
+    assert!(segments.len() > 3);
+    segments.sort_by_key(|segment| segment.start);
+    for pair in segments.windows(2) {
+        assert_eq!(pair[0].end() + 1, pair[1].start);
+    }
+    assert_eq!(segments.last().unwrap().end(), total - 1);
+    for segment in segments.iter().skip(1) {
+        assert!(segment.remaining() >= MIN_REBALANCE_SIZE);
+    }
+    assert_eq!(contiguous(&segments), 9 * MIN_REBALANCE_SIZE);
+}
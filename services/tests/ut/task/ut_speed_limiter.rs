@@ -0,0 +1,85 @@
+// Copyright (C) 2023 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use super::*;
+
+// @tc.name: ut_token_bucket_charge
+// @tc.desc: Test the debt and refill of a token bucket
+// @tc.precon: NA
+// @tc.step: 1. Charge a bucket of 1000 bytes per second within and over its burst
+//           2. Charge it again after the reported wait
+//           3. Charge an unlimited bucket
+// @tc.expect: The wait pays off the debt exactly and unlimited buckets never wait
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+#[test]
+fn ut_token_bucket_charge() {
+    let bucket = TokenBucket::with_rate(1000);
+    // A new bucket holds BURST_MILLIS of its rate
+    assert_eq!(bucket.charge(1000, BURST_MILLIS), 0);
+    assert_eq!(bucket.charge(1000, 100), 100);
+    assert_eq!(bucket.charge(1050, 0), 50);
+    assert_eq!(bucket.charge(1100, 0), 0);
+    // Idle time does not accumulate more than the burst
+    assert_eq!(bucket.charge(10_000, BURST_MILLIS + 10), 10);
+
+    bucket.set_rate(0);
+    assert_eq!(bucket.charge(10_000, u64::MAX), 0);
+}
+
+// @tc.name: ut_speed_budgets_uid
+// @tc.desc: Test adding and removing the budget of a uid
+// @tc.precon: NA
+// @tc.step: 1. Set, change and remove the limit of a uid
+//           2. Charge the shared bucket from two tasks of the uid
+// @tc.expect: The tasks draw from one bucket and only adding or removing a
+// budget changes the generation
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+#[test]
+fn ut_speed_budgets_uid() {
+    let budgets = SpeedBudgets::new();
+    assert!(budgets.uid_bucket(1).is_none());
+    budgets.set_uid_limit(1, 1000);
+    assert_eq!(budgets.generation.load(Ordering::Acquire), 1);
+    budgets.set_uid_limit(1, 2000);
+    assert_eq!(budgets.generation.load(Ordering::Acquire), 1);
+
+    let first = budgets.uid_bucket(1).unwrap();
+    let second = budgets.uid_bucket(1).unwrap();
+    assert_eq!(first.charge(1000, 2 * BURST_MILLIS), 0);
+    assert_eq!(second.charge(1000, 2000), 1000);
+
+    budgets.set_uid_limit(1, 0);
+    assert!(budgets.uid_bucket(1).is_none());
+    assert_eq!(budgets.generation.load(Ordering::Acquire), 2);
+    budgets.set_uid_limit(2, 0);
+    assert_eq!(budgets.generation.load(Ordering::Acquire), 2);
+}
+
+// @tc.name: ut_task_budget_uncharged
+// @tc.desc: Test that bytes reported by several transfers are charged once
+// @tc.precon: NA
+// @tc.step: 1. Report growing, repeated and reset processed sizes
+// @tc.expect: Only the growth since the last report is returned
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+#[test]
+fn ut_task_budget_uncharged() {
+    let budget = TaskBudget::new();
+    assert_eq!(budget.take_uncharged(100), 100);
+    assert_eq!(budget.take_uncharged(100), 0);
+    assert_eq!(budget.take_uncharged(150), 50);
+    assert_eq!(budget.take_uncharged(0), 0);
+    assert_eq!(budget.take_uncharged(10), 10);
+}
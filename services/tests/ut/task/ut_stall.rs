@@ -0,0 +1,117 @@
+// Copyright (C) 2023 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use super::*;
+
+const SPEED: u64 = 100 * 1024;
+
+fn detector(window: i64, ratio: i64) -> Option<StallDetector> {
+    StallDetector::new(&StallDetection { window, ratio })
+}
+
+// Samples one second each at `speed` bytes per second from `*now`.
+fn run(
+    detector: &mut StallDetector,
+    now: &mut u64,
+    received: &mut u64,
+    secs: u64,
+    speed: u64,
+) -> bool {
+    let mut stalled = false;
+    for _ in 0..secs {
+        *now += 1000;
+        *received += speed;
+        stalled |= detector.check(*now, *received, 0);
+    }
+    stalled
+}
+
+// @tc.name: ut_stall_config
+// @tc.desc: Test the stall detection settings of a task
+// @tc.precon: NA
+// @tc.step: 1. Create detectors with default, custom and negative settings
+// @tc.expect: Zero takes the defaults and a negative ratio disables detection
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+// @tc.level: level1
+#[test]
+fn ut_stall_config() {
+    let default = detector(0, 0).unwrap();
+    assert_eq!(default.window, DEFAULT_STALL_WINDOW);
+    assert_eq!(default.ratio, DEFAULT_STALL_RATIO);
+
+    let custom = detector(1, 50).unwrap();
+    assert_eq!(custom.window, MIN_WINDOW);
+    assert_eq!(custom.ratio, 50);
+
+    assert!(detector(5000, -1).is_none());
+}
+
+// @tc.name: ut_stall_detect
+// @tc.desc: Test a connection degrading from its usual throughput
+// @tc.precon: NA
+// @tc.step: 1. Receive at a steady speed for longer than window and history
+//           2. Receive at a speed within the ratio, then below it
+// @tc.expect: Only the window below the ratio of the history stalls
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+// @tc.level: level1
+#[test]
+fn ut_stall_detect() {
+    let mut detector = detector(0, 0).unwrap();
+    let (mut now, mut received) = (0, 0);
+    assert!(!run(&mut detector, &mut now, &mut received, 90, SPEED));
+
+    // A fifth of the usual speed is still above 10%
+    assert!(!run(&mut detector, &mut now, &mut received, 20, SPEED / 5));
+
+    // The history now averages the slower speed as well, a trickle stalls
+    assert!(run(&mut detector, &mut now, &mut received, 20, 1));
+}
+
+// @tc.name: ut_stall_warmup
+// @tc.desc: Test the history a stall needs before it is detected
+// @tc.precon: NA
+// @tc.step: 1. Trickle from the start of a connection
+//           2. Stall after a history shorter than the window
+//           3. Stall after a history too slow to compare with
+//           4. Change the speed limit during a stall
+// @tc.expect: None of the connections stalls
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+// @tc.level: level1
+#[test]
+fn ut_stall_warmup() {
+    let mut trickle = detector(0, 0).unwrap();
+    let (mut now, mut received) = (0, 0);
+    assert!(!run(&mut trickle, &mut now, &mut received, 60, 1));
+
+    let mut short = detector(0, 0).unwrap();
+    let (mut now, mut received) = (0, 0);
+    assert!(!run(&mut short, &mut now, &mut received, 5, SPEED));
+    assert!(!run(&mut short, &mut now, &mut received, 10, 0));
+
+    let mut slow = detector(0, 0).unwrap();
+    let (mut now, mut received) = (0, 0);
+    assert!(!run(&mut slow, &mut now, &mut received, 30, MIN_HISTORY_SPEED / 2));
+    assert!(!run(&mut slow, &mut now, &mut received, 20, 0));
+
+    let mut limited = detector(0, 0).unwrap();
+    let (mut now, mut received) = (0, 0);
+    assert!(!run(&mut limited, &mut now, &mut received, 30, SPEED));
+    for _ in 0..20 {
+        now += 1000;
+        received += 1;
+        assert!(!limited.check(now, received, 16 * 1024));
+    }
+}
@@ -0,0 +1,67 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use super::*;
+
+// @tc.name: ut_throughput_average
+// @tc.desc: Test the smoothing of the throughput of a task
+// @tc.precon: NA
+// @tc.step: 1. Sample a steady transfer of 1000 bytes per second
+//           2. Sample one second at 4000 bytes per second
+// @tc.expect: The speed is the steady one, then moves part of the way only
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_throughput_average() {
+    let mut throughput = Throughput::default();
+    assert_eq!(throughput.speed(), 0);
+    assert_eq!(throughput.eta(1000), -1);
+
+    for i in 0..5 {
+        throughput.sample(i * 1000, i * 1000);
+    }
+    assert_eq!(throughput.speed(), 1000);
+    assert_eq!(throughput.eta(2500), 3);
+    assert_eq!(throughput.eta(-1), -1);
+
+    throughput.sample(5000, 8000);
+    let speed = throughput.speed();
+    assert!(speed > 1000 && speed < 4000);
+}
+
+// @tc.name: ut_throughput_idle
+// @tc.desc: Test the throughput of a task resumed after a pause
+// @tc.precon: NA
+// @tc.step: 1. Sample a transfer, then sample again after a long gap
+//           2. Sample the resumed transfer
+// @tc.expect: The average starts over with the resumed transfer
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_throughput_idle() {
+    let mut throughput = Throughput::default();
+    throughput.sample(0, 0);
+    throughput.sample(1000, 1000);
+    assert_eq!(throughput.speed(), 1000);
+
+    throughput.sample(60000, 1000);
+    assert_eq!(throughput.speed(), 0);
+    throughput.sample(61000, 3000);
+    assert_eq!(throughput.speed(), 2000);
+
+    // A sample older than the last one is ignored.
+    throughput.sample(60500, 9000);
+    assert_eq!(throughput.speed(), 2000);
+}
@@ -0,0 +1,123 @@
+// Copyright (C) 2024 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use super::*;
+
+// @tc.name: ut_timeline_record
+// @tc.desc: Test recording the events of a task and dumping them as JSON
+// @tc.precon: NA
+// @tc.step: 1. Record the events of two runs of a task, with two first writes
+//              in the first run
+//           2. Dump the timeline
+// @tc.expect: The events are dumped in order, with one first write per run
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+// @tc.level: Level 1
+#[test]
+fn ut_timeline_record() {
+    let mut timeline = Timeline::new();
+    timeline.record(1, Phase::Queued);
+    timeline.record(2, Phase::Scheduled(QosLevel::Middle));
+    timeline.record(
+        3,
+        Phase::Response {
+            status: 200,
+            ttfb: 1,
+        },
+    );
+    timeline.record(4, Phase::FirstWrite);
+    timeline.record(5, Phase::FirstWrite);
+    timeline.record(6, Phase::Paused);
+    timeline.record(7, Phase::Resumed);
+    timeline.record(8, Phase::Scheduled(QosLevel::High));
+    timeline.record(9, Phase::FirstWrite);
+    timeline.record(10, Phase::Failed(Reason::ContinuousTaskTimeout));
+
+    let mut out = String::new();
+    timeline.write_json(5, &mut out);
+    assert_eq!(
+        out,
+        format!(
+            "{{\"task_id\":5,\"events\":[{{\"time\":1,\"phase\":\"queued\"}},\
+             {{\"time\":2,\"phase\":\"scheduled\",\"tier\":\"middle\"}},\
+             {{\"time\":3,\"phase\":\"response\",\"status\":200,\"ttfb\":1}},\
+             {{\"time\":4,\"phase\":\"first_write\"}},{{\"time\":6,\"phase\":\"paused\"}},\
+             {{\"time\":7,\"phase\":\"resumed\"}},\
+             {{\"time\":8,\"phase\":\"scheduled\",\"tier\":\"high\"}},\
+             {{\"time\":9,\"phase\":\"first_write\"}},\
+             {{\"time\":10,\"phase\":\"failed\",\"reason\":{}}}],\"samples\":[]}}",
+            Reason::ContinuousTaskTimeout.repr
+        )
+    );
+}
+
+// @tc.name: ut_timeline_sample
+// @tc.desc: Test sampling the speed of a task
+// @tc.precon: NA
+// @tc.step: 1. Sample the bytes of a run, then of a new run
+//           2. Sample more than the samples kept
+// @tc.expect: The speeds are computed per run and the oldest are dropped
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+// @tc.level: Level 1
+#[test]
+fn ut_timeline_sample() {
+    let mut timeline = Timeline::new();
+    timeline.sample(1000, 0);
+    timeline.sample(2000, 1000);
+    timeline.sample(2500, 2000);
+    assert_eq!(
+        timeline.samples.iter().copied().collect::<Vec<_>>(),
+        vec![(2000, 1000), (2500, 2000)]
+    );
+
+    timeline.record(3000, Phase::Scheduled(QosLevel::High));
+    timeline.sample(4000, 100);
+    timeline.sample(5000, 600);
+    assert_eq!(timeline.samples.back(), Some(&(5000, 500)));
+    assert_eq!(timeline.samples.len(), 3);
+
+    for i in 0..TIMELINE_SAMPLES as u64 {
+        timeline.sample(6000 + i * 1000, 600 + i);
+    }
+    assert_eq!(timeline.samples.len(), TIMELINE_SAMPLES);
+    assert_eq!(timeline.samples.front(), Some(&(6000, 0)));
+}
+
+// @tc.name: ut_timelines_capacity
+// @tc.desc: Test the number of timelines kept
+// @tc.precon: NA
+// @tc.step: 1. Record an event for more tasks than the timelines kept
+//           2. Dump the timeline of each task
+// @tc.expect: The timeline updated the longest ago is forgotten
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+// @tc.level: Level 1
+#[test]
+fn ut_timelines_capacity() {
+    let timelines = Timelines::new();
+    for task_id in 0..TIMELINE_TASKS as u32 {
+        timelines.with_timeline(task_id, |timeline| {
+            timeline.record(task_id as u64 + 1, Phase::Queued)
+        });
+    }
+    timelines.with_timeline(0, |timeline| timeline.record(1000, Phase::Completed));
+    timelines.record(TIMELINE_TASKS as u32, Phase::Queued);
+
+    assert!(timelines.dump(Some(0)).is_some());
+    assert!(timelines.dump(Some(1)).is_none());
+    assert!(timelines.dump(Some(TIMELINE_TASKS as u32)).is_some());
+    let all = timelines.dump(None).unwrap();
+    assert!(all.starts_with("[{\"task_id\":0,"));
+    assert_eq!(all.matches("\"task_id\"").count(), TIMELINE_TASKS);
+}
@@ -0,0 +1,109 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use super::*;
+use crate::utils::form_item::FileSpec;
+
+fn download_config(transport: Option<&str>) -> TaskConfig {
+    let mut config = TaskConfig::default();
+    config.url = "https://example.com/a".to_string();
+    config.method = "GET".to_string();
+    config.common_data.action = Action::Download;
+    config.file_specs = vec![FileSpec {
+        name: "a".to_string(),
+        path: "/data/a".to_string(),
+        file_name: "a".to_string(),
+        mime_type: String::new(),
+        is_user_file: false,
+        fd: None,
+    }];
+    if let Some(transport) = transport {
+        config
+            .extras
+            .insert(TRANSPORT_EXTRA.to_string(), transport.to_string());
+    }
+    config
+}
+
+// @tc.name: ut_transport_wanted
+// @tc.desc: Test the client a task asks for
+// @tc.precon: NA
+// @tc.step: 1. Build configs asking for each client, for none and for an
+//              unknown one
+// @tc.expect: A known client is taken, the one of the build otherwise
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_transport_wanted() {
+    assert_eq!(
+        Transport::wanted(&download_config(Some("netstack"))),
+        Transport::Netstack
+    );
+    assert_eq!(
+        Transport::wanted(&download_config(Some("ylong"))),
+        Transport::Ylong
+    );
+    assert_eq!(
+        Transport::wanted(&download_config(None)),
+        Transport::global()
+    );
+    assert_eq!(
+        Transport::wanted(&download_config(Some("quic"))),
+        Transport::global()
+    );
+}
+
+// @tc.name: ut_transport_netstack_supports
+// @tc.desc: Test the downloads the netstack can send
+// @tc.precon: NA
+// @tc.step: 1. Build a plain download config
+//           2. Change it to an upload, a range, no redirects, a decoded
+//              body, a proxy, certificates and an extracted archive
+// @tc.expect: Only the plain download is supported
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_transport_netstack_supports() {
+    let plain = download_config(Some("netstack"));
+    assert!(netstack_supports(&plain));
+
+    let mut upload = plain.clone();
+    upload.common_data.action = Action::Upload;
+    let mut range = plain.clone();
+    range.common_data.ends = 100;
+    let mut no_redirect = plain.clone();
+    no_redirect.common_data.redirect = false;
+    let mut compression = plain.clone();
+    compression.common_data.compression = true;
+    let mut proxy = plain.clone();
+    proxy.proxy = "http://proxy:8080".into();
+    let mut certs = plain.clone();
+    certs.certs_path = vec!["/data/ca.pem".to_string()].into();
+    let mut extract = plain.clone();
+    extract
+        .extras
+        .insert(EXTRACT_EXTRA.to_string(), "out".to_string());
+    for config in [
+        upload,
+        range,
+        no_redirect,
+        compression,
+        proxy,
+        certs,
+        extract,
+    ] {
+        assert!(!netstack_supports(&config));
+    }
+}
@@ -12,11 +12,12 @@
 // limitations under the License.
 
 use std::fs::File;
-use std::io::{BufRead, BufReader, Write};
+use std::io::{BufRead, BufReader, Read, Write};
 use std::net::{TcpListener, TcpStream};
 use std::sync::atomic::AtomicBool;
-use std::sync::Arc;
+use std::sync::{Arc, Mutex};
 
+use request_utils::compress::ContentEncoding;
 use ylong_runtime::sync::mpsc::unbounded_channel;
 
 use crate::ability::SYSTEM_CONFIG_MANAGER;
@@ -24,7 +25,10 @@ use crate::config::{Action, ConfigBuilder, Mode, TaskConfig};
 use crate::manage::network::{NetworkInfo, NetworkInner, NetworkType};
 use crate::service::client::ClientManagerEntry;
 use crate::task::request_task::{check_config, get_rest_time, RequestTask};
-use crate::task::upload::upload;
+use crate::task::upload::{
+    complete_parts_body, split_parts, upload, PART_COMPLETE_EXTRA, PART_URLS_EXTRA,
+    UPLOAD_ENCODING_EXTRA,
+};
 use crate::tests::test_init;
 
 const TEST_CONTENT: &str = "12345678910";
@@ -44,7 +48,6 @@ fn build_task(config: TaskConfig) -> Arc<RequestTask> {
 
     let (files, client) = check_config(
         &config,
-        rest_time,
         #[cfg(feature = "oh")]
         system_config,
     )
@@ -306,4 +309,330 @@ fn ut_upload_index_range() {
         upload(task.clone(), Arc::new(AtomicBool::new(false))).await;
     });
     assert!(task.running_result.lock().unwrap().unwrap().is_ok());
-}
\ No newline at end of file
+}
+// @tc.name: ut_upload_concurrent
+// @tc.desc: Test uploading the files of a task at the same time
+// @tc.precon: NA
+// @tc.step: 1. Initialize test environment
+//           2. Create multiple test files with content
+//           3. Configure upload task with a concurrency of 3
+//           4. Execute upload asynchronously
+//           5. Verify upload result and progress
+// @tc.expect: Upload succeeds, every file is processed and the index is the
+// last file
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+#[test]
+fn ut_upload_concurrent() {
+    test_init();
+
+    let mut files = vec![];
+    for i in 0..5 {
+        let mut file = create_file(&format!("test_files/ut_upload_concurrent{}.txt", i));
+        file.write_all(TEST_CONTENT.as_bytes()).unwrap();
+        files.push(file);
+    }
+    let server = test_server(vec![vec![TEST_CONTENT.to_string()]; 5]);
+
+    let mut config = config(server, files);
+    config.common_data.concurrency = 3;
+
+    let task = build_task(config);
+    assert_eq!(task.upload_concurrency(), 3);
+    ylong_runtime::block_on(async {
+        upload(task.clone(), Arc::new(AtomicBool::new(false))).await;
+    });
+    assert!(task.running_result.lock().unwrap().unwrap().is_ok());
+    let (processed, total) = task.processed.snapshot();
+    assert_eq!(processed, vec![TEST_CONTENT.len(); 5]);
+    assert_eq!(total, TEST_CONTENT.len() * 5);
+    assert_eq!(task.progress.lock().unwrap().common_data.index, 4);
+}
+
+// Serves a resumable upload which already stored `stored`, returns the
+// address and the bytes stored with the number of chunks received.
+fn tus_server(stored: &[u8]) -> (String, Arc<Mutex<(Vec<u8>, usize)>>) {
+    let server = "127.0.0.1";
+    let mut port = 7878;
+    let listener = loop {
+        match TcpListener::bind((server, port)) {
+            Ok(listener) => break listener,
+            Err(_) => port += 1,
+        }
+    };
+    let state = Arc::new(Mutex::new((stored.to_vec(), 0)));
+    let upload = state.clone();
+    std::thread::spawn(move || {
+        for stream in listener.incoming() {
+            let upload = upload.clone();
+            std::thread::spawn(move || handle_tus_connection(stream.unwrap(), upload));
+        }
+    });
+    (format!("{}:{}", server, port), state)
+}
+
+fn handle_tus_connection(mut stream: TcpStream, upload: Arc<Mutex<(Vec<u8>, usize)>>) {
+    let mut reader = BufReader::new(stream.try_clone().unwrap());
+    loop {
+        let mut line = String::new();
+        if reader.read_line(&mut line).unwrap_or(0) == 0 {
+            return;
+        }
+        let method = line.split(' ').next().unwrap_or_default().to_string();
+        let (mut offset, mut length) = (None, 0);
+        loop {
+            line.clear();
+            reader.read_line(&mut line).unwrap();
+            let line = line.trim();
+            if line.is_empty() {
+                break;
+            }
+            let (name, value) = line.split_once(':').unwrap();
+            match name.trim().to_lowercase().as_str() {
+                "upload-offset" => offset = value.trim().parse::<usize>().ok(),
+                "content-length" => length = value.trim().parse::<usize>().unwrap(),
+                _ => {}
+            }
+        }
+        let mut body = vec![0; length];
+        reader.read_exact(&mut body).unwrap();
+
+        let mut upload = upload.lock().unwrap();
+        let response = match method.as_str() {
+            "HEAD" => format!(
+                "HTTP/1.1 200 OK\r\nUpload-Offset: {}\r\nContent-Length: 0\r\n\r\n",
+                upload.0.len()
+            ),
+            "PATCH" if offset == Some(upload.0.len()) => {
+                upload.0.extend_from_slice(&body);
+                upload.1 += 1;
+                format!(
+                    "HTTP/1.1 204 No Content\r\nUpload-Offset: {}\r\n\r\n",
+                    upload.0.len()
+                )
+            }
+            _ => "HTTP/1.1 409 Conflict\r\nContent-Length: 0\r\n\r\n".to_string(),
+        };
+        stream.write_all(response.as_bytes()).unwrap();
+    }
+}
+
+// @tc.name: ut_upload_chunks
+// @tc.desc: Test resuming an upload in chunks from the offset of the server
+// @tc.precon: NA
+// @tc.step: 1. Initialize test environment
+//           2. Create a test file and a server which stored part of it
+//           3. Configure a PUT upload task with a chunk size
+//           4. Execute upload asynchronously
+//           5. Verify upload result, the stored bytes and the chunks sent
+// @tc.expect: Only the bytes after the offset are sent, in chunks
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+#[test]
+fn ut_upload_chunks() {
+    const CONTENT: &str = "0123456789abcdefghijklmnopqrstuvwxyz";
+    test_init();
+
+    let mut file = create_file("test_files/ut_upload_chunks.txt");
+    file.write_all(CONTENT.as_bytes()).unwrap();
+    let (server, upload_state) = tus_server(&CONTENT.as_bytes()[..6]);
+
+    let mut config = config(server, vec![file]);
+    config.method = "PUT".to_string();
+    config.common_data.chunk_size = 8;
+
+    let task = build_task(config);
+    assert_eq!(task.upload_chunk_size(), Some(8));
+    ylong_runtime::block_on(async {
+        upload(task.clone(), Arc::new(AtomicBool::new(false))).await;
+    });
+    assert!(task.running_result.lock().unwrap().unwrap().is_ok());
+    let (stored, chunks) = upload_state.lock().unwrap().clone();
+    assert_eq!(stored, CONTENT.as_bytes());
+    assert_eq!(chunks, 4);
+    assert_eq!(task.processed.total(), CONTENT.len());
+}
+
+// @tc.name: ut_upload_split_parts
+// @tc.desc: Test splitting a file into the parts of a parallel upload
+// @tc.precon: NA
+// @tc.step: 1. Split files of several sizes into parts
+//           2. Build the body completing the upload
+// @tc.expect: The parts cover the file in order, one per url, and the body
+//             lists the ETags by part number
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_upload_split_parts() {
+    assert_eq!(split_parts(10, 3), vec![(0, 4), (4, 4), (8, 2)]);
+    assert_eq!(split_parts(9, 3), vec![(0, 3), (3, 3), (6, 3)]);
+    assert_eq!(split_parts(2, 3), vec![(0, 1), (1, 1), (2, 0)]);
+    assert_eq!(split_parts(0, 1), vec![(0, 0)]);
+    assert_eq!(
+        complete_parts_body(&["\"a\"".to_string(), "\"b\"".to_string()]),
+        "<CompleteMultipartUpload>\
+         <Part><PartNumber>1</PartNumber><ETag>\"a\"</ETag></Part>\
+         <Part><PartNumber>2</PartNumber><ETag>\"b\"</ETag></Part>\
+         </CompleteMultipartUpload>"
+    );
+}
+
+// Serves the parts of a parallel upload, failing the first try of the
+// second part, returns the address and the parts stored with the body of
+// the completion request.
+fn parts_server() -> (String, Arc<Mutex<(Vec<Option<Vec<u8>>>, String)>>) {
+    let server = "127.0.0.1";
+    let mut port = 7878;
+    let listener = loop {
+        match TcpListener::bind((server, port)) {
+            Ok(listener) => break listener,
+            Err(_) => port += 1,
+        }
+    };
+    let state = Arc::new(Mutex::new((vec![None; 3], String::new())));
+    let parts = state.clone();
+    let failed = Arc::new(AtomicBool::new(false));
+    std::thread::spawn(move || {
+        for stream in listener.incoming() {
+            let parts = parts.clone();
+            let failed = failed.clone();
+            std::thread::spawn(move || handle_parts_connection(stream.unwrap(), parts, failed));
+        }
+    });
+    (format!("{}:{}", server, port), state)
+}
+
+fn handle_parts_connection(
+    mut stream: TcpStream,
+    parts: Arc<Mutex<(Vec<Option<Vec<u8>>>, String)>>,
+    failed: Arc<AtomicBool>,
+) {
+    let mut reader = BufReader::new(stream.try_clone().unwrap());
+    loop {
+        let mut line = String::new();
+        if reader.read_line(&mut line).unwrap_or(0) == 0 {
+            return;
+        }
+        let path = line.split(' ').nth(1).unwrap_or_default().to_string();
+        let mut length = 0;
+        loop {
+            line.clear();
+            reader.read_line(&mut line).unwrap();
+            let line = line.trim();
+            if line.is_empty() {
+                break;
+            }
+            let (name, value) = line.split_once(':').unwrap();
+            if name.trim().eq_ignore_ascii_case("content-length") {
+                length = value.trim().parse::<usize>().unwrap();
+            }
+        }
+        let mut body = vec![0; length];
+        reader.read_exact(&mut body).unwrap();
+
+        let mut parts = parts.lock().unwrap();
+        let response = match path.strip_prefix("/part") {
+            Some("1") if !failed.swap(true, std::sync::atomic::Ordering::SeqCst) => {
+                "HTTP/1.1 500 Internal Server Error\r\nContent-Length: 0\r\n\r\n".to_string()
+            }
+            Some(part) => {
+                let part = part.parse::<usize>().unwrap();
+                parts.0[part] = Some(body);
+                format!(
+                    "HTTP/1.1 200 OK\r\nETag: \"etag{}\"\r\nContent-Length: 0\r\n\r\n",
+                    part
+                )
+            }
+            None => {
+                parts.1 = String::from_utf8(body).unwrap();
+                "HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n".to_string()
+            }
+        };
+        stream.write_all(response.as_bytes()).unwrap();
+    }
+}
+
+// @tc.name: ut_upload_parts
+// @tc.desc: Test uploading a file in parallel parts to pre-signed urls
+// @tc.precon: NA
+// @tc.step: 1. Initialize test environment
+//           2. Create a test file and a server failing a part once
+//           3. Configure a PUT upload task with three part urls and a
+//              completion url
+//           4. Execute upload asynchronously
+//           5. Verify upload result, the parts stored and the completion
+// @tc.expect: Every part is stored, the failed one after it is sent again,
+//             and the completion lists the ETags of the parts in order
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_upload_parts() {
+    const CONTENT: &str = "0123456789abcdefghijklmnopqrstuvwxyz";
+    test_init();
+
+    let mut file = create_file("test_files/ut_upload_parts.txt");
+    file.write_all(CONTENT.as_bytes()).unwrap();
+    let (server, parts_state) = parts_server();
+
+    let mut config = config(server.clone(), vec![file]);
+    config.method = "PUT".to_string();
+    let urls = (0..3)
+        .map(|part| format!("http://{}/part{}", server, part))
+        .collect::<Vec<_>>();
+    config
+        .extras
+        .insert(PART_URLS_EXTRA.to_string(), urls.join("\n"));
+    config.extras.insert(
+        PART_COMPLETE_EXTRA.to_string(),
+        format!("http://{}/complete", server),
+    );
+
+    let task = build_task(config);
+    assert_eq!(task.upload_part_urls(), Some(urls));
+    assert_eq!(task.upload_chunk_size(), None);
+    ylong_runtime::block_on(async {
+        upload(task.clone(), Arc::new(AtomicBool::new(false))).await;
+    });
+    assert!(task.running_result.lock().unwrap().unwrap().is_ok());
+    let (stored, complete) = parts_state.lock().unwrap().clone();
+    let stored = stored.into_iter().map(Option::unwrap).collect::<Vec<_>>();
+    assert_eq!(stored.concat(), CONTENT.as_bytes());
+    assert_eq!(stored[0].len(), 12);
+    assert!(complete.contains("<PartNumber>3</PartNumber><ETag>\"etag2\"</ETag>"));
+    assert_eq!(task.processed.total(), CONTENT.len());
+    assert!(task.part_etags.lock().unwrap().is_empty());
+}
+
+// @tc.name: ut_upload_encoding
+// @tc.desc: Test which uploads compress their body
+// @tc.precon: NA
+// @tc.step: 1. Configure uploads asking for gzip as a stream, as form data
+//              and with a body the application encoded
+// @tc.expect: Only the stream upload not encoded yet is compressed
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_upload_encoding() {
+    test_init();
+
+    let file = create_file("test_files/ut_upload_encoding.txt");
+    let mut config = config("127.0.0.1:7878".to_string(), vec![file]);
+    config
+        .extras
+        .insert(UPLOAD_ENCODING_EXTRA.to_string(), "gzip".to_string());
+    let task = build_task(config.clone());
+    assert_eq!(task.upload_encoding(), None);
+
+    config.method = "PUT".to_string();
+    let task = build_task(config.clone());
+    assert_eq!(task.upload_encoding(), Some(ContentEncoding::Gzip));
+
+    config
+        .headers
+        .insert("Content-Encoding".to_string(), "br".to_string());
+    let task = build_task(config);
+    assert_eq!(task.upload_encoding(), None);
+}
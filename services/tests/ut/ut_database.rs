@@ -38,6 +38,12 @@ fn clear_database_test() {
             (),
         )
         .unwrap();
+    REQUEST_DB
+        .execute(
+            "CREATE TABLE IF NOT EXISTS request_task_progress (task_id INTEGER PRIMARY KEY, mtime INTEGER)",
+            (),
+        )
+        .unwrap();
     let mut task_ids = [
         fast_random() as u32,
         fast_random() as u32,
@@ -72,4 +78,96 @@ fn clear_database_test() {
         assert!(!query.contains(task_id));
     }
     assert!(query.contains(&task_ids[2]));
-}
\ No newline at end of file
+}
+// @tc.name: ut_reap_expired_tasks_in_chunks
+// @tc.desc: Test that the idle reaper deletes expired tasks in bounded chunks
+// @tc.precon: NA
+// @tc.step: 1. Insert expired tasks and a recent one
+//           2. Run reaper ticks with a chunk of two rows until nothing remains
+// @tc.expect: Every tick deletes at most two rows, only the recent task stays
+//             and the reported row count matches the table
+// @tc.type: FUNC
+// @tc.require: issues#ICN31I
+#[test]
+fn ut_reap_expired_tasks_in_chunks() {
+    use request_utils::fastrand::fast_random;
+
+    let current_time = SystemTime::now()
+        .duration_since(UNIX_EPOCH)
+        .unwrap()
+        .as_millis() as u64;
+    let a_week_ago = current_time - MILLIS_IN_A_WEEK;
+
+    REQUEST_DB
+        .execute(
+            "CREATE TABLE IF NOT EXISTS request_task (task_id INTEGER PRIMARY KEY, mtime INTEGER)",
+            (),
+        )
+        .unwrap();
+    REQUEST_DB
+        .execute(
+            "CREATE TABLE IF NOT EXISTS request_task_progress (task_id INTEGER PRIMARY KEY, mtime INTEGER)",
+            (),
+        )
+        .unwrap();
+
+    let sql = "INSERT OR REPLACE INTO request_task (task_id, mtime) VALUES (?, ?)";
+    let expired = (0..5).map(|_| fast_random() as u32).collect::<Vec<_>>();
+    for task_id in expired.iter() {
+        REQUEST_DB.execute(sql, (*task_id, a_week_ago)).unwrap();
+    }
+    let recent = fast_random() as u32;
+    REQUEST_DB.execute(sql, (recent, current_time)).unwrap();
+
+    loop {
+        let stats = reap_expired_tasks(2).unwrap();
+        assert!(stats.deleted <= 2);
+        let rows: Vec<_> = REQUEST_DB
+            .query::<i64>("SELECT COUNT(*) from request_task", ())
+            .unwrap()
+            .collect();
+        assert_eq!(stats.rows, rows[0]);
+        if !stats.remain {
+            break;
+        }
+    }
+
+    let query: Vec<_> = REQUEST_DB
+        .query::<u32>("SELECT task_id from request_task", ())
+        .unwrap()
+        .collect();
+    for task_id in expired.iter() {
+        assert!(!query.contains(task_id));
+    }
+    assert!(query.contains(&recent));
+}
+
+// @tc.name: ut_maintain_database
+// @tc.desc: Test the idle maintenance of the database
+// @tc.precon: NA
+// @tc.step: 1. Run the maintenance while tasks are running
+//           2. Run it twice while the service is idle
+// @tc.expect: Tasks running only get a passive checkpoint, the WAL is
+//             truncated from its threshold on, the statistics are refreshed
+//             at most once per interval and every checkpoint is measured
+// @tc.type: FUNC
+// @tc.require: issues#ICN31I
+#[test]
+fn ut_maintain_database() {
+    REQUEST_DB
+        .execute(
+            "CREATE TABLE IF NOT EXISTS request_task (task_id INTEGER PRIMARY KEY, mtime INTEGER)",
+            (),
+        )
+        .unwrap();
+    let checkpoints = metrics::DB_CHECKPOINT_US.count();
+
+    let stats = maintain(true);
+    assert!(!stats.truncated);
+    assert!(!stats.analyzed);
+
+    let stats = maintain(false);
+    assert_eq!(stats.truncated, stats.wal_bytes >= WAL_TRUNCATE_BYTES);
+    assert!(!maintain(false).analyzed);
+    assert!(metrics::DB_CHECKPOINT_US.count() >= checkpoints + 3);
+}
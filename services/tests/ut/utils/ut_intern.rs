@@ -0,0 +1,64 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use super::*;
+
+// @tc.name: ut_intern_shared
+// @tc.desc: Test that equal values are stored once
+// @tc.precon: NA
+// @tc.step: 1. Intern the same string twice and a different one
+//           2. Intern the same list of strings twice
+// @tc.expect: Equal values share their allocation, different ones do not
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_intern_shared() {
+    let interner = Interner::<str>::new();
+    let a = interner.intern("com.example.app");
+    let b = interner.intern("com.example.app");
+    let c = interner.intern("com.example.other");
+    assert!(Arc::ptr_eq(&a, &b));
+    assert!(!Arc::ptr_eq(&a, &c));
+    assert_eq!(interner.len(), 2);
+
+    let interner = Interner::<[String]>::new();
+    let paths = vec!["/data/a.pem".to_string(), "/data/b.pem".to_string()];
+    let a = interner.intern(&paths);
+    let b = interner.intern(&paths.clone());
+    assert!(Arc::ptr_eq(&a, &b));
+    assert_eq!(&a[..], &paths[..]);
+}
+
+// @tc.name: ut_intern_prune
+// @tc.desc: Test that values no longer used are dropped
+// @tc.precon: NA
+// @tc.step: 1. Intern more values than the pruning threshold, keeping one
+//           2. Intern one more value
+// @tc.expect: Only the kept value and the new one remain, the kept value is
+//             still shared
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_intern_prune() {
+    let interner = Interner::<str>::new();
+    let kept = interner.intern("kept");
+    for i in 1..PRUNE_THRESHOLD {
+        interner.intern(&i.to_string());
+    }
+    assert_eq!(interner.len(), PRUNE_THRESHOLD);
+    interner.intern("new");
+    assert_eq!(interner.len(), 2);
+    assert!(Arc::ptr_eq(&kept, &interner.intern("kept")));
+}
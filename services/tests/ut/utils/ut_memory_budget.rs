@@ -0,0 +1,77 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use std::sync::Arc;
+use std::task::Wake;
+
+use super::*;
+
+struct Flag(std::sync::atomic::AtomicBool);
+
+impl Wake for Flag {
+    fn wake(self: Arc<Self>) {
+        self.0.store(true, Ordering::SeqCst);
+    }
+}
+
+// @tc.name: ut_memory_budget_reserve
+// @tc.desc: Test reserving bytes from a memory budget
+// @tc.precon: NA
+// @tc.step: 1. Reserve bytes until the budget is spent
+//           2. Release a reservation
+//           3. Reserve more than the whole budget
+// @tc.expect: Reservations beyond the budget are refused until bytes are
+//             released, and the highest use is kept
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_memory_budget_reserve() {
+    static TEST_BUDGET: MemoryBudget = MemoryBudget::new(100);
+    let first = TEST_BUDGET.try_reserve(60).unwrap();
+    let second = TEST_BUDGET.try_reserve(40).unwrap();
+    assert!(TEST_BUDGET.try_reserve(1).is_none());
+    assert_eq!(TEST_BUDGET.used(), 100);
+
+    drop(first);
+    assert_eq!(TEST_BUDGET.used(), 40);
+    assert!(TEST_BUDGET.try_reserve(200).is_none());
+    drop(second);
+    let large = TEST_BUDGET.try_reserve(200).unwrap();
+    assert_eq!(TEST_BUDGET.high_water(), 200);
+    drop(large);
+    assert_eq!(TEST_BUDGET.used(), 0);
+}
+
+// @tc.name: ut_memory_budget_poll_reserve
+// @tc.desc: Test waiting for a spent memory budget
+// @tc.precon: NA
+// @tc.step: 1. Spend the budget and poll for a reservation
+//           2. Release the reservation spending the budget
+// @tc.expect: The poll is pending, then woken and ready
+// @tc.type: FUNC
+// @tc.require: issueNumber
+// @tc.level: Level 1
+#[test]
+fn ut_memory_budget_poll_reserve() {
+    static TEST_BUDGET: MemoryBudget = MemoryBudget::new(100);
+    let flag = Arc::new(Flag(std::sync::atomic::AtomicBool::new(false)));
+    let waker = Waker::from(flag.clone());
+    let mut cx = Context::from_waker(&waker);
+
+    let full = TEST_BUDGET.try_reserve(100).unwrap();
+    assert!(TEST_BUDGET.poll_reserve(&mut cx, 10).is_pending());
+    drop(full);
+    assert!(flag.0.load(Ordering::SeqCst));
+    assert!(TEST_BUDGET.poll_reserve(&mut cx, 10).is_ready());
+}
@@ -0,0 +1,96 @@
+// Copyright (C) 2024 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use std::sync::Arc;
+use std::thread;
+
+use super::*;
+
+// @tc.name: ut_metrics_counter
+// @tc.desc: Test counting from several threads
+// @tc.precon: NA
+// @tc.step: 1. Add to a counter from more threads than shards
+// @tc.expect: The counter holds the sum of all the additions
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+// @tc.level: Level 1
+#[test]
+fn ut_metrics_counter() {
+    let counter = Arc::new(Counter::new());
+    let threads = (0..COUNTER_SHARDS * 2)
+        .map(|_| {
+            let counter = counter.clone();
+            thread::spawn(move || {
+                for _ in 0..1000 {
+                    counter.add(2);
+                }
+            })
+        })
+        .collect::<Vec<_>>();
+    for thread in threads {
+        thread.join().unwrap();
+    }
+    assert_eq!(counter.get(), (COUNTER_SHARDS * 2 * 2000) as u64);
+}
+
+// @tc.name: ut_metrics_bucket
+// @tc.desc: Test the log-linear buckets of a histogram
+// @tc.precon: NA
+// @tc.step: 1. Compute the bucket of values and the floor of the buckets
+// @tc.expect: Every value lies between the floor of its bucket and the floor
+//             of the next one, which is at most 25% above it
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+// @tc.level: Level 1
+#[test]
+fn ut_metrics_bucket() {
+    for value in 0..LINEAR_MAX {
+        assert_eq!(bucket(value), value as usize);
+    }
+    assert_eq!(bucket(8), 8);
+    assert_eq!(bucket(9), 8);
+    assert_eq!(bucket(10), 9);
+    assert_eq!(bucket(15), 11);
+    assert_eq!(bucket(16), 12);
+    assert_eq!(bucket(u64::MAX), HISTOGRAM_BUCKETS - 1);
+    for index in 0..HISTOGRAM_BUCKETS - 1 {
+        let floor = bucket_floor(index);
+        let next = bucket_floor(index + 1);
+        assert_eq!(bucket(floor), index);
+        assert_eq!(bucket(next - 1), index);
+        assert!(floor < LINEAR_MAX || (next - floor) * 4 <= floor);
+    }
+}
+
+// @tc.name: ut_metrics_percentile
+// @tc.desc: Test the percentiles of a histogram
+// @tc.precon: NA
+// @tc.step: 1. Record 1 to 100 in a histogram
+// @tc.expect: The count, sum and percentiles match the recorded values
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+// @tc.level: Level 1
+#[test]
+fn ut_metrics_percentile() {
+    let histogram = Histogram::new();
+    assert_eq!(histogram.percentile(50), 0);
+    for value in 1..=100 {
+        histogram.record(value);
+    }
+    assert_eq!(histogram.count(), 100);
+    assert_eq!(histogram.sum(), 5050);
+    assert_eq!(histogram.percentile(50), 48);
+    assert_eq!(histogram.percentile(99), 96);
+    assert_eq!(histogram.percentile(100), 96);
+    assert_eq!(histogram.percentile(1), 1);
+}
@@ -0,0 +1,45 @@
+// Copyright (C) 2024 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use super::*;
+
+// @tc.name: ut_runtime_workers
+// @tc.desc: Test the number of workers configured for a pool
+// @tc.precon: NA
+// @tc.step: 1. Parse unset, invalid, zero and positive worker numbers
+// @tc.expect: Only a positive number overrides the default
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+// @tc.level: Level 1
+#[test]
+fn ut_runtime_workers() {
+    assert_eq!(workers(None, 2), 2);
+    assert_eq!(workers(Some("many"), 2), 2);
+    assert_eq!(workers(Some("0"), 2), 2);
+    assert_eq!(workers(Some("6"), 2), 6);
+}
+
+// @tc.name: ut_runtime_io_spawn
+// @tc.desc: Test spawning a future on the I/O pool
+// @tc.precon: NA
+// @tc.step: 1. Spawn a future returning a value on the I/O pool
+//           2. Wait for it from the global runtime
+// @tc.expect: The value of the future is returned through its handle
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+// @tc.level: Level 1
+#[test]
+fn ut_runtime_io_spawn() {
+    let handle = io_spawn(async { 1 + 1 });
+    assert_eq!(ylong_runtime::block_on(handle).unwrap(), 2);
+}
@@ -0,0 +1,52 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use std::time::{Duration, Instant};
+
+use super::*;
+
+// @tc.name: ut_startup_breakdown
+// @tc.desc: Test the breakdown of the init phases of a launch
+// @tc.precon: NA
+// @tc.step: 1. Record some phases, the publish ending 5000 us after the first
+//              phase started
+//           2. Dump the breakdown
+// @tc.expect: The recorded phases and the time until published are kept and
+//             dumped in phase order, the phases that did not run are left out
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+// @tc.level: Level 1
+#[test]
+fn ut_startup_breakdown() {
+    let mut startup = Startup::new();
+    assert_eq!(startup.dump(), "service not started\n");
+
+    let begin = Instant::now();
+    startup.record(Phase::Runtime, begin, 100);
+    startup.record(Phase::Database, begin + Duration::from_micros(200), 3000);
+    assert_eq!(startup.published_us(), None);
+    startup.record(Phase::Publish, begin + Duration::from_micros(4000), 1000);
+
+    assert_eq!(startup.phase_us(Phase::Runtime), Some(100));
+    assert_eq!(startup.phase_us(Phase::Database), Some(3000));
+    assert_eq!(startup.phase_us(Phase::Proxy), None);
+    assert_eq!(startup.published_us(), Some(5000));
+
+    let dump = startup.dump();
+    let lines = dump.lines().collect::<Vec<_>>();
+    assert_eq!(lines.len(), 4);
+    assert!(lines[0].starts_with("runtime") && lines[0].ends_with(" 100 us"));
+    assert!(lines[1].starts_with("database") && lines[1].ends_with(" 3000 us"));
+    assert!(lines[2].starts_with("publish") && lines[2].ends_with(" 1000 us"));
+    assert!(lines[3].starts_with("published") && lines[3].ends_with(" 5000 us"));
+}
@@ -11,7 +11,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-use crate::utils::task_id_generator::TaskIdGenerator;
+use crate::utils::task_id_generator::{IdPermutation, TaskIdGenerator};
 
 // @tc.name: ut_task_id_generator_generate_basic
 // @tc.desc: Test basic functionality of task ID generation
@@ -125,45 +125,42 @@ fn ut_task_id_generator_concurrent_safety() {
     assert_eq!(final_ids.len(), 400);
 }
 
-// Conditional tests for OH feature
-#[cfg(feature = "oh")]
-mod oh_tests {
-    use super::*;
-
-    // @tc.name: ut_task_id_generator_oh_system_time
-    // @tc.desc: Test OH feature task ID generation using system time
-    // @tc.precon: OH feature is enabled
-    // @tc.step: 1. Generate task ID
-    //           2. Verify ID is reasonable
-    // @tc.expect: ID is generated successfully
-    // @tc.type: FUNC
-    // @tc.require: issue#ICODZX
-    // @tc.level: Level 1
-    #[test]
-    fn ut_task_id_generator_oh_system_time() {
-        let task_id = TaskIdGenerator::generate();
-        assert_ne!(task_id, 0);
-        assert!(task_id < 2_000_000_000);
+// @tc.name: ut_task_id_permutation_inverse
+// @tc.desc: Test the permutation of the task IDs is invertible
+// @tc.precon: NA
+// @tc.step: 1. Create permutations with several keys
+//           2. Apply then invert them on sequence numbers
+// @tc.expect: Every sequence number is recovered from its ID
+// @tc.type: FUNC
+// @tc.require: issues#ICN31I
+// @tc.level: Level 1
+#[test]
+fn ut_task_id_permutation_inverse() {
+    for seed in [0, 1, 0x1234_5678_9ABC_DEF0, u64::MAX] {
+        let permutation = IdPermutation::new(seed);
+        for seq in (0..u32::MAX).step_by(65_521).chain([u32::MAX]) {
+            assert_eq!(permutation.invert(permutation.apply(seq)), seq);
+        }
     }
 }
 
-// Conditional tests for non-OH feature
-#[cfg(not(feature = "oh"))]
-mod non_oh_tests {
-    use super::*;
+// @tc.name: ut_task_id_permutation_unique
+// @tc.desc: Test consecutive sequence numbers map to distinct, scattered IDs
+// @tc.precon: NA
+// @tc.step: 1. Apply a permutation to 100000 consecutive sequence numbers
+// @tc.expect: All IDs are distinct and not consecutive
+// @tc.type: FUNC
+// @tc.require: issues#ICN31I
+// @tc.level: Level 1
+#[test]
+fn ut_task_id_permutation_unique() {
+    use std::collections::HashSet;
 
-    // @tc.name: ut_task_id_generator_non_oh_random
-    // @tc.desc: Test non-OH feature random task ID generation
-    // @tc.precon: OH feature is disabled
-    // @tc.step: 1. Generate task ID
-    //           2. Verify ID is random
-    // @tc.expect: ID is generated using rand::random()
-    // @tc.type: FUNC
-    // @tc.require: issue#ICODZX
-    // @tc.level: Level 1
-    #[test]
-    fn ut_task_id_generator_non_oh_random() {
-        let task_id = TaskIdGenerator::generate();
-        assert_ne!(task_id, 0);
-    }
-}
\ No newline at end of file
+    let permutation = IdPermutation::new(42);
+    let ids = (0..100_000u32)
+        .map(|seq| permutation.apply(seq))
+        .collect::<Vec<_>>();
+    assert_eq!(ids.iter().collect::<HashSet<_>>().len(), ids.len());
+    let consecutive = ids.windows(2).filter(|w| w[1] == w[0].wrapping_add(1)).count();
+    assert!(consecutive < 10);
+}
@@ -0,0 +1,39 @@
+// Copyright (C) 2025 Huawei Device Co., Ltd.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use super::*;
+
+// @tc.name: ut_url_policy_cache
+// @tc.desc: Test reusing the policy results of hosts
+// @tc.precon: NA
+// @tc.step: 1. Keep a fresh result and a result checked before the TTL
+//           2. Look up both, and the fresh one with another case of the host
+// @tc.expect: Only the fresh result is reused, whatever the case of the host
+// @tc.type: FUNC
+// @tc.require: issues#ICN16H
+// @tc.level: Level 1
+#[test]
+fn ut_url_policy_cache() {
+    let fresh = policy_key("ut_url_policy_cache", "download", "example.com");
+    cache_policy(fresh, false, Instant::now());
+    let upper = policy_key("ut_url_policy_cache", "download", "EXAMPLE.com");
+    assert_eq!(cached_policy(&upper), Some(false));
+
+    let other = policy_key("ut_url_policy_cache", "upload", "example.com");
+    assert_eq!(cached_policy(&other), None);
+
+    if let Some(checked) = Instant::now().checked_sub(POLICY_TTL + Duration::from_secs(1)) {
+        cache_policy(other.clone(), true, checked);
+        assert_eq!(cached_policy(&other), None);
+    }
+}